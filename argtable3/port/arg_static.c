@@ -0,0 +1,422 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ctype.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "argtable3/arg_static.h"
+
+/* The types, values and messages below follow those of arg_lit.c, arg_int.c, arg_dbl.c, arg_str.c and arg_end.c */
+
+static void print_option_error(arg_dstr_t ds, const struct arg_hdr *hdr, const char *message, const char *datatype)
+{
+    arg_dstr_cat(ds, message);
+    arg_print_option_ds(ds, hdr->shortopts, hdr->longopts, datatype, "\n");
+}
+
+static void print_count_error(arg_dstr_t ds, const struct arg_hdr *hdr, int error, const char *argval,
+                              const char *excess)
+{
+    if (error == ARG_ERR_MINCOUNT) {
+        print_option_error(ds, hdr, "missing option ", hdr->datatype);
+    } else if (error == ARG_ERR_MAXCOUNT) {
+        print_option_error(ds, hdr, excess, argval);
+    }
+}
+
+/* Whether only whitespaces are left, or the given suffix, in any case, then whitespaces */
+static bool detect_suffix(const char *str, const char *suffix)
+{
+    while (*suffix && toupper((unsigned char)*str) == toupper((unsigned char)*suffix)) {
+        str++;
+        suffix++;
+    }
+    if (*suffix) {
+        return false;
+    }
+    while (isspace((unsigned char)*str)) {
+        str++;
+    }
+    return *str == '\0';
+}
+
+/* A number with the prefix "0x", "0o" or "0b" of its base, or `str` in `end` if there is no such prefix */
+static long strtol_prefixed(const char *str, const char **end, char prefix, int base)
+{
+    const char *ptr = str;
+    long sign = 1;
+
+    while (isspace((unsigned char)*ptr)) {
+        ptr++;
+    }
+    if (*ptr == '+' || *ptr == '-') {
+        sign = *ptr == '-' ? -1 : 1;
+        ptr++;
+    }
+    if (ptr[0] != '0' || toupper((unsigned char)ptr[1]) != prefix) {
+        *end = str;
+        return 0;
+    }
+    ptr += 2;
+    char *num_end;
+    long val = strtol(ptr, &num_end, base);
+    *end = num_end == ptr ? str : num_end;
+    return sign * val;
+}
+
+void arg_static_lit_reset(void *parent)
+{
+    ((struct arg_lit *)parent)->count = 0;
+}
+
+int arg_static_lit_scan(void *parent, const char *argval)
+{
+    struct arg_lit *lit = parent;
+    (void)argval;
+    if (lit->count >= lit->hdr.maxcount) {
+        return ARG_ERR_MAXCOUNT;
+    }
+    lit->count++;
+    return 0;
+}
+
+int arg_static_lit_check(void *parent)
+{
+    struct arg_lit *lit = parent;
+    return lit->count < lit->hdr.mincount ? ARG_ERR_MINCOUNT : 0;
+}
+
+void arg_static_lit_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname)
+{
+    struct arg_lit *lit = parent;
+    arg_dstr_catf(ds, "%s: ", progname ? progname : "");
+    print_count_error(ds, &lit->hdr, error, argval, "extraneous option ");
+}
+
+void arg_static_int_reset(void *parent)
+{
+    ((struct arg_int *)parent)->count = 0;
+}
+
+int arg_static_int_scan(void *parent, const char *argval)
+{
+    struct arg_int *arg = parent;
+    if (arg->count >= arg->hdr.maxcount) {
+        return ARG_ERR_MAXCOUNT;
+    }
+    if (!argval) {
+        arg->count++;
+        return 0;
+    }
+
+    const char *end;
+    long val = strtol_prefixed(argval, &end, 'X', 16);
+    if (end == argval) {
+        val = strtol_prefixed(argval, &end, 'O', 8);
+    }
+    if (end == argval) {
+        val = strtol_prefixed(argval, &end, 'B', 2);
+    }
+    if (end == argval) {
+        char *dec_end;
+        val = strtol(argval, &dec_end, 10);
+        end = dec_end;
+    }
+    if (end == argval) {
+        return ARG_ERR_BADINT;
+    }
+
+    int error = 0;
+    long scale = 1;
+    if (detect_suffix(end, "KB")) {
+        scale = 1024;
+    } else if (detect_suffix(end, "MB")) {
+        scale = 1024 * 1024;
+    } else if (detect_suffix(end, "GB")) {
+        scale = 1024 * 1024 * 1024;
+    } else if (!detect_suffix(end, "")) {
+        error = ARG_ERR_BADINT;
+    }
+    if (!error && (val > INT_MAX / scale || val < INT_MIN / scale)) {
+        error = ARG_ERR_OVERFLOW;
+    }
+    if (!error) {
+        arg->ival[arg->count++] = (int)(val * scale);
+    }
+    return error;
+}
+
+int arg_static_int_check(void *parent)
+{
+    struct arg_int *arg = parent;
+    return arg->count < arg->hdr.mincount ? ARG_ERR_MINCOUNT : 0;
+}
+
+void arg_static_int_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname)
+{
+    struct arg_int *arg = parent;
+    argval = argval ? argval : "";
+    arg_dstr_catf(ds, "%s: ", progname ? progname : "");
+    if (error == ARG_ERR_BADINT) {
+        arg_dstr_catf(ds, "invalid argument \"%s\" to option ", argval);
+        arg_print_option_ds(ds, arg->hdr.shortopts, arg->hdr.longopts, arg->hdr.datatype, "\n");
+    } else if (error == ARG_ERR_OVERFLOW) {
+        arg_dstr_cat(ds, "integer overflow at option ");
+        arg_print_option_ds(ds, arg->hdr.shortopts, arg->hdr.longopts, arg->hdr.datatype, " ");
+        arg_dstr_catf(ds, "(%s is too large)\n", argval);
+    } else {
+        print_count_error(ds, &arg->hdr, error, argval, "excess option ");
+    }
+}
+
+void arg_static_dbl_reset(void *parent)
+{
+    ((struct arg_dbl *)parent)->count = 0;
+}
+
+int arg_static_dbl_scan(void *parent, const char *argval)
+{
+    struct arg_dbl *arg = parent;
+    if (arg->count >= arg->hdr.maxcount) {
+        return ARG_ERR_MAXCOUNT;
+    }
+    if (!argval) {
+        arg->count++;
+        return 0;
+    }
+
+    char *end;
+    double val = strtod(argval, &end);
+    if (end == argval || !detect_suffix(end, "")) {
+        return ARG_ERR_BADDOUBLE;
+    }
+    arg->dval[arg->count++] = val;
+    return 0;
+}
+
+int arg_static_dbl_check(void *parent)
+{
+    struct arg_dbl *arg = parent;
+    return arg->count < arg->hdr.mincount ? ARG_ERR_MINCOUNT : 0;
+}
+
+void arg_static_dbl_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname)
+{
+    struct arg_dbl *arg = parent;
+    argval = argval ? argval : "";
+    arg_dstr_catf(ds, "%s: ", progname ? progname : "");
+    if (error == ARG_ERR_BADDOUBLE) {
+        arg_dstr_catf(ds, "invalid argument \"%s\" to option ", argval);
+        arg_print_option_ds(ds, arg->hdr.shortopts, arg->hdr.longopts, arg->hdr.datatype, "\n");
+    } else {
+        print_count_error(ds, &arg->hdr, error, argval, "excess option ");
+    }
+}
+
+void arg_static_str_reset(void *parent)
+{
+    struct arg_str *arg = parent;
+    for (int i = 0; i < arg->hdr.maxcount; i++) {
+        arg->sval[i] = "";
+    }
+    arg->count = 0;
+}
+
+int arg_static_str_scan(void *parent, const char *argval)
+{
+    struct arg_str *arg = parent;
+    if (arg->count >= arg->hdr.maxcount) {
+        return ARG_ERR_MAXCOUNT;
+    }
+    if (argval) {
+        arg->sval[arg->count] = argval;
+    }
+    arg->count++;
+    return 0;
+}
+
+int arg_static_str_check(void *parent)
+{
+    struct arg_str *arg = parent;
+    return arg->count < arg->hdr.mincount ? ARG_ERR_MINCOUNT : 0;
+}
+
+void arg_static_str_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname)
+{
+    struct arg_str *arg = parent;
+    arg_dstr_catf(ds, "%s: ", progname ? progname : "");
+    print_count_error(ds, &arg->hdr, error, argval ? argval : "", "excess option ");
+}
+
+void arg_static_end_reset(void *parent)
+{
+    ((struct arg_end *)parent)->count = 0;
+}
+
+void arg_static_end_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname)
+{
+    (void)parent;
+    argval = argval ? argval : "";
+    arg_dstr_catf(ds, "%s: ", progname ? progname : "");
+    switch (error) {
+    case ARG_ELIMIT:
+        arg_dstr_cat(ds, "too many errors to display");
+        break;
+    case ARG_EMALLOC:
+        arg_dstr_cat(ds, "insufficient memory");
+        break;
+    case ARG_ENOMATCH:
+        arg_dstr_catf(ds, "unexpected argument \"%s\"", argval);
+        break;
+    case ARG_EMISSARG:
+        arg_dstr_catf(ds, "option \"%s\" requires an argument", argval);
+        break;
+    case ARG_ELONGOPT:
+        arg_dstr_catf(ds, "invalid option \"%s\"", argval);
+        break;
+    default:
+        arg_dstr_catf(ds, "invalid option \"-%c\"", error);
+        break;
+    }
+    arg_dstr_cat(ds, "\n");
+}
+
+static bool is_static(const struct arg_hdr *hdr)
+{
+    return hdr->scanfn == arg_static_lit_scan || hdr->scanfn == arg_static_int_scan ||
+           hdr->scanfn == arg_static_dbl_scan || hdr->scanfn == arg_static_str_scan;
+}
+
+static struct arg_hdr *find_short_option(struct arg_hdr **table, int count, char option)
+{
+    for (int i = 0; i < count; i++) {
+        if (table[i]->shortopts && strchr(table[i]->shortopts, option)) {
+            return table[i];
+        }
+    }
+    return NULL;
+}
+
+/* The long options of an entry are separated by commas, e.g. "help,usage" */
+static struct arg_hdr *find_long_option(struct arg_hdr **table, int count, const char *option, size_t len)
+{
+    for (int i = 0; i < count; i++) {
+        for (const char *name = table[i]->longopts; name && *name;) {
+            const char *comma = strchr(name, ',');
+            size_t name_len = comma ? (size_t)(comma - name) : strlen(name);
+            if (name_len == len && strncmp(name, option, len) == 0) {
+                return table[i];
+            }
+            name = comma ? comma + 1 : NULL;
+        }
+    }
+    return NULL;
+}
+
+/* Scan an untagged argument into the untagged entry at `*index`, or the next ones once full */
+static bool scan_untagged(struct arg_hdr **table, int count, int *index, const char *argval)
+{
+    for (; *index < count; (*index)++) {
+        struct arg_hdr *hdr = table[*index];
+        if (hdr->shortopts || hdr->longopts) {
+            continue;
+        }
+        int error = hdr->scanfn(hdr->parent, argval);
+        if (error != ARG_ERR_MAXCOUNT) {
+            return error == 0;
+        }
+    }
+    return false;
+}
+
+/* Scan the options of argv[*index], moving `*index` past a value taken from the next argument */
+static bool scan_option(struct arg_hdr **table, int count, int argc, char **argv, int *index)
+{
+    const char *arg = argv[*index];
+    const char *value;
+    struct arg_hdr *hdr;
+
+    if (arg[1] == '-') {
+        const char *name = arg + 2;
+        value = strchr(name, '=');
+        hdr = find_long_option(table, count, name, value ? (size_t)(value - name) : strlen(name));
+        if (!hdr) {
+            return false;
+        }
+        if (!(hdr->flag & ARG_HASVALUE)) {
+            return !value && hdr->scanfn(hdr->parent, NULL) == 0;
+        }
+        if (value) {
+            value++;
+        } else if (*index + 1 < argc) {
+            value = argv[++(*index)];
+        } else {
+            return false;
+        }
+        return hdr->scanfn(hdr->parent, value) == 0;
+    }
+
+    for (const char *option = arg + 1; *option; option++) {
+        hdr = find_short_option(table, count, *option);
+        if (!hdr) {
+            return false;
+        }
+        if (!(hdr->flag & ARG_HASVALUE)) {
+            if (hdr->scanfn(hdr->parent, NULL) != 0) {
+                return false;
+            }
+            continue;
+        }
+        if (option[1]) {
+            value = option + 1;
+        } else if (*index + 1 < argc) {
+            value = argv[++(*index)];
+        } else {
+            return false;
+        }
+        return hdr->scanfn(hdr->parent, value) == 0;
+    }
+    return true;
+}
+
+int arg_parse_fast(int argc, char **argv, void **argtable)
+{
+    struct arg_hdr **table = (struct arg_hdr **)argtable;
+    int count = 0;
+
+    for (; !(table[count]->flag & ARG_TERMINATOR); count++) {
+        if (!is_static(table[count])) {
+            return arg_parse(argc, argv, argtable);
+        }
+    }
+    for (int i = 0; i <= count; i++) {
+        if (table[i]->resetfn) {
+            table[i]->resetfn(table[i]->parent);
+        }
+    }
+
+    bool options = true;
+    int untagged = 0;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (options && strcmp(arg, "--") == 0) {
+            options = false;
+            continue;
+        }
+        bool ok = options && arg[0] == '-' && arg[1] ? scan_option(table, count, argc, argv, &i)
+                  : scan_untagged(table, count, &untagged, arg);
+        if (!ok) {
+            return arg_parse(argc, argv, argtable);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (table[i]->checkfn(table[i]->parent) != 0) {
+            return arg_parse(argc, argv, argtable);
+        }
+    }
+    return 0;
+}
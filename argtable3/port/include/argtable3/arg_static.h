@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "argtable3/argtable3.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Argument tables declared in static storage, without malloc()
+ *
+ * The macros below declare the same structures as arg_litn(), arg_intn(), arg_dbln(), arg_strn() and arg_end(),
+ * with their values in static arrays, so an argument table costs no allocation when a command is registered, and
+ * does not need arg_freetable(). The tables work with arg_parse(), arg_print_errors(), arg_print_syntax() and
+ * arg_print_glossary() as usual, and with arg_parse_fast() below. For instance:
+ *
+ *     ARG_INT_STATIC(timeout, "t", "timeout", "<ms>", 0, 1, "Timeout in milliseconds");
+ *     ARG_STR_STATIC(host, NULL, NULL, "<host>", 1, 1, "Host name");
+ *     ARG_END_STATIC(end, 4);
+ *
+ *     static struct {
+ *         struct arg_int *timeout;
+ *         struct arg_str *host;
+ *         struct arg_end *end;
+ *     } ping_args = { &timeout, &host, &end };
+ *
+ * `ping_args` can then be given as the `argtable` of an `esp_console_cmd_t`.
+ *
+ * The data type given to the macros must not be NULL: e.g. "<int>", "<double>" or "<string>", as chosen by the
+ * constructors by default.
+ */
+
+/* Callbacks of the static argument types, for the macros below */
+void arg_static_lit_reset(void *parent);
+int arg_static_lit_scan(void *parent, const char *argval);
+int arg_static_lit_check(void *parent);
+void arg_static_lit_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname);
+void arg_static_int_reset(void *parent);
+int arg_static_int_scan(void *parent, const char *argval);
+int arg_static_int_check(void *parent);
+void arg_static_int_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname);
+void arg_static_dbl_reset(void *parent);
+int arg_static_dbl_scan(void *parent, const char *argval);
+int arg_static_dbl_check(void *parent);
+void arg_static_dbl_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname);
+void arg_static_str_reset(void *parent);
+int arg_static_str_scan(void *parent, const char *argval);
+int arg_static_str_check(void *parent);
+void arg_static_str_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname);
+void arg_static_end_reset(void *parent);
+void arg_static_end_error(void *parent, arg_dstr_t ds, int error, const char *argval, const char *progname);
+
+#define ARG_STATIC_HDR(name, flags, short_opts, long_opts, data_type, gloss, min_count, max_count, type) \
+    {                                                                                                 \
+        .flag = (flags),                                                                              \
+        .shortopts = (short_opts),                                                                    \
+        .longopts = (long_opts),                                                                      \
+        .datatype = (data_type),                                                                      \
+        .glossary = (gloss),                                                                          \
+        .mincount = (min_count),                                                                      \
+        .maxcount = (max_count),                                                                      \
+        .parent = &name,                                                                              \
+        .resetfn = arg_static_##type##_reset,                                                         \
+        .scanfn = arg_static_##type##_scan,                                                           \
+        .checkfn = arg_static_##type##_check,                                                         \
+        .errorfn = arg_static_##type##_error,                                                         \
+    }
+
+/**
+ * @brief Declare a `struct arg_lit` called `name`, as `arg_litn()`
+ */
+#define ARG_LIT_STATIC(name, shortopts, longopts, mincount, maxcount, glossary)                       \
+    static struct arg_lit name = {                                                                    \
+        .hdr = ARG_STATIC_HDR(name, 0, shortopts, longopts, NULL, glossary, mincount, maxcount, lit), \
+    }
+
+/**
+ * @brief Declare a `struct arg_int` called `name`, as `arg_intn()`, with `maxcount` values
+ */
+#define ARG_INT_STATIC(name, shortopts, longopts, datatype, mincount, maxcount, glossary)                           \
+    static int name##_ival[(maxcount)];                                                                             \
+    static struct arg_int name = {                                                                                  \
+        .hdr = ARG_STATIC_HDR(name, ARG_HASVALUE, shortopts, longopts, datatype, glossary, mincount, maxcount, int), \
+        .ival = name##_ival,                                                                                        \
+    }
+
+/**
+ * @brief Declare a `struct arg_dbl` called `name`, as `arg_dbln()`, with `maxcount` values
+ */
+#define ARG_DBL_STATIC(name, shortopts, longopts, datatype, mincount, maxcount, glossary)                           \
+    static double name##_dval[(maxcount)];                                                                          \
+    static struct arg_dbl name = {                                                                                  \
+        .hdr = ARG_STATIC_HDR(name, ARG_HASVALUE, shortopts, longopts, datatype, glossary, mincount, maxcount, dbl), \
+        .dval = name##_dval,                                                                                        \
+    }
+
+/**
+ * @brief Declare a `struct arg_str` called `name`, as `arg_strn()`, with `maxcount` values
+ *
+ * The values are set to "" when the table is parsed, as `arg_strn()` does at construction.
+ */
+#define ARG_STR_STATIC(name, shortopts, longopts, datatype, mincount, maxcount, glossary)                           \
+    static const char *name##_sval[(maxcount)];                                                                     \
+    static struct arg_str name = {                                                                                  \
+        .hdr = ARG_STATIC_HDR(name, ARG_HASVALUE, shortopts, longopts, datatype, glossary, mincount, maxcount, str), \
+        .sval = name##_sval,                                                                                        \
+    }
+
+/**
+ * @brief Declare a `struct arg_end` called `name`, as `arg_end()`, recording up to `maxerrors` errors
+ */
+#define ARG_END_STATIC(name, maxerrors)              \
+    static int name##_error[(maxerrors)];            \
+    static void *name##_parent[(maxerrors)];         \
+    static const char *name##_argval[(maxerrors)];   \
+    static struct arg_end name = {                   \
+        .hdr = {                                     \
+            .flag = ARG_TERMINATOR,                  \
+            .mincount = 1,                           \
+            .maxcount = (maxerrors),                 \
+            .parent = &name,                         \
+            .resetfn = arg_static_end_reset,         \
+            .errorfn = arg_static_end_error,         \
+        },                                           \
+        .error = name##_error,                       \
+        .parent = name##_parent,                     \
+        .argval = name##_argval,                     \
+    }
+
+/**
+ * @brief Parse the command line, as `arg_parse()`, without getopt nor allocation when possible
+ *
+ * When the table is made only of entries declared with the `ARG_*_STATIC` macros, the arguments are matched
+ * directly against the options of the table: short options, grouped or not, with their value attached or in the
+ * next argument, exact long options, with `=value` or the value in the next argument, `--`, and untagged arguments,
+ * which fill the untagged entries in order. This avoids building the getopt option strings, which `arg_parse()`
+ * allocates at every call.
+ *
+ * Any other table, and any command line that does not parse cleanly this way, e.g. with an abbreviated long option,
+ * an invalid value or a missing option, is parsed again from the start by `arg_parse()`, so the results and the
+ * errors recorded in the `arg_end` are always those of `arg_parse()`.
+ *
+ * @param argc Number of arguments, including the program name
+ * @param argv Arguments, the first being the program name
+ * @param argtable Argument table, terminated by an `arg_end`
+ * @return Number of errors, as `arg_parse()`
+ */
+int arg_parse_fast(int argc, char **argv, void **argtable);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,8 @@
 #include <string.h>
 #include "unity.h"
 #include "argtable3/argtable3.h"
+#include "argtable3/arg_static.h"
+#include "esp_heap_caps.h"
 
 /* helper macros */
 #define ARG_TABLE_FREE(tbl) arg_freetable((tbl), sizeof(tbl)/sizeof(tbl[0]))
@@ -346,3 +348,75 @@ TEST_CASE("arg_parse: success and error cases", "[argtable3]")
 
     ARG_TABLE_FREE(argtable_fail);
 }
+
+/* ===================== Static tables ===================== */
+
+ARG_LIT_STATIC(static_verbose, "v", "verbose", 0, 2, "Verbose output");
+ARG_INT_STATIC(static_num, "n", "number", "<n>", 1, 2, "A required number");
+ARG_DBL_STATIC(static_ratio, "r", "ratio", "<r>", 0, 1, "An optional ratio");
+ARG_STR_STATIC(static_files, NULL, NULL, "<file>", 0, 3, "Files");
+ARG_END_STATIC(static_end, 4);
+
+static void *static_argtable[] = {&static_verbose, &static_num, &static_ratio, &static_files, &static_end};
+
+TEST_CASE("static argtable: arg_parse and arg_parse_fast give the same results", "[argtable3]")
+{
+    char *argv[] = {"prog", "-vn5", "a.txt", "--number=0x10", "-r", "2.5", "--", "-b.txt"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    TEST_ASSERT_EQUAL_INT(0, arg_parse_fast(argc, argv, static_argtable));
+    TEST_ASSERT_EQUAL_INT(1, static_verbose.count);
+    TEST_ASSERT_EQUAL_INT(2, static_num.count);
+    TEST_ASSERT_EQUAL_INT(5, static_num.ival[0]);
+    TEST_ASSERT_EQUAL_INT(16, static_num.ival[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, 2.5, static_ratio.dval[0]);
+    TEST_ASSERT_EQUAL_INT(2, static_files.count);
+    TEST_ASSERT_EQUAL_STRING("a.txt", static_files.sval[0]);
+    TEST_ASSERT_EQUAL_STRING("-b.txt", static_files.sval[1]);
+
+    char *argv_short[] = {"prog", "--number", "2KB"};
+    TEST_ASSERT_EQUAL_INT(0, arg_parse(3, argv_short, static_argtable));
+    TEST_ASSERT_EQUAL_INT(0, static_verbose.count);
+    TEST_ASSERT_EQUAL_INT(2048, static_num.ival[0]);
+    TEST_ASSERT_EQUAL_INT(0, static_files.count);
+    TEST_ASSERT_EQUAL_STRING("", static_files.sval[0]);
+}
+
+TEST_CASE("static argtable: arg_parse_fast does not allocate", "[argtable3]")
+{
+    char *argv[] = {"prog", "-v", "-n", "42", "file"};
+    int argc = sizeof(argv) / sizeof(argv[0]);
+
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_EQUAL_INT(0, arg_parse_fast(argc, argv, static_argtable));
+    TEST_ASSERT_EQUAL(free_before, heap_caps_get_free_size(MALLOC_CAP_DEFAULT));
+    TEST_ASSERT_EQUAL_INT(42, static_num.ival[0]);
+}
+
+TEST_CASE("static argtable: arg_parse_fast reports the errors of arg_parse", "[argtable3]")
+{
+    char *argv_missing[] = {"prog", "-v"};
+    TEST_ASSERT_GREATER_THAN(0, arg_parse_fast(2, argv_missing, static_argtable));
+
+    char buf[256] = {0};
+    FILE *f = fmemopen(buf, sizeof(buf), "w");
+    TEST_ASSERT_NOT_NULL(f);
+    arg_print_errors(f, &static_end, argv_missing[0]);
+    fclose(f);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "missing option"));
+
+    char *argv_invalid[] = {"prog", "-n", "NaN"};
+    TEST_ASSERT_GREATER_THAN(0, arg_parse_fast(3, argv_invalid, static_argtable));
+
+    memset(buf, 0, sizeof(buf));
+    f = fmemopen(buf, sizeof(buf), "w");
+    TEST_ASSERT_NOT_NULL(f);
+    arg_print_errors(f, &static_end, argv_invalid[0]);
+    fclose(f);
+    TEST_ASSERT_NOT_NULL(strstr(buf, "invalid argument \"NaN\""));
+
+    // Abbreviated long options are left to getopt
+    char *argv_abbrev[] = {"prog", "--num", "7"};
+    TEST_ASSERT_EQUAL_INT(0, arg_parse_fast(3, argv_abbrev, static_argtable));
+    TEST_ASSERT_EQUAL_INT(7, static_num.ival[0]);
+}
@@ -54,6 +54,22 @@ esp_err_t bdc_motor_disable(bdc_motor_handle_t motor);
  */
 esp_err_t bdc_motor_set_speed(bdc_motor_handle_t motor, uint32_t speed);
 
+/**
+ * @brief Set speed for bdc motor from ISR context
+ *
+ * @note Doesn't take any lock nor log, the new speed takes effect for both PWM channels at the start of the next
+ *       PWM period. The function is placed in IRAM with CONFIG_BDC_MOTOR_ISR_IRAM_SAFE.
+ *
+ * @param motor: BDC Motor handle
+ * @param speed: BDC speed
+ *
+ * @return
+ *      - ESP_OK: Set motor speed successfully
+ *      - ESP_ERR_INVALID_ARG: Set motor speed failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: Set motor speed failed because the backend has no ISR-safe path
+ */
+esp_err_t bdc_motor_set_speed_isr(bdc_motor_handle_t motor, uint32_t speed);
+
 /**
  * @brief Forward BDC motor
  *
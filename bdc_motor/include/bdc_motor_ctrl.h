@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/pulse_cnt.h"
+#include "pid_ctrl.h"
+#include "bdc_motor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief BDC Motor closed loop controller handle
+ */
+typedef struct bdc_motor_ctrl_t *bdc_motor_ctrl_handle_t;
+
+/**
+ * @brief Quantity controlled by a loop
+ */
+typedef enum {
+    BDC_MOTOR_CTRL_MODE_SPEED,    /*!< Control the speed, in encoder pulses per loop period */
+    BDC_MOTOR_CTRL_MODE_POSITION, /*!< Control the position, in encoder pulses since the start of the controller */
+} bdc_motor_ctrl_mode_t;
+
+/**
+ * @brief Configuration of the loop of one motor
+ */
+typedef struct {
+    bdc_motor_handle_t motor;        /*!< Motor driven by the loop, enabled by the caller */
+    pcnt_unit_handle_t pcnt_unit;    /*!< PCNT unit counting the encoder pulses, enabled and started by the caller */
+    pid_ctrl_block_handle_t pid;     /*!< PID control block of the loop, its output is the signed motor speed */
+    bdc_motor_ctrl_mode_t mode;      /*!< Quantity controlled by the loop */
+} bdc_motor_ctrl_loop_config_t;
+
+/**
+ * @brief BDC Motor closed loop controller configuration
+ */
+typedef struct {
+    const bdc_motor_ctrl_loop_config_t *loops; /*!< Loops, one per motor, sampled and computed in the same period */
+    size_t loop_num;                           /*!< Number of loops */
+    uint32_t loop_freq_hz;                     /*!< Loop frequency, in Hz */
+    uint32_t task_priority;                    /*!< Priority of the loop task, typically above all the other tasks */
+    uint32_t task_stack_size;                  /*!< Stack size of the loop task, in bytes */
+    int task_core_id;                          /*!< Core the loop task is pinned to, or tskNO_AFFINITY */
+} bdc_motor_ctrl_config_t;
+
+/**
+ * @brief Timing statistics of the controller
+ */
+typedef struct {
+    uint32_t loop_count;          /*!< Number of periods run */
+    uint32_t overrun_count;       /*!< Number of periods skipped because the previous one hadn't finished */
+    uint32_t max_latency_us;      /*!< Maximum delay from the timer alarm to the start of a period */
+    uint32_t avg_latency_us;      /*!< Average delay from the timer alarm to the start of a period */
+    uint32_t max_jitter_us;       /*!< Maximum deviation of the interval between two periods from the loop period */
+    uint32_t max_run_time_us;     /*!< Maximum time taken by one period, all the loops included */
+} bdc_motor_ctrl_stats_t;
+
+/**
+ * @brief Create a closed loop controller, running the loops of one or several motors from a hardware timer
+ *
+ * @note Each period, all the PCNT units are read first, then the PID of each loop is computed and its output is
+ *       applied to its motor: the sign selects the direction and the magnitude is the speed.
+ *
+ * @param config: Controller configuration
+ * @param ret_ctrl: Returned controller handle
+ * @return
+ *      - ESP_OK: Create controller successfully
+ *      - ESP_ERR_INVALID_ARG: Create controller failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create controller failed because of out of memory
+ *      - ESP_FAIL: Create controller failed because some other error
+ */
+esp_err_t bdc_motor_ctrl_new(const bdc_motor_ctrl_config_t *config, bdc_motor_ctrl_handle_t *ret_ctrl);
+
+/**
+ * @brief Delete the controller, which must be stopped
+ *
+ * @param ctrl: Controller handle
+ * @return
+ *      - ESP_OK: Delete controller successfully
+ *      - ESP_ERR_INVALID_ARG: Delete controller failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Delete controller failed because it is running
+ */
+esp_err_t bdc_motor_ctrl_del(bdc_motor_ctrl_handle_t ctrl);
+
+/**
+ * @brief Start the loops, from the current encoder counts and reset PID control blocks
+ *
+ * @param ctrl: Controller handle
+ * @return
+ *      - ESP_OK: Start controller successfully
+ *      - ESP_ERR_INVALID_ARG: Start controller failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Start controller failed because it is already running
+ *      - ESP_FAIL: Start controller failed because some other error
+ */
+esp_err_t bdc_motor_ctrl_start(bdc_motor_ctrl_handle_t ctrl);
+
+/**
+ * @brief Stop the loops and set the speed of the motors to 0
+ *
+ * @param ctrl: Controller handle
+ * @return
+ *      - ESP_OK: Stop controller successfully
+ *      - ESP_ERR_INVALID_ARG: Stop controller failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Stop controller failed because it is not running
+ *      - ESP_FAIL: Stop controller failed because some other error
+ */
+esp_err_t bdc_motor_ctrl_stop(bdc_motor_ctrl_handle_t ctrl);
+
+/**
+ * @brief Set the target of a loop, in encoder pulses per period for speed loops and in pulses for position loops
+ *
+ * @param ctrl: Controller handle
+ * @param loop: Index of the loop in the configuration
+ * @param target: Target speed or position, negative for the reverse direction
+ * @return
+ *      - ESP_OK: Set target successfully
+ *      - ESP_ERR_INVALID_ARG: Set target failed because of invalid argument
+ */
+esp_err_t bdc_motor_ctrl_set_target(bdc_motor_ctrl_handle_t ctrl, size_t loop, int target);
+
+/**
+ * @brief Get the last measured speed or position of a loop, in the unit of its target
+ *
+ * @param ctrl: Controller handle
+ * @param loop: Index of the loop in the configuration
+ * @param ret_feedback: Returned measurement
+ * @return
+ *      - ESP_OK: Get measurement successfully
+ *      - ESP_ERR_INVALID_ARG: Get measurement failed because of invalid argument
+ */
+esp_err_t bdc_motor_ctrl_get_feedback(bdc_motor_ctrl_handle_t ctrl, size_t loop, int *ret_feedback);
+
+/**
+ * @brief Get the timing statistics of the controller, since its creation or the last reset
+ *
+ * @param ctrl: Controller handle
+ * @param ret_stats: Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ */
+esp_err_t bdc_motor_ctrl_get_stats(bdc_motor_ctrl_handle_t ctrl, bdc_motor_ctrl_stats_t *ret_stats);
+
+/**
+ * @brief Reset the timing statistics of the controller
+ *
+ * @param ctrl: Controller handle
+ * @return
+ *      - ESP_OK: Reset statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Reset statistics failed because of invalid argument
+ */
+esp_err_t bdc_motor_ctrl_reset_stats(bdc_motor_ctrl_handle_t ctrl);
+
+#ifdef __cplusplus
+}
+#endif
@@ -55,6 +55,20 @@ struct bdc_motor_t {
      */
     esp_err_t (*set_speed)(bdc_motor_t *motor, uint32_t speed);
 
+    /**
+     * @brief Set speed for bdc motor from ISR context, optional
+     *
+     * @note Must not take locks nor log, and be placed in IRAM with CONFIG_BDC_MOTOR_ISR_IRAM_SAFE
+     *
+     * @param motor: BDC Motor handle
+     * @param speed: BDC speed
+     *
+     * @return
+     *      - ESP_OK: Set motor speed successfully
+     *      - ESP_ERR_INVALID_ARG: Set motor speed failed because of invalid parameters
+     */
+    esp_err_t (*set_speed_isr)(bdc_motor_t *motor, uint32_t speed);
+
     /**
      * @brief Forward BDC motor
      *
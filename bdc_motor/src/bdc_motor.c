@@ -31,6 +31,13 @@ esp_err_t bdc_motor_set_speed(bdc_motor_handle_t motor, uint32_t speed)
     return motor->set_speed(motor, speed);
 }
 
+esp_err_t bdc_motor_set_speed_isr(bdc_motor_handle_t motor, uint32_t speed)
+{
+    ESP_RETURN_ON_FALSE_ISR(motor, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE_ISR(motor->set_speed_isr, ESP_ERR_NOT_SUPPORTED, TAG, "set speed from ISR not supported");
+    return motor->set_speed_isr(motor, speed);
+}
+
 esp_err_t bdc_motor_forward(bdc_motor_handle_t motor)
 {
     ESP_RETURN_ON_FALSE(motor, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
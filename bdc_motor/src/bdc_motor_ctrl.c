@@ -0,0 +1,286 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "driver/gptimer.h"
+#include "bdc_motor_ctrl.h"
+
+#define BDC_MOTOR_CTRL_TIMER_RESOLUTION_HZ 1000000 // 1 tick = 1 us
+
+static const char *TAG = "bdc_motor_ctrl";
+
+typedef struct {
+    bdc_motor_ctrl_loop_config_t config;
+    volatile int target;   // set by the user, read by the loop task
+    volatile int feedback; // set by the loop task, read by the user
+    int last_count;        // encoder count of the previous period
+    int count;             // encoder count of the current period
+    int direction;         // direction the motor was last set to, 1 forward, -1 reverse, 0 not set yet
+} bdc_motor_ctrl_loop_t;
+
+typedef struct bdc_motor_ctrl_t {
+    gptimer_handle_t timer;
+    TaskHandle_t task;
+    SemaphoreHandle_t period_lock; // held by the loop task during a period
+    portMUX_TYPE stats_lock;
+    bool running;
+    uint32_t period_us;
+    int64_t last_start_us;
+    uint64_t latency_sum_us;
+    bdc_motor_ctrl_stats_t stats;
+    size_t loop_num;
+    bdc_motor_ctrl_loop_t loops[];
+} bdc_motor_ctrl_t;
+
+static bool IRAM_ATTR bdc_motor_ctrl_on_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx)
+{
+    bdc_motor_ctrl_t *ctrl = (bdc_motor_ctrl_t *)user_ctx;
+    BaseType_t task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(ctrl->task, &task_woken);
+    return task_woken == pdTRUE;
+}
+
+static void bdc_motor_ctrl_apply(bdc_motor_ctrl_loop_t *loop, float output)
+{
+    int direction = output < 0 ? -1 : 1;
+    if (direction != loop->direction) {
+        if (direction > 0) {
+            bdc_motor_forward(loop->config.motor);
+        } else {
+            bdc_motor_reverse(loop->config.motor);
+        }
+        loop->direction = direction;
+    }
+    bdc_motor_set_speed(loop->config.motor, (uint32_t)fabsf(output));
+}
+
+static void bdc_motor_ctrl_update_stats(bdc_motor_ctrl_t *ctrl, uint32_t alarms, uint32_t latency_us, int64_t start_us, int64_t end_us)
+{
+    portENTER_CRITICAL(&ctrl->stats_lock);
+    bdc_motor_ctrl_stats_t *stats = &ctrl->stats;
+    stats->loop_count++;
+    stats->overrun_count += alarms - 1;
+    stats->max_latency_us = MAX(stats->max_latency_us, latency_us);
+    ctrl->latency_sum_us += latency_us;
+    // The first period after a start has no previous one
+    if (ctrl->last_start_us) {
+        int64_t interval_us = start_us - ctrl->last_start_us;
+        uint32_t jitter_us = (uint32_t)llabs(interval_us - (int64_t)ctrl->period_us * alarms);
+        stats->max_jitter_us = MAX(stats->max_jitter_us, jitter_us);
+    }
+    stats->max_run_time_us = MAX(stats->max_run_time_us, (uint32_t)(end_us - start_us));
+    ctrl->last_start_us = start_us;
+    portEXIT_CRITICAL(&ctrl->stats_lock);
+}
+
+static void bdc_motor_ctrl_task(void *arg)
+{
+    bdc_motor_ctrl_t *ctrl = (bdc_motor_ctrl_t *)arg;
+    while (true) {
+        // More than one notification means the previous period overran the following alarms
+        uint32_t alarms = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        // With auto reload, the raw count is the time elapsed since the alarm
+        uint64_t latency_ticks = 0;
+        gptimer_get_raw_count(ctrl->timer, &latency_ticks);
+        int64_t start_us = esp_timer_get_time();
+
+        xSemaphoreTake(ctrl->period_lock, portMAX_DELAY);
+        if (!ctrl->running) {
+            xSemaphoreGive(ctrl->period_lock);
+            continue;
+        }
+        // Sample all the encoders first, so that the loops see the same instant
+        for (size_t i = 0; i < ctrl->loop_num; i++) {
+            pcnt_unit_get_count(ctrl->loops[i].config.pcnt_unit, &ctrl->loops[i].count);
+        }
+        for (size_t i = 0; i < ctrl->loop_num; i++) {
+            bdc_motor_ctrl_loop_t *loop = &ctrl->loops[i];
+            int feedback = loop->count;
+            if (loop->config.mode == BDC_MOTOR_CTRL_MODE_SPEED) {
+                feedback = (loop->count - loop->last_count) / (int)alarms;
+                loop->last_count = loop->count;
+            }
+            loop->feedback = feedback;
+            float output = 0;
+            pid_compute(loop->config.pid, (float)(loop->target - feedback), &output);
+            bdc_motor_ctrl_apply(loop, output);
+        }
+        xSemaphoreGive(ctrl->period_lock);
+
+        bdc_motor_ctrl_update_stats(ctrl, alarms, (uint32_t)latency_ticks, start_us, esp_timer_get_time());
+    }
+}
+
+esp_err_t bdc_motor_ctrl_new(const bdc_motor_ctrl_config_t *config, bdc_motor_ctrl_handle_t *ret_ctrl)
+{
+    bdc_motor_ctrl_t *ctrl = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(config && ret_ctrl && config->loops && config->loop_num, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->loop_freq_hz && config->loop_freq_hz <= BDC_MOTOR_CTRL_TIMER_RESOLUTION_HZ / 2, ESP_ERR_INVALID_ARG,
+                      err, TAG, "invalid loop frequency");
+    for (size_t i = 0; i < config->loop_num; i++) {
+        const bdc_motor_ctrl_loop_config_t *loop = &config->loops[i];
+        ESP_GOTO_ON_FALSE(loop->motor && loop->pcnt_unit && loop->pid, ESP_ERR_INVALID_ARG, err, TAG, "invalid loop %u", (unsigned)i);
+    }
+    // Everything the loop uses is allocated here, a period doesn't allocate memory
+    ctrl = calloc(1, sizeof(bdc_motor_ctrl_t) + config->loop_num * sizeof(bdc_motor_ctrl_loop_t));
+    ESP_GOTO_ON_FALSE(ctrl, ESP_ERR_NO_MEM, err, TAG, "no mem for controller");
+    ctrl->stats_lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+    ctrl->period_us = BDC_MOTOR_CTRL_TIMER_RESOLUTION_HZ / config->loop_freq_hz;
+    ctrl->loop_num = config->loop_num;
+    for (size_t i = 0; i < config->loop_num; i++) {
+        ctrl->loops[i].config = config->loops[i];
+    }
+    ctrl->period_lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(ctrl->period_lock, ESP_ERR_NO_MEM, err, TAG, "no mem for period lock");
+    ESP_GOTO_ON_FALSE(xTaskCreatePinnedToCore(bdc_motor_ctrl_task, "bdc_motor_ctrl", config->task_stack_size, ctrl,
+                                              config->task_priority, &ctrl->task, config->task_core_id) == pdPASS,
+                      ESP_ERR_NO_MEM, err, TAG, "create loop task failed");
+
+    gptimer_config_t timer_config = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = BDC_MOTOR_CTRL_TIMER_RESOLUTION_HZ,
+    };
+    ESP_GOTO_ON_ERROR(gptimer_new_timer(&timer_config, &ctrl->timer), err, TAG, "create timer failed");
+    gptimer_event_callbacks_t cbs = {
+        .on_alarm = bdc_motor_ctrl_on_alarm,
+    };
+    ESP_GOTO_ON_ERROR(gptimer_register_event_callbacks(ctrl->timer, &cbs, ctrl), err, TAG, "register timer callbacks failed");
+    gptimer_alarm_config_t alarm_config = {
+        .alarm_count = ctrl->period_us,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_GOTO_ON_ERROR(gptimer_set_alarm_action(ctrl->timer, &alarm_config), err, TAG, "set timer alarm failed");
+    ESP_GOTO_ON_ERROR(gptimer_enable(ctrl->timer), err, TAG, "enable timer failed");
+    *ret_ctrl = ctrl;
+    return ESP_OK;
+
+err:
+    if (ctrl) {
+        if (ctrl->timer) {
+            gptimer_del_timer(ctrl->timer);
+        }
+        if (ctrl->task) {
+            vTaskDelete(ctrl->task);
+        }
+        if (ctrl->period_lock) {
+            vSemaphoreDelete(ctrl->period_lock);
+        }
+        free(ctrl);
+    }
+    return ret;
+}
+
+esp_err_t bdc_motor_ctrl_del(bdc_motor_ctrl_handle_t ctrl)
+{
+    ESP_RETURN_ON_FALSE(ctrl, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!ctrl->running, ESP_ERR_INVALID_STATE, TAG, "controller is running");
+    ESP_RETURN_ON_ERROR(gptimer_disable(ctrl->timer), TAG, "disable timer failed");
+    gptimer_del_timer(ctrl->timer);
+    // The task may still be woken by the last alarm, holding the lock makes sure it's not in a period
+    xSemaphoreTake(ctrl->period_lock, portMAX_DELAY);
+    vTaskDelete(ctrl->task);
+    xSemaphoreGive(ctrl->period_lock);
+    vSemaphoreDelete(ctrl->period_lock);
+    free(ctrl);
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_start(bdc_motor_ctrl_handle_t ctrl)
+{
+    ESP_RETURN_ON_FALSE(ctrl, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!ctrl->running, ESP_ERR_INVALID_STATE, TAG, "controller is already running");
+    xSemaphoreTake(ctrl->period_lock, portMAX_DELAY);
+    for (size_t i = 0; i < ctrl->loop_num; i++) {
+        bdc_motor_ctrl_loop_t *loop = &ctrl->loops[i];
+        pcnt_unit_get_count(loop->config.pcnt_unit, &loop->last_count);
+        if (loop->config.mode == BDC_MOTOR_CTRL_MODE_POSITION) {
+            // Positions are relative to the start
+            pcnt_unit_clear_count(loop->config.pcnt_unit);
+            loop->last_count = 0;
+        }
+        loop->direction = 0;
+        pid_reset_ctrl_block(loop->config.pid);
+    }
+    portENTER_CRITICAL(&ctrl->stats_lock);
+    ctrl->last_start_us = 0;
+    portEXIT_CRITICAL(&ctrl->stats_lock);
+    ctrl->running = true;
+    xSemaphoreGive(ctrl->period_lock);
+
+    esp_err_t ret = gptimer_set_raw_count(ctrl->timer, 0);
+    if (ret == ESP_OK) {
+        ret = gptimer_start(ctrl->timer);
+    }
+    if (ret != ESP_OK) {
+        ctrl->running = false;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "start timer failed");
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_stop(bdc_motor_ctrl_handle_t ctrl)
+{
+    ESP_RETURN_ON_FALSE(ctrl, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(ctrl->running, ESP_ERR_INVALID_STATE, TAG, "controller is not running");
+    ESP_RETURN_ON_ERROR(gptimer_stop(ctrl->timer), TAG, "stop timer failed");
+    // Wait for the period in progress, the following ones are skipped
+    xSemaphoreTake(ctrl->period_lock, portMAX_DELAY);
+    ctrl->running = false;
+    for (size_t i = 0; i < ctrl->loop_num; i++) {
+        bdc_motor_set_speed(ctrl->loops[i].config.motor, 0);
+    }
+    xSemaphoreGive(ctrl->period_lock);
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_set_target(bdc_motor_ctrl_handle_t ctrl, size_t loop, int target)
+{
+    ESP_RETURN_ON_FALSE(ctrl && loop < ctrl->loop_num, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ctrl->loops[loop].target = target;
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_get_feedback(bdc_motor_ctrl_handle_t ctrl, size_t loop, int *ret_feedback)
+{
+    ESP_RETURN_ON_FALSE(ctrl && loop < ctrl->loop_num && ret_feedback, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_feedback = ctrl->loops[loop].feedback;
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_get_stats(bdc_motor_ctrl_handle_t ctrl, bdc_motor_ctrl_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(ctrl && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&ctrl->stats_lock);
+    *ret_stats = ctrl->stats;
+    uint64_t latency_sum_us = ctrl->latency_sum_us;
+    portEXIT_CRITICAL(&ctrl->stats_lock);
+    ret_stats->avg_latency_us = ret_stats->loop_count ? (uint32_t)(latency_sum_us / ret_stats->loop_count) : 0;
+    return ESP_OK;
+}
+
+esp_err_t bdc_motor_ctrl_reset_stats(bdc_motor_ctrl_handle_t ctrl)
+{
+    ESP_RETURN_ON_FALSE(ctrl, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&ctrl->stats_lock);
+    memset(&ctrl->stats, 0, sizeof(ctrl->stats));
+    ctrl->latency_sum_us = 0;
+    ctrl->last_start_us = 0;
+    portEXIT_CRITICAL(&ctrl->stats_lock);
+    return ESP_OK;
+}
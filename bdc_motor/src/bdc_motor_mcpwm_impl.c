@@ -8,10 +8,17 @@
 #include <sys/cdefs.h>
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
 #include "driver/mcpwm_prelude.h"
 #include "bdc_motor.h"
 #include "bdc_motor_interface.h"
 
+#if CONFIG_BDC_MOTOR_ISR_IRAM_SAFE
+#define BDC_MOTOR_MEM_ALLOC_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#else
+#define BDC_MOTOR_MEM_ALLOC_CAPS MALLOC_CAP_DEFAULT
+#endif
+
 static const char *TAG = "bdc_motor_mcpwm";
 
 typedef struct {
@@ -32,6 +39,17 @@ static esp_err_t bdc_motor_mcpwm_set_speed(bdc_motor_t *motor, uint32_t speed)
     return ESP_OK;
 }
 
+// The comparators are updated on TEZ, so both channels switch to the new compare value at the same period boundary
+static esp_err_t bdc_motor_mcpwm_set_speed_isr(bdc_motor_t *motor, uint32_t speed)
+{
+    bdc_motor_mcpwm_obj *mcpwm_motor = __containerof(motor, bdc_motor_mcpwm_obj, base);
+    esp_err_t ret = mcpwm_comparator_set_compare_value(mcpwm_motor->cmpa, speed);
+    if (ret == ESP_OK) {
+        ret = mcpwm_comparator_set_compare_value(mcpwm_motor->cmpb, speed);
+    }
+    return ret;
+}
+
 static esp_err_t bdc_motor_mcpwm_enable(bdc_motor_t *motor)
 {
     bdc_motor_mcpwm_obj *mcpwm_motor = __containerof(motor, bdc_motor_mcpwm_obj, base);
@@ -98,7 +116,7 @@ esp_err_t bdc_motor_new_mcpwm_device(const bdc_motor_config_t *motor_config, con
     bdc_motor_mcpwm_obj *mcpwm_motor = NULL;
     esp_err_t ret = ESP_OK;
     ESP_GOTO_ON_FALSE(motor_config && mcpwm_config && ret_motor, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
-    mcpwm_motor = calloc(1, sizeof(bdc_motor_mcpwm_obj));
+    mcpwm_motor = heap_caps_calloc(1, sizeof(bdc_motor_mcpwm_obj), BDC_MOTOR_MEM_ALLOC_CAPS);
     ESP_GOTO_ON_FALSE(mcpwm_motor, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt motor");
 
     // mcpwm timer
@@ -155,6 +173,7 @@ esp_err_t bdc_motor_new_mcpwm_device(const bdc_motor_config_t *motor_config, con
     mcpwm_motor->base.coast = bdc_motor_mcpwm_coast;
     mcpwm_motor->base.brake = bdc_motor_mcpwm_brake;
     mcpwm_motor->base.set_speed = bdc_motor_mcpwm_set_speed;
+    mcpwm_motor->base.set_speed_isr = bdc_motor_mcpwm_set_speed_isr;
     mcpwm_motor->base.del = bdc_motor_mcpwm_del;
     *ret_motor = &mcpwm_motor->base;
     return ESP_OK;
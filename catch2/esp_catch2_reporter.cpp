@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ * Note: same license as Catch2
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <ostream>
+#include <string>
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/interfaces/catch_interfaces_reporter.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+
+/*
+ * "json-lines" reporter: one JSON object per line, for the results to be parsed from the console output, e.g. by
+ * pytest-embedded, among the logs of the application. The "JSON" reporter of Catch2 writes one document for the whole
+ * run, which is harder to pick out of a serial log.
+ */
+
+namespace {
+
+std::string json_string(const std::string &str)
+{
+    std::string out = "\"";
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                out += esc;
+            } else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+class JsonLinesReporter : public Catch::StreamingReporterBase {
+public:
+    using StreamingReporterBase::StreamingReporterBase;
+
+    static std::string getDescription()
+    {
+        return "Reports each test case and benchmark as a JSON object on its own line";
+    }
+
+    void testCaseStarting(Catch::TestCaseInfo const &info) override
+    {
+        StreamingReporterBase::testCaseStarting(info);
+        m_test_case = info.name;
+    }
+
+    void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override
+    {
+        char line[320];
+        snprintf(line, sizeof(line),
+                 "\"samples\":%u,\"iterations\":%d,\"mean_ns\":%.1f,\"mean_low_ns\":%.1f,\"mean_high_ns\":%.1f,"
+                 "\"std_dev_ns\":%.1f,\"outliers\":%d,\"clock_resolution_ns\":%.1f",
+                 stats.info.samples, stats.info.iterations, stats.mean.point.count(), stats.mean.lower_bound.count(),
+                 stats.mean.upper_bound.count(), stats.standardDeviation.point.count(), stats.outliers.total(),
+                 stats.info.clockResolution);
+        m_stream << "{\"type\":\"benchmark\",\"test_case\":" << json_string(m_test_case)
+                 << ",\"name\":" << json_string(stats.info.name) << ',' << line << "}\n";
+        m_stream.flush();
+    }
+
+    void testCaseEnded(Catch::TestCaseStats const &stats) override
+    {
+        m_stream << "{\"type\":\"test_case\",\"name\":" << json_string(stats.testInfo->name)
+                 << ",\"passed\":" << (stats.totals.assertions.allOk() ? "true" : "false")
+                 << ",\"assertions\":" << stats.totals.assertions.total()
+                 << ",\"failed\":" << stats.totals.assertions.failed << "}\n";
+        m_stream.flush();
+        StreamingReporterBase::testCaseEnded(stats);
+    }
+
+    void testRunEnded(Catch::TestRunStats const &stats) override
+    {
+        m_stream << "{\"type\":\"summary\",\"test_cases\":" << stats.totals.testCases.total()
+                 << ",\"failed_test_cases\":" << stats.totals.testCases.failed
+                 << ",\"assertions\":" << stats.totals.assertions.total()
+                 << ",\"failed_assertions\":" << stats.totals.assertions.failed << "}\n";
+        m_stream.flush();
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+private:
+    std::string m_test_case;
+};
+
+} // namespace
+
+CATCH_REGISTER_REPORTER("json-lines", JsonLinesReporter)
+
+/* Referenced from the CMake of the component, so that the linker keeps the registration of the reporter */
+extern "C" void esp_catch2_reporter_include(void)
+{
+}
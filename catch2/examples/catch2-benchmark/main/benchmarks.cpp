@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+
+TEST_CASE("memcpy")
+{
+    static uint8_t src[1024], dst[1024];
+    std::iota(std::begin(src), std::end(src), 0);
+
+    ESP_BENCHMARK("memcpy 1 KB") {
+        memcpy(dst, src, sizeof(dst));
+        return dst[sizeof(dst) - 1];
+    };
+    REQUIRE(memcmp(dst, src, sizeof(dst)) == 0);
+}
+
+TEST_CASE("std::sort")
+{
+    std::vector<int> values(256);
+
+    // Only the sort is timed, not the shuffle preparing each run
+    ESP_BENCHMARK_ADVANCED("sort 256 ints")(Catch::Benchmark::Chronometer meter) {
+        std::vector<std::vector<int>> runs(meter.runs(), values);
+        for (auto &run : runs) {
+            std::iota(run.begin(), run.end(), 0);
+            std::reverse(run.begin(), run.end());
+        }
+        meter.measure([&](int i) {
+            std::sort(runs[i].begin(), runs[i].end());
+        });
+    };
+}
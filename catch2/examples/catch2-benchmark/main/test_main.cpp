@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <catch2/catch_session.hpp>
+
+extern "C" void app_main(void)
+{
+    // The benchmarks are timed with the cycle counter of the core running them: the main task is pinned to a core
+    int argc = 5;
+    const char *argv[6] = {
+        "target_benchmark_main",
+        "--reporter", "json-lines",
+        "--benchmark-samples", "20",
+        NULL
+    };
+
+    auto result = Catch::Session().run(argc, argv);
+    if (result != 0) {
+        printf("Benchmark failed with result %d\n", result);
+    } else {
+        printf("Benchmark passed.\n");
+    }
+}
@@ -0,0 +1,23 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Unlicense OR CC0-1.0
+
+import json
+
+import pytest
+from pytest_embedded import Dut
+
+
+@pytest.mark.generic
+def test_catch2_benchmark_example(dut: Dut) -> None:
+    results = {}
+    while True:
+        line = json.loads(dut.expect(r'(\{"type":.*\})\r?\n').group(1).decode())
+        if line['type'] == 'benchmark':
+            results[line['name']] = line
+        elif line['type'] == 'summary':
+            break
+    assert line['failed_assertions'] == 0
+    assert set(results) == {'memcpy 1 KB', 'sort 256 ints'}
+    for result in results.values():
+        assert 0 < result['mean_low_ns'] <= result['mean_ns'] <= result['mean_high_ns']
+    dut.expect_exact('Benchmark passed.')
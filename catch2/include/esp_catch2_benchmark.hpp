@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: BSL-1.0
+ * Note: same license as Catch2
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ratio>
+#include <string>
+#include <utility>
+#include "sdkconfig.h"
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/interfaces/catch_interfaces_config.hpp>
+#include <catch2/internal/catch_context.hpp>
+#if !CONFIG_IDF_TARGET_LINUX
+#include "esp_cpu.h"
+#endif
+
+namespace esp_catch2 {
+
+#if !CONFIG_IDF_TARGET_LINUX
+/**
+ * @brief Clock counting the CPU cycles, for the benchmarks of Catch2
+ *
+ * `std::chrono::steady_clock`, used by BENCHMARK(), counts microseconds; this clock counts the cycles of the CPU
+ * running the benchmark, with a period of 1 / CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ us. The 32-bit cycle counter is extended
+ * to 64 bits, which needs a read every few seconds, as Catch2 does while benchmarking.
+ *
+ * @note Each core has its own cycle counter: the benchmarks must run in a task pinned to a core, e.g. the main task,
+ *       and at the default CPU frequency, without dynamic frequency scaling
+ */
+struct cpu_cycle_clock {
+    using rep = int64_t;
+    using period = std::ratio<1, CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000LL>;
+    using duration = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<cpu_cycle_clock, duration>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+        static uint32_t s_last;
+        static int64_t s_high;
+        uint32_t cycles = esp_cpu_get_cycle_count();
+        if (cycles < s_last) {
+            s_high += INT64_C(1) << 32;
+        }
+        s_last = cycles;
+        return time_point(duration(s_high + cycles));
+    }
+};
+
+using benchmark_clock = cpu_cycle_clock;
+#else
+using benchmark_clock = std::chrono::steady_clock;
+#endif
+
+/* Runs a Catch2 benchmark with a given clock, as Catch::Benchmark::Benchmark does with the default one */
+template <typename Clock>
+struct clocked_benchmark {
+    std::string name;
+
+    template <typename Fun>
+    clocked_benchmark &operator=(Fun func)
+    {
+        if (!Catch::getCurrentContext().getConfig()->skipBenchmarks()) {
+            Catch::Benchmark::Benchmark benchmark(std::move(name), std::move(func));
+            benchmark.template run<Clock>();
+        }
+        return *this;
+    }
+
+    explicit operator bool()
+    {
+        return true;
+    }
+};
+
+} // namespace esp_catch2
+
+#define INTERNAL_ESP_BENCHMARK(var, name) \
+    if (esp_catch2::clocked_benchmark<esp_catch2::benchmark_clock> var{name}) \
+        var = [&]
+
+/**
+ * @brief BENCHMARK() of Catch2, timed with the CPU cycle counter
+ *
+ * @code{cpp}
+ * ESP_BENCHMARK("sort 64 ints") {
+ *     std::sort(v.begin(), v.end());
+ *     return v[0];
+ * };
+ * @endcode
+ */
+#define ESP_BENCHMARK(name) INTERNAL_ESP_BENCHMARK(INTERNAL_CATCH_UNIQUE_NAME(esp_catch2_benchmark), name)()
+
+/**
+ * @brief BENCHMARK_ADVANCED() of Catch2, timed with the CPU cycle counter, followed by a lambda taking a
+ *        `Catch::Benchmark::Chronometer`
+ */
+#define ESP_BENCHMARK_ADVANCED(name) INTERNAL_ESP_BENCHMARK(INTERNAL_CATCH_UNIQUE_NAME(esp_catch2_benchmark), name)
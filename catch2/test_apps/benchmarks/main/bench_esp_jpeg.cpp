@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "jpeg_decoder.h"
+
+// 160x120 frame of a USB camera, from the esp_jpeg test app
+extern const uint8_t jpg_start[] asm("_binary_usb_camera_2_jpg_start");
+extern const uint8_t jpg_end[] asm("_binary_usb_camera_2_jpg_end");
+
+#define BENCH_W     160
+#define BENCH_H     120
+
+TEST_CASE("esp_jpeg")
+{
+    static uint8_t outbuf[BENCH_W * BENCH_H * 3];
+    esp_jpeg_image_cfg_t cfg = {};
+    cfg.indata = (uint8_t *)jpg_start;
+    cfg.indata_size = jpg_end - jpg_start;
+    cfg.outbuf = outbuf;
+    cfg.outbuf_size = sizeof(outbuf);
+    cfg.out_format = JPEG_IMAGE_FORMAT_RGB565;
+    cfg.out_scale = JPEG_IMAGE_SCALE_0;
+    cfg.advanced.backend = JPEG_DECODER_BACKEND_SOFTWARE;
+    esp_jpeg_image_output_t img;
+
+    esp_jpeg_decoder_handle_t decoder;
+    REQUIRE(esp_jpeg_decoder_new(NULL, &decoder) == ESP_OK);
+    REQUIRE(esp_jpeg_decoder_decode(decoder, &cfg, &img) == ESP_OK);
+    REQUIRE(img.width == BENCH_W);
+    REQUIRE(img.height == BENCH_H);
+
+    ESP_BENCHMARK("esp_jpeg decode 160x120 RGB565") {
+        return esp_jpeg_decoder_decode(decoder, &cfg, &img);
+    };
+
+    cfg.out_format = JPEG_IMAGE_FORMAT_RGB888;
+    ESP_BENCHMARK("esp_jpeg decode 160x120 RGB888") {
+        return esp_jpeg_decoder_decode(decoder, &cfg, &img);
+    };
+
+    cfg.out_format = JPEG_IMAGE_FORMAT_GRAY;
+    ESP_BENCHMARK("esp_jpeg decode 160x120 grayscale") {
+        return esp_jpeg_decoder_decode(decoder, &cfg, &img);
+    };
+
+    cfg.out_format = JPEG_IMAGE_FORMAT_RGB565;
+    cfg.out_scale = JPEG_IMAGE_SCALE_1_4;
+    ESP_BENCHMARK("esp_jpeg decode 160x120 RGB565 scale 1/4") {
+        return esp_jpeg_decoder_decode(decoder, &cfg, &img);
+    };
+
+    esp_jpeg_decoder_delete(decoder);
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "IQmathLib.h"
+
+#define BENCH_VALUES    256
+
+// Each benchmark goes through the same values, in (0, 1] so that every function stays in range
+TEST_CASE("iqmath")
+{
+    static _iq24 in[BENCH_VALUES];
+    for (int i = 0; i < BENCH_VALUES; i++) {
+        in[i] = _IQ24(1.0) / BENCH_VALUES * (i + 1);
+    }
+
+    ESP_BENCHMARK("iqmath _IQ24mpy x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24mpy(in[i], in[BENCH_VALUES - 1 - i]);
+        }
+        return acc;
+    };
+    ESP_BENCHMARK("iqmath _IQ24div x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24div(in[i], in[BENCH_VALUES - 1]);
+        }
+        return acc;
+    };
+    ESP_BENCHMARK("iqmath _IQ24sqrt x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24sqrt(in[i]);
+        }
+        return acc;
+    };
+    ESP_BENCHMARK("iqmath _IQ24sin x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24sin(in[i]);
+        }
+        return acc;
+    };
+    ESP_BENCHMARK("iqmath _IQ24atan2 x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24atan2(in[i], in[BENCH_VALUES - 1 - i]);
+        }
+        return acc;
+    };
+    ESP_BENCHMARK("iqmath _IQ24exp x256") {
+        _iq24 acc = 0;
+        for (int i = 0; i < BENCH_VALUES; i++) {
+            acc += _IQ24exp(in[i]);
+        }
+        return acc;
+    };
+}
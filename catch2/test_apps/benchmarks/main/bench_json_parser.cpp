@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdio>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "json_parser.h"
+
+#define BENCH_RECORDS   32
+#define BENCH_TOKENS    (5 + BENCH_RECORDS * 9)    // root object, "device", "records" and 4 members per record
+
+// An array of sensor records, as a typical cloud or provisioning payload of about 3 KB
+static std::string bench_document()
+{
+    std::string js = "{\"device\":\"esp\",\"records\":[";
+    char record[96];
+    for (int i = 0; i < BENCH_RECORDS; i++) {
+        snprintf(record, sizeof(record), "%s{\"id\":%d,\"name\":\"sensor_%d\",\"value\":%d.%02d,\"ok\":%s}",
+                 i ? "," : "", i, i, i * 7, i % 100, (i % 3) ? "true" : "false");
+        js += record;
+    }
+    js += "]}";
+    return js;
+}
+
+TEST_CASE("json_parser")
+{
+    static json_tok_t tokens[BENCH_TOKENS];
+    const std::string js = bench_document();
+    jparse_ctx_t jctx;
+
+    ESP_BENCHMARK("json_parser parse 32 records") {
+        int ret = json_parse_start_static(&jctx, js.c_str(), js.length(), tokens, BENCH_TOKENS);
+        json_parse_end_static(&jctx);
+        return ret;
+    };
+
+    REQUIRE(json_parse_start_static(&jctx, js.c_str(), js.length(), tokens, BENCH_TOKENS) == OS_SUCCESS);
+    ESP_BENCHMARK("json_parser read 32 records") {
+        int num = 0, sum = 0;
+        json_obj_get_array(&jctx, "records", &num);
+        for (int i = 0; i < num; i++) {
+            int id;
+            float value;
+            char name[16];
+            json_arr_get_object(&jctx, i);
+            json_obj_get_int(&jctx, "id", &id);
+            json_obj_get_string(&jctx, "name", name, sizeof(name));
+            json_obj_get_float(&jctx, "value", &value);
+            json_arr_leave_object(&jctx);
+            sum += id;
+        }
+        json_obj_leave_array(&jctx);
+        return sum;
+    };
+
+    int num = 0;
+    REQUIRE(json_obj_get_array(&jctx, "records", &num) == OS_SUCCESS);
+    REQUIRE(num == BENCH_RECORDS);
+    json_obj_leave_array(&jctx);
+    json_parse_end_static(&jctx);
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "led_strip.h"
+
+#define BENCH_GPIO      2
+#define BENCH_LEDS      256
+
+/*
+ * No strip needs to be connected. The refresh includes the transmission, which lasts a fixed time for a given number
+ * of LEDs: its differences between chips and releases come from the encoding and the interrupts.
+ */
+TEST_CASE("led_strip")
+{
+    static uint8_t rgb[BENCH_LEDS * 3];
+    const led_strip_config_t strip_config = {
+        .strip_gpio_num = BENCH_GPIO,
+        .max_leds = BENCH_LEDS,
+        .led_model = LED_MODEL_WS2812,
+        .color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB,
+        .flags = {},
+    };
+    const led_strip_rmt_config_t rmt_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = 10 * 1000 * 1000,
+        .mem_block_symbols = 0,
+        .flags = {},
+    };
+    led_strip_handle_t strip;
+    REQUIRE(led_strip_new_rmt_device(&strip_config, &rmt_config, &strip) == ESP_OK);
+    for (size_t i = 0; i < sizeof(rgb); i++) {
+        rgb[i] = i & 0x3F;
+    }
+
+    ESP_BENCHMARK("led_strip set 256 pixels") {
+        return led_strip_set_pixels(strip, 0, BENCH_LEDS, rgb);
+    };
+    ESP_BENCHMARK("led_strip set 256 pixels HSV") {
+        for (int i = 0; i < BENCH_LEDS; i++) {
+            led_strip_set_pixel_hsv(strip, i, i * 360 / BENCH_LEDS, 255, 64);
+        }
+        return 0;
+    };
+    ESP_BENCHMARK("led_strip refresh 256 LEDs") {
+        return led_strip_refresh(strip);
+    };
+
+    const led_strip_color_correction_t correction = {
+        .gamma = 2.2f,
+        .brightness = 128,
+        .flags = {
+            .dithering = 1,
+        },
+    };
+    REQUIRE(led_strip_set_color_correction(strip, &correction) == ESP_OK);
+    ESP_BENCHMARK("led_strip refresh 256 LEDs, gamma and dithering") {
+        return led_strip_refresh(strip);
+    };
+
+    REQUIRE(led_strip_del(strip) == ESP_OK);
+}
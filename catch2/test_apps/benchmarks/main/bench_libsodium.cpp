@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "sodium.h"
+
+#define BENCH_MSG_LEN   1024
+
+TEST_CASE("libsodium")
+{
+    static uint8_t msg[BENCH_MSG_LEN];
+    static uint8_t cipher[crypto_secretbox_MACBYTES + BENCH_MSG_LEN];
+    uint8_t hash[crypto_hash_sha256_BYTES];
+    uint8_t key[crypto_secretbox_KEYBYTES];
+    uint8_t nonce[crypto_secretbox_NONCEBYTES];
+    uint8_t pk[crypto_sign_PUBLICKEYBYTES];
+    uint8_t sk[crypto_sign_SECRETKEYBYTES];
+    uint8_t sig[crypto_sign_BYTES];
+
+    REQUIRE(sodium_init() >= 0);
+    randombytes_buf(msg, sizeof(msg));
+    crypto_secretbox_keygen(key);
+    randombytes_buf(nonce, sizeof(nonce));
+    REQUIRE(crypto_sign_keypair(pk, sk) == 0);
+
+    ESP_BENCHMARK("libsodium SHA-256 1 KB") {
+        return crypto_hash_sha256(hash, msg, sizeof(msg));
+    };
+    ESP_BENCHMARK("libsodium secretbox 1 KB") {
+        return crypto_secretbox_easy(cipher, msg, sizeof(msg), nonce, key);
+    };
+    ESP_BENCHMARK("libsodium secretbox open 1 KB") {
+        return crypto_secretbox_open_easy(msg, cipher, sizeof(cipher), nonce, key);
+    };
+    ESP_BENCHMARK("libsodium Ed25519 sign 1 KB") {
+        return crypto_sign_detached(sig, NULL, msg, sizeof(msg), sk);
+    };
+    ESP_BENCHMARK("libsodium Ed25519 verify 1 KB") {
+        return crypto_sign_verify_detached(sig, msg, sizeof(msg), pk);
+    };
+    REQUIRE(crypto_sign_verify_detached(sig, msg, sizeof(msg), pk) == 0);
+}
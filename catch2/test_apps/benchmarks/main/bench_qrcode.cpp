@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "qrcode.h"
+
+#define BENCH_VERSION   10
+#define BENCH_SCALE     4
+#define BENCH_TEXT      "WIFI:S:esp-benchmark-network;T:WPA;P:correct-horse-battery-staple;;" \
+                        "https://github.com/espressif/idf-extra-components"
+
+static esp_qrcode_handle_t s_qrcode;
+
+static void bench_store_qrcode(esp_qrcode_handle_t qrcode)
+{
+    s_qrcode = qrcode;
+}
+
+TEST_CASE("qrcode")
+{
+    static uint8_t qrcode[ESP_QRCODE_BUFFER_LEN_FOR_VERSION(BENCH_VERSION)];
+    static uint8_t tempbuf[ESP_QRCODE_BUFFER_LEN_FOR_VERSION(BENCH_VERSION)];
+    const esp_qrcode_config_t cfg = {
+        .display_func = bench_store_qrcode,
+        .max_qrcode_version = BENCH_VERSION,
+        .qrcode_ecc_level = ESP_QRCODE_ECC_MED,
+        .reuse_mask = false,
+    };
+
+    ESP_BENCHMARK("qrcode encode 116 bytes") {
+        return esp_qrcode_generate_with_buffers(&cfg, BENCH_TEXT, qrcode, tempbuf);
+    };
+    REQUIRE(esp_qrcode_generate_with_buffers(&cfg, BENCH_TEXT, qrcode, tempbuf) == ESP_OK);
+    REQUIRE(s_qrcode != NULL);
+
+    const esp_qrcode_render_config_t render_cfg = {
+        .format = ESP_QRCODE_PIXEL_FORMAT_RGB565,
+        .scale = BENCH_SCALE,
+        .border = 4,
+        .black_color = 0x0000,
+        .white_color = 0xFFFF,
+    };
+    const size_t size = esp_qrcode_get_render_size(s_qrcode, &render_cfg) * esp_qrcode_get_render_stride(s_qrcode, &render_cfg);
+    uint16_t *buf = new uint16_t[size / sizeof(uint16_t)];
+
+    ESP_BENCHMARK("qrcode render RGB565 x4") {
+        return esp_qrcode_render(s_qrcode, &render_cfg, buf, size);
+    };
+    REQUIRE(esp_qrcode_render(s_qrcode, &render_cfg, buf, size) == ESP_OK);
+    delete[] buf;
+}
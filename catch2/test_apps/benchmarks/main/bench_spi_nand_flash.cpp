@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "spi_nand_flash.h"
+#include "nand_linux_mmap_emul.h"
+
+#define BENCH_FLASH_SIZE    (16 * 1024 * 1024)
+
+/*
+ * The flash is emulated in a memory mapped file, so the figures are the time spent in the driver and in the Dhara
+ * translation layer on the host. spi_nand_flash/host_test projects the times of a real chip from the emulator model.
+ */
+TEST_CASE("spi_nand_flash")
+{
+    nand_file_mmap_emul_config_t conf = {"", BENCH_FLASH_SIZE, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *handle;
+    uint32_t sector_num, sector_size;
+
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_get_capacity(handle, &sector_num) == ESP_OK);
+    REQUIRE(spi_nand_flash_get_sector_size(handle, &sector_size) == ESP_OK);
+    uint8_t *buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(buf != NULL);
+
+    // A quarter of the capacity is written again and again, as a file being rewritten
+    const uint32_t span = sector_num / 4;
+    uint32_t sector = 0;
+    ESP_BENCHMARK("spi_nand_flash write sector") {
+        buf[0] = (uint8_t)sector;
+        esp_err_t ret = spi_nand_flash_write_sector(handle, buf, sector);
+        sector = (sector + 1) % span;
+        return ret;
+    };
+    REQUIRE(spi_nand_flash_sync(handle) == ESP_OK);
+
+    sector = 0;
+    ESP_BENCHMARK("spi_nand_flash read sector") {
+        esp_err_t ret = spi_nand_flash_read_sector(handle, buf, sector);
+        sector = (sector + 1) % span;
+        return ret;
+    };
+
+    free(buf);
+    REQUIRE(spi_nand_flash_deinit_device(handle) == ESP_OK);
+}
@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <catch2/catch_test_macros.hpp>
+#include "esp_catch2_benchmark.hpp"
+#include "zlib.h"
+
+#define BENCH_DATA_LEN  8192
+
+// Log lines, compressible as the text and JSON payloads zlib is usually applied to
+static void bench_fill(uint8_t *data, size_t len)
+{
+    char line[64];
+    size_t pos = 0;
+    for (unsigned int i = 0; pos < len; i++) {
+        int n = snprintf(line, sizeof(line), "I (%u) sensor: temperature=%u.%u humidity=%u\n", i * 125, 20 + i % 7,
+                         i % 10, 40 + i % 13);
+        size_t copy = (size_t)n < len - pos ? (size_t)n : len - pos;
+        memcpy(data + pos, line, copy);
+        pos += copy;
+    }
+}
+
+TEST_CASE("zlib")
+{
+    static uint8_t data[BENCH_DATA_LEN];
+    static uint8_t out[BENCH_DATA_LEN];
+    static uint8_t compressed[BENCH_DATA_LEN + BENCH_DATA_LEN / 1000 + 64];
+    uLongf compressed_len = sizeof(compressed);
+    bench_fill(data, sizeof(data));
+
+    ESP_BENCHMARK("zlib crc32 8 KB") {
+        return crc32(0, data, sizeof(data));
+    };
+    ESP_BENCHMARK("zlib compress 8 KB level 1") {
+        uLongf len = sizeof(compressed);
+        return compress2(compressed, &len, data, sizeof(data), 1);
+    };
+    ESP_BENCHMARK("zlib compress 8 KB level 6") {
+        uLongf len = sizeof(compressed);
+        return compress2(compressed, &len, data, sizeof(data), 6);
+    };
+
+    REQUIRE(compress2(compressed, &compressed_len, data, sizeof(data), 6) == Z_OK);
+    ESP_BENCHMARK("zlib uncompress 8 KB") {
+        uLongf len = sizeof(out);
+        return uncompress(out, &len, compressed, compressed_len);
+    };
+    REQUIRE(memcmp(out, data, sizeof(data)) == 0);
+}
@@ -0,0 +1,38 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "esp_idf_version.h"
+#include <catch2/catch_session.hpp>
+
+#ifdef CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#define BENCH_CPU_FREQ_MHZ  CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ
+#else
+#define BENCH_CPU_FREQ_MHZ  0
+#endif
+
+extern "C" void app_main(void)
+{
+    // Identifies the run, so that the results of different chips and releases can be put side by side
+    printf("{\"type\":\"info\",\"target\":\"%s\",\"idf_version\":\"%d.%d.%d\",\"cpu_freq_mhz\":%d}\n",
+           CONFIG_IDF_TARGET, ESP_IDF_VERSION_MAJOR, ESP_IDF_VERSION_MINOR, ESP_IDF_VERSION_PATCH, BENCH_CPU_FREQ_MHZ);
+
+    // The benchmarks are timed with the cycle counter of the core running them: the main task is pinned to a core
+    int argc = 5;
+    const char *argv[6] = {
+        "target_benchmark_main",
+        "--reporter", "json-lines",
+        "--benchmark-samples", "20",
+        NULL
+    };
+
+    auto result = Catch::Session().run(argc, argv);
+    if (result != 0) {
+        printf("Benchmark failed with result %d\n", result);
+    } else {
+        printf("Benchmark passed.\n");
+    }
+}
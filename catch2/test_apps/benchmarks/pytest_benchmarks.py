@@ -0,0 +1,55 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Unlicense OR CC0-1.0
+
+import glob
+import json
+import os
+from pathlib import Path
+
+import pytest
+from pytest_embedded import Dut
+from pytest_embedded_idf.utils import idf_parametrize
+
+
+def run_benchmarks(dut: Dut) -> dict:
+    info = {}
+    results = []
+    while True:
+        line = json.loads(dut.expect(r'(\{"type":.*\})\r?\n', timeout=600).group(1).decode())
+        if line['type'] == 'info':
+            info = line
+        elif line['type'] == 'benchmark':
+            results.append(line)
+        elif line['type'] == 'summary':
+            break
+    assert line['failed_assertions'] == 0
+    for result in results:
+        assert 0 < result['mean_low_ns'] <= result['mean_ns'] <= result['mean_high_ns']
+    dut.expect_exact('Benchmark passed.')
+
+    # One file per target and release, to be compared side by side
+    report = {'target': info.get('target'), 'idf_version': info.get('idf_version'),
+              'cpu_freq_mhz': info.get('cpu_freq_mhz'), 'benchmarks': results}
+    path = os.path.join(dut.logdir, f'benchmarks_{report["target"]}_{report["idf_version"]}.json')
+    with open(path, 'w') as f:
+        json.dump(report, f, indent=2)
+    return report
+
+
+@pytest.mark.generic
+@idf_parametrize('target', ['esp32', 'esp32s3'], indirect=['target'])
+def test_benchmarks(dut: Dut) -> None:
+    report = run_benchmarks(dut)
+    assert {'esp_jpeg', 'iqmath', 'json_parser', 'qrcode', 'libsodium', 'zlib', 'led_strip'} == \
+        {result['test_case'] for result in report['benchmarks']}
+
+
+@pytest.mark.host_test
+@pytest.mark.skipif(
+    not bool(glob.glob(f'{Path(__file__).parent.absolute()}/build*/')),
+    reason="Skip the idf version that not build"
+)
+@idf_parametrize('target', ['linux'], indirect=['target'])
+def test_benchmarks_linux(dut: Dut) -> None:
+    report = run_benchmarks(dut)
+    assert {'json_parser', 'qrcode', 'spi_nand_flash'} == {result['test_case'] for result in report['benchmarks']}
@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "cbor_chunk_reader.h"
+
+/* Returned for the empty strings at the end of the input, a NULL pointer would mean the end of a string */
+static const uint8_t s_empty;
+
+/* Moves the position to the chunk holding it, skipping the empty chunks and the ones already read */
+static void chunk_reader_settle(cbor_chunk_reader_t *reader)
+{
+    while (reader->index < reader->chunk_count && reader->offset >= reader->chunks[reader->index].len) {
+        reader->offset -= reader->chunks[reader->index].len;
+        reader->index++;
+    }
+}
+
+static bool chunk_reader_can_read_bytes(void *token, size_t len)
+{
+    const cbor_chunk_reader_t *reader = (const cbor_chunk_reader_t *)token;
+    return reader->remaining >= len;
+}
+
+/* Copies len bytes starting offset bytes after the position, without moving it. Only used for the item headers */
+static void *chunk_reader_read_bytes(void *token, void *dst, size_t offset, size_t len)
+{
+    const cbor_chunk_reader_t *reader = (const cbor_chunk_reader_t *)token;
+    size_t index = reader->index;
+    size_t chunk_offset = reader->offset + offset;
+    uint8_t *out = (uint8_t *)dst;
+    while (len > 0 && index < reader->chunk_count) {
+        const cbor_chunk_t *chunk = &reader->chunks[index];
+        if (chunk_offset >= chunk->len) {
+            chunk_offset -= chunk->len;
+            index++;
+            continue;
+        }
+        size_t n = chunk->len - chunk_offset;
+        n = n < len ? n : len;
+        memcpy(out, (const uint8_t *)chunk->data + chunk_offset, n);
+        out += n;
+        len -= n;
+        chunk_offset = 0;
+        index++;
+    }
+    return dst;
+}
+
+static void chunk_reader_advance_bytes(void *token, size_t len)
+{
+    cbor_chunk_reader_t *reader = (cbor_chunk_reader_t *)token;
+    reader->offset += len;
+    reader->remaining -= len;
+    chunk_reader_settle(reader);
+}
+
+static CborError chunk_reader_transfer_string(void *token, const void **userptr, size_t offset, size_t len)
+{
+    cbor_chunk_reader_t *reader = (cbor_chunk_reader_t *)token;
+    if (reader->remaining < offset || reader->remaining - offset < len) {
+        return CborErrorUnexpectedEOF;
+    }
+    chunk_reader_advance_bytes(reader, offset);
+    if (len == 0) {
+        *userptr = reader->index < reader->chunk_count ?
+                   (const uint8_t *)reader->chunks[reader->index].data + reader->offset : &s_empty;
+        return CborNoError;
+    }
+    const cbor_chunk_t *chunk = &reader->chunks[reader->index];
+    if (chunk->len - reader->offset >= len) {
+        *userptr = (const uint8_t *)chunk->data + reader->offset;
+    } else if (len <= reader->scratch_size) {
+        *userptr = chunk_reader_read_bytes(reader, reader->scratch, 0, len);
+    } else {
+        return CborErrorDataTooLarge;
+    }
+    chunk_reader_advance_bytes(reader, len);
+    return CborNoError;
+}
+
+static const struct CborParserOperations s_chunk_reader_ops = {
+    .can_read_bytes = chunk_reader_can_read_bytes,
+    .read_bytes = chunk_reader_read_bytes,
+    .advance_bytes = chunk_reader_advance_bytes,
+    .transfer_string = chunk_reader_transfer_string,
+};
+
+CborError cbor_chunk_reader_init(cbor_chunk_reader_t *reader, const cbor_chunk_t *chunks, size_t chunk_count,
+                                 void *scratch, size_t scratch_size)
+{
+    if (!reader || (!chunks && chunk_count) || (!scratch && scratch_size)) {
+        return CborErrorInternalError;
+    }
+    memset(reader, 0, sizeof(*reader));
+    reader->chunks = chunks;
+    reader->chunk_count = chunk_count;
+    reader->scratch = (uint8_t *)scratch;
+    reader->scratch_size = scratch_size;
+    for (size_t i = 0; i < chunk_count; i++) {
+        reader->remaining += chunks[i].len;
+    }
+    chunk_reader_settle(reader);
+    return CborNoError;
+}
+
+CborError cbor_parser_init_chunk_reader(cbor_chunk_reader_t *reader, CborParser *parser, CborValue *it)
+{
+    return cbor_parser_init_reader(&s_chunk_reader_ops, parser, it, reader);
+}
+
+CborError cbor_value_foreach_string_chunk(CborValue *value, cbor_string_chunk_cb_t cb, void *arg)
+{
+    if (!cbor_value_is_byte_string(value) && !cbor_value_is_text_string(value)) {
+        return CborErrorIllegalType;
+    }
+    const bool text = cbor_value_is_text_string(value);
+    CborError err = cbor_value_begin_string_iteration(value);
+    while (err == CborNoError) {
+        const void *data;
+        size_t len;
+        if (text) {
+            err = cbor_value_get_text_string_chunk(value, (const char **)&data, &len, value);
+        } else {
+            err = cbor_value_get_byte_string_chunk(value, (const uint8_t **)&data, &len, value);
+        }
+        if (err != CborNoError || data == NULL) {
+            break;
+        }
+        err = cb(data, len, arg);
+    }
+    if (err != CborNoError) {
+        return err;
+    }
+    return cbor_value_finish_string_iteration(value);
+}
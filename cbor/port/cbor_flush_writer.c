@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "cbor_flush_writer.h"
+
+static CborError flush_writer_emit(cbor_flush_writer_t *writer, const void *data, size_t len)
+{
+    if (writer->error == CborNoError && len > 0) {
+        writer->error = writer->flush(data, len, writer->arg);
+    }
+    return writer->error;
+}
+
+static CborError flush_writer_write(void *token, const void *data, size_t len, CborEncoderAppendType append)
+{
+    (void)append;
+    cbor_flush_writer_t *writer = (cbor_flush_writer_t *)token;
+    const uint8_t *in = (const uint8_t *)data;
+    if (writer->error != CborNoError) {
+        return writer->error;
+    }
+    writer->total += len;
+    // fill up the buffer first, to keep the chunks in order
+    size_t n = writer->size - writer->used;
+    if (len < n) {
+        memcpy(writer->buf + writer->used, in, len);
+        writer->used += len;
+        return CborNoError;
+    }
+    memcpy(writer->buf + writer->used, in, n);
+    in += n;
+    len -= n;
+    writer->used = 0;
+    if (flush_writer_emit(writer, writer->buf, writer->size) != CborNoError) {
+        return writer->error;
+    }
+    // what is left of a long string goes through as whole chunks, only its tail is buffered
+    n = len - len % writer->size;
+    if (flush_writer_emit(writer, in, n) != CborNoError) {
+        return writer->error;
+    }
+    memcpy(writer->buf, in + n, len - n);
+    writer->used = len - n;
+    return CborNoError;
+}
+
+CborError cbor_flush_writer_init(cbor_flush_writer_t *writer, void *buf, size_t size, cbor_flush_cb_t flush, void *arg)
+{
+    if (!writer || !buf || !size || !flush) {
+        return CborErrorInternalError;
+    }
+    memset(writer, 0, sizeof(*writer));
+    writer->buf = (uint8_t *)buf;
+    writer->size = size;
+    writer->flush = flush;
+    writer->arg = arg;
+    return CborNoError;
+}
+
+void cbor_encoder_init_flush_writer(cbor_flush_writer_t *writer, CborEncoder *encoder)
+{
+    cbor_encoder_init_writer(encoder, flush_writer_write, writer);
+}
+
+CborError cbor_flush_writer_finish(cbor_flush_writer_t *writer)
+{
+    CborError err = flush_writer_emit(writer, writer->buf, writer->used);
+    writer->used = 0;
+    return err;
+}
+
+size_t cbor_flush_writer_get_total(const cbor_flush_writer_t *writer)
+{
+    return writer->total;
+}
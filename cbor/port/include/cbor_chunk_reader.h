@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cbor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A contiguous part of a CBOR document
+ */
+typedef struct {
+    const void *data; /*!< Start of the chunk */
+    size_t len;       /*!< Length of the chunk, in bytes */
+} cbor_chunk_t;
+
+/**
+ * @brief Source of a TinyCBOR parser reading a CBOR document split in several chunks, e.g. the received blocks of
+ *        a CoAP block-wise transfer, or the two parts of the used area of a ring buffer
+ *
+ * @note All the members are private, initialize it with `cbor_chunk_reader_init()`
+ */
+typedef struct {
+    const cbor_chunk_t *chunks;
+    size_t chunk_count;
+    uint8_t *scratch;
+    size_t scratch_size;
+    size_t index;     // chunk of the current position
+    size_t offset;    // offset of the current position in its chunk
+    size_t remaining; // bytes after the current position, in all the chunks
+} cbor_chunk_reader_t;
+
+/**
+ * @brief Signature of the function called for each chunk of a string by `cbor_value_foreach_string_chunk()`
+ *
+ * @param data Start of the string chunk, pointing into the input chunks
+ * @param len Length of the string chunk, in bytes
+ * @param arg Argument passed to `cbor_value_foreach_string_chunk()`
+ * @return CborNoError to go on, any other error to stop the iteration and be returned
+ */
+typedef CborError (*cbor_string_chunk_cb_t)(const void *data, size_t len, void *arg);
+
+/**
+ * @brief Initialize a chunk reader over a list of chunks
+ *
+ * @note The chunks, the list and the scratch buffer must stay valid while the document is parsed
+ *
+ * @param reader Reader to initialize
+ * @param chunks Chunks of the document, in order
+ * @param chunk_count Number of chunks
+ * @param scratch Buffer where the strings which are split between two chunks are copied to be returned as one,
+ *                can be NULL
+ * @param scratch_size Size of the scratch buffer, the longest split string which can be read
+ * @return
+ *      - CborNoError: Reader initialized
+ *      - CborErrorInternalError: Invalid argument
+ */
+CborError cbor_chunk_reader_init(cbor_chunk_reader_t *reader, const cbor_chunk_t *chunks, size_t chunk_count,
+                                 void *scratch, size_t scratch_size);
+
+/**
+ * @brief Initialize a TinyCBOR parser reading from a chunk reader, the counterpart of `cbor_parser_init()`
+ *
+ * The strings are returned as pointers into the chunks by `cbor_value_get_text_string_chunk()`,
+ * `cbor_value_get_byte_string_chunk()` and `cbor_value_foreach_string_chunk()`, without allocation nor copy,
+ * unless they are split between two chunks. Those are copied into the scratch buffer, valid until the next string,
+ * and fail with CborErrorDataTooLarge if they don't fit in it.
+ *
+ * @note The position in the document is held by the reader and shared by all the CborValue of the parser, so the
+ *       document must be parsed in order: the functions which look ahead and come back, such as
+ *       `cbor_value_map_find_value()` and `cbor_value_calculate_string_length()`, can't be used.
+ *
+ * @param reader Chunk reader, initialized by `cbor_chunk_reader_init()`
+ * @param parser Parser to initialize
+ * @param it Returned iterator on the first value of the document
+ * @return Errors of `cbor_parser_init_reader()`
+ */
+CborError cbor_parser_init_chunk_reader(cbor_chunk_reader_t *reader, CborParser *parser, CborValue *it);
+
+/**
+ * @brief Call a function for each chunk of a text or byte string, then advance to the next value
+ *
+ * @param value Text or byte string value, advanced to the next value on success
+ * @param cb Function called for each chunk, with a pointer into the input of the parser
+ * @param arg Argument passed to the function
+ * @return
+ *      - CborNoError: All the chunks were processed
+ *      - CborErrorIllegalType: The value is not a string
+ *      - Parser errors, or the error returned by the function
+ */
+CborError cbor_value_foreach_string_chunk(CborValue *value, cbor_string_chunk_cb_t cb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
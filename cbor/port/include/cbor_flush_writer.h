@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cbor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Signature of the function receiving the encoded data, e.g. writing it to a socket, a file or a CoAP block
+ *
+ * @param data Encoded data
+ * @param len Length of the data, in bytes, the size of the chunk buffer except for the last chunk and the long strings
+ * @param arg Argument passed to `cbor_flush_writer_init()`
+ * @return CborNoError on success, any other error to stop the encoding and be returned by the encoder
+ */
+typedef CborError (*cbor_flush_cb_t)(const void *data, size_t len, void *arg);
+
+/**
+ * @brief Sink of a TinyCBOR encoder, which accumulates the encoded data in a fixed size chunk buffer and hands it to
+ *        a flush callback each time the buffer is full
+ *
+ * @note All the members are private, initialize it with `cbor_flush_writer_init()`
+ */
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t used;          // bytes waiting in the buffer
+    size_t total;         // bytes encoded since the initialization
+    cbor_flush_cb_t flush;
+    void *arg;
+    CborError error;      // first error of the flush callback, returned by all the following writes
+} cbor_flush_writer_t;
+
+/**
+ * @brief Initialize a flush writer
+ *
+ * @note The chunk buffer must stay valid until `cbor_flush_writer_finish()` returns
+ *
+ * @param writer Writer to initialize
+ * @param buf Chunk buffer
+ * @param size Size of the chunk buffer, the length of the chunks passed to the callback
+ * @param flush Function receiving the encoded data
+ * @param arg Argument passed to the function
+ * @return
+ *      - CborNoError: Writer initialized
+ *      - CborErrorInternalError: Invalid argument
+ */
+CborError cbor_flush_writer_init(cbor_flush_writer_t *writer, void *buf, size_t size, cbor_flush_cb_t flush, void *arg);
+
+/**
+ * @brief Initialize a TinyCBOR encoder writing to a flush writer, the counterpart of `cbor_encoder_init()`
+ *
+ * The document is encoded in a single pass and in constant memory, whatever its size, so the encoder never fails
+ * with CborErrorOutOfMemory. The strings longer than the chunk buffer are passed to the callback directly from the
+ * memory of the caller, without copy.
+ *
+ * @note `cbor_encoder_get_buffer_size()` and `cbor_encoder_get_extra_bytes_needed()` don't apply to this encoder,
+ *       use `cbor_flush_writer_get_total()` instead.
+ *
+ * @param writer Flush writer, initialized by `cbor_flush_writer_init()`
+ * @param encoder Encoder to initialize
+ */
+void cbor_encoder_init_flush_writer(cbor_flush_writer_t *writer, CborEncoder *encoder);
+
+/**
+ * @brief Pass the data left in the chunk buffer to the callback, to be called once the document is encoded
+ *
+ * @param writer Flush writer
+ * @return
+ *      - CborNoError: All the encoded data was passed to the callback
+ *      - The error returned by the callback
+ */
+CborError cbor_flush_writer_finish(cbor_flush_writer_t *writer);
+
+/**
+ * @brief Get the number of bytes encoded since the initialization of the writer, flushed or not
+ *
+ * @param writer Flush writer
+ * @return Number of bytes
+ */
+size_t cbor_flush_writer_get_total(const cbor_flush_writer_t *writer);
+
+#ifdef __cplusplus
+}
+#endif
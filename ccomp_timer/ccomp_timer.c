@@ -84,3 +84,65 @@ int64_t IRAM_ATTR ccomp_timer_get_time(void)
 {
     return ccomp_timer_impl_get_time();
 }
+
+esp_err_t ccomp_timer_start_events(const ccomp_timer_event_t *events, size_t event_count)
+{
+    if (events == NULL || event_count == 0 || event_count > CCOMP_TIMER_EVENTS_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = ESP_OK;
+
+    ccomp_timer_impl_lock();
+    if (ccomp_timer_impl_is_init()) {
+        err = ESP_ERR_INVALID_STATE;
+    } else {
+        err = ccomp_timer_impl_init_events(events, event_count);
+    }
+    ccomp_timer_impl_unlock();
+
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = ccomp_timer_impl_reset();
+
+    if (err == ESP_OK) {
+        err = ccomp_timer_impl_start();
+    }
+
+    if (err != ESP_OK) {
+        ccomp_timer_impl_deinit();
+    }
+    return err;
+}
+
+esp_err_t IRAM_ATTR ccomp_timer_stop_events(int64_t *cycles, int64_t *counts)
+{
+    esp_err_t err = ESP_OK;
+    ccomp_timer_impl_lock();
+    if (!ccomp_timer_impl_is_active()) {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    ccomp_timer_impl_unlock();
+
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    err = ccomp_timer_impl_stop();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (cycles) {
+        *cycles = ccomp_timer_impl_get_cycles();
+    }
+    if (counts) {
+        for (size_t i = 0; i < CCOMP_TIMER_EVENTS_MAX; i++) {
+            counts[i] = ccomp_timer_impl_get_event_count(i);
+        }
+    }
+
+    return ccomp_timer_impl_deinit();
+}
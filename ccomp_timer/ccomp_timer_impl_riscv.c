@@ -5,7 +5,10 @@
  */
 
 #include <stdint.h>
-#include "freertos/portmacro.h"
+#include "ccomp_timer_impl.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "riscv/rvruntime-frames.h"
 #include "esp_freertos_hooks.h"
 #include "soc/soc_caps.h"
 #include "esp_rom_sys.h"
@@ -49,6 +52,12 @@ esp_err_t ccomp_timer_impl_init(void)
     return ESP_OK;
 }
 
+esp_err_t ccomp_timer_impl_init_events(const ccomp_timer_event_t *events, size_t event_count)
+{
+    // The performance counter is the cycle counter of the system, and has no cache events
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
 esp_err_t ccomp_timer_impl_deinit(void)
 {
     s_status[esp_cpu_get_core_id()].state = PERF_TIMER_UNINIT;
@@ -73,10 +82,21 @@ esp_err_t IRAM_ATTR ccomp_timer_impl_stop(void)
 }
 
 int64_t IRAM_ATTR ccomp_timer_impl_get_time(void)
+{
+    return (ccomp_timer_impl_get_cycles() * 1000000) / esp_clk_cpu_freq();
+}
+
+int64_t IRAM_ATTR ccomp_timer_impl_get_cycles(void)
 {
     update_ccount();
-    int64_t cycles = s_status[esp_cpu_get_core_id()].ccount;
-    return (cycles * 1000000) / esp_clk_cpu_freq();
+    return s_status[esp_cpu_get_core_id()].ccount;
+}
+
+uint32_t IRAM_ATTR ccomp_timer_impl_get_interrupted_pc(void)
+{
+    // pxTopOfStack is the first member of the TCB
+    RvExcFrame *frame = *(RvExcFrame **)xTaskGetCurrentTaskHandle();
+    return frame->mepc;
 }
 
 esp_err_t ccomp_timer_impl_reset(void)
@@ -86,6 +106,11 @@ esp_err_t ccomp_timer_impl_reset(void)
     return ESP_OK;
 }
 
+int64_t IRAM_ATTR ccomp_timer_impl_get_event_count(size_t index)
+{
+    return 0;
+}
+
 bool ccomp_timer_impl_is_init(void)
 {
     return s_status[esp_cpu_get_core_id()].state != PERF_TIMER_UNINIT;
@@ -18,6 +18,8 @@
 #include "xtensa/core-macros.h"
 #include "xtensa/xt_perf_consts.h"
 #include "xtensa-debug-module.h"
+#include "xtensa_context.h"
+#include "freertos/task.h"
 #include "esp_private/esp_clk.h"
 
 #define D_STALL_COUNTER_ID 0
@@ -30,8 +32,9 @@ typedef enum {
 } ccomp_timer_state_t;
 
 typedef struct {
-    int i_ovfl;                         // number of times instruction stall counter has overflowed
-    int d_ovfl;                         // number of times data stall counter has overflowed
+    int ovfl[CCOMP_TIMER_EVENTS_MAX];   // number of times each counter has overflowed
+    size_t counter_num;                 // number of counters in use
+    bool events;                        // counting the events of ccomp_timer_impl_init_events instead of the stalls
     uint32_t last_ccount;               // last CCOUNT value, updated every os tick
     ccomp_timer_state_t state;          // state of the timer
     intr_handle_t intr_handle;          // handle to allocated handler for perfmon counter overflows, so that it can be freed during deinit
@@ -42,8 +45,6 @@ typedef struct {
 ccomp_timer_status_t s_status[] = {
     (ccomp_timer_status_t)
     {
-        .i_ovfl = 0,
-        .d_ovfl = 0,
         .ccount = 0,
         .last_ccount = 0,
         .state = PERF_TIMER_UNINIT,
@@ -51,8 +52,6 @@ ccomp_timer_status_t s_status[] = {
     },
     (ccomp_timer_status_t)
     {
-        .i_ovfl = 0,
-        .d_ovfl = 0,
         .ccount = 0,
         .last_ccount = 0,
         .state = PERF_TIMER_UNINIT,
@@ -60,6 +59,16 @@ ccomp_timer_status_t s_status[] = {
     }
 };
 
+// Counter selection and mask of each ccomp_timer_event_t
+static const struct {
+    uint32_t select;
+    uint32_t mask;
+} s_event_counters[] = {
+    [CCOMP_TIMER_EVENT_INSTRUCTIONS] = { XTPERF_CNT_INSN, XTPERF_MASK_INSN_ALL },
+    [CCOMP_TIMER_EVENT_I_STALL_CYCLES] = { XTPERF_CNT_I_STALL, XTPERF_MASK_I_STALL_BUSY },
+    [CCOMP_TIMER_EVENT_D_STALL_CYCLES] = { XTPERF_CNT_D_STALL, XTPERF_MASK_D_STALL_BUSY },
+};
+
 static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
 
 static void IRAM_ATTR update_ccount(void)
@@ -83,56 +92,78 @@ static void inline update_overflow(int id, int *cnt)
         *cnt += 1;
         // Clear overflow and PerfMonInt asserted bits. The only valid bits in PMSTAT is the ones we're trying to clear. So it should be
         // ok to just modify the whole register.
-        eri_write(ERI_PERFMON_PMSTAT0 + id, ~0x0);
+        eri_write(ERI_PERFMON_PMSTAT0 + id * sizeof(int32_t), ~0x0);
     }
 }
 
 static void IRAM_ATTR perf_counter_overflow_handler(void *args)
 {
-    update_overflow(D_STALL_COUNTER_ID, &s_status[xPortGetCoreID()].d_ovfl);
-    update_overflow(I_STALL_COUNTER_ID, &s_status[xPortGetCoreID()].i_ovfl);
+    ccomp_timer_status_t *status = &s_status[xPortGetCoreID()];
+    for (int id = 0; id < status->counter_num; id++) {
+        update_overflow(id, &status->ovfl[id]);
+    }
 }
 
 static void set_perfmon_interrupt(bool enable)
 {
-    uint32_t d_pmctrl = eri_read(ERI_PERFMON_PMCTRL0 + D_STALL_COUNTER_ID * sizeof(int32_t));
-    uint32_t i_pmctrl = eri_read(ERI_PERFMON_PMCTRL0 + I_STALL_COUNTER_ID * sizeof(int32_t));
-
-    if (enable) {
-        d_pmctrl |= PMCTRL_INTEN;
-        i_pmctrl |= PMCTRL_INTEN;
-    } else {
-        d_pmctrl &= ~PMCTRL_INTEN;
-        i_pmctrl &= ~PMCTRL_INTEN;
+    for (int id = 0; id < s_status[xPortGetCoreID()].counter_num; id++) {
+        uint32_t pmctrl = eri_read(ERI_PERFMON_PMCTRL0 + id * sizeof(int32_t));
+        if (enable) {
+            pmctrl |= PMCTRL_INTEN;
+        } else {
+            pmctrl &= ~PMCTRL_INTEN;
+        }
+        eri_write(ERI_PERFMON_PMCTRL0 + id * sizeof(int32_t), pmctrl);
     }
-
-    eri_write(ERI_PERFMON_PMCTRL0 + D_STALL_COUNTER_ID * sizeof(int32_t), d_pmctrl);
-    eri_write(ERI_PERFMON_PMCTRL0 + I_STALL_COUNTER_ID * sizeof(int32_t), i_pmctrl);
 }
 
-
-esp_err_t ccomp_timer_impl_init(void)
+static esp_err_t init_counters(const uint32_t *selects, const uint32_t *masks, size_t counter_num, bool events)
 {
+    ccomp_timer_status_t *status = &s_status[xPortGetCoreID()];
+
     // Keep track of how many times each counter has overflowed.
     esp_err_t err = esp_intr_alloc(ETS_INTERNAL_PROFILING_INTR_SOURCE, 0,
-                                   perf_counter_overflow_handler, NULL, &s_status[xPortGetCoreID()].intr_handle);
+                                   perf_counter_overflow_handler, NULL, &status->intr_handle);
 
     if (err != ESP_OK) {
         return err;
     }
 
-    xtensa_perfmon_init(D_STALL_COUNTER_ID,
-                        XTPERF_CNT_D_STALL,
-                        XTPERF_MASK_D_STALL_BUSY, 0, -1);
-    xtensa_perfmon_init(I_STALL_COUNTER_ID,
-                        XTPERF_CNT_I_STALL,
-                        XTPERF_MASK_I_STALL_BUSY, 0, -1);
+    for (int id = 0; id < counter_num; id++) {
+        xtensa_perfmon_init(id, selects[id], masks[id], 0, -1);
+    }
+    status->counter_num = counter_num;
+    status->events = events;
 
     set_perfmon_interrupt(true);
-    s_status[xPortGetCoreID()].state = PERF_TIMER_IDLE;
+    status->state = PERF_TIMER_IDLE;
     return ESP_OK;
 }
 
+esp_err_t ccomp_timer_impl_init(void)
+{
+    const uint32_t selects[] = { [D_STALL_COUNTER_ID] = XTPERF_CNT_D_STALL, [I_STALL_COUNTER_ID] = XTPERF_CNT_I_STALL };
+    const uint32_t masks[] = { [D_STALL_COUNTER_ID] = XTPERF_MASK_D_STALL_BUSY, [I_STALL_COUNTER_ID] = XTPERF_MASK_I_STALL_BUSY };
+    return init_counters(selects, masks, 2, false);
+}
+
+esp_err_t ccomp_timer_impl_init_events(const ccomp_timer_event_t *events, size_t event_count)
+{
+    uint32_t selects[CCOMP_TIMER_EVENTS_MAX];
+    uint32_t masks[CCOMP_TIMER_EVENTS_MAX];
+    if (events == NULL || event_count == 0 || event_count > CCOMP_TIMER_EVENTS_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < event_count; i++) {
+        if (events[i] < 0 || events[i] >= sizeof(s_event_counters) / sizeof(s_event_counters[0])) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        selects[i] = s_event_counters[events[i]].select;
+        masks[i] = s_event_counters[events[i]].mask;
+    }
+    return init_counters(selects, masks, event_count, true);
+}
+
 esp_err_t ccomp_timer_impl_deinit(void)
 {
     set_perfmon_interrupt(false);
@@ -168,23 +199,44 @@ esp_err_t IRAM_ATTR ccomp_timer_impl_stop(void)
 }
 
 int64_t IRAM_ATTR ccomp_timer_impl_get_time(void)
+{
+    return (ccomp_timer_impl_get_cycles() * 1000000) / esp_clk_cpu_freq();
+}
+
+int64_t IRAM_ATTR ccomp_timer_impl_get_event_count(size_t index)
+{
+    if (index >= s_status[xPortGetCoreID()].counter_num) {
+        return 0;
+    }
+    // the counters are 32 bits wide
+    return xtensa_perfmon_value(index) + ((int64_t)s_status[xPortGetCoreID()].ovfl[index] << 32);
+}
+
+int64_t IRAM_ATTR ccomp_timer_impl_get_cycles(void)
 {
     update_ccount();
-    int64_t d_stalls = xtensa_perfmon_value(D_STALL_COUNTER_ID) +
-                       s_status[xPortGetCoreID()].d_ovfl * (1 << sizeof(int32_t));
-    int64_t i_stalls = xtensa_perfmon_value(I_STALL_COUNTER_ID) +
-                       s_status[xPortGetCoreID()].i_ovfl * (1 << sizeof(int32_t));
-    int64_t stalls = d_stalls + i_stalls;
     int64_t cycles = s_status[xPortGetCoreID()].ccount;
-    return ((cycles - stalls) * 1000000) / esp_clk_cpu_freq();
+    if (s_status[xPortGetCoreID()].events) {
+        return cycles;
+    }
+    int64_t d_stalls = ccomp_timer_impl_get_event_count(D_STALL_COUNTER_ID);
+    int64_t i_stalls = ccomp_timer_impl_get_event_count(I_STALL_COUNTER_ID);
+    return cycles - d_stalls - i_stalls;
+}
+
+uint32_t IRAM_ATTR ccomp_timer_impl_get_interrupted_pc(void)
+{
+    // pxTopOfStack is the first member of the TCB
+    XtExcFrame *frame = *(XtExcFrame **)xTaskGetCurrentTaskHandle();
+    return frame->pc;
 }
 
 esp_err_t ccomp_timer_impl_reset(void)
 {
-    xtensa_perfmon_reset(D_STALL_COUNTER_ID);
-    xtensa_perfmon_reset(I_STALL_COUNTER_ID);
-    s_status[xPortGetCoreID()].d_ovfl = 0;
-    s_status[xPortGetCoreID()].i_ovfl = 0;
+    for (int id = 0; id < s_status[xPortGetCoreID()].counter_num; id++) {
+        xtensa_perfmon_reset(id);
+        s_status[xPortGetCoreID()].ovfl[id] = 0;
+    }
     s_status[xPortGetCoreID()].ccount = 0;
     s_status[xPortGetCoreID()].last_ccount = 0;
     return ESP_OK;
@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include "ccomp_timer_sampler.h"
+
+#include "ccomp_timer_impl.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_freertos_hooks.h"
+#include "soc/soc_caps.h"
+#include "esp_private/esp_clk.h"
+#include "sdkconfig.h"
+
+#define SAMPLER_DUMP_LINE_SAMPLES 16
+
+// Written by the tick hook of the core, read by any task. A slot stays free to tell a full buffer from an empty one.
+typedef struct {
+    uint32_t pcs[CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE + 1];
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+} sampler_ring_t;
+
+static sampler_ring_t s_rings[SOC_CPU_CORES_NUM];
+static bool s_running;
+
+static void IRAM_ATTR sampler_tick_hook(void)
+{
+    sampler_ring_t *ring = &s_rings[esp_cpu_get_core_id()];
+    uint32_t head = ring->head;
+    uint32_t next = head == CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE ? 0 : head + 1;
+    if (next == ring->tail) {
+        ring->dropped++;
+        return;
+    }
+    ring->pcs[head] = ccomp_timer_impl_get_interrupted_pc();
+    ring->head = next;
+}
+
+esp_err_t ccomp_timer_sampler_start(void)
+{
+    if (s_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (int core = 0; core < SOC_CPU_CORES_NUM; core++) {
+        s_rings[core].dropped = 0;
+        esp_err_t err = esp_register_freertos_tick_hook_for_cpu(sampler_tick_hook, core);
+        if (err != ESP_OK) {
+            while (--core >= 0) {
+                esp_deregister_freertos_tick_hook_for_cpu(sampler_tick_hook, core);
+            }
+            return err;
+        }
+    }
+    s_running = true;
+    return ESP_OK;
+}
+
+esp_err_t ccomp_timer_sampler_stop(void)
+{
+    if (!s_running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (int core = 0; core < SOC_CPU_CORES_NUM; core++) {
+        esp_deregister_freertos_tick_hook_for_cpu(sampler_tick_hook, core);
+    }
+    s_running = false;
+    return ESP_OK;
+}
+
+size_t ccomp_timer_sampler_read(int core, uint32_t *pcs, size_t max_count)
+{
+    if (core < 0 || core >= SOC_CPU_CORES_NUM || pcs == NULL) {
+        return 0;
+    }
+    sampler_ring_t *ring = &s_rings[core];
+    uint32_t tail = ring->tail;
+    size_t count = 0;
+    while (count < max_count && tail != ring->head) {
+        pcs[count++] = ring->pcs[tail];
+        tail = tail == CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE ? 0 : tail + 1;
+    }
+    ring->tail = tail;
+    return count;
+}
+
+uint32_t ccomp_timer_sampler_get_dropped(int core)
+{
+    if (core < 0 || core >= SOC_CPU_CORES_NUM) {
+        return 0;
+    }
+    return s_rings[core].dropped;
+}
+
+void ccomp_timer_sampler_dump(void)
+{
+    uint32_t pcs[SAMPLER_DUMP_LINE_SAMPLES];
+    uint32_t dropped = 0;
+    printf("CCOMP_SAMPLER,%d,%d\n", (int)configTICK_RATE_HZ, esp_clk_cpu_freq());
+    for (int core = 0; core < SOC_CPU_CORES_NUM; core++) {
+        size_t count;
+        while ((count = ccomp_timer_sampler_read(core, pcs, SAMPLER_DUMP_LINE_SAMPLES)) > 0) {
+            printf("CCOMP_SAMPLES,%d", core);
+            for (size_t i = 0; i < count; i++) {
+                printf(",%08" PRIx32, pcs[i]);
+            }
+            printf("\n");
+        }
+        dropped += ccomp_timer_sampler_get_dropped(core);
+    }
+    printf("CCOMP_SAMPLER_END,%" PRIu32 "\n", dropped);
+}
@@ -0,0 +1,210 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "ccomp_timer.h"
+#include "ccomp_timer_scope.h"
+
+#include "ccomp_timer_impl.h"
+
+#include "freertos/FreeRTOS.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "soc/soc_caps.h"
+#include "esp_private/esp_clk.h"
+
+#if CONFIG_CCOMP_TIMER_SCOPE_ENABLE
+
+typedef struct {
+    int64_t total_cycles;
+    int64_t self_cycles;
+    int64_t min_cycles;
+    int64_t max_cycles;
+    uint32_t calls;
+} scope_stats_t;
+
+typedef struct {
+    int id;                 // scope entered, -1 if it couldn't be registered or is nested too deep
+    int64_t start_cycles;   // timer value when the scope was entered
+    int64_t child_cycles;   // cycles spent in the nested scopes so far
+} scope_frame_t;
+
+typedef struct {
+    scope_frame_t stack[CONFIG_CCOMP_TIMER_SCOPE_MAX_DEPTH];
+    int depth;
+    bool own_timer;         // the outermost scope started the timer
+    scope_stats_t stats[CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM];
+} scope_core_t;
+
+// The scopes are registered once for all the cores, their statistics are kept per core to avoid locking
+static const char *s_names[CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM];
+static uint8_t s_depths[CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM];
+static int s_count;
+static scope_core_t s_cores[SOC_CPU_CORES_NUM];
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static int scope_register(const char *name, int depth)
+{
+    int id = -1;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < s_count; i++) {
+        if (s_names[i] == name || strcmp(s_names[i], name) == 0) {
+            id = i;
+            break;
+        }
+    }
+    if (id < 0 && s_count < CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM) {
+        id = s_count++;
+        s_names[id] = name;
+        s_depths[id] = depth;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return id;
+}
+
+void IRAM_ATTR ccomp_timer_scope_begin(int *id, const char *name)
+{
+    scope_core_t *core = &s_cores[esp_cpu_get_core_id()];
+    if (core->depth == 0 && !ccomp_timer_impl_is_active()) {
+        core->own_timer = ccomp_timer_start() == ESP_OK;
+    }
+    if (*id < 0) {
+        *id = scope_register(name, core->depth);
+    }
+    if (core->depth < CONFIG_CCOMP_TIMER_SCOPE_MAX_DEPTH) {
+        scope_frame_t *frame = &core->stack[core->depth];
+        frame->id = *id;
+        frame->child_cycles = 0;
+        frame->start_cycles = ccomp_timer_impl_get_cycles();
+    }
+    // deeper scopes aren't recorded, their time goes to the innermost recorded scope
+    core->depth++;
+}
+
+void IRAM_ATTR ccomp_timer_scope_end(void)
+{
+    int64_t end_cycles = ccomp_timer_impl_get_cycles();
+    scope_core_t *core = &s_cores[esp_cpu_get_core_id()];
+    if (core->depth == 0) {
+        return;
+    }
+    core->depth--;
+    if (core->depth < CONFIG_CCOMP_TIMER_SCOPE_MAX_DEPTH) {
+        scope_frame_t *frame = &core->stack[core->depth];
+        int64_t cycles = end_cycles - frame->start_cycles;
+        if (frame->id >= 0) {
+            scope_stats_t *stats = &core->stats[frame->id];
+            if (stats->calls == 0 || cycles < stats->min_cycles) {
+                stats->min_cycles = cycles;
+            }
+            if (cycles > stats->max_cycles) {
+                stats->max_cycles = cycles;
+            }
+            stats->total_cycles += cycles;
+            stats->self_cycles += cycles - frame->child_cycles;
+            stats->calls++;
+            // nested scopes are shown under their outermost use
+            if (core->depth < s_depths[frame->id]) {
+                s_depths[frame->id] = core->depth;
+            }
+        }
+        if (core->depth > 0) {
+            core->stack[core->depth - 1].child_cycles += cycles;
+        }
+    }
+    if (core->depth == 0 && core->own_timer) {
+        core->own_timer = false;
+        ccomp_timer_stop();
+    }
+}
+
+// Sum of the statistics of all the cores
+static void scope_get_stats(int id, ccomp_timer_scope_stats_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    out->name = s_names[id];
+    out->depth = s_depths[id];
+    for (int c = 0; c < SOC_CPU_CORES_NUM; c++) {
+        const scope_stats_t *core_stats = &s_cores[c].stats[id];
+        if (core_stats->calls == 0) {
+            continue;
+        }
+        if (out->calls == 0 || core_stats->min_cycles < out->min_cycles) {
+            out->min_cycles = core_stats->min_cycles;
+        }
+        if (core_stats->max_cycles > out->max_cycles) {
+            out->max_cycles = core_stats->max_cycles;
+        }
+        out->total_cycles += core_stats->total_cycles;
+        out->self_cycles += core_stats->self_cycles;
+        out->calls += core_stats->calls;
+    }
+}
+
+esp_err_t ccomp_timer_scope_get_stats(ccomp_timer_scope_stats_t *stats, size_t max_count, size_t *count)
+{
+    if (count == NULL || (stats == NULL && max_count > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int scope_count = s_count;
+    for (int i = 0; i < scope_count && i < max_count; i++) {
+        scope_get_stats(i, &stats[i]);
+    }
+    *count = scope_count;
+    return ESP_OK;
+}
+
+void ccomp_timer_scope_print(void)
+{
+    double cycles_per_us = esp_clk_cpu_freq() / 1000000.0;
+    printf("%-32s %8s %12s %12s %10s %10s %10s\n", "Scope", "Calls", "Total us", "Self us", "Min us", "Avg us", "Max us");
+    int scope_count = s_count;
+    for (int i = 0; i < scope_count; i++) {
+        ccomp_timer_scope_stats_t stats;
+        scope_get_stats(i, &stats);
+        int indent = stats.depth * 2;
+        printf("%*s%-*s %8" PRIu32 " %12.1f %12.1f %10.2f %10.2f %10.2f\n", indent, "", 32 - indent, stats.name, stats.calls,
+               stats.total_cycles / cycles_per_us, stats.self_cycles / cycles_per_us, stats.min_cycles / cycles_per_us,
+               stats.calls ? stats.total_cycles / cycles_per_us / stats.calls : 0.0, stats.max_cycles / cycles_per_us);
+    }
+}
+
+void ccomp_timer_scope_reset(void)
+{
+    for (int c = 0; c < SOC_CPU_CORES_NUM; c++) {
+        memset(s_cores[c].stats, 0, sizeof(s_cores[c].stats));
+    }
+}
+
+#else // CONFIG_CCOMP_TIMER_SCOPE_ENABLE
+
+void ccomp_timer_scope_begin(int *id, const char *name)
+{
+}
+
+void ccomp_timer_scope_end(void)
+{
+}
+
+esp_err_t ccomp_timer_scope_get_stats(ccomp_timer_scope_stats_t *stats, size_t max_count, size_t *count)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void ccomp_timer_scope_print(void)
+{
+}
+
+void ccomp_timer_scope_reset(void)
+{
+}
+
+#endif // CONFIG_CCOMP_TIMER_SCOPE_ENABLE
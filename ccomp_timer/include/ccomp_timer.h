@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -48,6 +49,53 @@ int64_t ccomp_timer_stop(void);
  */
 int64_t ccomp_timer_get_time(void);
 
+/**
+ * @brief Events of the performance monitor counted by ccomp_timer_start_events().
+ */
+typedef enum {
+    CCOMP_TIMER_EVENT_INSTRUCTIONS,     /*!< Instructions retired */
+    CCOMP_TIMER_EVENT_I_STALL_CYCLES,   /*!< Cycles the instruction fetch waited for the memory, e.g. a cache miss */
+    CCOMP_TIMER_EVENT_D_STALL_CYCLES,   /*!< Cycles the loads and stores waited for the memory, e.g. a cache miss */
+} ccomp_timer_event_t;
+
+/**
+ * @brief Maximum number of events counted at the same time, the number of counters of the performance monitor.
+ */
+#define CCOMP_TIMER_EVENTS_MAX 2
+
+/**
+ * @brief Start counting events of the performance monitor on the current core, instead of timing.
+ *
+ * The stall cycles are the ones the timer subtracts from the elapsed cycles. Comparing them to the elapsed cycles
+ * tells whether some code is slowed down by cache misses, e.g. fetching code or tables from flash.
+ *
+ * @note Only supported on Xtensa targets. The RISC-V cores have no cache events, and their single performance counter
+ *       provides the cycle count of the system.
+ *
+ * @param[in] events Events to count
+ * @param[in] event_count Number of events, at most CCOMP_TIMER_EVENTS_MAX
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: Invalid event, or too many events
+ *  - ESP_ERR_INVALID_STATE: The timer has already been started previously.
+ *  - ESP_ERR_NOT_SUPPORTED: No performance monitor on this target
+ *  - Others: Fail
+ */
+esp_err_t ccomp_timer_start_events(const ccomp_timer_event_t *events, size_t event_count);
+
+/**
+ * @brief Stop counting events on the current core.
+ *
+ * @param[out] cycles Elapsed CPU cycles from the ccomp_timer_start_events() call, stall cycles included. Can be NULL.
+ * @param[out] counts Array of CCOMP_TIMER_EVENTS_MAX entries, receiving the count of each event passed to
+ *                    ccomp_timer_start_events() in the same order, the remaining entries being 0. Can be NULL.
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_STATE: Events are not being counted on this core
+ *  - Others: Fail
+ */
+esp_err_t ccomp_timer_stop_events(int64_t *cycles, int64_t *counts);
+
 #ifdef __cplusplus
 }
 #endif
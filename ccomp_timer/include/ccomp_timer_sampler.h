@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start sampling the program counter of all the cores.
+ *
+ * At every FreeRTOS tick, the program counter where the tick interrupted the running task is recorded in a ring
+ * buffer of CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE samples per core. Each sample stands for the CPU cycles of a tick
+ * period. Samples are dropped while the buffer of the core is full.
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_STATE: The sampler is already running
+ *  - ESP_ERR_NO_MEM: No free tick hook slot
+ */
+esp_err_t ccomp_timer_sampler_start(void);
+
+/**
+ * @brief Stop sampling. The samples recorded stay in the buffers.
+ *
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_STATE: The sampler is not running
+ */
+esp_err_t ccomp_timer_sampler_stop(void);
+
+/**
+ * @brief Take the oldest samples of a core out of its buffer.
+ *
+ * @param[in] core Core of the samples
+ * @param[out] pcs Program counters sampled
+ * @param[in] max_count Number of elements of pcs
+ * @return Number of samples taken, 0 once the buffer is empty
+ */
+size_t ccomp_timer_sampler_read(int core, uint32_t *pcs, size_t max_count);
+
+/**
+ * @brief Get the number of samples dropped on a core because its buffer was full, since the sampler started.
+ *
+ * @param[in] core Core of the samples
+ * @return Number of samples dropped
+ */
+uint32_t ccomp_timer_sampler_get_dropped(int core);
+
+/**
+ * @brief Print all the samples and empty the buffers.
+ *
+ * The output is read by tools/ccomp_timer_profile.py, which turns it into a flat profile of the functions:
+ * a `CCOMP_SAMPLER,<tick rate>,<CPU frequency>` line, then lines of `CCOMP_SAMPLES,<core>,<program counters>...`
+ * in hexadecimal, and a final `CCOMP_SAMPLER_END,<dropped samples>` line.
+ */
+void ccomp_timer_sampler_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Statistics of a profiling scope, over all its calls on all the cores.
+ *
+ * The times are in CPU cycles, without the cache stall cycles on Xtensa targets, like ccomp_timer_get_time().
+ */
+typedef struct {
+    const char *name;       /*!< Name of the scope */
+    uint32_t depth;         /*!< Smallest nesting depth the scope was recorded at, 0 for an outermost scope */
+    uint32_t calls;         /*!< Number of times the scope was entered and exited */
+    int64_t total_cycles;   /*!< Cycles spent in the scope, including the nested scopes */
+    int64_t self_cycles;    /*!< Cycles spent in the scope, excluding the nested scopes */
+    int64_t min_cycles;     /*!< Shortest call, including the nested scopes */
+    int64_t max_cycles;     /*!< Longest call, including the nested scopes */
+} ccomp_timer_scope_stats_t;
+
+/**
+ * @brief Enter a profiling scope on the current core.
+ *
+ * Scopes nest, each ccomp_timer_scope_begin() being closed by a ccomp_timer_scope_end() in the same task. If the
+ * timer isn't running on the current core, the outermost scope starts it with ccomp_timer_start() and stops it when
+ * it ends.
+ *
+ * @note Use CCOMP_TIMER_SCOPE_BEGIN() instead, which caches the scope ID and compiles to nothing when
+ *       CONFIG_CCOMP_TIMER_SCOPE_ENABLE is disabled.
+ *
+ * @param[inout] id ID of the scope, -1 until the first call which looks it up by name
+ * @param[in] name Name of the scope, which must stay valid. Scopes with the same name share their statistics.
+ */
+void ccomp_timer_scope_begin(int *id, const char *name);
+
+/**
+ * @brief Exit the innermost profiling scope on the current core, and account for its time.
+ */
+void ccomp_timer_scope_end(void);
+
+/**
+ * @brief Get the statistics of the scopes, in the order they were first entered.
+ *
+ * @param[out] stats Statistics of the scopes
+ * @param[in] max_count Number of elements of stats
+ * @param[out] count Number of scopes, possibly more than max_count
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: count is NULL, or stats is NULL while max_count isn't 0
+ *  - ESP_ERR_NOT_SUPPORTED: CONFIG_CCOMP_TIMER_SCOPE_ENABLE is disabled
+ */
+esp_err_t ccomp_timer_scope_get_stats(ccomp_timer_scope_stats_t *stats, size_t max_count, size_t *count);
+
+/**
+ * @brief Print the statistics of the scopes as a table, in microseconds, nested scopes being indented.
+ */
+void ccomp_timer_scope_print(void);
+
+/**
+ * @brief Clear the statistics of the scopes. Must not be called while a scope is open.
+ */
+void ccomp_timer_scope_reset(void);
+
+#if CONFIG_CCOMP_TIMER_SCOPE_ENABLE
+#define CCOMP_TIMER_SCOPE_BEGIN(name)                               \
+    do {                                                            \
+        static int ccomp_timer_scope_id = -1;                       \
+        ccomp_timer_scope_begin(&ccomp_timer_scope_id, name);       \
+    } while (0)
+#define CCOMP_TIMER_SCOPE_END() ccomp_timer_scope_end()
+#else
+#define CCOMP_TIMER_SCOPE_BEGIN(name) do { } while (0)
+#define CCOMP_TIMER_SCOPE_END() do { } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
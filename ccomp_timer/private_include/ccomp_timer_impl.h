@@ -8,7 +8,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include "esp_err.h"
+#include "ccomp_timer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +26,20 @@ extern "C" {
  */
 esp_err_t ccomp_timer_impl_init(void);
 
+/**
+ * @brief Initialize the underlying implementation to count events instead of keeping time. The elapsed
+ * cycles then include the stall cycles.
+ *
+ * @param[in] events Events to count
+ * @param[in] event_count Number of events, at most CCOMP_TIMER_EVENTS_MAX
+ * @return
+ *  - ESP_OK: Success
+ *  - ESP_ERR_INVALID_ARG: Invalid event, or too many events
+ *  - ESP_ERR_NOT_SUPPORTED: The events can't be counted on this target
+ *  - Others: Fail
+ */
+esp_err_t ccomp_timer_impl_init_events(const ccomp_timer_event_t *events, size_t event_count);
+
 /**
  * @brief Deinitialize the underlying implementation for cache compensated timer. This should restore
  * the state of the program to before ccomp_timer_impl_init.
@@ -68,6 +84,31 @@ esp_err_t ccomp_timer_impl_reset(void);
  */
 int64_t ccomp_timer_impl_get_time(void);
 
+/**
+ * @brief Get the elapsed time kept track of by the underlying implementation in CPU cycles.
+ *
+ * @return The elapsed CPU cycles, without the cache stall cycles where they are counted.
+ */
+int64_t ccomp_timer_impl_get_cycles(void);
+
+/**
+ * @brief Get the program counter of the task interrupted on the current core.
+ *
+ * @note Only valid in a level 1 interrupt which interrupted a task, e.g. a FreeRTOS tick hook. The interrupt entry
+ * saves the context of the task on its stack, and its stack pointer in the TCB.
+ *
+ * @return The program counter where the task was interrupted.
+ */
+uint32_t ccomp_timer_impl_get_interrupted_pc(void);
+
+/**
+ * @brief Get the count of an event, since ccomp_timer_impl_init_events.
+ *
+ * @param[in] index Index of the event in the events passed to ccomp_timer_impl_init_events
+ * @return The count of the event.
+ */
+int64_t ccomp_timer_impl_get_event_count(size_t index);
+
 /**
  * @brief Obtain an internal critical section used in the implementation. Should be treated
  * as a spinlock.
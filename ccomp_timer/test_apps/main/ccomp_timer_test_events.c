@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#include <stdint.h>
+
+#include "esp_attr.h"
+#include "ccomp_timer.h"
+
+#include "unity.h"
+
+#include "sdkconfig.h"
+
+#define LOOP_NUM    10000
+
+static void IRAM_ATTR computation(void)
+{
+    for (volatile int i = 0, a = 0; i < LOOP_NUM; i++) {
+        a += i;
+    }
+}
+
+TEST_CASE("counting events works", "[ccomp_timer]")
+{
+    const ccomp_timer_event_t events[] = {CCOMP_TIMER_EVENT_INSTRUCTIONS, CCOMP_TIMER_EVENT_I_STALL_CYCLES};
+
+#if CONFIG_IDF_TARGET_ARCH_RISCV
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, ccomp_timer_start_events(events, 2));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_stop_events(NULL, NULL));
+#else
+    int64_t cycles;
+    int64_t counts[CCOMP_TIMER_EVENTS_MAX];
+
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_start_events(events, 2));
+    // The timer and the counters can't be used at the same time
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_start());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_start_events(events, 2));
+    computation();
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_stop_events(&cycles, counts));
+
+    // Each iteration is a few instructions, and the cores retire at most one instruction per cycle
+    TEST_ASSERT_GREATER_THAN(LOOP_NUM, counts[0]);
+    TEST_ASSERT_GREATER_OR_EQUAL(counts[0], cycles);
+    TEST_ASSERT_LESS_THAN(cycles, counts[1]);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_stop_events(&cycles, counts));
+
+    // A single event leaves the other entry empty
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_start_events(&events[0], 1));
+    computation();
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_stop_events(NULL, counts));
+    TEST_ASSERT_GREATER_THAN(LOOP_NUM, counts[0]);
+    TEST_ASSERT_EQUAL(0, counts[1]);
+
+    // The timer can be started again afterwards
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_start());
+    TEST_ASSERT_NOT_EQUAL(-1, ccomp_timer_stop());
+#endif
+}
+
+TEST_CASE("counting events checks the arguments", "[ccomp_timer]")
+{
+    const ccomp_timer_event_t events[] = {CCOMP_TIMER_EVENT_INSTRUCTIONS, CCOMP_TIMER_EVENT_I_STALL_CYCLES,
+                                          CCOMP_TIMER_EVENT_D_STALL_CYCLES
+                                         };
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ccomp_timer_start_events(NULL, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ccomp_timer_start_events(events, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ccomp_timer_start_events(events, CCOMP_TIMER_EVENTS_MAX + 1));
+}
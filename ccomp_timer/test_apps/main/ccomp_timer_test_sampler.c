@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#include <stdint.h>
+
+#include "esp_timer.h"
+#include "esp_memory_utils.h"
+#include "ccomp_timer_sampler.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "unity.h"
+
+#define SAMPLE_TIME_US  100000
+
+TEST_CASE("sampler records the interrupted program counters", "[ccomp_timer]")
+{
+    static uint32_t pcs[CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE];
+    int core = xPortGetCoreID();
+
+    // drop the samples of previous runs
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        while (ccomp_timer_sampler_read(c, pcs, CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE) > 0) {
+        }
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_sampler_start());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_sampler_start());
+    vTaskSuspendAll();
+    int64_t end = esp_timer_get_time() + SAMPLE_TIME_US;
+    while (esp_timer_get_time() < end) {
+    }
+    xTaskResumeAll();
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_sampler_stop());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_sampler_stop());
+
+    size_t count = ccomp_timer_sampler_read(core, pcs, CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE);
+    TEST_ASSERT_GREATER_OR_EQUAL(SAMPLE_TIME_US / 1000 * configTICK_RATE_HZ / 1000 / 2, count);
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(esp_ptr_executable((void *)pcs[i]));
+    }
+    TEST_ASSERT_EQUAL(0, ccomp_timer_sampler_get_dropped(core));
+    TEST_ASSERT_EQUAL(0, ccomp_timer_sampler_read(core, pcs, CONFIG_CCOMP_TIMER_SAMPLER_BUF_SIZE));
+}
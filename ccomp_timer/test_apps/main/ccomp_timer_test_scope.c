@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+#include <stdint.h>
+#include <string.h>
+
+#include "ccomp_timer.h"
+#include "ccomp_timer_scope.h"
+
+#include "unity.h"
+
+static void computation(int l)
+{
+    for (volatile int i = 0, a = 0; i < l; i++) {
+        a += i;
+    }
+}
+
+static void inner(int l)
+{
+    CCOMP_TIMER_SCOPE_BEGIN("inner");
+    computation(l);
+    CCOMP_TIMER_SCOPE_END();
+}
+
+static const ccomp_timer_scope_stats_t *find_stats(const ccomp_timer_scope_stats_t *stats, size_t count, const char *name)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(stats[i].name, name) == 0) {
+            return &stats[i];
+        }
+    }
+    TEST_FAIL_MESSAGE("scope not found");
+    return NULL;
+}
+
+TEST_CASE("nested scopes are accounted", "[ccomp_timer]")
+{
+    ccomp_timer_scope_reset();
+    for (int i = 0; i < 10; i++) {
+        CCOMP_TIMER_SCOPE_BEGIN("outer");
+        computation(1000);
+        inner(1000 * (i + 1));
+        inner(100);
+        CCOMP_TIMER_SCOPE_END();
+    }
+    ccomp_timer_scope_print();
+
+    ccomp_timer_scope_stats_t stats[CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM];
+    size_t count;
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_scope_get_stats(stats, CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM, &count));
+    const ccomp_timer_scope_stats_t *outer = find_stats(stats, count, "outer");
+    const ccomp_timer_scope_stats_t *in = find_stats(stats, count, "inner");
+
+    TEST_ASSERT_EQUAL(10, outer->calls);
+    TEST_ASSERT_EQUAL(20, in->calls);
+    TEST_ASSERT_EQUAL(0, outer->depth);
+    TEST_ASSERT_EQUAL(1, in->depth);
+    TEST_ASSERT_EQUAL(in->total_cycles, in->self_cycles);
+    TEST_ASSERT_GREATER_THAN(0, outer->self_cycles);
+    TEST_ASSERT_EQUAL(outer->total_cycles, outer->self_cycles + in->total_cycles);
+    TEST_ASSERT_LESS_THAN(in->max_cycles, in->min_cycles);
+    TEST_ASSERT_LESS_OR_EQUAL(outer->max_cycles, outer->min_cycles);
+
+    // The outermost scope started the timer and stopped it
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_start());
+    TEST_ASSERT_GREATER_OR_EQUAL(0, ccomp_timer_stop());
+}
+
+TEST_CASE("scopes leave a running timer running", "[ccomp_timer]")
+{
+    ccomp_timer_scope_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_start());
+    inner(1000);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, ccomp_timer_start());
+    TEST_ASSERT_GREATER_THAN(0, ccomp_timer_stop());
+
+    ccomp_timer_scope_stats_t stats[CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM];
+    size_t count;
+    TEST_ASSERT_EQUAL(ESP_OK, ccomp_timer_scope_get_stats(stats, CONFIG_CCOMP_TIMER_SCOPE_MAX_NUM, &count));
+    TEST_ASSERT_EQUAL(1, find_stats(stats, count, "inner")->calls);
+}
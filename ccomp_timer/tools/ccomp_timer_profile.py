@@ -0,0 +1,107 @@
+#!/usr/bin/env python
+#
+# Turns the output of ccomp_timer_sampler_dump() into a flat profile of the functions, or of the source lines.
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import collections
+import subprocess
+import sys
+from typing import Dict, Iterable, List, TextIO, Tuple
+
+# e_machine of the ELF header
+ELF_MACHINE_XTENSA = 94
+ELF_MACHINE_RISCV = 243
+
+
+def default_addr2line(elf: str) -> str:
+    with open(elf, 'rb') as f:
+        header = f.read(20)
+    machine = int.from_bytes(header[18:20], 'little')
+    if machine == ELF_MACHINE_XTENSA:
+        return 'xtensa-esp-elf-addr2line'
+    if machine == ELF_MACHINE_RISCV:
+        return 'riscv32-esp-elf-addr2line'
+    return 'addr2line'
+
+
+def parse_dump(lines: Iterable[str]) -> Tuple[int, int, Dict[int, List[int]], int]:
+    """Returns the tick rate, the CPU frequency, the program counters of each core and the number of dropped samples"""
+    tick_hz = cpu_hz = dropped = 0
+    samples = collections.defaultdict(list)  # type: Dict[int, List[int]]
+    for line in lines:
+        # the lines can be prefixed, e.g. by a timestamp of the serial monitor
+        for tag in ('CCOMP_SAMPLER_END,', 'CCOMP_SAMPLER,', 'CCOMP_SAMPLES,'):
+            pos = line.find(tag)
+            if pos >= 0:
+                fields = line[pos + len(tag):].strip().split(',')
+                if tag == 'CCOMP_SAMPLER,':
+                    tick_hz, cpu_hz = int(fields[0]), int(fields[1])
+                elif tag == 'CCOMP_SAMPLES,':
+                    samples[int(fields[0])] += [int(pc, 16) for pc in fields[1:] if pc]
+                else:
+                    dropped = int(fields[0])
+                break
+    return tick_hz, cpu_hz, samples, dropped
+
+
+def symbolize(addr2line: str, elf: str, pcs: Iterable[int], lines: bool) -> Dict[int, str]:
+    pcs = sorted(set(pcs))
+    if not pcs:
+        return {}
+    out = subprocess.run([addr2line, '-f', '-C', '-e', elf], input='\n'.join('0x%x' % pc for pc in pcs),
+                         stdout=subprocess.PIPE, universal_newlines=True, check=True).stdout.splitlines()
+    # two lines per address: the function, then file:line
+    symbols = {}
+    for i, pc in enumerate(pcs):
+        function, location = out[2 * i], out[2 * i + 1]
+        if function == '??':
+            function = '0x%08x' % pc
+        symbols[pc] = '%s (%s)' % (function, location.split(' ')[0]) if lines else function
+    return symbols
+
+
+def print_profile(out: TextIO, samples: Dict[int, List[int]], symbols: Dict[int, str], tick_hz: int, cpu_hz: int,
+                  cores: List[int], limit: int) -> None:
+    counts = collections.Counter(symbols[pc] for core in cores for pc in samples[core])
+    total = sum(counts.values())
+    if total == 0:
+        out.write('No samples\n')
+        return
+    cycles_per_sample = cpu_hz // tick_hz if tick_hz else 0
+    out.write('%d samples on core(s) %s, %d cycles each\n\n' % (total, ','.join(str(c) for c in cores), cycles_per_sample))
+    out.write('%8s %7s %7s %14s  %s\n' % ('Samples', '%', 'Cum %', 'Est. cycles', 'Function'))
+    cumulated = 0
+    for name, count in counts.most_common(limit or None):
+        cumulated += count
+        out.write('%8d %6.2f%% %6.2f%% %14d  %s\n' % (count, 100.0 * count / total, 100.0 * cumulated / total,
+                                                     count * cycles_per_sample, name))
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser('Flat profile from the samples of ccomp_timer_sampler_dump()')
+    parser.add_argument('elf', help='ELF file of the application')
+    parser.add_argument('log', nargs='?', type=argparse.FileType('r'), default=sys.stdin,
+                        help='Output of the application, standard input by default')
+    parser.add_argument('--addr2line', help='addr2line of the toolchain, guessed from the ELF file by default')
+    parser.add_argument('--core', type=int, action='append', help='Only this core, can be repeated')
+    parser.add_argument('--lines', action='store_true', help='Profile of the source lines instead of the functions')
+    parser.add_argument('--limit', type=int, default=30, help='Number of entries shown, 0 for all')
+    args = parser.parse_args()
+
+    tick_hz, cpu_hz, samples, dropped = parse_dump(args.log)
+    if not samples:
+        print('No CCOMP_SAMPLES lines found')
+        sys.exit(1)
+    cores = args.core if args.core else sorted(samples)
+    symbols = symbolize(args.addr2line or default_addr2line(args.elf), args.elf,
+                        (pc for core in cores for pc in samples[core]), args.lines)
+    print_profile(sys.stdout, samples, symbols, tick_hz, cpu_hz, cores, args.limit)
+    if dropped:
+        print('\n%d samples were dropped, the buffers were full' % dropped)
+
+
+if __name__ == '__main__':
+    main()
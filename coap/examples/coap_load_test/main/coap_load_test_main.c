@@ -0,0 +1,354 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+/* CoAP server load test
+
+   This example code is in the Public Domain (or CC0 licensed, at your option.)
+
+   Unless required by applicable law or agreed to in writing, this
+   software is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+   CONDITIONS OF ANY KIND, either express or implied.
+*/
+
+/*
+ * A CoAP server and a set of clients run on the same chip and talk over the loopback interface, so that the
+ * measurements only depend on the CoAP stack: requests per second, latency percentiles and heap high-water mark,
+ * for CON and NON requests, over UDP and DTLS PSK.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_netif.h"
+#include "sdkconfig.h"
+
+#include "coap3/coap.h"
+#ifdef CONFIG_COAP_MEM_POOLS
+#include "coap_mem_pool.h"
+#endif /* CONFIG_COAP_MEM_POOLS */
+
+#ifndef CONFIG_COAP_SERVER_SUPPORT
+#error COAP_SERVER_SUPPORT needs to be enabled
+#endif /* ! CONFIG_COAP_SERVER_SUPPORT */
+#ifndef CONFIG_COAP_CLIENT_SUPPORT
+#error COAP_CLIENT_SUPPORT needs to be enabled
+#endif /* ! CONFIG_COAP_CLIENT_SUPPORT */
+
+#define EXAMPLE_COAP_PORT       5683
+#define EXAMPLE_COAPS_PORT      5684
+#define EXAMPLE_COAP_PSK_HINT   "CoAP"
+#define EXAMPLE_COAP_RESOURCE   "bench"
+
+const static char *TAG = "CoAP_load_test";
+
+typedef struct {
+    int64_t sent_us;
+    uint8_t token[8];
+    size_t token_len;
+    bool busy;
+} bench_slot_t;
+
+static uint8_t s_payload[CONFIG_EXAMPLE_COAP_PAYLOAD_SIZE + 1];
+static uint32_t *s_latency_us;
+static size_t s_done;
+static size_t s_lost;
+static bool s_record;
+static size_t s_min_free_heap;
+static volatile bool s_server_stop;
+static SemaphoreHandle_t s_server_done;
+
+static void bench_loopback_address(coap_address_t *addr, uint16_t port)
+{
+    coap_address_init(addr);
+    addr->size = sizeof(struct sockaddr_in);
+    addr->addr.sin.sin_family = AF_INET;
+    addr->addr.sin.sin_port = htons(port);
+    addr->addr.sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+}
+
+static void hnd_bench_get(coap_resource_t *resource, coap_session_t *session, const coap_pdu_t *request,
+                          const coap_string_t *query, coap_pdu_t *response)
+{
+    coap_pdu_set_code(response, COAP_RESPONSE_CODE_CONTENT);
+    coap_add_data(response, CONFIG_EXAMPLE_COAP_PAYLOAD_SIZE, s_payload);
+}
+
+static void bench_server_task(void *arg)
+{
+    coap_context_t *ctx = coap_new_context(NULL);
+    coap_address_t addr;
+    coap_resource_t *resource;
+
+    if (!ctx) {
+        ESP_LOGE(TAG, "coap_new_context() failed");
+        goto clean_up;
+    }
+    coap_context_set_max_idle_sessions(ctx, 2 * CONFIG_EXAMPLE_COAP_CLIENTS);
+#ifdef CONFIG_COAP_MBEDTLS_PSK
+    coap_context_set_psk(ctx, EXAMPLE_COAP_PSK_HINT, (const uint8_t *)CONFIG_EXAMPLE_COAP_PSK_KEY,
+                         sizeof(CONFIG_EXAMPLE_COAP_PSK_KEY) - 1);
+#endif /* CONFIG_COAP_MBEDTLS_PSK */
+
+    bench_loopback_address(&addr, EXAMPLE_COAP_PORT);
+    if (!coap_new_endpoint(ctx, &addr, COAP_PROTO_UDP)) {
+        ESP_LOGE(TAG, "cannot create the UDP endpoint");
+        goto clean_up;
+    }
+#ifdef CONFIG_COAP_MBEDTLS_PSK
+    bench_loopback_address(&addr, EXAMPLE_COAPS_PORT);
+    if (!coap_new_endpoint(ctx, &addr, COAP_PROTO_DTLS)) {
+        ESP_LOGE(TAG, "cannot create the DTLS endpoint");
+        goto clean_up;
+    }
+#endif /* CONFIG_COAP_MBEDTLS_PSK */
+
+    resource = coap_resource_init(coap_make_str_const(EXAMPLE_COAP_RESOURCE), 0);
+    if (!resource) {
+        ESP_LOGE(TAG, "coap_resource_init() failed");
+        goto clean_up;
+    }
+    coap_register_handler(resource, COAP_REQUEST_GET, hnd_bench_get);
+    coap_add_resource(ctx, resource);
+
+    while (!s_server_stop) {
+        if (coap_io_process(ctx, 100) < 0) {
+            break;
+        }
+    }
+
+clean_up:
+    coap_free_context(ctx);
+    xSemaphoreGive(s_server_done);
+    vTaskDelete(NULL);
+}
+
+static coap_response_t bench_response_handler(coap_session_t *session, const coap_pdu_t *sent,
+                                              const coap_pdu_t *received, const coap_mid_t mid)
+{
+    bench_slot_t *slot = (bench_slot_t *)coap_session_get_app_data(session);
+    coap_bin_const_t token = coap_pdu_get_token(received);
+
+    /* a NON response coming after its request timed out is ignored */
+    if (!slot->busy || token.length != slot->token_len || memcmp(token.s, slot->token, token.length) != 0) {
+        return COAP_RESPONSE_OK;
+    }
+    if (s_record && s_done < CONFIG_EXAMPLE_COAP_REQUESTS) {
+        s_latency_us[s_done] = (uint32_t)(esp_timer_get_time() - slot->sent_us);
+    }
+    s_done++;
+    slot->busy = false;
+    return COAP_RESPONSE_OK;
+}
+
+static void bench_nack_handler(coap_session_t *session, const coap_pdu_t *sent, const coap_nack_reason_t reason,
+                               const coap_mid_t mid)
+{
+    bench_slot_t *slot = (bench_slot_t *)coap_session_get_app_data(session);
+
+    if (slot->busy) {
+        slot->busy = false;
+        s_lost++;
+    }
+}
+
+static void bench_send(coap_session_t *session, bench_slot_t *slot, coap_pdu_type_t type)
+{
+    coap_pdu_t *request = coap_new_pdu(type, COAP_REQUEST_CODE_GET, session);
+
+    if (!request) {
+        s_lost++;
+        return;
+    }
+    coap_session_new_token(session, &slot->token_len, slot->token);
+    coap_add_token(request, slot->token_len, slot->token);
+    coap_add_option(request, COAP_OPTION_URI_PATH, strlen(EXAMPLE_COAP_RESOURCE),
+                    (const uint8_t *)EXAMPLE_COAP_RESOURCE);
+    slot->sent_us = esp_timer_get_time();
+    slot->busy = true;
+    if (coap_send(session, request) == COAP_INVALID_MID) {
+        slot->busy = false;
+        s_lost++;
+    }
+}
+
+/* Run the requests, with one in flight per client, until they are all answered or lost */
+static void bench_loop(coap_context_t *ctx, coap_session_t **sessions, bench_slot_t *slots, size_t requests,
+                       coap_pdu_type_t type)
+{
+    size_t sent = 0;
+
+    s_done = 0;
+    s_lost = 0;
+    while (s_done + s_lost < requests) {
+        int64_t now = esp_timer_get_time();
+
+        for (int i = 0; i < CONFIG_EXAMPLE_COAP_CLIENTS; i++) {
+            if (slots[i].busy && type == COAP_MESSAGE_NON &&
+                    now - slots[i].sent_us > CONFIG_EXAMPLE_COAP_NON_TIMEOUT_MS * 1000LL) {
+                slots[i].busy = false;
+                s_lost++;
+            }
+            if (!slots[i].busy && sent < requests) {
+                bench_send(sessions[i], &slots[i], type);
+                sent++;
+            }
+        }
+        if (coap_io_process(ctx, 10) < 0) {
+            break;
+        }
+        size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+        if (free_heap < s_min_free_heap) {
+            s_min_free_heap = free_heap;
+        }
+    }
+}
+
+static int bench_compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void bench_run(coap_proto_t proto, coap_pdu_type_t type)
+{
+    const char *name = proto == COAP_PROTO_DTLS ? "DTLS" : "UDP";
+    const char *type_name = type == COAP_MESSAGE_CON ? "CON" : "NON";
+    coap_session_t *sessions[CONFIG_EXAMPLE_COAP_CLIENTS] = {0};
+    bench_slot_t slots[CONFIG_EXAMPLE_COAP_CLIENTS] = {0};
+    coap_context_t *ctx = coap_new_context(NULL);
+    coap_address_t dst;
+
+    if (!ctx) {
+        ESP_LOGE(TAG, "coap_new_context() failed");
+        return;
+    }
+    coap_register_response_handler(ctx, bench_response_handler);
+    coap_register_nack_handler(ctx, bench_nack_handler);
+    bench_loopback_address(&dst, proto == COAP_PROTO_DTLS ? EXAMPLE_COAPS_PORT : EXAMPLE_COAP_PORT);
+
+    for (int i = 0; i < CONFIG_EXAMPLE_COAP_CLIENTS; i++) {
+#ifdef CONFIG_COAP_MBEDTLS_PSK
+        if (proto == COAP_PROTO_DTLS) {
+            coap_dtls_cpsk_t dtls_psk;
+
+            memset(&dtls_psk, 0, sizeof(dtls_psk));
+            dtls_psk.version = COAP_DTLS_CPSK_SETUP_VERSION;
+            dtls_psk.psk_info.identity.s = (const uint8_t *)EXAMPLE_COAP_PSK_HINT;
+            dtls_psk.psk_info.identity.length = sizeof(EXAMPLE_COAP_PSK_HINT) - 1;
+            dtls_psk.psk_info.key.s = (const uint8_t *)CONFIG_EXAMPLE_COAP_PSK_KEY;
+            dtls_psk.psk_info.key.length = sizeof(CONFIG_EXAMPLE_COAP_PSK_KEY) - 1;
+            sessions[i] = coap_new_client_session_psk2(ctx, NULL, &dst, proto, &dtls_psk);
+        } else
+#endif /* CONFIG_COAP_MBEDTLS_PSK */
+        {
+            sessions[i] = coap_new_client_session(ctx, NULL, &dst, proto);
+        }
+        if (!sessions[i]) {
+            ESP_LOGE(TAG, "%s: coap_new_client_session() failed", name);
+            goto clean_up;
+        }
+        coap_session_set_app_data(sessions[i], &slots[i]);
+    }
+
+    /* one request per client first, so that the DTLS handshakes are not in the measurement */
+    int64_t start_us = esp_timer_get_time();
+    s_record = false;
+    bench_loop(ctx, sessions, slots, CONFIG_EXAMPLE_COAP_CLIENTS, type);
+    int64_t setup_us = esp_timer_get_time() - start_us;
+
+    size_t free_heap = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s_min_free_heap = free_heap;
+    s_record = true;
+    start_us = esp_timer_get_time();
+    bench_loop(ctx, sessions, slots, CONFIG_EXAMPLE_COAP_REQUESTS, type);
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    s_record = false;
+
+    size_t n = MIN(s_done, CONFIG_EXAMPLE_COAP_REQUESTS);
+    uint32_t p50 = 0;
+    uint32_t p99 = 0;
+    uint32_t max = 0;
+    if (n) {
+        qsort(s_latency_us, n, sizeof(uint32_t), bench_compare_u32);
+        p50 = s_latency_us[(n - 1) / 2];
+        p99 = s_latency_us[(n * 99 + 99) / 100 - 1];
+        max = s_latency_us[n - 1];
+    }
+    ESP_LOGI(TAG, "%-4s %s: %u req in %u ms, %u req/s, latency p50 %u us, p99 %u us, max %u us, %u lost",
+             name, type_name, (unsigned)n, (unsigned)(elapsed_us / 1000),
+             (unsigned)(elapsed_us ? n * 1000000LL / elapsed_us : 0), (unsigned)p50, (unsigned)p99, (unsigned)max,
+             (unsigned)s_lost);
+    ESP_LOGI(TAG, "%-4s %s: heap high-water %u bytes, setup of %d sessions %u ms", name, type_name,
+             (unsigned)(free_heap - s_min_free_heap), CONFIG_EXAMPLE_COAP_CLIENTS, (unsigned)(setup_us / 1000));
+
+clean_up:
+    for (int i = 0; i < CONFIG_EXAMPLE_COAP_CLIENTS; i++) {
+        if (sessions[i]) {
+            coap_session_release(sessions[i]);
+        }
+    }
+    coap_free_context(ctx);
+}
+
+static void bench_print_pools(void)
+{
+#ifdef CONFIG_COAP_MEM_POOLS
+    static const char *pool_names[COAP_MEM_POOL_MAX] = {"PDU", "PDU buffer", "session"};
+
+    for (int i = 0; i < COAP_MEM_POOL_MAX; i++) {
+        coap_mem_pool_stats_t stats;
+
+        coap_mem_pool_get_stats(i, &stats);
+        ESP_LOGI(TAG, "%s pool: %u of %u blocks of %u bytes used at most, %u allocations from the heap",
+                 pool_names[i], (unsigned)stats.max_used, (unsigned)stats.block_num, (unsigned)stats.block_size,
+                 (unsigned)stats.fallback_count);
+    }
+#endif /* CONFIG_COAP_MEM_POOLS */
+}
+
+static void coap_load_test(void *p)
+{
+    memset(s_payload, 'x', sizeof(s_payload));
+    s_latency_us = malloc(CONFIG_EXAMPLE_COAP_REQUESTS * sizeof(uint32_t));
+    s_server_done = xSemaphoreCreateBinary();
+    if (!s_latency_us || !s_server_done) {
+        ESP_LOGE(TAG, "no memory for the load test");
+        vTaskDelete(NULL);
+    }
+
+    coap_startup();
+    xTaskCreate(bench_server_task, "coap_server", 8 * 1024, NULL, 5, NULL);
+    /* let the server create its endpoints */
+    vTaskDelay(pdMS_TO_TICKS(100));
+
+    bench_run(COAP_PROTO_UDP, COAP_MESSAGE_CON);
+    bench_run(COAP_PROTO_UDP, COAP_MESSAGE_NON);
+#ifdef CONFIG_COAP_MBEDTLS_PSK
+    bench_run(COAP_PROTO_DTLS, COAP_MESSAGE_CON);
+    bench_run(COAP_PROTO_DTLS, COAP_MESSAGE_NON);
+#endif /* CONFIG_COAP_MBEDTLS_PSK */
+    bench_print_pools();
+
+    s_server_stop = true;
+    xSemaphoreTake(s_server_done, portMAX_DELAY);
+    coap_cleanup();
+
+    ESP_LOGI(TAG, "Finished");
+    vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+    /* only the loopback interface is used */
+    ESP_ERROR_CHECK(esp_netif_init());
+
+    xTaskCreate(coap_load_test, "coap_load_test", 8 * 1024, NULL, 5, NULL);
+}
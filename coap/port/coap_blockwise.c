@@ -0,0 +1,315 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "coap_blockwise.h"
+
+static const char *TAG = "coap_blockwise";
+
+/* Room left in a PDU for the header, the token, the options and the payload marker of a block */
+#define COAP_BLOCKWISE_PDU_OVERHEAD 32
+
+#define COAP_BLOCKWISE_BLOCK_SIZE(szx) ((size_t)1 << ((szx) + 4))
+
+struct coap_blockwise_source_t {
+    size_t size;
+    coap_blockwise_read_cb_t read;
+    void *arg;
+    int content_format;
+    uint8_t max_szx;
+    uint8_t *buf;              // block buffer, also filled by the prefetch task
+    TaskHandle_t task;         // prefetch task, NULL without prefetch
+    SemaphoreHandle_t idle;    // taken while the prefetch task reads a block
+    size_t prefetch_offset;
+    size_t prefetch_len;
+    esp_err_t prefetch_ret;
+    bool prefetched;           // buf holds the block at prefetch_offset, once the task is idle
+    bool exit;
+};
+
+struct coap_blockwise_sink_t {
+    size_t max_size;
+    coap_blockwise_write_cb_t write;
+    void *arg;
+    uint8_t max_szx;
+    const coap_session_t *session; // session of the upload in progress, only compared
+    size_t next_offset;
+    bool active;
+};
+
+/* Largest block size, up to max_szx, of which a block fits in a PDU of the session */
+static unsigned int blockwise_session_szx(const coap_session_t *session, unsigned int max_szx)
+{
+    size_t max_pdu = coap_session_max_pdu_size(session);
+    unsigned int szx = max_szx;
+    while (szx > COAP_BLOCKWISE_SZX_16 && COAP_BLOCKWISE_BLOCK_SIZE(szx) + COAP_BLOCKWISE_PDU_OVERHEAD > max_pdu) {
+        szx--;
+    }
+    return szx;
+}
+
+static void blockwise_add_uint_option(coap_pdu_t *pdu, coap_option_num_t number, unsigned int value)
+{
+    uint8_t buf[4];
+    coap_add_option(pdu, number, coap_encode_var_safe(buf, sizeof(buf), value), buf);
+}
+
+static void blockwise_add_block_option(coap_pdu_t *pdu, coap_option_num_t number, unsigned int num, bool more,
+                                       unsigned int szx)
+{
+    blockwise_add_uint_option(pdu, number, (num << 4) | (more ? 0x08 : 0) | szx);
+}
+
+static void blockwise_prefetch_task(void *arg)
+{
+    coap_blockwise_source_handle_t source = (coap_blockwise_source_handle_t)arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (source->exit) {
+            break;
+        }
+        source->prefetch_ret = source->read(source->prefetch_offset, source->buf, source->prefetch_len, source->arg);
+        xSemaphoreGive(source->idle);
+    }
+    xSemaphoreGive(source->idle);
+    vTaskDelete(NULL);
+}
+
+static void blockwise_source_get(coap_resource_t *resource, coap_session_t *session, const coap_pdu_t *request,
+                                 const coap_string_t *query, coap_pdu_t *response)
+{
+    (void)query;
+    coap_blockwise_source_handle_t source = (coap_blockwise_source_handle_t)coap_resource_get_userdata(resource);
+    coap_block_b_t block = {0};
+    unsigned int szx = blockwise_session_szx(session, source->max_szx);
+    size_t offset = 0;
+    bool blockwise = coap_get_block_b(session, request, COAP_OPTION_BLOCK2, &block);
+    if (blockwise) {
+        // a block of a larger size is a whole number of blocks of the smaller one
+        offset = (size_t)block.num << (MIN(block.szx, COAP_BLOCKWISE_SZX_1024) + 4);
+        szx = MIN(szx, block.szx);
+    }
+    if (offset > source->size || (offset == source->size && offset > 0)) {
+        coap_pdu_set_code(response, COAP_RESPONSE_CODE_BAD_OPTION);
+        return;
+    }
+    size_t len = MIN(COAP_BLOCKWISE_BLOCK_SIZE(szx), source->size - offset);
+    bool more = offset + len < source->size;
+    // no Block2 option at all for a resource fitting in one block which wasn't asked block-wise
+    blockwise = blockwise || more;
+
+    esp_err_t ret = ESP_OK;
+    if (source->task) {
+        xSemaphoreTake(source->idle, portMAX_DELAY);
+    }
+    if (!source->prefetched || source->prefetch_ret != ESP_OK ||
+            source->prefetch_offset != offset || source->prefetch_len != len) {
+        ret = source->read(offset, source->buf, len, source->arg);
+    }
+    source->prefetched = false;
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "read of %u bytes at %u failed: %s", (unsigned)len, (unsigned)offset, esp_err_to_name(ret));
+        if (source->task) {
+            xSemaphoreGive(source->idle);
+        }
+        coap_pdu_set_code(response, COAP_RESPONSE_CODE_INTERNAL_ERROR);
+        return;
+    }
+
+    coap_pdu_set_code(response, COAP_RESPONSE_CODE_CONTENT);
+    if (source->content_format != COAP_BLOCKWISE_NO_CONTENT_FORMAT) {
+        blockwise_add_uint_option(response, COAP_OPTION_CONTENT_FORMAT, (unsigned int)source->content_format);
+    }
+    if (blockwise) {
+        blockwise_add_block_option(response, COAP_OPTION_BLOCK2, offset >> (szx + 4), more, szx);
+        blockwise_add_uint_option(response, COAP_OPTION_SIZE2, source->size);
+    }
+    coap_add_data(response, len, source->buf);
+
+    // the block is copied into the response, read the next one while this one is in flight
+    if (source->task) {
+        if (more) {
+            source->prefetch_offset = offset + len;
+            source->prefetch_len = MIN(len, source->size - source->prefetch_offset);
+            source->prefetched = true;
+            xTaskNotifyGive(source->task);
+        } else {
+            xSemaphoreGive(source->idle);
+        }
+    }
+}
+
+esp_err_t coap_blockwise_source_new(const coap_blockwise_source_config_t *config,
+                                    coap_blockwise_source_handle_t *ret_source)
+{
+    esp_err_t ret = ESP_OK;
+    coap_blockwise_source_handle_t source = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_source && config->read, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->max_szx <= COAP_BLOCKWISE_SZX_1024, ESP_ERR_INVALID_ARG, err, TAG, "invalid max_szx");
+    source = calloc(1, sizeof(struct coap_blockwise_source_t));
+    ESP_GOTO_ON_FALSE(source, ESP_ERR_NO_MEM, err, TAG, "no mem for source");
+    source->buf = malloc(COAP_BLOCKWISE_BLOCK_SIZE(config->max_szx));
+    ESP_GOTO_ON_FALSE(source->buf, ESP_ERR_NO_MEM, err, TAG, "no mem for block buffer");
+    source->size = config->size;
+    source->read = config->read;
+    source->arg = config->arg;
+    source->content_format = config->content_format;
+    source->max_szx = config->max_szx;
+    if (config->flags.prefetch) {
+        source->idle = xSemaphoreCreateBinary();
+        ESP_GOTO_ON_FALSE(source->idle, ESP_ERR_NO_MEM, err, TAG, "no mem for semaphore");
+        xSemaphoreGive(source->idle);
+        ESP_GOTO_ON_FALSE(xTaskCreate(blockwise_prefetch_task, "coap_prefetch", config->prefetch_task_stack_size,
+                                      source, config->prefetch_task_priority, &source->task) == pdPASS,
+                          ESP_ERR_NO_MEM, err, TAG, "create prefetch task failed");
+    }
+    *ret_source = source;
+    return ESP_OK;
+
+err:
+    if (source) {
+        if (source->idle) {
+            vSemaphoreDelete(source->idle);
+        }
+        free(source->buf);
+        free(source);
+    }
+    return ret;
+}
+
+esp_err_t coap_blockwise_source_del(coap_blockwise_source_handle_t source)
+{
+    ESP_RETURN_ON_FALSE(source, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (source->task) {
+        // wait for the block being prefetched, then for the task to exit
+        xSemaphoreTake(source->idle, portMAX_DELAY);
+        source->exit = true;
+        xTaskNotifyGive(source->task);
+        xSemaphoreTake(source->idle, portMAX_DELAY);
+        vSemaphoreDelete(source->idle);
+    }
+    free(source->buf);
+    free(source);
+    return ESP_OK;
+}
+
+esp_err_t coap_blockwise_source_set_size(coap_blockwise_source_handle_t source, size_t size)
+{
+    ESP_RETURN_ON_FALSE(source, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (source->task) {
+        xSemaphoreTake(source->idle, portMAX_DELAY);
+    }
+    source->size = size;
+    source->prefetched = false;
+    if (source->task) {
+        xSemaphoreGive(source->idle);
+    }
+    return ESP_OK;
+}
+
+esp_err_t coap_blockwise_register_source(coap_resource_t *resource, coap_blockwise_source_handle_t source)
+{
+    ESP_RETURN_ON_FALSE(resource && source, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    coap_resource_set_userdata(resource, source);
+    coap_register_request_handler(resource, COAP_REQUEST_GET, blockwise_source_get);
+    return ESP_OK;
+}
+
+static void blockwise_sink_upload(coap_resource_t *resource, coap_session_t *session, const coap_pdu_t *request,
+                                  const coap_string_t *query, coap_pdu_t *response)
+{
+    (void)query;
+    coap_blockwise_sink_handle_t sink = (coap_blockwise_sink_handle_t)coap_resource_get_userdata(resource);
+    coap_block_b_t block = {0};
+    coap_opt_iterator_t opt_iter;
+    const uint8_t *data = NULL;
+    size_t len = 0;
+    coap_get_data(request, &len, &data);
+    bool blockwise = coap_get_block_b(session, request, COAP_OPTION_BLOCK1, &block);
+    unsigned int szx = MIN(block.szx, COAP_BLOCKWISE_SZX_1024);
+    size_t offset = blockwise ? (size_t)block.num << (szx + 4) : 0;
+    bool more = blockwise && block.m;
+
+    coap_opt_t *size1 = coap_check_option(request, COAP_OPTION_SIZE1, &opt_iter);
+    size_t total = size1 ? coap_decode_var_bytes(coap_opt_value(size1), coap_opt_length(size1)) : 0;
+    if (total > sink->max_size || offset + len > sink->max_size) {
+        coap_pdu_set_code(response, COAP_RESPONSE_CODE_REQUEST_TOO_LARGE);
+        blockwise_add_uint_option(response, COAP_OPTION_SIZE1, sink->max_size);
+        return;
+    }
+    if (more && len != COAP_BLOCKWISE_BLOCK_SIZE(szx)) {
+        coap_pdu_set_code(response, COAP_RESPONSE_CODE_BAD_REQUEST);
+        return;
+    }
+    if (offset == 0) {
+        sink->session = session;
+        sink->next_offset = 0;
+        sink->active = true;
+    } else if (!sink->active || sink->session != session || offset > sink->next_offset) {
+        coap_pdu_set_code(response, COAP_RESPONSE_CODE_INCOMPLETE);
+        return;
+    }
+
+    // a retransmitted block is acknowledged again, without being written twice
+    if (offset + len > sink->next_offset || (offset == sink->next_offset && !more)) {
+        esp_err_t ret = sink->write(offset, data, len, !more, sink->arg);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "write of %u bytes at %u failed: %s", (unsigned)len, (unsigned)offset, esp_err_to_name(ret));
+            sink->active = false;
+            coap_pdu_set_code(response, COAP_RESPONSE_CODE_INTERNAL_ERROR);
+            return;
+        }
+        sink->next_offset = offset + len;
+        sink->active = more;
+    }
+
+    coap_pdu_set_code(response, more ? COAP_RESPONSE_CODE_CONTINUE : COAP_RESPONSE_CODE_CHANGED);
+    if (blockwise) {
+        // a smaller size in the reply asks the client to use it for the next blocks
+        unsigned int reply_szx = MIN(szx, blockwise_session_szx(session, sink->max_szx));
+        size_t end = offset + len;
+        unsigned int num = more ? (unsigned int)(end >> (reply_szx + 4)) - 1 : block.num;
+        blockwise_add_block_option(response, COAP_OPTION_BLOCK1, num, more, more ? reply_szx : szx);
+    }
+}
+
+esp_err_t coap_blockwise_sink_new(const coap_blockwise_sink_config_t *config, coap_blockwise_sink_handle_t *ret_sink)
+{
+    ESP_RETURN_ON_FALSE(config && ret_sink && config->write, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->max_szx <= COAP_BLOCKWISE_SZX_1024, ESP_ERR_INVALID_ARG, TAG, "invalid max_szx");
+    coap_blockwise_sink_handle_t sink = calloc(1, sizeof(struct coap_blockwise_sink_t));
+    ESP_RETURN_ON_FALSE(sink, ESP_ERR_NO_MEM, TAG, "no mem for sink");
+    sink->max_size = config->max_size;
+    sink->write = config->write;
+    sink->arg = config->arg;
+    sink->max_szx = config->max_szx;
+    *ret_sink = sink;
+    return ESP_OK;
+}
+
+esp_err_t coap_blockwise_sink_del(coap_blockwise_sink_handle_t sink)
+{
+    ESP_RETURN_ON_FALSE(sink, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    free(sink);
+    return ESP_OK;
+}
+
+esp_err_t coap_blockwise_register_sink(coap_resource_t *resource, coap_request_t method,
+                                       coap_blockwise_sink_handle_t sink)
+{
+    ESP_RETURN_ON_FALSE(resource && sink, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(method == COAP_REQUEST_PUT || method == COAP_REQUEST_POST, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid method");
+    coap_resource_set_userdata(resource, sink);
+    coap_register_request_handler(resource, method, blockwise_sink_upload);
+    return ESP_OK;
+}
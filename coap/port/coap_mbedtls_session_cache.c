@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * DTLS session resumption cache of the CoAP servers.
+ *
+ * libcoap configures the DTLS cookies of each server SSL configuration it sets up, so
+ * mbedtls_ssl_conf_dtls_cookies() is wrapped at link time (see CMakeLists.txt) to attach the
+ * session cache to those configurations as well.
+ */
+#include <pthread.h>
+#include "sdkconfig.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+
+#if !defined(MBEDTLS_SSL_CACHE_C)
+#error "CONFIG_COAP_MBEDTLS_SESSION_CACHE needs MBEDTLS_SSL_CACHE_C in the mbedTLS configuration"
+#endif
+
+static mbedtls_ssl_cache_context s_session_cache;
+static pthread_once_t s_session_cache_once = PTHREAD_ONCE_INIT;
+
+void __real_mbedtls_ssl_conf_dtls_cookies(mbedtls_ssl_config *conf, mbedtls_ssl_cookie_write_t *f_cookie_write,
+                                          mbedtls_ssl_cookie_check_t *f_cookie_check, void *p_cookie);
+
+static void coap_session_cache_init(void)
+{
+    mbedtls_ssl_cache_init(&s_session_cache);
+    mbedtls_ssl_cache_set_max_entries(&s_session_cache, CONFIG_COAP_MBEDTLS_SESSION_CACHE_SIZE);
+    mbedtls_ssl_cache_set_timeout(&s_session_cache, CONFIG_COAP_MBEDTLS_SESSION_CACHE_TIMEOUT);
+}
+
+void __wrap_mbedtls_ssl_conf_dtls_cookies(mbedtls_ssl_config *conf, mbedtls_ssl_cookie_write_t *f_cookie_write,
+                                          mbedtls_ssl_cookie_check_t *f_cookie_check, void *p_cookie)
+{
+    __real_mbedtls_ssl_conf_dtls_cookies(conf, f_cookie_write, f_cookie_check, p_cookie);
+    pthread_once(&s_session_cache_once, coap_session_cache_init);
+    mbedtls_ssl_conf_session_cache(conf, &s_session_cache, mbedtls_ssl_cache_get, mbedtls_ssl_cache_set);
+}
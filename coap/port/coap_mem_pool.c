@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/*
+ * Preallocated pools for the PDUs and the sessions of libcoap.
+ *
+ * coap_malloc_type(), coap_realloc_type() and coap_free_type() are wrapped at link time (see CMakeLists.txt), so
+ * that the allocations of the pooled types are served from static blocks. The others, and the ones which don't fit
+ * in a pool, go to the libcoap implementation in coap_mem.c.
+ */
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_check.h"
+#include "coap3/coap_libcoap_build.h"
+#include "coap_mem_pool.h"
+
+static const char *TAG = "coap_mem_pool";
+
+#define COAP_MEM_POOL_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+#define COAP_MEM_POOL_PDU_SIZE     COAP_MEM_POOL_ALIGN(sizeof(coap_pdu_t))
+#define COAP_MEM_POOL_PDU_BUF_SIZE COAP_MEM_POOL_ALIGN(CONFIG_COAP_MEM_POOL_PDU_BUF_SIZE)
+#define COAP_MEM_POOL_SESSION_SIZE COAP_MEM_POOL_ALIGN(sizeof(coap_session_t))
+
+typedef struct coap_mem_block_t {
+    struct coap_mem_block_t *next;
+} coap_mem_block_t;
+
+typedef struct {
+    uint8_t *base;
+    size_t block_size;
+    size_t block_num;
+    coap_mem_block_t *free_list;
+    size_t next_unused;      // blocks never used yet are taken in order, so that no initialization is needed
+    size_t used;
+    size_t max_used;
+    size_t fallback_count;
+} coap_mem_pool_t;
+
+static uint8_t s_pdu_blocks[CONFIG_COAP_MEM_POOL_PDU_NUM][COAP_MEM_POOL_PDU_SIZE] __attribute__((aligned(8)));
+static uint8_t s_pdu_buf_blocks[CONFIG_COAP_MEM_POOL_PDU_NUM][COAP_MEM_POOL_PDU_BUF_SIZE] __attribute__((aligned(8)));
+static uint8_t s_session_blocks[CONFIG_COAP_MEM_POOL_SESSION_NUM][COAP_MEM_POOL_SESSION_SIZE] __attribute__((aligned(8)));
+
+static coap_mem_pool_t s_pools[COAP_MEM_POOL_MAX] = {
+    [COAP_MEM_POOL_PDU] = {
+        .base = &s_pdu_blocks[0][0],
+        .block_size = COAP_MEM_POOL_PDU_SIZE,
+        .block_num = CONFIG_COAP_MEM_POOL_PDU_NUM,
+    },
+    [COAP_MEM_POOL_PDU_BUF] = {
+        .base = &s_pdu_buf_blocks[0][0],
+        .block_size = COAP_MEM_POOL_PDU_BUF_SIZE,
+        .block_num = CONFIG_COAP_MEM_POOL_PDU_NUM,
+    },
+    [COAP_MEM_POOL_SESSION] = {
+        .base = &s_session_blocks[0][0],
+        .block_size = COAP_MEM_POOL_SESSION_SIZE,
+        .block_num = CONFIG_COAP_MEM_POOL_SESSION_NUM,
+    },
+};
+
+static portMUX_TYPE s_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void *__real_coap_malloc_type(coap_memory_tag_t type, size_t size);
+void *__real_coap_realloc_type(coap_memory_tag_t type, void *p, size_t size);
+void __real_coap_free_type(coap_memory_tag_t type, void *p);
+
+static coap_mem_pool_t *coap_mem_pool_of_type(coap_memory_tag_t type)
+{
+    switch (type) {
+    case COAP_PDU:
+        return &s_pools[COAP_MEM_POOL_PDU];
+    case COAP_PDU_BUF:
+        return &s_pools[COAP_MEM_POOL_PDU_BUF];
+    case COAP_SESSION:
+        return &s_pools[COAP_MEM_POOL_SESSION];
+    default:
+        return NULL;
+    }
+}
+
+static bool coap_mem_pool_owns(const coap_mem_pool_t *pool, const void *p)
+{
+    const uint8_t *addr = (const uint8_t *)p;
+    return pool && addr >= pool->base && addr < pool->base + pool->block_size * pool->block_num;
+}
+
+static void *coap_mem_pool_take(coap_mem_pool_t *pool, size_t size)
+{
+    void *p = NULL;
+    portENTER_CRITICAL_SAFE(&s_pool_lock);
+    if (size <= pool->block_size) {
+        if (pool->free_list) {
+            p = pool->free_list;
+            pool->free_list = pool->free_list->next;
+        } else if (pool->next_unused < pool->block_num) {
+            p = pool->base + pool->block_size * pool->next_unused++;
+        }
+    }
+    if (p) {
+        pool->used++;
+        if (pool->used > pool->max_used) {
+            pool->max_used = pool->used;
+        }
+    } else {
+        pool->fallback_count++;
+    }
+    portEXIT_CRITICAL_SAFE(&s_pool_lock);
+    return p;
+}
+
+static void coap_mem_pool_give(coap_mem_pool_t *pool, void *p)
+{
+    coap_mem_block_t *block = (coap_mem_block_t *)p;
+    portENTER_CRITICAL_SAFE(&s_pool_lock);
+    block->next = pool->free_list;
+    pool->free_list = block;
+    pool->used--;
+    portEXIT_CRITICAL_SAFE(&s_pool_lock);
+}
+
+void *__wrap_coap_malloc_type(coap_memory_tag_t type, size_t size)
+{
+    coap_mem_pool_t *pool = coap_mem_pool_of_type(type);
+    void *p = pool ? coap_mem_pool_take(pool, size) : NULL;
+    return p ? p : __real_coap_malloc_type(type, size);
+}
+
+void *__wrap_coap_realloc_type(coap_memory_tag_t type, void *p, size_t size)
+{
+    if (!p) {
+        return __wrap_coap_malloc_type(type, size);
+    }
+    coap_mem_pool_t *pool = coap_mem_pool_of_type(type);
+    if (!coap_mem_pool_owns(pool, p)) {
+        return __real_coap_realloc_type(type, p, size);
+    }
+    if (size == 0) {
+        coap_mem_pool_give(pool, p);
+        return NULL;
+    }
+    if (size <= pool->block_size) {
+        return p;
+    }
+    // the block is too small now, move to the heap
+    void *new_p = __real_coap_malloc_type(type, size);
+    if (new_p) {
+        memcpy(new_p, p, pool->block_size);
+        coap_mem_pool_give(pool, p);
+    }
+    return new_p;
+}
+
+void __wrap_coap_free_type(coap_memory_tag_t type, void *p)
+{
+    coap_mem_pool_t *pool = coap_mem_pool_of_type(type);
+    if (coap_mem_pool_owns(pool, p)) {
+        coap_mem_pool_give(pool, p);
+    } else {
+        __real_coap_free_type(type, p);
+    }
+}
+
+esp_err_t coap_mem_pool_get_stats(coap_mem_pool_id_t pool, coap_mem_pool_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(pool < COAP_MEM_POOL_MAX && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL_SAFE(&s_pool_lock);
+    ret_stats->block_size = s_pools[pool].block_size;
+    ret_stats->block_num = s_pools[pool].block_num;
+    ret_stats->used = s_pools[pool].used;
+    ret_stats->max_used = s_pools[pool].max_used;
+    ret_stats->fallback_count = s_pools[pool].fallback_count;
+    portEXIT_CRITICAL_SAFE(&s_pool_lock);
+    return ESP_OK;
+}
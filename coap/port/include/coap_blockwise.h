@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "coap3/coap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Block size exponent (SZX) of the Block1 and Block2 options, the block size is 2^(SZX + 4) bytes
+ */
+#define COAP_BLOCKWISE_SZX_16    0
+#define COAP_BLOCKWISE_SZX_32    1
+#define COAP_BLOCKWISE_SZX_64    2
+#define COAP_BLOCKWISE_SZX_128   3
+#define COAP_BLOCKWISE_SZX_256   4
+#define COAP_BLOCKWISE_SZX_512   5
+#define COAP_BLOCKWISE_SZX_1024  6
+
+/**
+ * @brief Content format of a resource without the Content-Format option
+ */
+#define COAP_BLOCKWISE_NO_CONTENT_FORMAT (-1)
+
+/**
+ * @brief Block-wise source handle, serving a large resource with Block2
+ */
+typedef struct coap_blockwise_source_t *coap_blockwise_source_handle_t;
+
+/**
+ * @brief Block-wise sink handle, receiving a large upload with Block1
+ */
+typedef struct coap_blockwise_sink_t *coap_blockwise_sink_handle_t;
+
+/**
+ * @brief Function reading a block of the resource from its storage, e.g. a file or a partition
+ *
+ * @note With the `prefetch` flag, it is also called from the prefetch task, but never concurrently
+ *
+ * @param offset Offset of the block in the resource
+ * @param buf Buffer to fill
+ * @param len Length of the block, always within the resource
+ * @param arg User argument of the source
+ * @return ESP_OK on success, any other error to reply 5.00 Internal Server Error
+ */
+typedef esp_err_t (*coap_blockwise_read_cb_t)(size_t offset, void *buf, size_t len, void *arg);
+
+/**
+ * @brief Function writing a block of an upload to its storage
+ *
+ * @note A write at offset 0 starts a new upload, the previous one, if not finished, is abandoned
+ *
+ * @param offset Offset of the block in the upload, the blocks are written in order and only once
+ * @param data Block data
+ * @param len Length of the block, can be 0 for the last one
+ * @param last True for the last block of the upload
+ * @param arg User argument of the sink
+ * @return ESP_OK on success, any other error to abort the upload and reply 5.00 Internal Server Error
+ */
+typedef esp_err_t (*coap_blockwise_write_cb_t)(size_t offset, const void *data, size_t len, bool last, void *arg);
+
+/**
+ * @brief Block-wise source configuration
+ */
+typedef struct {
+    size_t size;                       /*!< Size of the resource, in bytes, sent in the Size2 option */
+    coap_blockwise_read_cb_t read;     /*!< Function reading the blocks */
+    void *arg;                         /*!< User argument passed to the function */
+    int content_format;                /*!< Content format of the resource, or COAP_BLOCKWISE_NO_CONTENT_FORMAT */
+    uint8_t max_szx;                   /*!< Largest block size served, COAP_BLOCKWISE_SZX_x */
+    uint32_t prefetch_task_priority;   /*!< Priority of the prefetch task */
+    uint32_t prefetch_task_stack_size; /*!< Stack size of the prefetch task, in bytes */
+    struct {
+        uint32_t prefetch: 1;          /*!< Read the next block from a task while the current one is in flight */
+    } flags;                           /*!< Source flags */
+} coap_blockwise_source_config_t;
+
+/**
+ * @brief Block-wise sink configuration
+ */
+typedef struct {
+    size_t max_size;                   /*!< Largest upload accepted, in bytes, larger ones get 4.13 */
+    coap_blockwise_write_cb_t write;   /*!< Function writing the blocks */
+    void *arg;                         /*!< User argument passed to the function */
+    uint8_t max_szx;                   /*!< Largest block size accepted, COAP_BLOCKWISE_SZX_x */
+} coap_blockwise_sink_config_t;
+
+/**
+ * @brief Create a block-wise source, serving a resource block by block from its storage
+ *
+ * Each GET request is answered with the Block2 block it asks for, read from the storage, so the resource is
+ * never held in RAM. The block size is the smallest of the one asked by the client, `max_szx` and the largest
+ * fitting in the maximum PDU size of the session, e.g. reduced by DTLS. With the `prefetch` flag, the next block is
+ * read by a task as soon as a block is sent, and the request for it is answered without waiting for the storage.
+ *
+ * @note The blocks are handled by the resource handler, so `COAP_BLOCK_USE_LIBCOAP` must not be set in the block
+ *       mode of the context, or libcoap would reassemble the transfer itself.
+ *
+ * @param config Source configuration
+ * @param ret_source Returned source handle
+ * @return
+ *      - ESP_OK: Create source successfully
+ *      - ESP_ERR_INVALID_ARG: Create source failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create source failed because of out of memory
+ */
+esp_err_t coap_blockwise_source_new(const coap_blockwise_source_config_t *config,
+                                    coap_blockwise_source_handle_t *ret_source);
+
+/**
+ * @brief Delete a block-wise source, its resource must be deleted or no longer served
+ *
+ * @param source Source handle
+ * @return
+ *      - ESP_OK: Delete source successfully
+ *      - ESP_ERR_INVALID_ARG: Delete source failed because of invalid argument
+ */
+esp_err_t coap_blockwise_source_del(coap_blockwise_source_handle_t source);
+
+/**
+ * @brief Update the size of the resource, e.g. for a growing log, from the task running the CoAP I/O
+ *
+ * @param source Source handle
+ * @param size New size of the resource, in bytes
+ * @return
+ *      - ESP_OK: Set size successfully
+ *      - ESP_ERR_INVALID_ARG: Set size failed because of invalid argument
+ */
+esp_err_t coap_blockwise_source_set_size(coap_blockwise_source_handle_t source, size_t size);
+
+/**
+ * @brief Serve a resource with a block-wise source, for its GET requests
+ *
+ * @param resource Resource, which user data is set to the source
+ * @param source Source handle
+ * @return
+ *      - ESP_OK: Register source successfully
+ *      - ESP_ERR_INVALID_ARG: Register source failed because of invalid argument
+ */
+esp_err_t coap_blockwise_register_source(coap_resource_t *resource, coap_blockwise_source_handle_t source);
+
+/**
+ * @brief Create a block-wise sink, writing the Block1 blocks of the uploads to their storage as they come
+ *
+ * The blocks must come in order, the retransmitted ones are acknowledged again without being written and a missing
+ * one gets 4.08 Request Entity Incomplete. One upload is received at a time, a new one starts with its block 0.
+ * Blocks larger than `max_szx` or than the maximum PDU size of the session are accepted, and the reply asks the
+ * client to go on with smaller ones.
+ *
+ * @note The blocks are handled by the resource handler, so `COAP_BLOCK_USE_LIBCOAP` must not be set in the block
+ *       mode of the context, or libcoap would reassemble the transfer itself.
+ *
+ * @param config Sink configuration
+ * @param ret_sink Returned sink handle
+ * @return
+ *      - ESP_OK: Create sink successfully
+ *      - ESP_ERR_INVALID_ARG: Create sink failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create sink failed because of out of memory
+ */
+esp_err_t coap_blockwise_sink_new(const coap_blockwise_sink_config_t *config, coap_blockwise_sink_handle_t *ret_sink);
+
+/**
+ * @brief Delete a block-wise sink, its resource must be deleted or no longer served
+ *
+ * @param sink Sink handle
+ * @return
+ *      - ESP_OK: Delete sink successfully
+ *      - ESP_ERR_INVALID_ARG: Delete sink failed because of invalid argument
+ */
+esp_err_t coap_blockwise_sink_del(coap_blockwise_sink_handle_t sink);
+
+/**
+ * @brief Receive the uploads of a resource with a block-wise sink
+ *
+ * @param resource Resource, which user data is set to the sink
+ * @param method Request method of the uploads, COAP_REQUEST_PUT or COAP_REQUEST_POST
+ * @param sink Sink handle
+ * @return
+ *      - ESP_OK: Register sink successfully
+ *      - ESP_ERR_INVALID_ARG: Register sink failed because of invalid argument
+ */
+esp_err_t coap_blockwise_register_sink(coap_resource_t *resource, coap_request_t method,
+                                       coap_blockwise_sink_handle_t sink);
+
+#ifdef __cplusplus
+}
+#endif
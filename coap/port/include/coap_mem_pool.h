@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Memory pools of libcoap, enabled by CONFIG_COAP_MEM_POOLS
+ */
+typedef enum {
+    COAP_MEM_POOL_PDU,     /*!< PDU descriptors */
+    COAP_MEM_POOL_PDU_BUF, /*!< PDU buffers */
+    COAP_MEM_POOL_SESSION, /*!< Sessions */
+    COAP_MEM_POOL_MAX,     /*!< Number of pools */
+} coap_mem_pool_id_t;
+
+/**
+ * @brief Usage statistics of a memory pool
+ */
+typedef struct {
+    size_t block_size;     /*!< Size of a block, in bytes */
+    size_t block_num;      /*!< Number of blocks */
+    size_t used;           /*!< Number of blocks in use */
+    size_t max_used;       /*!< Highest number of blocks in use at the same time */
+    size_t fallback_count; /*!< Number of allocations which fell back to the heap, too large or with the pool empty */
+} coap_mem_pool_stats_t;
+
+/**
+ * @brief Get the usage statistics of a memory pool
+ *
+ * @note Only available with CONFIG_COAP_MEM_POOLS
+ *
+ * @param pool Memory pool
+ * @param ret_stats Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ */
+esp_err_t coap_mem_pool_get_stats(coap_mem_pool_id_t pool, coap_mem_pool_stats_t *ret_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -31,4 +31,5 @@ void app_main(void)
     printf("Running coremark...\n");
     main();
     printf("CPU frequency: %d MHz\n", CPU_FREQ);
+    printf("Target: %s\n", CONFIG_IDF_TARGET);
 }
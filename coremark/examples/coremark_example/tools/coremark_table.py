@@ -0,0 +1,78 @@
+#!/usr/bin/env python
+#
+# Prints a comparison table of the CoreMark scores found in the logs of several runs of the example, e.g. with the
+# code and the data of the benchmark placed in different memories.
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import re
+import sys
+from typing import Dict, List, Optional, TextIO, Tuple
+
+# CoreMark 1.0 : <score> / <compiler> <flags> / <memory location>[ / <contexts>:<parallel method>]
+SCORE_RE = re.compile(r'^CoreMark 1\.0 : ([0-9.]+) / .* / (\w+) code, (\w+) data(?: / (\d+):\w+)?\s*$')
+FREQ_RE = re.compile(r'^CPU frequency: (\d+) MHz')
+TARGET_RE = re.compile(r'^Target: (\w+)')
+
+BASELINE = ('IRAM', 'DRAM')
+
+
+def parse_log(f: TextIO) -> List[Dict]:
+    runs = []
+    run: Optional[Dict] = None
+    for line in f:
+        line = line.strip()
+        m = SCORE_RE.match(line)
+        if m:
+            run = {'score': float(m.group(1)), 'code': m.group(2), 'data': m.group(3),
+                   'threads': int(m.group(4) or 1), 'freq': None, 'target': None}
+            runs.append(run)
+            continue
+        if run is None:
+            continue
+        m = FREQ_RE.match(line)
+        if m:
+            run['freq'] = int(m.group(1))
+        m = TARGET_RE.match(line)
+        if m:
+            run['target'] = m.group(1)
+    return runs
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser('CoreMark placement comparison')
+    parser.add_argument('logs', nargs='+', help='Monitor logs of the coremark example, "-" for the standard input')
+    args = parser.parse_args()
+
+    runs = []
+    for path in args.logs:
+        if path == '-':
+            runs += parse_log(sys.stdin)
+        else:
+            with open(path) as f:
+                runs += parse_log(f)
+    if not runs:
+        print('No CoreMark results found')
+        sys.exit(1)
+
+    # Each score is compared to the one with the code in IRAM and the data in DRAM, on the same target and threads
+    baselines: Dict[Tuple, float] = {}
+    for run in runs:
+        if (run['code'], run['data']) == BASELINE:
+            baselines[(run['target'], run['freq'], run['threads'])] = run['score']
+
+    print('| Target | CPU MHz | Code | Data | Threads | CoreMark | CoreMark/MHz | vs IRAM/DRAM |')
+    print('|--------|---------|------|------|---------|----------|--------------|--------------|')
+    for run in sorted(runs, key=lambda r: (str(r['target']), r['freq'] or 0, r['threads'], r['code'], r['data'])):
+        per_mhz = '%.3f' % (run['score'] / run['freq']) if run['freq'] else '-'
+        baseline = baselines.get((run['target'], run['freq'], run['threads']))
+        relative = '%.1f%%' % (100.0 * run['score'] / baseline) if baseline else '-'
+        print('| %s | %s | %s | %s | %d | %.2f | %s | %s |' % (run['target'] or '-', run['freq'] or '-', run['code'],
+                                                              run['data'], run['threads'], run['score'], per_mhz,
+                                                              relative))
+
+
+if __name__ == '__main__':
+    main()
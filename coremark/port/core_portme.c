@@ -11,6 +11,15 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "esp_timer.h"
+#if (MEM_METHOD == MEM_MALLOC)
+#include "esp_heap_caps.h"
+#endif
+#if (MULTITHREAD > 1)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <sys/param.h>
+#endif
 
 #if VALIDATION_RUN
 volatile ee_s32 seed1_volatile = 0x3415;
@@ -98,7 +107,111 @@ secs_ret time_in_secs(CORE_TICKS ticks)
     return retval;
 }
 
-ee_u32 default_num_contexts = 1;
+ee_u32 default_num_contexts = MULTITHREAD;
+
+#if (MEM_METHOD == MEM_MALLOC)
+/* Function : portable_malloc
+    Allocates the data area of a context, from the memory selected by CONFIG_COREMARK_DATA_LOCATION.
+*/
+void *portable_malloc(ee_size_t size)
+{
+#if CONFIG_COREMARK_DATA_IN_PSRAM
+    return heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#else
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+#endif
+}
+
+void portable_free(void *p)
+{
+    heap_caps_free(p);
+}
+#endif
+
+#if (MULTITHREAD > 1)
+/* Results of the contexts which have run, reported by portable_fini */
+static struct {
+    ee_u8 core;
+    ee_u32 iterations;
+    int64_t start_us;
+    int64_t stop_us;
+} s_contexts[MULTITHREAD];
+static ee_u8 s_context_num;
+
+static void run_context(core_results *res)
+{
+    res->port.start_us = esp_timer_get_time();
+    iterate(res);
+    res->port.stop_us = esp_timer_get_time();
+    xSemaphoreGive((SemaphoreHandle_t)res->port.done);
+}
+
+static void parallel_task(void *arg)
+{
+    run_context((core_results *)arg);
+    vTaskDelete(NULL);
+}
+
+/* Function : core_start_parallel
+    Runs a context in a task pinned to the next core. The tasks have the priority of the caller, so that it can start
+    all of them before the first one is done.
+*/
+ee_u8 core_start_parallel(core_results *res)
+{
+    res->port.context = s_context_num++;
+    res->port.core = res->port.context % portNUM_PROCESSORS;
+    res->port.done = xSemaphoreCreateBinary();
+    if (res->port.done == NULL) {
+        ee_printf("ERROR! Couldn't create the semaphore of context %d\n", res->port.context);
+        return 1;
+    }
+    if (xTaskCreatePinnedToCore(parallel_task, "coremark", CONFIG_COREMARK_THREAD_STACK_SIZE, res,
+                                uxTaskPriorityGet(NULL), NULL, res->port.core) != pdPASS) {
+        // Still run the context, its result is needed to validate the run
+        ee_printf("ERROR! Couldn't create the task of context %d, running it in the caller\n", res->port.context);
+        run_context(res);
+    }
+    return 0;
+}
+
+/* Function : core_stop_parallel
+    Waits for the task of a context to be done.
+*/
+ee_u8 core_stop_parallel(core_results *res)
+{
+    if (res->port.done == NULL) {
+        return 1;
+    }
+    xSemaphoreTake((SemaphoreHandle_t)res->port.done, portMAX_DELAY);
+    vSemaphoreDelete((SemaphoreHandle_t)res->port.done);
+    res->port.done = NULL;
+    s_contexts[res->port.context].core = res->port.core;
+    s_contexts[res->port.context].iterations = res->iterations;
+    s_contexts[res->port.context].start_us = res->port.start_us;
+    s_contexts[res->port.context].stop_us = res->port.stop_us;
+    return 0;
+}
+
+/* Prints the iterations per second of each core, from the first of its contexts starting to the last one ending */
+static void report_cores(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        ee_u32 iterations = 0;
+        int64_t start_us = INT64_MAX;
+        int64_t stop_us = 0;
+        for (int i = 0; i < s_context_num; i++) {
+            if (s_contexts[i].core == core) {
+                iterations += s_contexts[i].iterations;
+                start_us = MIN(start_us, s_contexts[i].start_us);
+                stop_us = MAX(stop_us, s_contexts[i].stop_us);
+            }
+        }
+        if (iterations > 0 && stop_us > start_us) {
+            ee_printf("[core %d]Iterations/Sec : %f\n", core, (double)iterations * 1000000 / (stop_us - start_us));
+        }
+    }
+}
+#endif
 
 /* Function : portable_init
     Target specific initialization code
@@ -112,6 +225,9 @@ void portable_init(core_portable *p, int *argc, char *argv[])
     if (sizeof(ee_u32) != 4) {
         ee_printf("ERROR! Please define ee_u32 to a 32b unsigned type!\n");
     }
+#if (MULTITHREAD > 1)
+    s_context_num = 0;
+#endif
     p->portable_id = 1;
 }
 /* Function : portable_fini
@@ -119,5 +235,8 @@ void portable_init(core_portable *p, int *argc, char *argv[])
 */
 void portable_fini(core_portable *p)
 {
+#if (MULTITHREAD > 1)
+    report_cores();
+#endif
     p->portable_id = 0;
 }
@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <cstdio>
+#include <cinttypes>
+
+#include "eigen_dsp.hpp"
+#include "esp_timer.h"
+
+extern "C" void app_main(void);
+
+/*
+ * Times the products of square float matrices, and of a matrix by a vector, computed by Eigen and by esp-dsp. With
+ * eigen_dsp.hpp, the products of MatrixXf go to esp-dsp, those of maps of the same data still go to the kernels of
+ * Eigen, so both run on the same matrices.
+ */
+
+static const int s_sizes[] = {4, 8, 16, 32, 64};
+
+template<typename F>
+static int64_t time_us(int iterations, F &&f)
+{
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < iterations; i++) {
+        f();
+    }
+    return esp_timer_get_time() - start;
+}
+
+static void bench_size(int n)
+{
+    using namespace Eigen;
+    // about the same total time for every size
+    const int iterations = n <= 8 ? 2000 : 64 * 64 * 8 / (n * n) + 1;
+
+    MatrixXf a = MatrixXf::Random(n, n);
+    MatrixXf b = MatrixXf::Random(n, n);
+    VectorXf v = VectorXf::Random(n);
+    MatrixXf c_eigen(n, n);
+    MatrixXf c_dsp(n, n);
+    VectorXf y_eigen(n);
+    VectorXf y_dsp(n);
+    Map<MatrixXf> a_map(a.data(), n, n);
+    Map<MatrixXf> b_map(b.data(), n, n);
+    Map<VectorXf> v_map(v.data(), n);
+
+    int64_t mm_eigen = time_us(iterations, [&] { c_eigen.noalias() = a_map * b_map; });
+    int64_t mm_dsp = time_us(iterations, [&] { c_dsp.noalias() = a * b; });
+    int64_t mv_eigen = time_us(iterations, [&] { y_eigen.noalias() = a_map * v_map; });
+    int64_t mv_dsp = time_us(iterations, [&] { y_dsp.noalias() = a * v; });
+
+    printf("%2dx%-2d  %9.2f %9.2f %6.2fx   %9.2f %9.2f %6.2fx   %.1e\n", n, n,
+           (double)mm_eigen / iterations, (double)mm_dsp / iterations, (double)mm_eigen / mm_dsp,
+           (double)mv_eigen / iterations, (double)mv_dsp / iterations, (double)mv_eigen / mv_dsp,
+           (double)((c_eigen - c_dsp).cwiseAbs().maxCoeff() + (y_eigen - y_dsp).cwiseAbs().maxCoeff()));
+}
+
+void app_main(void)
+{
+    printf("Eigen vs esp-dsp products, us per product, EIGEN_DSP_THRESHOLD %d\n", EIGEN_DSP_THRESHOLD);
+    printf("size   mat*mat:  Eigen    esp-dsp speedup   mat*vec:  Eigen   esp-dsp speedup   max diff\n");
+    for (int n : s_sizes) {
+        bench_size(n);
+    }
+    printf("Example finished!\n");
+}
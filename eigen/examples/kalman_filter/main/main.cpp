@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+*/
+
+#include <cstdio>
+#include <cinttypes>
+#include <atomic>
+
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/LU>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+extern "C" void app_main(void);
+
+/*
+ * Tracks a target moving at constant velocity in a plane from noisy position measurements, with a Kalman filter made
+ * of fixed-size matrices only. The loop of the filter is run with the heap allocations of Eigen forbidden
+ * (EIGEN_RUNTIME_NO_MALLOC), and the heap hooks count any allocation made by the task in the loop, which must be 0.
+ */
+
+#define FILTER_STEPS  10000
+#define FILTER_DT     0.01f
+
+using Vector4 = Eigen::Matrix<float, 4, 1>;
+using Matrix4 = Eigen::Matrix<float, 4, 4>;
+using Vector2 = Eigen::Matrix<float, 2, 1>;
+using Matrix2 = Eigen::Matrix<float, 2, 2>;
+using Matrix24 = Eigen::Matrix<float, 2, 4>;
+using Matrix42 = Eigen::Matrix<float, 4, 2>;
+
+/* State: position x, y and velocity x, y. Measurement: position x, y */
+struct KalmanFilter {
+    Vector4 x;
+    Matrix4 P;
+    Matrix4 F;
+    Matrix4 Q;
+    Matrix24 H;
+    Matrix2 R;
+
+    KalmanFilter(float dt, float process_noise, float measurement_noise)
+    {
+        x.setZero();
+        P = Matrix4::Identity() * 10.0f;
+        F = Matrix4::Identity();
+        F(0, 2) = dt;
+        F(1, 3) = dt;
+        Q = Matrix4::Identity() * process_noise;
+        H.setZero();
+        H(0, 0) = 1.0f;
+        H(1, 1) = 1.0f;
+        R = Matrix2::Identity() * measurement_noise;
+    }
+
+    void predict()
+    {
+        x = F * x;
+        P = F * P * F.transpose() + Q;
+    }
+
+    void update(const Vector2 &z)
+    {
+        Vector2 y = z - H * x;
+        Matrix2 S = H * P * H.transpose() + R;
+        Matrix42 K = P * H.transpose() * S.inverse();
+        x += K * y;
+        P = (Matrix4::Identity() - K * H) * P;
+    }
+};
+
+/* Heap allocations made by the task running the filter, counted with CONFIG_HEAP_USE_HOOKS */
+static std::atomic<uint32_t> s_alloc_count;
+static TaskHandle_t s_counted_task;
+
+extern "C" void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (s_counted_task && xTaskGetCurrentTaskHandle() == s_counted_task) {
+        s_alloc_count++;
+    }
+}
+
+extern "C" void esp_heap_trace_free_hook(void *ptr)
+{
+}
+
+/* Small deterministic noise, so every run tracks the same measurements */
+static uint32_t s_seed = 1;
+
+static float noise(float amplitude)
+{
+    s_seed = s_seed * 1103515245 + 12345;
+    return amplitude * ((float)((s_seed >> 8) & 0xffff) / 32768.0f - 1.0f);
+}
+
+void app_main(void)
+{
+    printf("Eigen Kalman filter example, %d steps, EIGEN_MAX_ALIGN_BYTES %d, EIGEN_STACK_ALLOCATION_LIMIT %d\n",
+           FILTER_STEPS, EIGEN_MAX_ALIGN_BYTES, EIGEN_STACK_ALLOCATION_LIMIT);
+    printf("sizeof(KalmanFilter) = %u bytes\n", (unsigned)sizeof(KalmanFilter));
+
+    KalmanFilter filter(FILTER_DT, 1e-4f, 0.25f);
+    Vector2 position(0.0f, 0.0f);
+    const Vector2 velocity(1.5f, -0.5f);
+    float max_error = 0;
+
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    s_alloc_count = 0;
+    s_counted_task = xTaskGetCurrentTaskHandle();
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(false);
+#endif
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < FILTER_STEPS; i++) {
+        position += velocity * FILTER_DT;
+        Vector2 z(position.x() + noise(0.5f), position.y() + noise(0.5f));
+        filter.predict();
+        filter.update(z);
+        if (i >= FILTER_STEPS / 2) {
+            float error = (filter.x.head<2>() - position).norm();
+            max_error = error > max_error ? error : max_error;
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+    Eigen::internal::set_is_malloc_allowed(true);
+#endif
+    s_counted_task = NULL;
+    size_t free_after = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+
+    printf("%.2f us per step (predict + update), %" PRIi64 " us in total\n", (double)elapsed / FILTER_STEPS, elapsed);
+    printf("Estimated velocity: %.3f, %.3f (true %.3f, %.3f)\n", filter.x(2), filter.x(3), velocity.x(),
+           velocity.y());
+    printf("Max position error over the second half: %.3f\n", max_error);
+#if CONFIG_HEAP_USE_HOOKS
+    printf("Heap allocations in the loop: %" PRIu32 "\n", s_alloc_count.load());
+#endif
+    printf("Free heap before/after the loop: %u/%u bytes\n", (unsigned)free_before, (unsigned)free_after);
+    printf("Example finished!\n");
+}
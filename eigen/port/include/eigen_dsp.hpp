@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+/*
+ * Products of float matrices on esp-dsp
+ *
+ * Including this header routes the products of dynamic-size float matrices, `MatrixXf * MatrixXf` and
+ * `MatrixXf * VectorXf`, to `dspm_mult_f32()`, the assembly matrix product of esp-dsp for the ESP32, ESP32-S3 and
+ * ESP32-P4, instead of the generic GEBP kernels of Eigen. The products with less than EIGEN_DSP_THRESHOLD rows and
+ * columns in total fall back to the coefficient-based product of Eigen, as Eigen itself does below
+ * EIGEN_GEMM_TO_COEFFBASED_THRESHOLD.
+ *
+ * As Eigen stores the matrices column-major and esp-dsp row-major, C = A * B is computed as C^T = B^T * A^T, on the
+ * data of the matrices as they are, without copy.
+ *
+ * @note The header must be included before the products are used, in every source file using them, e.g. in place of
+ *       `<eigen3/Eigen/Core>`. The project must depend on the espressif/esp-dsp component
+ * @note The other products, e.g. of maps, blocks, transposes or fixed-size matrices, are left to Eigen
+ */
+
+#include <eigen3/Eigen/Core>
+#include "dspm_mult.h"
+
+#ifndef EIGEN_DSP_THRESHOLD
+/**
+ * @brief Smallest number of rows of the right-hand side, plus rows and columns of the result, of a product computed
+ *        with esp-dsp, 12 from a 4x4 by 4x4 product
+ */
+#define EIGEN_DSP_THRESHOLD 12
+#endif
+
+namespace Eigen {
+namespace internal {
+
+/* Row-major C[m][k] = A[m][n] * B[n][k] of esp-dsp, on column-major data */
+inline bool eigen_dsp_mult(const float *a, const float *b, float *c, Index a_rows, Index a_cols, Index b_cols)
+{
+    return dspm_mult_f32(b, a, c, (int)b_cols, (int)a_cols, (int)a_rows) == ESP_OK;
+}
+
+template<>
+struct generic_product_impl<MatrixXf, MatrixXf, DenseShape, DenseShape, GemmProduct>
+    : generic_product_impl_base<MatrixXf, MatrixXf,
+      generic_product_impl<MatrixXf, MatrixXf, DenseShape, DenseShape, GemmProduct>> {
+    static bool use_dsp(const MatrixXf &lhs, const MatrixXf &rhs)
+    {
+        return rhs.rows() + lhs.rows() + rhs.cols() >= EIGEN_DSP_THRESHOLD && rhs.rows() > 0;
+    }
+
+    static void evalTo(MatrixXf &dst, const MatrixXf &lhs, const MatrixXf &rhs)
+    {
+        dst.resize(lhs.rows(), rhs.cols());
+        if (!use_dsp(lhs, rhs) || !eigen_dsp_mult(lhs.data(), rhs.data(), dst.data(), lhs.rows(), lhs.cols(),
+                rhs.cols())) {
+            dst.noalias() = lhs.lazyProduct(rhs);
+        }
+    }
+
+    /* Blocks, maps and other destinations, which may not be contiguous, through a temporary */
+    template<typename Dst>
+    static void evalTo(Dst &dst, const MatrixXf &lhs, const MatrixXf &rhs)
+    {
+        if (!use_dsp(lhs, rhs)) {
+            dst.noalias() = lhs.lazyProduct(rhs);
+            return;
+        }
+        MatrixXf tmp;
+        evalTo(tmp, lhs, rhs);
+        dst = tmp;
+    }
+
+    template<typename Dst>
+    static void scaleAndAddTo(Dst &dst, const MatrixXf &lhs, const MatrixXf &rhs, const float &alpha)
+    {
+        if (lhs.cols() == 0 || lhs.rows() == 0 || rhs.cols() == 0) {
+            return;
+        }
+        if (!use_dsp(lhs, rhs)) {
+            dst.noalias() += alpha * lhs.lazyProduct(rhs);
+            return;
+        }
+        MatrixXf tmp;
+        evalTo(tmp, lhs, rhs);
+        dst += alpha * tmp;
+    }
+};
+
+template<>
+struct generic_product_impl<MatrixXf, VectorXf, DenseShape, DenseShape, GemvProduct>
+    : generic_product_impl_base<MatrixXf, VectorXf,
+      generic_product_impl<MatrixXf, VectorXf, DenseShape, DenseShape, GemvProduct>> {
+    static bool use_dsp(const MatrixXf &lhs)
+    {
+        return lhs.cols() + lhs.rows() + 1 >= EIGEN_DSP_THRESHOLD && lhs.cols() > 0;
+    }
+
+    static void evalTo(VectorXf &dst, const MatrixXf &lhs, const VectorXf &rhs)
+    {
+        dst.resize(lhs.rows());
+        if (!use_dsp(lhs) || !eigen_dsp_mult(lhs.data(), rhs.data(), dst.data(), lhs.rows(), lhs.cols(), 1)) {
+            dst.noalias() = lhs.lazyProduct(rhs);
+        }
+    }
+
+    template<typename Dst>
+    static void evalTo(Dst &dst, const MatrixXf &lhs, const VectorXf &rhs)
+    {
+        if (!use_dsp(lhs)) {
+            dst.noalias() = lhs.lazyProduct(rhs);
+            return;
+        }
+        VectorXf tmp;
+        evalTo(tmp, lhs, rhs);
+        dst = tmp;
+    }
+
+    template<typename Dst>
+    static void scaleAndAddTo(Dst &dst, const MatrixXf &lhs, const VectorXf &rhs, const float &alpha)
+    {
+        if (lhs.cols() == 0 || lhs.rows() == 0) {
+            return;
+        }
+        if (!use_dsp(lhs)) {
+            dst.noalias() += alpha * lhs.lazyProduct(rhs);
+            return;
+        }
+        VectorXf tmp;
+        evalTo(tmp, lhs, rhs);
+        dst += alpha * tmp;
+    }
+};
+
+} // namespace internal
+} // namespace Eigen
@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "esp_delta_ota.h"
+
+/*
+ * Applies every patch of the bench_patch partition, written by tools/gen_bench_patches.py, to the source image of the
+ * bench_src partition, into the bench_dst partition, with a few configurations of the component. Only the calls to
+ * esp_delta_ota_feed_patch() and esp_delta_ota_finalize() are timed, the patch being read from the flash between them.
+ * The destination is erased sector by sector as it is written, like esp_ota_write() does.
+ */
+
+#define BENCH_MAGIC                 0x42544f44  // "DOTB"
+#define BENCH_NAME_SIZE             32
+#define BENCH_FEED_SIZE             1024
+#define BENCH_SECTOR_SIZE           4096
+#define BENCH_SRC_CACHE_BLOCK_COUNT 4
+
+// Layout of the bench_patch partition, see tools/gen_bench_patches.py
+typedef struct {
+    uint32_t magic;
+    uint32_t patch_count;
+    uint32_t src_size;
+    uint32_t src_crc;
+} bench_header_t;
+
+typedef struct {
+    char name[BENCH_NAME_SIZE];
+    uint32_t offset;
+    uint32_t size;
+    uint32_t target_size;
+    uint32_t target_crc;
+} bench_entry_t;
+
+typedef struct {
+    const char *name;
+    size_t src_cache_block_count;
+    size_t write_buffer_size;
+    bool write_task;
+} bench_config_t;
+
+static const bench_config_t s_configs[] = {
+    {"direct", 0, 0, false},
+    {"cache", BENCH_SRC_CACHE_BLOCK_COUNT, 0, false},
+    {"cache_wbuf", BENCH_SRC_CACHE_BLOCK_COUNT, BENCH_SECTOR_SIZE, false},
+#if !CONFIG_FREERTOS_UNICORE
+    {"cache_wtask", BENCH_SRC_CACHE_BLOCK_COUNT, BENCH_SECTOR_SIZE, true},
+#endif
+};
+
+typedef struct {
+    const esp_partition_t *src;
+    const esp_partition_t *dst;
+    size_t dst_offset;
+    size_t dst_erased;
+    uint32_t src_reads;
+    uint32_t src_read_bytes;
+    uint32_t writes;
+    uint32_t erases;
+} bench_state_t;
+
+static const char *TAG = "delta_ota_bench";
+
+static bench_state_t s_state;
+static uint8_t s_feed_buf[BENCH_FEED_SIZE];
+
+static esp_err_t read_cb(uint8_t *buf_p, size_t size, int src_offset)
+{
+    s_state.src_reads++;
+    s_state.src_read_bytes += size;
+    return esp_partition_read(s_state.src, src_offset, buf_p, size);
+}
+
+static esp_err_t write_cb(const uint8_t *buf_p, size_t size, void *user_data)
+{
+    bench_state_t *state = (bench_state_t *)user_data;
+    while (state->dst_offset + size > state->dst_erased) {
+        esp_err_t err = esp_partition_erase_range(state->dst, state->dst_erased, BENCH_SECTOR_SIZE);
+        if (err != ESP_OK) {
+            return err;
+        }
+        state->dst_erased += BENCH_SECTOR_SIZE;
+        state->erases++;
+    }
+    esp_err_t err = esp_partition_write(state->dst, state->dst_offset, buf_p, size);
+    state->dst_offset += size;
+    state->writes++;
+    return err;
+}
+
+static uint32_t partition_crc(const esp_partition_t *partition, size_t size)
+{
+    uint32_t crc = 0;
+    for (size_t offset = 0; offset < size; offset += BENCH_FEED_SIZE) {
+        size_t len = MIN(BENCH_FEED_SIZE, size - offset);
+        ESP_ERROR_CHECK(esp_partition_read(partition, offset, s_feed_buf, len));
+        crc = esp_rom_crc32_le(crc, s_feed_buf, len);
+    }
+    return crc;
+}
+
+static const char *compression_name(esp_delta_ota_compression_t compression)
+{
+    switch (compression) {
+    case ESP_DELTA_OTA_COMPRESSION_NONE:
+        return "none";
+    case ESP_DELTA_OTA_COMPRESSION_LZMA:
+        return "lzma";
+    case ESP_DELTA_OTA_COMPRESSION_CRLE:
+        return "crle";
+    case ESP_DELTA_OTA_COMPRESSION_HEATSHRINK:
+        return "heatshrink";
+    default:
+        return "unknown";
+    }
+}
+
+static void bench_patch(const esp_partition_t *patch_partition, const bench_entry_t *entry, const bench_config_t *config)
+{
+    esp_delta_ota_cfg_t cfg = {
+        .read_cb = &read_cb,
+        .write_cb_with_user_data = &write_cb,
+        .user_data = &s_state,
+        .src_cache_block_size = BENCH_SECTOR_SIZE,
+        .src_cache_block_count = config->src_cache_block_count,
+        .write_buffer_size = config->write_buffer_size,
+        .flags.write_task = config->write_task,
+    };
+
+    ESP_ERROR_CHECK(esp_partition_read(patch_partition, entry->offset, s_feed_buf, MIN(BENCH_FEED_SIZE, entry->size)));
+    esp_delta_ota_patch_info_t info;
+    esp_err_t err = esp_delta_ota_parse_patch_header(s_feed_buf, MIN(BENCH_FEED_SIZE, entry->size), &cfg, &info);
+    if (err != ESP_OK) {
+        printf("DOTABENCH,%s,%s,unsupported: %s\n", entry->name, config->name, esp_err_to_name(err));
+        return;
+    }
+
+    s_state.dst_offset = 0;
+    s_state.dst_erased = 0;
+    s_state.src_reads = 0;
+    s_state.src_read_bytes = 0;
+    s_state.writes = 0;
+    s_state.erases = 0;
+
+    // Everything is allocated by esp_delta_ota_init(), applying the patch doesn't allocate memory
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    esp_delta_ota_handle_t handle = esp_delta_ota_init(&cfg);
+    if (handle == NULL) {
+        printf("DOTABENCH,%s,%s,init failed\n", entry->name, config->name);
+        return;
+    }
+    size_t heap_used = free_before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    int64_t apply_us = 0;
+    for (size_t offset = 0; offset < entry->size && err == ESP_OK; offset += BENCH_FEED_SIZE) {
+        size_t len = MIN(BENCH_FEED_SIZE, entry->size - offset);
+        ESP_ERROR_CHECK(esp_partition_read(patch_partition, entry->offset + offset, s_feed_buf, len));
+        int64_t start = esp_timer_get_time();
+        err = esp_delta_ota_feed_patch(handle, s_feed_buf, len);
+        apply_us += esp_timer_get_time() - start;
+    }
+    if (err == ESP_OK) {
+        int64_t start = esp_timer_get_time();
+        err = esp_delta_ota_finalize(handle);
+        apply_us += esp_timer_get_time() - start;
+    }
+
+    esp_delta_ota_progress_t progress = {0};
+    esp_delta_ota_get_progress(handle, &progress);
+    esp_delta_ota_deinit(handle);
+    if (err != ESP_OK) {
+        printf("DOTABENCH,%s,%s,apply failed: %s\n", entry->name, config->name, esp_err_to_name(err));
+        return;
+    }
+
+    bool valid = s_state.dst_offset == entry->target_size && partition_crc(s_state.dst, entry->target_size) == entry->target_crc;
+    // Bytes per microsecond are MB/s
+    printf("DOTABENCH,%s,%s,%s,%" PRIu32 ",%" PRIu32 ",%" PRIi64 ",%.3f,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%u,%u,%s\n",
+           entry->name, config->name, compression_name(info.compression), entry->size, entry->target_size, apply_us,
+           (double)entry->target_size / apply_us, s_state.src_reads, s_state.src_read_bytes, s_state.writes,
+           s_state.erases, progress.write_stalls, (unsigned)heap_used, (unsigned)info.heap_size, valid ? "ok" : "CORRUPT");
+}
+
+void app_main(void)
+{
+    s_state.src = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, 0x40, "bench_src");
+    s_state.dst = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, 0x41, "bench_dst");
+    const esp_partition_t *patch_partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, 0x42, "bench_patch");
+    if (s_state.src == NULL || s_state.dst == NULL || patch_partition == NULL) {
+        ESP_LOGE(TAG, "Benchmark partitions not found, see partitions.csv");
+        return;
+    }
+
+    bench_header_t header;
+    ESP_ERROR_CHECK(esp_partition_read(patch_partition, 0, &header, sizeof(header)));
+    if (header.magic != BENCH_MAGIC) {
+        ESP_LOGE(TAG, "No patches in bench_patch, run tools/gen_bench_patches.py and write its output, see README.md");
+        return;
+    }
+    if (header.src_size > s_state.src->size || partition_crc(s_state.src, header.src_size) != header.src_crc) {
+        ESP_LOGE(TAG, "Source image in bench_src doesn't match the patches");
+        return;
+    }
+
+    printf("DOTABENCH,patch,config,compression,patch_size,target_size,apply_us,mb_per_s,src_reads,src_read_bytes,"
+           "writes,erases,write_stalls,heap_used,heap_estimate,result\n");
+    for (uint32_t i = 0; i < header.patch_count; i++) {
+        bench_entry_t entry;
+        ESP_ERROR_CHECK(esp_partition_read(patch_partition, sizeof(header) + i * sizeof(entry), &entry, sizeof(entry)));
+        entry.name[BENCH_NAME_SIZE - 1] = '\0';
+        if (entry.target_size > s_state.dst->size) {
+            printf("DOTABENCH,%s,,target larger than bench_dst\n", entry.name);
+            continue;
+        }
+        for (size_t c = 0; c < sizeof(s_configs) / sizeof(s_configs[0]); c++) {
+            bench_patch(patch_partition, &entry, &s_configs[c]);
+        }
+    }
+    printf("Benchmark done\n");
+}
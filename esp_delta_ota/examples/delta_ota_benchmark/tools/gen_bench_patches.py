@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+#
+# Generates the source image and the patch set of the delta OTA benchmark, and measures applying the patches on
+# the host with detools for comparison.
+#
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+
+import argparse
+import io
+import random
+import struct
+import sys
+import time
+import zlib
+
+try:
+    import detools
+except ImportError:
+    print("Please install 'detools'. Use command `pip install -r tools/requirements.txt`")
+    sys.exit(1)
+
+# Must match delta_ota_benchmark_main.c
+BENCH_MAGIC = 0x42544f44  # "DOTB"
+BENCH_NAME_SIZE = 32
+BENCH_HEADER = struct.Struct('<IIII')  # magic, patch count, source size, source CRC32
+BENCH_ENTRY = struct.Struct('<%dsIIII' % BENCH_NAME_SIZE)  # name, offset, size, target size, target CRC32
+BENCH_IMAGE_PARTITION_SIZE = 512 * 1024
+BENCH_PATCH_PARTITION_SIZE = 1024 * 1024
+
+COMPRESSIONS = ['heatshrink', 'crle', 'none']
+
+
+def firmware_like_image(rng: random.Random, size: int) -> bytearray:
+    """Mix of repeated instruction-like sequences, random data and padding, compressing roughly like an app."""
+    words = [rng.randbytes(rng.randint(2, 8)) for _ in range(256)]
+    image = bytearray()
+    while len(image) < size:
+        r = rng.random()
+        if r < 0.6:
+            image += rng.choice(words)
+        elif r < 0.9:
+            image += rng.randbytes(rng.randint(1, 16))
+        else:
+            image += bytes(rng.randint(4, 64))
+    return image[:size]
+
+
+def small_delta(rng: random.Random, base: bytearray) -> bytearray:
+    """A few constants changed in place, e.g. a version string and a configuration value."""
+    new = bytearray(base)
+    for _ in range(8):
+        offset = rng.randrange(len(new) - 16)
+        new[offset:offset + 16] = rng.randbytes(16)
+    return new
+
+
+def large_delta(rng: random.Random, base: bytearray) -> bytearray:
+    """Many functions rewritten, and code inserted and removed, which shifts everything after it."""
+    new = bytearray(base)
+    for _ in range(64):
+        size = rng.randint(256, 2048)
+        offset = rng.randrange(len(new) - size)
+        new[offset:offset + size] = firmware_like_image(rng, size)
+    third = len(new) // 3
+    new[third:third] = firmware_like_image(rng, 4096)
+    del new[2 * third:2 * third + 2048]
+    return new
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser('Delta OTA benchmark patch generator')
+    parser.add_argument('--source_size', type=int, default=256 * 1024, help='Size of the source image')
+    parser.add_argument('--seed', type=int, default=1, help='Seed of the generated images')
+    parser.add_argument('--source_file', default='bench_src.bin', help='Output for the bench_src partition')
+    parser.add_argument('--patch_file', default='bench_patch.bin', help='Output for the bench_patch partition')
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    base = firmware_like_image(rng, args.source_size)
+    targets = [('small', small_delta(rng, base)), ('large', large_delta(rng, base))]
+    if max(len(new) for _, new in targets) > BENCH_IMAGE_PARTITION_SIZE:
+        print('The images are larger than the bench_src and bench_dst partitions')
+        sys.exit(1)
+
+    entries = []
+    patches = bytearray()
+    offset = BENCH_HEADER.size + BENCH_ENTRY.size * len(targets) * len(COMPRESSIONS)
+    print('HOSTBENCH,patch,patch_size,target_size,host_apply_us')
+    for delta, new in targets:
+        for compression in COMPRESSIONS:
+            name = '%s_%s' % (delta, compression)
+            fpatch = io.BytesIO()
+            detools.create_patch(io.BytesIO(base), io.BytesIO(new), fpatch, compression=compression)
+            patch = fpatch.getvalue()
+
+            fto = io.BytesIO()
+            start = time.perf_counter()
+            detools.apply_patch(io.BytesIO(base), io.BytesIO(patch), fto)
+            host_us = int((time.perf_counter() - start) * 1e6)
+            if fto.getvalue() != new:
+                print('Failed to verify patch %s' % name)
+                sys.exit(1)
+            print('HOSTBENCH,%s,%d,%d,%d' % (name, len(patch), len(new), host_us))
+
+            entries.append(BENCH_ENTRY.pack(name.encode(), offset + len(patches), len(patch), len(new), zlib.crc32(new)))
+            patches += patch
+            patches += bytes(-len(patches) % 4)
+
+    image = BENCH_HEADER.pack(BENCH_MAGIC, len(entries), len(base), zlib.crc32(base)) + b''.join(entries) + patches
+    if len(image) > BENCH_PATCH_PARTITION_SIZE:
+        print('The patches take %d bytes, more than the bench_patch partition' % len(image))
+        sys.exit(1)
+    with open(args.source_file, 'wb') as f:
+        f.write(base)
+    with open(args.patch_file, 'wb') as f:
+        f.write(image)
+    print('Wrote %s and %s' % (args.source_file, args.patch_file))
+
+
+if __name__ == '__main__':
+    main()
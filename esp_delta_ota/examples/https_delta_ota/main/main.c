@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include <sys/param.h>
 
 #include "freertos/FreeRTOS.h"
@@ -36,6 +37,8 @@
 #define BUFFSIZE 1024
 #define PATCH_HEADER_SIZE 64
 #define DIGEST_SIZE 32
+#define SRC_CACHE_BLOCK_SIZE 4096      // Flash sector size
+#define SRC_CACHE_BLOCK_COUNT 4
 static uint32_t esp_delta_ota_magic = 0xfccdde10;
 
 static const char *TAG = "https_delta_ota_example";
@@ -189,6 +192,15 @@ static void ota_example_task(void *pvParameter)
     }
     esp_delta_ota_cfg_t cfg = {
         .read_cb = &read_cb,
+        // Cache a few flash sectors of the source, patches read it in many small chunks
+        .src_cache_block_size = SRC_CACHE_BLOCK_SIZE,
+        .src_cache_block_count = SRC_CACHE_BLOCK_COUNT,
+        // Write whole flash sectors instead of the small pieces produced by the patch
+        .write_buffer_size = SRC_CACHE_BLOCK_SIZE,
+#if !CONFIG_FREERTOS_UNICORE
+        // Apply the patch on this core while the other one writes the flash
+        .flags.write_task = true,
+#endif
     };
 
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0))
@@ -216,12 +228,28 @@ static void ota_example_task(void *pvParameter)
         goto error;
     }
 
+    bool patch_checked = false;
     while (1) {
         int data_read = esp_http_client_read(client, ota_write_data, BUFFSIZE);
         if (data_read < 0) {
             ESP_LOGE(TAG, "Error: SSL data read error");
             goto error;
         } else if (data_read > 0) {
+            if (!patch_checked) {
+                // Reject a patch that can't be applied before writing anything
+                esp_delta_ota_patch_info_t info;
+                if (esp_delta_ota_parse_patch_header((const uint8_t *)ota_write_data, data_read, &cfg, &info) != ESP_OK) {
+                    ESP_LOGE(TAG, "Patch not supported");
+                    goto error;
+                }
+                if (info.target_size > destination_partition->size) {
+                    ESP_LOGE(TAG, "New image of %u bytes doesn't fit in the partition", (unsigned)info.target_size);
+                    goto error;
+                }
+                ESP_LOGI(TAG, "New image of %u bytes, applying the patch takes %u bytes of heap",
+                         (unsigned)info.target_size, (unsigned)info.heap_size);
+                patch_checked = true;
+            }
             if (esp_delta_ota_feed_patch(handle, (const uint8_t *)ota_write_data, data_read) < 0) {
                 ESP_LOGE(TAG, "Error while applying patch");
                 goto error;
@@ -241,6 +269,16 @@ static void ota_example_task(void *pvParameter)
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "esp_delta_ota_finalize() failed : %s", esp_err_to_name(err));
     }
+    esp_delta_ota_src_cache_stats_t cache_stats;
+    if (esp_delta_ota_get_src_cache_stats(handle, &cache_stats) == ESP_OK) {
+        ESP_LOGI(TAG, "Source cache: %" PRIu32 " hits, %" PRIu32 " misses, %" PRIu32 " flash reads",
+                 cache_stats.hits, cache_stats.misses, cache_stats.src_reads);
+    }
+    esp_delta_ota_progress_t progress;
+    if (esp_delta_ota_get_progress(handle, &progress) == ESP_OK) {
+        ESP_LOGI(TAG, "Wrote %" PRIu32 " bytes, waited %" PRIu32 " times for the flash",
+                 progress.bytes_written, progress.write_stalls);
+    }
     err = esp_delta_ota_deinit(handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "esp_delta_ota_deinit() failed : %s", esp_err_to_name(err));
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include "esp_partition.h"
 #include <esp_idf_version.h>
 
 #ifdef __cplusplus
@@ -35,8 +36,49 @@ typedef struct esp_delta_ota_cfg {
         merged_stream_write_cb_with_user_ctx_t write_cb_with_user_data;     /*!< Write Callback with user data */
         merged_stream_write_cb_t write_cb DEPRECATED_ATTRIBUTE;             /*!< Write Callback */
     };
+    size_t src_cache_block_size;  /*!< Size of the blocks of the source read cache, e.g. the flash sector size.
+                                       Reads of a whole block or more bypass the cache. 0 forwards every source
+                                       read to read_cb */
+    size_t src_cache_block_count; /*!< Number of blocks of the source read cache, the least recently used is
+                                       evicted first. 0 forwards every source read to read_cb */
+    size_t write_buffer_size;     /*!< Size of the chunks passed to the write callback, e.g. the flash sector size,
+                                       the last one being written by esp_delta_ota_finalize(). 0 passes the output
+                                       of the patch through as it comes */
+    struct {
+        uint32_t write_task: 1;   /*!< Call the write callback from a write task, through two buffers of
+                                       write_buffer_size bytes, so that the patch is applied while the previous
+                                       chunk is written. See CONFIG_ESP_DELTA_OTA_WRITE_TASK_CORE_ID */
+    } flags;
 } esp_delta_ota_cfg_t;
 
+typedef struct esp_delta_ota_src_cache_stats {
+    uint32_t hits;          /*!< Source reads from a cached block */
+    uint32_t misses;        /*!< Source reads from a block which wasn't cached */
+    uint32_t src_reads;     /*!< Calls to read_cb */
+} esp_delta_ota_src_cache_stats_t;
+
+typedef struct esp_delta_ota_progress {
+    uint32_t bytes_applied;     /*!< Bytes of the new image produced by the patch */
+    uint32_t bytes_written;     /*!< Bytes of the new image passed to the write callback */
+    uint32_t write_stalls;      /*!< Times the patch had to wait for the write task to free a buffer */
+} esp_delta_ota_progress_t;
+
+// Compression of a patch, as set by detools
+typedef enum {
+    ESP_DELTA_OTA_COMPRESSION_NONE = 0,
+    ESP_DELTA_OTA_COMPRESSION_LZMA = 1,
+    ESP_DELTA_OTA_COMPRESSION_CRLE = 2,
+    ESP_DELTA_OTA_COMPRESSION_HEATSHRINK = 4,
+} esp_delta_ota_compression_t;
+
+typedef struct esp_delta_ota_patch_info {
+    esp_delta_ota_compression_t compression;    /*!< Compression of the patch */
+    uint8_t heatshrink_window_sz2;              /*!< Heatshrink window size of the patch, log2 */
+    uint8_t heatshrink_lookahead_sz2;           /*!< Heatshrink lookahead size of the patch, log2 */
+    size_t target_size;                         /*!< Size of the new image */
+    size_t heap_size;                           /*!< Heap allocated by esp_delta_ota_init() for the configuration */
+} esp_delta_ota_patch_info_t;
+
 #undef DEPRECATED_ATTRIBUTE
 
 /**
@@ -48,6 +90,20 @@ typedef struct esp_delta_ota_cfg {
  */
 esp_delta_ota_handle_t esp_delta_ota_init(esp_delta_ota_cfg_t *cfg);
 
+/**
+ * @brief Initializes the delta OTA process from a source partition to an OTA partition, without callbacks
+ *
+ * The source is read through a memory mapping of src, and the new image is written to dst with esp_ota_write(), in
+ * chunks of a flash sector. esp_delta_ota_finalize() also calls esp_ota_end(), which validates the new image. Setting
+ * dst as the boot partition is left to the application.
+ *
+ * @param[in] src   partition holding the source image, e.g. the running partition
+ * @param[in] dst   OTA partition receiving the new image, e.g. from esp_ota_get_next_update_partition()
+ * @return - NULL   On failure
+ *         - esp_delta_ota_handle_t handle
+ */
+esp_delta_ota_handle_t esp_delta_ota_init_partitions(const esp_partition_t *src, const esp_partition_t *dst);
+
 /**
  * @brief This function performs the patch applying operation on the source data.
  *
@@ -63,6 +119,10 @@ esp_err_t esp_delta_ota_feed_patch(esp_delta_ota_handle_t handle, const uint8_t
 /**
  * @brief This function finishes the patch applying operation.
  *
+ * With a write buffer, it also writes the data left in it. With flags.write_task, it waits for the write task to
+ * write everything, and returns ESP_FAIL if any write failed. With esp_delta_ota_init_partitions(), it returns the
+ * error of esp_ota_end() if the new image isn't valid.
+ *
  * @param[in] handle    esp_delta_ota_handle_t
  * @return int
  */
@@ -75,6 +135,49 @@ esp_err_t esp_delta_ota_finalize(esp_delta_ota_handle_t handle);
  */
 esp_err_t esp_delta_ota_deinit(esp_delta_ota_handle_t handle);
 
+/**
+ * @brief Get the statistics of the source read cache
+ *
+ * @note A source read spanning several blocks counts once per block.
+ *
+ * @param[in]  handle   esp_delta_ota_handle_t
+ * @param[out] stats    pointer to esp_delta_ota_src_cache_stats_t structure.
+ * @return - ESP_OK
+ *         - ESP_ERR_INVALID_ARG
+ */
+esp_err_t esp_delta_ota_get_src_cache_stats(esp_delta_ota_handle_t handle, esp_delta_ota_src_cache_stats_t *stats);
+
+/**
+ * @brief Get the progress of the patching
+ *
+ * @note With flags.write_task, it can be called from any task while the patch is being applied.
+ *
+ * @param[in]  handle   esp_delta_ota_handle_t
+ * @param[out] progress pointer to esp_delta_ota_progress_t structure.
+ * @return - ESP_OK
+ *         - ESP_ERR_INVALID_ARG
+ */
+esp_err_t esp_delta_ota_get_progress(esp_delta_ota_handle_t handle, esp_delta_ota_progress_t *progress);
+
+/**
+ * @brief Parse the header of a patch and estimate the memory needed to apply it, before starting the update
+ *
+ * It checks that the patch can be applied by this build, and gives the size of the new image, e.g. to check that it
+ * fits in the update partition, and the heap that esp_delta_ota_init() would allocate for cfg, e.g. to shrink the
+ * source cache or the write buffer before starting.
+ *
+ * @param[in]  buf      first bytes of the patch, as passed to esp_delta_ota_feed_patch(). 16 bytes are enough
+ * @param[in]  size     size of buf
+ * @param[in]  cfg      configuration the patch would be applied with
+ * @param[out] info     pointer to esp_delta_ota_patch_info_t structure.
+ * @return - ESP_OK
+ *         - ESP_ERR_INVALID_ARG
+ *         - ESP_ERR_INVALID_SIZE   buf doesn't hold the whole header
+ *         - ESP_ERR_NOT_SUPPORTED  The patch type, compression or heatshrink parameters aren't supported by this build
+ */
+esp_err_t esp_delta_ota_parse_patch_header(const uint8_t *buf, size_t size, const esp_delta_ota_cfg_t *cfg,
+        esp_delta_ota_patch_info_t *info);
+
 #ifdef __cplusplus
 }
 #endif
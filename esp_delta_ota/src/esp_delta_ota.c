@@ -8,15 +8,53 @@
 #include <stdint.h>
 #include <string.h>
 #include <inttypes.h>
+#include <sys/param.h>
 
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_idf_version.h"
+#include "sdkconfig.h"
 
 #include "esp_delta_ota.h"
 #include "detools.h"
+#include "heatshrink_decoder.h"
+
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+typedef spi_flash_mmap_handle_t esp_partition_mmap_handle_t;
+#define ESP_PARTITION_MMAP_DATA SPI_FLASH_MMAP_DATA
+#endif
 
 static const char *TAG = "esp_delta_ota";
 
+typedef struct {
+    uint8_t *data;
+    int offset;             /* Source offset of the block, -1 when empty */
+    uint32_t last_use;
+} src_cache_block_t;
+
+/* A chunk without buffer stops the write task */
+typedef struct {
+    uint8_t *buf;
+    size_t len;
+} write_chunk_t;
+
+/* Write buffer size of esp_delta_ota_init_partitions(), so that esp_ota_write() erases and writes whole sectors */
+#define FLASH_SECTOR_SIZE   0x1000
+
+/* The write buffers go round between the patch applying task and the write task */
+#define WRITE_TASK_BUF_NUM  2
+
+#if CONFIG_ESP_DELTA_OTA_WRITE_TASK_CORE_ID < 0
+#define WRITE_TASK_CORE_ID  tskNO_AFFINITY
+#else
+#define WRITE_TASK_CORE_ID  CONFIG_ESP_DELTA_OTA_WRITE_TASK_CORE_ID
+#endif
+
 typedef struct esp_delta_ota_ctx {
     void *user_data;
     src_read_cb_t read_cb;
@@ -26,14 +64,33 @@ typedef struct esp_delta_ota_ctx {
     };
     struct detools_apply_patch_t *apply_patch;
     int src_offset;
+    src_cache_block_t *src_cache;
+    uint8_t *src_cache_data;
+    size_t src_cache_block_size;
+    size_t src_cache_block_count;
+    uint32_t src_cache_use;
+    esp_delta_ota_src_cache_stats_t src_cache_stats;
+    uint8_t *write_buf;
+    size_t write_buf_size;
+    size_t write_buf_len;
+    esp_delta_ota_progress_t progress;
+    uint8_t *write_task_bufs;
+    QueueHandle_t write_free_queue;
+    QueueHandle_t write_queue;
+    SemaphoreHandle_t write_task_done;
+    bool write_task_running;
+    portMUX_TYPE write_task_lock;
+    esp_err_t write_task_err;
+    /* Partition backend of esp_delta_ota_init_partitions() */
+    const uint8_t *src_map;
+    size_t src_map_size;
+    esp_partition_mmap_handle_t src_map_handle;
+    esp_ota_handle_t ota_handle;
+    bool ota_started;
 } esp_delta_ota_ctx;
 
-static int esp_delta_ota_write_cb(void *arg_p, const uint8_t *buf_p, size_t size)
+static esp_err_t write_out(esp_delta_ota_ctx *handle, const uint8_t *buf_p, size_t size)
 {
-    if (size <= 0) {
-        return ESP_ERR_INVALID_ARG;
-    }
-    esp_delta_ota_ctx *handle = (esp_delta_ota_ctx *)arg_p;
     esp_err_t err = ESP_OK;
     if (!handle->user_data) {
         err = handle->write_cb(buf_p, size);
@@ -48,6 +105,180 @@ static int esp_delta_ota_write_cb(void *arg_p, const uint8_t *buf_p, size_t size
             return ESP_FAIL;
         }
     }
+    handle->progress.bytes_written += size;
+    return ESP_OK;
+}
+
+static esp_err_t write_task_get_error(esp_delta_ota_ctx *handle)
+{
+    portENTER_CRITICAL(&handle->write_task_lock);
+    esp_err_t err = handle->write_task_err;
+    portEXIT_CRITICAL(&handle->write_task_lock);
+    return err;
+}
+
+static void write_task(void *arg)
+{
+    esp_delta_ota_ctx *handle = (esp_delta_ota_ctx *)arg;
+    write_chunk_t chunk;
+
+    while (xQueueReceive(handle->write_queue, &chunk, portMAX_DELAY) == pdTRUE && chunk.buf != NULL) {
+        // After a failure, the chunks are only given back
+        if (write_task_get_error(handle) == ESP_OK && write_out(handle, chunk.buf, chunk.len) != ESP_OK) {
+            portENTER_CRITICAL(&handle->write_task_lock);
+            handle->write_task_err = ESP_FAIL;
+            portEXIT_CRITICAL(&handle->write_task_lock);
+        }
+        xQueueSend(handle->write_free_queue, &chunk, portMAX_DELAY);
+    }
+    xSemaphoreGive(handle->write_task_done);
+    vTaskDelete(NULL);
+}
+
+/* Hands the current buffer over to the write task and waits for a free one */
+static esp_err_t write_task_submit(esp_delta_ota_ctx *handle)
+{
+    write_chunk_t chunk = {
+        .buf = handle->write_buf,
+        .len = handle->write_buf_len,
+    };
+    xQueueSend(handle->write_queue, &chunk, portMAX_DELAY);
+    if (xQueueReceive(handle->write_free_queue, &chunk, 0) != pdTRUE) {
+        handle->progress.write_stalls++;
+        xQueueReceive(handle->write_free_queue, &chunk, portMAX_DELAY);
+    }
+    handle->write_buf = chunk.buf;
+    handle->write_buf_len = 0;
+    return write_task_get_error(handle);
+}
+
+static esp_err_t write_task_stop(esp_delta_ota_ctx *handle)
+{
+    if (handle->write_task_running) {
+        write_chunk_t chunk = {
+            .buf = NULL,
+        };
+        xQueueSend(handle->write_queue, &chunk, portMAX_DELAY);
+        xSemaphoreTake(handle->write_task_done, portMAX_DELAY);
+        handle->write_task_running = false;
+    }
+    return write_task_get_error(handle);
+}
+
+static int esp_delta_ota_write_cb(void *arg_p, const uint8_t *buf_p, size_t size)
+{
+    if (size <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_delta_ota_ctx *handle = (esp_delta_ota_ctx *)arg_p;
+    handle->progress.bytes_applied += size;
+    if (!handle->write_buf) {
+        return write_out(handle, buf_p, size);
+    }
+
+    // Only whole buffers are written, the tail is written by esp_delta_ota_finalize()
+    while (size > 0) {
+        size_t len;
+        if (handle->write_task_running) {
+            // The data of detools is only valid during the call
+            len = MIN(size, handle->write_buf_size - handle->write_buf_len);
+            memcpy(handle->write_buf + handle->write_buf_len, buf_p, len);
+            handle->write_buf_len += len;
+            if (handle->write_buf_len == handle->write_buf_size && write_task_submit(handle) != ESP_OK) {
+                return ESP_FAIL;
+            }
+        } else if (handle->write_buf_len == 0 && size >= handle->write_buf_size) {
+            len = size - size % handle->write_buf_size;
+            if (write_out(handle, buf_p, len) != ESP_OK) {
+                return ESP_FAIL;
+            }
+        } else {
+            len = MIN(size, handle->write_buf_size - handle->write_buf_len);
+            memcpy(handle->write_buf + handle->write_buf_len, buf_p, len);
+            handle->write_buf_len += len;
+            if (handle->write_buf_len == handle->write_buf_size) {
+                handle->write_buf_len = 0;
+                if (write_out(handle, handle->write_buf, handle->write_buf_size) != ESP_OK) {
+                    return ESP_FAIL;
+                }
+            }
+        }
+        buf_p += len;
+        size -= len;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t src_read(esp_delta_ota_ctx *handle, uint8_t *buf_p, size_t size, int src_offset)
+{
+    handle->src_cache_stats.src_reads++;
+    if (handle->src_map) {
+        if (src_offset < 0 || size > handle->src_map_size - src_offset) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        memcpy(buf_p, handle->src_map + src_offset, size);
+        return ESP_OK;
+    }
+    return handle->read_cb(buf_p, size, src_offset);
+}
+
+static src_cache_block_t *src_cache_find(esp_delta_ota_ctx *handle, int block_offset)
+{
+    for (size_t i = 0; i < handle->src_cache_block_count; i++) {
+        src_cache_block_t *block = &handle->src_cache[i];
+        if (block->offset == block_offset) {
+            handle->src_cache_stats.hits++;
+            block->last_use = ++handle->src_cache_use;
+            return block;
+        }
+    }
+    handle->src_cache_stats.misses++;
+    return NULL;
+}
+
+/* Loads the block at block_offset in place of the least recently used one */
+static src_cache_block_t *src_cache_load(esp_delta_ota_ctx *handle, int block_offset)
+{
+    src_cache_block_t *victim = &handle->src_cache[0];
+    for (size_t i = 1; i < handle->src_cache_block_count; i++) {
+        if (handle->src_cache[i].last_use < victim->last_use) {
+            victim = &handle->src_cache[i];
+        }
+    }
+    if (src_read(handle, victim->data, handle->src_cache_block_size, block_offset) != ESP_OK) {
+        // The block goes past the end of the source
+        victim->offset = -1;
+        victim->last_use = 0;
+        return NULL;
+    }
+    victim->offset = block_offset;
+    victim->last_use = ++handle->src_cache_use;
+    return victim;
+}
+
+static esp_err_t src_cache_read(esp_delta_ota_ctx *handle, uint8_t *buf_p, size_t size, int src_offset)
+{
+    while (size > 0) {
+        int block_offset = src_offset - src_offset % handle->src_cache_block_size;
+        size_t offset_in_block = src_offset - block_offset;
+        size_t len = MIN(size, handle->src_cache_block_size - offset_in_block);
+        src_cache_block_t *block = src_cache_find(handle, block_offset);
+        if (!block && size < handle->src_cache_block_size) {
+            block = src_cache_load(handle, block_offset);
+        }
+        if (block) {
+            memcpy(buf_p, block->data + offset_in_block, len);
+        } else {
+            // Reads of a whole block or more, and the end of the source, go around the cache
+            esp_err_t err = src_read(handle, buf_p, len, src_offset);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        buf_p += len;
+        size -= len;
+        src_offset += len;
+    }
     return ESP_OK;
 }
 
@@ -57,7 +288,12 @@ static int esp_delta_ota_read_cb(void *arg_p, uint8_t *buf_p, size_t size)
         return -ESP_ERR_INVALID_ARG;
     }
     esp_delta_ota_ctx *handle = (esp_delta_ota_ctx *)arg_p;
-    esp_err_t err = handle->read_cb(buf_p, size, handle->src_offset);
+    esp_err_t err;
+    if (handle->src_cache && handle->src_offset >= 0) {
+        err = src_cache_read(handle, buf_p, size, handle->src_offset);
+    } else {
+        err = src_read(handle, buf_p, size, handle->src_offset);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error in read_cb(): %s", esp_err_to_name(err));
         return ESP_FAIL;
@@ -83,22 +319,132 @@ esp_delta_ota_handle_t esp_delta_ota_init(esp_delta_ota_cfg_t *cfg)
     ctx->user_data = cfg->user_data;
     ctx->read_cb = cfg->read_cb;
     ctx->write_cb_with_user_data = cfg->write_cb_with_user_data;
+    if (cfg->src_cache_block_size > 0 && cfg->src_cache_block_count > 0) {
+        ctx->src_cache = calloc(cfg->src_cache_block_count, sizeof(src_cache_block_t));
+        ctx->src_cache_data = malloc(cfg->src_cache_block_size * cfg->src_cache_block_count);
+        if (!ctx->src_cache || !ctx->src_cache_data) {
+            ESP_LOGE(TAG, "Unable to allocate memory for the source cache");
+            goto failure;
+        }
+        for (size_t i = 0; i < cfg->src_cache_block_count; i++) {
+            ctx->src_cache[i].data = ctx->src_cache_data + i * cfg->src_cache_block_size;
+            ctx->src_cache[i].offset = -1;
+        }
+        ctx->src_cache_block_size = cfg->src_cache_block_size;
+        ctx->src_cache_block_count = cfg->src_cache_block_count;
+    }
+    if (cfg->flags.write_task) {
+        if (cfg->write_buffer_size == 0) {
+            ESP_LOGE(TAG, "The write task needs a write buffer size");
+            goto failure;
+        }
+        portMUX_INITIALIZE(&ctx->write_task_lock);
+        ctx->write_task_err = ESP_OK;
+        ctx->write_task_bufs = malloc(cfg->write_buffer_size * WRITE_TASK_BUF_NUM);
+        ctx->write_free_queue = xQueueCreate(WRITE_TASK_BUF_NUM, sizeof(write_chunk_t));
+        // One more item to stop the task
+        ctx->write_queue = xQueueCreate(WRITE_TASK_BUF_NUM + 1, sizeof(write_chunk_t));
+        ctx->write_task_done = xSemaphoreCreateBinary();
+        if (!ctx->write_task_bufs || !ctx->write_free_queue || !ctx->write_queue || !ctx->write_task_done) {
+            ESP_LOGE(TAG, "Unable to allocate memory for the write task");
+            goto failure;
+        }
+        ctx->write_buf = ctx->write_task_bufs;
+        for (int i = 1; i < WRITE_TASK_BUF_NUM; i++) {
+            write_chunk_t chunk = {
+                .buf = ctx->write_task_bufs + i * cfg->write_buffer_size,
+            };
+            xQueueSend(ctx->write_free_queue, &chunk, 0);
+        }
+        ctx->write_buf_size = cfg->write_buffer_size;
+    } else if (cfg->write_buffer_size > 0) {
+        ctx->write_buf = malloc(cfg->write_buffer_size);
+        if (!ctx->write_buf) {
+            ESP_LOGE(TAG, "Unable to allocate memory for the write buffer");
+            goto failure;
+        }
+        ctx->write_buf_size = cfg->write_buffer_size;
+    }
     ctx->apply_patch = calloc(1, sizeof(struct detools_apply_patch_t));
     if (!ctx->apply_patch) {
         ESP_LOGE(TAG, "Unable to allocate memory");
-        free(ctx);
-        ctx = NULL;
-        return NULL;
+        goto failure;
     }
     int ret = detools_apply_patch_init(ctx->apply_patch, &esp_delta_ota_read_cb, &esp_delta_ota_seek_cb, 0, &esp_delta_ota_write_cb, ctx);
     if (ret < 0) {
         ESP_LOGE(TAG, "Error while initializing delta_ota: %s", detools_error_as_string(ret));
-        free(ctx->apply_patch);
-        ctx->apply_patch = NULL;
-        free(ctx);
-        ctx = NULL;
+        goto failure;
+    }
+    if (cfg->flags.write_task) {
+        if (xTaskCreatePinnedToCore(write_task, "delta_ota_write", CONFIG_ESP_DELTA_OTA_WRITE_TASK_STACK_SIZE, ctx,
+                                    CONFIG_ESP_DELTA_OTA_WRITE_TASK_PRIORITY, NULL, WRITE_TASK_CORE_ID) != pdPASS) {
+            ESP_LOGE(TAG, "Unable to create the write task");
+            goto failure;
+        }
+        ctx->write_task_running = true;
+    }
+    return (esp_delta_ota_handle_t)ctx;
+
+failure:
+    free(ctx->apply_patch);
+    if (ctx->write_task_bufs) {
+        free(ctx->write_task_bufs);
+    } else {
+        free(ctx->write_buf);
+    }
+    if (ctx->write_task_done) {
+        vSemaphoreDelete(ctx->write_task_done);
+    }
+    if (ctx->write_queue) {
+        vQueueDelete(ctx->write_queue);
+    }
+    if (ctx->write_free_queue) {
+        vQueueDelete(ctx->write_free_queue);
+    }
+    free(ctx->src_cache_data);
+    free(ctx->src_cache);
+    free(ctx);
+    return NULL;
+}
+
+static esp_err_t partition_write_cb(const uint8_t *buf_p, size_t size, void *user_data)
+{
+    esp_delta_ota_ctx *ctx = (esp_delta_ota_ctx *)user_data;
+    return esp_ota_write(ctx->ota_handle, buf_p, size);
+}
+
+esp_delta_ota_handle_t esp_delta_ota_init_partitions(const esp_partition_t *src, const esp_partition_t *dst)
+{
+    if (src == NULL || dst == NULL) {
+        ESP_LOGE(TAG, "Invalid partition");
+        return NULL;
+    }
+    // The flash cache already keeps the recently read sectors, the source cache would only copy them once more
+    esp_delta_ota_cfg_t cfg = {
+        .write_buffer_size = FLASH_SECTOR_SIZE,
+    };
+    esp_delta_ota_ctx *ctx = (esp_delta_ota_ctx *)esp_delta_ota_init(&cfg);
+    if (!ctx) {
+        return NULL;
+    }
+    const void *src_map;
+    esp_err_t err = esp_partition_mmap(src, 0, src->size, ESP_PARTITION_MMAP_DATA, &src_map, &ctx->src_map_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Unable to map the source partition: %s", esp_err_to_name(err));
+        esp_delta_ota_deinit(ctx);
+        return NULL;
+    }
+    ctx->src_map = src_map;
+    ctx->src_map_size = src->size;
+    err = esp_ota_begin(dst, OTA_WITH_SEQUENTIAL_WRITES, &ctx->ota_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error in esp_ota_begin(): %s", esp_err_to_name(err));
+        esp_delta_ota_deinit(ctx);
         return NULL;
     }
+    ctx->ota_started = true;
+    ctx->user_data = ctx;
+    ctx->write_cb_with_user_data = &partition_write_cb;
     return (esp_delta_ota_handle_t)ctx;
 }
 
@@ -129,6 +475,29 @@ esp_err_t esp_delta_ota_finalize(esp_delta_ota_handle_t handle)
         ESP_LOGE(TAG, "Error while finishing the patching: %s", detools_error_as_string(err));
         return ESP_FAIL;
     }
+    if (ctx->write_task_running) {
+        if (ctx->write_buf_len > 0 && write_task_submit(ctx) != ESP_OK) {
+            write_task_stop(ctx);
+            return ESP_FAIL;
+        }
+        return write_task_stop(ctx);
+    }
+    if (ctx->write_buf_len > 0) {
+        size_t len = ctx->write_buf_len;
+        ctx->write_buf_len = 0;
+        if (write_out(ctx, ctx->write_buf, len) != ESP_OK) {
+            return ESP_FAIL;
+        }
+    }
+    if (ctx->ota_started) {
+        // esp_ota_end() frees the OTA handle, even when the validation fails
+        ctx->ota_started = false;
+        esp_err_t ota_err = esp_ota_end(ctx->ota_handle);
+        if (ota_err != ESP_OK) {
+            ESP_LOGE(TAG, "Error in esp_ota_end(): %s", esp_err_to_name(ota_err));
+            return ota_err;
+        }
+    }
     return ESP_OK;
 }
 
@@ -139,9 +508,168 @@ esp_err_t esp_delta_ota_deinit(esp_delta_ota_handle_t handle)
     }
     esp_delta_ota_ctx *ctx = (esp_delta_ota_ctx *)handle;
 
+    if (ctx->src_cache) {
+        ESP_LOGD(TAG, "Source cache: %" PRIu32 " hits, %" PRIu32 " misses, %" PRIu32 " reads",
+                 ctx->src_cache_stats.hits, ctx->src_cache_stats.misses, ctx->src_cache_stats.src_reads);
+    }
+    if (ctx->write_task_bufs) {
+        // Without esp_delta_ota_finalize(), the data left in the current buffer is dropped
+        write_task_stop(ctx);
+        vSemaphoreDelete(ctx->write_task_done);
+        vQueueDelete(ctx->write_queue);
+        vQueueDelete(ctx->write_free_queue);
+        free(ctx->write_task_bufs);
+    } else {
+        free(ctx->write_buf);
+    }
+    if (ctx->ota_started) {
+        esp_ota_abort(ctx->ota_handle);
+    }
+    if (ctx->src_map) {
+        esp_partition_munmap(ctx->src_map_handle);
+    }
+    free(ctx->src_cache_data);
+    free(ctx->src_cache);
     free(ctx->apply_patch);
     ctx->apply_patch = NULL;
     free(ctx);
     ctx = NULL;
     return ESP_OK;
 }
+
+esp_err_t esp_delta_ota_get_src_cache_stats(esp_delta_ota_handle_t handle, esp_delta_ota_src_cache_stats_t *stats)
+{
+    if (handle == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_delta_ota_ctx *ctx = (esp_delta_ota_ctx *)handle;
+
+    *stats = ctx->src_cache_stats;
+    return ESP_OK;
+}
+
+esp_err_t esp_delta_ota_get_progress(esp_delta_ota_handle_t handle, esp_delta_ota_progress_t *progress)
+{
+    if (handle == NULL || progress == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_delta_ota_ctx *ctx = (esp_delta_ota_ctx *)handle;
+
+    *progress = ctx->progress;
+    return ESP_OK;
+}
+
+// Only sequential patches are applied, in-place patches need a different API of detools
+#define PATCH_TYPE_SEQUENTIAL   0
+
+/* Unpacks a size as packed by detools: sign and 6 bits in the first byte, then 7 bits per byte */
+static int unpack_patch_size(const uint8_t *buf, size_t size, size_t *value)
+{
+    if (size == 0) {
+        return 0;
+    }
+    uint8_t byte = buf[0];
+    if (byte & 0x40) {
+        return -1;
+    }
+    uint32_t result = byte & 0x3f;
+    int offset = 6;
+    size_t i = 1;
+    while (byte & 0x80) {
+        if (i == size) {
+            return 0;
+        }
+        if (offset > 31) {
+            return -1;
+        }
+        byte = buf[i++];
+        result |= (uint32_t)(byte & 0x7f) << offset;
+        offset += 7;
+    }
+    *value = result;
+    return i;
+}
+
+static bool compression_supported(int compression)
+{
+    switch (compression) {
+#if !defined(DETOOLS_CONFIG_COMPRESSION_NONE) || DETOOLS_CONFIG_COMPRESSION_NONE == 1
+    case ESP_DELTA_OTA_COMPRESSION_NONE:
+#endif
+#if !defined(DETOOLS_CONFIG_COMPRESSION_LZMA) || DETOOLS_CONFIG_COMPRESSION_LZMA == 1
+    case ESP_DELTA_OTA_COMPRESSION_LZMA:
+#endif
+#if !defined(DETOOLS_CONFIG_COMPRESSION_CRLE) || DETOOLS_CONFIG_COMPRESSION_CRLE == 1
+    case ESP_DELTA_OTA_COMPRESSION_CRLE:
+#endif
+#if !defined(DETOOLS_CONFIG_COMPRESSION_HEATSHRINK) || DETOOLS_CONFIG_COMPRESSION_HEATSHRINK == 1
+    case ESP_DELTA_OTA_COMPRESSION_HEATSHRINK:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
+esp_err_t esp_delta_ota_parse_patch_header(const uint8_t *buf, size_t size, const esp_delta_ota_cfg_t *cfg,
+        esp_delta_ota_patch_info_t *info)
+{
+    if (buf == NULL || cfg == NULL || info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memset(info, 0, sizeof(*info));
+    if (size == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    int patch_type = (buf[0] >> 4) & 0x7;
+    int compression = buf[0] & 0xf;
+    if (patch_type != PATCH_TYPE_SEQUENTIAL) {
+        ESP_LOGE(TAG, "Unsupported patch type %d", patch_type);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (!compression_supported(compression)) {
+        ESP_LOGE(TAG, "Unsupported patch compression %d", compression);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    info->compression = compression;
+
+    int len = unpack_patch_size(buf + 1, size - 1, &info->target_size);
+    if (len < 0) {
+        ESP_LOGE(TAG, "Invalid patch target size");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (len == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t index = 1 + len;
+
+    if (compression == ESP_DELTA_OTA_COMPRESSION_HEATSHRINK) {
+        if (index == size) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+        info->heatshrink_window_sz2 = (buf[index] >> 4) + 4;
+        info->heatshrink_lookahead_sz2 = (buf[index] & 0xf) + 3;
+#if defined(HEATSHRINK_STATIC_WINDOW_BITS) && defined(HEATSHRINK_STATIC_LOOKAHEAD_BITS)
+        if (info->heatshrink_window_sz2 != HEATSHRINK_STATIC_WINDOW_BITS ||
+                info->heatshrink_lookahead_sz2 != HEATSHRINK_STATIC_LOOKAHEAD_BITS) {
+            ESP_LOGE(TAG, "The patch was created with heatshrink window %d and lookahead %d, this build supports %d and %d",
+                     info->heatshrink_window_sz2, info->heatshrink_lookahead_sz2,
+                     HEATSHRINK_STATIC_WINDOW_BITS, HEATSHRINK_STATIC_LOOKAHEAD_BITS);
+            return ESP_ERR_NOT_SUPPORTED;
+        }
+#endif
+    }
+
+    // Same allocations as esp_delta_ota_init(), the decompression buffers are part of detools_apply_patch_t
+    info->heap_size = sizeof(esp_delta_ota_ctx) + sizeof(struct detools_apply_patch_t);
+    if (cfg->src_cache_block_size > 0 && cfg->src_cache_block_count > 0) {
+        info->heap_size += cfg->src_cache_block_count * (sizeof(src_cache_block_t) + cfg->src_cache_block_size);
+    }
+    if (cfg->flags.write_task) {
+        info->heap_size += cfg->write_buffer_size * WRITE_TASK_BUF_NUM + CONFIG_ESP_DELTA_OTA_WRITE_TASK_STACK_SIZE;
+    } else {
+        info->heap_size += cfg->write_buffer_size;
+    }
+    return ESP_OK;
+}
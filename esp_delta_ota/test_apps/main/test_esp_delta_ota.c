@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <inttypes.h>
 #include <freertos/FreeRTOS.h>
 
 #include "unity.h"
@@ -116,3 +117,171 @@ TEST_CASE("Sending 1 byte of patch at once", "[esp_delta_ota]")
 
     TEST_ASSERT_EQUAL_INT(0, memcmp(new_bin_start, output_buffer, output_index));
 }
+
+static int bounded_read_count = 0;
+static esp_err_t bounded_read_cb(uint8_t *buf_p, size_t size, int src_offset)
+{
+    bounded_read_count++;
+    if (size <= 0 || src_offset < 0 || src_offset + size > base_bin_end - base_bin_start) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(buf_p, base_bin_start + src_offset, size);
+    return ESP_OK;
+}
+
+TEST_CASE("Reading the source through the cache", "[esp_delta_ota]")
+{
+    memset(output_buffer, 0, 1000);
+    output_index = 0;
+    bounded_read_count = 0;
+    esp_delta_ota_cfg_t cfg = {
+        .read_cb = &bounded_read_cb,
+        .write_cb = &write_cb,
+    };
+
+    // Reference number of source reads, without the cache
+    esp_delta_ota_handle_t handle = esp_delta_ota_init(&cfg);
+    TEST_ASSERT_NOT_NULL(handle);
+    TEST_ESP_OK(esp_delta_ota_feed_patch(handle, patch_bin_start, patch_bin_end - patch_bin_start));
+    TEST_ESP_OK(esp_delta_ota_finalize(handle));
+    TEST_ESP_OK(esp_delta_ota_deinit(handle));
+    const int direct_reads = bounded_read_count;
+
+    memset(output_buffer, 0, 1000);
+    output_index = 0;
+    bounded_read_count = 0;
+    // The last block goes past the end of base.bin, and is read directly
+    cfg.src_cache_block_size = 256;
+    cfg.src_cache_block_count = 2;
+    handle = esp_delta_ota_init(&cfg);
+    TEST_ASSERT_NOT_NULL(handle);
+    TEST_ESP_OK(esp_delta_ota_feed_patch(handle, patch_bin_start, patch_bin_end - patch_bin_start));
+    TEST_ESP_OK(esp_delta_ota_finalize(handle));
+    esp_delta_ota_src_cache_stats_t stats;
+    TEST_ESP_OK(esp_delta_ota_get_src_cache_stats(handle, &stats));
+    TEST_ESP_OK(esp_delta_ota_deinit(handle));
+
+    TEST_ASSERT_EQUAL_INT(0, memcmp(new_bin_start, output_buffer, new_bin_end - new_bin_start));
+    TEST_ASSERT_EQUAL_UINT32(bounded_read_count, stats.src_reads);
+    printf("Source reads: %d direct, %" PRIu32 " cached (%" PRIu32 " hits, %" PRIu32 " misses)\n",
+           direct_reads, stats.src_reads, stats.hits, stats.misses);
+}
+
+#define TEST_WRITE_BUFFER_SIZE 256
+static int unaligned_write_count = 0;
+static esp_err_t buffered_write_cb(const uint8_t *buf_p, size_t size, void *user_data)
+{
+    if (size % TEST_WRITE_BUFFER_SIZE != 0) {
+        unaligned_write_count++;
+    }
+    memcpy(output_buffer + output_index, buf_p, size);
+    output_index += size;
+    return ESP_OK;
+}
+
+TEST_CASE("Writing through the write buffer", "[esp_delta_ota]")
+{
+    memset(output_buffer, 0, 1000);
+    output_index = 0;
+    unaligned_write_count = 0;
+    esp_delta_ota_cfg_t cfg = {
+        // write_cb_with_user_data is only used along with user_data
+        .user_data = &unaligned_write_count,
+        .read_cb = &read_cb,
+        .write_cb_with_user_data = &buffered_write_cb,
+        .write_buffer_size = TEST_WRITE_BUFFER_SIZE,
+    };
+
+    esp_delta_ota_handle_t handle = esp_delta_ota_init(&cfg);
+    TEST_ASSERT_NOT_NULL(handle);
+    esp_err_t err = ESP_OK;
+
+    for (int i = 0; i < patch_bin_end - patch_bin_start; i++) {
+        err = esp_delta_ota_feed_patch(handle, patch_bin_start + i, 1);
+        TEST_ESP_OK(err);
+    }
+    TEST_ASSERT_EQUAL_INT(0, unaligned_write_count);
+    err = esp_delta_ota_finalize(handle);
+    TEST_ESP_OK(err);
+
+    err = esp_delta_ota_deinit(handle);
+    TEST_ESP_OK(err);
+
+    // Only the tail written by esp_delta_ota_finalize() may be shorter
+    TEST_ASSERT_LESS_OR_EQUAL_INT(1, unaligned_write_count);
+    TEST_ASSERT_EQUAL_INT(new_bin_end - new_bin_start, output_index);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(new_bin_start, output_buffer, output_index));
+}
+
+TEST_CASE("Writing from the write task", "[esp_delta_ota]")
+{
+    memset(output_buffer, 0, 1000);
+    output_index = 0;
+    unaligned_write_count = 0;
+    esp_delta_ota_cfg_t cfg = {
+        .user_data = &unaligned_write_count,
+        .read_cb = &read_cb,
+        .write_cb_with_user_data = &buffered_write_cb,
+        .write_buffer_size = TEST_WRITE_BUFFER_SIZE,
+        .flags.write_task = true,
+    };
+
+    esp_delta_ota_handle_t handle = esp_delta_ota_init(&cfg);
+    TEST_ASSERT_NOT_NULL(handle);
+    esp_err_t err = ESP_OK;
+
+    for (int i = 0; i < patch_bin_end - patch_bin_start; i++) {
+        err = esp_delta_ota_feed_patch(handle, patch_bin_start + i, 1);
+        TEST_ESP_OK(err);
+    }
+    err = esp_delta_ota_finalize(handle);
+    TEST_ESP_OK(err);
+
+    esp_delta_ota_progress_t progress;
+    TEST_ESP_OK(esp_delta_ota_get_progress(handle, &progress));
+    err = esp_delta_ota_deinit(handle);
+    TEST_ESP_OK(err);
+
+    TEST_ASSERT_EQUAL_UINT32(new_bin_end - new_bin_start, progress.bytes_applied);
+    TEST_ASSERT_EQUAL_UINT32(new_bin_end - new_bin_start, progress.bytes_written);
+    TEST_ASSERT_LESS_OR_EQUAL_INT(1, unaligned_write_count);
+    TEST_ASSERT_EQUAL_INT(new_bin_end - new_bin_start, output_index);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(new_bin_start, output_buffer, output_index));
+}
+
+TEST_CASE("Write task without write buffer", "[esp_delta_ota]")
+{
+    esp_delta_ota_cfg_t cfg = {
+        .read_cb = &read_cb,
+        .write_cb = &write_cb,
+        .flags.write_task = true,
+    };
+    TEST_ASSERT_NULL(esp_delta_ota_init(&cfg));
+}
+
+TEST_CASE("Partition backend without partitions", "[esp_delta_ota]")
+{
+    const esp_partition_t *running = esp_partition_find_first(ESP_PARTITION_TYPE_APP, ESP_PARTITION_SUBTYPE_ANY, NULL);
+    TEST_ASSERT_NOT_NULL(running);
+    TEST_ASSERT_NULL(esp_delta_ota_init_partitions(NULL, running));
+    TEST_ASSERT_NULL(esp_delta_ota_init_partitions(running, NULL));
+}
+
+TEST_CASE("Parsing the patch header", "[esp_delta_ota]")
+{
+    esp_delta_ota_cfg_t cfg = {
+        .read_cb = &read_cb,
+        .write_cb = &write_cb,
+        .write_buffer_size = 256,
+    };
+    esp_delta_ota_patch_info_t info;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_delta_ota_parse_patch_header(patch_bin_start, patch_bin_end - patch_bin_start, &cfg, &info));
+    TEST_ASSERT_EQUAL(ESP_DELTA_OTA_COMPRESSION_HEATSHRINK, info.compression);
+    TEST_ASSERT_EQUAL(new_bin_end - new_bin_start, info.target_size);
+    TEST_ASSERT_GREATER_THAN(cfg.write_buffer_size, info.heap_size);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_delta_ota_parse_patch_header(patch_bin_start, 2, &cfg, &info));
+
+    const uint8_t in_place_patch[] = {0x14, 0xbd, 0x13, 0x44};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_delta_ota_parse_patch_header(in_place_patch, sizeof(in_place_patch), &cfg, &info));
+}
@@ -19,6 +19,7 @@
 #include "esp_system.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "esp_ota_ops.h"
 #include "esp_http_client.h"
 #include "esp_https_ota.h"
@@ -26,6 +27,9 @@
 #include "nvs_flash.h"
 #include "protocol_examples_common.h"
 #include "esp_encrypted_img.h"
+#if CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE
+#include "esp_encrypted_img_pipeline.h"
+#endif
 #ifdef CONFIG_EXAMPLE_USE_CERT_BUNDLE
 #include "esp_crt_bundle.h"
 #endif
@@ -43,6 +47,12 @@ static const char *TAG = "pre_encrypted_ota_example";
 extern const char server_cert_pem_start[] asm("_binary_ca_cert_pem_start");
 extern const char server_cert_pem_end[] asm("_binary_ca_cert_pem_end");
 
+#if !CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE
+// Time spent in the decryption, to tell whether the OTA is bound by the CPU or by the network
+static int64_t s_decrypt_us;
+static size_t s_decrypt_bytes;
+#endif
+
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
 extern const char rsa_private_pem_start[] asm("_binary_private_pem_start");
 extern const char rsa_private_pem_end[]   asm("_binary_private_pem_end");
@@ -73,6 +83,7 @@ static esp_err_t validate_image_header(esp_app_desc_t *new_app_info)
     return ESP_OK;
 }
 
+#if !CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE
 static esp_err_t _decrypt_cb(decrypt_cb_arg_t *args, void *user_ctx)
 {
     if (args == NULL || user_ctx == NULL) {
@@ -83,7 +94,10 @@ static esp_err_t _decrypt_cb(decrypt_cb_arg_t *args, void *user_ctx)
     pre_enc_decrypt_arg_t pargs = {};
     pargs.data_in = args->data_in;
     pargs.data_in_len = args->data_in_len;
+    const int64_t start = esp_timer_get_time();
     err = esp_encrypted_img_decrypt_data((esp_decrypt_handle_t *)user_ctx, &pargs);
+    s_decrypt_us += esp_timer_get_time() - start;
+    s_decrypt_bytes += args->data_in_len;
     if (err != ESP_OK && err != ESP_ERR_NOT_FINISHED) {
         ESP_LOGE(TAG, "Decrypt callback failed %d", err);
         free(pargs.data_out);
@@ -112,6 +126,100 @@ static esp_err_t _decrypt_cb(decrypt_cb_arg_t *args, void *user_ctx)
 
     return ESP_OK;
 }
+#else
+typedef struct {
+    esp_http_client_handle_t client;
+    esp_ota_handle_t ota;
+    bool image_verified;
+    size_t image_len;
+} pipeline_ota_t;
+
+static int pipeline_read_cb(void *user_ctx, char *buf, size_t size)
+{
+    pipeline_ota_t *ota = (pipeline_ota_t *)user_ctx;
+    return esp_http_client_read(ota->client, buf, size);
+}
+
+static esp_err_t pipeline_write_cb(void *user_ctx, const char *data, size_t len)
+{
+    pipeline_ota_t *ota = (pipeline_ota_t *)user_ctx;
+    if (!ota->image_verified) {
+        const int app_desc_offset = sizeof(esp_image_header_t) + sizeof(esp_image_segment_header_t);
+        // The first chunk holds the App Descriptor, unless the pipeline chunks are very small
+        if (len < app_desc_offset + sizeof(esp_app_desc_t)) {
+            ESP_LOGE(TAG, "App Descriptor not found in the first chunk");
+            return ESP_ERR_INVALID_SIZE;
+        }
+        esp_err_t err = validate_image_header((esp_app_desc_t *)&data[app_desc_offset]);
+        if (err != ESP_OK) {
+            return err;
+        }
+        ota->image_verified = true;
+    }
+    ota->image_len += len;
+    return esp_ota_write(ota->ota, data, len);
+}
+
+/* Downloads, decrypts and writes the image through the pipeline, decrypt_handle is released in any case */
+static esp_err_t pipeline_ota(esp_http_client_config_t *config, esp_decrypt_handle_t decrypt_handle)
+{
+    pipeline_ota_t ota = {0};
+    const esp_partition_t *partition = esp_ota_get_next_update_partition(NULL);
+    bool ota_begun = false;
+    esp_err_t err = ESP_FAIL;
+
+    ota.client = esp_http_client_init(config);
+    if (ota.client == NULL) {
+        goto exit;
+    }
+    if ((err = esp_http_client_open(ota.client, 0)) != ESP_OK) {
+        goto exit;
+    }
+    if (esp_http_client_fetch_headers(ota.client) < 0) {
+        err = ESP_FAIL;
+        goto exit;
+    }
+    if ((err = esp_ota_begin(partition, OTA_SIZE_UNKNOWN, &ota.ota)) != ESP_OK) {
+        goto exit;
+    }
+    ota_begun = true;
+
+    esp_encrypted_img_pipeline_config_t pipeline_cfg = ESP_ENCRYPTED_IMG_PIPELINE_CONFIG_DEFAULT();
+    pipeline_cfg.read_cb = pipeline_read_cb;
+    pipeline_cfg.write_cb = pipeline_write_cb;
+    pipeline_cfg.user_ctx = &ota;
+    pipeline_cfg.chunk_size = CONFIG_EXAMPLE_OTA_BUF_SIZE;
+    const int64_t start = esp_timer_get_time();
+    err = esp_encrypted_img_decrypt_pipeline(decrypt_handle, &pipeline_cfg);
+    const int64_t ota_us = esp_timer_get_time() - start;
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Pipelined OTA of %u bytes in %lld us: %.2f MB/s", (unsigned int)ota.image_len, (long long)ota_us,
+                 (double)ota.image_len / ota_us);
+    }
+
+exit:
+    if (err == ESP_OK) {
+        err = esp_encrypted_img_decrypt_end(decrypt_handle);
+    } else {
+        esp_encrypted_img_decrypt_abort(decrypt_handle);
+    }
+    if (ota_begun) {
+        if (err == ESP_OK) {
+            err = esp_ota_end(ota.ota);
+        } else {
+            esp_ota_abort(ota.ota);
+        }
+    }
+    if (err == ESP_OK) {
+        err = esp_ota_set_boot_partition(partition);
+    }
+    if (ota.client) {
+        esp_http_client_close(ota.client);
+        esp_http_client_cleanup(ota.client);
+    }
+    return err;
+}
+#endif /* CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE */
 
 void pre_encrypted_ota_task(void *pvParameter)
 {
@@ -120,6 +228,7 @@ void pre_encrypted_ota_task(void *pvParameter)
     esp_http_client_config_t config = {
         .url = CONFIG_EXAMPLE_FIRMWARE_UPGRADE_URL,
         .timeout_ms = CONFIG_EXAMPLE_OTA_RECV_TIMEOUT,
+        .buffer_size = CONFIG_EXAMPLE_OTA_BUF_SIZE,
 #ifdef CONFIG_EXAMPLE_USE_CERT_BUNDLE
         .crt_bundle_attach = esp_crt_bundle_attach,
 #else
@@ -160,6 +269,15 @@ void pre_encrypted_ota_task(void *pvParameter)
     config.skip_cert_common_name_check = true;
 #endif
 
+#if CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE
+    if (pipeline_ota(&config, decrypt_handle) == ESP_OK) {
+        ESP_LOGI(TAG, "ESP_HTTPS_OTA upgrade successful. Rebooting ...");
+        vTaskDelay(1000 / portTICK_PERIOD_MS);
+        esp_restart();
+    }
+    ESP_LOGE(TAG, "ESP_HTTPS_OTA upgrade failed");
+    vTaskDelete(NULL);
+#else
     esp_https_ota_config_t ota_config = {
         .http_config = &config,
 #ifdef CONFIG_EXAMPLE_ENABLE_PARTIAL_HTTP_DOWNLOAD
@@ -172,6 +290,7 @@ void pre_encrypted_ota_task(void *pvParameter)
     };
 
     esp_https_ota_handle_t https_ota_handle = NULL;
+    const int64_t ota_start = esp_timer_get_time();
     esp_err_t err = esp_https_ota_begin(&ota_config, &https_ota_handle);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "ESP HTTPS OTA Begin failed");
@@ -189,6 +308,12 @@ void pre_encrypted_ota_task(void *pvParameter)
         ESP_LOGD(TAG, "Image bytes read: %d", esp_https_ota_get_image_len_read(https_ota_handle));
     }
 
+    const int64_t ota_us = esp_timer_get_time() - ota_start;
+    if (s_decrypt_us > 0) {
+        ESP_LOGI(TAG, "Decrypted %u bytes in %lld us: %.2f MB/s, %.1f%% of the OTA time", (unsigned int)s_decrypt_bytes,
+                 (long long)s_decrypt_us, (double)s_decrypt_bytes / s_decrypt_us, 100.0 * s_decrypt_us / ota_us);
+    }
+
     if (!esp_https_ota_is_complete_data_received(https_ota_handle)) {
         // the OTA image was not completely received and user can customise the response to this situation.
         ESP_LOGE(TAG, "Complete data was not received.");
@@ -216,6 +341,7 @@ ota_end:
     esp_encrypted_img_decrypt_abort(decrypt_handle);
     ESP_LOGE(TAG, "ESP_HTTPS_OTA upgrade failed");
     vTaskDelete(NULL);
+#endif /* CONFIG_EXAMPLE_USE_DECRYPT_PIPELINE */
 }
 
 void app_main(void)
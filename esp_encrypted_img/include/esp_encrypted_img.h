@@ -62,8 +62,13 @@ extern "C" {
 #define BIN_SIZE_DATA       4
 #define RESERVED_HEADER     88
 
+/* Extra space needed in a caller supplied output buffer, see `esp_encrypted_img_decrypt_data_to_buf` */
+#define ESP_ENCRYPTED_IMG_OUT_BUF_EXTRA_SIZE    16
+
 #define ESP_ERR_ENCRYPTED_IMAGE_HMAC_KEY_NOT_FOUND 1
 
+#define ESP_ENCRYPTED_IMG_HEADER_HASH_SIZE      32
+
 typedef void *esp_decrypt_handle_t;
 
 typedef struct {
@@ -98,6 +103,25 @@ typedef struct {
     size_t data_out_len;    /*!< Output data length */
 } pre_enc_decrypt_arg_t;
 
+/**
+ * @brief  Saved state of a decryption, see `esp_encrypted_img_export_session`
+ *
+ * @note   It holds the GCM key of the image in clear: store it only in encrypted storage, e.g. encrypted NVS,
+ *         and erase it once the update is over. Only `image_offset` is meant to be read by the application.
+ */
+typedef struct {
+    uint8_t header_hash[ESP_ENCRYPTED_IMG_HEADER_HASH_SIZE];   /*!< SHA-256 of the image header */
+    uint8_t gcm_key[32];                    /*!< GCM key unwrapped from the header */
+    uint32_t image_offset;                  /*!< Offset in the image, header included, to resume the data from */
+    uint32_t binary_read;                   /*!< Binary bytes consumed at the checkpoint */
+    uint8_t cache[16];                      /*!< Partial block consumed but not decrypted yet */
+    uint8_t cache_len;                      /*!< Length of cache */
+    bool has_checkpoint;                    /*!< The GCM state below is valid */
+    uint8_t gcm_counter[16];                /*!< GCM counter block at the checkpoint */
+    uint8_t gcm_ghash[16];                  /*!< GHASH accumulator at the checkpoint */
+    uint64_t gcm_len;                       /*!< Binary bytes decrypted at the checkpoint */
+} esp_encrypted_img_session_t;
+
 
 /**
 * @brief  This function returns esp_decrypt_handle_t handle.
@@ -132,6 +156,33 @@ esp_decrypt_handle_t esp_encrypted_img_decrypt_start(const esp_decrypt_cfg_t *cf
 esp_err_t esp_encrypted_img_decrypt_data(esp_decrypt_handle_t ctx, pre_enc_decrypt_arg_t *args);
 
 
+/**
+* @brief  This function performs decryption on input data, into an output buffer supplied by the caller.
+*
+* Same as `esp_encrypted_img_decrypt_data`, without any allocation: args->data_out must point to a buffer of
+* data_out_size bytes, which may be reused across calls. It is never reallocated or freed by this function.
+* The output of a call is at most `args->data_in_len + ESP_ENCRYPTED_IMG_OUT_BUF_EXTRA_SIZE` bytes long.
+*
+* The input is decrypted in place if args->data_out is equal to args->data_in, the input buffer must then hold
+* data_out_size bytes too. Otherwise, both buffers must not overlap.
+*
+* @note Input chunks with a length multiple of 16 bytes are decrypted without any copy. Other lengths leave
+*       a partial block behind, which is decrypted with the next chunk.
+*
+* @param[in]        ctx                 esp_decrypt_handle_t handle
+* @param[in/out]    args                pointer to pre_enc_decrypt_arg_t, with data_out set by the caller
+* @param[in]        data_out_size       size of the buffer pointed to by args->data_out
+*
+* @return
+*    - ESP_FAIL                         On failure
+*    - ESP_ERR_INVALID_ARG              Invalid arguments
+*    - ESP_ERR_INVALID_SIZE             Output buffer too small
+*    - ESP_ERR_NOT_FINISHED             Decryption is in process
+*    - ESP_OK                           Success
+*/
+esp_err_t esp_encrypted_img_decrypt_data_to_buf(esp_decrypt_handle_t ctx, pre_enc_decrypt_arg_t *args, size_t data_out_size);
+
+
 /**
 * @brief  Clean-up decryption process.
 *
@@ -198,6 +249,53 @@ uint16_t esp_encrypted_img_get_header_size(void);
  */
 esp_err_t esp_encrypted_img_export_public_key(esp_decrypt_handle_t ctx, uint8_t **pub_key, size_t *pub_key_len);
 
+/**
+* @brief  Save the state of a decryption, to resume it later without unwrapping the GCM key again.
+*
+* The session holds the GCM key, bound to the SHA-256 of the image header. When the GCM state can be saved, it also
+* holds a checkpoint at the current position, so that an interrupted download resumes from `image_offset` instead of
+* the start of the binary. This is only possible with the mbedtls software GCM context: with
+* `CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM` or `CONFIG_MBEDTLS_HARDWARE_GCM`, `has_checkpoint` is false and
+* `image_offset` is the header size.
+*
+* @note Call it between two calls to `esp_encrypted_img_decrypt_data`, once the data before the checkpoint has been
+*       written, e.g. along with the OTA write offset.
+*
+* @param[in]   ctx       esp_decrypt_handle_t handle
+* @param[out]  session   session to fill
+*
+* @return
+*    - ESP_ERR_INVALID_ARG      Invalid arguments
+*    - ESP_ERR_INVALID_STATE    The whole header hasn't been processed yet
+*    - ESP_OK                   Success
+*/
+esp_err_t esp_encrypted_img_export_session(esp_decrypt_handle_t ctx, esp_encrypted_img_session_t *session);
+
+/**
+* @brief  Resume a decryption from a session saved by `esp_encrypted_img_export_session`.
+*
+* The header of the image, e.g. fetched again with an HTTP range request, is processed with the GCM key of the session
+* instead of the private key, then the decryption goes on from the checkpoint of the session, if any. The data must
+* then be passed to `esp_encrypted_img_decrypt_data` from offset `image_offset` of the image.
+*
+* @note This API must be called right after `esp_encrypted_img_decrypt_start`.
+*
+* @param[in]   ctx          esp_decrypt_handle_t handle
+* @param[in]   session      session exported for the same image
+* @param[in]   header       header of the image
+* @param[in]   header_len   length of header, `esp_encrypted_img_get_header_size()`
+*
+* @return
+*    - ESP_ERR_INVALID_ARG      Invalid arguments, or invalid session
+*    - ESP_ERR_INVALID_SIZE     header_len is not the header size
+*    - ESP_ERR_INVALID_STATE    Some data has already been processed
+*    - ESP_ERR_INVALID_CRC      The session belongs to another image
+*    - ESP_FAIL                 Invalid header
+*    - ESP_OK                   Success
+*/
+esp_err_t esp_encrypted_img_import_session(esp_decrypt_handle_t ctx, const esp_encrypted_img_session_t *session,
+        const char *header, size_t header_len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <esp_err.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_encrypted_img.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Reads the next part of the encrypted image, e.g. from the network.
+ *
+ * @param[in]   user_ctx    user_ctx of esp_encrypted_img_pipeline_config_t
+ * @param[out]  buf         buffer to fill
+ * @param[in]   size        size of buf
+ *
+ * @return
+ *    - Number of bytes read, at most size
+ *    - 0 at the end of the image
+ *    - Negative value on failure
+ */
+typedef int (*esp_encrypted_img_read_cb_t)(void *user_ctx, char *buf, size_t size);
+
+/**
+ * @brief  Writes the next part of the decrypted image, e.g. with esp_ota_write().
+ *
+ * @param[in]   user_ctx    user_ctx of esp_encrypted_img_pipeline_config_t
+ * @param[in]   data        decrypted data
+ * @param[in]   len         length of data
+ *
+ * @return
+ *    - ESP_OK on success, any other value aborts the pipeline and is returned by esp_encrypted_img_decrypt_pipeline()
+ */
+typedef esp_err_t (*esp_encrypted_img_write_cb_t)(void *user_ctx, const char *data, size_t len);
+
+typedef struct {
+    esp_encrypted_img_read_cb_t read_cb;    /*!< Called by the task running the pipeline */
+    esp_encrypted_img_write_cb_t write_cb;  /*!< Called by the writer task */
+    void *user_ctx;                         /*!< Passed to read_cb and write_cb */
+    size_t chunk_size;                      /*!< Size of the chunks read, decrypted and written. A multiple of 16
+                                                 bytes avoids moving the data during the decryption */
+    size_t chunk_count;                     /*!< Number of chunks in flight between the stages, at least 2 */
+    uint32_t task_stack_size;               /*!< Stack size of the decrypt and writer tasks */
+    UBaseType_t task_priority;              /*!< Priority of the decrypt and writer tasks */
+    BaseType_t decrypt_task_core;           /*!< Core of the decrypt task, or tskNO_AFFINITY */
+} esp_encrypted_img_pipeline_config_t;
+
+#if CONFIG_FREERTOS_UNICORE || portNUM_PROCESSORS < 2
+#define ESP_ENCRYPTED_IMG_PIPELINE_DECRYPT_CORE tskNO_AFFINITY
+#else
+#define ESP_ENCRYPTED_IMG_PIPELINE_DECRYPT_CORE 1
+#endif
+
+#define ESP_ENCRYPTED_IMG_PIPELINE_CONFIG_DEFAULT() {               \
+    .chunk_size = 4096,                                             \
+    .chunk_count = 4,                                               \
+    .task_stack_size = 4096,                                        \
+    .task_priority = 5,                                             \
+    .decrypt_task_core = ESP_ENCRYPTED_IMG_PIPELINE_DECRYPT_CORE,   \
+}
+
+/**
+ * @brief  Decrypt a whole image, with the reading, the decryption and the writing of successive chunks overlapping.
+ *
+ * The calling task reads the image with read_cb, a decrypt task decrypts it in place and a writer task writes it with
+ * write_cb, the three stages passing chunks to each other through a ring of chunk_count buffers. The decrypt task runs
+ * on the other core on dual core targets, so that the OTA time gets close to the slowest of the network and the flash.
+ *
+ * This function must be called after esp_encrypted_img_decrypt_start(), and returns once the whole image has been
+ * written or on the first failure. esp_encrypted_img_decrypt_end() must then be called to verify the image, or
+ * esp_encrypted_img_decrypt_abort() on failure.
+ *
+ * @param[in]   ctx         esp_decrypt_handle_t handle
+ * @param[in]   config      pointer to esp_encrypted_img_pipeline_config_t
+ *
+ * @return
+ *    - ESP_OK                  The whole image has been decrypted and written
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments
+ *    - ESP_ERR_NO_MEM          Out of memory
+ *    - ESP_FAIL                read_cb failed, decryption failed, or the image is incomplete
+ *    - Error returned by write_cb
+ */
+esp_err_t esp_encrypted_img_decrypt_pipeline(esp_decrypt_handle_t ctx, const esp_encrypted_img_pipeline_config_t *config);
+
+#ifdef __cplusplus
+}
+#endif
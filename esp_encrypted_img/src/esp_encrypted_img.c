@@ -7,6 +7,7 @@
 #include <string.h>
 #include "esp_encrypted_img.h"
 #include <errno.h>
+#include <inttypes.h>
 #include <esp_log.h>
 #include <esp_err.h>
 
@@ -15,6 +16,8 @@
 #include "mbedtls/entropy.h"
 #include "mbedtls/ctr_drbg.h"
 #include "mbedtls/gcm.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/platform_util.h"
 #include "sys/param.h"
 
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES)
@@ -40,17 +43,20 @@
 
 #endif /* CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
 
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM)
+#if __has_include("aes/esp_aes_gcm.h")
+#include "aes/esp_aes_gcm.h"
+#else
+#error "AES GCM driver is not available on this version of ESP-IDF"
+#endif /* __has_include("aes/esp_aes_gcm.h") */
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM */
+
 #include "esp_random.h"
 
 static const char *TAG = "esp_encrypted_img";
 
 typedef enum {
-    ESP_PRE_ENC_IMG_READ_MAGIC,
-    ESP_PRE_ENC_IMG_READ_GCM,
-    ESP_PRE_ENC_IMG_READ_IV,
-    ESP_PRE_ENC_IMG_READ_BINSIZE,
-    ESP_PRE_ENC_IMG_READ_AUTH,
-    ESP_PRE_ENC_IMG_READ_EXTRA_HEADER,
+    ESP_PRE_ENC_IMG_READ_HEADER,
     ESP_PRE_ENC_DATA_DECODE_STATE,
 } esp_encrypted_img_state;
 
@@ -58,25 +64,44 @@ typedef enum {
 
 #define CACHE_BUF_SIZE        16
 
-struct esp_encrypted_img_handle {
-#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
-#if !defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
-    char *rsa_pem;
-    size_t rsa_len;
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM)
+/* Bypass the mbedtls GCM layer, so that the AES peripheral processes each update at once through DMA */
+typedef esp_gcm_context enc_img_gcm_context_t;
+#define enc_img_gcm_init        esp_aes_gcm_init
+#define enc_img_gcm_setkey      esp_aes_gcm_setkey
+#define enc_img_gcm_starts      esp_aes_gcm_starts
+#define enc_img_gcm_update      esp_aes_gcm_update
+#define enc_img_gcm_finish      esp_aes_gcm_finish
+#define enc_img_gcm_free        esp_aes_gcm_free
+#else
+typedef mbedtls_gcm_context enc_img_gcm_context_t;
+#define enc_img_gcm_init        mbedtls_gcm_init
+#define enc_img_gcm_setkey      mbedtls_gcm_setkey
+#define enc_img_gcm_starts      mbedtls_gcm_starts
+#define enc_img_gcm_update      mbedtls_gcm_update
+#define enc_img_gcm_finish      mbedtls_gcm_finish
+#define enc_img_gcm_free        mbedtls_gcm_free
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM */
+
+/* The GCM state of a session can only be saved from the mbedtls software context, whose fields are known */
+#if !defined(CONFIG_PRE_ENCRYPTED_OTA_USE_HW_GCM) && !defined(MBEDTLS_GCM_ALT)
+#define ENC_IMG_GCM_CHECKPOINT  1
+#ifndef MBEDTLS_PRIVATE
+#define MBEDTLS_PRIVATE(member) member
+#endif
+#endif
+
+#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
+#define enc_img_sha256_starts   mbedtls_sha256_starts_ret
+#define enc_img_sha256_update   mbedtls_sha256_update_ret
+#define enc_img_sha256_finish   mbedtls_sha256_finish_ret
+#define enc_img_sha256          mbedtls_sha256_ret
+#else
+#define enc_img_sha256_starts   mbedtls_sha256_starts
+#define enc_img_sha256_update   mbedtls_sha256_update
+#define enc_img_sha256_finish   mbedtls_sha256_finish
+#define enc_img_sha256          mbedtls_sha256
 #endif
-#elif defined(CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES)
-    hmac_key_id_t hmac_key;
-#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES */
-    uint32_t binary_file_len;
-    uint32_t binary_file_read;
-    char gcm_key[GCM_KEY_SIZE];
-    char iv[IV_SIZE];
-    char auth_tag[AUTH_SIZE];
-    esp_encrypted_img_state state;
-    mbedtls_gcm_context gcm_ctx;
-    size_t cache_buf_len;
-    char *cache_buf;
-};
 
 typedef struct {
     char magic[MAGIC_SIZE];
@@ -94,6 +119,28 @@ typedef struct {
 } pre_enc_bin_header;
 #define HEADER_DATA_SIZE    sizeof(pre_enc_bin_header)
 
+struct esp_encrypted_img_handle {
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
+#if !defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    char *rsa_pem;
+    size_t rsa_len;
+#endif
+#elif defined(CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES)
+    hmac_key_id_t hmac_key;
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES */
+    uint32_t binary_file_len;
+    uint32_t binary_file_read;
+    char gcm_key[GCM_KEY_SIZE];
+    esp_encrypted_img_state state;
+    enc_img_gcm_context_t gcm_ctx;
+    size_t cache_buf_len;
+    char cache_buf[CACHE_BUF_SIZE];
+    size_t header_read;
+    pre_enc_bin_header header;  /* Filled as the data comes, parsed once complete */
+    uint8_t header_hash[ESP_ENCRYPTED_IMG_HEADER_HASH_SIZE];
+    bool session_key;           /* gcm_key comes from an imported session */
+};
+
 // Magic Byte is created using command: echo -n "esp_encrypted_img" | sha256sum
 static uint32_t esp_enc_img_magic = 0x0788b6cf;
 
@@ -138,17 +185,6 @@ static int decipher_gcm_key(const char *enc_gcm, esp_encrypted_img_t *handle)
         ESP_LOGE(TAG, "failed\n  ! mbedtls_pk_decrypt returned -0x%04x\n", (unsigned int) - ret);
         goto exit;
     }
-
-    void *tmp_buf = realloc(handle->cache_buf, CACHE_BUF_SIZE);
-    if (!tmp_buf) {
-        ESP_LOGE(TAG, "Failed to reallocate memory for cache buffer");
-        ret = ESP_ERR_NO_MEM;
-        goto exit;
-    }
-    handle->cache_buf = tmp_buf;
-    handle->state = ESP_PRE_ENC_IMG_READ_IV;
-    handle->binary_file_read = 0;
-    handle->cache_buf_len = 0;
 exit:
     mbedtls_pk_free(&pk);
     return (ret);
@@ -192,16 +228,6 @@ static int decipher_gcm_key(const char *enc_gcm, esp_encrypted_img_t *handle)
         ESP_LOGE(TAG, "failed\n  ! mbedtls_pk_decrypt returned -0x%04x\n", (unsigned int) - ret );
         goto exit;
     }
-    void *tmp_buf = realloc(handle->cache_buf, CACHE_BUF_SIZE);
-    if (!tmp_buf) {
-        ESP_LOGE(TAG, "Failed to reallocate memory for cache buffer");
-        ret = ESP_ERR_NO_MEM;
-        goto exit;
-    }
-    handle->cache_buf = tmp_buf;
-    handle->state = ESP_PRE_ENC_IMG_READ_IV;
-    handle->binary_file_read = 0;
-    handle->cache_buf_len = 0;
 exit:
     if (handle->rsa_pem) {
         mbedtls_platform_zeroize(handle->rsa_pem, handle->rsa_len);
@@ -519,18 +545,6 @@ static int derive_gcm_key(const char *data, esp_encrypted_img_t *handle)
 
     memcpy(handle->gcm_key, derived_key, GCM_KEY_SIZE);
     ESP_LOGI(TAG, "GCM key derived successfully");
-
-    void *tmp_buf = realloc(handle->cache_buf, CACHE_BUF_SIZE);
-    if (!tmp_buf) {
-        ESP_LOGE(TAG, "Failed to reallocate memory for cache buffer");
-        ret = ESP_ERR_NO_MEM;
-        goto exit;
-    }
-    handle->cache_buf = tmp_buf;
-
-    handle->state = ESP_PRE_ENC_IMG_READ_IV;
-    handle->binary_file_read = 0;
-    handle->cache_buf_len = 0;
 exit:
     mbedtls_ecp_group_free(&grp);
     if (server_public_point) {
@@ -747,12 +761,7 @@ esp_decrypt_handle_t esp_encrypted_img_decrypt_start(const esp_decrypt_cfg_t *cf
 
     handle->hmac_key = cfg->hmac_key_id;
 #endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES */
-    handle->cache_buf = calloc(1, ENC_GCM_KEY_SIZE);
-    if (!handle->cache_buf) {
-        ESP_LOGE(TAG, "Couldn't allocate memory to handle->cache_buf");
-        goto failure;
-    }
-    handle->state = ESP_PRE_ENC_IMG_READ_MAGIC;
+    handle->state = ESP_PRE_ENC_IMG_READ_HEADER;
 
     esp_decrypt_handle_t ctx = (esp_decrypt_handle_t)handle;
     return ctx;
@@ -762,132 +771,100 @@ failure:
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && !defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
         free(handle->rsa_pem);
 #endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA */
-        if (handle->cache_buf) {
-            free(handle->cache_buf);
-            handle->cache_buf = NULL;
-        }
         free(handle);
     }
     return NULL;
 }
 
-static esp_err_t process_bin(esp_encrypted_img_t *handle, pre_enc_decrypt_arg_t *args, int curr_index)
+static int gcm_update(esp_encrypted_img_t *handle, const char *input, size_t len, char *output)
 {
-    size_t data_len = args->data_in_len;
-    size_t data_out_size = args->data_out_len;
-#if !(MBEDTLS_VERSION_NUMBER < 0x03000000)
-    size_t olen;
-#endif
-    handle->binary_file_read += data_len - curr_index;
-    int dec_len = 0;
-    if (handle->binary_file_read != handle->binary_file_len) {
-        size_t copy_len = 0;
-
-        if ((handle->cache_buf_len + (data_len - curr_index)) - (handle->cache_buf_len + (data_len - curr_index)) % CACHE_BUF_SIZE > 0) {
-            data_out_size = (handle->cache_buf_len + (data_len - curr_index)) - (handle->cache_buf_len + (data_len - curr_index)) % CACHE_BUF_SIZE;
-            args->data_out = realloc(args->data_out, data_out_size);
-            if (!args->data_out) {
-                return ESP_ERR_NO_MEM;
-            }
-        }
-        if (handle->cache_buf_len != 0) {
-            copy_len = MIN(CACHE_BUF_SIZE - handle->cache_buf_len, data_len - curr_index);
-            memcpy(handle->cache_buf + handle->cache_buf_len, args->data_in + curr_index, copy_len);
-            handle->cache_buf_len += copy_len;
-            if (handle->cache_buf_len != CACHE_BUF_SIZE) {
-                args->data_out_len = 0;
-                return ESP_ERR_NOT_FINISHED;
-            }
 #if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-            if (mbedtls_gcm_update(&handle->gcm_ctx, CACHE_BUF_SIZE, (const unsigned char *)handle->cache_buf, (unsigned char *) args->data_out) != 0) {
+    return enc_img_gcm_update(&handle->gcm_ctx, len, (const unsigned char *)input, (unsigned char *)output);
 #else
-            if (mbedtls_gcm_update(&handle->gcm_ctx, (const unsigned char *)handle->cache_buf, CACHE_BUF_SIZE, (unsigned char *) args->data_out, data_out_size, &olen) != 0) {
+    size_t olen;
+    return enc_img_gcm_update(&handle->gcm_ctx, (const unsigned char *)input, len, (unsigned char *)output, len, &olen);
 #endif
-                return ESP_FAIL;
-            }
-            dec_len = CACHE_BUF_SIZE;
-        }
-        handle->cache_buf_len = (data_len - curr_index - copy_len) % CACHE_BUF_SIZE;
-        if (handle->cache_buf_len != 0) {
-            data_len -= handle->cache_buf_len;
-            memcpy(handle->cache_buf, args->data_in + (data_len), handle->cache_buf_len);
-        }
+}
 
-        if (data_len - copy_len - curr_index > 0) {
-#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-            if (mbedtls_gcm_update(&handle->gcm_ctx, data_len - copy_len - curr_index, (const unsigned char *)args->data_in + curr_index + copy_len, (unsigned char *)args->data_out + dec_len) != 0) {
-#else
-            if (mbedtls_gcm_update(&handle->gcm_ctx, (const unsigned char *)args->data_in + curr_index + copy_len, data_len - copy_len - curr_index, (unsigned char *)args->data_out + dec_len, data_out_size - dec_len, &olen) != 0) {
-#endif
-                return ESP_FAIL;
-            }
+/*
+ * Decrypts the binary part of the input, from curr_index. Only full blocks are decrypted, but for the last call: a
+ * partial block left at the end is cached and decrypted with the next call. args->data_out is reallocated to the
+ * output size, unless caller_buf is set.
+ */
+static esp_err_t process_bin(esp_encrypted_img_t *handle, pre_enc_decrypt_arg_t *args, int curr_index, bool caller_buf, size_t data_out_size)
+{
+    const char *data_in = args->data_in + curr_index;
+    const size_t data_in_len = args->data_in_len - curr_index;
+    const bool last = handle->binary_file_read + data_in_len == handle->binary_file_len;
+    const size_t total_len = handle->cache_buf_len + data_in_len;
+    const size_t dec_len = last ? total_len : total_len - total_len % CACHE_BUF_SIZE;
+
+    if (dec_len == 0) {
+        memcpy(handle->cache_buf + handle->cache_buf_len, data_in, data_in_len);
+        handle->cache_buf_len = total_len;
+        handle->binary_file_read += data_in_len;
+        args->data_out_len = 0;
+        return last ? ESP_OK : ESP_ERR_NOT_FINISHED;
+    }
+    if (!caller_buf) {
+        char *data_out = realloc(args->data_out, dec_len);
+        if (!data_out) {
+            return ESP_ERR_NO_MEM;
         }
-        args->data_out_len = dec_len + data_len - curr_index - copy_len;
-        return ESP_ERR_NOT_FINISHED;
-    }
-    data_out_size = handle->cache_buf_len + data_len - curr_index;
-    args->data_out = realloc(args->data_out, data_out_size);
-    if (!args->data_out) {
-        return ESP_ERR_NO_MEM;
+        args->data_out = data_out;
+    } else if (data_out_size < dec_len) {
+        ESP_LOGE(TAG, "Output buffer too small: %u bytes needed", (unsigned int)dec_len);
+        return ESP_ERR_INVALID_SIZE;
     }
-    size_t copy_len = 0;
+    handle->binary_file_read += data_in_len;
 
-    copy_len = MIN(CACHE_BUF_SIZE - handle->cache_buf_len, data_len - curr_index);
-    memcpy(handle->cache_buf + handle->cache_buf_len, args->data_in + curr_index, copy_len);
-    handle->cache_buf_len += copy_len;
-#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-    if (mbedtls_gcm_update(&handle->gcm_ctx, handle->cache_buf_len, (const unsigned char *)handle->cache_buf, (unsigned char *)args->data_out) != 0) {
-#else
-    if (mbedtls_gcm_update(&handle->gcm_ctx,  (const unsigned char *)handle->cache_buf, handle->cache_buf_len, (unsigned char *)args->data_out, data_out_size, &olen) != 0) {
-#endif
-        return ESP_FAIL;
-    }
-    if (data_len - curr_index - copy_len > 0) {
-#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-        if (mbedtls_gcm_update(&handle->gcm_ctx, data_len - curr_index - copy_len, (const unsigned char *)(args->data_in + curr_index + copy_len), (unsigned char *)(args->data_out + CACHE_BUF_SIZE)) != 0) {
-#else
-        if (mbedtls_gcm_update(&handle->gcm_ctx,  (const unsigned char *)(args->data_in + curr_index + copy_len), data_len - curr_index - copy_len, (unsigned char *)(args->data_out + CACHE_BUF_SIZE), data_out_size - CACHE_BUF_SIZE, &olen) != 0) {
-#endif
+    // Complete the block cached by the previous call
+    char block[CACHE_BUF_SIZE];
+    size_t block_len = 0;
+    size_t copy_len = 0;
+    if (handle->cache_buf_len != 0) {
+        copy_len = MIN(CACHE_BUF_SIZE - handle->cache_buf_len, data_in_len);
+        memcpy(handle->cache_buf + handle->cache_buf_len, data_in, copy_len);
+        block_len = handle->cache_buf_len + copy_len;
+        if (gcm_update(handle, handle->cache_buf, block_len, block) != 0) {
             return ESP_FAIL;
         }
     }
 
-    args->data_out_len = handle->cache_buf_len + data_len - copy_len - curr_index;
-    handle->cache_buf_len = 0;
-
-    return ESP_OK;
-}
+    // Cache the partial block left at the end, before an in place decryption overwrites it
+    const size_t bulk_len = dec_len - block_len;
+    handle->cache_buf_len = total_len - dec_len;
+    memcpy(handle->cache_buf, data_in + copy_len + bulk_len, handle->cache_buf_len);
 
-static void read_and_cache_data(esp_encrypted_img_t *handle, pre_enc_decrypt_arg_t *args, int *curr_index, int data_size)
-{
-    const int data_left = data_size - handle->binary_file_read;
-    const int data_recv = args->data_in_len - *curr_index;
-    if (handle->state == ESP_PRE_ENC_IMG_READ_IV) {
-        memcpy(handle->iv + handle->cache_buf_len, args->data_in + *curr_index, MIN(data_recv, data_left));
-    } else if (handle->state == ESP_PRE_ENC_IMG_READ_AUTH) {
-        memcpy(handle->auth_tag + handle->cache_buf_len, args->data_in + *curr_index, MIN(data_recv, data_left));
-    } else {
-        memcpy(handle->cache_buf + handle->cache_buf_len, args->data_in + *curr_index, MIN(data_recv, data_left));
+    if (bulk_len > 0) {
+        // In place, the output is shifted from the input by the header and the cached block
+        const bool in_place = caller_buf && args->data_out == args->data_in;
+        char *bulk_out = in_place ? args->data_out + curr_index + copy_len : args->data_out + block_len;
+        if (gcm_update(handle, data_in + copy_len, bulk_len, bulk_out) != 0) {
+            return ESP_FAIL;
+        }
+        if (bulk_out != args->data_out + block_len) {
+            memmove(args->data_out + block_len, bulk_out, bulk_len);
+        }
     }
-    handle->cache_buf_len += MIN(data_recv, data_left);
-    int temp = *curr_index;
-    *curr_index += MIN(data_recv, data_left);
-    handle->binary_file_read += MIN(args->data_in_len - temp, data_left);
+    memcpy(args->data_out, block, block_len);
+    args->data_out_len = dec_len;
+
+    return last ? ESP_OK : ESP_ERR_NOT_FINISHED;
 }
 
-static esp_err_t process_gcm_key(esp_encrypted_img_t *handle, const char *data_in, size_t data_in_len)
+static esp_err_t process_gcm_key(esp_encrypted_img_t *handle)
 {
-    if (data_in_len < ENC_GCM_KEY_SIZE) {
-        ESP_LOGE(TAG, "GCM key size is less than expected");
-        return ESP_FAIL;
+    if (handle->session_key) {
+        return ESP_OK;
     }
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
-    if (decipher_gcm_key(data_in, handle) != 0) {
+    if (decipher_gcm_key(handle->header.enc_gcm, handle) != 0) {
         ESP_LOGE(TAG, "Unable to decipher GCM key");
         return ESP_FAIL;
     }
 #elif defined(CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES)
-    if (derive_gcm_key(data_in, handle) != ESP_OK) {
+    if (derive_gcm_key((const char *)handle->header.server_ecc_pub_key, handle) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to derive GCM key");
         return ESP_FAIL;
     }
@@ -895,155 +872,106 @@ static esp_err_t process_gcm_key(esp_encrypted_img_t *handle, const char *data_i
     return ESP_OK;
 }
 
-esp_err_t esp_encrypted_img_decrypt_data(esp_decrypt_handle_t ctx, pre_enc_decrypt_arg_t *args)
+/*
+ * Parses the complete header: unwraps the GCM key and starts the decryption of the binary with the IV of the header.
+ */
+static esp_err_t process_header(esp_encrypted_img_t *handle)
 {
-    if (ctx == NULL || args == NULL || args->data_in == NULL) {
-        return ESP_ERR_INVALID_ARG;
+    const pre_enc_bin_header *header = &handle->header;
+    int ret;
+
+    if (process_gcm_key(handle) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to process GCM key");
+        return ESP_FAIL;
     }
-    esp_encrypted_img_t *handle = (esp_encrypted_img_t *)ctx;
-    if (handle == NULL) {
-        ESP_LOGE(TAG, "esp_encrypted_img_decrypt_data: Invalid argument");
-        return ESP_ERR_INVALID_ARG;
+    memcpy(&handle->binary_file_len, header->bin_size, BIN_SIZE_DATA);
+
+    enc_img_gcm_init(&handle->gcm_ctx);
+    if ((ret = enc_img_gcm_setkey(&handle->gcm_ctx, MBEDTLS_CIPHER_ID_AES, (const unsigned char *)handle->gcm_key, GCM_KEY_SIZE * 8)) != 0) {
+        ESP_LOGE(TAG, "Error: mbedtls_gcm_set_key: -0x%04x\n", (unsigned int) - ret);
+        return ESP_FAIL;
+    }
+#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
+    if ((ret = enc_img_gcm_starts(&handle->gcm_ctx, MBEDTLS_GCM_DECRYPT, (const unsigned char *)header->iv, IV_SIZE, NULL, 0)) != 0) {
+#else
+    if ((ret = enc_img_gcm_starts(&handle->gcm_ctx, MBEDTLS_GCM_DECRYPT, (const unsigned char *)header->iv, IV_SIZE)) != 0) {
+#endif
+        ESP_LOGE(TAG, "Error: mbedtls_gcm_starts: -0x%04x\n", (unsigned int) - ret);
+        return ESP_FAIL;
+    }
+    if (enc_img_sha256((const unsigned char *)header, HEADER_DATA_SIZE, handle->header_hash, 0) != 0) {
+        return ESP_FAIL;
     }
 
-    esp_err_t err;
-    int curr_index = 0;
+    handle->state = ESP_PRE_ENC_DATA_DECODE_STATE;
+    handle->binary_file_read = 0;
+    handle->cache_buf_len = 0;
+    return ESP_OK;
+}
 
-    switch (handle->state) {
-    case ESP_PRE_ENC_IMG_READ_MAGIC:
-        if (handle->cache_buf_len == 0 && (args->data_in_len - curr_index) >= MAGIC_SIZE) {
-            uint32_t recv_magic = *(uint32_t *)args->data_in;
-            if (recv_magic != esp_enc_img_magic) {
-                ESP_LOGE(TAG, "Magic Verification failed");
-#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && !defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
-                free(handle->rsa_pem);
-                handle->rsa_pem = NULL;
-#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA */
-                return ESP_FAIL;
-            }
-            curr_index += MAGIC_SIZE;
-        } else {
-            read_and_cache_data(handle, args, &curr_index, MAGIC_SIZE);
-            if (handle->binary_file_read == MAGIC_SIZE) {
-                uint32_t recv_magic = *(uint32_t *)handle->cache_buf;
-
-                if (recv_magic != esp_enc_img_magic) {
-                    ESP_LOGE(TAG, "Magic Verification failed");
+/*
+ * Copies the header part of the input to handle->header, at once, and parses the header when it is complete. The
+ * magic is checked as soon as it is received, so that another image is rejected without waiting for the header.
+ */
+static esp_err_t read_header(esp_encrypted_img_t *handle, const pre_enc_decrypt_arg_t *args, size_t *header_len)
+{
+    const size_t prev_read = handle->header_read;
+    const size_t len = MIN(args->data_in_len, HEADER_DATA_SIZE - prev_read);
+
+    memcpy((char *)&handle->header + prev_read, args->data_in, len);
+    handle->header_read += len;
+    *header_len = len;
+
+    if (handle->header_read >= MAGIC_SIZE && memcmp(handle->header.magic, &esp_enc_img_magic, MAGIC_SIZE) != 0) {
+        ESP_LOGE(TAG, "Magic Verification failed");
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && !defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
-                    free(handle->rsa_pem);
-                    handle->rsa_pem = NULL;
+        free(handle->rsa_pem);
+        handle->rsa_pem = NULL;
 #endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA */
-                    return ESP_FAIL;
-                }
-                handle->binary_file_read = 0;
-                handle->cache_buf_len = 0;
-            } else {
-                return ESP_ERR_NOT_FINISHED;
-            }
-        }
+        return ESP_FAIL;
+    }
+    if (prev_read < MAGIC_SIZE && handle->header_read >= MAGIC_SIZE) {
         ESP_LOGI(TAG, "Magic Verified");
-        handle->state = ESP_PRE_ENC_IMG_READ_GCM;
-    /* falls through */
-    case ESP_PRE_ENC_IMG_READ_GCM:
-        if (handle->cache_buf_len == 0 && args->data_in_len - curr_index >= ENC_GCM_KEY_SIZE) {
-            if (process_gcm_key(handle, args->data_in + curr_index, ENC_GCM_KEY_SIZE) != ESP_OK) {
-                ESP_LOGE(TAG, "Failed to process GCM key");
-                handle->cache_buf_len = 0;
-                return ESP_FAIL;
-            }
-            curr_index += ENC_GCM_KEY_SIZE;
-        } else {
-            read_and_cache_data(handle, args, &curr_index, ENC_GCM_KEY_SIZE);
-            if (handle->cache_buf_len == ENC_GCM_KEY_SIZE) {
-                if (process_gcm_key(handle, handle->cache_buf, ENC_GCM_KEY_SIZE) != ESP_OK) {
-                    ESP_LOGE(TAG, "Failed to process GCM key");
-                    handle->cache_buf_len = 0;
-                    return ESP_FAIL;
-                }
-            } else {
-                return ESP_ERR_NOT_FINISHED;
-            }
-        }
-    /* falls through */
-    case ESP_PRE_ENC_IMG_READ_IV:
-        if (handle->cache_buf_len == 0 && args->data_in_len - curr_index >= IV_SIZE) {
-            memcpy(handle->iv, args->data_in + curr_index, IV_SIZE);
-            handle->binary_file_read = IV_SIZE;
-            curr_index += IV_SIZE;
-        } else {
-            read_and_cache_data(handle, args, &curr_index, IV_SIZE);
-        }
-        if (handle->binary_file_read == IV_SIZE) {
-            handle->state = ESP_PRE_ENC_IMG_READ_BINSIZE;
-            handle->binary_file_read = 0;
-            handle->cache_buf_len = 0;
-            mbedtls_gcm_init(&handle->gcm_ctx);
-            if ((err = mbedtls_gcm_setkey(&handle->gcm_ctx, MBEDTLS_CIPHER_ID_AES, (const unsigned char *)handle->gcm_key, GCM_KEY_SIZE * 8)) != 0) {
-                ESP_LOGE(TAG, "Error: mbedtls_gcm_set_key: -0x%04x\n", (unsigned int) - err);
-                return ESP_FAIL;
-            }
-#if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-            if (mbedtls_gcm_starts(&handle->gcm_ctx, MBEDTLS_GCM_DECRYPT, (const unsigned char *)handle->iv, IV_SIZE, NULL, 0) != 0) {
-#else
-            if (mbedtls_gcm_starts(&handle->gcm_ctx, MBEDTLS_GCM_DECRYPT, (const unsigned char *)handle->iv, IV_SIZE) != 0) {
-#endif
-                ESP_LOGE(TAG, "Error: mbedtls_gcm_starts: -0x%04x\n", (unsigned int) - err);
-                return ESP_FAIL;
-            }
-        } else {
-            return ESP_ERR_NOT_FINISHED;
-        }
-    /* falls through */
-    case ESP_PRE_ENC_IMG_READ_BINSIZE:
-        if (handle->cache_buf_len == 0 && (args->data_in_len - curr_index) >= BIN_SIZE_DATA) {
-            handle->binary_file_len = *(uint32_t *)(args->data_in + curr_index);
-            curr_index += BIN_SIZE_DATA;
-        } else {
-            read_and_cache_data(handle, args, &curr_index, BIN_SIZE_DATA);
-            if (handle->binary_file_read == BIN_SIZE_DATA) {
-                handle->binary_file_len = *(uint32_t *)handle->cache_buf;
-            } else {
-                return ESP_ERR_NOT_FINISHED;
-            }
-        }
-        handle->state = ESP_PRE_ENC_IMG_READ_AUTH;
-        handle->binary_file_read = 0;
-        handle->cache_buf_len = 0;
-    /* falls through */
-    case ESP_PRE_ENC_IMG_READ_AUTH:
-        if (handle->cache_buf_len == 0 && args->data_in_len - curr_index >= AUTH_SIZE) {
-            memcpy(handle->auth_tag, args->data_in + curr_index, AUTH_SIZE);
-            handle->binary_file_read = AUTH_SIZE;
-            curr_index += AUTH_SIZE;
-        } else {
-            read_and_cache_data(handle, args, &curr_index, AUTH_SIZE);
-        }
-        if (handle->binary_file_read == AUTH_SIZE) {
-            handle->state = ESP_PRE_ENC_IMG_READ_EXTRA_HEADER;
-            handle->binary_file_read = 0;
-            handle->cache_buf_len = 0;
-        } else {
-            return ESP_ERR_NOT_FINISHED;
-        }
-    /* falls through */
-    case ESP_PRE_ENC_IMG_READ_EXTRA_HEADER: {
-        int temp = curr_index;
-        curr_index += MIN(args->data_in_len - curr_index, RESERVED_HEADER - handle->binary_file_read);
-        handle->binary_file_read += MIN(args->data_in_len - temp, RESERVED_HEADER - handle->binary_file_read);
-        if (handle->binary_file_read == RESERVED_HEADER) {
-            handle->state = ESP_PRE_ENC_DATA_DECODE_STATE;
-            handle->binary_file_read = 0;
-            handle->cache_buf_len = 0;
-        } else {
-            return ESP_ERR_NOT_FINISHED;
-        }
     }
-/* falls through */
-    case ESP_PRE_ENC_DATA_DECODE_STATE:
-        err = process_bin(handle, args, curr_index);
+    if (handle->header_read < HEADER_DATA_SIZE) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    return process_header(handle);
+}
+
+static esp_err_t decrypt_data(esp_encrypted_img_t *handle, pre_enc_decrypt_arg_t *args, bool caller_buf, size_t data_out_size)
+{
+    // Once the header is consumed, the whole input goes to the GCM decryption
+    if (handle->state == ESP_PRE_ENC_DATA_DECODE_STATE) {
+        return process_bin(handle, args, 0, caller_buf, data_out_size);
+    }
+
+    size_t header_len;
+    esp_err_t err = read_header(handle, args, &header_len);
+    if (err != ESP_OK) {
         return err;
     }
-    return ESP_OK;
+    return process_bin(handle, args, header_len, caller_buf, data_out_size);
+}
+
+esp_err_t esp_encrypted_img_decrypt_data(esp_decrypt_handle_t ctx, pre_enc_decrypt_arg_t *args)
+{
+    if (ctx == NULL || args == NULL || args->data_in == NULL) {
+        ESP_LOGE(TAG, "esp_encrypted_img_decrypt_data: Invalid argument");
+        return ESP_ERR_INVALID_ARG;
+    }
+    return decrypt_data((esp_encrypted_img_t *)ctx, args, false, 0);
+}
+
+esp_err_t esp_encrypted_img_decrypt_data_to_buf(esp_decrypt_handle_t ctx, pre_enc_decrypt_arg_t *args, size_t data_out_size)
+{
+    if (ctx == NULL || args == NULL || args->data_in == NULL || args->data_out == NULL) {
+        ESP_LOGE(TAG, "esp_encrypted_img_decrypt_data_to_buf: Invalid argument");
+        return ESP_ERR_INVALID_ARG;
+    }
+    // The header is consumed without any output
+    args->data_out_len = 0;
+    return decrypt_data((esp_encrypted_img_t *)ctx, args, true, data_out_size);
 }
 
 esp_err_t esp_encrypted_img_decrypt_end(esp_decrypt_handle_t ctx)
@@ -1066,17 +994,17 @@ esp_err_t esp_encrypted_img_decrypt_end(esp_decrypt_handle_t ctx)
 
         unsigned char got_auth[AUTH_SIZE] = {0};
 #if (MBEDTLS_VERSION_NUMBER < 0x03000000)
-        err = mbedtls_gcm_finish(&handle->gcm_ctx, got_auth, AUTH_SIZE);
+        err = enc_img_gcm_finish(&handle->gcm_ctx, got_auth, AUTH_SIZE);
 #else
         size_t olen;
-        err = mbedtls_gcm_finish(&handle->gcm_ctx, NULL, 0, &olen, got_auth, AUTH_SIZE);
+        err = enc_img_gcm_finish(&handle->gcm_ctx, NULL, 0, &olen, got_auth, AUTH_SIZE);
 #endif
         if (err != 0) {
             ESP_LOGE(TAG, "Error: %d", err);
             err = ESP_FAIL;
             goto exit;
         }
-        if (memcmp(got_auth, handle->auth_tag, AUTH_SIZE) != 0) {
+        if (memcmp(got_auth, handle->header.auth, AUTH_SIZE) != 0) {
             ESP_LOGE(TAG, "Invalid Auth");
             err = ESP_FAIL;
             goto exit;
@@ -1090,8 +1018,8 @@ esp_err_t esp_encrypted_img_decrypt_end(esp_decrypt_handle_t ctx)
     }
     err = ESP_OK;
 exit:
-    mbedtls_gcm_free(&handle->gcm_ctx);
-    free(handle->cache_buf);
+    enc_img_gcm_free(&handle->gcm_ctx);
+    mbedtls_platform_zeroize(handle->gcm_key, GCM_KEY_SIZE);
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
 #if defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
     esp_ds_deinit_data_ctx();
@@ -1117,8 +1045,8 @@ esp_err_t esp_encrypted_img_decrypt_abort(esp_decrypt_handle_t ctx)
         ESP_LOGE(TAG, "esp_encrypted_img_decrypt_abort: Invalid argument");
         return ESP_ERR_INVALID_ARG;
     }
-    mbedtls_gcm_free(&handle->gcm_ctx);
-    free(handle->cache_buf);
+    enc_img_gcm_free(&handle->gcm_ctx);
+    mbedtls_platform_zeroize(handle->gcm_key, GCM_KEY_SIZE);
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
 #if defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
     esp_ds_deinit_data_ctx();
@@ -1135,3 +1063,103 @@ uint16_t esp_encrypted_img_get_header_size(void)
 {
     return HEADER_DATA_SIZE;
 }
+
+esp_err_t esp_encrypted_img_export_session(esp_decrypt_handle_t ctx, esp_encrypted_img_session_t *session)
+{
+    esp_encrypted_img_t *handle = (esp_encrypted_img_t *)ctx;
+    if (handle == NULL || session == NULL) {
+        ESP_LOGE(TAG, "esp_encrypted_img_export_session: Invalid argument");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->state != ESP_PRE_ENC_DATA_DECODE_STATE) {
+        ESP_LOGE(TAG, "The image header hasn't been processed yet");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(session, 0, sizeof(*session));
+    memcpy(session->header_hash, handle->header_hash, sizeof(session->header_hash));
+    memcpy(session->gcm_key, handle->gcm_key, GCM_KEY_SIZE);
+    session->image_offset = HEADER_DATA_SIZE;
+#if defined(ENC_IMG_GCM_CHECKPOINT)
+    const mbedtls_gcm_context *gcm = &handle->gcm_ctx;
+    session->has_checkpoint = true;
+    session->image_offset += handle->binary_file_read;
+    session->binary_read = handle->binary_file_read;
+    memcpy(session->cache, handle->cache_buf, handle->cache_buf_len);
+    session->cache_len = handle->cache_buf_len;
+    memcpy(session->gcm_counter, gcm->MBEDTLS_PRIVATE(y), sizeof(session->gcm_counter));
+    memcpy(session->gcm_ghash, gcm->MBEDTLS_PRIVATE(buf), sizeof(session->gcm_ghash));
+    session->gcm_len = gcm->MBEDTLS_PRIVATE(len);
+#endif /* ENC_IMG_GCM_CHECKPOINT */
+    return ESP_OK;
+}
+
+esp_err_t esp_encrypted_img_import_session(esp_decrypt_handle_t ctx, const esp_encrypted_img_session_t *session,
+        const char *header, size_t header_len)
+{
+    esp_encrypted_img_t *handle = (esp_encrypted_img_t *)ctx;
+    if (handle == NULL || session == NULL || header == NULL) {
+        ESP_LOGE(TAG, "esp_encrypted_img_import_session: Invalid argument");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (header_len != HEADER_DATA_SIZE) {
+        ESP_LOGE(TAG, "Invalid header size");
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (handle->state != ESP_PRE_ENC_IMG_READ_HEADER || handle->header_read != 0) {
+        ESP_LOGE(TAG, "The session must be imported before any data");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (session->has_checkpoint) {
+#if defined(ENC_IMG_GCM_CHECKPOINT)
+        if (session->cache_len >= CACHE_BUF_SIZE || session->binary_read < session->cache_len ||
+                session->gcm_len != session->binary_read - session->cache_len ||
+                session->image_offset != HEADER_DATA_SIZE + session->binary_read) {
+            ESP_LOGE(TAG, "Invalid session checkpoint");
+            return ESP_ERR_INVALID_ARG;
+        }
+#else
+        ESP_LOGE(TAG, "GCM checkpoints aren't supported with this GCM implementation");
+        return ESP_ERR_INVALID_ARG;
+#endif /* ENC_IMG_GCM_CHECKPOINT */
+    }
+
+    uint8_t hash[ESP_ENCRYPTED_IMG_HEADER_HASH_SIZE];
+    if (enc_img_sha256((const unsigned char *)header, header_len, hash, 0) != 0) {
+        return ESP_FAIL;
+    }
+    if (memcmp(hash, session->header_hash, sizeof(hash)) != 0) {
+        ESP_LOGE(TAG, "The session belongs to another image");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    memcpy(handle->gcm_key, session->gcm_key, GCM_KEY_SIZE);
+    handle->session_key = true;
+    pre_enc_decrypt_arg_t args = {
+        .data_in = header,
+        .data_in_len = header_len,
+    };
+    esp_err_t err = decrypt_data(handle, &args, false, 0);
+    free(args.data_out);
+    if (err != ESP_OK && err != ESP_ERR_NOT_FINISHED) {
+        return ESP_FAIL;
+    }
+
+#if defined(ENC_IMG_GCM_CHECKPOINT)
+    if (session->has_checkpoint) {
+        if (session->binary_read > handle->binary_file_len) {
+            ESP_LOGE(TAG, "Invalid session checkpoint");
+            return ESP_ERR_INVALID_ARG;
+        }
+        mbedtls_gcm_context *gcm = &handle->gcm_ctx;
+        memcpy(gcm->MBEDTLS_PRIVATE(y), session->gcm_counter, sizeof(session->gcm_counter));
+        memcpy(gcm->MBEDTLS_PRIVATE(buf), session->gcm_ghash, sizeof(session->gcm_ghash));
+        gcm->MBEDTLS_PRIVATE(len) = session->gcm_len;
+        memcpy(handle->cache_buf, session->cache, session->cache_len);
+        handle->cache_buf_len = session->cache_len;
+        handle->binary_file_read = session->binary_read;
+    }
+#endif /* ENC_IMG_GCM_CHECKPOINT */
+    ESP_LOGI(TAG, "Session resumed at offset %" PRIu32, session->image_offset);
+    return ESP_OK;
+}
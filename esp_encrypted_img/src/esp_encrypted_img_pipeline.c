@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <esp_log.h>
+#include "esp_encrypted_img_pipeline.h"
+
+static const char *TAG = "esp_encrypted_img_pipeline";
+
+/* A chunk without buffer marks the end of the image */
+typedef struct {
+    char *buf;
+    size_t len;
+} pipeline_chunk_t;
+
+/*
+ * The chunks go round from free_queue to decrypt_queue, to write_queue and back to free_queue. The end of image chunk
+ * goes through the stages in order, each stage task exits once it has forwarded it. After a failure, the stages keep
+ * on forwarding the chunks without processing them, until the end of image chunk.
+ */
+typedef struct {
+    esp_decrypt_handle_t ctx;
+    const esp_encrypted_img_pipeline_config_t *config;
+    size_t buf_size;
+    char *bufs;
+    QueueHandle_t free_queue;
+    QueueHandle_t decrypt_queue;
+    QueueHandle_t write_queue;
+    SemaphoreHandle_t task_done;
+    portMUX_TYPE lock;
+    esp_err_t err;
+    bool complete;
+} pipeline_t;
+
+static void pipeline_set_error(pipeline_t *pipeline, esp_err_t err)
+{
+    portENTER_CRITICAL(&pipeline->lock);
+    if (pipeline->err == ESP_OK) {
+        pipeline->err = err;
+    }
+    portEXIT_CRITICAL(&pipeline->lock);
+}
+
+static esp_err_t pipeline_get_error(pipeline_t *pipeline)
+{
+    portENTER_CRITICAL(&pipeline->lock);
+    esp_err_t err = pipeline->err;
+    portEXIT_CRITICAL(&pipeline->lock);
+    return err;
+}
+
+static void pipeline_decrypt_task(void *arg)
+{
+    pipeline_t *pipeline = (pipeline_t *)arg;
+    pipeline_chunk_t chunk;
+
+    while (xQueueReceive(pipeline->decrypt_queue, &chunk, portMAX_DELAY) == pdTRUE && chunk.buf != NULL) {
+        // Data after the end of the image is dropped
+        if (pipeline_get_error(pipeline) != ESP_OK || pipeline->complete) {
+            xQueueSend(pipeline->free_queue, &chunk, portMAX_DELAY);
+            continue;
+        }
+        pre_enc_decrypt_arg_t args = {
+            .data_in = chunk.buf,
+            .data_in_len = chunk.len,
+            .data_out = chunk.buf,
+        };
+        esp_err_t err = esp_encrypted_img_decrypt_data_to_buf(pipeline->ctx, &args, pipeline->buf_size);
+        if (err == ESP_OK) {
+            pipeline->complete = true;
+        } else if (err != ESP_ERR_NOT_FINISHED) {
+            ESP_LOGE(TAG, "Decryption failed: %s", esp_err_to_name(err));
+            pipeline_set_error(pipeline, ESP_FAIL);
+            args.data_out_len = 0;
+        }
+        if (args.data_out_len > 0) {
+            chunk.len = args.data_out_len;
+            xQueueSend(pipeline->write_queue, &chunk, portMAX_DELAY);
+        } else {
+            xQueueSend(pipeline->free_queue, &chunk, portMAX_DELAY);
+        }
+    }
+    xQueueSend(pipeline->write_queue, &chunk, portMAX_DELAY);
+    xSemaphoreGive(pipeline->task_done);
+    vTaskDelete(NULL);
+}
+
+static void pipeline_write_task(void *arg)
+{
+    pipeline_t *pipeline = (pipeline_t *)arg;
+    pipeline_chunk_t chunk;
+
+    while (xQueueReceive(pipeline->write_queue, &chunk, portMAX_DELAY) == pdTRUE && chunk.buf != NULL) {
+        if (pipeline_get_error(pipeline) == ESP_OK) {
+            esp_err_t err = pipeline->config->write_cb(pipeline->config->user_ctx, chunk.buf, chunk.len);
+            if (err != ESP_OK) {
+                ESP_LOGE(TAG, "Write failed: %s", esp_err_to_name(err));
+                pipeline_set_error(pipeline, err);
+            }
+        }
+        xQueueSend(pipeline->free_queue, &chunk, portMAX_DELAY);
+    }
+    xSemaphoreGive(pipeline->task_done);
+    vTaskDelete(NULL);
+}
+
+/* Fills the chunk as much as possible, the larger the chunks the faster the decryption. Returns false at the end */
+static bool pipeline_read_chunk(pipeline_t *pipeline, pipeline_chunk_t *chunk)
+{
+    const esp_encrypted_img_pipeline_config_t *config = pipeline->config;
+    chunk->len = 0;
+    while (chunk->len < config->chunk_size) {
+        int len = config->read_cb(config->user_ctx, chunk->buf + chunk->len, config->chunk_size - chunk->len);
+        if (len < 0) {
+            ESP_LOGE(TAG, "Read failed: %d", len);
+            pipeline_set_error(pipeline, ESP_FAIL);
+            return false;
+        }
+        if (len == 0) {
+            return false;
+        }
+        chunk->len += len;
+    }
+    return true;
+}
+
+esp_err_t esp_encrypted_img_decrypt_pipeline(esp_decrypt_handle_t ctx, const esp_encrypted_img_pipeline_config_t *config)
+{
+    if (ctx == NULL || config == NULL || config->read_cb == NULL || config->write_cb == NULL ||
+            config->chunk_size == 0 || config->chunk_count < 2) {
+        ESP_LOGE(TAG, "esp_encrypted_img_decrypt_pipeline: Invalid argument");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pipeline_t pipeline = {
+        .ctx = ctx,
+        .config = config,
+        // Room for the partial block carried over by the decryption, aligned for the DMA
+        .buf_size = (config->chunk_size + ESP_ENCRYPTED_IMG_OUT_BUF_EXTRA_SIZE + 15) & ~15,
+        .lock = portMUX_INITIALIZER_UNLOCKED,
+        .err = ESP_OK,
+    };
+    esp_err_t err = ESP_OK;
+    int tasks = 0;
+    pipeline_chunk_t chunk;
+
+    pipeline.bufs = malloc(pipeline.buf_size * config->chunk_count);
+    pipeline.free_queue = xQueueCreate(config->chunk_count, sizeof(pipeline_chunk_t));
+    // One more item for the end of image chunk
+    pipeline.decrypt_queue = xQueueCreate(config->chunk_count + 1, sizeof(pipeline_chunk_t));
+    pipeline.write_queue = xQueueCreate(config->chunk_count + 1, sizeof(pipeline_chunk_t));
+    pipeline.task_done = xSemaphoreCreateCounting(2, 0);
+    if (!pipeline.bufs || !pipeline.free_queue || !pipeline.decrypt_queue || !pipeline.write_queue || !pipeline.task_done) {
+        ESP_LOGE(TAG, "Couldn't allocate memory for the pipeline");
+        err = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+    for (size_t i = 0; i < config->chunk_count; i++) {
+        chunk.buf = pipeline.bufs + i * pipeline.buf_size;
+        chunk.len = 0;
+        xQueueSend(pipeline.free_queue, &chunk, 0);
+    }
+
+    if (xTaskCreatePinnedToCore(pipeline_write_task, "enc_img_write", config->task_stack_size, &pipeline,
+                                config->task_priority, NULL, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGE(TAG, "Couldn't create the writer task");
+        err = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+    tasks++;
+    if (xTaskCreatePinnedToCore(pipeline_decrypt_task, "enc_img_decrypt", config->task_stack_size, &pipeline,
+                                config->task_priority, NULL, config->decrypt_task_core) != pdPASS) {
+        ESP_LOGE(TAG, "Couldn't create the decrypt task");
+        err = ESP_ERR_NO_MEM;
+        // Stop the writer task directly
+        chunk.buf = NULL;
+        xQueueSend(pipeline.write_queue, &chunk, portMAX_DELAY);
+        goto join;
+    }
+    tasks++;
+
+    bool more = true;
+    while (more && pipeline_get_error(&pipeline) == ESP_OK) {
+        xQueueReceive(pipeline.free_queue, &chunk, portMAX_DELAY);
+        more = pipeline_read_chunk(&pipeline, &chunk);
+        if (chunk.len > 0 && pipeline_get_error(&pipeline) == ESP_OK) {
+            xQueueSend(pipeline.decrypt_queue, &chunk, portMAX_DELAY);
+        } else {
+            xQueueSend(pipeline.free_queue, &chunk, portMAX_DELAY);
+        }
+    }
+    chunk.buf = NULL;
+    xQueueSend(pipeline.decrypt_queue, &chunk, portMAX_DELAY);
+
+join:
+    for (int i = 0; i < tasks; i++) {
+        xSemaphoreTake(pipeline.task_done, portMAX_DELAY);
+    }
+    if (err == ESP_OK) {
+        err = pipeline.err;
+    }
+    if (err == ESP_OK && !pipeline.complete) {
+        ESP_LOGE(TAG, "Incomplete image");
+        err = ESP_FAIL;
+    }
+
+cleanup:
+    if (pipeline.task_done) {
+        vSemaphoreDelete(pipeline.task_done);
+    }
+    if (pipeline.write_queue) {
+        vQueueDelete(pipeline.write_queue);
+    }
+    if (pipeline.decrypt_queue) {
+        vQueueDelete(pipeline.decrypt_queue);
+    }
+    if (pipeline.free_queue) {
+        vQueueDelete(pipeline.free_queue);
+    }
+    free(pipeline.bufs);
+    return err;
+}
@@ -13,12 +13,14 @@
 #include "esp_system.h"
 #endif
 #include "esp_encrypted_img.h"
+#include "esp_encrypted_img_pipeline.h"
 #include "sdkconfig.h"
 #if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES) || \
     (defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS))
 #include "test_mocks.h"
 #endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_ECIES */
 #include <string.h>
+#include <sys/param.h>
 
 #ifdef CONFIG_HEAP_TRACING
 #include <esp_heap_trace.h>
@@ -121,12 +123,15 @@ TEST_CASE("test_rsa_ds_decrypt_v15_padding", "[encrypted_img]")
     cfg.ds_data = ds_data;
 
     // Prepare input data: magic + Encrypted GCM key + IV + Binary Size + Auth Tag + Reserved
-    size_t input_data_len = MAGIC_SIZE + ENC_GCM_KEY_SIZE;
-    uint8_t *input_data = (uint8_t *)malloc(input_data_len);
+    // The key is deciphered once the whole header is received
+    size_t input_data_len = esp_encrypted_img_get_header_size();
+    uint8_t *input_data = (uint8_t *)calloc(1, input_data_len);
     TEST_ASSERT_NOT_NULL(input_data);
     uint32_t magic = 0x0788b6cf; // esp_enc_img_magic
+    uint32_t bin_size = 16;
     memcpy(input_data, &magic, MAGIC_SIZE);
     memcpy(input_data + MAGIC_SIZE, encrypted_gcm_key_bin, ENC_GCM_KEY_SIZE); // Encrypted GCM key
+    memcpy(input_data + MAGIC_SIZE + ENC_GCM_KEY_SIZE + IV_SIZE, &bin_size, BIN_SIZE_DATA);
 
     esp_decrypt_handle_t decrypt_ctx = esp_encrypted_img_decrypt_start(&cfg);
     TEST_ASSERT_NOT_NULL(decrypt_ctx);
@@ -478,6 +483,254 @@ TEST_CASE("Sending random size data at once", "[encrypted_img]")
 #endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA && CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
 }
 
+TEST_CASE("Decrypting in place into a caller buffer", "[encrypted_img]")
+{
+    esp_err_t err;
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
+    esp_decrypt_cfg_t cfg = {0};
+#if defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_ds_data_ctx_t *ds_data = esp_secure_cert_get_ds_ctx();
+    if (ds_data == NULL) {
+        printf("Failed to get DS context\n");
+        vTaskDelete(NULL);
+    }
+    cfg.ds_data = ds_data;
+#else
+    cfg.rsa_priv_key = (char *)rsa_private_pem_start;
+    cfg.rsa_priv_key_len = rsa_private_pem_end - rsa_private_pem_start;
+#endif /* CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+#else
+    esp_decrypt_cfg_t cfg = {0};
+    cfg.hmac_key_id = 2;
+#endif
+    const size_t bin_len = bin_end - bin_start;
+
+    // Reference output, all data at once
+    esp_decrypt_handle_t ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    pre_enc_decrypt_arg_t args = {
+        .data_in = (char *)bin_start,
+        .data_in_len = bin_len,
+    };
+    err = esp_encrypted_img_decrypt_data(ctx, &args);
+    TEST_ESP_OK(err);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    char *expected = args.data_out;
+    const size_t expected_len = args.data_out_len;
+    TEST_ASSERT_NOT_NULL(expected);
+
+    // Random chunk sizes leave partial blocks behind, which are carried over to the next chunk
+    const size_t chunk_max = 100;
+    char *buf = malloc(chunk_max + ESP_ENCRYPTED_IMG_OUT_BUF_EXTRA_SIZE);
+    char *out = malloc(expected_len);
+    TEST_ASSERT_NOT_NULL(buf);
+    TEST_ASSERT_NOT_NULL(out);
+    ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    size_t i = 0;
+    size_t out_len = 0;
+    do {
+        size_t x = MIN((esp_random() % chunk_max) + 1, bin_len - i);
+        memcpy(buf, bin_start + i, x);
+        i += x;
+        args.data_in = buf;
+        args.data_in_len = x;
+        args.data_out = buf;
+        err = esp_encrypted_img_decrypt_data_to_buf(ctx, &args, chunk_max + ESP_ENCRYPTED_IMG_OUT_BUF_EXTRA_SIZE);
+        if (err == ESP_ERR_NOT_FINISHED || err == ESP_OK) {
+            TEST_ASSERT_TRUE(args.data_out == buf);
+            TEST_ASSERT_LESS_OR_EQUAL(expected_len, out_len + args.data_out_len);
+            memcpy(out + out_len, args.data_out, args.data_out_len);
+            out_len += args.data_out_len;
+        }
+    } while (err == ESP_ERR_NOT_FINISHED);
+    TEST_ESP_OK(err);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    TEST_ASSERT_EQUAL(expected_len, out_len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, expected_len);
+
+    free(out);
+    free(buf);
+    free(expected);
+#if defined (CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_secure_cert_free_ds_ctx(cfg.ds_data);
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA && CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+}
+
+typedef struct {
+    size_t read_off;
+    char *out;
+    size_t out_len;
+    size_t out_size;
+} pipeline_test_ctx_t;
+
+static int pipeline_test_read(void *user_ctx, char *buf, size_t size)
+{
+    pipeline_test_ctx_t *test = (pipeline_test_ctx_t *)user_ctx;
+    size_t x = MIN(MIN((esp_random() % 700) + 1, size), (size_t)(bin_end - bin_start) - test->read_off);
+    memcpy(buf, bin_start + test->read_off, x);
+    test->read_off += x;
+    return x;
+}
+
+static esp_err_t pipeline_test_write(void *user_ctx, const char *data, size_t len)
+{
+    pipeline_test_ctx_t *test = (pipeline_test_ctx_t *)user_ctx;
+    if (test->out_len + len > test->out_size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(test->out + test->out_len, data, len);
+    test->out_len += len;
+    return ESP_OK;
+}
+
+TEST_CASE("Decrypting through the pipeline", "[encrypted_img]")
+{
+    esp_err_t err;
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
+    esp_decrypt_cfg_t cfg = {0};
+#if defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_ds_data_ctx_t *ds_data = esp_secure_cert_get_ds_ctx();
+    if (ds_data == NULL) {
+        printf("Failed to get DS context\n");
+        vTaskDelete(NULL);
+    }
+    cfg.ds_data = ds_data;
+#else
+    cfg.rsa_priv_key = (char *)rsa_private_pem_start;
+    cfg.rsa_priv_key_len = rsa_private_pem_end - rsa_private_pem_start;
+#endif /* CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+#else
+    esp_decrypt_cfg_t cfg = {0};
+    cfg.hmac_key_id = 2;
+#endif
+    // Reference output, all data at once
+    esp_decrypt_handle_t ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    pre_enc_decrypt_arg_t args = {
+        .data_in = (char *)bin_start,
+        .data_in_len = bin_end - bin_start,
+    };
+    err = esp_encrypted_img_decrypt_data(ctx, &args);
+    TEST_ESP_OK(err);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    TEST_ASSERT_NOT_NULL(args.data_out);
+
+    pipeline_test_ctx_t test = {
+        .out = malloc(args.data_out_len),
+        .out_size = args.data_out_len,
+    };
+    TEST_ASSERT_NOT_NULL(test.out);
+    esp_encrypted_img_pipeline_config_t pipeline_cfg = ESP_ENCRYPTED_IMG_PIPELINE_CONFIG_DEFAULT();
+    pipeline_cfg.read_cb = pipeline_test_read;
+    pipeline_cfg.write_cb = pipeline_test_write;
+    pipeline_cfg.user_ctx = &test;
+    pipeline_cfg.chunk_size = 1024;
+    ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    err = esp_encrypted_img_decrypt_pipeline(ctx, &pipeline_cfg);
+    TEST_ESP_OK(err);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    TEST_ASSERT_EQUAL(args.data_out_len, test.out_len);
+    TEST_ASSERT_EQUAL_MEMORY(args.data_out, test.out, test.out_len);
+
+    free(test.out);
+    free(args.data_out);
+#if defined (CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_secure_cert_free_ds_ctx(cfg.ds_data);
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA && CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+}
+
+TEST_CASE("Resuming a decryption from a session", "[encrypted_img]")
+{
+    esp_err_t err;
+#if defined(CONFIG_PRE_ENCRYPTED_OTA_USE_RSA)
+    esp_decrypt_cfg_t cfg = {0};
+#if defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_ds_data_ctx_t *ds_data = esp_secure_cert_get_ds_ctx();
+    if (ds_data == NULL) {
+        printf("Failed to get DS context\n");
+        vTaskDelete(NULL);
+    }
+    cfg.ds_data = ds_data;
+#else
+    cfg.rsa_priv_key = (char *)rsa_private_pem_start;
+    cfg.rsa_priv_key_len = rsa_private_pem_end - rsa_private_pem_start;
+#endif /* CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+#else
+    esp_decrypt_cfg_t cfg = {0};
+    cfg.hmac_key_id = 2;
+#endif
+    const size_t bin_len = bin_end - bin_start;
+    const size_t header_len = esp_encrypted_img_get_header_size();
+
+    // Reference output, all data at once
+    esp_decrypt_handle_t ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    pre_enc_decrypt_arg_t args = {
+        .data_in = (char *)bin_start,
+        .data_in_len = bin_len,
+    };
+    err = esp_encrypted_img_decrypt_data(ctx, &args);
+    TEST_ESP_OK(err);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    char *expected = args.data_out;
+    const size_t expected_len = args.data_out_len;
+    TEST_ASSERT_NOT_NULL(expected);
+
+    // Interrupted after a partial block
+    const size_t stop = header_len + (expected_len / 2) + 5;
+    char *out = malloc(expected_len);
+    TEST_ASSERT_NOT_NULL(out);
+    esp_encrypted_img_session_t session;
+    ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_encrypted_img_export_session(ctx, &session));
+    args.data_in = (char *)bin_start;
+    args.data_in_len = stop;
+    args.data_out = NULL;
+    err = esp_encrypted_img_decrypt_data(ctx, &args);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, err);
+    memcpy(out, args.data_out, args.data_out_len);
+    free(args.data_out);
+    TEST_ESP_OK(esp_encrypted_img_export_session(ctx, &session));
+    TEST_ESP_OK(esp_encrypted_img_decrypt_abort(ctx));
+    // Without a checkpoint, the session only saves the key unwrapping and the binary starts over
+    size_t out_len = session.gcm_len;
+    TEST_ASSERT_EQUAL(session.has_checkpoint ? stop : header_len, session.image_offset);
+
+    // Another image header is refused
+    char *header = malloc(header_len);
+    TEST_ASSERT_NOT_NULL(header);
+    memcpy(header, bin_start, header_len);
+    header[header_len - 1] ^= 1;
+    ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, esp_encrypted_img_import_session(ctx, &session, header, header_len));
+    TEST_ESP_OK(esp_encrypted_img_decrypt_abort(ctx));
+
+    ctx = esp_encrypted_img_decrypt_start(&cfg);
+    TEST_ASSERT_NOT_NULL(ctx);
+    TEST_ESP_OK(esp_encrypted_img_import_session(ctx, &session, (const char *)bin_start, header_len));
+    args.data_in = (char *)bin_start + session.image_offset;
+    args.data_in_len = bin_len - session.image_offset;
+    args.data_out = NULL;
+    err = esp_encrypted_img_decrypt_data(ctx, &args);
+    TEST_ESP_OK(err);
+    TEST_ASSERT_EQUAL(expected_len, out_len + args.data_out_len);
+    memcpy(out + out_len, args.data_out, args.data_out_len);
+    free(args.data_out);
+    TEST_ESP_OK(esp_encrypted_img_decrypt_end(ctx));
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, expected_len);
+
+    free(header);
+    free(out);
+    free(expected);
+#if defined (CONFIG_PRE_ENCRYPTED_OTA_USE_RSA) && defined(CONFIG_PRE_ENCRYPTED_RSA_USE_DS)
+    esp_secure_cert_free_ds_ctx(cfg.ds_data);
+#endif /* CONFIG_PRE_ENCRYPTED_OTA_USE_RSA && CONFIG_PRE_ENCRYPTED_RSA_USE_DS */
+}
+
 TEST_CASE("Sending incomplete data", "[encrypted_img]")
 {
     esp_err_t err;
@@ -600,16 +853,18 @@ TEST_CASE("test_ecc_key_derivation", "[encrypted_img]")
     pre_enc_decrypt_arg_t *args = (pre_enc_decrypt_arg_t *)calloc(1, sizeof(pre_enc_decrypt_arg_t));
     TEST_ASSERT_NOT_NULL(args);
 
-    // Prepare input data: magic + ECC header (server_pub_key + kdf_salt_from_header + reserved)
-    size_t input_data_len = MAGIC_SIZE + SERVER_ECC_KEY_LEN + KDF_SALT_SIZE + RESERVED_SIZE;
-    uint8_t *input_data = (uint8_t *)malloc(input_data_len);
+    // Prepare input data: magic + ECC header (server_pub_key + kdf_salt_from_header + reserved) + IV + Binary Size
+    // + Auth Tag + Reserved, as the key is derived once the whole header is received
+    size_t input_data_len = esp_encrypted_img_get_header_size();
+    uint8_t *input_data = (uint8_t *)calloc(1, input_data_len);
     TEST_ASSERT_NOT_NULL(input_data);
 
     uint32_t magic = 0x0788b6cf; // esp_enc_img_magic
+    uint32_t bin_size = 16;
     memcpy(input_data, &magic, MAGIC_SIZE);
     memcpy(input_data + MAGIC_SIZE, server_pub, SERVER_ECC_KEY_LEN); // Dummy server_pub_key from header
     memcpy(input_data + MAGIC_SIZE + SERVER_ECC_KEY_LEN, kdf_salt, KDF_SALT_SIZE); // Dummy kdf_salt from header
-    memset(input_data + MAGIC_SIZE + SERVER_ECC_KEY_LEN + KDF_SALT_SIZE, 0x00, RESERVED_SIZE); // Dummy reserved data
+    memcpy(input_data + MAGIC_SIZE + ENC_GCM_KEY_SIZE + IV_SIZE, &bin_size, BIN_SIZE_DATA);
 
     args->data_in = (char *)input_data;
     args->data_in_len = input_data_len;
@@ -617,12 +872,12 @@ TEST_CASE("test_ecc_key_derivation", "[encrypted_img]")
     args->data_out_len = 0;
 
     // --- Execute ---
-    // This call will trigger reading magic, then ECC header.
+    // This call will trigger reading the header, then parsing it.
     // derive_gcm_key -> derive_ota_ecc_device_key -> compute_ecc_key_with_hmac -> esp_encrypted_img_pbkdf2_hmac_sha256
     esp_err_t err = esp_encrypted_img_decrypt_data(decrypt_ctx, args);
 
     // --- Assert ---
-    // After processing the header, it expects more data (IV, etc.), so it should return ESP_ERR_NOT_FINISHED.
+    // After processing the header, it expects the binary, so it should return ESP_ERR_NOT_FINISHED.
     TEST_ESP_ERR(ESP_ERR_NOT_FINISHED, err);
 
     esp_encrypted_img_decrypt_abort(decrypt_ctx); // Use abort as we didn't provide full data
@@ -7,6 +7,10 @@
 // This module implements runtime file I/O API for GCOV.
 
 #include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <sys/param.h>
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_app_trace.h"
@@ -24,6 +28,297 @@ static volatile bool s_gcov_task_running = false;
 extern void __gcov_dump(void);
 extern void __gcov_reset(void);
 
+/*
+ * Buffer of the stream being read or written, allocated by the dump task. libgcov reads and writes a word at a time,
+ * each apptrace call being a round trip to the host.
+ */
+typedef struct {
+    void *stream;
+    char *buf;
+    size_t len;                             // bytes to write, or bytes read ahead
+    size_t pos;                             // bytes of the read ahead ones already returned
+    bool reading;
+    bool err;
+} gcov_rtio_buf_t;
+
+static gcov_rtio_buf_t s_buf;
+
+#if CONFIG_ESP_GCOV_INCREMENTAL_DUMP || CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+/*
+ * Layout of the coverage data emitted by GCC, see libgcov.h of the GCC sources. The counter types are listed by
+ * gcov-counter.def, from the headers of the GCC plugins.
+ */
+#if !__has_include("gcov-counter.def")
+#error "CONFIG_ESP_GCOV_INCREMENTAL_DUMP and CONFIG_ESP_GCOV_SNAPSHOT_DUMP need gcov-counter.def from the headers of the GCC plugins"
+#endif
+
+enum {
+#define DEF_GCOV_COUNTER(COUNTER, NAME, MERGE_FN) COUNTER,
+#include "gcov-counter.def"
+#undef DEF_GCOV_COUNTER
+    GCOV_COUNTERS
+};
+
+typedef int64_t gcov_rtio_type_t;
+
+typedef struct {
+    uint32_t num;
+    gcov_rtio_type_t *values;
+} gcov_rtio_ctr_info_t;
+
+struct gcov_rtio_info;
+
+typedef struct {
+    const struct gcov_rtio_info *key;
+    uint32_t ident;
+    uint32_t lineno_checksum;
+    uint32_t cfg_checksum;
+    gcov_rtio_ctr_info_t ctrs[1];           // one for each merge function of the object
+} gcov_rtio_fn_info_t;
+
+typedef struct gcov_rtio_info {
+    uint32_t version;
+    struct gcov_rtio_info *next;
+    uint32_t stamp;
+    uint32_t checksum;
+    const char *filename;
+    void (*merge[GCOV_COUNTERS])(gcov_rtio_type_t *, uint32_t);
+    uint32_t n_functions;
+    const gcov_rtio_fn_info_t *const *functions;
+} gcov_rtio_info_t;
+
+/* Objects dumped by __gcov_dump(), only its first member is used */
+extern struct {
+    gcov_rtio_info_t *list;
+} __gcov_root;
+
+/* Returns the data of a function, NULL for the functions removed by the optimizations */
+static const gcov_rtio_fn_info_t *gcov_fn_info(const gcov_rtio_info_t *info, uint32_t f)
+{
+    const gcov_rtio_fn_info_t *fn = info->functions[f];
+    return fn != NULL && fn->key == info ? fn : NULL;
+}
+
+static int gcov_ctr_num(const gcov_rtio_info_t *info)
+{
+    int num = 0;
+    for (int t = 0; t < GCOV_COUNTERS; t++) {
+        if (info->merge[t] != NULL) {
+            num++;
+        }
+    }
+    return num;
+}
+#endif // CONFIG_ESP_GCOV_INCREMENTAL_DUMP || CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+
+#if CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+/*
+ * Copy of the objects of libgcov pointing to a copy of their counters. Once the counters are copied, libgcov dumps the
+ * copy while the application keeps on running and counting. libgcov only accesses the gcov_info part.
+ */
+typedef struct {
+    gcov_rtio_info_t info;
+    const gcov_rtio_info_t *live;
+} gcov_rtio_snapshot_t;
+
+#define GCOV_RTIO_ALIGN(size)   (((size) + 7) & ~7)
+
+static gcov_rtio_info_t *s_snapshot_list;
+static portMUX_TYPE s_snapshot_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static size_t gcov_fn_info_size(const gcov_rtio_info_t *info)
+{
+    return GCOV_RTIO_ALIGN(offsetof(gcov_rtio_fn_info_t, ctrs) + gcov_ctr_num(info) * sizeof(gcov_rtio_ctr_info_t));
+}
+
+/* Allocates the copy of the objects once, their number and counters don't change after __gcov_init() */
+static esp_err_t gcov_snapshot_alloc(void)
+{
+    if (s_snapshot_list != NULL) {
+        return ESP_OK;
+    }
+
+    size_t size = 0;
+    for (const gcov_rtio_info_t *info = __gcov_root.list; info != NULL; info = info->next) {
+        size += GCOV_RTIO_ALIGN(sizeof(gcov_rtio_snapshot_t)) + GCOV_RTIO_ALIGN(info->n_functions * sizeof(void *));
+        int ctr_num = gcov_ctr_num(info);
+        for (uint32_t f = 0; f < info->n_functions; f++) {
+            const gcov_rtio_fn_info_t *fn = gcov_fn_info(info, f);
+            if (fn == NULL) {
+                continue;
+            }
+            size += gcov_fn_info_size(info);
+            for (int c = 0; c < ctr_num; c++) {
+                size += fn->ctrs[c].num * sizeof(gcov_rtio_type_t);
+            }
+        }
+    }
+    ESP_EARLY_LOGV(TAG, "Alloc snapshot %u bytes", size);
+    char *mem = calloc(1, size);
+    if (mem == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    gcov_rtio_info_t **tail = &s_snapshot_list;
+    for (const gcov_rtio_info_t *info = __gcov_root.list; info != NULL; info = info->next) {
+        gcov_rtio_snapshot_t *snapshot = (gcov_rtio_snapshot_t *)mem;
+        mem += GCOV_RTIO_ALIGN(sizeof(gcov_rtio_snapshot_t));
+        const gcov_rtio_fn_info_t **functions = (const gcov_rtio_fn_info_t **)mem;
+        mem += GCOV_RTIO_ALIGN(info->n_functions * sizeof(void *));
+        snapshot->info = *info;
+        snapshot->info.functions = functions;
+        snapshot->live = info;
+        int ctr_num = gcov_ctr_num(info);
+        for (uint32_t f = 0; f < info->n_functions; f++) {
+            const gcov_rtio_fn_info_t *fn = gcov_fn_info(info, f);
+            if (fn == NULL) {
+                continue;
+            }
+            gcov_rtio_fn_info_t *copy = (gcov_rtio_fn_info_t *)mem;
+            mem += gcov_fn_info_size(info);
+            memcpy(copy, fn, offsetof(gcov_rtio_fn_info_t, ctrs));
+            copy->key = &snapshot->info;
+            for (int c = 0; c < ctr_num; c++) {
+                copy->ctrs[c].num = fn->ctrs[c].num;
+                copy->ctrs[c].values = (gcov_rtio_type_t *)mem;
+                mem += fn->ctrs[c].num * sizeof(gcov_rtio_type_t);
+            }
+            functions[f] = copy;
+        }
+        *tail = &snapshot->info;
+        tail = &snapshot->info.next;
+    }
+    *tail = NULL;
+    return ESP_OK;
+}
+
+/*
+ * Moves the counters to the copy, the live ones restart from zero as after __gcov_reset(). The interrupts of this core
+ * are disabled for the time of the copy, the other core keeps on running: its increments racing with the copy of a
+ * counter can be lost, as the increments of the code compiled with coverage aren't atomic anyway.
+ */
+static void gcov_snapshot_take(void)
+{
+    portENTER_CRITICAL(&s_snapshot_lock);
+    for (gcov_rtio_info_t *info = s_snapshot_list; info != NULL; info = info->next) {
+        const gcov_rtio_info_t *live = ((gcov_rtio_snapshot_t *)info)->live;
+        int ctr_num = gcov_ctr_num(live);
+        for (uint32_t f = 0; f < live->n_functions; f++) {
+            const gcov_rtio_fn_info_t *fn = gcov_fn_info(live, f);
+            if (fn == NULL) {
+                continue;
+            }
+            for (int c = 0; c < ctr_num; c++) {
+                size_t size = fn->ctrs[c].num * sizeof(gcov_rtio_type_t);
+                memcpy(info->functions[f]->ctrs[c].values, fn->ctrs[c].values, size);
+                memset(fn->ctrs[c].values, 0, size);
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_snapshot_lock);
+}
+#endif // CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+
+#if CONFIG_ESP_GCOV_INCREMENTAL_DUMP
+/* The objects have been dumped once, the next dumps can skip the unchanged ones */
+static bool s_dumped_once = false;
+
+static bool gcov_info_changed(const gcov_rtio_info_t *info)
+{
+    int ctr_num = gcov_ctr_num(info);
+    for (uint32_t f = 0; f < info->n_functions; f++) {
+        const gcov_rtio_fn_info_t *fn = gcov_fn_info(info, f);
+        if (fn == NULL) {
+            continue;
+        }
+        for (int c = 0; c < ctr_num; c++) {
+            for (uint32_t i = 0; i < fn->ctrs[c].num; i++) {
+                if (fn->ctrs[c].values[i] != 0) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * The counters are reset after each dump, so the objects whose counters are all zero haven't run since the previous
+ * dump, and merging them wouldn't change their .gcda file. They are unlinked from the list of libgcov for the dump.
+ */
+static void gcov_dump_changed(void)
+{
+    if (!s_dumped_once) {
+        // Each object needs a .gcda file, even if it never ran
+        __gcov_dump();
+        s_dumped_once = true;
+        return;
+    }
+
+    gcov_rtio_info_t *changed = NULL, **changed_tail = &changed;
+    gcov_rtio_info_t *unchanged = NULL, **unchanged_tail = &unchanged;
+    int changed_num = 0, unchanged_num = 0;
+    for (gcov_rtio_info_t *info = __gcov_root.list; info != NULL; info = info->next) {
+        if (gcov_info_changed(info)) {
+            *changed_tail = info;
+            changed_tail = &info->next;
+            changed_num++;
+        } else {
+            *unchanged_tail = info;
+            unchanged_tail = &info->next;
+            unchanged_num++;
+        }
+    }
+    *changed_tail = NULL;
+    *unchanged_tail = NULL;
+    ESP_EARLY_LOGV(TAG, "Dump %d changed objects, skip %d", changed_num, unchanged_num);
+
+    if (changed != NULL) {
+        __gcov_root.list = changed;
+        __gcov_dump();
+    }
+    // Restore the list for the next dumps and for __gcov_reset()
+    *changed_tail = unchanged;
+    __gcov_root.list = changed != NULL ? changed : unchanged;
+}
+#endif // CONFIG_ESP_GCOV_INCREMENTAL_DUMP
+
+/* Writes the buffered data, or moves the file position back to the data actually read */
+static int gcov_rtio_flush(void *stream)
+{
+    if (s_buf.stream != stream || s_buf.len == 0) {
+        return 0;
+    }
+    if (s_buf.reading) {
+        if (s_buf.pos < s_buf.len &&
+                esp_apptrace_fseek(ESP_APPTRACE_DEST_JTAG, stream, -(long)(s_buf.len - s_buf.pos), SEEK_CUR) != 0) {
+            ESP_EARLY_LOGE(TAG, "Failed to seek back %u bytes!", s_buf.len - s_buf.pos);
+            s_buf.err = true;
+        }
+    } else if (esp_apptrace_fwrite(ESP_APPTRACE_DEST_JTAG, s_buf.buf, 1, s_buf.len, stream) != s_buf.len) {
+        ESP_EARLY_LOGE(TAG, "Failed to write %u bytes!", s_buf.len);
+        s_buf.err = true;
+    }
+    s_buf.len = 0;
+    s_buf.pos = 0;
+    return s_buf.err ? EOF : 0;
+}
+
+/* Makes the buffer hold the data of the stream, in the given direction */
+static int gcov_rtio_buf_use(void *stream, bool reading)
+{
+    if (s_buf.stream != stream) {
+        // libgcov handles a file at a time, the previous one should have been closed
+        gcov_rtio_flush(s_buf.stream);
+        s_buf.stream = stream;
+        s_buf.err = false;
+    } else if (s_buf.reading != reading && gcov_rtio_flush(stream) != 0) {
+        return EOF;
+    }
+    s_buf.reading = reading;
+    return s_buf.err ? EOF : 0;
+}
+
 void gcov_dump_task(void *pvParameter)
 {
     int dump_result = 0;
@@ -31,6 +326,16 @@ void gcov_dump_task(void *pvParameter)
 
     ESP_EARLY_LOGV(TAG, "%s stack use in %d", __FUNCTION__, uxTaskGetStackHighWaterMark(NULL));
 
+#if CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+    // Take the snapshot as soon as the dump is requested
+    dump_result = gcov_snapshot_alloc();
+    if (dump_result != ESP_OK) {
+        ESP_EARLY_LOGE(TAG, "Could not allocate memory for the snapshot");
+        goto gcov_exit;
+    }
+    gcov_snapshot_take();
+#endif
+
     ESP_EARLY_LOGV(TAG, "Alloc apptrace down buf %d bytes", ESP_GCOV_DOWN_BUF_SIZE);
     void *down_buf = malloc(ESP_GCOV_DOWN_BUF_SIZE);
     if (down_buf == NULL) {
@@ -45,10 +350,34 @@ void gcov_dump_task(void *pvParameter)
         dump_result = res;
         goto gcov_exit;
     }
+#if CONFIG_ESP_GCOV_IO_BUF_SIZE > 0
+    // Without the buffer, the data is read and written directly, only slower
+    s_buf.buf = malloc(CONFIG_ESP_GCOV_IO_BUF_SIZE);
+    s_buf.len = 0;
+    s_buf.pos = 0;
+    s_buf.stream = NULL;
+    s_buf.err = false;
+#endif
     ESP_EARLY_LOGV(TAG, "Dump data...");
+#if CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+    // libgcov dumps and resets the copy, the live counters have been reset by the snapshot
+    gcov_rtio_info_t *live_list = __gcov_root.list;
+    __gcov_root.list = s_snapshot_list;
+#endif
+#if CONFIG_ESP_GCOV_INCREMENTAL_DUMP
+    gcov_dump_changed();
+#else
     __gcov_dump();
+#endif
     // reset dump status to allow incremental data accumulation
     __gcov_reset();
+#if CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+    // The incremental dump may have reordered the list
+    s_snapshot_list = __gcov_root.list;
+    __gcov_root.list = live_list;
+#endif
+    free(s_buf.buf);
+    s_buf.buf = NULL;
     free(down_buf);
     ESP_EARLY_LOGV(TAG, "Finish file transfer session");
     dump_result = esp_apptrace_fstop(ESP_APPTRACE_DEST_JTAG);
@@ -70,8 +399,14 @@ gcov_exit:
 void gcov_create_task(void *arg)
 {
     ESP_EARLY_LOGV(TAG, "%s", __FUNCTION__);
+#if CONFIG_ESP_GCOV_SNAPSHOT_DUMP
+    // The snapshot is dumped in the background, on any core
+    xTaskCreatePinnedToCore(&gcov_dump_task, "gcov_dump_task", CONFIG_ESP_GCOV_DUMP_TASK_STACK_SIZE,
+                            (void *)&s_gcov_task_running, CONFIG_ESP_GCOV_DUMP_TASK_PRIORITY, NULL, tskNO_AFFINITY);
+#else
     xTaskCreatePinnedToCore(&gcov_dump_task, "gcov_dump_task", CONFIG_ESP_GCOV_DUMP_TASK_STACK_SIZE,
                             (void *)&s_gcov_task_running, configMAX_PRIORITIES - 1, NULL, 0);
+#endif
 }
 
 static IRAM_ATTR
@@ -140,25 +475,79 @@ void *gcov_rtio_fopen(const char *path, const char *mode)
 int gcov_rtio_fclose(void *stream)
 {
     ESP_EARLY_LOGV(TAG, "%s", __FUNCTION__);
-    return esp_apptrace_fclose(ESP_APPTRACE_DEST_JTAG, stream);
+    int ret = gcov_rtio_flush(stream);
+    if (s_buf.stream == stream) {
+        s_buf.stream = NULL;
+        s_buf.err = false;
+    }
+    if (esp_apptrace_fclose(ESP_APPTRACE_DEST_JTAG, stream) != 0) {
+        ret = EOF;
+    }
+    return ret;
 }
 
 size_t gcov_rtio_fread(void *ptr, size_t size, size_t nmemb, void *stream)
 {
     ESP_EARLY_LOGV(TAG, "%s read %u", __FUNCTION__, size * nmemb);
-    size_t sz = esp_apptrace_fread(ESP_APPTRACE_DEST_JTAG, ptr, size, nmemb, stream);
-    ESP_EARLY_LOGV(TAG, "%s actually read %u", __FUNCTION__, sz);
-    return sz;
+    if (s_buf.buf == NULL || size == 0) {
+        size_t sz = esp_apptrace_fread(ESP_APPTRACE_DEST_JTAG, ptr, size, nmemb, stream);
+        ESP_EARLY_LOGV(TAG, "%s actually read %u", __FUNCTION__, sz);
+        return sz;
+    }
+    if (gcov_rtio_buf_use(stream, true) != 0) {
+        return 0;
+    }
+    size_t len = size * nmemb;
+    size_t done = 0;
+    while (done < len) {
+        if (s_buf.pos == s_buf.len) {
+            // Large reads go directly to the caller
+            if (len - done >= CONFIG_ESP_GCOV_IO_BUF_SIZE) {
+                done += esp_apptrace_fread(ESP_APPTRACE_DEST_JTAG, (char *)ptr + done, 1, len - done, stream);
+                break;
+            }
+            s_buf.pos = 0;
+            s_buf.len = esp_apptrace_fread(ESP_APPTRACE_DEST_JTAG, s_buf.buf, 1, CONFIG_ESP_GCOV_IO_BUF_SIZE, stream);
+            if (s_buf.len == 0) {
+                break;
+            }
+        }
+        size_t n = MIN(len - done, s_buf.len - s_buf.pos);
+        memcpy((char *)ptr + done, s_buf.buf + s_buf.pos, n);
+        s_buf.pos += n;
+        done += n;
+    }
+    ESP_EARLY_LOGV(TAG, "%s actually read %u", __FUNCTION__, done);
+    return done / size;
 }
 
 size_t gcov_rtio_fwrite(const void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    ESP_EARLY_LOGV(TAG, "%s", __FUNCTION__);
-    return esp_apptrace_fwrite(ESP_APPTRACE_DEST_JTAG, ptr, size, nmemb, stream);
+    size_t len = size * nmemb;
+    ESP_EARLY_LOGV(TAG, "%s %u", __FUNCTION__, len);
+    if (s_buf.buf == NULL) {
+        return esp_apptrace_fwrite(ESP_APPTRACE_DEST_JTAG, ptr, size, nmemb, stream);
+    }
+    if (gcov_rtio_buf_use(stream, false) != 0) {
+        return 0;
+    }
+    if (s_buf.len + len > CONFIG_ESP_GCOV_IO_BUF_SIZE && gcov_rtio_flush(stream) != 0) {
+        return 0;
+    }
+    // Large writes go directly to the host
+    if (len >= CONFIG_ESP_GCOV_IO_BUF_SIZE) {
+        return esp_apptrace_fwrite(ESP_APPTRACE_DEST_JTAG, ptr, size, nmemb, stream);
+    }
+    memcpy(s_buf.buf + s_buf.len, ptr, len);
+    s_buf.len += len;
+    return nmemb;
 }
 
 int gcov_rtio_fseek(void *stream, long offset, int whence)
 {
+    if (gcov_rtio_flush(stream) != 0) {
+        return -1;
+    }
     int ret = esp_apptrace_fseek(ESP_APPTRACE_DEST_JTAG, stream, offset, whence);
     ESP_EARLY_LOGV(TAG, "%s(%p %ld %d) = %d", __FUNCTION__, stream, offset, whence, ret);
     return ret;
@@ -167,12 +556,20 @@ int gcov_rtio_fseek(void *stream, long offset, int whence)
 long gcov_rtio_ftell(void *stream)
 {
     long ret = esp_apptrace_ftell(ESP_APPTRACE_DEST_JTAG, stream);
+    // the buffered data is not written yet, or not returned yet
+    if (ret >= 0 && s_buf.stream == stream) {
+        ret = s_buf.reading ? ret - (long)(s_buf.len - s_buf.pos) : ret + (long)s_buf.len;
+    }
     ESP_EARLY_LOGV(TAG, "%s(%p) = %ld", __FUNCTION__, stream, ret);
     return ret;
 }
 
 int gcov_rtio_feof(void *stream)
 {
+    // the end of the file may have been reached by reading ahead
+    if (s_buf.stream == stream && s_buf.reading && s_buf.pos < s_buf.len) {
+        return 0;
+    }
     int ret = esp_apptrace_feof(ESP_APPTRACE_DEST_JTAG, stream);
     ESP_EARLY_LOGV(TAG, "%s(%p) = %d", __FUNCTION__, stream, ret);
     return ret;
@@ -0,0 +1,217 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_twai.h"
+#include "esp_twai_onchip.h"
+#include "esp_isotp.h"
+
+/*
+ * Measures the ISO-TP throughput between two links of one multiplexer, on a TWAI node in self-test loopback mode:
+ * every frame sent by one link is received by the node and dispatched to the other link. No transceiver is needed.
+ * Every result is printed as one CSV line starting with "ISOTPBENCH,":
+ *
+ *     ISOTPBENCH,<poll mode>,<BS>,<STmin [us]>,<message size>,<transfer time [us]>,<bytes/s>,<frames>,<frame gap [us]>,<bus load [%]>,<CPU load [%]>
+ *
+ * The block size and STmin sent in the flow control frames are CONFIG_ISO_TP_DEFAULT_BLOCK_SIZE and
+ * CONFIG_ISO_TP_DEFAULT_ST_MIN_US, set them with menuconfig to sweep them. The frame gap is the average time
+ * between the starts of two frames, flow control frames included. The bus load compares it with the time
+ * of a frame on the bus, without bit stuffing. The CPU load is measured by low priority tasks counting how
+ * much CPU time is left, on every core.
+ */
+
+#define BENCH_TWAI_GPIO         GPIO_NUM_4  // Loopback through the same GPIO, no transceiver needed
+#define BENCH_BITRATE           500000
+#define BENCH_TX_ID             0x7E0
+#define BENCH_RX_ID             0x7E8
+#define BENCH_MAX_SIZE          4095
+#define BENCH_RUNS              5           // Transfers per message size, the results are averaged
+#define BENCH_TIMEOUT_MS        5000
+// Bits of a classic frame with an 11-bit ID and 8 data bytes, interframe space included, without stuffing
+#define BENCH_FRAME_BITS        111
+
+typedef enum {
+    BENCH_POLL_APP,     // esp_isotp_poll() called by the application every tick
+    BENCH_POLL_TASK,    // Built-in poll task, flags.poll_task
+} bench_poll_mode_t;
+
+static const char *TAG = "isotp_bench";
+
+static const uint32_t s_sizes[] = {7, 64, 256, 1024, BENCH_MAX_SIZE};
+static uint8_t s_tx_data[BENCH_MAX_SIZE];
+static TaskHandle_t s_main_task;
+static volatile int64_t s_rx_done_us;
+static volatile uint32_t s_idle_count[portNUM_PROCESSORS];
+
+static void bench_rx_done(esp_isotp_handle_t handle, const uint8_t *data, uint32_t size, void *user_arg)
+{
+    BaseType_t task_woken = pdFALSE;
+    s_rx_done_us = esp_timer_get_time();
+    vTaskNotifyGiveFromISR(s_main_task, &task_woken);
+    portYIELD_FROM_ISR(task_woken);
+}
+
+/* Idle priority task counting the CPU time other tasks leave */
+static void bench_idle_task(void *arg)
+{
+    volatile uint32_t *count = (volatile uint32_t *)arg;
+    while (true) {
+        (*count)++;
+    }
+}
+
+static uint32_t bench_idle_total(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        total += s_idle_count[i];
+    }
+    return total;
+}
+
+/* Number of frames of a transfer: first frame, consecutive frames and flow control frames, or a single frame */
+static uint32_t bench_frame_count(uint32_t size)
+{
+    if (size <= 7) {
+        return 1;
+    }
+    // The first frame carries 6 bytes, every consecutive frame 7 bytes
+    const uint32_t cf = (size - 6 + 7 - 1) / 7;
+    // One flow control frame after the first frame, then one after every block but the last
+    const uint32_t bs = CONFIG_ISO_TP_DEFAULT_BLOCK_SIZE;
+    const uint32_t fc = bs ? 1 + (cf - 1) / bs : 1;
+    return 1 + cf + fc;
+}
+
+/* Time of one transfer in us, 0 on failure. The message is checked once received, outside of the measured time */
+static int64_t bench_transfer(esp_isotp_handle_t sender, esp_isotp_handle_t receiver, bench_poll_mode_t mode, uint32_t size)
+{
+    ulTaskNotifyTake(pdTRUE, 0);
+    const int64_t start = esp_timer_get_time();
+    if (esp_isotp_send(sender, s_tx_data, size) != ESP_OK) {
+        return 0;
+    }
+    if (mode == BENCH_POLL_TASK) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BENCH_TIMEOUT_MS));
+    } else {
+        const int64_t deadline = start + BENCH_TIMEOUT_MS * 1000LL;
+        while (!ulTaskNotifyTake(pdTRUE, 0) && esp_timer_get_time() < deadline) {
+            esp_isotp_poll(sender);
+            esp_isotp_poll(receiver);
+            vTaskDelay(1);
+        }
+    }
+
+    const uint8_t *data;
+    uint32_t rx_size;
+    if (esp_isotp_receive_borrow(receiver, &data, &rx_size) != ESP_OK) {
+        return 0;
+    }
+    bool valid = rx_size == size && memcmp(data, s_tx_data, size) == 0;
+    esp_isotp_receive_release(receiver, data);
+    return valid ? s_rx_done_us - start : 0;
+}
+
+static void bench_run(esp_isotp_mux_handle_t mux, bench_poll_mode_t mode, float cpu_idle_per_us)
+{
+    esp_isotp_config_t config = {
+        .tx_buffer_size = BENCH_MAX_SIZE,
+        .rx_buffer_size = BENCH_MAX_SIZE,
+        .flags.poll_task = (mode == BENCH_POLL_TASK),
+    };
+    esp_isotp_handle_t sender, receiver;
+
+    config.tx_id = BENCH_TX_ID;
+    config.rx_id = BENCH_RX_ID;
+    ESP_ERROR_CHECK(esp_isotp_mux_new_transport(mux, &config, &sender));
+    config.tx_id = BENCH_RX_ID;
+    config.rx_id = BENCH_TX_ID;
+    config.rx_callback = bench_rx_done;
+    config.rx_slot_count = 1;
+    ESP_ERROR_CHECK(esp_isotp_mux_new_transport(mux, &config, &receiver));
+
+    const char *mode_name = mode == BENCH_POLL_TASK ? "poll_task" : "app_poll";
+    for (size_t s = 0; s < sizeof(s_sizes) / sizeof(s_sizes[0]); s++) {
+        const uint32_t size = s_sizes[s];
+        int64_t total_us = 0;
+        const uint32_t idle_start = bench_idle_total();
+        for (int run = 0; run < BENCH_RUNS; run++) {
+            const int64_t us = bench_transfer(sender, receiver, mode, size);
+            if (us <= 0) {
+                ESP_LOGE(TAG, "%s: transfer of %" PRIu32 " bytes failed", mode_name, size);
+                total_us = 0;
+                break;
+            }
+            total_us += us;
+        }
+        if (!total_us) {
+            continue;
+        }
+        const uint32_t idle = bench_idle_total() - idle_start;
+        const uint32_t avg_us = total_us / BENCH_RUNS;
+        const uint32_t frames = bench_frame_count(size);
+        const float frame_gap_us = (float)avg_us / frames;
+        const float bus_load = 100.0f * BENCH_FRAME_BITS * 1000000.0f / BENCH_BITRATE / frame_gap_us;
+        const float cpu_load = 100.0f * (1.0f - (float)idle / (cpu_idle_per_us * total_us));
+        printf("ISOTPBENCH,%s,%d,%d,%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%.1f,%.1f,%.1f\n", mode_name,
+               CONFIG_ISO_TP_DEFAULT_BLOCK_SIZE, CONFIG_ISO_TP_DEFAULT_ST_MIN_US, size, avg_us,
+               (uint32_t)(size * 1000000ULL / avg_us), frames, frame_gap_us, bus_load, cpu_load < 0 ? 0 : cpu_load);
+    }
+
+    ESP_ERROR_CHECK(esp_isotp_delete(receiver));
+    ESP_ERROR_CHECK(esp_isotp_delete(sender));
+}
+
+void app_main(void)
+{
+    s_main_task = xTaskGetCurrentTaskHandle();
+    // Above the CPU time counters, which must only get the time left by the benchmark
+    vTaskPrioritySet(NULL, 5);
+    for (size_t i = 0; i < sizeof(s_tx_data); i++) {
+        s_tx_data[i] = i * 7 + 1;
+    }
+
+    // Self-test loopback: the node receives its own frames and does not need an acknowledgment
+    twai_onchip_node_config_t twai_cfg = {
+        .io_cfg = {.tx = BENCH_TWAI_GPIO, .rx = BENCH_TWAI_GPIO},
+        .bit_timing = {.bitrate = BENCH_BITRATE},
+        .tx_queue_depth = 8,
+        .flags = {.enable_self_test = true, .enable_loopback = true},
+    };
+    twai_node_handle_t twai_node;
+    ESP_ERROR_CHECK(twai_new_node_onchip(&twai_cfg, &twai_node));
+
+    // Both links share the node, the multiplexer dispatches the frames of one link to the other
+    esp_isotp_mux_config_t mux_cfg = {
+        .tx_frame_pool_size = 8,
+        .tx_queue_depth = 2,
+    };
+    esp_isotp_mux_handle_t mux;
+    ESP_ERROR_CHECK(esp_isotp_new_mux(twai_node, &mux_cfg, &mux));
+
+    // Calibrate the CPU time counters while nothing else runs
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        xTaskCreatePinnedToCore(bench_idle_task, "bench_idle", 2048, (void *)&s_idle_count[i], tskIDLE_PRIORITY, NULL, i);
+    }
+    const uint32_t idle_start = bench_idle_total();
+    const int64_t calib_start = esp_timer_get_time();
+    vTaskDelay(pdMS_TO_TICKS(500));
+    const float cpu_idle_per_us = (float)(bench_idle_total() - idle_start) / (esp_timer_get_time() - calib_start);
+
+    printf("ISOTPBENCH,mode,bs,stmin_us,size,transfer_us,bytes_per_s,frames,frame_gap_us,bus_load_pct,cpu_load_pct\n");
+    bench_run(mux, BENCH_POLL_APP, cpu_idle_per_us);
+    bench_run(mux, BENCH_POLL_TASK, cpu_idle_per_us);
+    printf("Benchmark done\n");
+
+    ESP_ERROR_CHECK(esp_isotp_del_mux(mux));
+    ESP_ERROR_CHECK(twai_node_delete(twai_node));
+}
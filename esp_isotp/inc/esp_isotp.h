@@ -18,6 +18,9 @@
  * **Large packets (>7 bytes)**: Split into multiple frames - first frame sent immediately,
  * remaining frames sent during esp_isotp_poll() calls.
  *
+ * **Poll task**: With `flags.poll_task`, a built-in task drives the link instead of esp_isotp_poll().
+ * It sends every consecutive frame as soon as STmin expires, and sleeps in between.
+ *
  */
 
 #include "esp_err.h"
@@ -33,6 +36,11 @@ extern "C" {
  */
 typedef struct esp_isotp_link_t *esp_isotp_handle_t;
 
+/**
+ * @brief ISO-TP multiplexer handle, shares one TWAI node between many ISO-TP links
+ */
+typedef struct esp_isotp_mux_t *esp_isotp_mux_handle_t;
+
 /**
  * @brief ISO-TP receive callback function type
  *
@@ -67,6 +75,82 @@ typedef void (*esp_isotp_rx_callback_t)(esp_isotp_handle_t handle, const uint8_t
  */
 typedef void (*esp_isotp_tx_callback_t)(esp_isotp_handle_t handle, uint32_t tx_size, void *user_arg);
 
+/**
+ * @brief Streamed send read callback function type
+ *
+ * Fills a chunk of a message sent with esp_isotp_stream_send(), e.g. from flash or PSRAM.
+ * The chunks are read in order, from offset 0 up to the size of the message.
+ *
+ * @note Called in task context: from esp_isotp_stream_send() for the first chunk, then from
+ *       esp_isotp_poll() or the poll task. It may block, the consecutive frames wait meanwhile.
+ *
+ * @param[in] handle ISO-TP handle sending the message
+ * @param[in] offset Offset of the chunk in the message
+ * @param[out] buf Buffer to fill, 4-byte aligned and DMA capable
+ * @param[in] len Number of bytes to read, chunk_size except for the last chunk
+ * @param[in] user_arg User argument provided in the stream configuration
+ * @return ESP_OK, or an error to abort the send
+ */
+typedef esp_err_t (*esp_isotp_stream_read_cb_t)(esp_isotp_handle_t handle, uint32_t offset, uint8_t *buf, uint32_t len, void *user_arg);
+
+/**
+ * @brief Streamed receive write callback function type
+ *
+ * Takes a chunk of a message received with esp_isotp_stream_receive(), e.g. to write it to flash.
+ * The chunks come in order, at offsets multiple of chunk_size.
+ *
+ * @note Called in task context, from esp_isotp_poll() or the poll task. It may block, the
+ *       flow control frames are held back until there is room for the next block.
+ *
+ * @param[in] handle ISO-TP handle receiving the message
+ * @param[in] offset Offset of the chunk in the message
+ * @param[in] data Chunk data, 4-byte aligned and DMA capable, valid during the callback
+ * @param[in] len Chunk length, chunk_size except for the last chunk
+ * @param[in] user_arg User argument provided in the stream configuration
+ * @return ESP_OK, or an error to abort the reception
+ */
+typedef esp_err_t (*esp_isotp_stream_write_cb_t)(esp_isotp_handle_t handle, uint32_t offset, const uint8_t *data, uint32_t len, void *user_arg);
+
+/**
+ * @brief Streamed transfer completion callback function type
+ *
+ * @note Called in task context, from esp_isotp_poll() or the poll task.
+ *
+ * @param[in] handle ISO-TP handle of the transfer
+ * @param[in] size Number of bytes sent or passed to the write callback
+ * @param[in] result ESP_OK, ESP_ERR_TIMEOUT when the peer stopped responding, ESP_ERR_INVALID_SIZE when
+ *                   the receiver refused the message size, ESP_ERR_INVALID_RESPONSE on a protocol error,
+ *                   or the error returned by the read or write callback
+ * @param[in] user_arg User argument provided in the stream configuration
+ */
+typedef void (*esp_isotp_stream_done_cb_t)(esp_isotp_handle_t handle, uint32_t size, esp_err_t result, void *user_arg);
+
+/**
+ * @brief Configuration of a streamed send, see esp_isotp_stream_send()
+ */
+typedef struct {
+    uint32_t chunk_size;                 /*!< Bytes read by each call of on_read, multiple of 4 and at least 64 */
+    esp_isotp_stream_read_cb_t on_read;  /*!< Read callback, provides the message */
+    esp_isotp_stream_done_cb_t on_done;  /*!< Completion callback (NULL to disable) */
+    void *user_arg;                      /*!< User argument passed to the callbacks */
+} esp_isotp_stream_tx_config_t;
+
+/**
+ * @brief Configuration of a streamed receive, see esp_isotp_stream_receive()
+ */
+typedef struct {
+    uint32_t chunk_size;                 /*!< Bytes passed to each call of on_write, multiple of 4 and at least 64.
+                                              Two chunks are buffered, the larger they are the larger the blocks */
+    uint32_t max_size;                   /*!< Larger messages are refused with an overflow flow control frame, 0 for no limit */
+    uint8_t block_size;                  /*!< Initial block size announced to the sender, 0 for CONFIG_ISO_TP_DEFAULT_BLOCK_SIZE */
+    uint32_t st_min_us;                  /*!< Smallest STmin announced to the sender */
+    uint32_t st_min_max_us;              /*!< Largest STmin announced when the write callback can't keep up with the bus,
+                                              at least st_min_us, up to 127000 */
+    esp_isotp_stream_write_cb_t on_write; /*!< Write callback, takes the message */
+    esp_isotp_stream_done_cb_t on_done;  /*!< Completion callback (NULL to disable) */
+    void *user_arg;                      /*!< User argument passed to the callbacks */
+} esp_isotp_stream_rx_config_t;
+
 /**
  * @brief Configuration structure for creating a new ISO-TP link
  */
@@ -75,13 +159,35 @@ typedef struct {
     uint32_t rx_id;                  /*!< TWAI ID for receiving ISO-TP frames (11-bit or 29-bit, auto-detected from value) */
     uint32_t tx_buffer_size;         /*!< Size of the transmit buffer (max message size to send) */
     uint32_t rx_buffer_size;         /*!< Size of the receive buffer (max message size to receive) */
-    uint32_t tx_frame_pool_size;     /*!< Size of TX frame pool */
+    uint32_t tx_frame_pool_size;     /*!< Size of TX frame pool, ignored by the links of a multiplexer */
+    uint32_t rx_slot_count;          /*!< Number of receive message slots of rx_buffer_size bytes each, for esp_isotp_receive_borrow().
+                                          0 to receive into the single reassembly buffer */
 
     esp_isotp_rx_callback_t rx_callback; /*!< Receive completion callback (NULL for polling mode) */
     esp_isotp_tx_callback_t tx_callback; /*!< Transmit completion callback (NULL to disable) */
     void *callback_arg;               /*!< User argument passed to callbacks */
+
+    /** Extra configuration flags */
+    struct {
+        uint32_t poll_task: 1;        /*!< Drive the link from a built-in task woken up at STmin expiry and by the TWAI
+                                           callbacks, see CONFIG_ISO_TP_POLL_TASK_PRIORITY. esp_isotp_poll() must not be called */
+        uint32_t fd_frames: 1;        /*!< Send the ISO-TP frames as CAN FD frames, padded to a valid CAN FD length, and receive
+                                           CAN FD frames of up to 64 bytes. Needs a target with CAN FD and a TWAI node with FD timing */
+        uint32_t fd_bitrate_switch: 1; /*!< Send the data phase of the CAN FD frames at the data bitrate of the node (BRS),
+                                           needs fd_frames */
+    } flags;                          /*!< Extra configuration flags */
 } esp_isotp_config_t;
 
+/**
+ * @brief Configuration structure for creating a new ISO-TP multiplexer
+ */
+typedef struct {
+    uint32_t tx_frame_pool_size;     /*!< Size of the TX frame pool shared by all the links. One frame is reserved for flow control frames */
+    uint32_t tx_queue_depth;         /*!< Largest number of frames handed over to the TWAI driver at a time, at most the tx_queue_depth
+                                          of the node. The other frames wait in the multiplexer, where flow control frames go first,
+                                          so a small value (1-2) gives the lowest flow control latency */
+} esp_isotp_mux_config_t;
+
 /**
  * @brief Create a new ISO-TP transport bound to a TWAI node.
  *
@@ -96,10 +202,64 @@ typedef struct {
  *  - ESP_ERR_INVALID_ARG for invalid parameters
  *  - ESP_ERR_INVALID_SIZE for invalid buffer sizes
  *  - ESP_ERR_NO_MEM when allocation fails
+ *  - ESP_ERR_NOT_SUPPORTED when CAN FD frames are requested on a target without CAN FD
  *  - Other error codes from TWAI functions
  */
 esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_config_t *config, esp_isotp_handle_t *out_handle);
 
+/**
+ * @brief Create a new ISO-TP multiplexer bound to a TWAI node.
+ *
+ * The multiplexer registers the TWAI callbacks once for all its links, see esp_isotp_mux_new_transport().
+ * Received frames are dispatched to the links by RX ID through a hash table, and the links share
+ * a TX frame pool. Flow control frames are handed over to the driver before the other frames,
+ * so that a reception is not slowed down by the consecutive frames sent by the other links.
+ * Enables the provided TWAI node.
+ *
+ * @param twai_node TWAI node handle to bind, not used by any other ISO-TP transport.
+ * @param config Multiplexer configuration.
+ * @param[out] out_mux Returned ISO-TP multiplexer handle.
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_ARG for invalid parameters
+ *  - ESP_ERR_INVALID_SIZE for invalid pool size or queue depth
+ *  - ESP_ERR_NO_MEM when allocation fails
+ *  - Other error codes from TWAI functions
+ */
+esp_err_t esp_isotp_new_mux(twai_node_handle_t twai_node, const esp_isotp_mux_config_t *config, esp_isotp_mux_handle_t *out_mux);
+
+/**
+ * @brief Create a new ISO-TP transport on a multiplexer.
+ *
+ * Same as esp_isotp_new_transport(), on the TWAI node of the multiplexer. The link takes its TX frames
+ * from the shared pool of the multiplexer, tx_frame_pool_size is ignored. Delete it with esp_isotp_delete().
+ *
+ * @param mux ISO-TP multiplexer handle.
+ * @param config Transport configuration, rx_id must differ from the rx_id of the other links of the multiplexer.
+ * @param[out] out_handle Returned ISO-TP transport handle.
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_ARG for invalid parameters or an rx_id already used on the multiplexer
+ *  - ESP_ERR_INVALID_SIZE for invalid buffer sizes
+ *  - ESP_ERR_NO_MEM when allocation fails
+ *  - ESP_ERR_NOT_SUPPORTED when CAN FD frames are requested on a target without CAN FD
+ */
+esp_err_t esp_isotp_mux_new_transport(esp_isotp_mux_handle_t mux, const esp_isotp_config_t *config, esp_isotp_handle_t *out_handle);
+
+/**
+ * @brief Delete an ISO-TP multiplexer
+ *
+ * Disables the TWAI node and unregisters its callbacks.
+ *
+ * @param mux The handle of the ISO-TP multiplexer to delete
+ * @return
+ *     - ESP_OK: Success
+ *     - ESP_ERR_INVALID_ARG: Invalid argument
+ *     - ESP_ERR_INVALID_STATE: The multiplexer still has links, delete them first
+ *     - Other ESP error codes: TWAI node disable failed
+ */
+esp_err_t esp_isotp_del_mux(esp_isotp_mux_handle_t mux);
+
 /**
  * @brief Send data over an ISO-TP link (non-blocking, ISR-safe)
  *
@@ -164,6 +324,8 @@ esp_err_t esp_isotp_send_with_id(esp_isotp_handle_t handle, uint32_t id, const u
  * @note When using callback mode (rx_callback != NULL), received messages are
  *       automatically delivered via callback. This function should only be used
  *       in polling mode (rx_callback == NULL).
+ * @note With receive message slots (rx_slot_count > 0), this function copies the oldest
+ *       received message and releases its slot, see esp_isotp_receive_borrow() to avoid the copy.
  *
  * @param handle ISO-TP handle
  * @param data Buffer to store received data
@@ -180,6 +342,90 @@ esp_err_t esp_isotp_send_with_id(esp_isotp_handle_t handle, uint32_t id, const u
  */
 esp_err_t esp_isotp_receive(esp_isotp_handle_t handle, uint8_t *data, uint32_t size, uint32_t *received_size);
 
+/**
+ * @brief Borrow the oldest received message from its receive slot, without copying it (non-blocking, task context only)
+ *
+ * Needs receive message slots (rx_slot_count > 0). Every message is reassembled directly
+ * into a slot, and stays there until esp_isotp_receive_release() is called. The next
+ * messages are received into the other slots meanwhile, so that a transfer can start
+ * before the application has consumed the previous message.
+ *
+ * @note The rx_callback, if any, is still called when a message is complete, e.g. to wake
+ *       up the task which borrows it.
+ * @note When all the slots are borrowed or waiting to be borrowed, a new message is
+ *       reassembled into the internal buffer, and copied into the first slot released
+ *       before its end. It is lost if no slot is released in time.
+ *
+ * @param handle ISO-TP handle
+ * @param[out] data Pointer to the message data, valid until the slot is released
+ * @param[out] size Size of the message in bytes
+ * @return
+ *     - ESP_OK: Message borrowed, release it with esp_isotp_receive_release()
+ *     - ESP_ERR_NOT_FOUND: No complete message ready
+ *     - ESP_ERR_INVALID_STATE: The link has no receive message slots
+ *     - ESP_ERR_INVALID_ARG: Invalid parameters
+ */
+esp_err_t esp_isotp_receive_borrow(esp_isotp_handle_t handle, const uint8_t **data, uint32_t *size);
+
+/**
+ * @brief Release the receive slot of a message borrowed with esp_isotp_receive_borrow() (task context only)
+ *
+ * @param handle ISO-TP handle
+ * @param data Message data returned by esp_isotp_receive_borrow()
+ * @return
+ *     - ESP_OK: Slot released, it can receive a new message
+ *     - ESP_ERR_INVALID_ARG: Invalid parameters, or data is not a borrowed message of the link
+ */
+esp_err_t esp_isotp_receive_release(esp_isotp_handle_t handle, const uint8_t *data);
+
+/**
+ * @brief Send a message read chunk by chunk from a callback (task context only)
+ *
+ * The message does not go through the TX buffer of the link, its size is only limited by the
+ * 32-bit length of ISO 15765-2 first frames, e.g. a firmware image in flash for a UDS
+ * TransferData sequence. Messages longer than 4095 bytes use the escape sequence of the
+ * first frame, the receiver must support it. on_read fills one chunk at a time, the
+ * consecutive frames are sent by esp_isotp_poll() or the poll task, following the block
+ * size and STmin of the receiver.
+ *
+ * @note Single-frame messages are not streamed, send them with esp_isotp_send().
+ *
+ * @param handle ISO-TP handle
+ * @param size Message size in bytes, larger than a single frame
+ * @param config Stream configuration, copied
+ * @return
+ *     - ESP_OK: First frame sent, on_done is called at the end of the transfer
+ *     - ESP_ERR_NOT_FINISHED: Previous send still in progress
+ *     - ESP_ERR_INVALID_SIZE: Message fits a single frame or invalid chunk size
+ *     - ESP_ERR_NO_MEM: Chunk buffer allocation failed or no free TX frame
+ *     - ESP_ERR_INVALID_ARG: Invalid parameters
+ *     - Other: Error returned by on_read, or ESP_FAIL when the first frame could not be sent
+ */
+esp_err_t esp_isotp_stream_send(esp_isotp_handle_t handle, uint32_t size, const esp_isotp_stream_tx_config_t *config);
+
+/**
+ * @brief Receive the next multi-frame message chunk by chunk into a callback (task context only)
+ *
+ * The next first frame received by the link starts a streamed reception instead of a reception
+ * into the RX buffer, single-frame messages are still received as usual. The consecutive frames
+ * are buffered into two chunks, passed to on_write by esp_isotp_poll() or the poll task.
+ *
+ * The block size and STmin of the flow control frames adapt to the transfer: a block never
+ * exceeds the free buffer, STmin is doubled, up to st_min_max_us, when on_write is slower than
+ * the bus and halved again after 8 blocks without waiting, and the block size is doubled when
+ * no TX frame is free for a flow control frame, to send fewer of them.
+ *
+ * @param handle ISO-TP handle
+ * @param config Stream configuration, copied
+ * @return
+ *     - ESP_OK: Ready, on_done is called at the end of the reception
+ *     - ESP_ERR_NOT_FINISHED: A streamed reception is already waiting or in progress
+ *     - ESP_ERR_INVALID_SIZE: Invalid chunk size
+ *     - ESP_ERR_NO_MEM: Chunk buffer allocation failed
+ *     - ESP_ERR_INVALID_ARG: Invalid parameters
+ */
+esp_err_t esp_isotp_stream_receive(esp_isotp_handle_t handle, const esp_isotp_stream_rx_config_t *config);
+
 /**
  * @brief Poll the ISO-TP link to process messages (CRITICAL - call regularly, task context only)
  *
@@ -191,9 +437,12 @@ esp_err_t esp_isotp_receive(esp_isotp_handle_t handle, uint8_t *data, uint32_t s
  * - Handles flow control and timeouts
  * - Updates internal state machine
  * - Triggers TX completion callbacks for multi-frame messages
+ * - Reads, drains and completes the streamed transfers
  *
  * Without regular polling: multi-frame sends will stall and receives won't complete.
  *
+ * @note Not needed with `flags.poll_task`, the poll task drives the link and this function fails.
+ *
  * @warning This function is NOT ISR-safe and must only be called from task context.
  * @note TX completion callbacks for multi-frame messages are triggered from this function.
  *
@@ -201,12 +450,15 @@ esp_err_t esp_isotp_receive(esp_isotp_handle_t handle, uint8_t *data, uint32_t s
  * @return
  *     - ESP_OK: Processing successful
  *     - ESP_ERR_INVALID_ARG: Invalid parameters
+ *     - ESP_ERR_INVALID_STATE: The link is driven by its poll task
  */
 esp_err_t esp_isotp_poll(esp_isotp_handle_t handle);
 
 /**
  * @brief Delete an ISO-TP link
  *
+ * A link of a multiplexer is removed from it, the TWAI node stays enabled for the other links.
+ *
  * @param handle The handle of the ISO-TP link to delete
  * @return
  *     - ESP_OK: Success (or TWAI disable warning logged)
@@ -3,13 +3,19 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <inttypes.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/queue.h>
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "soc/soc_caps.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "esp_twai.h"
@@ -19,6 +25,34 @@
 
 static const char *TAG = "esp_isotp";
 
+#if SOC_TWAI_SUPPORT_FD
+#define ESP_ISOTP_FRAME_MAX_LEN     64      ///< Largest TWAI frame payload, CAN FD frames
+#else
+#define ESP_ISOTP_FRAME_MAX_LEN     8       ///< Largest TWAI frame payload, classic CAN frames
+#endif
+
+#define ESP_ISOTP_MUX_HASH_SIZE             32  ///< Number of buckets of the RX ID hash table of a multiplexer, power of 2
+#define ESP_ISOTP_MUX_FC_RESERVED_FRAMES    1   ///< Frames of the shared pool of a multiplexer only flow control frames can use
+#define ESP_ISOTP_PCI_TYPE_FIRST_FRAME      0x1 ///< Protocol control information type of first frames, high nibble of byte 0
+#define ESP_ISOTP_PCI_TYPE_CONSECUTIVE      0x2 ///< Protocol control information type of consecutive frames
+#define ESP_ISOTP_PCI_TYPE_FLOW_CONTROL     0x3 ///< Protocol control information type of flow control frames
+#define ESP_ISOTP_FC_CONTINUE               0x0 ///< Flow status of a flow control frame: send the next block
+#define ESP_ISOTP_FC_WAIT                   0x1 ///< Flow status of a flow control frame: wait for the next flow control frame
+#define ESP_ISOTP_FC_OVERFLOW               0x2 ///< Flow status of a flow control frame: message too large for the receiver
+#define ESP_ISOTP_FF_DL_12BIT_MAX           4095    ///< Largest message length of a first frame without the 32-bit escape sequence
+
+#define ESP_ISOTP_STREAM_CHUNK_MIN          64      ///< Smallest chunk of a streamed transfer, holds the payload of any frame
+#define ESP_ISOTP_FD_SEND_CHUNK_SIZE        256     ///< Chunk of the multi-frame messages of esp_isotp_send() on CAN FD links
+#define ESP_ISOTP_STREAM_CLEAN_BLOCKS       8       ///< Blocks received without a full ring before the announced STmin is halved
+#define ESP_ISOTP_ST_MIN_STEP_US            100     ///< Smallest non-zero STmin of a flow control frame
+#define ESP_ISOTP_ST_MIN_MAX_US             127000  ///< Largest STmin of a flow control frame
+
+#ifdef ISO_TP_FRAME_PADDING
+#define ESP_ISOTP_FD_PADDING_VALUE  ISO_TP_FRAME_PADDING_VALUE
+#else
+#define ESP_ISOTP_FD_PADDING_VALUE  0xCC    ///< Padding recommended by ISO 15765-2 up to the next CAN FD frame length
+#endif
+
 /**
  * @brief Determine if the given ID requires extended (29-bit) format
  *
@@ -30,23 +64,146 @@ static inline bool is_extended_id(uint32_t id)
     return (id > TWAI_STD_ID_MASK);
 }
 
+/**
+ * @brief Round a payload length up to the next length a CAN FD frame can carry
+ *
+ * @param len Payload length in bytes (0-64).
+ * @return Frame length: len up to 8 bytes, then 12, 16, 20, 24, 32, 48 or 64.
+ */
+static inline uint8_t esp_isotp_fd_frame_len(uint8_t len)
+{
+    if (len <= 8) {
+        return len;
+    }
+    if (len <= 24) {
+        return (len + 3) & ~3;
+    }
+    return len <= 32 ? 32 : len <= 48 ? 48 : 64;
+}
+
 /**
  * @brief TWAI frame container with embedded data buffer.
  *
- * This structure wraps the TWAI frame with an embedded 8-byte data buffer
- * to ensure memory safety during asynchronous operations.
+ * This structure wraps the TWAI frame with an embedded data buffer, 8 bytes or 64 bytes
+ * on targets with CAN FD, to ensure memory safety during asynchronous operations.
  *
  * Used for:
  * - TX frames: Pre-allocated in SLIST pool, recycled after transmission
  * - RX frames: Pre-allocated in link structure for ISR-safe reception
+ * - Multiplexer TX frames: Shared SLIST pool, STAILQ queues until handed over to the driver
  */
 typedef struct esp_isotp_frame_t {
     twai_frame_t frame;           ///< TWAI driver frame structure
-    uint8_t data_payload[8];      ///< Embedded 8-byte TWAI frame data buffer
+    uint8_t data_payload[ESP_ISOTP_FRAME_MAX_LEN];  ///< Embedded TWAI frame data buffer
     SLIST_ENTRY(esp_isotp_frame_t) link;  ///< Single-linked list entry for frame pool
+    STAILQ_ENTRY(esp_isotp_frame_t) pending;  ///< Entry in a TX queue of a multiplexer
 } esp_isotp_frame_t;
 
 SLIST_HEAD(frame_pool_head, esp_isotp_frame_t);
+STAILQ_HEAD(frame_queue_head, esp_isotp_frame_t);
+SLIST_HEAD(link_bucket_head, esp_isotp_link_t);
+
+/**
+ * @brief ISO-TP multiplexer context structure.
+ *
+ * Shares one TWAI node, its callbacks and a TX frame pool between many ISO-TP links.
+ */
+typedef struct esp_isotp_mux_t {
+    twai_node_handle_t twai_node;                 ///< TWAI node shared by the links
+    esp_isotp_frame_t isr_rx_frame_buffer;        ///< Pre-allocated frame buffer for ISR-safe RX operations
+    struct link_bucket_head links[ESP_ISOTP_MUX_HASH_SIZE]; ///< Links hashed by RX ID
+    uint32_t link_count;                          ///< Number of links
+    struct esp_isotp_link_t *volatile rx_dispatching; ///< Link the RX callback feeds a frame to, outside of links_lock
+    portMUX_TYPE links_lock;                      ///< Protects the hash table between the RX ISR and the tasks
+    struct frame_pool_head tx_frame_pool;         ///< Free TX frames shared by the links
+    esp_isotp_frame_t *tx_frame_array;            ///< Pre-allocated array of TX frames
+    uint32_t tx_frames_free;                      ///< Number of frames in tx_frame_pool
+    struct frame_queue_head tx_fc_queue;          ///< Flow control frames waiting for the driver, sent first
+    struct frame_queue_head tx_data_queue;        ///< Other frames waiting for the driver
+    uint32_t tx_queue_depth;                      ///< Largest number of frames queued in the driver
+    uint32_t tx_in_driver;                        ///< Number of frames queued in the driver
+    bool tx_feeding;                              ///< A context is handing frames over to the driver
+    portMUX_TYPE tx_lock;                         ///< Protects the frame pool and the queues
+} esp_isotp_mux_t;
+
+/**
+ * @brief State of a receive message slot.
+ */
+typedef enum {
+    ESP_ISOTP_RX_SLOT_FREE,         ///< Available to receive a message
+    ESP_ISOTP_RX_SLOT_RECEIVING,    ///< Reassembly buffer of the link
+    ESP_ISOTP_RX_SLOT_READY,        ///< Complete message waiting for esp_isotp_receive_borrow()
+    ESP_ISOTP_RX_SLOT_BORROWED,     ///< Message borrowed by the application
+} esp_isotp_rx_slot_state_t;
+
+/**
+ * @brief State of a streamed transfer.
+ */
+typedef enum {
+    ESP_ISOTP_STREAM_IDLE,          ///< No streamed transfer
+    ESP_ISOTP_STREAM_WAIT_FF,       ///< RX: waiting for the first frame of the message
+    ESP_ISOTP_STREAM_RECEIVING,     ///< RX: receiving the consecutive frames
+    ESP_ISOTP_STREAM_WAIT_FC,       ///< TX: waiting for a flow control frame
+    ESP_ISOTP_STREAM_SENDING,       ///< TX: sending the consecutive frames of a block
+    ESP_ISOTP_STREAM_DONE,          ///< Finished, on_done is called by the next poll
+} esp_isotp_stream_state_t;
+
+/**
+ * @brief Streamed send, see esp_isotp_stream_send().
+ *
+ * The task context owns the send, except in ESP_ISOTP_STREAM_WAIT_FC where the flow control
+ * frames received by the ISR update the block size, STmin and state.
+ */
+typedef struct {
+    volatile uint8_t state;                   ///< esp_isotp_stream_state_t
+    esp_isotp_stream_tx_config_t config;      ///< Configuration of the send
+    uint8_t *chunk;                           ///< DMA capable chunk buffer, kept for the next sends
+    uint32_t chunk_alloc;                     ///< Size of the chunk buffer
+    uint32_t chunk_offset;                    ///< Offset in the message of the chunk read last
+    uint32_t chunk_len;                       ///< Length of the chunk read last
+    uint32_t arbitration_id;                  ///< TWAI identifier of the first and consecutive frames
+    uint32_t size;                            ///< Message size
+    uint32_t offset;                          ///< Bytes sent
+    uint8_t frame[ESP_ISOTP_FRAME_MAX_LEN];   ///< Next consecutive frame, kept until a TX frame is free
+    uint8_t frame_len;                        ///< Length of frame, 0 when the next one is not built yet
+    uint8_t sn;                               ///< Sequence number of the next consecutive frame
+    uint8_t bs_remain;                        ///< Consecutive frames left in the block
+    bool bs_unlimited;                        ///< Block size 0, no flow control frame until the end
+    uint8_t wft_count;                        ///< Wait flow control frames received in a row
+    uint32_t st_min_us;                       ///< STmin of the receiver
+    uint32_t timer_st;                        ///< Earliest time of the next consecutive frame
+    uint32_t timer_bs;                        ///< Deadline of the next flow control frame
+    uint32_t pool_stalls;                     ///< Consecutive frames delayed by the TX frame pool running empty
+    esp_err_t result;                         ///< Result passed to on_done
+} esp_isotp_stream_tx_t;
+
+/**
+ * @brief Streamed reception, see esp_isotp_stream_receive().
+ *
+ * The ISR fills the ring buffer, two chunks long, and the task context drains it chunk by chunk.
+ */
+typedef struct {
+    volatile uint8_t state;                   ///< esp_isotp_stream_state_t
+    esp_isotp_stream_rx_config_t config;      ///< Configuration of the reception
+    uint8_t *ring;                            ///< DMA capable ring buffer, kept for the next receptions
+    uint32_t ring_alloc;                      ///< Size of the ring buffer
+    uint32_t size;                            ///< Message size, from the first frame
+    volatile uint32_t head;                   ///< Bytes received
+    volatile uint32_t tail;                   ///< Bytes passed to on_write
+    uint8_t sn;                               ///< Sequence number of the next consecutive frame
+    uint8_t cf_len;                           ///< Payload of a consecutive frame, from the first frame length
+    uint8_t bs;                               ///< Block size of the last flow control frame
+    uint8_t bs_count;                         ///< Consecutive frames received in the block
+    uint8_t bs_target;                        ///< Block size announced when the ring has room for it
+    uint8_t wft_count;                        ///< Wait flow control frames sent in a row
+    uint32_t st_min_us;                       ///< STmin announced, adapted to the pace of on_write
+    uint32_t clean_blocks;                    ///< Blocks since the ring was last full
+    bool fc_pending;                          ///< The next flow control frame is left to the poll context
+    bool ring_full;                           ///< fc_pending because the ring has no room for a consecutive frame
+    uint32_t fc_pending_since;                ///< Start of the wait for room, for the wait flow control frames
+    uint32_t timer_cr;                        ///< Deadline of the next consecutive frame
+    esp_err_t result;                         ///< Result passed to on_done
+} esp_isotp_stream_rx_t;
 
 /**
  * @brief ISO-TP link context structure.
@@ -63,11 +220,95 @@ typedef struct esp_isotp_link_t {
     struct frame_pool_head tx_frame_pool;     ///< Single-linked list of available TX frames
     esp_isotp_frame_t *tx_frame_array;        ///< Pre-allocated array of TX frames
     size_t tx_frame_pool_size;                ///< Size of TX frame pool
+    bool fd_frames;                           ///< Send CAN FD frames
+    bool fd_bitrate_switch;                   ///< Send the data phase of the CAN FD frames at the data bitrate
     esp_isotp_rx_callback_t rx_callback;      ///< User RX callback function
     esp_isotp_tx_callback_t tx_callback;      ///< User TX callback function
     void *callback_arg;                       ///< User argument for callbacks
+    uint32_t tx_buffer_size;                  ///< Size of the TX buffer, largest message of esp_isotp_send()
+    uint32_t rx_buffer_size;                  ///< Size of the RX reassembly buffer and of every receive slot
+    uint32_t rx_slot_count;                   ///< Number of receive message slots, 0 without slots
+    uint8_t *rx_slot_mem;                     ///< Memory of the receive message slots, one after the other
+    uint32_t *rx_slot_size;                   ///< Size of the message in every slot
+    uint8_t *rx_slot_state;                   ///< esp_isotp_rx_slot_state_t of every slot
+    uint32_t *rx_ready_fifo;                  ///< Indexes of the slots with a complete message, oldest first
+    uint32_t rx_ready_head;                   ///< Position of the oldest message in rx_ready_fifo
+    uint32_t rx_ready_count;                  ///< Number of messages in rx_ready_fifo
+    int32_t rx_receiving_slot;                ///< Slot the link reassembles into, -1 for isotp_rx_buffer
+    portMUX_TYPE rx_slot_lock;                ///< Protects the slots between the RX ISR and the borrowing task
+    TaskHandle_t poll_task;                   ///< Built-in task driving the link, NULL when polled by the application
+    esp_timer_handle_t poll_timer;            ///< One-shot timer waking the poll task at the next STmin or timeout expiry
+    SemaphoreHandle_t poll_task_done;         ///< Given by the poll task when it exits
+    volatile bool poll_task_exit;             ///< Asks the poll task to exit
+    esp_isotp_mux_handle_t mux;               ///< Multiplexer of the link, NULL when the link owns its TWAI node
+    SLIST_ENTRY(esp_isotp_link_t) mux_entry;  ///< Entry in the hash table of the multiplexer
+    esp_isotp_stream_tx_t stream_tx;          ///< Streamed send, bypassing isotp-c
+    esp_isotp_stream_rx_t stream_rx;          ///< Streamed reception, bypassing isotp-c
+    portMUX_TYPE stream_lock;                 ///< Protects the streamed transfers between the RX ISR and the tasks
 } esp_isotp_link_t;
 
+static inline uint8_t *esp_isotp_rx_slot_data(esp_isotp_handle_t handle, int32_t slot)
+{
+    return handle->rx_slot_mem + (size_t)slot * handle->rx_buffer_size;
+}
+
+/**
+ * @brief Find a free receive slot and mark it as receiving, call with rx_slot_lock held.
+ *
+ * @return Index of the slot, -1 if all the slots are in use.
+ */
+static int32_t esp_isotp_rx_slot_take(esp_isotp_handle_t handle)
+{
+    for (uint32_t i = 0; i < handle->rx_slot_count; i++) {
+        if (handle->rx_slot_state[i] == ESP_ISOTP_RX_SLOT_FREE) {
+            handle->rx_slot_state[i] = ESP_ISOTP_RX_SLOT_RECEIVING;
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Hand a complete message over to the application and give the link a new reassembly buffer.
+ *
+ * The message stays in the slot it was reassembled into. Only a message received while all the
+ * slots were in use, reassembled into isotp_rx_buffer, is copied, into a slot released meanwhile.
+ * The link buffer is only changed here, in the context of isotp_on_can_message().
+ *
+ * @note Runs in ISR context, from the isotp-c RX completion callback.
+ * @param handle ISO-TP link handle.
+ * @param data Received data, in the current reassembly buffer.
+ * @param size Size of received data in bytes.
+ */
+static void esp_isotp_rx_slot_done(esp_isotp_handle_t handle, const uint8_t *data, uint32_t size)
+{
+    portENTER_CRITICAL_ISR(&handle->rx_slot_lock);
+    int32_t done = handle->rx_receiving_slot;
+    bool copy = done < 0;
+    if (copy) {
+        done = esp_isotp_rx_slot_take(handle);
+    }
+    portEXIT_CRITICAL_ISR(&handle->rx_slot_lock);
+
+    if (copy && done >= 0) {
+        memcpy(esp_isotp_rx_slot_data(handle, done), data, size);
+    }
+
+    portENTER_CRITICAL_ISR(&handle->rx_slot_lock);
+    if (done >= 0) {
+        handle->rx_slot_size[done] = size;
+        handle->rx_slot_state[done] = ESP_ISOTP_RX_SLOT_READY;
+        handle->rx_ready_fifo[(handle->rx_ready_head + handle->rx_ready_count) % handle->rx_slot_count] = done;
+        handle->rx_ready_count++;
+    }
+    int32_t next = esp_isotp_rx_slot_take(handle);
+    handle->rx_receiving_slot = next;
+    handle->link.receive_buffer = next >= 0 ? esp_isotp_rx_slot_data(handle, next) : handle->isotp_rx_buffer;
+    // The message has left the reassembly buffer, the next transfer can start
+    handle->link.receive_status = ISOTP_RECEIVE_STATUS_IDLE;
+    portEXIT_CRITICAL_ISR(&handle->rx_slot_lock);
+}
+
 /**
  * @brief Wrapper callback for isotp-c RX completion.
  *
@@ -89,6 +330,9 @@ static void esp_isotp_rx_wrapper(void *link, const uint8_t *data, uint32_t size,
     if (handle && handle->rx_callback) {
         handle->rx_callback(handle, data, size, handle->callback_arg);
     }
+    if (handle && handle->rx_slot_count) {
+        esp_isotp_rx_slot_done(handle, data, size);
+    }
 }
 #endif
 
@@ -116,6 +360,566 @@ static void esp_isotp_tx_wrapper(void *link, uint32_t tx_size, void *user_arg)
 }
 #endif
 
+static inline bool esp_isotp_time_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * @brief Decode the STmin byte of a flow control frame.
+ *
+ * @param st_min STmin byte: 0-127 ms, or 100-900 us from 0xF1 to 0xF9.
+ * @return STmin in microseconds, 127 ms for the reserved values as required by ISO 15765-2.
+ */
+static uint32_t esp_isotp_st_min_to_us(uint8_t st_min)
+{
+    if (st_min <= 0x7F) {
+        return st_min * 1000;
+    }
+    if (st_min >= 0xF1 && st_min <= 0xF9) {
+        return (st_min - 0xF0) * ESP_ISOTP_ST_MIN_STEP_US;
+    }
+    return ESP_ISOTP_ST_MIN_MAX_US;
+}
+
+/**
+ * @brief Encode a STmin for a flow control frame, rounded up.
+ *
+ * @param us STmin in microseconds, up to 127000.
+ * @return STmin byte.
+ */
+static uint8_t esp_isotp_st_min_from_us(uint32_t us)
+{
+    if (us == 0) {
+        return 0;
+    }
+    if (us < 1000) {
+        return 0xF0 + MIN((us + ESP_ISOTP_ST_MIN_STEP_US - 1) / ESP_ISOTP_ST_MIN_STEP_US, 9);
+    }
+    return MIN((us + 999) / 1000, 0x7F);
+}
+
+/**
+ * @brief Send a frame of a streamed transfer with a given TWAI ID, padded like the classic CAN frames of isotp-c.
+ *
+ * @note ISR-safe.
+ * @param handle ISO-TP link handle.
+ * @param id TWAI identifier.
+ * @param frame Frame payload, ESP_ISOTP_FRAME_MAX_LEN bytes long for the padding.
+ * @param len Payload length.
+ * @return Same as isotp_user_send_can().
+ */
+static int esp_isotp_stream_send_frame_with_id(esp_isotp_handle_t handle, uint32_t id, uint8_t *frame, uint8_t len)
+{
+#ifdef ISO_TP_FRAME_PADDING
+    if (!handle->fd_frames && len < 8) {
+        memset(frame + len, ISO_TP_FRAME_PADDING_VALUE, 8 - len);
+        len = 8;
+    }
+#endif
+    return isotp_user_send_can(id, frame, len, handle);
+}
+
+/**
+ * @brief Send a frame of a streamed transfer with the TX ID of the link.
+ *
+ * @note ISR-safe.
+ * @return Same as isotp_user_send_can().
+ */
+static int esp_isotp_stream_send_frame(esp_isotp_handle_t handle, uint8_t *frame, uint8_t len)
+{
+    return esp_isotp_stream_send_frame_with_id(handle, handle->link.send_arbitration_id, frame, len);
+}
+
+/**
+ * @brief Copy bytes of a streamed send, reading the next chunk when needed.
+ *
+ * The bytes are copied in order, so only the chunk read last is kept.
+ *
+ * @note Task context, on_read may block.
+ * @return ESP_OK, or the error returned by on_read.
+ */
+static esp_err_t esp_isotp_stream_tx_copy(esp_isotp_handle_t handle, uint8_t *dst, uint32_t offset, uint32_t len)
+{
+    esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+
+    while (len) {
+        if (offset >= tx->chunk_offset + tx->chunk_len) {
+            const uint32_t next = tx->chunk_offset + tx->chunk_len;
+            const uint32_t chunk_len = MIN(tx->config.chunk_size, tx->size - next);
+            esp_err_t ret = tx->config.on_read(handle, next, tx->chunk, chunk_len, tx->config.user_arg);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+            tx->chunk_offset = next;
+            tx->chunk_len = chunk_len;
+        }
+        const uint32_t n = MIN(len, tx->chunk_offset + tx->chunk_len - offset);
+        memcpy(dst, tx->chunk + (offset - tx->chunk_offset), n);
+        dst += n;
+        offset += n;
+        len -= n;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Handle a flow control frame for a streamed send.
+ *
+ * @note Runs in ISR context.
+ * @return true if the send state changed and the poll task has to run.
+ */
+static bool esp_isotp_stream_tx_on_flow_control(esp_isotp_handle_t handle, const uint8_t *buf, uint8_t len)
+{
+    esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+    bool changed = true;
+
+    portENTER_CRITICAL_ISR(&handle->stream_lock);
+    // Flow control frames are only expected at the end of a block
+    if (len < 3 || tx->state != ESP_ISOTP_STREAM_WAIT_FC) {
+        changed = false;
+    } else {
+        switch (buf[0] & 0x0F) {
+        case ESP_ISOTP_FC_CONTINUE:
+            tx->bs_remain = buf[1];
+            tx->bs_unlimited = buf[1] == 0;
+            tx->st_min_us = esp_isotp_st_min_to_us(buf[2]);
+            tx->wft_count = 0;
+            tx->state = ESP_ISOTP_STREAM_SENDING;
+            break;
+        case ESP_ISOTP_FC_WAIT:
+            if (++tx->wft_count > ISO_TP_MAX_WFT_NUMBER) {
+                tx->result = ESP_ERR_TIMEOUT;
+                tx->state = ESP_ISOTP_STREAM_DONE;
+            } else {
+                tx->timer_bs = isotp_user_get_us() + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US;
+            }
+            break;
+        case ESP_ISOTP_FC_OVERFLOW:
+            tx->result = ESP_ERR_INVALID_SIZE;
+            tx->state = ESP_ISOTP_STREAM_DONE;
+            break;
+        default:
+            tx->result = ESP_ERR_INVALID_RESPONSE;
+            tx->state = ESP_ISOTP_STREAM_DONE;
+            break;
+        }
+    }
+    portEXIT_CRITICAL_ISR(&handle->stream_lock);
+
+    return changed;
+}
+
+/**
+ * @brief Send the flow control frame of the next block of a streamed reception.
+ *
+ * The block never exceeds the room left in the ring buffer. When the ring has no room for a
+ * consecutive frame, on_write is slower than the bus: the flow control frame is left to the
+ * poll context, which sends it once a chunk has been drained, and STmin is doubled to slow the
+ * sender down. STmin is halved again after ESP_ISOTP_STREAM_CLEAN_BLOCKS blocks without a full ring.
+ * When no TX frame is free for the flow control frame, the poll context sends it once a frame
+ * is done and the block size is doubled, so that the transfer needs fewer flow control frames.
+ *
+ * @note ISR-safe.
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_stream_rx_continue(esp_isotp_handle_t handle)
+{
+    esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+    const uint32_t now = isotp_user_get_us();
+    uint8_t fc[ESP_ISOTP_FRAME_MAX_LEN];
+    bool send = false;
+
+    portENTER_CRITICAL_SAFE(&handle->stream_lock);
+    if (rx->state == ESP_ISOTP_STREAM_RECEIVING) {
+        const uint32_t room = (2 * rx->config.chunk_size - (rx->head - rx->tail)) / rx->cf_len;
+        if (room == 0) {
+            if (!rx->ring_full) {
+                rx->ring_full = true;
+                rx->fc_pending_since = now;
+                rx->clean_blocks = 0;
+                rx->st_min_us = MIN(MAX(rx->st_min_us * 2, ESP_ISOTP_ST_MIN_STEP_US), rx->config.st_min_max_us);
+            }
+            rx->fc_pending = true;
+        } else {
+            if (!rx->ring_full && ++rx->clean_blocks >= ESP_ISOTP_STREAM_CLEAN_BLOCKS) {
+                rx->clean_blocks = 0;
+                rx->st_min_us = MAX(rx->st_min_us / 2 < ESP_ISOTP_ST_MIN_STEP_US ? 0 : rx->st_min_us / 2, rx->config.st_min_us);
+            }
+            rx->ring_full = false;
+            rx->fc_pending = false;
+            rx->bs = MIN(rx->bs_target, room);
+            rx->bs_count = 0;
+            rx->wft_count = 0;
+            rx->timer_cr = now + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US;
+            fc[0] = (ESP_ISOTP_PCI_TYPE_FLOW_CONTROL << 4) | ESP_ISOTP_FC_CONTINUE;
+            fc[1] = rx->bs;
+            fc[2] = esp_isotp_st_min_from_us(rx->st_min_us);
+            send = true;
+        }
+    }
+    portEXIT_CRITICAL_SAFE(&handle->stream_lock);
+
+    if (send && esp_isotp_stream_send_frame(handle, fc, 3) != ISOTP_RET_OK) {
+        portENTER_CRITICAL_SAFE(&handle->stream_lock);
+        rx->fc_pending = true;
+        rx->bs_target = MIN(rx->bs_target * 2, UINT8_MAX);
+        portEXIT_CRITICAL_SAFE(&handle->stream_lock);
+    }
+}
+
+/**
+ * @brief Copy received bytes of a streamed reception into the ring buffer, call with stream_lock held.
+ */
+static void esp_isotp_stream_rx_store(esp_isotp_stream_rx_t *rx, const uint8_t *data, uint32_t len)
+{
+    const uint32_t ring_size = 2 * rx->config.chunk_size;
+    const uint32_t pos = rx->head % ring_size;
+    const uint32_t n = MIN(len, ring_size - pos);
+
+    memcpy(rx->ring + pos, data, n);
+    memcpy(rx->ring, data + n, len - n);
+    rx->head += len;
+}
+
+/**
+ * @brief Start a streamed reception on a first frame.
+ *
+ * @note Runs in ISR context.
+ * @return true if the reception started and the poll task has to run.
+ */
+static bool esp_isotp_stream_rx_on_first_frame(esp_isotp_handle_t handle, const uint8_t *buf, uint8_t len)
+{
+    esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+
+    // A first frame fills a whole frame, 8 bytes or the CAN FD frame length of the sender
+    if (len < 8) {
+        return false;
+    }
+    uint32_t size = ((buf[0] & 0x0F) << 8) | buf[1];
+    uint8_t pos = 2;
+    if (size == 0) {
+        size = ((uint32_t)buf[2] << 24) | ((uint32_t)buf[3] << 16) | ((uint32_t)buf[4] << 8) | buf[5];
+        pos = 6;
+        if (size <= ESP_ISOTP_FF_DL_12BIT_MAX) {
+            return false;
+        }
+    }
+    // Messages fitting a single frame are invalid in a first frame
+    if (size <= (len == 8 ? 7U : len - 2U)) {
+        return false;
+    }
+    if (rx->config.max_size && size > rx->config.max_size) {
+        uint8_t fc[ESP_ISOTP_FRAME_MAX_LEN] = { (ESP_ISOTP_PCI_TYPE_FLOW_CONTROL << 4) | ESP_ISOTP_FC_OVERFLOW };
+        esp_isotp_stream_send_frame(handle, fc, 3);
+        return false;
+    }
+
+    portENTER_CRITICAL_ISR(&handle->stream_lock);
+    rx->size = size;
+    rx->head = 0;
+    rx->tail = 0;
+    rx->sn = 1;
+    rx->cf_len = len - 1;
+    rx->clean_blocks = 0;
+    rx->fc_pending = false;
+    rx->ring_full = false;
+    rx->state = ESP_ISOTP_STREAM_RECEIVING;
+    esp_isotp_stream_rx_store(rx, buf + pos, len - pos);
+    portEXIT_CRITICAL_ISR(&handle->stream_lock);
+
+    esp_isotp_stream_rx_continue(handle);
+    return true;
+}
+
+/**
+ * @brief Store a consecutive frame of a streamed reception.
+ *
+ * @note Runs in ISR context.
+ * @return true when a chunk is ready for on_write or the reception ended.
+ */
+static bool esp_isotp_stream_rx_on_consecutive_frame(esp_isotp_handle_t handle, const uint8_t *buf, uint8_t len)
+{
+    esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+    const uint32_t chunk = rx->config.chunk_size;
+    bool block_end = false;
+    bool wake = true;
+
+    portENTER_CRITICAL_ISR(&handle->stream_lock);
+    const uint32_t n = MIN((uint32_t)len - 1, rx->size - rx->head);
+    if (len < 2 || (buf[0] & 0x0F) != rx->sn || n > 2 * chunk - (rx->head - rx->tail)) {
+        // Wrong sequence number, or a sender ignoring the block size
+        rx->result = ESP_ERR_INVALID_RESPONSE;
+        rx->state = ESP_ISOTP_STREAM_DONE;
+    } else {
+        const uint32_t chunk_before = rx->head / chunk;
+        esp_isotp_stream_rx_store(rx, buf + 1, n);
+        rx->sn = (rx->sn + 1) & 0x0F;
+        rx->timer_cr = isotp_user_get_us() + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US;
+        wake = rx->head == rx->size || rx->head / chunk != chunk_before;
+        block_end = rx->head < rx->size && ++rx->bs_count == rx->bs;
+    }
+    portEXIT_CRITICAL_ISR(&handle->stream_lock);
+
+    if (block_end) {
+        esp_isotp_stream_rx_continue(handle);
+    }
+    return wake;
+}
+
+/**
+ * @brief Feed a received frame to the streamed transfers of a link.
+ *
+ * @note Runs in ISR context, before isotp_on_can_message().
+ * @param handle ISO-TP link handle.
+ * @param frame Received TWAI frame.
+ * @param[out] wake Set when the poll task has to run.
+ * @return true if the frame belongs to a streamed transfer, isotp-c does not get it.
+ */
+static bool esp_isotp_stream_on_frame(esp_isotp_handle_t handle, const twai_frame_t *frame, bool *wake)
+{
+    const uint8_t *buf = frame->buffer;
+    const uint8_t len = frame->buffer_len;
+
+    if (len == 0) {
+        return false;
+    }
+    switch (buf[0] >> 4) {
+    case ESP_ISOTP_PCI_TYPE_FLOW_CONTROL:
+        if (handle->stream_tx.state == ESP_ISOTP_STREAM_IDLE) {
+            return false;
+        }
+        *wake = esp_isotp_stream_tx_on_flow_control(handle, buf, len);
+        return true;
+    case ESP_ISOTP_PCI_TYPE_FIRST_FRAME:
+        if (handle->stream_rx.state != ESP_ISOTP_STREAM_WAIT_FF) {
+            return false;
+        }
+        *wake = esp_isotp_stream_rx_on_first_frame(handle, buf, len);
+        return true;
+    case ESP_ISOTP_PCI_TYPE_CONSECUTIVE:
+        if (handle->stream_rx.state != ESP_ISOTP_STREAM_RECEIVING) {
+            return false;
+        }
+        *wake = esp_isotp_stream_rx_on_consecutive_frame(handle, buf, len);
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Send the consecutive frames of a streamed send that STmin and the block size allow.
+ *
+ * @note Task context.
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_stream_tx_poll(esp_isotp_handle_t handle)
+{
+    esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+    const uint8_t tx_dl = handle->fd_frames ? ESP_ISOTP_FRAME_MAX_LEN : 8;
+
+    portENTER_CRITICAL(&handle->stream_lock);
+    if (tx->state == ESP_ISOTP_STREAM_WAIT_FC && esp_isotp_time_reached(isotp_user_get_us(), tx->timer_bs)) {
+        tx->result = ESP_ERR_TIMEOUT;
+        tx->state = ESP_ISOTP_STREAM_DONE;
+    }
+    portEXIT_CRITICAL(&handle->stream_lock);
+
+    while (tx->state == ESP_ISOTP_STREAM_SENDING) {
+        const uint32_t now = isotp_user_get_us();
+        if (tx->st_min_us && !esp_isotp_time_reached(now, tx->timer_st)) {
+            break;
+        }
+        const uint32_t len = MIN(tx_dl - 1U, tx->size - tx->offset);
+        if (!tx->frame_len) {
+            tx->frame[0] = (ESP_ISOTP_PCI_TYPE_CONSECUTIVE << 4) | tx->sn;
+            esp_err_t ret = esp_isotp_stream_tx_copy(handle, tx->frame + 1, tx->offset, len);
+            if (ret != ESP_OK) {
+                tx->result = ret;
+                tx->state = ESP_ISOTP_STREAM_DONE;
+                break;
+            }
+            tx->frame_len = len + 1;
+        }
+        // Wait for the flow control frame before sending the last frame of the block, it may come right after it
+        const bool block_end = !tx->bs_unlimited && tx->bs_remain == 1 && tx->offset + len < tx->size;
+        if (block_end) {
+            tx->timer_bs = now + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US;
+            tx->state = ESP_ISOTP_STREAM_WAIT_FC;
+        }
+        tx->timer_st = now + tx->st_min_us;
+        int ret = esp_isotp_stream_send_frame_with_id(handle, tx->arbitration_id, tx->frame, tx->frame_len);
+        if (ret != ISOTP_RET_OK) {
+            tx->state = ESP_ISOTP_STREAM_SENDING;
+            if (ret == ISOTP_RET_NOSPACE) {
+                // The TX done callback wakes the poll task up when a frame is free again
+                tx->pool_stalls++;
+                break;
+            }
+            tx->result = ESP_FAIL;
+            tx->state = ESP_ISOTP_STREAM_DONE;
+            break;
+        }
+        tx->frame_len = 0;
+        tx->offset += len;
+        tx->sn = (tx->sn + 1) & 0x0F;
+        if (tx->offset == tx->size) {
+            tx->result = ESP_OK;
+            tx->state = ESP_ISOTP_STREAM_DONE;
+        } else if (!block_end && !tx->bs_unlimited) {
+            tx->bs_remain--;
+        }
+    }
+
+    if (tx->state == ESP_ISOTP_STREAM_DONE) {
+        ESP_LOGD(TAG, "Streamed send of %" PRIu32 "/%" PRIu32 " bytes done (%s), %" PRIu32 " TX pool stalls",
+                 tx->offset, tx->size, esp_err_to_name(tx->result), tx->pool_stalls);
+        tx->state = ESP_ISOTP_STREAM_IDLE;
+        if (tx->config.on_done) {
+            tx->config.on_done(handle, tx->offset, tx->result, tx->config.user_arg);
+        }
+    }
+}
+
+/**
+ * @brief Drain the received chunks of a streamed reception into on_write and send the pending flow control frame.
+ *
+ * @note Task context.
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_stream_rx_poll(esp_isotp_handle_t handle)
+{
+    esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+    const uint32_t chunk = rx->config.chunk_size;
+
+    if (rx->state == ESP_ISOTP_STREAM_RECEIVING) {
+        // The chunks start at multiples of chunk_size, they never wrap around the ring
+        while (true) {
+            const uint32_t head = rx->head;
+            const uint32_t avail = head - rx->tail;
+            if (avail < chunk && !(avail && head == rx->size)) {
+                break;
+            }
+            const uint32_t n = MIN(avail, chunk);
+            esp_err_t ret = rx->config.on_write(handle, rx->tail, rx->ring + rx->tail % (2 * chunk), n, rx->config.user_arg);
+            portENTER_CRITICAL(&handle->stream_lock);
+            if (ret == ESP_OK) {
+                rx->tail += n;
+            } else if (rx->state == ESP_ISOTP_STREAM_RECEIVING) {
+                rx->result = ret;
+                rx->state = ESP_ISOTP_STREAM_DONE;
+            }
+            portEXIT_CRITICAL(&handle->stream_lock);
+            if (ret != ESP_OK) {
+                break;
+            }
+        }
+
+        const uint32_t now = isotp_user_get_us();
+        portENTER_CRITICAL(&handle->stream_lock);
+        if (rx->state == ESP_ISOTP_STREAM_RECEIVING) {
+            if (rx->tail == rx->size) {
+                rx->result = ESP_OK;
+                rx->state = ESP_ISOTP_STREAM_DONE;
+            } else if (!rx->fc_pending && esp_isotp_time_reached(now, rx->timer_cr)) {
+                rx->result = ESP_ERR_TIMEOUT;
+                rx->state = ESP_ISOTP_STREAM_DONE;
+            }
+        }
+        const bool fc_pending = rx->state == ESP_ISOTP_STREAM_RECEIVING && rx->fc_pending;
+        portEXIT_CRITICAL(&handle->stream_lock);
+
+        if (fc_pending) {
+            esp_isotp_stream_rx_continue(handle);
+            // Still no room, keep the sender waiting
+            bool send_wait = false;
+            portENTER_CRITICAL(&handle->stream_lock);
+            if (rx->state == ESP_ISOTP_STREAM_RECEIVING && rx->ring_full &&
+                    esp_isotp_time_reached(now, rx->fc_pending_since + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US / 2)) {
+                if (++rx->wft_count > ISO_TP_MAX_WFT_NUMBER) {
+                    rx->result = ESP_ERR_TIMEOUT;
+                    rx->state = ESP_ISOTP_STREAM_DONE;
+                } else {
+                    rx->fc_pending_since = now;
+                    send_wait = true;
+                }
+            }
+            portEXIT_CRITICAL(&handle->stream_lock);
+            if (send_wait) {
+                uint8_t fc[ESP_ISOTP_FRAME_MAX_LEN] = { (ESP_ISOTP_PCI_TYPE_FLOW_CONTROL << 4) | ESP_ISOTP_FC_WAIT };
+                esp_isotp_stream_send_frame(handle, fc, 3);
+            }
+        }
+    }
+
+    if (rx->state == ESP_ISOTP_STREAM_DONE) {
+        ESP_LOGD(TAG, "Streamed reception of %" PRIu32 "/%" PRIu32 " bytes done (%s), block size %u, STmin %" PRIu32 " us",
+                 rx->tail, rx->size, esp_err_to_name(rx->result), rx->bs_target, rx->st_min_us);
+        rx->state = ESP_ISOTP_STREAM_IDLE;
+        if (rx->config.on_done) {
+            rx->config.on_done(handle, rx->tail, rx->result, rx->config.user_arg);
+        }
+    }
+}
+
+/**
+ * @brief Run the streamed transfers of a link.
+ *
+ * @note Task context.
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_stream_poll(esp_isotp_handle_t handle)
+{
+    if (handle->stream_tx.state != ESP_ISOTP_STREAM_IDLE) {
+        esp_isotp_stream_tx_poll(handle);
+    }
+    if (handle->stream_rx.state != ESP_ISOTP_STREAM_IDLE) {
+        esp_isotp_stream_rx_poll(handle);
+    }
+}
+
+/**
+ * @brief Check whether a streamed transfer of a link waits for a free TX frame.
+ *
+ * @note ISR-safe.
+ */
+static inline bool esp_isotp_stream_waits_tx_frame(esp_isotp_handle_t handle)
+{
+    return handle->stream_tx.state == ESP_ISOTP_STREAM_SENDING ||
+           (handle->stream_rx.state == ESP_ISOTP_STREAM_RECEIVING && handle->stream_rx.fc_pending);
+}
+
+/**
+ * @brief Feed a received TWAI frame to the ISO-TP state machine of a link.
+ *
+ * @note Runs in ISR context.
+ * @param link_handle ISO-TP link handle the frame is addressed to.
+ * @param frame Received TWAI frame.
+ * @return true when the poll task has been woken up and a context switch is needed, false otherwise.
+ */
+static bool esp_isotp_link_on_frame(esp_isotp_handle_t link_handle, const twai_frame_t *frame)
+{
+    uint8_t receive_status = link_handle->link.receive_status;
+    bool stream_wake = false;
+
+    // Feed received TWAI frame to isotp-c state machine for reassembly, unless it belongs to a streamed transfer.
+    // isotp-c will handle single/multi-frame logic and send flow control frames as needed.
+    if (!esp_isotp_stream_on_frame(link_handle, frame, &stream_wake)) {
+        isotp_on_can_message(&link_handle->link, frame->buffer, frame->buffer_len);
+    }
+
+    // Wake the poll task on flow control frames, which resume the send, and when a reception
+    // starts or ends, which changes the timeout to wait for.
+    BaseType_t task_woken = pdFALSE;
+    if (link_handle->poll_task && (stream_wake || link_handle->link.send_status == ISOTP_SEND_STATUS_INPROGRESS ||
+                                   link_handle->link.receive_status != receive_status)) {
+        vTaskNotifyGiveFromISR(link_handle->poll_task, &task_woken);
+    }
+
+    return task_woken == pdTRUE;
+}
+
 /**
  * @brief TWAI transmit done callback.
  *
@@ -126,19 +930,25 @@ static void esp_isotp_tx_wrapper(void *link, uint32_t tx_size, void *user_arg)
  * @param handle TWAI node handle invoking the callback.
  * @param edata Transmit event data from TWAI driver.
  * @param user_ctx User context pointer (esp_isotp_handle_t).
- * @return Always returns false (no context switch needed).
+ * @return true when the poll task has been woken up and a context switch is needed, false otherwise.
  */
 static IRAM_ATTR bool esp_isotp_tx_callback(twai_node_handle_t handle, const twai_tx_done_event_data_t *edata, void *user_ctx)
 {
     esp_isotp_handle_t isotp_handle = (esp_isotp_handle_t) user_ctx;
+    BaseType_t task_woken = pdFALSE;
     // Return the used frame back to the SLIST pool.
     if (isotp_handle && edata->done_tx_frame) {
         esp_isotp_frame_t *tx_frame = (esp_isotp_frame_t *)edata->done_tx_frame;
+        bool pool_was_empty = SLIST_EMPTY(&isotp_handle->tx_frame_pool);
         // Return frame to SLIST pool for reuse
         SLIST_INSERT_HEAD(&isotp_handle->tx_frame_pool, tx_frame, link);
+        // The poll task waits for a free frame to send the next consecutive frame
+        if (pool_was_empty && isotp_handle->poll_task) {
+            vTaskNotifyGiveFromISR(isotp_handle->poll_task, &task_woken);
+        }
     }
 
-    return false;
+    return task_woken == pdTRUE;
 }
 
 /**
@@ -160,6 +970,8 @@ static IRAM_ATTR bool esp_isotp_rx_callback(twai_node_handle_t handle, const twa
     }
 
     esp_isotp_frame_t *rx_frame = &link_handle->isr_rx_frame_buffer;
+    // The whole buffer is available to every frame, up to 64 bytes for CAN FD frames
+    rx_frame->frame.buffer_len = sizeof(rx_frame->data_payload);
 
     if (twai_node_receive_from_isr(handle, &rx_frame->frame) != ESP_OK) {
         return false;
@@ -170,11 +982,193 @@ static IRAM_ATTR bool esp_isotp_rx_callback(twai_node_handle_t handle, const twa
         return false;
     }
 
-    // Feed received TWAI frame to isotp-c state machine for reassembly.
-    // isotp-c will handle single/multi-frame logic and send flow control frames as needed.
-    isotp_on_can_message(&link_handle->link, rx_frame->frame.buffer, rx_frame->frame.buffer_len);
+    return esp_isotp_link_on_frame(link_handle, &rx_frame->frame);
+}
+
+static inline uint32_t esp_isotp_mux_hash(uint32_t id)
+{
+    return (id ^ (id >> 8) ^ (id >> 16)) & (ESP_ISOTP_MUX_HASH_SIZE - 1);
+}
 
-    return false;
+/**
+ * @brief Find the link of a multiplexer receiving an ID, call with links_lock held.
+ *
+ * @return Link handle, NULL if no link receives this ID.
+ */
+static esp_isotp_handle_t esp_isotp_mux_find_link(esp_isotp_mux_handle_t mux, uint32_t rx_id)
+{
+    esp_isotp_handle_t link;
+    SLIST_FOREACH(link, &mux->links[esp_isotp_mux_hash(rx_id)], mux_entry) {
+        if (link->link.receive_arbitration_id == rx_id) {
+            return link;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Hand the queued frames of a multiplexer over to the TWAI driver, flow control frames first.
+ *
+ * At most tx_queue_depth frames are queued in the driver, the others wait in the multiplexer
+ * queues, so that a flow control frame only waits for the frames already in the driver.
+ * Only one context feeds the driver at a time, which keeps the frames of every link in order,
+ * the driver itself is called outside of tx_lock.
+ *
+ * @note ISR-safe.
+ * @param mux ISO-TP multiplexer handle.
+ */
+static void esp_isotp_mux_feed_driver(esp_isotp_mux_handle_t mux)
+{
+    uint32_t failed = 0;
+
+    portENTER_CRITICAL_SAFE(&mux->tx_lock);
+    if (mux->tx_feeding) {
+        // The other context sends the frame after its current one
+        portEXIT_CRITICAL_SAFE(&mux->tx_lock);
+        return;
+    }
+    mux->tx_feeding = true;
+    while (mux->tx_in_driver < mux->tx_queue_depth) {
+        struct frame_queue_head *queue = STAILQ_EMPTY(&mux->tx_fc_queue) ? &mux->tx_data_queue : &mux->tx_fc_queue;
+        esp_isotp_frame_t *tx_frame = STAILQ_FIRST(queue);
+        if (tx_frame == NULL) {
+            break;
+        }
+        STAILQ_REMOVE_HEAD(queue, pending);
+        mux->tx_in_driver++;
+        portEXIT_CRITICAL_SAFE(&mux->tx_lock);
+
+        esp_err_t ret = twai_node_transmit(mux->twai_node, &tx_frame->frame, 0);
+
+        portENTER_CRITICAL_SAFE(&mux->tx_lock);
+        if (ret != ESP_OK) {
+            // Return frame to the pool, the transfer of the link times out
+            mux->tx_in_driver--;
+            SLIST_INSERT_HEAD(&mux->tx_frame_pool, tx_frame, link);
+            mux->tx_frames_free++;
+            failed++;
+        }
+    }
+    mux->tx_feeding = false;
+    portEXIT_CRITICAL_SAFE(&mux->tx_lock);
+
+    if (failed) {
+        ESP_EARLY_LOGE(TAG, "Failed to send %" PRIu32 " TWAI frames", failed);
+    }
+}
+
+/**
+ * @brief Wake up the poll tasks of the links of a multiplexer which are sending a message.
+ *
+ * @note Runs in ISR context, when a frame is free again after the pool ran short of frames.
+ * @param mux ISO-TP multiplexer handle.
+ * @return true when a poll task has been woken up and a context switch is needed, false otherwise.
+ */
+static bool esp_isotp_mux_wake_senders(esp_isotp_mux_handle_t mux)
+{
+    BaseType_t task_woken = pdFALSE;
+    esp_isotp_handle_t link;
+
+    portENTER_CRITICAL_ISR(&mux->links_lock);
+    for (size_t i = 0; i < ESP_ISOTP_MUX_HASH_SIZE; i++) {
+        SLIST_FOREACH(link, &mux->links[i], mux_entry) {
+            if (link->poll_task && (link->link.send_status == ISOTP_SEND_STATUS_INPROGRESS ||
+                                    esp_isotp_stream_waits_tx_frame(link))) {
+                vTaskNotifyGiveFromISR(link->poll_task, &task_woken);
+            }
+        }
+    }
+    portEXIT_CRITICAL_ISR(&mux->links_lock);
+
+    return task_woken == pdTRUE;
+}
+
+/**
+ * @brief TWAI transmit done callback of a multiplexer.
+ *
+ * Returns the used frame back to the shared pool and hands the next queued frame over to the driver.
+ *
+ * @note Runs in ISR context.
+ * @param handle TWAI node handle invoking the callback.
+ * @param edata Transmit event data from TWAI driver.
+ * @param user_ctx User context pointer (esp_isotp_mux_handle_t).
+ * @return true when a poll task has been woken up and a context switch is needed, false otherwise.
+ */
+static IRAM_ATTR bool esp_isotp_mux_tx_callback(twai_node_handle_t handle, const twai_tx_done_event_data_t *edata, void *user_ctx)
+{
+    esp_isotp_mux_handle_t mux = (esp_isotp_mux_handle_t)user_ctx;
+    if (!mux || !edata->done_tx_frame) {
+        return false;
+    }
+
+    esp_isotp_frame_t *tx_frame = (esp_isotp_frame_t *)edata->done_tx_frame;
+    portENTER_CRITICAL_ISR(&mux->tx_lock);
+    // Frames other than flow control frames could not be sent while the reserved frames were the only free ones
+    bool pool_was_short = mux->tx_frames_free <= ESP_ISOTP_MUX_FC_RESERVED_FRAMES;
+    SLIST_INSERT_HEAD(&mux->tx_frame_pool, tx_frame, link);
+    mux->tx_frames_free++;
+    mux->tx_in_driver--;
+    portEXIT_CRITICAL_ISR(&mux->tx_lock);
+
+    esp_isotp_mux_feed_driver(mux);
+
+    return pool_was_short && esp_isotp_mux_wake_senders(mux);
+}
+
+/**
+ * @brief TWAI receive done callback of a multiplexer.
+ *
+ * Dispatches the received TWAI frame to the link receiving its ID, through the hash table.
+ *
+ * @note Runs in ISR context.
+ * @param handle TWAI node handle invoking the callback.
+ * @param edata Receive event data from TWAI driver (unused).
+ * @param user_ctx User context pointer (esp_isotp_mux_handle_t).
+ * @return true to request a context switch to a higher-priority task, false otherwise.
+ */
+static IRAM_ATTR bool esp_isotp_mux_rx_callback(twai_node_handle_t handle, const twai_rx_done_event_data_t *edata, void *user_ctx)
+{
+    esp_isotp_mux_handle_t mux = (esp_isotp_mux_handle_t)user_ctx;
+    if (!mux) {
+        return false;
+    }
+
+    esp_isotp_frame_t *rx_frame = &mux->isr_rx_frame_buffer;
+    rx_frame->frame.buffer_len = sizeof(rx_frame->data_payload);
+    if (twai_node_receive_from_isr(handle, &rx_frame->frame) != ESP_OK) {
+        return false;
+    }
+
+    // The link cannot be deleted while it is fed the frame, see esp_isotp_delete()
+    portENTER_CRITICAL_ISR(&mux->links_lock);
+    esp_isotp_handle_t link_handle = esp_isotp_mux_find_link(mux, rx_frame->frame.header.id);
+    mux->rx_dispatching = link_handle;
+    portEXIT_CRITICAL_ISR(&mux->links_lock);
+    if (!link_handle) {
+        return false;
+    }
+
+    bool need_yield = esp_isotp_link_on_frame(link_handle, &rx_frame->frame);
+
+    portENTER_CRITICAL_ISR(&mux->links_lock);
+    mux->rx_dispatching = NULL;
+    portEXIT_CRITICAL_ISR(&mux->links_lock);
+
+    return need_yield;
+}
+
+/**
+ * @brief Check whether a consecutive frame can get a TX frame.
+ *
+ * @param handle ISO-TP link handle.
+ * @return true if a TX frame is free, for the link or in the shared pool of its multiplexer.
+ */
+static inline bool esp_isotp_tx_frame_available(esp_isotp_handle_t handle)
+{
+    if (handle->mux) {
+        return handle->mux->tx_frames_free > ESP_ISOTP_MUX_FC_RESERVED_FRAMES;
+    }
+    return !SLIST_EMPTY(&handle->tx_frame_pool);
 }
 
 /**
@@ -191,6 +1185,87 @@ uint32_t isotp_user_get_us(void)
     return (uint32_t)esp_timer_get_time();
 }
 
+/**
+ * @brief Initialize a TX frame with a payload of a link.
+ *
+ * @param isotp_handle ISO-TP link handle, for its CAN FD settings.
+ * @param tx_frame Frame to initialize.
+ * @param arbitration_id TWAI identifier (11-bit or 29-bit).
+ * @param data Pointer to frame payload.
+ * @param size Payload length in bytes.
+ * @return false if the payload does not fit a frame of the link.
+ */
+static bool esp_isotp_frame_fill(esp_isotp_handle_t isotp_handle, esp_isotp_frame_t *tx_frame, uint32_t arbitration_id,
+                                 const uint8_t *data, uint8_t size)
+{
+    // Initialize TWAI frame header and copy payload data into embedded buffer.
+    memset(&tx_frame->frame, 0, sizeof(twai_frame_t));
+    tx_frame->frame.header.id = arbitration_id;
+    tx_frame->frame.header.ide = is_extended_id(arbitration_id);  // Extended (29-bit) vs Standard (11-bit) ID
+
+    // Size validation - TWAI frames are max 8 bytes by protocol, 64 bytes for CAN FD
+    uint8_t frame_len = size;
+    if (isotp_handle->fd_frames) {
+        frame_len = esp_isotp_fd_frame_len(size);
+        tx_frame->frame.header.fdf = 1;
+        tx_frame->frame.header.brs = isotp_handle->fd_bitrate_switch;
+    }
+    if (size > (isotp_handle->fd_frames ? ESP_ISOTP_FRAME_MAX_LEN : 8)) {
+        return false;
+    }
+
+    // Copy payload into the embedded buffer to ensure data lifetime during async transmission.
+    memcpy(tx_frame->data_payload, data, size);
+    // CAN FD frames longer than 8 bytes only have a few lengths, the rest of the frame is padding
+    memset(tx_frame->data_payload + size, ESP_ISOTP_FD_PADDING_VALUE, frame_len - size);
+
+    tx_frame->frame.buffer = tx_frame->data_payload;
+    tx_frame->frame.buffer_len = frame_len;
+    return true;
+}
+
+/**
+ * @brief Queue a TWAI frame of a link of a multiplexer.
+ *
+ * Flow control frames go to the high priority queue and may use the frames reserved for them,
+ * the other frames wait behind them.
+ *
+ * @note ISR-safe.
+ * @return Same as isotp_user_send_can().
+ */
+static int esp_isotp_mux_send_can(esp_isotp_handle_t isotp_handle, uint32_t arbitration_id, const uint8_t *data, uint8_t size)
+{
+    esp_isotp_mux_handle_t mux = isotp_handle->mux;
+    const bool flow_control = size && (data[0] >> 4) == ESP_ISOTP_PCI_TYPE_FLOW_CONTROL;
+
+    portENTER_CRITICAL_SAFE(&mux->tx_lock);
+    esp_isotp_frame_t *tx_frame = NULL;
+    if (mux->tx_frames_free > (flow_control ? 0 : ESP_ISOTP_MUX_FC_RESERVED_FRAMES)) {
+        tx_frame = SLIST_FIRST(&mux->tx_frame_pool);
+        SLIST_REMOVE_HEAD(&mux->tx_frame_pool, link);
+        mux->tx_frames_free--;
+    }
+    portEXIT_CRITICAL_SAFE(&mux->tx_lock);
+    if (tx_frame == NULL) {
+        return ISOTP_RET_NOSPACE;
+    }
+
+    bool valid = esp_isotp_frame_fill(isotp_handle, tx_frame, arbitration_id, data, size);
+
+    portENTER_CRITICAL_SAFE(&mux->tx_lock);
+    if (valid) {
+        STAILQ_INSERT_TAIL(flow_control ? &mux->tx_fc_queue : &mux->tx_data_queue, tx_frame, pending);
+    } else {
+        SLIST_INSERT_HEAD(&mux->tx_frame_pool, tx_frame, link);
+        mux->tx_frames_free++;
+    }
+    portEXIT_CRITICAL_SAFE(&mux->tx_lock);
+    ESP_RETURN_ON_FALSE_ISR(valid, ISOTP_RET_ERROR, TAG, "Invalid TWAI frame size");
+
+    esp_isotp_mux_feed_driver(mux);
+    return ISOTP_RET_OK;
+}
+
 /**
  * @brief isotp-c library stub function: send twai message
  *
@@ -198,9 +1273,10 @@ uint32_t isotp_user_get_us(void)
  *
  * @param arbitration_id TWAI identifier (11-bit or 29-bit).
  * @param data Pointer to frame payload.
- * @param size Payload length in bytes (0–8).
+ * @param size Payload length in bytes (0–8, 0-64 for CAN FD links).
  * @param user_data Optional ISO-TP link handle.
  * @retval ISOTP_RET_OK Frame queued successfully.
+ * @retval ISOTP_RET_NOSPACE No free frame in the TX frame pool.
  * @retval ISOTP_RET_ERROR Transmission failed or invalid context.
  */
 int isotp_user_send_can(const uint32_t arbitration_id, const uint8_t *data, const uint8_t size, void *user_data)
@@ -208,69 +1284,260 @@ int isotp_user_send_can(const uint32_t arbitration_id, const uint8_t *data, cons
     esp_isotp_handle_t isotp_handle = (esp_isotp_handle_t) user_data;
     ESP_RETURN_ON_FALSE_ISR(isotp_handle != NULL, ISOTP_RET_ERROR, TAG, "Invalid ISO-TP handle");
 
+    if (isotp_handle->mux) {
+        return esp_isotp_mux_send_can(isotp_handle, arbitration_id, data, size);
+    }
+
     twai_node_handle_t twai_node = isotp_handle->twai_node;
 
     // Get a pre-allocated frame from the SLIST pool.
     // This avoids dynamic allocation overhead completely.
+    // An empty pool is not an error, isotp-c sends the consecutive frame again at the next poll,
+    // once a frame has been returned by the TX done callback.
     esp_isotp_frame_t *tx_frame = SLIST_FIRST(&isotp_handle->tx_frame_pool);
-    ESP_RETURN_ON_FALSE_ISR(tx_frame != NULL, ISOTP_RET_ERROR, TAG, "No available frames in pool");
+    if (tx_frame == NULL) {
+        return ISOTP_RET_NOSPACE;
+    }
 
     // Remove frame from pool
     SLIST_REMOVE_HEAD(&isotp_handle->tx_frame_pool, link);
 
-    // Initialize TWAI frame header and copy payload data into embedded buffer.
-    memset(&tx_frame->frame, 0, sizeof(twai_frame_t));
-    tx_frame->frame.header.id = arbitration_id;
-    tx_frame->frame.header.ide = is_extended_id(arbitration_id);  // Extended (29-bit) vs Standard (11-bit) ID
+    if (!esp_isotp_frame_fill(isotp_handle, tx_frame, arbitration_id, data, size)) {
+        SLIST_INSERT_HEAD(&isotp_handle->tx_frame_pool, tx_frame, link);
+        ESP_EARLY_LOGE(TAG, "Invalid TWAI frame size");
+        return ISOTP_RET_ERROR;
+    }
+
+    // Send the frame; TX callback will return frame to pool on completion.
+    esp_err_t ret = twai_node_transmit(twai_node, &tx_frame->frame, 0);
+    if (ret != ESP_OK) {
+        // Return frame to SLIST pool if sending failed immediately.
+        SLIST_INSERT_HEAD(&isotp_handle->tx_frame_pool, tx_frame, link);
+        ESP_EARLY_LOGE(TAG, "Failed to send TWAI frame: %s", esp_err_to_name(ret));
+        return ISOTP_RET_ERROR;
+    }
+
+    return ISOTP_RET_OK;
+}
+
+/**
+ * @brief Print a formatted debug message from isotp-c.
+ *
+ * @param message Format string.
+ * @param ... Variadic arguments for the format string.
+ */
+void isotp_user_debug(const char *message, ...)
+{
+    va_list args;
+    va_start(args, message);
+    esp_log_writev(ESP_LOG_DEBUG, "isotp_c", message, args);
+    va_end(args);
+}
+
+/**
+ * @brief Get the time until the next deadline of the link state machine.
+ *
+ * The deadlines are the STmin expiry before the next consecutive frame, and the timeouts
+ * of the send and of the reception in progress, including the streamed ones.
+ *
+ * @param handle ISO-TP link handle.
+ * @param[out] wait_us Time until the next deadline, 0 if isotp_poll() has work to do right away.
+ * @return false if there is no deadline, the poll task waits for the next event.
+ */
+static bool esp_isotp_poll_next_deadline(esp_isotp_handle_t handle, int32_t *wait_us)
+{
+    const uint32_t now = isotp_user_get_us();
+    bool has_deadline = false;
+    int32_t wait = INT32_MAX;
+
+    if (handle->link.send_status == ISOTP_SEND_STATUS_INPROGRESS) {
+        wait = (int32_t)(handle->link.send_timer_bs - now);
+        has_deadline = true;
+        // Without a pending flow control frame or a free TX frame, the RX and TX done callbacks wake the task
+        if (handle->link.send_bs_remain != 0 && esp_isotp_tx_frame_available(handle)) {
+            int32_t st_wait = handle->link.send_st_min_us ? (int32_t)(handle->link.send_timer_st - now) : 0;
+            wait = MIN(wait, st_wait);
+        }
+    }
+    if (handle->link.receive_status == ISOTP_RECEIVE_STATUS_INPROGRESS) {
+        wait = MIN(wait, (int32_t)(handle->link.receive_timer_cr - now));
+        has_deadline = true;
+    }
 
-    // Size validation - TWAI frames are max 8 bytes by protocol
-    ESP_RETURN_ON_FALSE_ISR(size <= 8, ISOTP_RET_ERROR, TAG, "Invalid TWAI frame size");
+    const esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+    if (tx->state == ESP_ISOTP_STREAM_WAIT_FC) {
+        wait = MIN(wait, (int32_t)(tx->timer_bs - now));
+        has_deadline = true;
+    } else if (tx->state == ESP_ISOTP_STREAM_DONE ||
+               (tx->state == ESP_ISOTP_STREAM_SENDING && esp_isotp_tx_frame_available(handle))) {
+        wait = MIN(wait, tx->state == ESP_ISOTP_STREAM_SENDING && tx->st_min_us ? (int32_t)(tx->timer_st - now) : 0);
+        has_deadline = true;
+    }
+    const esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+    if (rx->state == ESP_ISOTP_STREAM_DONE) {
+        wait = 0;
+        has_deadline = true;
+    } else if (rx->state == ESP_ISOTP_STREAM_RECEIVING) {
+        const uint32_t avail = rx->head - rx->tail;
+        if (avail >= rx->config.chunk_size || (avail && rx->head == rx->size)) {
+            wait = 0;
+        } else if (rx->ring_full) {
+            wait = MIN(wait, (int32_t)(rx->fc_pending_since + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US / 2 - now));
+        } else if (!rx->fc_pending) {
+            wait = MIN(wait, (int32_t)(rx->timer_cr - now));
+        }
+        // A flow control frame waiting for a free TX frame is sent when the TX done callback wakes the task
+        has_deadline = has_deadline || wait != INT32_MAX;
+    }
+    *wait_us = MAX(wait, 0);
+    return has_deadline;
+}
 
-    // Copy payload into the embedded buffer to ensure data lifetime during async transmission.
-    memcpy(tx_frame->data_payload, data, size);
+static void esp_isotp_poll_timer_cb(void *arg)
+{
+    esp_isotp_handle_t handle = (esp_isotp_handle_t)arg;
+    // The timer may expire while the link is deleted, the task is then gone or exiting
+    TaskHandle_t task = handle->poll_task;
+    if (task && !handle->poll_task_exit) {
+        xTaskNotifyGive(task);
+    }
+}
 
-    tx_frame->frame.buffer = tx_frame->data_payload;
-    tx_frame->frame.buffer_len = size;
+/**
+ * @brief Built-in task driving the link state machine.
+ *
+ * Runs isotp_poll() when woken up by the RX and TX done callbacks, by esp_isotp_send(), or by
+ * the poll timer, which is armed at the next deadline instead of polling periodically.
+ *
+ * @param arg ISO-TP link handle.
+ */
+static void esp_isotp_poll_task(void *arg)
+{
+    esp_isotp_handle_t handle = (esp_isotp_handle_t)arg;
+    int32_t wait_us;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (handle->poll_task_exit) {
+            // The timer may have been armed by the last poll, it must not fire once the task is deleted
+            esp_timer_stop(handle->poll_timer);
+            break;
+        }
+        esp_timer_stop(handle->poll_timer);
+        // Send the consecutive frames back to back while STmin allows it
+        bool has_deadline;
+        do {
+            isotp_poll(&handle->link);
+            esp_isotp_stream_poll(handle);
+            has_deadline = esp_isotp_poll_next_deadline(handle, &wait_us);
+        } while (has_deadline && wait_us == 0);
+        if (has_deadline) {
+            esp_timer_start_once(handle->poll_timer, wait_us);
+        }
+    }
 
-    // Send the frame; TX callback will return frame to pool on completion.
-    esp_err_t ret = twai_node_transmit(twai_node, &tx_frame->frame, 0);
-    if (ret != ESP_OK) {
-        // Return frame to SLIST pool if sending failed immediately.
-        SLIST_INSERT_HEAD(&isotp_handle->tx_frame_pool, tx_frame, link);
-        ESP_EARLY_LOGE(TAG, "Failed to send TWAI frame: %s", esp_err_to_name(ret));
-        return ISOTP_RET_ERROR;
+    xSemaphoreGive(handle->poll_task_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wake the poll task up, if the link has one.
+ *
+ * @note ISR-safe.
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_poll_task_wake(esp_isotp_handle_t handle)
+{
+    if (!handle->poll_task || handle->poll_task_exit) {
+        return;
     }
+    if (xPortInIsrContext()) {
+        BaseType_t task_woken = pdFALSE;
+        vTaskNotifyGiveFromISR(handle->poll_task, &task_woken);
+        portYIELD_FROM_ISR(task_woken);
+    } else {
+        xTaskNotifyGive(handle->poll_task);
+    }
+}
 
-    return ISOTP_RET_OK;
+/**
+ * @brief Stop the poll task and free its resources.
+ *
+ * @param handle ISO-TP link handle.
+ */
+static void esp_isotp_poll_task_stop(esp_isotp_handle_t handle)
+{
+    if (handle->poll_task) {
+        // From here on the timer callback does not notify the task anymore, and the task stops the timer on exit
+        handle->poll_task_exit = true;
+        xTaskNotifyGive(handle->poll_task);
+        xSemaphoreTake(handle->poll_task_done, portMAX_DELAY);
+    }
+    // The task does not arm the timer anymore, it can be deleted before the task handle is dropped
+    if (handle->poll_timer) {
+        esp_timer_stop(handle->poll_timer);
+        esp_timer_delete(handle->poll_timer);
+        handle->poll_timer = NULL;
+    }
+    handle->poll_task = NULL;
+    if (handle->poll_task_done) {
+        vSemaphoreDelete(handle->poll_task_done);
+        handle->poll_task_done = NULL;
+    }
 }
 
 /**
- * @brief Print a formatted debug message from isotp-c.
+ * @brief Free the memory of a link, after its poll task has been stopped.
  *
- * @param message Format string.
- * @param ... Variadic arguments for the format string.
+ * @param isotp ISO-TP link handle.
  */
-void isotp_user_debug(const char *message, ...)
+static void esp_isotp_free_link(esp_isotp_handle_t isotp)
 {
-    va_list args;
-    va_start(args, message);
-    esp_log_writev(ESP_LOG_DEBUG, "isotp_c", message, args);
-    va_end(args);
+    esp_isotp_poll_task_stop(isotp);
+    if (isotp->isotp_rx_buffer) {
+        free(isotp->isotp_rx_buffer);
+    }
+    if (isotp->isotp_tx_buffer) {
+        free(isotp->isotp_tx_buffer);
+    }
+    // Clean up TX frame array (SLIST pool is automatically cleaned when frames are freed).
+    if (isotp->tx_frame_array) {
+        free(isotp->tx_frame_array);
+    }
+    free(isotp->rx_slot_mem);
+    free(isotp->rx_slot_size);
+    free(isotp->rx_slot_state);
+    free(isotp->rx_ready_fifo);
+    free(isotp->stream_tx.chunk);
+    free(isotp->stream_rx.ring);
+    free(isotp);
 }
 
-esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_config_t *config, esp_isotp_handle_t *out_handle)
+/**
+ * @brief Allocate and initialize an ISO-TP link, without binding it to a TWAI node.
+ *
+ * @param config Transport configuration.
+ * @param mux Multiplexer providing the TX frames of the link, NULL for a link with its own TX frame pool.
+ * @param[out] out_handle Returned ISO-TP link handle.
+ * @return Same as esp_isotp_new_transport().
+ */
+static esp_err_t esp_isotp_new_link(const esp_isotp_config_t *config, esp_isotp_mux_handle_t mux, esp_isotp_handle_t *out_handle)
 {
     esp_err_t ret = ESP_OK;
     esp_isotp_handle_t isotp = NULL;
-    ESP_RETURN_ON_FALSE(twai_node && config && out_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
     ESP_RETURN_ON_FALSE(config->tx_buffer_size > 0 && config->rx_buffer_size > 0, ESP_ERR_INVALID_SIZE, TAG, "Buffer sizes must be greater than 0");
-    ESP_RETURN_ON_FALSE(config->tx_frame_pool_size != 0, ESP_ERR_INVALID_SIZE, TAG, "TX frame pool size cannot be zero");
+    ESP_RETURN_ON_FALSE(mux || config->tx_frame_pool_size != 0, ESP_ERR_INVALID_SIZE, TAG, "TX frame pool size cannot be zero");
 
     // Validate ID ranges - each ID is validated against its own required format
     ESP_RETURN_ON_FALSE((config->tx_id & ~TWAI_EXT_ID_MASK) == 0,
                         ESP_ERR_INVALID_ARG, TAG, "TX ID exceeds maximum value");
     ESP_RETURN_ON_FALSE((config->rx_id & ~TWAI_EXT_ID_MASK) == 0,
                         ESP_ERR_INVALID_ARG, TAG, "RX ID exceeds maximum value");
+#if !SOC_TWAI_SUPPORT_FD
+    ESP_RETURN_ON_FALSE(!config->flags.fd_frames, ESP_ERR_NOT_SUPPORTED, TAG, "CAN FD is not supported by this target");
+#endif
+    ESP_RETURN_ON_FALSE(config->flags.fd_frames || !config->flags.fd_bitrate_switch, ESP_ERR_INVALID_ARG, TAG,
+                        "Bitrate switch needs CAN FD frames");
 
     // Allocate memory for handle.
     isotp = calloc(1, sizeof(esp_isotp_link_t));
@@ -282,22 +1549,36 @@ esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_
     isotp->isotp_rx_buffer = calloc(config->rx_buffer_size, sizeof(uint8_t));
     ESP_GOTO_ON_FALSE(isotp->isotp_rx_buffer && isotp->isotp_tx_buffer, ESP_ERR_NO_MEM, err, TAG, "Failed to allocate ISO-TP reassembly buffers");
 
-    // Initialize TX frame pool with user-specified size
-    // Using simple single-linked list for maximum efficiency
-    isotp->tx_frame_pool_size = config->tx_frame_pool_size;
+    isotp->tx_buffer_size = config->tx_buffer_size;
+    isotp->mux = mux;
+    isotp->fd_frames = config->flags.fd_frames;
+    isotp->fd_bitrate_switch = config->flags.fd_bitrate_switch;
+    // The multi-frame messages of esp_isotp_send() on CAN FD links are streamed, see esp_isotp_fd_send()
+    if (isotp->fd_frames) {
+        isotp->stream_tx.chunk = heap_caps_malloc(ESP_ISOTP_FD_SEND_CHUNK_SIZE, MALLOC_CAP_DMA);
+        ESP_GOTO_ON_FALSE(isotp->stream_tx.chunk, ESP_ERR_NO_MEM, err, TAG, "Failed to allocate stream chunk buffer");
+        isotp->stream_tx.chunk_alloc = ESP_ISOTP_FD_SEND_CHUNK_SIZE;
+    }
     SLIST_INIT(&isotp->tx_frame_pool);
 
-    // Allocate array of TX frames
-    isotp->tx_frame_array = calloc(isotp->tx_frame_pool_size, sizeof(esp_isotp_frame_t));
-    ESP_GOTO_ON_FALSE(isotp->tx_frame_array, ESP_ERR_NO_MEM, err, TAG, "Failed to allocate TX frame array");
+    // The links of a multiplexer take their TX frames from its shared pool
+    if (!mux) {
+        // Initialize TX frame pool with user-specified size
+        // Using simple single-linked list for maximum efficiency
+        isotp->tx_frame_pool_size = config->tx_frame_pool_size;
 
-    // Initialize each frame and add to SLIST pool
-    for (size_t i = 0; i < isotp->tx_frame_pool_size; i++) {
-        esp_isotp_frame_t *frame = &isotp->tx_frame_array[i];
-        frame->frame.buffer = frame->data_payload;
-        frame->frame.buffer_len = sizeof(frame->data_payload);
+        // Allocate array of TX frames
+        isotp->tx_frame_array = calloc(isotp->tx_frame_pool_size, sizeof(esp_isotp_frame_t));
+        ESP_GOTO_ON_FALSE(isotp->tx_frame_array, ESP_ERR_NO_MEM, err, TAG, "Failed to allocate TX frame array");
+
+        // Initialize each frame and add to SLIST pool
+        for (size_t i = 0; i < isotp->tx_frame_pool_size; i++) {
+            esp_isotp_frame_t *frame = &isotp->tx_frame_array[i];
+            frame->frame.buffer = frame->data_payload;
+            frame->frame.buffer_len = sizeof(frame->data_payload);
 
-        SLIST_INSERT_HEAD(&isotp->tx_frame_pool, frame, link);
+            SLIST_INSERT_HEAD(&isotp->tx_frame_pool, frame, link);
+        }
     }
 
     // Initialize the isotp-c library link with our allocated buffers.
@@ -305,6 +1586,23 @@ esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_
                     config->tx_buffer_size, isotp->isotp_rx_buffer, config->rx_buffer_size);
     isotp->link.receive_arbitration_id = config->rx_id;
 
+    // Allocate the receive message slots, the link reassembles directly into the first one.
+    isotp->rx_buffer_size = config->rx_buffer_size;
+    isotp->rx_receiving_slot = -1;
+    portMUX_INITIALIZE(&isotp->rx_slot_lock);
+    portMUX_INITIALIZE(&isotp->stream_lock);
+    if (config->rx_slot_count) {
+        isotp->rx_slot_mem = calloc(config->rx_slot_count, config->rx_buffer_size);
+        isotp->rx_slot_size = calloc(config->rx_slot_count, sizeof(uint32_t));
+        isotp->rx_slot_state = calloc(config->rx_slot_count, sizeof(uint8_t));
+        isotp->rx_ready_fifo = calloc(config->rx_slot_count, sizeof(uint32_t));
+        ESP_GOTO_ON_FALSE(isotp->rx_slot_mem && isotp->rx_slot_size && isotp->rx_slot_state && isotp->rx_ready_fifo,
+                          ESP_ERR_NO_MEM, err, TAG, "Failed to allocate receive message slots");
+        isotp->rx_slot_count = config->rx_slot_count;
+        isotp->rx_receiving_slot = esp_isotp_rx_slot_take(isotp);
+        isotp->link.receive_buffer = esp_isotp_rx_slot_data(isotp, isotp->rx_receiving_slot);
+    }
+
     // Pre-allocate ISR-safe receive frame buffer to avoid dynamic allocation in interrupt context.
     // This buffer is reused for each incoming TWAI frame received in the ISR.
     memset(&isotp->isr_rx_frame_buffer, 0, sizeof(esp_isotp_frame_t));
@@ -319,6 +1617,23 @@ esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_
     isotp->tx_callback = config->tx_callback;
     isotp->callback_arg = config->callback_arg;
 
+    // Create the poll task, woken up by the TWAI callbacks and by the poll timer.
+    if (config->flags.poll_task) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = esp_isotp_poll_timer_cb,
+            .arg = isotp,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "isotp_poll",
+        };
+        ret = esp_timer_create(&timer_args, &isotp->poll_timer);
+        ESP_GOTO_ON_ERROR(ret, err, TAG, "Failed to create poll timer");
+        isotp->poll_task_done = xSemaphoreCreateBinary();
+        ESP_GOTO_ON_FALSE(isotp->poll_task_done, ESP_ERR_NO_MEM, err, TAG, "Failed to create poll task semaphore");
+        ESP_GOTO_ON_FALSE(xTaskCreate(esp_isotp_poll_task, "isotp_poll", CONFIG_ISO_TP_POLL_TASK_STACK_SIZE, isotp,
+                                      CONFIG_ISO_TP_POLL_TASK_PRIORITY, &isotp->poll_task) == pdPASS,
+                          ESP_ERR_NO_MEM, err, TAG, "Failed to create poll task");
+    }
+
     // Set isotp-c wrapper callbacks if user callbacks provided.
 #ifdef ISO_TP_TRANSMIT_COMPLETE_CALLBACK
     if (config->tx_callback) {
@@ -327,11 +1642,31 @@ esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_
 #endif
 
 #ifdef ISO_TP_RECEIVE_COMPLETE_CALLBACK
-    if (config->rx_callback) {
+    if (config->rx_callback || config->rx_slot_count) {
         isotp_set_rx_done_cb(&isotp->link, esp_isotp_rx_wrapper, isotp);
     }
 #endif
 
+    *out_handle = isotp;
+    return ESP_OK;
+
+err:
+    esp_isotp_free_link(isotp);
+    return ret;
+}
+
+esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_config_t *config, esp_isotp_handle_t *out_handle)
+{
+    esp_err_t ret = ESP_OK;
+    esp_isotp_handle_t isotp = NULL;
+    ESP_RETURN_ON_FALSE(twai_node && config && out_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+
+    ret = esp_isotp_new_link(config, NULL, &isotp);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    isotp->twai_node = twai_node;
+
     // Register TWAI callbacks.
     twai_event_callbacks_t cbs = {
         .on_rx_done = esp_isotp_rx_callback,
@@ -344,24 +1679,127 @@ esp_err_t esp_isotp_new_transport(twai_node_handle_t twai_node, const esp_isotp_
     ret = twai_node_enable(twai_node);
     ESP_GOTO_ON_ERROR(ret, err, TAG, "Failed to enable TWAI node");
 
-    isotp->twai_node = twai_node;
     *out_handle = isotp;
 
     return ESP_OK;
 
 err:
-    if (isotp) {
-        if (isotp->isotp_rx_buffer) {
-            free(isotp->isotp_rx_buffer);
-        }
-        if (isotp->isotp_tx_buffer) {
-            free(isotp->isotp_tx_buffer);
-        }
-        if (isotp->tx_frame_array) {
-            free(isotp->tx_frame_array);
-        }
-        free(isotp);
+    esp_isotp_free_link(isotp);
+    return ret;
+}
+
+esp_err_t esp_isotp_new_mux(twai_node_handle_t twai_node, const esp_isotp_mux_config_t *config, esp_isotp_mux_handle_t *out_mux)
+{
+    esp_err_t ret = ESP_OK;
+    esp_isotp_mux_handle_t mux = NULL;
+    ESP_RETURN_ON_FALSE(twai_node && config && out_mux, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(config->tx_frame_pool_size > ESP_ISOTP_MUX_FC_RESERVED_FRAMES, ESP_ERR_INVALID_SIZE, TAG,
+                        "TX frame pool size must be greater than %d", ESP_ISOTP_MUX_FC_RESERVED_FRAMES);
+    ESP_RETURN_ON_FALSE(config->tx_queue_depth != 0, ESP_ERR_INVALID_SIZE, TAG, "TX queue depth cannot be zero");
+
+    mux = calloc(1, sizeof(esp_isotp_mux_t));
+    ESP_RETURN_ON_FALSE(mux, ESP_ERR_NO_MEM, TAG, "Failed to allocate memory for ISO-TP multiplexer");
+
+    // Shared TX frame pool and the queues of the frames waiting for the driver
+    mux->tx_frame_array = calloc(config->tx_frame_pool_size, sizeof(esp_isotp_frame_t));
+    ESP_GOTO_ON_FALSE(mux->tx_frame_array, ESP_ERR_NO_MEM, err, TAG, "Failed to allocate TX frame array");
+    SLIST_INIT(&mux->tx_frame_pool);
+    for (size_t i = 0; i < config->tx_frame_pool_size; i++) {
+        esp_isotp_frame_t *frame = &mux->tx_frame_array[i];
+        frame->frame.buffer = frame->data_payload;
+        frame->frame.buffer_len = sizeof(frame->data_payload);
+
+        SLIST_INSERT_HEAD(&mux->tx_frame_pool, frame, link);
+    }
+    mux->tx_frames_free = config->tx_frame_pool_size;
+    mux->tx_queue_depth = config->tx_queue_depth;
+    STAILQ_INIT(&mux->tx_fc_queue);
+    STAILQ_INIT(&mux->tx_data_queue);
+    portMUX_INITIALIZE(&mux->tx_lock);
+
+    for (size_t i = 0; i < ESP_ISOTP_MUX_HASH_SIZE; i++) {
+        SLIST_INIT(&mux->links[i]);
+    }
+    portMUX_INITIALIZE(&mux->links_lock);
+
+    mux->isr_rx_frame_buffer.frame.buffer = mux->isr_rx_frame_buffer.data_payload;
+    mux->isr_rx_frame_buffer.frame.buffer_len = sizeof(mux->isr_rx_frame_buffer.data_payload);
+    mux->twai_node = twai_node;
+
+    // Register TWAI callbacks, shared by all the links.
+    twai_event_callbacks_t cbs = {
+        .on_rx_done = esp_isotp_mux_rx_callback,
+        .on_tx_done = esp_isotp_mux_tx_callback,
+    };
+    ret = twai_node_register_event_callbacks(twai_node, &cbs, mux);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "Failed to register event callbacks");
+
+    // Enable TWAI node.
+    ret = twai_node_enable(twai_node);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "Failed to enable TWAI node");
+
+    *out_mux = mux;
+    return ESP_OK;
+
+err:
+    free(mux->tx_frame_array);
+    free(mux);
+    return ret;
+}
+
+esp_err_t esp_isotp_mux_new_transport(esp_isotp_mux_handle_t mux, const esp_isotp_config_t *config, esp_isotp_handle_t *out_handle)
+{
+    esp_err_t ret = ESP_OK;
+    esp_isotp_handle_t isotp = NULL;
+    ESP_RETURN_ON_FALSE(mux && config && out_handle, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+
+    ret = esp_isotp_new_link(config, mux, &isotp);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    isotp->twai_node = mux->twai_node;
+
+    // Add the link to the hash table, from then on the RX callback dispatches its frames
+    portENTER_CRITICAL(&mux->links_lock);
+    bool id_used = esp_isotp_mux_find_link(mux, config->rx_id) != NULL;
+    if (!id_used) {
+        SLIST_INSERT_HEAD(&mux->links[esp_isotp_mux_hash(config->rx_id)], isotp, mux_entry);
+        mux->link_count++;
+    }
+    portEXIT_CRITICAL(&mux->links_lock);
+    ESP_GOTO_ON_FALSE(!id_used, ESP_ERR_INVALID_ARG, err, TAG, "RX ID already received by another link of the multiplexer");
+
+    *out_handle = isotp;
+    return ESP_OK;
+
+err:
+    esp_isotp_free_link(isotp);
+    return ret;
+}
+
+esp_err_t esp_isotp_del_mux(esp_isotp_mux_handle_t mux)
+{
+    ESP_RETURN_ON_FALSE(mux, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(mux->link_count == 0, ESP_ERR_INVALID_STATE, TAG, "Links of the multiplexer must be deleted first");
+
+    esp_err_t ret = ESP_OK;
+
+    esp_err_t twai_ret = twai_node_disable(mux->twai_node);
+    if (twai_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to disable TWAI node: %s", esp_err_to_name(twai_ret));
+        ret = twai_ret;
+    }
+
+    twai_event_callbacks_t cbs = { 0 };
+    esp_err_t unreg_ret = twai_node_register_event_callbacks(mux->twai_node, &cbs, NULL);
+    if (unreg_ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to unregister TWAI callbacks: %s", esp_err_to_name(unreg_ret));
+        ret = unreg_ret;
     }
+
+    free(mux->tx_frame_array);
+    free(mux);
+
     return ret;
 }
 
@@ -369,7 +1807,8 @@ err:
  * @brief Delete an ISO-TP transport and free resources.
  *
  * Disables the TWAI node, cleans up TX frame pool and frees allocated
- * memory. Continues cleanup even if disabling TWAI fails.
+ * memory. Continues cleanup even if disabling TWAI fails. A link of a
+ * multiplexer is only removed from it, the TWAI node stays enabled.
  *
  * @param handle ISO-TP transport handle.
  * @return ESP_OK on success or the error from TWAI disable.
@@ -380,39 +1819,43 @@ esp_err_t esp_isotp_delete(esp_isotp_handle_t handle)
 
     esp_err_t ret = ESP_OK;
 
-    // Disable TWAI node after unregistering callbacks
-    esp_err_t twai_ret = twai_node_disable(handle->twai_node);
-    if (twai_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to disable TWAI node: %s", esp_err_to_name(twai_ret));
-        if (ret == ESP_OK) {
-            ret = twai_ret;
+    if (handle->mux) {
+        esp_isotp_mux_handle_t mux = handle->mux;
+        portENTER_CRITICAL(&mux->links_lock);
+        SLIST_REMOVE(&mux->links[esp_isotp_mux_hash(handle->link.receive_arbitration_id)], handle, esp_isotp_link_t, mux_entry);
+        mux->link_count--;
+        portEXIT_CRITICAL(&mux->links_lock);
+        // Wait for the RX callback to be done with the link, if it found it before its removal
+        while (mux->rx_dispatching == handle) {
+            vTaskDelay(1);
+        }
+    } else {
+        // Disable TWAI node after unregistering callbacks
+        esp_err_t twai_ret = twai_node_disable(handle->twai_node);
+        if (twai_ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to disable TWAI node: %s", esp_err_to_name(twai_ret));
+            if (ret == ESP_OK) {
+                ret = twai_ret;
+            }
         }
-    }
 
-    // Unregister TWAI callbacks first to prevent use-after-free during disable
-    twai_event_callbacks_t cbs = { 0 };
-    esp_err_t unreg_ret = twai_node_register_event_callbacks(handle->twai_node, &cbs, NULL);
-    if (unreg_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to unregister TWAI callbacks: %s", esp_err_to_name(unreg_ret));
-        ret = unreg_ret;
+        // Unregister TWAI callbacks first to prevent use-after-free during disable
+        twai_event_callbacks_t cbs = { 0 };
+        esp_err_t unreg_ret = twai_node_register_event_callbacks(handle->twai_node, &cbs, NULL);
+        if (unreg_ret != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to unregister TWAI callbacks: %s", esp_err_to_name(unreg_ret));
+            ret = unreg_ret;
+        }
     }
 
+    // Stop the poll task before the link goes away.
+    esp_isotp_poll_task_stop(handle);
+
     // Clean up ISO-TP link.
     isotp_destroy_link(&handle->link);
 
-    // Clean up TX frame array (SLIST pool is automatically cleaned when frames are freed).
-    if (handle->tx_frame_array) {
-        free(handle->tx_frame_array);
-    }
-
-    // Free ISO-TP reassembly buffers and handle.
-    if (handle->isotp_tx_buffer) {
-        free(handle->isotp_tx_buffer);
-    }
-    if (handle->isotp_rx_buffer) {
-        free(handle->isotp_rx_buffer);
-    }
-    free(handle);
+    // Free TX frames, ISO-TP reassembly buffers and handle.
+    esp_isotp_free_link(handle);
 
     return ret;
 }
@@ -422,18 +1865,145 @@ esp_err_t esp_isotp_delete(esp_isotp_handle_t handle)
  * @brief Poll the ISO-TP link. Call this periodically from a task.
  *
  * @param handle ISO-TP transport handle.
- * @return ESP_OK on success, or an error code on failure.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE when the link has a poll task, or an error code on failure.
  */
 esp_err_t esp_isotp_poll(esp_isotp_handle_t handle)
 {
     ESP_RETURN_ON_FALSE(handle, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(!handle->poll_task, ESP_ERR_INVALID_STATE, TAG, "Link is polled by its poll task");
 
     // Run ISO-TP state machine to check timeouts and send consecutive frames.
     isotp_poll(&handle->link);
+    esp_isotp_stream_poll(handle);
 
     return ESP_OK;
 }
 
+/**
+ * @brief Start a streamed send: send the first frame and let the poll context send the consecutive frames.
+ *
+ * The chunk buffer must already hold config->chunk_size bytes.
+ *
+ * @param handle ISO-TP link handle, without a send in progress.
+ * @param id TWAI identifier of the frames.
+ * @param size Message size, larger than a single frame.
+ * @param config Configuration of the send.
+ * @return ESP_OK, ESP_ERR_NO_MEM without a free TX frame, the error of on_read, or ESP_FAIL.
+ */
+static esp_err_t esp_isotp_stream_tx_start(esp_isotp_handle_t handle, uint32_t id, uint32_t size,
+                                           const esp_isotp_stream_tx_config_t *config)
+{
+    esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+    const uint8_t tx_dl = handle->fd_frames ? ESP_ISOTP_FRAME_MAX_LEN : 8;
+
+    tx->config = *config;
+    tx->arbitration_id = id;
+    tx->size = size;
+    tx->chunk_offset = 0;
+    tx->chunk_len = 0;
+    tx->frame_len = 0;
+    tx->sn = 1;
+    tx->wft_count = 0;
+    tx->pool_stalls = 0;
+
+    // First frame, with the 32-bit escape sequence above 4095 bytes
+    uint8_t ff[ESP_ISOTP_FRAME_MAX_LEN];
+    uint8_t pos = 2;
+    if (size <= ESP_ISOTP_FF_DL_12BIT_MAX) {
+        ff[0] = (ESP_ISOTP_PCI_TYPE_FIRST_FRAME << 4) | (size >> 8);
+        ff[1] = size & 0xFF;
+    } else {
+        ff[0] = ESP_ISOTP_PCI_TYPE_FIRST_FRAME << 4;
+        ff[1] = 0;
+        ff[2] = size >> 24;
+        ff[3] = (size >> 16) & 0xFF;
+        ff[4] = (size >> 8) & 0xFF;
+        ff[5] = size & 0xFF;
+        pos = 6;
+    }
+    ESP_RETURN_ON_ERROR(esp_isotp_stream_tx_copy(handle, ff + pos, 0, tx_dl - pos), TAG, "Failed to read the first chunk");
+    tx->offset = tx_dl - pos;
+
+    tx->timer_bs = isotp_user_get_us() + ISO_TP_DEFAULT_RESPONSE_TIMEOUT_US;
+    tx->state = ESP_ISOTP_STREAM_WAIT_FC;
+    int ret = esp_isotp_stream_send_frame_with_id(handle, id, ff, tx_dl);
+    if (ret != ISOTP_RET_OK) {
+        tx->state = ESP_ISOTP_STREAM_IDLE;
+        return ret == ISOTP_RET_NOSPACE ? ESP_ERR_NO_MEM : ESP_FAIL;
+    }
+    // The poll task waits for the flow control frame, with its timeout
+    esp_isotp_poll_task_wake(handle);
+    return ESP_OK;
+}
+
+#if SOC_TWAI_SUPPORT_FD
+/**
+ * @brief on_read of the multi-frame messages of esp_isotp_send() on CAN FD links, reads the TX buffer.
+ */
+static esp_err_t esp_isotp_fd_send_read(esp_isotp_handle_t handle, uint32_t offset, uint8_t *buf, uint32_t len, void *user_arg)
+{
+    memcpy(buf, handle->isotp_tx_buffer + offset, len);
+    return ESP_OK;
+}
+
+/**
+ * @brief on_done of the multi-frame messages of esp_isotp_send() on CAN FD links, calls the TX callback like isotp-c.
+ */
+static void esp_isotp_fd_send_done(esp_isotp_handle_t handle, uint32_t size, esp_err_t result, void *user_arg)
+{
+    if (result == ESP_OK && handle->tx_callback) {
+        handle->tx_callback(handle, size, handle->callback_arg);
+    }
+}
+
+/**
+ * @brief Send a message on a CAN FD link.
+ *
+ * isotp-c only builds classic 8-byte frames with a 12-bit message length. The single frames are
+ * built here, with the escape sequence above 7 bytes, and the multi-frame messages go through
+ * the streamed send, which fills the frames up to 64 bytes.
+ *
+ * @return Same as esp_isotp_send().
+ */
+static esp_err_t esp_isotp_fd_send(esp_isotp_handle_t handle, uint32_t id, const uint8_t *data, uint32_t size)
+{
+    if (handle->stream_tx.state != ESP_ISOTP_STREAM_IDLE || handle->link.send_status == ISOTP_SEND_STATUS_INPROGRESS) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (size > handle->tx_buffer_size) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (size <= ESP_ISOTP_FRAME_MAX_LEN - 2) {
+        uint8_t sf[ESP_ISOTP_FRAME_MAX_LEN];
+        uint8_t pos = 1;
+        if (size <= 7) {
+            sf[0] = size;
+        } else {
+            sf[0] = 0;
+            sf[1] = size;
+            pos = 2;
+        }
+        memcpy(sf + pos, data, size);
+        int ret = esp_isotp_stream_send_frame_with_id(handle, id, sf, pos + size);
+        if (ret != ISOTP_RET_OK) {
+            return ret == ISOTP_RET_NOSPACE ? ESP_ERR_NO_MEM : ESP_FAIL;
+        }
+        esp_isotp_fd_send_done(handle, size, ESP_OK, NULL);
+        return ESP_OK;
+    }
+
+    // The chunk buffer was allocated with the link
+    memcpy(handle->isotp_tx_buffer, data, size);
+    const esp_isotp_stream_tx_config_t config = {
+        .chunk_size = ESP_ISOTP_FD_SEND_CHUNK_SIZE,
+        .on_read = esp_isotp_fd_send_read,
+        .on_done = esp_isotp_fd_send_done,
+    };
+    return esp_isotp_stream_tx_start(handle, id, size, &config);
+}
+#endif
+
 /**
  * @brief Send a payload using ISO-TP.
  *
@@ -453,10 +2023,20 @@ esp_err_t esp_isotp_send(esp_isotp_handle_t handle, const uint8_t *data, uint32_
     if (!(handle && data && size)) {
         return ESP_ERR_INVALID_ARG;
     }
+#if SOC_TWAI_SUPPORT_FD
+    if (handle->fd_frames) {
+        return esp_isotp_fd_send(handle, handle->link.send_arbitration_id, data, size);
+    }
+#endif
+    if (handle->stream_tx.state != ESP_ISOTP_STREAM_IDLE) {
+        return ESP_ERR_NOT_FINISHED;
+    }
 
     int ret = isotp_send(&handle->link, data, size);
     switch (ret) {
     case ISOTP_RET_OK:
+        // The poll task sends the consecutive frames of a multi-frame message
+        esp_isotp_poll_task_wake(handle);
         return ESP_OK;
     case ISOTP_RET_INPROGRESS:
         return ESP_ERR_NOT_FINISHED;
@@ -493,10 +2073,19 @@ esp_err_t esp_isotp_send_with_id(esp_isotp_handle_t handle, uint32_t id, const u
     if ((id & ~TWAI_EXT_ID_MASK) != 0) {
         return ESP_ERR_INVALID_ARG;
     }
+#if SOC_TWAI_SUPPORT_FD
+    if (handle->fd_frames) {
+        return esp_isotp_fd_send(handle, id, data, size);
+    }
+#endif
+    if (handle->stream_tx.state != ESP_ISOTP_STREAM_IDLE) {
+        return ESP_ERR_NOT_FINISHED;
+    }
 
     int ret = isotp_send_with_id(&handle->link, id, data, size);
     switch (ret) {
     case ISOTP_RET_OK:
+        esp_isotp_poll_task_wake(handle);
         return ESP_OK;
     case ISOTP_RET_INPROGRESS:
         return ESP_ERR_NOT_FINISHED;
@@ -514,6 +2103,99 @@ esp_err_t esp_isotp_send_with_id(esp_isotp_handle_t handle, uint32_t id, const u
     }
 }
 
+esp_err_t esp_isotp_stream_send(esp_isotp_handle_t handle, uint32_t size, const esp_isotp_stream_tx_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(handle && config && config->on_read, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(config->chunk_size >= ESP_ISOTP_STREAM_CHUNK_MIN && config->chunk_size % 4 == 0, ESP_ERR_INVALID_SIZE,
+                        TAG, "Chunk size must be a multiple of 4, at least %d", ESP_ISOTP_STREAM_CHUNK_MIN);
+    const uint8_t tx_dl = handle->fd_frames ? ESP_ISOTP_FRAME_MAX_LEN : 8;
+    ESP_RETURN_ON_FALSE(size > (tx_dl == 8 ? 7U : tx_dl - 2U), ESP_ERR_INVALID_SIZE, TAG, "Message fits a single frame");
+
+    esp_isotp_stream_tx_t *tx = &handle->stream_tx;
+    if (tx->state != ESP_ISOTP_STREAM_IDLE || handle->link.send_status == ISOTP_SEND_STATUS_INPROGRESS) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    // DMA capable, so that on_read can read from flash or another peripheral straight into it
+    if (tx->chunk_alloc < config->chunk_size) {
+        free(tx->chunk);
+        tx->chunk_alloc = 0;
+        tx->chunk = heap_caps_malloc(config->chunk_size, MALLOC_CAP_DMA);
+        ESP_RETURN_ON_FALSE(tx->chunk, ESP_ERR_NO_MEM, TAG, "Failed to allocate stream chunk buffer");
+        tx->chunk_alloc = config->chunk_size;
+    }
+    return esp_isotp_stream_tx_start(handle, handle->link.send_arbitration_id, size, config);
+}
+
+esp_err_t esp_isotp_stream_receive(esp_isotp_handle_t handle, const esp_isotp_stream_rx_config_t *config)
+{
+    ESP_RETURN_ON_FALSE(handle && config && config->on_write, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(config->chunk_size >= ESP_ISOTP_STREAM_CHUNK_MIN && config->chunk_size % 4 == 0, ESP_ERR_INVALID_SIZE,
+                        TAG, "Chunk size must be a multiple of 4, at least %d", ESP_ISOTP_STREAM_CHUNK_MIN);
+    ESP_RETURN_ON_FALSE(config->st_min_us <= config->st_min_max_us && config->st_min_max_us <= ESP_ISOTP_ST_MIN_MAX_US,
+                        ESP_ERR_INVALID_ARG, TAG, "Invalid STmin range");
+
+    esp_isotp_stream_rx_t *rx = &handle->stream_rx;
+    if (rx->state != ESP_ISOTP_STREAM_IDLE) {
+        return ESP_ERR_NOT_FINISHED;
+    }
+    if (rx->ring_alloc < 2 * config->chunk_size) {
+        free(rx->ring);
+        rx->ring_alloc = 0;
+        rx->ring = heap_caps_malloc(2 * config->chunk_size, MALLOC_CAP_DMA);
+        ESP_RETURN_ON_FALSE(rx->ring, ESP_ERR_NO_MEM, TAG, "Failed to allocate stream chunk buffers");
+        rx->ring_alloc = 2 * config->chunk_size;
+    }
+    rx->config = *config;
+    rx->bs_target = config->block_size ? config->block_size : ISO_TP_DEFAULT_BLOCK_SIZE;
+    rx->st_min_us = config->st_min_us;
+    rx->head = 0;
+    rx->tail = 0;
+
+    // From now on the RX ISR takes the first frames
+    portENTER_CRITICAL(&handle->stream_lock);
+    rx->state = ESP_ISOTP_STREAM_WAIT_FF;
+    portEXIT_CRITICAL(&handle->stream_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Copy the oldest message of the receive slots and release its slot.
+ *
+ * @param handle ISO-TP transport handle.
+ * @param data Output buffer for received data.
+ * @param size Size of the output buffer in bytes.
+ * @param received_size Actual number of bytes written to the buffer.
+ * @return
+ *  - ESP_OK when data is received
+ *  - ESP_ERR_NOT_FOUND when no data is available
+ *  - ESP_ERR_INVALID_SIZE when the buffer is too small, the message is kept
+ */
+static esp_err_t esp_isotp_receive_from_slot(esp_isotp_handle_t handle, uint8_t *data, uint32_t size, uint32_t *received_size)
+{
+    esp_err_t ret = ESP_OK;
+    int32_t slot = -1;
+
+    portENTER_CRITICAL(&handle->rx_slot_lock);
+    if (!handle->rx_ready_count) {
+        ret = ESP_ERR_NOT_FOUND;
+    } else if (handle->rx_slot_size[handle->rx_ready_fifo[handle->rx_ready_head]] > size) {
+        ret = ESP_ERR_INVALID_SIZE;
+    } else {
+        slot = handle->rx_ready_fifo[handle->rx_ready_head];
+        handle->rx_ready_head = (handle->rx_ready_head + 1) % handle->rx_slot_count;
+        handle->rx_ready_count--;
+        handle->rx_slot_state[slot] = ESP_ISOTP_RX_SLOT_BORROWED;
+    }
+    portEXIT_CRITICAL(&handle->rx_slot_lock);
+    if (slot < 0) {
+        return ret;
+    }
+
+    memcpy(data, esp_isotp_rx_slot_data(handle, slot), handle->rx_slot_size[slot]);
+    *received_size = handle->rx_slot_size[slot];
+    return esp_isotp_receive_release(handle, esp_isotp_rx_slot_data(handle, slot));
+}
+
 /**
  * @brief Receive a payload using ISO-TP.
  *
@@ -534,6 +2216,9 @@ esp_err_t esp_isotp_receive(esp_isotp_handle_t handle, uint8_t *data, uint32_t s
     ESP_RETURN_ON_FALSE(handle && data && size && received_size, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
 
     *received_size = 0;
+    if (handle->rx_slot_count) {
+        return esp_isotp_receive_from_slot(handle, data, size, received_size);
+    }
     int ret = isotp_receive(&handle->link, data, size, received_size);
     switch (ret) {
     case ISOTP_RET_OK:
@@ -557,3 +2242,49 @@ esp_err_t esp_isotp_receive(esp_isotp_handle_t handle, uint8_t *data, uint32_t s
         return ESP_FAIL;
     }
 }
+
+esp_err_t esp_isotp_receive_borrow(esp_isotp_handle_t handle, const uint8_t **data, uint32_t *size)
+{
+    ESP_RETURN_ON_FALSE(handle && data && size, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    ESP_RETURN_ON_FALSE(handle->rx_slot_count, ESP_ERR_INVALID_STATE, TAG, "No receive message slots");
+
+    int32_t slot = -1;
+    portENTER_CRITICAL(&handle->rx_slot_lock);
+    if (handle->rx_ready_count) {
+        slot = handle->rx_ready_fifo[handle->rx_ready_head];
+        handle->rx_ready_head = (handle->rx_ready_head + 1) % handle->rx_slot_count;
+        handle->rx_ready_count--;
+        handle->rx_slot_state[slot] = ESP_ISOTP_RX_SLOT_BORROWED;
+    }
+    portEXIT_CRITICAL(&handle->rx_slot_lock);
+    if (slot < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    *data = esp_isotp_rx_slot_data(handle, slot);
+    *size = handle->rx_slot_size[slot];
+    return ESP_OK;
+}
+
+esp_err_t esp_isotp_receive_release(esp_isotp_handle_t handle, const uint8_t *data)
+{
+    ESP_RETURN_ON_FALSE(handle && data && handle->rx_slot_count, ESP_ERR_INVALID_ARG, TAG, "Invalid parameters");
+    // Find the slot from its data pointer
+    ESP_RETURN_ON_FALSE(data >= handle->rx_slot_mem &&
+                        data < handle->rx_slot_mem + (size_t)handle->rx_slot_count * handle->rx_buffer_size &&
+                        (data - handle->rx_slot_mem) % handle->rx_buffer_size == 0,
+                        ESP_ERR_INVALID_ARG, TAG, "Not a receive message slot");
+    int32_t slot = (data - handle->rx_slot_mem) / handle->rx_buffer_size;
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&handle->rx_slot_lock);
+    // The slot is taken by the RX ISR at the end of the next message
+    if (handle->rx_slot_state[slot] == ESP_ISOTP_RX_SLOT_BORROWED) {
+        handle->rx_slot_state[slot] = ESP_ISOTP_RX_SLOT_FREE;
+    } else {
+        ret = ESP_ERR_INVALID_ARG;
+    }
+    portEXIT_CRITICAL(&handle->rx_slot_lock);
+    ESP_RETURN_ON_FALSE(ret == ESP_OK, ret, TAG, "Message slot is not borrowed");
+    return ESP_OK;
+}
@@ -30,8 +30,33 @@ typedef enum {
 typedef enum {
     JPEG_IMAGE_FORMAT_RGB888 = 0,   /*!< Format RGB888 */
     JPEG_IMAGE_FORMAT_RGB565,       /*!< Format RGB565 */
+    JPEG_IMAGE_FORMAT_GRAY,         /*!< Format grayscale, 8 bits of luminance. Chroma is not transformed (TJpgDec only) */
+    JPEG_IMAGE_FORMAT_YUV422,       /*!< Format YUV422 packed as Y0 U Y1 V, or U Y0 V Y1 with swap_color_bytes.
+                                         Color conversion is omitted (TJpgDec only) */
 } esp_jpeg_image_format_t;
 
+/**
+ * @brief Decoder used by esp_jpeg_decode()
+ *
+ */
+typedef enum {
+    JPEG_DECODER_BACKEND_AUTO = 0,  /*!< Hardware decoder if available and the image is supported by it, TJpgDec otherwise */
+    JPEG_DECODER_BACKEND_SOFTWARE,  /*!< Always TJpgDec */
+    JPEG_DECODER_BACKEND_HARDWARE,  /*!< Only the hardware decoder, ESP_ERR_NOT_SUPPORTED is returned if it can't decode the image */
+} esp_jpeg_decoder_backend_t;
+
+/**
+ * @brief Input callback providing the JPEG data
+ *
+ * @param[in]  user_ctx: User context (read_cb_ctx)
+ * @param[out] buf:      Buffer for the data. If NULL, len bytes of the input must be skipped.
+ * @param[in]  len:      Number of bytes requested, at most CONFIG_JD_SZBUF
+ *
+ * @return Number of bytes read or skipped, 0 at the end of the input or on error.
+ *         Fewer bytes than requested may be returned, the callback is then called again for the rest.
+ */
+typedef size_t (*esp_jpeg_read_cb_t)(void *user_ctx, uint8_t *buf, size_t len);
+
 /**
  * @brief JPEG Configuration Type
  *
@@ -46,6 +71,8 @@ typedef struct esp_jpeg_image_cfg_s {
 
     struct {
         uint8_t swap_color_bytes: 1; /*!< Swap first and last color bytes */
+        uint8_t dither: 1;           /*!< RGB565 output with ordered dithering instead of truncation. Needs
+                                          JD_FORMAT RGB888 (TJpgDec only) */
     } flags;
 
     struct {
@@ -53,11 +80,31 @@ typedef struct esp_jpeg_image_cfg_s {
                                          Tjpgd does not use dynamic allocation, se we pass this buffer to Tjpgd that uses it as scratchpad */
         size_t working_buffer_size; /*!< Size of the working buffer. Must be set it working_buffer != NULL.
                                          Default size is 3.1kB or 65kB if JD_FASTDECODE == 2 */
+        esp_jpeg_decoder_backend_t backend; /*!< Decoder used by esp_jpeg_decode(), see CONFIG_JD_HW_DECODE.
+                                                 The hardware decoder needs indata, no scaling or cropping, packed
+                                                 rows, and outbuf aligned to the cache line */
     } advanced;
 
     struct {
         uint32_t read;  /*!< Internal count of read bytes */
     } priv;
+
+    esp_jpeg_read_cb_t read_cb; /*!< If set, the input image is read by this callback instead of from indata.
+                                     The image is then decoded as it arrives, e.g. from a file or a network stream */
+    void *read_cb_ctx;      /*!< User context passed to read_cb */
+    struct {
+        uint16_t left;      /*!< Left edge of the region, in pixels of the input image */
+        uint16_t top;       /*!< Top edge of the region, in pixels of the input image */
+        uint16_t width;     /*!< Width of the region, 0 decodes the whole image */
+        uint16_t height;    /*!< Height of the region, 0 decodes the whole image */
+    } crop;                 /*!< Region of the input image to decode, out_scale is applied to it. Only the MCUs overlapping
+                                 the region are converted, decoding ends after the last MCU row of the region */
+    uint16_t out_width;     /*!< If not 0, the cropped and scaled image is downscaled to out_width x out_height pixels
+                                 with a box filter while decoding. Upscaling is not supported */
+    uint16_t out_height;    /*!< Height of the downscaled image, must be set together with out_width */
+    uint32_t out_stride;    /*!< Bytes between the starts of two rows in outbuf, 0 if the rows are packed. Allows to
+                                 decode into a region of a larger frame buffer, e.g. a display or canvas buffer, with
+                                 outbuf pointing to its top left pixel */
 } esp_jpeg_image_cfg_t;
 
 /**
@@ -66,9 +113,33 @@ typedef struct esp_jpeg_image_cfg_s {
 typedef struct esp_jpeg_image_output_s {
     uint16_t width;    /*!< Width of the output image */
     uint16_t height;   /*!< Height of the output image */
-    size_t output_len; /*!< Length of the output image in bytes */
+    size_t output_len; /*!< Length of the output image in bytes, from the first to the last byte written with out_stride */
 } esp_jpeg_image_output_t;
 
+/**
+ * @brief Block of decoded pixels passed to esp_jpeg_decode_stream() callback
+ */
+typedef struct esp_jpeg_image_block_s {
+    uint16_t left;          /*!< X coordinate of the first pixel of the block in the output image */
+    uint16_t top;           /*!< Y coordinate of the first pixel of the block in the output image */
+    uint16_t width;         /*!< Width of the block in pixels */
+    uint16_t height;        /*!< Height of the block in pixels */
+    const uint8_t *data;    /*!< Pixels in the output format, rows are packed without padding */
+} esp_jpeg_image_block_t;
+
+/**
+ * @brief Callback receiving decoded blocks of the image
+ *
+ * Blocks are delivered in decoding order: MCU by MCU, from left to right and from top to bottom.
+ * The data points into the working buffer and is only valid until the callback returns.
+ *
+ * @param[in] block:    Decoded block
+ * @param[in] user_ctx: User context passed to esp_jpeg_decode_stream()
+ *
+ * @return ESP_OK to continue decoding, any other value stops decoding and is returned by esp_jpeg_decode_stream()
+ */
+typedef esp_err_t (*esp_jpeg_decode_stream_cb_t)(const esp_jpeg_image_block_t *block, void *user_ctx);
+
 /**
  * @brief Decode JPEG image
  *
@@ -80,10 +151,120 @@ typedef struct esp_jpeg_image_output_s {
  * @return
  *      - ESP_OK            on success
  *      - ESP_ERR_NO_MEM    if there is no memory for allocating main structure
+ *      - ESP_ERR_INVALID_ARG if crop or out_width/out_height is invalid, or out_stride is shorter than a row
+ *      - ESP_ERR_NOT_SUPPORTED if JPEG_DECODER_BACKEND_HARDWARE is requested and the hardware can't decode the image
  *      - ESP_FAIL          if there is an error in decoding JPEG
  */
 esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img);
 
+/**
+ * @brief Decode JPEG image block by block, without an output buffer
+ *
+ * Each decoded block, at most 16x16 pixels before scaling, is passed to the callback in the requested output format.
+ * This allows drawing an image on a display (e.g. with esp_lcd_panel_draw_bitmap()) without a full frame buffer.
+ * If the block is transferred by DMA, the callback must wait until the transfer is done before returning.
+ * Put the working buffer (cfg->advanced.working_buffer) into DMA capable memory in that case.
+ *
+ * @note This function is blocking. cfg->outbuf and cfg->outbuf_size are not used.
+ *
+ * @param[in]  cfg:      Configuration structure
+ * @param[in]  cb:       Callback receiving the decoded blocks
+ * @param[in]  user_ctx: User context passed to the callback
+ * @param[out] img:      Output image info
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if cfg, cb or img is NULL
+ *      - ESP_ERR_NO_MEM      if there is no memory for allocating the working buffer
+ *      - ESP_FAIL            if there is an error in decoding JPEG
+ *      - Error returned by the callback if it stopped the decoding
+ */
+esp_err_t esp_jpeg_decode_stream(esp_jpeg_image_cfg_t *cfg, esp_jpeg_decode_stream_cb_t cb, void *user_ctx,
+                                 esp_jpeg_image_output_t *img);
+
+/**
+ * @brief Decoder keeping its working buffer and tables between images
+ */
+typedef struct esp_jpeg_decoder_t *esp_jpeg_decoder_handle_t;
+
+/**
+ * @brief Configuration of a decoder created by esp_jpeg_decoder_new()
+ */
+typedef struct {
+    uint32_t working_buffer_caps;   /*!< Heap capabilities of the working buffer, e.g. MALLOC_CAP_DMA for
+                                         esp_jpeg_decoder_decode_stream() with a DMA display. 0 for MALLOC_CAP_DEFAULT, or internal
+                                         RAM with CONFIG_JD_TJPGD_IN_IRAM */
+} esp_jpeg_decoder_config_t;
+
+/**
+ * @brief Create a decoder for decoding several images
+ *
+ * esp_jpeg_decode() allocates the working buffer and builds the Huffman and quantization tables for every image.
+ * A decoder allocates the working buffer once and keeps the tables of the previous image: when the next image has
+ * the same DHT and DQT segments, as the frames of an MJPEG stream usually do, they are not built again.
+ *
+ * @note A decoder must not be used by several tasks at the same time.
+ *
+ * @param[in]  config:      Decoder configuration, may be NULL for default configuration
+ * @param[out] ret_decoder: Created decoder
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if ret_decoder is NULL
+ *      - ESP_ERR_NO_MEM      if there is no memory for the decoder
+ */
+esp_err_t esp_jpeg_decoder_new(const esp_jpeg_decoder_config_t *config, esp_jpeg_decoder_handle_t *ret_decoder);
+
+/**
+ * @brief Decode JPEG image with a decoder
+ *
+ * Same as esp_jpeg_decode(), cfg->advanced.working_buffer is not used.
+ *
+ * @param[in]  decoder: Decoder created by esp_jpeg_decoder_new()
+ * @param[in]  cfg:     Configuration structure
+ * @param[out] img:     Output image info
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder, cfg or img is NULL, or crop or out_width/out_height is invalid
+ *      - ESP_ERR_NOT_SUPPORTED if JPEG_DECODER_BACKEND_HARDWARE is requested and the hardware can't decode the image
+ *      - ESP_FAIL            if there is an error in decoding JPEG
+ */
+esp_err_t esp_jpeg_decoder_decode(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+                                  esp_jpeg_image_output_t *img);
+
+/**
+ * @brief Decode JPEG image block by block with a decoder
+ *
+ * Same as esp_jpeg_decode_stream(), cfg->advanced.working_buffer is not used.
+ * The blocks point into the working buffer of the decoder.
+ *
+ * @param[in]  decoder:  Decoder created by esp_jpeg_decoder_new()
+ * @param[in]  cfg:      Configuration structure
+ * @param[in]  cb:       Callback receiving the decoded blocks
+ * @param[in]  user_ctx: User context passed to the callback
+ * @param[out] img:      Output image info
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder, cfg, cb or img is NULL
+ *      - ESP_FAIL            if there is an error in decoding JPEG
+ *      - Error returned by the callback if it stopped the decoding
+ */
+esp_err_t esp_jpeg_decoder_decode_stream(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+        esp_jpeg_decode_stream_cb_t cb, void *user_ctx, esp_jpeg_image_output_t *img);
+
+/**
+ * @brief Delete a decoder
+ *
+ * @param[in] decoder: Decoder created by esp_jpeg_decoder_new()
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder is NULL
+ */
+esp_err_t esp_jpeg_decoder_delete(esp_jpeg_decoder_handle_t decoder);
+
 /**
  * @brief Get information about the JPEG image
  *
@@ -91,12 +272,15 @@ esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *im
  * Allocate a buffer of size img->output_len to store the decoded image.
  *
  * @note cfg->outbuf and cfg->outbuf_size are not used in this function.
+ * @note The image must be in cfg->indata, cfg->read_cb is not supported by this function.
+ * @note img->width and img->height are the size of the input image, img->output_len takes out_scale, crop and
+ *       out_width/out_height into account.
  * @param[in]  cfg: Configuration structure
  * @param[out] img: Output image info
  *
  * @return
  *      - ESP_OK              on success
- *      - ESP_ERR_INVALID_ARG if cfg or img is NULL
+ *      - ESP_ERR_INVALID_ARG if cfg or img is NULL, or crop or out_width/out_height is invalid
  *      - ESP_FAIL            if there is an error in decoding JPEG
  */
 esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img);
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "jpeg_decoder.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief MJPEG decoder handle
+ */
+typedef struct esp_jpeg_mjpeg_t *esp_jpeg_mjpeg_handle_t;
+
+/**
+ * @brief Decoded frame passed to the frame callback
+ */
+typedef struct {
+    uint8_t *buf;           /*!< Framebuffer holding the decoded image, valid until the frame is released */
+    size_t len;             /*!< Length of the decoded image in bytes */
+    uint16_t width;         /*!< Width of the decoded image */
+    uint16_t height;        /*!< Height of the decoded image */
+    uint32_t seq;           /*!< Number of the frame in the stream, dropped frames are counted too */
+    uint32_t decode_us;     /*!< Decoding time of the frame */
+    uint32_t latency_us;    /*!< Time from the end of the frame in the stream to the frame callback */
+    uint8_t fb_index;       /*!< Index of the framebuffer in the ring */
+} esp_jpeg_mjpeg_frame_t;
+
+/**
+ * @brief Callback receiving decoded frames, called from the decoding task
+ *
+ * The framebuffer belongs to the application until it is given back with esp_jpeg_mjpeg_release_frame(),
+ * e.g. when the display has finished sending it. The callback itself may release it before returning.
+ *
+ * @param[in] frame:    Decoded frame, the structure is only valid during the call
+ * @param[in] user_ctx: User context from the configuration
+ */
+typedef void (*esp_jpeg_mjpeg_frame_cb_t)(const esp_jpeg_mjpeg_frame_t *frame, void *user_ctx);
+
+/**
+ * @brief MJPEG decoder configuration
+ */
+typedef struct {
+    size_t max_frame_size;          /*!< Largest compressed frame, frames that do not fit are dropped */
+    uint16_t max_width;             /*!< Largest decoded image width, after out_scale, crop and out_width */
+    uint16_t max_height;            /*!< Largest decoded image height */
+    uint8_t num_fbs;                /*!< Number of framebuffers in the ring. With 2 or more, a frame is decoded while
+                                         the previous one is displayed */
+    uint32_t fb_caps;               /*!< Heap capabilities of the framebuffers, 0 for MALLOC_CAP_DEFAULT */
+    uint32_t frame_buf_caps;        /*!< Heap capabilities of the compressed frame buffers, 0 for MALLOC_CAP_DEFAULT */
+    esp_jpeg_image_cfg_t image_cfg; /*!< Decoding options: out_format, out_scale, crop, out_width/out_height, flags and
+                                         advanced.backend. Input, output and working buffer fields are not used */
+    esp_jpeg_mjpeg_frame_cb_t on_frame; /*!< Frame callback */
+    void *user_ctx;                 /*!< User context passed to on_frame */
+    struct {
+        uint32_t stack_size;        /*!< Stack size of the decoding task, 0 for 4 kB */
+        uint32_t priority;          /*!< Priority of the decoding task */
+        int core_id;                /*!< Core of the decoding task, tskNO_AFFINITY for any */
+    } task;
+} esp_jpeg_mjpeg_config_t;
+
+/**
+ * @brief Counters of an MJPEG decoder
+ */
+typedef struct {
+    uint32_t frames_decoded;    /*!< Frames passed to the frame callback */
+    uint32_t frames_dropped;    /*!< Frames dropped because the decoder was still busy with the previous one */
+    uint32_t frames_skipped;    /*!< Frames not decoded because no framebuffer was released by the application */
+    uint32_t frames_oversized;  /*!< Frames dropped because they are larger than max_frame_size */
+    uint32_t decode_errors;     /*!< Frames which failed to decode */
+    uint32_t last_decode_us;    /*!< Decoding time of the last frame */
+    uint32_t min_decode_us;     /*!< Shortest decoding time */
+    uint32_t max_decode_us;     /*!< Longest decoding time */
+    uint64_t total_decode_us;   /*!< Sum of decoding times, divide by frames_decoded for the average */
+    uint32_t max_latency_us;    /*!< Longest time from the end of a frame in the stream to the frame callback */
+} esp_jpeg_mjpeg_stats_t;
+
+/**
+ * @brief Create an MJPEG decoder and start its decoding task
+ *
+ * The decoder takes a byte stream through esp_jpeg_mjpeg_feed(), finds the JPEG frames in it (SOI to EOI) and
+ * decodes them into a ring of framebuffers on its own task. Bytes between frames, such as the boundaries and
+ * headers of an HTTP multipart stream, are skipped. The stream is paced to the decoder: a frame completed while
+ * the previous one is still being decoded is dropped.
+ *
+ * @param[in]  config:     Decoder configuration
+ * @param[out] ret_handle: Created decoder
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if an argument is NULL or the configuration is invalid
+ *      - ESP_ERR_NO_MEM      if there is no memory for the buffers or the task
+ */
+esp_err_t esp_jpeg_mjpeg_new(const esp_jpeg_mjpeg_config_t *config, esp_jpeg_mjpeg_handle_t *ret_handle);
+
+/**
+ * @brief Feed bytes of the stream
+ *
+ * Chunks may split frames anywhere. The frame data is copied once, into the compressed frame buffer.
+ *
+ * @note Must not be called by several tasks at the same time.
+ *
+ * @param[in] handle: MJPEG decoder
+ * @param[in] data:   Bytes of the stream
+ * @param[in] len:    Number of bytes
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if handle or data is NULL
+ */
+esp_err_t esp_jpeg_mjpeg_feed(esp_jpeg_mjpeg_handle_t handle, const uint8_t *data, size_t len);
+
+/**
+ * @brief Give a framebuffer back to the decoder
+ *
+ * @note May be called from an ISR, e.g. from the color transfer done callback of the display.
+ *
+ * @param[in] handle:   MJPEG decoder
+ * @param[in] fb_index: Framebuffer index of the frame (esp_jpeg_mjpeg_frame_t::fb_index)
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if handle is NULL or fb_index is out of range
+ */
+esp_err_t esp_jpeg_mjpeg_release_frame(esp_jpeg_mjpeg_handle_t handle, uint8_t fb_index);
+
+/**
+ * @brief Get the counters of the decoder
+ *
+ * @param[in]  handle: MJPEG decoder
+ * @param[out] stats:  Counters
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if handle or stats is NULL
+ */
+esp_err_t esp_jpeg_mjpeg_get_stats(esp_jpeg_mjpeg_handle_t handle, esp_jpeg_mjpeg_stats_t *stats);
+
+/**
+ * @brief Stop the decoding task and free the decoder
+ *
+ * The frame being decoded is finished first. Framebuffers must not be used after this call.
+ *
+ * @param[in] handle: MJPEG decoder
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if handle is NULL
+ */
+esp_err_t esp_jpeg_mjpeg_delete(esp_jpeg_mjpeg_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -5,6 +5,7 @@
  */
 
 #include <string.h>
+#include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "esp_system.h"
 #include "esp_rom_caps.h"
@@ -12,6 +13,17 @@
 #include "esp_err.h"
 #include "esp_check.h"
 #include "jpeg_decoder.h"
+#if CONFIG_JD_PARALLEL_DECODE
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#endif
+#if CONFIG_JD_HW_DECODE
+#include <sys/lock.h>
+#include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_cache.h"
+#include "driver/jpeg_decode.h"
+#endif
 
 #if CONFIG_JD_USE_ROM
 /* When supported in ROM, use ROM functions */
@@ -23,6 +35,9 @@
 
 /* The ROM code of TJPGD is older and has different return type in decode callback */
 typedef unsigned int jpeg_decode_out_t;
+
+/* The ROM code outputs RGB only */
+#define JD_COLOR_RGB    0
 #else
 /* When Tiny JPG Decoder is not in ROM or selected external code */
 #include "tjpgd.h"
@@ -38,10 +53,19 @@ static const char *TAG = "JPEG";
 
 #if defined(JD_FASTDECODE) && (JD_FASTDECODE == 2)
 #define JPEG_WORK_BUF_SIZE  65472
+#elif defined(JD_FASTDECODE) && (JD_FASTDECODE == 1)
+#define JPEG_WORK_BUF_SIZE  3500    /* 16-bit MCU buffer, 4:2:0 images with full Huffman tables need about 3480 bytes */
 #else
 #define JPEG_WORK_BUF_SIZE  3100    /* Recommended buffer size; Independent on the size of the image */
 #endif
 
+#if CONFIG_JD_TJPGD_IN_IRAM
+/* The Huffman and quantization tables live in the working buffer, keep them off the flash cache as the code */
+#define JPEG_WORK_BUF_CAPS  (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#else
+#define JPEG_WORK_BUF_CAPS  MALLOC_CAP_DEFAULT
+#endif
+
 /* If not set JD_FORMAT, it is set in ROM to RGB888, otherwise, it can be set in config */
 #ifndef JD_FORMAT
 #define JD_FORMAT 0
@@ -57,14 +81,105 @@ static const char *TAG = "JPEG";
 #define ESP_JPEG_COLOR_BYTES    1
 #endif
 
+/* Converts `pixels` pixels from the TJPGD format to the output format, `out` may be equal to `in`.
+ * (x, y) is the position of the first pixel in the output image, used by YUV422 and dithering. */
+typedef void (*jpeg_convert_row_t)(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x, unsigned int y);
+
+/* Box filter downscaling the decoded region to out_width x out_height. Source pixel (x, y) is added to the output
+ * pixel (x * dst_w / src_w, y * dst_h / src_h), an output row is written once all its source rows were decoded. */
+typedef struct {
+    uint16_t src_w, src_h;                  /* Size of the decoded region */
+    uint16_t dst_w, dst_h;                  /* Size of the output image */
+    uint16_t acc_rows;                      /* Output rows which can have pending sums at the same time */
+    uint16_t next_row;                      /* First output row not written yet */
+    uint8_t color_bytes;                    /* Bytes per pixel of the decoded blocks */
+    uint32_t *acc;                          /* Sums of the color components, output row n is at n % acc_rows */
+    uint8_t *row;                           /* One output row in the TJPGD format */
+} jpeg_resize_t;
+
+/* Decoder kept across images, see esp_jpeg_decoder_new() */
+struct esp_jpeg_decoder_t {
+    uint8_t *workbuf;                       /* JPEG_WORK_BUF_SIZE bytes */
+#if !CONFIG_JD_USE_ROM
+    JTBLCACHE tables;                       /* Tables of the previous image, built in workbuf */
+#endif
+};
+
+/* State of one decoding, passed to TJPGD as the device pointer */
+typedef struct {
+    esp_jpeg_image_cfg_t *cfg;
+    esp_jpeg_decoder_handle_t decoder;      /* NULL for a one-shot decoding */
+    jpeg_convert_row_t convert_row;         /* Selected once per decoding from the output format and flags */
+    bool convert_per_row;                   /* convert_row depends on the pixel position, a block is converted row by row */
+    uint8_t tjpgd_color;                    /* JD_COLOR_* decoded by TJPGD for the output format */
+    uint8_t in_color_bytes;                 /* Bytes per pixel of the blocks output by TJPGD */
+    uint8_t scale_div;
+    uint8_t out_color_bytes;
+    uint32_t out_stride;                    /* Bytes per row of cfg->outbuf */
+    uint32_t line;                          /* Width of the decoded region in pixels */
+    JRECT roi;                              /* Decoded region in the scaled image, blocks are clipped to it */
+    bool roi_stop;                          /* The region ends above the bottom of the image */
+    bool roi_done;                          /* TJPGD was interrupted after the last block of the region */
+    jpeg_resize_t *resize;                  /* NULL if the region is output without downscaling */
+    esp_jpeg_decode_stream_cb_t stream_cb;  /* NULL when decoding into cfg->outbuf */
+    void *stream_user_ctx;
+    esp_err_t stream_err;                   /* Error returned by stream_cb, reported once TJPGD is interrupted */
+} jpeg_decode_ctx_t;
+
+#if CONFIG_JD_PARALLEL_DECODE
+/* One strip per core, the calling task decodes the first one */
+#define JPEG_PARALLEL_STRIPS            portNUM_PROCESSORS
+/* The strips share the tables of the main decoder, they only need their own stream and MCU buffers */
+#define JPEG_PARALLEL_WORK_BUF_SIZE     3100
+
+/* Restart intervals decoded by a separate task */
+typedef struct {
+    JDEC jdec;
+    esp_jpeg_image_cfg_t cfg;       /* Copy of the user configuration with the stream position of this strip */
+    jpeg_decode_ctx_t ctx;
+    uint8_t *workbuf;
+    unsigned int first_interval;
+    unsigned int num_intervals;
+    SemaphoreHandle_t done;         /* NULL if no task was started, the strip is then decoded by the caller */
+    JRESULT res;
+} jpeg_strip_t;
+#endif
+
+#if CONFIG_JD_HW_DECODE
+#define JPEG_HW_TIMEOUT_MS  1000
+
+/* Created on the first hardware decoding and kept for the lifetime of the application */
+static jpeg_decoder_handle_t s_hw_engine;
+static _lock_t s_hw_lock;
+#endif
+
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
 static uint8_t jpeg_get_div_by_scale(esp_jpeg_image_scale_t scale);
 static uint8_t jpeg_get_color_bytes(esp_jpeg_image_format_t format);
+static uint8_t jpeg_get_tjpgd_color_bytes(uint8_t tjpgd_color);
+static esp_err_t jpeg_get_output_geometry(const esp_jpeg_image_cfg_t *cfg, uint16_t width, uint16_t height,
+        JRECT *roi, uint16_t *out_width, uint16_t *out_height);
+static jpeg_convert_row_t jpeg_get_convert_row(const esp_jpeg_image_cfg_t *cfg, uint8_t *tjpgd_color);
+static esp_err_t jpeg_decode(jpeg_decode_ctx_t *ctx, esp_jpeg_image_output_t *img);
+static esp_err_t jpeg_decode_image(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+                                   esp_jpeg_image_output_t *img);
+static void jpeg_convert_rect(const jpeg_decode_ctx_t *ctx, const uint8_t *in, size_t in_stride,
+                              uint8_t *dst, size_t dst_stride, unsigned int x, unsigned int y,
+                              unsigned int width, unsigned int height);
+static jpeg_resize_t *jpeg_resize_create(const jpeg_decode_ctx_t *ctx, unsigned int mcu_height,
+        uint16_t out_width, uint16_t out_height);
 
 static unsigned int jpeg_decode_in_cb(JDEC *jd, uint8_t *buff, unsigned int nbyte);
 static jpeg_decode_out_t jpeg_decode_out_cb(JDEC *jd, void *bitmap, JRECT *rect);
+static jpeg_decode_out_t jpeg_decode_stream_out_cb(JDEC *jd, void *bitmap, JRECT *rect);
+#if CONFIG_JD_PARALLEL_DECODE
+static esp_err_t jpeg_decode_parallel(jpeg_decode_ctx_t *ctx, JDEC *jdec);
+#endif
+#if CONFIG_JD_HW_DECODE
+static esp_err_t jpeg_decode_hw(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img);
+#endif
 static inline uint16_t ldb_word(const void *ptr);
 /*******************************************************************************
 * Public API functions
@@ -72,53 +187,73 @@ static inline uint16_t ldb_word(const void *ptr);
 
 esp_err_t esp_jpeg_decode(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
 {
-    esp_err_t ret = ESP_OK;
-    uint8_t *workbuf = NULL;
-    JRESULT res;
-    JDEC JDEC;
-
     assert(cfg != NULL);
     assert(img != NULL);
 
-    const bool allocate_buffer = (cfg->advanced.working_buffer == NULL);
-    const size_t workbuf_size = allocate_buffer ? JPEG_WORK_BUF_SIZE : cfg->advanced.working_buffer_size;
-    if (allocate_buffer) {
-        workbuf = heap_caps_malloc(JPEG_WORK_BUF_SIZE, MALLOC_CAP_DEFAULT);
-        ESP_GOTO_ON_FALSE(workbuf, ESP_ERR_NO_MEM, err, TAG, "no mem for JPEG work buffer");
-    } else {
-        workbuf = cfg->advanced.working_buffer;
-        ESP_RETURN_ON_FALSE(workbuf_size != 0, ESP_ERR_INVALID_ARG, TAG, "Working buffer size not defined!");
-    }
+    return jpeg_decode_image(NULL, cfg, img);
+}
 
+esp_err_t esp_jpeg_decode_stream(esp_jpeg_image_cfg_t *cfg, esp_jpeg_decode_stream_cb_t cb, void *user_ctx,
+                                 esp_jpeg_image_output_t *img)
+{
+    ESP_RETURN_ON_FALSE(cfg && cb && img, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
 
-    cfg->priv.read = 0;
+    jpeg_decode_ctx_t ctx = {
+        .cfg = cfg,
+        .stream_cb = cb,
+        .stream_user_ctx = user_ctx,
+        .stream_err = ESP_OK,
+    };
+    return jpeg_decode(&ctx, img);
+}
 
-    /* Prepare image */
-    res = jd_prepare(&JDEC, jpeg_decode_in_cb, workbuf, workbuf_size, cfg);
-    ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in preparing JPEG image! %d", res);
+esp_err_t esp_jpeg_decoder_new(const esp_jpeg_decoder_config_t *config, esp_jpeg_decoder_handle_t *ret_decoder)
+{
+    ESP_RETURN_ON_FALSE(ret_decoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const uint32_t caps = (config && config->working_buffer_caps) ? config->working_buffer_caps : JPEG_WORK_BUF_CAPS;
 
-    const uint8_t scale_div       = jpeg_get_div_by_scale(cfg->out_scale);
-    const uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
+    esp_jpeg_decoder_handle_t decoder = heap_caps_calloc(1, sizeof(struct esp_jpeg_decoder_t), MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(decoder, ESP_ERR_NO_MEM, TAG, "no mem for JPEG decoder");
+    decoder->workbuf = heap_caps_malloc(JPEG_WORK_BUF_SIZE, caps);
+    if (decoder->workbuf == NULL) {
+        free(decoder);
+        ESP_LOGE(TAG, "no mem for JPEG work buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_decoder = decoder;
+    return ESP_OK;
+}
 
-    /* Size of output image */
-    const uint32_t outsize = (JDEC.height / scale_div) * (JDEC.width / scale_div) * out_color_bytes;
-    ESP_GOTO_ON_FALSE((outsize <= cfg->outbuf_size), ESP_ERR_NO_MEM, err, TAG, "Not enough size in output buffer!");
+esp_err_t esp_jpeg_decoder_decode(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+                                  esp_jpeg_image_output_t *img)
+{
+    ESP_RETURN_ON_FALSE(decoder && cfg && img, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
 
-    /* Size of output image */
-    img->height = JDEC.height / scale_div;
-    img->width = JDEC.width / scale_div;
-    img->output_len = outsize;
+    return jpeg_decode_image(decoder, cfg, img);
+}
 
-    /* Decode JPEG */
-    res = jd_decomp(&JDEC, jpeg_decode_out_cb, cfg->out_scale);
-    ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in decoding JPEG image! %d", res);
+esp_err_t esp_jpeg_decoder_decode_stream(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+        esp_jpeg_decode_stream_cb_t cb, void *user_ctx, esp_jpeg_image_output_t *img)
+{
+    ESP_RETURN_ON_FALSE(decoder && cfg && cb && img, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
 
-err:
-    if (workbuf && allocate_buffer) {
-        free(workbuf);
-    }
+    jpeg_decode_ctx_t ctx = {
+        .cfg = cfg,
+        .decoder = decoder,
+        .stream_cb = cb,
+        .stream_user_ctx = user_ctx,
+        .stream_err = ESP_OK,
+    };
+    return jpeg_decode(&ctx, img);
+}
 
-    return ret;
+esp_err_t esp_jpeg_decoder_delete(esp_jpeg_decoder_handle_t decoder)
+{
+    ESP_RETURN_ON_FALSE(decoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    free(decoder->workbuf);
+    free(decoder);
+    return ESP_OK;
 }
 
 esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
@@ -154,10 +289,11 @@ esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_outp
             /* Size of output image */
             img->height = ldb_word(seg + 1);
             img->width = ldb_word(seg + 3);
-            const uint8_t scale_div       = jpeg_get_div_by_scale(cfg->out_scale);
             const uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
-            img->output_len = (img->height / scale_div) * (img->width / scale_div) * out_color_bytes;
-            ret = ESP_OK;
+            JRECT roi;
+            uint16_t out_width, out_height;
+            ret = jpeg_get_output_geometry(cfg, img->width, img->height, &roi, &out_width, &out_height);
+            img->output_len = out_width * out_height * out_color_bytes;
             break;
         }
     }
@@ -168,13 +304,412 @@ esp_err_t esp_jpeg_get_image_info(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_outp
 * Private API functions
 *******************************************************************************/
 
+/* Decodes into cfg->outbuf, with the hardware decoder if possible */
+static esp_err_t jpeg_decode_image(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *cfg,
+                                   esp_jpeg_image_output_t *img)
+{
+#if CONFIG_JD_HW_DECODE
+    if (cfg->advanced.backend != JPEG_DECODER_BACKEND_SOFTWARE) {
+        esp_err_t ret = jpeg_decode_hw(cfg, img);
+        if (ret == ESP_OK || cfg->advanced.backend == JPEG_DECODER_BACKEND_HARDWARE) {
+            return ret;
+        }
+        ESP_LOGD(TAG, "Hardware decoder not used (%s), decoding in software", esp_err_to_name(ret));
+    }
+#else
+    if (cfg->advanced.backend == JPEG_DECODER_BACKEND_HARDWARE) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+#endif
+
+    jpeg_decode_ctx_t ctx = {
+        .cfg = cfg,
+        .decoder = decoder,
+    };
+    return jpeg_decode(&ctx, img);
+}
+
+static esp_err_t jpeg_decode(jpeg_decode_ctx_t *ctx, esp_jpeg_image_output_t *img)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t *workbuf = NULL;
+    JRESULT res;
+    JDEC JDEC;
+    esp_jpeg_image_cfg_t *cfg = ctx->cfg;
+
+    ESP_RETURN_ON_FALSE(cfg->indata || cfg->read_cb, ESP_ERR_INVALID_ARG, TAG, "No input data");
+    ctx->convert_row = jpeg_get_convert_row(cfg, &ctx->tjpgd_color);
+    ESP_RETURN_ON_FALSE(ctx->convert_row, ESP_ERR_INVALID_ARG, TAG, "Selected output format is not supported!");
+    ctx->in_color_bytes = jpeg_get_tjpgd_color_bytes(ctx->tjpgd_color);
+    ctx->convert_per_row = (cfg->out_format == JPEG_IMAGE_FORMAT_YUV422 ||
+                            (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565 && cfg->flags.dither));
+
+    const bool allocate_buffer = (ctx->decoder == NULL && cfg->advanced.working_buffer == NULL);
+    const size_t workbuf_size = (allocate_buffer || ctx->decoder) ? JPEG_WORK_BUF_SIZE : cfg->advanced.working_buffer_size;
+    if (ctx->decoder) {
+        workbuf = ctx->decoder->workbuf;
+    } else if (allocate_buffer) {
+        workbuf = heap_caps_malloc(JPEG_WORK_BUF_SIZE, JPEG_WORK_BUF_CAPS);
+        ESP_GOTO_ON_FALSE(workbuf, ESP_ERR_NO_MEM, err, TAG, "no mem for JPEG work buffer");
+    } else {
+        workbuf = cfg->advanced.working_buffer;
+        ESP_RETURN_ON_FALSE(workbuf_size != 0, ESP_ERR_INVALID_ARG, TAG, "Working buffer size not defined!");
+    }
+
+
+    cfg->priv.read = 0;
+
+    /* Prepare image */
+#if CONFIG_JD_USE_ROM
+    res = jd_prepare(&JDEC, jpeg_decode_in_cb, workbuf, workbuf_size, ctx);
+#else
+    /* A decoder keeps the tables of the previous image in its working buffer */
+    res = jd_prepare_cached(&JDEC, jpeg_decode_in_cb, workbuf, workbuf_size, ctx,
+                            ctx->decoder ? &ctx->decoder->tables : NULL);
+#endif
+    ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in preparing JPEG image! %d", res);
+#if !CONFIG_JD_USE_ROM
+    JDEC.color = ctx->tjpgd_color;
+#endif
+
+    const uint8_t scale_div       = jpeg_get_div_by_scale(cfg->out_scale);
+    const uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
+    uint16_t out_width, out_height;
+    ESP_GOTO_ON_ERROR(jpeg_get_output_geometry(cfg, JDEC.width, JDEC.height, &ctx->roi, &out_width, &out_height),
+                      err, TAG, "Invalid crop or output size");
+    ctx->scale_div = scale_div;
+    ctx->out_color_bytes = out_color_bytes;
+    ctx->line = ctx->roi.right - ctx->roi.left + 1;
+    ctx->roi_stop = ctx->roi.bottom + 1 < JDEC.height / scale_div;
+
+    /* Size of output image, up to the end of the last row with out_stride */
+    const uint32_t row_size = out_width * out_color_bytes;
+    ctx->out_stride = cfg->out_stride ? cfg->out_stride : row_size;
+    const uint32_t outsize = (out_height - 1) * ctx->out_stride + row_size;
+    if (ctx->stream_cb == NULL) {
+        ESP_GOTO_ON_FALSE((ctx->out_stride >= row_size), ESP_ERR_INVALID_ARG, err, TAG, "Output stride shorter than a row!");
+        ESP_GOTO_ON_FALSE((outsize <= cfg->outbuf_size), ESP_ERR_NO_MEM, err, TAG, "Not enough size in output buffer!");
+    }
+
+    /* Size of output image */
+    img->height = out_height;
+    img->width = out_width;
+    img->output_len = outsize;
+
+    if (out_width != ctx->line || out_height != ctx->roi.bottom - ctx->roi.top + 1) {
+        ctx->resize = jpeg_resize_create(ctx, (JDEC.msy * 8) / scale_div, out_width, out_height);
+        ESP_GOTO_ON_FALSE(ctx->resize, ESP_ERR_NO_MEM, err, TAG, "no mem for downscaling");
+    }
+
+#if CONFIG_JD_PARALLEL_DECODE
+    /* Images with restart intervals can be split between the cores, blocks are then not output in order.
+     * The strips are located in the input data, so it must be in memory. Only whole images are split. */
+    if (JDEC.nrst && ctx->stream_cb == NULL && cfg->read_cb == NULL && cfg->crop.width == 0 && ctx->resize == NULL) {
+        ret = jpeg_decode_parallel(ctx, &JDEC);
+        if (ret != ESP_ERR_NOT_SUPPORTED) {
+            goto err;
+        }
+        ret = ESP_OK;
+    }
+#endif
+
+    /* Decode JPEG */
+#if CONFIG_JD_USE_ROM
+    /* The ROM decoder outputs the whole image, the output callbacks clip the blocks and interrupt it after the region */
+    res = jd_decomp(&JDEC, ctx->stream_cb ? jpeg_decode_stream_out_cb : jpeg_decode_out_cb, cfg->out_scale);
+#else
+    const JRECT rect = {
+        .left = ctx->roi.left * scale_div,
+        .right = (ctx->roi.right + 1) * scale_div - 1,
+        .top = ctx->roi.top * scale_div,
+        .bottom = (ctx->roi.bottom + 1) * scale_div - 1,
+    };
+    res = jd_decomp_rect(&JDEC, ctx->stream_cb ? jpeg_decode_stream_out_cb : jpeg_decode_out_cb, cfg->out_scale, &rect);
+#endif
+    if (res == JDR_INTR && ctx->stream_err != ESP_OK) {
+        ret = ctx->stream_err;
+        goto err;
+    }
+    if (res == JDR_INTR && ctx->roi_done) {
+        res = JDR_OK;
+    }
+    ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, err, TAG, "Error in decoding JPEG image! %d", res);
+
+err:
+    if (workbuf && allocate_buffer) {
+        free(workbuf);
+    }
+    free(ctx->resize);
+    ctx->resize = NULL;
+
+    return ret;
+}
+
+#if CONFIG_JD_PARALLEL_DECODE
+/* Finds the offset of the entropy coded data, which follows the SOS segment */
+static esp_err_t jpeg_find_scan_data(const esp_jpeg_image_cfg_t *cfg, uint32_t *scan_ofs)
+{
+    uint32_t ofs = 2; // Start after SOI marker
+
+    while (ofs + 4 <= cfg->indata_size) {
+        const uint8_t *seg = cfg->indata + ofs;
+        if (seg[0] == 0xFF && seg[1] == 0xFF) {
+            ofs++; // Fill byte before a marker
+            continue;
+        }
+        unsigned short marker = ldb_word(seg);
+        unsigned int len = ldb_word(seg + 2);
+        if (len <= 2 || (marker >> 8) != 0xFF) {
+            return ESP_FAIL;
+        }
+        ofs += 2 + len;
+        if ((marker & 0xFF) == 0xDA) { /* SOS */
+            *scan_ofs = ofs;
+            return ofs < cfg->indata_size ? ESP_OK : ESP_FAIL;
+        }
+    }
+    return ESP_FAIL;
+}
+
+static void jpeg_strip_task(void *arg)
+{
+    jpeg_strip_t *strip = (jpeg_strip_t *)arg;
+
+    strip->res = jd_decomp_intervals(&strip->jdec, jpeg_decode_out_cb, strip->cfg.out_scale,
+                                     strip->first_interval, strip->num_intervals);
+    xSemaphoreGive(strip->done);
+    vTaskDelete(NULL);
+}
+
+/* Splits the restart intervals of the image into strips and decodes them on all cores. Returns ESP_ERR_NOT_SUPPORTED
+ * if the image can't be split, it is then decoded serially. */
+static esp_err_t jpeg_decode_parallel(jpeg_decode_ctx_t *ctx, JDEC *jdec)
+{
+    esp_err_t ret = ESP_OK;
+    const esp_jpeg_image_cfg_t *cfg = ctx->cfg;
+    const unsigned int mx = jdec->msx * 8, my = jdec->msy * 8;
+    const unsigned int mcus = ((jdec->width + mx - 1) / mx) * ((jdec->height + my - 1) / my);
+    const unsigned int intervals = (mcus + jdec->nrst - 1) / jdec->nrst;
+    const unsigned int num_strips = JPEG_PARALLEL_STRIPS;
+    unsigned int first[JPEG_PARALLEL_STRIPS + 1];
+    uint32_t scan_ofs;
+
+    if (intervals < num_strips || jpeg_find_scan_data(cfg, &scan_ofs) != ESP_OK) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    for (unsigned int s = 0; s <= num_strips; s++) {
+        first[s] = s * intervals / num_strips;
+    }
+
+    jpeg_strip_t *strips = heap_caps_calloc(num_strips - 1, sizeof(jpeg_strip_t), MALLOC_CAP_DEFAULT);
+    if (strips == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* Strip s starts at the RSTn marker preceding its first interval, that is the marker number first[s] - 1 */
+    unsigned int marker = 0, s = 1;
+    for (uint32_t i = scan_ofs; i + 1 < cfg->indata_size && s < num_strips; i++) {
+        if (cfg->indata[i] == 0xFF && (cfg->indata[i + 1] & 0xF8) == 0xD0) {
+            if (marker == first[s] - 1) {
+                strips[s - 1].cfg = *cfg;
+                strips[s - 1].cfg.priv.read = i;
+                s++;
+            }
+            marker++;
+            i++;
+        }
+    }
+    if (s < num_strips) {
+        ESP_LOGD(TAG, "Restart markers not found, decoding serially");
+        ret = ESP_ERR_NOT_SUPPORTED;
+        goto err;
+    }
+
+    for (s = 1; s < num_strips; s++) {
+        jpeg_strip_t *strip = &strips[s - 1];
+        strip->ctx = *ctx;
+        strip->ctx.cfg = &strip->cfg;
+        strip->first_interval = first[s];
+        strip->num_intervals = first[s + 1] - first[s];
+        strip->workbuf = heap_caps_malloc(JPEG_PARALLEL_WORK_BUF_SIZE, JPEG_WORK_BUF_CAPS);
+        ESP_GOTO_ON_FALSE(strip->workbuf, ESP_ERR_NO_MEM, wait, TAG, "no mem for JPEG work buffer");
+        ESP_GOTO_ON_FALSE(jd_clone(&strip->jdec, jdec, strip->workbuf, JPEG_PARALLEL_WORK_BUF_SIZE, &strip->ctx) == JDR_OK,
+                          ESP_ERR_NO_MEM, wait, TAG, "JPEG work buffer too small");
+
+        strip->done = xSemaphoreCreateBinary();
+        if (strip->done && xTaskCreatePinnedToCore(jpeg_strip_task, "jpeg_strip", CONFIG_JD_PARALLEL_TASK_STACK_SIZE, strip,
+                uxTaskPriorityGet(NULL), NULL, (xPortGetCoreID() + s) % portNUM_PROCESSORS) != pdPASS) {
+            vSemaphoreDelete(strip->done);
+            strip->done = NULL;
+        }
+    }
+
+    /* Decode the first strip, and the ones which could not get a task */
+    JRESULT res = jd_decomp_intervals(jdec, jpeg_decode_out_cb, cfg->out_scale, 0, first[1]);
+    ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, wait, TAG, "Error in decoding JPEG image! %d", res);
+    for (s = 1; s < num_strips; s++) {
+        jpeg_strip_t *strip = &strips[s - 1];
+        if (strip->done == NULL) {
+            res = jd_decomp_intervals(&strip->jdec, jpeg_decode_out_cb, cfg->out_scale, strip->first_interval,
+                                      strip->num_intervals);
+            ESP_GOTO_ON_FALSE((res == JDR_OK), ESP_FAIL, wait, TAG, "Error in decoding JPEG image! %d", res);
+        }
+    }
+
+wait:
+    /* The tasks write into the output buffer, wait for all of them even if decoding failed */
+    for (s = 1; s < num_strips; s++) {
+        jpeg_strip_t *strip = &strips[s - 1];
+        if (strip->done) {
+            xSemaphoreTake(strip->done, portMAX_DELAY);
+            vSemaphoreDelete(strip->done);
+            if (ret == ESP_OK && strip->res != JDR_OK) {
+                ESP_LOGE(TAG, "Error in decoding JPEG image! %d", strip->res);
+                ret = ESP_FAIL;
+            }
+        }
+        free(strip->workbuf);
+    }
+err:
+    free(strips);
+    return ret;
+}
+#endif
+
+#if CONFIG_JD_HW_DECODE
+/* Returns the alignment the hardware decoder requires for a buffer in the memory of ptr */
+static size_t jpeg_hw_get_alignment(const void *ptr)
+{
+    size_t alignment = 0;
+    uint32_t caps = esp_ptr_external_ram(ptr) ? MALLOC_CAP_SPIRAM : MALLOC_CAP_DMA;
+    if (esp_cache_get_alignment(caps, &alignment) != ESP_OK || alignment == 0) {
+        alignment = 4;
+    }
+    return alignment;
+}
+
+static esp_err_t jpeg_decode_hw(esp_jpeg_image_cfg_t *cfg, esp_jpeg_image_output_t *img)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t *inbuf = NULL;
+    jpeg_decode_picture_info_t info;
+    uint32_t mcu_w, mcu_h;
+
+    /* Scaling, cropping, streamed input, strided rows, grayscale, YUV and dithered output are done by TJpgDec only */
+    if (cfg->indata == NULL || cfg->read_cb || cfg->out_scale != JPEG_IMAGE_SCALE_0 || cfg->outbuf == NULL ||
+            cfg->crop.width || cfg->crop.height || cfg->out_width || cfg->out_height || cfg->out_stride ||
+            (cfg->out_format != JPEG_IMAGE_FORMAT_RGB888 && cfg->out_format != JPEG_IMAGE_FORMAT_RGB565) ||
+            cfg->flags.dither) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (jpeg_decoder_get_info(cfg->indata, cfg->indata_size, &info) != ESP_OK) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    switch (info.sample_method) {
+    case JPEG_DOWN_SAMPLING_YUV444:
+        mcu_w = 8;
+        mcu_h = 8;
+        break;
+    case JPEG_DOWN_SAMPLING_YUV422:
+        mcu_w = 16;
+        mcu_h = 8;
+        break;
+    case JPEG_DOWN_SAMPLING_YUV420:
+        mcu_w = 16;
+        mcu_h = 16;
+        break;
+    default:
+        /* Grayscale images can't be output in RGB by the hardware */
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    /* The hardware writes whole MCUs, the output would be padded otherwise */
+    if ((info.width % mcu_w) != 0 || (info.height % mcu_h) != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    const uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
+    const uint32_t out_len = info.width * info.height * out_color_bytes;
+    ESP_RETURN_ON_FALSE(out_len <= cfg->outbuf_size, ESP_ERR_NO_MEM, TAG, "Not enough size in output buffer!");
+
+    /* The output is written by DMA, the buffer must not share cache lines with other data */
+    const size_t out_align = jpeg_hw_get_alignment(cfg->outbuf);
+    if (((uintptr_t)cfg->outbuf % out_align) != 0 || (cfg->outbuf_size % out_align) != 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* Images in flash or in unaligned buffers are copied to memory the DMA can read */
+    const uint8_t *bitstream = cfg->indata;
+    if (!(esp_ptr_dma_capable(bitstream) || esp_ptr_dma_ext_capable(bitstream)) ||
+            ((uintptr_t)bitstream % jpeg_hw_get_alignment(bitstream)) != 0) {
+        jpeg_decode_memory_alloc_cfg_t mem_cfg = {
+            .buffer_direction = JPEG_DEC_ALLOC_INPUT_BUFFER,
+        };
+        size_t inbuf_size = 0;
+        inbuf = jpeg_alloc_decoder_mem(cfg->indata_size, &mem_cfg, &inbuf_size);
+        ESP_RETURN_ON_FALSE(inbuf, ESP_ERR_NO_MEM, TAG, "no mem for the input buffer");
+        memcpy(inbuf, cfg->indata, cfg->indata_size);
+        bitstream = inbuf;
+    }
+
+    jpeg_decode_cfg_t decode_cfg = {
+        .output_format = (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) ? JPEG_DECODE_OUT_FORMAT_RGB565 : JPEG_DECODE_OUT_FORMAT_RGB888,
+        /* Swapping the first and last color bytes of RGB888 is the BGR order, RGB565 is swapped below */
+        .rgb_order = (cfg->flags.swap_color_bytes && cfg->out_format == JPEG_IMAGE_FORMAT_RGB888) ? JPEG_DEC_RGB_ELEMENT_ORDER_BGR : JPEG_DEC_RGB_ELEMENT_ORDER_RGB,
+        .conv_std = JPEG_YUV_RGB_CONV_STD_BT601,
+    };
+    uint32_t out_size = 0;
+
+    _lock_acquire(&s_hw_lock);
+    if (s_hw_engine == NULL) {
+        jpeg_decode_engine_cfg_t engine_cfg = {
+            .timeout_ms = JPEG_HW_TIMEOUT_MS,
+        };
+        ret = jpeg_new_decoder_engine(&engine_cfg, &s_hw_engine);
+    }
+    if (ret == ESP_OK) {
+        ret = jpeg_decoder_process(s_hw_engine, &decode_cfg, bitstream, cfg->indata_size,
+                                   cfg->outbuf, cfg->outbuf_size, &out_size);
+    }
+    _lock_release(&s_hw_lock);
+    free(inbuf);
+    ESP_RETURN_ON_ERROR(ret, TAG, "hardware decoder failed");
+
+    if (cfg->flags.swap_color_bytes && cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) {
+        uint16_t *pixels = (uint16_t *)cfg->outbuf;
+        for (uint32_t i = 0; i < info.width * info.height; i++) {
+            pixels[i] = __builtin_bswap16(pixels[i]);
+        }
+    }
+
+    img->width = info.width;
+    img->height = info.height;
+    img->output_len = out_len;
+    return ESP_OK;
+}
+#endif
+
 static unsigned int jpeg_decode_in_cb(JDEC *dec, uint8_t *buff, unsigned int nbyte)
 {
     assert(dec != NULL);
 
     uint32_t to_read = nbyte;
-    esp_jpeg_image_cfg_t *cfg = (esp_jpeg_image_cfg_t *)dec->device;
-    assert(cfg != NULL);
+    jpeg_decode_ctx_t *ctx = (jpeg_decode_ctx_t *)dec->device;
+    assert(ctx != NULL);
+    esp_jpeg_image_cfg_t *cfg = ctx->cfg;
+
+    if (cfg->read_cb) {
+        /* TJPGD treats a short read as the end of the stream, so read until the request is complete */
+        uint32_t done = 0;
+        while (done < to_read) {
+            size_t len = cfg->read_cb(cfg->read_cb_ctx, buff ? buff + done : NULL, to_read - done);
+            if (len == 0) {
+                break;
+            }
+            done += len;
+        }
+        cfg->priv.read += done;
+        return done;
+    }
 
     if (buff) {
         if (cfg->priv.read + to_read > cfg->indata_size) {
@@ -192,58 +727,421 @@ static unsigned int jpeg_decode_in_cb(JDEC *dec, uint8_t *buff, unsigned int nby
     return to_read;
 }
 
+/* RGB888 to RGB565, the result is stored little endian (native) or big endian (swapped) */
+#define JPEG_RGB565(r, g, b)            ((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3))
+#define JPEG_SWAP16(c)                  ((uint16_t)(((c) >> 8) | ((c) << 8)))
+
+static void jpeg_convert_row_copy(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x, unsigned int y)
+{
+    if (in != out) {
+        memmove(out, in, pixels * ESP_JPEG_COLOR_BYTES);
+    }
+}
+
+#if (JD_FORMAT==0)
+static void jpeg_convert_row_rgb888_swap(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x,
+        unsigned int y)
+{
+    for (unsigned int i = 0; i < pixels; i++) {
+        const uint8_t first = in[0];
+        out[0] = in[2];
+        out[1] = in[1];
+        out[2] = first;
+        in += 3;
+        out += 3;
+    }
+}
+
+/* Output pixels are 2/3 of the input ones, so the conversion can run in place: every pair of pixels is read
+ * before it is overwritten. With a word aligned output, two pixels are stored at once. */
+static inline void jpeg_convert_row_rgb888_to_rgb565_common(const uint8_t *in, uint8_t *out, unsigned int pixels,
+        const bool swap)
+{
+    unsigned int i = 0;
+    if (((uintptr_t)out & 3) == 0) {
+        uint32_t *out32 = (uint32_t *)out;
+        for (; i + 1 < pixels; i += 2) {
+            uint16_t c0 = JPEG_RGB565(in[0], in[1], in[2]);
+            uint16_t c1 = JPEG_RGB565(in[3], in[4], in[5]);
+            if (swap) {
+                c0 = JPEG_SWAP16(c0);
+                c1 = JPEG_SWAP16(c1);
+            }
+            *out32++ = c0 | ((uint32_t)c1 << 16);
+            in += 6;
+        }
+        out = (uint8_t *)out32;
+    }
+    for (; i < pixels; i++) {
+        const uint16_t color = JPEG_RGB565(in[0], in[1], in[2]);
+        out[swap ? 1 : 0] = LOBYTE(color);
+        out[swap ? 0 : 1] = HIBYTE(color);
+        in += 3;
+        out += 2;
+    }
+}
+
+static void jpeg_convert_row_rgb888_to_rgb565(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x,
+        unsigned int y)
+{
+    jpeg_convert_row_rgb888_to_rgb565_common(in, out, pixels, false);
+}
+
+static void jpeg_convert_row_rgb888_to_rgb565_swap(const uint8_t *in, uint8_t *out, unsigned int pixels,
+        unsigned int x, unsigned int y)
+{
+    jpeg_convert_row_rgb888_to_rgb565_common(in, out, pixels, true);
+}
+
+/* 4x4 Bayer matrix, thresholds 0..15 */
+static const uint8_t s_dither_4x4[4][4] = {
+    { 0,  8,  2, 10},
+    {12,  4, 14,  6},
+    { 3, 11,  1,  9},
+    {15,  7, 13,  5},
+};
+
+/* Ordered dithering: the threshold of the pixel position is added below the kept bits before truncation, so areas
+ * of one color are rendered with the two nearest RGB565 colors in the right proportion instead of banding */
+static inline void jpeg_convert_row_rgb888_to_rgb565_dither_common(const uint8_t *in, uint8_t *out,
+        unsigned int pixels, unsigned int x, unsigned int y, const bool swap)
+{
+    const uint8_t *thr = s_dither_4x4[y & 3];
+    for (unsigned int i = 0; i < pixels; i++) {
+        const unsigned int t = thr[(x + i) & 3];
+        const unsigned int r = MIN(in[0] + (t >> 1), 255);
+        const unsigned int g = MIN(in[1] + (t >> 2), 255);
+        const unsigned int b = MIN(in[2] + (t >> 1), 255);
+        const uint16_t color = JPEG_RGB565(r, g, b);
+        out[swap ? 1 : 0] = LOBYTE(color);
+        out[swap ? 0 : 1] = HIBYTE(color);
+        in += 3;
+        out += 2;
+    }
+}
+
+static void jpeg_convert_row_rgb888_to_rgb565_dither(const uint8_t *in, uint8_t *out, unsigned int pixels,
+        unsigned int x, unsigned int y)
+{
+    jpeg_convert_row_rgb888_to_rgb565_dither_common(in, out, pixels, x, y, false);
+}
+
+static void jpeg_convert_row_rgb888_to_rgb565_dither_swap(const uint8_t *in, uint8_t *out, unsigned int pixels,
+        unsigned int x, unsigned int y)
+{
+    jpeg_convert_row_rgb888_to_rgb565_dither_common(in, out, pixels, x, y, true);
+}
+#elif (JD_FORMAT==1)
+static void jpeg_convert_row_rgb565_swap(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x,
+                                         unsigned int y)
+{
+    for (unsigned int i = 0; i < pixels; i++) {
+        const uint8_t first = in[0];
+        out[0] = in[1];
+        out[1] = first;
+        in += 2;
+        out += 2;
+    }
+}
+#endif
+
+#if !CONFIG_JD_USE_ROM
+static void jpeg_convert_row_gray(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x, unsigned int y)
+{
+    if (in != out) {
+        memmove(out, in, pixels);
+    }
+}
+
+/* YCbCr (3 bytes) to YUV422 (2 bytes): even pixels keep Cb, odd pixels Cr. The chroma of the pixel is picked instead
+ * of averaged, TJPGD upsampled it from one sample per pixel pair already for 4:2:x images. */
+static inline void jpeg_convert_row_ycc_to_yuv422_common(const uint8_t *in, uint8_t *out, unsigned int pixels,
+        unsigned int x, const bool swap)
+{
+    for (unsigned int i = 0; i < pixels; i++) {
+        const uint8_t yy = in[0], c = in[((x + i) & 1) ? 2 : 1];
+        out[swap ? 1 : 0] = yy;
+        out[swap ? 0 : 1] = c;
+        in += 3;
+        out += 2;
+    }
+}
+
+static void jpeg_convert_row_ycc_to_yuyv(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x,
+        unsigned int y)
+{
+    jpeg_convert_row_ycc_to_yuv422_common(in, out, pixels, x, false);
+}
+
+static void jpeg_convert_row_ycc_to_uyvy(const uint8_t *in, uint8_t *out, unsigned int pixels, unsigned int x,
+        unsigned int y)
+{
+    jpeg_convert_row_ycc_to_yuv422_common(in, out, pixels, x, true);
+}
+#endif
+
+static jpeg_convert_row_t jpeg_get_convert_row(const esp_jpeg_image_cfg_t *cfg, uint8_t *tjpgd_color)
+{
+    const bool swap = cfg->flags.swap_color_bytes;
+    *tjpgd_color = JD_COLOR_RGB;
+#if !CONFIG_JD_USE_ROM
+    /* The ROM decoder can only output RGB */
+    if (cfg->out_format == JPEG_IMAGE_FORMAT_GRAY) {
+        *tjpgd_color = JD_COLOR_GRAY;
+        return jpeg_convert_row_gray;
+    } else if (cfg->out_format == JPEG_IMAGE_FORMAT_YUV422) {
+        *tjpgd_color = JD_COLOR_YCC;
+        return swap ? jpeg_convert_row_ycc_to_uyvy : jpeg_convert_row_ycc_to_yuyv;
+    }
+#endif
+#if (JD_FORMAT==0)
+    if (cfg->out_format == JPEG_IMAGE_FORMAT_RGB888) {
+        return swap ? jpeg_convert_row_rgb888_swap : jpeg_convert_row_copy;
+    } else if (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565 && cfg->flags.dither) {
+        return swap ? jpeg_convert_row_rgb888_to_rgb565_dither_swap : jpeg_convert_row_rgb888_to_rgb565_dither;
+    } else if (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) {
+        return swap ? jpeg_convert_row_rgb888_to_rgb565_swap : jpeg_convert_row_rgb888_to_rgb565;
+    }
+#elif (JD_FORMAT==1)
+    /* TJPGD truncates to RGB565 itself, it can't be dithered */
+    if (cfg->out_format == JPEG_IMAGE_FORMAT_RGB565 && !cfg->flags.dither) {
+        return swap ? jpeg_convert_row_rgb565_swap : jpeg_convert_row_copy;
+    }
+#endif
+    return NULL;
+}
+
+/* Converts a rectangle of pixels in the TJPGD format to the output format. dst may be equal to in, or point before it
+ * in the same buffer: the output pixel is never larger than the decoded one, so the conversion can run in place. */
+static void jpeg_convert_rect(const jpeg_decode_ctx_t *ctx, const uint8_t *in, size_t in_stride,
+                              uint8_t *dst, size_t dst_stride, unsigned int x, unsigned int y,
+                              unsigned int width, unsigned int height)
+{
+    if (in_stride == width * ctx->in_color_bytes && dst_stride == width * ctx->out_color_bytes && !ctx->convert_per_row) {
+        /* Rows are contiguous in both buffers, convert the block at once */
+        ctx->convert_row(in, dst, width * height, x, y);
+        return;
+    }
+    for (unsigned int row = 0; row < height; row++) {
+        ctx->convert_row(in, dst, width, x, y + row);
+        in += in_stride;
+        dst += dst_stride;
+    }
+}
+
+/* First source pixel of output pixel n, for a downscaling from src to dst pixels */
+static inline unsigned int jpeg_resize_first(unsigned int n, unsigned int src, unsigned int dst)
+{
+    return (n * src + dst - 1) / dst;
+}
+
+static jpeg_resize_t *jpeg_resize_create(const jpeg_decode_ctx_t *ctx, unsigned int mcu_height,
+        uint16_t out_width, uint16_t out_height)
+{
+    const uint16_t src_w = ctx->roi.right - ctx->roi.left + 1;
+    const uint16_t src_h = ctx->roi.bottom - ctx->roi.top + 1;
+    /* An MCU row completes the output rows it covers, only the last one may wait for the next MCU row */
+    unsigned int acc_rows = ((mcu_height ? mcu_height : 1) - 1) * out_height / src_h + 2;
+    if (acc_rows > out_height) {
+        acc_rows = out_height;
+    }
+
+    const size_t acc_size = acc_rows * out_width * 3 * sizeof(uint32_t);
+    jpeg_resize_t *resize = heap_caps_calloc(1, sizeof(jpeg_resize_t) + acc_size + out_width * ctx->in_color_bytes,
+                            MALLOC_CAP_DEFAULT);
+    if (resize == NULL) {
+        return NULL;
+    }
+    resize->src_w = src_w;
+    resize->src_h = src_h;
+    resize->dst_w = out_width;
+    resize->dst_h = out_height;
+    resize->acc_rows = acc_rows;
+    resize->color_bytes = ctx->in_color_bytes;
+    resize->acc = (uint32_t *)(resize + 1);
+    resize->row = (uint8_t *)resize->acc + acc_size;
+    return resize;
+}
+
+/* Adds a block of the decoded region, at (x0, y0) in the region, to the sums of the output pixels */
+static void jpeg_resize_add(jpeg_resize_t *resize, const uint8_t *in, size_t in_stride,
+                            unsigned int x0, unsigned int y0, unsigned int width, unsigned int height)
+{
+    for (unsigned int y = y0; y < y0 + height; y++) {
+        const unsigned int row = y * resize->dst_h / resize->src_h;
+        uint32_t *acc = resize->acc + (row % resize->acc_rows) * resize->dst_w * 3;
+        unsigned int col = x0 * resize->dst_w / resize->src_w;
+        unsigned int next = jpeg_resize_first(col + 1, resize->src_w, resize->dst_w);
+        const uint8_t *p = in;
+
+        for (unsigned int x = x0; x < x0 + width; x++) {
+            if (x >= next) {
+                col++;
+                next = jpeg_resize_first(col + 1, resize->src_w, resize->dst_w);
+            }
+            uint32_t *sum = acc + col * 3;
+            if (resize->color_bytes == 3) {
+                /* RGB888 or YCbCr */
+                sum[0] += p[0];
+                sum[1] += p[1];
+                sum[2] += p[2];
+            } else if (resize->color_bytes == 2) {
+                const uint16_t color = *(const uint16_t *)p;
+                sum[0] += color >> 11;
+                sum[1] += (color >> 5) & 0x3F;
+                sum[2] += color & 0x1F;
+            } else {
+                sum[0] += p[0];
+            }
+            p += resize->color_bytes;
+        }
+        in += in_stride;
+    }
+}
+
+/* Writes the output rows whose source rows are all among the first src_rows rows of the region */
+static esp_err_t jpeg_resize_flush(jpeg_decode_ctx_t *ctx, unsigned int src_rows)
+{
+    jpeg_resize_t *resize = ctx->resize;
+
+    while (resize->next_row < resize->dst_h &&
+            jpeg_resize_first(resize->next_row + 1, resize->src_h, resize->dst_h) <= src_rows) {
+        const unsigned int row = resize->next_row++;
+        const unsigned int rows = jpeg_resize_first(row + 1, resize->src_h, resize->dst_h) -
+                                  jpeg_resize_first(row, resize->src_h, resize->dst_h);
+        uint32_t *sum = resize->acc + (row % resize->acc_rows) * resize->dst_w * 3;
+        uint8_t *p = resize->row;
+
+        for (unsigned int col = 0; col < resize->dst_w; col++) {
+            const uint32_t n = rows * (jpeg_resize_first(col + 1, resize->src_w, resize->dst_w) -
+                                       jpeg_resize_first(col, resize->src_w, resize->dst_w));
+            const uint32_t c0 = (sum[0] + n / 2) / n, c1 = (sum[1] + n / 2) / n, c2 = (sum[2] + n / 2) / n;
+            if (resize->color_bytes == 3) {
+                p[0] = c0;
+                p[1] = c1;
+                p[2] = c2;
+            } else if (resize->color_bytes == 2) {
+                *(uint16_t *)p = (c0 << 11) | (c1 << 5) | c2;
+            } else {
+                p[0] = c0;
+            }
+            sum[0] = sum[1] = sum[2] = 0;
+            sum += 3;
+            p += resize->color_bytes;
+        }
+
+        if (ctx->stream_cb) {
+            ctx->convert_row(resize->row, resize->row, resize->dst_w, 0, row);
+            const esp_jpeg_image_block_t block = {
+                .left = 0,
+                .top = row,
+                .width = resize->dst_w,
+                .height = 1,
+                .data = resize->row,
+            };
+            esp_err_t ret = ctx->stream_cb(&block, ctx->stream_user_ctx);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        } else {
+            ctx->convert_row(resize->row, ctx->cfg->outbuf + row * ctx->out_stride, resize->dst_w,
+                             0, row);
+        }
+    }
+    return ESP_OK;
+}
+
+/* Clips a decoded block to the region, returns false if no pixel of the block is in it */
+static inline bool jpeg_clip_block(const jpeg_decode_ctx_t *ctx, const JRECT *rect, JRECT *clip)
+{
+    clip->left = MAX(rect->left, ctx->roi.left);
+    clip->right = MIN(rect->right, ctx->roi.right);
+    clip->top = MAX(rect->top, ctx->roi.top);
+    clip->bottom = MIN(rect->bottom, ctx->roi.bottom);
+    return clip->left <= clip->right && clip->top <= clip->bottom;
+}
+
+/* Returns 0 to interrupt TJPGD after the last block of a region which ends above the bottom of the image */
+static inline jpeg_decode_out_t jpeg_roi_continue(jpeg_decode_ctx_t *ctx, const JRECT *rect)
+{
+    if (ctx->roi_stop && rect->bottom >= ctx->roi.bottom && rect->right >= ctx->roi.right) {
+        ctx->roi_done = true;
+        return 0;
+    }
+    return 1;
+}
+
 static jpeg_decode_out_t jpeg_decode_out_cb(JDEC *dec, void *bitmap, JRECT *rect)
 {
-    uint16_t color = 0;
     assert(dec != NULL);
 
-    esp_jpeg_image_cfg_t *cfg = (esp_jpeg_image_cfg_t *)dec->device;
-    assert(cfg != NULL);
+    jpeg_decode_ctx_t *ctx = (jpeg_decode_ctx_t *)dec->device;
+    assert(ctx != NULL);
     assert(bitmap != NULL);
     assert(rect != NULL);
 
-    uint8_t scale_div = jpeg_get_div_by_scale(cfg->out_scale);
-    uint8_t out_color_bytes = jpeg_get_color_bytes(cfg->out_format);
-
-    /* Copy decoded image data to output buffer */
-    uint8_t *in = (uint8_t *)bitmap;
-    uint32_t line = dec->width / scale_div;
-    uint8_t *dst = (uint8_t *)cfg->outbuf;
-    for (int y = rect->top; y <= rect->bottom; y++) {
-        for (int x = rect->left; x <= rect->right; x++) {
-            if ( (JD_FORMAT == 0 && cfg->out_format == JPEG_IMAGE_FORMAT_RGB888) ||
-                    (JD_FORMAT == 1 && cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) ) {
-                /* Output image format is same as set in TJPGD */
-                for (int b = 0; b < ESP_JPEG_COLOR_BYTES; b++) {
-                    if (cfg->flags.swap_color_bytes) {
-                        dst[(y * line * out_color_bytes) + x * out_color_bytes + b] = in[out_color_bytes - b - 1];
-                    } else {
-                        dst[(y * line * out_color_bytes) + x * out_color_bytes + b] = in[b];
-                    }
-                }
-            } else if (JD_FORMAT == 0 && cfg->out_format == JPEG_IMAGE_FORMAT_RGB565) {
-                /* Output image format is not same as set in TJPGD */
-                /* We need to convert the 3 bytes in `in` to a rgb565 value */
-                color = ((in[0] & 0xF8) << 8);
-                color |= ((in[1] & 0xFC) << 3);
-                color |= (in[2] >> 3);
-
-                if (cfg->flags.swap_color_bytes) {
-                    dst[(y * line * out_color_bytes) + (x * out_color_bytes)] = HIBYTE(color);
-                    dst[(y * line * out_color_bytes) + (x * out_color_bytes) + 1] = LOBYTE(color);
-                } else {
-                    dst[(y * line * out_color_bytes) + (x * out_color_bytes) + 1] = HIBYTE(color);
-                    dst[(y * line * out_color_bytes) + (x * out_color_bytes)] = LOBYTE(color);
-                }
-            } else {
-                ESP_LOGE(TAG, "Selected output format is not supported!");
-                assert(0);
+    JRECT clip;
+    if (jpeg_clip_block(ctx, rect, &clip)) {
+        const size_t in_stride = (rect->right - rect->left + 1) * ctx->in_color_bytes;
+        const uint8_t *in = (const uint8_t *)bitmap + (clip.top - rect->top) * in_stride +
+                            (clip.left - rect->left) * ctx->in_color_bytes;
+        const unsigned int x = clip.left - ctx->roi.left, y = clip.top - ctx->roi.top;
+
+        if (ctx->resize) {
+            jpeg_resize_add(ctx->resize, in, in_stride, x, y, clip.right - clip.left + 1, clip.bottom - clip.top + 1);
+            if (clip.right == ctx->roi.right) {
+                jpeg_resize_flush(ctx, clip.bottom - ctx->roi.top + 1);
             }
-            in += ESP_JPEG_COLOR_BYTES;
+        } else {
+            /* Copy decoded image data to output buffer */
+            uint8_t *dst = ctx->cfg->outbuf + y * ctx->out_stride + x * ctx->out_color_bytes;
+            jpeg_convert_rect(ctx, in, in_stride, dst, ctx->out_stride, x, y, clip.right - clip.left + 1, clip.bottom - clip.top + 1);
         }
     }
 
-    return 1;
+    return jpeg_roi_continue(ctx, rect);
+}
+
+static jpeg_decode_out_t jpeg_decode_stream_out_cb(JDEC *dec, void *bitmap, JRECT *rect)
+{
+    assert(dec != NULL);
+
+    jpeg_decode_ctx_t *ctx = (jpeg_decode_ctx_t *)dec->device;
+    assert(ctx != NULL);
+    assert(bitmap != NULL);
+    assert(rect != NULL);
+
+    JRECT clip;
+    if (jpeg_clip_block(ctx, rect, &clip)) {
+        const size_t in_stride = (rect->right - rect->left + 1) * ctx->in_color_bytes;
+        const uint8_t *in = (const uint8_t *)bitmap + (clip.top - rect->top) * in_stride +
+                            (clip.left - rect->left) * ctx->in_color_bytes;
+
+        if (ctx->resize) {
+            jpeg_resize_add(ctx->resize, in, in_stride, clip.left - ctx->roi.left, clip.top - ctx->roi.top,
+                            clip.right - clip.left + 1, clip.bottom - clip.top + 1);
+            if (clip.right == ctx->roi.right) {
+                ctx->stream_err = jpeg_resize_flush(ctx, clip.bottom - ctx->roi.top + 1);
+            }
+        } else {
+            /* Convert the block in place in the TJPGD working buffer and hand it out without copying */
+            const esp_jpeg_image_block_t block = {
+                .left = clip.left - ctx->roi.left,
+                .top = clip.top - ctx->roi.top,
+                .width = clip.right - clip.left + 1,
+                .height = clip.bottom - clip.top + 1,
+                .data = (const uint8_t *)bitmap,
+            };
+            jpeg_convert_rect(ctx, in, in_stride, (uint8_t *)bitmap, block.width * ctx->out_color_bytes,
+                              block.left, block.top, block.width, block.height);
+            ctx->stream_err = ctx->stream_cb(&block, ctx->stream_user_ctx);
+        }
+        if (ctx->stream_err != ESP_OK) {
+            return 0;
+        }
+    }
+
+    return jpeg_roi_continue(ctx, rect);
 }
 
 static uint8_t jpeg_get_div_by_scale(esp_jpeg_image_scale_t scale)
@@ -275,11 +1173,64 @@ static uint8_t jpeg_get_color_bytes(esp_jpeg_image_format_t format)
     /* RGB565 (16-bit/pix) */
     case JPEG_IMAGE_FORMAT_RGB565:
         return 2;
+    /* Grayscale (8-bit/pix) */
+    case JPEG_IMAGE_FORMAT_GRAY:
+        return 1;
+    /* YUV422 (16-bit/pix) */
+    case JPEG_IMAGE_FORMAT_YUV422:
+        return 2;
     }
 
     return 1;
 }
 
+static uint8_t jpeg_get_tjpgd_color_bytes(uint8_t tjpgd_color)
+{
+#if !CONFIG_JD_USE_ROM
+    switch (tjpgd_color) {
+    case JD_COLOR_GRAY:
+        return 1;
+    case JD_COLOR_YCC:
+        return 3;
+    }
+#endif
+
+    return ESP_JPEG_COLOR_BYTES;
+}
+
+/* Computes the decoded region in the scaled image and the size of the output image */
+static esp_err_t jpeg_get_output_geometry(const esp_jpeg_image_cfg_t *cfg, uint16_t width, uint16_t height,
+        JRECT *roi, uint16_t *out_width, uint16_t *out_height)
+{
+    const uint8_t scale_div = jpeg_get_div_by_scale(cfg->out_scale);
+    uint32_t left = 0, top = 0, crop_width = width, crop_height = height;
+
+    if (cfg->crop.width || cfg->crop.height) {
+        left = cfg->crop.left;
+        top = cfg->crop.top;
+        crop_width = cfg->crop.width;
+        crop_height = cfg->crop.height;
+        ESP_RETURN_ON_FALSE(crop_width && crop_height && left + crop_width <= width && top + crop_height <= height,
+                            ESP_ERR_INVALID_ARG, TAG, "Crop region outside of the image");
+    }
+    const uint32_t scaled_width = crop_width / scale_div, scaled_height = crop_height / scale_div;
+    ESP_RETURN_ON_FALSE(scaled_width && scaled_height, ESP_ERR_INVALID_ARG, TAG, "Crop region too small for the scale");
+    roi->left = left / scale_div;
+    roi->top = top / scale_div;
+    roi->right = roi->left + scaled_width - 1;
+    roi->bottom = roi->top + scaled_height - 1;
+
+    *out_width = scaled_width;
+    *out_height = scaled_height;
+    if (cfg->out_width || cfg->out_height) {
+        ESP_RETURN_ON_FALSE(cfg->out_width && cfg->out_height && cfg->out_width <= scaled_width &&
+                            cfg->out_height <= scaled_height, ESP_ERR_INVALID_ARG, TAG, "Output size must not be larger than the decoded region");
+        *out_width = cfg->out_width;
+        *out_height = cfg->out_height;
+    }
+    return ESP_OK;
+}
+
 static inline uint16_t ldb_word(const void *ptr)
 {
     const uint8_t *p = (const uint8_t *)ptr;
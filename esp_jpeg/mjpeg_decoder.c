@@ -0,0 +1,446 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "mjpeg_decoder.h"
+
+static const char *TAG = "MJPEG";
+
+#define MJPEG_TASK_STACK_SIZE   4096
+/* Framebuffers and compressed frames are aligned to the largest cache line, as needed by the hardware decoder */
+#define MJPEG_BUF_ALIGN         128
+/* One compressed frame is filled by esp_jpeg_mjpeg_feed() while the other one is decoded */
+#define MJPEG_FRAME_BUFS        2
+
+/* Position of esp_jpeg_mjpeg_feed() in the stream */
+typedef enum {
+    MJPEG_STATE_SEARCH = 0,     /* Outside of a frame, looking for SOI */
+    MJPEG_STATE_MARKER,         /* Before a marker of the frame header */
+    MJPEG_STATE_LENGTH,         /* In the length field of a segment */
+    MJPEG_STATE_SEGMENT,        /* In the data of a segment */
+    MJPEG_STATE_SCAN,           /* In the entropy coded data, until EOI */
+} mjpeg_state_t;
+
+/* Compressed frame passed to the decoding task, data is NULL to stop the task */
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    uint32_t seq;
+    int64_t end_us;             /* Time at which the EOI of the frame was fed */
+} mjpeg_msg_t;
+
+struct esp_jpeg_mjpeg_t {
+    esp_jpeg_mjpeg_config_t config;
+    esp_jpeg_decoder_handle_t decoder;
+
+    /* Stream parser, only used by esp_jpeg_mjpeg_feed() */
+    mjpeg_state_t state;
+    bool prev_ff;               /* The previous byte was 0xFF */
+    uint8_t marker;             /* Marker of the current segment */
+    uint8_t len_bytes;          /* Bytes of the length field received */
+    uint16_t seg_left;          /* Bytes of the current segment not received yet */
+    uint8_t *fill;              /* Compressed frame being received */
+    size_t fill_len;
+    uint32_t seq;
+
+    uint8_t *frame_bufs[MJPEG_FRAME_BUFS];
+    QueueHandle_t frame_queue;  /* mjpeg_msg_t with complete frames, to the decoding task */
+    QueueHandle_t free_queue;   /* Compressed frame buffers not used by the decoding task */
+    uint8_t **fbs;
+    size_t fb_size;
+    QueueHandle_t fb_queue;     /* Indexes of the framebuffers released by the application */
+    TaskHandle_t task;
+    SemaphoreHandle_t task_done;
+
+    portMUX_TYPE lock;          /* Protects stats, updated by both the feeding and the decoding task */
+    esp_jpeg_mjpeg_stats_t stats;
+};
+
+static void mjpeg_free(esp_jpeg_mjpeg_handle_t h);
+static void mjpeg_task(void *arg);
+
+/*******************************************************************************
+* Public API functions
+*******************************************************************************/
+
+esp_err_t esp_jpeg_mjpeg_new(const esp_jpeg_mjpeg_config_t *config, esp_jpeg_mjpeg_handle_t *ret_handle)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config && ret_handle && config->on_frame, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->max_frame_size > 4 && config->max_width && config->max_height && config->num_fbs,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid configuration");
+
+    esp_jpeg_mjpeg_handle_t h = heap_caps_calloc(1, sizeof(struct esp_jpeg_mjpeg_t), MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(h, ESP_ERR_NO_MEM, TAG, "no mem for MJPEG decoder");
+    h->config = *config;
+    portMUX_INITIALIZE(&h->lock);
+    h->stats.min_decode_us = UINT32_MAX;
+
+    ESP_GOTO_ON_ERROR(esp_jpeg_decoder_new(NULL, &h->decoder), err, TAG, "failed to create JPEG decoder");
+
+    h->frame_queue = xQueueCreate(MJPEG_FRAME_BUFS + 1, sizeof(mjpeg_msg_t));
+    h->free_queue = xQueueCreate(MJPEG_FRAME_BUFS, sizeof(uint8_t *));
+    h->fb_queue = xQueueCreate(config->num_fbs, sizeof(uint8_t));
+    h->task_done = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(h->frame_queue && h->free_queue && h->fb_queue && h->task_done, ESP_ERR_NO_MEM, err, TAG,
+                      "no mem for MJPEG queues");
+
+    const uint32_t frame_caps = config->frame_buf_caps ? config->frame_buf_caps : MALLOC_CAP_DEFAULT;
+    for (int i = 0; i < MJPEG_FRAME_BUFS; i++) {
+        h->frame_bufs[i] = heap_caps_aligned_alloc(MJPEG_BUF_ALIGN, config->max_frame_size, frame_caps);
+        ESP_GOTO_ON_FALSE(h->frame_bufs[i], ESP_ERR_NO_MEM, err, TAG, "no mem for compressed frames");
+    }
+    h->fill = h->frame_bufs[0];
+    xQueueSend(h->free_queue, &h->frame_bufs[1], 0);
+
+    const esp_jpeg_image_format_t format = config->image_cfg.out_format;
+    const size_t bpp = (format == JPEG_IMAGE_FORMAT_RGB888) ? 3 : (format == JPEG_IMAGE_FORMAT_GRAY) ? 1 : 2;
+    const uint32_t fb_caps = config->fb_caps ? config->fb_caps : MALLOC_CAP_DEFAULT;
+    h->fb_size = (config->max_width * config->max_height * bpp + MJPEG_BUF_ALIGN - 1) & ~(MJPEG_BUF_ALIGN - 1);
+    h->fbs = heap_caps_calloc(config->num_fbs, sizeof(uint8_t *), MALLOC_CAP_DEFAULT);
+    ESP_GOTO_ON_FALSE(h->fbs, ESP_ERR_NO_MEM, err, TAG, "no mem for framebuffers");
+    for (uint8_t i = 0; i < config->num_fbs; i++) {
+        h->fbs[i] = heap_caps_aligned_alloc(MJPEG_BUF_ALIGN, h->fb_size, fb_caps);
+        ESP_GOTO_ON_FALSE(h->fbs[i], ESP_ERR_NO_MEM, err, TAG, "no mem for framebuffers");
+        xQueueSend(h->fb_queue, &i, 0);
+    }
+
+    const uint32_t stack_size = config->task.stack_size ? config->task.stack_size : MJPEG_TASK_STACK_SIZE;
+    ESP_GOTO_ON_FALSE(xTaskCreatePinnedToCore(mjpeg_task, "mjpeg", stack_size, h, config->task.priority, &h->task,
+                      config->task.core_id) == pdPASS, ESP_ERR_NO_MEM, err, TAG, "failed to create MJPEG task");
+
+    *ret_handle = h;
+    return ESP_OK;
+err:
+    mjpeg_free(h);
+    return ret;
+}
+
+/* Aborts the frame being received */
+static void mjpeg_abort_frame(esp_jpeg_mjpeg_handle_t h)
+{
+    h->state = MJPEG_STATE_SEARCH;
+    h->prev_ff = false;
+    h->fill_len = 0;
+}
+
+/* Appends bytes to the frame being received. If the frame does not fit, it is dropped and false is returned */
+static bool mjpeg_append(esp_jpeg_mjpeg_handle_t h, const uint8_t *data, size_t len)
+{
+    if (h->fill_len + len > h->config.max_frame_size) {
+        mjpeg_abort_frame(h);
+        h->seq++;
+        portENTER_CRITICAL(&h->lock);
+        h->stats.frames_oversized++;
+        portEXIT_CRITICAL(&h->lock);
+        return false;
+    }
+    memcpy(h->fill + h->fill_len, data, len);
+    h->fill_len += len;
+    return true;
+}
+
+static void mjpeg_start_frame(esp_jpeg_mjpeg_handle_t h)
+{
+    static const uint8_t soi[2] = {0xFF, 0xD8};
+
+    h->fill_len = 0;
+    h->prev_ff = false;
+    mjpeg_append(h, soi, sizeof(soi));
+    h->state = MJPEG_STATE_MARKER;
+}
+
+/* Hands the received frame to the decoding task, or drops it if the task is still busy with the previous one */
+static void mjpeg_end_frame(esp_jpeg_mjpeg_handle_t h)
+{
+    uint8_t *next;
+
+    if (xQueueReceive(h->free_queue, &next, 0) == pdTRUE) {
+        const mjpeg_msg_t msg = {
+            .data = h->fill,
+            .len = h->fill_len,
+            .seq = h->seq,
+            .end_us = esp_timer_get_time(),
+        };
+        xQueueSend(h->frame_queue, &msg, portMAX_DELAY);
+        h->fill = next;
+    } else {
+        portENTER_CRITICAL(&h->lock);
+        h->stats.frames_dropped++;
+        portEXIT_CRITICAL(&h->lock);
+    }
+    h->seq++;
+    mjpeg_abort_frame(h);
+}
+
+/* Handles the marker code following 0xFF in the frame, already appended */
+static void mjpeg_marker(esp_jpeg_mjpeg_handle_t h, uint8_t code)
+{
+    if (code == 0xD9) {             /* EOI */
+        mjpeg_end_frame(h);
+    } else if (code == 0xD8) {      /* SOI without EOI before, the previous frame is incomplete */
+        mjpeg_start_frame(h);
+    } else if (code == 0x01 || (code >= 0xD0 && code <= 0xD7)) {
+        h->state = MJPEG_STATE_MARKER;  /* TEM and RSTn have no length field */
+    } else {
+        h->marker = code;
+        h->len_bytes = 0;
+        h->seg_left = 0;
+        h->state = MJPEG_STATE_LENGTH;
+    }
+}
+
+esp_err_t esp_jpeg_mjpeg_feed(esp_jpeg_mjpeg_handle_t h, const uint8_t *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(h && data, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const uint8_t *p = data;
+    const uint8_t *const end = data + len;
+
+    while (p < end) {
+        switch (h->state) {
+        case MJPEG_STATE_SEARCH:
+            if (h->prev_ff) {
+                h->prev_ff = (*p == 0xFF);
+                if (*p++ == 0xD8) {
+                    mjpeg_start_frame(h);
+                }
+            } else {
+                const uint8_t *ff = memchr(p, 0xFF, end - p);
+                h->prev_ff = (ff != NULL);
+                p = ff ? ff + 1 : end;
+            }
+            break;
+
+        case MJPEG_STATE_MARKER: {
+            const uint8_t b = *p++;
+            if (!h->prev_ff) {
+                if (b != 0xFF) {
+                    ESP_LOGD(TAG, "Corrupted frame header, waiting for the next frame");
+                    mjpeg_abort_frame(h);
+                    h->seq++;
+                } else if (mjpeg_append(h, &b, 1)) {
+                    h->prev_ff = true;
+                }
+            } else if (b != 0xFF) {     /* Repeated 0xFF are fill bytes */
+                h->prev_ff = false;
+                if (mjpeg_append(h, &b, 1)) {
+                    mjpeg_marker(h, b);
+                }
+            }
+            break;
+        }
+
+        case MJPEG_STATE_LENGTH: {
+            const uint8_t b = *p++;
+            if (!mjpeg_append(h, &b, 1)) {
+                break;
+            }
+            h->seg_left = (h->seg_left << 8) | b;
+            if (++h->len_bytes == 2) {
+                if (h->seg_left < 2) {
+                    mjpeg_abort_frame(h);
+                    h->seq++;
+                    break;
+                }
+                h->seg_left -= 2;
+                h->state = MJPEG_STATE_SEGMENT;
+            }
+            break;
+        }
+
+        case MJPEG_STATE_SEGMENT: {
+            const size_t n = MIN(h->seg_left, (size_t)(end - p));
+            if (!mjpeg_append(h, p, n)) {
+                break;  /* Not p += n, the rest is searched for the next SOI */
+            }
+            p += n;
+            h->seg_left -= n;
+            break;
+        }
+
+        case MJPEG_STATE_SCAN:
+            if (h->prev_ff) {
+                const uint8_t b = *p++;
+                if (b == 0xFF) {
+                    break;      /* Fill byte */
+                }
+                h->prev_ff = false;
+                if (mjpeg_append(h, &b, 1) && b != 0x00 && (b < 0xD0 || b > 0xD7)) {
+                    mjpeg_marker(h, b); /* Not a stuffed byte or a restart marker */
+                }
+            } else {
+                /* Copy the entropy coded data up to the next 0xFF at once */
+                const uint8_t *ff = memchr(p, 0xFF, end - p);
+                const size_t n = ff ? (size_t)(ff - p + 1) : (size_t)(end - p);
+                if (mjpeg_append(h, p, n)) {
+                    h->prev_ff = (ff != NULL);
+                    p += n;
+                }
+            }
+            break;
+        }
+
+        /* A segment is complete, the entropy coded data follows SOS */
+        if (h->state == MJPEG_STATE_SEGMENT && h->seg_left == 0) {
+            h->state = (h->marker == 0xDA) ? MJPEG_STATE_SCAN : MJPEG_STATE_MARKER;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_jpeg_mjpeg_release_frame(esp_jpeg_mjpeg_handle_t h, uint8_t fb_index)
+{
+    ESP_RETURN_ON_FALSE_ISR(h && fb_index < h->config.num_fbs, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    if (xPortInIsrContext()) {
+        BaseType_t need_yield = pdFALSE;
+        xQueueSendFromISR(h->fb_queue, &fb_index, &need_yield);
+        if (need_yield) {
+            portYIELD_FROM_ISR();
+        }
+    } else {
+        xQueueSend(h->fb_queue, &fb_index, 0);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_jpeg_mjpeg_get_stats(esp_jpeg_mjpeg_handle_t h, esp_jpeg_mjpeg_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(h && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    portENTER_CRITICAL(&h->lock);
+    *stats = h->stats;
+    portEXIT_CRITICAL(&h->lock);
+    if (stats->frames_decoded == 0) {
+        stats->min_decode_us = 0;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_jpeg_mjpeg_delete(esp_jpeg_mjpeg_handle_t h)
+{
+    ESP_RETURN_ON_FALSE(h, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    const mjpeg_msg_t stop = { .data = NULL };
+    xQueueSend(h->frame_queue, &stop, portMAX_DELAY);
+    xSemaphoreTake(h->task_done, portMAX_DELAY);
+    h->task = NULL;
+    mjpeg_free(h);
+    return ESP_OK;
+}
+
+/*******************************************************************************
+* Private API functions
+*******************************************************************************/
+
+static void mjpeg_free(esp_jpeg_mjpeg_handle_t h)
+{
+    if (h->fbs) {
+        for (uint8_t i = 0; i < h->config.num_fbs; i++) {
+            heap_caps_free(h->fbs[i]);
+        }
+        free(h->fbs);
+    }
+    for (int i = 0; i < MJPEG_FRAME_BUFS; i++) {
+        heap_caps_free(h->frame_bufs[i]);
+    }
+    if (h->task_done) {
+        vSemaphoreDelete(h->task_done);
+    }
+    if (h->fb_queue) {
+        vQueueDelete(h->fb_queue);
+    }
+    if (h->free_queue) {
+        vQueueDelete(h->free_queue);
+    }
+    if (h->frame_queue) {
+        vQueueDelete(h->frame_queue);
+    }
+    if (h->decoder) {
+        esp_jpeg_decoder_delete(h->decoder);
+    }
+    free(h);
+}
+
+/* Decodes a compressed frame and gives its buffer back to esp_jpeg_mjpeg_feed() before calling on_frame */
+static void mjpeg_decode_frame(esp_jpeg_mjpeg_handle_t h, const mjpeg_msg_t *msg)
+{
+    uint8_t fb_index;
+
+    if (xQueueReceive(h->fb_queue, &fb_index, 0) != pdTRUE) {
+        xQueueSend(h->free_queue, &msg->data, portMAX_DELAY);
+        portENTER_CRITICAL(&h->lock);
+        h->stats.frames_skipped++;
+        portEXIT_CRITICAL(&h->lock);
+        return;
+    }
+
+    esp_jpeg_image_cfg_t cfg = h->config.image_cfg;
+    cfg.indata = msg->data;
+    cfg.indata_size = msg->len;
+    cfg.read_cb = NULL;
+    cfg.outbuf = h->fbs[fb_index];
+    cfg.outbuf_size = h->fb_size;
+    cfg.out_stride = 0;
+    esp_jpeg_image_output_t img;
+
+    const int64_t start = esp_timer_get_time();
+    esp_err_t ret = esp_jpeg_decoder_decode(h->decoder, &cfg, &img);
+    const int64_t now = esp_timer_get_time();
+    xQueueSend(h->free_queue, &msg->data, portMAX_DELAY);
+    if (ret != ESP_OK) {
+        ESP_LOGD(TAG, "Frame %"PRIu32" not decoded: %s", msg->seq, esp_err_to_name(ret));
+        xQueueSend(h->fb_queue, &fb_index, 0);
+        portENTER_CRITICAL(&h->lock);
+        h->stats.decode_errors++;
+        portEXIT_CRITICAL(&h->lock);
+        return;
+    }
+
+    const esp_jpeg_mjpeg_frame_t frame = {
+        .buf = h->fbs[fb_index],
+        .len = img.output_len,
+        .width = img.width,
+        .height = img.height,
+        .seq = msg->seq,
+        .decode_us = now - start,
+        .latency_us = now - msg->end_us,
+        .fb_index = fb_index,
+    };
+    portENTER_CRITICAL(&h->lock);
+    h->stats.frames_decoded++;
+    h->stats.last_decode_us = frame.decode_us;
+    h->stats.min_decode_us = MIN(h->stats.min_decode_us, frame.decode_us);
+    h->stats.max_decode_us = MAX(h->stats.max_decode_us, frame.decode_us);
+    h->stats.total_decode_us += frame.decode_us;
+    h->stats.max_latency_us = MAX(h->stats.max_latency_us, frame.latency_us);
+    portEXIT_CRITICAL(&h->lock);
+
+    h->config.on_frame(&frame, h->config.user_ctx);
+}
+
+static void mjpeg_task(void *arg)
+{
+    esp_jpeg_mjpeg_handle_t h = (esp_jpeg_mjpeg_handle_t)arg;
+    mjpeg_msg_t msg;
+
+    while (xQueueReceive(h->frame_queue, &msg, portMAX_DELAY) == pdTRUE && msg.data != NULL) {
+        mjpeg_decode_frame(h, &msg);
+    }
+    xSemaphoreGive(h->task_done);
+    vTaskDelete(NULL);
+}
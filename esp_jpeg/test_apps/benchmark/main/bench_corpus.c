@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "esp_heap_caps.h"
+#include "jpeglib.h"
+#include "benchmark.h"
+
+#define BENCH_QUALITY   80
+
+/* Smooth gradients with a checkerboard and noise, so that the images have both flat areas and details */
+static void bench_corpus_row(uint8_t *row, const bench_image_t *img, unsigned int y, uint32_t *seed)
+{
+    for (unsigned int x = 0; x < img->width; x++) {
+        *seed = *seed * 1103515245 + 12345;
+        const int noise = (int)((*seed >> 16) & 0x1F) - 16;
+        const int check = (((x / 16) + (y / 16)) & 1) ? 48 : -48;
+        const int b = 128 + check + noise;
+
+        row[0] = x * 255 / img->width;
+        row[1] = y * 255 / img->height;
+        row[2] = (b < 0) ? 0 : (b > 255) ? 255 : b;
+        row += 3;
+    }
+}
+
+esp_err_t bench_corpus_create(bench_image_t *img)
+{
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    unsigned char *jpg = NULL;
+    unsigned long len = 0;
+    uint32_t seed = img->width * img->height;
+    JSAMPROW row = heap_caps_malloc(img->width * 3, MALLOC_CAP_DEFAULT);
+    if (row == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    cinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&cinfo);
+    jpeg_mem_dest(&cinfo, &jpg, &len);
+    cinfo.image_width = img->width;
+    cinfo.image_height = img->height;
+    cinfo.input_components = 3;
+    cinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&cinfo);
+    jpeg_set_quality(&cinfo, BENCH_QUALITY, TRUE);
+    cinfo.comp_info[0].h_samp_factor = img->subsampling_420 ? 2 : 1;
+    cinfo.comp_info[0].v_samp_factor = img->subsampling_420 ? 2 : 1;
+    cinfo.restart_in_rows = img->restart ? 1 : 0;
+
+    jpeg_start_compress(&cinfo, TRUE);
+    for (unsigned int y = 0; y < img->height; y++) {
+        bench_corpus_row(row, img, y, &seed);
+        jpeg_write_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_compress(&cinfo);
+    jpeg_destroy_compress(&cinfo);
+    free(row);
+
+    img->jpg = jpg;
+    img->len = len;
+    return ESP_OK;
+}
+
+void bench_corpus_free(bench_image_t *img)
+{
+    free(img->jpg);
+    img->jpg = NULL;
+    img->len = 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdint.h>
+#include "esp_heap_caps.h"
+#include "ccomp_timer.h"
+#include "jpeg_decoder.h"
+#include "benchmark.h"
+
+/* The free heap is sampled in the first block, when the working buffer is allocated */
+static esp_err_t bench_esp_jpeg_block(const esp_jpeg_image_block_t *block, void *user_ctx)
+{
+    size_t *free_decoding = (size_t *)user_ctx;
+
+    if (*free_decoding == SIZE_MAX) {
+        *free_decoding = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    }
+    return ESP_OK;
+}
+
+/* esp_jpeg_decode_stream() with the menuconfig options of esp_jpeg, including the conversion to RGB888 */
+esp_err_t bench_esp_jpeg(const bench_image_t *img, bench_result_t *res)
+{
+    esp_jpeg_image_cfg_t cfg = {
+        .indata = img->jpg,
+        .indata_size = img->len,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+    size_t free_decoding = SIZE_MAX;
+    const size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    ccomp_timer_start();
+    esp_err_t ret = esp_jpeg_decode_stream(&cfg, bench_esp_jpeg_block, &free_decoding, &outimg);
+    res->time_us = ccomp_timer_stop();
+    if (ret == ESP_OK) {
+        res->heap = free_before - free_decoding;
+    }
+    return ret;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <setjmp.h>
+#include "esp_heap_caps.h"
+#include "ccomp_timer.h"
+#include "jpeglib.h"
+#include "benchmark.h"
+
+typedef struct {
+    struct jpeg_error_mgr pub;
+    jmp_buf jmp;
+} bench_jpeg_error_t;
+
+static void bench_jpeg_error_exit(j_common_ptr cinfo)
+{
+    bench_jpeg_error_t *err = (bench_jpeg_error_t *)cinfo->err;
+    longjmp(err->jmp, 1);
+}
+
+esp_err_t bench_libjpeg_turbo(const bench_image_t *img, bench_result_t *res)
+{
+    struct jpeg_decompress_struct cinfo;
+    bench_jpeg_error_t jerr;
+    JSAMPROW row = heap_caps_malloc(img->width * 3, MALLOC_CAP_DEFAULT);
+    if (row == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    const size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = bench_jpeg_error_exit;
+    if (setjmp(jerr.jmp)) {
+        ccomp_timer_stop();
+        jpeg_destroy_decompress(&cinfo);
+        free(row);
+        return ESP_FAIL;
+    }
+
+    ccomp_timer_start();
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, img->jpg, img->len);
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    /* All the memory of the decompressor is allocated by jpeg_start_decompress() */
+    const size_t free_decoding = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    res->time_us = ccomp_timer_stop();
+    res->heap = free_before - free_decoding;
+
+    free(row);
+    return ESP_OK;
+}
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <string.h>
+#include <sys/param.h>
+#include "esp_rom_caps.h"
+#include "esp_heap_caps.h"
+#include "ccomp_timer.h"
+#include "benchmark.h"
+
+#if ESP_ROM_HAS_JPEG_DECODE
+#include "rom/tjpgd.h"
+
+/* Working buffer size recommended for the TJpgDec in ROM */
+#define BENCH_ROM_POOL_SIZE 3100
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+} bench_src_t;
+
+static unsigned int bench_rom_in(JDEC *jd, uint8_t *buf, unsigned int len)
+{
+    bench_src_t *src = (bench_src_t *)jd->device;
+
+    len = MIN(len, src->len - src->pos);
+    if (buf) {
+        memcpy(buf, src->data + src->pos, len);
+    }
+    src->pos += len;
+    return len;
+}
+
+static unsigned int bench_rom_out(JDEC *jd, void *bitmap, JRECT *rect)
+{
+    return 1;
+}
+
+esp_err_t bench_rom(const bench_image_t *img, bench_result_t *res)
+{
+    JDEC jd;
+    bench_src_t src = {
+        .data = img->jpg,
+        .len = img->len,
+    };
+    void *pool = heap_caps_malloc(BENCH_ROM_POOL_SIZE, MALLOC_CAP_DEFAULT);
+    if (pool == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    ccomp_timer_start();
+    JRESULT rc = jd_prepare(&jd, bench_rom_in, pool, BENCH_ROM_POOL_SIZE, &src);
+    if (rc == JDR_OK) {
+        rc = jd_decomp(&jd, bench_rom_out, 0);
+    }
+    res->time_us = ccomp_timer_stop();
+    if (rc == JDR_OK) {
+        res->heap = BENCH_ROM_POOL_SIZE - jd.sz_pool;
+    }
+
+    free(pool);
+    return (rc == JDR_OK) ? ESP_OK : ESP_FAIL;
+}
+
+#else
+
+esp_err_t bench_rom(const bench_image_t *img, bench_result_t *res)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
@@ -0,0 +1,10 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#define BENCH_TJPGD_FN      bench_tjpgd_32bit
+#define JD_FASTDECODE       1
+#define JD_TBLCLIP          1
+#include "bench_tjpgd.inc"
@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* Image of the corpus, encoded at startup by bench_corpus_create() */
+typedef struct {
+    uint16_t width;
+    uint16_t height;
+    bool subsampling_420;   /* 4:2:0 if true, 4:4:4 otherwise */
+    bool restart;           /* Restart marker after every MCU row */
+    uint8_t *jpg;
+    size_t len;
+} bench_image_t;
+
+/* Result of one decoding */
+typedef struct {
+    int64_t time_us;        /* Decoding time measured with ccomp_timer */
+    size_t heap;            /* Memory used by the decoder, working buffer or heap allocations */
+} bench_result_t;
+
+/* Decodes the image once, discarding the decoded pixels */
+typedef esp_err_t (*bench_decode_fn_t)(const bench_image_t *img, bench_result_t *res);
+
+esp_err_t bench_corpus_create(bench_image_t *img);
+void bench_corpus_free(bench_image_t *img);
+
+esp_err_t bench_tjpgd_basic(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_tjpgd_32bit(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_tjpgd_32bit_noclip(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_tjpgd_table(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_rom(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_esp_jpeg(const bench_image_t *img, bench_result_t *res);
+esp_err_t bench_libjpeg_turbo(const bench_image_t *img, bench_result_t *res);
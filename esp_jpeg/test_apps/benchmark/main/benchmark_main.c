@@ -0,0 +1,209 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "benchmark.h"
+
+/*
+ * Decodes every image of the corpus with every decoder and prints a table of decoding time, memory used by the
+ * decoder and stack usage. All TJpgDec configurations are built into this application (see bench_tjpgd.inc),
+ * so a single run compares them on the target. The ROM decoder is included on targets which have it.
+ *
+ * A second table gives the wall clock decoding time while another task erases and writes the "bench" partition,
+ * which disables the flash cache: build the application with and without CONFIG_JD_TJPGD_IN_IRAM to compare.
+ */
+
+static const char *TAG = "benchmark";
+
+#define BENCH_RUNS              5
+#define BENCH_TASK_STACK_SIZE   (16 * 1024)
+#define BENCH_FLASH_SECTOR_SIZE 4096
+
+#if CONFIG_JD_TJPGD_IN_IRAM
+#define BENCH_TJPGD_IN_IRAM     "y"
+#else
+#define BENCH_TJPGD_IN_IRAM     "n"
+#endif
+
+typedef struct {
+    const char *name;
+    bench_decode_fn_t decode;
+} bench_decoder_t;
+
+typedef struct {
+    const bench_decoder_t *decoder;
+    const bench_image_t *img;
+    TaskHandle_t caller;
+    bool wall_clock;        /* Wall clock time instead of the ccomp_timer time, which leaves out the cache misses */
+    esp_err_t err;
+    int64_t total_us;
+    size_t heap;
+    size_t stack;
+} bench_run_t;
+
+static bench_image_t s_corpus[] = {
+    { .width = 160, .height = 120, .subsampling_420 = true },
+    { .width = 320, .height = 240, .subsampling_420 = true },
+    { .width = 320, .height = 240, .subsampling_420 = false },
+    { .width = 320, .height = 240, .subsampling_420 = true, .restart = true },
+    { .width = 640, .height = 480, .subsampling_420 = true },
+    { .width = 640, .height = 480, .subsampling_420 = true, .restart = true },
+};
+
+static const bench_decoder_t s_decoders[] = {
+    { "TJpgDec basic", bench_tjpgd_basic },
+    { "TJpgDec 32-bit", bench_tjpgd_32bit },
+    { "TJpgDec 32-bit, no TBLCLIP", bench_tjpgd_32bit_noclip },
+    { "TJpgDec table", bench_tjpgd_table },
+    { "TJpgDec ROM", bench_rom },
+    { "esp_jpeg (menuconfig)", bench_esp_jpeg },
+    { "libjpeg-turbo", bench_libjpeg_turbo },
+};
+
+/* Runs the decoder in its own task, so that the stack it uses can be measured */
+static void bench_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    bench_result_t res = { 0 };
+
+    /* The first decoding only loads the caches */
+    run->err = run->decoder->decode(run->img, &res);
+    for (int i = 0; i < BENCH_RUNS && run->err == ESP_OK; i++) {
+        const int64_t start = esp_timer_get_time();
+        run->err = run->decoder->decode(run->img, &res);
+        run->total_us += run->wall_clock ? esp_timer_get_time() - start : res.time_us;
+        run->heap = MAX(run->heap, res.heap);
+    }
+    run->stack = BENCH_TASK_STACK_SIZE - uxTaskGetStackHighWaterMark(NULL);
+
+    xTaskNotifyGive(run->caller);
+    vTaskDelete(NULL);
+}
+
+static void bench_run(const bench_image_t *img, const bench_decoder_t *decoder, bool wall_clock)
+{
+    bench_run_t run = {
+        .decoder = decoder,
+        .img = img,
+        .caller = xTaskGetCurrentTaskHandle(),
+        .wall_clock = wall_clock,
+    };
+
+    /* ccomp_timer measures the core it is started on */
+    if (xTaskCreatePinnedToCore(bench_task, "bench", BENCH_TASK_STACK_SIZE, &run, uxTaskPriorityGet(NULL), NULL,
+                                xPortGetCoreID()) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the benchmark task");
+        return;
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    printf("| %3ux%-3u %s%-4s | %-27s |", img->width, img->height, img->subsampling_420 ? "4:2:0" : "4:4:4",
+           img->restart ? " RST" : "", decoder->name);
+    if (run.err == ESP_ERR_NOT_SUPPORTED) {
+        printf(" %8s | %8s | %9s |\n", "-", "-", "-");
+    } else if (run.err != ESP_OK) {
+        printf(" %-30s |\n", esp_err_to_name(run.err));
+    } else {
+        const int64_t us = run.total_us / BENCH_RUNS;
+        printf(" %4"PRId64".%03"PRId64" | %8u | %9u |\n", us / 1000, us % 1000, (unsigned)run.heap, (unsigned)run.stack);
+    }
+}
+
+/* Decoders run again under flash writes: esp_jpeg follows CONFIG_JD_TJPGD_IN_IRAM, the others are references */
+static const bench_decoder_t s_flash_load_decoders[] = {
+    { "TJpgDec 32-bit", bench_tjpgd_32bit },
+    { "TJpgDec ROM", bench_rom },
+    { "esp_jpeg (menuconfig)", bench_esp_jpeg },
+};
+
+typedef struct {
+    const esp_partition_t *part;
+    volatile bool stop;
+    TaskHandle_t caller;
+} bench_flash_load_t;
+
+/* Erases and writes the partition one sector at a time, as NVS or an OTA update does, until stopped */
+static void bench_flash_load_task(void *arg)
+{
+    bench_flash_load_t *load = (bench_flash_load_t *)arg;
+    uint8_t buf[256];
+    size_t offset = 0;
+
+    memset(buf, 0x5A, sizeof(buf));
+    while (!load->stop) {
+        esp_partition_erase_range(load->part, offset, BENCH_FLASH_SECTOR_SIZE);
+        for (size_t i = 0; i < BENCH_FLASH_SECTOR_SIZE; i += sizeof(buf)) {
+            esp_partition_write(load->part, offset + i, buf, sizeof(buf));
+        }
+        offset = (offset + BENCH_FLASH_SECTOR_SIZE) % load->part->size;
+    }
+    xTaskNotifyGive(load->caller);
+    vTaskDelete(NULL);
+}
+
+static void bench_image_flash_load(const bench_image_t *img)
+{
+    bench_flash_load_t load = {
+        .part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, "bench"),
+        .caller = xTaskGetCurrentTaskHandle(),
+    };
+    if (load.part == NULL) {
+        ESP_LOGE(TAG, "No \"bench\" partition for the flash writes");
+        return;
+    }
+    /* On the other core if there is one, so that the writes go on during the whole decoding */
+    if (xTaskCreatePinnedToCore(bench_flash_load_task, "flash_load", 4096, &load, uxTaskPriorityGet(NULL), NULL,
+                                portNUM_PROCESSORS > 1 ? !xPortGetCoreID() : 0) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the flash load task");
+        return;
+    }
+    for (size_t d = 0; d < sizeof(s_flash_load_decoders) / sizeof(s_flash_load_decoders[0]); d++) {
+        bench_run(img, &s_flash_load_decoders[d], true);
+    }
+    load.stop = true;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void app_main(void)
+{
+    printf("| Image              | Decoder                     | ms/frame | Heap [B] | Stack [B] |\n");
+    printf("|--------------------|-----------------------------|----------|----------|-----------|\n");
+
+    for (size_t i = 0; i < sizeof(s_corpus) / sizeof(s_corpus[0]); i++) {
+        bench_image_t *img = &s_corpus[i];
+        if (bench_corpus_create(img) != ESP_OK) {
+            ESP_LOGE(TAG, "No memory for the %ux%u image", img->width, img->height);
+            continue;
+        }
+        for (size_t d = 0; d < sizeof(s_decoders) / sizeof(s_decoders[0]); d++) {
+            bench_run(img, &s_decoders[d], false);
+        }
+        bench_corpus_free(img);
+    }
+
+    printf("\nDecoding under concurrent flash writes, wall clock time (CONFIG_JD_TJPGD_IN_IRAM=%s)\n", BENCH_TJPGD_IN_IRAM);
+    printf("| Image              | Decoder                     | ms/frame | Heap [B] | Stack [B] |\n");
+    printf("|--------------------|-----------------------------|----------|----------|-----------|\n");
+    for (size_t i = 0; i < sizeof(s_corpus) / sizeof(s_corpus[0]); i++) {
+        bench_image_t *img = &s_corpus[i];
+        /* Restart markers don't change how much code and tables the decoding uses, skip them to save time */
+        if (img->restart || bench_corpus_create(img) != ESP_OK) {
+            continue;
+        }
+        bench_image_flash_load(img);
+        bench_corpus_free(img);
+    }
+    printf("Benchmark done\n");
+}
@@ -0,0 +1,6 @@
+import pytest
+
+
+@pytest.mark.generic
+def test_esp_jpeg_benchmark(dut) -> None:
+    dut.expect_exact('Benchmark done', timeout=600)
@@ -6,12 +6,19 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <stdio.h>
+#include <sys/param.h>
 #include "sdkconfig.h"
 #include "unity.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 
 #include "jpeg_decoder.h"
+#include "mjpeg_decoder.h"
 #include "test_logo_jpg.h"
 #include "test_logo_rgb888.h"
 #include "test_usb_camera_2_jpg.h"
@@ -198,6 +205,293 @@ TEST_CASE("Test JPEG decompression library: User defined working buffer", "[esp_
     free(decoded);
 }
 
+typedef struct {
+    uint8_t *image;     /* Reassembled RGB888 image */
+    int blocks;
+    int stop_after;     /* Number of blocks after which the callback stops the decoding, 0 to decode everything */
+} stream_test_ctx_t;
+
+static esp_err_t stream_test_cb(const esp_jpeg_image_block_t *block, void *user_ctx)
+{
+    stream_test_ctx_t *ctx = (stream_test_ctx_t *)user_ctx;
+    TEST_ASSERT_LESS_OR_EQUAL(TESTW, block->left + block->width);
+    TEST_ASSERT_LESS_OR_EQUAL(TESTH, block->top + block->height);
+
+    for (int y = 0; y < block->height; y++) {
+        memcpy(ctx->image + ((block->top + y) * TESTW + block->left) * 3, block->data + y * block->width * 3, block->width * 3);
+    }
+    ctx->blocks++;
+    return (ctx->stop_after && ctx->blocks >= ctx->stop_after) ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+TEST_CASE("Test JPEG decompression library: Stream decode", "[esp_jpeg]")
+{
+    const unsigned char *p, *o;
+    stream_test_ctx_t ctx = {
+        .image = calloc(1, TESTW * TESTH * 3),
+    };
+    TEST_ASSERT_NOT_NULL(ctx.image);
+
+    /* JPEG decode, without output buffer */
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)logo_jpg,
+        .indata_size = logo_jpg_len,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+    esp_err_t err = esp_jpeg_decode_stream(&jpeg_cfg, stream_test_cb, &ctx, &outimg);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(outimg.width, TESTW);
+    TEST_ASSERT_EQUAL(outimg.height, TESTH);
+
+    p = ctx.image;
+    o = logo_rgb888;
+    for (int x = 0; x < outimg.width * outimg.height; x++) {
+        /* The color can be +- 2 */
+        TEST_ASSERT_UINT8_WITHIN(2, o[0], p[0]);
+        TEST_ASSERT_UINT8_WITHIN(2, o[1], p[1]);
+        TEST_ASSERT_UINT8_WITHIN(2, o[2], p[2]);
+
+        p += 3;
+        o += 3;
+    }
+
+    /* The error returned by the callback stops the decoding */
+    ctx.blocks = 0;
+    ctx.stop_after = 2;
+    err = esp_jpeg_decode_stream(&jpeg_cfg, stream_test_cb, &ctx, &outimg);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_EQUAL(2, ctx.blocks);
+
+    free(ctx.image);
+}
+
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+} read_test_ctx_t;
+
+/* Returns at most 100 bytes per call, like a slow network stream */
+static size_t read_test_cb(void *user_ctx, uint8_t *buf, size_t len)
+{
+    read_test_ctx_t *ctx = (read_test_ctx_t *)user_ctx;
+    len = MIN(MIN(len, 100), ctx->size - ctx->pos);
+    if (buf) {
+        memcpy(buf, ctx->data + ctx->pos, len);
+    }
+    ctx->pos += len;
+    return len;
+}
+
+TEST_CASE("Test JPEG decompression library: Input callback", "[esp_jpeg]")
+{
+    unsigned char *decoded, *p;
+    const unsigned char *o;
+    int decoded_outsize = TESTW * TESTH * 3;
+    read_test_ctx_t read_ctx = {
+        .data = logo_jpg,
+        .size = logo_jpg_len,
+    };
+
+    decoded = malloc(decoded_outsize);
+    TEST_ASSERT_NOT_NULL(decoded);
+
+    /* JPEG decode, without input buffer */
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .read_cb = read_test_cb,
+        .read_cb_ctx = &read_ctx,
+        .outbuf = decoded,
+        .outbuf_size = decoded_outsize,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+    esp_err_t err = esp_jpeg_decode(&jpeg_cfg, &outimg);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(outimg.width, TESTW);
+    TEST_ASSERT_EQUAL(outimg.height, TESTH);
+
+    p = decoded;
+    o = logo_rgb888;
+    for (int x = 0; x < outimg.width * outimg.height; x++) {
+        /* The color can be +- 2 */
+        TEST_ASSERT_UINT8_WITHIN(2, o[0], p[0]);
+        TEST_ASSERT_UINT8_WITHIN(2, o[1], p[1]);
+        TEST_ASSERT_UINT8_WITHIN(2, o[2], p[2]);
+
+        p += 3;
+        o += 3;
+    }
+    free(decoded);
+}
+
+/**
+ * @brief Crop and downscale test
+ *
+ * A region of the logo is decoded, then downscaled to an exact size. The cropped pixels must be the same as the
+ * ones of the whole image, each downscaled pixel must be the rounded average of the pixels it covers.
+ */
+#define CROP_LEFT   10
+#define CROP_TOP    9
+#define CROP_W      30
+#define CROP_H      20
+#define THUMB_W     7
+#define THUMB_H     6
+TEST_CASE("Test JPEG decompression library: Crop and downscale", "[esp_jpeg]")
+{
+    uint8_t *full = malloc(TESTW * TESTH * 3);
+    uint8_t *crop = malloc(CROP_W * CROP_H * 3);
+    uint8_t *thumb = malloc(THUMB_W * THUMB_H * 3);
+    TEST_ASSERT_NOT_NULL(full);
+    TEST_ASSERT_NOT_NULL(crop);
+    TEST_ASSERT_NOT_NULL(thumb);
+
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)logo_jpg,
+        .indata_size = logo_jpg_len,
+        .outbuf = full,
+        .outbuf_size = TESTW * TESTH * 3,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    /* Region only */
+    jpeg_cfg.outbuf = crop;
+    jpeg_cfg.outbuf_size = CROP_W * CROP_H * 3;
+    jpeg_cfg.crop.left = CROP_LEFT;
+    jpeg_cfg.crop.top = CROP_TOP;
+    jpeg_cfg.crop.width = CROP_W;
+    jpeg_cfg.crop.height = CROP_H;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(CROP_W, outimg.width);
+    TEST_ASSERT_EQUAL(CROP_H, outimg.height);
+    for (int y = 0; y < CROP_H; y++) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(full + ((CROP_TOP + y) * TESTW + CROP_LEFT) * 3, crop + y * CROP_W * 3, CROP_W * 3);
+    }
+
+    /* Region downscaled */
+    jpeg_cfg.outbuf = thumb;
+    jpeg_cfg.outbuf_size = THUMB_W * THUMB_H * 3;
+    jpeg_cfg.out_width = THUMB_W;
+    jpeg_cfg.out_height = THUMB_H;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_get_image_info(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(THUMB_W * THUMB_H * 3, outimg.output_len);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(THUMB_W, outimg.width);
+    TEST_ASSERT_EQUAL(THUMB_H, outimg.height);
+    for (int y = 0; y < THUMB_H; y++) {
+        const int y0 = (y * CROP_H + THUMB_H - 1) / THUMB_H, y1 = ((y + 1) * CROP_H + THUMB_H - 1) / THUMB_H;
+        for (int x = 0; x < THUMB_W; x++) {
+            const int x0 = (x * CROP_W + THUMB_W - 1) / THUMB_W, x1 = ((x + 1) * CROP_W + THUMB_W - 1) / THUMB_W;
+            const unsigned int n = (y1 - y0) * (x1 - x0);
+            for (int c = 0; c < 3; c++) {
+                unsigned int sum = 0;
+                for (int yy = y0; yy < y1; yy++) {
+                    for (int xx = x0; xx < x1; xx++) {
+                        sum += crop[(yy * CROP_W + xx) * 3 + c];
+                    }
+                }
+                TEST_ASSERT_EQUAL((sum + n / 2) / n, thumb[(y * THUMB_W + x) * 3 + c]);
+            }
+        }
+    }
+
+    /* Upscaling is not supported */
+    jpeg_cfg.out_width = CROP_W + 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    free(full);
+    free(crop);
+    free(thumb);
+}
+
+#define FB_W        (TESTW + 10)
+#define FB_H        (TESTH + 6)
+#define FB_X        3
+#define FB_Y        2
+#define FB_FILL     0xA5
+
+/* Checks that the region of fb at FB_X, FB_Y is ref and that the rest of fb is untouched */
+static void check_fb_region(const uint8_t *fb, const uint8_t *ref, int w, int h)
+{
+    for (int y = 0; y < FB_H; y++) {
+        for (int x = 0; x < FB_W; x++) {
+            const uint8_t *px = fb + (y * FB_W + x) * 3;
+            if (x >= FB_X && x < FB_X + w && y >= FB_Y && y < FB_Y + h) {
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(ref + ((y - FB_Y) * w + x - FB_X) * 3, px, 3);
+            } else {
+                TEST_ASSERT_EACH_EQUAL_UINT8(FB_FILL, px, 3);
+            }
+        }
+    }
+}
+
+TEST_CASE("Test JPEG decompression library: Output stride", "[esp_jpeg]")
+{
+    uint8_t *full = malloc(TESTW * TESTH * 3);
+    uint8_t *thumb = malloc(THUMB_W * THUMB_H * 3);
+    uint8_t *fb = malloc(FB_W * FB_H * 3);
+    TEST_ASSERT_NOT_NULL(full);
+    TEST_ASSERT_NOT_NULL(thumb);
+    TEST_ASSERT_NOT_NULL(fb);
+
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)logo_jpg,
+        .indata_size = logo_jpg_len,
+        .outbuf = full,
+        .outbuf_size = TESTW * TESTH * 3,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    /* Whole image into the frame buffer */
+    memset(fb, FB_FILL, FB_W * FB_H * 3);
+    jpeg_cfg.outbuf = fb + (FB_Y * FB_W + FB_X) * 3;
+    jpeg_cfg.outbuf_size = (FB_H - FB_Y) * FB_W * 3 - FB_X * 3;
+    jpeg_cfg.out_stride = FB_W * 3;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(TESTW, outimg.width);
+    TEST_ASSERT_EQUAL(TESTH, outimg.height);
+    TEST_ASSERT_EQUAL((TESTH - 1) * FB_W * 3 + TESTW * 3, outimg.output_len);
+    check_fb_region(fb, full, TESTW, TESTH);
+
+    /* Downscaled region, rows written by the box filter */
+    jpeg_cfg.outbuf = thumb;
+    jpeg_cfg.outbuf_size = THUMB_W * THUMB_H * 3;
+    jpeg_cfg.out_stride = 0;
+    jpeg_cfg.crop.left = CROP_LEFT;
+    jpeg_cfg.crop.top = CROP_TOP;
+    jpeg_cfg.crop.width = CROP_W;
+    jpeg_cfg.crop.height = CROP_H;
+    jpeg_cfg.out_width = THUMB_W;
+    jpeg_cfg.out_height = THUMB_H;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    memset(fb, FB_FILL, FB_W * FB_H * 3);
+    jpeg_cfg.outbuf = fb + (FB_Y * FB_W + FB_X) * 3;
+    jpeg_cfg.outbuf_size = (FB_H - FB_Y) * FB_W * 3 - FB_X * 3;
+    jpeg_cfg.out_stride = FB_W * 3;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    check_fb_region(fb, thumb, THUMB_W, THUMB_H);
+
+    /* Stride shorter than a row, or buffer ending before the last row */
+    jpeg_cfg.out_stride = THUMB_W * 3 - 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    jpeg_cfg.out_stride = FB_W * 3;
+    jpeg_cfg.outbuf_size = (THUMB_H - 1) * FB_W * 3 + THUMB_W * 3 - 1;
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    free(full);
+    free(thumb);
+    free(fb);
+}
+
 #if CONFIG_JD_DEFAULT_HUFFMAN
 #include "test_usb_camera_jpg.h"
 #include "test_usb_camera_rgb888.h"
@@ -326,3 +620,289 @@ TEST_CASE("Test JPEG invalid marker 0xFFFF", "[esp_jpeg]")
     free(decoded);
 }
 
+/**
+ * @brief Decoder handle test
+ *
+ * Images with different tables are decoded alternately with one decoder, each image twice in a row so that
+ * its tables are reused once. The output must be the same as with esp_jpeg_decode().
+ */
+TEST_CASE("Test JPEG decompression library: Decoder handle", "[esp_jpeg]")
+{
+    const struct {
+        const uint8_t *jpg;
+        size_t len;
+        size_t outsize;
+    } images[] = {
+        { logo_jpg, logo_jpg_len, TESTW * TESTH * 3 },
+        { camera_2_jpg, camera_2_jpg_len, 160 * 120 * 3 },
+    };
+    uint8_t *expected = malloc(160 * 120 * 3);
+    uint8_t *decoded = malloc(160 * 120 * 3);
+    TEST_ASSERT_NOT_NULL(expected);
+    TEST_ASSERT_NOT_NULL(decoded);
+
+    esp_jpeg_decoder_handle_t decoder;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decoder_new(NULL, &decoder));
+
+    for (int i = 0; i < 8; i++) {
+        const int n = (i / 2) % 2;
+        esp_jpeg_image_cfg_t jpeg_cfg = {
+            .indata = (uint8_t *)images[n].jpg,
+            .indata_size = images[n].len,
+            .outbuf = expected,
+            .outbuf_size = images[n].outsize,
+            .out_format = JPEG_IMAGE_FORMAT_RGB888,
+            .out_scale = JPEG_IMAGE_SCALE_0,
+            .advanced = {
+                .backend = JPEG_DECODER_BACKEND_SOFTWARE,
+            },
+        };
+        esp_jpeg_image_output_t outimg;
+        TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+        jpeg_cfg.outbuf = decoded;
+        memset(decoded, 0, images[n].outsize);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decoder_decode(decoder, &jpeg_cfg, &outimg));
+        TEST_ASSERT_EQUAL(images[n].outsize, outimg.output_len);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, decoded, images[n].outsize);
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decoder_delete(decoder));
+    free(decoded);
+    free(expected);
+}
+
+/**
+ * @brief Grayscale, YUV422 and dithered RGB565 output test
+ *
+ * The luminance must match the reference RGB888 image, YUV422 must carry the same luminance as the grayscale output
+ * and the dithered RGB565 colors can only be one step above the truncated ones.
+ */
+TEST_CASE("Test JPEG decompression library: Grayscale and YUV422 output", "[esp_jpeg]")
+{
+    uint8_t *gray = malloc(TESTW * TESTH);
+    uint8_t *yuv = malloc(TESTW * TESTH * 2);
+    uint8_t *rgb565 = malloc(TESTW * TESTH * 2);
+    TEST_ASSERT_NOT_NULL(gray);
+    TEST_ASSERT_NOT_NULL(yuv);
+    TEST_ASSERT_NOT_NULL(rgb565);
+
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)logo_jpg,
+        .indata_size = logo_jpg_len,
+        .outbuf = gray,
+        .outbuf_size = TESTW * TESTH,
+        .out_format = JPEG_IMAGE_FORMAT_GRAY,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    esp_jpeg_image_output_t outimg;
+#if CONFIG_JD_USE_ROM
+    /* The ROM decoder outputs RGB only */
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_jpeg_decode(&jpeg_cfg, &outimg));
+#else
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(TESTW * TESTH, outimg.output_len);
+
+    jpeg_cfg.outbuf = yuv;
+    jpeg_cfg.outbuf_size = TESTW * TESTH * 2;
+    jpeg_cfg.out_format = JPEG_IMAGE_FORMAT_YUV422;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    TEST_ASSERT_EQUAL(TESTW * TESTH * 2, outimg.output_len);
+
+    for (int i = 0; i < TESTW * TESTH; i++) {
+        const uint8_t *o = &logo_rgb888[i * 3];
+        const int y = (299 * o[0] + 587 * o[1] + 114 * o[2] + 500) / 1000;
+        /* The luminance can be +- 3 */
+        TEST_ASSERT_UINT8_WITHIN(3, y, gray[i]);
+        TEST_ASSERT_EQUAL_UINT8(gray[i], yuv[i * 2]);
+    }
+#endif
+
+#if !CONFIG_JD_FORMAT_RGB565
+    uint16_t *truncated = (uint16_t *)yuv;
+    jpeg_cfg.outbuf = (uint8_t *)truncated;
+    jpeg_cfg.out_format = JPEG_IMAGE_FORMAT_RGB565;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+    jpeg_cfg.outbuf = rgb565;
+    jpeg_cfg.flags.dither = 1;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+
+    const uint16_t *dithered = (const uint16_t *)rgb565;
+    for (int i = 0; i < TESTW * TESTH; i++) {
+        const int dr = (dithered[i] >> 11) - (truncated[i] >> 11);
+        const int dg = ((dithered[i] >> 5) & 0x3F) - ((truncated[i] >> 5) & 0x3F);
+        const int db = (dithered[i] & 0x1F) - (truncated[i] & 0x1F);
+        TEST_ASSERT_TRUE(dr == 0 || dr == 1);
+        TEST_ASSERT_TRUE(dg == 0 || dg == 1);
+        TEST_ASSERT_TRUE(db == 0 || db == 1);
+    }
+#endif
+
+    free(rgb565);
+    free(yuv);
+    free(gray);
+}
+
+/**
+ * @brief MJPEG decoder test
+ *
+ * A multipart stream with two different images is fed in small chunks, so that the markers are split between
+ * chunks. Every frame must be found in the stream, decoded and equal to the output of esp_jpeg_decode().
+ */
+#define MJPEG_TEST_FRAMES 6
+typedef struct {
+    esp_jpeg_mjpeg_handle_t handle;
+    SemaphoreHandle_t done;
+    const uint8_t *expected;
+    size_t expected_len;
+    uint32_t frames;
+} mjpeg_test_ctx_t;
+
+static void mjpeg_test_on_frame(const esp_jpeg_mjpeg_frame_t *frame, void *user_ctx)
+{
+    mjpeg_test_ctx_t *ctx = (mjpeg_test_ctx_t *)user_ctx;
+
+    if (frame->len == ctx->expected_len && memcmp(frame->buf, ctx->expected, frame->len) == 0) {
+        ctx->frames++;
+    }
+    esp_jpeg_mjpeg_release_frame(ctx->handle, frame->fb_index);
+    xSemaphoreGive(ctx->done);
+}
+
+static void mjpeg_test_feed(esp_jpeg_mjpeg_handle_t handle, const uint8_t *data, size_t len)
+{
+    while (len) {
+        const size_t chunk = MIN(len, 97);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_mjpeg_feed(handle, data, chunk));
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+TEST_CASE("Test JPEG decompression library: MJPEG decoder", "[esp_jpeg]")
+{
+    static const char boundary[] = "\r\n--frame\r\nContent-Type: image/jpeg\r\n\r\n";
+    const struct {
+        const uint8_t *jpg;
+        size_t len;
+        size_t outsize;
+    } images[] = {
+        { logo_jpg, logo_jpg_len, TESTW * TESTH * 2 },
+        { camera_2_jpg, camera_2_jpg_len, 160 * 120 * 2 },
+    };
+    uint8_t *expected = malloc(160 * 120 * 2);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    mjpeg_test_ctx_t ctx = {
+        .done = xSemaphoreCreateBinary(),
+        .expected = expected,
+    };
+    TEST_ASSERT_NOT_NULL(ctx.done);
+    esp_jpeg_mjpeg_config_t mjpeg_cfg = {
+        .max_frame_size = 16 * 1024,
+        .max_width = 160,
+        .max_height = 120,
+        .num_fbs = 2,
+        .image_cfg = {
+            .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        },
+        .on_frame = mjpeg_test_on_frame,
+        .user_ctx = &ctx,
+        .task = {
+            .priority = 5,
+            .core_id = tskNO_AFFINITY,
+        },
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_mjpeg_new(&mjpeg_cfg, &ctx.handle));
+
+    for (int i = 0; i < MJPEG_TEST_FRAMES; i++) {
+        const int n = i % 2;
+        esp_jpeg_image_cfg_t jpeg_cfg = {
+            .indata = (uint8_t *)images[n].jpg,
+            .indata_size = images[n].len,
+            .outbuf = expected,
+            .outbuf_size = images[n].outsize,
+            .out_format = JPEG_IMAGE_FORMAT_RGB565,
+        };
+        esp_jpeg_image_output_t outimg;
+        TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decode(&jpeg_cfg, &outimg));
+        ctx.expected_len = outimg.output_len;
+
+        mjpeg_test_feed(ctx.handle, (const uint8_t *)boundary, sizeof(boundary) - 1);
+        mjpeg_test_feed(ctx.handle, images[n].jpg, images[n].len);
+        TEST_ASSERT_TRUE(xSemaphoreTake(ctx.done, pdMS_TO_TICKS(1000)));
+    }
+    TEST_ASSERT_EQUAL(MJPEG_TEST_FRAMES, ctx.frames);
+
+    esp_jpeg_mjpeg_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_mjpeg_get_stats(ctx.handle, &stats));
+    TEST_ASSERT_EQUAL(MJPEG_TEST_FRAMES, stats.frames_decoded);
+    TEST_ASSERT_EQUAL(0, stats.frames_dropped + stats.frames_skipped + stats.frames_oversized + stats.decode_errors);
+    printf("MJPEG: %"PRIu32" us average decoding time, %"PRIu32" us max latency\n",
+           (uint32_t)(stats.total_decode_us / stats.frames_decoded), stats.max_latency_us);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_mjpeg_delete(ctx.handle));
+    vSemaphoreDelete(ctx.done);
+    free(expected);
+}
+
+
+/**
+ * @brief Decoding speed of the software and hardware decoders, and of a reused decoder
+ *
+ * The output buffer is aligned to the cache line, so that the hardware decoder can be used on targets that have one.
+ * The hardware decoder is reported as not supported on other targets or if it can't decode the image.
+ */
+#define BENCHMARK_RUNS  20
+static esp_err_t benchmark_decode(esp_jpeg_decoder_handle_t decoder, esp_jpeg_image_cfg_t *jpeg_cfg,
+                                  esp_jpeg_image_output_t *outimg)
+{
+    return decoder ? esp_jpeg_decoder_decode(decoder, jpeg_cfg, outimg) : esp_jpeg_decode(jpeg_cfg, outimg);
+}
+
+static void benchmark_backend(esp_jpeg_image_cfg_t *jpeg_cfg, esp_jpeg_decoder_backend_t backend,
+                              esp_jpeg_decoder_handle_t decoder, const char *name)
+{
+    esp_jpeg_image_output_t outimg;
+
+    jpeg_cfg->advanced.backend = backend;
+    esp_err_t err = benchmark_decode(decoder, jpeg_cfg, &outimg);
+    if (backend == JPEG_DECODER_BACKEND_HARDWARE && err == ESP_ERR_NOT_SUPPORTED) {
+        printf("%s decoder: not supported\n", name);
+        return;
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCHMARK_RUNS; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, benchmark_decode(decoder, jpeg_cfg, &outimg));
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start;
+    printf("%s decoder: %ux%u, %lld us per image, %.1f fps\n", name, outimg.width, outimg.height,
+           (long long)(elapsed_us / BENCHMARK_RUNS), BENCHMARK_RUNS * 1000000.0 / elapsed_us);
+}
+
+TEST_CASE("Test JPEG decoding speed", "[esp_jpeg]")
+{
+    int decoded_outsize = 160 * 120 * 3;
+    uint8_t *decoded = heap_caps_aligned_alloc(128, decoded_outsize, MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(decoded);
+
+    esp_jpeg_image_cfg_t jpeg_cfg = {
+        .indata = (uint8_t *)camera_2_jpg,
+        .indata_size = camera_2_jpg_len,
+        .outbuf = decoded,
+        .outbuf_size = decoded_outsize,
+        .out_format = JPEG_IMAGE_FORMAT_RGB888,
+        .out_scale = JPEG_IMAGE_SCALE_0,
+    };
+    benchmark_backend(&jpeg_cfg, JPEG_DECODER_BACKEND_SOFTWARE, NULL, "Software");
+    benchmark_backend(&jpeg_cfg, JPEG_DECODER_BACKEND_HARDWARE, NULL, "Hardware");
+
+    esp_jpeg_decoder_handle_t decoder;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decoder_new(NULL, &decoder));
+    benchmark_backend(&jpeg_cfg, JPEG_DECODER_BACKEND_SOFTWARE, decoder, "Software, reused decoder");
+    TEST_ASSERT_EQUAL(ESP_OK, esp_jpeg_decoder_delete(decoder));
+
+    heap_caps_free(decoded);
+}
@@ -823,7 +823,8 @@ static void block_idct (
 /*-----------------------------------------------------------------------*/
 
 static JRESULT mcu_load (
-    JDEC *jd        /* Pointer to the decompressor object */
+    JDEC *jd,       /* Pointer to the decompressor object */
+    int output      /* 0: the MCU is not output, only the stream is decoded */
 )
 {
     int32_t *tmp = (int32_t *)jd->workbuf;  /* Block working buffer for de-quantize and IDCT */
@@ -897,7 +898,7 @@ static JRESULT mcu_load (
                 }
             } while (++z < 64);     /* Next AC element */
 
-            if (JD_FORMAT != 2 || !cmp) {   /* C components may not be processed if in grayscale output */
+            if (output && (!cmp || (JD_FORMAT != 2 && jd->color != JD_COLOR_GRAY))) {  /* C components may not be processed if in grayscale output */
                 if (z == 1 || (JD_USE_SCALE && jd->scale == 3)) {   /* If no AC element or scale ratio is 1/8, IDCT can be omitted and the block is filled with DC value */
                     d = (jd_yuv_t)((*tmp / 256) + 128);
                     if (JD_FASTDECODE >= 1) {
@@ -932,6 +933,8 @@ static JRESULT mcu_output (
 )
 {
     const int CVACC = (sizeof (int) > 2) ? 1024 : 128;  /* Adaptive accuracy for both 16-/32-bit systems */
+    const int gray = (JD_FORMAT == 2 || jd->color == JD_COLOR_GRAY);    /* Grayscale output? */
+    const unsigned int bpp = gray ? 1 : 3;              /* Bytes per pixel until the RGB565 conversion */
     unsigned int ix, iy, mx, my, rx, ry;
     int yy, cb, cr;
     jd_yuv_t *py, *pc;
@@ -956,7 +959,7 @@ static JRESULT mcu_output (
     if (!JD_USE_SCALE || jd->scale != 3) {  /* Not for 1/8 scaling */
         pix = (uint8_t *)jd->workbuf;
 
-        if (JD_FORMAT != 2) {   /* RGB output (build an RGB MCU from Y/C component) */
+        if (!gray) {    /* RGB output (build an RGB MCU from Y/C component) */
             for (iy = 0; iy < my; iy++) {
                 pc = py = jd->mcubuf;
                 if (my == 16) {     /* Double block height? */
@@ -983,6 +986,12 @@ static JRESULT mcu_output (
                         pc++;                       /* Step forward chroma pointer every pixel */
                     }
                     yy = *py++;         /* Get Y component */
+                    if (jd->color == JD_COLOR_YCC) {    /* YCbCr output? */
+                        *pix++ = BYTECLIP(yy);
+                        *pix++ = BYTECLIP(cb + 128);
+                        *pix++ = BYTECLIP(cr + 128);
+                        continue;
+                    }
                     *pix++ = /*R*/ BYTECLIP(yy + ((int)(1.402 * CVACC) * cr) / CVACC);
                     *pix++ = /*G*/ BYTECLIP(yy - ((int)(0.344 * CVACC) * cb + (int)(0.714 * CVACC) * cr) / CVACC);
                     *pix++ = /*B*/ BYTECLIP(yy + ((int)(1.772 * CVACC) * cb) / CVACC);
@@ -1002,7 +1011,7 @@ static JRESULT mcu_output (
                             py += 64 - 8;    /* Jump to next block if double block height */
                         }
                     }
-                    *pix++ = (uint8_t) * py++;          /* Get and store a Y value as grayscale */
+                    *pix++ = BYTECLIP(*py++);   /* Get and store a Y value as grayscale */
                 }
             }
         }
@@ -1015,16 +1024,16 @@ static JRESULT mcu_output (
             /* Get averaged RGB value of each square corresponds to a pixel */
             s = jd->scale * 2;  /* Number of shifts for averaging */
             w = 1 << jd->scale; /* Width of square */
-            a = (mx - w) * (JD_FORMAT != 2 ? 3 : 1);    /* Bytes to skip for next line in the square */
+            a = (mx - w) * bpp;     /* Bytes to skip for next line in the square */
             op = (uint8_t *)jd->workbuf;
             for (iy = 0; iy < my; iy += w) {
                 for (ix = 0; ix < mx; ix += w) {
-                    pix = (uint8_t *)jd->workbuf + (iy * mx + ix) * (JD_FORMAT != 2 ? 3 : 1);
+                    pix = (uint8_t *)jd->workbuf + (iy * mx + ix) * bpp;
                     r = g = b = 0;
                     for (y = 0; y < w; y++) {   /* Accumulate RGB value in the square */
                         for (x = 0; x < w; x++) {
                             r += *pix++;    /* Accumulate R or Y (monochrome output) */
-                            if (JD_FORMAT != 2) {   /* RGB output? */
+                            if (!gray) {    /* RGB output? */
                                 g += *pix++;    /* Accumulate G */
                                 b += *pix++;    /* Accumulate B */
                             }
@@ -1032,7 +1041,7 @@ static JRESULT mcu_output (
                         pix += a;
                     }                           /* Put the averaged pixel value */
                     *op++ = (uint8_t)(r >> s);  /* Put R or Y (monochrome output) */
-                    if (JD_FORMAT != 2) {   /* RGB output? */
+                    if (!gray) {    /* RGB output? */
                         *op++ = (uint8_t)(g >> s);  /* Put G */
                         *op++ = (uint8_t)(b >> s);  /* Put B */
                     }
@@ -1055,12 +1064,16 @@ static JRESULT mcu_output (
             for (ix = 0; ix < mx; ix += 8) {
                 yy = *py;   /* Get Y component */
                 py += 64;
-                if (JD_FORMAT != 2) {
+                if (jd->color == JD_COLOR_YCC) {
+                    *pix++ = BYTECLIP(yy);
+                    *pix++ = BYTECLIP(cb + 128);
+                    *pix++ = BYTECLIP(cr + 128);
+                } else if (!gray) {
                     *pix++ = /*R*/ BYTECLIP(yy + ((int)(1.402 * CVACC) * cr / CVACC));
                     *pix++ = /*G*/ BYTECLIP(yy - ((int)(0.344 * CVACC) * cb + (int)(0.714 * CVACC) * cr) / CVACC);
                     *pix++ = /*B*/ BYTECLIP(yy + ((int)(1.772 * CVACC) * cb / CVACC));
                 } else {
-                    *pix++ = yy;
+                    *pix++ = BYTECLIP(yy);
                 }
             }
         }
@@ -1076,17 +1089,17 @@ static JRESULT mcu_output (
         for (y = 0; y < ry; y++) {
             for (x = 0; x < rx; x++) {  /* Copy effective pixels */
                 *d++ = *s++;
-                if (JD_FORMAT != 2) {
+                if (!gray) {
                     *d++ = *s++;
                     *d++ = *s++;
                 }
             }
-            s += (mx - rx) * (JD_FORMAT != 2 ? 3 : 1);  /* Skip truncated pixels */
+            s += (mx - rx) * bpp;   /* Skip truncated pixels */
         }
     }
 
     /* Convert RGB888 to RGB565 if needed */
-    if (JD_FORMAT == 1) {
+    if (JD_FORMAT == 1 && jd->color == JD_COLOR_RGB) {
         uint8_t *s = (uint8_t *)jd->workbuf;
         uint16_t w, *d = (uint16_t *)s;
         unsigned int n = rx * ry;
@@ -1120,10 +1133,127 @@ JRESULT jd_prepare (
     size_t sz_pool,         /* Size of working buffer */
     void *dev               /* I/O device identifier for the session */
 )
+{
+    return jd_prepare_cached(jd, infunc, pool, sz_pool, dev, 0);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Table cache of jd_prepare_cached()                                    */
+/*-----------------------------------------------------------------------*/
+/* Memory is allocated from the pool in stream order, so if the DHT/DQT
+/  segments seen so far are the same as in the previous image, the pool and
+/  the tables are in the same state as after the same segment back then. */
+
+static uint32_t tbl_sig (   /* FNV-1a hash of a segment, chained to the previous segments */
+    uint32_t sig,
+    uint8_t marker,
+    const uint8_t *data,
+    size_t ndata
+)
+{
+    sig = (sig ^ marker) * 16777619;
+    sig = (sig ^ (uint8_t)ndata) * 16777619;
+    sig = (sig ^ (uint8_t)(ndata >> 8)) * 16777619;
+    while (ndata--) {
+        sig = (sig ^ *data++) * 16777619;
+    }
+    return sig;
+}
+
+static void tbl_save (JTBLSTATE *st, const JDEC *jd, uint32_t sig)
+{
+    st->sig = sig;
+    st->pool = jd->pool;
+    st->sz_pool = jd->sz_pool;
+    memcpy(st->huffbits, jd->huffbits, sizeof st->huffbits);
+    memcpy(st->huffcode, jd->huffcode, sizeof st->huffcode);
+    memcpy(st->huffdata, jd->huffdata, sizeof st->huffdata);
+    memcpy(st->qttbl, jd->qttbl, sizeof st->qttbl);
+#if JD_FASTDECODE == 2
+    memcpy(st->longofs, jd->longofs, sizeof st->longofs);
+    memcpy(st->hufflut_ac, jd->hufflut_ac, sizeof st->hufflut_ac);
+    memcpy(st->hufflut_dc, jd->hufflut_dc, sizeof st->hufflut_dc);
+#endif
+}
+
+static void tbl_restore (JDEC *jd, const JTBLSTATE *st)
+{
+    jd->pool = st->pool;
+    jd->sz_pool = st->sz_pool;
+    memcpy(jd->huffbits, st->huffbits, sizeof jd->huffbits);
+    memcpy(jd->huffcode, st->huffcode, sizeof jd->huffcode);
+    memcpy(jd->huffdata, st->huffdata, sizeof jd->huffdata);
+    memcpy(jd->qttbl, st->qttbl, sizeof jd->qttbl);
+#if JD_FASTDECODE == 2
+    memcpy(jd->longofs, st->longofs, sizeof jd->longofs);
+    memcpy(jd->hufflut_ac, st->hufflut_ac, sizeof jd->hufflut_ac);
+    memcpy(jd->hufflut_dc, st->hufflut_dc, sizeof jd->hufflut_dc);
+#endif
+}
+
+/* Looks up a DHT/DQT segment in the cache. Returns 1 if its tables were restored, 0 if they must be created */
+static int tbl_lookup (
+    JDEC *jd,
+    JTBLCACHE *cache,
+    unsigned int *nseg,     /* Index of the segment in the image, incremented if the tables were restored */
+    uint32_t *sig,          /* Signature of the previous segments, updated with this one */
+    uint8_t marker,
+    const uint8_t *data,
+    size_t ndata
+)
+{
+    *sig = tbl_sig(*sig, marker, data, ndata);
+    if (*nseg < cache->nseg && cache->seg[*nseg].sig == *sig) {
+        tbl_restore(jd, &cache->seg[(*nseg)++]);
+        return 1;
+    }
+    cache->nseg = *nseg;    /* The pool after this segment is going to be overwritten */
+    return 0;
+}
+
+/* Records the tables after a DHT/DQT segment */
+static void tbl_store (
+    const JDEC *jd,
+    JTBLCACHE *cache,
+    unsigned int *nseg,
+    uint32_t sig
+)
+{
+    if (*nseg < JD_TBLCACHE_SEGS && cache->nseg == *nseg) {
+        tbl_save(&cache->seg[*nseg], jd, sig);
+        cache->nseg = *nseg + 1;
+    }
+    (*nseg)++;
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Analyze the JPEG image reusing the tables of the previous image       */
+/*-----------------------------------------------------------------------*/
+/* Same as jd_prepare(), but huffman and dequantizer tables are not created
+/  again if the DHT/DQT segments are the same as in the previous image
+/  prepared with the same cache and memory pool, e.g. frames of an MJPEG
+/  stream. The memory pool must not be modified between the calls, except by
+/  the decompression. */
+
+JRESULT jd_prepare_cached (
+    JDEC *jd,               /* Blank decompressor object */
+    size_t (*infunc)(JDEC *, uint8_t *, size_t), /* JPEG stream input function */
+    void *pool,             /* Working buffer for the decompression session */
+    size_t sz_pool,         /* Size of working buffer */
+    void *dev,              /* I/O device identifier for the session */
+    JTBLCACHE *cache        /* Table cache, 0:not used */
+)
 {
     uint8_t *seg, b;
     uint16_t marker;
-    unsigned int n, i, ofs;
+    unsigned int n, i, ofs, nseg = 0;
+    uint32_t sig = 2166136261;
     size_t len;
     JRESULT rc;
 
@@ -1134,6 +1264,12 @@ JRESULT jd_prepare (
     jd->infunc = infunc;    /* Stream input function */
     jd->device = dev;       /* I/O device identifier */
 
+    if (cache && (cache->pool != pool || cache->sz_pool != sz_pool)) {
+        cache->pool = pool;     /* Another memory pool, forget the tables */
+        cache->sz_pool = sz_pool;
+        cache->nseg = 0;
+    }
+
     jd->inbuf = seg = alloc_pool(jd, JD_SZBUF);     /* Allocate stream input buffer */
     if (!seg) {
         return JDR_MEM1;
@@ -1235,10 +1371,16 @@ JRESULT jd_prepare (
                 return JDR_INP;    /* Load segment data */
             }
 
+            if (cache && tbl_lookup(jd, cache, &nseg, &sig, 0xC4, seg, len)) {
+                break;  /* Same tables as in the previous image */
+            }
             rc = create_huffman_tbl(jd, seg, len);  /* Create huffman tables */
             if (rc) {
                 return rc;
             }
+            if (cache) {
+                tbl_store(jd, cache, &nseg, sig);
+            }
             break;
 
         case 0xDB:  /* DQT - Define Quaitizer Tables */
@@ -1249,10 +1391,16 @@ JRESULT jd_prepare (
                 return JDR_INP;    /* Load segment data */
             }
 
+            if (cache && tbl_lookup(jd, cache, &nseg, &sig, 0xDB, seg, len)) {
+                break;  /* Same tables as in the previous image */
+            }
             rc = create_qt_tbl(jd, seg, len);   /* Create de-quantizer tables */
             if (rc) {
                 return rc;
             }
+            if (cache) {
+                tbl_store(jd, cache, &nseg, sig);
+            }
             break;
 
         case 0xDA:  /* SOS - Start of Scan */
@@ -1270,6 +1418,10 @@ JRESULT jd_prepare (
                 return JDR_FMT3;    /* Err: Wrong color components */
             }
 
+            if (cache && nseg < cache->nseg) {
+                cache->nseg = nseg;     /* The previous image had more tables, the pool after them is reused below */
+            }
+
             /* Check if all tables corresponding to each components have been loaded */
             for (i = 0; i < jd->ncomp; i++) {
                 b = seg[2 + 2 * i]; /* Get huffman table ID */
@@ -1351,9 +1503,29 @@ JRESULT jd_decomp (
     int (*outfunc)(JDEC *, void *, JRECT *), /* RGB output function */
     uint8_t scale                           /* Output de-scaling factor (0 to 3) */
 )
+{
+    return jd_decomp_rect(jd, outfunc, scale, 0);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Decompress a region of the JPEG picture                               */
+/*-----------------------------------------------------------------------*/
+/* Only the MCUs overlapping the region are output, the others are just
+/  huffman decoded. Decompression ends after the last MCU row of the region. */
+
+JRESULT jd_decomp_rect (
+    JDEC *jd,                               /* Initialized decompression object */
+    int (*outfunc)(JDEC *, void *, JRECT *), /* RGB output function */
+    uint8_t scale,                          /* Output de-scaling factor (0 to 3) */
+    const JRECT *rect                       /* Region in the input image (pixel, before scaling), 0:whole image */
+)
 {
     unsigned int x, y, mx, my;
     uint16_t rst, rsc;
+    int out;
     JRESULT rc;
 
 
@@ -1369,6 +1541,9 @@ JRESULT jd_decomp (
 
     rc = JDR_OK;
     for (y = 0; y < jd->height; y += my) {      /* Vertical loop of MCUs */
+        if (rect && y > rect->bottom) {
+            break;    /* Below the region, the rest of the stream is not needed */
+        }
         for (x = 0; x < jd->width; x += mx) {   /* Horizontal loop of MCUs */
             if (jd->nrst && rst++ == jd->nrst) {    /* Process restart interval if enabled */
                 rc = restart(jd, rsc++);
@@ -1377,16 +1552,127 @@ JRESULT jd_decomp (
                 }
                 rst = 1;
             }
-            rc = mcu_load(jd);                  /* Load an MCU (decompress huffman coded stream, dequantize and apply IDCT) */
+            out = !rect || (x <= rect->right && x + mx > rect->left && y + my > rect->top);
+            rc = mcu_load(jd, out);             /* Load an MCU (decompress huffman coded stream, dequantize and apply IDCT) */
             if (rc != JDR_OK) {
                 return rc;
             }
-            rc = mcu_output(jd, outfunc, x, y); /* Output the MCU (YCbCr to RGB, scaling and output) */
+            if (out) {
+                rc = mcu_output(jd, outfunc, x, y); /* Output the MCU (YCbCr to RGB, scaling and output) */
+                if (rc != JDR_OK) {
+                    return rc;
+                }
+            }
+        }
+    }
+
+    return rc;
+}
+
+
+
+#if JD_PARALLEL_DECODE
+/*-----------------------------------------------------------------------*/
+/* Create a decompressor object sharing the tables of a prepared one     */
+/*-----------------------------------------------------------------------*/
+/* The huffman and dequantizer tables are only read during decompression,
+/  so the clone allocates just its own stream, IDCT and MCU buffers. The
+/  stream of the clone must be positioned by its input function. */
+
+JRESULT jd_clone (
+    JDEC *jd,               /* Blank decompressor object */
+    const JDEC *src,        /* Decompressor object initialized by jd_prepare() */
+    void *pool,             /* Working buffer for the clone */
+    size_t sz_pool,         /* Size of working buffer */
+    void *dev               /* I/O device identifier for the clone */
+)
+{
+    unsigned int n;
+    size_t len;
+
+
+    *jd = *src;
+    jd->pool = pool;
+    jd->sz_pool = sz_pool;
+    jd->device = dev;
+
+    n = jd->msy * jd->msx;                      /* Number of Y blocks in the MCU */
+    len = n * 64 * 2 + 64;                      /* Same buffer sizes as in jd_prepare() */
+    if (len < 256) {
+        len = 256;
+    }
+    jd->inbuf = alloc_pool(jd, JD_SZBUF);
+    jd->workbuf = alloc_pool(jd, len);
+    jd->mcubuf = alloc_pool(jd, (n + 2) * 64 * sizeof (jd_yuv_t));
+    if (!jd->inbuf || !jd->workbuf || !jd->mcubuf) {
+        return JDR_MEM1;    /* Err: not enough memory */
+    }
+
+    jd->dctr = 0;           /* Input buffer is empty, the first read refills it */
+    jd->dptr = jd->inbuf;
+    jd->dbit = 0;
+#if JD_FASTDECODE >= 1
+    jd->wreg = 0;
+    jd->marker = 0;
+#endif
+
+    return JDR_OK;
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Decompress a range of restart intervals                               */
+/*-----------------------------------------------------------------------*/
+/* If first is not 0, the stream must start at the RSTn marker preceding
+/  the first interval. */
+
+JRESULT jd_decomp_intervals (
+    JDEC *jd,                               /* Initialized decompression object */
+    int (*outfunc)(JDEC *, void *, JRECT *), /* RGB output function */
+    uint8_t scale,                          /* Output de-scaling factor (0 to 3) */
+    unsigned int first,                     /* First restart interval to decompress */
+    unsigned int count                      /* Number of restart intervals to decompress */
+)
+{
+    unsigned int x, y, mx, my, nx, mcu, end;
+    JRESULT rc;
+
+
+    if (scale > (JD_USE_SCALE ? 3 : 0) || !jd->nrst) {
+        return JDR_PAR;
+    }
+    jd->scale = scale;
+
+    mx = jd->msx * 8; my = jd->msy * 8;         /* Size of the MCU (pixel) */
+    nx = (jd->width + mx - 1) / mx;             /* Number of MCUs in a row */
+    end = nx * ((jd->height + my - 1) / my);    /* Number of MCUs in the image */
+    if ((first + count) * jd->nrst < end) {
+        end = (first + count) * jd->nrst;
+    }
+
+    jd->dcv[2] = jd->dcv[1] = jd->dcv[0] = 0;   /* Initialize DC values */
+
+    rc = JDR_OK;
+    for (mcu = first * jd->nrst; mcu < end; mcu++) {
+        if (mcu && mcu % jd->nrst == 0) {       /* Process restart interval */
+            rc = restart(jd, mcu / jd->nrst - 1);
             if (rc != JDR_OK) {
                 return rc;
             }
         }
+        x = (mcu % nx) * mx; y = (mcu / nx) * my;
+        rc = mcu_load(jd, 1);                      /* Load an MCU (decompress huffman coded stream, dequantize and apply IDCT) */
+        if (rc != JDR_OK) {
+            return rc;
+        }
+        rc = mcu_output(jd, outfunc, x, y);     /* Output the MCU (YCbCr to RGB, scaling and output) */
+        if (rc != JDR_OK) {
+            return rc;
+        }
     }
 
     return rc;
 }
+#endif /* JD_PARALLEL_DECODE */
@@ -53,6 +53,13 @@ typedef struct {
 
 
 
+/* Output color of jd_decomp(), JDEC.color */
+#define JD_COLOR_RGB    0   /* JD_FORMAT output */
+#define JD_COLOR_GRAY   1   /* Y only, 1 byte per pixel. Chroma blocks are not transformed */
+#define JD_COLOR_YCC    2   /* Y, Cb, Cr, 3 bytes per pixel. Color conversion is omitted */
+
+
+
 /* Decompressor object structure */
 typedef struct JDEC JDEC;
 struct JDEC {
@@ -61,6 +68,7 @@ struct JDEC {
     uint8_t *inbuf;             /* Bit stream input buffer */
     uint8_t dbit;               /* Number of bits available in wreg or reading bit mask */
     uint8_t scale;              /* Output scaling ratio */
+    uint8_t color;              /* Output color JD_COLOR_*, may be set between jd_prepare() and jd_decomp() */
     uint8_t msx, msy;           /* MCU size in unit of block (width, height) */
     uint8_t qtid[3];            /* Quantization table ID of each component, Y, Cb, Cr */
     uint8_t ncomp;              /* Number of color components 1:grayscale, 3:color */
@@ -90,9 +98,43 @@ struct JDEC {
 
 
 
+/* Huffman and dequantizer tables after a DHT/DQT segment, see jd_prepare_cached() */
+typedef struct {
+    uint32_t sig;               /* Signature of the DHT/DQT segments up to this one */
+    void *pool;                 /* Memory pool after the tables */
+    size_t sz_pool;
+    uint8_t *huffbits[2][2];
+    uint16_t *huffcode[2][2];
+    uint8_t *huffdata[2][2];
+    int32_t *qttbl[4];
+#if JD_FASTDECODE == 2
+    uint8_t longofs[2][2];
+    uint16_t *hufflut_ac[2];
+    uint8_t *hufflut_dc[2];
+#endif
+} JTBLSTATE;
+
+#define JD_TBLCACHE_SEGS    8   /* DHT/DQT segments of an image kept in the table cache */
+
+/* Tables built in a memory pool by the previous jd_prepare_cached() call */
+typedef struct {
+    void *pool;                 /* Memory pool the tables were built in (0:cache empty) */
+    size_t sz_pool;
+    unsigned int nseg;          /* Number of valid entries in seg */
+    JTBLSTATE seg[JD_TBLCACHE_SEGS];
+} JTBLCACHE;
+
+
+
 /* TJpgDec API functions */
 JRESULT jd_prepare (JDEC *jd, size_t (*infunc)(JDEC *, uint8_t *, size_t), void *pool, size_t sz_pool, void *dev);
+JRESULT jd_prepare_cached (JDEC *jd, size_t (*infunc)(JDEC *, uint8_t *, size_t), void *pool, size_t sz_pool, void *dev, JTBLCACHE *cache);
 JRESULT jd_decomp (JDEC *jd, int (*outfunc)(JDEC *, void *, JRECT *), uint8_t scale);
+JRESULT jd_decomp_rect (JDEC *jd, int (*outfunc)(JDEC *, void *, JRECT *), uint8_t scale, const JRECT *rect);
+#if JD_PARALLEL_DECODE
+JRESULT jd_clone (JDEC *jd, const JDEC *src, void *pool, size_t sz_pool, void *dev);
+JRESULT jd_decomp_intervals (JDEC *jd, int (*outfunc)(JDEC *, void *, JRECT *), uint8_t scale, unsigned int first, unsigned int count);
+#endif
 
 
 #ifdef __cplusplus
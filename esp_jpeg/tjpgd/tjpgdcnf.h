@@ -4,45 +4,71 @@
 
 #include "sdkconfig.h"
 
+/* Options are taken from menuconfig unless defined before, e.g. to build several configurations in one application */
+
+#ifndef JD_SZBUF
 #define JD_SZBUF        CONFIG_JD_SZBUF
+#endif
 /* Specifies size of stream input buffer */
 
+#ifndef JD_FORMAT
 #define JD_FORMAT       CONFIG_JD_FORMAT
+#endif
 /* Specifies output pixel format.
 /  0: RGB888 (24-bit/pix)
 /  1: RGB565 (16-bit/pix)
 /  2: Grayscale (8-bit/pix)
 */
 
+#ifndef JD_USE_SCALE
 #if defined(CONFIG_JD_USE_SCALE)
 #define JD_USE_SCALE    CONFIG_JD_USE_SCALE
 #else
 #define JD_USE_SCALE    0
 #endif
+#endif
 /* Switches output descaling feature.
 /  0: Disable
 /  1: Enable
 */
 
+#ifndef JD_TBLCLIP
 #if defined(CONFIG_JD_TBLCLIP)
 #define JD_TBLCLIP      CONFIG_JD_TBLCLIP
 #else
 #define JD_TBLCLIP      0
 #endif
+#endif
 /* Use table conversion for saturation arithmetic. A bit faster, but increases 1 KB of code size.
 /  0: Disable
 /  1: Enable
 */
 
+#ifndef JD_FASTDECODE
 #define JD_FASTDECODE   CONFIG_JD_FASTDECODE
+#endif
 /* Optimization level
 /  0: Basic optimization. Suitable for 8/16-bit MCUs.
 /  1: + 32-bit barrel shifter. Suitable for 32-bit MCUs.
 /  2: + Table conversion for huffman decoding (wants 6 << HUFF_BIT bytes of RAM)
 */
 
+#ifndef JD_DEFAULT_HUFFMAN
 #if defined(CONFIG_JD_DEFAULT_HUFFMAN)
 #define JD_DEFAULT_HUFFMAN CONFIG_JD_DEFAULT_HUFFMAN
 #else
 #define JD_DEFAULT_HUFFMAN 0
 #endif
+#endif
+
+#ifndef JD_PARALLEL_DECODE
+#if defined(CONFIG_JD_PARALLEL_DECODE)
+#define JD_PARALLEL_DECODE CONFIG_JD_PARALLEL_DECODE
+#else
+#define JD_PARALLEL_DECODE 0
+#endif
+#endif
+/* Decoding of restart intervals by several decompressor objects, see jd_clone() and jd_decomp_intervals().
+/  0: Disable
+/  1: Enable
+*/
@@ -147,7 +147,8 @@ void app_main(void)
     disp_drv.draw_buf = &disp_buf;
     disp_drv.user_data = panel_handle;
 #if CONFIG_EXAMPLE_QEMU_RGB_PANEL_DEDIC_FB
-    disp_drv.full_refresh = true; // the full_refresh mode can maintain the synchronization between the two frame buffers
+    // LVGL draws in place in the frame buffer, only the rows of the areas it redraws are transmitted to the panel
+    disp_drv.direct_mode = true;
 #endif
     lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
 
@@ -24,8 +24,27 @@ typedef struct {
     uint32_t width;             /*!< Width of the graphical window in pixels */
     uint32_t height;            /*!< Height of the graphical window in pixels */
     esp_lcd_rgb_qemu_bpp_t bpp;                /*!< BPP - bit per pixel*/
+    uint32_t num_fbs;           /*!< Number of frame buffers, 0 or 1 for the dedicated one, 2 to add one in RAM for double buffering */
 } esp_lcd_rgb_qemu_config_t;
 
+/**
+ * @brief Frame done callback, called once a frame given to `esp_lcd_rgb_qemu_swap_frame_buffers` is transmitted
+ *
+ * @note Called from a task, either the one calling the panel functions or the esp_timer one
+ *
+ * @param[in] panel QEMU RGB panel handle
+ * @param[in] frame_buffer Frame buffer which was transmitted
+ * @param[in] user_ctx User context, passed to `esp_lcd_rgb_qemu_register_event_callbacks`
+ */
+typedef void (*esp_lcd_rgb_qemu_frame_done_cb_t)(esp_lcd_panel_handle_t panel, void *frame_buffer, void *user_ctx);
+
+/**
+ * @brief QEMU RGB panel event callbacks
+ */
+typedef struct {
+    esp_lcd_rgb_qemu_frame_done_cb_t on_frame_done; /*!< A frame was transmitted to the panel */
+} esp_lcd_rgb_qemu_event_callbacks_t;
+
 /**
  * @brief Create QEMU RGB panel
  *
@@ -49,14 +68,71 @@ esp_err_t esp_lcd_new_rgb_qemu(const esp_lcd_rgb_qemu_config_t *rgb_config, esp_
  */
 esp_err_t esp_lcd_rgb_qemu_get_frame_buffer(esp_lcd_panel_handle_t panel, void **fb);
 
+/**
+ * @brief Get the addresses of the frame buffers for the QEMU RGB panel
+ *
+ * @param[in] panel QEMU RGB panel handle, returned from `esp_lcd_new_rgb_qemu`
+ * @param[out] fb0 Returned address of the dedicated frame buffer, the one of `esp_lcd_rgb_qemu_get_frame_buffer`
+ * @param[out] fb1 Returned address of the second frame buffer, NULL with a single frame buffer
+ * @return
+ *      - ESP_ERR_INVALID_ARG: Invalid panel handle
+ *      - ESP_OK: Frame buffers returned successfully
+ */
+esp_err_t esp_lcd_rgb_qemu_get_frame_buffers(esp_lcd_panel_handle_t panel, void **fb0, void **fb1);
+
+/**
+ * @brief Register the event callbacks of the QEMU RGB panel
+ *
+ * @param[in] panel QEMU RGB panel handle, returned from `esp_lcd_new_rgb_qemu`
+ * @param[in] callbacks Callbacks, NULL members are not called
+ * @param[in] user_ctx User context, passed to the callbacks
+ * @return
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_OK: Callbacks registered successfully
+ */
+esp_err_t esp_lcd_rgb_qemu_register_event_callbacks(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_qemu_event_callbacks_t *callbacks, void *user_ctx);
+
 /**
  * @brief Manually trigger once transmission of the frame buffer to the panel
  *
+ * @note Once `esp_lcd_rgb_qemu_mark_dirty` has been called, only the rows of the areas marked dirty since the last
+ *       refresh are transmitted, and nothing if there is none. Otherwise, the whole frame buffer is transmitted.
+ *
  * @param[in] panel QEMU RGB panel handle, returned from `esp_lcd_new_rgb_qemu`
  * @returns ESP_OK unconditionally
  */
 esp_err_t esp_lcd_rgb_qemu_refresh(esp_lcd_panel_handle_t panel);
 
+/**
+ * @brief Mark an area of the frame buffer as modified, to be transmitted by the next `esp_lcd_rgb_qemu_refresh`
+ *
+ * @param[in] panel QEMU RGB panel handle, returned from `esp_lcd_new_rgb_qemu`
+ * @param[in] x_start Start column of the area
+ * @param[in] y_start Start row of the area
+ * @param[in] x_end End column of the area, not included
+ * @param[in] y_end End row of the area, not included
+ * @return
+ *      - ESP_ERR_INVALID_ARG: The area is empty or out of the panel
+ *      - ESP_OK: Area marked successfully
+ */
+esp_err_t esp_lcd_rgb_qemu_mark_dirty(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end);
+
+/**
+ * @brief Start transmitting the back frame buffer to the panel, and make the other one the back frame buffer
+ *
+ * @note Returns without waiting for the end of the transfer, which is reported by the `on_frame_done` callback.
+ *       Only waits for the transfer of the previous frame, if it isn't over yet, because its frame buffer is the
+ *       one returned to be drawn in.
+ *
+ * @param[in] panel QEMU RGB panel handle, created with `num_fbs` set to 2
+ * @param[out] ret_back_fb Returned address of the new back frame buffer, to draw the next frame in
+ * @return
+ *      - ESP_ERR_INVALID_ARG: Invalid panel handle
+ *      - ESP_ERR_INVALID_STATE: The panel has a single frame buffer
+ *      - ESP_OK: Frame buffers swapped successfully
+ */
+esp_err_t esp_lcd_rgb_qemu_swap_frame_buffers(esp_lcd_panel_handle_t panel, void **ret_back_fb);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,8 +4,13 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stdbool.h>
+#include <sys/param.h>
 #include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
 #include "esp_lcd_panel_interface.h"
 #include "esp_lcd_qemu_rgb_struct.h"
 #include "esp_lcd_qemu_rgb.h"
@@ -16,6 +21,9 @@
  * QEMU or on real hardware */
 #define RGB_QEMU_ORIGIN     0x51454d55
 
+/* Period of the check of the end of an asynchronous frame transfer, the virtual panel has no interrupt */
+#define RGB_QEMU_FRAME_DONE_POLL_US 1000
+
 static const char *TAG = "lcd_qemu.rgb";
 
 static rgb_qemu_dev_t *s_rgb_dev = (void *) 0x21000000;
@@ -28,6 +36,21 @@ typedef struct esp_rgb_qemu_t {
     int panel_id;          // LCD panel ID
     uint32_t width;
     uint32_t height;
+    uint32_t bytes_per_pixel;
+    bool dirty_tracking;   // esp_lcd_rgb_qemu_mark_dirty() was called, refresh only the dirty area
+    bool dirty;            // the dirty area below isn't empty
+    int dirty_x_start;
+    int dirty_y_start;
+    int dirty_x_end;
+    int dirty_y_end;
+    uint32_t num_fbs;
+    void *fbs[2];          // fbs[0] is the dedicated frame buffer, fbs[1] the RAM one of the double buffering
+    uint32_t front;        // index of the frame buffer last transmitted by esp_lcd_rgb_qemu_swap_frame_buffers()
+    portMUX_TYPE lock;
+    bool transfer_pending; // a frame transfer was started and its end not reported yet
+    esp_timer_handle_t poll_timer;
+    esp_lcd_rgb_qemu_frame_done_cb_t on_frame_done;
+    void *user_ctx;
 } esp_rgb_qemu_t;
 
 static_assert(offsetof(esp_rgb_qemu_t, base) == 0, "Base field must be the first");
@@ -41,12 +64,15 @@ static esp_err_t rgb_qemu_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mir
 static esp_err_t rgb_qemu_swap_xy(esp_lcd_panel_t *panel, bool swap_axes);
 static esp_err_t rgb_qemu_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap);
 static esp_err_t rgb_qemu_disp_on_off(esp_lcd_panel_t *panel, bool off);
+static void rgb_qemu_poll_frame_done(void *arg);
+static bool rgb_qemu_check_frame_done(esp_rgb_qemu_t *rgb_panel);
+static void rgb_qemu_start_update(esp_rgb_qemu_t *rgb_panel, int x_start, int y_start, int x_end, int y_end, const void *content);
 
 esp_err_t esp_lcd_new_rgb_qemu(const esp_lcd_rgb_qemu_config_t *rgb_config, esp_lcd_panel_handle_t *ret_panel)
 {
     esp_err_t ret = ESP_OK;
     esp_rgb_qemu_t *rgb_panel = NULL;
-    ESP_GOTO_ON_FALSE(ret_panel, ESP_ERR_INVALID_ARG, err, TAG, "invalid parameter");
+    ESP_GOTO_ON_FALSE(rgb_config && ret_panel && rgb_config->num_fbs <= 2, ESP_ERR_INVALID_ARG, err, TAG, "invalid parameter");
 
     /* Check if we are actually running on QEMU, read the special register allocated just before the
      * SYSCON date one. */
@@ -66,6 +92,22 @@ esp_err_t esp_lcd_new_rgb_qemu(const esp_lcd_rgb_qemu_config_t *rgb_config, esp_
      * So, read back the configured size */
     rgb_panel->height = rgb_config->height;
     rgb_panel->width = rgb_config->width;
+    rgb_panel->bytes_per_pixel = s_rgb_dev->bpp / 8;
+    rgb_panel->lock = (portMUX_TYPE) portMUX_INITIALIZER_UNLOCKED;
+    rgb_panel->num_fbs = rgb_config->num_fbs ? rgb_config->num_fbs : 1;
+    rgb_panel->fbs[0] = s_rgb_framebuffer;
+    if (rgb_panel->num_fbs == 2) {
+        /* Too large for the internal RAM with most resolutions */
+        const size_t fb_size = rgb_panel->width * rgb_panel->height * rgb_panel->bytes_per_pixel;
+        rgb_panel->fbs[1] = heap_caps_malloc_prefer(fb_size, 2, MALLOC_CAP_SPIRAM, MALLOC_CAP_8BIT);
+        ESP_GOTO_ON_FALSE(rgb_panel->fbs[1], ESP_ERR_NO_MEM, err, TAG, "no mem for second frame buffer");
+        const esp_timer_create_args_t timer_args = {
+            .callback = rgb_qemu_poll_frame_done,
+            .arg = rgb_panel,
+            .name = "lcd_qemu_rgb",
+        };
+        ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &rgb_panel->poll_timer), err, TAG, "create poll timer failed");
+    }
 
     /* Fill function table */
     rgb_panel->base.del = rgb_qemu_del;
@@ -80,9 +122,13 @@ esp_err_t esp_lcd_new_rgb_qemu(const esp_lcd_rgb_qemu_config_t *rgb_config, esp_
 
     /* Return base class */
     *ret_panel = &(rgb_panel->base);
-    ret = ESP_OK;
+    return ESP_OK;
 
 err:
+    if (rgb_panel) {
+        free(rgb_panel->fbs[1]);
+        free(rgb_panel);
+    }
     return ret;
 }
 
@@ -95,46 +141,180 @@ esp_err_t esp_lcd_rgb_qemu_get_frame_buffer(esp_lcd_panel_handle_t panel, void *
     return ESP_OK;
 }
 
-esp_err_t esp_lcd_rgb_qemu_refresh(esp_lcd_panel_handle_t panel)
+esp_err_t esp_lcd_rgb_qemu_get_frame_buffers(esp_lcd_panel_handle_t panel, void **fb0, void **fb1)
 {
     esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
-    return rgb_qemu_draw_bitmap(panel, 0, 0, rgb_panel->width, rgb_panel->height, s_rgb_framebuffer);
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (fb0) {
+        *fb0 = rgb_panel->fbs[0];
+    }
+    if (fb1) {
+        *fb1 = rgb_panel->fbs[1];
+    }
+    return ESP_OK;
 }
 
-/*** PRIVATE FUNCTIONS ***/
-
-static esp_err_t rgb_qemu_del(esp_lcd_panel_t *panel)
+esp_err_t esp_lcd_rgb_qemu_register_event_callbacks(esp_lcd_panel_handle_t panel, const esp_lcd_rgb_qemu_event_callbacks_t *callbacks, void *user_ctx)
 {
-    free(panel);
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
+    ESP_RETURN_ON_FALSE(panel && callbacks, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&rgb_panel->lock);
+    rgb_panel->on_frame_done = callbacks->on_frame_done;
+    rgb_panel->user_ctx = user_ctx;
+    portEXIT_CRITICAL(&rgb_panel->lock);
     return ESP_OK;
 }
 
-static esp_err_t rgb_qemu_reset(esp_lcd_panel_t *panel)
+esp_err_t esp_lcd_rgb_qemu_refresh(esp_lcd_panel_handle_t panel)
 {
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
+    void *fb = rgb_panel->fbs[rgb_panel->front];
+    if (!rgb_panel->dirty_tracking) {
+        return rgb_qemu_draw_bitmap(panel, 0, 0, rgb_panel->width, rgb_panel->height, fb);
+    }
+    if (rgb_panel->dirty) {
+        rgb_panel->dirty = false;
+        return rgb_qemu_draw_bitmap(panel, rgb_panel->dirty_x_start, rgb_panel->dirty_y_start,
+                                    rgb_panel->dirty_x_end, rgb_panel->dirty_y_end, fb);
+    }
     return ESP_OK;
 }
 
-static esp_err_t rgb_qemu_init(esp_lcd_panel_t *panel)
+esp_err_t esp_lcd_rgb_qemu_mark_dirty(esp_lcd_panel_handle_t panel, int x_start, int y_start, int x_end, int y_end)
 {
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
+    ESP_RETURN_ON_FALSE(panel && x_start >= 0 && y_start >= 0 && x_start < x_end && y_start < y_end &&
+                        x_end <= rgb_panel->width && y_end <= rgb_panel->height, ESP_ERR_INVALID_ARG, TAG, "invalid area");
+    rgb_panel->dirty_tracking = true;
+    if (rgb_panel->dirty) {
+        rgb_panel->dirty_x_start = MIN(rgb_panel->dirty_x_start, x_start);
+        rgb_panel->dirty_y_start = MIN(rgb_panel->dirty_y_start, y_start);
+        rgb_panel->dirty_x_end = MAX(rgb_panel->dirty_x_end, x_end);
+        rgb_panel->dirty_y_end = MAX(rgb_panel->dirty_y_end, y_end);
+    } else {
+        rgb_panel->dirty_x_start = x_start;
+        rgb_panel->dirty_y_start = y_start;
+        rgb_panel->dirty_x_end = x_end;
+        rgb_panel->dirty_y_end = y_end;
+        rgb_panel->dirty = true;
+    }
     return ESP_OK;
 }
 
-static esp_err_t rgb_qemu_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+esp_err_t esp_lcd_rgb_qemu_swap_frame_buffers(esp_lcd_panel_handle_t panel, void **ret_back_fb)
 {
     esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
-    assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(rgb_panel->num_fbs == 2, ESP_ERR_INVALID_STATE, TAG, "panel has a single frame buffer");
+    const uint32_t back = !rgb_panel->front;
+    /* The previous frame, about to be drawn over, must have been transmitted. Only waits if the rendering is
+     * faster than the transfer */
+    rgb_qemu_start_update(rgb_panel, 0, 0, rgb_panel->width, rgb_panel->height, rgb_panel->fbs[back]);
+    portENTER_CRITICAL(&rgb_panel->lock);
+    rgb_panel->front = back;
+    rgb_panel->transfer_pending = true;
+    portEXIT_CRITICAL(&rgb_panel->lock);
+    if (ret_back_fb) {
+        *ret_back_fb = rgb_panel->fbs[!back];
+    }
+    /* ESP32-C3 QEMU transmits synchronously, ESP32 QEMU in the background */
+    if (!rgb_qemu_check_frame_done(rgb_panel)) {
+        esp_timer_start_periodic(rgb_panel->poll_timer, RGB_QEMU_FRAME_DONE_POLL_US);
+    }
+    return ESP_OK;
+}
+
+/*** PRIVATE FUNCTIONS ***/
+
+/* Reports the end of the pending frame transfer, if it is over. Returns whether no transfer is pending anymore */
+static bool rgb_qemu_check_frame_done(esp_rgb_qemu_t *rgb_panel)
+{
+    portENTER_CRITICAL(&rgb_panel->lock);
+    bool done = s_rgb_dev->update_st.ena == 0;
+    bool report = done && rgb_panel->transfer_pending;
+    if (report) {
+        rgb_panel->transfer_pending = false;
+    }
+    esp_lcd_rgb_qemu_frame_done_cb_t on_frame_done = rgb_panel->on_frame_done;
+    void *user_ctx = rgb_panel->user_ctx;
+    portEXIT_CRITICAL(&rgb_panel->lock);
+    if (report && on_frame_done) {
+        on_frame_done(&rgb_panel->base, rgb_panel->fbs[rgb_panel->front], user_ctx);
+    }
+    return done;
+}
+
+static void rgb_qemu_poll_frame_done(void *arg)
+{
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) arg;
+    if (rgb_qemu_check_frame_done(rgb_panel)) {
+        esp_timer_stop(rgb_panel->poll_timer);
+    }
+}
+
+/* Starts transmitting the window, whose pixels are packed in content, once the previous update is over */
+static void rgb_qemu_start_update(esp_rgb_qemu_t *rgb_panel, int x_start, int y_start, int x_end, int y_end, const void *content)
+{
+    while (!rgb_qemu_check_frame_done(rgb_panel)) {}
     s_rgb_dev->update_from.x = x_start;
     s_rgb_dev->update_from.y = y_start;
     /* The rendering WON'T include end (x,y) coordinates  */
     s_rgb_dev->update_to.x = x_end;
     s_rgb_dev->update_to.y = y_end;
-    s_rgb_dev->update_content = (void *) color_data;
+    s_rgb_dev->update_content = (void *) content;
     s_rgb_dev->update_st.ena = 1;
+}
+
+/* Transmits the window, whose pixels are packed in content */
+static void rgb_qemu_update(esp_rgb_qemu_t *rgb_panel, int x_start, int y_start, int x_end, int y_end, const void *content)
+{
+    rgb_qemu_start_update(rgb_panel, x_start, y_start, x_end, y_end, content);
     /* Wait for the driver to finish updating the window to avoid screen tearing effect.
      * This issue is on the ESP32 QEMU target (making this loop necessary) but not on the ESP32-C3. */
     while (s_rgb_dev->update_st.ena == 1) {}
+}
 
-    (void) rgb_panel;
+static esp_err_t rgb_qemu_del(esp_lcd_panel_t *panel)
+{
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
+    if (rgb_panel->poll_timer) {
+        /* The second frame buffer may still be being transmitted */
+        while (s_rgb_dev->update_st.ena == 1) {}
+        esp_timer_stop(rgb_panel->poll_timer);
+        esp_timer_delete(rgb_panel->poll_timer);
+    }
+    free(rgb_panel->fbs[1]);
+    free(panel);
+    return ESP_OK;
+}
+
+static esp_err_t rgb_qemu_reset(esp_lcd_panel_t *panel)
+{
+    return ESP_OK;
+}
+
+static esp_err_t rgb_qemu_init(esp_lcd_panel_t *panel)
+{
+    return ESP_OK;
+}
+
+static esp_err_t rgb_qemu_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start, int x_end, int y_end, const void *color_data)
+{
+    esp_rgb_qemu_t *rgb_panel = (esp_rgb_qemu_t *) panel;
+    assert((x_start < x_end) && (y_start < y_end) && "start position must be smaller than end position");
+    const size_t stride = rgb_panel->width * rgb_panel->bytes_per_pixel;
+    const size_t window_offset = y_start * stride + x_start * rgb_panel->bytes_per_pixel;
+    /* When the pixels are already at their place in a frame buffer, given either as the frame buffer as a whole
+     * or as the address of the window in it, they aren't packed in a separate buffer. The rows of the frame buffer
+     * are contiguous, so the full-width band covering the window is transmitted from the frame buffer directly. */
+    for (uint32_t i = 0; i < rgb_panel->num_fbs; i++) {
+        const uint8_t *fb = (const uint8_t *) rgb_panel->fbs[i];
+        if (color_data == fb || color_data == fb + window_offset) {
+            rgb_qemu_update(rgb_panel, 0, y_start, rgb_panel->width, y_end, fb + y_start * stride);
+            return ESP_OK;
+        }
+    }
+    rgb_qemu_update(rgb_panel, x_start, y_start, x_end, y_end, color_data);
     return ESP_OK;
 }
 
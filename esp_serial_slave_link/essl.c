@@ -7,6 +7,8 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
 
 #include "essl.h"
 #include "essl_internal.h"
@@ -28,6 +30,16 @@
 
 #define ESSL_MIN(a, b)   ((a) < (b) ? (a) : (b))
 
+#define ESSL_EVENT_LOOP_WAIT_MS     100 // Period the event loop checks whether it's being stopped, and timeout of its transfers
+
+struct essl_event_loop_t {
+    essl_handle_t handle;
+    essl_event_loop_config_t config;
+    uint8_t *rx_buffer;
+    SemaphoreHandle_t exit_sem;     // Given by the task when it exits
+    volatile bool stop;
+};
+
 __attribute__((unused)) static const char TAG[] = "esp_serial_slave_link";
 
 #define _CHECK_EXECUTE_CMD(DEV, CMD, STR, ...) do{ \
@@ -139,6 +151,117 @@ esp_err_t essl_get_packet(essl_handle_t handle, void *out_data, size_t size, siz
     return ESP_OK;
 }
 
+esp_err_t essl_send_packets(essl_handle_t handle, const essl_tx_packet_t *packets, size_t num, size_t *out_sent, uint32_t wait_ms)
+{
+    if (handle == NULL || packets == NULL || num == 0 || out_sent == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < num; i++) {
+        if (packets[i].start == NULL || packets[i].length == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (handle->send_packet == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t err = ESP_OK;
+    const uint32_t timeout_ticks = pdMS_TO_TICKS(wait_ms);
+
+    uint32_t pre = xTaskGetTickCount();
+    uint32_t now;
+    uint32_t remain_wait_ms = 0;
+    size_t sent = 0;
+
+    /* The device only reads the TX buffer num from the slave when the number known by the master doesn't cover the
+     * packet, so the packets go out back to back as long as the slave has loaded enough buffers.
+     */
+    while (sent < num) {
+        now = xTaskGetTickCount();
+        remain_wait_ms = pdTICKS_TO_MS(TIME_REMAIN(pre, now, timeout_ticks));
+        err = handle->send_packet(handle->args, packets[sent].start, packets[sent].length, remain_wait_ms);
+        if (err == ESP_OK) {
+            sent++;
+        } else if (err != ESP_ERR_NOT_FOUND || remain_wait_ms == 0) {
+            break;
+        } // else ESP_ERR_NOT_FOUND, the slave is not ready, retry
+    }
+    *out_sent = sent;
+    return err;
+}
+
+esp_err_t essl_get_packets(essl_handle_t handle, essl_rx_packet_t *packets, size_t num, size_t *out_num, uint32_t wait_ms)
+{
+    if (handle == NULL || packets == NULL || num == 0 || out_num == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < num; i++) {
+        if (packets[i].out_data == NULL || packets[i].size == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (handle->get_packet == NULL || handle->update_rx_data_size == NULL || handle->get_rx_data_size == NULL) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t err = ESP_OK;
+    const uint32_t timeout_ticks = pdMS_TO_TICKS(wait_ms);
+
+    uint32_t pre = xTaskGetTickCount();
+    uint32_t now;
+    uint32_t wait_remain_ms = 0;
+    size_t filled = 0;
+    uint32_t data_available = handle->get_rx_data_size(handle->args);
+
+    *out_num = 0;
+    if (data_available == 0) {
+        //loop until timeout, or there is at least one byte
+        do {
+            now = xTaskGetTickCount();
+            wait_remain_ms = pdTICKS_TO_MS(TIME_REMAIN(pre, now, timeout_ticks));
+            err = handle->update_rx_data_size(handle->args, wait_remain_ms);
+            if (err != ESP_OK) {
+                return err;
+            }
+            data_available = handle->get_rx_data_size(handle->args);
+        } while (data_available == 0 && wait_remain_ms > 0);
+    }
+    if (data_available == 0) {
+        //the slave has no data to send
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    while (filled < num) {
+        if (data_available == 0) {
+            // The data known by the master has all been read, only check for more now
+            err = handle->update_rx_data_size(handle->args, 0);
+            if (err != ESP_OK) {
+                break;
+            }
+            data_available = handle->get_rx_data_size(handle->args);
+            if (data_available == 0) {
+                break;
+            }
+        }
+        essl_rx_packet_t *packet = &packets[filled];
+        size_t len = ESSL_MIN(data_available, packet->size);
+        // The length is covered by the RX data size known by the master, the device doesn't read it again
+        err = handle->get_packet(handle->args, packet->out_data, len, 0);
+        if (err != ESP_OK) {
+            break;
+        }
+        packet->out_length = len;
+        data_available -= len;
+        filled++;
+        if (len < packet->size) {
+            break;
+        }
+    }
+    *out_num = filled;
+    if (err != ESP_OK) {
+        return err;
+    }
+    return (filled == num && data_available > 0) ? ESP_ERR_NOT_FINISHED : ESP_OK;
+}
+
 esp_err_t essl_get_tx_buffer_num(essl_handle_t handle, uint32_t *out_tx_num, uint32_t wait_ms)
 {
     if (handle == NULL || out_tx_num == NULL) {
@@ -232,3 +355,151 @@ esp_err_t essl_send_slave_intr(essl_handle_t handle, uint32_t intr_mask, uint32_
 {
     CHECK_EXECUTE_CMD(handle, send_slave_intr, intr_mask, wait_ms);
 }
+
+static esp_err_t essl_event_loop_handle_intr(essl_event_loop_handle_t loop)
+{
+    essl_handle_t handle = loop->handle;
+    const essl_event_loop_config_t *config = &loop->config;
+    uint32_t intr_st = 0;
+    esp_err_t err;
+
+    /* Clear the RX interrupt before reading the RX data size: the data loaded by the slave after the reading raises it
+     * again, and is received after the next interrupt, without polling the RX data size once more after the data.
+     */
+    err = handle->clear_intr(handle->args, config->rx_intr_mask, ESSL_EVENT_LOOP_WAIT_MS);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (handle->get_intr_rx_size) {
+        err = handle->get_intr_rx_size(handle->args, &intr_st, ESSL_EVENT_LOOP_WAIT_MS);
+    } else {
+        err = handle->get_intr(handle->args, NULL, &intr_st, ESSL_EVENT_LOOP_WAIT_MS);
+        if (err == ESP_OK) {
+            err = handle->update_rx_data_size(handle->args, ESSL_EVENT_LOOP_WAIT_MS);
+        }
+    }
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    // The other interrupts are cleared before the callback, or the slave would keep the interrupt line active
+    intr_st &= ~config->rx_intr_mask;
+    if (intr_st) {
+        err = handle->clear_intr(handle->args, intr_st, ESSL_EVENT_LOOP_WAIT_MS);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (config->on_intr) {
+            config->on_intr(handle, intr_st, config->user_ctx);
+        }
+    }
+
+    // The RX data size is known, the data is read without polling it again
+    uint32_t data_available;
+    while ((data_available = handle->get_rx_data_size(handle->args)) > 0 && !loop->stop) {
+        size_t len = ESSL_MIN(data_available, config->rx_buffer_size);
+        err = handle->get_packet(handle->args, loop->rx_buffer, len, ESSL_EVENT_LOOP_WAIT_MS);
+        if (err != ESP_OK) {
+            return err;
+        }
+        config->on_rx(handle, loop->rx_buffer, len, config->user_ctx);
+    }
+    return ESP_OK;
+}
+
+static void essl_event_loop_task(void *arg)
+{
+    essl_event_loop_handle_t loop = arg;
+    essl_handle_t handle = loop->handle;
+    esp_err_t err;
+
+    while (!loop->stop) {
+        err = handle->wait_int(handle->args, ESSL_EVENT_LOOP_WAIT_MS);
+        if (err == ESP_ERR_TIMEOUT) {
+            continue;
+        }
+        if (err == ESP_OK) {
+            err = essl_event_loop_handle_intr(loop);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "event loop: %s", esp_err_to_name(err));
+            vTaskDelay(pdMS_TO_TICKS(ESSL_EVENT_LOOP_WAIT_MS));
+        }
+    }
+    xSemaphoreGive(loop->exit_sem);
+    vTaskDelete(NULL);
+}
+
+static void essl_event_loop_free(essl_event_loop_handle_t loop)
+{
+    if (loop->exit_sem) {
+        vSemaphoreDelete(loop->exit_sem);
+    }
+    free(loop->rx_buffer);
+    free(loop);
+}
+
+esp_err_t essl_event_loop_start(essl_handle_t handle, const essl_event_loop_config_t *config, essl_event_loop_handle_t *out_loop)
+{
+    if (handle == NULL || config == NULL || out_loop == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->rx_intr_mask == 0 || config->rx_buffer_size == 0 || config->on_rx == NULL || config->task_stack_size == 0
+            || (config->intr_mask != 0 && config->on_intr == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (handle->wait_int == NULL || handle->clear_intr == NULL || handle->get_packet == NULL || handle->get_rx_data_size == NULL
+            || (handle->get_intr_rx_size == NULL && (handle->get_intr == NULL || handle->update_rx_data_size == NULL))) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    esp_err_t err;
+
+    essl_event_loop_handle_t loop = calloc(1, sizeof(struct essl_event_loop_t));
+    if (loop == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    loop->handle = handle;
+    loop->config = *config;
+    // The data is read in words aligned to 4 bytes, by DMA
+    loop->rx_buffer = heap_caps_malloc((config->rx_buffer_size + 3) & (~3), MALLOC_CAP_DMA);
+    loop->exit_sem = xSemaphoreCreateBinary();
+    if (loop->rx_buffer == NULL || loop->exit_sem == NULL) {
+        err = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    if (handle->enable_int) {
+        err = handle->enable_int(handle->args);
+        if (err != ESP_OK) {
+            goto cleanup;
+        }
+    }
+    if (handle->set_intr_ena) {
+        err = handle->set_intr_ena(handle->args, config->rx_intr_mask | config->intr_mask, ESSL_EVENT_LOOP_WAIT_MS);
+        if (err != ESP_OK) {
+            goto cleanup;
+        }
+    }
+
+    if (xTaskCreate(essl_event_loop_task, "essl_event", config->task_stack_size, loop, config->task_priority, NULL) != pdPASS) {
+        err = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+    *out_loop = loop;
+    return ESP_OK;
+
+cleanup:
+    essl_event_loop_free(loop);
+    return err;
+}
+
+esp_err_t essl_event_loop_stop(essl_event_loop_handle_t loop)
+{
+    if (loop == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    loop->stop = true;
+    xSemaphoreTake(loop->exit_sem, portMAX_DELAY);
+    essl_event_loop_free(loop);
+    return ESP_OK;
+}
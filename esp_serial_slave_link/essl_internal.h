@@ -29,6 +29,8 @@ struct essl_dev_t {
     esp_err_t (*set_intr_ena)(void *ctx, uint32_t ena_mask, uint32_t wait_ms);
     esp_err_t (*get_intr_ena)(void *ctx, uint32_t *ena_mask_o, uint32_t wait_ms);
     esp_err_t (*send_slave_intr)(void *ctx, uint32_t intr_mask, uint32_t wait_ms);
+    esp_err_t (*enable_int)(void *ctx);
+    esp_err_t (*get_intr_rx_size)(void *ctx, uint32_t *intr_st, uint32_t wait_ms);
 
     uint32_t (*get_tx_buffer_num)(void *ctx);
     uint32_t (*get_rx_data_size)(void *ctx);
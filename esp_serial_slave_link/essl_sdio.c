@@ -60,6 +60,8 @@ static const char TAG[] = "essl_sdio";
     .clear_intr = essl_sdio_clear_intr, \
     .set_intr_ena = essl_sdio_set_intr_ena, \
     .reset_cnt = essl_sdio_reset_cnt, \
+    .enable_int = essl_sdio_enable_int, \
+    .get_intr_rx_size = essl_sdio_get_intr_rx_size, \
     }
 
 typedef struct {
@@ -501,6 +503,28 @@ esp_err_t essl_sdio_wait_int(void *arg, uint32_t wait_ms)
     return sdmmc_io_wait_int(((essl_sdio_context_t *)arg)->card, wait_ms);
 }
 
+esp_err_t essl_sdio_enable_int(void *arg)
+{
+    return sdmmc_io_enable_int(((essl_sdio_context_t *)arg)->card);
+}
+
+esp_err_t essl_sdio_get_intr_rx_size(void *arg, uint32_t *intr_st, uint32_t wait_ms)
+{
+    essl_sdio_context_t *ctx = arg;
+    // INT_ST, SLC1HOST_INT_ST and PKT_LEN are read in one CMD53
+    uint32_t regs[(HOST_SLCHOST_PKT_LEN_REG - HOST_SLC0HOST_INT_ST_REG) / 4 + 1];
+    esp_err_t err;
+
+    ESP_LOGV(TAG, "get_intr_rx_size");
+    err = essl_sdio_read_bytes(ctx->card, HOST_SLC0HOST_INT_ST_REG, (uint8_t *) regs, sizeof(regs));
+    if (err != ESP_OK) {
+        return err;
+    }
+    *intr_st = regs[0];
+    ctx->rx_got_bytes_latest = regs[(HOST_SLCHOST_PKT_LEN_REG - HOST_SLC0HOST_INT_ST_REG) / 4] & RX_BYTE_MASK;
+    return ESP_OK;
+}
+
 void essl_sdio_reset_cnt(void *arg)
 {
     essl_sdio_context_t *ctx = arg;
@@ -0,0 +1,694 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "essl_internal.h"
+#include "essl_sim.h"
+
+static const char TAG[] = "essl_sim";
+
+// Same ranges as the counters of the SDIO slave
+#define TX_BUFFER_MAX   0x1000
+#define RX_BYTE_MAX     0x100000
+
+#define SIM_INTR_MASK   0x00FFFFFF
+
+/**
+ * Initialize ``essl_dev_t`` with the simulated slave by this macro.
+ */
+#define ESSL_SIM_DEFAULT_CONTEXT() (essl_dev_t){\
+    .init = essl_sim_init, \
+    .wait_for_ready = essl_sim_wait_for_ready, \
+    .get_tx_buffer_num = essl_sim_get_tx_buffer_num,\
+    .update_tx_buffer_num = essl_sim_update_tx_buffer_num,\
+    .get_rx_data_size = essl_sim_get_rx_data_size,\
+    .update_rx_data_size = essl_sim_update_rx_data_size,\
+    .send_packet = essl_sim_send_packet,\
+    .get_packet = essl_sim_get_packet,\
+    .write_reg = essl_sim_write_reg,\
+    .read_reg = essl_sim_read_reg,\
+    .wait_int = essl_sim_wait_int,\
+    .send_slave_intr = essl_sim_send_slave_intr, \
+    .get_intr = essl_sim_get_intr, \
+    .clear_intr = essl_sim_clear_intr, \
+    .set_intr_ena = essl_sim_set_intr_ena, \
+    .get_intr_ena = essl_sim_get_intr_ena, \
+    .reset_cnt = essl_sim_reset_cnt, \
+    .enable_int = essl_sim_enable_int, \
+    .get_intr_rx_size = essl_sim_get_intr_rx_size, \
+    }
+
+typedef struct sim_packet_t {
+    struct sim_packet_t *next;
+    size_t length;
+    uint8_t data[];
+} sim_packet_t;
+
+typedef struct {
+    //master side, as essl_sdio_context_t
+    size_t          buffer_size;
+    size_t          tx_sent_buffers;        ///< Counter holding the amount of buffers already sent to the slave.
+    size_t          tx_sent_buffers_latest; ///< The latest reading (from the slave) of counter holding the amount of buffers loaded.
+    size_t          rx_got_bytes;           ///< Counter holding the amount of bytes already received from the slave.
+    size_t          rx_got_bytes_latest;    ///< The latest reading (from the slave) of counter holding the amount of bytes to send.
+
+    //slave side
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t intr_sem;             ///< Given when an enabled interrupt is raised
+    size_t          buffers_loaded;         ///< Counter of the buffers loaded, read as ``tx_sent_buffers_latest``
+    size_t          buffers_used;           ///< Counter of the buffers used by the packets of the master
+    size_t          bytes_loaded;           ///< Counter of the bytes loaded, read as ``rx_got_bytes_latest``
+    uint8_t        *rx_fifo;                ///< Ring of the bytes loaded and not read by the master
+    size_t          rx_fifo_size;
+    size_t          rx_fifo_head;
+    size_t          rx_fifo_len;
+    sim_packet_t   *tx_head;                ///< Packets sent by the master, oldest first
+    sim_packet_t   *tx_tail;
+    uint32_t        intr_raw;
+    uint32_t        intr_ena;
+    uint32_t        slave_intr;
+    uint8_t         regs[ESSL_SIM_REG_NUM];
+
+    //bus model
+    uint32_t        transaction_latency_us;
+    uint32_t        byte_time_ns;
+    bool            real_time;
+    essl_sim_stats_t stats;
+    uint64_t        bus_time_ns;
+} essl_sim_context_t;
+
+static esp_err_t essl_sim_init(void *arg, uint32_t wait_ms);
+static esp_err_t essl_sim_wait_for_ready(void *arg, uint32_t wait_ms);
+static uint32_t essl_sim_get_tx_buffer_num(void *arg);
+static esp_err_t essl_sim_update_tx_buffer_num(void *arg, uint32_t wait_ms);
+static uint32_t essl_sim_get_rx_data_size(void *arg);
+static esp_err_t essl_sim_update_rx_data_size(void *arg, uint32_t wait_ms);
+static esp_err_t essl_sim_send_packet(void *arg, const void *start, size_t length, uint32_t wait_ms);
+static esp_err_t essl_sim_get_packet(void *arg, void *out_data, size_t size, uint32_t wait_ms);
+static esp_err_t essl_sim_write_reg(void *arg, uint8_t addr, uint8_t value, uint8_t *value_o, uint32_t wait_ms);
+static esp_err_t essl_sim_read_reg(void *arg, uint8_t add, uint8_t *value_o, uint32_t wait_ms);
+static esp_err_t essl_sim_wait_int(void *arg, uint32_t wait_ms);
+static esp_err_t essl_sim_send_slave_intr(void *arg, uint32_t intr_mask, uint32_t wait_ms);
+static esp_err_t essl_sim_get_intr(void *arg, uint32_t *intr_raw, uint32_t *intr_st, uint32_t wait_ms);
+static esp_err_t essl_sim_clear_intr(void *arg, uint32_t intr_mask, uint32_t wait_ms);
+static esp_err_t essl_sim_set_intr_ena(void *arg, uint32_t ena_mask, uint32_t wait_ms);
+static esp_err_t essl_sim_get_intr_ena(void *arg, uint32_t *ena_mask_o, uint32_t wait_ms);
+static void essl_sim_reset_cnt(void *arg);
+static esp_err_t essl_sim_enable_int(void *arg);
+static esp_err_t essl_sim_get_intr_rx_size(void *arg, uint32_t *intr_st, uint32_t wait_ms);
+
+static inline essl_sim_context_t *sim_ctx(essl_handle_t handle)
+{
+    return (handle && handle->init == essl_sim_init) ? handle->args : NULL;
+}
+
+// Account one bus transaction of the master moving `bytes` bytes, called without the lock
+static void sim_transaction(essl_sim_context_t *ctx, size_t bytes)
+{
+    uint64_t time_ns = (uint64_t)ctx->transaction_latency_us * 1000 + (uint64_t)bytes * ctx->byte_time_ns;
+
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->stats.transactions++;
+    ctx->bus_time_ns += time_ns;
+    xSemaphoreGive(ctx->lock);
+
+    if (ctx->real_time && time_ns >= 1000) {
+        esp_rom_delay_us(time_ns / 1000);
+    }
+}
+
+// Called with the lock held after the raw or enabled interrupts change
+static inline void sim_update_intr(essl_sim_context_t *ctx)
+{
+    if (ctx->intr_raw & ctx->intr_ena) {
+        xSemaphoreGive(ctx->intr_sem);
+    }
+}
+
+static void sim_free_data(essl_sim_context_t *ctx)
+{
+    while (ctx->tx_head) {
+        sim_packet_t *next = ctx->tx_head->next;
+        free(ctx->tx_head);
+        ctx->tx_head = next;
+    }
+    ctx->tx_tail = NULL;
+    ctx->rx_fifo_head = 0;
+    ctx->rx_fifo_len = 0;
+}
+
+esp_err_t essl_sim_init_dev(essl_handle_t *out_handle, const essl_sim_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    essl_sim_context_t *arg = NULL;
+    essl_dev_t *dev = NULL;
+
+    if (out_handle == NULL || config == NULL || config->recv_buffer_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    arg = (essl_sim_context_t *)heap_caps_calloc(1, sizeof(essl_sim_context_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    dev = (essl_dev_t *)heap_caps_calloc(1, sizeof(essl_dev_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (arg == NULL || dev == NULL) {
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    arg->lock = xSemaphoreCreateMutex();
+    arg->intr_sem = xSemaphoreCreateBinary();
+    if (arg->lock == NULL || arg->intr_sem == NULL) {
+        ret = ESP_ERR_NO_MEM;
+        goto cleanup;
+    }
+
+    *dev = ESSL_SIM_DEFAULT_CONTEXT();
+    dev->args = arg;
+
+    arg->buffer_size = config->recv_buffer_size;
+    arg->transaction_latency_us = config->transaction_latency_us;
+    arg->byte_time_ns = config->byte_time_ns;
+    arg->real_time = config->real_time;
+
+    *out_handle = dev;
+    return ESP_OK;
+
+cleanup:
+    if (arg) {
+        if (arg->lock) {
+            vSemaphoreDelete(arg->lock);
+        }
+        if (arg->intr_sem) {
+            vSemaphoreDelete(arg->intr_sem);
+        }
+    }
+    free(arg);
+    free(dev);
+    return ret;
+}
+
+esp_err_t essl_sim_deinit_dev(essl_handle_t handle)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_free_data(ctx);
+    free(ctx->rx_fifo);
+    vSemaphoreDelete(ctx->lock);
+    vSemaphoreDelete(ctx->intr_sem);
+    free(ctx);
+    free(handle);
+    return ESP_OK;
+}
+
+/*---------------------------------------------------------------------------
+ *                  Master side
+ *--------------------------------------------------------------------------*/
+
+static esp_err_t essl_sim_init(void *arg, uint32_t wait_ms)
+{
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_wait_for_ready(void *arg, uint32_t wait_ms)
+{
+    return ESP_OK;
+}
+
+static uint32_t essl_sim_get_tx_buffer_num(void *arg)
+{
+    essl_sim_context_t *ctx = arg;
+    return (ctx->tx_sent_buffers_latest + TX_BUFFER_MAX - ctx->tx_sent_buffers) % TX_BUFFER_MAX;
+}
+
+static esp_err_t essl_sim_update_tx_buffer_num(void *arg, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+
+    sim_transaction(ctx, 4);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->tx_sent_buffers_latest = ctx->buffers_loaded;
+    ctx->stats.tx_buffer_num_reads++;
+    xSemaphoreGive(ctx->lock);
+    ESP_LOGV(TAG, "update_tx_buffer_num: %d", (unsigned int)ctx->tx_sent_buffers_latest);
+    return ESP_OK;
+}
+
+static uint32_t essl_sim_get_rx_data_size(void *arg)
+{
+    essl_sim_context_t *ctx = arg;
+    return (ctx->rx_got_bytes_latest + RX_BYTE_MAX - ctx->rx_got_bytes) % RX_BYTE_MAX;
+}
+
+static esp_err_t essl_sim_update_rx_data_size(void *arg, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+
+    sim_transaction(ctx, 4);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->rx_got_bytes_latest = ctx->bytes_loaded;
+    ctx->stats.rx_data_size_reads++;
+    xSemaphoreGive(ctx->lock);
+    ESP_LOGV(TAG, "update_rx_data_size: %d", (unsigned int)ctx->rx_got_bytes_latest);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_send_packet(void *arg, const void *start, size_t length, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    size_t buffer_used = (length + ctx->buffer_size - 1) / ctx->buffer_size;
+
+    if (essl_sim_get_tx_buffer_num(arg) < buffer_used) {
+        //slave has no enough buffer, try update for once
+        esp_err_t err = essl_sim_update_tx_buffer_num(arg, wait_ms);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (essl_sim_get_tx_buffer_num(arg) < buffer_used) {
+            ESP_LOGV(TAG, "buffer is not enough: %d, %d required.", (int)ctx->tx_sent_buffers_latest, (int)(ctx->tx_sent_buffers + buffer_used));
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+
+    sim_packet_t *packet = malloc(sizeof(sim_packet_t) + length);
+    if (packet == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    packet->next = NULL;
+    packet->length = length;
+    memcpy(packet->data, start, length);
+
+    sim_transaction(ctx, (length + 3) & (~3));
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    // The check above trusts the counters of the master, the slave checks its own
+    if ((ctx->buffers_loaded + TX_BUFFER_MAX - ctx->buffers_used) % TX_BUFFER_MAX < buffer_used) {
+        ctx->stats.overruns++;
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        ctx->buffers_used = (ctx->buffers_used + buffer_used) % TX_BUFFER_MAX;
+        if (ctx->tx_tail) {
+            ctx->tx_tail->next = packet;
+        } else {
+            ctx->tx_head = packet;
+        }
+        ctx->tx_tail = packet;
+        ctx->stats.packets_sent++;
+        ctx->stats.bytes_sent += length;
+    }
+    xSemaphoreGive(ctx->lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "packet of %d buffers sent without enough buffers loaded by the slave", (int)buffer_used);
+        free(packet);
+        return ret;
+    }
+    ctx->tx_sent_buffers += buffer_used;
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_get_packet(void *arg, void *out_data, size_t size, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    esp_err_t err;
+
+    ESP_LOGV(TAG, "get_packet: read size=%d", (int)size);
+    if (essl_sim_get_rx_data_size(arg) < size) {
+        err = essl_sim_update_rx_data_size(arg, wait_ms);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (essl_sim_get_rx_data_size(arg) < size) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+
+    sim_transaction(ctx, (size + 3) & (~3));
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    if (ctx->rx_fifo_len < size) {
+        ctx->stats.overruns++;
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        uint8_t *out = out_data;
+        size_t first = MIN(size, ctx->rx_fifo_size - ctx->rx_fifo_head);
+        memcpy(out, ctx->rx_fifo + ctx->rx_fifo_head, first);
+        memcpy(out + first, ctx->rx_fifo, size - first);
+        ctx->rx_fifo_head = (ctx->rx_fifo_head + size) % ctx->rx_fifo_size;
+        ctx->rx_fifo_len -= size;
+        ctx->stats.packets_received++;
+        ctx->stats.bytes_received += size;
+    }
+    xSemaphoreGive(ctx->lock);
+
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "read of %d bytes without enough data loaded by the slave", (int)size);
+        return ret;
+    }
+    ctx->rx_got_bytes += size;
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_write_reg(void *arg, uint8_t addr, uint8_t value, uint8_t *value_o, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    if (addr >= ESSL_SIM_REG_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_transaction(ctx, 1);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->regs[addr] = value;
+    xSemaphoreGive(ctx->lock);
+    if (value_o) {
+        *value_o = value;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_read_reg(void *arg, uint8_t add, uint8_t *value_o, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    if (add >= ESSL_SIM_REG_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_transaction(ctx, 1);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *value_o = ctx->regs[add];
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_wait_int(void *arg, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t wait_ticks = (wait_ms == portMAX_DELAY) ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+
+    while (true) {
+        xSemaphoreTake(ctx->lock, portMAX_DELAY);
+        bool raised = (ctx->intr_raw & ctx->intr_ena) != 0;
+        xSemaphoreGive(ctx->lock);
+        if (raised) {
+            return ESP_OK;
+        }
+
+        // the semaphore may have been given for interrupts cleared since, check again after each take
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (wait_ticks != portMAX_DELAY && elapsed >= wait_ticks) {
+            return ESP_ERR_TIMEOUT;
+        }
+        if (xSemaphoreTake(ctx->intr_sem, wait_ticks == portMAX_DELAY ? portMAX_DELAY : wait_ticks - elapsed) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+}
+
+static esp_err_t essl_sim_send_slave_intr(void *arg, uint32_t intr_mask, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    //Only 8 bits available, as for SDIO
+    sim_transaction(ctx, 1);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->slave_intr |= (uint8_t)intr_mask;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_get_intr(void *arg, uint32_t *intr_raw, uint32_t *intr_st, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    if (intr_raw == NULL && intr_st == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (intr_raw != NULL) {
+        sim_transaction(ctx, 4);
+        xSemaphoreTake(ctx->lock, portMAX_DELAY);
+        *intr_raw = ctx->intr_raw;
+        xSemaphoreGive(ctx->lock);
+    }
+    if (intr_st != NULL) {
+        sim_transaction(ctx, 4);
+        xSemaphoreTake(ctx->lock, portMAX_DELAY);
+        *intr_st = ctx->intr_raw & ctx->intr_ena;
+        xSemaphoreGive(ctx->lock);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_clear_intr(void *arg, uint32_t intr_mask, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    sim_transaction(ctx, 4);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->intr_raw &= ~intr_mask;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_set_intr_ena(void *arg, uint32_t ena_mask, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    sim_transaction(ctx, 4);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->intr_ena = ena_mask & SIM_INTR_MASK;
+    sim_update_intr(ctx);
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_get_intr_ena(void *arg, uint32_t *ena_mask_o, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    sim_transaction(ctx, 4);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *ena_mask_o = ctx->intr_ena;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_enable_int(void *arg)
+{
+    return ESP_OK;
+}
+
+static esp_err_t essl_sim_get_intr_rx_size(void *arg, uint32_t *intr_st, uint32_t wait_ms)
+{
+    essl_sim_context_t *ctx = arg;
+    // The interrupt status and the RX data size are read in one transaction, as for SDIO
+    sim_transaction(ctx, 16);
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *intr_st = ctx->intr_raw & ctx->intr_ena;
+    ctx->rx_got_bytes_latest = ctx->bytes_loaded;
+    ctx->stats.rx_data_size_reads++;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+// Resets the counters of both sides, as when the slave restarts, and drops the data in flight
+static void essl_sim_reset_cnt(void *arg)
+{
+    essl_sim_context_t *ctx = arg;
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    sim_free_data(ctx);
+    ctx->buffers_loaded = 0;
+    ctx->buffers_used = 0;
+    ctx->bytes_loaded = 0;
+    xSemaphoreGive(ctx->lock);
+    ctx->tx_sent_buffers = 0;
+    ctx->tx_sent_buffers_latest = 0;
+    ctx->rx_got_bytes = 0;
+    ctx->rx_got_bytes_latest = 0;
+}
+
+/*---------------------------------------------------------------------------
+ *                  Slave side
+ *--------------------------------------------------------------------------*/
+
+esp_err_t essl_sim_slave_load_buffers(essl_handle_t handle, uint32_t num)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->buffers_loaded = (ctx->buffers_loaded + num) % TX_BUFFER_MAX;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+// Called with the lock held, makes room for `length` more bytes in the RX fifo
+static esp_err_t sim_rx_fifo_reserve(essl_sim_context_t *ctx, size_t length)
+{
+    size_t needed = ctx->rx_fifo_len + length;
+    if (needed <= ctx->rx_fifo_size) {
+        return ESP_OK;
+    }
+    size_t new_size = ctx->rx_fifo_size ? ctx->rx_fifo_size : 1024;
+    while (new_size < needed) {
+        new_size *= 2;
+    }
+    uint8_t *fifo = malloc(new_size);
+    if (fifo == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    if (ctx->rx_fifo_len) {
+        size_t first = MIN(ctx->rx_fifo_len, ctx->rx_fifo_size - ctx->rx_fifo_head);
+        memcpy(fifo, ctx->rx_fifo + ctx->rx_fifo_head, first);
+        memcpy(fifo + first, ctx->rx_fifo, ctx->rx_fifo_len - first);
+    }
+    free(ctx->rx_fifo);
+    ctx->rx_fifo = fifo;
+    ctx->rx_fifo_size = new_size;
+    ctx->rx_fifo_head = 0;
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_slave_send(essl_handle_t handle, const void *data, size_t length)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || (data == NULL && length != 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    if (ctx->rx_fifo_len + length >= RX_BYTE_MAX) {
+        // the master couldn't tell the data in flight from none
+        ret = ESP_ERR_INVALID_SIZE;
+    } else {
+        ret = sim_rx_fifo_reserve(ctx, length);
+    }
+    if (ret == ESP_OK) {
+        size_t tail = (ctx->rx_fifo_head + ctx->rx_fifo_len) % ctx->rx_fifo_size;
+        size_t first = MIN(length, ctx->rx_fifo_size - tail);
+        memcpy(ctx->rx_fifo + tail, data, first);
+        memcpy(ctx->rx_fifo, (const uint8_t *)data + first, length - first);
+        ctx->rx_fifo_len += length;
+        ctx->bytes_loaded = (ctx->bytes_loaded + length) % RX_BYTE_MAX;
+        ctx->intr_raw |= ESSL_SIM_NEW_PACKET_INTR_MASK;
+        sim_update_intr(ctx);
+    }
+    xSemaphoreGive(ctx->lock);
+    return ret;
+}
+
+esp_err_t essl_sim_slave_recv(essl_handle_t handle, void *out_data, size_t size, size_t *out_length)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || out_data == NULL || out_length == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = ESP_OK;
+    sim_packet_t *packet = NULL;
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    if (ctx->tx_head == NULL) {
+        ret = ESP_ERR_NOT_FOUND;
+    } else if (ctx->tx_head->length > size) {
+        *out_length = ctx->tx_head->length;
+        ret = ESP_ERR_INVALID_SIZE;
+    } else {
+        packet = ctx->tx_head;
+        ctx->tx_head = packet->next;
+        if (ctx->tx_head == NULL) {
+            ctx->tx_tail = NULL;
+        }
+    }
+    xSemaphoreGive(ctx->lock);
+
+    if (packet) {
+        memcpy(out_data, packet->data, packet->length);
+        *out_length = packet->length;
+        free(packet);
+    }
+    return ret;
+}
+
+esp_err_t essl_sim_slave_send_intr(essl_handle_t handle, uint32_t intr_mask)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->intr_raw |= intr_mask & SIM_INTR_MASK;
+    sim_update_intr(ctx);
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_slave_get_intr(essl_handle_t handle, uint32_t *out_intr)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || out_intr == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *out_intr = ctx->slave_intr;
+    ctx->slave_intr = 0;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_slave_read_reg(essl_handle_t handle, uint8_t addr, uint8_t *out_value)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || out_value == NULL || addr >= ESSL_SIM_REG_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *out_value = ctx->regs[addr];
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_slave_write_reg(essl_handle_t handle, uint8_t addr, uint8_t value)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || addr >= ESSL_SIM_REG_NUM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    ctx->regs[addr] = value;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_get_stats(essl_handle_t handle, essl_sim_stats_t *out_stats)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL || out_stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    *out_stats = ctx->stats;
+    out_stats->bus_time_us = ctx->bus_time_ns / 1000;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
+
+esp_err_t essl_sim_reset_stats(essl_handle_t handle)
+{
+    essl_sim_context_t *ctx = sim_ctx(handle);
+    if (ctx == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(ctx->lock, portMAX_DELAY);
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    ctx->bus_time_ns = 0;
+    xSemaphoreGive(ctx->lock);
+    return ESP_OK;
+}
@@ -249,6 +249,87 @@ esp_err_t essl_spi_wrdma(spi_device_handle_t spi, const uint8_t *data, int len,
     return essl_spi_wrdma_done(spi, flags);
 }
 
+/* Queue one transaction for each segment and one for the done command, keeping up to ESSL_SPI_DMA_IOV_QUEUE_DEPTH of
+ * them in the driver so that the next segment starts as soon as the previous one is finished.
+ */
+static esp_err_t essl_spi_dma_iov(spi_device_handle_t spi, spi_command_t cmd, spi_command_t done_cmd, bool is_rx,
+                                  const essl_spi_iovec_t *iov, int iovcnt, uint32_t flags)
+{
+    spi_transaction_ext_t trans[ESSL_SPI_DMA_IOV_QUEUE_DEPTH];
+    spi_transaction_t *ret_trans;
+    const int total = iovcnt + 1;
+    int queued = 0;
+    int finished = 0;
+    esp_err_t ret = ESP_OK;
+
+    while (finished < total) {
+        if (ret == ESP_OK && queued < total && queued - finished < ESSL_SPI_DMA_IOV_QUEUE_DEPTH) {
+            // Transactions are finished in order, the slot of the oldest one is free again
+            spi_transaction_ext_t *t = &trans[queued % ESSL_SPI_DMA_IOV_QUEUE_DEPTH];
+            if (queued < iovcnt) {
+                *t = (spi_transaction_ext_t) {
+                    .base = {
+                        .cmd = get_hd_command(cmd, flags),
+                        .flags = flags | SPI_TRANS_VARIABLE_DUMMY,
+                    },
+                    .dummy_bits = get_hd_dummy_bits(flags),
+                };
+                if (is_rx) {
+                    t->base.rxlength = iov[queued].len * 8;
+                    t->base.rx_buffer = iov[queued].data;
+                } else {
+                    t->base.length = iov[queued].len * 8;
+                    t->base.tx_buffer = iov[queued].data;
+                }
+            } else {
+                *t = (spi_transaction_ext_t) {
+                    .base = {
+                        .cmd = get_hd_command(done_cmd, flags),
+                        .flags = flags,
+                    },
+                };
+            }
+            ret = spi_device_queue_trans(spi, &t->base, portMAX_DELAY);
+            if (ret == ESP_OK) {
+                queued++;
+                continue;
+            }
+        }
+        // Nothing more to queue for now, or queueing failed: the transactions queued must be finished before returning
+        if (finished == queued) {
+            break;
+        }
+        esp_err_t err = spi_device_get_trans_result(spi, &ret_trans, portMAX_DELAY);
+        if (err != ESP_OK) {
+            return err;
+        }
+        finished++;
+    }
+    return ret;
+}
+
+esp_err_t essl_spi_rddma_iov(spi_device_handle_t spi, const essl_spi_iovec_t *iov, int iovcnt, uint32_t flags)
+{
+    ESP_RETURN_ON_FALSE(iov && iovcnt > 0, ESP_ERR_INVALID_ARG, TAG, "No segment to receive");
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].len == 0 || !esp_ptr_dma_capable(iov[i].data) || ((intptr_t)iov[i].data % 4) != 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return essl_spi_dma_iov(spi, SPI_CMD_HD_RDDMA, SPI_CMD_HD_INT0, true, iov, iovcnt, flags);
+}
+
+esp_err_t essl_spi_wrdma_iov(spi_device_handle_t spi, const essl_spi_iovec_t *iov, int iovcnt, uint32_t flags)
+{
+    ESP_RETURN_ON_FALSE(iov && iovcnt > 0, ESP_ERR_INVALID_ARG, TAG, "No segment to send");
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].len == 0 || !esp_ptr_dma_capable(iov[i].data)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    return essl_spi_dma_iov(spi, SPI_CMD_HD_WRDMA, SPI_CMD_HD_WR_END, false, iov, iovcnt, flags);
+}
+
 esp_err_t essl_spi_int(spi_device_handle_t spi, int int_n, uint32_t flags)
 {
     spi_transaction_t end_t = {
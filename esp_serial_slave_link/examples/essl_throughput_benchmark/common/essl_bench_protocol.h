@@ -0,0 +1,30 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#pragma once
+
+/*
+ * Parameters shared by the host and the slave of the benchmark. Both sides must be built with the same values.
+ */
+
+// SDIO: size of the receiving buffers of the slave, pre-negotiated with the host
+#define BENCH_SDIO_RECV_BUF_SIZE        512
+// SDIO: number of receiving buffers loaded by the slave
+#define BENCH_SDIO_RECV_BUF_NUM         32
+// SDIO: size and number of the packets the slave keeps queued to the host
+#define BENCH_SDIO_SEND_LEN             4096
+#define BENCH_SDIO_SEND_QUEUE_SIZE      4
+// SDIO: shared register holding the command of the host, and the host interrupt telling the slave to read it
+#define BENCH_SDIO_REG_CMD              0
+#define BENCH_SDIO_INTR_CMD             0
+#define BENCH_SDIO_CMD_RESET            0x01    // Reset the counters of the slave, written back as BENCH_SDIO_CMD_DONE
+#define BENCH_SDIO_CMD_DONE             0x80
+
+// SPI: size of the DMA buffers of the slave, in both directions, and number of them appended at a time
+#define BENCH_SPI_BUF_SIZE              4096
+#define BENCH_SPI_QUEUE_SIZE            4
+// SPI: shared registers for the synchronization of the append mode, see `essl_spi_config_t`
+#define BENCH_SPI_REG_RX_BUF_NUM        0       // Number of receiving buffers loaded by the slave, `tx_sync_reg` of the host
+#define BENCH_SPI_REG_TX_BYTES          4       // Number of bytes loaded by the slave to send, `rx_sync_reg` of the host
@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <assert.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_serial_slave_link/essl.h"
+#if CONFIG_BENCH_BUS_SDIO
+#include "driver/sdmmc_host.h"
+#include "sdmmc_cmd.h"
+#include "esp_serial_slave_link/essl_sdio.h"
+#else
+#include "driver/spi_master.h"
+#include "esp_serial_slave_link/essl_spi.h"
+#endif
+#include "essl_bench_protocol.h"
+
+/*
+ * Measures the throughput from and to a slave running the slave app of this example. Every result is printed as one
+ * CSV line starting with "ESSLBENCH,":
+ *
+ *     ESSLBENCH,<bus>,<bus width>,<clock [kHz]>,<direction>,<transfer size>,<bytes>,<time [us]>,<MB/s>,<CPU load [%]>
+ *
+ * Each transfer is one call to essl_send_packet() or essl_get_packet() of the transfer size. For SDIO, the tests run
+ * with each bus width and clock frequency, the transfers of 512 bytes and more are sent in block mode. For SPI, the
+ * transfer size is the length of the DMA segments. The CPU load is measured by low priority tasks counting how much
+ * CPU time is left, on every core.
+ */
+
+#define BENCH_MAX_SIZE      4096
+#define BENCH_WAIT_MS       1000
+
+#if CONFIG_BENCH_BUS_SPI
+// Assign the GPIOs connected to the slave
+#define BENCH_SPI_HOST      SPI2_HOST
+#define BENCH_SPI_GPIO_MOSI 11
+#define BENCH_SPI_GPIO_MISO 13
+#define BENCH_SPI_GPIO_SCLK 12
+#define BENCH_SPI_GPIO_CS   10
+#endif
+
+typedef struct {
+    const char *bus;
+    int width;
+    int freq_khz;
+} bench_bus_info_t;
+
+static const char *TAG = "essl_bench";
+
+#if CONFIG_BENCH_BUS_SDIO
+static const uint32_t s_sizes[] = {64, 512, BENCH_MAX_SIZE};
+#else
+static const uint32_t s_sizes[] = {256, 1024, BENCH_MAX_SIZE};
+#endif
+static uint8_t *s_buf;
+static volatile uint32_t s_idle_count[portNUM_PROCESSORS];
+
+/* Idle priority task counting the CPU time other tasks leave */
+static void bench_idle_task(void *arg)
+{
+    volatile uint32_t *count = (volatile uint32_t *)arg;
+    while (true) {
+        (*count)++;
+    }
+}
+
+static uint32_t bench_idle_total(void)
+{
+    uint32_t total = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        total += s_idle_count[i];
+    }
+    return total;
+}
+
+static void bench_run(essl_handle_t handle, const bench_bus_info_t *info, bool to_slave, float cpu_idle_per_us)
+{
+    const char *dir = to_slave ? "host_to_slave" : "slave_to_host";
+    for (size_t s = 0; s < sizeof(s_sizes) / sizeof(s_sizes[0]); s++) {
+        const uint32_t size = s_sizes[s];
+        uint64_t bytes = 0;
+        esp_err_t err = ESP_OK;
+
+        const uint32_t idle_start = bench_idle_total();
+        const int64_t start = esp_timer_get_time();
+        const int64_t end = start + CONFIG_BENCH_DURATION_MS * 1000LL;
+        while (esp_timer_get_time() < end) {
+            if (to_slave) {
+                err = essl_send_packet(handle, s_buf, size, BENCH_WAIT_MS);
+                if (err == ESP_OK) {
+                    bytes += size;
+                }
+            } else {
+                size_t len = 0;
+                err = essl_get_packet(handle, s_buf, size, &len, BENCH_WAIT_MS);
+                if (err == ESP_OK || err == ESP_ERR_NOT_FINISHED) {
+                    bytes += len;
+                    err = ESP_OK;
+                }
+            }
+            if (err != ESP_OK) {
+                break;
+            }
+        }
+        const int64_t elapsed_us = esp_timer_get_time() - start;
+        const uint32_t idle = bench_idle_total() - idle_start;
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "%s, %d-bit, %d kHz: %s of %" PRIu32 " bytes failed: %s", info->bus, info->width, info->freq_khz,
+                     dir, size, esp_err_to_name(err));
+            continue;
+        }
+        const float cpu_load = 100.0f * (1.0f - (float)idle / (cpu_idle_per_us * elapsed_us));
+        printf("ESSLBENCH,%s,%d,%d,%s,%" PRIu32 ",%" PRIu64 ",%" PRId64 ",%.2f,%.1f\n", info->bus, info->width, info->freq_khz,
+               dir, size, bytes, elapsed_us, (float)bytes / elapsed_us, cpu_load < 0 ? 0 : cpu_load);
+    }
+}
+
+#if CONFIG_BENCH_BUS_SDIO
+static sdmmc_card_t s_card;
+
+/* Reset the counters of the slave, which are kept from the previous configuration, to match the new device */
+static esp_err_t bench_sdio_reset_slave(essl_handle_t handle)
+{
+    uint8_t value = 0;
+    ESP_RETURN_ON_ERROR(essl_write_reg(handle, BENCH_SDIO_REG_CMD, BENCH_SDIO_CMD_RESET, NULL, BENCH_WAIT_MS), TAG, "write cmd failed");
+    ESP_RETURN_ON_ERROR(essl_send_slave_intr(handle, BIT(BENCH_SDIO_INTR_CMD), BENCH_WAIT_MS), TAG, "send intr failed");
+    const int64_t deadline = esp_timer_get_time() + BENCH_WAIT_MS * 1000LL;
+    do {
+        vTaskDelay(1);
+        ESP_RETURN_ON_ERROR(essl_read_reg(handle, BENCH_SDIO_REG_CMD, &value, BENCH_WAIT_MS), TAG, "read cmd failed");
+    } while (value != BENCH_SDIO_CMD_DONE && esp_timer_get_time() < deadline);
+    ESP_RETURN_ON_FALSE(value == BENCH_SDIO_CMD_DONE, ESP_ERR_TIMEOUT, TAG, "slave not responding");
+    return essl_reset_cnt(handle);
+}
+
+static esp_err_t bench_sdio_open(int width, int freq_khz, essl_handle_t *out_handle)
+{
+    esp_err_t ret = ESP_OK;
+    sdmmc_host_t config = SDMMC_HOST_DEFAULT();
+    config.flags = (width == 4) ? SDMMC_HOST_FLAG_4BIT : SDMMC_HOST_FLAG_1BIT;
+    config.max_freq_khz = freq_khz;
+    sdmmc_slot_config_t slot_config = SDMMC_SLOT_CONFIG_DEFAULT();
+    slot_config.width = width;
+    // The bus still needs external pull-ups, the internal ones are too weak for high clock frequencies
+    slot_config.flags |= SDMMC_SLOT_FLAG_INTERNAL_PULLUP;
+
+    ESP_RETURN_ON_ERROR(sdmmc_host_init(), TAG, "host init failed");
+    ESP_GOTO_ON_ERROR(sdmmc_host_init_slot(config.slot, &slot_config), err, TAG, "slot init failed");
+    ESP_GOTO_ON_ERROR(sdmmc_card_init(&config, &s_card), err, TAG, "slave not found");
+
+    essl_sdio_config_t essl_config = {
+        .card = &s_card,
+        .recv_buffer_size = BENCH_SDIO_RECV_BUF_SIZE,
+    };
+    ESP_GOTO_ON_ERROR(essl_sdio_init_dev(out_handle, &essl_config), err, TAG, "essl device init failed");
+    ESP_GOTO_ON_ERROR(essl_init(*out_handle, BENCH_WAIT_MS), err_dev, TAG, "essl init failed");
+    ESP_GOTO_ON_ERROR(essl_wait_for_ready(*out_handle, BENCH_WAIT_MS), err_dev, TAG, "slave not ready");
+    ESP_GOTO_ON_ERROR(bench_sdio_reset_slave(*out_handle), err_dev, TAG, "slave reset failed");
+    return ESP_OK;
+
+err_dev:
+    essl_sdio_deinit_dev(*out_handle);
+err:
+    sdmmc_host_deinit();
+    return ret;
+}
+
+static void bench_sdio(float cpu_idle_per_us)
+{
+#if CONFIG_BENCH_SDIO_4BIT
+    const int widths[] = {1, 4};
+#else
+    const int widths[] = {1};
+#endif
+    const int freqs_khz[] = {SDMMC_FREQ_DEFAULT, SDMMC_FREQ_HIGHSPEED};
+    for (size_t w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+        for (size_t f = 0; f < sizeof(freqs_khz) / sizeof(freqs_khz[0]); f++) {
+            bench_bus_info_t info = {
+                .bus = "sdio",
+                .width = widths[w],
+                .freq_khz = freqs_khz[f],
+            };
+            essl_handle_t handle;
+            if (bench_sdio_open(info.width, info.freq_khz, &handle) != ESP_OK) {
+                continue;
+            }
+            bench_run(handle, &info, true, cpu_idle_per_us);
+            bench_run(handle, &info, false, cpu_idle_per_us);
+            essl_sdio_deinit_dev(handle);
+            sdmmc_host_deinit();
+        }
+    }
+}
+#else
+static void bench_spi(float cpu_idle_per_us)
+{
+    spi_bus_config_t bus_config = {
+        .mosi_io_num = BENCH_SPI_GPIO_MOSI,
+        .miso_io_num = BENCH_SPI_GPIO_MISO,
+        .sclk_io_num = BENCH_SPI_GPIO_SCLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = BENCH_MAX_SIZE,
+    };
+    ESP_ERROR_CHECK(spi_bus_initialize(BENCH_SPI_HOST, &bus_config, SPI_DMA_CH_AUTO));
+
+    spi_device_interface_config_t dev_config = {
+        .command_bits = 8,
+        .address_bits = 8,
+        .dummy_bits = 8,
+        .clock_speed_hz = CONFIG_BENCH_SPI_CLOCK_MHZ * 1000 * 1000,
+        .mode = 0,
+        .spics_io_num = BENCH_SPI_GPIO_CS,
+        .flags = SPI_DEVICE_HALFDUPLEX,
+        .queue_size = 4,
+    };
+    spi_device_handle_t spi;
+    ESP_ERROR_CHECK(spi_bus_add_device(BENCH_SPI_HOST, &dev_config, &spi));
+
+    essl_spi_config_t essl_config = {
+        .spi = &spi,
+        .tx_buf_size = BENCH_SPI_BUF_SIZE,
+        .tx_sync_reg = BENCH_SPI_REG_RX_BUF_NUM,
+        .rx_sync_reg = BENCH_SPI_REG_TX_BYTES,
+    };
+    essl_handle_t handle;
+    ESP_ERROR_CHECK(essl_spi_init_dev(&handle, &essl_config));
+
+    bench_bus_info_t info = {
+        .bus = "spi",
+        .width = 1,
+        .freq_khz = CONFIG_BENCH_SPI_CLOCK_MHZ * 1000,
+    };
+    bench_run(handle, &info, true, cpu_idle_per_us);
+    bench_run(handle, &info, false, cpu_idle_per_us);
+
+    ESP_ERROR_CHECK(essl_spi_deinit_dev(handle));
+    ESP_ERROR_CHECK(spi_bus_remove_device(spi));
+    ESP_ERROR_CHECK(spi_bus_free(BENCH_SPI_HOST));
+}
+#endif
+
+void app_main(void)
+{
+    // Above the CPU time counters, which must only get the time left by the benchmark
+    vTaskPrioritySet(NULL, 5);
+    // DMA capable and aligned to 4, as required by both buses
+    s_buf = heap_caps_aligned_alloc(4, BENCH_MAX_SIZE, MALLOC_CAP_DMA);
+    assert(s_buf);
+    for (int i = 0; i < BENCH_MAX_SIZE; i++) {
+        s_buf[i] = i;
+    }
+
+    // Calibrate the CPU time counters while nothing else runs
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        xTaskCreatePinnedToCore(bench_idle_task, "bench_idle", 2048, (void *)&s_idle_count[i], tskIDLE_PRIORITY, NULL, i);
+    }
+    const uint32_t idle_start = bench_idle_total();
+    const int64_t calib_start = esp_timer_get_time();
+    vTaskDelay(pdMS_TO_TICKS(500));
+    const float cpu_idle_per_us = (float)(bench_idle_total() - idle_start) / (esp_timer_get_time() - calib_start);
+
+    printf("ESSLBENCH,bus,width,freq_khz,dir,size,bytes,us,mb_per_s,cpu_load_pct\n");
+#if CONFIG_BENCH_BUS_SDIO
+    bench_sdio(cpu_idle_per_us);
+#else
+    bench_spi(cpu_idle_per_us);
+#endif
+    printf("Benchmark done\n");
+}
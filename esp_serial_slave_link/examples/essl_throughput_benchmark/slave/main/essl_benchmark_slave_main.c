@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#if CONFIG_BENCH_BUS_SDIO
+#include "driver/sdio_slave.h"
+#else
+#include "driver/spi_slave_hd.h"
+#endif
+#include "essl_bench_protocol.h"
+
+/*
+ * Slave of the throughput benchmark. It keeps as many buffers loaded as possible in both directions, in a busy loop:
+ * the received data is dropped and the same buffer is sent again and again, so that the host measures the bus and not
+ * the slave.
+ */
+
+#if CONFIG_BENCH_BUS_SPI
+// Assign the GPIOs connected to the host
+#define BENCH_SPI_HOST      SPI2_HOST
+#define BENCH_SPI_GPIO_MOSI 11
+#define BENCH_SPI_GPIO_MISO 13
+#define BENCH_SPI_GPIO_SCLK 12
+#define BENCH_SPI_GPIO_CS   10
+#endif
+
+static const char *TAG = "essl_bench_slave";
+
+#if CONFIG_BENCH_BUS_SDIO
+static void bench_sdio_slave(void)
+{
+    sdio_slave_config_t config = {
+        .sending_mode = SDIO_SLAVE_SEND_STREAM,
+        .send_queue_size = BENCH_SDIO_SEND_QUEUE_SIZE,
+        .recv_buffer_size = BENCH_SDIO_RECV_BUF_SIZE,
+    };
+    ESP_ERROR_CHECK(sdio_slave_initialize(&config));
+
+    for (int i = 0; i < BENCH_SDIO_RECV_BUF_NUM; i++) {
+        uint8_t *buf = heap_caps_malloc(BENCH_SDIO_RECV_BUF_SIZE, MALLOC_CAP_DMA);
+        assert(buf);
+        sdio_slave_buf_handle_t handle = sdio_slave_recv_register_buf(buf);
+        assert(handle);
+        ESP_ERROR_CHECK(sdio_slave_recv_load_buf(handle));
+    }
+    uint8_t *send_buf = heap_caps_malloc(BENCH_SDIO_SEND_LEN, MALLOC_CAP_DMA);
+    assert(send_buf);
+    for (int i = 0; i < BENCH_SDIO_SEND_LEN; i++) {
+        send_buf[i] = i;
+    }
+    ESP_ERROR_CHECK(sdio_slave_start());
+    ESP_LOGI(TAG, "SDIO slave ready");
+
+    while (true) {
+        // The host reconnects with new counters for each bus configuration
+        if (sdio_slave_wait_int(BENCH_SDIO_INTR_CMD, 0) == ESP_OK
+                && sdio_slave_read_reg(BENCH_SDIO_REG_CMD) == BENCH_SDIO_CMD_RESET) {
+            sdio_slave_stop();
+            ESP_ERROR_CHECK(sdio_slave_reset());
+            ESP_ERROR_CHECK(sdio_slave_start());
+            sdio_slave_write_reg(BENCH_SDIO_REG_CMD, BENCH_SDIO_CMD_DONE);
+        }
+
+        sdio_slave_buf_handle_t handle;
+        uint8_t *addr;
+        size_t len;
+        while (sdio_slave_recv(&handle, &addr, &len, 0) == ESP_OK) {
+            ESP_ERROR_CHECK(sdio_slave_recv_load_buf(handle));
+        }
+
+        void *arg;
+        while (sdio_slave_send_get_finished(&arg, 0) == ESP_OK) {
+        }
+        while (sdio_slave_send_queue(send_buf, BENCH_SDIO_SEND_LEN, NULL, 0) == ESP_OK) {
+        }
+    }
+}
+#else
+static spi_slave_hd_data_t s_rx_trans[BENCH_SPI_QUEUE_SIZE];
+static spi_slave_hd_data_t s_tx_trans[BENCH_SPI_QUEUE_SIZE];
+
+static void bench_spi_slave(void)
+{
+    spi_bus_config_t bus_config = {
+        .mosi_io_num = BENCH_SPI_GPIO_MOSI,
+        .miso_io_num = BENCH_SPI_GPIO_MISO,
+        .sclk_io_num = BENCH_SPI_GPIO_SCLK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = BENCH_SPI_BUF_SIZE,
+    };
+    spi_slave_hd_slot_config_t slave_config = {
+        .spics_io_num = BENCH_SPI_GPIO_CS,
+        .flags = SPI_SLAVE_HD_APPEND_MODE,
+        .mode = 0,
+        .command_bits = 8,
+        .address_bits = 8,
+        .dummy_bits = 8,
+        .queue_size = BENCH_SPI_QUEUE_SIZE,
+        .dma_chan = SPI_DMA_CH_AUTO,
+    };
+    ESP_ERROR_CHECK(spi_slave_hd_init(BENCH_SPI_HOST, &bus_config, &slave_config));
+
+    uint8_t *send_buf = heap_caps_malloc(BENCH_SPI_BUF_SIZE, MALLOC_CAP_DMA);
+    assert(send_buf);
+    for (int i = 0; i < BENCH_SPI_BUF_SIZE; i++) {
+        send_buf[i] = i;
+    }
+    // Accumulated counters read by the host, see `essl_spi_config_t`
+    uint32_t rx_buf_num = 0;
+    uint32_t tx_bytes = 0;
+    for (int i = 0; i < BENCH_SPI_QUEUE_SIZE; i++) {
+        s_rx_trans[i].data = heap_caps_malloc(BENCH_SPI_BUF_SIZE, MALLOC_CAP_DMA);
+        assert(s_rx_trans[i].data);
+        s_rx_trans[i].len = BENCH_SPI_BUF_SIZE;
+        ESP_ERROR_CHECK(spi_slave_hd_append_trans(BENCH_SPI_HOST, SPI_SLAVE_CHAN_RX, &s_rx_trans[i], portMAX_DELAY));
+        rx_buf_num++;
+
+        s_tx_trans[i].data = send_buf;
+        s_tx_trans[i].len = BENCH_SPI_BUF_SIZE;
+        ESP_ERROR_CHECK(spi_slave_hd_append_trans(BENCH_SPI_HOST, SPI_SLAVE_CHAN_TX, &s_tx_trans[i], portMAX_DELAY));
+        tx_bytes += BENCH_SPI_BUF_SIZE;
+    }
+    spi_slave_hd_write_buffer(BENCH_SPI_HOST, BENCH_SPI_REG_RX_BUF_NUM, (uint8_t *)&rx_buf_num, sizeof(rx_buf_num));
+    spi_slave_hd_write_buffer(BENCH_SPI_HOST, BENCH_SPI_REG_TX_BYTES, (uint8_t *)&tx_bytes, sizeof(tx_bytes));
+    ESP_LOGI(TAG, "SPI slave ready");
+
+    while (true) {
+        spi_slave_hd_data_t *trans;
+        bool rx_updated = false;
+        bool tx_updated = false;
+        // Append each finished buffer again, the counters include it once it's loaded
+        while (spi_slave_hd_get_append_trans_res(BENCH_SPI_HOST, SPI_SLAVE_CHAN_RX, &trans, 0) == ESP_OK) {
+            ESP_ERROR_CHECK(spi_slave_hd_append_trans(BENCH_SPI_HOST, SPI_SLAVE_CHAN_RX, trans, 0));
+            rx_buf_num++;
+            rx_updated = true;
+        }
+        while (spi_slave_hd_get_append_trans_res(BENCH_SPI_HOST, SPI_SLAVE_CHAN_TX, &trans, 0) == ESP_OK) {
+            ESP_ERROR_CHECK(spi_slave_hd_append_trans(BENCH_SPI_HOST, SPI_SLAVE_CHAN_TX, trans, 0));
+            tx_bytes += trans->len;
+            tx_updated = true;
+        }
+        if (rx_updated) {
+            spi_slave_hd_write_buffer(BENCH_SPI_HOST, BENCH_SPI_REG_RX_BUF_NUM, (uint8_t *)&rx_buf_num, sizeof(rx_buf_num));
+        }
+        if (tx_updated) {
+            spi_slave_hd_write_buffer(BENCH_SPI_HOST, BENCH_SPI_REG_TX_BYTES, (uint8_t *)&tx_bytes, sizeof(tx_bytes));
+        }
+    }
+}
+#endif
+
+void app_main(void)
+{
+#if CONFIG_BENCH_BUS_SDIO
+    bench_sdio_slave();
+#else
+    bench_spi_slave();
+#endif
+}
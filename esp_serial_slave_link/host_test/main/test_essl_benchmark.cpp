@@ -0,0 +1,174 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Moves the same traffic through the simulated slave with the different transfer functions and reports the
+ * transactions, the counter reads and the simulated bus time they take. The bus model is a 4-bit SDIO bus at 40 MHz
+ * with a fixed cost per CMD53, the numbers are meant to compare changes of the master side, not to predict the
+ * throughput of a given host.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "esp_serial_slave_link/essl.h"
+#include "esp_serial_slave_link/essl_sim.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#define BENCH_BUFFER_SIZE       512
+#define BENCH_SLAVE_BUFFERS     32      // buffers the slave keeps loaded
+#define BENCH_PACKET_LEN        1500
+#define BENCH_PACKET_NUM        1024
+#define BENCH_BATCH             16
+
+typedef enum {
+    BENCH_POLL_EACH,            // reads the counter of the slave before each transfer
+    BENCH_SINGLE,               // essl_send_packet / essl_get_packet
+    BENCH_BATCHED,              // essl_send_packets / essl_get_packets
+} bench_mode_t;
+
+static const char *const bench_mode_names[] = {"poll each", "single", "batched"};
+
+static uint8_t s_packet[BENCH_PACKET_LEN];
+static uint8_t s_recv[BENCH_BATCH][BENCH_PACKET_LEN];
+
+static essl_handle_t bench_init_dev(void)
+{
+    essl_sim_config_t config = {
+        .recv_buffer_size = BENCH_BUFFER_SIZE,
+        .transaction_latency_us = 20,
+        .byte_time_ns = 50,
+        .real_time = false,
+    };
+    essl_handle_t handle = NULL;
+    REQUIRE(essl_sim_init_dev(&handle, &config) == ESP_OK);
+    return handle;
+}
+
+static void bench_report(essl_handle_t handle, const char *dir, bench_mode_t mode)
+{
+    essl_sim_stats_t stats;
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.overruns == 0);
+
+    uint64_t bytes = stats.bytes_sent + stats.bytes_received;
+    printf("[benchmark] %s %-9s: %" PRIu32 " transactions, %" PRIu32 " counter reads, %" PRIu64 " us bus time, %" PRIu64 " KB/s\n",
+           dir, bench_mode_names[mode], stats.transactions, stats.tx_buffer_num_reads + stats.rx_data_size_reads,
+           stats.bus_time_us, stats.bus_time_us ? bytes * 1000000 / 1024 / stats.bus_time_us : 0);
+}
+
+// The slave hands the buffers of the packets it got back to the bus, as a slave app reloading its receiving buffers
+static void bench_slave_drain(essl_handle_t handle)
+{
+    size_t len;
+    uint32_t buffers = 0;
+    while (essl_sim_slave_recv(handle, s_recv[0], sizeof(s_recv[0]), &len) == ESP_OK) {
+        buffers += (len + BENCH_BUFFER_SIZE - 1) / BENCH_BUFFER_SIZE;
+    }
+    REQUIRE(essl_sim_slave_load_buffers(handle, buffers) == ESP_OK);
+}
+
+static void bench_tx(bench_mode_t mode)
+{
+    essl_handle_t handle = bench_init_dev();
+    essl_tx_packet_t packets[BENCH_BATCH];
+    size_t sent = 0;
+
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        packets[i] = (essl_tx_packet_t) {
+            .start = s_packet, .length = sizeof(s_packet),
+        };
+    }
+    REQUIRE(essl_sim_slave_load_buffers(handle, BENCH_SLAVE_BUFFERS) == ESP_OK);
+
+    while (sent < BENCH_PACKET_NUM) {
+        esp_err_t err;
+        if (mode == BENCH_BATCHED) {
+            size_t batch_sent;
+            size_t num = BENCH_PACKET_NUM - sent < BENCH_BATCH ? BENCH_PACKET_NUM - sent : BENCH_BATCH;
+            err = essl_send_packets(handle, packets, num, &batch_sent, 0);
+            sent += batch_sent;
+        } else {
+            if (mode == BENCH_POLL_EACH) {
+                uint32_t tx_num;
+                REQUIRE(essl_get_tx_buffer_num(handle, &tx_num, 0) == ESP_OK);
+            }
+            err = essl_send_packet(handle, s_packet, sizeof(s_packet), 0);
+            if (err == ESP_OK) {
+                sent++;
+            }
+        }
+        REQUIRE((err == ESP_OK || err == ESP_ERR_NOT_FOUND));
+        if (err == ESP_ERR_NOT_FOUND) {
+            bench_slave_drain(handle);
+        }
+    }
+
+    bench_report(handle, "tx", mode);
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+static void bench_rx(bench_mode_t mode)
+{
+    essl_handle_t handle = bench_init_dev();
+    essl_rx_packet_t packets[BENCH_BATCH];
+    size_t loaded = 0;
+    uint64_t received = 0;
+    const uint64_t total = (uint64_t)BENCH_PACKET_NUM * BENCH_PACKET_LEN;
+
+    for (int i = 0; i < BENCH_BATCH; i++) {
+        packets[i] = (essl_rx_packet_t) {
+            .out_data = s_recv[i], .size = BENCH_BUFFER_SIZE,
+        };
+    }
+
+    while (received < total) {
+        // The slave keeps a few packets loaded ahead of the master
+        while (loaded < BENCH_PACKET_NUM && loaded * BENCH_PACKET_LEN - received < BENCH_BATCH * BENCH_PACKET_LEN) {
+            REQUIRE(essl_sim_slave_send(handle, s_packet, sizeof(s_packet)) == ESP_OK);
+            loaded++;
+        }
+
+        esp_err_t err;
+        if (mode == BENCH_BATCHED) {
+            size_t num;
+            err = essl_get_packets(handle, packets, BENCH_BATCH, &num, 0);
+            for (size_t i = 0; i < num; i++) {
+                received += packets[i].out_length;
+            }
+        } else {
+            size_t len;
+            if (mode == BENCH_POLL_EACH) {
+                uint32_t rx_size;
+                REQUIRE(essl_get_rx_data_size(handle, &rx_size, 0) == ESP_OK);
+            }
+            err = essl_get_packet(handle, s_recv[0], BENCH_BUFFER_SIZE, &len, 0);
+            if (err == ESP_OK || err == ESP_ERR_NOT_FINISHED) {
+                received += len;
+            }
+        }
+        REQUIRE((err == ESP_OK || err == ESP_ERR_NOT_FINISHED));
+    }
+
+    bench_report(handle, "rx", mode);
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+TEST_CASE("benchmark sending packets to the slave", "[essl_sim][benchmark]")
+{
+    bench_tx(BENCH_POLL_EACH);
+    bench_tx(BENCH_SINGLE);
+    bench_tx(BENCH_BATCHED);
+}
+
+TEST_CASE("benchmark receiving data from the slave", "[essl_sim][benchmark]")
+{
+    bench_rx(BENCH_POLL_EACH);
+    bench_rx(BENCH_SINGLE);
+    bench_rx(BENCH_BATCHED);
+}
@@ -0,0 +1,294 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_serial_slave_link/essl.h"
+#include "esp_serial_slave_link/essl_sim.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#define TEST_BUFFER_SIZE    512
+
+static essl_handle_t test_init_dev(void)
+{
+    essl_sim_config_t config = {
+        .recv_buffer_size = TEST_BUFFER_SIZE,
+        .transaction_latency_us = 10,
+        .byte_time_ns = 50,
+        .real_time = false,
+    };
+    essl_handle_t handle = NULL;
+    REQUIRE(essl_sim_init_dev(&handle, &config) == ESP_OK);
+    REQUIRE(essl_init(handle, 0) == ESP_OK);
+    REQUIRE(essl_wait_for_ready(handle, 0) == ESP_OK);
+    return handle;
+}
+
+static void test_fill(uint8_t *buf, size_t len, uint32_t seed)
+{
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+TEST_CASE("send_packet uses the TX buffer num known by the master before reading it again", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    uint8_t data[TEST_BUFFER_SIZE + 100];
+    uint8_t recv[sizeof(data)];
+    size_t len;
+    essl_sim_stats_t stats;
+
+    test_fill(data, sizeof(data), 1);
+    REQUIRE(essl_send_packet(handle, data, sizeof(data), 0) == ESP_ERR_NOT_FOUND);
+
+    // Each packet takes 2 buffers
+    REQUIRE(essl_sim_slave_load_buffers(handle, 4) == ESP_OK);
+    REQUIRE(essl_sim_reset_stats(handle) == ESP_OK);
+    REQUIRE(essl_send_packet(handle, data, sizeof(data), 0) == ESP_OK);
+    REQUIRE(essl_send_packet(handle, data, sizeof(data), 0) == ESP_OK);
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.tx_buffer_num_reads == 1);
+    CHECK(stats.packets_sent == 2);
+    CHECK(stats.bytes_sent == 2 * sizeof(data));
+
+    REQUIRE(essl_send_packet(handle, data, sizeof(data), 0) == ESP_ERR_NOT_FOUND);
+    REQUIRE(essl_sim_slave_load_buffers(handle, 2) == ESP_OK);
+    REQUIRE(essl_send_packet(handle, data, 10, 0) == ESP_OK);
+
+    for (int i = 0; i < 2; i++) {
+        memset(recv, 0, sizeof(recv));
+        REQUIRE(essl_sim_slave_recv(handle, recv, sizeof(recv), &len) == ESP_OK);
+        CHECK(len == sizeof(data));
+        CHECK(memcmp(recv, data, len) == 0);
+    }
+    REQUIRE(essl_sim_slave_recv(handle, recv, 5, &len) == ESP_ERR_INVALID_SIZE);
+    REQUIRE(essl_sim_slave_recv(handle, recv, sizeof(recv), &len) == ESP_OK);
+    CHECK(len == 10);
+    REQUIRE(essl_sim_slave_recv(handle, recv, sizeof(recv), &len) == ESP_ERR_NOT_FOUND);
+
+    uint32_t tx_num;
+    REQUIRE(essl_get_tx_buffer_num(handle, &tx_num, 0) == ESP_OK);
+    CHECK(tx_num == 1);
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.overruns == 0);
+
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+TEST_CASE("send_packets pipelines the packets as long as the slave has loaded buffers", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    uint8_t data[8][100];
+    essl_tx_packet_t packets[8];
+    size_t sent;
+    essl_sim_stats_t stats;
+
+    for (int i = 0; i < 8; i++) {
+        test_fill(data[i], sizeof(data[i]), i);
+        packets[i] = (essl_tx_packet_t) {
+            .start = data[i], .length = sizeof(data[i]),
+        };
+    }
+
+    REQUIRE(essl_sim_slave_load_buffers(handle, 5) == ESP_OK);
+    REQUIRE(essl_send_packets(handle, packets, 8, &sent, 0) == ESP_ERR_NOT_FOUND);
+    CHECK(sent == 5);
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    // Once before the first packet, once more when the buffers run out
+    CHECK(stats.tx_buffer_num_reads == 2);
+
+    REQUIRE(essl_sim_slave_load_buffers(handle, 3) == ESP_OK);
+    REQUIRE(essl_send_packets(handle, &packets[sent], 8 - sent, &sent, 0) == ESP_OK);
+    CHECK(sent == 3);
+
+    for (int i = 0; i < 8; i++) {
+        uint8_t recv[TEST_BUFFER_SIZE];
+        size_t len;
+        REQUIRE(essl_sim_slave_recv(handle, recv, sizeof(recv), &len) == ESP_OK);
+        CHECK(len == sizeof(data[i]));
+        CHECK(memcmp(recv, data[i], len) == 0);
+    }
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+TEST_CASE("get_packets reads the data of the slave into several buffers", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    uint8_t data[900];
+    uint8_t recv[3][400];
+    essl_rx_packet_t packets[2];
+    size_t num;
+    size_t len;
+    essl_sim_stats_t stats;
+
+    test_fill(data, sizeof(data), 3);
+    REQUIRE(essl_get_packet(handle, recv[0], sizeof(recv[0]), &len, 0) == ESP_ERR_NOT_FOUND);
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(essl_sim_slave_send(handle, data + i * 300, 300) == ESP_OK);
+    }
+
+    REQUIRE(essl_sim_reset_stats(handle) == ESP_OK);
+    for (int i = 0; i < 2; i++) {
+        packets[i] = (essl_rx_packet_t) {
+            .out_data = recv[i], .size = sizeof(recv[i]),
+        };
+    }
+    REQUIRE(essl_get_packets(handle, packets, 2, &num, 0) == ESP_ERR_NOT_FINISHED);
+    CHECK(num == 2);
+    CHECK(packets[0].out_length == 400);
+    CHECK(packets[1].out_length == 400);
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.rx_data_size_reads == 1);
+
+    // The rest is covered by the RX data size read before
+    REQUIRE(essl_get_packet(handle, recv[2], 100, &len, 0) == ESP_OK);
+    CHECK(len == 100);
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.rx_data_size_reads == 1);
+    CHECK(stats.bytes_received == sizeof(data));
+
+    CHECK(memcmp(recv[0], data, 400) == 0);
+    CHECK(memcmp(recv[1], data + 400, 400) == 0);
+    CHECK(memcmp(recv[2], data + 800, 100) == 0);
+    REQUIRE(essl_get_packet(handle, recv[0], sizeof(recv[0]), &len, 0) == ESP_ERR_NOT_FOUND);
+
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+TEST_CASE("the TX buffer num and RX data size counters wrap around", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    static uint8_t data[4096];
+    static uint8_t recv[4096];
+    size_t len;
+    essl_sim_stats_t stats;
+
+    // More than the 0x1000 buffers the counter covers
+    for (uint32_t i = 0; i < 0x1000 + 100; i++) {
+        REQUIRE(essl_sim_slave_load_buffers(handle, 1) == ESP_OK);
+        REQUIRE(essl_send_packet(handle, data, 16, 0) == ESP_OK);
+        REQUIRE(essl_sim_slave_recv(handle, recv, sizeof(recv), &len) == ESP_OK);
+    }
+
+    // More than the 0x100000 bytes the counter covers
+    for (uint32_t i = 0; i < 300; i++) {
+        test_fill(data, sizeof(data), i);
+        REQUIRE(essl_sim_slave_send(handle, data, sizeof(data)) == ESP_OK);
+        REQUIRE(essl_get_packet(handle, recv, sizeof(recv), &len, 0) == ESP_OK);
+        REQUIRE(len == sizeof(data));
+        REQUIRE(memcmp(recv, data, len) == 0);
+    }
+
+    REQUIRE(essl_sim_get_stats(handle, &stats) == ESP_OK);
+    CHECK(stats.overruns == 0);
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+typedef struct {
+    SemaphoreHandle_t done;
+    uint8_t data[2048];
+    size_t received;
+    size_t expected;
+    uint32_t intr_st;
+} test_event_ctx_t;
+
+static void test_on_rx(essl_handle_t handle, const void *data, size_t length, void *user_ctx)
+{
+    test_event_ctx_t *ctx = (test_event_ctx_t *)user_ctx;
+    // Catch2 assertions can't be used from the event loop task
+    if (ctx->received + length > sizeof(ctx->data)) {
+        return;
+    }
+    memcpy(ctx->data + ctx->received, data, length);
+    ctx->received += length;
+    if (ctx->received == ctx->expected) {
+        xSemaphoreGive(ctx->done);
+    }
+}
+
+static void test_on_intr(essl_handle_t handle, uint32_t intr_st, void *user_ctx)
+{
+    test_event_ctx_t *ctx = (test_event_ctx_t *)user_ctx;
+    ctx->intr_st |= intr_st;
+    xSemaphoreGive(ctx->done);
+}
+
+TEST_CASE("the event loop receives the data and the interrupts of the slave", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    static test_event_ctx_t ctx;
+    uint8_t data[1500];
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.done = xSemaphoreCreateBinary();
+    REQUIRE(ctx.done != NULL);
+
+    essl_event_loop_config_t config = {
+        .rx_intr_mask = ESSL_SIM_NEW_PACKET_INTR_MASK,
+        .intr_mask = 1 << 0,
+        .rx_buffer_size = 256,
+        .on_rx = test_on_rx,
+        .on_intr = test_on_intr,
+        .user_ctx = &ctx,
+        .task_stack_size = 4096,
+        .task_priority = 5,
+    };
+    essl_event_loop_handle_t loop;
+    REQUIRE(essl_event_loop_start(handle, &config, &loop) == ESP_OK);
+
+    test_fill(data, sizeof(data), 5);
+    ctx.expected = sizeof(data);
+    REQUIRE(essl_sim_slave_send(handle, data, 1000) == ESP_OK);
+    REQUIRE(essl_sim_slave_send(handle, data + 1000, 500) == ESP_OK);
+    REQUIRE(xSemaphoreTake(ctx.done, pdMS_TO_TICKS(1000)) == pdTRUE);
+    CHECK(memcmp(ctx.data, data, sizeof(data)) == 0);
+
+    REQUIRE(essl_sim_slave_send_intr(handle, 1 << 0) == ESP_OK);
+    REQUIRE(xSemaphoreTake(ctx.done, pdMS_TO_TICKS(1000)) == pdTRUE);
+    CHECK(ctx.intr_st == (1 << 0));
+
+    REQUIRE(essl_event_loop_stop(loop) == ESP_OK);
+    vSemaphoreDelete(ctx.done);
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
+
+TEST_CASE("registers and interrupts are shared between the master and the slave", "[essl_sim]")
+{
+    essl_handle_t handle = test_init_dev();
+    uint8_t value;
+    uint32_t intr_raw, intr_st, intr;
+
+    REQUIRE(essl_write_reg(handle, 3, 0x5a, &value, 0) == ESP_OK);
+    REQUIRE(essl_sim_slave_read_reg(handle, 3, &value) == ESP_OK);
+    CHECK(value == 0x5a);
+    REQUIRE(essl_sim_slave_write_reg(handle, 4, 0xa5) == ESP_OK);
+    REQUIRE(essl_read_reg(handle, 4, &value, 0) == ESP_OK);
+    CHECK(value == 0xa5);
+    REQUIRE(essl_read_reg(handle, ESSL_SIM_REG_NUM, &value, 0) == ESP_ERR_INVALID_ARG);
+
+    REQUIRE(essl_send_slave_intr(handle, 0x81, 0) == ESP_OK);
+    REQUIRE(essl_sim_slave_get_intr(handle, &intr) == ESP_OK);
+    CHECK(intr == 0x81);
+    REQUIRE(essl_sim_slave_get_intr(handle, &intr) == ESP_OK);
+    CHECK(intr == 0);
+
+    REQUIRE(essl_set_intr_ena(handle, 1 << 2, 0) == ESP_OK);
+    REQUIRE(essl_wait_int(handle, 10) == ESP_ERR_TIMEOUT);
+    REQUIRE(essl_sim_slave_send_intr(handle, (1 << 1) | (1 << 2)) == ESP_OK);
+    REQUIRE(essl_wait_int(handle, 10) == ESP_OK);
+    REQUIRE(essl_get_intr(handle, &intr_raw, &intr_st, 0) == ESP_OK);
+    CHECK(intr_raw == ((1 << 1) | (1 << 2)));
+    CHECK(intr_st == (1 << 2));
+    REQUIRE(essl_clear_intr(handle, 1 << 2, 0) == ESP_OK);
+    REQUIRE(essl_wait_int(handle, 10) == ESP_ERR_TIMEOUT);
+
+    REQUIRE(essl_sim_deinit_dev(handle) == ESP_OK);
+}
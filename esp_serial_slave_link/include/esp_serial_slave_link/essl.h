@@ -17,6 +17,54 @@ struct essl_dev_t;
 /// Handle of an ESSL device
 typedef struct essl_dev_t *essl_handle_t;
 
+struct essl_event_loop_t;
+/// Handle of an ESSL event loop, see ``essl_event_loop_start``
+typedef struct essl_event_loop_t *essl_event_loop_handle_t;
+
+/**
+ * @brief Callback of an ESSL event loop for the data received from the slave.
+ *
+ * @param handle Handle of the ESSL device.
+ * @param data Data received, only valid until the callback returns.
+ * @param length Length of the data, at most ``rx_buffer_size`` of the event loop.
+ * @param user_ctx User context passed in the configuration of the event loop.
+ */
+typedef void (*essl_rx_cb_t)(essl_handle_t handle, const void *data, size_t length, void *user_ctx);
+
+/**
+ * @brief Callback of an ESSL event loop for the other interrupts of the slave.
+ *
+ * @param handle Handle of the ESSL device.
+ * @param intr_st Masked interrupt bits, already cleared on the slave.
+ * @param user_ctx User context passed in the configuration of the event loop.
+ */
+typedef void (*essl_intr_cb_t)(essl_handle_t handle, uint32_t intr_st, void *user_ctx);
+
+/// Configuration of an ESSL event loop
+typedef struct {
+    uint32_t rx_intr_mask;      ///< Interrupt bits the slave raises when it has new data to send, e.g. ``ESSL_SDIO_DEF_ESP32.new_packet_intr_mask``
+    uint32_t intr_mask;         ///< Other interrupt bits to enable, passed to ``on_intr``. Set to 0 if not used.
+    size_t rx_buffer_size;      ///< Size of the buffer the data is received into. At most this many bytes are passed to ``on_rx`` at a time.
+    essl_rx_cb_t on_rx;         ///< Called with all the data available each time the slave interrupts
+    essl_intr_cb_t on_intr;     ///< Called with the other interrupt bits raised by the slave, can be NULL if ``intr_mask`` is 0
+    void *user_ctx;             ///< User context passed to the callbacks
+    uint32_t task_stack_size;   ///< Stack size of the event loop task, the callbacks run in this task
+    uint32_t task_priority;     ///< Priority of the event loop task
+} essl_event_loop_config_t;
+
+/// Packet to send in a batch, see ``essl_send_packets``
+typedef struct {
+    const void *start;      ///< Start address of the packet to send
+    size_t length;          ///< Length of the packet to send
+} essl_tx_packet_t;
+
+/// Buffer to receive into in a batch, see ``essl_get_packets``
+typedef struct {
+    void *out_data;         ///< Data output address
+    size_t size;            ///< Size of the output buffer
+    size_t out_length;      ///< Output of the length of the data actually received into this buffer
+} essl_rx_packet_t;
+
 /**
  * @brief Initialize the slave.
  *
@@ -120,6 +168,88 @@ esp_err_t essl_send_packet(essl_handle_t handle, const void *start, size_t lengt
  */
 esp_err_t essl_get_packet(essl_handle_t handle, void *out_data, size_t size, size_t *out_length, uint32_t wait_ms);
 
+/**
+ * @brief Send several packets to the ESSL Slave back to back.
+ *
+ * The packets are sent in order as long as the TX buffer num known by the master covers them, without reading it back
+ * from the slave between the packets. It's only updated from the slave when the next packet doesn't fit into the
+ * remaining buffers. Each packet is received by the slave into its own buffers, the same as ``essl_send_packet``.
+ *
+ * @param handle Handle of an ESSL device.
+ * @param packets Packets to send.
+ * @param num Number of packets to send.
+ * @param[out] out_sent Output of the number of packets sent, also valid when an error is returned.
+ * @param wait_ms Millisecond to wait for slave buffers before timeout, for the whole batch, will not wait at all if set to 0-9.
+ *
+ * @return
+ *      - ESP_OK:                All the packets have been sent.
+ *      - ESP_ERR_INVALID_ARG:   Invalid argument, handle is not init or other argument is not valid.
+ *      - ESP_ERR_NOT_FOUND:     Slave is not ready for receiving the packet ``*out_sent`` before timeout.
+ *      - ESP_ERR_NOT_SUPPORTED: This API is not supported in this mode
+ *      - One of the error codes from SDMMC/SPI host controller.
+ */
+esp_err_t essl_send_packets(essl_handle_t handle, const essl_tx_packet_t *packets, size_t num, size_t *out_sent, uint32_t wait_ms);
+
+/**
+ * @brief Get the data the ESSL slave is ready to send into several buffers.
+ *
+ * The buffers are filled in order, each one as long as the RX data size known by the master covers it. The RX data size
+ * is only updated from the slave when all the data it covers has been read, instead of before each buffer as repeated
+ * calls to ``essl_get_packet`` do. This returns as soon as the slave has no more data, the buffers left are not touched.
+ *
+ * @param handle Handle of an ESSL device.
+ * @param[inout] packets Buffers to receive into. The ``out_length`` member of each filled buffer is set.
+ * @param num Number of buffers.
+ * @param[out] out_num Output of the number of buffers filled, the last one may be filled partially.
+ * @param wait_ms Millisecond to wait for data before timeout, will not wait at all if set to 0-9. Only waits until the first data is available.
+ *
+ * @return
+ *     - ESP_OK:                Success, at least one buffer has been filled.
+ *     - ESP_ERR_INVALID_ARG:   Invalid argument, The handle is not initialized or the other arguments are invalid.
+ *     - ESP_ERR_NOT_FINISHED:  All the buffers have been filled, but there is still data remaining.
+ *     - ESP_ERR_NOT_FOUND:     Slave is not ready to send data.
+ *     - ESP_ERR_NOT_SUPPORTED: This API is not supported in this mode
+ *     - One of the error codes from SDMMC/SPI host controller.
+ */
+esp_err_t essl_get_packets(essl_handle_t handle, essl_rx_packet_t *packets, size_t num, size_t *out_num, uint32_t wait_ms);
+
+/**
+ * @brief Start an event loop, receiving the data of the slave as soon as it interrupts.
+ *
+ * The event loop enables the interrupt line of the slave on the host and ``rx_intr_mask | intr_mask`` on the slave,
+ * and waits for the slave to interrupt in a task. For each interrupt, it clears the RX interrupt, and reads the interrupt
+ * bits together with the RX data size in a single transaction when the device supports it. All the data available is
+ * then read and passed to ``on_rx``, and the other interrupt bits are cleared and passed to ``on_intr``.
+ *
+ * @note Don't call other ESSL APIs that read or clear the interrupts, or receive data, for the device while the event loop is running.
+ * @note Only supported by the devices with an interrupt line, i.e. the SDIO slaves.
+ *
+ * @param handle Handle of an ESSL device, initialized by ``essl_init``.
+ * @param config Configuration of the event loop.
+ * @param[out] out_loop Output of the handle of the event loop.
+ *
+ * @return
+ *        - ESP_OK:                Success
+ *        - ESP_ERR_INVALID_ARG:   Invalid argument, handle is not init or the configuration is not valid.
+ *        - ESP_ERR_NO_MEM:        Failed to allocate the event loop or its task.
+ *        - ESP_ERR_NOT_SUPPORTED: Current device does not support this function.
+ *        - One of the error codes from SDMMC host controller
+ */
+esp_err_t essl_event_loop_start(essl_handle_t handle, const essl_event_loop_config_t *config, essl_event_loop_handle_t *out_loop);
+
+/**
+ * @brief Stop an event loop and free it. Blocks until its task exits, at most the time of one transfer plus 100 ms.
+ *
+ * @note Don't call from the callbacks of the event loop.
+ *
+ * @param loop Handle of the event loop.
+ *
+ * @return
+ *        - ESP_OK:                Success
+ *        - ESP_ERR_INVALID_ARG:   Invalid argument, the handle is NULL.
+ */
+esp_err_t essl_event_loop_stop(essl_event_loop_handle_t loop);
+
 /**
  * @brief Write general purpose R/W registers (8-bit) of ESSL slave.
  *
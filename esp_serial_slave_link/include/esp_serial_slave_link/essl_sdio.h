@@ -138,6 +138,29 @@ esp_err_t essl_sdio_get_packet(void *arg, void *out_data, size_t size, uint32_t
  */
 esp_err_t essl_sdio_wait_int(void *arg, uint32_t wait_ms);
 
+/**
+ * @brief Enable the interrupt of the SDIO slave on the host, the DAT1 line for SDMMC host or the interrupt GPIO for SDSPI host.
+ *
+ * @param arg Context of the component.
+ * @return
+ *  - ESP_OK: on success
+ *  - or other values returned from the `io_int_enable` member of the `card->host` structure.
+ */
+esp_err_t essl_sdio_enable_int(void *arg);
+
+/**
+ * @brief Get the masked interrupt bits of an ESSL SDIO slave and update the RX data size, in one transaction.
+ *
+ * @param arg Context of the component.
+ * @param intr_st Output of the masked interrupt bits.
+ * @param wait_ms Time to wait before timeout, in ms.
+ *
+ * @return
+ *      - ESP_OK Success
+ *      - One of the error codes from SDMMC host controller
+ */
+esp_err_t essl_sdio_get_intr_rx_size(void *arg, uint32_t *intr_st, uint32_t wait_ms);
+
 /**
  * @brief Clear interrupt bits of an ESSL SDIO slave. All the bits set in the mask will be cleared, while other bits will stay the same.
  *
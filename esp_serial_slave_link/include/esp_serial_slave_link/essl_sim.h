@@ -0,0 +1,184 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// ESSL device simulating an ESP slave in memory, to test and benchmark the master side without a bus.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#include "esp_serial_slave_link/essl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Interrupt bit raised by the simulated slave when it loads data to send, as ``ESSL_SDIO_DEF_ESP32.new_packet_intr_mask``
+#define ESSL_SIM_NEW_PACKET_INTR_MASK   (1UL << 23)
+
+/// Number of 8-bit shared registers of the simulated slave, see ``essl_read_reg`` and ``essl_write_reg``
+#define ESSL_SIM_REG_NUM                64
+
+/// Configuration for the simulated ESSL device
+typedef struct {
+    size_t recv_buffer_size;        ///< Size of the receiving buffers loaded by the slave, as for SDIO. A packet uses one buffer per started ``recv_buffer_size`` bytes.
+    uint32_t transaction_latency_us;///< Simulated time of each bus transaction of the master: register access, counter read or data transfer
+    uint32_t byte_time_ns;          ///< Simulated time of each byte transferred, e.g. 200 for a 4-bit SDIO bus at 10 MHz
+    bool real_time;                 ///< Also delay the master by the simulated time. Otherwise the time is only counted in the statistics.
+} essl_sim_config_t;
+
+/// Statistics of the simulated ESSL device, see ``essl_sim_get_stats``
+typedef struct {
+    uint32_t transactions;          ///< Bus transactions of the master
+    uint32_t tx_buffer_num_reads;   ///< Reads of the TX buffer num of the slave by the master
+    uint32_t rx_data_size_reads;    ///< Reads of the RX data size of the slave by the master
+    uint32_t packets_sent;          ///< Packets sent to the slave
+    uint32_t packets_received;      ///< Data transfers from the slave
+    uint64_t bytes_sent;            ///< Bytes sent to the slave
+    uint64_t bytes_received;        ///< Bytes received from the slave
+    uint64_t bus_time_us;           ///< Simulated time of all the transactions
+    uint32_t overruns;              ///< Transfers refused because the master used more buffers or data than the slave loaded
+} essl_sim_stats_t;
+
+/**
+ * @brief Initialize a simulated ESSL device and get its handle.
+ *
+ * The simulated slave hasn't loaded any buffer nor data. The master side is used with the ``essl_`` functions, the
+ * slave side with the ``essl_sim_slave_`` functions below, from the same task or another one.
+ *
+ * @param out_handle Output of the handle.
+ * @param config Configuration for the simulated ESSL device.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: ``recv_buffer_size`` is 0
+ *  - ESP_ERR_NO_MEM: memory exhausted.
+ */
+esp_err_t essl_sim_init_dev(essl_handle_t *out_handle, const essl_sim_config_t *config);
+
+/**
+ * @brief Deinitialize and free the simulated ESSL device, with the data not received by either side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_deinit_dev(essl_handle_t handle);
+
+/**
+ * @brief Load receiving buffers on the slave side, increasing the TX buffer num read by the master.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param num Number of buffers of ``recv_buffer_size`` bytes.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_slave_load_buffers(essl_handle_t handle, uint32_t num);
+
+/**
+ * @brief Load data to send on the slave side, increasing the RX data size read by the master, and raise
+ *        ``ESSL_SIM_NEW_PACKET_INTR_MASK``.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param data Data to send, copied.
+ * @param length Length of the data.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle or data passed
+ *  - ESP_ERR_INVALID_SIZE: the data not received by the master would exceed the range of the RX data size counter
+ *  - ESP_ERR_NO_MEM: memory exhausted.
+ */
+esp_err_t essl_sim_slave_send(essl_handle_t handle, const void *data, size_t length);
+
+/**
+ * @brief Get the oldest packet sent by the master on the slave side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param out_data Buffer for the packet.
+ * @param size Size of the buffer.
+ * @param out_length Output of the length of the packet.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle or buffer passed
+ *  - ESP_ERR_NOT_FOUND: the master hasn't sent any packet
+ *  - ESP_ERR_INVALID_SIZE: the packet is larger than the buffer, it is kept
+ */
+esp_err_t essl_sim_slave_recv(essl_handle_t handle, void *out_data, size_t size, size_t *out_length);
+
+/**
+ * @brief Raise interrupts of the master on the slave side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param intr_mask Interrupt bits to raise, ``essl_wait_int`` returns once an enabled one is raised.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_slave_send_intr(essl_handle_t handle, uint32_t intr_mask);
+
+/**
+ * @brief Get and clear the interrupts sent by the master with ``essl_send_slave_intr`` on the slave side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param out_intr Output of the interrupt bits.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_slave_get_intr(essl_handle_t handle, uint32_t *out_intr);
+
+/**
+ * @brief Read a shared register on the slave side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param addr Address of the register, below ``ESSL_SIM_REG_NUM``.
+ * @param out_value Output of the value.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle or address passed
+ */
+esp_err_t essl_sim_slave_read_reg(essl_handle_t handle, uint8_t addr, uint8_t *out_value);
+
+/**
+ * @brief Write a shared register on the slave side.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param addr Address of the register, below ``ESSL_SIM_REG_NUM``.
+ * @param value Value to write.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle or address passed
+ */
+esp_err_t essl_sim_slave_write_reg(essl_handle_t handle, uint8_t addr, uint8_t value);
+
+/**
+ * @brief Get the statistics of the simulated ESSL device.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @param out_stats Output of the statistics.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_get_stats(essl_handle_t handle, essl_sim_stats_t *out_stats);
+
+/**
+ * @brief Reset the statistics of the simulated ESSL device to 0.
+ *
+ * @param handle Handle of the simulated ESSL device.
+ * @return
+ *  - ESP_OK: on success
+ *  - ESP_ERR_INVALID_ARG: wrong handle passed
+ */
+esp_err_t essl_sim_reset_stats(essl_handle_t handle);
+
+#ifdef __cplusplus
+}
+#endif
@@ -23,6 +23,15 @@ typedef struct {
     uint8_t             rx_sync_reg;    ///< The pre-negotiated register ID for Master-RX-Slave-TX synchronization. 1 word (4 Bytes) will be reserved for the synchronization.
 } essl_spi_config_t;
 
+/// Number of transactions queued at a time by ``essl_spi_rddma_iov`` and ``essl_spi_wrdma_iov``. The ``queue_size`` of the SPI device should be at least this.
+#define ESSL_SPI_DMA_IOV_QUEUE_DEPTH    2
+
+/// Segment of a scatter-gather DMA transfer, see ``essl_spi_rddma_iov`` and ``essl_spi_wrdma_iov``
+typedef struct {
+    void    *data;      ///< Buffer of the segment, DMA capable. Only read by ``essl_spi_wrdma_iov``.
+    size_t  len;        ///< Length of the segment, not larger than the maximum transaction length allowed for the SPI device
+} essl_spi_iovec_t;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // APIs for DMA Append Mode
 // This mode has a better performance for continuous Half Duplex SPI transactions.
@@ -229,6 +238,25 @@ esp_err_t essl_spi_wrbuf_polling(spi_device_handle_t spi, const uint8_t *data, i
  */
 esp_err_t essl_spi_rddma(spi_device_handle_t spi, uint8_t *out_data, int len, int seg_len, uint32_t flags);
 
+/**
+ * @brief Receive data into several buffers from the slave through its DMA, one segment per buffer.
+ *
+ * @note Same as :cpp:func:`essl_spi_rddma`, but the segments are received directly into the buffers of ``iov``. Their
+ *       transactions are queued back to back, up to ``ESSL_SPI_DMA_IOV_QUEUE_DEPTH`` at a time, followed by the
+ *       ``rddma_done`` command, so that the bus doesn't stay idle between the segments. Used when the slave is working
+ *       in segment mode.
+ *
+ * @param spi       SPI device handle representing the slave
+ * @param iov       Segments to receive, the buffers must be DMA capable and aligned to 4
+ * @param iovcnt    Number of segments
+ * @param flags     `SPI_TRANS_*` flags to control the transaction mode of the transaction to send.
+ * @return
+ *      - ESP_OK: success
+ *      - ESP_ERR_INVALID_ARG: a buffer is not DMA capable or not aligned, or a segment is empty
+ *      - or other return value from :cpp:func:`spi_device_queue_trans`.
+ */
+esp_err_t essl_spi_rddma_iov(spi_device_handle_t spi, const essl_spi_iovec_t *iov, int iovcnt, uint32_t flags);
+
 /**
  * @brief Read one data segment from the slave through its DMA.
  *
@@ -278,6 +306,25 @@ esp_err_t essl_spi_rddma_done(spi_device_handle_t spi, uint32_t flags);
  */
 esp_err_t essl_spi_wrdma(spi_device_handle_t spi, const uint8_t *data, int len, int seg_len, uint32_t flags);
 
+/**
+ * @brief Send data from several buffers to the slave through its DMA, one segment per buffer.
+ *
+ * @note Same as :cpp:func:`essl_spi_wrdma`, but the segments are sent directly from the buffers of ``iov``, without
+ *       gathering them into one buffer. Their transactions are queued back to back, up to ``ESSL_SPI_DMA_IOV_QUEUE_DEPTH``
+ *       at a time, followed by the ``wrdma_done`` command, so that the bus doesn't stay idle between the segments. Used
+ *       when the slave is working in segment mode.
+ *
+ * @param spi       SPI device handle representing the slave
+ * @param iov       Segments to send, the buffers must be DMA capable
+ * @param iovcnt    Number of segments
+ * @param flags     `SPI_TRANS_*` flags to control the transaction mode of the transaction to send.
+ * @return
+ *      - ESP_OK: success
+ *      - ESP_ERR_INVALID_ARG: a buffer is not DMA capable, or a segment is empty
+ *      - or other return value from :cpp:func:`spi_device_queue_trans`.
+ */
+esp_err_t essl_spi_wrdma_iov(spi_device_handle_t spi, const essl_spi_iovec_t *iov, int iovcnt, uint32_t flags);
+
 /**
  * @brief Send one data segment to the slave through its DMA.
  *
@@ -0,0 +1,241 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "expat_arena.h"
+
+#define EXPAT_ARENA_MIN_CHUNK_SIZE 256
+#define EXPAT_ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+/* Header in front of each allocation, to know its size when it is reallocated and where it comes from */
+typedef struct {
+    size_t size;
+    size_t large;  // allocated from the heap, not from a chunk
+} expat_arena_hdr_t;
+
+typedef struct expat_arena_chunk_t {
+    struct expat_arena_chunk_t *next;
+    size_t size;
+    size_t used;
+    size_t reserved;   // keeps the data 8-byte aligned
+    uint8_t data[];
+} expat_arena_chunk_t;
+
+typedef struct {
+    bool in_use;
+    XML_Parser parser;
+    size_t chunk_size;
+    uint32_t caps;
+    expat_arena_chunk_t *chunks;   // the chunk being filled comes first
+    void *last;                    // last allocation of the first chunk, which can grow or be released in place
+    size_t chunk_count;
+    size_t alloc_count;
+    size_t large_count;
+} expat_arena_t;
+
+static expat_arena_t s_arenas[EXPAT_ARENA_MAX_PARSERS];
+static portMUX_TYPE s_arena_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline size_t expat_arena_footprint(size_t size)
+{
+    return EXPAT_ARENA_ALIGN(sizeof(expat_arena_hdr_t) + size);
+}
+
+static void *expat_arena_malloc(expat_arena_t *arena, size_t size)
+{
+    size_t need = expat_arena_footprint(size);
+    expat_arena_hdr_t *hdr;
+    if (need > arena->chunk_size / 4) {
+        hdr = heap_caps_malloc(sizeof(expat_arena_hdr_t) + size, arena->caps);
+        if (!hdr) {
+            return NULL;
+        }
+        hdr->size = size;
+        hdr->large = 1;
+        arena->large_count++;
+        return hdr + 1;
+    }
+    expat_arena_chunk_t *chunk = arena->chunks;
+    if (!chunk || chunk->size - chunk->used < need) {
+        chunk = heap_caps_malloc(sizeof(expat_arena_chunk_t) + arena->chunk_size, arena->caps);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        chunk->size = arena->chunk_size;
+        chunk->used = 0;
+        arena->chunks = chunk;
+        arena->chunk_count++;
+    }
+    hdr = (expat_arena_hdr_t *)(chunk->data + chunk->used);
+    chunk->used += need;
+    hdr->size = size;
+    hdr->large = 0;
+    arena->last = hdr + 1;
+    arena->alloc_count++;
+    return hdr + 1;
+}
+
+static void expat_arena_free(expat_arena_t *arena, void *p)
+{
+    if (!p) {
+        return;
+    }
+    expat_arena_hdr_t *hdr = (expat_arena_hdr_t *)p - 1;
+    if (hdr->large) {
+        heap_caps_free(hdr);
+    } else if (p == arena->last) {
+        arena->chunks->used -= expat_arena_footprint(hdr->size);
+        arena->last = NULL;
+    }
+    // the other allocations are released with the arena
+}
+
+static void *expat_arena_realloc(expat_arena_t *arena, void *p, size_t size)
+{
+    if (!p) {
+        return expat_arena_malloc(arena, size);
+    }
+    expat_arena_hdr_t *hdr = (expat_arena_hdr_t *)p - 1;
+    if (hdr->large) {
+        hdr = heap_caps_realloc(hdr, sizeof(expat_arena_hdr_t) + size, arena->caps);
+        if (!hdr) {
+            return NULL;
+        }
+        hdr->size = size;
+        return hdr + 1;
+    }
+    if (size <= hdr->size) {
+        return p;
+    }
+    // the last allocation grows in place while the chunk has room
+    if (p == arena->last) {
+        expat_arena_chunk_t *chunk = arena->chunks;
+        size_t extra = expat_arena_footprint(size) - expat_arena_footprint(hdr->size);
+        if (expat_arena_footprint(size) <= arena->chunk_size / 4 && chunk->size - chunk->used >= extra) {
+            chunk->used += extra;
+            hdr->size = size;
+            return p;
+        }
+    }
+    void *new_p = expat_arena_malloc(arena, size);
+    if (new_p) {
+        memcpy(new_p, p, hdr->size);
+    }
+    return new_p;
+}
+
+#define EXPAT_ARENA_SUITE_FUNCS(i)                                                                                    \
+    static void *expat_arena_malloc_##i(size_t size) { return expat_arena_malloc(&s_arenas[i], size); }               \
+    static void *expat_arena_realloc_##i(void *p, size_t size) { return expat_arena_realloc(&s_arenas[i], p, size); } \
+    static void expat_arena_free_##i(void *p) { expat_arena_free(&s_arenas[i], p); }
+
+#define EXPAT_ARENA_SUITE(i) { expat_arena_malloc_##i, expat_arena_realloc_##i, expat_arena_free_##i }
+
+/* The memory functions of expat have no context, each arena has its own set */
+EXPAT_ARENA_SUITE_FUNCS(0)
+EXPAT_ARENA_SUITE_FUNCS(1)
+EXPAT_ARENA_SUITE_FUNCS(2)
+EXPAT_ARENA_SUITE_FUNCS(3)
+EXPAT_ARENA_SUITE_FUNCS(4)
+EXPAT_ARENA_SUITE_FUNCS(5)
+EXPAT_ARENA_SUITE_FUNCS(6)
+EXPAT_ARENA_SUITE_FUNCS(7)
+
+static const XML_Memory_Handling_Suite s_arena_suites[EXPAT_ARENA_MAX_PARSERS] = {
+    EXPAT_ARENA_SUITE(0), EXPAT_ARENA_SUITE(1), EXPAT_ARENA_SUITE(2), EXPAT_ARENA_SUITE(3),
+    EXPAT_ARENA_SUITE(4), EXPAT_ARENA_SUITE(5), EXPAT_ARENA_SUITE(6), EXPAT_ARENA_SUITE(7),
+};
+
+static void expat_arena_release(expat_arena_t *arena)
+{
+    expat_arena_chunk_t *chunk = arena->chunks;
+    while (chunk) {
+        expat_arena_chunk_t *next = chunk->next;
+        heap_caps_free(chunk);
+        chunk = next;
+    }
+    portENTER_CRITICAL(&s_arena_lock);
+    memset(arena, 0, sizeof(*arena));
+    portEXIT_CRITICAL(&s_arena_lock);
+}
+
+static expat_arena_t *expat_arena_of_parser(XML_Parser parser)
+{
+    expat_arena_t *arena = NULL;
+    portENTER_CRITICAL(&s_arena_lock);
+    for (int i = 0; i < EXPAT_ARENA_MAX_PARSERS; i++) {
+        if (s_arenas[i].in_use && s_arenas[i].parser == parser) {
+            arena = &s_arenas[i];
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_arena_lock);
+    return arena;
+}
+
+XML_Parser expat_arena_parser_create(const expat_arena_config_t *config, const XML_Char *encoding,
+                                     const XML_Char *namespace_separator)
+{
+    if (!config || config->chunk_size < EXPAT_ARENA_MIN_CHUNK_SIZE) {
+        return NULL;
+    }
+    int index = -1;
+    portENTER_CRITICAL(&s_arena_lock);
+    for (int i = 0; i < EXPAT_ARENA_MAX_PARSERS; i++) {
+        if (!s_arenas[i].in_use) {
+            s_arenas[i].in_use = true;
+            index = i;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_arena_lock);
+    if (index < 0) {
+        return NULL;
+    }
+    expat_arena_t *arena = &s_arenas[index];
+    arena->chunk_size = EXPAT_ARENA_ALIGN(config->chunk_size);
+    arena->caps = config->caps ? config->caps : MALLOC_CAP_DEFAULT;
+    XML_Parser parser = XML_ParserCreate_MM(encoding, &s_arena_suites[index], namespace_separator);
+    if (!parser) {
+        expat_arena_release(arena);
+        return NULL;
+    }
+    arena->parser = parser;
+    return parser;
+}
+
+void expat_arena_parser_free(XML_Parser parser)
+{
+    expat_arena_t *arena = expat_arena_of_parser(parser);
+    if (!arena) {
+        return;
+    }
+    XML_ParserFree(parser);
+    expat_arena_release(arena);
+}
+
+esp_err_t expat_arena_get_stats(XML_Parser parser, expat_arena_stats_t *ret_stats)
+{
+    if (!parser || !ret_stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    expat_arena_t *arena = expat_arena_of_parser(parser);
+    if (!arena) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    memset(ret_stats, 0, sizeof(*ret_stats));
+    for (expat_arena_chunk_t *chunk = arena->chunks; chunk; chunk = chunk->next) {
+        ret_stats->arena_size += chunk->size;
+        ret_stats->arena_used += chunk->used;
+    }
+    ret_stats->chunk_count = arena->chunk_count;
+    ret_stats->alloc_count = arena->alloc_count;
+    ret_stats->large_count = arena->large_count;
+    return ESP_OK;
+}
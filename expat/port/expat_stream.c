@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <limits.h>
+#include "expat_stream.h"
+
+esp_err_t expat_stream_parse(XML_Parser parser, expat_stream_read_cb_t read, void *arg, size_t chunk_size)
+{
+    if (!parser || !read || chunk_size == 0 || chunk_size > INT_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    while (1) {
+        void *buf = XML_GetBuffer(parser, (int)chunk_size);
+        if (!buf) {
+            // also fails when the parser is already stopped or finished
+            return XML_GetErrorCode(parser) == XML_ERROR_NO_MEMORY ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_STATE;
+        }
+        int len = read(arg, buf, chunk_size);
+        if (len < 0) {
+            return ESP_FAIL;
+        }
+        const XML_Bool is_final = len == 0;
+        switch (XML_ParseBuffer(parser, len, is_final)) {
+        case XML_STATUS_OK:
+            if (is_final) {
+                return ESP_OK;
+            }
+            break;
+        case XML_STATUS_SUSPENDED:
+            return ESP_ERR_NOT_FINISHED;
+        default:
+            return XML_GetErrorCode(parser) == XML_ERROR_ABORTED ? ESP_ERR_NOT_FINISHED : ESP_ERR_INVALID_RESPONSE;
+        }
+    }
+}
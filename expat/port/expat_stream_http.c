@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "expat_stream_http.h"
+
+static int expat_stream_http_read(void *arg, void *buf, size_t len)
+{
+    esp_http_client_handle_t client = (esp_http_client_handle_t)arg;
+    int ret;
+    do {
+        ret = esp_http_client_read(client, (char *)buf, (int)len);
+    } while (ret == -ESP_ERR_HTTP_EAGAIN);
+    return ret;
+}
+
+esp_err_t expat_stream_parse_http(XML_Parser parser, esp_http_client_handle_t client, size_t chunk_size)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return expat_stream_parse(parser, expat_stream_http_read, client, chunk_size);
+}
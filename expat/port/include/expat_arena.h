@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "expat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of arena parsers existing at the same time
+ */
+#define EXPAT_ARENA_MAX_PARSERS 8
+
+/**
+ * @brief Configuration of the arena of a parser
+ */
+typedef struct {
+    size_t chunk_size; /*!< Size of the chunks the arena is made of, the first one is allocated with the parser */
+    uint32_t caps;     /*!< Heap capabilities of the chunks, e.g. MALLOC_CAP_INTERNAL or MALLOC_CAP_SPIRAM,
+                            0 for MALLOC_CAP_DEFAULT */
+} expat_arena_config_t;
+
+/**
+ * @brief Default configuration of an arena, with 4 KB chunks in the default memory
+ */
+#define EXPAT_ARENA_DEFAULT_CONFIG() \
+    {                                \
+        .chunk_size = 4096,          \
+        .caps = 0,                   \
+    }
+
+/**
+ * @brief Usage statistics of the arena of a parser
+ */
+typedef struct {
+    size_t chunk_count;      /*!< Number of chunks allocated */
+    size_t arena_size;       /*!< Total size of the chunks, in bytes */
+    size_t arena_used;       /*!< Bytes taken in the chunks, freed allocations included */
+    size_t alloc_count;      /*!< Number of allocations served from the chunks */
+    size_t large_count;      /*!< Number of allocations too large for a chunk, taken from the heap */
+} expat_arena_stats_t;
+
+/**
+ * @brief Create a parser which takes its memory from an arena, the counterpart of `XML_ParserCreate_MM()`
+ *
+ * The small allocations of the parser, such as the names, the attributes and the hash tables, are taken in turn from
+ * large chunks and are only released all at once, when the parser is freed. This replaces the thousands of heap
+ * allocations of a large document by a few ones. The memory freed by the parser is not reused, except for the last
+ * allocation, so the arena grows up to the total memory allocated during the parse; the allocations larger than a
+ * quarter of a chunk, such as the input buffer, come from the heap and are freed as usual.
+ *
+ * @note The parser must be freed with `expat_arena_parser_free()`, not `XML_ParserFree()`
+ * @note `XML_ParserReset()` is not supported, as it would keep the arena growing. Free and create a new parser instead
+ * @note The chunks must be at least 256 bytes long
+ *
+ * @param config Configuration of the arena
+ * @param encoding Encoding of the document, as for `XML_ParserCreate()`, can be NULL
+ * @param namespace_separator Namespace separator, as for `XML_ParserCreateNS()`, NULL without namespace processing
+ * @return The parser, or NULL if out of memory, if the configuration is invalid or if there are already
+ *         EXPAT_ARENA_MAX_PARSERS arena parsers
+ */
+XML_Parser expat_arena_parser_create(const expat_arena_config_t *config, const XML_Char *encoding,
+                                     const XML_Char *namespace_separator);
+
+/**
+ * @brief Free a parser created by `expat_arena_parser_create()` and its arena
+ *
+ * @param parser Parser
+ */
+void expat_arena_parser_free(XML_Parser parser);
+
+/**
+ * @brief Get the usage statistics of the arena of a parser
+ *
+ * @param parser Parser created by `expat_arena_parser_create()`
+ * @param ret_stats Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ *      - ESP_ERR_NOT_FOUND: Get statistics failed because the parser has no arena
+ */
+esp_err_t expat_arena_get_stats(XML_Parser parser, expat_arena_stats_t *ret_stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,51 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "expat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function reading the next bytes of a document
+ *
+ * @param arg User argument passed to `expat_stream_parse()`
+ * @param buf Buffer to fill, inside the input buffer of the parser
+ * @param len Size of the buffer
+ * @return Number of bytes read, 0 at the end of the document, negative on error
+ */
+typedef int (*expat_stream_read_cb_t)(void *arg, void *buf, size_t len);
+
+/**
+ * @brief Parse a document as it is read, in fixed size pieces
+ *
+ * Each piece is read straight into the input buffer of the parser, given by `XML_GetBuffer()`, and parsed with
+ * `XML_ParseBuffer()`, so the document is never copied nor held in memory as a whole. A handler can call
+ * `XML_StopParser()` once it has found what it was looking for, the parsing and the reading then stop at once,
+ * without reading the rest of the document.
+ *
+ * @param parser Parser, with its handlers set
+ * @param read Function reading the document
+ * @param arg User argument passed to the function
+ * @param chunk_size Size of the pieces, in bytes
+ * @return
+ *      - ESP_OK: The whole document was parsed
+ *      - ESP_ERR_NOT_FINISHED: The parsing was stopped by `XML_StopParser()` before the end of the document
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_INVALID_STATE: The parser was already stopped or finished
+ *      - ESP_ERR_INVALID_RESPONSE: The document is not well-formed, see `XML_GetErrorCode()`
+ *      - ESP_ERR_NO_MEM: Out of memory for the input buffer
+ *      - ESP_FAIL: The function reading the document failed
+ */
+esp_err_t expat_stream_parse(XML_Parser parser, expat_stream_read_cb_t read, void *arg, size_t chunk_size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "esp_http_client.h"
+#include "expat_stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Parse the body of an HTTP response as it is received, see `expat_stream_parse()`
+ *
+ * The client must be opened with `esp_http_client_open()`, the request sent and the headers fetched with
+ * `esp_http_client_fetch_headers()`. The body is read with `esp_http_client_read()`, which also decodes the chunked
+ * transfer encoding. When a handler stops the parser, the rest of the body is not downloaded: close the connection
+ * with `esp_http_client_close()`.
+ *
+ * @note Only built when the esp_http_client component is part of the project
+ *
+ * @param parser Parser, with its handlers set
+ * @param client HTTP client, with the headers of the response fetched
+ * @param chunk_size Size of the pieces read from the connection, in bytes
+ * @return See `expat_stream_parse()`, ESP_FAIL being a read error of the connection
+ */
+esp_err_t expat_stream_parse_http(XML_Parser parser, esp_http_client_handle_t client, size_t chunk_size);
+
+#ifdef __cplusplus
+}
+#endif
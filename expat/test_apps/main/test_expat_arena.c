@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <expat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#include "expat_arena.h"
+
+#define TEST_PAGE "<html><title>Page title</title><body><h>header</h><ol><li id=\"a\">A</li>"\
+                  "<li id=\"b\">B</li><li id=\"c\">C</li></ol></body></html>"
+#define TEST_PAGE_REPEAT 200
+
+typedef struct {
+    int elements;
+    int attributes;
+    int depth;
+} counts_t;
+
+static void XMLCALL count_start(void *userData, const XML_Char *name, const XML_Char **atts)
+{
+    counts_t *counts = (counts_t *) userData;
+
+    counts->elements++;
+    counts->depth++;
+    for (; *atts; atts += 2) {
+        counts->attributes++;
+    }
+}
+
+static void XMLCALL count_end(void *userData, const XML_Char *name)
+{
+    counts_t *counts = (counts_t *) userData;
+
+    counts->depth--;
+}
+
+/* The test page, repeated in a root element */
+static char *make_document(size_t *ret_len)
+{
+    const size_t page_len = strlen(TEST_PAGE);
+    const size_t len = strlen("<root>") + page_len * TEST_PAGE_REPEAT + strlen("</root>");
+    char *doc = malloc(len + 1);
+    TEST_ASSERT_NOT_NULL(doc);
+
+    strcpy(doc, "<root>");
+    for (int i = 0; i < TEST_PAGE_REPEAT; i++) {
+        memcpy(doc + strlen("<root>") + i * page_len, TEST_PAGE, page_len);
+    }
+    strcpy(doc + len - strlen("</root>"), "</root>");
+    *ret_len = len;
+    return doc;
+}
+
+/* Parse in 512-byte pieces, as from a network stream */
+static int64_t parse_document(XML_Parser parser, const char *doc, size_t len, counts_t *counts)
+{
+    memset(counts, 0, sizeof(*counts));
+    XML_SetUserData(parser, counts);
+    XML_SetElementHandler(parser, count_start, count_end);
+
+    int64_t start = esp_timer_get_time();
+    for (size_t off = 0; off < len; off += 512) {
+        const size_t piece = len - off < 512 ? len - off : 512;
+        TEST_ASSERT_NOT_EQUAL(XML_STATUS_ERROR, XML_Parse(parser, doc + off, piece, off + piece == len));
+    }
+    return esp_timer_get_time() - start;
+}
+
+static void test_arena_parse(uint32_t caps)
+{
+    size_t len;
+    char *doc = make_document(&len);
+    counts_t counts;
+    expat_arena_config_t config = EXPAT_ARENA_DEFAULT_CONFIG();
+    config.caps = caps;
+
+    XML_Parser parser = expat_arena_parser_create(&config, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(parser);
+    parse_document(parser, doc, len, &counts);
+    TEST_ASSERT_EQUAL(1 + 9 * TEST_PAGE_REPEAT, counts.elements);
+    TEST_ASSERT_EQUAL(3 * TEST_PAGE_REPEAT, counts.attributes);
+    TEST_ASSERT_EQUAL(0, counts.depth);
+
+    expat_arena_stats_t stats;
+    TEST_ESP_OK(expat_arena_get_stats(parser, &stats));
+    TEST_ASSERT_GREATER_THAN(0, stats.chunk_count);
+    TEST_ASSERT_LESS_OR_EQUAL(stats.arena_size, stats.arena_used);
+    expat_arena_parser_free(parser);
+    free(doc);
+}
+
+TEST_CASE("Expat parses XML with an arena", "[expat]")
+{
+    test_arena_parse(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+#if CONFIG_SPIRAM
+TEST_CASE("Expat parses XML with an arena in PSRAM", "[expat]")
+{
+    test_arena_parse(MALLOC_CAP_SPIRAM);
+}
+#endif
+
+TEST_CASE("Expat arena parsers are limited", "[expat]")
+{
+    expat_arena_config_t config = EXPAT_ARENA_DEFAULT_CONFIG();
+    XML_Parser parsers[EXPAT_ARENA_MAX_PARSERS];
+
+    for (int i = 0; i < EXPAT_ARENA_MAX_PARSERS; i++) {
+        parsers[i] = expat_arena_parser_create(&config, NULL, NULL);
+        TEST_ASSERT_NOT_NULL(parsers[i]);
+    }
+    TEST_ASSERT_NULL(expat_arena_parser_create(&config, NULL, NULL));
+    for (int i = 0; i < EXPAT_ARENA_MAX_PARSERS; i++) {
+        expat_arena_parser_free(parsers[i]);
+    }
+
+    config.chunk_size = 16;
+    TEST_ASSERT_NULL(expat_arena_parser_create(&config, NULL, NULL));
+}
+
+TEST_CASE("Expat arena performance", "[expat]")
+{
+    size_t len;
+    char *doc = make_document(&len);
+    counts_t counts;
+    expat_arena_config_t config = EXPAT_ARENA_DEFAULT_CONFIG();
+
+    XML_Parser parser = XML_ParserCreate(NULL);
+    TEST_ASSERT_NOT_NULL(parser);
+    const int64_t malloc_us = parse_document(parser, doc, len, &counts);
+    XML_ParserFree(parser);
+
+    parser = expat_arena_parser_create(&config, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(parser);
+    const int64_t arena_us = parse_document(parser, doc, len, &counts);
+    expat_arena_stats_t stats;
+    TEST_ESP_OK(expat_arena_get_stats(parser, &stats));
+    int64_t start = esp_timer_get_time();
+    expat_arena_parser_free(parser);
+    const int64_t arena_free_us = esp_timer_get_time() - start;
+
+    printf("%u bytes: malloc %lld us, arena %lld us and %lld us to free, %u chunks, %u allocations, %u from heap\n",
+           (unsigned)len, malloc_us, arena_us, arena_free_us, (unsigned)stats.chunk_count,
+           (unsigned)stats.alloc_count, (unsigned)stats.large_count);
+    free(doc);
+}
@@ -0,0 +1,108 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <expat.h>
+#include <string.h>
+#include "unity.h"
+#include "expat_stream.h"
+
+static const char test_in[] = "<html><title>Page title</title><body><h>header</h><ol><li>A</li>"\
+                              "<li>B</li><li>C</li></ol></body></html>";
+
+typedef struct {
+    const char *doc;
+    size_t len;
+    size_t off;
+} source_t;
+
+typedef struct {
+    XML_Parser parser;
+    const char *target;
+    int elements;
+    XML_Bool resumable;
+} search_t;
+
+/* Gives at most 5 bytes per read, as a slow connection would */
+static int read_source(void *arg, void *buf, size_t len)
+{
+    source_t *source = (source_t *) arg;
+    size_t n = source->len - source->off;
+
+    n = n < len ? n : len;
+    n = n < 5 ? n : 5;
+    memcpy(buf, source->doc + source->off, n);
+    source->off += n;
+    return n;
+}
+
+static int read_failure(void *arg, void *buf, size_t len)
+{
+    return -1;
+}
+
+static void XMLCALL search_start(void *userData, const XML_Char *name, const XML_Char **atts)
+{
+    search_t *search = (search_t *) userData;
+
+    search->elements++;
+    if (search->target && strcmp(name, search->target) == 0) {
+        XML_StopParser(search->parser, search->resumable);
+    }
+}
+
+static esp_err_t stream_parse(const char *doc, const char *target, XML_Bool resumable, search_t *search,
+                              source_t *source)
+{
+    source->doc = doc;
+    source->len = strlen(doc);
+    source->off = 0;
+    search->parser = XML_ParserCreate(NULL);
+    search->target = target;
+    search->elements = 0;
+    search->resumable = resumable;
+    TEST_ASSERT_NOT_NULL(search->parser);
+    XML_SetUserData(search->parser, search);
+    XML_SetStartElementHandler(search->parser, search_start);
+
+    esp_err_t ret = expat_stream_parse(search->parser, read_source, source, 16);
+    XML_ParserFree(search->parser);
+    return ret;
+}
+
+TEST_CASE("Expat parses a stream", "[expat]")
+{
+    search_t search;
+    source_t source;
+
+    TEST_ESP_OK(stream_parse(test_in, NULL, XML_FALSE, &search, &source));
+    TEST_ASSERT_EQUAL(8, search.elements);
+    TEST_ASSERT_EQUAL(source.len, source.off);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_RESPONSE, stream_parse("<html><title></html>", NULL, XML_FALSE, &search, &source));
+}
+
+TEST_CASE("Expat stops a stream at the target element", "[expat]")
+{
+    search_t search;
+    source_t source;
+
+    for (int resumable = 0; resumable < 2; resumable++) {
+        TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, stream_parse(test_in, "h", resumable, &search, &source));
+        TEST_ASSERT_EQUAL(4, search.elements);
+        // the rest of the document is not read
+        TEST_ASSERT_LESS_THAN(source.len, source.off);
+    }
+}
+
+TEST_CASE("Expat stream reports read errors", "[expat]")
+{
+    XML_Parser parser = XML_ParserCreate(NULL);
+
+    TEST_ASSERT_NOT_NULL(parser);
+    TEST_ASSERT_EQUAL(ESP_FAIL, expat_stream_parse(parser, read_failure, NULL, 16));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, expat_stream_parse(parser, read_source, NULL, 0));
+    XML_ParserFree(parser);
+}
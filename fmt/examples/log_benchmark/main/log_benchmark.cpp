@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: CC0-1.0
+ */
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_fmt_log.hpp"
+
+/*
+ * Logs the same lines with ESP_LOGI() and ESP_FMT_LOGI(), and counts the CPU cycles and the heap allocations it
+ * takes. To time the logging and not the console, both go to a sink copying the line into a buffer: ESP_LOG through
+ * esp_log_set_vprintf(), formatting with vsnprintf() as vprintf() would, ESP_FMT_LOG through esp_fmt_log_set_sink().
+ */
+
+#define BENCH_ITERATIONS 1000
+
+static const char *TAG = "bench";
+
+static char s_sink_buf[256];
+static size_t s_sink_len;
+
+static int bench_vprintf(const char *format, va_list args)
+{
+    int len = vsnprintf(s_sink_buf, sizeof(s_sink_buf), format, args);
+    s_sink_len = len;
+    return len;
+}
+
+static void bench_sink(const char *line, size_t len)
+{
+    len = len < sizeof(s_sink_buf) ? len : sizeof(s_sink_buf);
+    memcpy(s_sink_buf, line, len);
+    s_sink_len = len;
+}
+
+/* Heap allocations made by the benchmark task, counted with CONFIG_HEAP_USE_HOOKS */
+static std::atomic<uint32_t> s_alloc_count;
+static TaskHandle_t s_counted_task;
+
+extern "C" void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (s_counted_task && xTaskGetCurrentTaskHandle() == s_counted_task) {
+        s_alloc_count++;
+    }
+}
+
+extern "C" void esp_heap_trace_free_hook(void *ptr)
+{
+}
+
+template<typename F>
+static void bench_run(const char *name, F &&log_line)
+{
+    log_line(0); // first call out of the measure, e.g. for the lazy init of newlib
+    s_alloc_count = 0;
+    s_counted_task = xTaskGetCurrentTaskHandle();
+    uint32_t start = esp_cpu_get_cycle_count();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        log_line(i);
+    }
+    uint32_t cycles = esp_cpu_get_cycle_count() - start;
+    s_counted_task = NULL;
+    printf("%-28s %8" PRIu32 " cycles per line, %" PRIu32 " heap allocations, last line: %.*s", name,
+           cycles / BENCH_ITERATIONS, s_alloc_count.load(), (int)s_sink_len, s_sink_buf);
+}
+
+extern "C" void app_main(void)
+{
+    const char *state = "connected";
+    float rssi = -61.5f;
+
+    vprintf_like_t prev_vprintf = esp_log_set_vprintf(bench_vprintf);
+    esp_fmt_log_sink_t prev_sink = esp_fmt_log_set_sink(bench_sink);
+
+    bench_run("ESP_LOGI, integers", [&](int i) {
+        ESP_LOGI(TAG, "sample %d, value %" PRIu32 ", flags 0x%04x", i, (uint32_t)i * 7, i & 0xffff);
+    });
+    bench_run("ESP_FMT_LOGI, integers", [&](int i) {
+        ESP_FMT_LOGI(TAG, "sample {}, value {}, flags 0x{:04x}", i, (uint32_t)i * 7, i & 0xffff);
+    });
+    bench_run("ESP_LOGI, float and string", [&](int i) {
+        ESP_LOGI(TAG, "link %s, rssi %.1f dBm, retry %d", state, rssi, i);
+    });
+    bench_run("ESP_FMT_LOGI, float and string", [&](int i) {
+        ESP_FMT_LOGI(TAG, "link {}, rssi {:.1f} dBm, retry {}", state, rssi, i);
+    });
+
+    esp_log_set_vprintf(prev_vprintf);
+    esp_fmt_log_set_sink(prev_sink);
+
+    ESP_FMT_LOGI(TAG, "Benchmark done, {} lines per case", BENCH_ITERATIONS);
+}
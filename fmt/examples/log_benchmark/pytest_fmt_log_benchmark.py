@@ -0,0 +1,13 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Unlicense OR CC0-1.0
+
+import pytest
+from pytest_embedded import Dut
+
+
+@pytest.mark.generic
+def test_fmt_log_benchmark(dut: Dut) -> None:
+    for case in ['ESP_LOGI, integers', 'ESP_FMT_LOGI, integers',
+                 'ESP_LOGI, float and string', 'ESP_FMT_LOGI, float and string']:
+        dut.expect(case + r'\s+\d+ cycles per line')
+    dut.expect_exact('Benchmark done, 1000 lines per case')
@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <atomic>
+#include <cstdio>
+#include "esp_fmt_log.hpp"
+
+static void default_sink(const char *line, size_t len)
+{
+    // stdout is line-buffered, as for ESP_LOG the line goes out at its newline
+    fwrite(line, 1, len, stdout);
+}
+
+static std::atomic<esp_fmt_log_sink_t> s_sink{default_sink};
+
+esp_fmt_log_sink_t esp_fmt_log_set_sink(esp_fmt_log_sink_t sink)
+{
+    return s_sink.exchange(sink ? sink : default_sink);
+}
+
+void esp_fmt_log_write(const char *line, size_t len)
+{
+    s_sink.load(std::memory_order_relaxed)(line, len);
+}
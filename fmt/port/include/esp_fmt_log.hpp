@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+#include <fmt/format.h>
+#include "sdkconfig.h"
+#include "esp_idf_version.h"
+#include "esp_log.h"
+
+/*
+ * Logging with fmt
+ *
+ * ESP_FMT_LOGE() to ESP_FMT_LOGV() log the same lines as ESP_LOGE() to ESP_LOGV(), e.g. "I (1234) tag: message",
+ * with a format string of fmt, checked against the arguments at build time with FMT_STRING(). The line is formatted
+ * with fmt::format_to_n() into a buffer of CONFIG_FMT_LOG_BUFFER_SIZE bytes on the stack of the calling task, and
+ * given to the log sink in one piece: there is no heap allocation, no vprintf() and no lock but the one of the sink.
+ *
+ * FMT_COMPILE() is not used: format_to_n() writes the output of a compiled format one character at a time, to
+ * truncate it, which makes it slower than the parsed format, which is copied in bulk.
+ *
+ * The levels are filtered as with ESP_LOG, at build time by LOG_LOCAL_LEVEL and at run time by
+ * `esp_log_level_set()`. The lines longer than the buffer are truncated.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Function receiving the formatted log lines
+ *
+ * @param line Log line, ended by a newline, not NUL-terminated
+ * @param len Length of the line, in bytes
+ */
+typedef void (*esp_fmt_log_sink_t)(const char *line, size_t len);
+
+/**
+ * @brief Set the function receiving the log lines of ESP_FMT_LOG, e.g. writing them to a UART, to apptrace or to a
+ *        ring buffer
+ *
+ * @note The sink is called from the tasks logging, it must be thread-safe
+ *
+ * @param sink Sink, NULL for the default one, writing the lines to stdout as ESP_LOG does
+ * @return The previous sink
+ */
+esp_fmt_log_sink_t esp_fmt_log_set_sink(esp_fmt_log_sink_t sink);
+
+/**
+ * @brief Write a log line to the current sink
+ *
+ * @param line Log line
+ * @param len Length of the line, in bytes
+ */
+void esp_fmt_log_write(const char *line, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace esp_fmt_log {
+
+#if CONFIG_LOG_COLORS
+#define ESP_FMT_LOG_COLOR(c) "\033[0;" #c "m"
+constexpr const char *level_prefix[] = {"", ESP_FMT_LOG_COLOR(31) "E", ESP_FMT_LOG_COLOR(33) "W",
+                                        ESP_FMT_LOG_COLOR(32) "I", "D", "V"
+                                       };
+constexpr const char *level_suffix[] = {"", "\033[0m\n", "\033[0m\n", "\033[0m\n", "\n", "\n"};
+#undef ESP_FMT_LOG_COLOR
+#else
+constexpr const char *level_prefix[] = {"", "E", "W", "I", "D", "V"};
+constexpr const char *level_suffix[] = {"", "\n", "\n", "\n", "\n", "\n"};
+#endif
+
+template <typename S, typename... T>
+inline void log(esp_log_level_t level, const char *tag, const S &format_str, const T &...args)
+{
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+    if (level > esp_log_level_get(tag)) {
+        return;
+    }
+#endif
+    char line[CONFIG_FMT_LOG_BUFFER_SIZE];
+    const char *suffix = level_suffix[level];
+    const size_t suffix_len = std::char_traits<char>::length(suffix);
+    const size_t size = sizeof(line) - suffix_len;
+
+    auto res = fmt::format_to_n(line, size, FMT_STRING("{} ({}) {}: "), level_prefix[level], esp_log_timestamp(), tag);
+    size_t len = res.size < size ? res.size : size;
+    res = fmt::format_to_n(line + len, size - len, format_str, args...);
+    len += res.size < size - len ? res.size : size - len;
+    for (size_t i = 0; i < suffix_len; i++) {
+        line[len++] = suffix[i];
+    }
+    esp_fmt_log_write(line, len);
+}
+
+} // namespace esp_fmt_log
+
+#define ESP_FMT_LOG_LEVEL(level, tag, format, ...) do {                                 \
+        if (LOG_LOCAL_LEVEL >= level) {                                                 \
+            esp_fmt_log::log(level, tag, FMT_STRING(format), ##__VA_ARGS__);            \
+        }                                                                               \
+    } while (0)
+
+#define ESP_FMT_LOGE(tag, format, ...) ESP_FMT_LOG_LEVEL(ESP_LOG_ERROR,   tag, format, ##__VA_ARGS__)
+#define ESP_FMT_LOGW(tag, format, ...) ESP_FMT_LOG_LEVEL(ESP_LOG_WARN,    tag, format, ##__VA_ARGS__)
+#define ESP_FMT_LOGI(tag, format, ...) ESP_FMT_LOG_LEVEL(ESP_LOG_INFO,    tag, format, ##__VA_ARGS__)
+#define ESP_FMT_LOGD(tag, format, ...) ESP_FMT_LOG_LEVEL(ESP_LOG_DEBUG,   tag, format, ##__VA_ARGS__)
+#define ESP_FMT_LOGV(tag, format, ...) ESP_FMT_LOG_LEVEL(ESP_LOG_VERBOSE, tag, format, ##__VA_ARGS__)
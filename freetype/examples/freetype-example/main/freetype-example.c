@@ -5,12 +5,17 @@
  */
 
 
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
 #include "esp_log.h"
 #include "esp_err.h"
 #include "esp_spiffs.h"
+#include "esp_timer.h"
 #include "ft2build.h"
 #include FT_FREETYPE_H
+#include "esp_ft_glyph_cache.h"
 
 static const char *TAG = "example";
 
@@ -18,12 +23,14 @@ static void init_filesystem(void);
 static void init_freetype(void);
 static void load_font(void);
 static void render_text(void);
+static int draw_text(const char *text, bool log_chars);
 
 #define BITMAP_WIDTH  80
 #define BITMAP_HEIGHT 18
 
 static FT_Library  s_library;
 static FT_Face s_face;
+static esp_ft_glyph_cache_handle_t s_glyph_cache;
 static uint8_t s_bitmap[BITMAP_HEIGHT][BITMAP_WIDTH];
 
 
@@ -83,7 +90,42 @@ static void render_text(void)
         abort();
     }
 
+    /* Keep the rendered glyphs, in PSRAM when there is some, so drawing the text again skips FreeType */
+    esp_ft_glyph_cache_config_t cache_config = ESP_FT_GLYPH_CACHE_DEFAULT_CONFIG();
+    ESP_ERROR_CHECK(esp_ft_glyph_cache_new(&cache_config, &s_glyph_cache));
+
     const char *text = "FreeType";
+    int64_t start = esp_timer_get_time();
+    int x = draw_text(text, true);
+    int64_t first_us = esp_timer_get_time() - start;
+
+    /* Draw the same text again, e.g. when a UI redraws a label, from the glyph cache */
+    start = esp_timer_get_time();
+    draw_text(text, false);
+    int64_t cached_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "Text drawn in %" PRIi64 " us, then in %" PRIi64 " us from the glyph cache", first_us, cached_us);
+
+    /* output the resulting bitmap to console */
+    for (int iy = 0; iy < BITMAP_HEIGHT; iy++) {
+        for (int ix = 0; ix < x; ix++) {
+            int val = s_bitmap[iy][ix];
+            if (val > 127) {
+                putchar('#');
+            } else if (val > 64) {
+                putchar('+');
+            } else if (val > 32) {
+                putchar('.');
+            } else {
+                putchar(' ');
+            }
+        }
+        putchar('\n');
+    }
+}
+
+/* Draws a line of text into the bitmap, returns its width */
+static int draw_text(const char *text, bool log_chars)
+{
     int num_chars = strlen(text);
 
     /* current drawing position */
@@ -91,60 +133,32 @@ static void render_text(void)
     int y = 12;
 
     for (int n = 0; n < num_chars; n++) {
-        ESP_LOGI(TAG, "Rendering char: '%c'", text[n]);
-
-        /* retrieve glyph index from character code */
-        FT_UInt  glyph_index = FT_Get_Char_Index( s_face, text[n] );
-
-        /* load glyph image into the slot (erase previous one) */
-        error = FT_Load_Glyph( s_face, glyph_index, FT_LOAD_DEFAULT );
-        if (error) {
-            ESP_LOGE(TAG, "Error loading glyph: %d", error);
-            abort();
+        if (log_chars) {
+            ESP_LOGI(TAG, "Rendering char: '%c'", text[n]);
         }
 
-        /* convert to a bitmap */
-        error = FT_Render_Glyph( s_face->glyph, FT_RENDER_MODE_NORMAL );
-        if (error) {
-            ESP_LOGE(TAG, "Error rendering glyph: %d", error);
-            abort();
-        }
+        /* get the glyph bitmap, rendered by FreeType the first time only */
+        const esp_ft_glyph_t *glyph;
+        ESP_ERROR_CHECK(esp_ft_glyph_cache_get_char(s_glyph_cache, s_face, text[n], &glyph));
 
         /* copy the glyph bitmap into the overall bitmap */
-        FT_GlyphSlot slot = s_face->glyph;
-        for (int iy = 0; iy < slot->bitmap.rows; iy++) {
-            for (int ix = 0; ix < slot->bitmap.width; ix++) {
+        for (int iy = 0; iy < glyph->rows; iy++) {
+            for (int ix = 0; ix < glyph->width; ix++) {
                 /* bounds check */
                 int res_x = ix + x;
-                int res_y = y + iy - slot->bitmap_top;
-                if (res_x >= BITMAP_WIDTH || res_y >= BITMAP_HEIGHT) {
+                int res_y = y + iy - glyph->top;
+                if (res_x >= BITMAP_WIDTH || res_y < 0 || res_y >= BITMAP_HEIGHT) {
                     continue;
                 }
-                s_bitmap[res_y][res_x] = slot->bitmap.buffer[ix + iy * slot->bitmap.width];
+                s_bitmap[res_y][res_x] = glyph->buffer[ix + iy * glyph->pitch];
             }
         }
 
         /* increment horizontal position */
-        x += slot->advance.x / 64;
+        x += glyph->advance.x / 64;
         if (x >= BITMAP_WIDTH) {
             break;
         }
     }
-
-    /* output the resulting bitmap to console */
-    for (int iy = 0; iy < BITMAP_HEIGHT; iy++) {
-        for (int ix = 0; ix < x; ix++) {
-            int val = s_bitmap[iy][ix];
-            if (val > 127) {
-                putchar('#');
-            } else if (val > 64) {
-                putchar('+');
-            } else if (val > 32) {
-                putchar('.');
-            } else {
-                putchar(' ');
-            }
-        }
-        putchar('\n');
-    }
+    return x;
 }
@@ -14,3 +14,4 @@ def test_freetype_example(dut: Dut) -> None:
     dut.expect_exact('Font loaded')
     for c in 'FreeType':
         dut.expect_exact(f'Rendering char: \'{c}\'')
+    dut.expect(r'Text drawn in \d+ us, then in \d+ us from the glyph cache')
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdlib.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_idf_version.h"
+#include "esp_partition.h"
+#include "esp_ft_font_partition.h"
+
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+typedef spi_flash_mmap_handle_t esp_partition_mmap_handle_t;
+#define ESP_PARTITION_MMAP_DATA SPI_FLASH_MMAP_DATA
+#endif
+
+static const char *TAG = "esp_ft_font_partition";
+
+typedef struct esp_ft_font_partition_t {
+    const esp_partition_t *partition;
+    esp_partition_mmap_handle_t mmap_handle;
+    const void *data;
+} esp_ft_font_partition_t;
+
+esp_err_t esp_ft_font_partition_open(const char *label, esp_ft_font_partition_handle_t *ret_partition)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(label && ret_partition, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    ESP_RETURN_ON_FALSE(part, ESP_ERR_NOT_FOUND, TAG, "no data partition %s", label);
+
+    esp_ft_font_partition_t *font = calloc(1, sizeof(esp_ft_font_partition_t));
+    ESP_RETURN_ON_FALSE(font, ESP_ERR_NO_MEM, TAG, "no memory for font partition");
+    font->partition = part;
+    ESP_GOTO_ON_ERROR(esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &font->data, &font->mmap_handle),
+                      err, TAG, "map partition %s failed", label);
+    ESP_LOGD(TAG, "partition %s mapped at %p, %u bytes", label, font->data, (unsigned)part->size);
+
+    *ret_partition = font;
+    return ESP_OK;
+
+err:
+    free(font);
+    return ret;
+}
+
+esp_err_t esp_ft_font_partition_new_face(esp_ft_font_partition_handle_t partition, FT_Library library,
+                                         FT_Long face_index, FT_Face *ret_face)
+{
+    ESP_RETURN_ON_FALSE(partition && library && ret_face, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    FT_Error error = FT_New_Memory_Face(library, partition->data, partition->partition->size, face_index, ret_face);
+    ESP_RETURN_ON_FALSE(error != FT_Err_Unknown_File_Format, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "partition %s doesn't hold a supported font", partition->partition->label);
+    ESP_RETURN_ON_FALSE(!error, ESP_FAIL, TAG, "open face %ld of partition %s failed: %d", (long)face_index,
+                        partition->partition->label, error);
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_font_partition_get_data(esp_ft_font_partition_handle_t partition, const void **ret_data,
+                                         size_t *ret_size)
+{
+    ESP_RETURN_ON_FALSE(partition && ret_data && ret_size, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_data = partition->data;
+    *ret_size = partition->partition->size;
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_font_partition_close(esp_ft_font_partition_handle_t partition)
+{
+    ESP_RETURN_ON_FALSE(partition, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    esp_partition_munmap(partition->mmap_handle);
+    free(partition);
+    return ESP_OK;
+}
@@ -0,0 +1,308 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_ft_glyph_cache.h"
+
+static const char *TAG = "esp_ft_glyph_cache";
+
+#define GLYPH_CACHE_NONE UINT16_MAX
+
+typedef struct {
+    FT_Face face;
+    FT_Fixed x_scale;
+    FT_Fixed y_scale;
+    FT_UInt glyph_index;
+    esp_ft_glyph_t glyph;     // buffer points to the cell of the entry
+    uint16_t hash_next;       // next entry of the same bucket, or next free entry
+    uint16_t lru_prev;        // more recently used entry
+    uint16_t lru_next;        // less recently used entry
+} glyph_cache_entry_t;
+
+typedef struct esp_ft_glyph_cache_t {
+    esp_ft_glyph_cache_config_t config;
+    uint8_t *atlas;
+    glyph_cache_entry_t *entries;
+    uint16_t *buckets;
+    size_t bucket_mask;
+    size_t used;             // entries in use
+    uint16_t free_head;      // first free entry
+    uint16_t lru_head;       // most recently used entry
+    uint16_t lru_tail;       // least recently used entry, dropped first
+    esp_ft_glyph_t uncached; // last glyph too large for a cell, in the glyph slot of its face
+    esp_ft_glyph_cache_stats_t stats;
+} esp_ft_glyph_cache_t;
+
+static size_t glyph_cache_bucket(const esp_ft_glyph_cache_t *cache, FT_Face face, FT_Fixed x_scale, FT_Fixed y_scale,
+                                 FT_UInt glyph_index)
+{
+    uint32_t h = (uint32_t)(uintptr_t)face;
+    h = (h ^ (uint32_t)x_scale) * 0x9e3779b1;
+    h = (h ^ (uint32_t)y_scale) * 0x9e3779b1;
+    h = (h ^ glyph_index) * 0x9e3779b1;
+    return (h >> 16) & cache->bucket_mask;
+}
+
+static void glyph_cache_lru_unlink(esp_ft_glyph_cache_t *cache, uint16_t i)
+{
+    glyph_cache_entry_t *e = &cache->entries[i];
+    if (e->lru_prev != GLYPH_CACHE_NONE) {
+        cache->entries[e->lru_prev].lru_next = e->lru_next;
+    } else {
+        cache->lru_head = e->lru_next;
+    }
+    if (e->lru_next != GLYPH_CACHE_NONE) {
+        cache->entries[e->lru_next].lru_prev = e->lru_prev;
+    } else {
+        cache->lru_tail = e->lru_prev;
+    }
+}
+
+static void glyph_cache_lru_push(esp_ft_glyph_cache_t *cache, uint16_t i)
+{
+    glyph_cache_entry_t *e = &cache->entries[i];
+    e->lru_prev = GLYPH_CACHE_NONE;
+    e->lru_next = cache->lru_head;
+    if (cache->lru_head != GLYPH_CACHE_NONE) {
+        cache->entries[cache->lru_head].lru_prev = i;
+    } else {
+        cache->lru_tail = i;
+    }
+    cache->lru_head = i;
+}
+
+static void glyph_cache_hash_unlink(esp_ft_glyph_cache_t *cache, uint16_t i)
+{
+    glyph_cache_entry_t *e = &cache->entries[i];
+    uint16_t *link = &cache->buckets[glyph_cache_bucket(cache, e->face, e->x_scale, e->y_scale, e->glyph_index)];
+    while (*link != i) {
+        link = &cache->entries[*link].hash_next;
+    }
+    *link = e->hash_next;
+}
+
+/* Takes a free entry, or drops the least recently used one */
+static uint16_t glyph_cache_take_entry(esp_ft_glyph_cache_t *cache)
+{
+    uint16_t i = cache->free_head;
+    if (i != GLYPH_CACHE_NONE) {
+        cache->free_head = cache->entries[i].hash_next;
+        cache->used++;
+        return i;
+    }
+    i = cache->lru_tail;
+    glyph_cache_lru_unlink(cache, i);
+    glyph_cache_hash_unlink(cache, i);
+    cache->stats.evictions++;
+    return i;
+}
+
+static void glyph_cache_fill(esp_ft_glyph_t *glyph, FT_GlyphSlot slot)
+{
+    glyph->width = slot->bitmap.width;
+    glyph->rows = slot->bitmap.rows;
+    glyph->pixel_mode = slot->bitmap.pixel_mode;
+    glyph->left = slot->bitmap_left;
+    glyph->top = slot->bitmap_top;
+    glyph->advance = slot->advance;
+}
+
+static esp_err_t glyph_cache_render(esp_ft_glyph_cache_t *cache, FT_Face face, FT_UInt glyph_index)
+{
+    FT_Error error = FT_Load_Glyph(face, glyph_index, cache->config.load_flags);
+    ESP_RETURN_ON_FALSE(!error, ESP_FAIL, TAG, "load glyph %u failed: %d", glyph_index, error);
+    if (face->glyph->format != FT_GLYPH_FORMAT_BITMAP) {
+        error = FT_Render_Glyph(face->glyph, cache->config.render_mode);
+        ESP_RETURN_ON_FALSE(!error, ESP_FAIL, TAG, "render glyph %u failed: %d", glyph_index, error);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_glyph_cache_new(const esp_ft_glyph_cache_config_t *config, esp_ft_glyph_cache_handle_t *ret_cache)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config && ret_cache, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->cell_size > 0 && config->cell_count > 0 && config->cell_count < GLYPH_CACHE_NONE,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid cell size or count");
+
+    esp_ft_glyph_cache_t *cache = calloc(1, sizeof(esp_ft_glyph_cache_t));
+    ESP_RETURN_ON_FALSE(cache, ESP_ERR_NO_MEM, TAG, "no memory for cache");
+    cache->config = *config;
+    cache->lru_head = GLYPH_CACHE_NONE;
+    cache->lru_tail = GLYPH_CACHE_NONE;
+
+    size_t bucket_count = 1;
+    while (bucket_count < config->cell_count) {
+        bucket_count <<= 1;
+    }
+    cache->bucket_mask = bucket_count - 1;
+    cache->buckets = malloc(bucket_count * sizeof(uint16_t));
+    cache->entries = malloc(config->cell_count * sizeof(glyph_cache_entry_t));
+    ESP_GOTO_ON_FALSE(cache->buckets && cache->entries, ESP_ERR_NO_MEM, err, TAG, "no memory for cache entries");
+    memset(cache->buckets, 0xff, bucket_count * sizeof(uint16_t));
+    for (size_t i = 0; i < config->cell_count; i++) {
+        cache->entries[i].hash_next = i + 1 < config->cell_count ? i + 1 : GLYPH_CACHE_NONE;
+    }
+
+    size_t atlas_size = config->cell_size * config->cell_count;
+    if (config->caps) {
+        cache->atlas = heap_caps_malloc(atlas_size, config->caps);
+    } else {
+        cache->atlas = heap_caps_malloc_prefer(atlas_size, 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_DEFAULT);
+    }
+    ESP_GOTO_ON_FALSE(cache->atlas, ESP_ERR_NO_MEM, err, TAG, "no memory for %u bytes of atlas", (unsigned)atlas_size);
+
+    *ret_cache = cache;
+    return ESP_OK;
+
+err:
+    free(cache->buckets);
+    free(cache->entries);
+    free(cache);
+    return ret;
+}
+
+esp_err_t esp_ft_glyph_cache_get(esp_ft_glyph_cache_handle_t cache, FT_Face face, FT_UInt glyph_index,
+                                 const esp_ft_glyph_t **ret_glyph)
+{
+    ESP_RETURN_ON_FALSE(cache && face && face->size && ret_glyph, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    FT_Fixed x_scale = face->size->metrics.x_scale;
+    FT_Fixed y_scale = face->size->metrics.y_scale;
+    uint16_t *bucket = &cache->buckets[glyph_cache_bucket(cache, face, x_scale, y_scale, glyph_index)];
+
+    for (uint16_t i = *bucket; i != GLYPH_CACHE_NONE; i = cache->entries[i].hash_next) {
+        glyph_cache_entry_t *e = &cache->entries[i];
+        if (e->face == face && e->glyph_index == glyph_index && e->x_scale == x_scale && e->y_scale == y_scale) {
+            if (cache->lru_head != i) {
+                glyph_cache_lru_unlink(cache, i);
+                glyph_cache_lru_push(cache, i);
+            }
+            cache->stats.hits++;
+            *ret_glyph = &e->glyph;
+            return ESP_OK;
+        }
+    }
+
+    ESP_RETURN_ON_ERROR(glyph_cache_render(cache, face, glyph_index), TAG, "get glyph failed");
+    cache->stats.misses++;
+    const FT_Bitmap *bitmap = &face->glyph->bitmap;
+    const size_t row_bytes = abs(bitmap->pitch);
+    if (row_bytes * bitmap->rows > cache->config.cell_size) {
+        cache->stats.uncached++;
+        glyph_cache_fill(&cache->uncached, face->glyph);
+        cache->uncached.buffer = bitmap->buffer;
+        cache->uncached.pitch = bitmap->pitch;
+        *ret_glyph = &cache->uncached;
+        return ESP_OK;
+    }
+
+    uint16_t i = glyph_cache_take_entry(cache);
+    glyph_cache_entry_t *e = &cache->entries[i];
+    uint8_t *cell = cache->atlas + (size_t)i * cache->config.cell_size;
+    // with a negative pitch, FreeType stores the bottom row first
+    for (unsigned int y = 0; y < bitmap->rows; y++) {
+        unsigned int src_row = bitmap->pitch < 0 ? bitmap->rows - 1 - y : y;
+        memcpy(cell + y * row_bytes, bitmap->buffer + src_row * row_bytes, row_bytes);
+    }
+    e->face = face;
+    e->x_scale = x_scale;
+    e->y_scale = y_scale;
+    e->glyph_index = glyph_index;
+    glyph_cache_fill(&e->glyph, face->glyph);
+    e->glyph.buffer = cell;
+    e->glyph.pitch = row_bytes;
+    // the bucket may have changed if the dropped entry was its head
+    bucket = &cache->buckets[glyph_cache_bucket(cache, face, x_scale, y_scale, glyph_index)];
+    e->hash_next = *bucket;
+    *bucket = i;
+    glyph_cache_lru_push(cache, i);
+    *ret_glyph = &e->glyph;
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_glyph_cache_get_char(esp_ft_glyph_cache_handle_t cache, FT_Face face, FT_ULong char_code,
+                                      const esp_ft_glyph_t **ret_glyph)
+{
+    ESP_RETURN_ON_FALSE(face, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    return esp_ft_glyph_cache_get(cache, face, FT_Get_Char_Index(face, char_code), ret_glyph);
+}
+
+/* Decodes the UTF-8 character at *s and moves past it, 0 at the end of the string, -1 if invalid */
+static int32_t glyph_cache_next_utf8(const char **s)
+{
+    const uint8_t *p = (const uint8_t *)*s;
+    uint32_t c = p[0];
+    int len = c < 0x80 ? 1 : (c & 0xe0) == 0xc0 ? 2 : (c & 0xf0) == 0xe0 ? 3 : (c & 0xf8) == 0xf0 ? 4 : 0;
+    if (len == 0) {
+        return -1;
+    }
+    if (len > 1) {
+        c &= 0x7f >> len;
+    }
+    for (int i = 1; i < len; i++) {
+        if ((p[i] & 0xc0) != 0x80) {
+            return -1;
+        }
+        c = (c << 6) | (p[i] & 0x3f);
+    }
+    *s += len;
+    return c;
+}
+
+esp_err_t esp_ft_glyph_cache_warm_up(esp_ft_glyph_cache_handle_t cache, FT_Face face, const char *chars)
+{
+    ESP_RETURN_ON_FALSE(cache && face && chars, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const esp_ft_glyph_t *glyph = NULL;
+    for (;;) {
+        int32_t c = glyph_cache_next_utf8(&chars);
+        ESP_RETURN_ON_FALSE(c >= 0, ESP_ERR_INVALID_ARG, TAG, "invalid UTF-8");
+        if (c == 0) {
+            return ESP_OK;
+        }
+        ESP_RETURN_ON_ERROR(esp_ft_glyph_cache_get_char(cache, face, c, &glyph), TAG, "warm up failed");
+    }
+}
+
+esp_err_t esp_ft_glyph_cache_drop_face(esp_ft_glyph_cache_handle_t cache, FT_Face face)
+{
+    ESP_RETURN_ON_FALSE(cache, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    uint16_t i = cache->lru_head;
+    while (i != GLYPH_CACHE_NONE) {
+        glyph_cache_entry_t *e = &cache->entries[i];
+        uint16_t next = e->lru_next;
+        if (face == NULL || e->face == face) {
+            glyph_cache_lru_unlink(cache, i);
+            glyph_cache_hash_unlink(cache, i);
+            e->hash_next = cache->free_head;
+            cache->free_head = i;
+            cache->used--;
+        }
+        i = next;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_glyph_cache_get_stats(esp_ft_glyph_cache_handle_t cache, esp_ft_glyph_cache_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(cache && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_stats = cache->stats;
+    ret_stats->used = cache->used;
+    return ESP_OK;
+}
+
+esp_err_t esp_ft_glyph_cache_del(esp_ft_glyph_cache_handle_t cache)
+{
+    ESP_RETURN_ON_FALSE(cache, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    heap_caps_free(cache->atlas);
+    free(cache->buckets);
+    free(cache->entries);
+    free(cache);
+    return ESP_OK;
+}
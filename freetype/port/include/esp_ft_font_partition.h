@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include "esp_err.h"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Font partition handle
+ */
+typedef struct esp_ft_font_partition_t *esp_ft_font_partition_handle_t;
+
+/**
+ * @brief Map a data partition holding a font file into the address space
+ *
+ * The font is then read through the flash cache, without being copied to RAM: opening a face only parses its tables,
+ * and the outlines of the glyphs are read from flash as they are rendered. The partition holds the font file as is,
+ * e.g. written with `esptool.py write_flash` or `parttool.py write_partition`; the bytes after the file are ignored.
+ *
+ * @note The whole partition is mapped, which takes as much of the MMU address space as its size, rounded up to the
+ *       MMU page size. The space left for the other mappings depends on the chip
+ *
+ * @param label Label of the partition, of type data
+ * @param ret_partition Returned font partition handle
+ * @return
+ *      - ESP_OK: Open font partition successfully
+ *      - ESP_ERR_INVALID_ARG: Open font partition failed because of invalid argument
+ *      - ESP_ERR_NOT_FOUND: Open font partition failed because there is no data partition with this label
+ *      - ESP_ERR_NO_MEM: Open font partition failed because of out of memory, or of MMU address space
+ */
+esp_err_t esp_ft_font_partition_open(const char *label, esp_ft_font_partition_handle_t *ret_partition);
+
+/**
+ * @brief Create a face from the font of a partition, the counterpart of `FT_New_Memory_Face()`
+ *
+ * @param partition Font partition handle
+ * @param library FreeType library
+ * @param face_index Index of the face in the font file, as for `FT_New_Memory_Face()`, usually 0
+ * @param ret_face Returned face, to be freed with `FT_Done_Face()` before closing the partition
+ * @return
+ *      - ESP_OK: Create face successfully
+ *      - ESP_ERR_INVALID_ARG: Create face failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Create face failed because the partition doesn't hold a font FreeType can open
+ *      - ESP_FAIL: Create face failed because of another FreeType error
+ */
+esp_err_t esp_ft_font_partition_new_face(esp_ft_font_partition_handle_t partition, FT_Library library,
+                                         FT_Long face_index, FT_Face *ret_face);
+
+/**
+ * @brief Get the mapped data of a font partition
+ *
+ * @param partition Font partition handle
+ * @param ret_data Returned address of the data, valid until the partition is closed
+ * @param ret_size Returned size of the partition, in bytes
+ * @return
+ *      - ESP_OK: Get data successfully
+ *      - ESP_ERR_INVALID_ARG: Get data failed because of invalid argument
+ */
+esp_err_t esp_ft_font_partition_get_data(esp_ft_font_partition_handle_t partition, const void **ret_data,
+                                         size_t *ret_size);
+
+/**
+ * @brief Unmap a font partition
+ *
+ * @note The faces created from the partition must be freed before
+ *
+ * @param partition Font partition handle
+ * @return
+ *      - ESP_OK: Close font partition successfully
+ *      - ESP_ERR_INVALID_ARG: Close font partition failed because of invalid argument
+ */
+esp_err_t esp_ft_font_partition_close(esp_ft_font_partition_handle_t partition);
+
+#ifdef __cplusplus
+}
+#endif
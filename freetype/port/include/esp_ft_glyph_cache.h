@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "ft2build.h"
+#include FT_FREETYPE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Printable ASCII characters, e.g. to warm up a cache with `esp_ft_glyph_cache_warm_up()`
+ */
+#define ESP_FT_GLYPH_CACHE_CHARSET_ASCII \
+    " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~"
+
+/**
+ * @brief Glyph cache handle
+ */
+typedef struct esp_ft_glyph_cache_t *esp_ft_glyph_cache_handle_t;
+
+/**
+ * @brief Glyph cache configuration
+ */
+typedef struct {
+    size_t cell_size;           /*!< Size of the cells of the atlas, in bytes, the largest glyph bitmap the cache keeps,
+                                     e.g. 32 * 32 for 8-bit gray glyphs of up to 32x32 pixels */
+    size_t cell_count;          /*!< Number of cells of the atlas, the number of glyphs the cache keeps, up to 65535 */
+    uint32_t caps;              /*!< Heap capabilities of the atlas, 0 for PSRAM when there is some, else the default
+                                     memory */
+    FT_Int32 load_flags;        /*!< Flags given to `FT_Load_Glyph()`, e.g. FT_LOAD_DEFAULT or FT_LOAD_TARGET_LIGHT */
+    FT_Render_Mode render_mode; /*!< Mode given to `FT_Render_Glyph()`, e.g. FT_RENDER_MODE_NORMAL for 8-bit gray */
+} esp_ft_glyph_cache_config_t;
+
+/**
+ * @brief Default configuration of a glyph cache, 256 glyphs of 8-bit gray of up to 1 KB each
+ */
+#define ESP_FT_GLYPH_CACHE_DEFAULT_CONFIG()    \
+    {                                          \
+        .cell_size = 32 * 32,                  \
+        .cell_count = 256,                     \
+        .caps = 0,                             \
+        .load_flags = FT_LOAD_DEFAULT,         \
+        .render_mode = FT_RENDER_MODE_NORMAL,  \
+    }
+
+/**
+ * @brief Rendered glyph
+ */
+typedef struct {
+    const uint8_t *buffer;      /*!< Bitmap, `rows` rows of `pitch` bytes each */
+    unsigned int width;         /*!< Width of the bitmap, in pixels */
+    unsigned int rows;          /*!< Height of the bitmap, in pixels */
+    int pitch;                  /*!< Bytes from one row to the next, always positive for a cached glyph */
+    unsigned char pixel_mode;   /*!< Format of the pixels, an FT_Pixel_Mode, e.g. FT_PIXEL_MODE_GRAY */
+    FT_Int left;                /*!< Distance from the pen position to the left of the bitmap, in pixels */
+    FT_Int top;                 /*!< Distance from the baseline to the top of the bitmap, in pixels, upwards */
+    FT_Vector advance;          /*!< Pen advance, in 26.6 fixed point pixels, as `FT_GlyphSlot.advance` */
+} esp_ft_glyph_t;
+
+/**
+ * @brief Glyph cache statistics
+ */
+typedef struct {
+    size_t hits;       /*!< Glyphs found in the cache */
+    size_t misses;     /*!< Glyphs loaded and rendered by FreeType */
+    size_t evictions;  /*!< Glyphs dropped to make room, the least recently used first */
+    size_t uncached;   /*!< Glyphs larger than a cell, rendered every time */
+    size_t used;       /*!< Cells in use */
+} esp_ft_glyph_cache_stats_t;
+
+/**
+ * @brief Create a glyph cache
+ *
+ * The cache keeps the rendered bitmaps of the glyphs in an atlas of `cell_count` cells of `cell_size` bytes, in
+ * PSRAM by default, and their metrics in internal RAM. The glyphs are keyed by face, size (the scales of the active
+ * `FT_Size` of the face) and glyph index, so a cache can hold several faces and sizes. When the atlas is full, the
+ * least recently used glyph is dropped.
+ *
+ * @note The cache must be used from one task at a time, like the faces it renders
+ *
+ * @param config Glyph cache configuration
+ * @param ret_cache Returned glyph cache handle
+ * @return
+ *      - ESP_OK: Create glyph cache successfully
+ *      - ESP_ERR_INVALID_ARG: Create glyph cache failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create glyph cache failed because of out of memory
+ */
+esp_err_t esp_ft_glyph_cache_new(const esp_ft_glyph_cache_config_t *config, esp_ft_glyph_cache_handle_t *ret_cache);
+
+/**
+ * @brief Get a rendered glyph, rendering it with FreeType if not in the cache
+ *
+ * The glyph is taken at the current size of the face, set with `FT_Set_Char_Size()` or `FT_Set_Pixel_Sizes()`.
+ * A glyph larger than a cell is loaded into the glyph slot of the face and not kept.
+ *
+ * @note The returned glyph is only valid until the next call on the cache, which may drop it, or for a glyph too large
+ *       for the cache, until the next load on the face
+ *
+ * @param cache Glyph cache handle
+ * @param face Face of the glyph
+ * @param glyph_index Glyph index, e.g. from `FT_Get_Char_Index()`
+ * @param ret_glyph Returned glyph
+ * @return
+ *      - ESP_OK: Get glyph successfully
+ *      - ESP_ERR_INVALID_ARG: Get glyph failed because of invalid argument, or the face has no size
+ *      - ESP_FAIL: Get glyph failed because FreeType failed to load or render it
+ */
+esp_err_t esp_ft_glyph_cache_get(esp_ft_glyph_cache_handle_t cache, FT_Face face, FT_UInt glyph_index,
+                                 const esp_ft_glyph_t **ret_glyph);
+
+/**
+ * @brief Get the rendered glyph of a character, as `esp_ft_glyph_cache_get()` with its glyph index
+ *
+ * @param cache Glyph cache handle
+ * @param face Face of the glyph
+ * @param char_code Character code, in the charmap of the face, e.g. a Unicode code point
+ * @param ret_glyph Returned glyph, the missing glyph of the face if it has none for the character
+ * @return
+ *      - ESP_OK: Get glyph successfully
+ *      - ESP_ERR_INVALID_ARG: Get glyph failed because of invalid argument, or the face has no size
+ *      - ESP_FAIL: Get glyph failed because FreeType failed to load or render it
+ */
+esp_err_t esp_ft_glyph_cache_get_char(esp_ft_glyph_cache_handle_t cache, FT_Face face, FT_ULong char_code,
+                                      const esp_ft_glyph_t **ret_glyph);
+
+/**
+ * @brief Render the glyphs of a set of characters ahead of time, e.g. at startup, so drawing text doesn't wait for
+ *        FreeType
+ *
+ * @note Warming up more glyphs than `cell_count` drops the first ones
+ *
+ * @param cache Glyph cache handle
+ * @param face Face of the glyphs, at the size they will be drawn at
+ * @param chars Characters, in UTF-8, e.g. ESP_FT_GLYPH_CACHE_CHARSET_ASCII
+ * @return
+ *      - ESP_OK: Warm up glyph cache successfully
+ *      - ESP_ERR_INVALID_ARG: Warm up glyph cache failed because of invalid argument, or invalid UTF-8
+ *      - ESP_FAIL: Warm up glyph cache failed because FreeType failed to load or render a glyph
+ */
+esp_err_t esp_ft_glyph_cache_warm_up(esp_ft_glyph_cache_handle_t cache, FT_Face face, const char *chars);
+
+/**
+ * @brief Drop the glyphs of a face, to be called before `FT_Done_Face()`, as another face may be created at its
+ *        address
+ *
+ * @param cache Glyph cache handle
+ * @param face Face, NULL to drop all the glyphs
+ * @return
+ *      - ESP_OK: Drop glyphs successfully
+ *      - ESP_ERR_INVALID_ARG: Drop glyphs failed because of invalid argument
+ */
+esp_err_t esp_ft_glyph_cache_drop_face(esp_ft_glyph_cache_handle_t cache, FT_Face face);
+
+/**
+ * @brief Get the statistics of a glyph cache
+ *
+ * @param cache Glyph cache handle
+ * @param ret_stats Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ */
+esp_err_t esp_ft_glyph_cache_get_stats(esp_ft_glyph_cache_handle_t cache, esp_ft_glyph_cache_stats_t *ret_stats);
+
+/**
+ * @brief Delete a glyph cache
+ *
+ * @param cache Glyph cache handle
+ * @return
+ *      - ESP_OK: Delete glyph cache successfully
+ *      - ESP_ERR_INVALID_ARG: Delete glyph cache failed because of invalid argument
+ */
+esp_err_t esp_ft_glyph_cache_del(esp_ft_glyph_cache_handle_t cache);
+
+#ifdef __cplusplus
+}
+#endif
@@ -117,6 +117,14 @@ __STATIC_INLINE int_fast32_t __IQNatan2(int_fast32_t iqNInputY, int_fast32_t iqN
         uiq31Input = _UIQ31div(uiqNInputY, uiqNInputX);
     }
 
+    /*
+     * The ratio is 1.0 when both inputs have the same magnitude, which does
+     * not fit the signed iq31 multiplies below. Use the largest iq31 value.
+     */
+    if (uiq31Input > INT32_MAX) {
+        uiq31Input = INT32_MAX;
+    }
+
     /* Calculate the index using the left 8 most bits of the input. */
     ui8Index = (uint_fast16_t)(uiq31Input >> 24);
     ui8Index = ui8Index & 0x00fc;
@@ -0,0 +1,1298 @@
+/*!****************************************************************************
+ *  @file       _IQNclarke_park.c
+ *  @brief      Functions to compute the Clarke, Park and inverse Park
+ *              transforms of IQN inputs.
+ *
+ *  <hr>
+ ******************************************************************************/
+
+#include <stdint.h>
+
+#include "../support/support.h"
+
+/*!
+ * @brief 1/sqrt(3) in unsigned IQ31 format
+ */
+#define uiq31_oneBySqrt3    (0x49e69d16)
+
+/**
+ * @brief Computes the Clarke transform of two phase currents of IQN type.
+ *
+ * The third phase is assumed to be -(a + b). The sum is computed with 64-bit
+ * precision so that it cannot overflow.
+ *
+ * @param iqNa            IQN type current of phase a.
+ * @param iqNb            IQN type current of phase b.
+ * @param iqNAlpha        IQN type alpha component.
+ * @param iqNBeta         IQN type beta component.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNclarke)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNclarke(int_fast32_t iqNa, int_fast32_t iqNb, int32_t *iqNAlpha, int32_t *iqNBeta)
+{
+    /* beta = (a + 2*b) / sqrt(3) */
+    int_fast64_t iqNSum = (int_fast64_t)iqNa + 2 * (int_fast64_t)iqNb;
+
+    *iqNAlpha = iqNa;
+    *iqNBeta = (int32_t)((iqNSum * uiq31_oneBySqrt3) >> 31);
+}
+
+/**
+ * @brief Computes the Park transform of IQN type inputs.
+ *
+ * Both products of each output are accumulated with 64-bit precision and
+ * shifted once, which is one rounding step less than two _IQNmpy() calls.
+ *
+ * @param iqNAlpha        IQN type alpha component.
+ * @param iqNBeta         IQN type beta component.
+ * @param iqNSin          IQN type sine of the angle.
+ * @param iqNCos          IQN type cosine of the angle.
+ * @param iqNd            IQN type d component.
+ * @param iqNq            IQN type q component.
+ * @param q_value         IQ format.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNpark)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNpark(int_fast32_t iqNAlpha, int_fast32_t iqNBeta, int_fast32_t iqNSin,
+                               int_fast32_t iqNCos, int32_t *iqNd, int32_t *iqNq, const int8_t q_value)
+{
+    /* d = alpha*cos + beta*sin, q = beta*cos - alpha*sin */
+    *iqNd = (int32_t)(((int_fast64_t)iqNAlpha * iqNCos + (int_fast64_t)iqNBeta * iqNSin) >> q_value);
+    *iqNq = (int32_t)(((int_fast64_t)iqNBeta * iqNCos - (int_fast64_t)iqNAlpha * iqNSin) >> q_value);
+}
+
+/**
+ * @brief Computes the inverse Park transform of IQN type inputs.
+ *
+ * @param iqNd            IQN type d component.
+ * @param iqNq            IQN type q component.
+ * @param iqNSin          IQN type sine of the angle.
+ * @param iqNCos          IQN type cosine of the angle.
+ * @param iqNAlpha        IQN type alpha component.
+ * @param iqNBeta         IQN type beta component.
+ * @param q_value         IQ format.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNipark)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNipark(int_fast32_t iqNd, int_fast32_t iqNq, int_fast32_t iqNSin,
+                                int_fast32_t iqNCos, int32_t *iqNAlpha, int32_t *iqNBeta, const int8_t q_value)
+{
+    /* alpha = d*cos - q*sin, beta = q*cos + d*sin */
+    *iqNAlpha = (int32_t)(((int_fast64_t)iqNd * iqNCos - (int_fast64_t)iqNq * iqNSin) >> q_value);
+    *iqNBeta = (int32_t)(((int_fast64_t)iqNq * iqNCos + (int_fast64_t)iqNd * iqNSin) >> q_value);
+}
+
+/* IQ clarke functions */
+/**
+ * @brief Computes the Clarke transform of two IQ30 phase currents.
+ *
+ * @param a               IQ30 type current of phase a.
+ * @param b               IQ30 type current of phase b.
+ * @param alpha           IQ30 type alpha component.
+ * @param beta            IQ30 type beta component.
+ */
+void _IQ30clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ29 phase currents.
+ *
+ * @param a               IQ29 type current of phase a.
+ * @param b               IQ29 type current of phase b.
+ * @param alpha           IQ29 type alpha component.
+ * @param beta            IQ29 type beta component.
+ */
+void _IQ29clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ28 phase currents.
+ *
+ * @param a               IQ28 type current of phase a.
+ * @param b               IQ28 type current of phase b.
+ * @param alpha           IQ28 type alpha component.
+ * @param beta            IQ28 type beta component.
+ */
+void _IQ28clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ27 phase currents.
+ *
+ * @param a               IQ27 type current of phase a.
+ * @param b               IQ27 type current of phase b.
+ * @param alpha           IQ27 type alpha component.
+ * @param beta            IQ27 type beta component.
+ */
+void _IQ27clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ26 phase currents.
+ *
+ * @param a               IQ26 type current of phase a.
+ * @param b               IQ26 type current of phase b.
+ * @param alpha           IQ26 type alpha component.
+ * @param beta            IQ26 type beta component.
+ */
+void _IQ26clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ25 phase currents.
+ *
+ * @param a               IQ25 type current of phase a.
+ * @param b               IQ25 type current of phase b.
+ * @param alpha           IQ25 type alpha component.
+ * @param beta            IQ25 type beta component.
+ */
+void _IQ25clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ24 phase currents.
+ *
+ * @param a               IQ24 type current of phase a.
+ * @param b               IQ24 type current of phase b.
+ * @param alpha           IQ24 type alpha component.
+ * @param beta            IQ24 type beta component.
+ */
+void _IQ24clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ23 phase currents.
+ *
+ * @param a               IQ23 type current of phase a.
+ * @param b               IQ23 type current of phase b.
+ * @param alpha           IQ23 type alpha component.
+ * @param beta            IQ23 type beta component.
+ */
+void _IQ23clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ22 phase currents.
+ *
+ * @param a               IQ22 type current of phase a.
+ * @param b               IQ22 type current of phase b.
+ * @param alpha           IQ22 type alpha component.
+ * @param beta            IQ22 type beta component.
+ */
+void _IQ22clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ21 phase currents.
+ *
+ * @param a               IQ21 type current of phase a.
+ * @param b               IQ21 type current of phase b.
+ * @param alpha           IQ21 type alpha component.
+ * @param beta            IQ21 type beta component.
+ */
+void _IQ21clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ20 phase currents.
+ *
+ * @param a               IQ20 type current of phase a.
+ * @param b               IQ20 type current of phase b.
+ * @param alpha           IQ20 type alpha component.
+ * @param beta            IQ20 type beta component.
+ */
+void _IQ20clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ19 phase currents.
+ *
+ * @param a               IQ19 type current of phase a.
+ * @param b               IQ19 type current of phase b.
+ * @param alpha           IQ19 type alpha component.
+ * @param beta            IQ19 type beta component.
+ */
+void _IQ19clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ18 phase currents.
+ *
+ * @param a               IQ18 type current of phase a.
+ * @param b               IQ18 type current of phase b.
+ * @param alpha           IQ18 type alpha component.
+ * @param beta            IQ18 type beta component.
+ */
+void _IQ18clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ17 phase currents.
+ *
+ * @param a               IQ17 type current of phase a.
+ * @param b               IQ17 type current of phase b.
+ * @param alpha           IQ17 type alpha component.
+ * @param beta            IQ17 type beta component.
+ */
+void _IQ17clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ16 phase currents.
+ *
+ * @param a               IQ16 type current of phase a.
+ * @param b               IQ16 type current of phase b.
+ * @param alpha           IQ16 type alpha component.
+ * @param beta            IQ16 type beta component.
+ */
+void _IQ16clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ15 phase currents.
+ *
+ * @param a               IQ15 type current of phase a.
+ * @param b               IQ15 type current of phase b.
+ * @param alpha           IQ15 type alpha component.
+ * @param beta            IQ15 type beta component.
+ */
+void _IQ15clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ14 phase currents.
+ *
+ * @param a               IQ14 type current of phase a.
+ * @param b               IQ14 type current of phase b.
+ * @param alpha           IQ14 type alpha component.
+ * @param beta            IQ14 type beta component.
+ */
+void _IQ14clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ13 phase currents.
+ *
+ * @param a               IQ13 type current of phase a.
+ * @param b               IQ13 type current of phase b.
+ * @param alpha           IQ13 type alpha component.
+ * @param beta            IQ13 type beta component.
+ */
+void _IQ13clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ12 phase currents.
+ *
+ * @param a               IQ12 type current of phase a.
+ * @param b               IQ12 type current of phase b.
+ * @param alpha           IQ12 type alpha component.
+ * @param beta            IQ12 type beta component.
+ */
+void _IQ12clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ11 phase currents.
+ *
+ * @param a               IQ11 type current of phase a.
+ * @param b               IQ11 type current of phase b.
+ * @param alpha           IQ11 type alpha component.
+ * @param beta            IQ11 type beta component.
+ */
+void _IQ11clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ10 phase currents.
+ *
+ * @param a               IQ10 type current of phase a.
+ * @param b               IQ10 type current of phase b.
+ * @param alpha           IQ10 type alpha component.
+ * @param beta            IQ10 type beta component.
+ */
+void _IQ10clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ9 phase currents.
+ *
+ * @param a               IQ9 type current of phase a.
+ * @param b               IQ9 type current of phase b.
+ * @param alpha           IQ9 type alpha component.
+ * @param beta            IQ9 type beta component.
+ */
+void _IQ9clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ8 phase currents.
+ *
+ * @param a               IQ8 type current of phase a.
+ * @param b               IQ8 type current of phase b.
+ * @param alpha           IQ8 type alpha component.
+ * @param beta            IQ8 type beta component.
+ */
+void _IQ8clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ7 phase currents.
+ *
+ * @param a               IQ7 type current of phase a.
+ * @param b               IQ7 type current of phase b.
+ * @param alpha           IQ7 type alpha component.
+ * @param beta            IQ7 type beta component.
+ */
+void _IQ7clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ6 phase currents.
+ *
+ * @param a               IQ6 type current of phase a.
+ * @param b               IQ6 type current of phase b.
+ * @param alpha           IQ6 type alpha component.
+ * @param beta            IQ6 type beta component.
+ */
+void _IQ6clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ5 phase currents.
+ *
+ * @param a               IQ5 type current of phase a.
+ * @param b               IQ5 type current of phase b.
+ * @param alpha           IQ5 type alpha component.
+ * @param beta            IQ5 type beta component.
+ */
+void _IQ5clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ4 phase currents.
+ *
+ * @param a               IQ4 type current of phase a.
+ * @param b               IQ4 type current of phase b.
+ * @param alpha           IQ4 type alpha component.
+ * @param beta            IQ4 type beta component.
+ */
+void _IQ4clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ3 phase currents.
+ *
+ * @param a               IQ3 type current of phase a.
+ * @param b               IQ3 type current of phase b.
+ * @param alpha           IQ3 type alpha component.
+ * @param beta            IQ3 type beta component.
+ */
+void _IQ3clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ2 phase currents.
+ *
+ * @param a               IQ2 type current of phase a.
+ * @param b               IQ2 type current of phase b.
+ * @param alpha           IQ2 type alpha component.
+ * @param beta            IQ2 type beta component.
+ */
+void _IQ2clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+/**
+ * @brief Computes the Clarke transform of two IQ1 phase currents.
+ *
+ * @param a               IQ1 type current of phase a.
+ * @param b               IQ1 type current of phase b.
+ * @param alpha           IQ1 type alpha component.
+ * @param beta            IQ1 type beta component.
+ */
+void _IQ1clarke(int32_t a, int32_t b, int32_t *alpha, int32_t *beta)
+{
+    __IQNclarke(a, b, alpha, beta);
+}
+
+/* IQ park functions */
+/**
+ * @brief Computes the Park transform of IQ30 inputs.
+ *
+ * @param alpha           IQ30 type alpha component.
+ * @param beta            IQ30 type beta component.
+ * @param sin             IQ30 type sine of the angle.
+ * @param cos             IQ30 type cosine of the angle.
+ * @param d               IQ30 type d component.
+ * @param q               IQ30 type q component.
+ */
+void _IQ30park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 30);
+}
+/**
+ * @brief Computes the Park transform of IQ29 inputs.
+ *
+ * @param alpha           IQ29 type alpha component.
+ * @param beta            IQ29 type beta component.
+ * @param sin             IQ29 type sine of the angle.
+ * @param cos             IQ29 type cosine of the angle.
+ * @param d               IQ29 type d component.
+ * @param q               IQ29 type q component.
+ */
+void _IQ29park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 29);
+}
+/**
+ * @brief Computes the Park transform of IQ28 inputs.
+ *
+ * @param alpha           IQ28 type alpha component.
+ * @param beta            IQ28 type beta component.
+ * @param sin             IQ28 type sine of the angle.
+ * @param cos             IQ28 type cosine of the angle.
+ * @param d               IQ28 type d component.
+ * @param q               IQ28 type q component.
+ */
+void _IQ28park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 28);
+}
+/**
+ * @brief Computes the Park transform of IQ27 inputs.
+ *
+ * @param alpha           IQ27 type alpha component.
+ * @param beta            IQ27 type beta component.
+ * @param sin             IQ27 type sine of the angle.
+ * @param cos             IQ27 type cosine of the angle.
+ * @param d               IQ27 type d component.
+ * @param q               IQ27 type q component.
+ */
+void _IQ27park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 27);
+}
+/**
+ * @brief Computes the Park transform of IQ26 inputs.
+ *
+ * @param alpha           IQ26 type alpha component.
+ * @param beta            IQ26 type beta component.
+ * @param sin             IQ26 type sine of the angle.
+ * @param cos             IQ26 type cosine of the angle.
+ * @param d               IQ26 type d component.
+ * @param q               IQ26 type q component.
+ */
+void _IQ26park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 26);
+}
+/**
+ * @brief Computes the Park transform of IQ25 inputs.
+ *
+ * @param alpha           IQ25 type alpha component.
+ * @param beta            IQ25 type beta component.
+ * @param sin             IQ25 type sine of the angle.
+ * @param cos             IQ25 type cosine of the angle.
+ * @param d               IQ25 type d component.
+ * @param q               IQ25 type q component.
+ */
+void _IQ25park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 25);
+}
+/**
+ * @brief Computes the Park transform of IQ24 inputs.
+ *
+ * @param alpha           IQ24 type alpha component.
+ * @param beta            IQ24 type beta component.
+ * @param sin             IQ24 type sine of the angle.
+ * @param cos             IQ24 type cosine of the angle.
+ * @param d               IQ24 type d component.
+ * @param q               IQ24 type q component.
+ */
+void _IQ24park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 24);
+}
+/**
+ * @brief Computes the Park transform of IQ23 inputs.
+ *
+ * @param alpha           IQ23 type alpha component.
+ * @param beta            IQ23 type beta component.
+ * @param sin             IQ23 type sine of the angle.
+ * @param cos             IQ23 type cosine of the angle.
+ * @param d               IQ23 type d component.
+ * @param q               IQ23 type q component.
+ */
+void _IQ23park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 23);
+}
+/**
+ * @brief Computes the Park transform of IQ22 inputs.
+ *
+ * @param alpha           IQ22 type alpha component.
+ * @param beta            IQ22 type beta component.
+ * @param sin             IQ22 type sine of the angle.
+ * @param cos             IQ22 type cosine of the angle.
+ * @param d               IQ22 type d component.
+ * @param q               IQ22 type q component.
+ */
+void _IQ22park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 22);
+}
+/**
+ * @brief Computes the Park transform of IQ21 inputs.
+ *
+ * @param alpha           IQ21 type alpha component.
+ * @param beta            IQ21 type beta component.
+ * @param sin             IQ21 type sine of the angle.
+ * @param cos             IQ21 type cosine of the angle.
+ * @param d               IQ21 type d component.
+ * @param q               IQ21 type q component.
+ */
+void _IQ21park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 21);
+}
+/**
+ * @brief Computes the Park transform of IQ20 inputs.
+ *
+ * @param alpha           IQ20 type alpha component.
+ * @param beta            IQ20 type beta component.
+ * @param sin             IQ20 type sine of the angle.
+ * @param cos             IQ20 type cosine of the angle.
+ * @param d               IQ20 type d component.
+ * @param q               IQ20 type q component.
+ */
+void _IQ20park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 20);
+}
+/**
+ * @brief Computes the Park transform of IQ19 inputs.
+ *
+ * @param alpha           IQ19 type alpha component.
+ * @param beta            IQ19 type beta component.
+ * @param sin             IQ19 type sine of the angle.
+ * @param cos             IQ19 type cosine of the angle.
+ * @param d               IQ19 type d component.
+ * @param q               IQ19 type q component.
+ */
+void _IQ19park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 19);
+}
+/**
+ * @brief Computes the Park transform of IQ18 inputs.
+ *
+ * @param alpha           IQ18 type alpha component.
+ * @param beta            IQ18 type beta component.
+ * @param sin             IQ18 type sine of the angle.
+ * @param cos             IQ18 type cosine of the angle.
+ * @param d               IQ18 type d component.
+ * @param q               IQ18 type q component.
+ */
+void _IQ18park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 18);
+}
+/**
+ * @brief Computes the Park transform of IQ17 inputs.
+ *
+ * @param alpha           IQ17 type alpha component.
+ * @param beta            IQ17 type beta component.
+ * @param sin             IQ17 type sine of the angle.
+ * @param cos             IQ17 type cosine of the angle.
+ * @param d               IQ17 type d component.
+ * @param q               IQ17 type q component.
+ */
+void _IQ17park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 17);
+}
+/**
+ * @brief Computes the Park transform of IQ16 inputs.
+ *
+ * @param alpha           IQ16 type alpha component.
+ * @param beta            IQ16 type beta component.
+ * @param sin             IQ16 type sine of the angle.
+ * @param cos             IQ16 type cosine of the angle.
+ * @param d               IQ16 type d component.
+ * @param q               IQ16 type q component.
+ */
+void _IQ16park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 16);
+}
+/**
+ * @brief Computes the Park transform of IQ15 inputs.
+ *
+ * @param alpha           IQ15 type alpha component.
+ * @param beta            IQ15 type beta component.
+ * @param sin             IQ15 type sine of the angle.
+ * @param cos             IQ15 type cosine of the angle.
+ * @param d               IQ15 type d component.
+ * @param q               IQ15 type q component.
+ */
+void _IQ15park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 15);
+}
+/**
+ * @brief Computes the Park transform of IQ14 inputs.
+ *
+ * @param alpha           IQ14 type alpha component.
+ * @param beta            IQ14 type beta component.
+ * @param sin             IQ14 type sine of the angle.
+ * @param cos             IQ14 type cosine of the angle.
+ * @param d               IQ14 type d component.
+ * @param q               IQ14 type q component.
+ */
+void _IQ14park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 14);
+}
+/**
+ * @brief Computes the Park transform of IQ13 inputs.
+ *
+ * @param alpha           IQ13 type alpha component.
+ * @param beta            IQ13 type beta component.
+ * @param sin             IQ13 type sine of the angle.
+ * @param cos             IQ13 type cosine of the angle.
+ * @param d               IQ13 type d component.
+ * @param q               IQ13 type q component.
+ */
+void _IQ13park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 13);
+}
+/**
+ * @brief Computes the Park transform of IQ12 inputs.
+ *
+ * @param alpha           IQ12 type alpha component.
+ * @param beta            IQ12 type beta component.
+ * @param sin             IQ12 type sine of the angle.
+ * @param cos             IQ12 type cosine of the angle.
+ * @param d               IQ12 type d component.
+ * @param q               IQ12 type q component.
+ */
+void _IQ12park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 12);
+}
+/**
+ * @brief Computes the Park transform of IQ11 inputs.
+ *
+ * @param alpha           IQ11 type alpha component.
+ * @param beta            IQ11 type beta component.
+ * @param sin             IQ11 type sine of the angle.
+ * @param cos             IQ11 type cosine of the angle.
+ * @param d               IQ11 type d component.
+ * @param q               IQ11 type q component.
+ */
+void _IQ11park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 11);
+}
+/**
+ * @brief Computes the Park transform of IQ10 inputs.
+ *
+ * @param alpha           IQ10 type alpha component.
+ * @param beta            IQ10 type beta component.
+ * @param sin             IQ10 type sine of the angle.
+ * @param cos             IQ10 type cosine of the angle.
+ * @param d               IQ10 type d component.
+ * @param q               IQ10 type q component.
+ */
+void _IQ10park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 10);
+}
+/**
+ * @brief Computes the Park transform of IQ9 inputs.
+ *
+ * @param alpha           IQ9 type alpha component.
+ * @param beta            IQ9 type beta component.
+ * @param sin             IQ9 type sine of the angle.
+ * @param cos             IQ9 type cosine of the angle.
+ * @param d               IQ9 type d component.
+ * @param q               IQ9 type q component.
+ */
+void _IQ9park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 9);
+}
+/**
+ * @brief Computes the Park transform of IQ8 inputs.
+ *
+ * @param alpha           IQ8 type alpha component.
+ * @param beta            IQ8 type beta component.
+ * @param sin             IQ8 type sine of the angle.
+ * @param cos             IQ8 type cosine of the angle.
+ * @param d               IQ8 type d component.
+ * @param q               IQ8 type q component.
+ */
+void _IQ8park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 8);
+}
+/**
+ * @brief Computes the Park transform of IQ7 inputs.
+ *
+ * @param alpha           IQ7 type alpha component.
+ * @param beta            IQ7 type beta component.
+ * @param sin             IQ7 type sine of the angle.
+ * @param cos             IQ7 type cosine of the angle.
+ * @param d               IQ7 type d component.
+ * @param q               IQ7 type q component.
+ */
+void _IQ7park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 7);
+}
+/**
+ * @brief Computes the Park transform of IQ6 inputs.
+ *
+ * @param alpha           IQ6 type alpha component.
+ * @param beta            IQ6 type beta component.
+ * @param sin             IQ6 type sine of the angle.
+ * @param cos             IQ6 type cosine of the angle.
+ * @param d               IQ6 type d component.
+ * @param q               IQ6 type q component.
+ */
+void _IQ6park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 6);
+}
+/**
+ * @brief Computes the Park transform of IQ5 inputs.
+ *
+ * @param alpha           IQ5 type alpha component.
+ * @param beta            IQ5 type beta component.
+ * @param sin             IQ5 type sine of the angle.
+ * @param cos             IQ5 type cosine of the angle.
+ * @param d               IQ5 type d component.
+ * @param q               IQ5 type q component.
+ */
+void _IQ5park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 5);
+}
+/**
+ * @brief Computes the Park transform of IQ4 inputs.
+ *
+ * @param alpha           IQ4 type alpha component.
+ * @param beta            IQ4 type beta component.
+ * @param sin             IQ4 type sine of the angle.
+ * @param cos             IQ4 type cosine of the angle.
+ * @param d               IQ4 type d component.
+ * @param q               IQ4 type q component.
+ */
+void _IQ4park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 4);
+}
+/**
+ * @brief Computes the Park transform of IQ3 inputs.
+ *
+ * @param alpha           IQ3 type alpha component.
+ * @param beta            IQ3 type beta component.
+ * @param sin             IQ3 type sine of the angle.
+ * @param cos             IQ3 type cosine of the angle.
+ * @param d               IQ3 type d component.
+ * @param q               IQ3 type q component.
+ */
+void _IQ3park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 3);
+}
+/**
+ * @brief Computes the Park transform of IQ2 inputs.
+ *
+ * @param alpha           IQ2 type alpha component.
+ * @param beta            IQ2 type beta component.
+ * @param sin             IQ2 type sine of the angle.
+ * @param cos             IQ2 type cosine of the angle.
+ * @param d               IQ2 type d component.
+ * @param q               IQ2 type q component.
+ */
+void _IQ2park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 2);
+}
+/**
+ * @brief Computes the Park transform of IQ1 inputs.
+ *
+ * @param alpha           IQ1 type alpha component.
+ * @param beta            IQ1 type beta component.
+ * @param sin             IQ1 type sine of the angle.
+ * @param cos             IQ1 type cosine of the angle.
+ * @param d               IQ1 type d component.
+ * @param q               IQ1 type q component.
+ */
+void _IQ1park(int32_t alpha, int32_t beta, int32_t sin, int32_t cos, int32_t *d, int32_t *q)
+{
+    __IQNpark(alpha, beta, sin, cos, d, q, 1);
+}
+
+/* IQ ipark functions */
+/**
+ * @brief Computes the inverse Park transform of IQ30 inputs.
+ *
+ * @param d               IQ30 type d component.
+ * @param q               IQ30 type q component.
+ * @param sin             IQ30 type sine of the angle.
+ * @param cos             IQ30 type cosine of the angle.
+ * @param alpha           IQ30 type alpha component.
+ * @param beta            IQ30 type beta component.
+ */
+void _IQ30ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 30);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ29 inputs.
+ *
+ * @param d               IQ29 type d component.
+ * @param q               IQ29 type q component.
+ * @param sin             IQ29 type sine of the angle.
+ * @param cos             IQ29 type cosine of the angle.
+ * @param alpha           IQ29 type alpha component.
+ * @param beta            IQ29 type beta component.
+ */
+void _IQ29ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 29);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ28 inputs.
+ *
+ * @param d               IQ28 type d component.
+ * @param q               IQ28 type q component.
+ * @param sin             IQ28 type sine of the angle.
+ * @param cos             IQ28 type cosine of the angle.
+ * @param alpha           IQ28 type alpha component.
+ * @param beta            IQ28 type beta component.
+ */
+void _IQ28ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 28);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ27 inputs.
+ *
+ * @param d               IQ27 type d component.
+ * @param q               IQ27 type q component.
+ * @param sin             IQ27 type sine of the angle.
+ * @param cos             IQ27 type cosine of the angle.
+ * @param alpha           IQ27 type alpha component.
+ * @param beta            IQ27 type beta component.
+ */
+void _IQ27ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 27);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ26 inputs.
+ *
+ * @param d               IQ26 type d component.
+ * @param q               IQ26 type q component.
+ * @param sin             IQ26 type sine of the angle.
+ * @param cos             IQ26 type cosine of the angle.
+ * @param alpha           IQ26 type alpha component.
+ * @param beta            IQ26 type beta component.
+ */
+void _IQ26ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 26);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ25 inputs.
+ *
+ * @param d               IQ25 type d component.
+ * @param q               IQ25 type q component.
+ * @param sin             IQ25 type sine of the angle.
+ * @param cos             IQ25 type cosine of the angle.
+ * @param alpha           IQ25 type alpha component.
+ * @param beta            IQ25 type beta component.
+ */
+void _IQ25ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 25);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ24 inputs.
+ *
+ * @param d               IQ24 type d component.
+ * @param q               IQ24 type q component.
+ * @param sin             IQ24 type sine of the angle.
+ * @param cos             IQ24 type cosine of the angle.
+ * @param alpha           IQ24 type alpha component.
+ * @param beta            IQ24 type beta component.
+ */
+void _IQ24ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 24);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ23 inputs.
+ *
+ * @param d               IQ23 type d component.
+ * @param q               IQ23 type q component.
+ * @param sin             IQ23 type sine of the angle.
+ * @param cos             IQ23 type cosine of the angle.
+ * @param alpha           IQ23 type alpha component.
+ * @param beta            IQ23 type beta component.
+ */
+void _IQ23ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 23);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ22 inputs.
+ *
+ * @param d               IQ22 type d component.
+ * @param q               IQ22 type q component.
+ * @param sin             IQ22 type sine of the angle.
+ * @param cos             IQ22 type cosine of the angle.
+ * @param alpha           IQ22 type alpha component.
+ * @param beta            IQ22 type beta component.
+ */
+void _IQ22ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 22);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ21 inputs.
+ *
+ * @param d               IQ21 type d component.
+ * @param q               IQ21 type q component.
+ * @param sin             IQ21 type sine of the angle.
+ * @param cos             IQ21 type cosine of the angle.
+ * @param alpha           IQ21 type alpha component.
+ * @param beta            IQ21 type beta component.
+ */
+void _IQ21ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 21);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ20 inputs.
+ *
+ * @param d               IQ20 type d component.
+ * @param q               IQ20 type q component.
+ * @param sin             IQ20 type sine of the angle.
+ * @param cos             IQ20 type cosine of the angle.
+ * @param alpha           IQ20 type alpha component.
+ * @param beta            IQ20 type beta component.
+ */
+void _IQ20ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 20);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ19 inputs.
+ *
+ * @param d               IQ19 type d component.
+ * @param q               IQ19 type q component.
+ * @param sin             IQ19 type sine of the angle.
+ * @param cos             IQ19 type cosine of the angle.
+ * @param alpha           IQ19 type alpha component.
+ * @param beta            IQ19 type beta component.
+ */
+void _IQ19ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 19);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ18 inputs.
+ *
+ * @param d               IQ18 type d component.
+ * @param q               IQ18 type q component.
+ * @param sin             IQ18 type sine of the angle.
+ * @param cos             IQ18 type cosine of the angle.
+ * @param alpha           IQ18 type alpha component.
+ * @param beta            IQ18 type beta component.
+ */
+void _IQ18ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 18);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ17 inputs.
+ *
+ * @param d               IQ17 type d component.
+ * @param q               IQ17 type q component.
+ * @param sin             IQ17 type sine of the angle.
+ * @param cos             IQ17 type cosine of the angle.
+ * @param alpha           IQ17 type alpha component.
+ * @param beta            IQ17 type beta component.
+ */
+void _IQ17ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 17);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ16 inputs.
+ *
+ * @param d               IQ16 type d component.
+ * @param q               IQ16 type q component.
+ * @param sin             IQ16 type sine of the angle.
+ * @param cos             IQ16 type cosine of the angle.
+ * @param alpha           IQ16 type alpha component.
+ * @param beta            IQ16 type beta component.
+ */
+void _IQ16ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 16);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ15 inputs.
+ *
+ * @param d               IQ15 type d component.
+ * @param q               IQ15 type q component.
+ * @param sin             IQ15 type sine of the angle.
+ * @param cos             IQ15 type cosine of the angle.
+ * @param alpha           IQ15 type alpha component.
+ * @param beta            IQ15 type beta component.
+ */
+void _IQ15ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 15);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ14 inputs.
+ *
+ * @param d               IQ14 type d component.
+ * @param q               IQ14 type q component.
+ * @param sin             IQ14 type sine of the angle.
+ * @param cos             IQ14 type cosine of the angle.
+ * @param alpha           IQ14 type alpha component.
+ * @param beta            IQ14 type beta component.
+ */
+void _IQ14ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 14);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ13 inputs.
+ *
+ * @param d               IQ13 type d component.
+ * @param q               IQ13 type q component.
+ * @param sin             IQ13 type sine of the angle.
+ * @param cos             IQ13 type cosine of the angle.
+ * @param alpha           IQ13 type alpha component.
+ * @param beta            IQ13 type beta component.
+ */
+void _IQ13ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 13);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ12 inputs.
+ *
+ * @param d               IQ12 type d component.
+ * @param q               IQ12 type q component.
+ * @param sin             IQ12 type sine of the angle.
+ * @param cos             IQ12 type cosine of the angle.
+ * @param alpha           IQ12 type alpha component.
+ * @param beta            IQ12 type beta component.
+ */
+void _IQ12ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 12);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ11 inputs.
+ *
+ * @param d               IQ11 type d component.
+ * @param q               IQ11 type q component.
+ * @param sin             IQ11 type sine of the angle.
+ * @param cos             IQ11 type cosine of the angle.
+ * @param alpha           IQ11 type alpha component.
+ * @param beta            IQ11 type beta component.
+ */
+void _IQ11ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 11);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ10 inputs.
+ *
+ * @param d               IQ10 type d component.
+ * @param q               IQ10 type q component.
+ * @param sin             IQ10 type sine of the angle.
+ * @param cos             IQ10 type cosine of the angle.
+ * @param alpha           IQ10 type alpha component.
+ * @param beta            IQ10 type beta component.
+ */
+void _IQ10ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 10);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ9 inputs.
+ *
+ * @param d               IQ9 type d component.
+ * @param q               IQ9 type q component.
+ * @param sin             IQ9 type sine of the angle.
+ * @param cos             IQ9 type cosine of the angle.
+ * @param alpha           IQ9 type alpha component.
+ * @param beta            IQ9 type beta component.
+ */
+void _IQ9ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 9);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ8 inputs.
+ *
+ * @param d               IQ8 type d component.
+ * @param q               IQ8 type q component.
+ * @param sin             IQ8 type sine of the angle.
+ * @param cos             IQ8 type cosine of the angle.
+ * @param alpha           IQ8 type alpha component.
+ * @param beta            IQ8 type beta component.
+ */
+void _IQ8ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 8);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ7 inputs.
+ *
+ * @param d               IQ7 type d component.
+ * @param q               IQ7 type q component.
+ * @param sin             IQ7 type sine of the angle.
+ * @param cos             IQ7 type cosine of the angle.
+ * @param alpha           IQ7 type alpha component.
+ * @param beta            IQ7 type beta component.
+ */
+void _IQ7ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 7);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ6 inputs.
+ *
+ * @param d               IQ6 type d component.
+ * @param q               IQ6 type q component.
+ * @param sin             IQ6 type sine of the angle.
+ * @param cos             IQ6 type cosine of the angle.
+ * @param alpha           IQ6 type alpha component.
+ * @param beta            IQ6 type beta component.
+ */
+void _IQ6ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 6);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ5 inputs.
+ *
+ * @param d               IQ5 type d component.
+ * @param q               IQ5 type q component.
+ * @param sin             IQ5 type sine of the angle.
+ * @param cos             IQ5 type cosine of the angle.
+ * @param alpha           IQ5 type alpha component.
+ * @param beta            IQ5 type beta component.
+ */
+void _IQ5ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 5);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ4 inputs.
+ *
+ * @param d               IQ4 type d component.
+ * @param q               IQ4 type q component.
+ * @param sin             IQ4 type sine of the angle.
+ * @param cos             IQ4 type cosine of the angle.
+ * @param alpha           IQ4 type alpha component.
+ * @param beta            IQ4 type beta component.
+ */
+void _IQ4ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 4);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ3 inputs.
+ *
+ * @param d               IQ3 type d component.
+ * @param q               IQ3 type q component.
+ * @param sin             IQ3 type sine of the angle.
+ * @param cos             IQ3 type cosine of the angle.
+ * @param alpha           IQ3 type alpha component.
+ * @param beta            IQ3 type beta component.
+ */
+void _IQ3ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 3);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ2 inputs.
+ *
+ * @param d               IQ2 type d component.
+ * @param q               IQ2 type q component.
+ * @param sin             IQ2 type sine of the angle.
+ * @param cos             IQ2 type cosine of the angle.
+ * @param alpha           IQ2 type alpha component.
+ * @param beta            IQ2 type beta component.
+ */
+void _IQ2ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 2);
+}
+/**
+ * @brief Computes the inverse Park transform of IQ1 inputs.
+ *
+ * @param d               IQ1 type d component.
+ * @param q               IQ1 type q component.
+ * @param sin             IQ1 type sine of the angle.
+ * @param cos             IQ1 type cosine of the angle.
+ * @param alpha           IQ1 type alpha component.
+ * @param beta            IQ1 type beta component.
+ */
+void _IQ1ipark(int32_t d, int32_t q, int32_t sin, int32_t cos, int32_t *alpha, int32_t *beta)
+{
+    __IQNipark(d, q, sin, cos, alpha, beta, 1);
+}
@@ -38,7 +38,7 @@
 #endif
 __STATIC_INLINE int_fast32_t __IQNdiv(int_fast32_t iqNInput1, int_fast32_t iqNInput2, const uint8_t type, const int8_t q_value)
 {
-    uint8_t ui8Index, ui8Sign = 0;
+    uint8_t ui8Index, ui8Shift, ui8Sign = 0;
     uint_fast32_t ui32Temp;
     uint_fast32_t uiq30Guess;
     uint_fast32_t uiqNInput1;
@@ -56,30 +56,36 @@ __STATIC_INLINE int_fast32_t __IQNdiv(int_fast32_t iqNInput1, int_fast32_t iqNIn
                 return INT32_MAX;
             } else {
                 ui8Sign = 1;
-                iqNInput2 = -iqNInput2;
             }
         }
 
         /* save sign of numerator */
         if (iqNInput1 < 0) {
             ui8Sign ^= 1;
-            iqNInput1 = -iqNInput1;
         }
+
+        /*
+         * Save the magnitudes to unsigned IQN and IIQN (64-bit). They are
+         * negated as unsigned values, so that INT32_MIN gives 2^31.
+         */
+        uiiqNInput1 = iqNInput1 < 0 ? -(uint_fast32_t)iqNInput1 : (uint_fast32_t)iqNInput1;
+        uiqNInput2 = iqNInput2 < 0 ? -(uint_fast32_t)iqNInput2 : (uint_fast32_t)iqNInput2;
     } else {
         /* Check for divide by zero */
         if (iqNInput2 == 0) {
             return INT32_MAX;
         }
-    }
 
-    /* Save input1 and input2 to unsigned IQN and IIQN (64-bit). */
-    uiiqNInput1 = (uint_fast64_t)iqNInput1;
-    uiqNInput2 = (uint_fast32_t)iqNInput2;
+        /* Save input1 and input2 to unsigned IQN and IIQN (64-bit). */
+        uiiqNInput1 = (uint_fast64_t)iqNInput1;
+        uiqNInput2 = (uint_fast32_t)iqNInput2;
+    }
 
     /* Scale inputs so that 0.5 <= uiqNInput2 < 1.0. */
-    while (uiqNInput2 < 0x40000000) {
-        uiqNInput2 <<= 1;
-        uiiqNInput1 <<= 1;
+    if (uiqNInput2 < 0x40000000) {
+        ui8Shift = __clz_ul(uiqNInput2) - 1;
+        uiqNInput2 <<= ui8Shift;
+        uiiqNInput1 <<= ui8Shift;
     }
 
     /*
@@ -4,6 +4,8 @@
  *
  *  <hr>
  ******************************************************************************/
+#include <stddef.h>
+
 #include "_IQNmpy.h"
 
 /**
@@ -378,3 +380,389 @@ int32_t _IQ1mpy(int32_t a, int32_t b)
 {
     return __IQNmpy(a, b, 1);
 }
+
+/* IQ mpy array functions */
+
+/**
+ * @brief Multiply two arrays of IQN type element by element.
+ *
+ * @param iqNInput1       IQN type array to be multiplied.
+ * @param iqNInput2       IQN type array to be multiplied.
+ * @param iqNResult       IQN type array receiving the products, may be one of the inputs.
+ * @param n               Number of elements.
+ * @param q_value         IQ format.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNmpy_v)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNmpy_v(const int32_t *iqNInput1, const int32_t *iqNInput2, int32_t *iqNResult, size_t n,
+                                const int8_t q_value)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        iqNResult[i] = __IQNmpy(iqNInput1[i], iqNInput2[i], q_value);
+    }
+}
+/**
+ * @brief Multiplies two arrays of IQ30 format element by element.
+ *
+ * @param a             IQ30 type array to be multiplied.
+ * @param b             IQ30 type array to be multiplied.
+ * @param y             IQ30 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ30mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 30);
+}
+/**
+ * @brief Multiplies two arrays of IQ29 format element by element.
+ *
+ * @param a             IQ29 type array to be multiplied.
+ * @param b             IQ29 type array to be multiplied.
+ * @param y             IQ29 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ29mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 29);
+}
+/**
+ * @brief Multiplies two arrays of IQ28 format element by element.
+ *
+ * @param a             IQ28 type array to be multiplied.
+ * @param b             IQ28 type array to be multiplied.
+ * @param y             IQ28 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ28mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 28);
+}
+/**
+ * @brief Multiplies two arrays of IQ27 format element by element.
+ *
+ * @param a             IQ27 type array to be multiplied.
+ * @param b             IQ27 type array to be multiplied.
+ * @param y             IQ27 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ27mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 27);
+}
+/**
+ * @brief Multiplies two arrays of IQ26 format element by element.
+ *
+ * @param a             IQ26 type array to be multiplied.
+ * @param b             IQ26 type array to be multiplied.
+ * @param y             IQ26 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ26mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 26);
+}
+/**
+ * @brief Multiplies two arrays of IQ25 format element by element.
+ *
+ * @param a             IQ25 type array to be multiplied.
+ * @param b             IQ25 type array to be multiplied.
+ * @param y             IQ25 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ25mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 25);
+}
+/**
+ * @brief Multiplies two arrays of IQ24 format element by element.
+ *
+ * @param a             IQ24 type array to be multiplied.
+ * @param b             IQ24 type array to be multiplied.
+ * @param y             IQ24 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ24mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 24);
+}
+/**
+ * @brief Multiplies two arrays of IQ23 format element by element.
+ *
+ * @param a             IQ23 type array to be multiplied.
+ * @param b             IQ23 type array to be multiplied.
+ * @param y             IQ23 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ23mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 23);
+}
+/**
+ * @brief Multiplies two arrays of IQ22 format element by element.
+ *
+ * @param a             IQ22 type array to be multiplied.
+ * @param b             IQ22 type array to be multiplied.
+ * @param y             IQ22 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ22mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 22);
+}
+/**
+ * @brief Multiplies two arrays of IQ21 format element by element.
+ *
+ * @param a             IQ21 type array to be multiplied.
+ * @param b             IQ21 type array to be multiplied.
+ * @param y             IQ21 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ21mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 21);
+}
+/**
+ * @brief Multiplies two arrays of IQ20 format element by element.
+ *
+ * @param a             IQ20 type array to be multiplied.
+ * @param b             IQ20 type array to be multiplied.
+ * @param y             IQ20 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ20mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 20);
+}
+/**
+ * @brief Multiplies two arrays of IQ19 format element by element.
+ *
+ * @param a             IQ19 type array to be multiplied.
+ * @param b             IQ19 type array to be multiplied.
+ * @param y             IQ19 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ19mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 19);
+}
+/**
+ * @brief Multiplies two arrays of IQ18 format element by element.
+ *
+ * @param a             IQ18 type array to be multiplied.
+ * @param b             IQ18 type array to be multiplied.
+ * @param y             IQ18 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ18mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 18);
+}
+/**
+ * @brief Multiplies two arrays of IQ17 format element by element.
+ *
+ * @param a             IQ17 type array to be multiplied.
+ * @param b             IQ17 type array to be multiplied.
+ * @param y             IQ17 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ17mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 17);
+}
+/**
+ * @brief Multiplies two arrays of IQ16 format element by element.
+ *
+ * @param a             IQ16 type array to be multiplied.
+ * @param b             IQ16 type array to be multiplied.
+ * @param y             IQ16 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ16mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 16);
+}
+/**
+ * @brief Multiplies two arrays of IQ15 format element by element.
+ *
+ * @param a             IQ15 type array to be multiplied.
+ * @param b             IQ15 type array to be multiplied.
+ * @param y             IQ15 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ15mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 15);
+}
+/**
+ * @brief Multiplies two arrays of IQ14 format element by element.
+ *
+ * @param a             IQ14 type array to be multiplied.
+ * @param b             IQ14 type array to be multiplied.
+ * @param y             IQ14 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ14mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 14);
+}
+/**
+ * @brief Multiplies two arrays of IQ13 format element by element.
+ *
+ * @param a             IQ13 type array to be multiplied.
+ * @param b             IQ13 type array to be multiplied.
+ * @param y             IQ13 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ13mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 13);
+}
+/**
+ * @brief Multiplies two arrays of IQ12 format element by element.
+ *
+ * @param a             IQ12 type array to be multiplied.
+ * @param b             IQ12 type array to be multiplied.
+ * @param y             IQ12 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ12mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 12);
+}
+/**
+ * @brief Multiplies two arrays of IQ11 format element by element.
+ *
+ * @param a             IQ11 type array to be multiplied.
+ * @param b             IQ11 type array to be multiplied.
+ * @param y             IQ11 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ11mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 11);
+}
+/**
+ * @brief Multiplies two arrays of IQ10 format element by element.
+ *
+ * @param a             IQ10 type array to be multiplied.
+ * @param b             IQ10 type array to be multiplied.
+ * @param y             IQ10 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ10mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 10);
+}
+/**
+ * @brief Multiplies two arrays of IQ9 format element by element.
+ *
+ * @param a             IQ9 type array to be multiplied.
+ * @param b             IQ9 type array to be multiplied.
+ * @param y             IQ9 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ9mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 9);
+}
+/**
+ * @brief Multiplies two arrays of IQ8 format element by element.
+ *
+ * @param a             IQ8 type array to be multiplied.
+ * @param b             IQ8 type array to be multiplied.
+ * @param y             IQ8 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ8mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 8);
+}
+/**
+ * @brief Multiplies two arrays of IQ7 format element by element.
+ *
+ * @param a             IQ7 type array to be multiplied.
+ * @param b             IQ7 type array to be multiplied.
+ * @param y             IQ7 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ7mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 7);
+}
+/**
+ * @brief Multiplies two arrays of IQ6 format element by element.
+ *
+ * @param a             IQ6 type array to be multiplied.
+ * @param b             IQ6 type array to be multiplied.
+ * @param y             IQ6 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ6mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 6);
+}
+/**
+ * @brief Multiplies two arrays of IQ5 format element by element.
+ *
+ * @param a             IQ5 type array to be multiplied.
+ * @param b             IQ5 type array to be multiplied.
+ * @param y             IQ5 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ5mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 5);
+}
+/**
+ * @brief Multiplies two arrays of IQ4 format element by element.
+ *
+ * @param a             IQ4 type array to be multiplied.
+ * @param b             IQ4 type array to be multiplied.
+ * @param y             IQ4 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ4mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 4);
+}
+/**
+ * @brief Multiplies two arrays of IQ3 format element by element.
+ *
+ * @param a             IQ3 type array to be multiplied.
+ * @param b             IQ3 type array to be multiplied.
+ * @param y             IQ3 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ3mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 3);
+}
+/**
+ * @brief Multiplies two arrays of IQ2 format element by element.
+ *
+ * @param a             IQ2 type array to be multiplied.
+ * @param b             IQ2 type array to be multiplied.
+ * @param y             IQ2 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ2mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 2);
+}
+/**
+ * @brief Multiplies two arrays of IQ1 format element by element.
+ *
+ * @param a             IQ1 type array to be multiplied.
+ * @param b             IQ1 type array to be multiplied.
+ * @param y             IQ1 type array receiving the products, may be a or b.
+ * @param n             Number of elements.
+ */
+void _IQ1mpy_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    __IQNmpy_v(a, b, y, n, 1);
+}
@@ -6,6 +6,7 @@
  *  <hr>
  ******************************************************************************/
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "../support/support.h"
@@ -181,6 +182,61 @@ __STATIC_INLINE int_fast32_t __IQNcalcCos(uint_fast32_t uiq31Input)
     return iq31Res;
 }
 
+/**
+ * @brief Computes the sine and the cosine of an UIQ31 input.
+ *
+ * Same computation as __IQNcalcSin() and __IQNcalcCos(), sharing the table
+ * lookups and the remainder.
+ *
+ * @param uiq31Input      UIQ31 type input.
+ * @param iq31SinResult   UIQ31 type result of sine.
+ * @param iq31CosResult   UIQ31 type result of cosine.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNcalcSinCos)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNcalcSinCos(uint_fast32_t uiq31Input, int_fast32_t *iq31SinResult,
+                                     int_fast32_t *iq31CosResult)
+{
+    uint_fast16_t index;
+    int_fast32_t iq31X;
+    int_fast32_t iq31Sin;
+    int_fast32_t iq31Cos;
+    int_fast32_t iq31Third;
+    int_fast32_t iq31Res;
+
+    /* Calculate index for sin and cos lookup using bits 31:26 */
+    index = (uint_fast16_t)(uiq31Input >> 25) & 0x003f;
+
+    /* Lookup S(k) and C(k) values. */
+    iq31Sin = _IQ31SinLookup[index];
+    iq31Cos = _IQ31CosLookup[index];
+
+    /* Calculate x (the remainder) and 0.333*x, shared by both results. */
+    iq31X = uiq31Input & 0x01ffffff;
+    iq31Third = __mpyf_l(0x2aaaaaab, iq31X);
+
+    /* sin(Radian) = S(k) + x*(C(k) + 0.5*x*(-S(k) - 0.333*x*C(k))) */
+    iq31Res = __mpyf_l(iq31Cos, iq31Third);
+    iq31Res = -(iq31Sin + iq31Res);
+    iq31Res = iq31Res >> 1;
+    iq31Res = __mpyf_l(iq31X, iq31Res);
+    iq31Res = iq31Cos + iq31Res;
+    iq31Res = __mpyf_l(iq31X, iq31Res);
+    *iq31SinResult = iq31Sin + iq31Res;
+
+    /* cos(Radian) = C(k) + x*(-S(k) + 0.5*x*(-C(k) + 0.333*x*S(k))) */
+    iq31Res = __mpyf_l(iq31Sin, iq31Third);
+    iq31Res = iq31Res - iq31Cos;
+    iq31Res = iq31Res >> 1;
+    iq31Res = __mpyf_l(iq31X, iq31Res);
+    iq31Res = iq31Res - iq31Sin;
+    iq31Res = __mpyf_l(iq31X, iq31Res);
+    *iq31CosResult = iq31Cos + iq31Res;
+}
+
 /**
  * @brief Computes the sine or cosine of an IQN input.
  *
@@ -322,6 +378,107 @@ __STATIC_INLINE int_fast32_t __IQNsin_cos(int_fast32_t iqNInput, const int8_t q_
 
     return uiq31Result;
 }
+
+/**
+ * @brief Computes the sine and the cosine of an IQN input.
+ *
+ * The results are the same as the ones of __IQNsin_cos() for TYPE_SIN and
+ * TYPE_COS, but the range reduction and the table lookups are only done once.
+ *
+ * @param iqNInput        IQN type input.
+ * @param q_value         IQ format.
+ * @param format          Specifies radians or per-unit operation.
+ * @param iqNSin          IQN type result of sine operation.
+ * @param iqNCos          IQN type result of cosine operation.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNsincos)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNsincos(int_fast32_t iqNInput, const int8_t q_value, const int8_t format,
+                                 int32_t *iqNSin, int32_t *iqNCos)
+{
+    uint8_t ui8SinSign = 0;
+    uint8_t ui8CosSign = 0;
+    uint_fast16_t ui16IntState;
+    uint_fast16_t ui16MPYState;
+    uint_fast32_t uiq29Input;
+    uint_fast32_t uiq30Input;
+    uint_fast32_t uiq31Input;
+    uint_fast32_t uiq32Input;
+    int_fast32_t iq31Sin;
+    int_fast32_t iq31Cos;
+    uint_fast32_t uiq31Sin;
+    uint_fast32_t uiq31Cos;
+
+    /* Remove sign from input, only the sine changes sign */
+    if (iqNInput < 0) {
+        iqNInput = -iqNInput;
+        ui8SinSign = 1;
+    }
+
+    __mpyf_start(&ui16IntState, &ui16MPYState);
+
+    /* Per unit API */
+    if (format == TYPE_PU) {
+        uiq32Input = (uint_fast32_t)iqNInput << (32 - q_value);
+
+        /* Reduce the input to the first two quadrants, both results change sign. */
+        if (uiq32Input >= 0x80000000) {
+            uiq32Input -= 0x80000000;
+            ui8SinSign ^= 1;
+            ui8CosSign ^= 1;
+        }
+
+        uiq30Input = __mpyf_ul(uiq32Input, iq30_pi);
+    }
+    /* Radians API */
+    else {
+        int_fast16_t exp = 29 - q_value;
+
+        uiq29Input = (uint_fast32_t)iqNInput;
+
+        while (exp) {
+            if (uiq29Input >= iq29_pi) {
+                uiq29Input -= iq29_pi;
+            }
+            uiq29Input <<= 1;
+            exp--;
+        }
+
+        if (uiq29Input >= iq29_pi) {
+            uiq29Input -= iq29_pi;
+            ui8SinSign ^= 1;
+            ui8CosSign ^= 1;
+        }
+
+        uiq30Input = uiq29Input << 1;
+    }
+
+    /* Reduce the iq30 input range to the first quadrant, only the cosine changes sign. */
+    if (uiq30Input >= iq30_halfPi) {
+        uiq30Input = iq30_pi - uiq30Input;
+        ui8CosSign ^= 1;
+    }
+
+    uiq31Input = uiq30Input << 1;
+
+    /* Above pi/4, sin(x) = cos(pi/2 - x) and cos(x) = sin(pi/2 - x) */
+    if (uiq31Input > iq31_quarterPi) {
+        __IQNcalcSinCos(iq31_halfPi - uiq31Input, &iq31Cos, &iq31Sin);
+    } else {
+        __IQNcalcSinCos(uiq31Input, &iq31Sin, &iq31Cos);
+    }
+
+    __mpy_stop(&ui16IntState, &ui16MPYState);
+
+    /* Shift to Q type and set the signs */
+    uiq31Sin = (uint_fast32_t)iq31Sin >> (31 - q_value);
+    uiq31Cos = (uint_fast32_t)iq31Cos >> (31 - q_value);
+    *iqNSin = ui8SinSign ? -uiq31Sin : uiq31Sin;
+    *iqNCos = ui8CosSign ? -uiq31Cos : uiq31Cos;
+}
 #else
 /**
  * @brief Computes the sine or cosine of an IQN input, using MathACL.
@@ -383,6 +540,40 @@ __STATIC_INLINE int_fast32_t __IQNsin_cos(int_fast32_t iqNInput, const int8_t q_
     res = res1 >> (31 - q_value);
     return res;
 }
+
+/**
+ * @brief Computes the sine and the cosine of an IQN input, using MathACL.
+ *
+ * @param iqNInput        IQN type input.
+ * @param q_value         IQ format.
+ * @param format          Specifies radians or per-unit operation.
+ * @param iqNSin          IQN type result of sine operation.
+ * @param iqNCos          IQN type result of cosine operation.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNsincos)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNsincos(int_fast32_t iqNInput, const int8_t q_value, const int8_t format,
+                                 int32_t *iqNSin, int32_t *iqNCos)
+{
+    int_fast32_t iq31input;
+
+    if (format == TYPE_PU) {
+        iq31input = (uint_fast32_t)((uint_fast32_t)iqNInput << 1) << (31 - q_value);
+    } else {
+        MATHACL->CTL = 4 | (q_value << 8) | (1 << 5);
+        MATHACL->OP2 = ((uint_fast32_t)((PI) * ((uint_fast32_t)1 << q_value)));
+        MATHACL->OP1 = iqNInput;
+        iq31input = (uint_fast32_t)MATHACL->RES1 << (31 - q_value);
+    }
+    /* operation = sincos, iterations = 31, both results are available at once */
+    MATHACL->CTL = 1 | (31 << 24);
+    MATHACL->OP1 = iq31input;
+    *iqNCos = (int_fast32_t)MATHACL->RES1 >> (31 - q_value);
+    *iqNSin = (int_fast32_t)MATHACL->RES2 >> (31 - q_value);
+}
 #endif
 
 /* IQ sin functions */
@@ -1713,3 +1904,999 @@ int32_t _IQ1cosPU(int32_t a)
 {
     return __IQNsin_cos(a, 1, TYPE_COS, TYPE_PU);
 }
+
+/* IQ sin array functions */
+
+/**
+ * @brief Computes the sine of an array of IQN inputs, in radians.
+ *
+ * @param iqNInput        IQN type input array.
+ * @param iqNResult       IQN type array receiving the results, may be the input.
+ * @param n               Number of elements.
+ * @param q_value         IQ format.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNsin_v)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNsin_v(const int32_t *iqNInput, int32_t *iqNResult, size_t n, const int8_t q_value)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        iqNResult[i] = __IQNsin_cos(iqNInput[i], q_value, TYPE_SIN, TYPE_RAD);
+    }
+}
+/**
+ * @brief Computes the sine of an array of IQ29 inputs.
+ *
+ * @param a               IQ29 type input array.
+ * @param y               IQ29 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ29sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 29);
+}
+/**
+ * @brief Computes the sine of an array of IQ28 inputs.
+ *
+ * @param a               IQ28 type input array.
+ * @param y               IQ28 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ28sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 28);
+}
+/**
+ * @brief Computes the sine of an array of IQ27 inputs.
+ *
+ * @param a               IQ27 type input array.
+ * @param y               IQ27 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ27sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 27);
+}
+/**
+ * @brief Computes the sine of an array of IQ26 inputs.
+ *
+ * @param a               IQ26 type input array.
+ * @param y               IQ26 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ26sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 26);
+}
+/**
+ * @brief Computes the sine of an array of IQ25 inputs.
+ *
+ * @param a               IQ25 type input array.
+ * @param y               IQ25 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ25sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 25);
+}
+/**
+ * @brief Computes the sine of an array of IQ24 inputs.
+ *
+ * @param a               IQ24 type input array.
+ * @param y               IQ24 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ24sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 24);
+}
+/**
+ * @brief Computes the sine of an array of IQ23 inputs.
+ *
+ * @param a               IQ23 type input array.
+ * @param y               IQ23 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ23sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 23);
+}
+/**
+ * @brief Computes the sine of an array of IQ22 inputs.
+ *
+ * @param a               IQ22 type input array.
+ * @param y               IQ22 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ22sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 22);
+}
+/**
+ * @brief Computes the sine of an array of IQ21 inputs.
+ *
+ * @param a               IQ21 type input array.
+ * @param y               IQ21 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ21sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 21);
+}
+/**
+ * @brief Computes the sine of an array of IQ20 inputs.
+ *
+ * @param a               IQ20 type input array.
+ * @param y               IQ20 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ20sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 20);
+}
+/**
+ * @brief Computes the sine of an array of IQ19 inputs.
+ *
+ * @param a               IQ19 type input array.
+ * @param y               IQ19 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ19sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 19);
+}
+/**
+ * @brief Computes the sine of an array of IQ18 inputs.
+ *
+ * @param a               IQ18 type input array.
+ * @param y               IQ18 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ18sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 18);
+}
+/**
+ * @brief Computes the sine of an array of IQ17 inputs.
+ *
+ * @param a               IQ17 type input array.
+ * @param y               IQ17 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ17sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 17);
+}
+/**
+ * @brief Computes the sine of an array of IQ16 inputs.
+ *
+ * @param a               IQ16 type input array.
+ * @param y               IQ16 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ16sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 16);
+}
+/**
+ * @brief Computes the sine of an array of IQ15 inputs.
+ *
+ * @param a               IQ15 type input array.
+ * @param y               IQ15 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ15sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 15);
+}
+/**
+ * @brief Computes the sine of an array of IQ14 inputs.
+ *
+ * @param a               IQ14 type input array.
+ * @param y               IQ14 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ14sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 14);
+}
+/**
+ * @brief Computes the sine of an array of IQ13 inputs.
+ *
+ * @param a               IQ13 type input array.
+ * @param y               IQ13 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ13sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 13);
+}
+/**
+ * @brief Computes the sine of an array of IQ12 inputs.
+ *
+ * @param a               IQ12 type input array.
+ * @param y               IQ12 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ12sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 12);
+}
+/**
+ * @brief Computes the sine of an array of IQ11 inputs.
+ *
+ * @param a               IQ11 type input array.
+ * @param y               IQ11 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ11sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 11);
+}
+/**
+ * @brief Computes the sine of an array of IQ10 inputs.
+ *
+ * @param a               IQ10 type input array.
+ * @param y               IQ10 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ10sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 10);
+}
+/**
+ * @brief Computes the sine of an array of IQ9 inputs.
+ *
+ * @param a               IQ9 type input array.
+ * @param y               IQ9 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ9sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 9);
+}
+/**
+ * @brief Computes the sine of an array of IQ8 inputs.
+ *
+ * @param a               IQ8 type input array.
+ * @param y               IQ8 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ8sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 8);
+}
+/**
+ * @brief Computes the sine of an array of IQ7 inputs.
+ *
+ * @param a               IQ7 type input array.
+ * @param y               IQ7 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ7sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 7);
+}
+/**
+ * @brief Computes the sine of an array of IQ6 inputs.
+ *
+ * @param a               IQ6 type input array.
+ * @param y               IQ6 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ6sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 6);
+}
+/**
+ * @brief Computes the sine of an array of IQ5 inputs.
+ *
+ * @param a               IQ5 type input array.
+ * @param y               IQ5 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ5sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 5);
+}
+/**
+ * @brief Computes the sine of an array of IQ4 inputs.
+ *
+ * @param a               IQ4 type input array.
+ * @param y               IQ4 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ4sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 4);
+}
+/**
+ * @brief Computes the sine of an array of IQ3 inputs.
+ *
+ * @param a               IQ3 type input array.
+ * @param y               IQ3 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ3sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 3);
+}
+/**
+ * @brief Computes the sine of an array of IQ2 inputs.
+ *
+ * @param a               IQ2 type input array.
+ * @param y               IQ2 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ2sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 2);
+}
+/**
+ * @brief Computes the sine of an array of IQ1 inputs.
+ *
+ * @param a               IQ1 type input array.
+ * @param y               IQ1 type array receiving the results, in radians, may be a.
+ * @param n               Number of elements.
+ */
+void _IQ1sin_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsin_v(a, y, n, 1);
+}
+
+/* IQ sincos functions */
+/**
+ * @brief Computes the sine and the cosine of an IQ29 input.
+ *
+ * @param a               IQ29 type input, in radians.
+ * @param sin             IQ29 type result of sine operation.
+ * @param cos             IQ29 type result of cosine operation.
+ */
+void _IQ29sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 29, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ28 input.
+ *
+ * @param a               IQ28 type input, in radians.
+ * @param sin             IQ28 type result of sine operation.
+ * @param cos             IQ28 type result of cosine operation.
+ */
+void _IQ28sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 28, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ27 input.
+ *
+ * @param a               IQ27 type input, in radians.
+ * @param sin             IQ27 type result of sine operation.
+ * @param cos             IQ27 type result of cosine operation.
+ */
+void _IQ27sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 27, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ26 input.
+ *
+ * @param a               IQ26 type input, in radians.
+ * @param sin             IQ26 type result of sine operation.
+ * @param cos             IQ26 type result of cosine operation.
+ */
+void _IQ26sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 26, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ25 input.
+ *
+ * @param a               IQ25 type input, in radians.
+ * @param sin             IQ25 type result of sine operation.
+ * @param cos             IQ25 type result of cosine operation.
+ */
+void _IQ25sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 25, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ24 input.
+ *
+ * @param a               IQ24 type input, in radians.
+ * @param sin             IQ24 type result of sine operation.
+ * @param cos             IQ24 type result of cosine operation.
+ */
+void _IQ24sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 24, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ23 input.
+ *
+ * @param a               IQ23 type input, in radians.
+ * @param sin             IQ23 type result of sine operation.
+ * @param cos             IQ23 type result of cosine operation.
+ */
+void _IQ23sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 23, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ22 input.
+ *
+ * @param a               IQ22 type input, in radians.
+ * @param sin             IQ22 type result of sine operation.
+ * @param cos             IQ22 type result of cosine operation.
+ */
+void _IQ22sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 22, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ21 input.
+ *
+ * @param a               IQ21 type input, in radians.
+ * @param sin             IQ21 type result of sine operation.
+ * @param cos             IQ21 type result of cosine operation.
+ */
+void _IQ21sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 21, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ20 input.
+ *
+ * @param a               IQ20 type input, in radians.
+ * @param sin             IQ20 type result of sine operation.
+ * @param cos             IQ20 type result of cosine operation.
+ */
+void _IQ20sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 20, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ19 input.
+ *
+ * @param a               IQ19 type input, in radians.
+ * @param sin             IQ19 type result of sine operation.
+ * @param cos             IQ19 type result of cosine operation.
+ */
+void _IQ19sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 19, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ18 input.
+ *
+ * @param a               IQ18 type input, in radians.
+ * @param sin             IQ18 type result of sine operation.
+ * @param cos             IQ18 type result of cosine operation.
+ */
+void _IQ18sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 18, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ17 input.
+ *
+ * @param a               IQ17 type input, in radians.
+ * @param sin             IQ17 type result of sine operation.
+ * @param cos             IQ17 type result of cosine operation.
+ */
+void _IQ17sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 17, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ16 input.
+ *
+ * @param a               IQ16 type input, in radians.
+ * @param sin             IQ16 type result of sine operation.
+ * @param cos             IQ16 type result of cosine operation.
+ */
+void _IQ16sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 16, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ15 input.
+ *
+ * @param a               IQ15 type input, in radians.
+ * @param sin             IQ15 type result of sine operation.
+ * @param cos             IQ15 type result of cosine operation.
+ */
+void _IQ15sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 15, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ14 input.
+ *
+ * @param a               IQ14 type input, in radians.
+ * @param sin             IQ14 type result of sine operation.
+ * @param cos             IQ14 type result of cosine operation.
+ */
+void _IQ14sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 14, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ13 input.
+ *
+ * @param a               IQ13 type input, in radians.
+ * @param sin             IQ13 type result of sine operation.
+ * @param cos             IQ13 type result of cosine operation.
+ */
+void _IQ13sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 13, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ12 input.
+ *
+ * @param a               IQ12 type input, in radians.
+ * @param sin             IQ12 type result of sine operation.
+ * @param cos             IQ12 type result of cosine operation.
+ */
+void _IQ12sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 12, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ11 input.
+ *
+ * @param a               IQ11 type input, in radians.
+ * @param sin             IQ11 type result of sine operation.
+ * @param cos             IQ11 type result of cosine operation.
+ */
+void _IQ11sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 11, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ10 input.
+ *
+ * @param a               IQ10 type input, in radians.
+ * @param sin             IQ10 type result of sine operation.
+ * @param cos             IQ10 type result of cosine operation.
+ */
+void _IQ10sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 10, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ9 input.
+ *
+ * @param a               IQ9 type input, in radians.
+ * @param sin             IQ9 type result of sine operation.
+ * @param cos             IQ9 type result of cosine operation.
+ */
+void _IQ9sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 9, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ8 input.
+ *
+ * @param a               IQ8 type input, in radians.
+ * @param sin             IQ8 type result of sine operation.
+ * @param cos             IQ8 type result of cosine operation.
+ */
+void _IQ8sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 8, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ7 input.
+ *
+ * @param a               IQ7 type input, in radians.
+ * @param sin             IQ7 type result of sine operation.
+ * @param cos             IQ7 type result of cosine operation.
+ */
+void _IQ7sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 7, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ6 input.
+ *
+ * @param a               IQ6 type input, in radians.
+ * @param sin             IQ6 type result of sine operation.
+ * @param cos             IQ6 type result of cosine operation.
+ */
+void _IQ6sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 6, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ5 input.
+ *
+ * @param a               IQ5 type input, in radians.
+ * @param sin             IQ5 type result of sine operation.
+ * @param cos             IQ5 type result of cosine operation.
+ */
+void _IQ5sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 5, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ4 input.
+ *
+ * @param a               IQ4 type input, in radians.
+ * @param sin             IQ4 type result of sine operation.
+ * @param cos             IQ4 type result of cosine operation.
+ */
+void _IQ4sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 4, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ3 input.
+ *
+ * @param a               IQ3 type input, in radians.
+ * @param sin             IQ3 type result of sine operation.
+ * @param cos             IQ3 type result of cosine operation.
+ */
+void _IQ3sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 3, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ2 input.
+ *
+ * @param a               IQ2 type input, in radians.
+ * @param sin             IQ2 type result of sine operation.
+ * @param cos             IQ2 type result of cosine operation.
+ */
+void _IQ2sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 2, TYPE_RAD, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ1 input.
+ *
+ * @param a               IQ1 type input, in radians.
+ * @param sin             IQ1 type result of sine operation.
+ * @param cos             IQ1 type result of cosine operation.
+ */
+void _IQ1sincos(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 1, TYPE_RAD, sin, cos);
+}
+
+/* IQ sincosPU functions */
+/**
+ * @brief Computes the sine and the cosine of an IQ30 input.
+ *
+ * @param a               IQ30 type input, in cycles per unit.
+ * @param sin             IQ30 type result of sine operation.
+ * @param cos             IQ30 type result of cosine operation.
+ */
+void _IQ30sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 30, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ29 input.
+ *
+ * @param a               IQ29 type input, in cycles per unit.
+ * @param sin             IQ29 type result of sine operation.
+ * @param cos             IQ29 type result of cosine operation.
+ */
+void _IQ29sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 29, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ28 input.
+ *
+ * @param a               IQ28 type input, in cycles per unit.
+ * @param sin             IQ28 type result of sine operation.
+ * @param cos             IQ28 type result of cosine operation.
+ */
+void _IQ28sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 28, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ27 input.
+ *
+ * @param a               IQ27 type input, in cycles per unit.
+ * @param sin             IQ27 type result of sine operation.
+ * @param cos             IQ27 type result of cosine operation.
+ */
+void _IQ27sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 27, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ26 input.
+ *
+ * @param a               IQ26 type input, in cycles per unit.
+ * @param sin             IQ26 type result of sine operation.
+ * @param cos             IQ26 type result of cosine operation.
+ */
+void _IQ26sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 26, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ25 input.
+ *
+ * @param a               IQ25 type input, in cycles per unit.
+ * @param sin             IQ25 type result of sine operation.
+ * @param cos             IQ25 type result of cosine operation.
+ */
+void _IQ25sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 25, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ24 input.
+ *
+ * @param a               IQ24 type input, in cycles per unit.
+ * @param sin             IQ24 type result of sine operation.
+ * @param cos             IQ24 type result of cosine operation.
+ */
+void _IQ24sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 24, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ23 input.
+ *
+ * @param a               IQ23 type input, in cycles per unit.
+ * @param sin             IQ23 type result of sine operation.
+ * @param cos             IQ23 type result of cosine operation.
+ */
+void _IQ23sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 23, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ22 input.
+ *
+ * @param a               IQ22 type input, in cycles per unit.
+ * @param sin             IQ22 type result of sine operation.
+ * @param cos             IQ22 type result of cosine operation.
+ */
+void _IQ22sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 22, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ21 input.
+ *
+ * @param a               IQ21 type input, in cycles per unit.
+ * @param sin             IQ21 type result of sine operation.
+ * @param cos             IQ21 type result of cosine operation.
+ */
+void _IQ21sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 21, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ20 input.
+ *
+ * @param a               IQ20 type input, in cycles per unit.
+ * @param sin             IQ20 type result of sine operation.
+ * @param cos             IQ20 type result of cosine operation.
+ */
+void _IQ20sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 20, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ19 input.
+ *
+ * @param a               IQ19 type input, in cycles per unit.
+ * @param sin             IQ19 type result of sine operation.
+ * @param cos             IQ19 type result of cosine operation.
+ */
+void _IQ19sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 19, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ18 input.
+ *
+ * @param a               IQ18 type input, in cycles per unit.
+ * @param sin             IQ18 type result of sine operation.
+ * @param cos             IQ18 type result of cosine operation.
+ */
+void _IQ18sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 18, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ17 input.
+ *
+ * @param a               IQ17 type input, in cycles per unit.
+ * @param sin             IQ17 type result of sine operation.
+ * @param cos             IQ17 type result of cosine operation.
+ */
+void _IQ17sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 17, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ16 input.
+ *
+ * @param a               IQ16 type input, in cycles per unit.
+ * @param sin             IQ16 type result of sine operation.
+ * @param cos             IQ16 type result of cosine operation.
+ */
+void _IQ16sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 16, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ15 input.
+ *
+ * @param a               IQ15 type input, in cycles per unit.
+ * @param sin             IQ15 type result of sine operation.
+ * @param cos             IQ15 type result of cosine operation.
+ */
+void _IQ15sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 15, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ14 input.
+ *
+ * @param a               IQ14 type input, in cycles per unit.
+ * @param sin             IQ14 type result of sine operation.
+ * @param cos             IQ14 type result of cosine operation.
+ */
+void _IQ14sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 14, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ13 input.
+ *
+ * @param a               IQ13 type input, in cycles per unit.
+ * @param sin             IQ13 type result of sine operation.
+ * @param cos             IQ13 type result of cosine operation.
+ */
+void _IQ13sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 13, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ12 input.
+ *
+ * @param a               IQ12 type input, in cycles per unit.
+ * @param sin             IQ12 type result of sine operation.
+ * @param cos             IQ12 type result of cosine operation.
+ */
+void _IQ12sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 12, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ11 input.
+ *
+ * @param a               IQ11 type input, in cycles per unit.
+ * @param sin             IQ11 type result of sine operation.
+ * @param cos             IQ11 type result of cosine operation.
+ */
+void _IQ11sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 11, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ10 input.
+ *
+ * @param a               IQ10 type input, in cycles per unit.
+ * @param sin             IQ10 type result of sine operation.
+ * @param cos             IQ10 type result of cosine operation.
+ */
+void _IQ10sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 10, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ9 input.
+ *
+ * @param a               IQ9 type input, in cycles per unit.
+ * @param sin             IQ9 type result of sine operation.
+ * @param cos             IQ9 type result of cosine operation.
+ */
+void _IQ9sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 9, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ8 input.
+ *
+ * @param a               IQ8 type input, in cycles per unit.
+ * @param sin             IQ8 type result of sine operation.
+ * @param cos             IQ8 type result of cosine operation.
+ */
+void _IQ8sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 8, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ7 input.
+ *
+ * @param a               IQ7 type input, in cycles per unit.
+ * @param sin             IQ7 type result of sine operation.
+ * @param cos             IQ7 type result of cosine operation.
+ */
+void _IQ7sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 7, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ6 input.
+ *
+ * @param a               IQ6 type input, in cycles per unit.
+ * @param sin             IQ6 type result of sine operation.
+ * @param cos             IQ6 type result of cosine operation.
+ */
+void _IQ6sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 6, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ5 input.
+ *
+ * @param a               IQ5 type input, in cycles per unit.
+ * @param sin             IQ5 type result of sine operation.
+ * @param cos             IQ5 type result of cosine operation.
+ */
+void _IQ5sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 5, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ4 input.
+ *
+ * @param a               IQ4 type input, in cycles per unit.
+ * @param sin             IQ4 type result of sine operation.
+ * @param cos             IQ4 type result of cosine operation.
+ */
+void _IQ4sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 4, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ3 input.
+ *
+ * @param a               IQ3 type input, in cycles per unit.
+ * @param sin             IQ3 type result of sine operation.
+ * @param cos             IQ3 type result of cosine operation.
+ */
+void _IQ3sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 3, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ2 input.
+ *
+ * @param a               IQ2 type input, in cycles per unit.
+ * @param sin             IQ2 type result of sine operation.
+ * @param cos             IQ2 type result of cosine operation.
+ */
+void _IQ2sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 2, TYPE_PU, sin, cos);
+}
+/**
+ * @brief Computes the sine and the cosine of an IQ1 input.
+ *
+ * @param a               IQ1 type input, in cycles per unit.
+ * @param sin             IQ1 type result of sine operation.
+ * @param cos             IQ1 type result of cosine operation.
+ */
+void _IQ1sincosPU(int32_t a, int32_t *sin, int32_t *cos)
+{
+    __IQNsincos(a, 1, TYPE_PU, sin, cos);
+}
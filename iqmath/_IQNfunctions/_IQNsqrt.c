@@ -6,6 +6,7 @@
  *  <hr>
  ******************************************************************************/
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "../support/support.h"
@@ -69,6 +70,7 @@ __STATIC_INLINE int_fast32_t __IQNsqrt(int_fast32_t iqNInputX, int_fast32_t iqNI
 {
     uint8_t ui8Index;
     uint8_t ui8Loops;
+    uint8_t ui8Shift;
     int_fast16_t i16Exponent;
     uint_fast16_t ui16IntState;
     uint_fast16_t ui16MPYState;
@@ -106,17 +108,19 @@ __STATIC_INLINE int_fast32_t __IQNsqrt(int_fast32_t iqNInputX, int_fast32_t iqNI
             i16Exponent = -(32 - q_value);
         }
 
-        /* Shift to iq64 by keeping track of exponent. */
-        while ((uint_fast16_t)(ui64Sum >> 48) < 0x4000) {
-            ui64Sum <<= 2;
-            /* Decrement exponent for mag */
-            if (type == TYPE_MAG) {
-                i16Exponent--;
-            }
-            /* Increment exponent for imag */
-            else {
-                i16Exponent++;
-            }
+        /*
+         * Shift to iq64 by keeping track of exponent, by an even number of
+         * bits so that the exponent of the square root is an integer.
+         */
+        ui8Shift = __clzx_u(ui64Sum) >> 1;
+        ui64Sum <<= 2 * ui8Shift;
+        /* Decrement exponent for mag */
+        if (type == TYPE_MAG) {
+            i16Exponent -= ui8Shift;
+        }
+        /* Increment exponent for imag */
+        else {
+            i16Exponent += ui8Shift;
         }
 
         /* Shift ui64Sum to unsigned iq32 and set as uiq32Input */
@@ -127,9 +131,12 @@ __STATIC_INLINE int_fast32_t __IQNsqrt(int_fast32_t iqNInputX, int_fast32_t iqNI
             return 0;
         }
 
+        /* Save input as unsigned iq32. */
+        uiq32Input = (uint_fast32_t)iqNInputX;
+
         /* If the q_value gives an odd starting exponent make it even. */
         if ((32 - q_value) % 2 == 1) {
-            iqNInputX <<= 1;
+            uiq32Input <<= 1;
             /* Start with positive exponent for sqrt */
             if (type == TYPE_SQRT) {
                 i16Exponent = ((32 - q_value) - 1) >> 1;
@@ -149,20 +156,16 @@ __STATIC_INLINE int_fast32_t __IQNsqrt(int_fast32_t iqNInputX, int_fast32_t iqNI
             }
         }
 
-        /* Save input as unsigned iq32. */
-        uiq32Input = (uint_fast32_t)iqNInputX;
-
-        /* Shift to iq32 by keeping track of exponent */
-        while ((uint_fast16_t)(uiq32Input >> 16) < 0x4000) {
-            uiq32Input <<= 2;
-            /* Decrement exponent for sqrt and mag */
-            if (type) {
-                i16Exponent--;
-            }
-            /* Increment exponent for isqrt */
-            else {
-                i16Exponent++;
-            }
+        /* Shift to iq32 by an even number of bits, keeping track of exponent */
+        ui8Shift = __clz_ul(uiq32Input) >> 1;
+        uiq32Input <<= 2 * ui8Shift;
+        /* Decrement exponent for sqrt and mag */
+        if (type) {
+            i16Exponent -= ui8Shift;
+        }
+        /* Increment exponent for isqrt */
+        else {
+            i16Exponent += ui8Shift;
         }
     }
 
@@ -261,22 +264,18 @@ __STATIC_INLINE int_fast32_t __IQNsqrt(int_fast32_t iqNInputX, int_fast32_t iqNI
     if (i16Exponent <= -32) {
         return 0;
     }
-    if (i16Exponent <= -16) {
-        uiq31Result >>= 16;
-        i16Exponent += 16;
-    }
-    if (i16Exponent <= -8) {
-        uiq31Result >>= 8;
-        i16Exponent += 8;
-    }
-    while (i16Exponent < -1) {
-        uiq31Result >>= 1;
-        i16Exponent++;
+    /*
+     * Shifts by a multiple of 8 bits truncate, any other shift rounds using
+     * the last bit shifted out.
+     */
+    if (i16Exponent <= 0 && (i16Exponent & 7) == 0) {
+        return uiq31Result >> -i16Exponent;
     }
-    if (i16Exponent) {
-        uiq31Result++;
-        uiq31Result >>= 1;
+    if (i16Exponent < -1) {
+        uiq31Result >>= -1 - i16Exponent;
     }
+    uiq31Result++;
+    uiq31Result >>= 1;
 
     return uiq31Result;
 }
@@ -1746,3 +1745,373 @@ int32_t _IQ1imag(int32_t a, int32_t b)
 {
     return __IQNsqrt(a, b, 1, TYPE_IMAG);
 }
+
+/* SQRT AND MAGNITUDE ARRAYS */
+
+/**
+ * @brief Calculate the square root of an array of IQN inputs.
+ *
+ * @param iqNInput        IQN type input array.
+ * @param iqNResult       IQN type array receiving the results, may be the input.
+ * @param n               Number of elements.
+ * @param q_value         IQ format.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNsqrt_v)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE void __IQNsqrt_v(const int32_t *iqNInput, int32_t *iqNResult, size_t n, const int8_t q_value)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        iqNResult[i] = __IQNsqrt(iqNInput[i], 0, q_value, TYPE_SQRT);
+    }
+}
+/**
+ * @brief Calculate square root of an array of IQ30 inputs.
+ *
+ * @param a                 IQ30 type input array.
+ * @param y                 IQ30 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ30sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 30);
+}
+/**
+ * @brief Calculate square root of an array of IQ29 inputs.
+ *
+ * @param a                 IQ29 type input array.
+ * @param y                 IQ29 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ29sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 29);
+}
+/**
+ * @brief Calculate square root of an array of IQ28 inputs.
+ *
+ * @param a                 IQ28 type input array.
+ * @param y                 IQ28 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ28sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 28);
+}
+/**
+ * @brief Calculate square root of an array of IQ27 inputs.
+ *
+ * @param a                 IQ27 type input array.
+ * @param y                 IQ27 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ27sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 27);
+}
+/**
+ * @brief Calculate square root of an array of IQ26 inputs.
+ *
+ * @param a                 IQ26 type input array.
+ * @param y                 IQ26 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ26sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 26);
+}
+/**
+ * @brief Calculate square root of an array of IQ25 inputs.
+ *
+ * @param a                 IQ25 type input array.
+ * @param y                 IQ25 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ25sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 25);
+}
+/**
+ * @brief Calculate square root of an array of IQ24 inputs.
+ *
+ * @param a                 IQ24 type input array.
+ * @param y                 IQ24 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ24sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 24);
+}
+/**
+ * @brief Calculate square root of an array of IQ23 inputs.
+ *
+ * @param a                 IQ23 type input array.
+ * @param y                 IQ23 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ23sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 23);
+}
+/**
+ * @brief Calculate square root of an array of IQ22 inputs.
+ *
+ * @param a                 IQ22 type input array.
+ * @param y                 IQ22 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ22sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 22);
+}
+/**
+ * @brief Calculate square root of an array of IQ21 inputs.
+ *
+ * @param a                 IQ21 type input array.
+ * @param y                 IQ21 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ21sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 21);
+}
+/**
+ * @brief Calculate square root of an array of IQ20 inputs.
+ *
+ * @param a                 IQ20 type input array.
+ * @param y                 IQ20 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ20sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 20);
+}
+/**
+ * @brief Calculate square root of an array of IQ19 inputs.
+ *
+ * @param a                 IQ19 type input array.
+ * @param y                 IQ19 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ19sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 19);
+}
+/**
+ * @brief Calculate square root of an array of IQ18 inputs.
+ *
+ * @param a                 IQ18 type input array.
+ * @param y                 IQ18 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ18sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 18);
+}
+/**
+ * @brief Calculate square root of an array of IQ17 inputs.
+ *
+ * @param a                 IQ17 type input array.
+ * @param y                 IQ17 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ17sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 17);
+}
+/**
+ * @brief Calculate square root of an array of IQ16 inputs.
+ *
+ * @param a                 IQ16 type input array.
+ * @param y                 IQ16 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ16sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 16);
+}
+/**
+ * @brief Calculate square root of an array of IQ15 inputs.
+ *
+ * @param a                 IQ15 type input array.
+ * @param y                 IQ15 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ15sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 15);
+}
+/**
+ * @brief Calculate square root of an array of IQ14 inputs.
+ *
+ * @param a                 IQ14 type input array.
+ * @param y                 IQ14 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ14sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 14);
+}
+/**
+ * @brief Calculate square root of an array of IQ13 inputs.
+ *
+ * @param a                 IQ13 type input array.
+ * @param y                 IQ13 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ13sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 13);
+}
+/**
+ * @brief Calculate square root of an array of IQ12 inputs.
+ *
+ * @param a                 IQ12 type input array.
+ * @param y                 IQ12 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ12sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 12);
+}
+/**
+ * @brief Calculate square root of an array of IQ11 inputs.
+ *
+ * @param a                 IQ11 type input array.
+ * @param y                 IQ11 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ11sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 11);
+}
+/**
+ * @brief Calculate square root of an array of IQ10 inputs.
+ *
+ * @param a                 IQ10 type input array.
+ * @param y                 IQ10 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ10sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 10);
+}
+/**
+ * @brief Calculate square root of an array of IQ9 inputs.
+ *
+ * @param a                 IQ9 type input array.
+ * @param y                 IQ9 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ9sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 9);
+}
+/**
+ * @brief Calculate square root of an array of IQ8 inputs.
+ *
+ * @param a                 IQ8 type input array.
+ * @param y                 IQ8 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ8sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 8);
+}
+/**
+ * @brief Calculate square root of an array of IQ7 inputs.
+ *
+ * @param a                 IQ7 type input array.
+ * @param y                 IQ7 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ7sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 7);
+}
+/**
+ * @brief Calculate square root of an array of IQ6 inputs.
+ *
+ * @param a                 IQ6 type input array.
+ * @param y                 IQ6 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ6sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 6);
+}
+/**
+ * @brief Calculate square root of an array of IQ5 inputs.
+ *
+ * @param a                 IQ5 type input array.
+ * @param y                 IQ5 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ5sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 5);
+}
+/**
+ * @brief Calculate square root of an array of IQ4 inputs.
+ *
+ * @param a                 IQ4 type input array.
+ * @param y                 IQ4 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ4sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 4);
+}
+/**
+ * @brief Calculate square root of an array of IQ3 inputs.
+ *
+ * @param a                 IQ3 type input array.
+ * @param y                 IQ3 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ3sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 3);
+}
+/**
+ * @brief Calculate square root of an array of IQ2 inputs.
+ *
+ * @param a                 IQ2 type input array.
+ * @param y                 IQ2 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ2sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 2);
+}
+/**
+ * @brief Calculate square root of an array of IQ1 inputs.
+ *
+ * @param a                 IQ1 type input array.
+ * @param y                 IQ1 type array receiving the results, may be a.
+ * @param n                 Number of elements.
+ */
+void _IQ1sqrt_v(const int32_t *a, int32_t *y, size_t n)
+{
+    __IQNsqrt_v(a, y, n, 1);
+}
+/**
+ * @brief Calculate the magnitude of arrays of two inputs element by element.
+ *
+ * @param a                 IQN type input array.
+ * @param b                 IQN type input array.
+ * @param y                 IQN type array receiving the results, may be a or b.
+ * @param n                 Number of elements.
+ */
+void _IQmag_v(const int32_t *a, const int32_t *b, int32_t *y, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        y[i] = __IQNsqrt(a[i], b[i], 31, TYPE_MAG);
+    }
+}
@@ -0,0 +1,593 @@
+/*!****************************************************************************
+ *  @file       _IQNtoa_fixed.c
+ *  @brief      Functions to convert an IQ number to a string with a fixed
+ *              number of decimals.
+ *
+ *  <hr>
+ ******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../support/support.h"
+
+/* Two ASCII digits for each value from 0 to 99. */
+static const char _IQNtoa_digit_pairs[200] = {
+    '0', '0', '0', '1', '0', '2', '0', '3', '0', '4', '0', '5', '0', '6', '0', '7', '0', '8', '0', '9',
+    '1', '0', '1', '1', '1', '2', '1', '3', '1', '4', '1', '5', '1', '6', '1', '7', '1', '8', '1', '9',
+    '2', '0', '2', '1', '2', '2', '2', '3', '2', '4', '2', '5', '2', '6', '2', '7', '2', '8', '2', '9',
+    '3', '0', '3', '1', '3', '2', '3', '3', '3', '4', '3', '5', '3', '6', '3', '7', '3', '8', '3', '9',
+    '4', '0', '4', '1', '4', '2', '4', '3', '4', '4', '4', '5', '4', '6', '4', '7', '4', '8', '4', '9',
+    '5', '0', '5', '1', '5', '2', '5', '3', '5', '4', '5', '5', '5', '6', '5', '7', '5', '8', '5', '9',
+    '6', '0', '6', '1', '6', '2', '6', '3', '6', '4', '6', '5', '6', '6', '6', '7', '6', '8', '6', '9',
+    '7', '0', '7', '1', '7', '2', '7', '3', '7', '4', '7', '5', '7', '6', '7', '7', '7', '8', '7', '9',
+    '8', '0', '8', '1', '8', '2', '8', '3', '8', '4', '8', '5', '8', '6', '8', '7', '8', '8', '8', '9',
+    '9', '0', '9', '1', '9', '2', '9', '3', '9', '4', '9', '5', '9', '6', '9', '7', '9', '8', '9', '9',
+};
+
+static const uint32_t _IQNtoa_pow10[10] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/*
+ * Writes the digits of value backwards, ending just before end, two at a time.
+ * width is the minimum number of digits, the value is padded with zeros.
+ * Dividing by 100 is a multiplication by 2^37 / 100, exact for any 32-bit
+ * value. Returns a pointer to the first digit.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNutoa)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE char *__IQNutoa(uint_fast32_t value, char *end, int_fast16_t width)
+{
+    uint_fast32_t ui32Hundredth;
+
+    while (value >= 100 || width > 2) {
+        ui32Hundredth = (uint_fast32_t)(((uint_fast64_t)value * 0x51eb851f) >> 37);
+        end -= 2;
+        memcpy(end, &_IQNtoa_digit_pairs[(value - ui32Hundredth * 100) * 2], 2);
+        value = ui32Hundredth;
+        width -= 2;
+    }
+    if (value >= 10 || width == 2) {
+        end -= 2;
+        memcpy(end, &_IQNtoa_digit_pairs[value * 2], 2);
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+/**
+ * @brief Convert an IQ number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQN type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ * @param q_value         IQ format.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__IQNtoa_fixed)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+__STATIC_INLINE int_fast16_t __IQNtoa_fixed(char *string, int_fast32_t iqNInput, int_fast16_t decimals,
+                                            int_fast16_t q_value)
+{
+    char acBuf[24];                 // digits written backwards
+    char *pcBuf = acBuf + sizeof(acBuf);
+    uint_fast32_t uiqNInput;        // unsigned input
+    uint_fast32_t ui32Integer;      // integer part
+    uint_fast32_t ui32Fractional;   // fractional part scaled by 10^decimals
+    int_fast16_t length;
+
+    if (decimals < 0 || decimals > 9) {
+        return -1;
+    }
+
+    /* Unsigned negation, so that the most negative value is handled too. */
+    uiqNInput = (uint32_t)iqNInput;
+    if (iqNInput < 0) {
+        uiqNInput = (uint32_t)(0 - (uint32_t)iqNInput);
+    }
+
+    /*
+     * Round the fractional part to the requested decimals:
+     * (fraction * 10^decimals + 0.5) / 2^q, which fits in 64 bits.
+     */
+    ui32Integer = uiqNInput >> q_value;
+    ui32Fractional = (uint_fast32_t)(((uint_fast64_t)(uiqNInput & (((uint_fast32_t)1 << q_value) - 1)) *
+                                      _IQNtoa_pow10[decimals] + ((uint_fast64_t)1 << (q_value - 1))) >> q_value);
+    if (ui32Fractional == _IQNtoa_pow10[decimals]) {
+        ui32Fractional = 0;
+        ui32Integer++;
+    }
+
+    if (decimals > 0) {
+        pcBuf = __IQNutoa(ui32Fractional, pcBuf, decimals);
+        *--pcBuf = '.';
+    }
+    pcBuf = __IQNutoa(ui32Integer, pcBuf, 1);
+
+    /* No sign if the value rounds to zero. */
+    if (iqNInput < 0 && (ui32Integer | ui32Fractional)) {
+        *--pcBuf = '-';
+    }
+
+    length = (int_fast16_t)(acBuf + sizeof(acBuf) - pcBuf);
+    memcpy(string, pcBuf, length);
+    string[length] = 0;
+    return length;
+}
+
+/**
+ * @brief Convert an IQ31 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ31 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ31toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 31);
+}
+/**
+ * @brief Convert an IQ30 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ30 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ30toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 30);
+}
+/**
+ * @brief Convert an IQ29 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ29 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ29toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 29);
+}
+/**
+ * @brief Convert an IQ28 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ28 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ28toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 28);
+}
+/**
+ * @brief Convert an IQ27 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ27 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ27toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 27);
+}
+/**
+ * @brief Convert an IQ26 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ26 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ26toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 26);
+}
+/**
+ * @brief Convert an IQ25 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ25 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ25toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 25);
+}
+/**
+ * @brief Convert an IQ24 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ24 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ24toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 24);
+}
+/**
+ * @brief Convert an IQ23 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ23 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ23toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 23);
+}
+/**
+ * @brief Convert an IQ22 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ22 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ22toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 22);
+}
+/**
+ * @brief Convert an IQ21 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ21 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ21toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 21);
+}
+/**
+ * @brief Convert an IQ20 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ20 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ20toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 20);
+}
+/**
+ * @brief Convert an IQ19 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ19 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ19toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 19);
+}
+/**
+ * @brief Convert an IQ18 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ18 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ18toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 18);
+}
+/**
+ * @brief Convert an IQ17 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ17 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ17toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 17);
+}
+/**
+ * @brief Convert an IQ16 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ16 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ16toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 16);
+}
+/**
+ * @brief Convert an IQ15 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ15 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ15toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 15);
+}
+/**
+ * @brief Convert an IQ14 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ14 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ14toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 14);
+}
+/**
+ * @brief Convert an IQ13 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ13 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ13toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 13);
+}
+/**
+ * @brief Convert an IQ12 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ12 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ12toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 12);
+}
+/**
+ * @brief Convert an IQ11 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ11 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ11toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 11);
+}
+/**
+ * @brief Convert an IQ10 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ10 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ10toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 10);
+}
+/**
+ * @brief Convert an IQ9 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ9 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ9toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 9);
+}
+/**
+ * @brief Convert an IQ8 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ8 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ8toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 8);
+}
+/**
+ * @brief Convert an IQ7 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ7 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ7toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 7);
+}
+/**
+ * @brief Convert an IQ6 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ6 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ6toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 6);
+}
+/**
+ * @brief Convert an IQ5 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ5 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ5toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 5);
+}
+/**
+ * @brief Convert an IQ4 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ4 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ4toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 4);
+}
+/**
+ * @brief Convert an IQ3 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ3 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ3toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 3);
+}
+/**
+ * @brief Convert an IQ2 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ2 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ2toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 2);
+}
+/**
+ * @brief Convert an IQ1 number to a string with a fixed number of decimals.
+ *
+ * @param string          Pointer to the buffer to store the converted IQ number,
+ *                        of at least 13 + decimals characters.
+ * @param iqNInput        IQ1 type input.
+ * @param decimals        Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null
+ *                        terminator, or -1 if decimals is out of range.
+ */
+int16_t _IQ1toa_fixed(char *string, int32_t iqNInput, int16_t decimals)
+{
+    return __IQNtoa_fixed(string, iqNInput, decimals, 1);
+}
@@ -9,6 +9,19 @@
 
 #include "../support/support.h"
 
+/*
+ * 2^64 / 10^n for n = 0 to 9, split in 32-bit halves. 2^64 itself does not fit,
+ * n = 0 only occurs without any fractional digit, whose value is 0 anyway.
+ */
+static const uint32_t _atoIQN_recip_hi[10] = {
+    0x00000000, 0x19999999, 0x028f5c28, 0x00418937, 0x00068db8,
+    0x0000a7c5, 0x000010c6, 0x000001ad, 0x0000002a, 0x00000004,
+};
+static const uint32_t _atoIQN_recip_lo[10] = {
+    0x00000000, 0x99999999, 0xf5c28f5c, 0x4bc6a7ef, 0xbac710cb,
+    0xac471b47, 0xf7a0b5ed, 0x7f29abca, 0xf31dc461, 0x4b82fa09,
+};
+
 /**
  * @brief Converts string to an IQN number.
  *
@@ -29,7 +42,10 @@ __STATIC_INLINE int_fast32_t __atoIQN(const char *string, int_fast32_t q_value)
     uint_fast16_t ui16MPYState;
     uint_fast32_t iqNResult;
     uint_fast32_t uiq0Integer = 0;
-    uint_fast32_t uiq31Fractional = 0;
+    uint_fast32_t uiq32Fractional;
+    uint_fast32_t uiqNFractional;
+    uint_fast32_t ui32Digits;
+    uint_fast16_t ui16Count;
     uint_fast32_t max_int = 0x7fffffff >> q_value;
 
     /* Check for sign */
@@ -82,52 +98,51 @@ __STATIC_INLINE int_fast32_t __atoIQN(const char *string, int_fast32_t q_value)
     if (*string == 0) {
         /* Shift integer portion up */
         iqNResult = uiq0Integer << q_value;
+        if (sgn) {
+            iqNResult = -iqNResult;
+        }
 
         /* Return the result. */
         return iqNResult;
     }
 
-    /* Increment to the null terminating character and back up one character. */
-    while (*++string);
-    string--;
-
-    /* Setup the device multiplier. */
-    __mpy_start(&ui16IntState, &ui16MPYState);
-
-    /* Process fractional portion of string starting at the last character. */
-    while (*string != '.') {
+    /*
+     * Accumulate the first 9 fractional digits, the following ones are below
+     * the resolution of IQ31 and are only checked.
+     */
+    string++;
+    ui32Digits = 0;
+    ui16Count = 0;
+    while (*string != 0) {
         /* Check for invalid character */
         if (*string < '0' || *string > '9') {
             return 0;
         }
-
-        /* Multiply fractional piece by 0.1 to setup the next decimal place. */
-        __mpy_set_frac();
-        uiq31Fractional = __mpyf_ul(uiq31Fractional, iq31_pointOne);
-        __mpy_clear_ctl0();
-
-        /*
-         * Add the current decimal place converted to iq31 to the sum and
-         * decrement pointer.
-         */
-        uiq31Fractional += __mpy_ul((*string - '0'), iq31_pointOne);
-        string--;
+        if (ui16Count < 9) {
+            ui32Digits = ui32Digits * 10 + (*string - '0');
+            ui16Count++;
+        }
+        string++;
     }
 
-    /* Restore multiplier context. */
-    __mpy_stop(&ui16IntState, &ui16MPYState);
+    /*
+     * Convert the digits to an unsigned iq32 with a single multiplication by
+     * 2^64 / 10^count, done as two 32x32 multiplications.
+     */
+    uiq32Fractional = ui32Digits * _atoIQN_recip_hi[ui16Count] +
+                      (uint_fast32_t)(((uint_fast64_t)ui32Digits * _atoIQN_recip_lo[ui16Count]) >> 32);
 
     /* Shift integer portion up */
     uiq0Integer <<= q_value;
 
     /* Shift fractional portion to match Q type with rounding. */
-    if (q_value != 31) {
-        uiq31Fractional += ((uint_fast32_t)1 << (30 - q_value));
-    }
-    uiq31Fractional >>= (31 - q_value);
+    uiqNFractional = (uiq32Fractional >> (32 - q_value)) + ((uiq32Fractional >> (31 - q_value)) & 1);
 
-    /* Construct the iqN result. */
-    iqNResult = uiq0Integer + uiq31Fractional;
+    /* Construct the iqN result, rounding may carry into the sign bit. */
+    iqNResult = uiq0Integer + uiqNFractional;
+    if (!sgn && iqNResult > 0x7fffffff) {
+        iqNResult = 0x7fffffff;
+    }
     if (sgn) {
         iqNResult = -iqNResult;
     }
@@ -0,0 +1,217 @@
+/*!****************************************************************************
+ *  @file       IQmathEigen.hpp
+ *  @brief      iqmath::iq<Q> as a scalar type of Eigen.
+ *
+ *  Including this header makes Eigen::Matrix<iqmath::iq<Q>, ...> usable
+ *  like a float matrix: arithmetic, products, decompositions (LU, LLT,
+ *  JacobiSVD...), norms and printing. The products and the sums of Eigen
+ *  call the inlined operators of iq<Q>, i.e. _IQNmpy() truncation and a
+ *  wrapping addition like the C API, the other functions (sqrt, abs...)
+ *  are the ones of IQmathLib.hpp.
+ *
+ *  Fixed-point does not saturate: the format must leave enough integer bits
+ *  for the largest coefficient and the largest intermediate sum of the
+ *  computation, e.g. the covariance of a Kalman filter, and enough
+ *  fractional bits for the smallest one.
+ *
+ *  The project must depend on the espressif/eigen component, and the header
+ *  must be included in place of <eigen3/Eigen/Core>, before the Eigen
+ *  modules using the scalar type.
+ *
+ *  <hr>
+ ******************************************************************************/
+#ifndef __IQMATHEIGEN_HPP__
+#define __IQMATHEIGEN_HPP__
+
+#include <limits>
+#include <ostream>
+#include <eigen3/Eigen/Core>
+#include "IQmathLib.hpp"
+
+#ifdef EIGEN_JACOBISVD_H
+#error "IQmathEigen.hpp must be included before <eigen3/Eigen/SVD>"
+#endif
+
+/*
+ * Floating point like limits: min() is the smallest positive value, which
+ * Eigen uses as the threshold under which a value is zero.
+ */
+namespace std {
+
+template <int Q>
+class numeric_limits<iqmath::iq<Q>> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = false;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true;
+    static constexpr int radix = 2;
+    static constexpr int digits = 31;
+    static constexpr int digits10 = 9;
+
+    static constexpr iqmath::iq<Q> min()
+    {
+        return iqmath::iq<Q>::from_raw(1);
+    }
+
+    static constexpr iqmath::iq<Q> max()
+    {
+        return iqmath::iq<Q>::from_raw(INT32_MAX);
+    }
+
+    static constexpr iqmath::iq<Q> lowest()
+    {
+        return iqmath::iq<Q>::from_raw(INT32_MIN);
+    }
+
+    static constexpr iqmath::iq<Q> epsilon()
+    {
+        return iqmath::iq<Q>::from_raw(1);
+    }
+
+    static constexpr iqmath::iq<Q> round_error()
+    {
+        return iqmath::iq<Q>::from_raw(1);
+    }
+};
+
+} // namespace std
+
+namespace Eigen {
+
+template <int Q>
+struct NumTraits<iqmath::iq<Q>> : GenericNumTraits<iqmath::iq<Q>> {
+    typedef iqmath::iq<Q> Real;
+    typedef iqmath::iq<Q> NonInteger;
+    typedef iqmath::iq<Q> Nested;
+    typedef iqmath::iq<Q> Literal;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 0,
+        ReadCost = 1,
+        AddCost = 1,
+        MulCost = 2
+    };
+
+    /*
+     * Precision of the iterative algorithms, e.g. the convergence threshold
+     * of JacobiSVD: 4 LSB, above the truncation errors of a rotation, which
+     * would otherwise never converge below 1 LSB
+     */
+    static inline Real epsilon()
+    {
+        return Real::from_raw(4);
+    }
+
+    /* Precision of the comparisons of isApprox(), 2^-(Q/2), e.g. 2^-12 in IQ24 */
+    static inline Real dummy_precision()
+    {
+        return Real::from_raw(static_cast<int32_t>(1) << ((Q + 1) / 2));
+    }
+
+    /* Decimal digits of the fractional part, to print the values */
+    static inline int digits10()
+    {
+        return (Q * 3 + 9) / 10;
+    }
+};
+
+namespace internal {
+
+/* cast<float>() and cast<iq<Q>>() of float matrices, like _IQNtoF() and _IQN() */
+template <int Q>
+struct cast_impl<iqmath::iq<Q>, float> {
+    static inline float run(const iqmath::iq<Q> &x)
+    {
+        return x.to_float();
+    }
+};
+
+template <int Q>
+struct cast_impl<float, iqmath::iq<Q>> {
+    static inline iqmath::iq<Q> run(const float &x)
+    {
+        return iqmath::iq<Q>(x);
+    }
+};
+
+/*
+ * 2x2 step of JacobiSVD. The generic one computes the rotations from
+ * cotangents, which overflow the format as soon as the off-diagonal terms
+ * are small, here they are computed from their angles with _IQNatan2() and
+ * _IQNsincos(), which are bounded. The inputs of the angles are halved so
+ * that their differences do not overflow. Q must not be larger than 29.
+ */
+template <typename MatrixType, int Q, typename IndexType>
+void real_2x2_jacobi_svd(const MatrixType &matrix, IndexType p, IndexType q, JacobiRotation<iqmath::iq<Q>> *j_left,
+                         JacobiRotation<iqmath::iq<Q>> *j_right)
+{
+    typedef iqmath::iq<Q> iq;
+    const iq zero;
+    const iq a = matrix.coeff(p, p), b = matrix.coeff(p, q), c = matrix.coeff(q, p), d = matrix.coeff(q, q);
+
+    /* Rotation from the left making the matrix symmetric, by the angle of (a + d, c - b) taken in [0, pi] */
+    const iq t = (a >> 1) + (d >> 1), u = (c >> 1) - (b >> 1);
+    iq angle_left, s1 = zero, c1 = iq(1);
+    if (u != zero) {
+        angle_left = atan2(abs(u), u > zero ? t : -t);
+        sincos(angle_left, s1, c1);
+    }
+
+    /* Jacobi rotation diagonalizing the symmetric matrix [x y; y z], by an angle in [-pi/4, pi/4] */
+    const iq x = c1 * a + s1 * c, y = c1 * b + s1 * d, z = c1 * d - s1 * b;
+    iq angle_right, s2 = zero, c2 = iq(1);
+    if (y != zero) {
+        angle_right = atan2(x >= z ? -y : y, abs((x >> 1) - (z >> 1))) >> 1;
+        sincos(angle_right, s2, c2);
+    }
+    *j_right = JacobiRotation<iq>(c2, s2);
+
+    /* The left rotation is the first one followed by the transposed right one */
+    iq s3, c3;
+    sincos(angle_left - angle_right, s3, c3);
+    *j_left = JacobiRotation<iq>(c3, s3);
+}
+
+} // namespace internal
+} // namespace Eigen
+
+namespace iqmath {
+
+/* Classification functions found by the numext functions of Eigen, IQ values are always finite */
+template <int Q>
+constexpr bool isfinite(iq<Q>)
+{
+    return true;
+}
+
+template <int Q>
+constexpr bool isinf(iq<Q>)
+{
+    return false;
+}
+
+template <int Q>
+constexpr bool isnan(iq<Q>)
+{
+    return false;
+}
+
+/** @brief Prints the floating point value, for the output of Eigen matrices. */
+template <int Q>
+inline std::ostream &operator<<(std::ostream &os, iq<Q> a)
+{
+    return os << a.to_float();
+}
+
+} // namespace iqmath
+
+#endif /* __IQMATHEIGEN_HPP__ */
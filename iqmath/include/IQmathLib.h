@@ -6262,6 +6262,150 @@ extern int16_t _IQ1toa(char *string, const char *format, _iq1 input);
 #define _IQtoa(A, B, C)     _IQ1toa(A, B, C)
 #endif
 
+//*****************************************************************************
+//
+// Converts an IQ number into a string with a fixed number of decimals.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern int16_t _IQ31toa_fixed(char *string, int32_t input, int16_t decimals);
+extern int16_t _IQ30toa_fixed(char *string, _iq30 input, int16_t decimals);
+extern int16_t _IQ29toa_fixed(char *string, _iq29 input, int16_t decimals);
+extern int16_t _IQ28toa_fixed(char *string, _iq28 input, int16_t decimals);
+extern int16_t _IQ27toa_fixed(char *string, _iq27 input, int16_t decimals);
+extern int16_t _IQ26toa_fixed(char *string, _iq26 input, int16_t decimals);
+extern int16_t _IQ25toa_fixed(char *string, _iq25 input, int16_t decimals);
+extern int16_t _IQ24toa_fixed(char *string, _iq24 input, int16_t decimals);
+extern int16_t _IQ23toa_fixed(char *string, _iq23 input, int16_t decimals);
+extern int16_t _IQ22toa_fixed(char *string, _iq22 input, int16_t decimals);
+extern int16_t _IQ21toa_fixed(char *string, _iq21 input, int16_t decimals);
+extern int16_t _IQ20toa_fixed(char *string, _iq20 input, int16_t decimals);
+extern int16_t _IQ19toa_fixed(char *string, _iq19 input, int16_t decimals);
+extern int16_t _IQ18toa_fixed(char *string, _iq18 input, int16_t decimals);
+extern int16_t _IQ17toa_fixed(char *string, _iq17 input, int16_t decimals);
+extern int16_t _IQ16toa_fixed(char *string, _iq16 input, int16_t decimals);
+extern int16_t _IQ15toa_fixed(char *string, _iq15 input, int16_t decimals);
+extern int16_t _IQ14toa_fixed(char *string, _iq14 input, int16_t decimals);
+extern int16_t _IQ13toa_fixed(char *string, _iq13 input, int16_t decimals);
+extern int16_t _IQ12toa_fixed(char *string, _iq12 input, int16_t decimals);
+extern int16_t _IQ11toa_fixed(char *string, _iq11 input, int16_t decimals);
+extern int16_t _IQ10toa_fixed(char *string, _iq10 input, int16_t decimals);
+extern int16_t _IQ9toa_fixed(char *string, _iq9 input, int16_t decimals);
+extern int16_t _IQ8toa_fixed(char *string, _iq8 input, int16_t decimals);
+extern int16_t _IQ7toa_fixed(char *string, _iq7 input, int16_t decimals);
+extern int16_t _IQ6toa_fixed(char *string, _iq6 input, int16_t decimals);
+extern int16_t _IQ5toa_fixed(char *string, _iq5 input, int16_t decimals);
+extern int16_t _IQ4toa_fixed(char *string, _iq4 input, int16_t decimals);
+extern int16_t _IQ3toa_fixed(char *string, _iq3 input, int16_t decimals);
+extern int16_t _IQ2toa_fixed(char *string, _iq2 input, int16_t decimals);
+extern int16_t _IQ1toa_fixed(char *string, _iq1 input, int16_t decimals);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Converts a global IQ format input into a string with a fixed number of decimals.
+ *
+ * Unlike _IQtoa(), there is no format string to parse and the last decimal is rounded. The integer part has no
+ * padding and a minus sign is only written if the rounded value is not zero, so the result is also a valid JSON
+ * number.
+ *
+ * @param A               Pointer to the buffer to store the converted IQ number, of at least 13 + C characters.
+ * @param B               Global IQ format input.
+ * @param C               Number of decimals, from 0 to 9.
+ *
+ * @return                Returns the length of the string, without the null terminator, or -1 if the number of
+ *                        decimals is out of range.
+ */
+#if GLOBAL_IQ == 30
+#define _IQtoa_fixed(A, B, C)   _IQ30toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQtoa_fixed(A, B, C)   _IQ29toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQtoa_fixed(A, B, C)   _IQ28toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQtoa_fixed(A, B, C)   _IQ27toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQtoa_fixed(A, B, C)   _IQ26toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQtoa_fixed(A, B, C)   _IQ25toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQtoa_fixed(A, B, C)   _IQ24toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQtoa_fixed(A, B, C)   _IQ23toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQtoa_fixed(A, B, C)   _IQ22toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQtoa_fixed(A, B, C)   _IQ21toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQtoa_fixed(A, B, C)   _IQ20toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQtoa_fixed(A, B, C)   _IQ19toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQtoa_fixed(A, B, C)   _IQ18toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQtoa_fixed(A, B, C)   _IQ17toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQtoa_fixed(A, B, C)   _IQ16toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQtoa_fixed(A, B, C)   _IQ15toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQtoa_fixed(A, B, C)   _IQ14toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQtoa_fixed(A, B, C)   _IQ13toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQtoa_fixed(A, B, C)   _IQ12toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQtoa_fixed(A, B, C)   _IQ11toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQtoa_fixed(A, B, C)   _IQ10toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQtoa_fixed(A, B, C)   _IQ9toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQtoa_fixed(A, B, C)   _IQ8toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQtoa_fixed(A, B, C)   _IQ7toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQtoa_fixed(A, B, C)   _IQ6toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQtoa_fixed(A, B, C)   _IQ5toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQtoa_fixed(A, B, C)   _IQ4toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQtoa_fixed(A, B, C)   _IQ3toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQtoa_fixed(A, B, C)   _IQ2toa_fixed(A, B, C)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQtoa_fixed(A, B, C)   _IQ1toa_fixed(A, B, C)
+#endif
+
 //*****************************************************************************
 //
 // Computes the absolute value of an IQ number.
@@ -6516,6 +6660,1386 @@ extern int16_t _IQ1toa(char *string, const char *format, _iq1 input);
  */
 #define _IQabs(A)               (((A) < 0) ? - (A) : (A))
 
+//*****************************************************************************
+//
+// Multiplies two arrays of IQ numbers element by element.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30mpy_v(const _iq30 *A, const _iq30 *B, _iq30 *Y, size_t N);
+extern void _IQ29mpy_v(const _iq29 *A, const _iq29 *B, _iq29 *Y, size_t N);
+extern void _IQ28mpy_v(const _iq28 *A, const _iq28 *B, _iq28 *Y, size_t N);
+extern void _IQ27mpy_v(const _iq27 *A, const _iq27 *B, _iq27 *Y, size_t N);
+extern void _IQ26mpy_v(const _iq26 *A, const _iq26 *B, _iq26 *Y, size_t N);
+extern void _IQ25mpy_v(const _iq25 *A, const _iq25 *B, _iq25 *Y, size_t N);
+extern void _IQ24mpy_v(const _iq24 *A, const _iq24 *B, _iq24 *Y, size_t N);
+extern void _IQ23mpy_v(const _iq23 *A, const _iq23 *B, _iq23 *Y, size_t N);
+extern void _IQ22mpy_v(const _iq22 *A, const _iq22 *B, _iq22 *Y, size_t N);
+extern void _IQ21mpy_v(const _iq21 *A, const _iq21 *B, _iq21 *Y, size_t N);
+extern void _IQ20mpy_v(const _iq20 *A, const _iq20 *B, _iq20 *Y, size_t N);
+extern void _IQ19mpy_v(const _iq19 *A, const _iq19 *B, _iq19 *Y, size_t N);
+extern void _IQ18mpy_v(const _iq18 *A, const _iq18 *B, _iq18 *Y, size_t N);
+extern void _IQ17mpy_v(const _iq17 *A, const _iq17 *B, _iq17 *Y, size_t N);
+extern void _IQ16mpy_v(const _iq16 *A, const _iq16 *B, _iq16 *Y, size_t N);
+extern void _IQ15mpy_v(const _iq15 *A, const _iq15 *B, _iq15 *Y, size_t N);
+extern void _IQ14mpy_v(const _iq14 *A, const _iq14 *B, _iq14 *Y, size_t N);
+extern void _IQ13mpy_v(const _iq13 *A, const _iq13 *B, _iq13 *Y, size_t N);
+extern void _IQ12mpy_v(const _iq12 *A, const _iq12 *B, _iq12 *Y, size_t N);
+extern void _IQ11mpy_v(const _iq11 *A, const _iq11 *B, _iq11 *Y, size_t N);
+extern void _IQ10mpy_v(const _iq10 *A, const _iq10 *B, _iq10 *Y, size_t N);
+extern void _IQ9mpy_v(const _iq9 *A, const _iq9 *B, _iq9 *Y, size_t N);
+extern void _IQ8mpy_v(const _iq8 *A, const _iq8 *B, _iq8 *Y, size_t N);
+extern void _IQ7mpy_v(const _iq7 *A, const _iq7 *B, _iq7 *Y, size_t N);
+extern void _IQ6mpy_v(const _iq6 *A, const _iq6 *B, _iq6 *Y, size_t N);
+extern void _IQ5mpy_v(const _iq5 *A, const _iq5 *B, _iq5 *Y, size_t N);
+extern void _IQ4mpy_v(const _iq4 *A, const _iq4 *B, _iq4 *Y, size_t N);
+extern void _IQ3mpy_v(const _iq3 *A, const _iq3 *B, _iq3 *Y, size_t N);
+extern void _IQ2mpy_v(const _iq2 *A, const _iq2 *B, _iq2 *Y, size_t N);
+extern void _IQ1mpy_v(const _iq1 *A, const _iq1 *B, _iq1 *Y, size_t N);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Multiplies two arrays of global IQ format numbers element by element.
+ *
+ * The loop runs inside the library, without a function call per element.
+ *
+ * @param A               Global IQ format input array.
+ * @param B               Global IQ format input array.
+ * @param Y               Global IQ format array receiving the products, may be A or B.
+ * @param N               Number of elements.
+ */
+#if GLOBAL_IQ == 30
+#define _IQmpy_v(A, B, Y, N)    _IQ30mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQmpy_v(A, B, Y, N)    _IQ29mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQmpy_v(A, B, Y, N)    _IQ28mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQmpy_v(A, B, Y, N)    _IQ27mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQmpy_v(A, B, Y, N)    _IQ26mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQmpy_v(A, B, Y, N)    _IQ25mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQmpy_v(A, B, Y, N)    _IQ24mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQmpy_v(A, B, Y, N)    _IQ23mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQmpy_v(A, B, Y, N)    _IQ22mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQmpy_v(A, B, Y, N)    _IQ21mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQmpy_v(A, B, Y, N)    _IQ20mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQmpy_v(A, B, Y, N)    _IQ19mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQmpy_v(A, B, Y, N)    _IQ18mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQmpy_v(A, B, Y, N)    _IQ17mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQmpy_v(A, B, Y, N)    _IQ16mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQmpy_v(A, B, Y, N)    _IQ15mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQmpy_v(A, B, Y, N)    _IQ14mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQmpy_v(A, B, Y, N)    _IQ13mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQmpy_v(A, B, Y, N)    _IQ12mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQmpy_v(A, B, Y, N)    _IQ11mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQmpy_v(A, B, Y, N)    _IQ10mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQmpy_v(A, B, Y, N)    _IQ9mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQmpy_v(A, B, Y, N)    _IQ8mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQmpy_v(A, B, Y, N)    _IQ7mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQmpy_v(A, B, Y, N)    _IQ6mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQmpy_v(A, B, Y, N)    _IQ5mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQmpy_v(A, B, Y, N)    _IQ4mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQmpy_v(A, B, Y, N)    _IQ3mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQmpy_v(A, B, Y, N)    _IQ2mpy_v(A, B, Y, N)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQmpy_v(A, B, Y, N)    _IQ1mpy_v(A, B, Y, N)
+#endif
+
+//*****************************************************************************
+//
+// Computes the sin of an array of IQ numbers.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ29sin_v(const _iq29 *A, _iq29 *Y, size_t N);
+extern void _IQ28sin_v(const _iq28 *A, _iq28 *Y, size_t N);
+extern void _IQ27sin_v(const _iq27 *A, _iq27 *Y, size_t N);
+extern void _IQ26sin_v(const _iq26 *A, _iq26 *Y, size_t N);
+extern void _IQ25sin_v(const _iq25 *A, _iq25 *Y, size_t N);
+extern void _IQ24sin_v(const _iq24 *A, _iq24 *Y, size_t N);
+extern void _IQ23sin_v(const _iq23 *A, _iq23 *Y, size_t N);
+extern void _IQ22sin_v(const _iq22 *A, _iq22 *Y, size_t N);
+extern void _IQ21sin_v(const _iq21 *A, _iq21 *Y, size_t N);
+extern void _IQ20sin_v(const _iq20 *A, _iq20 *Y, size_t N);
+extern void _IQ19sin_v(const _iq19 *A, _iq19 *Y, size_t N);
+extern void _IQ18sin_v(const _iq18 *A, _iq18 *Y, size_t N);
+extern void _IQ17sin_v(const _iq17 *A, _iq17 *Y, size_t N);
+extern void _IQ16sin_v(const _iq16 *A, _iq16 *Y, size_t N);
+extern void _IQ15sin_v(const _iq15 *A, _iq15 *Y, size_t N);
+extern void _IQ14sin_v(const _iq14 *A, _iq14 *Y, size_t N);
+extern void _IQ13sin_v(const _iq13 *A, _iq13 *Y, size_t N);
+extern void _IQ12sin_v(const _iq12 *A, _iq12 *Y, size_t N);
+extern void _IQ11sin_v(const _iq11 *A, _iq11 *Y, size_t N);
+extern void _IQ10sin_v(const _iq10 *A, _iq10 *Y, size_t N);
+extern void _IQ9sin_v(const _iq9 *A, _iq9 *Y, size_t N);
+extern void _IQ8sin_v(const _iq8 *A, _iq8 *Y, size_t N);
+extern void _IQ7sin_v(const _iq7 *A, _iq7 *Y, size_t N);
+extern void _IQ6sin_v(const _iq6 *A, _iq6 *Y, size_t N);
+extern void _IQ5sin_v(const _iq5 *A, _iq5 *Y, size_t N);
+extern void _IQ4sin_v(const _iq4 *A, _iq4 *Y, size_t N);
+extern void _IQ3sin_v(const _iq3 *A, _iq3 *Y, size_t N);
+extern void _IQ2sin_v(const _iq2 *A, _iq2 *Y, size_t N);
+extern void _IQ1sin_v(const _iq1 *A, _iq1 *Y, size_t N);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the sine of an array of global IQ format inputs, in radians.
+ *
+ * @param A               Global IQ format input array.
+ * @param Y               Global IQ format array receiving the results, may be A.
+ * @param N               Number of elements.
+ */
+#if GLOBAL_IQ == 29
+#define _IQsin_v(A, Y, N)       _IQ29sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQsin_v(A, Y, N)       _IQ28sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQsin_v(A, Y, N)       _IQ27sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQsin_v(A, Y, N)       _IQ26sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQsin_v(A, Y, N)       _IQ25sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQsin_v(A, Y, N)       _IQ24sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQsin_v(A, Y, N)       _IQ23sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQsin_v(A, Y, N)       _IQ22sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQsin_v(A, Y, N)       _IQ21sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQsin_v(A, Y, N)       _IQ20sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQsin_v(A, Y, N)       _IQ19sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQsin_v(A, Y, N)       _IQ18sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQsin_v(A, Y, N)       _IQ17sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQsin_v(A, Y, N)       _IQ16sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQsin_v(A, Y, N)       _IQ15sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQsin_v(A, Y, N)       _IQ14sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQsin_v(A, Y, N)       _IQ13sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQsin_v(A, Y, N)       _IQ12sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQsin_v(A, Y, N)       _IQ11sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQsin_v(A, Y, N)       _IQ10sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQsin_v(A, Y, N)       _IQ9sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQsin_v(A, Y, N)       _IQ8sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQsin_v(A, Y, N)       _IQ7sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQsin_v(A, Y, N)       _IQ6sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQsin_v(A, Y, N)       _IQ5sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQsin_v(A, Y, N)       _IQ4sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQsin_v(A, Y, N)       _IQ3sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQsin_v(A, Y, N)       _IQ2sin_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQsin_v(A, Y, N)       _IQ1sin_v(A, Y, N)
+#endif
+
+//*****************************************************************************
+//
+// Computes the square root of an array of IQ numbers.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30sqrt_v(const _iq30 *A, _iq30 *Y, size_t N);
+extern void _IQ29sqrt_v(const _iq29 *A, _iq29 *Y, size_t N);
+extern void _IQ28sqrt_v(const _iq28 *A, _iq28 *Y, size_t N);
+extern void _IQ27sqrt_v(const _iq27 *A, _iq27 *Y, size_t N);
+extern void _IQ26sqrt_v(const _iq26 *A, _iq26 *Y, size_t N);
+extern void _IQ25sqrt_v(const _iq25 *A, _iq25 *Y, size_t N);
+extern void _IQ24sqrt_v(const _iq24 *A, _iq24 *Y, size_t N);
+extern void _IQ23sqrt_v(const _iq23 *A, _iq23 *Y, size_t N);
+extern void _IQ22sqrt_v(const _iq22 *A, _iq22 *Y, size_t N);
+extern void _IQ21sqrt_v(const _iq21 *A, _iq21 *Y, size_t N);
+extern void _IQ20sqrt_v(const _iq20 *A, _iq20 *Y, size_t N);
+extern void _IQ19sqrt_v(const _iq19 *A, _iq19 *Y, size_t N);
+extern void _IQ18sqrt_v(const _iq18 *A, _iq18 *Y, size_t N);
+extern void _IQ17sqrt_v(const _iq17 *A, _iq17 *Y, size_t N);
+extern void _IQ16sqrt_v(const _iq16 *A, _iq16 *Y, size_t N);
+extern void _IQ15sqrt_v(const _iq15 *A, _iq15 *Y, size_t N);
+extern void _IQ14sqrt_v(const _iq14 *A, _iq14 *Y, size_t N);
+extern void _IQ13sqrt_v(const _iq13 *A, _iq13 *Y, size_t N);
+extern void _IQ12sqrt_v(const _iq12 *A, _iq12 *Y, size_t N);
+extern void _IQ11sqrt_v(const _iq11 *A, _iq11 *Y, size_t N);
+extern void _IQ10sqrt_v(const _iq10 *A, _iq10 *Y, size_t N);
+extern void _IQ9sqrt_v(const _iq9 *A, _iq9 *Y, size_t N);
+extern void _IQ8sqrt_v(const _iq8 *A, _iq8 *Y, size_t N);
+extern void _IQ7sqrt_v(const _iq7 *A, _iq7 *Y, size_t N);
+extern void _IQ6sqrt_v(const _iq6 *A, _iq6 *Y, size_t N);
+extern void _IQ5sqrt_v(const _iq5 *A, _iq5 *Y, size_t N);
+extern void _IQ4sqrt_v(const _iq4 *A, _iq4 *Y, size_t N);
+extern void _IQ3sqrt_v(const _iq3 *A, _iq3 *Y, size_t N);
+extern void _IQ2sqrt_v(const _iq2 *A, _iq2 *Y, size_t N);
+extern void _IQ1sqrt_v(const _iq1 *A, _iq1 *Y, size_t N);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the square root of an array of global IQ format inputs.
+ *
+ * @param A               Global IQ format input array.
+ * @param Y               Global IQ format array receiving the results, may be A.
+ * @param N               Number of elements.
+ */
+#if GLOBAL_IQ == 30
+#define _IQsqrt_v(A, Y, N)      _IQ30sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQsqrt_v(A, Y, N)      _IQ29sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQsqrt_v(A, Y, N)      _IQ28sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQsqrt_v(A, Y, N)      _IQ27sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQsqrt_v(A, Y, N)      _IQ26sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQsqrt_v(A, Y, N)      _IQ25sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQsqrt_v(A, Y, N)      _IQ24sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQsqrt_v(A, Y, N)      _IQ23sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQsqrt_v(A, Y, N)      _IQ22sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQsqrt_v(A, Y, N)      _IQ21sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQsqrt_v(A, Y, N)      _IQ20sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQsqrt_v(A, Y, N)      _IQ19sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQsqrt_v(A, Y, N)      _IQ18sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQsqrt_v(A, Y, N)      _IQ17sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQsqrt_v(A, Y, N)      _IQ16sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQsqrt_v(A, Y, N)      _IQ15sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQsqrt_v(A, Y, N)      _IQ14sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQsqrt_v(A, Y, N)      _IQ13sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQsqrt_v(A, Y, N)      _IQ12sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQsqrt_v(A, Y, N)      _IQ11sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQsqrt_v(A, Y, N)      _IQ10sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQsqrt_v(A, Y, N)      _IQ9sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQsqrt_v(A, Y, N)      _IQ8sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQsqrt_v(A, Y, N)      _IQ7sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQsqrt_v(A, Y, N)      _IQ6sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQsqrt_v(A, Y, N)      _IQ5sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQsqrt_v(A, Y, N)      _IQ4sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQsqrt_v(A, Y, N)      _IQ3sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQsqrt_v(A, Y, N)      _IQ2sqrt_v(A, Y, N)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQsqrt_v(A, Y, N)      _IQ1sqrt_v(A, Y, N)
+#endif
+
+//*****************************************************************************
+//
+// Computes the square root of A^2 + B^2 for arrays of IQ numbers.
+//
+//*****************************************************************************
+extern void _IQmag_v(const int32_t *A, const int32_t *B, int32_t *Y, size_t N);
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ30 numbers.
+ *
+ * @param A               IQ30 type input array.
+ * @param B               IQ30 type input array.
+ * @param Y               IQ30 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ30mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ29 numbers.
+ *
+ * @param A               IQ29 type input array.
+ * @param B               IQ29 type input array.
+ * @param Y               IQ29 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ29mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ28 numbers.
+ *
+ * @param A               IQ28 type input array.
+ * @param B               IQ28 type input array.
+ * @param Y               IQ28 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ28mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ27 numbers.
+ *
+ * @param A               IQ27 type input array.
+ * @param B               IQ27 type input array.
+ * @param Y               IQ27 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ27mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ26 numbers.
+ *
+ * @param A               IQ26 type input array.
+ * @param B               IQ26 type input array.
+ * @param Y               IQ26 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ26mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ25 numbers.
+ *
+ * @param A               IQ25 type input array.
+ * @param B               IQ25 type input array.
+ * @param Y               IQ25 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ25mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ24 numbers.
+ *
+ * @param A               IQ24 type input array.
+ * @param B               IQ24 type input array.
+ * @param Y               IQ24 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ24mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ23 numbers.
+ *
+ * @param A               IQ23 type input array.
+ * @param B               IQ23 type input array.
+ * @param Y               IQ23 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ23mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ22 numbers.
+ *
+ * @param A               IQ22 type input array.
+ * @param B               IQ22 type input array.
+ * @param Y               IQ22 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ22mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ21 numbers.
+ *
+ * @param A               IQ21 type input array.
+ * @param B               IQ21 type input array.
+ * @param Y               IQ21 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ21mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ20 numbers.
+ *
+ * @param A               IQ20 type input array.
+ * @param B               IQ20 type input array.
+ * @param Y               IQ20 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ20mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ19 numbers.
+ *
+ * @param A               IQ19 type input array.
+ * @param B               IQ19 type input array.
+ * @param Y               IQ19 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ19mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ18 numbers.
+ *
+ * @param A               IQ18 type input array.
+ * @param B               IQ18 type input array.
+ * @param Y               IQ18 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ18mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ17 numbers.
+ *
+ * @param A               IQ17 type input array.
+ * @param B               IQ17 type input array.
+ * @param Y               IQ17 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ17mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ16 numbers.
+ *
+ * @param A               IQ16 type input array.
+ * @param B               IQ16 type input array.
+ * @param Y               IQ16 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ16mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ15 numbers.
+ *
+ * @param A               IQ15 type input array.
+ * @param B               IQ15 type input array.
+ * @param Y               IQ15 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ15mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ14 numbers.
+ *
+ * @param A               IQ14 type input array.
+ * @param B               IQ14 type input array.
+ * @param Y               IQ14 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ14mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ13 numbers.
+ *
+ * @param A               IQ13 type input array.
+ * @param B               IQ13 type input array.
+ * @param Y               IQ13 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ13mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ12 numbers.
+ *
+ * @param A               IQ12 type input array.
+ * @param B               IQ12 type input array.
+ * @param Y               IQ12 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ12mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ11 numbers.
+ *
+ * @param A               IQ11 type input array.
+ * @param B               IQ11 type input array.
+ * @param Y               IQ11 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ11mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ10 numbers.
+ *
+ * @param A               IQ10 type input array.
+ * @param B               IQ10 type input array.
+ * @param Y               IQ10 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ10mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ9 numbers.
+ *
+ * @param A               IQ9 type input array.
+ * @param B               IQ9 type input array.
+ * @param Y               IQ9 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ9mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ8 numbers.
+ *
+ * @param A               IQ8 type input array.
+ * @param B               IQ8 type input array.
+ * @param Y               IQ8 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ8mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ7 numbers.
+ *
+ * @param A               IQ7 type input array.
+ * @param B               IQ7 type input array.
+ * @param Y               IQ7 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ7mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ6 numbers.
+ *
+ * @param A               IQ6 type input array.
+ * @param B               IQ6 type input array.
+ * @param Y               IQ6 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ6mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ5 numbers.
+ *
+ * @param A               IQ5 type input array.
+ * @param B               IQ5 type input array.
+ * @param Y               IQ5 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ5mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ4 numbers.
+ *
+ * @param A               IQ4 type input array.
+ * @param B               IQ4 type input array.
+ * @param Y               IQ4 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ4mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ3 numbers.
+ *
+ * @param A               IQ3 type input array.
+ * @param B               IQ3 type input array.
+ * @param Y               IQ3 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ3mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ2 numbers.
+ *
+ * @param A               IQ2 type input array.
+ * @param B               IQ2 type input array.
+ * @param Y               IQ2 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ2mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+/**
+ * @brief Computes the square root of A^2 + B^2 for arrays of IQ1 numbers.
+ *
+ * @param A               IQ1 type input array.
+ * @param B               IQ1 type input array.
+ * @param Y               IQ1 type array receiving the results, may be A or B.
+ * @param N               Number of elements.
+ */
+#define _IQ1mag_v(A, B, Y, N)         _IQmag_v(A, B, Y, N)
+
+//*****************************************************************************
+//
+// Computes the sin and cos of an IQ number at once.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ29sincos(_iq29 A, _iq29 *S, _iq29 *C);
+extern void _IQ28sincos(_iq28 A, _iq28 *S, _iq28 *C);
+extern void _IQ27sincos(_iq27 A, _iq27 *S, _iq27 *C);
+extern void _IQ26sincos(_iq26 A, _iq26 *S, _iq26 *C);
+extern void _IQ25sincos(_iq25 A, _iq25 *S, _iq25 *C);
+extern void _IQ24sincos(_iq24 A, _iq24 *S, _iq24 *C);
+extern void _IQ23sincos(_iq23 A, _iq23 *S, _iq23 *C);
+extern void _IQ22sincos(_iq22 A, _iq22 *S, _iq22 *C);
+extern void _IQ21sincos(_iq21 A, _iq21 *S, _iq21 *C);
+extern void _IQ20sincos(_iq20 A, _iq20 *S, _iq20 *C);
+extern void _IQ19sincos(_iq19 A, _iq19 *S, _iq19 *C);
+extern void _IQ18sincos(_iq18 A, _iq18 *S, _iq18 *C);
+extern void _IQ17sincos(_iq17 A, _iq17 *S, _iq17 *C);
+extern void _IQ16sincos(_iq16 A, _iq16 *S, _iq16 *C);
+extern void _IQ15sincos(_iq15 A, _iq15 *S, _iq15 *C);
+extern void _IQ14sincos(_iq14 A, _iq14 *S, _iq14 *C);
+extern void _IQ13sincos(_iq13 A, _iq13 *S, _iq13 *C);
+extern void _IQ12sincos(_iq12 A, _iq12 *S, _iq12 *C);
+extern void _IQ11sincos(_iq11 A, _iq11 *S, _iq11 *C);
+extern void _IQ10sincos(_iq10 A, _iq10 *S, _iq10 *C);
+extern void _IQ9sincos(_iq9 A, _iq9 *S, _iq9 *C);
+extern void _IQ8sincos(_iq8 A, _iq8 *S, _iq8 *C);
+extern void _IQ7sincos(_iq7 A, _iq7 *S, _iq7 *C);
+extern void _IQ6sincos(_iq6 A, _iq6 *S, _iq6 *C);
+extern void _IQ5sincos(_iq5 A, _iq5 *S, _iq5 *C);
+extern void _IQ4sincos(_iq4 A, _iq4 *S, _iq4 *C);
+extern void _IQ3sincos(_iq3 A, _iq3 *S, _iq3 *C);
+extern void _IQ2sincos(_iq2 A, _iq2 *S, _iq2 *C);
+extern void _IQ1sincos(_iq1 A, _iq1 *S, _iq1 *C);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the sine and the cosine of a global IQ format input.
+ *
+ * Same results as _IQsin() and _IQcos(), with a single range reduction.
+ *
+ * @param A               Global IQ format input, in radians.
+ * @param S               Global IQ format result of sine operation.
+ * @param C               Global IQ format result of cosine operation.
+ */
+#if GLOBAL_IQ == 29
+#define _IQsincos(A, S, C)      _IQ29sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQsincos(A, S, C)      _IQ28sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQsincos(A, S, C)      _IQ27sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQsincos(A, S, C)      _IQ26sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQsincos(A, S, C)      _IQ25sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQsincos(A, S, C)      _IQ24sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQsincos(A, S, C)      _IQ23sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQsincos(A, S, C)      _IQ22sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQsincos(A, S, C)      _IQ21sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQsincos(A, S, C)      _IQ20sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQsincos(A, S, C)      _IQ19sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQsincos(A, S, C)      _IQ18sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQsincos(A, S, C)      _IQ17sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQsincos(A, S, C)      _IQ16sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQsincos(A, S, C)      _IQ15sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQsincos(A, S, C)      _IQ14sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQsincos(A, S, C)      _IQ13sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQsincos(A, S, C)      _IQ12sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQsincos(A, S, C)      _IQ11sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQsincos(A, S, C)      _IQ10sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQsincos(A, S, C)      _IQ9sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQsincos(A, S, C)      _IQ8sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQsincos(A, S, C)      _IQ7sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQsincos(A, S, C)      _IQ6sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQsincos(A, S, C)      _IQ5sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQsincos(A, S, C)      _IQ4sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQsincos(A, S, C)      _IQ3sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQsincos(A, S, C)      _IQ2sincos(A, S, C)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQsincos(A, S, C)      _IQ1sincos(A, S, C)
+#endif
+
+//*****************************************************************************
+//
+// Computes the sin and cos of an IQ number at once, using cycles per unit
+// instead of radians.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30sincosPU(_iq30 A, _iq30 *S, _iq30 *C);
+extern void _IQ29sincosPU(_iq29 A, _iq29 *S, _iq29 *C);
+extern void _IQ28sincosPU(_iq28 A, _iq28 *S, _iq28 *C);
+extern void _IQ27sincosPU(_iq27 A, _iq27 *S, _iq27 *C);
+extern void _IQ26sincosPU(_iq26 A, _iq26 *S, _iq26 *C);
+extern void _IQ25sincosPU(_iq25 A, _iq25 *S, _iq25 *C);
+extern void _IQ24sincosPU(_iq24 A, _iq24 *S, _iq24 *C);
+extern void _IQ23sincosPU(_iq23 A, _iq23 *S, _iq23 *C);
+extern void _IQ22sincosPU(_iq22 A, _iq22 *S, _iq22 *C);
+extern void _IQ21sincosPU(_iq21 A, _iq21 *S, _iq21 *C);
+extern void _IQ20sincosPU(_iq20 A, _iq20 *S, _iq20 *C);
+extern void _IQ19sincosPU(_iq19 A, _iq19 *S, _iq19 *C);
+extern void _IQ18sincosPU(_iq18 A, _iq18 *S, _iq18 *C);
+extern void _IQ17sincosPU(_iq17 A, _iq17 *S, _iq17 *C);
+extern void _IQ16sincosPU(_iq16 A, _iq16 *S, _iq16 *C);
+extern void _IQ15sincosPU(_iq15 A, _iq15 *S, _iq15 *C);
+extern void _IQ14sincosPU(_iq14 A, _iq14 *S, _iq14 *C);
+extern void _IQ13sincosPU(_iq13 A, _iq13 *S, _iq13 *C);
+extern void _IQ12sincosPU(_iq12 A, _iq12 *S, _iq12 *C);
+extern void _IQ11sincosPU(_iq11 A, _iq11 *S, _iq11 *C);
+extern void _IQ10sincosPU(_iq10 A, _iq10 *S, _iq10 *C);
+extern void _IQ9sincosPU(_iq9 A, _iq9 *S, _iq9 *C);
+extern void _IQ8sincosPU(_iq8 A, _iq8 *S, _iq8 *C);
+extern void _IQ7sincosPU(_iq7 A, _iq7 *S, _iq7 *C);
+extern void _IQ6sincosPU(_iq6 A, _iq6 *S, _iq6 *C);
+extern void _IQ5sincosPU(_iq5 A, _iq5 *S, _iq5 *C);
+extern void _IQ4sincosPU(_iq4 A, _iq4 *S, _iq4 *C);
+extern void _IQ3sincosPU(_iq3 A, _iq3 *S, _iq3 *C);
+extern void _IQ2sincosPU(_iq2 A, _iq2 *S, _iq2 *C);
+extern void _IQ1sincosPU(_iq1 A, _iq1 *S, _iq1 *C);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the sine and the cosine of a global IQ format input.
+ *
+ * Same results as _IQsinPU() and _IQcosPU(), with a single range reduction.
+ *
+ * @param A               Global IQ format input, in cycles per unit.
+ * @param S               Global IQ format result of sine operation.
+ * @param C               Global IQ format result of cosine operation.
+ */
+#if GLOBAL_IQ == 30
+#define _IQsincosPU(A, S, C)    _IQ30sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQsincosPU(A, S, C)    _IQ29sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQsincosPU(A, S, C)    _IQ28sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQsincosPU(A, S, C)    _IQ27sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQsincosPU(A, S, C)    _IQ26sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQsincosPU(A, S, C)    _IQ25sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQsincosPU(A, S, C)    _IQ24sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQsincosPU(A, S, C)    _IQ23sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQsincosPU(A, S, C)    _IQ22sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQsincosPU(A, S, C)    _IQ21sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQsincosPU(A, S, C)    _IQ20sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQsincosPU(A, S, C)    _IQ19sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQsincosPU(A, S, C)    _IQ18sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQsincosPU(A, S, C)    _IQ17sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQsincosPU(A, S, C)    _IQ16sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQsincosPU(A, S, C)    _IQ15sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQsincosPU(A, S, C)    _IQ14sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQsincosPU(A, S, C)    _IQ13sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQsincosPU(A, S, C)    _IQ12sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQsincosPU(A, S, C)    _IQ11sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQsincosPU(A, S, C)    _IQ10sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQsincosPU(A, S, C)    _IQ9sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQsincosPU(A, S, C)    _IQ8sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQsincosPU(A, S, C)    _IQ7sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQsincosPU(A, S, C)    _IQ6sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQsincosPU(A, S, C)    _IQ5sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQsincosPU(A, S, C)    _IQ4sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQsincosPU(A, S, C)    _IQ3sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQsincosPU(A, S, C)    _IQ2sincosPU(A, S, C)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQsincosPU(A, S, C)    _IQ1sincosPU(A, S, C)
+#endif
+
+//*****************************************************************************
+//
+// Computes the Clarke transform of two phase currents.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30clarke(_iq30 A, _iq30 B, _iq30 *ALPHA, _iq30 *BETA);
+extern void _IQ29clarke(_iq29 A, _iq29 B, _iq29 *ALPHA, _iq29 *BETA);
+extern void _IQ28clarke(_iq28 A, _iq28 B, _iq28 *ALPHA, _iq28 *BETA);
+extern void _IQ27clarke(_iq27 A, _iq27 B, _iq27 *ALPHA, _iq27 *BETA);
+extern void _IQ26clarke(_iq26 A, _iq26 B, _iq26 *ALPHA, _iq26 *BETA);
+extern void _IQ25clarke(_iq25 A, _iq25 B, _iq25 *ALPHA, _iq25 *BETA);
+extern void _IQ24clarke(_iq24 A, _iq24 B, _iq24 *ALPHA, _iq24 *BETA);
+extern void _IQ23clarke(_iq23 A, _iq23 B, _iq23 *ALPHA, _iq23 *BETA);
+extern void _IQ22clarke(_iq22 A, _iq22 B, _iq22 *ALPHA, _iq22 *BETA);
+extern void _IQ21clarke(_iq21 A, _iq21 B, _iq21 *ALPHA, _iq21 *BETA);
+extern void _IQ20clarke(_iq20 A, _iq20 B, _iq20 *ALPHA, _iq20 *BETA);
+extern void _IQ19clarke(_iq19 A, _iq19 B, _iq19 *ALPHA, _iq19 *BETA);
+extern void _IQ18clarke(_iq18 A, _iq18 B, _iq18 *ALPHA, _iq18 *BETA);
+extern void _IQ17clarke(_iq17 A, _iq17 B, _iq17 *ALPHA, _iq17 *BETA);
+extern void _IQ16clarke(_iq16 A, _iq16 B, _iq16 *ALPHA, _iq16 *BETA);
+extern void _IQ15clarke(_iq15 A, _iq15 B, _iq15 *ALPHA, _iq15 *BETA);
+extern void _IQ14clarke(_iq14 A, _iq14 B, _iq14 *ALPHA, _iq14 *BETA);
+extern void _IQ13clarke(_iq13 A, _iq13 B, _iq13 *ALPHA, _iq13 *BETA);
+extern void _IQ12clarke(_iq12 A, _iq12 B, _iq12 *ALPHA, _iq12 *BETA);
+extern void _IQ11clarke(_iq11 A, _iq11 B, _iq11 *ALPHA, _iq11 *BETA);
+extern void _IQ10clarke(_iq10 A, _iq10 B, _iq10 *ALPHA, _iq10 *BETA);
+extern void _IQ9clarke(_iq9 A, _iq9 B, _iq9 *ALPHA, _iq9 *BETA);
+extern void _IQ8clarke(_iq8 A, _iq8 B, _iq8 *ALPHA, _iq8 *BETA);
+extern void _IQ7clarke(_iq7 A, _iq7 B, _iq7 *ALPHA, _iq7 *BETA);
+extern void _IQ6clarke(_iq6 A, _iq6 B, _iq6 *ALPHA, _iq6 *BETA);
+extern void _IQ5clarke(_iq5 A, _iq5 B, _iq5 *ALPHA, _iq5 *BETA);
+extern void _IQ4clarke(_iq4 A, _iq4 B, _iq4 *ALPHA, _iq4 *BETA);
+extern void _IQ3clarke(_iq3 A, _iq3 B, _iq3 *ALPHA, _iq3 *BETA);
+extern void _IQ2clarke(_iq2 A, _iq2 B, _iq2 *ALPHA, _iq2 *BETA);
+extern void _IQ1clarke(_iq1 A, _iq1 B, _iq1 *ALPHA, _iq1 *BETA);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the Clarke transform of two global IQ format phase currents.
+ *
+ * ALPHA = A, BETA = (A + 2 * B) / sqrt(3). The third phase current is
+ * assumed to be -(A + B).
+ *
+ * @param A               Global IQ format current of phase a.
+ * @param B               Global IQ format current of phase b.
+ * @param ALPHA           Global IQ format alpha component.
+ * @param BETA            Global IQ format beta component.
+ */
+#if GLOBAL_IQ == 30
+#define _IQclarke(A, B, ALPHA, BETA)_IQ30clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQclarke(A, B, ALPHA, BETA)_IQ29clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQclarke(A, B, ALPHA, BETA)_IQ28clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQclarke(A, B, ALPHA, BETA)_IQ27clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQclarke(A, B, ALPHA, BETA)_IQ26clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQclarke(A, B, ALPHA, BETA)_IQ25clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQclarke(A, B, ALPHA, BETA)_IQ24clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQclarke(A, B, ALPHA, BETA)_IQ23clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQclarke(A, B, ALPHA, BETA)_IQ22clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQclarke(A, B, ALPHA, BETA)_IQ21clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQclarke(A, B, ALPHA, BETA)_IQ20clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQclarke(A, B, ALPHA, BETA)_IQ19clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQclarke(A, B, ALPHA, BETA)_IQ18clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQclarke(A, B, ALPHA, BETA)_IQ17clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQclarke(A, B, ALPHA, BETA)_IQ16clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQclarke(A, B, ALPHA, BETA)_IQ15clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQclarke(A, B, ALPHA, BETA)_IQ14clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQclarke(A, B, ALPHA, BETA)_IQ13clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQclarke(A, B, ALPHA, BETA)_IQ12clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQclarke(A, B, ALPHA, BETA)_IQ11clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQclarke(A, B, ALPHA, BETA)_IQ10clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQclarke(A, B, ALPHA, BETA)_IQ9clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQclarke(A, B, ALPHA, BETA)_IQ8clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQclarke(A, B, ALPHA, BETA)_IQ7clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQclarke(A, B, ALPHA, BETA)_IQ6clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQclarke(A, B, ALPHA, BETA)_IQ5clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQclarke(A, B, ALPHA, BETA)_IQ4clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQclarke(A, B, ALPHA, BETA)_IQ3clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQclarke(A, B, ALPHA, BETA)_IQ2clarke(A, B, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQclarke(A, B, ALPHA, BETA)_IQ1clarke(A, B, ALPHA, BETA)
+#endif
+
+//*****************************************************************************
+//
+// Computes the Park transform.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30park(_iq30 ALPHA, _iq30 BETA, _iq30 S, _iq30 C, _iq30 *D, _iq30 *Q);
+extern void _IQ29park(_iq29 ALPHA, _iq29 BETA, _iq29 S, _iq29 C, _iq29 *D, _iq29 *Q);
+extern void _IQ28park(_iq28 ALPHA, _iq28 BETA, _iq28 S, _iq28 C, _iq28 *D, _iq28 *Q);
+extern void _IQ27park(_iq27 ALPHA, _iq27 BETA, _iq27 S, _iq27 C, _iq27 *D, _iq27 *Q);
+extern void _IQ26park(_iq26 ALPHA, _iq26 BETA, _iq26 S, _iq26 C, _iq26 *D, _iq26 *Q);
+extern void _IQ25park(_iq25 ALPHA, _iq25 BETA, _iq25 S, _iq25 C, _iq25 *D, _iq25 *Q);
+extern void _IQ24park(_iq24 ALPHA, _iq24 BETA, _iq24 S, _iq24 C, _iq24 *D, _iq24 *Q);
+extern void _IQ23park(_iq23 ALPHA, _iq23 BETA, _iq23 S, _iq23 C, _iq23 *D, _iq23 *Q);
+extern void _IQ22park(_iq22 ALPHA, _iq22 BETA, _iq22 S, _iq22 C, _iq22 *D, _iq22 *Q);
+extern void _IQ21park(_iq21 ALPHA, _iq21 BETA, _iq21 S, _iq21 C, _iq21 *D, _iq21 *Q);
+extern void _IQ20park(_iq20 ALPHA, _iq20 BETA, _iq20 S, _iq20 C, _iq20 *D, _iq20 *Q);
+extern void _IQ19park(_iq19 ALPHA, _iq19 BETA, _iq19 S, _iq19 C, _iq19 *D, _iq19 *Q);
+extern void _IQ18park(_iq18 ALPHA, _iq18 BETA, _iq18 S, _iq18 C, _iq18 *D, _iq18 *Q);
+extern void _IQ17park(_iq17 ALPHA, _iq17 BETA, _iq17 S, _iq17 C, _iq17 *D, _iq17 *Q);
+extern void _IQ16park(_iq16 ALPHA, _iq16 BETA, _iq16 S, _iq16 C, _iq16 *D, _iq16 *Q);
+extern void _IQ15park(_iq15 ALPHA, _iq15 BETA, _iq15 S, _iq15 C, _iq15 *D, _iq15 *Q);
+extern void _IQ14park(_iq14 ALPHA, _iq14 BETA, _iq14 S, _iq14 C, _iq14 *D, _iq14 *Q);
+extern void _IQ13park(_iq13 ALPHA, _iq13 BETA, _iq13 S, _iq13 C, _iq13 *D, _iq13 *Q);
+extern void _IQ12park(_iq12 ALPHA, _iq12 BETA, _iq12 S, _iq12 C, _iq12 *D, _iq12 *Q);
+extern void _IQ11park(_iq11 ALPHA, _iq11 BETA, _iq11 S, _iq11 C, _iq11 *D, _iq11 *Q);
+extern void _IQ10park(_iq10 ALPHA, _iq10 BETA, _iq10 S, _iq10 C, _iq10 *D, _iq10 *Q);
+extern void _IQ9park(_iq9 ALPHA, _iq9 BETA, _iq9 S, _iq9 C, _iq9 *D, _iq9 *Q);
+extern void _IQ8park(_iq8 ALPHA, _iq8 BETA, _iq8 S, _iq8 C, _iq8 *D, _iq8 *Q);
+extern void _IQ7park(_iq7 ALPHA, _iq7 BETA, _iq7 S, _iq7 C, _iq7 *D, _iq7 *Q);
+extern void _IQ6park(_iq6 ALPHA, _iq6 BETA, _iq6 S, _iq6 C, _iq6 *D, _iq6 *Q);
+extern void _IQ5park(_iq5 ALPHA, _iq5 BETA, _iq5 S, _iq5 C, _iq5 *D, _iq5 *Q);
+extern void _IQ4park(_iq4 ALPHA, _iq4 BETA, _iq4 S, _iq4 C, _iq4 *D, _iq4 *Q);
+extern void _IQ3park(_iq3 ALPHA, _iq3 BETA, _iq3 S, _iq3 C, _iq3 *D, _iq3 *Q);
+extern void _IQ2park(_iq2 ALPHA, _iq2 BETA, _iq2 S, _iq2 C, _iq2 *D, _iq2 *Q);
+extern void _IQ1park(_iq1 ALPHA, _iq1 BETA, _iq1 S, _iq1 C, _iq1 *D, _iq1 *Q);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the Park transform of global IQ format inputs.
+ *
+ * D = ALPHA * C + BETA * S, Q = BETA * C - ALPHA * S. S and C are the sine
+ * and the cosine of the angle, e.g. from _IQsincos().
+ *
+ * @param ALPHA           Global IQ format alpha component.
+ * @param BETA            Global IQ format beta component.
+ * @param S               Global IQ format sine of the angle.
+ * @param C               Global IQ format cosine of the angle.
+ * @param D               Global IQ format d component.
+ * @param Q               Global IQ format q component.
+ */
+#if GLOBAL_IQ == 30
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ30park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ29park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ28park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ27park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ26park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ25park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ24park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ23park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ22park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ21park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ20park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ19park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ18park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ17park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ16park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ15park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ14park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ13park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ12park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ11park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ10park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ9park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ8park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ7park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ6park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ5park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ4park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ3park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ2park(ALPHA, BETA, S, C, D, Q)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQpark(ALPHA, BETA, S, C, D, Q)_IQ1park(ALPHA, BETA, S, C, D, Q)
+#endif
+
+//*****************************************************************************
+//
+// Computes the inverse Park transform.
+//
+//*****************************************************************************
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+extern void _IQ30ipark(_iq30 D, _iq30 Q, _iq30 S, _iq30 C, _iq30 *ALPHA, _iq30 *BETA);
+extern void _IQ29ipark(_iq29 D, _iq29 Q, _iq29 S, _iq29 C, _iq29 *ALPHA, _iq29 *BETA);
+extern void _IQ28ipark(_iq28 D, _iq28 Q, _iq28 S, _iq28 C, _iq28 *ALPHA, _iq28 *BETA);
+extern void _IQ27ipark(_iq27 D, _iq27 Q, _iq27 S, _iq27 C, _iq27 *ALPHA, _iq27 *BETA);
+extern void _IQ26ipark(_iq26 D, _iq26 Q, _iq26 S, _iq26 C, _iq26 *ALPHA, _iq26 *BETA);
+extern void _IQ25ipark(_iq25 D, _iq25 Q, _iq25 S, _iq25 C, _iq25 *ALPHA, _iq25 *BETA);
+extern void _IQ24ipark(_iq24 D, _iq24 Q, _iq24 S, _iq24 C, _iq24 *ALPHA, _iq24 *BETA);
+extern void _IQ23ipark(_iq23 D, _iq23 Q, _iq23 S, _iq23 C, _iq23 *ALPHA, _iq23 *BETA);
+extern void _IQ22ipark(_iq22 D, _iq22 Q, _iq22 S, _iq22 C, _iq22 *ALPHA, _iq22 *BETA);
+extern void _IQ21ipark(_iq21 D, _iq21 Q, _iq21 S, _iq21 C, _iq21 *ALPHA, _iq21 *BETA);
+extern void _IQ20ipark(_iq20 D, _iq20 Q, _iq20 S, _iq20 C, _iq20 *ALPHA, _iq20 *BETA);
+extern void _IQ19ipark(_iq19 D, _iq19 Q, _iq19 S, _iq19 C, _iq19 *ALPHA, _iq19 *BETA);
+extern void _IQ18ipark(_iq18 D, _iq18 Q, _iq18 S, _iq18 C, _iq18 *ALPHA, _iq18 *BETA);
+extern void _IQ17ipark(_iq17 D, _iq17 Q, _iq17 S, _iq17 C, _iq17 *ALPHA, _iq17 *BETA);
+extern void _IQ16ipark(_iq16 D, _iq16 Q, _iq16 S, _iq16 C, _iq16 *ALPHA, _iq16 *BETA);
+extern void _IQ15ipark(_iq15 D, _iq15 Q, _iq15 S, _iq15 C, _iq15 *ALPHA, _iq15 *BETA);
+extern void _IQ14ipark(_iq14 D, _iq14 Q, _iq14 S, _iq14 C, _iq14 *ALPHA, _iq14 *BETA);
+extern void _IQ13ipark(_iq13 D, _iq13 Q, _iq13 S, _iq13 C, _iq13 *ALPHA, _iq13 *BETA);
+extern void _IQ12ipark(_iq12 D, _iq12 Q, _iq12 S, _iq12 C, _iq12 *ALPHA, _iq12 *BETA);
+extern void _IQ11ipark(_iq11 D, _iq11 Q, _iq11 S, _iq11 C, _iq11 *ALPHA, _iq11 *BETA);
+extern void _IQ10ipark(_iq10 D, _iq10 Q, _iq10 S, _iq10 C, _iq10 *ALPHA, _iq10 *BETA);
+extern void _IQ9ipark(_iq9 D, _iq9 Q, _iq9 S, _iq9 C, _iq9 *ALPHA, _iq9 *BETA);
+extern void _IQ8ipark(_iq8 D, _iq8 Q, _iq8 S, _iq8 C, _iq8 *ALPHA, _iq8 *BETA);
+extern void _IQ7ipark(_iq7 D, _iq7 Q, _iq7 S, _iq7 C, _iq7 *ALPHA, _iq7 *BETA);
+extern void _IQ6ipark(_iq6 D, _iq6 Q, _iq6 S, _iq6 C, _iq6 *ALPHA, _iq6 *BETA);
+extern void _IQ5ipark(_iq5 D, _iq5 Q, _iq5 S, _iq5 C, _iq5 *ALPHA, _iq5 *BETA);
+extern void _IQ4ipark(_iq4 D, _iq4 Q, _iq4 S, _iq4 C, _iq4 *ALPHA, _iq4 *BETA);
+extern void _IQ3ipark(_iq3 D, _iq3 Q, _iq3 S, _iq3 C, _iq3 *ALPHA, _iq3 *BETA);
+extern void _IQ2ipark(_iq2 D, _iq2 Q, _iq2 S, _iq2 C, _iq2 *ALPHA, _iq2 *BETA);
+extern void _IQ1ipark(_iq1 D, _iq1 Q, _iq1 S, _iq1 C, _iq1 *ALPHA, _iq1 *BETA);
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+/**
+ * @brief Computes the inverse Park transform of global IQ format inputs.
+ *
+ * ALPHA = D * C - Q * S, BETA = Q * C + D * S.
+ *
+ * @param D               Global IQ format d component.
+ * @param Q               Global IQ format q component.
+ * @param S               Global IQ format sine of the angle.
+ * @param C               Global IQ format cosine of the angle.
+ * @param ALPHA           Global IQ format alpha component.
+ * @param BETA            Global IQ format beta component.
+ */
+#if GLOBAL_IQ == 30
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ30ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 29
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ29ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 28
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ28ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 27
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ27ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 26
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ26ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 25
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ25ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 24
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ24ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 23
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ23ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 22
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ22ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 21
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ21ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 20
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ20ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 19
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ19ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 18
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ18ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 17
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ17ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 16
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ16ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 15
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ15ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 14
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ14ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 13
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ13ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 12
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ12ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 11
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ11ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 10
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ10ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 9
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ9ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 8
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ8ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 7
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ7ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 6
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ6ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 5
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ5ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 4
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ4ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 3
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ3ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 2
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ2ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+#if GLOBAL_IQ == 1
+#define _IQipark(D, Q, S, C, ALPHA, BETA)_IQ1ipark(D, Q, S, C, ALPHA, BETA)
+#endif
+
 //*****************************************************************************
 //
 // Mark the end of the C bindings section for C++ compilers.
@@ -0,0 +1,512 @@
+/*!****************************************************************************
+ *  @file       IQmathLib.hpp
+ *  @brief      C++ fixed-point type on top of the IQmath library.
+ *
+ *  iqmath::iq<Q> holds an IQ value of a format known at compile time. The
+ *  conversions from and to literals, addition, multiplication and the shifts
+ *  are constexpr and inlined, all the other operations call the _IQN
+ *  functions of IQmathLib.h for the format Q, so the results are bit exact
+ *  with the C API.
+ *
+ *  The header requires C++14 and does not change the C API, C and C++
+ *  sources can share values through iq<Q>::raw() and iq<Q>::from_raw().
+ *
+ *  <hr>
+ ******************************************************************************/
+#ifndef __IQMATHLIB_HPP__
+#define __IQMATHLIB_HPP__
+
+#if !defined(__cplusplus) || __cplusplus < 201402L
+#error "IQmathLib.hpp requires C++14 or newer"
+#endif
+
+#include <stdint.h>
+#include <type_traits>
+#include "IQmathLib.h"
+
+namespace iqmath {
+
+namespace detail {
+
+/*
+ * Bindings of the _IQN functions of a format. Only the formats for which
+ * IQmathLib.h declares a function provide it, using e.g. sin() on an
+ * iq<30> value fails at compile time, like _IQ30sin() which does not exist.
+ */
+template <int Q> struct functions;
+template <int Q> struct trig_functions;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#define IQMATH_DETAIL_FUNCTIONS(N)                                                             \
+    template <> struct functions<N> {                                                          \
+        static int32_t div(int32_t a, int32_t b) { return _IQ##N##div(a, b); }                 \
+        static int32_t rmpy(int32_t a, int32_t b) { return _IQ##N##rmpy(a, b); }               \
+        static int32_t rsmpy(int32_t a, int32_t b) { return _IQ##N##rsmpy(a, b); }             \
+        static int32_t sqrt(int32_t a) { return _IQ##N##sqrt(a); }                             \
+        static int32_t isqrt(int32_t a) { return _IQ##N##isqrt(a); }                           \
+        static int32_t exp(int32_t a) { return _IQ##N##exp(a); }                               \
+        static int32_t log(int32_t a) { return _IQ##N##log(a); }                               \
+        static int32_t frac(int32_t a) { return _IQ##N##frac(a); }                             \
+        static int32_t sinPU(int32_t a) { return _IQ##N##sinPU(a); }                           \
+        static int32_t cosPU(int32_t a) { return _IQ##N##cosPU(a); }                           \
+        static int32_t atan2PU(int32_t a, int32_t b) { return _IQ##N##atan2PU(a, b); }         \
+        static void sincosPU(int32_t a, int32_t *s, int32_t *c) { _IQ##N##sincosPU(a, s, c); } \
+        static float toF(int32_t a) { return _IQ##N##toF(a); }                                 \
+    };
+
+#define IQMATH_DETAIL_TRIG_FUNCTIONS(N)                                                        \
+    template <> struct trig_functions<N> {                                                     \
+        static int32_t sin(int32_t a) { return _IQ##N##sin(a); }                               \
+        static int32_t cos(int32_t a) { return _IQ##N##cos(a); }                               \
+        static int32_t asin(int32_t a) { return _IQ##N##asin(a); }                             \
+        static int32_t atan2(int32_t a, int32_t b) { return _IQ##N##atan2(a, b); }             \
+        static void sincos(int32_t a, int32_t *s, int32_t *c) { _IQ##N##sincos(a, s, c); }     \
+    };
+
+#define IQMATH_DETAIL_ALL_FUNCTIONS(N) \
+    IQMATH_DETAIL_FUNCTIONS(N)         \
+    IQMATH_DETAIL_TRIG_FUNCTIONS(N)
+
+IQMATH_DETAIL_FUNCTIONS(30)
+IQMATH_DETAIL_ALL_FUNCTIONS(29)
+IQMATH_DETAIL_ALL_FUNCTIONS(28)
+IQMATH_DETAIL_ALL_FUNCTIONS(27)
+IQMATH_DETAIL_ALL_FUNCTIONS(26)
+IQMATH_DETAIL_ALL_FUNCTIONS(25)
+IQMATH_DETAIL_ALL_FUNCTIONS(24)
+IQMATH_DETAIL_ALL_FUNCTIONS(23)
+IQMATH_DETAIL_ALL_FUNCTIONS(22)
+IQMATH_DETAIL_ALL_FUNCTIONS(21)
+IQMATH_DETAIL_ALL_FUNCTIONS(20)
+IQMATH_DETAIL_ALL_FUNCTIONS(19)
+IQMATH_DETAIL_ALL_FUNCTIONS(18)
+IQMATH_DETAIL_ALL_FUNCTIONS(17)
+IQMATH_DETAIL_ALL_FUNCTIONS(16)
+IQMATH_DETAIL_ALL_FUNCTIONS(15)
+IQMATH_DETAIL_ALL_FUNCTIONS(14)
+IQMATH_DETAIL_ALL_FUNCTIONS(13)
+IQMATH_DETAIL_ALL_FUNCTIONS(12)
+IQMATH_DETAIL_ALL_FUNCTIONS(11)
+IQMATH_DETAIL_ALL_FUNCTIONS(10)
+IQMATH_DETAIL_ALL_FUNCTIONS(9)
+IQMATH_DETAIL_ALL_FUNCTIONS(8)
+IQMATH_DETAIL_ALL_FUNCTIONS(7)
+IQMATH_DETAIL_ALL_FUNCTIONS(6)
+IQMATH_DETAIL_ALL_FUNCTIONS(5)
+IQMATH_DETAIL_ALL_FUNCTIONS(4)
+IQMATH_DETAIL_ALL_FUNCTIONS(3)
+IQMATH_DETAIL_ALL_FUNCTIONS(2)
+IQMATH_DETAIL_ALL_FUNCTIONS(1)
+
+#undef IQMATH_DETAIL_ALL_FUNCTIONS
+#undef IQMATH_DETAIL_TRIG_FUNCTIONS
+#undef IQMATH_DETAIL_FUNCTIONS
+#endif /* DOXYGEN_SHOULD_SKIP_THIS */
+
+} // namespace detail
+
+/**
+ * @brief IQ value in the format Q, with Q fractional bits.
+ *
+ * The type has the size and the representation of _iqQ, arrays of iq<Q>
+ * may be passed to the array functions through a cast to int32_t *.
+ *
+ * @tparam Q            Number of fractional bits, 1 to 30.
+ */
+template <int Q>
+class iq {
+    static_assert(Q >= 1 && Q <= 30, "IQ formats range from 1 to 30 fractional bits");
+
+public:
+    /** @brief Number of fractional bits of the format. */
+    static constexpr int q = Q;
+
+    /** @brief Zero. */
+    constexpr iq() : m_raw(0) {}
+
+    /**
+     * @brief Converts an integer, like from_int().
+     *
+     * The conversions are explicit, iq<Q>(2) or iq<Q>(0.5) as written by
+     * generic code, e.g. Eigen, never happen implicitly in expressions.
+     *
+     * @param a             Integer value, must fit the integer part of the format.
+     */
+    template <typename T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    explicit constexpr iq(T a) : m_raw(static_cast<int32_t>(static_cast<uint32_t>(a) << Q)) {}
+
+    /**
+     * @brief Converts a floating point value, like from_float().
+     *
+     * @param a             Floating point value, truncated towards zero.
+     */
+    template <typename T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    explicit constexpr iq(T a) : m_raw(static_cast<int32_t>(a * static_cast<T>(static_cast<int32_t>(1) << Q))) {}
+
+    /**
+     * @brief Converts a floating point value at compile time, like _IQN(A).
+     *
+     * @param a             Floating point value, truncated towards zero.
+     *
+     * @return              IQ value of a.
+     */
+    static constexpr iq from_float(double a)
+    {
+        return from_raw(static_cast<int32_t>(a * static_cast<double>(static_cast<int32_t>(1) << Q)));
+    }
+
+    /**
+     * @brief Converts an integer, like _IQN(A) with an integer argument.
+     *
+     * @param a             Integer value, must fit the integer part of the format.
+     *
+     * @return              IQ value of a.
+     */
+    static constexpr iq from_int(int32_t a)
+    {
+        return from_raw(static_cast<int32_t>(static_cast<uint32_t>(a) << Q));
+    }
+
+    /**
+     * @brief Wraps an _iqQ value of the C API.
+     *
+     * @param raw           _iqQ value.
+     *
+     * @return              IQ value with the same representation.
+     */
+    static constexpr iq from_raw(int32_t raw)
+    {
+        iq r;
+        r.m_raw = raw;
+        return r;
+    }
+
+    /** @brief _iqQ value for the C API. */
+    constexpr int32_t raw() const
+    {
+        return m_raw;
+    }
+
+    /** @brief Integer part, rounded towards negative infinity like _IQNint(). */
+    constexpr int32_t to_int() const
+    {
+        return m_raw >> Q;
+    }
+
+    /** @brief Floating point value, like _IQNtoF(). */
+    float to_float() const
+    {
+        return detail::functions<Q>::toF(m_raw);
+    }
+
+    /**
+     * @brief Converts to another format, like _IQNtoIQM().
+     *
+     * Converting to a format with more fractional bits does not check for
+     * overflow.
+     *
+     * @tparam P            Number of fractional bits of the result.
+     */
+    template <int P>
+    constexpr iq<P> to() const
+    {
+        return iq<P>::from_raw(P >= Q ? static_cast<int32_t>(static_cast<uint32_t>(m_raw) << (P >= Q ? P - Q : 0))
+                               : m_raw >> (P < Q ? Q - P : 0));
+    }
+
+    constexpr iq operator+() const
+    {
+        return *this;
+    }
+
+    constexpr iq operator-() const
+    {
+        return from_raw(-m_raw);
+    }
+
+    constexpr iq operator+(iq b) const
+    {
+        return from_raw(m_raw + b.m_raw);
+    }
+
+    constexpr iq operator-(iq b) const
+    {
+        return from_raw(m_raw - b.m_raw);
+    }
+
+    /** @brief Multiplication, truncated like _IQNmpy(). */
+    constexpr iq operator*(iq b) const
+    {
+        return from_raw(static_cast<int32_t>((static_cast<int64_t>(m_raw) * b.m_raw) >> Q));
+    }
+
+    /** @brief Multiplication by an integer, like _IQNmpyI32() without saturation. */
+    constexpr iq operator*(int32_t b) const
+    {
+        return from_raw(m_raw * b);
+    }
+
+    /** @brief Division, with _IQNdiv(). */
+    iq operator/(iq b) const
+    {
+        return from_raw(detail::functions<Q>::div(m_raw, b.m_raw));
+    }
+
+    /** @brief Multiplication by 2^n, like _IQmpy2() and its variants. */
+    constexpr iq operator<<(int n) const
+    {
+        return from_raw(static_cast<int32_t>(static_cast<uint32_t>(m_raw) << n));
+    }
+
+    /** @brief Division by 2^n, rounded towards negative infinity like _IQdiv2() and its variants. */
+    constexpr iq operator>>(int n) const
+    {
+        return from_raw(m_raw >> n);
+    }
+
+    iq &operator+=(iq b)
+    {
+        m_raw += b.m_raw;
+        return *this;
+    }
+
+    iq &operator-=(iq b)
+    {
+        m_raw -= b.m_raw;
+        return *this;
+    }
+
+    iq &operator*=(iq b)
+    {
+        return *this = *this * b;
+    }
+
+    iq &operator*=(int32_t b)
+    {
+        return *this = *this * b;
+    }
+
+    iq &operator/=(iq b)
+    {
+        return *this = *this / b;
+    }
+
+    iq &operator<<=(int n)
+    {
+        return *this = *this << n;
+    }
+
+    iq &operator>>=(int n)
+    {
+        return *this = *this >> n;
+    }
+
+    constexpr bool operator==(iq b) const
+    {
+        return m_raw == b.m_raw;
+    }
+
+    constexpr bool operator!=(iq b) const
+    {
+        return m_raw != b.m_raw;
+    }
+
+    constexpr bool operator<(iq b) const
+    {
+        return m_raw < b.m_raw;
+    }
+
+    constexpr bool operator<=(iq b) const
+    {
+        return m_raw <= b.m_raw;
+    }
+
+    constexpr bool operator>(iq b) const
+    {
+        return m_raw > b.m_raw;
+    }
+
+    constexpr bool operator>=(iq b) const
+    {
+        return m_raw >= b.m_raw;
+    }
+
+private:
+    int32_t m_raw;
+};
+
+template <int Q>
+constexpr iq<Q> operator*(int32_t a, iq<Q> b)
+{
+    return b * a;
+}
+
+/** @brief Multiplication rounded to the nearest value, with _IQNrmpy(). */
+template <int Q>
+inline iq<Q> rmpy(iq<Q> a, iq<Q> b)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::rmpy(a.raw(), b.raw()));
+}
+
+/** @brief Multiplication rounded and saturated, with _IQNrsmpy(). */
+template <int Q>
+inline iq<Q> rsmpy(iq<Q> a, iq<Q> b)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::rsmpy(a.raw(), b.raw()));
+}
+
+/** @brief Absolute value, like _IQabs(). */
+template <int Q>
+constexpr iq<Q> abs(iq<Q> a)
+{
+    return a < iq<Q>() ? -a : a;
+}
+
+/** @brief Saturation of a between lo and hi, like _IQsat(). */
+template <int Q>
+constexpr iq<Q> sat(iq<Q> a, iq<Q> hi, iq<Q> lo)
+{
+    return a > hi ? hi : (a < lo ? lo : a);
+}
+
+/** @brief Fractional part, with _IQNfrac(). */
+template <int Q>
+inline iq<Q> frac(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::frac(a.raw()));
+}
+
+/** @brief Square root, with _IQNsqrt(). */
+template <int Q>
+inline iq<Q> sqrt(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::sqrt(a.raw()));
+}
+
+/** @brief Inverse square root, with _IQNisqrt(). */
+template <int Q>
+inline iq<Q> isqrt(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::isqrt(a.raw()));
+}
+
+/** @brief Magnitude sqrt(a^2 + b^2), with _IQmag(). */
+template <int Q>
+inline iq<Q> mag(iq<Q> a, iq<Q> b)
+{
+    return iq<Q>::from_raw(_IQmag(a.raw(), b.raw()));
+}
+
+/** @brief Base-e exponential, with _IQNexp(). */
+template <int Q>
+inline iq<Q> exp(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::exp(a.raw()));
+}
+
+/** @brief Base-e logarithm, with _IQNlog(). */
+template <int Q>
+inline iq<Q> log(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::log(a.raw()));
+}
+
+/** @brief Sine of an angle in radians, with _IQNsin(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> sin(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::trig_functions<Q>::sin(a.raw()));
+}
+
+/** @brief Cosine of an angle in radians, with _IQNcos(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> cos(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::trig_functions<Q>::cos(a.raw()));
+}
+
+/** @brief Sine and cosine of an angle in radians, with _IQNsincos(). Q must not be larger than 29. */
+template <int Q>
+inline void sincos(iq<Q> a, iq<Q> &s, iq<Q> &c)
+{
+    int32_t s_raw, c_raw;
+    detail::trig_functions<Q>::sincos(a.raw(), &s_raw, &c_raw);
+    s = iq<Q>::from_raw(s_raw);
+    c = iq<Q>::from_raw(c_raw);
+}
+
+/** @brief Arcsine in radians, with _IQNasin(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> asin(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::trig_functions<Q>::asin(a.raw()));
+}
+
+/** @brief Arccosine in radians, like _IQNacos(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> acos(iq<Q> a)
+{
+    return iq<Q>::from_float(1.570796327) - asin(a);
+}
+
+/** @brief Four quadrant arctangent of a / b in radians, with _IQNatan2(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> atan2(iq<Q> a, iq<Q> b)
+{
+    return iq<Q>::from_raw(detail::trig_functions<Q>::atan2(a.raw(), b.raw()));
+}
+
+/** @brief Arctangent in radians, like _IQNatan(). Q must not be larger than 29. */
+template <int Q>
+inline iq<Q> atan(iq<Q> a)
+{
+    return atan2(a, iq<Q>::from_int(1));
+}
+
+/** @brief Sine of an angle in per unit of 2*pi, with _IQNsinPU(). */
+template <int Q>
+inline iq<Q> sinPU(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::sinPU(a.raw()));
+}
+
+/** @brief Cosine of an angle in per unit of 2*pi, with _IQNcosPU(). */
+template <int Q>
+inline iq<Q> cosPU(iq<Q> a)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::cosPU(a.raw()));
+}
+
+/** @brief Four quadrant arctangent of a / b in per unit of 2*pi, with _IQNatan2PU(). */
+template <int Q>
+inline iq<Q> atan2PU(iq<Q> a, iq<Q> b)
+{
+    return iq<Q>::from_raw(detail::functions<Q>::atan2PU(a.raw(), b.raw()));
+}
+
+/** @brief Sine and cosine of an angle in per unit of 2*pi, with _IQNsincosPU(). */
+template <int Q>
+inline void sincosPU(iq<Q> a, iq<Q> &s, iq<Q> &c)
+{
+    int32_t s_raw, c_raw;
+    detail::functions<Q>::sincosPU(a.raw(), &s_raw, &c_raw);
+    s = iq<Q>::from_raw(s_raw);
+    c = iq<Q>::from_raw(c_raw);
+}
+
+namespace literals {
+
+/** @brief Literal of the GLOBAL_IQ format, e.g. 0.5_iq. */
+constexpr iq<GLOBAL_IQ> operator""_iq(long double a)
+{
+    return iq<GLOBAL_IQ>::from_float(static_cast<double>(a));
+}
+
+} // namespace literals
+
+/** @brief Value of the GLOBAL_IQ format, like _iq. */
+using iq_global = iq<GLOBAL_IQ>;
+
+} // namespace iqmath
+
+#endif /* __IQMATHLIB_HPP__ */
@@ -287,4 +287,65 @@ static inline uint_fast64_t __mpyfx_u(uint_fast32_t arg1, uint_fast32_t arg2)
     return (((uint_fast64_t)arg1 * (uint_fast64_t)arg2) << 1);
 }
 
+////////////////////////////////////////////////////////////
+//                                                        //
+//              Bit manipulation functions.               //
+//                                                        //
+////////////////////////////////////////////////////////////
+/*
+ * Count the leading zero bits of a non-zero 32-bit value. Xtensa (NSAU) and
+ * RISC-V with Zbb (CLZ) have an instruction for it. On other RISC-V targets
+ * the builtin is a libgcc call using a table, so use a short binary search
+ * instead, which has no table and can run from IRAM.
+ */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__clz_ul)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+static inline uint_fast8_t __clz_ul(uint_fast32_t arg)
+{
+#if defined(__GNUC__) && (!defined(__riscv) || defined(__riscv_zbb))
+    return (uint_fast8_t)__builtin_clz((uint32_t)arg);
+#else
+    uint32_t ui32Value = (uint32_t)arg;
+    uint_fast8_t ui8Count = 0;
+
+    if (ui32Value < 0x00010000) {
+        ui32Value <<= 16;
+        ui8Count += 16;
+    }
+    if (ui32Value < 0x01000000) {
+        ui32Value <<= 8;
+        ui8Count += 8;
+    }
+    if (ui32Value < 0x10000000) {
+        ui32Value <<= 4;
+        ui8Count += 4;
+    }
+    if (ui32Value < 0x40000000) {
+        ui32Value <<= 2;
+        ui8Count += 2;
+    }
+    if (ui32Value < 0x80000000) {
+        ui8Count += 1;
+    }
+    return ui8Count;
+#endif
+}
+
+/* Count the leading zero bits of a non-zero 64-bit value. */
+#if defined (__TI_COMPILER_VERSION__)
+#pragma FUNC_ALWAYS_INLINE(__clzx_u)
+#elif defined(__IAR_SYSTEMS_ICC__)
+#pragma inline=forced
+#endif
+static inline uint_fast8_t __clzx_u(uint_fast64_t arg)
+{
+    if (arg >> 32) {
+        return __clz_ul((uint_fast32_t)(arg >> 32));
+    }
+    return 32 + __clz_ul((uint_fast32_t)arg);
+}
+
 #endif //__RTS_SUPPORTH__
@@ -0,0 +1,256 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <math.h>
+#include "IQmathLib.h"
+#include "benchmark.h"
+
+/* Designated initializers of the implementations of a function, [Q] = _IQ<Q><name> */
+#define BENCH_Q(name, q)    [q] = _IQ##q##name,
+#define BENCH_Q1_29(name)                                                                       \
+    BENCH_Q(name, 1) BENCH_Q(name, 2) BENCH_Q(name, 3) BENCH_Q(name, 4) BENCH_Q(name, 5)        \
+    BENCH_Q(name, 6) BENCH_Q(name, 7) BENCH_Q(name, 8) BENCH_Q(name, 9) BENCH_Q(name, 10)       \
+    BENCH_Q(name, 11) BENCH_Q(name, 12) BENCH_Q(name, 13) BENCH_Q(name, 14) BENCH_Q(name, 15)   \
+    BENCH_Q(name, 16) BENCH_Q(name, 17) BENCH_Q(name, 18) BENCH_Q(name, 19) BENCH_Q(name, 20)   \
+    BENCH_Q(name, 21) BENCH_Q(name, 22) BENCH_Q(name, 23) BENCH_Q(name, 24) BENCH_Q(name, 25)   \
+    BENCH_Q(name, 26) BENCH_Q(name, 27) BENCH_Q(name, 28) BENCH_Q(name, 29)
+#define BENCH_Q1_30(name)   BENCH_Q1_29(name) BENCH_Q(name, 30)
+
+/* _IQmag does not depend on the format */
+#define BENCH_MAG_Q(q)      [q] = _IQmag,
+#define BENCH_MAG1_30                                                                           \
+    BENCH_MAG_Q(1) BENCH_MAG_Q(2) BENCH_MAG_Q(3) BENCH_MAG_Q(4) BENCH_MAG_Q(5) BENCH_MAG_Q(6)   \
+    BENCH_MAG_Q(7) BENCH_MAG_Q(8) BENCH_MAG_Q(9) BENCH_MAG_Q(10) BENCH_MAG_Q(11) BENCH_MAG_Q(12) \
+    BENCH_MAG_Q(13) BENCH_MAG_Q(14) BENCH_MAG_Q(15) BENCH_MAG_Q(16) BENCH_MAG_Q(17)             \
+    BENCH_MAG_Q(18) BENCH_MAG_Q(19) BENCH_MAG_Q(20) BENCH_MAG_Q(21) BENCH_MAG_Q(22)             \
+    BENCH_MAG_Q(23) BENCH_MAG_Q(24) BENCH_MAG_Q(25) BENCH_MAG_Q(26) BENCH_MAG_Q(27)             \
+    BENCH_MAG_Q(28) BENCH_MAG_Q(29) BENCH_MAG_Q(30)
+
+#define TWO_PI  (2.0 * M_PI)
+
+/* Float equivalents of the operators and of the per-unit functions */
+static float flt_mpy(float a, float b)
+{
+    return a * b;
+}
+
+static float flt_div(float a, float b)
+{
+    return a / b;
+}
+
+static float flt_isqrt(float a)
+{
+    return 1.0f / sqrtf(a);
+}
+
+static float flt_sinpu(float a)
+{
+    return sinf((float)TWO_PI * a);
+}
+
+static float flt_cospu(float a)
+{
+    return cosf((float)TWO_PI * a);
+}
+
+static void flt_sincos(float a, float *s, float *c)
+{
+    *s = sinf(a);
+    *c = cosf(a);
+}
+
+static float flt_atan2pu(float a, float b)
+{
+    return atan2f(a, b) / (float)TWO_PI;
+}
+
+/* Exact results */
+static double ref_mpy(double a, double b, double *second)
+{
+    return a * b;
+}
+
+static double ref_div(double a, double b, double *second)
+{
+    return a / b;
+}
+
+static double ref_sqrt(double a, double b, double *second)
+{
+    return sqrt(a);
+}
+
+static double ref_isqrt(double a, double b, double *second)
+{
+    return 1.0 / sqrt(a);
+}
+
+static double ref_mag(double a, double b, double *second)
+{
+    return hypot(a, b);
+}
+
+static double ref_sin(double a, double b, double *second)
+{
+    return sin(a);
+}
+
+static double ref_cos(double a, double b, double *second)
+{
+    return cos(a);
+}
+
+static double ref_sinpu(double a, double b, double *second)
+{
+    return sin(TWO_PI * a);
+}
+
+static double ref_cospu(double a, double b, double *second)
+{
+    return cos(TWO_PI * a);
+}
+
+static double ref_sincos(double a, double b, double *second)
+{
+    *second = cos(a);
+    return sin(a);
+}
+
+static double ref_asin(double a, double b, double *second)
+{
+    return asin(a);
+}
+
+static double ref_atan2(double a, double b, double *second)
+{
+    return atan2(a, b);
+}
+
+static double ref_atan2pu(double a, double b, double *second)
+{
+    return atan2(a, b) / TWO_PI;
+}
+
+static double ref_exp(double a, double b, double *second)
+{
+    return exp(a);
+}
+
+static double ref_log(double a, double b, double *second)
+{
+    return log(a);
+}
+
+/* Input ranges, max is the largest value of the IQ format */
+static void dom_full(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    *a_lo = *b_lo = -max;
+    *a_hi = *b_hi = max;
+}
+
+static void dom_mpy(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    /* _IQNmpy does not saturate, keep the products in range */
+    dom_full(sqrt(max) * 0.99, a_lo, a_hi, b_lo, b_hi);
+}
+
+static void dom_half(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    dom_full(max / 2, a_lo, a_hi, b_lo, b_hi);
+}
+
+static void dom_positive(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    *a_lo = *b_lo = 0.0;
+    *a_hi = *b_hi = max;
+}
+
+static void dom_unit(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    dom_full(fmin(max, 1.0), a_lo, a_hi, b_lo, b_hi);
+}
+
+static void dom_exp(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi)
+{
+    /* Includes the start of the saturated range */
+    dom_full(max, a_lo, a_hi, b_lo, b_hi);
+    *a_lo = fmax(-max, -30.0);
+    *a_hi = fmin(max, log(max) + 1.0);
+}
+
+const bench_function_t bench_functions[] = {
+    {
+        .name = "mpy", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_30(mpy) },
+        .flt.binary = flt_mpy, .ref = ref_mpy, .domain = dom_mpy,
+    },
+    {
+        .name = "rmpy", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_30(rmpy) },
+        .ref = ref_mpy, .domain = dom_mpy,
+    },
+    {
+        .name = "rsmpy", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_30(rsmpy) },
+        .ref = ref_mpy, .domain = dom_full,
+    },
+    {
+        .name = "div", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_30(div) },
+        .flt.binary = flt_div, .ref = ref_div, .domain = dom_full,
+    },
+    {
+        .name = "sqrt", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(sqrt) },
+        .flt.unary = sqrtf, .ref = ref_sqrt, .domain = dom_positive,
+    },
+    {
+        .name = "isqrt", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(isqrt) },
+        .flt.unary = flt_isqrt, .ref = ref_isqrt, .domain = dom_positive,
+    },
+    {
+        .name = "mag", .kind = BENCH_BINARY, .iq.binary = { BENCH_MAG1_30 },
+        .flt.binary = hypotf, .ref = ref_mag, .domain = dom_half,
+    },
+    {
+        .name = "sin", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_29(sin) },
+        .flt.unary = sinf, .ref = ref_sin, .domain = dom_full,
+    },
+    {
+        .name = "cos", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_29(cos) },
+        .flt.unary = cosf, .ref = ref_cos, .domain = dom_full,
+    },
+    {
+        .name = "sincos", .kind = BENCH_SINCOS, .iq.sincos = { BENCH_Q1_29(sincos) },
+        .flt.sincos = flt_sincos, .ref = ref_sincos, .domain = dom_full,
+    },
+    {
+        .name = "sinPU", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(sinPU) },
+        .flt.unary = flt_sinpu, .ref = ref_sinpu, .domain = dom_full,
+    },
+    {
+        .name = "cosPU", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(cosPU) },
+        .flt.unary = flt_cospu, .ref = ref_cospu, .domain = dom_full,
+    },
+    {
+        .name = "asin", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_29(asin) },
+        .flt.unary = asinf, .ref = ref_asin, .domain = dom_unit,
+    },
+    {
+        .name = "atan2", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_29(atan2) },
+        .flt.binary = atan2f, .ref = ref_atan2, .domain = dom_full,
+    },
+    {
+        .name = "atan2PU", .kind = BENCH_BINARY, .iq.binary = { BENCH_Q1_30(atan2PU) },
+        .flt.binary = flt_atan2pu, .ref = ref_atan2pu, .domain = dom_full,
+    },
+    {
+        .name = "exp", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(exp) },
+        .flt.unary = expf, .ref = ref_exp, .domain = dom_exp,
+    },
+    {
+        .name = "log", .kind = BENCH_UNARY, .iq.unary = { BENCH_Q1_30(log) },
+        .flt.unary = logf, .ref = ref_log, .domain = dom_positive,
+    },
+};
+
+const size_t bench_functions_count = sizeof(bench_functions) / sizeof(bench_functions[0]);
@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Highest number of fractional bits of the IQ formats */
+#define BENCH_Q_MAX     30
+
+typedef enum {
+    BENCH_UNARY,        /* y = f(a) */
+    BENCH_BINARY,       /* y = f(a, b) */
+    BENCH_SINCOS,       /* s, c = f(a) */
+} bench_kind_t;
+
+typedef int32_t (*bench_iq_unary_t)(int32_t a);
+typedef int32_t (*bench_iq_binary_t)(int32_t a, int32_t b);
+typedef void (*bench_iq_sincos_t)(int32_t a, int32_t *s, int32_t *c);
+
+typedef float (*bench_float_unary_t)(float a);
+typedef float (*bench_float_binary_t)(float a, float b);
+typedef void (*bench_float_sincos_t)(float a, float *s, float *c);
+
+/* Function under test, with its implementation for every IQ format and its float equivalent */
+typedef struct {
+    const char *name;
+    bench_kind_t kind;
+    union {
+        bench_iq_unary_t unary[BENCH_Q_MAX + 1];
+        bench_iq_binary_t binary[BENCH_Q_MAX + 1];
+        bench_iq_sincos_t sincos[BENCH_Q_MAX + 1];
+    } iq;                   /* Indexed by the IQ format, NULL for the formats which do not have the function */
+    union {
+        bench_float_unary_t unary;
+        bench_float_binary_t binary;
+        bench_float_sincos_t sincos;
+    } flt;                  /* Float equivalent, NULL if there is none */
+    /* Exact result in double precision, the second result of BENCH_SINCOS is returned in second */
+    double (*ref)(double a, double b, double *second);
+    /* Range of the inputs for the IQ format with the given largest value */
+    void (*domain)(double max, double *a_lo, double *a_hi, double *b_lo, double *b_hi);
+} bench_function_t;
+
+extern const bench_function_t bench_functions[];
+extern const size_t bench_functions_count;
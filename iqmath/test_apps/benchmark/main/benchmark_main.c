@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+#include "esp_cpu.h"
+#include "benchmark.h"
+
+/*
+ * Measures the cost in CPU cycles and the largest error of every IQmath function in every IQ format it exists in,
+ * and of its float equivalent. Every result is printed as one CSV line starting with "IQBENCH,":
+ *
+ *     IQBENCH,<target>,<function>,<format>,<cycles/call>,<max error [ULP]>,<max absolute error>
+ *
+ * The format is the number of fractional bits, or "float" ("float_soft" on targets without FPU). For IQ formats,
+ * one ULP is one LSB of the format. For float results below 1.0, one ULP is the ULP of 1.0. Errors are measured
+ * against the double precision result over a sweep of the input range of the format, results which do not fit the
+ * format are expected to saturate. The float functions are measured with the inputs of the IQ24 sweep.
+ */
+
+/* Number of inputs of the error sweep */
+#define BENCH_SWEEP_POINTS  1024
+/* Number of calls of one timing run, and number of runs of which the fastest is kept */
+#define BENCH_TIMING_CALLS  256
+#define BENCH_TIMING_RUNS   5
+/* IQ format whose inputs are used for the float functions */
+#define BENCH_FLOAT_Q       24
+
+#if SOC_CPU_HAS_FPU
+#define BENCH_FLOAT_NAME    "float"
+#else
+#define BENCH_FLOAT_NAME    "float_soft"
+#endif
+
+static int32_t s_iq_a[BENCH_SWEEP_POINTS], s_iq_b[BENCH_SWEEP_POINTS];
+static int32_t s_iq_y[BENCH_TIMING_CALLS], s_iq_y2[BENCH_TIMING_CALLS];
+static float s_flt_a[BENCH_SWEEP_POINTS], s_flt_b[BENCH_SWEEP_POINTS];
+static float s_flt_y[BENCH_TIMING_CALLS], s_flt_y2[BENCH_TIMING_CALLS];
+
+/* Largest value of the IQ format q */
+static inline double bench_max(int q)
+{
+    return ldexp(1.0, 31 - q);
+}
+
+/* Saturates to the symmetric range, the functions which negate their inputs do not support INT32_MIN */
+static int32_t bench_to_iq(double x, int q)
+{
+    const double raw = nearbyint(ldexp(x, q));
+    return raw >= 2147483647.0 ? INT32_MAX : raw <= -2147483647.0 ? -INT32_MAX : (int32_t)raw;
+}
+
+static void bench_fill_inputs(const bench_function_t *fn, int q)
+{
+    double a_lo, a_hi, b_lo, b_hi;
+
+    fn->domain(bench_max(q), &a_lo, &a_hi, &b_lo, &b_hi);
+    for (int i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        /* b runs through its range in another order, so that the pairs cover the plane */
+        const int j = (i * 601) % BENCH_SWEEP_POINTS;
+        s_iq_a[i] = bench_to_iq(a_lo + (a_hi - a_lo) * i / (BENCH_SWEEP_POINTS - 1), q);
+        s_iq_b[i] = bench_to_iq(b_lo + (b_hi - b_lo) * j / (BENCH_SWEEP_POINTS - 1), q);
+    }
+}
+
+/* Error in ULP of the format q and absolute error of an IQ result, the exact result saturated to the format */
+static void bench_iq_error(int32_t y, double exact, int q, double *ulp, double *abs_err)
+{
+    const double lsb_err = fabs((double)y - fmax(fmin(ldexp(exact, q), 2147483647.0), -2147483648.0));
+    *ulp = fmax(*ulp, lsb_err);
+    *abs_err = fmax(*abs_err, ldexp(lsb_err, -q));
+}
+
+/* Error in ULP of a float result, results below 1.0 use the ULP of 1.0 so that results close to 0 stay meaningful */
+static void bench_float_error(float y, double exact, double *ulp, double *abs_err)
+{
+    const float e = fmaxf(fabsf((float)exact), 1.0f);
+    const double ulp_size = (double)nextafterf(e, INFINITY) - e;
+    *ulp = fmax(*ulp, fabs(y - exact) / ulp_size);
+    *abs_err = fmax(*abs_err, fabs(y - exact));
+}
+
+/* Cycles of the fastest of BENCH_TIMING_RUNS runs of BENCH_TIMING_CALLS calls, divided by the number of calls */
+static uint32_t bench_iq_cycles(const bench_function_t *fn, int q)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (int run = 0; run < BENCH_TIMING_RUNS; run++) {
+        const uint32_t start = esp_cpu_get_cycle_count();
+        switch (fn->kind) {
+        case BENCH_UNARY:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                s_iq_y[i] = fn->iq.unary[q](s_iq_a[i]);
+            }
+            break;
+        case BENCH_BINARY:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                s_iq_y[i] = fn->iq.binary[q](s_iq_a[i], s_iq_b[i]);
+            }
+            break;
+        case BENCH_SINCOS:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                fn->iq.sincos[q](s_iq_a[i], &s_iq_y[i], &s_iq_y2[i]);
+            }
+            break;
+        }
+        const uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        best = cycles < best ? cycles : best;
+    }
+    return best / BENCH_TIMING_CALLS;
+}
+
+static uint32_t bench_float_cycles(const bench_function_t *fn)
+{
+    uint32_t best = UINT32_MAX;
+
+    for (int run = 0; run < BENCH_TIMING_RUNS; run++) {
+        const uint32_t start = esp_cpu_get_cycle_count();
+        switch (fn->kind) {
+        case BENCH_UNARY:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                s_flt_y[i] = fn->flt.unary(s_flt_a[i]);
+            }
+            break;
+        case BENCH_BINARY:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                s_flt_y[i] = fn->flt.binary(s_flt_a[i], s_flt_b[i]);
+            }
+            break;
+        case BENCH_SINCOS:
+            for (int i = 0; i < BENCH_TIMING_CALLS; i++) {
+                fn->flt.sincos(s_flt_a[i], &s_flt_y[i], &s_flt_y2[i]);
+            }
+            break;
+        }
+        const uint32_t cycles = esp_cpu_get_cycle_count() - start;
+        best = cycles < best ? cycles : best;
+    }
+    return best / BENCH_TIMING_CALLS;
+}
+
+static void bench_iq(const bench_function_t *fn, int q)
+{
+    double ulp = 0.0, abs_err = 0.0;
+
+    bench_fill_inputs(fn, q);
+    for (int i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        const double a = ldexp(s_iq_a[i], -q), b = ldexp(s_iq_b[i], -q);
+        double second = 0.0;
+        const double exact = fn->ref(a, b, &second);
+        /* No exact result, e.g. log(0) or a division by 0 */
+        if (!isfinite(exact)) {
+            continue;
+        }
+        switch (fn->kind) {
+        case BENCH_UNARY:
+            bench_iq_error(fn->iq.unary[q](s_iq_a[i]), exact, q, &ulp, &abs_err);
+            break;
+        case BENCH_BINARY:
+            bench_iq_error(fn->iq.binary[q](s_iq_a[i], s_iq_b[i]), exact, q, &ulp, &abs_err);
+            break;
+        case BENCH_SINCOS: {
+            int32_t s, c;
+            fn->iq.sincos[q](s_iq_a[i], &s, &c);
+            bench_iq_error(s, exact, q, &ulp, &abs_err);
+            bench_iq_error(c, second, q, &ulp, &abs_err);
+            break;
+        }
+        }
+    }
+    printf("IQBENCH,%s,%s,%d,%u,%.1f,%.3g\n", CONFIG_IDF_TARGET, fn->name, q, (unsigned)bench_iq_cycles(fn, q), ulp,
+           abs_err);
+}
+
+static void bench_float(const bench_function_t *fn)
+{
+    double ulp = 0.0, abs_err = 0.0;
+
+    bench_fill_inputs(fn, BENCH_FLOAT_Q);
+    for (int i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        s_flt_a[i] = (float)ldexp(s_iq_a[i], -BENCH_FLOAT_Q);
+        s_flt_b[i] = (float)ldexp(s_iq_b[i], -BENCH_FLOAT_Q);
+    }
+    for (int i = 0; i < BENCH_SWEEP_POINTS; i++) {
+        double second = 0.0;
+        const double exact = fn->ref(s_flt_a[i], s_flt_b[i], &second);
+        if (!isfinite(exact)) {
+            continue;
+        }
+        switch (fn->kind) {
+        case BENCH_UNARY:
+            bench_float_error(fn->flt.unary(s_flt_a[i]), exact, &ulp, &abs_err);
+            break;
+        case BENCH_BINARY:
+            bench_float_error(fn->flt.binary(s_flt_a[i], s_flt_b[i]), exact, &ulp, &abs_err);
+            break;
+        case BENCH_SINCOS: {
+            float s, c;
+            fn->flt.sincos(s_flt_a[i], &s, &c);
+            bench_float_error(s, exact, &ulp, &abs_err);
+            bench_float_error(c, second, &ulp, &abs_err);
+            break;
+        }
+        }
+    }
+    printf("IQBENCH,%s,%s,%s,%u,%.1f,%.3g\n", CONFIG_IDF_TARGET, fn->name, BENCH_FLOAT_NAME,
+           (unsigned)bench_float_cycles(fn), ulp, abs_err);
+}
+
+void app_main(void)
+{
+    printf("IQBENCH,target,function,format,cycles,max_err_ulp,max_abs_err\n");
+    for (size_t f = 0; f < bench_functions_count; f++) {
+        const bench_function_t *fn = &bench_functions[f];
+        for (int q = 1; q <= BENCH_Q_MAX; q++) {
+            if (fn->iq.unary[q] != NULL) {
+                bench_iq(fn, q);
+            }
+        }
+        if (fn->flt.unary != NULL) {
+            bench_float(fn);
+        }
+    }
+    printf("Benchmark done\n");
+}
@@ -0,0 +1,10 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Unlicense OR CC0-1.0
+
+import pytest
+
+
+@pytest.mark.generic
+def test_iqmath_benchmark(dut) -> None:
+    dut.expect_exact('IQBENCH,target,function,format,cycles,max_err_ulp,max_abs_err', timeout=30)
+    dut.expect_exact('Benchmark done', timeout=600)
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include "unity.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "IQmathLib.h"
 
 #define ERROR_WITHIN_TOLERANCE(result, expected, tolerance) \
@@ -74,6 +75,17 @@ TEST_CASE("Test IQmath mathematical functions", "[iqmath]")
     res = _IQtoF(qC);
     ESP_LOGI(TAG, "cos(pi/4) = %f", res);
     TEST_ASSERT(ERROR_WITHIN_TOLERANCE(res, 0.707106781, error_tolerance));
+
+    // Test atan2 of inputs with the same magnitude, the ratio of the inputs is 1.0
+    qC = _IQatan2(qA, qA);
+    res = _IQtoF(qC);
+    ESP_LOGI(TAG, "atan2(pi/4, pi/4) = %f", res);
+    TEST_ASSERT(ERROR_WITHIN_TOLERANCE(res, 0.785398163, error_tolerance));
+
+    qC = _IQatan2(-qA, -qA);
+    res = _IQtoF(qC);
+    ESP_LOGI(TAG, "atan2(-pi/4, -pi/4) = %f", res);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, -2.35619449, res);
 }
 
 TEST_CASE("Test IQ8 type operations", "[iqmath]")
@@ -117,4 +129,167 @@ TEST_CASE("Test IQ conversion and saturation", "[iqmath]")
     res = _IQtoF(qC);
     ESP_LOGI(TAG, "IQ saturation test: %f", res);
     TEST_ASSERT(ERROR_WITHIN_TOLERANCE(res, 16.0, error_tolerance));
-}
\ No newline at end of file
+
+    // Test division by and of the most negative value
+    TEST_ASSERT_EQUAL_INT32(_IQ24(-1.0 / 128.0), _IQ24div(_IQ24(1.0), INT32_MIN));
+    TEST_ASSERT_INT32_WITHIN(1, _IQ24(-64.0), _IQ24div(INT32_MIN, _IQ24(2.0)));
+    TEST_ASSERT_EQUAL_INT32(_IQ24(1.0), _IQ24div(INT32_MIN, INT32_MIN));
+}
+
+TEST_CASE("Test IQ string conversions", "[iqmath]")
+{
+    char str[24];
+
+    TEST_ASSERT_EQUAL(6, _IQ24toa_fixed(str, _IQ24(3.14159), 4));
+    TEST_ASSERT_EQUAL_STRING("3.1416", str);
+    TEST_ASSERT_EQUAL(5, _IQ24toa_fixed(str, _IQ24(-2.5), 2));
+    TEST_ASSERT_EQUAL_STRING("-2.50", str);
+    TEST_ASSERT_EQUAL(3, _IQ24toa_fixed(str, _IQ24(99.96), 0));
+    TEST_ASSERT_EQUAL_STRING("100", str);
+    // No sign when the value rounds to zero
+    TEST_ASSERT_EQUAL(4, _IQ24toa_fixed(str, _IQ24(-0.001), 2));
+    TEST_ASSERT_EQUAL_STRING("0.00", str);
+    TEST_ASSERT_EQUAL(13, _IQ1toa_fixed(str, INT32_MIN, 1));
+    TEST_ASSERT_EQUAL_STRING("-1073741824.0", str);
+    TEST_ASSERT_EQUAL(-1, _IQ24toa_fixed(str, _IQ24(1.0), 10));
+
+    TEST_ASSERT_EQUAL_INT32(_IQ24(3.14159), _atoIQ24("3.14159"));
+    TEST_ASSERT_EQUAL_INT32(_IQ24(-105.0), _atoIQ24("-105"));
+    TEST_ASSERT_EQUAL_INT32(_IQ24(-0.5), _atoIQ24("-0.5000000000001"));
+    TEST_ASSERT_EQUAL_INT32(0x7fffffff, _atoIQ24("200"));
+    TEST_ASSERT_EQUAL_INT32(0, _atoIQ24("1.2x"));
+
+    // Round trip with enough decimals for the resolution of the format
+    for (int32_t val = -0x7f000000; val < 0x7f000000; val += 0x00fedcba) {
+        _IQ24toa_fixed(str, val, 8);
+        TEST_ASSERT_INT32_WITHIN(1, val, _atoIQ24(str));
+    }
+}
+
+#define ARRAY_TEST_LEN      256
+#define ARRAY_TEST_LOOPS    100
+
+TEST_CASE("Test IQmath array functions", "[iqmath]")
+{
+    static _iq24 a[ARRAY_TEST_LEN], b[ARRAY_TEST_LEN], y[ARRAY_TEST_LEN], ref[ARRAY_TEST_LEN];
+    int64_t start, scalar_us, array_us;
+
+    for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+        a[i] = _IQ24(-3.0 + 6.0 * i / ARRAY_TEST_LEN);
+        b[i] = _IQ24(0.5 + 0.01 * i);
+    }
+
+    /* The array functions must give the same results as the scalar ones */
+    _IQ24mpy_v(a, b, y, ARRAY_TEST_LEN);
+    for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT32(_IQ24mpy(a[i], b[i]), y[i]);
+    }
+    _IQ24sin_v(a, y, ARRAY_TEST_LEN);
+    for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT32(_IQ24sin(a[i]), y[i]);
+    }
+    _IQ24sqrt_v(b, y, ARRAY_TEST_LEN);
+    for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT32(_IQ24sqrt(b[i]), y[i]);
+    }
+    _IQ24mag_v(a, b, y, ARRAY_TEST_LEN);
+    for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+        TEST_ASSERT_EQUAL_INT32(_IQ24mag(a[i], b[i]), y[i]);
+    }
+
+    /* Throughput against the scalar loop */
+    start = esp_timer_get_time();
+    for (int n = 0; n < ARRAY_TEST_LOOPS; n++) {
+        for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+            ref[i] = _IQ24mpy(a[i], b[i]);
+        }
+    }
+    scalar_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int n = 0; n < ARRAY_TEST_LOOPS; n++) {
+        _IQ24mpy_v(a, b, y, ARRAY_TEST_LEN);
+    }
+    array_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "mpy of %d values: scalar loop %d us, array %d us", ARRAY_TEST_LEN,
+             (int)(scalar_us / ARRAY_TEST_LOOPS), (int)(array_us / ARRAY_TEST_LOOPS));
+
+    start = esp_timer_get_time();
+    for (int n = 0; n < ARRAY_TEST_LOOPS; n++) {
+        for (int i = 0; i < ARRAY_TEST_LEN; i++) {
+            ref[i] = _IQ24sin(a[i]);
+        }
+    }
+    scalar_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int n = 0; n < ARRAY_TEST_LOOPS; n++) {
+        _IQ24sin_v(a, y, ARRAY_TEST_LEN);
+    }
+    array_us = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "sin of %d values: scalar loop %d us, array %d us", ARRAY_TEST_LEN,
+             (int)(scalar_us / ARRAY_TEST_LOOPS), (int)(array_us / ARRAY_TEST_LOOPS));
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref, y, ARRAY_TEST_LEN);
+}
+
+TEST_CASE("Test IQmath sincos and Park/Clarke transforms", "[iqmath]")
+{
+    const float error_tolerance = 0.001;
+    _iq24 s, c, alpha, beta, d, q, alpha2, beta2;
+
+    /* sincos must give the same results as sin and cos */
+    for (int i = -400; i <= 400; i++) {
+        const _iq24 angle = _IQ24(0.0251 * i);
+        _IQ24sincos(angle, &s, &c);
+        TEST_ASSERT_EQUAL_INT32(_IQ24sin(angle), s);
+        TEST_ASSERT_EQUAL_INT32(_IQ24cos(angle), c);
+        _IQ24sincosPU(angle, &s, &c);
+        TEST_ASSERT_EQUAL_INT32(_IQ24sinPU(angle), s);
+        TEST_ASSERT_EQUAL_INT32(_IQ24cosPU(angle), c);
+    }
+
+    /* Balanced currents at 30 degrees: 10 A amplitude gives d = 10 A, q = 0 */
+    const float theta = M_PI / 6;
+    const _iq24 ia = _IQ24(10.0 * cosf(theta));
+    const _iq24 ib = _IQ24(10.0 * cosf(theta - 2 * M_PI / 3));
+    _IQ24clarke(ia, ib, &alpha, &beta);
+    TEST_ASSERT(ERROR_WITHIN_TOLERANCE(_IQ24toF(beta), 10.0 * sinf(theta), error_tolerance));
+
+    _IQ24sincos(_IQ24(theta), &s, &c);
+    _IQ24park(alpha, beta, s, c, &d, &q);
+    ESP_LOGI(TAG, "Park transform: d = %f, q = %f", _IQ24toF(d), _IQ24toF(q));
+    TEST_ASSERT(ERROR_WITHIN_TOLERANCE(_IQ24toF(d), 10.0, error_tolerance));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.0, _IQ24toF(q));
+
+    /* The inverse transform gives the input back */
+    _IQ24ipark(d, q, s, c, &alpha2, &beta2);
+    TEST_ASSERT_INT32_WITHIN(_IQ24(0.0001), alpha, alpha2);
+    TEST_ASSERT_INT32_WITHIN(_IQ24(0.0001), beta, beta2);
+}
+
+#if CONFIG_IQMATH_MPY_DIV_IN_RAM && CONFIG_IQMATH_TRIG_IN_RAM && \
+    (CONFIG_IQMATH_RAM_ALL_FORMATS || CONFIG_IQMATH_RAM_FORMAT == 24)
+#include "esp_attr.h"
+#include "esp_private/cache_utils.h"
+
+static IRAM_ATTR void iqmath_ram_functions(const _iq24 *in, _iq24 *out)
+{
+    out[0] = _IQ24mpy(in[0], in[1]);
+    out[1] = _IQ24div(in[0], in[1]);
+    out[2] = _IQ24sin(in[0]);
+    out[3] = _IQ24cosPU(in[1]);
+    out[4] = _IQ24atan2(in[0], in[1]);
+}
+
+TEST_CASE("Test IQmath functions in RAM with the flash cache disabled", "[iqmath]")
+{
+    const _iq24 in[2] = { _IQ24(0.7), _IQ24(-1.3) };
+    _iq24 out[5], ref[5];
+
+    /* This would crash if a function or a table it reads were still in flash */
+    spi_flash_disable_interrupts_caches_and_other_cpu();
+    iqmath_ram_functions(in, out);
+    spi_flash_enable_interrupts_caches_and_other_cpu();
+
+    iqmath_ram_functions(in, ref);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(ref, out, 5);
+}
+#endif
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "unity.h"
+#include "IQmathLib.hpp"
+
+using iqmath::iq;
+using namespace iqmath::literals;
+
+/* Conversions and the inlined operators are evaluated at compile time */
+static_assert(iq<24>::from_float(1.5).raw() == _IQ24(1.5), "from_float must match _IQN()");
+static_assert(iq<30>::from_float(-0.25).raw() == _IQ30(-0.25), "from_float must match _IQN()");
+static_assert((iq<16>::from_float(1.5) * iq<16>::from_float(2.5)).raw() == _IQ16(3.75), "inlined multiplication");
+static_assert((iq<8>::from_int(3) >> 1).raw() == _IQ8(1.5), "shift");
+static_assert(iq<24>::from_float(2.0).to<12>().raw() == _IQ12(2.0), "format conversion");
+static_assert((0.5_iq).raw() == _IQ(0.5), "GLOBAL_IQ literal");
+static_assert(sizeof(iq<24>) == sizeof(_iq24), "iq<Q> must have the size of _iqQ");
+
+TEST_CASE("Test IQmath C++ type", "[iqmath]")
+{
+    volatile int32_t a_raw = _IQ20(1.75), b_raw = _IQ20(-0.6);
+    const iq<20> a = iq<20>::from_raw(a_raw), b = iq<20>::from_raw(b_raw);
+
+    /* Every operation must be bit exact with the C API for the same format */
+    TEST_ASSERT_EQUAL_INT32(_IQ20mpy(a_raw, b_raw), (a * b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20div(a_raw, b_raw), (a / b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20rmpy(a_raw, b_raw), rmpy(a, b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20sqrt(a_raw), sqrt(a).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20sin(b_raw), sin(b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20cosPU(b_raw), cosPU(b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20atan2(a_raw, b_raw), atan2(a, b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20exp(b_raw), exp(b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20log(a_raw), log(a).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQmag(a_raw, b_raw), mag(a, b).raw());
+    TEST_ASSERT_EQUAL_INT32(_IQ20abs(b_raw), abs(b).raw());
+    TEST_ASSERT_EQUAL_FLOAT(_IQ20toF(a_raw), a.to_float());
+
+    iq<20> acc;
+    acc += a;
+    acc *= b;
+    acc -= a;
+    TEST_ASSERT_EQUAL_INT32(_IQ20mpy(a_raw, b_raw) - a_raw, acc.raw());
+    TEST_ASSERT_TRUE(b < a);
+}
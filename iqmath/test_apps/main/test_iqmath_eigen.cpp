@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include "unity.h"
+#include "IQmathEigen.hpp"
+#include <eigen3/Eigen/LU>
+#include <eigen3/Eigen/SVD>
+
+using iqmath::iq;
+
+using Matrix3q = Eigen::Matrix<iq<24>, 3, 3>;
+using MatrixXq = Eigen::Matrix<iq<24>, Eigen::Dynamic, Eigen::Dynamic>;
+
+static const float s_matrix[9] = {
+    1.0f, 0.3f, 0.4f,
+    0.5f, 2.0f, 0.2f,
+    0.2f, 0.1f, 1.5f,
+};
+
+TEST_CASE("Test IQmath Eigen products", "[iqmath]")
+{
+    const Eigen::Matrix3f a = Eigen::Map<const Eigen::Matrix3f>(s_matrix);
+    const Matrix3q aq = a.cast<iq<24>>();
+    const Eigen::Vector3f x(0.25f, -1.5f, 0.75f);
+    const Eigen::Matrix<iq<24>, 3, 1> xq = x.cast<iq<24>>();
+
+    /* The products are sums of _IQNmpy() */
+    const Eigen::Matrix<iq<24>, 3, 1> yq = aq * xq;
+    for (int i = 0; i < 3; i++) {
+        int32_t y = 0;
+        for (int j = 0; j < 3; j++) {
+            y += _IQ24mpy(aq(i, j).raw(), xq(j).raw());
+        }
+        TEST_ASSERT_EQUAL_INT32(y, yq(i).raw());
+    }
+
+    /* Decompositions need the NumTraits of iq<Q> */
+    const Matrix3q identity = aq.inverse() * aq;
+    TEST_ASSERT_TRUE(identity.isApprox(Matrix3q::Identity()));
+    const Eigen::Matrix<iq<24>, 3, 1> solution = aq.lu().solve(yq);
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 0.0f, (solution.cast<float>() - x).cwiseAbs().maxCoeff());
+}
+
+TEST_CASE("Test IQmath Eigen SVD", "[iqmath]")
+{
+    const Eigen::Matrix3f a = Eigen::Map<const Eigen::Matrix3f>(s_matrix);
+    const MatrixXq aq = a.cast<iq<24>>();
+
+    Eigen::JacobiSVD<MatrixXq> svd(aq, Eigen::ComputeThinU | Eigen::ComputeThinV);
+    Eigen::JacobiSVD<Eigen::MatrixXf> svd_float(a);
+    const MatrixXq product = svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().transpose();
+
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, (product - aq).cast<float>().cwiseAbs().maxCoeff());
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.0f, (svd.singularValues().cast<float>() - svd_float.singularValues())
+                             .cwiseAbs().maxCoeff());
+}
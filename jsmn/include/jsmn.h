@@ -131,6 +131,73 @@ static void jsmn_fill_token(jsmntok_t *token, const jsmntype_t type,
     token->size = 0;
 }
 
+#if defined(JSMN_FAST_SCAN) && defined(__GNUC__)
+/*
+ * Word at a time scanning. The JSON string is read one aligned machine word
+ * at a time, looking for the bytes which end the run with SWAR bit tricks.
+ */
+typedef size_t __attribute__((__may_alias__)) jsmn_word_t;
+
+#define JSMN_WORD_ONES ((size_t)-1 / 0xff)
+#define JSMN_WORD_HIGHS (JSMN_WORD_ONES * 0x80)
+/* Non zero if a byte of w is zero */
+#define JSMN_WORD_HAS_ZERO(w) (((w) - JSMN_WORD_ONES) & ~(w) & JSMN_WORD_HIGHS)
+/* Non zero if a byte of w is equal to c */
+#define JSMN_WORD_HAS_BYTE(w, c) JSMN_WORD_HAS_ZERO((w) ^ (JSMN_WORD_ONES * (c)))
+
+#define JSMN_IS_STRING_END(c) ((c) == '\"' || (c) == '\\' || (c) == '\0')
+
+/**
+ * Returns the position of the first quote, backslash or NULL character from
+ * pos, or len.
+ */
+static unsigned int jsmn_scan_string(const char *js, unsigned int pos,
+                                     const size_t len)
+{
+    for (; pos < len && ((size_t)(js + pos) & (sizeof(jsmn_word_t) - 1)); pos++) {
+        if (JSMN_IS_STRING_END(js[pos])) {
+            return pos;
+        }
+    }
+    for (; pos + sizeof(jsmn_word_t) <= len; pos += sizeof(jsmn_word_t)) {
+        jsmn_word_t w = *(const jsmn_word_t *)(js + pos);
+        if (JSMN_WORD_HAS_ZERO(w) | JSMN_WORD_HAS_BYTE(w, '\"') |
+                JSMN_WORD_HAS_BYTE(w, '\\')) {
+            break;
+        }
+    }
+    for (; pos < len; pos++) {
+        if (JSMN_IS_STRING_END(js[pos])) {
+            return pos;
+        }
+    }
+    return pos;
+}
+
+/**
+ * Returns the position of the first character other than a space from pos,
+ * or len. Runs of spaces are the indentation of pretty printed JSON.
+ */
+static unsigned int jsmn_skip_spaces(const char *js, unsigned int pos,
+                                     const size_t len)
+{
+    for (; pos < len && ((size_t)(js + pos) & (sizeof(jsmn_word_t) - 1)); pos++) {
+        if (js[pos] != ' ') {
+            return pos;
+        }
+    }
+    for (; pos + sizeof(jsmn_word_t) <= len; pos += sizeof(jsmn_word_t)) {
+        if (*(const jsmn_word_t *)(js + pos) != JSMN_WORD_ONES * ' ') {
+            break;
+        }
+    }
+    for (; pos < len && js[pos] == ' '; pos++) {
+    }
+    return pos;
+}
+#define JSMN_USE_FAST_SCAN
+#endif
+
 /**
  * Fills next available token with JSON primitive.
  */
@@ -205,7 +272,15 @@ static int jsmn_parse_string(jsmn_parser *parser, const char *js,
     parser->pos++;
 
     for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
-        char c = js[parser->pos];
+        char c;
+
+#ifdef JSMN_USE_FAST_SCAN
+        parser->pos = jsmn_scan_string(js, parser->pos, len);
+        if (parser->pos >= len || js[parser->pos] == '\0') {
+            break;
+        }
+#endif
+        c = js[parser->pos];
 
         /* Quote: end of string */
         if (c == '\"') {
@@ -377,6 +452,9 @@ JSMN_API int jsmn_parse(jsmn_parser *parser, const char *js, const size_t len,
         case '\r':
         case '\n':
         case ' ':
+#ifdef JSMN_USE_FAST_SCAN
+            parser->pos = jsmn_skip_spaces(js, parser->pos + 1, len) - 1;
+#endif
             break;
         case ':':
             parser->toksuper = parser->toknext - 1;
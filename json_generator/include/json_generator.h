@@ -50,6 +50,33 @@ extern "C"
  */
 typedef void (*json_gen_flush_cb_t) (char *buf, void *priv);
 
+/** Piece of the JSON string passed to the sink callback */
+typedef struct {
+    /** Pointer to the data. Not NULL terminated */
+    const char *base;
+    /** Length of the data */
+    int len;
+} json_gen_iovec_t;
+
+/** JSON string sink callback prototype
+ *
+ * This is a prototype of the function that needs to be passed to
+ * json_gen_str_start_sink(). Like writev(), it receives the pieces of the
+ * JSON string to be output, in order. The first piece is the content of the
+ * buffer, the second one, if any, is a value which did not fit in the buffer
+ * and which is passed directly from the memory of the caller, without copy.
+ *
+ * \param[in] iov Array of pieces to output
+ * \param[in] iovcnt Number of pieces in the array, 1 or 2
+ * \param[in] priv Private data. Will be the same as the one passed to
+ * json_gen_str_start_sink()
+ *
+ * \return 0 on Success
+ * \return Any other value on failure, which is then returned as -1 by the
+ * API which triggered the callback
+ */
+typedef int (*json_gen_sink_cb_t) (const json_gen_iovec_t *iov, int iovcnt, void *priv);
+
 /** JSON String structure
  *
  * Please do not set/modify any elements.
@@ -70,6 +97,8 @@ typedef struct {
     char *free_ptr;
     /** Total length */
     int total_len;
+    /** (Optional) sink callback set by json_gen_str_start_sink() */
+    json_gen_sink_cb_t sink_cb;
 } json_gen_str_t;
 
 /** Start a JSON String
@@ -93,6 +122,27 @@ typedef struct {
 void json_gen_str_start(json_gen_str_t *jstr, char *buf, int buf_size,
                         json_gen_flush_cb_t flush_cb, void *priv);
 
+/** Start a JSON String with a sink callback
+ *
+ * This is an alternative to json_gen_str_start() for output to a socket,
+ * a file, etc. Small values are gathered in the buffer as usual. When a value
+ * does not fit in the remaining space, the content of the buffer and the value
+ * itself are passed together to the sink callback, so that large strings are
+ * never copied and each output operation is at least as large as the buffer.
+ * json_gen_str_end() passes the remaining content of the buffer.
+ *
+ * \param[out] jstr Pointer to an allocated \ref json_gen_str_t structure.
+ * This will be initialised internally and needs to be passed to all
+ * subsequent function calls
+ * \param[out] buf Pointer to an allocated buffer in which the JSON
+ * string will be gathered
+ * \param[in] buf_size Size of the buffer
+ * \param[in] sink_cb Pointer to the sink function of type \ref json_gen_sink_cb_t
+ * \param[in] priv Private data to be passed to the sink function callback.
+ */
+void json_gen_str_start_sink(json_gen_str_t *jstr, char *buf, int buf_size,
+                             json_gen_sink_cb_t sink_cb, void *priv);
+
 /** End JSON string
  *
  * This should be the last function to be called after the entire JSON string
@@ -505,6 +555,96 @@ int json_gen_add_to_long_string(json_gen_str_t *jstr, const char *val);
  * added after that
  */
 int json_gen_end_long_string(json_gen_str_t *jstr);
+
+/** Type of a value slot of a JSON template */
+typedef enum {
+    /** No value, for the trailing segment of the template and segments ending with a "%%" */
+    JSON_GEN_TMPL_END,
+    /** Integer, "%d" in the shape */
+    JSON_GEN_TMPL_INT,
+    /** Float, "%f" in the shape */
+    JSON_GEN_TMPL_FLOAT,
+    /** Boolean, "%b" in the shape */
+    JSON_GEN_TMPL_BOOL,
+    /** String, added with quotes, "%s" in the shape */
+    JSON_GEN_TMPL_STRING,
+    /** Pre-formatted JSON, added as is, "%j" in the shape */
+    JSON_GEN_TMPL_RAW,
+} json_gen_tmpl_type_t;
+
+/** Part of a compiled JSON template: a constant segment followed by a value slot */
+typedef struct {
+    /** Pointer to the segment, inside the shape string. Not NULL terminated */
+    const char *seg;
+    /** Length of the segment */
+    int seg_len;
+    /** Type of the value following the segment */
+    json_gen_tmpl_type_t type;
+} json_gen_tmpl_part_t;
+
+/** Compiled JSON template
+ *
+ * Please do not set/modify any elements.
+ * Just define this structure and pass a pointer to it in the APIs below
+ */
+typedef struct {
+    /** Parts provided by the calling function */
+    json_gen_tmpl_part_t *parts;
+    /** Number of parts used, including the trailing segment */
+    int num_parts;
+} json_gen_tmpl_t;
+
+/** Value of a slot of a JSON template, of the type of the slot */
+typedef union {
+    int i;
+    float f;
+    bool b;
+    /** For JSON_GEN_TMPL_STRING and JSON_GEN_TMPL_RAW */
+    const char *s;
+} json_gen_tmpl_val_t;
+
+/** Compile a JSON template
+ *
+ * This splits the shape of a JSON string that is generated repeatedly with
+ * different values into its constant segments and its value slots, once,
+ * so that json_gen_tmpl_render() only has to add the segments as they are
+ * and to format the values.
+ *
+ * The shape is the JSON string with the values replaced by "%d", "%f", "%b",
+ * "%s" or "%j", and "%%" for a literal '%'. Eg.
+ * "{\"temp\":%f,\"hum\":%d,\"loc\":{\"name\":%s}}"
+ * The shape is not copied and should remain valid as long as the template is used.
+ *
+ * \param[out] tmpl Pointer to an allocated \ref json_gen_tmpl_t structure
+ * \param[in] shape The shape of the JSON string
+ * \param[out] parts Array in which the template is compiled. It needs one part
+ * per value slot, plus one, and one more per "%%".
+ * \param[in] max_parts Number of elements in the parts array
+ *
+ * \return Number of value slots on Success
+ * \return -1 if the shape has an invalid placeholder or the parts array is too small
+ */
+int json_gen_tmpl_compile(json_gen_tmpl_t *tmpl, const char *shape,
+                          json_gen_tmpl_part_t *parts, int max_parts);
+
+/** Render a JSON template
+ *
+ * This adds the JSON string described by a compiled template, with the
+ * values given. A comma is added before it if required, so that a template
+ * can also be rendered as an element of an array, or repeatedly.
+ *
+ * \param[in] jstr Pointer to the \ref json_gen_str_t structure initialised by
+ * json_gen_str_start()
+ * \param[in] tmpl Pointer to the template compiled by json_gen_tmpl_compile()
+ * \param[in] vals Values of the slots, in the order of the shape
+ *
+ * \return 0 on Success
+ * \return -1 if buffer is out of space (possible only if no callback function
+ * is passed to json_gen_str_start(). Else, buffer will be flushed out and new data
+ * added after that
+ */
+int json_gen_tmpl_render(json_gen_str_t *jstr, const json_gen_tmpl_t *tmpl,
+                         const json_gen_tmpl_val_t *vals);
 #ifdef __cplusplus
 }
 #endif
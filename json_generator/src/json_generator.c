@@ -29,21 +29,47 @@ static inline int json_gen_get_empty_len(json_gen_str_t *jstr)
     return (jstr->buf_size - (jstr->free_ptr - jstr->buf) - 1);
 }
 
+/* Passes the content of the buffer, followed by the data if any, to the sink
+ * callback and empties the buffer
+ */
+static int json_gen_sink(json_gen_str_t *jstr, const char *data, int len)
+{
+    json_gen_iovec_t iov[2];
+    int iovcnt = 0;
+    if (jstr->free_ptr != jstr->buf) {
+        iov[iovcnt].base = jstr->buf;
+        iov[iovcnt].len = jstr->free_ptr - jstr->buf;
+        iovcnt++;
+    }
+    if (len) {
+        iov[iovcnt].base = data;
+        iov[iovcnt].len = len;
+        iovcnt++;
+    }
+    jstr->free_ptr = jstr->buf;
+    if (iovcnt == 0) {
+        return 0;
+    }
+    return jstr->sink_cb(iov, iovcnt, jstr->priv) == 0 ? 0 : -1;
+}
+
 /* This will add the incoming string to the JSON string buffer
  * and flush it out if the buffer is full. Note that the data being
  * flushed out will always be equal to the size of the buffer unless
  * this is the last chunk being flushed out on json_gen_end_str()
  */
-static int json_gen_add_to_str(json_gen_str_t *jstr, const char *str)
+static int json_gen_add_to_str_len(json_gen_str_t *jstr, const char *str, int len)
 {
-    if (!str) {
-        return 0;
-    }
-    int len = strlen(str);
     jstr->total_len += len;
     if (jstr->buf == NULL) {
         return 0;
     }
+    /* With a sink, data which does not fit is output along with the buffer,
+     * straight from the memory of the caller
+     */
+    if (jstr->sink_cb && len > json_gen_get_empty_len(jstr)) {
+        return json_gen_sink(jstr, str, len);
+    }
     const char *cur_ptr = str;
     while (1) {
         int len_remaining = json_gen_get_empty_len(jstr);
@@ -69,6 +95,13 @@ static int json_gen_add_to_str(json_gen_str_t *jstr, const char *str)
     return 0;
 }
 
+static int json_gen_add_to_str(json_gen_str_t *jstr, const char *str)
+{
+    if (!str) {
+        return 0;
+    }
+    return json_gen_add_to_str_len(jstr, str, strlen(str));
+}
 
 void json_gen_str_start(json_gen_str_t *jstr, char *buf, int buf_size,
                         json_gen_flush_cb_t flush_cb, void *priv)
@@ -81,6 +114,13 @@ void json_gen_str_start(json_gen_str_t *jstr, char *buf, int buf_size,
     jstr->priv = priv;
 }
 
+void json_gen_str_start_sink(json_gen_str_t *jstr, char *buf, int buf_size,
+                             json_gen_sink_cb_t sink_cb, void *priv)
+{
+    json_gen_str_start(jstr, buf, buf_size, NULL, priv);
+    jstr->sink_cb = sink_cb;
+}
+
 int json_gen_str_end(json_gen_str_t *jstr)
 {
     int total_len = jstr->total_len;
@@ -88,6 +128,8 @@ int json_gen_str_end(json_gen_str_t *jstr)
         *jstr->free_ptr = '\0';
         if (jstr->flush_cb) {
             jstr->flush_cb(jstr->buf, jstr->priv);
+        } else if (jstr->sink_cb) {
+            json_gen_sink(jstr, NULL, 0);
         }
     }
     memset(jstr, 0, sizeof(json_gen_str_t));
@@ -202,12 +244,52 @@ int json_gen_arr_set_bool(json_gen_str_t *jstr, bool val)
     return json_gen_set_bool(jstr, val);
 }
 
+static const char json_gen_digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Writes the decimal digits of val two at a time, backwards, ending just
+ * before end. Returns a pointer to the first digit.
+ */
+static char *json_gen_utoa(uint32_t val, char *end)
+{
+    while (val >= 100) {
+        const char *pair = &json_gen_digit_pairs[(val % 100) * 2];
+        val /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
+    }
+    if (val >= 10) {
+        const char *pair = &json_gen_digit_pairs[val * 2];
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = '0' + val;
+    }
+    return end;
+}
+
 static int json_gen_set_int(json_gen_str_t *jstr, int val)
 {
     jstr->comma_req = true;
     char str[MAX_INT_IN_STR];
-    snprintf(str, MAX_INT_IN_STR, "%d", val);
-    return json_gen_add_to_str(jstr, str);
+    char *end = str + MAX_INT_IN_STR;
+    char *start;
+    if (val < 0) {
+        start = json_gen_utoa(0U - (uint32_t)val, end);
+        *--start = '-';
+    } else {
+        start = json_gen_utoa(val, end);
+    }
+    return json_gen_add_to_str_len(jstr, start, end - start);
 }
 
 int json_gen_obj_set_int(json_gen_str_t *jstr, const char *name, int val)
@@ -223,13 +305,84 @@ int json_gen_arr_set_int(json_gen_str_t *jstr, int val)
     return json_gen_set_int(jstr, val);
 }
 
+/* Formats val like "%.*f" with JSON_FLOAT_PRECISION, using integer operations
+ * only. The float is m * 2^e with m on 24 bits, so val * 10^p is exactly
+ * m * 5^p * 2^(e + p), which fits in 64 bits for |val| < 2^32 and p <= 9.
+ * It is then rounded to the nearest integer, ties to even, like printf does.
+ * Writes backwards, ending just before end, and returns a pointer to the first
+ * character, or NULL if val has to be formatted by snprintf.
+ */
+static char *json_gen_ftoa(float val, char *end)
+{
+#if JSON_FLOAT_PRECISION <= 9
+    static const uint32_t pow5[] = {1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125};
+    static const uint32_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000,
+                                     100000000, 1000000000
+                                    };
+    union {
+        float f;
+        uint32_t u;
+    } bits = { .f = val };
+    int exp = (bits.u >> 23) & 0xff;
+    uint32_t mant = bits.u & 0x7fffff;
+    if (exp >= 127 + 32) {
+        /* Too large, infinity or NaN */
+        return NULL;
+    }
+    int e;
+    if (exp == 0) {
+        e = 1 - 150;
+    } else {
+        mant |= 0x800000;
+        e = exp - 150;
+    }
+    uint64_t scaled = (uint64_t)mant * pow5[JSON_FLOAT_PRECISION];
+    int shift = e + JSON_FLOAT_PRECISION;
+    if (shift >= 0) {
+        scaled <<= shift;
+    } else if (shift > -64) {
+        uint64_t rem = scaled & ((1ULL << -shift) - 1);
+        uint64_t half = 1ULL << (-shift - 1);
+        scaled >>= -shift;
+        if (rem > half || (rem == half && (scaled & 1))) {
+            scaled++;
+        }
+    } else {
+        scaled = 0;
+    }
+
+    char *start = end;
+    uint32_t int_part = scaled / pow10[JSON_FLOAT_PRECISION];
+#if JSON_FLOAT_PRECISION > 0
+    uint32_t frac_part = scaled - (uint64_t)int_part * pow10[JSON_FLOAT_PRECISION];
+    char *frac_end = end - JSON_FLOAT_PRECISION;
+    start = json_gen_utoa(frac_part, end);
+    while (start > frac_end) {
+        *--start = '0';
+    }
+    *--start = '.';
+#endif
+    start = json_gen_utoa(int_part, start);
+    if (bits.u >> 31) {
+        *--start = '-';
+    }
+    return start;
+#else
+    return NULL;
+#endif
+}
 
 static int json_gen_set_float(json_gen_str_t *jstr, float val)
 {
     jstr->comma_req = true;
     char str[MAX_FLOAT_IN_STR];
-    snprintf(str, MAX_FLOAT_IN_STR, "%.*f", JSON_FLOAT_PRECISION, val);
-    return json_gen_add_to_str(jstr, str);
+    char *end = str + MAX_FLOAT_IN_STR;
+    char *start = json_gen_ftoa(val, end);
+    if (start == NULL) {
+        snprintf(str, MAX_FLOAT_IN_STR, "%.*f", JSON_FLOAT_PRECISION, val);
+        return json_gen_add_to_str(jstr, str);
+    }
+    return json_gen_add_to_str_len(jstr, start, end - start);
 }
 int json_gen_obj_set_float(json_gen_str_t *jstr, const char *name, float val)
 {
@@ -310,3 +463,98 @@ int json_gen_arr_set_null(json_gen_str_t *jstr)
     json_gen_handle_comma(jstr);
     return json_gen_set_null(jstr);
 }
+
+int json_gen_tmpl_compile(json_gen_tmpl_t *tmpl, const char *shape,
+                          json_gen_tmpl_part_t *parts, int max_parts)
+{
+    int num_parts = 0;
+    int num_slots = 0;
+    const char *seg = shape;
+    const char *cur = shape;
+    while (1) {
+        const char *pct = strchr(cur, '%');
+        json_gen_tmpl_type_t type;
+        int seg_len;
+        if (!pct) {
+            type = JSON_GEN_TMPL_END;
+            seg_len = strlen(seg);
+        } else {
+            switch (pct[1]) {
+            case 'd':
+                type = JSON_GEN_TMPL_INT;
+                break;
+            case 'f':
+                type = JSON_GEN_TMPL_FLOAT;
+                break;
+            case 'b':
+                type = JSON_GEN_TMPL_BOOL;
+                break;
+            case 's':
+                type = JSON_GEN_TMPL_STRING;
+                break;
+            case 'j':
+                type = JSON_GEN_TMPL_RAW;
+                break;
+            case '%':
+                /* The segment ends with the first '%' */
+                type = JSON_GEN_TMPL_END;
+                pct++;
+                break;
+            default:
+                return -1;
+            }
+            seg_len = pct - seg;
+        }
+        if (num_parts == max_parts) {
+            return -1;
+        }
+        parts[num_parts].seg = seg;
+        parts[num_parts].seg_len = seg_len;
+        parts[num_parts].type = type;
+        num_parts++;
+        if (!pct) {
+            break;
+        }
+        if (type == JSON_GEN_TMPL_END) {
+            seg = cur = pct + 1;
+        } else {
+            num_slots++;
+            seg = cur = pct + 2;
+        }
+    }
+    tmpl->parts = parts;
+    tmpl->num_parts = num_parts;
+    return num_slots;
+}
+
+int json_gen_tmpl_render(json_gen_str_t *jstr, const json_gen_tmpl_t *tmpl,
+                         const json_gen_tmpl_val_t *vals)
+{
+    int ret = 0;
+    json_gen_handle_comma(jstr);
+    for (int i = 0; i < tmpl->num_parts; i++) {
+        const json_gen_tmpl_part_t *part = &tmpl->parts[i];
+        ret |= json_gen_add_to_str_len(jstr, part->seg, part->seg_len);
+        switch (part->type) {
+        case JSON_GEN_TMPL_INT:
+            ret |= json_gen_set_int(jstr, (vals++)->i);
+            break;
+        case JSON_GEN_TMPL_FLOAT:
+            ret |= json_gen_set_float(jstr, (vals++)->f);
+            break;
+        case JSON_GEN_TMPL_BOOL:
+            ret |= json_gen_set_bool(jstr, (vals++)->b);
+            break;
+        case JSON_GEN_TMPL_STRING:
+            ret |= json_gen_set_string(jstr, (vals++)->s);
+            break;
+        case JSON_GEN_TMPL_RAW:
+            ret |= json_gen_add_to_str(jstr, (vals++)->s);
+            break;
+        default:
+            break;
+        }
+    }
+    jstr->comma_req = true;
+    return ret;
+}
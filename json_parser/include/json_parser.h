@@ -19,6 +19,7 @@
 #define JSMN_PARENT_LINKS
 #define JSMN_HEADER
 #include <jsmn.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -39,13 +40,67 @@ typedef struct {
     json_tok_t *tokens;
     json_tok_t *cur;
     int num_tokens;
+    bool use_index;
+    int *next_tok;
+    int *key_index;
+    int key_index_size;
 } jparse_ctx_t;
 
+typedef enum {
+    JSON_FIELD_BOOL,    /* bool */
+    JSON_FIELD_INT,     /* int */
+    JSON_FIELD_INT64,   /* int64_t */
+    JSON_FIELD_FLOAT,   /* float */
+    JSON_FIELD_STRING,  /* char array, NULL terminated */
+    JSON_FIELD_OBJECT,  /* struct described by fields */
+} json_field_type_t;
+
+/* Describes a member of a C struct filled from the value of a key, see json_obj_get_fields() */
+typedef struct json_field {
+    const char *name;
+    json_field_type_t type;
+    size_t offset;
+    size_t size;
+    const struct json_field *fields;
+    int num_fields;
+} json_field_t;
+
+#define JSON_FIELD(name_, type_, struct_type_, member_) { \
+    .name = (name_), \
+    .type = (type_), \
+    .offset = offsetof(struct_type_, member_), \
+    .size = sizeof(((struct_type_ *)0)->member_), \
+}
+
+#define JSON_FIELD_OBJECT_OF(name_, struct_type_, member_, fields_) { \
+    .name = (name_), \
+    .type = JSON_FIELD_OBJECT, \
+    .offset = offsetof(struct_type_, member_), \
+    .size = sizeof(((struct_type_ *)0)->member_), \
+    .fields = (fields_), \
+    .num_fields = sizeof(fields_) / sizeof((fields_)[0]), \
+}
+
 int json_parse_start(jparse_ctx_t *jctx, const char *js, int len);
 int json_parse_end(jparse_ctx_t *jctx);
 int json_parse_start_static(jparse_ctx_t *jctx, const char *js, int len, json_tok_t *buffer_tokens, int buffer_tokens_max_count);
 int json_parse_end_static(jparse_ctx_t *jctx);
 
+/* Speeds up the lookups in large documents. On the first lookup, the index of the token following each token and
+ * its children, and a hash table of the keys of all the objects are built, so that the json_obj_get_*() calls take a
+ * constant time instead of walking the members of the object. Must be called after json_parse_start() or
+ * json_parse_start_static(). The index is allocated on the heap, and freed by json_parse_end() or
+ * json_parse_end_static(). The lookups walk the tokens as usual if it can't be allocated.
+ */
+int json_parse_enable_index(jparse_ctx_t *jctx);
+
+/* Decodes the escape sequences of all the string values, including \uXXXX as UTF-8, in place in js, which must be the
+ * JSON passed to json_parse_start() or json_parse_start_static(), when the caller can modify it. The string values
+ * returned afterwards, by copy or by reference, are decoded. The keys are left as they are. The objects and arrays
+ * returned as strings are no longer valid JSON. Returns -OS_FAIL if js isn't the parsed JSON or has an invalid escape.
+ */
+int json_parse_unescape_in_place(jparse_ctx_t *jctx, char *js);
+
 int json_obj_get_array(jparse_ctx_t *jctx, const char *name, int *num_elem);
 int json_obj_leave_array(jparse_ctx_t *jctx);
 int json_obj_get_object(jparse_ctx_t *jctx, const char *name);
@@ -56,11 +111,22 @@ int json_obj_get_int64(jparse_ctx_t *jctx, const char *name, int64_t *val);
 int json_obj_get_float(jparse_ctx_t *jctx, const char *name, float *val);
 int json_obj_get_string(jparse_ctx_t *jctx, const char *name, char *val, int size);
 int json_obj_get_strlen(jparse_ctx_t *jctx, const char *name, int *strlen);
+/* Returns the string in place, in the JSON passed to json_parse_start(), in one lookup and without copying it. The
+ * string isn't NULL terminated, its length is returned in len.
+ */
+int json_obj_get_string_ref(jparse_ctx_t *jctx, const char *name, const char **val, int *len);
 int json_obj_get_object_str(jparse_ctx_t *jctx, const char *name, char *val, int size);
 int json_obj_get_object_strlen(jparse_ctx_t *jctx, const char *name, int *strlen);
 int json_obj_get_array_str(jparse_ctx_t *jctx, const char *name, char *val, int size);
 int json_obj_get_array_strlen(jparse_ctx_t *jctx, const char *name, int *strlen);
 
+/* Fills the members of out described by fields from the keys of the current object, walking its members once instead
+ * of looking them up one by one. The members without a key of the expected type are left untouched. With duplicate
+ * keys, the last one is used. Returns the number of members filled, including the members of nested objects, or
+ * -OS_FAIL if the current element isn't an object.
+ */
+int json_obj_get_fields(jparse_ctx_t *jctx, const json_field_t *fields, int num_fields, void *out);
+
 int json_arr_get_array(jparse_ctx_t *jctx, uint32_t index);
 int json_arr_leave_array(jparse_ctx_t *jctx);
 int json_arr_get_object(jparse_ctx_t *jctx, uint32_t index);
@@ -71,6 +137,65 @@ int json_arr_get_int64(jparse_ctx_t *jctx, uint32_t index, int64_t *val);
 int json_arr_get_float(jparse_ctx_t *jctx, uint32_t index, float *val);
 int json_arr_get_string(jparse_ctx_t *jctx, uint32_t index, char *val, int size);
 int json_arr_get_strlen(jparse_ctx_t *jctx, uint32_t index, int *strlen);
+int json_arr_get_string_ref(jparse_ctx_t *jctx, uint32_t index, const char **val, int *len);
+
+/* Streaming parser, for documents received in chunks, e.g. from HTTP, which don't fit in memory. The values are passed
+ * to a callback as they are parsed, along with their path, e.g. "features.list[2].name". Only the path of the current
+ * value, one string or primitive value and the state of each nesting level are kept in memory. Strings are passed as
+ * they appear in the document, without unescaping, like with json_obj_get_string().
+ */
+typedef enum {
+    JSON_STREAM_OBJECT_START,
+    JSON_STREAM_OBJECT_END,
+    JSON_STREAM_ARRAY_START,
+    JSON_STREAM_ARRAY_END,
+    JSON_STREAM_STRING,     /* String value */
+    JSON_STREAM_PRIMITIVE,  /* Number, true, false or null */
+} json_stream_event_type_t;
+
+typedef struct {
+    json_stream_event_type_t type;
+    const char *path;       /* Path of the value, NULL terminated, "" for the root */
+    int depth;              /* Number of objects and arrays the value is in */
+    const char *value;      /* String or primitive value, NULL terminated */
+    int value_len;
+    bool partial;           /* The string was longer than max_value_len, its next part comes with the next event */
+} json_stream_event_t;
+
+/* Returns OS_SUCCESS to go on, anything else to stop the parsing */
+typedef int (*json_stream_cb_t)(const json_stream_event_t *event, void *arg);
+
+typedef struct {
+    json_stream_cb_t cb;
+    void *arg;              /* Passed to cb */
+    int max_depth;          /* Maximum nesting of the objects and arrays */
+    int max_path_len;       /* Maximum length of the paths, longer keys fail the parsing */
+    int max_value_len;      /* Longer strings are passed in parts, longer primitives fail the parsing */
+} json_stream_config_t;
+
+typedef struct {
+    uint8_t type;
+    int path_len;
+    int index;
+} json_stream_level_t;
+
+typedef struct {
+    json_stream_config_t config;
+    json_stream_level_t *levels;
+    int depth;
+    char *path;
+    int path_len;
+    char *value;
+    int value_len;
+    int state;
+    bool escape;
+} json_stream_ctx_t;
+
+int json_stream_start(json_stream_ctx_t *ctx, const json_stream_config_t *config);
+/* Parses the next chunk of the document, returns -OS_FAIL on invalid JSON, or when the callback stops the parsing */
+int json_stream_feed(json_stream_ctx_t *ctx, const char *buf, int len);
+/* Frees the parser, returns -OS_FAIL if the document is incomplete or invalid */
+int json_stream_end(json_stream_ctx_t *ctx);
 
 #ifdef __cplusplus
 }
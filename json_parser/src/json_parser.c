@@ -23,11 +23,14 @@
 #include <jsmn.h>
 #include <json_parser.h>
 
+static bool token_matches_strn(jparse_ctx_t *ctx, json_tok_t *tok, const char *str, size_t len)
+{
+    return (len == (size_t) (tok->end - tok->start)) && (memcmp(ctx->js + tok->start, str, len) == 0);
+}
+
 static bool token_matches_str(jparse_ctx_t *ctx, json_tok_t *tok, const char *str)
 {
-    const char *js = ctx->js;
-    return ((strncmp(js + tok->start, str, strlen(str)) == 0)
-            && (strlen(str) == (size_t) (tok->end - tok->start)));
+    return token_matches_strn(ctx, tok, str, strlen(str));
 }
 
 static json_tok_t *json_skip_elem(json_tok_t *token)
@@ -41,6 +44,99 @@ static json_tok_t *json_skip_elem(json_tok_t *token)
     return cur;
 }
 
+/* Key hash, mixed with the object the key belongs to */
+static uint32_t json_key_hash(const char *str, size_t len, int parent)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ (uint8_t)str[i]) * 16777619u;
+    }
+    return hash ^ ((uint32_t)parent * 2654435761u);
+}
+
+static bool json_tok_is_key(jparse_ctx_t *jctx, json_tok_t *tok)
+{
+    return tok->parent >= 0 && jctx->tokens[tok->parent].type == JSMN_OBJECT;
+}
+
+static void json_index_free(jparse_ctx_t *jctx)
+{
+    free(jctx->next_tok);
+    free(jctx->key_index);
+    jctx->next_tok = NULL;
+    jctx->key_index = NULL;
+    jctx->key_index_size = 0;
+}
+
+static void json_index_build(jparse_ctx_t *jctx)
+{
+    /* Only try once */
+    jctx->use_index = false;
+    int num_tokens = jctx->num_tokens;
+    json_tok_t *tokens = jctx->tokens;
+    int num_keys = 0;
+    for (int i = 0; i < num_tokens; i++) {
+        if (json_tok_is_key(jctx, &tokens[i])) {
+            num_keys++;
+        }
+    }
+    /* Less than half full, so that the probe sequences stay short */
+    int size = 8;
+    while (size < 2 * num_keys) {
+        size *= 2;
+    }
+    jctx->next_tok = malloc(num_tokens * sizeof(int));
+    jctx->key_index = malloc(size * sizeof(int));
+    if (!jctx->next_tok || !jctx->key_index) {
+        json_index_free(jctx);
+        return;
+    }
+    jctx->key_index_size = size;
+
+    /* The children come after their parent, so the tokens following them are known when going backwards */
+    for (int i = num_tokens - 1; i >= 0; i--) {
+        if (tokens[i].type == JSMN_OBJECT || tokens[i].type == JSMN_ARRAY) {
+            int next = i + 1;
+            for (int child = 0; child < tokens[i].size; child++) {
+                next = jctx->next_tok[next];
+            }
+            jctx->next_tok[i] = next;
+        } else if (tokens[i].size > 0) {
+            /* A key and its value */
+            jctx->next_tok[i] = jctx->next_tok[i + 1];
+        } else {
+            jctx->next_tok[i] = i + 1;
+        }
+    }
+
+    /* Keys inserted in order, so that the first of duplicate keys is found first like when walking the members */
+    memset(jctx->key_index, 0xff, size * sizeof(int));
+    for (int i = 0; i < num_tokens; i++) {
+        if (!json_tok_is_key(jctx, &tokens[i])) {
+            continue;
+        }
+        uint32_t slot = json_key_hash(jctx->js + tokens[i].start, tokens[i].end - tokens[i].start, tokens[i].parent);
+        slot &= size - 1;
+        while (jctx->key_index[slot] >= 0) {
+            slot = (slot + 1) & (size - 1);
+        }
+        jctx->key_index[slot] = i;
+    }
+}
+
+/* Returns the last token of the element and its children */
+static json_tok_t *json_skip_elem_indexed(jparse_ctx_t *jctx, json_tok_t *token)
+{
+    /* Nothing to skip, which is cheaper to tell than looking up the index */
+    if (token->size == 0) {
+        return token;
+    }
+    if (jctx->next_tok) {
+        return &jctx->tokens[jctx->next_tok[token - jctx->tokens] - 1];
+    }
+    return json_skip_elem(token);
+}
+
 static int json_tok_to_bool(jparse_ctx_t *jctx, json_tok_t *tok, bool *val)
 {
     if (token_matches_str(jctx, tok, "true") || token_matches_str(jctx, tok, "1")) {
@@ -112,13 +208,32 @@ static json_tok_t *json_obj_search(jparse_ctx_t *jctx, const char *key)
     if (tok->type != JSMN_OBJECT) {
         return NULL;
     }
+    if (jctx->use_index) {
+        json_index_build(jctx);
+    }
+
+    size_t len = strlen(key);
+    if (jctx->key_index) {
+        int parent = tok - jctx->tokens;
+        uint32_t mask = jctx->key_index_size - 1;
+        uint32_t slot = json_key_hash(key, len, parent) & mask;
+        int index;
+        while ((index = jctx->key_index[slot]) >= 0) {
+            tok = &jctx->tokens[index];
+            if (tok->parent == parent && token_matches_strn(jctx, tok, key, len)) {
+                return tok;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return NULL;
+    }
 
     while (size--) {
         tok++;
-        if (token_matches_str(jctx, tok, key)) {
+        if (token_matches_strn(jctx, tok, key, len)) {
             return tok;
         }
-        tok = json_skip_elem(tok);
+        tok = json_skip_elem_indexed(jctx, tok);
     }
     return NULL;
 }
@@ -244,6 +359,17 @@ int json_obj_get_strlen(jparse_ctx_t *jctx, const char *name, int *strlen)
     return OS_SUCCESS;
 }
 
+int json_obj_get_string_ref(jparse_ctx_t *jctx, const char *name, const char **val, int *len)
+{
+    json_tok_t *tok = json_obj_get_val_tok(jctx, name, JSMN_STRING);
+    if (!tok) {
+        return -OS_FAIL;
+    }
+    *val = jctx->js + tok->start;
+    *len = tok->end - tok->start;
+    return OS_SUCCESS;
+}
+
 int json_obj_get_object_str(jparse_ctx_t *jctx, const char *name, char *val, int size)
 {
     json_tok_t *tok = json_obj_get_val_tok(jctx, name, JSMN_OBJECT);
@@ -281,6 +407,87 @@ int json_obj_get_array_strlen(jparse_ctx_t *jctx, const char *name, int *strlen)
     return OS_SUCCESS;
 }
 
+static void json_tok_to_field(jparse_ctx_t *jctx, json_tok_t *tok, const json_field_t *field, char *out, int *filled)
+{
+    void *member = out + field->offset;
+    int ret = -OS_FAIL;
+    switch (field->type) {
+    case JSON_FIELD_BOOL:
+        if (tok->type == JSMN_PRIMITIVE) {
+            ret = json_tok_to_bool(jctx, tok, (bool *)member);
+        }
+        break;
+    case JSON_FIELD_INT:
+        if (tok->type == JSMN_PRIMITIVE) {
+            ret = json_tok_to_int(jctx, tok, (int *)member);
+        }
+        break;
+    case JSON_FIELD_INT64:
+        if (tok->type == JSMN_PRIMITIVE) {
+            ret = json_tok_to_int64(jctx, tok, (int64_t *)member);
+        }
+        break;
+    case JSON_FIELD_FLOAT:
+        if (tok->type == JSMN_PRIMITIVE) {
+            ret = json_tok_to_float(jctx, tok, (float *)member);
+        }
+        break;
+    case JSON_FIELD_STRING:
+        if (tok->type == JSMN_STRING) {
+            ret = json_tok_to_string(jctx, tok, (char *)member, field->size);
+        }
+        break;
+    case JSON_FIELD_OBJECT:
+        break;
+    }
+    if (ret == OS_SUCCESS) {
+        (*filled)++;
+    }
+}
+
+/* Returns the last token of the object */
+static json_tok_t *json_obj_walk_fields(jparse_ctx_t *jctx, json_tok_t *obj, const json_field_t *fields,
+                                        int num_fields, char *out, int *filled)
+{
+    json_tok_t *tok = obj;
+    int size = obj->size;
+    while (size--) {
+        /* The key, then its value */
+        tok++;
+        json_tok_t *key = tok;
+        const json_field_t *field = NULL;
+        for (int i = 0; i < num_fields; i++) {
+            if (token_matches_str(jctx, key, fields[i].name)) {
+                field = &fields[i];
+                break;
+            }
+        }
+        if (key->size == 0) {
+            continue;
+        }
+        tok++;
+        if (field && field->type == JSON_FIELD_OBJECT && tok->type == JSMN_OBJECT) {
+            tok = json_obj_walk_fields(jctx, tok, field->fields, field->num_fields, out + field->offset, filled);
+            continue;
+        }
+        if (field) {
+            json_tok_to_field(jctx, tok, field, out, filled);
+        }
+        tok = json_skip_elem_indexed(jctx, tok);
+    }
+    return tok;
+}
+
+int json_obj_get_fields(jparse_ctx_t *jctx, const json_field_t *fields, int num_fields, void *out)
+{
+    if (jctx->cur->type != JSMN_OBJECT) {
+        return -OS_FAIL;
+    }
+    int filled = 0;
+    json_obj_walk_fields(jctx, jctx->cur, fields, num_fields, out, &filled);
+    return filled;
+}
+
 static json_tok_t *json_arr_search(jparse_ctx_t *ctx, uint32_t index)
 {
     json_tok_t *tok = ctx->cur;
@@ -290,10 +497,13 @@ static json_tok_t *json_arr_search(jparse_ctx_t *ctx, uint32_t index)
     if (index > (uint32_t)(tok->size - 1)) {
         return NULL;
     }
+    if (ctx->use_index) {
+        json_index_build(ctx);
+    }
     /* Increment by 1, so that token points to index 0 */
     tok++;
     while (index--) {
-        tok = json_skip_elem(tok);
+        tok = json_skip_elem_indexed(ctx, tok);
         tok++;
     }
     return tok;
@@ -403,33 +613,55 @@ int json_arr_get_strlen(jparse_ctx_t *jctx, uint32_t index, int *strlen)
     return OS_SUCCESS;
 }
 
-int json_parse_start(jparse_ctx_t *jctx, const char *js, int len)
+int json_arr_get_string_ref(jparse_ctx_t *jctx, uint32_t index, const char **val, int *len)
 {
-    memset(jctx, 0, sizeof(jparse_ctx_t));
-    jsmn_init(&jctx->parser);
-    int num_tokens = jsmn_parse(&jctx->parser, js, len, NULL, 0);
-    if (num_tokens <= 0) {
-        return -OS_FAIL;
-    }
-    jctx->num_tokens = num_tokens;
-    jctx->tokens = calloc(num_tokens, sizeof(json_tok_t));
-    if (!jctx->tokens) {
+    json_tok_t *tok = json_arr_get_val_tok(jctx, index, JSMN_STRING);
+    if (!tok) {
         return -OS_FAIL;
     }
-    jctx->js = js;
+    *val = jctx->js + tok->start;
+    *len = tok->end - tok->start;
+    return OS_SUCCESS;
+}
+
+/* Initial number of tokens per byte of JSON, the token array is doubled whenever jsmn runs out of tokens */
+#define JSON_PARSER_BYTES_PER_TOKEN     8
+
+int json_parse_start(jparse_ctx_t *jctx, const char *js, int len)
+{
+    memset(jctx, 0, sizeof(jparse_ctx_t));
     jsmn_init(&jctx->parser);
-    int ret = jsmn_parse(&jctx->parser, js, len, jctx->tokens, jctx->num_tokens);
+    /* jsmn resumes where it ran out of tokens, so the JSON is parsed once whatever the initial guess */
+    int num_tokens = len / JSON_PARSER_BYTES_PER_TOKEN + 1;
+    json_tok_t *tokens = NULL;
+    int ret;
+    do {
+        json_tok_t *new_tokens = realloc(tokens, num_tokens * sizeof(json_tok_t));
+        if (!new_tokens) {
+            free(tokens);
+            return -OS_FAIL;
+        }
+        tokens = new_tokens;
+        ret = jsmn_parse(&jctx->parser, js, len, tokens, num_tokens);
+        num_tokens *= 2;
+    } while (ret == JSMN_ERROR_NOMEM);
     if (ret <= 0) {
-        free(jctx->tokens);
+        free(tokens);
         memset(jctx, 0, sizeof(jparse_ctx_t));
         return -OS_FAIL;
     }
+    /* Give back the unused tokens, shrinking doesn't fail */
+    json_tok_t *new_tokens = realloc(tokens, ret * sizeof(json_tok_t));
+    jctx->tokens = new_tokens ? new_tokens : tokens;
+    jctx->num_tokens = ret;
+    jctx->js = js;
     jctx->cur = jctx->tokens;
     return OS_SUCCESS;
 }
 
 int json_parse_end(jparse_ctx_t *jctx)
 {
+    json_index_free(jctx);
     if (jctx->tokens) {
         free(jctx->tokens);
     }
@@ -439,36 +671,163 @@ int json_parse_end(jparse_ctx_t *jctx)
 
 int json_parse_start_static(jparse_ctx_t *jctx, const char *js, int len, json_tok_t *buffer_tokens, int buffer_tokens_max_count)
 {
-    // Init
-    memset(buffer_tokens, 0, buffer_tokens_max_count * sizeof(json_tok_t));
     memset(jctx, 0, sizeof(jparse_ctx_t));
 
-    // Check fit
+    // Parse, JSMN_ERROR_NOMEM if the buffer is too small
     jsmn_init(&jctx->parser);
-    int num_tokens = jsmn_parse(&jctx->parser, js, len, NULL, 0);
-    if (num_tokens <= 0 || num_tokens > buffer_tokens_max_count) {
+    int ret = jsmn_parse(&jctx->parser, js, len, buffer_tokens, buffer_tokens_max_count);
+    if (ret <= 0) {
+        memset(jctx, 0, sizeof(jparse_ctx_t));
         return -OS_FAIL;
     }
 
     // Set struct
-    jctx->num_tokens = num_tokens;
+    jctx->num_tokens = ret;
     jctx->tokens = buffer_tokens;
     jctx->js = js;
-
-    // Parse
-    jsmn_init(&jctx->parser);
-    int ret = jsmn_parse(&jctx->parser, js, len, jctx->tokens, jctx->num_tokens);
-    if (ret <= 0) {
-        memset(jctx, 0, sizeof(jparse_ctx_t));
-        return -OS_FAIL;
-    }
     jctx->cur = jctx->tokens;
     return OS_SUCCESS;
 }
 
 int json_parse_end_static(jparse_ctx_t *jctx)
 {
+    json_index_free(jctx);
     memset(jctx, 0, sizeof(jparse_ctx_t));
     return OS_SUCCESS;
 }
 
+int json_parse_enable_index(jparse_ctx_t *jctx)
+{
+    if (!jctx->tokens) {
+        return -OS_FAIL;
+    }
+    if (!jctx->next_tok) {
+        jctx->use_index = true;
+    }
+    return OS_SUCCESS;
+}
+
+static int json_hex4(const char *str)
+{
+    int val = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = str[i];
+        val <<= 4;
+        if (c >= '0' && c <= '9') {
+            val |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            val |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            val |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return val;
+}
+
+static char *json_put_utf8(char *dst, uint32_t cp)
+{
+    if (cp < 0x80) {
+        *dst++ = cp;
+    } else if (cp < 0x800) {
+        *dst++ = 0xc0 | (cp >> 6);
+        *dst++ = 0x80 | (cp & 0x3f);
+    } else if (cp < 0x10000) {
+        *dst++ = 0xe0 | (cp >> 12);
+        *dst++ = 0x80 | ((cp >> 6) & 0x3f);
+        *dst++ = 0x80 | (cp & 0x3f);
+    } else {
+        *dst++ = 0xf0 | (cp >> 18);
+        *dst++ = 0x80 | ((cp >> 12) & 0x3f);
+        *dst++ = 0x80 | ((cp >> 6) & 0x3f);
+        *dst++ = 0x80 | (cp & 0x3f);
+    }
+    return dst;
+}
+
+/* The decoded string is never longer than the escaped one, a \uXXXX escape taking 6 bytes and its UTF-8 encoding at
+ * most 3, or 4 for the 12 bytes of a surrogate pair, so it's written over it and the token end moved back */
+static int json_tok_unescape(char *js, json_tok_t *tok)
+{
+    char *end = js + tok->end;
+    char *dst = memchr(js + tok->start, '\\', tok->end - tok->start);
+    if (!dst) {
+        return OS_SUCCESS;
+    }
+    const char *src = dst;
+    while (src < end) {
+        if (*src != '\\') {
+            *dst++ = *src++;
+            continue;
+        }
+        if (end - src < 2) {
+            return -OS_FAIL;
+        }
+        src += 2;
+        switch (src[-1]) {
+        case '"':
+        case '\\':
+        case '/':
+            *dst++ = src[-1];
+            break;
+        case 'b':
+            *dst++ = '\b';
+            break;
+        case 'f':
+            *dst++ = '\f';
+            break;
+        case 'n':
+            *dst++ = '\n';
+            break;
+        case 'r':
+            *dst++ = '\r';
+            break;
+        case 't':
+            *dst++ = '\t';
+            break;
+        case 'u': {
+            int cp = (end - src >= 4) ? json_hex4(src) : -1;
+            if (cp < 0) {
+                return -OS_FAIL;
+            }
+            src += 4;
+            if (cp >= 0xd800 && cp <= 0xdbff && end - src >= 6 && src[0] == '\\' && src[1] == 'u') {
+                int low = json_hex4(src + 2);
+                if (low >= 0xdc00 && low <= 0xdfff) {
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    src += 6;
+                }
+            }
+            if (cp >= 0xd800 && cp <= 0xdfff) {
+                /* Unpaired surrogate */
+                cp = 0xfffd;
+            }
+            dst = json_put_utf8(dst, cp);
+            break;
+        }
+        default:
+            return -OS_FAIL;
+        }
+    }
+    tok->end = dst - js;
+    return OS_SUCCESS;
+}
+
+int json_parse_unescape_in_place(jparse_ctx_t *jctx, char *js)
+{
+    if (!jctx->tokens || js != jctx->js) {
+        return -OS_FAIL;
+    }
+    for (int i = 0; i < jctx->num_tokens; i++) {
+        json_tok_t *tok = &jctx->tokens[i];
+        /* The keys are left as they are, the lookups match them against the names given as they appear in the JSON */
+        if (tok->type != JSMN_STRING || json_tok_is_key(jctx, tok)) {
+            continue;
+        }
+        if (json_tok_unescape(js, tok) != OS_SUCCESS) {
+            return -OS_FAIL;
+        }
+    }
+    return OS_SUCCESS;
+}
@@ -0,0 +1,370 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+#include <json_parser.h>
+
+enum {
+    STREAM_VALUE,           /* Expecting a value */
+    STREAM_FIRST_VALUE,     /* After '[', expecting a value or ']' */
+    STREAM_FIRST_KEY,       /* After '{', expecting a key or '}' */
+    STREAM_KEY,             /* After ',' in an object, expecting a key */
+    STREAM_COLON,           /* After a key */
+    STREAM_NEXT,            /* After a value, expecting ',' or the end of the object or array */
+    STREAM_KEY_STRING,
+    STREAM_VALUE_STRING,
+    STREAM_PRIMITIVE,
+    STREAM_DONE,            /* After the root value */
+    STREAM_ERROR,
+};
+
+#define STREAM_CHAR_ERROR   -1
+
+enum {
+    STREAM_LEVEL_OBJECT,
+    STREAM_LEVEL_ARRAY,
+};
+
+static bool json_stream_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+/* Same characters as the primitives of jsmn */
+static bool json_stream_is_primitive_char(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+}
+
+static bool json_stream_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool json_stream_number_valid(const char *value)
+{
+    if (*value == '-') {
+        value++;
+    }
+    if (*value == '0') {
+        value++;
+    } else if (json_stream_is_digit(*value)) {
+        while (json_stream_is_digit(*value)) {
+            value++;
+        }
+    } else {
+        return false;
+    }
+    if (*value == '.') {
+        value++;
+        if (!json_stream_is_digit(*value)) {
+            return false;
+        }
+        while (json_stream_is_digit(*value)) {
+            value++;
+        }
+    }
+    if (*value == 'e' || *value == 'E') {
+        value++;
+        if (*value == '+' || *value == '-') {
+            value++;
+        }
+        if (!json_stream_is_digit(*value)) {
+            return false;
+        }
+        while (json_stream_is_digit(*value)) {
+            value++;
+        }
+    }
+    return *value == '\0';
+}
+
+static bool json_stream_primitive_valid(const char *value)
+{
+    return json_stream_number_valid(value) || strcmp(value, "true") == 0 || strcmp(value, "false") == 0
+           || strcmp(value, "null") == 0;
+}
+
+static int json_stream_emit(json_stream_ctx_t *ctx, json_stream_event_type_t type, bool partial)
+{
+    json_stream_event_t event = {
+        .type = type,
+        .path = ctx->path,
+        .depth = ctx->depth,
+        .partial = partial,
+    };
+    if (type == JSON_STREAM_STRING || type == JSON_STREAM_PRIMITIVE) {
+        ctx->value[ctx->value_len] = '\0';
+        event.value = ctx->value;
+        event.value_len = ctx->value_len;
+    }
+    return ctx->config.cb(&event, ctx->config.arg);
+}
+
+static void json_stream_set_path_len(json_stream_ctx_t *ctx, int path_len)
+{
+    ctx->path_len = path_len;
+    ctx->path[path_len] = '\0';
+}
+
+static int json_stream_path_append(json_stream_ctx_t *ctx, char c)
+{
+    if (ctx->path_len == ctx->config.max_path_len) {
+        return -OS_FAIL;
+    }
+    ctx->path[ctx->path_len++] = c;
+    ctx->path[ctx->path_len] = '\0';
+    return OS_SUCCESS;
+}
+
+static void json_stream_value_done(json_stream_ctx_t *ctx)
+{
+    ctx->state = ctx->depth ? STREAM_NEXT : STREAM_DONE;
+}
+
+/* Sets the path of the next element of an array */
+static int json_stream_array_path(json_stream_ctx_t *ctx)
+{
+    json_stream_level_t *level = &ctx->levels[ctx->depth - 1];
+    int room = ctx->config.max_path_len - level->path_len + 1;
+    int len = snprintf(ctx->path + level->path_len, room, "[%d]", level->index);
+    if (len >= room) {
+        return -OS_FAIL;
+    }
+    ctx->path_len = level->path_len + len;
+    return OS_SUCCESS;
+}
+
+static int json_stream_open(json_stream_ctx_t *ctx, uint8_t type)
+{
+    if (ctx->depth == ctx->config.max_depth) {
+        return -OS_FAIL;
+    }
+    if (json_stream_emit(ctx, type == STREAM_LEVEL_OBJECT ? JSON_STREAM_OBJECT_START : JSON_STREAM_ARRAY_START,
+                         false) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_level_t *level = &ctx->levels[ctx->depth++];
+    level->type = type;
+    level->path_len = ctx->path_len;
+    level->index = 0;
+    ctx->state = type == STREAM_LEVEL_OBJECT ? STREAM_FIRST_KEY : STREAM_FIRST_VALUE;
+    return OS_SUCCESS;
+}
+
+static int json_stream_close(json_stream_ctx_t *ctx, uint8_t type)
+{
+    json_stream_level_t *level = &ctx->levels[ctx->depth - 1];
+    if (level->type != type) {
+        return -OS_FAIL;
+    }
+    json_stream_set_path_len(ctx, level->path_len);
+    ctx->depth--;
+    if (json_stream_emit(ctx, type == STREAM_LEVEL_OBJECT ? JSON_STREAM_OBJECT_END : JSON_STREAM_ARRAY_END,
+                         false) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    json_stream_value_done(ctx);
+    return OS_SUCCESS;
+}
+
+static int json_stream_value(json_stream_ctx_t *ctx, char c)
+{
+    if (ctx->depth && ctx->levels[ctx->depth - 1].type == STREAM_LEVEL_ARRAY && json_stream_array_path(ctx) != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    if (c == '{') {
+        return json_stream_open(ctx, STREAM_LEVEL_OBJECT);
+    } else if (c == '[') {
+        return json_stream_open(ctx, STREAM_LEVEL_ARRAY);
+    } else if (c == '\"') {
+        ctx->value_len = 0;
+        ctx->escape = false;
+        ctx->state = STREAM_VALUE_STRING;
+        return OS_SUCCESS;
+    } else if (json_stream_is_primitive_char(c)) {
+        ctx->value[0] = c;
+        ctx->value_len = 1;
+        ctx->state = STREAM_PRIMITIVE;
+        return OS_SUCCESS;
+    }
+    return -OS_FAIL;
+}
+
+static int json_stream_key(json_stream_ctx_t *ctx)
+{
+    json_stream_set_path_len(ctx, ctx->levels[ctx->depth - 1].path_len);
+    if (ctx->path_len > 0 && json_stream_path_append(ctx, '.') != OS_SUCCESS) {
+        return -OS_FAIL;
+    }
+    ctx->escape = false;
+    ctx->state = STREAM_KEY_STRING;
+    return OS_SUCCESS;
+}
+
+/* Returns whether the string goes on after c */
+static bool json_stream_string_char(json_stream_ctx_t *ctx, char c)
+{
+    if (ctx->escape) {
+        ctx->escape = false;
+    } else if (c == '\\') {
+        ctx->escape = true;
+    } else if (c == '\"') {
+        return false;
+    }
+    return true;
+}
+
+/* Parses c, returns the number of characters used, 0 if c must be parsed again in the new state, or STREAM_CHAR_ERROR */
+static int json_stream_char(json_stream_ctx_t *ctx, char c)
+{
+    switch (ctx->state) {
+    case STREAM_KEY_STRING:
+        if (!json_stream_string_char(ctx, c)) {
+            ctx->state = STREAM_COLON;
+            return 1;
+        }
+        if ((uint8_t)c < 0x20) {
+            return STREAM_CHAR_ERROR;
+        }
+        return json_stream_path_append(ctx, c) == OS_SUCCESS ? 1 : STREAM_CHAR_ERROR;
+    case STREAM_VALUE_STRING:
+        if (!json_stream_string_char(ctx, c)) {
+            if (json_stream_emit(ctx, JSON_STREAM_STRING, false) != OS_SUCCESS) {
+                return STREAM_CHAR_ERROR;
+            }
+            json_stream_value_done(ctx);
+            return 1;
+        }
+        if ((uint8_t)c < 0x20) {
+            return STREAM_CHAR_ERROR;
+        }
+        if (ctx->value_len == ctx->config.max_value_len) {
+            if (json_stream_emit(ctx, JSON_STREAM_STRING, true) != OS_SUCCESS) {
+                return STREAM_CHAR_ERROR;
+            }
+            ctx->value_len = 0;
+        }
+        ctx->value[ctx->value_len++] = c;
+        return 1;
+    case STREAM_PRIMITIVE:
+        if (json_stream_is_primitive_char(c)) {
+            if (ctx->value_len == ctx->config.max_value_len) {
+                return STREAM_CHAR_ERROR;
+            }
+            ctx->value[ctx->value_len++] = c;
+            return 1;
+        }
+        ctx->value[ctx->value_len] = '\0';
+        if (!json_stream_primitive_valid(ctx->value) || json_stream_emit(ctx, JSON_STREAM_PRIMITIVE, false) != OS_SUCCESS) {
+            return STREAM_CHAR_ERROR;
+        }
+        json_stream_value_done(ctx);
+        return 0;
+    default:
+        break;
+    }
+
+    if (json_stream_is_space(c)) {
+        return 1;
+    }
+    int ret = -OS_FAIL;
+    switch (ctx->state) {
+    case STREAM_FIRST_VALUE:
+        if (c == ']') {
+            ret = json_stream_close(ctx, STREAM_LEVEL_ARRAY);
+            break;
+        }
+    /* fall through */
+    case STREAM_VALUE:
+        ret = json_stream_value(ctx, c);
+        break;
+    case STREAM_FIRST_KEY:
+        if (c == '}') {
+            ret = json_stream_close(ctx, STREAM_LEVEL_OBJECT);
+            break;
+        }
+    /* fall through */
+    case STREAM_KEY:
+        if (c == '\"') {
+            ret = json_stream_key(ctx);
+        }
+        break;
+    case STREAM_COLON:
+        if (c == ':') {
+            ctx->state = STREAM_VALUE;
+            ret = OS_SUCCESS;
+        }
+        break;
+    case STREAM_NEXT:
+        if (c == ',') {
+            if (ctx->levels[ctx->depth - 1].type == STREAM_LEVEL_ARRAY) {
+                ctx->levels[ctx->depth - 1].index++;
+                ctx->state = STREAM_VALUE;
+            } else {
+                ctx->state = STREAM_KEY;
+            }
+            ret = OS_SUCCESS;
+        } else if (c == '}') {
+            ret = json_stream_close(ctx, STREAM_LEVEL_OBJECT);
+        } else if (c == ']') {
+            ret = json_stream_close(ctx, STREAM_LEVEL_ARRAY);
+        }
+        break;
+    default:
+        break;
+    }
+    return ret == OS_SUCCESS ? 1 : STREAM_CHAR_ERROR;
+}
+
+int json_stream_start(json_stream_ctx_t *ctx, const json_stream_config_t *config)
+{
+    memset(ctx, 0, sizeof(json_stream_ctx_t));
+    if (!config->cb || config->max_depth <= 0 || config->max_path_len <= 0 || config->max_value_len <= 0) {
+        return -OS_FAIL;
+    }
+    ctx->config = *config;
+    ctx->levels = calloc(config->max_depth, sizeof(json_stream_level_t));
+    ctx->path = calloc(1, config->max_path_len + 1);
+    ctx->value = calloc(1, config->max_value_len + 1);
+    if (!ctx->levels || !ctx->path || !ctx->value) {
+        json_stream_end(ctx);
+        return -OS_FAIL;
+    }
+    ctx->state = STREAM_VALUE;
+    return OS_SUCCESS;
+}
+
+int json_stream_feed(json_stream_ctx_t *ctx, const char *buf, int len)
+{
+    int i = 0;
+    while (i < len && ctx->state != STREAM_ERROR) {
+        int ret = json_stream_char(ctx, buf[i]);
+        if (ret == STREAM_CHAR_ERROR) {
+            ctx->state = STREAM_ERROR;
+        } else {
+            i += ret;
+        }
+    }
+    return ctx->state == STREAM_ERROR ? -OS_FAIL : OS_SUCCESS;
+}
+
+int json_stream_end(json_stream_ctx_t *ctx)
+{
+    /* A primitive ends with the document when it is the root value */
+    if (ctx->state == STREAM_PRIMITIVE && ctx->depth == 0) {
+        json_stream_char(ctx, ' ');
+    }
+    int ret = ctx->state == STREAM_DONE ? OS_SUCCESS : -OS_FAIL;
+    free(ctx->levels);
+    free(ctx->path);
+    free(ctx->value);
+    memset(ctx, 0, sizeof(json_stream_ctx_t));
+    return ret;
+}
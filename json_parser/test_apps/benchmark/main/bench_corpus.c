@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "benchmark.h"
+
+#define BENCH_SAMPLE_COUNT  512
+
+/* Node configuration sent by a device during provisioning */
+static const char s_provisioning[] =
+    "{\"node_id\":\"a1b2c3d4e5f6a7b8\",\"config_version\":\"2020-03-20\","
+    "\"info\":{\"name\":\"ESP Light\",\"fw_version\":\"1.0.3\",\"type\":\"Lightbulb\","
+    "\"model\":\"esp-light\",\"project_name\":\"led_light\",\"platform\":\"esp32\"},"
+    "\"devices\":[{\"name\":\"Light\",\"type\":\"esp.device.lightbulb\",\"primary\":\"Power\",\"params\":["
+    "{\"name\":\"Name\",\"type\":\"esp.param.name\",\"data_type\":\"string\",\"properties\":[\"read\",\"write\"]},"
+    "{\"name\":\"Power\",\"type\":\"esp.param.power\",\"data_type\":\"bool\",\"properties\":[\"read\",\"write\"],"
+    "\"ui_type\":\"esp.ui.toggle\"},"
+    "{\"name\":\"Brightness\",\"type\":\"esp.param.brightness\",\"data_type\":\"int\",\"properties\":[\"read\",\"write\"],"
+    "\"bounds\":{\"min\":0,\"max\":100,\"step\":1},\"ui_type\":\"esp.ui.slider\"},"
+    "{\"name\":\"Hue\",\"type\":\"esp.param.hue\",\"data_type\":\"int\",\"properties\":[\"read\",\"write\"],"
+    "\"bounds\":{\"min\":0,\"max\":360,\"step\":1},\"ui_type\":\"esp.ui.hue-slider\"},"
+    "{\"name\":\"Saturation\",\"type\":\"esp.param.saturation\",\"data_type\":\"int\",\"properties\":[\"read\",\"write\"],"
+    "\"bounds\":{\"min\":0,\"max\":100,\"step\":1},\"ui_type\":\"esp.ui.slider\"}]}],"
+    "\"services\":[{\"name\":\"OTA\",\"type\":\"esp.service.ota\",\"params\":["
+    "{\"name\":\"URL\",\"type\":\"esp.param.ota_url\",\"data_type\":\"string\",\"properties\":[\"write\"]},"
+    "{\"name\":\"Status\",\"type\":\"esp.param.ota_status\",\"data_type\":\"string\",\"properties\":[\"read\"]},"
+    "{\"name\":\"Info\",\"type\":\"esp.param.ota_info\",\"data_type\":\"string\",\"properties\":[\"read\"]}]}]}";
+
+/* AWS IoT device shadow document, as received on the get/accepted topic */
+static const char s_shadow[] =
+    "{\"state\":{"
+    "\"desired\":{\"color\":\"RED\",\"brightness\":80,\"power\":true,\"schedule\":{\"on\":\"07:30\",\"off\":\"23:00\"}},"
+    "\"reported\":{\"color\":\"GREEN\",\"brightness\":55,\"power\":true,\"temperature\":23.75,\"firmware\":\"2.1.0\","
+    "\"schedule\":{\"on\":\"07:30\",\"off\":\"22:00\"}},"
+    "\"delta\":{\"color\":\"RED\",\"brightness\":80,\"schedule\":{\"off\":\"23:00\"}}},"
+    "\"metadata\":{"
+    "\"desired\":{\"color\":{\"timestamp\":1700000000},\"brightness\":{\"timestamp\":1700000000},"
+    "\"power\":{\"timestamp\":1700000000},"
+    "\"schedule\":{\"on\":{\"timestamp\":1700000000},\"off\":{\"timestamp\":1700000012}}},"
+    "\"reported\":{\"color\":{\"timestamp\":1700000100},\"brightness\":{\"timestamp\":1700000100},"
+    "\"power\":{\"timestamp\":1700000100},\"temperature\":{\"timestamp\":1700000100},"
+    "\"firmware\":{\"timestamp\":1699990000},"
+    "\"schedule\":{\"on\":{\"timestamp\":1699990000},\"off\":{\"timestamp\":1699990000}}}},"
+    "\"version\":1024,\"timestamp\":1700000200,\"clientToken\":\"esp32-shadow-0001\"}";
+
+/* Batch of sensor samples, generated by bench_corpus_create() */
+static char *s_samples;
+
+static int access_provisioning(jparse_ctx_t *jctx)
+{
+    char str[64];
+    int num_devices, num_params;
+    int count = 0;
+
+    count += json_obj_get_string(jctx, "node_id", str, sizeof(str)) == OS_SUCCESS;
+    if (json_obj_get_object(jctx, "info") == OS_SUCCESS) {
+        count += json_obj_get_string(jctx, "fw_version", str, sizeof(str)) == OS_SUCCESS;
+        count += json_obj_get_string(jctx, "model", str, sizeof(str)) == OS_SUCCESS;
+        json_obj_leave_object(jctx);
+    }
+    if (json_obj_get_array(jctx, "devices", &num_devices) == OS_SUCCESS) {
+        for (int d = 0; d < num_devices; d++) {
+            if (json_arr_get_object(jctx, d) != OS_SUCCESS) {
+                continue;
+            }
+            count += json_obj_get_string(jctx, "name", str, sizeof(str)) == OS_SUCCESS;
+            if (json_obj_get_array(jctx, "params", &num_params) == OS_SUCCESS) {
+                for (int p = 0; p < num_params; p++) {
+                    if (json_arr_get_object(jctx, p) != OS_SUCCESS) {
+                        continue;
+                    }
+                    count += json_obj_get_string(jctx, "name", str, sizeof(str)) == OS_SUCCESS;
+                    count += json_obj_get_string(jctx, "data_type", str, sizeof(str)) == OS_SUCCESS;
+                    json_arr_leave_object(jctx);
+                }
+                json_obj_leave_array(jctx);
+            }
+            json_arr_leave_object(jctx);
+        }
+        json_obj_leave_array(jctx);
+    }
+    return count;
+}
+
+static int access_shadow(jparse_ctx_t *jctx)
+{
+    char str[32];
+    int ival;
+    int64_t i64val;
+    float fval;
+    bool bval;
+    int count = 0;
+
+    count += json_obj_get_int(jctx, "version", &ival) == OS_SUCCESS;
+    count += json_obj_get_int64(jctx, "timestamp", &i64val) == OS_SUCCESS;
+    if (json_obj_get_object(jctx, "state") == OS_SUCCESS) {
+        if (json_obj_get_object(jctx, "delta") == OS_SUCCESS) {
+            count += json_obj_get_string(jctx, "color", str, sizeof(str)) == OS_SUCCESS;
+            count += json_obj_get_int(jctx, "brightness", &ival) == OS_SUCCESS;
+            json_obj_leave_object(jctx);
+        }
+        if (json_obj_get_object(jctx, "reported") == OS_SUCCESS) {
+            count += json_obj_get_float(jctx, "temperature", &fval) == OS_SUCCESS;
+            count += json_obj_get_bool(jctx, "power", &bval) == OS_SUCCESS;
+            json_obj_leave_object(jctx);
+        }
+        json_obj_leave_object(jctx);
+    }
+    return count;
+}
+
+static int access_samples(jparse_ctx_t *jctx)
+{
+    int num_samples;
+    int ival;
+    float fval;
+    int count = 0;
+
+    count += json_obj_get_int(jctx, "interval_ms", &ival) == OS_SUCCESS;
+    if (json_obj_get_array(jctx, "samples", &num_samples) == OS_SUCCESS) {
+        for (int i = 0; i < num_samples; i++) {
+            count += json_arr_get_float(jctx, i, &fval) == OS_SUCCESS;
+        }
+        json_obj_leave_array(jctx);
+    }
+    return count;
+}
+
+static bench_doc_t s_docs[] = {
+    { "provisioning", s_provisioning, sizeof(s_provisioning) - 1, access_provisioning },
+    { "aws shadow", s_shadow, sizeof(s_shadow) - 1, access_shadow },
+    { "samples", NULL, 0, access_samples },
+};
+
+int bench_corpus_create(const bench_doc_t **docs)
+{
+    /* At most 9 bytes per sample, like "-999.999," */
+    size_t size = 64 + BENCH_SAMPLE_COUNT * 9;
+    s_samples = malloc(size);
+    if (s_samples == NULL) {
+        return 0;
+    }
+    int len = snprintf(s_samples, size, "{\"device\":\"sensor-01\",\"interval_ms\":10,\"samples\":[");
+    unsigned int seed = 1;
+    for (int i = 0; i < BENCH_SAMPLE_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        int val = (int)((seed >> 8) % 2000000) - 1000000;
+        len += snprintf(s_samples + len, size - len, "%s%s%d.%03d", i ? "," : "", val < 0 ? "-" : "",
+                        abs(val) / 1000, abs(val) % 1000);
+    }
+    len += snprintf(s_samples + len, size - len, "]}");
+    s_docs[2].js = s_samples;
+    s_docs[2].len = len;
+
+    *docs = s_docs;
+    return sizeof(s_docs) / sizeof(s_docs[0]);
+}
+
+void bench_corpus_free(void)
+{
+    free(s_samples);
+    s_samples = NULL;
+}
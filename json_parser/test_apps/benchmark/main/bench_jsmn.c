@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+/* Same configuration as json_parser.c, so that the tokens are the same */
+#define JSMN_PARENT_LINKS
+#define JSMN_STRICT
+#define JSMN_STATIC
+#include "jsmn.h"
+
+#include "benchmark.h"
+
+int bench_jsmn_parse(const char *js, int len, json_tok_t *tokens, int num_tokens)
+{
+    jsmn_parser parser;
+
+    jsmn_init(&parser);
+    return jsmn_parse(&parser, js, len, tokens, num_tokens);
+}
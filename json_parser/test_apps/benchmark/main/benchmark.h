@@ -0,0 +1,25 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#pragma once
+
+#include "json_parser.h"
+
+/* Document of the corpus */
+typedef struct {
+    const char *name;
+    const char *js;
+    int len;
+    /* Reads the values an application typically reads from the document, returns the number of values read */
+    int (*access)(jparse_ctx_t *jctx);
+} bench_doc_t;
+
+/* Fills the documents of the corpus, returns their number */
+int bench_corpus_create(const bench_doc_t **docs);
+void bench_corpus_free(void);
+
+/* Parses the document with jsmn_parse(), with the configuration used by json_parser. Returns the number of tokens */
+int bench_jsmn_parse(const char *js, int len, json_tok_t *tokens, int num_tokens);
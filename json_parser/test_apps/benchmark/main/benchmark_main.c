@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "benchmark.h"
+
+/*
+ * Parses every document of the corpus with raw jsmn_parse(), json_parse_start() and json_parse_start_static(), then
+ * reads the values an application typically reads from it, with and without the key index, and prints a table of
+ * time per document and parsing throughput. Each measurement repeats the operation for at least BENCH_MIN_US.
+ */
+
+static const char *TAG = "benchmark";
+
+#define BENCH_MIN_US    200000
+
+typedef struct {
+    const bench_doc_t *doc;
+    json_tok_t *tokens;
+    int num_tokens;
+} bench_ctx_t;
+
+/* Runs the method once, returns false on failure */
+typedef bool (*bench_method_fn_t)(bench_ctx_t *ctx);
+
+typedef struct {
+    const char *name;
+    bench_method_fn_t run;
+} bench_method_t;
+
+static bool bench_jsmn(bench_ctx_t *ctx)
+{
+    return bench_jsmn_parse(ctx->doc->js, ctx->doc->len, ctx->tokens, ctx->num_tokens) == ctx->num_tokens;
+}
+
+static bool bench_parse(bench_ctx_t *ctx)
+{
+    jparse_ctx_t jctx;
+    if (json_parse_start(&jctx, ctx->doc->js, ctx->doc->len) != OS_SUCCESS) {
+        return false;
+    }
+    json_parse_end(&jctx);
+    return true;
+}
+
+static bool bench_parse_static(bench_ctx_t *ctx)
+{
+    jparse_ctx_t jctx;
+    if (json_parse_start_static(&jctx, ctx->doc->js, ctx->doc->len, ctx->tokens, ctx->num_tokens) != OS_SUCCESS) {
+        return false;
+    }
+    json_parse_end_static(&jctx);
+    return true;
+}
+
+static bool bench_access_common(bench_ctx_t *ctx, bool indexed)
+{
+    jparse_ctx_t jctx;
+    if (json_parse_start(&jctx, ctx->doc->js, ctx->doc->len) != OS_SUCCESS) {
+        return false;
+    }
+    if (indexed) {
+        json_parse_enable_index(&jctx);
+    }
+    int count = ctx->doc->access(&jctx);
+    json_parse_end(&jctx);
+    return count > 0;
+}
+
+static bool bench_access(bench_ctx_t *ctx)
+{
+    return bench_access_common(ctx, false);
+}
+
+static bool bench_access_indexed(bench_ctx_t *ctx)
+{
+    return bench_access_common(ctx, true);
+}
+
+static const bench_method_t s_methods[] = {
+    { "jsmn_parse", bench_jsmn },
+    { "json_parse_start", bench_parse },
+    { "json_parse_start_static", bench_parse_static },
+    { "parse + json_obj_get_*", bench_access },
+    { "parse + index + json_obj_get_*", bench_access_indexed },
+};
+
+static void bench_run(bench_ctx_t *ctx, const bench_method_t *method)
+{
+    /* The first run only loads the caches */
+    bool ok = method->run(ctx);
+    int runs = 0;
+    int64_t start = esp_timer_get_time();
+    int64_t elapsed = 0;
+    while (ok && elapsed < BENCH_MIN_US) {
+        ok = method->run(ctx);
+        runs++;
+        elapsed = esp_timer_get_time() - start;
+    }
+
+    printf("| %-12s | %5d | %6d | %-30s |", ctx->doc->name, ctx->doc->len, ctx->num_tokens, method->name);
+    if (!ok) {
+        printf(" %10s | %10s |\n", "failed", "-");
+        return;
+    }
+    double us = (double)elapsed / runs;
+    printf(" %10.1f | %10.0f |\n", us, ctx->num_tokens * 1e6 / us);
+}
+
+void app_main(void)
+{
+    const bench_doc_t *docs;
+    int num_docs = bench_corpus_create(&docs);
+    if (num_docs == 0) {
+        ESP_LOGE(TAG, "No memory for the corpus");
+        return;
+    }
+
+    printf("| Document     | Bytes | Tokens | Method                         |  us/doc    |  tokens/s  |\n");
+    printf("|--------------|-------|--------|--------------------------------|------------|------------|\n");
+
+    for (int i = 0; i < num_docs; i++) {
+        bench_ctx_t ctx = {
+            .doc = &docs[i],
+            .num_tokens = bench_jsmn_parse(docs[i].js, docs[i].len, NULL, 0),
+        };
+        if (ctx.num_tokens <= 0) {
+            ESP_LOGE(TAG, "Invalid document %s: %d", docs[i].name, ctx.num_tokens);
+            continue;
+        }
+        ctx.tokens = malloc(ctx.num_tokens * sizeof(json_tok_t));
+        if (ctx.tokens == NULL) {
+            ESP_LOGE(TAG, "No memory for %d tokens", ctx.num_tokens);
+            continue;
+        }
+        for (size_t m = 0; m < sizeof(s_methods) / sizeof(s_methods[0]); m++) {
+            bench_run(&ctx, &s_methods[m]);
+        }
+        free(ctx.tokens);
+    }
+    bench_corpus_free();
+    printf("Benchmark done\n");
+}
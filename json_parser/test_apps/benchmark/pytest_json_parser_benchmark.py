@@ -0,0 +1,6 @@
+import pytest
+
+
+@pytest.mark.generic
+def test_json_parser_benchmark(dut) -> None:
+    dut.expect_exact('Benchmark done', timeout=300)
@@ -58,4 +58,220 @@ TEST_CASE("json_parser basic tests", "[json_parser]")
     TEST_ASSERT(int64_val == 109174583252);
 
     json_parse_end(&jctx);
-}
\ No newline at end of file
+}
+TEST_CASE("json_parser grows the token array", "[json_parser]")
+{
+    // Many more tokens than bytes / 8
+    char js[512] = "[";
+    for (int i = 0; i < 100; i++) {
+        strcat(js, i ? ",1" : "1");
+    }
+    strcat(js, "]");
+
+    jparse_ctx_t jctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start(&jctx, js, strlen(js)));
+    TEST_ASSERT_EQUAL(101, jctx.num_tokens);
+    int int_val;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_arr_get_int(&jctx, 99, &int_val));
+    TEST_ASSERT_EQUAL_INT(1, int_val);
+    json_parse_end(&jctx);
+
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_parse_start(&jctx, "{\"a\":", 5));
+}
+
+TEST_CASE("json_parser static token buffer", "[json_parser]")
+{
+    json_tok_t tokens[32];
+    jparse_ctx_t jctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, json_test_str, strlen(json_test_str), tokens, 32));
+    int int_val;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "int_val", &int_val));
+    TEST_ASSERT_EQUAL_INT(2017, int_val);
+    int num_tokens = jctx.num_tokens;
+    json_parse_end_static(&jctx);
+
+    // Exactly enough tokens, then one too few
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start_static(&jctx, json_test_str, strlen(json_test_str), tokens, num_tokens));
+    json_parse_end_static(&jctx);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_parse_start_static(&jctx, json_test_str, strlen(json_test_str), tokens, num_tokens - 1));
+}
+
+TEST_CASE("json_parser key index", "[json_parser]")
+{
+    // Same keys in nested objects, and a duplicate key
+    const char *js = "{\"a\":1,\"obj\":{\"a\":2,\"b\":[{\"a\":3},{\"a\":4}]},\"b\":5,\"a\":6}";
+    jparse_ctx_t jctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start(&jctx, js, strlen(js)));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_enable_index(&jctx));
+
+    int int_val, num_elem;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "a", &int_val));
+    TEST_ASSERT_EQUAL_INT(1, int_val);
+    TEST_ASSERT_NOT_NULL(jctx.key_index);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "b", &int_val));
+    TEST_ASSERT_EQUAL_INT(5, int_val);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_obj_get_int(&jctx, "c", &int_val));
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_object(&jctx, "obj"));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "a", &int_val));
+    TEST_ASSERT_EQUAL_INT(2, int_val);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_array(&jctx, "b", &num_elem));
+    TEST_ASSERT_EQUAL(2, num_elem);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_arr_get_object(&jctx, 1));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "a", &int_val));
+    TEST_ASSERT_EQUAL_INT(4, int_val);
+    json_arr_leave_object(&jctx);
+    json_obj_leave_array(&jctx);
+    json_obj_leave_object(&jctx);
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "b", &int_val));
+    TEST_ASSERT_EQUAL_INT(5, int_val);
+    json_parse_end(&jctx);
+}
+
+typedef struct {
+    bool objects;
+    char arrays[8];
+} test_features_t;
+
+typedef struct {
+    char str_val[16];
+    float float_val;
+    int int_val;
+    bool bool_val;
+    int64_t int_64;
+    test_features_t features;
+    int missing;
+} test_struct_t;
+
+static const json_field_t test_features_fields[] = {
+    JSON_FIELD("objects", JSON_FIELD_BOOL, test_features_t, objects),
+    JSON_FIELD("arrays", JSON_FIELD_STRING, test_features_t, arrays),
+};
+
+static const json_field_t test_struct_fields[] = {
+    JSON_FIELD("str_val", JSON_FIELD_STRING, test_struct_t, str_val),
+    JSON_FIELD("float_val", JSON_FIELD_FLOAT, test_struct_t, float_val),
+    JSON_FIELD("int_val", JSON_FIELD_INT, test_struct_t, int_val),
+    JSON_FIELD("bool_val", JSON_FIELD_BOOL, test_struct_t, bool_val),
+    JSON_FIELD("int_64", JSON_FIELD_INT64, test_struct_t, int_64),
+    JSON_FIELD_OBJECT_OF("features", test_struct_t, features, test_features_fields),
+    JSON_FIELD("missing", JSON_FIELD_INT, test_struct_t, missing),
+    // Wrong type, left untouched
+    JSON_FIELD("supported_el", JSON_FIELD_INT, test_struct_t, missing),
+};
+
+TEST_CASE("json_parser struct binding", "[json_parser]")
+{
+    jparse_ctx_t jctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start(&jctx, json_test_str, strlen(json_test_str)));
+
+    test_struct_t val = {
+        .missing = 42,
+    };
+    int num_fields = sizeof(test_struct_fields) / sizeof(test_struct_fields[0]);
+    TEST_ASSERT_EQUAL(7, json_obj_get_fields(&jctx, test_struct_fields, num_fields, &val));
+    TEST_ASSERT_EQUAL_STRING("JSON Parser", val.str_val);
+    TEST_ASSERT(fabs(val.float_val - 2.0f) < 0.0001f);
+    TEST_ASSERT_EQUAL_INT(2017, val.int_val);
+    TEST_ASSERT_EQUAL(false, val.bool_val);
+    TEST_ASSERT(val.int_64 == 109174583252);
+    TEST_ASSERT_EQUAL(true, val.features.objects);
+    TEST_ASSERT_EQUAL_STRING("yes", val.features.arrays);
+    TEST_ASSERT_EQUAL_INT(42, val.missing);
+
+    // The current element is left unchanged, so the fields can be mixed with the other calls
+    int int_val;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_int(&jctx, "int_val", &int_val));
+    json_parse_end(&jctx);
+}
+
+typedef struct {
+    char values[512];
+    int events;
+} test_stream_t;
+
+static int test_stream_cb(const json_stream_event_t *event, void *arg)
+{
+    test_stream_t *stream = (test_stream_t *)arg;
+    stream->events++;
+    if (event->type == JSON_STREAM_STRING || event->type == JSON_STREAM_PRIMITIVE) {
+        size_t len = strlen(stream->values);
+        snprintf(stream->values + len, sizeof(stream->values) - len, "%s=%s%s", event->path, event->value,
+                 event->partial ? "" : ";");
+    }
+    return OS_SUCCESS;
+}
+
+TEST_CASE("json_parser streaming", "[json_parser]")
+{
+    test_stream_t stream = {0};
+    json_stream_config_t config = {
+        .cb = test_stream_cb,
+        .arg = &stream,
+        .max_depth = 4,
+        .max_path_len = 32,
+        .max_value_len = 12,
+    };
+    json_stream_ctx_t ctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_start(&ctx, &config));
+    // Chunks cut through the keys and values
+    const char *js = json_test_str;
+    int len = strlen(js);
+    for (int i = 0; i < len; i += 3) {
+        TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_feed(&ctx, js + i, len - i < 3 ? len - i : 3));
+    }
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_end(&ctx));
+    TEST_ASSERT_EQUAL_STRING("str_val=JSON Parser;float_val=2.0;int_val=2017;bool_val=false;"
+                             "supported_el[0]=bool;supported_el[1]=int;supported_el[2]=float;supported_el[3]=str;"
+                             "supported_el[4]=object;supported_el[5]=array;features.objects=true;features.arrays=yes;"
+                             "int_64=109174583252;", stream.values);
+    // Root object, the array and the nested object, start and end
+    TEST_ASSERT_EQUAL(13 + 6, stream.events);
+
+    // Incomplete document
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_start(&ctx, &config));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_stream_feed(&ctx, js, len - 1));
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_stream_end(&ctx));
+}
+
+TEST_CASE("json_parser string references and in place unescaping", "[json_parser]")
+{
+    char js[] = "{\"cert\":\"MIIB\\/Zz==\",\"msg\":\"a\\\"b\\\\c\\n\\u00e9\\u20ac\\ud83d\\ude00\\ud800\","
+                "\"list\":[\"x\\ty\"],\"k\\u0065y\":\"v\"}";
+    jparse_ctx_t jctx;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_start(&jctx, js, strlen(js)));
+
+    const char *val;
+    int len;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_string_ref(&jctx, "cert", &val, &len));
+    TEST_ASSERT_EQUAL_PTR(js + 9, val);
+    TEST_ASSERT_EQUAL(10, len);
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_obj_get_string_ref(&jctx, "none", &val, &len));
+
+    char other[] = "{}";
+    TEST_ASSERT_EQUAL(-OS_FAIL, json_parse_unescape_in_place(&jctx, other));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_parse_unescape_in_place(&jctx, js));
+
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_string_ref(&jctx, "cert", &val, &len));
+    TEST_ASSERT_EQUAL(9, len);
+    TEST_ASSERT_EQUAL_MEMORY("MIIB/Zz==", val, len);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_string_ref(&jctx, "msg", &val, &len));
+    const char expected[] = "a\"b\\c\n\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xef\xbf\xbd";
+    TEST_ASSERT_EQUAL(sizeof(expected) - 1, len);
+    TEST_ASSERT_EQUAL_MEMORY(expected, val, len);
+
+    // The copies are unescaped too, the keys are not
+    char str_val[16];
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_string(&jctx, "k\\u0065y", str_val, sizeof(str_val)));
+    TEST_ASSERT_EQUAL_STRING("v", str_val);
+    int num_elem;
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_obj_get_array(&jctx, "list", &num_elem));
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_arr_get_string(&jctx, 0, str_val, sizeof(str_val)));
+    TEST_ASSERT_EQUAL_STRING("x\ty", str_val);
+    TEST_ASSERT_EQUAL(OS_SUCCESS, json_arr_get_string_ref(&jctx, 0, &val, &len));
+    TEST_ASSERT_EQUAL(3, len);
+    json_obj_leave_array(&jctx);
+
+    json_parse_end(&jctx);
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+#include "esp_idf_version.h"
+#include "led_strip.h"
+#include "esp_log.h"
+#include "esp_err.h"
+
+// GPIO assignment
+#define LED_STRIP_GPIO_PIN  2
+// Numbers of the LED in the strip
+#define LED_STRIP_LED_COUNT 256
+// Number of refreshes of every benchmark
+#define BENCH_REFRESH_COUNT 100
+
+// The SPI backend relies on some feature that was available in IDF 5.1
+#define BENCH_SPI_SUPPORTED (SOC_GPSPI_SUPPORTED && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0))
+
+static const char *TAG = "example";
+
+static const led_strip_config_t s_strip_config = {
+    .strip_gpio_num = LED_STRIP_GPIO_PIN, // The GPIO that connected to the LED strip's data line
+    .max_leds = LED_STRIP_LED_COUNT,      // The number of LEDs in the strip,
+    .led_model = LED_MODEL_WS2812,        // LED strip model
+    .color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB, // The color order of the strip: GRB
+};
+
+// Refresh the strip with a moving pattern, and compare the measured timing with the shortest possible refresh time
+static void bench_strip(const char *name, led_strip_handle_t led_strip, led_strip_backend_t backend)
+{
+    static uint8_t rgb[LED_STRIP_LED_COUNT * 3];
+    led_strip_refresh_stats_t stats;
+    uint32_t min_time_us = 0;
+
+    ESP_ERROR_CHECK(led_strip_get_min_refresh_time(&s_strip_config, backend, &min_time_us));
+    ESP_ERROR_CHECK(led_strip_reset_refresh_stats(led_strip));
+    for (int frame = 0; frame < BENCH_REFRESH_COUNT; frame++) {
+        for (int i = 0; i < sizeof(rgb); i++) {
+            rgb[i] = (i + frame) & 0x0F;
+        }
+        ESP_ERROR_CHECK(led_strip_set_pixels(led_strip, 0, LED_STRIP_LED_COUNT, rgb));
+        ESP_ERROR_CHECK(led_strip_refresh(led_strip));
+    }
+    ESP_ERROR_CHECK(led_strip_get_refresh_stats(led_strip, &stats));
+
+    ESP_LOGI(TAG, "%s: %"PRIu32" refreshes, start %"PRIu32" us (max %"PRIu32"), transmit %"PRIu32" us (max %"PRIu32"), "
+             "frame interval %"PRIu32" us", name, stats.refresh_count, stats.start_time_us, stats.max_start_time_us,
+             stats.transmit_time_us, stats.max_transmit_time_us, stats.avg_frame_interval_us);
+    ESP_LOGI(TAG, "%s: %.1f fps, at most %.1f fps for %d LEDs", name, 1000000.0f / stats.avg_frame_interval_us,
+             1000000.0f / min_time_us, LED_STRIP_LED_COUNT);
+    ESP_ERROR_CHECK(led_strip_del(led_strip));
+}
+
+static void bench_rmt(const char *name, bool with_dma)
+{
+    led_strip_rmt_config_t rmt_config = {
+        .clk_src = RMT_CLK_SRC_DEFAULT,         // different clock source can lead to different power consumption
+        .resolution_hz = 10 * 1000 * 1000,      // 10MHz resolution, 1 tick = 0.1us
+        .mem_block_symbols = with_dma ? 1024 : 0, // the DMA block size, or the default memory block size without DMA
+        .flags = {
+            .with_dma = with_dma,
+        }
+    };
+    led_strip_handle_t led_strip;
+    ESP_ERROR_CHECK(led_strip_new_rmt_device(&s_strip_config, &rmt_config, &led_strip));
+    bench_strip(name, led_strip, LED_STRIP_BACKEND_RMT);
+}
+
+#if BENCH_SPI_SUPPORTED
+static void bench_spi(void)
+{
+    led_strip_spi_config_t spi_config = {
+        .clk_src = SPI_CLK_SRC_DEFAULT, // different clock source can lead to different power consumption
+        .spi_bus = SPI2_HOST,           // SPI bus ID
+        .flags = {
+            .with_dma = true, // the SPI backend needs DMA for long strips
+        }
+    };
+    led_strip_handle_t led_strip;
+    ESP_ERROR_CHECK(led_strip_new_spi_device(&s_strip_config, &spi_config, &led_strip));
+    bench_strip("SPI", led_strip, LED_STRIP_BACKEND_SPI);
+}
+#endif
+
+void app_main(void)
+{
+#if SOC_RMT_SUPPORTED
+    bench_rmt("RMT", false);
+#if SOC_RMT_SUPPORT_DMA
+    bench_rmt("RMT DMA", true);
+#endif
+#endif
+#if BENCH_SPI_SUPPORTED
+    bench_spi();
+#endif
+    ESP_LOGI(TAG, "Benchmark done");
+}
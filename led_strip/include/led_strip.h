@@ -30,6 +30,26 @@ extern "C" {
  */
 esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue);
 
+/**
+ * @brief Set RGB for a range of pixels from a packed buffer
+ *
+ * @note The buffer holds the red, green and blue parts of every pixel, in this order, whatever the
+ *       color component format of the strip. The white component of RGBW strips is set to 0.
+ * @note Faster than calling `led_strip_set_pixel` for every pixel, the color component format is applied
+ *       to the whole range at once.
+ *
+ * @param strip: LED strip
+ * @param start: index of the first pixel to set
+ * @param count: number of pixels to set
+ * @param rgb: packed colors, 3 bytes per pixel
+ *
+ * @return
+ *      - ESP_OK: Set RGB for the pixels successfully
+ *      - ESP_ERR_INVALID_ARG: Set RGB for the pixels failed because of invalid parameters
+ *      - ESP_FAIL: Set RGB for the pixels failed because other error occurred
+ */
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *rgb);
+
 /**
  * @brief Set RGBW for a specific pixel
  *
@@ -66,6 +86,25 @@ esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uin
  */
 esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value);
 
+/**
+ * @brief Set the gamma and brightness correction of the LED strip
+ *
+ * @note The correction is applied to every color component by the encoder, when the pixels are transmitted:
+ *       the colors in memory are left as set by `led_strip_set_pixel`, and a change of the correction takes effect
+ *       at the next refresh without setting the pixels again.
+ * @note Waits for the refresh in progress to be done.
+ *
+ * @param strip: LED strip
+ * @param config: Color correction. NULL, or a gamma of 1.0 with full brightness and no dithering, disables the correction
+ *
+ * @return
+ *      - ESP_OK: Set the color correction successfully
+ *      - ESP_ERR_INVALID_ARG: Set the color correction failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: The backend does not support color correction (SPI)
+ *      - ESP_ERR_NO_MEM: Set the color correction failed because of out of memory
+ */
+esp_err_t led_strip_set_color_correction(led_strip_handle_t strip, const led_strip_color_correction_t *config);
+
 /**
  * @brief Refresh memory colors to LEDs
  *
@@ -80,6 +119,54 @@ esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint
  */
 esp_err_t led_strip_refresh(led_strip_handle_t strip);
 
+/**
+ * @brief Start refreshing memory colors to LEDs, without waiting for the end of the transmission
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Refresh started successfully
+ *      - ESP_ERR_NOT_SUPPORTED: The backend does not support asynchronous refresh
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ *
+ * @note:
+ *      With the `double_buffer` flag, the pixels are copied to the second buffer which is transmitted, the pixels can be set
+ *      for the next frame right after this function returns. It waits for the previous refresh to be done first.
+ *      Without it, the pixels must not be set until the refresh is done, see `led_strip_refresh_wait_done` and
+ *      `led_strip_register_refresh_done_callback`.
+ */
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip);
+
+/**
+ * @brief Wait for the refresh started by `led_strip_refresh_async` to be done
+ *
+ * @param strip: LED strip
+ * @param timeout_ms: Wait timeout, in ms. `-1` means to wait forever
+ *
+ * @return
+ *      - ESP_OK: Refresh done
+ *      - ESP_ERR_TIMEOUT: Refresh not done within the timeout
+ *      - ESP_ERR_NOT_SUPPORTED: The backend does not support asynchronous refresh
+ *      - ESP_FAIL: Wait failed because some other error occurred
+ */
+esp_err_t led_strip_refresh_wait_done(led_strip_handle_t strip, int timeout_ms);
+
+/**
+ * @brief Register a callback called when a refresh is done
+ *
+ * @param strip: LED strip
+ * @param cb: Callback, called from the ISR context at the end of each refresh. NULL to unregister
+ * @param user_ctx: User context passed to the callback
+ *
+ * @return
+ *      - ESP_OK: Register the callback successfully
+ *      - ESP_ERR_NOT_SUPPORTED: The backend does not support the refresh done callback
+ *
+ * @note:
+ *      Do not call this function while a refresh is in progress.
+ */
+esp_err_t led_strip_register_refresh_done_callback(led_strip_handle_t strip, led_strip_refresh_done_cb_t cb, void *user_ctx);
+
 /**
  * @brief Clear LED strip (turn off all LEDs)
  *
@@ -102,6 +189,48 @@ esp_err_t led_strip_clear(led_strip_handle_t strip);
  */
 esp_err_t led_strip_del(led_strip_handle_t strip);
 
+/**
+ * @brief Get the refresh timing statistics of the LED strip
+ *
+ * @param strip: LED strip
+ * @param[out] stats: Refresh timing statistics
+ *
+ * @return
+ *      - ESP_OK: Get the statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get the statistics failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_LED_STRIP_REFRESH_STATS is disabled
+ */
+esp_err_t led_strip_get_refresh_stats(led_strip_handle_t strip, led_strip_refresh_stats_t *stats);
+
+/**
+ * @brief Reset the refresh timing statistics of the LED strip
+ *
+ * @param strip: LED strip
+ *
+ * @return
+ *      - ESP_OK: Reset the statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Reset the statistics failed because of invalid parameters
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_LED_STRIP_REFRESH_STATS is disabled
+ */
+esp_err_t led_strip_reset_refresh_stats(led_strip_handle_t strip);
+
+/**
+ * @brief Get the shortest possible time of a refresh, which gives the highest possible frame rate
+ *
+ * @note This is the time on the wire for `max_leds` pixels with the bit timing the backend uses for the LED model,
+ *       followed by the reset time of the LED model, see `led_strip_get_refresh_stats` for the achieved time.
+ *       The time is the same with and without DMA for the RMT backend.
+ *
+ * @param led_config: LED strip configuration, only `max_leds`, `led_model` and `color_component_format` are used
+ * @param backend: Backend peripheral
+ * @param[out] ret_time_us: Shortest time of a refresh, in us
+ *
+ * @return
+ *      - ESP_OK: Get the refresh time successfully
+ *      - ESP_ERR_INVALID_ARG: Get the refresh time failed because of invalid parameters
+ */
+esp_err_t led_strip_get_min_refresh_time(const led_strip_config_t *led_config, led_strip_backend_t backend, uint32_t *ret_time_us);
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,77 @@ typedef struct {
  */
 esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const led_strip_rmt_config_t *rmt_config, led_strip_handle_t *ret_strip);
 
+/**
+ * @brief Type of LED strip group handle
+ */
+typedef struct led_strip_rmt_group_t *led_strip_rmt_group_handle_t;
+
+/**
+ * @brief Create a group of RMT LED strips which are refreshed in lockstep
+ *
+ * @note The RMT channels of the strips are synchronized by the RMT sync manager, the transmissions to all the strips
+ *       start at the same time. The refresh of the group then takes as long as the refresh of the longest strip.
+ * @note The strips cannot be refreshed or cleared on their own while they are in the group, use
+ *       `led_strip_rmt_group_refresh` instead. Their pixels are still set with the `led_strip_set_pixel` functions.
+ * @note Only supported by the targets with RMT TX synchronization (SOC_RMT_SUPPORT_TX_SYNCHRO).
+ *
+ * @param strips Array of LED strips created by `led_strip_new_rmt_device`
+ * @param num_strips Number of LED strips in the array
+ * @param ret_group Returned LED strip group handle
+ * @return
+ *      - ESP_OK: create LED strip group successfully
+ *      - ESP_ERR_INVALID_ARG: create LED strip group failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: create LED strip group failed because a strip is already in a group
+ *      - ESP_ERR_NO_MEM: create LED strip group failed because of out of memory
+ *      - ESP_ERR_NOT_SUPPORTED: create LED strip group failed because the target can't synchronize RMT TX channels
+ *      - ESP_FAIL: create LED strip group failed because some other error
+ */
+esp_err_t led_strip_new_rmt_group(const led_strip_handle_t *strips, size_t num_strips, led_strip_rmt_group_handle_t *ret_group);
+
+/**
+ * @brief Refresh memory colors to the LEDs of all the strips of the group, and wait for it to be done
+ *
+ * @param group LED strip group
+ * @return
+ *      - ESP_OK: Refresh successfully
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group);
+
+/**
+ * @brief Start refreshing memory colors to the LEDs of all the strips of the group
+ *
+ * @note Waits for the previous refresh of the group to be done first.
+ *
+ * @param group LED strip group
+ * @return
+ *      - ESP_OK: Refresh started successfully
+ *      - ESP_FAIL: Refresh failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_refresh_async(led_strip_rmt_group_handle_t group);
+
+/**
+ * @brief Wait for the refresh of the group started by `led_strip_rmt_group_refresh_async` to be done
+ *
+ * @param group LED strip group
+ * @param timeout_ms Wait timeout for each strip, in ms. `-1` means to wait forever
+ * @return
+ *      - ESP_OK: Refresh done
+ *      - ESP_ERR_TIMEOUT: Refresh not done within the timeout
+ *      - ESP_FAIL: Wait failed because some other error occurred
+ */
+esp_err_t led_strip_rmt_group_wait_done(led_strip_rmt_group_handle_t group, int timeout_ms);
+
+/**
+ * @brief Delete the LED strip group, the strips can then be refreshed on their own again
+ *
+ * @param group LED strip group
+ * @return
+ *      - ESP_OK: delete LED strip group successfully
+ *      - ESP_FAIL: delete LED strip group failed because some other error
+ */
+esp_err_t led_strip_del_rmt_group(led_strip_rmt_group_handle_t group);
+
 #ifdef __cplusplus
 }
 #endif
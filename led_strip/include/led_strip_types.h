@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,6 +17,17 @@ extern "C" {
  */
 typedef struct led_strip_t *led_strip_handle_t;
 
+/**
+ * @brief Type of LED strip refresh done callback
+ *
+ * @param strip: LED strip
+ * @param user_ctx: User context passed to `led_strip_register_refresh_done_callback`
+ * @return Whether a high priority task has been woken up by this callback
+ *
+ * @note This callback is called from the ISR context, it must not block
+ */
+typedef bool (*led_strip_refresh_done_cb_t)(led_strip_handle_t strip, void *user_ctx);
+
 /**
  * @brief LED strip model
  * @note Different led model may have different timing parameters, so we need to distinguish them.
@@ -62,9 +74,45 @@ typedef struct {
     /*!< LED strip extra driver flags */
     struct led_strip_extra_flags {
         uint32_t invert_out: 1; /*!< Invert output signal */
+        uint32_t double_buffer: 1; /*!< Allocate a second pixel buffer, so that the pixels can be set while `led_strip_refresh_async` transmits the previous frame */
     } flags; /*!< Extra driver flags */
 } led_strip_config_t;
 
+/**
+ * @brief LED strip color correction, applied to every color component when the pixels are transmitted
+ */
+typedef struct {
+    float gamma;                    /*!< Gamma exponent, the component c is sent as 255 * (c / 255) ^ gamma. 1.0 for no gamma correction, 2.2 to 2.8 are usual */
+    uint8_t brightness;             /*!< Global brightness, scales the gamma corrected components. 255 for full brightness */
+    /*!< Color correction flags */
+    struct led_strip_color_correction_flags {
+        uint32_t dithering: 1;      /*!< Temporal dithering, the fractional part of the corrected components is spread over 8 refreshes */
+    } flags;                        /*!< Color correction flags */
+} led_strip_color_correction_t;
+
+/**
+ * @brief LED strip backend peripheral
+ */
+typedef enum {
+    LED_STRIP_BACKEND_RMT, /*!< RMT backend, see `led_strip_new_rmt_device` */
+    LED_STRIP_BACKEND_SPI, /*!< SPI backend, see `led_strip_new_spi_device` */
+} led_strip_backend_t;
+
+/**
+ * @brief LED strip refresh timing, measured with CONFIG_LED_STRIP_REFRESH_STATS
+ */
+typedef struct {
+    uint32_t refresh_count;             /*!< Number of refreshes started since the creation of the strip or the last reset of the statistics */
+    uint32_t start_time_us;             /*!< Time to start the last refresh: wait for the previous one with the double buffer, copy of the pixels,
+                                             first encoding pass and queueing of the transmission */
+    uint32_t max_start_time_us;         /*!< Longest time to start a refresh */
+    uint32_t transmit_time_us;          /*!< Time of the transmission of the last refresh done, from its queueing, or from the end of the previous
+                                             transmission if it was queued behind it, to its end. Includes the reset code of the RMT backend */
+    uint32_t max_transmit_time_us;      /*!< Longest time to transmit a refresh */
+    uint32_t frame_interval_us;         /*!< Time between the starts of the last two refreshes */
+    uint32_t avg_frame_interval_us;     /*!< Average time between the starts of two refreshes, the achieved frame rate is 1000000 / avg_frame_interval_us */
+} led_strip_refresh_stats_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,7 +6,9 @@
 #pragma once
 
 #include <stdint.h>
+#include "sdkconfig.h"
 #include "esp_err.h"
+#include "led_strip_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +53,39 @@ struct led_strip_t {
      */
     esp_err_t (*set_pixel_rgbw)(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white);
 
+    /**
+     * @brief Set RGB for a range of pixels from a packed buffer
+     *
+     * @param strip: LED strip
+     * @param start: index of the first pixel to set
+     * @param count: number of pixels to set
+     * @param rgb: packed colors, 3 bytes per pixel in the R-G-B order
+     *
+     * @return
+     *      - ESP_OK: Set RGB for the pixels successfully
+     *      - ESP_ERR_INVALID_ARG: Set RGB for the pixels failed because of invalid parameters
+     *      - ESP_FAIL: Set RGB for the pixels failed because other error occurred
+     *
+     * @note:
+     *      Optional, NULL if the backend does not support it, `set_pixel` is then called for every pixel.
+     */
+    esp_err_t (*set_pixels)(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb);
+
+    /**
+     * @brief Set the gamma and brightness correction applied when the pixels are transmitted
+     *
+     * @param strip: LED strip
+     * @param config: Color correction, NULL to disable it
+     *
+     * @return
+     *      - ESP_OK: Set the color correction successfully
+     *      - ESP_ERR_NO_MEM: Set the color correction failed because of out of memory
+     *
+     * @note:
+     *      Optional, NULL if the backend does not support color correction.
+     */
+    esp_err_t (*set_color_correction)(led_strip_t *strip, const led_strip_color_correction_t *config);
+
     /**
      * @brief Refresh memory colors to LEDs
      *
@@ -66,6 +101,48 @@ struct led_strip_t {
      */
     esp_err_t (*refresh)(led_strip_t *strip);
 
+    /**
+     * @brief Start refreshing memory colors to LEDs, without waiting for the end of the transmission
+     *
+     * @param strip: LED strip
+     *
+     * @return
+     *      - ESP_OK: Refresh started successfully
+     *      - ESP_FAIL: Refresh failed because some other error occurred
+     *
+     * @note:
+     *      Optional, NULL if the backend does not support asynchronous refresh.
+     */
+    esp_err_t (*refresh_async)(led_strip_t *strip);
+
+    /**
+     * @brief Wait for the refresh started by `refresh_async` to be done
+     *
+     * @param strip: LED strip
+     * @param timeout_ms: Wait timeout, in ms. `-1` means to wait forever
+     *
+     * @return
+     *      - ESP_OK: Refresh done
+     *      - ESP_ERR_TIMEOUT: Refresh not done within the timeout
+     *      - ESP_FAIL: Wait failed because some other error occurred
+     */
+    esp_err_t (*refresh_wait_done)(led_strip_t *strip, int timeout_ms);
+
+    /**
+     * @brief Register a callback called from the ISR context when a refresh is done
+     *
+     * @param strip: LED strip
+     * @param cb: Callback, NULL to unregister
+     * @param user_ctx: User context passed to the callback
+     *
+     * @return
+     *      - ESP_OK: Register the callback successfully
+     *
+     * @note:
+     *      Optional, NULL if the backend does not support the refresh done callback.
+     */
+    esp_err_t (*register_refresh_done_cb)(led_strip_t *strip, led_strip_refresh_done_cb_t cb, void *user_ctx);
+
     /**
      * @brief Clear LED strip (turn off all LEDs)
      *
@@ -88,8 +165,42 @@ struct led_strip_t {
      *      - ESP_FAIL: Free resources failed because error occurred
      */
     esp_err_t (*del)(led_strip_t *strip);
+
+#if CONFIG_LED_STRIP_REFRESH_STATS
+    /**
+     * @brief Refresh timing, updated by the backend through the `led_strip_stats_refresh_*` functions
+     */
+    struct {
+        int64_t first_start;                /*!< Time of the start of the first refresh */
+        int64_t last_start;                 /*!< Time of the start of the last refresh */
+        int64_t last_queued;                /*!< Time the last refresh was queued */
+        int64_t last_done;                  /*!< Time the last refresh was done */
+        led_strip_refresh_stats_t stats;    /*!< Statistics returned by `led_strip_get_refresh_stats` */
+    } refresh_record;
+#endif
 };
 
+#if CONFIG_LED_STRIP_REFRESH_STATS
+/**
+ * @brief Record the start of a refresh, called by the backend when the refresh is requested
+ */
+void led_strip_stats_refresh_start(led_strip_t *strip);
+
+/**
+ * @brief Record the queueing of the transmission of the refresh, called by the backend once the peripheral has it
+ */
+void led_strip_stats_refresh_queued(led_strip_t *strip);
+
+/**
+ * @brief Record the end of the transmission of a refresh, called by the backend from the ISR context
+ */
+void led_strip_stats_refresh_done(led_strip_t *strip);
+#else
+#define led_strip_stats_refresh_start(strip)
+#define led_strip_stats_refresh_queued(strip)
+#define led_strip_stats_refresh_done(strip)
+#endif
+
 #ifdef __cplusplus
 }
 #endif
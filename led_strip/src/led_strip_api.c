@@ -3,8 +3,10 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <string.h>
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_timer.h"
 #include "led_strip.h"
 #include "led_strip_interface.h"
 
@@ -16,6 +18,18 @@ esp_err_t led_strip_set_pixel(led_strip_handle_t strip, uint32_t index, uint32_t
     return strip->set_pixel(strip, index, red, green, blue);
 }
 
+esp_err_t led_strip_set_pixels(led_strip_handle_t strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    ESP_RETURN_ON_FALSE(strip && (rgb || !count), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (strip->set_pixels) {
+        return strip->set_pixels(strip, start, count, rgb);
+    }
+    for (uint32_t i = 0; i < count; i++, rgb += 3) {
+        ESP_RETURN_ON_ERROR(strip->set_pixel(strip, start + i, rgb[0], rgb[1], rgb[2]), TAG, "set pixel failed");
+    }
+    return ESP_OK;
+}
+
 esp_err_t led_strip_set_pixel_hsv(led_strip_handle_t strip, uint32_t index, uint16_t hue, uint8_t saturation, uint8_t value)
 {
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
@@ -75,12 +89,41 @@ esp_err_t led_strip_set_pixel_rgbw(led_strip_handle_t strip, uint32_t index, uin
     return strip->set_pixel_rgbw(strip, index, red, green, blue, white);
 }
 
+esp_err_t led_strip_set_color_correction(led_strip_handle_t strip, const led_strip_color_correction_t *config)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!config || config->gamma > 0.0f, ESP_ERR_INVALID_ARG, TAG, "invalid gamma");
+    ESP_RETURN_ON_FALSE(strip->set_color_correction, ESP_ERR_NOT_SUPPORTED, TAG, "color correction not supported");
+    return strip->set_color_correction(strip, config);
+}
+
 esp_err_t led_strip_refresh(led_strip_handle_t strip)
 {
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
     return strip->refresh(strip);
 }
 
+esp_err_t led_strip_refresh_async(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->refresh_async, ESP_ERR_NOT_SUPPORTED, TAG, "asynchronous refresh not supported");
+    return strip->refresh_async(strip);
+}
+
+esp_err_t led_strip_refresh_wait_done(led_strip_handle_t strip, int timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->refresh_wait_done, ESP_ERR_NOT_SUPPORTED, TAG, "asynchronous refresh not supported");
+    return strip->refresh_wait_done(strip, timeout_ms);
+}
+
+esp_err_t led_strip_register_refresh_done_callback(led_strip_handle_t strip, led_strip_refresh_done_cb_t cb, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(strip->register_refresh_done_cb, ESP_ERR_NOT_SUPPORTED, TAG, "refresh done callback not supported");
+    return strip->register_refresh_done_cb(strip, cb, user_ctx);
+}
+
 esp_err_t led_strip_clear(led_strip_handle_t strip)
 {
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
@@ -92,3 +135,95 @@ esp_err_t led_strip_del(led_strip_handle_t strip)
     ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
     return strip->del(strip);
 }
+
+esp_err_t led_strip_get_refresh_stats(led_strip_handle_t strip, led_strip_refresh_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(strip && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+#if CONFIG_LED_STRIP_REFRESH_STATS
+    *stats = strip->refresh_record.stats;
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t led_strip_reset_refresh_stats(led_strip_handle_t strip)
+{
+    ESP_RETURN_ON_FALSE(strip, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+#if CONFIG_LED_STRIP_REFRESH_STATS
+    memset(&strip->refresh_record, 0, sizeof(strip->refresh_record));
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+#if CONFIG_LED_STRIP_REFRESH_STATS
+void led_strip_stats_refresh_start(led_strip_t *strip)
+{
+    int64_t now = esp_timer_get_time();
+    led_strip_refresh_stats_t *stats = &strip->refresh_record.stats;
+
+    if (stats->refresh_count) {
+        stats->frame_interval_us = now - strip->refresh_record.last_start;
+        stats->avg_frame_interval_us = (now - strip->refresh_record.first_start) / stats->refresh_count;
+    } else {
+        strip->refresh_record.first_start = now;
+    }
+    strip->refresh_record.last_start = now;
+    stats->refresh_count++;
+}
+
+void led_strip_stats_refresh_queued(led_strip_t *strip)
+{
+    int64_t now = esp_timer_get_time();
+    led_strip_refresh_stats_t *stats = &strip->refresh_record.stats;
+
+    stats->start_time_us = now - strip->refresh_record.last_start;
+    if (stats->start_time_us > stats->max_start_time_us) {
+        stats->max_start_time_us = stats->start_time_us;
+    }
+    strip->refresh_record.last_queued = now;
+}
+
+void led_strip_stats_refresh_done(led_strip_t *strip)
+{
+    int64_t now = esp_timer_get_time();
+    led_strip_refresh_stats_t *stats = &strip->refresh_record.stats;
+    int64_t tx_start = strip->refresh_record.last_queued;
+
+    // a transmission queued behind the previous one starts at the end of the previous one
+    if (strip->refresh_record.last_done > tx_start) {
+        tx_start = strip->refresh_record.last_done;
+    }
+    stats->transmit_time_us = now - tx_start;
+    if (stats->transmit_time_us > stats->max_transmit_time_us) {
+        stats->max_transmit_time_us = stats->transmit_time_us;
+    }
+    strip->refresh_record.last_done = now;
+}
+#endif // CONFIG_LED_STRIP_REFRESH_STATS
+
+esp_err_t led_strip_get_min_refresh_time(const led_strip_config_t *led_config, led_strip_backend_t backend, uint32_t *ret_time_us)
+{
+    // bit period sent by the RMT backend, and reset time, of every LED model
+    static const struct {
+        uint32_t bit_ns;
+        uint32_t reset_us;
+    } led_model_timing[LED_MODEL_INVALID] = {
+        [LED_MODEL_WS2812] = {.bit_ns = 1200, .reset_us = 280},
+        [LED_MODEL_SK6812] = {.bit_ns = 1200, .reset_us = 280},
+        [LED_MODEL_WS2811] = {.bit_ns = 2500, .reset_us = 50},
+    };
+    ESP_RETURN_ON_FALSE(led_config && ret_time_us, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(led_config->led_model < LED_MODEL_INVALID, ESP_ERR_INVALID_ARG, TAG, "invalid led model");
+    ESP_RETURN_ON_FALSE(backend == LED_STRIP_BACKEND_RMT || backend == LED_STRIP_BACKEND_SPI, ESP_ERR_INVALID_ARG, TAG, "invalid backend");
+
+    // same default as the backends when the format is not specified
+    uint32_t num_components = led_config->color_component_format.format_id ? led_config->color_component_format.format.num_components : 3;
+    // the SPI backend sends every bit as 3 SPI bits at 2.5 MHz, whatever the LED model
+    uint32_t bit_ns = backend == LED_STRIP_BACKEND_SPI ? 1200 : led_model_timing[led_config->led_model].bit_ns;
+    uint64_t bits = (uint64_t)led_config->max_leds * num_components * 8;
+    *ret_time_us = (bits * bit_ns + 999) / 1000 + led_model_timing[led_config->led_model].reset_us;
+    return ESP_OK;
+}
@@ -12,6 +12,7 @@
 #include "led_strip.h"
 #include "led_strip_interface.h"
 #include "led_strip_rmt_encoder.h"
+#include "soc/soc_caps.h"
 
 #define LED_STRIP_RMT_DEFAULT_RESOLUTION 10000000 // 10MHz resolution
 #define LED_STRIP_RMT_DEFAULT_TRANS_QUEUE_SIZE 4
@@ -24,6 +25,8 @@
 
 static const char *TAG = "led_strip_rmt";
 
+typedef struct led_strip_rmt_group_t led_strip_rmt_group_t;
+
 typedef struct {
     led_strip_t base;
     rmt_channel_handle_t rmt_chan;
@@ -31,9 +34,22 @@ typedef struct {
     uint32_t strip_len;
     uint8_t bytes_per_pixel;
     led_color_component_format_t component_fmt;
+    bool is_enabled;                                // RMT channel is enabled, from the first refresh until the wait for it to be done
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    uint8_t *tx_buf;                                // Buffer on the wire with the `double_buffer` flag, NULL otherwise
+    led_strip_rmt_group_t *group;                   // Group refreshing the strip, NULL if the strip is refreshed alone
     uint8_t pixel_buf[];
 } led_strip_rmt_obj;
 
+struct led_strip_rmt_group_t {
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+    rmt_sync_manager_handle_t sync_manager;
+#endif
+    size_t num_strips;
+    led_strip_rmt_obj *strips[];
+};
+
 static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
 {
     led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
@@ -53,6 +69,37 @@ static esp_err_t led_strip_rmt_set_pixel(led_strip_t *strip, uint32_t index, uin
     return ESP_OK;
 }
 
+static esp_err_t led_strip_rmt_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(count <= rmt_strip->strip_len && start <= rmt_strip->strip_len - count, ESP_ERR_INVALID_ARG, TAG,
+                        "index out of maximum number of LEDs");
+
+    led_color_component_format_t component_fmt = rmt_strip->component_fmt;
+    uint8_t bytes_per_pixel = rmt_strip->bytes_per_pixel;
+    // position in the pixel of the R, G and B bytes of the packed buffer
+    const uint8_t pos[3] = {component_fmt.format.r_pos, component_fmt.format.g_pos, component_fmt.format.b_pos};
+    uint8_t *pixel = rmt_strip->pixel_buf + start * bytes_per_pixel;
+
+    if (bytes_per_pixel > 3) {
+        uint32_t w_pos = component_fmt.format.w_pos;
+        for (uint32_t i = 0; i < count; i++, pixel += bytes_per_pixel, rgb += 3) {
+            pixel[pos[0]] = rgb[0];
+            pixel[pos[1]] = rgb[1];
+            pixel[pos[2]] = rgb[2];
+            pixel[w_pos] = 0;
+        }
+    } else {
+        for (uint32_t i = 0; i < count; i++, pixel += 3, rgb += 3) {
+            pixel[pos[0]] = rgb[0];
+            pixel[pos[1]] = rgb[1];
+            pixel[pos[2]] = rgb[2];
+        }
+    }
+
+    return ESP_OK;
+}
+
 static esp_err_t led_strip_rmt_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
 {
     led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
@@ -71,21 +118,86 @@ static esp_err_t led_strip_rmt_set_pixel_rgbw(led_strip_t *strip, uint32_t index
     return ESP_OK;
 }
 
-static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+// Queue the transmission of the pixels, the RMT channel must be enabled
+static esp_err_t led_strip_rmt_transmit(led_strip_rmt_obj *rmt_strip)
 {
-    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
     rmt_transmit_config_t tx_conf = {
         .loop_count = 0,
     };
+    size_t buf_size = rmt_strip->strip_len * rmt_strip->bytes_per_pixel;
+    uint8_t *tx_buf = rmt_strip->pixel_buf;
+
+    led_strip_stats_refresh_start(&rmt_strip->base);
+    if (rmt_strip->tx_buf) {
+        // the encoder reads the buffer on the wire until the end of the transmission
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+        memcpy(rmt_strip->tx_buf, rmt_strip->pixel_buf, buf_size);
+        tx_buf = rmt_strip->tx_buf;
+    }
+    ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, tx_buf, buf_size, &tx_conf),
+                        TAG, "transmit pixels by RMT failed");
+    led_strip_stats_refresh_queued(&rmt_strip->base);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh_async(led_strip_t *strip)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // a synchronized channel would wait for the other channels of the group to transmit too
+    ESP_RETURN_ON_FALSE(!rmt_strip->group, ESP_ERR_INVALID_STATE, TAG, "strip is refreshed by its group");
 
-    ESP_RETURN_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), TAG, "enable RMT channel failed");
-    ESP_RETURN_ON_ERROR(rmt_transmit(rmt_strip->rmt_chan, rmt_strip->strip_encoder, rmt_strip->pixel_buf,
-                                     rmt_strip->strip_len * rmt_strip->bytes_per_pixel, &tx_conf), TAG, "transmit pixels by RMT failed");
-    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    if (!rmt_strip->is_enabled) {
+        ESP_RETURN_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), TAG, "enable RMT channel failed");
+        rmt_strip->is_enabled = true;
+    }
+    return led_strip_rmt_transmit(rmt_strip);
+}
+
+static esp_err_t led_strip_rmt_refresh_wait_done(led_strip_t *strip, int timeout_ms)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->group, ESP_ERR_INVALID_STATE, TAG, "strip is refreshed by its group");
+    if (!rmt_strip->is_enabled) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, timeout_ms), TAG, "flush RMT channel failed");
     ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    rmt_strip->is_enabled = false;
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_rmt_refresh(led_strip_t *strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_refresh_async(strip), TAG, "start refresh failed");
+    return led_strip_rmt_refresh_wait_done(strip, -1);
+}
+
+static bool led_strip_rmt_trans_done_cb(rmt_channel_handle_t tx_chan, const rmt_tx_done_event_data_t *edata, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = (led_strip_rmt_obj *)user_ctx;
+    led_strip_refresh_done_cb_t on_refresh_done = rmt_strip->on_refresh_done;
+    led_strip_stats_refresh_done(&rmt_strip->base);
+    return on_refresh_done ? on_refresh_done(&rmt_strip->base, rmt_strip->user_ctx) : false;
+}
+
+static esp_err_t led_strip_rmt_register_refresh_done_cb(led_strip_t *strip, led_strip_refresh_done_cb_t cb, void *user_ctx)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    rmt_strip->user_ctx = user_ctx;
+    rmt_strip->on_refresh_done = cb;
     return ESP_OK;
 }
 
+static esp_err_t led_strip_rmt_set_color_correction(led_strip_t *strip, const led_strip_color_correction_t *config)
+{
+    led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    // the encoder reads the correction table until the end of the transmission
+    if (rmt_strip->is_enabled) {
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), TAG, "flush RMT channel failed");
+    }
+    return rmt_led_strip_encoder_set_color_correction(rmt_strip->strip_encoder, config);
+}
+
 static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
 {
     led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
@@ -97,6 +209,10 @@ static esp_err_t led_strip_rmt_clear(led_strip_t *strip)
 static esp_err_t led_strip_rmt_del(led_strip_t *strip)
 {
     led_strip_rmt_obj *rmt_strip = __containerof(strip, led_strip_rmt_obj, base);
+    ESP_RETURN_ON_FALSE(!rmt_strip->group, ESP_ERR_INVALID_STATE, TAG, "strip is still in a group");
+    if (rmt_strip->is_enabled) {
+        ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+    }
     ESP_RETURN_ON_ERROR(rmt_del_channel(rmt_strip->rmt_chan), TAG, "delete RMT channel failed");
     ESP_RETURN_ON_ERROR(rmt_del_encoder(rmt_strip->strip_encoder), TAG, "delete strip encoder failed");
     free(rmt_strip);
@@ -128,8 +244,13 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const l
     }
     // TODO: we assume each color component is 8 bits, may need to support other configurations in the future, e.g. 10bits per color component?
     uint8_t bytes_per_pixel = component_fmt.format.num_components;
-    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj) + led_config->max_leds * bytes_per_pixel);
+    // the second buffer of the `double_buffer` flag follows the pixel buffer
+    size_t num_bufs = led_config->flags.double_buffer ? 2 : 1;
+    rmt_strip = calloc(1, sizeof(led_strip_rmt_obj) + num_bufs * led_config->max_leds * bytes_per_pixel);
     ESP_GOTO_ON_FALSE(rmt_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt strip");
+    if (led_config->flags.double_buffer) {
+        rmt_strip->tx_buf = rmt_strip->pixel_buf + led_config->max_leds * bytes_per_pixel;
+    }
     uint32_t resolution = rmt_config->resolution_hz ? rmt_config->resolution_hz : LED_STRIP_RMT_DEFAULT_RESOLUTION;
 
     // for backward compatibility, if the user does not set the clk_src, use the default value
@@ -152,6 +273,10 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const l
         .flags.invert_out = led_config->flags.invert_out,
     };
     ESP_GOTO_ON_ERROR(rmt_new_tx_channel(&rmt_chan_config, &rmt_strip->rmt_chan), err, TAG, "create RMT TX channel failed");
+    rmt_tx_event_callbacks_t cbs = {
+        .on_trans_done = led_strip_rmt_trans_done_cb,
+    };
+    ESP_GOTO_ON_ERROR(rmt_tx_register_event_callbacks(rmt_strip->rmt_chan, &cbs, rmt_strip), err, TAG, "register RMT TX callbacks failed");
 
     led_strip_encoder_config_t strip_encoder_conf = {
         .resolution = resolution,
@@ -164,7 +289,12 @@ esp_err_t led_strip_new_rmt_device(const led_strip_config_t *led_config, const l
     rmt_strip->strip_len = led_config->max_leds;
     rmt_strip->base.set_pixel = led_strip_rmt_set_pixel;
     rmt_strip->base.set_pixel_rgbw = led_strip_rmt_set_pixel_rgbw;
+    rmt_strip->base.set_pixels = led_strip_rmt_set_pixels;
     rmt_strip->base.refresh = led_strip_rmt_refresh;
+    rmt_strip->base.refresh_async = led_strip_rmt_refresh_async;
+    rmt_strip->base.refresh_wait_done = led_strip_rmt_refresh_wait_done;
+    rmt_strip->base.register_refresh_done_cb = led_strip_rmt_register_refresh_done_cb;
+    rmt_strip->base.set_color_correction = led_strip_rmt_set_color_correction;
     rmt_strip->base.clear = led_strip_rmt_clear;
     rmt_strip->base.del = led_strip_rmt_del;
 
@@ -182,3 +312,122 @@ err:
     }
     return ret;
 }
+
+#if SOC_RMT_SUPPORT_TX_SYNCHRO
+esp_err_t led_strip_new_rmt_group(const led_strip_handle_t *strips, size_t num_strips, led_strip_rmt_group_handle_t *ret_group)
+{
+    led_strip_rmt_group_t *group = NULL;
+    rmt_channel_handle_t *channels = NULL;
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(strips && num_strips && ret_group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < num_strips; i++) {
+        ESP_RETURN_ON_FALSE(strips[i] && strips[i]->refresh == led_strip_rmt_refresh, ESP_ERR_INVALID_ARG, TAG,
+                            "strip %d is not an RMT strip", (int)i);
+        ESP_RETURN_ON_FALSE(!__containerof(strips[i], led_strip_rmt_obj, base)->group, ESP_ERR_INVALID_STATE, TAG,
+                            "strip %d is already in a group", (int)i);
+    }
+    group = calloc(1, sizeof(led_strip_rmt_group_t) + num_strips * sizeof(led_strip_rmt_obj *));
+    channels = calloc(num_strips, sizeof(rmt_channel_handle_t));
+    ESP_GOTO_ON_FALSE(group && channels, ESP_ERR_NO_MEM, err, TAG, "no mem for rmt strip group");
+
+    // the sync manager only accepts enabled channels, they stay enabled for the lifetime of the group
+    for (size_t i = 0; i < num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = __containerof(strips[i], led_strip_rmt_obj, base);
+        if (rmt_strip->is_enabled) {
+            ESP_GOTO_ON_ERROR(rmt_tx_wait_all_done(rmt_strip->rmt_chan, -1), err, TAG, "flush RMT channel failed");
+        } else {
+            ESP_GOTO_ON_ERROR(rmt_enable(rmt_strip->rmt_chan), err, TAG, "enable RMT channel failed");
+            rmt_strip->is_enabled = true;
+        }
+        group->strips[i] = rmt_strip;
+        channels[i] = rmt_strip->rmt_chan;
+    }
+    rmt_sync_manager_config_t sync_config = {
+        .tx_channel_array = channels,
+        .array_size = num_strips,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_sync_manager(&sync_config, &group->sync_manager), err, TAG, "create RMT sync manager failed");
+    free(channels);
+
+    group->num_strips = num_strips;
+    for (size_t i = 0; i < num_strips; i++) {
+        group->strips[i]->group = group;
+    }
+    *ret_group = group;
+    return ESP_OK;
+err:
+    // the channels enabled so far are disabled by the next refresh of their strip
+    free(channels);
+    free(group);
+    return ret;
+}
+
+esp_err_t led_strip_rmt_group_refresh_async(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    // restart all the channels from the same point, even if the previous refresh failed half way
+    ESP_RETURN_ON_ERROR(led_strip_rmt_group_wait_done(group, -1), TAG, "wait previous refresh failed");
+    ESP_RETURN_ON_ERROR(rmt_sync_reset(group->sync_manager), TAG, "reset RMT sync manager failed");
+    // the transmissions start together when the last channel has its transmission queued
+    for (size_t i = 0; i < group->num_strips; i++) {
+        ESP_RETURN_ON_ERROR(led_strip_rmt_transmit(group->strips[i]), TAG, "start refresh of strip %d failed", (int)i);
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_group_wait_done(led_strip_rmt_group_handle_t group, int timeout_ms)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        ESP_RETURN_ON_ERROR(rmt_tx_wait_all_done(group->strips[i]->rmt_chan, timeout_ms), TAG, "flush RMT channel failed");
+    }
+    return ESP_OK;
+}
+
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_ERROR(led_strip_rmt_group_refresh_async(group), TAG, "start group refresh failed");
+    return led_strip_rmt_group_wait_done(group, -1);
+}
+
+esp_err_t led_strip_del_rmt_group(led_strip_rmt_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_ERROR(led_strip_rmt_group_wait_done(group, -1), TAG, "wait refresh failed");
+    ESP_RETURN_ON_ERROR(rmt_del_sync_manager(group->sync_manager), TAG, "delete RMT sync manager failed");
+    for (size_t i = 0; i < group->num_strips; i++) {
+        led_strip_rmt_obj *rmt_strip = group->strips[i];
+        rmt_strip->group = NULL;
+        ESP_RETURN_ON_ERROR(rmt_disable(rmt_strip->rmt_chan), TAG, "disable RMT channel failed");
+        rmt_strip->is_enabled = false;
+    }
+    free(group);
+    return ESP_OK;
+}
+#else
+esp_err_t led_strip_new_rmt_group(const led_strip_handle_t *strips, size_t num_strips, led_strip_rmt_group_handle_t *ret_group)
+{
+    ESP_LOGE(TAG, "RMT TX synchronization is not supported by this target");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t led_strip_rmt_group_refresh_async(led_strip_rmt_group_handle_t group)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t led_strip_rmt_group_wait_done(led_strip_rmt_group_handle_t group, int timeout_ms)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t led_strip_rmt_group_refresh(led_strip_rmt_group_handle_t group)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t led_strip_del_rmt_group(led_strip_rmt_group_handle_t group)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+#endif // SOC_RMT_SUPPORT_TX_SYNCHRO
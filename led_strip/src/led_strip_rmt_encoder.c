@@ -4,20 +4,141 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <math.h>
+#include <string.h>
+#include "esp_attr.h"
 #include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
 #include "led_strip_rmt_encoder.h"
 
+// number of pixel bytes corrected at once before they are passed to the bytes encoder
+#define LED_STRIP_ENCODER_CHUNK_SIZE 32
+// number of refreshes the dithering pattern repeats over
+#define LED_STRIP_ENCODER_DITHER_FRAMES 8
+
+// the symbol table encoder is built on the RMT simple encoder, available from ESP-IDF v5.3
+#if CONFIG_LED_STRIP_RMT_ENCODER_TABLE && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define LED_STRIP_ENCODER_TABLE 1
+// the encoder runs in the RMT interrupt, which refills the RMT memory
+#define LED_STRIP_ENCODER_ATTR IRAM_ATTR
+#else
+#define LED_STRIP_ENCODER_TABLE 0
+#define LED_STRIP_ENCODER_ATTR
+#endif
+
 static const char *TAG = "led_rmt_encoder";
 
 typedef struct {
     rmt_encoder_t base;
     rmt_encoder_t *bytes_encoder;
     rmt_encoder_t *copy_encoder;
+    rmt_encoder_t *table_encoder;   // simple encoder copying the symbols of every pixel byte from symbol_table, NULL without the table
+    rmt_symbol_word_t (*symbol_table)[8];   // the 8 symbols of every byte value, in the bit order of the LED model
     int state;
     rmt_symbol_word_t reset_code;
+    uint16_t *lut;                  // corrected value of every pixel byte in 8.8 fixed-point, NULL if there is no color correction
+    bool dithering;
+    uint8_t frame;                  // number of the refresh, selects the dithering threshold
+    size_t chunk_offset;            // offset in the pixel bytes of the chunk being encoded
+    size_t chunk_size;              // size of the chunk being encoded, 0 if the next chunk is not corrected yet
+    uint8_t chunk[LED_STRIP_ENCODER_CHUNK_SIZE];
 } rmt_led_strip_encoder_t;
 
-static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
+// dithering thresholds in 8.8 fixed-point, in an order which spreads the rounded up refreshes
+static DRAM_ATTR const uint8_t s_dither_threshold[LED_STRIP_ENCODER_DITHER_FRAMES] = {16, 144, 80, 208, 48, 176, 112, 240};
+
+// Correct the pixel byte at index, the dithering threshold also changes along the strip to avoid a global flicker
+static inline uint8_t LED_STRIP_ENCODER_ATTR rmt_led_strip_correct_byte(const rmt_led_strip_encoder_t *led_encoder, const uint8_t *pixels, size_t index)
+{
+    uint32_t threshold = led_encoder->dithering ?
+                         s_dither_threshold[(led_encoder->frame + index) % LED_STRIP_ENCODER_DITHER_FRAMES] : 128;
+    // the table tops at 255 << 8, the sum never rounds above 255
+    return (led_encoder->lut[pixels[index]] + threshold) >> 8;
+}
+
+// Correct the next chunk of the pixel bytes
+static void rmt_led_strip_correct_chunk(rmt_led_strip_encoder_t *led_encoder, const uint8_t *pixels, size_t data_size)
+{
+    size_t offset = led_encoder->chunk_offset;
+    size_t size = data_size - offset < LED_STRIP_ENCODER_CHUNK_SIZE ? data_size - offset : LED_STRIP_ENCODER_CHUNK_SIZE;
+
+    for (size_t i = 0; i < size; i++) {
+        led_encoder->chunk[i] = rmt_led_strip_correct_byte(led_encoder, pixels, offset + i);
+    }
+    led_encoder->chunk_size = size;
+}
+
+#if LED_STRIP_ENCODER_TABLE
+// Callback of the simple encoder: copy the symbols of as many pixel bytes as the RMT memory can take, then the reset code
+static size_t IRAM_ATTR rmt_encode_led_strip_table(const void *data, size_t data_size, size_t symbols_written, size_t symbols_free,
+                                                   rmt_symbol_word_t *symbols, bool *done, void *arg)
+{
+    rmt_led_strip_encoder_t *led_encoder = (rmt_led_strip_encoder_t *)arg;
+    const uint8_t *pixels = (const uint8_t *)data;
+    size_t offset = symbols_written / 8;
+
+    if (offset >= data_size) {
+        if (symbols_free < 1) {
+            return 0;
+        }
+        symbols[0] = led_encoder->reset_code;
+        *done = true;
+        return 1;
+    }
+    // a byte is never split, the simple encoder fills the last words of the memory from its own chunk buffer
+    size_t count = symbols_free / 8 < data_size - offset ? symbols_free / 8 : data_size - offset;
+    for (size_t i = 0; i < count; i++) {
+        uint8_t byte = led_encoder->lut ? rmt_led_strip_correct_byte(led_encoder, pixels, offset + i) : pixels[offset + i];
+        memcpy(&symbols[i * 8], led_encoder->symbol_table[byte], sizeof(led_encoder->symbol_table[byte]));
+    }
+    return count * 8;
+}
+
+// Fill the symbol table from the bit timing of the LED model
+static void rmt_led_strip_fill_symbol_table(rmt_led_strip_encoder_t *led_encoder, const rmt_bytes_encoder_config_t *config)
+{
+    for (int byte = 0; byte < 256; byte++) {
+        for (int bit = 0; bit < 8; bit++) {
+            int mask = config->flags.msb_first ? 0x80 >> bit : 1 << bit;
+            led_encoder->symbol_table[byte][bit] = (byte & mask) ? config->bit1 : config->bit0;
+        }
+    }
+}
+#endif
+
+// Encode the pixel bytes through the color correction table, one chunk at a time
+static size_t rmt_encode_led_strip_corrected(rmt_led_strip_encoder_t *led_encoder, rmt_channel_handle_t channel, const uint8_t *pixels,
+                                             size_t data_size, rmt_encode_state_t *ret_state)
+{
+    rmt_encoder_handle_t bytes_encoder = led_encoder->bytes_encoder;
+    rmt_encode_state_t session_state = 0;
+    size_t encoded_symbols = 0;
+
+    while (led_encoder->chunk_offset < data_size) {
+        // a chunk interrupted by a full memory is passed again as it is, the bytes encoder resumes where it stopped
+        if (!led_encoder->chunk_size) {
+            rmt_led_strip_correct_chunk(led_encoder, pixels, data_size);
+        }
+        encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, led_encoder->chunk, led_encoder->chunk_size, &session_state);
+        if (session_state & RMT_ENCODING_COMPLETE) {
+            led_encoder->chunk_offset += led_encoder->chunk_size;
+            led_encoder->chunk_size = 0;
+        }
+        if (session_state & RMT_ENCODING_MEM_FULL) {
+            break;
+        }
+    }
+    rmt_encode_state_t state = session_state & RMT_ENCODING_MEM_FULL;
+    if (led_encoder->chunk_offset >= data_size) {
+        led_encoder->chunk_offset = 0;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    *ret_state = state;
+    return encoded_symbols;
+}
+
+static size_t LED_STRIP_ENCODER_ATTR rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel, const void *primary_data, size_t data_size, rmt_encode_state_t *ret_state)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
     rmt_encoder_handle_t bytes_encoder = led_encoder->bytes_encoder;
@@ -25,9 +146,25 @@ static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t
     rmt_encode_state_t session_state = 0;
     rmt_encode_state_t state = 0;
     size_t encoded_symbols = 0;
+#if LED_STRIP_ENCODER_TABLE
+    // the table encoder sends the RGB data and the reset code at once
+    rmt_encoder_handle_t table_encoder = led_encoder->table_encoder;
+    encoded_symbols = table_encoder->encode(table_encoder, channel, primary_data, data_size, &session_state);
+    if (session_state & RMT_ENCODING_COMPLETE) {
+        led_encoder->frame++;
+        state |= RMT_ENCODING_COMPLETE;
+    }
+    state |= session_state & RMT_ENCODING_MEM_FULL;
+    *ret_state = state;
+    return encoded_symbols;
+#endif
     switch (led_encoder->state) {
     case 0: // send RGB data
-        encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, primary_data, data_size, &session_state);
+        if (led_encoder->lut) {
+            encoded_symbols += rmt_encode_led_strip_corrected(led_encoder, channel, primary_data, data_size, &session_state);
+        } else {
+            encoded_symbols += bytes_encoder->encode(bytes_encoder, channel, primary_data, data_size, &session_state);
+        }
         if (session_state & RMT_ENCODING_COMPLETE) {
             led_encoder->state = 1; // switch to next state when current encoding session finished
         }
@@ -41,6 +178,7 @@ static size_t rmt_encode_led_strip(rmt_encoder_t *encoder, rmt_channel_handle_t
                                                 sizeof(led_encoder->reset_code), &session_state);
         if (session_state & RMT_ENCODING_COMPLETE) {
             led_encoder->state = 0; // back to the initial encoding session
+            led_encoder->frame++;
             state |= RMT_ENCODING_COMPLETE;
         }
         if (session_state & RMT_ENCODING_MEM_FULL) {
@@ -56,8 +194,14 @@ out:
 static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
-    rmt_del_encoder(led_encoder->bytes_encoder);
-    rmt_del_encoder(led_encoder->copy_encoder);
+    if (led_encoder->table_encoder) {
+        rmt_del_encoder(led_encoder->table_encoder);
+    } else {
+        rmt_del_encoder(led_encoder->bytes_encoder);
+        rmt_del_encoder(led_encoder->copy_encoder);
+    }
+    free(led_encoder->symbol_table);
+    free(led_encoder->lut);
     free(led_encoder);
     return ESP_OK;
 }
@@ -65,9 +209,38 @@ static esp_err_t rmt_del_led_strip_encoder(rmt_encoder_t *encoder)
 static esp_err_t rmt_led_strip_encoder_reset(rmt_encoder_t *encoder)
 {
     rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
-    rmt_encoder_reset(led_encoder->bytes_encoder);
-    rmt_encoder_reset(led_encoder->copy_encoder);
+    if (led_encoder->table_encoder) {
+        rmt_encoder_reset(led_encoder->table_encoder);
+    } else {
+        rmt_encoder_reset(led_encoder->bytes_encoder);
+        rmt_encoder_reset(led_encoder->copy_encoder);
+    }
     led_encoder->state = 0;
+    led_encoder->chunk_offset = 0;
+    led_encoder->chunk_size = 0;
+    return ESP_OK;
+}
+
+esp_err_t rmt_led_strip_encoder_set_color_correction(rmt_encoder_handle_t encoder, const led_strip_color_correction_t *config)
+{
+    ESP_RETURN_ON_FALSE(encoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    rmt_led_strip_encoder_t *led_encoder = __containerof(encoder, rmt_led_strip_encoder_t, base);
+    // the identity correction is the same as no correction, skip the table
+    if (!config || (config->gamma == 1.0f && config->brightness == 255 && !config->flags.dithering)) {
+        free(led_encoder->lut);
+        led_encoder->lut = NULL;
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(config->gamma > 0.0f, ESP_ERR_INVALID_ARG, TAG, "invalid gamma");
+    if (!led_encoder->lut) {
+        // read by the table encoder in the RMT interrupt, keep it in internal memory
+        led_encoder->lut = heap_caps_malloc(256 * sizeof(uint16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        ESP_RETURN_ON_FALSE(led_encoder->lut, ESP_ERR_NO_MEM, TAG, "no mem for color correction table");
+    }
+    for (int i = 0; i < 256; i++) {
+        led_encoder->lut[i] = lroundf(powf(i / 255.0f, config->gamma) * config->brightness * 256.0f);
+    }
+    led_encoder->dithering = config->flags.dithering;
     return ESP_OK;
 }
 
@@ -138,9 +311,21 @@ esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rm
     } else {
         assert(false);
     }
+#if LED_STRIP_ENCODER_TABLE
+    led_encoder->symbol_table = heap_caps_malloc(256 * sizeof(led_encoder->symbol_table[0]), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ESP_GOTO_ON_FALSE(led_encoder->symbol_table, ESP_ERR_NO_MEM, err, TAG, "no mem for symbol table");
+    rmt_led_strip_fill_symbol_table(led_encoder, &bytes_encoder_config);
+    rmt_simple_encoder_config_t table_encoder_config = {
+        .callback = rmt_encode_led_strip_table,
+        .arg = led_encoder,
+        .min_chunk_size = CONFIG_LED_STRIP_RMT_ENCODER_TABLE_CHUNK_SYMBOLS,
+    };
+    ESP_GOTO_ON_ERROR(rmt_new_simple_encoder(&table_encoder_config, &led_encoder->table_encoder), err, TAG, "create table encoder failed");
+#else
     ESP_GOTO_ON_ERROR(rmt_new_bytes_encoder(&bytes_encoder_config, &led_encoder->bytes_encoder), err, TAG, "create bytes encoder failed");
     rmt_copy_encoder_config_t copy_encoder_config = {};
     ESP_GOTO_ON_ERROR(rmt_new_copy_encoder(&copy_encoder_config, &led_encoder->copy_encoder), err, TAG, "create copy encoder failed");
+#endif
 
     led_encoder->reset_code = (rmt_symbol_word_t) {
         .level0 = 0,
@@ -158,6 +343,10 @@ err:
         if (led_encoder->copy_encoder) {
             rmt_del_encoder(led_encoder->copy_encoder);
         }
+        if (led_encoder->table_encoder) {
+            rmt_del_encoder(led_encoder->table_encoder);
+        }
+        free(led_encoder->symbol_table);
         free(led_encoder);
     }
     return ret;
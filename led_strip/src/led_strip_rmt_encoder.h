@@ -33,6 +33,20 @@ typedef struct {
  */
 esp_err_t rmt_new_led_strip_encoder(const led_strip_encoder_config_t *config, rmt_encoder_handle_t *ret_encoder);
 
+/**
+ * @brief Set the color correction applied to the pixel bytes by the encoder
+ *
+ * @note Must not be called while the encoder is in use by a transmission
+ *
+ * @param[in] encoder Encoder created by `rmt_new_led_strip_encoder`
+ * @param[in] config Color correction, NULL to send the pixel bytes as they are
+ * @return
+ *      - ESP_ERR_INVALID_ARG for any invalid arguments
+ *      - ESP_ERR_NO_MEM out of memory when allocating the correction table
+ *      - ESP_OK if setting the color correction successfully
+ */
+esp_err_t rmt_led_strip_encoder_set_color_correction(rmt_encoder_handle_t encoder, const led_strip_color_correction_t *config);
+
 #ifdef __cplusplus
 }
 #endif
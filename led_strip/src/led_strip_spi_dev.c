@@ -9,6 +9,7 @@
 #include "esp_log.h"
 #include "esp_check.h"
 #include "esp_rom_gpio.h"
+#include "freertos/FreeRTOS.h"
 #include "soc/spi_periph.h"
 #include "led_strip.h"
 #include "led_strip_interface.h"
@@ -28,24 +29,61 @@ typedef struct {
     uint32_t strip_len;
     uint8_t bytes_per_pixel;
     led_color_component_format_t component_fmt;
+    spi_transaction_t trans;                        // Transaction of the refresh in progress
+    bool is_trans_pending;                          // The transaction is queued, its result is not read yet
+    led_strip_refresh_done_cb_t on_refresh_done;
+    void *user_ctx;
+    uint8_t *tx_buf;                                // Buffer on the wire with the `double_buffer` flag, NULL otherwise
     uint8_t pixel_buf[];
 } led_strip_spi_obj;
 
-// please make sure to zero-initialize the buf before calling this function
-static void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
+// Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
+// So a color byte occupies 3 bytes of SPI, the SPI bits of the color byte `d` are looked up in a table
+#define LED_STRIP_SPI_BIT(d, n)     ((((d) >> (n)) & 0x01) ? 0x06 : 0x04)
+#define LED_STRIP_SPI_NIBBLE(d)     (LED_STRIP_SPI_BIT(d, 3) << 9 | LED_STRIP_SPI_BIT(d, 2) << 6 | \
+                                     LED_STRIP_SPI_BIT(d, 1) << 3 | LED_STRIP_SPI_BIT(d, 0))
+#define LED_STRIP_SPI_NIBBLE_4(d)   LED_STRIP_SPI_NIBBLE(d), LED_STRIP_SPI_NIBBLE((d) + 1), \
+                                    LED_STRIP_SPI_NIBBLE((d) + 2), LED_STRIP_SPI_NIBBLE((d) + 3)
+
+#if CONFIG_LED_STRIP_SPI_ENCODER_TABLE_NIBBLE
+// 12 SPI bits of every half of a color byte
+static const uint16_t s_spi_nibble_table[16] = {
+    LED_STRIP_SPI_NIBBLE_4(0), LED_STRIP_SPI_NIBBLE_4(4), LED_STRIP_SPI_NIBBLE_4(8), LED_STRIP_SPI_NIBBLE_4(12),
+};
+
+static inline void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
+{
+    uint32_t pattern = (uint32_t)s_spi_nibble_table[data >> 4] << 12 | s_spi_nibble_table[data & 0x0F];
+    buf[0] = pattern >> 16;
+    buf[1] = pattern >> 8;
+    buf[2] = pattern;
+}
+#else
+#define LED_STRIP_SPI_BYTE(d)       {                                                                   \
+                                        LED_STRIP_SPI_NIBBLE((d) >> 4) >> 4,                            \
+                                        (LED_STRIP_SPI_NIBBLE((d) >> 4) << 4 | LED_STRIP_SPI_NIBBLE(d) >> 8) & 0xFF, \
+                                        LED_STRIP_SPI_NIBBLE(d) & 0xFF,                                 \
+                                    }
+#define LED_STRIP_SPI_BYTE_4(d)     LED_STRIP_SPI_BYTE(d), LED_STRIP_SPI_BYTE((d) + 1), \
+                                    LED_STRIP_SPI_BYTE((d) + 2), LED_STRIP_SPI_BYTE((d) + 3)
+#define LED_STRIP_SPI_BYTE_16(d)    LED_STRIP_SPI_BYTE_4(d), LED_STRIP_SPI_BYTE_4((d) + 4), \
+                                    LED_STRIP_SPI_BYTE_4((d) + 8), LED_STRIP_SPI_BYTE_4((d) + 12)
+#define LED_STRIP_SPI_BYTE_64(d)    LED_STRIP_SPI_BYTE_16(d), LED_STRIP_SPI_BYTE_16((d) + 16), \
+                                    LED_STRIP_SPI_BYTE_16((d) + 32), LED_STRIP_SPI_BYTE_16((d) + 48)
+
+// 3 SPI bytes of every color byte
+static const uint8_t s_spi_byte_table[256][SPI_BYTES_PER_COLOR_BYTE] = {
+    LED_STRIP_SPI_BYTE_64(0), LED_STRIP_SPI_BYTE_64(64), LED_STRIP_SPI_BYTE_64(128), LED_STRIP_SPI_BYTE_64(192),
+};
+
+static inline void __led_strip_spi_bit(uint8_t data, uint8_t *buf)
 {
-    // Each color of 1 bit is represented by 3 bits of SPI, low_level:100 ,high_level:110
-    // So a color byte occupies 3 bytes of SPI.
-    *(buf + 2) |= data & BIT(0) ? BIT(2) | BIT(1) : BIT(2);
-    *(buf + 2) |= data & BIT(1) ? BIT(5) | BIT(4) : BIT(5);
-    *(buf + 2) |= data & BIT(2) ? BIT(7) : 0x00;
-    *(buf + 1) |= BIT(0);
-    *(buf + 1) |= data & BIT(3) ? BIT(3) | BIT(2) : BIT(3);
-    *(buf + 1) |= data & BIT(4) ? BIT(6) | BIT(5) : BIT(6);
-    *(buf + 0) |= data & BIT(5) ? BIT(1) | BIT(0) : BIT(1);
-    *(buf + 0) |= data & BIT(6) ? BIT(4) | BIT(3) : BIT(4);
-    *(buf + 0) |= data & BIT(7) ? BIT(7) | BIT(6) : BIT(7);
+    const uint8_t *pattern = s_spi_byte_table[data];
+    buf[0] = pattern[0];
+    buf[1] = pattern[1];
+    buf[2] = pattern[2];
 }
+#endif // CONFIG_LED_STRIP_SPI_ENCODER_TABLE_NIBBLE
 
 static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue)
 {
@@ -55,7 +93,6 @@ static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uin
     uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
     uint8_t *pixel_buf = spi_strip->pixel_buf;
     led_color_component_format_t component_fmt = spi_strip->component_fmt;
-    memset(pixel_buf + start, 0, spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
 
     __led_strip_spi_bit(red, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos]);
     __led_strip_spi_bit(green, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos]);
@@ -67,6 +104,34 @@ static esp_err_t led_strip_spi_set_pixel(led_strip_t *strip, uint32_t index, uin
     return ESP_OK;
 }
 
+static esp_err_t led_strip_spi_set_pixels(led_strip_t *strip, uint32_t start, uint32_t count, const uint8_t *rgb)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    ESP_RETURN_ON_FALSE(count <= spi_strip->strip_len && start <= spi_strip->strip_len - count, ESP_ERR_INVALID_ARG, TAG,
+                        "index out of maximum number of LEDs");
+
+    led_color_component_format_t component_fmt = spi_strip->component_fmt;
+    uint32_t pixel_size = spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    // position in the SPI pixel of the encoded R, G and B bytes of the packed buffer
+    const uint8_t pos[3] = {
+        SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos,
+        SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos,
+        SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.b_pos,
+    };
+    uint8_t *pixel = spi_strip->pixel_buf + start * pixel_size;
+
+    for (uint32_t i = 0; i < count; i++, pixel += pixel_size, rgb += 3) {
+        __led_strip_spi_bit(rgb[0], &pixel[pos[0]]);
+        __led_strip_spi_bit(rgb[1], &pixel[pos[1]]);
+        __led_strip_spi_bit(rgb[2], &pixel[pos[2]]);
+        if (component_fmt.format.num_components > 3) {
+            __led_strip_spi_bit(0, &pixel[SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.w_pos]);
+        }
+    }
+
+    return ESP_OK;
+}
+
 static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index, uint32_t red, uint32_t green, uint32_t blue, uint32_t white)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
@@ -77,7 +142,6 @@ static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index
     // LED_PIXEL_FORMAT_GRBW takes 96bits(12bytes)
     uint32_t start = index * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
     uint8_t *pixel_buf = spi_strip->pixel_buf;
-    memset(pixel_buf + start, 0, spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE);
 
     __led_strip_spi_bit(red, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.r_pos]);
     __led_strip_spi_bit(green, &pixel_buf[start + SPI_BYTES_PER_COLOR_BYTE * component_fmt.format.g_pos]);
@@ -87,17 +151,64 @@ static esp_err_t led_strip_spi_set_pixel_rgbw(led_strip_t *strip, uint32_t index
     return ESP_OK;
 }
 
-static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+static esp_err_t led_strip_spi_refresh_wait_done(led_strip_t *strip, int timeout_ms)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
-    spi_transaction_t tx_conf;
-    memset(&tx_conf, 0, sizeof(tx_conf));
+    spi_transaction_t *ret_trans = NULL;
+    if (!spi_strip->is_trans_pending) {
+        return ESP_OK;
+    }
+    TickType_t ticks = timeout_ms < 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    ESP_RETURN_ON_ERROR(spi_device_get_trans_result(spi_strip->spi_device, &ret_trans, ticks), TAG, "wait SPI transaction failed");
+    spi_strip->is_trans_pending = false;
+    return ESP_OK;
+}
 
-    tx_conf.length = spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BITS_PER_COLOR_BYTE;
-    tx_conf.tx_buffer = spi_strip->pixel_buf;
-    tx_conf.rx_buffer = NULL;
-    ESP_RETURN_ON_ERROR(spi_device_transmit(spi_strip->spi_device, &tx_conf), TAG, "transmit pixels by SPI failed");
+static esp_err_t led_strip_spi_refresh_async(led_strip_t *strip)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    size_t buf_size = spi_strip->strip_len * spi_strip->bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    uint8_t *tx_buf = spi_strip->pixel_buf;
 
+    led_strip_stats_refresh_start(strip);
+    // the transaction is reused, wait for the previous one before queueing it again
+    ESP_RETURN_ON_ERROR(led_strip_spi_refresh_wait_done(strip, -1), TAG, "wait previous refresh failed");
+    if (spi_strip->tx_buf) {
+        memcpy(spi_strip->tx_buf, spi_strip->pixel_buf, buf_size);
+        tx_buf = spi_strip->tx_buf;
+    }
+    memset(&spi_strip->trans, 0, sizeof(spi_strip->trans));
+    spi_strip->trans.length = buf_size * 8;
+    spi_strip->trans.tx_buffer = tx_buf;
+    spi_strip->trans.rx_buffer = NULL;
+    spi_strip->trans.user = spi_strip;
+    ESP_RETURN_ON_ERROR(spi_device_queue_trans(spi_strip->spi_device, &spi_strip->trans, portMAX_DELAY), TAG, "transmit pixels by SPI failed");
+    spi_strip->is_trans_pending = true;
+    led_strip_stats_refresh_queued(strip);
+    return ESP_OK;
+}
+
+static esp_err_t led_strip_spi_refresh(led_strip_t *strip)
+{
+    ESP_RETURN_ON_ERROR(led_strip_spi_refresh_async(strip), TAG, "start refresh failed");
+    return led_strip_spi_refresh_wait_done(strip, -1);
+}
+
+static void led_strip_spi_trans_done_cb(spi_transaction_t *trans)
+{
+    led_strip_spi_obj *spi_strip = (led_strip_spi_obj *)trans->user;
+    led_strip_refresh_done_cb_t on_refresh_done = spi_strip->on_refresh_done;
+    led_strip_stats_refresh_done(&spi_strip->base);
+    if (on_refresh_done && on_refresh_done(&spi_strip->base, spi_strip->user_ctx)) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+static esp_err_t led_strip_spi_register_refresh_done_cb(led_strip_t *strip, led_strip_refresh_done_cb_t cb, void *user_ctx)
+{
+    led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
+    spi_strip->user_ctx = user_ctx;
+    spi_strip->on_refresh_done = cb;
     return ESP_OK;
 }
 
@@ -119,6 +230,7 @@ static esp_err_t led_strip_spi_del(led_strip_t *strip)
 {
     led_strip_spi_obj *spi_strip = __containerof(strip, led_strip_spi_obj, base);
 
+    ESP_RETURN_ON_ERROR(led_strip_spi_refresh_wait_done(strip, -1), TAG, "wait refresh failed");
     ESP_RETURN_ON_ERROR(spi_bus_remove_device(spi_strip->spi_device), TAG, "delete spi device failed");
     ESP_RETURN_ON_ERROR(spi_bus_free(spi_strip->spi_host), TAG, "free spi bus failed");
 
@@ -156,9 +268,14 @@ esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const l
         // DMA buffer must be placed in internal SRAM
         mem_caps |= MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
     }
-    spi_strip = heap_caps_calloc(1, sizeof(led_strip_spi_obj) + led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE, mem_caps);
+    // the second buffer of the `double_buffer` flag follows the pixel buffer
+    size_t num_bufs = led_config->flags.double_buffer ? 2 : 1;
+    spi_strip = heap_caps_calloc(1, sizeof(led_strip_spi_obj) + num_bufs * led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE, mem_caps);
 
     ESP_GOTO_ON_FALSE(spi_strip, ESP_ERR_NO_MEM, err, TAG, "no mem for spi strip");
+    if (led_config->flags.double_buffer) {
+        spi_strip->tx_buf = spi_strip->pixel_buf + led_config->max_leds * bytes_per_pixel * SPI_BYTES_PER_COLOR_BYTE;
+    }
 
     spi_strip->spi_host = spi_config->spi_bus;
     // for backward compatibility, if the user does not set the clk_src, use the default value
@@ -192,6 +309,7 @@ esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const l
         //set -1 when CS is not used
         .spics_io_num = -1,
         .queue_size = LED_STRIP_SPI_DEFAULT_TRANS_QUEUE_SIZE,
+        .post_cb = led_strip_spi_trans_done_cb,
     };
 
     ESP_GOTO_ON_ERROR(spi_bus_add_device(spi_strip->spi_host, &spi_dev_cfg, &spi_strip->spi_device), err, TAG, "Failed to add spi device");
@@ -214,7 +332,11 @@ esp_err_t led_strip_new_spi_device(const led_strip_config_t *led_config, const l
     spi_strip->strip_len = led_config->max_leds;
     spi_strip->base.set_pixel = led_strip_spi_set_pixel;
     spi_strip->base.set_pixel_rgbw = led_strip_spi_set_pixel_rgbw;
+    spi_strip->base.set_pixels = led_strip_spi_set_pixels;
     spi_strip->base.refresh = led_strip_spi_refresh;
+    spi_strip->base.refresh_async = led_strip_spi_refresh_async;
+    spi_strip->base.refresh_wait_done = led_strip_spi_refresh_wait_done;
+    spi_strip->base.register_refresh_done_cb = led_strip_spi_register_refresh_done_cb;
     spi_strip->base.clear = led_strip_spi_clear;
     spi_strip->base.del = led_strip_spi_del;
 
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: CC0-1.0
  */
 
+#include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include "decode_image.h"
 #include "esp_log.h"
 #include "esp_check.h"
@@ -14,6 +16,10 @@
 
 #include "jpeglib.h"
 #include "jerror.h"
+#include "jpeg_turbo_decoder.h"
+#if CONFIG_LIBJPEG_TURBO_ESP_JSIMD
+#include "jsimd_esp.h"
+#endif
 
 /* Reference the binary-included jpeg file */
 extern const uint8_t image_jpg_start[] asm("_binary_image_jpg_start");
@@ -139,3 +145,119 @@ esp_err_t decode_image(uint16_t **pixels)
 
     return ret;
 }
+
+esp_err_t decode_preview(void)
+{
+    jpeg_turbo_decoder_handle_t decoder = NULL;
+    uint8_t *outbuf = NULL;
+    esp_err_t ret = ESP_OK;
+
+    ESP_RETURN_ON_ERROR(jpeg_turbo_decoder_new(&decoder), TAG, "Failed to create decoder");
+
+    /* A preview fitting into half the size of the image, then its center at full size, with the same decoder */
+    jpeg_turbo_decode_cfg_t cfgs[] = {
+        {
+            .out_format = JPEG_TURBO_FORMAT_RGB565,
+            .max_width = IMAGE_W / 2,
+            .max_height = IMAGE_H / 2,
+            .flags.swap_color_bytes = 1,
+        },
+        {
+            .out_format = JPEG_TURBO_FORMAT_RGB565,
+            .crop = { .left = IMAGE_W / 4, .top = IMAGE_H / 4, .width = IMAGE_W / 2, .height = IMAGE_H / 2 },
+            .flags.swap_color_bytes = 1,
+        },
+    };
+    for (int i = 0; i < sizeof(cfgs) / sizeof(cfgs[0]); i++) {
+        jpeg_turbo_decode_cfg_t *cfg = &cfgs[i];
+        jpeg_turbo_output_t img;
+        cfg->indata = image_jpg_start;
+        cfg->indata_size = image_jpg_end - image_jpg_start;
+        ESP_GOTO_ON_ERROR(jpeg_turbo_decoder_get_info(decoder, cfg, &img), cleanup, TAG, "Failed to get image info");
+
+        outbuf = malloc(img.output_len);
+        ESP_GOTO_ON_FALSE(outbuf, ESP_ERR_NO_MEM, cleanup, TAG, "No mem for %u bytes", (unsigned int)img.output_len);
+        cfg->outbuf = outbuf;
+        cfg->outbuf_size = img.output_len;
+
+        unsigned int start_b = esp_cpu_get_cycle_count();
+        ESP_GOTO_ON_ERROR(jpeg_turbo_decoder_decode(decoder, cfg, &img), cleanup, TAG, "Failed to decode");
+        unsigned int end_b = esp_cpu_get_cycle_count();
+        printf("%s: %ux%u RGB565, time = %u\n", i == 0 ? "Preview" : "Center", img.width, img.height,
+               end_b - start_b);
+        free(outbuf);
+        outbuf = NULL;
+    }
+
+cleanup:
+    free(outbuf);
+    jpeg_turbo_decoder_delete(decoder);
+    return ret;
+}
+
+#if CONFIG_LIBJPEG_TURBO_ESP_JSIMD
+/* Decode image.jpg into out_color_space, and return the FNV-1a hash of the pixels and the decoding time */
+static uint32_t decode_hash(J_COLOR_SPACE out_color_space, J_DCT_METHOD dct_method, uint32_t *cycles)
+{
+    struct my_error_mgr jerr;
+    struct jpeg_decompress_struct jpeg_info;
+    struct jpeg_decompress_struct *cinfo = &jpeg_info;
+    uint32_t hash = 2166136261u;
+
+    cinfo->err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = my_error_exit;
+    jpeg_create_decompress(cinfo);
+    jpeg_mem_src(cinfo, image_jpg_start, (image_jpg_end - image_jpg_start));
+    (void)jpeg_read_header(cinfo, TRUE);
+    cinfo->out_color_space = out_color_space;
+    cinfo->dct_method = dct_method;
+    cinfo->dither_mode = JDITHER_NONE;
+
+    unsigned int start_b = esp_cpu_get_cycle_count();
+    jpeg_start_decompress(cinfo);
+    int row_stride = cinfo->output_width * cinfo->output_components;
+    JSAMPARRAY buffer = (*cinfo->mem->alloc_sarray)
+                        ((j_common_ptr)cinfo, JPOOL_IMAGE, row_stride, 1);
+    unsigned int hash_cycles = 0;
+    while (cinfo->output_scanline < cinfo->output_height) {
+        (void)jpeg_read_scanlines(cinfo, buffer, 1);
+        unsigned int start_h = esp_cpu_get_cycle_count();
+        for (int i = 0; i < row_stride; i++) {
+            hash = (hash ^ buffer[0][i]) * 16777619u;
+        }
+        hash_cycles += esp_cpu_get_cycle_count() - start_h;
+    }
+    *cycles = esp_cpu_get_cycle_count() - start_b - hash_cycles;
+    jpeg_finish_decompress(cinfo);
+    jpeg_destroy_decompress(cinfo);
+    return hash;
+}
+
+esp_err_t compare_jsimd(void)
+{
+    static const struct {
+        const char *name;
+        J_COLOR_SPACE out_color_space;
+        J_DCT_METHOD dct_method;
+    } cases[] = {
+        { "RGB, islow", JCS_RGB, JDCT_ISLOW },
+        { "RGB, ifast", JCS_RGB, JDCT_IFAST },
+        { "RGB565, islow", JCS_RGB565, JDCT_ISLOW },
+    };
+    esp_err_t ret = ESP_OK;
+
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        uint32_t c_cycles, jsimd_cycles;
+        jsimd_esp_set_enabled(false);
+        uint32_t c_hash = decode_hash(cases[i].out_color_space, cases[i].dct_method, &c_cycles);
+        jsimd_esp_set_enabled(true);
+        uint32_t jsimd_hash = decode_hash(cases[i].out_color_space, cases[i].dct_method, &jsimd_cycles);
+        printf("%s: C %" PRIu32 " cycles, jsimd %" PRIu32 " cycles, pixels %s\n", cases[i].name,
+               c_cycles, jsimd_cycles, c_hash == jsimd_hash ? "identical" : "DIFFERENT");
+        if (c_hash != jsimd_hash) {
+            ret = ESP_FAIL;
+        }
+    }
+    return ret;
+}
+#endif
@@ -7,6 +7,7 @@
 #pragma once
 #include <stdint.h>
 #include "esp_err.h"
+#include "sdkconfig.h"
 
 #define IMAGE_W 320
 #define IMAGE_H 240
@@ -23,6 +24,23 @@ extern "C" {
  */
 esp_err_t decode_image(uint16_t **pixels);
 
+/**
+ * @brief Decode ``image.jpg`` into RGB565 with the jpeg_turbo_decoder API: a preview at half its size, and its
+ *        center at full size.
+ *
+ * @return - ESP_OK on successful decode
+ */
+esp_err_t decode_preview(void);
+
+#if CONFIG_LIBJPEG_TURBO_ESP_JSIMD
+/**
+ * @brief Decode ``image.jpg`` with and without the ESP jsimd kernels, and compare the pixels and the decoding times.
+ *
+ * @return - ESP_OK if the kernels give the same pixels as the C code of libjpeg-turbo
+ */
+esp_err_t compare_jsimd(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
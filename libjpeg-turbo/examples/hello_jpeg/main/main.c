@@ -23,4 +23,8 @@ void app_main(void)
 {
     printf("app_main started\n");
     decode_image(&pixels);
+    decode_preview();
+#if CONFIG_LIBJPEG_TURBO_ESP_JSIMD
+    compare_jsimd();
+#endif
 }
@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Format of the output image
+ */
+typedef enum {
+    JPEG_TURBO_FORMAT_RGB888 = 0,   /*!< 3 bytes per pixel, R G B */
+    JPEG_TURBO_FORMAT_RGB565,       /*!< 2 bytes per pixel, little-endian, or big-endian with swap_color_bytes */
+    JPEG_TURBO_FORMAT_GRAY,         /*!< 1 byte of luminance per pixel */
+} jpeg_turbo_format_t;
+
+/**
+ * @brief Configuration of the decoding of one image
+ */
+typedef struct {
+    const uint8_t *indata;      /*!< JPEG image */
+    size_t indata_size;         /*!< Size of the JPEG image */
+    uint8_t *outbuf;            /*!< Output buffer, rows are packed without padding */
+    size_t outbuf_size;         /*!< Output buffer size */
+    jpeg_turbo_format_t out_format; /*!< Output format */
+    uint8_t scale_num;          /*!< Scaling by scale_num / 8, from 1 to 16. 0 for no scaling */
+    uint16_t max_width;         /*!< If not 0, scale_num is ignored and the image is scaled by the largest N / 8,
+                                     N from 1 to 8, fitting into max_width x max_height, e.g. a display or a thumbnail */
+    uint16_t max_height;        /*!< Height limit, must be set together with max_width */
+    struct {
+        uint16_t left;          /*!< Left edge of the region, in pixels of the scaled image */
+        uint16_t top;           /*!< Top edge of the region, in pixels of the scaled image */
+        uint16_t width;         /*!< Width of the region, 0 decodes the whole image */
+        uint16_t height;        /*!< Height of the region, 0 decodes the whole image */
+    } crop;                     /*!< Region of the scaled image to decode. The rows above it are skipped without
+                                     color conversion, only the iMCU columns overlapping it are decoded and decoding
+                                     stops after its last row. The pixels are the same as in the whole image */
+    struct {
+        uint32_t swap_color_bytes: 1;   /*!< RGB565 in big-endian, as SPI displays expect it */
+        uint32_t fast_dct: 1;           /*!< Use the faster, less accurate integer IDCT (JDCT_IFAST) */
+        uint32_t dither: 1;             /*!< RGB565 with ordered dithering instead of truncation */
+    } flags;
+} jpeg_turbo_decode_cfg_t;
+
+/**
+ * @brief Output image info
+ */
+typedef struct {
+    uint16_t width;     /*!< Width of the output image */
+    uint16_t height;    /*!< Height of the output image */
+    size_t output_len;  /*!< Length of the output image in bytes */
+} jpeg_turbo_output_t;
+
+/**
+ * @brief Decoder keeping its libjpeg-turbo decompression object between images
+ */
+typedef struct jpeg_turbo_decoder_t *jpeg_turbo_decoder_handle_t;
+
+/**
+ * @brief Create a decoder
+ *
+ * The decompression object of libjpeg-turbo and its permanent allocations are kept until the decoder is deleted,
+ * so that decoding a sequence of images, e.g. previews, doesn't create and destroy it for each of them.
+ *
+ * @note A decoder must not be used by several tasks at the same time.
+ *
+ * @param[out] ret_decoder: Created decoder
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if ret_decoder is NULL
+ *      - ESP_ERR_NO_MEM      if there is no memory for the decoder
+ */
+esp_err_t jpeg_turbo_decoder_new(jpeg_turbo_decoder_handle_t *ret_decoder);
+
+/**
+ * @brief Get the size of the output image without decoding it
+ *
+ * Allocate a buffer of img->output_len bytes for jpeg_turbo_decoder_decode() with the same configuration.
+ * cfg->outbuf and cfg->outbuf_size are not used.
+ *
+ * @param[in]  decoder: Decoder created by jpeg_turbo_decoder_new()
+ * @param[in]  cfg:     Configuration structure
+ * @param[out] img:     Output image info
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder, cfg or img is NULL, or the scaling or the crop region is invalid
+ *      - ESP_FAIL            if the JPEG header can't be read
+ */
+esp_err_t jpeg_turbo_decoder_get_info(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                      jpeg_turbo_output_t *img);
+
+/**
+ * @brief Decode a JPEG image
+ *
+ * @note This function is blocking.
+ *
+ * @param[in]  decoder: Decoder created by jpeg_turbo_decoder_new()
+ * @param[in]  cfg:     Configuration structure
+ * @param[out] img:     Output image info
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder, cfg or img is NULL, or the scaling or the crop region is invalid
+ *      - ESP_ERR_INVALID_SIZE if cfg->outbuf is too small
+ *      - ESP_FAIL            if there is an error in decoding JPEG
+ */
+esp_err_t jpeg_turbo_decoder_decode(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                    jpeg_turbo_output_t *img);
+
+/**
+ * @brief Delete a decoder
+ *
+ * @param[in] decoder: Decoder created by jpeg_turbo_decoder_new()
+ *
+ * @return
+ *      - ESP_OK              on success
+ *      - ESP_ERR_INVALID_ARG if decoder is NULL
+ */
+esp_err_t jpeg_turbo_decoder_delete(jpeg_turbo_decoder_handle_t decoder);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Use, or not, the ESP jsimd kernels in the decompressors started from now on
+ *
+ * With CONFIG_LIBJPEG_TURBO_ESP_JSIMD, libjpeg-turbo decodes with the IDCT, upsampling and color conversion kernels
+ * of this component, which give the same pixels as its C code. libjpeg-turbo chooses its kernels in
+ * `jpeg_start_decompress()`, so this applies to the images started afterwards. The kernels are enabled by default.
+ * Only available with CONFIG_LIBJPEG_TURBO_ESP_JSIMD.
+ *
+ * @param enabled Whether to use the kernels
+ */
+void jsimd_esp_set_enabled(bool enabled);
+
+#ifdef __cplusplus
+}
+#endif
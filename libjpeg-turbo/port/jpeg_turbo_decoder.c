@@ -0,0 +1,246 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <sys/param.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "jpeglib.h"
+#include "jpeg_turbo_decoder.h"
+
+static const char *TAG = "jpeg_turbo";
+
+struct jpeg_turbo_decoder_t {
+    struct jpeg_decompress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    jmp_buf setjmp_buffer;          /* Where error_exit() returns to, set by each public function */
+};
+
+/* Region of the scaled image to decode, and bytes per output pixel */
+typedef struct {
+    JDIMENSION left;
+    JDIMENSION top;
+    JDIMENSION width;
+    JDIMENSION height;
+    size_t pixel_size;
+} decode_region_t;
+
+/* libjpeg-turbo must not return from error_exit(), the public function that called it returns ESP_FAIL */
+static void decoder_error_exit(j_common_ptr cinfo)
+{
+    jpeg_turbo_decoder_handle_t decoder = (jpeg_turbo_decoder_handle_t)cinfo->client_data;
+    char message[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, message);
+    ESP_LOGE(TAG, "%s", message);
+    longjmp(decoder->setjmp_buffer, 1);
+}
+
+static void decoder_output_message(j_common_ptr cinfo)
+{
+    char message[JMSG_LENGTH_MAX];
+
+    (*cinfo->err->format_message)(cinfo, message);
+    ESP_LOGW(TAG, "%s", message);
+}
+
+/* Read the header, and set the output parameters of cfg. Called with setjmp_buffer set */
+static esp_err_t decoder_prepare(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                 decode_region_t *region)
+{
+    struct jpeg_decompress_struct *cinfo = &decoder->cinfo;
+
+    ESP_RETURN_ON_FALSE(!cfg->max_width == !cfg->max_height && cfg->scale_num <= 16, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid scaling");
+
+    jpeg_mem_src(cinfo, cfg->indata, cfg->indata_size);
+    ESP_RETURN_ON_FALSE(jpeg_read_header(cinfo, TRUE) == JPEG_HEADER_OK, ESP_FAIL, TAG, "no JPEG image");
+
+    switch (cfg->out_format) {
+    case JPEG_TURBO_FORMAT_RGB888:
+        cinfo->out_color_space = JCS_RGB;
+        region->pixel_size = 3;
+        break;
+    case JPEG_TURBO_FORMAT_RGB565:
+        cinfo->out_color_space = JCS_RGB565;
+        region->pixel_size = 2;
+        break;
+    case JPEG_TURBO_FORMAT_GRAY:
+        cinfo->out_color_space = JCS_GRAYSCALE;
+        region->pixel_size = 1;
+        break;
+    default:
+        ESP_LOGE(TAG, "invalid output format");
+        return ESP_ERR_INVALID_ARG;
+    }
+    cinfo->dct_method = cfg->flags.fast_dct ? JDCT_IFAST : JDCT_ISLOW;
+    cinfo->dither_mode = cfg->flags.dither ? JDITHER_ORDERED : JDITHER_NONE;
+
+    /* The output size of each scaling is only known from libjpeg-turbo, try them from the largest */
+    cinfo->scale_denom = 8;
+    if (cfg->max_width) {
+        unsigned int num = 8;
+        do {
+            cinfo->scale_num = num;
+            jpeg_calc_output_dimensions(cinfo);
+        } while ((cinfo->output_width > cfg->max_width || cinfo->output_height > cfg->max_height) && --num > 0);
+        ESP_RETURN_ON_FALSE(num > 0, ESP_ERR_INVALID_ARG, TAG, "%ux%u image can't fit into %ux%u",
+                            cinfo->image_width, cinfo->image_height, cfg->max_width, cfg->max_height);
+    } else {
+        cinfo->scale_num = cfg->scale_num ? cfg->scale_num : 8;
+        jpeg_calc_output_dimensions(cinfo);
+    }
+
+    if (cfg->crop.width && cfg->crop.height) {
+        ESP_RETURN_ON_FALSE(cfg->crop.left + cfg->crop.width <= cinfo->output_width &&
+                            cfg->crop.top + cfg->crop.height <= cinfo->output_height, ESP_ERR_INVALID_ARG, TAG,
+                            "crop region out of the %ux%u image", cinfo->output_width, cinfo->output_height);
+        region->left = cfg->crop.left;
+        region->top = cfg->crop.top;
+        region->width = cfg->crop.width;
+        region->height = cfg->crop.height;
+    } else {
+        region->left = 0;
+        region->top = 0;
+        region->width = cinfo->output_width;
+        region->height = cinfo->output_height;
+    }
+    return ESP_OK;
+}
+
+/* Called with setjmp_buffer set */
+static esp_err_t decoder_decode(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                jpeg_turbo_output_t *img)
+{
+    struct jpeg_decompress_struct *cinfo = &decoder->cinfo;
+    decode_region_t region;
+
+    esp_err_t ret = decoder_prepare(decoder, cfg, &region);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    const size_t row_len = region.width * region.pixel_size;
+    ESP_RETURN_ON_FALSE(cfg->outbuf_size >= row_len * region.height, ESP_ERR_INVALID_SIZE, TAG,
+                        "output buffer too small, %u bytes needed", (unsigned int)(row_len * region.height));
+
+    jpeg_start_decompress(cinfo);
+
+    /*
+     * Fancy upsampling replicates the chroma samples at the edges of the decoded columns, so one more pixel is
+     * decoded on each side of the region to give the same pixels as decoding the whole image. jpeg_crop_scanline()
+     * then moves the left edge to an iMCU boundary. The decoded rows are wider than the region, they are decoded
+     * into a row buffer and copied.
+     */
+    JSAMPARRAY row_buffer = NULL;
+    size_t row_skip = 0;
+    if (region.width < cinfo->output_width) {
+        JDIMENSION xoffset = region.left > 0 ? region.left - 1 : 0;
+        JDIMENSION width = MIN(region.left + region.width + 1, cinfo->output_width) - xoffset;
+        jpeg_crop_scanline(cinfo, &xoffset, &width);
+        row_skip = (region.left - xoffset) * region.pixel_size;
+        if (width > region.width) {
+            row_buffer = (*cinfo->mem->alloc_sarray)((j_common_ptr)cinfo, JPOOL_IMAGE,
+                         width * region.pixel_size, 1);
+        }
+    }
+    if (region.top) {
+        jpeg_skip_scanlines(cinfo, region.top);
+    }
+
+    for (JDIMENSION row = 0; row < region.height; row++) {
+        JSAMPROW outptr = cfg->outbuf + row * row_len;
+        if (row_buffer) {
+            (void)jpeg_read_scanlines(cinfo, row_buffer, 1);
+            memcpy(outptr, row_buffer[0] + row_skip, row_len);
+        } else {
+            (void)jpeg_read_scanlines(cinfo, &outptr, 1);
+        }
+        if (cfg->out_format == JPEG_TURBO_FORMAT_RGB565 && cfg->flags.swap_color_bytes) {
+            for (size_t i = 0; i < row_len; i += 2) {
+                JSAMPLE low = outptr[i];
+                outptr[i] = outptr[i + 1];
+                outptr[i + 1] = low;
+            }
+        }
+    }
+
+    img->width = region.width;
+    img->height = region.height;
+    img->output_len = row_len * region.height;
+    return ESP_OK;
+}
+
+esp_err_t jpeg_turbo_decoder_new(jpeg_turbo_decoder_handle_t *ret_decoder)
+{
+    ESP_RETURN_ON_FALSE(ret_decoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    jpeg_turbo_decoder_handle_t decoder = calloc(1, sizeof(struct jpeg_turbo_decoder_t));
+    ESP_RETURN_ON_FALSE(decoder, ESP_ERR_NO_MEM, TAG, "no mem for JPEG decoder");
+    decoder->cinfo.err = jpeg_std_error(&decoder->jerr);
+    decoder->jerr.error_exit = decoder_error_exit;
+    decoder->jerr.output_message = decoder_output_message;
+    decoder->cinfo.client_data = decoder;
+
+    /* Only fails if the decompression object can't be allocated */
+    if (setjmp(decoder->setjmp_buffer)) {
+        free(decoder);
+        return ESP_ERR_NO_MEM;
+    }
+    jpeg_create_decompress(&decoder->cinfo);
+    *ret_decoder = decoder;
+    return ESP_OK;
+}
+
+esp_err_t jpeg_turbo_decoder_get_info(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                      jpeg_turbo_output_t *img)
+{
+    ESP_RETURN_ON_FALSE(decoder && cfg && cfg->indata && img, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    if (setjmp(decoder->setjmp_buffer)) {
+        jpeg_abort_decompress(&decoder->cinfo);
+        return ESP_FAIL;
+    }
+    decode_region_t region;
+    esp_err_t ret = decoder_prepare(decoder, cfg, &region);
+    if (ret == ESP_OK) {
+        img->width = region.width;
+        img->height = region.height;
+        img->output_len = region.width * region.pixel_size * region.height;
+    }
+    jpeg_abort_decompress(&decoder->cinfo);
+    return ret;
+}
+
+esp_err_t jpeg_turbo_decoder_decode(jpeg_turbo_decoder_handle_t decoder, const jpeg_turbo_decode_cfg_t *cfg,
+                                    jpeg_turbo_output_t *img)
+{
+    ESP_RETURN_ON_FALSE(decoder && cfg && cfg->indata && cfg->outbuf && img, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+
+    if (setjmp(decoder->setjmp_buffer)) {
+        jpeg_abort_decompress(&decoder->cinfo);
+        return ESP_FAIL;
+    }
+    esp_err_t ret = decoder_decode(decoder, cfg, img);
+    /*
+     * Unlike jpeg_finish_decompress(), jpeg_abort_decompress() doesn't decode the rows below the region. Both keep
+     * the object and its permanent allocations for the next image.
+     */
+    jpeg_abort_decompress(&decoder->cinfo);
+    return ret;
+}
+
+esp_err_t jpeg_turbo_decoder_delete(jpeg_turbo_decoder_handle_t decoder)
+{
+    ESP_RETURN_ON_FALSE(decoder, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    jpeg_destroy_decompress(&decoder->cinfo);
+    free(decoder);
+    return ESP_OK;
+}
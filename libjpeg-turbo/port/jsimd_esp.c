@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * jsimd hooks of the decoder, in place of those of jsimd_none.c
+ *
+ * The build weakens the symbols of jsimd_none.c in libjpeg.a, so the hooks defined here override them, and the ones
+ * not defined here keep their jsimd_none.c version, which offers no kernel. This file is linked in with
+ * `-u jsimd_esp_set_enabled`, since libjpeg.a would otherwise find the weak definitions first.
+ */
+
+#include "jsimd_esp_kernels.h"
+#include "jsimd_esp.h"
+
+static bool s_enabled = true;
+
+void jsimd_esp_set_enabled(bool enabled)
+{
+    s_enabled = enabled;
+}
+
+GLOBAL(int)
+jsimd_can_idct_islow(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_idct_islow(j_decompress_ptr cinfo, jpeg_component_info *compptr, JCOEFPTR coef_block, JSAMPARRAY output_buf,
+                 JDIMENSION output_col)
+{
+    jsimd_esp_idct_islow(cinfo, compptr, coef_block, output_buf, output_col);
+}
+
+GLOBAL(int)
+jsimd_can_idct_ifast(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_idct_ifast(j_decompress_ptr cinfo, jpeg_component_info *compptr, JCOEFPTR coef_block, JSAMPARRAY output_buf,
+                 JDIMENSION output_col)
+{
+    jsimd_esp_idct_ifast(cinfo, compptr, coef_block, output_buf, output_col);
+}
+
+GLOBAL(int)
+jsimd_can_h2v1_fancy_upsample(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_h2v1_fancy_upsample(j_decompress_ptr cinfo, jpeg_component_info *compptr, JSAMPARRAY input_data,
+                          JSAMPARRAY *output_data_ptr)
+{
+    jsimd_esp_h2v1_fancy_upsample(cinfo, compptr, input_data, output_data_ptr);
+}
+
+GLOBAL(int)
+jsimd_can_h2v2_fancy_upsample(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_h2v2_fancy_upsample(j_decompress_ptr cinfo, jpeg_component_info *compptr, JSAMPARRAY input_data,
+                          JSAMPARRAY *output_data_ptr)
+{
+    jsimd_esp_h2v2_fancy_upsample(cinfo, compptr, input_data, output_data_ptr);
+}
+
+GLOBAL(int)
+jsimd_can_ycc_rgb(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_ycc_rgb_convert(j_decompress_ptr cinfo, JSAMPIMAGE input_buf, JDIMENSION input_row, JSAMPARRAY output_buf,
+                      int num_rows)
+{
+    jsimd_esp_ycc_rgb_convert(cinfo, input_buf, input_row, output_buf, num_rows);
+}
+
+GLOBAL(int)
+jsimd_can_ycc_rgb565(void)
+{
+    return s_enabled;
+}
+
+GLOBAL(void)
+jsimd_ycc_rgb565_convert(j_decompress_ptr cinfo, JSAMPIMAGE input_buf, JDIMENSION input_row, JSAMPARRAY output_buf,
+                         int num_rows)
+{
+    jsimd_esp_ycc_rgb565_convert(cinfo, input_buf, input_row, output_buf, num_rows);
+}
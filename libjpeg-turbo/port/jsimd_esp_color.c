@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Upsampling and color conversion kernels, with the arithmetic of jdsample.c, jdcolor.c and jdcol565.c
+ *
+ * The YCbCr to RGB conversion of jdcolor.c looks up 4 tables of 1 KB and the range limit table for every pixel.
+ * Here, the same rounded products are computed with the single-cycle multiplier of the core, which gives the same
+ * values and leaves the data cache to the image.
+ */
+
+#include "jsimd_esp_kernels.h"
+
+/* FIX() of jdcolor.c, with SCALEBITS 16 */
+#define COLOR_SCALEBITS 16
+#define COLOR_ONE_HALF ((JLONG)1 << (COLOR_SCALEBITS - 1))
+#define FIX_1_40200 ((JLONG)91881)
+#define FIX_1_77200 ((JLONG)116130)
+#define FIX_0_71414 ((JLONG)46802)
+#define FIX_0_34414 ((JLONG)22554)
+
+static inline JSAMPLE clamp_sample(int value)
+{
+    return (JSAMPLE)(value < 0 ? 0 : value > MAXJSAMPLE ? MAXJSAMPLE : value);
+}
+
+static inline void ycc_to_rgb(int y, int cb, int cr, int *r, int *g, int *b)
+{
+    cb -= CENTERJSAMPLE;
+    cr -= CENTERJSAMPLE;
+    *r = clamp_sample(y + (int)RIGHT_SHIFT(FIX_1_40200 * cr + COLOR_ONE_HALF, COLOR_SCALEBITS));
+    *g = clamp_sample(y + (int)RIGHT_SHIFT(-FIX_0_34414 * cb - FIX_0_71414 * cr + COLOR_ONE_HALF, COLOR_SCALEBITS));
+    *b = clamp_sample(y + (int)RIGHT_SHIFT(FIX_1_77200 * cb + COLOR_ONE_HALF, COLOR_SCALEBITS));
+}
+
+void jsimd_esp_ycc_rgb_convert(j_decompress_ptr cinfo, JSAMPIMAGE input_buf, JDIMENSION input_row,
+                               JSAMPARRAY output_buf, int num_rows)
+{
+    /* Offsets of red, green, blue and alpha, or -1, and pixel size, as the RGB_* macros of jmorecfg.h */
+    int red = 0, green = 1, blue = 2, alpha = -1, pixelsize = 3;
+    switch (cinfo->out_color_space) {
+    case JCS_EXT_BGR:
+        red = 2, blue = 0;
+        break;
+    case JCS_EXT_RGBX:
+    case JCS_EXT_RGBA:
+        alpha = 3, pixelsize = 4;
+        break;
+    case JCS_EXT_BGRX:
+    case JCS_EXT_BGRA:
+        red = 2, blue = 0, alpha = 3, pixelsize = 4;
+        break;
+    case JCS_EXT_XBGR:
+    case JCS_EXT_ABGR:
+        red = 3, green = 2, blue = 1, alpha = 0, pixelsize = 4;
+        break;
+    case JCS_EXT_XRGB:
+    case JCS_EXT_ARGB:
+        red = 1, green = 2, blue = 3, alpha = 0, pixelsize = 4;
+        break;
+    default:
+        break;
+    }
+
+    JDIMENSION num_cols = cinfo->output_width;
+    while (--num_rows >= 0) {
+        const JSAMPLE *inptr0 = input_buf[0][input_row];
+        const JSAMPLE *inptr1 = input_buf[1][input_row];
+        const JSAMPLE *inptr2 = input_buf[2][input_row];
+        JSAMPROW outptr = *output_buf++;
+        input_row++;
+        for (JDIMENSION col = 0; col < num_cols; col++) {
+            int r, g, b;
+            ycc_to_rgb(inptr0[col], inptr1[col], inptr2[col], &r, &g, &b);
+            outptr[red] = (JSAMPLE)r;
+            outptr[green] = (JSAMPLE)g;
+            outptr[blue] = (JSAMPLE)b;
+            if (alpha >= 0) {
+                outptr[alpha] = MAXJSAMPLE;
+            }
+            outptr += pixelsize;
+        }
+    }
+}
+
+void jsimd_esp_ycc_rgb565_convert(j_decompress_ptr cinfo, JSAMPIMAGE input_buf, JDIMENSION input_row,
+                                  JSAMPARRAY output_buf, int num_rows)
+{
+    JDIMENSION num_cols = cinfo->output_width;
+    while (--num_rows >= 0) {
+        const JSAMPLE *inptr0 = input_buf[0][input_row];
+        const JSAMPLE *inptr1 = input_buf[1][input_row];
+        const JSAMPLE *inptr2 = input_buf[2][input_row];
+        JSAMPROW outptr = *output_buf++;
+        input_row++;
+        /* Little-endian RGB565, as jdcol565.c writes it on little-endian cores */
+        for (JDIMENSION col = 0; col < num_cols; col++) {
+            int r, g, b;
+            ycc_to_rgb(inptr0[col], inptr1[col], inptr2[col], &r, &g, &b);
+            unsigned int rgb = ((r << 8) & 0xF800) | ((g << 3) & 0x7E0) | (b >> 3);
+            outptr[0] = (JSAMPLE)rgb;
+            outptr[1] = (JSAMPLE)(rgb >> 8);
+            outptr += 2;
+        }
+    }
+}
+
+void jsimd_esp_h2v1_fancy_upsample(j_decompress_ptr cinfo, jpeg_component_info *compptr, JSAMPARRAY input_data,
+                                   JSAMPARRAY *output_data_ptr)
+{
+    JSAMPARRAY output_data = *output_data_ptr;
+
+    for (int inrow = 0; inrow < cinfo->max_v_samp_factor; inrow++) {
+        const JSAMPLE *inptr = input_data[inrow];
+        JSAMPROW outptr = output_data[inrow];
+        int cur = *inptr++;
+
+        /* Between 2 input samples, 3/4 of the nearer one and 1/4 of the other, rounding alternately up and down */
+        *outptr++ = (JSAMPLE)cur;
+        for (JDIMENSION colctr = compptr->downsampled_width - 1; colctr > 0; colctr--) {
+            int next = *inptr++;
+            outptr[0] = (JSAMPLE)((cur * 3 + next + 2) >> 2);
+            outptr[1] = (JSAMPLE)((next * 3 + cur + 1) >> 2);
+            outptr += 2;
+            cur = next;
+        }
+        *outptr = (JSAMPLE)cur;
+    }
+}
+
+void jsimd_esp_h2v2_fancy_upsample(j_decompress_ptr cinfo, jpeg_component_info *compptr, JSAMPARRAY input_data,
+                                   JSAMPARRAY *output_data_ptr)
+{
+    JSAMPARRAY output_data = *output_data_ptr;
+    int inrow = 0, outrow = 0;
+
+    while (outrow < cinfo->max_v_samp_factor) {
+        for (int v = 0; v < 2; v++) {
+            /* The nearer row, then the row above for the upper output row, the row below for the lower one */
+            const JSAMPLE *inptr0 = input_data[inrow];
+            const JSAMPLE *inptr1 = v == 0 ? input_data[inrow - 1] : input_data[inrow + 1];
+            JSAMPROW outptr = output_data[outrow++];
+
+            /* Each output sample is 9/16, 3/16, 3/16 and 1/16 of the 4 nearest, as 3/4 and 1/4 of the column sums */
+            int thiscolsum = *inptr0++ * 3 + *inptr1++;
+            *outptr++ = (JSAMPLE)((thiscolsum * 4 + 8) >> 4);
+            for (JDIMENSION colctr = compptr->downsampled_width - 1; colctr > 0; colctr--) {
+                int nextcolsum = *inptr0++ * 3 + *inptr1++;
+                outptr[0] = (JSAMPLE)((thiscolsum * 3 + nextcolsum + 7) >> 4);
+                outptr[1] = (JSAMPLE)((nextcolsum * 3 + thiscolsum + 8) >> 4);
+                outptr += 2;
+                thiscolsum = nextcolsum;
+            }
+            *outptr = (JSAMPLE)((thiscolsum * 4 + 7) >> 4);
+        }
+        inrow++;
+    }
+}
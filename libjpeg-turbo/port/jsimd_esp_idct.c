@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * IDCT kernels, with the arithmetic of jidctint.c (islow) and jidctfst.c (ifast), so they give the same pixels
+ *
+ * Each pass works on a whole row or column held in locals, so the compiler keeps the 8 coefficients in registers,
+ * and the dequantization of the column pass is skipped for the columns whose AC coefficients are all zero, which
+ * are most of them in the usual images.
+ */
+
+#include "jsimd_esp_kernels.h"
+
+/* jidctint.c */
+#define ISLOW_CONST_BITS 13
+#define ISLOW_PASS1_BITS 2
+
+#define FIX_0_298631336 ((JLONG)2446)
+#define FIX_0_390180644 ((JLONG)3196)
+#define FIX_0_541196100 ((JLONG)4433)
+#define FIX_0_765366865 ((JLONG)6270)
+#define FIX_0_899976223 ((JLONG)7373)
+#define FIX_1_175875602 ((JLONG)9633)
+#define FIX_1_501321110 ((JLONG)12299)
+#define FIX_1_847759065 ((JLONG)15137)
+#define FIX_1_961570560 ((JLONG)16069)
+#define FIX_2_053119869 ((JLONG)16819)
+#define FIX_2_562915447 ((JLONG)20995)
+#define FIX_3_072711026 ((JLONG)25172)
+
+/* jidctfst.c, whose MULTIPLY() truncates */
+#define IFAST_CONST_BITS 8
+#define IFAST_PASS1_BITS 2
+
+#define IFAST_FIX_1_082392200 ((JLONG)277)
+#define IFAST_FIX_1_414213562 ((JLONG)362)
+#define IFAST_FIX_1_847759065 ((JLONG)473)
+#define IFAST_FIX_2_613125930 ((JLONG)669)
+
+#define IFAST_MULTIPLY(var, c) ((DCTELEM)RIGHT_SHIFT((JLONG)(var) * (c), IFAST_CONST_BITS))
+
+static inline bool ac_is_zero(const JCOEF *in, int stride)
+{
+    return (in[stride * 1] | in[stride * 2] | in[stride * 3] | in[stride * 4] | in[stride * 5] | in[stride * 6] |
+            in[stride * 7]) == 0;
+}
+
+static inline bool ws_ac_is_zero(const int *ws)
+{
+    return (ws[1] | ws[2] | ws[3] | ws[4] | ws[5] | ws[6] | ws[7]) == 0;
+}
+
+/*
+ * Even and odd parts of jidctint.c, on inputs already dequantized, leaving the 8 outputs scaled up by CONST_BITS
+ */
+static inline void islow_1d(JLONG in0, JLONG in1, JLONG in2, JLONG in3, JLONG in4, JLONG in5, JLONG in6, JLONG in7,
+                            JLONG out[8])
+{
+    JLONG z1 = (in2 + in6) * FIX_0_541196100;
+    JLONG tmp2 = z1 + in6 * -FIX_1_847759065;
+    JLONG tmp3 = z1 + in2 * FIX_0_765366865;
+    JLONG tmp0 = LEFT_SHIFT(in0 + in4, ISLOW_CONST_BITS);
+    JLONG tmp1 = LEFT_SHIFT(in0 - in4, ISLOW_CONST_BITS);
+
+    JLONG tmp10 = tmp0 + tmp3;
+    JLONG tmp13 = tmp0 - tmp3;
+    JLONG tmp11 = tmp1 + tmp2;
+    JLONG tmp12 = tmp1 - tmp2;
+
+    tmp0 = in7;
+    tmp1 = in5;
+    tmp2 = in3;
+    tmp3 = in1;
+
+    z1 = tmp0 + tmp3;
+    JLONG z2 = tmp1 + tmp2;
+    JLONG z3 = tmp0 + tmp2;
+    JLONG z4 = tmp1 + tmp3;
+    JLONG z5 = (z3 + z4) * FIX_1_175875602;
+
+    tmp0 = tmp0 * FIX_0_298631336;
+    tmp1 = tmp1 * FIX_2_053119869;
+    tmp2 = tmp2 * FIX_3_072711026;
+    tmp3 = tmp3 * FIX_1_501321110;
+    z1 = z1 * -FIX_0_899976223;
+    z2 = z2 * -FIX_2_562915447;
+    z3 = z3 * -FIX_1_961570560 + z5;
+    z4 = z4 * -FIX_0_390180644 + z5;
+
+    tmp0 += z1 + z3;
+    tmp1 += z2 + z4;
+    tmp2 += z2 + z3;
+    tmp3 += z1 + z4;
+
+    out[0] = tmp10 + tmp3;
+    out[7] = tmp10 - tmp3;
+    out[1] = tmp11 + tmp2;
+    out[6] = tmp11 - tmp2;
+    out[2] = tmp12 + tmp1;
+    out[5] = tmp12 - tmp1;
+    out[3] = tmp13 + tmp0;
+    out[4] = tmp13 - tmp0;
+}
+
+void jsimd_esp_idct_islow(j_decompress_ptr cinfo, jpeg_component_info *compptr, JCOEFPTR coef_block,
+                          JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+    const JSAMPLE *range_limit = IDCT_range_limit(cinfo);
+    const ISLOW_MULT_TYPE *quantptr = (const ISLOW_MULT_TYPE *)compptr->dct_table;
+    int workspace[DCTSIZE2];
+    JLONG out[DCTSIZE];
+
+    /* Pass 1: columns of the input into the work array, scaled up by PASS1_BITS */
+    for (int col = 0; col < DCTSIZE; col++) {
+        const JCOEF *in = coef_block + col;
+        const ISLOW_MULT_TYPE *q = quantptr + col;
+        int *ws = workspace + col;
+
+        if (ac_is_zero(in, DCTSIZE)) {
+            int dcval = (int)LEFT_SHIFT((JLONG)in[0] * q[0], ISLOW_PASS1_BITS);
+            for (int i = 0; i < DCTSIZE; i++) {
+                ws[DCTSIZE * i] = dcval;
+            }
+            continue;
+        }
+        islow_1d((JLONG)in[DCTSIZE * 0] * q[DCTSIZE * 0], (JLONG)in[DCTSIZE * 1] * q[DCTSIZE * 1],
+                 (JLONG)in[DCTSIZE * 2] * q[DCTSIZE * 2], (JLONG)in[DCTSIZE * 3] * q[DCTSIZE * 3],
+                 (JLONG)in[DCTSIZE * 4] * q[DCTSIZE * 4], (JLONG)in[DCTSIZE * 5] * q[DCTSIZE * 5],
+                 (JLONG)in[DCTSIZE * 6] * q[DCTSIZE * 6], (JLONG)in[DCTSIZE * 7] * q[DCTSIZE * 7], out);
+        for (int i = 0; i < DCTSIZE; i++) {
+            ws[DCTSIZE * i] = (int)DESCALE(out[i], ISLOW_CONST_BITS - ISLOW_PASS1_BITS);
+        }
+    }
+
+    /* Pass 2: rows of the work array into the output, scaled down by PASS1_BITS and by 8 */
+    for (int row = 0; row < DCTSIZE; row++) {
+        const int *ws = workspace + row * DCTSIZE;
+        JSAMPROW outptr = output_buf[row] + output_col;
+
+        if (ws_ac_is_zero(ws)) {
+            JSAMPLE outval = range_limit[(int)DESCALE((JLONG)ws[0], ISLOW_PASS1_BITS + 3) & RANGE_MASK];
+            for (int i = 0; i < DCTSIZE; i++) {
+                outptr[i] = outval;
+            }
+            continue;
+        }
+        islow_1d(ws[0], ws[1], ws[2], ws[3], ws[4], ws[5], ws[6], ws[7], out);
+        for (int i = 0; i < DCTSIZE; i++) {
+            outptr[i] = range_limit[(int)DESCALE(out[i], ISLOW_CONST_BITS + ISLOW_PASS1_BITS + 3) & RANGE_MASK];
+        }
+    }
+}
+
+/*
+ * Even and odd parts of jidctfst.c
+ */
+static inline void ifast_1d(DCTELEM in0, DCTELEM in1, DCTELEM in2, DCTELEM in3, DCTELEM in4, DCTELEM in5,
+                            DCTELEM in6, DCTELEM in7, DCTELEM out[8])
+{
+    DCTELEM tmp10 = in0 + in4;
+    DCTELEM tmp11 = in0 - in4;
+    DCTELEM tmp13 = in2 + in6;
+    DCTELEM tmp12 = IFAST_MULTIPLY(in2 - in6, IFAST_FIX_1_414213562) - tmp13;
+
+    DCTELEM tmp0 = tmp10 + tmp13;
+    DCTELEM tmp3 = tmp10 - tmp13;
+    DCTELEM tmp1 = tmp11 + tmp12;
+    DCTELEM tmp2 = tmp11 - tmp12;
+
+    DCTELEM z13 = in5 + in3;
+    DCTELEM z10 = in5 - in3;
+    DCTELEM z11 = in1 + in7;
+    DCTELEM z12 = in1 - in7;
+
+    DCTELEM tmp7 = z11 + z13;
+    tmp11 = IFAST_MULTIPLY(z11 - z13, IFAST_FIX_1_414213562);
+    DCTELEM z5 = IFAST_MULTIPLY(z10 + z12, IFAST_FIX_1_847759065);
+    tmp10 = IFAST_MULTIPLY(z12, IFAST_FIX_1_082392200) - z5;
+    tmp12 = IFAST_MULTIPLY(z10, -IFAST_FIX_2_613125930) + z5;
+
+    DCTELEM tmp6 = tmp12 - tmp7;
+    DCTELEM tmp5 = tmp11 - tmp6;
+    DCTELEM tmp4 = tmp10 + tmp5;
+
+    out[0] = tmp0 + tmp7;
+    out[7] = tmp0 - tmp7;
+    out[1] = tmp1 + tmp6;
+    out[6] = tmp1 - tmp6;
+    out[2] = tmp2 + tmp5;
+    out[5] = tmp2 - tmp5;
+    out[4] = tmp3 + tmp4;
+    out[3] = tmp3 - tmp4;
+}
+
+void jsimd_esp_idct_ifast(j_decompress_ptr cinfo, jpeg_component_info *compptr, JCOEFPTR coef_block,
+                          JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+    const JSAMPLE *range_limit = IDCT_range_limit(cinfo);
+    const IFAST_MULT_TYPE *quantptr = (const IFAST_MULT_TYPE *)compptr->dct_table;
+    int workspace[DCTSIZE2];
+    DCTELEM out[DCTSIZE];
+
+    /* Pass 1: columns of the input into the work array, the quantization table of ifast being prescaled */
+    for (int col = 0; col < DCTSIZE; col++) {
+        const JCOEF *in = coef_block + col;
+        const IFAST_MULT_TYPE *q = quantptr + col;
+        int *ws = workspace + col;
+
+        if (ac_is_zero(in, DCTSIZE)) {
+            int dcval = (int)((IFAST_MULT_TYPE)in[0] * q[0]);
+            for (int i = 0; i < DCTSIZE; i++) {
+                ws[DCTSIZE * i] = dcval;
+            }
+            continue;
+        }
+        ifast_1d((DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 0] * q[DCTSIZE * 0]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 1] * q[DCTSIZE * 1]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 2] * q[DCTSIZE * 2]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 3] * q[DCTSIZE * 3]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 4] * q[DCTSIZE * 4]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 5] * q[DCTSIZE * 5]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 6] * q[DCTSIZE * 6]),
+                 (DCTELEM)((IFAST_MULT_TYPE)in[DCTSIZE * 7] * q[DCTSIZE * 7]), out);
+        for (int i = 0; i < DCTSIZE; i++) {
+            ws[DCTSIZE * i] = (int)out[i];
+        }
+    }
+
+    /* Pass 2: rows of the work array into the output, scaled down by PASS1_BITS and by 8, truncating */
+    for (int row = 0; row < DCTSIZE; row++) {
+        const int *ws = workspace + row * DCTSIZE;
+        JSAMPROW outptr = output_buf[row] + output_col;
+
+        if (ws_ac_is_zero(ws)) {
+            JSAMPLE outval = range_limit[(ws[0] >> (IFAST_PASS1_BITS + 3)) & RANGE_MASK];
+            for (int i = 0; i < DCTSIZE; i++) {
+                outptr[i] = outval;
+            }
+            continue;
+        }
+        ifast_1d(ws[0], ws[1], ws[2], ws[3], ws[4], ws[5], ws[6], ws[7], out);
+        for (int i = 0; i < DCTSIZE; i++) {
+            outptr[i] = range_limit[((int)out[i] >> (IFAST_PASS1_BITS + 3)) & RANGE_MASK];
+        }
+    }
+}
@@ -0,0 +1,34 @@
+# Weakens the symbols of the jsimd_none.c object of a static libjpeg-turbo library.
+#
+# Arguments: AR, OBJCOPY, LIB (the library to modify), WORK_DIR (a scratch directory)
+
+execute_process(COMMAND ${AR} t ${LIB}
+                OUTPUT_VARIABLE members
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Cannot list the members of ${LIB}")
+endif()
+
+string(REGEX MATCH "jsimd_none\\.c\\.o(bj)?" member "${members}")
+if(NOT member)
+    message(FATAL_ERROR "No jsimd_none.c object in ${LIB}")
+endif()
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+execute_process(COMMAND ${AR} x ${LIB} ${member}
+                WORKING_DIRECTORY ${WORK_DIR}
+                RESULT_VARIABLE result)
+if(result EQUAL 0)
+    execute_process(COMMAND ${OBJCOPY} --weaken ${member}
+                    WORKING_DIRECTORY ${WORK_DIR}
+                    RESULT_VARIABLE result)
+endif()
+if(result EQUAL 0)
+    execute_process(COMMAND ${AR} r ${LIB} ${WORK_DIR}/${member}
+                    RESULT_VARIABLE result)
+endif()
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Cannot weaken the symbols of ${member} in ${LIB}")
+endif()
@@ -14,6 +14,7 @@
 /* Derived from: scripts/pnglibconf.dfa */
 #ifndef PNGLCONF_H
 #define PNGLCONF_H
+#include "sdkconfig.h"
 /* options */
 #define PNG_16BIT_SUPPORTED
 #define PNG_ALIGNED_MEMORY_SUPPORTED
@@ -63,14 +64,22 @@
 #define PNG_READ_INTERLACING_SUPPORTED
 #define PNG_READ_INT_FUNCTIONS_SUPPORTED
 #define PNG_READ_INVERT_ALPHA_SUPPORTED
+#ifndef CONFIG_LIBPNG_TRIM_READ_TRANSFORMS
 #define PNG_READ_INVERT_SUPPORTED
+#endif
 #define PNG_READ_OPT_PLTE_SUPPORTED
+#ifndef CONFIG_LIBPNG_TRIM_READ_TRANSFORMS
 #define PNG_READ_PACKSWAP_SUPPORTED
+#endif
 #define PNG_READ_PACK_SUPPORTED
+#ifndef CONFIG_LIBPNG_TRIM_READ_TRANSFORMS
 #define PNG_READ_QUANTIZE_SUPPORTED
+#endif
 #define PNG_READ_RGB_TO_GRAY_SUPPORTED
 #define PNG_READ_SCALE_16_TO_8_SUPPORTED
+#ifndef CONFIG_LIBPNG_TRIM_READ_TRANSFORMS
 #define PNG_READ_SHIFT_SUPPORTED
+#endif
 #define PNG_READ_STRIP_16_TO_8_SUPPORTED
 #define PNG_READ_STRIP_ALPHA_SUPPORTED
 #define PNG_READ_SUPPORTED
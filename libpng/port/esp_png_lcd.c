@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_idf_version.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_png_stream.h"
+#include "esp_png_lcd.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+#define PNG_LCD_ASYNC_SUPPORTED 1
+#endif
+
+static const char *TAG = "esp_png_lcd";
+
+typedef struct {
+    const esp_png_lcd_config_t *config;
+    uint32_t width;
+    SemaphoreHandle_t trans_done; // given when no band is being sent
+} png_lcd_ctx_t;
+
+#if PNG_LCD_ASYNC_SUPPORTED
+static bool png_lcd_on_color_trans_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata,
+                                        void *user_ctx)
+{
+    png_lcd_ctx_t *ctx = (png_lcd_ctx_t *)user_ctx;
+    BaseType_t need_yield = pdFALSE;
+    xSemaphoreGiveFromISR(ctx->trans_done, &need_yield);
+    return need_yield == pdTRUE;
+}
+#endif
+
+static esp_err_t png_lcd_on_info(const esp_png_info_t *info, void *arg)
+{
+    png_lcd_ctx_t *ctx = (png_lcd_ctx_t *)arg;
+    ctx->width = info->width;
+    return ESP_OK;
+}
+
+static esp_err_t png_lcd_on_band(uint32_t y, uint32_t rows, const uint16_t *pixels, void *arg)
+{
+    png_lcd_ctx_t *ctx = (png_lcd_ctx_t *)arg;
+    const esp_png_lcd_config_t *config = ctx->config;
+    if (ctx->trans_done) {
+        // the previous band was sent from the buffer the decoder fills once this function returns
+        xSemaphoreTake(ctx->trans_done, portMAX_DELAY);
+    }
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(config->panel, config->x, config->y + y, config->x + ctx->width,
+                                              config->y + y + rows, pixels);
+    if (ret != ESP_OK && ctx->trans_done) {
+        // nothing is being sent
+        xSemaphoreGive(ctx->trans_done);
+    }
+    return ret;
+}
+
+esp_err_t esp_png_lcd_draw(const esp_png_lcd_config_t *config, const void *png, size_t len)
+{
+    ESP_RETURN_ON_FALSE(config && config->panel && png, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+#if !PNG_LCD_ASYNC_SUPPORTED
+    ESP_RETURN_ON_FALSE(!config->io, ESP_ERR_NOT_SUPPORTED, TAG, "io events not supported");
+#endif
+    esp_err_t ret = ESP_OK;
+    esp_png_stream_handle_t stream = NULL;
+    png_lcd_ctx_t ctx = {
+        .config = config,
+    };
+    esp_png_stream_config_t stream_config = {
+        .band_rows = config->band_rows,
+        .background = config->background,
+        .caps = MALLOC_CAP_DMA,
+        .on_info = png_lcd_on_info,
+        .on_band = png_lcd_on_band,
+        .arg = &ctx,
+        .flags = {
+            .swap_color_bytes = config->flags.swap_color_bytes,
+            .double_buffer = config->io != NULL,
+        },
+    };
+
+#if PNG_LCD_ASYNC_SUPPORTED
+    if (config->io) {
+        ctx.trans_done = xSemaphoreCreateBinary();
+        ESP_RETURN_ON_FALSE(ctx.trans_done, ESP_ERR_NO_MEM, TAG, "no memory for semaphore");
+        xSemaphoreGive(ctx.trans_done);
+        const esp_lcd_panel_io_callbacks_t cbs = {
+            .on_color_trans_done = png_lcd_on_color_trans_done,
+        };
+        ESP_GOTO_ON_ERROR(esp_lcd_panel_io_register_event_callbacks(config->io, &cbs, &ctx), err, TAG,
+                          "register io callbacks failed");
+    }
+#endif
+
+    ESP_GOTO_ON_ERROR(esp_png_stream_new(&stream_config, &stream), done, TAG, "create stream failed");
+    ret = esp_png_stream_feed(stream, png, len);
+    if (ret == ESP_OK) {
+        ret = esp_png_stream_finish(stream);
+    }
+
+done:
+#if PNG_LCD_ASYNC_SUPPORTED
+    if (config->io) {
+        // the last band is sent from the decoder, which can only be deleted then
+        xSemaphoreTake(ctx.trans_done, portMAX_DELAY);
+        const esp_lcd_panel_io_callbacks_t cbs = {0};
+        esp_lcd_panel_io_register_event_callbacks(config->io, &cbs, NULL);
+    }
+#endif
+    if (stream) {
+        esp_png_stream_del(stream);
+    }
+#if PNG_LCD_ASYNC_SUPPORTED
+err:
+    if (ctx.trans_done) {
+        vSemaphoreDelete(ctx.trans_done);
+    }
+#endif
+    return ret;
+}
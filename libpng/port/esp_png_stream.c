@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "png.h"
+#include "esp_png_stream.h"
+
+static const char *TAG = "esp_png_stream";
+
+typedef struct esp_png_stream_t {
+    png_structp png;
+    png_infop info;
+    esp_png_stream_config_t config;
+    uint32_t caps;
+    uint32_t width;
+    uint32_t height;
+    uint16_t *bands[2];
+    int band;            // index of the band being filled
+    uint32_t band_y;     // first row of the band being filled
+    uint8_t background[3];
+    esp_err_t err;       // error the decoding failed with, ESP_OK while it goes on
+    bool no_mem;         // an allocation failed, which is the cause of the next libpng error
+    bool done;
+} esp_png_stream_t;
+
+static png_voidp png_stream_malloc(png_structp png, png_alloc_size_t size)
+{
+    esp_png_stream_t *stream = (esp_png_stream_t *)png_get_mem_ptr(png);
+    void *ptr = heap_caps_malloc(size, stream->caps);
+    if (!ptr) {
+        stream->no_mem = true;
+    }
+    return ptr;
+}
+
+static void png_stream_free(png_structp png, png_voidp ptr)
+{
+    heap_caps_free(ptr);
+}
+
+static void png_stream_error(png_structp png, png_const_charp msg)
+{
+    esp_png_stream_t *stream = (esp_png_stream_t *)png_get_error_ptr(png);
+    if (stream->err == ESP_OK) {
+        stream->err = stream->no_mem ? ESP_ERR_NO_MEM : ESP_ERR_INVALID_RESPONSE;
+    }
+    ESP_LOGE(TAG, "%s", msg);
+    png_longjmp(png, 1);
+}
+
+static void png_stream_warning(png_structp png, png_const_charp msg)
+{
+    ESP_LOGW(TAG, "%s", msg);
+}
+
+/* Fails the decoding with err, does not return */
+static void png_stream_abort(esp_png_stream_t *stream, esp_err_t err, const char *msg)
+{
+    stream->err = err;
+    png_error(stream->png, msg);
+}
+
+static void png_stream_info_cb(png_structp png, png_infop info)
+{
+    esp_png_stream_t *stream = (esp_png_stream_t *)png_get_progressive_ptr(png);
+    png_uint_32 width;
+    png_uint_32 height;
+    int bit_depth;
+    int color_type;
+    int interlace;
+    png_get_IHDR(png, info, &width, &height, &bit_depth, &color_type, &interlace, NULL, NULL);
+    if (interlace != PNG_INTERLACE_NONE) {
+        png_stream_abort(stream, ESP_ERR_NOT_SUPPORTED, "interlaced images are not supported");
+    }
+    // whatever the format, get 8-bit RGBA rows
+    png_set_expand(png);
+    png_set_scale_16(png);
+    png_set_gray_to_rgb(png);
+    png_set_add_alpha(png, 0xff, PNG_FILLER_AFTER);
+    png_read_update_info(png, info);
+    if (png_get_channels(png, info) != 4 || png_get_rowbytes(png, info) != (size_t)width * 4) {
+        png_stream_abort(stream, ESP_ERR_INVALID_RESPONSE, "unexpected row format");
+    }
+    stream->width = width;
+    stream->height = height;
+
+    size_t band_size = (size_t)width * stream->config.band_rows * sizeof(uint16_t);
+    for (int i = 0; i < (stream->config.flags.double_buffer ? 2 : 1); i++) {
+        stream->bands[i] = heap_caps_malloc(band_size, stream->caps);
+        if (!stream->bands[i]) {
+            png_stream_abort(stream, ESP_ERR_NO_MEM, "no memory for the bands");
+        }
+    }
+    if (stream->config.on_info) {
+        esp_png_info_t png_info = {
+            .width = width,
+            .height = height,
+        };
+        esp_err_t err = stream->config.on_info(&png_info, stream->config.arg);
+        if (err != ESP_OK) {
+            png_stream_abort(stream, err, "info callback failed");
+        }
+    }
+}
+
+/* Blends a channel onto the background, rounding the division by 255 without dividing */
+static inline uint32_t png_stream_blend(uint32_t c, uint32_t bg, uint32_t a)
+{
+    uint32_t x = c * a + bg * (255 - a) + 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static void png_stream_row_cb(png_structp png, png_bytep row, png_uint_32 row_num, int pass)
+{
+    esp_png_stream_t *stream = (esp_png_stream_t *)png_get_progressive_ptr(png);
+    if (!row) {
+        return;
+    }
+    uint16_t *out = stream->bands[stream->band] + (size_t)(row_num - stream->band_y) * stream->width;
+    const uint8_t *bg = stream->background;
+    const bool swap = stream->config.flags.swap_color_bytes;
+    for (uint32_t x = 0; x < stream->width; x++, row += 4) {
+        uint32_t r = row[0];
+        uint32_t g = row[1];
+        uint32_t b = row[2];
+        uint32_t a = row[3];
+        if (a != 0xff) {
+            r = png_stream_blend(r, bg[0], a);
+            g = png_stream_blend(g, bg[1], a);
+            b = png_stream_blend(b, bg[2], a);
+        }
+        uint16_t pixel = ((r & 0xf8) << 8) | ((g & 0xfc) << 3) | (b >> 3);
+        out[x] = swap ? (uint16_t)((pixel >> 8) | (pixel << 8)) : pixel;
+    }
+
+    uint32_t rows = row_num + 1 - stream->band_y;
+    if (rows == stream->config.band_rows || row_num + 1 == stream->height) {
+        esp_err_t err = stream->config.on_band(stream->band_y, rows, stream->bands[stream->band], stream->config.arg);
+        if (err != ESP_OK) {
+            png_stream_abort(stream, err, "band callback failed");
+        }
+        stream->band_y = row_num + 1;
+        if (stream->config.flags.double_buffer) {
+            stream->band ^= 1;
+        }
+    }
+}
+
+static void png_stream_end_cb(png_structp png, png_infop info)
+{
+    esp_png_stream_t *stream = (esp_png_stream_t *)png_get_progressive_ptr(png);
+    stream->done = true;
+}
+
+esp_err_t esp_png_stream_new(const esp_png_stream_config_t *config, esp_png_stream_handle_t *ret_stream)
+{
+    ESP_RETURN_ON_FALSE(config && ret_stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->on_band && config->band_rows > 0, ESP_ERR_INVALID_ARG, TAG, "invalid band config");
+    const uint32_t caps = config->caps ? config->caps : MALLOC_CAP_DEFAULT;
+    esp_png_stream_t *stream = heap_caps_calloc(1, sizeof(esp_png_stream_t), caps);
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_NO_MEM, TAG, "no memory for stream");
+    stream->config = *config;
+    stream->caps = caps;
+    stream->background[0] = (config->background >> 16) & 0xff;
+    stream->background[1] = (config->background >> 8) & 0xff;
+    stream->background[2] = config->background & 0xff;
+
+    esp_err_t ret = ESP_OK;
+    stream->png = png_create_read_struct_2(PNG_LIBPNG_VER_STRING, stream, png_stream_error, png_stream_warning,
+                                           stream, png_stream_malloc, png_stream_free);
+    ESP_GOTO_ON_FALSE(stream->png, ESP_ERR_NO_MEM, err, TAG, "no memory for png struct");
+    stream->info = png_create_info_struct(stream->png);
+    ESP_GOTO_ON_FALSE(stream->info, ESP_ERR_NO_MEM, err, TAG, "no memory for png info");
+    if (config->flags.skip_checksums) {
+        png_set_crc_action(stream->png, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+        png_set_option(stream->png, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+    }
+    png_set_progressive_read_fn(stream->png, stream, png_stream_info_cb, png_stream_row_cb, png_stream_end_cb);
+    *ret_stream = stream;
+    return ESP_OK;
+
+err:
+    esp_png_stream_del(stream);
+    return ret;
+}
+
+esp_err_t esp_png_stream_feed(esp_png_stream_handle_t stream, const void *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(stream && (data || len == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(stream->err == ESP_OK && !stream->done, ESP_ERR_INVALID_STATE, TAG, "decoding is over");
+    if (setjmp(png_jmpbuf(stream->png))) {
+        return stream->err;
+    }
+    png_process_data(stream->png, stream->info, (png_bytep)data, len);
+    return ESP_OK;
+}
+
+esp_err_t esp_png_stream_finish(esp_png_stream_handle_t stream)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (stream->err != ESP_OK) {
+        return stream->err;
+    }
+    return stream->done ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t esp_png_stream_del(esp_png_stream_handle_t stream)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (stream->png) {
+        png_destroy_read_struct(&stream->png, stream->info ? &stream->info : NULL, NULL);
+    }
+    heap_caps_free(stream->bands[0]);
+    heap_caps_free(stream->bands[1]);
+    heap_caps_free(stream);
+    return ESP_OK;
+}
+
+esp_err_t esp_png_stream_decode(const esp_png_stream_config_t *config, const void *data, size_t len)
+{
+    esp_png_stream_handle_t stream = NULL;
+    ESP_RETURN_ON_ERROR(esp_png_stream_new(config, &stream), TAG, "create stream failed");
+    esp_err_t ret = esp_png_stream_feed(stream, data, len);
+    if (ret == ESP_OK) {
+        ret = esp_png_stream_finish(stream);
+    }
+    esp_png_stream_del(stream);
+    return ret;
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Configuration of the drawing of a PNG image on an LCD panel
+ */
+typedef struct {
+    esp_lcd_panel_handle_t panel;  /*!< Panel to draw on, in RGB565 */
+    esp_lcd_panel_io_handle_t io;  /*!< IO of the panel, to send a band while the next one is decoded, or NULL if
+                                        `esp_lcd_panel_draw_bitmap()` is done with the pixels when it returns */
+    int x;                         /*!< Column of the top left corner of the image on the panel */
+    int y;                         /*!< Row of the top left corner of the image on the panel */
+    uint32_t band_rows;            /*!< Number of rows drawn at once */
+    uint32_t background;           /*!< Color the transparent pixels are blended onto, as 0xRRGGBB */
+    struct {
+        uint32_t swap_color_bytes: 1; /*!< Send the pixels big-endian, as SPI LCDs expect them */
+    } flags;                       /*!< Drawing flags */
+} esp_png_lcd_config_t;
+
+/**
+ * @brief Draw a PNG image held in memory on an LCD panel, decoding and drawing it band by band
+ *
+ * The image is never held as a bitmap: each band is decoded into a DMA capable buffer and drawn with
+ * `esp_lcd_panel_draw_bitmap()`. With `io`, two bands are used in turn, and the next band is decoded while the
+ * previous one is sent; the transfers are followed with the color transfer done event of `io`.
+ *
+ * @note With `io`, the event callbacks of `io` are replaced while drawing and cleared at the end
+ * @note The image is not clipped, it must fit in the panel at the given position
+ *
+ * @param config Drawing configuration
+ * @param png PNG data
+ * @param len Length of the data, in bytes
+ * @return
+ *      - ESP_OK: Draw image successfully
+ *      - ESP_ERR_INVALID_ARG: Draw image failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Draw image failed because the image is interlaced, or `io` is given on an ESP-IDF
+ *        version without `esp_lcd_panel_io_register_event_callbacks()`
+ *      - Others: Draw image failed, see `esp_png_stream_feed()` and `esp_lcd_panel_draw_bitmap()`
+ */
+esp_err_t esp_png_lcd_draw(const esp_png_lcd_config_t *config, const void *png, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
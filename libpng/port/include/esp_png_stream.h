@@ -0,0 +1,147 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Streaming PNG decoder handle
+ */
+typedef struct esp_png_stream_t *esp_png_stream_handle_t;
+
+/**
+ * @brief Header of the decoded image
+ */
+typedef struct {
+    uint32_t width;  /*!< Width of the image, in pixels */
+    uint32_t height; /*!< Height of the image, in pixels */
+} esp_png_info_t;
+
+/**
+ * @brief Function called once the header of the image is decoded, before the first band
+ *
+ * @param info Header of the image
+ * @param arg User argument of the decoder
+ * @return ESP_OK to go on, any other error to abort the decoding, which then returns it
+ */
+typedef esp_err_t (*esp_png_info_cb_t)(const esp_png_info_t *info, void *arg);
+
+/**
+ * @brief Function called with each band of decoded rows
+ *
+ * @param y Index of the first row of the band
+ * @param rows Number of rows in the band, at most `band_rows`, fewer for the last band
+ * @param pixels RGB565 pixels of the band, `rows` rows of the image width. The buffer is written again by the decoder
+ *               once the function returns, or with the `double_buffer` flag, once the function for the next band
+ *               returns
+ * @param arg User argument of the decoder
+ * @return ESP_OK to go on, any other error to abort the decoding, which then returns it
+ */
+typedef esp_err_t (*esp_png_band_cb_t)(uint32_t y, uint32_t rows, const uint16_t *pixels, void *arg);
+
+/**
+ * @brief Streaming PNG decoder configuration
+ */
+typedef struct {
+    uint32_t band_rows;        /*!< Number of rows of a band */
+    uint32_t background;       /*!< Color the transparent pixels are blended onto, as 0xRRGGBB */
+    uint32_t caps;             /*!< Heap capabilities of the memory of the decoder, bands included, e.g.
+                                    MALLOC_CAP_INTERNAL to keep out of PSRAM or MALLOC_CAP_DMA for bands sent by DMA,
+                                    0 for MALLOC_CAP_DEFAULT */
+    esp_png_info_cb_t on_info; /*!< Function called with the header of the image, can be NULL */
+    esp_png_band_cb_t on_band; /*!< Function called with the bands */
+    void *arg;                 /*!< User argument passed to the functions */
+    struct {
+        uint32_t swap_color_bytes: 1; /*!< Store the pixels big-endian, as SPI LCDs expect them */
+        uint32_t double_buffer: 1;    /*!< Decode into two bands in turn, so a band can be sent while the next one
+                                           is decoded */
+        uint32_t skip_checksums: 1;   /*!< Skip the CRC of the chunks and the Adler-32 of the image data, for
+                                           images already known to be intact, e.g. embedded in the firmware */
+    } flags;                   /*!< Decoder flags */
+} esp_png_stream_config_t;
+
+/**
+ * @brief Create a streaming PNG decoder, converting the image to RGB565 bands as its data is fed
+ *
+ * The data is decoded with the progressive reader of libpng as it arrives, in pieces of any size, and the rows are
+ * converted to RGB565 and handed over in bands of `band_rows` rows. Neither the PNG file nor the bitmap is held in
+ * RAM: the decoder only needs the inflate window, a few rows of the image and the bands. Palette, grayscale
+ * and 16-bit images are converted, and the alpha channel is blended onto the background color.
+ *
+ * @note Interlaced images are not supported, as they can only be rebuilt in a full bitmap
+ *
+ * @param config Decoder configuration
+ * @param ret_stream Returned decoder handle
+ * @return
+ *      - ESP_OK: Create decoder successfully
+ *      - ESP_ERR_INVALID_ARG: Create decoder failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create decoder failed because of out of memory
+ */
+esp_err_t esp_png_stream_new(const esp_png_stream_config_t *config, esp_png_stream_handle_t *ret_stream);
+
+/**
+ * @brief Feed the next piece of the PNG data to the decoder, calling the functions of the decoder for what it completes
+ *
+ * @note Once an error is returned, the decoder can only be deleted
+ *
+ * @param stream Decoder handle
+ * @param data Data
+ * @param len Length of the data, in bytes
+ * @return
+ *      - ESP_OK: Feed data successfully
+ *      - ESP_ERR_INVALID_ARG: Feed data failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Feed data failed because the decoder has already failed or the image is complete
+ *      - ESP_ERR_INVALID_RESPONSE: Feed data failed because the data is not a valid PNG image
+ *      - ESP_ERR_NOT_SUPPORTED: Feed data failed because the image is interlaced
+ *      - ESP_ERR_NO_MEM: Feed data failed because of out of memory
+ *      - Others: Feed data failed because a function of the decoder returned this error
+ */
+esp_err_t esp_png_stream_feed(esp_png_stream_handle_t stream, const void *data, size_t len);
+
+/**
+ * @brief Check that the whole image has been fed and decoded
+ *
+ * @param stream Decoder handle
+ * @return
+ *      - ESP_OK: The image is complete
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_INVALID_SIZE: The image is truncated, its end has not been fed yet
+ *      - Others: The error the decoding failed with
+ */
+esp_err_t esp_png_stream_finish(esp_png_stream_handle_t stream);
+
+/**
+ * @brief Delete a streaming PNG decoder
+ *
+ * @param stream Decoder handle
+ * @return
+ *      - ESP_OK: Delete decoder successfully
+ *      - ESP_ERR_INVALID_ARG: Delete decoder failed because of invalid argument
+ */
+esp_err_t esp_png_stream_del(esp_png_stream_handle_t stream);
+
+/**
+ * @brief Decode a PNG image held in memory into RGB565 bands, with a decoder of this configuration
+ *
+ * @param config Decoder configuration
+ * @param data PNG data
+ * @param len Length of the data, in bytes
+ * @return
+ *      - ESP_OK: Decode image successfully
+ *      - ESP_ERR_INVALID_SIZE: Decode image failed because the image is truncated
+ *      - Others: Decode image failed, see `esp_png_stream_new()` and `esp_png_stream_feed()`
+ */
+esp_err_t esp_png_stream_decode(const esp_png_stream_config_t *config, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
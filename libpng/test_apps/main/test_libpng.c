@@ -8,6 +8,9 @@
 #include <string.h>
 #include "unity.h"
 #include "png.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_png_stream.h"
 
 extern const uint8_t in_png_start[] asm("_binary_in_png_start");
 extern const uint8_t in_png_end[]   asm("_binary_in_png_end");
@@ -54,4 +57,153 @@ TEST_CASE("load a png image", "[libpng]")
     fclose(expected);
 
     free(buffer);
-}
\ No newline at end of file
+}
+
+typedef struct {
+    const png_byte *rgba;   // expected image, from the simplified API
+    uint32_t width;
+    uint32_t next_y;
+    int mismatches;
+} band_check_t;
+
+static uint16_t rgba_to_rgb565(const png_byte *p, uint32_t background)
+{
+    uint32_t c[3];
+    for (int i = 0; i < 3; i++) {
+        uint32_t bg = (background >> (16 - 8 * i)) & 0xff;
+        uint32_t x = p[i] * p[3] + bg * (255 - p[3]) + 128;
+        c[i] = (x + (x >> 8)) >> 8;
+    }
+    return ((c[0] & 0xf8) << 8) | ((c[1] & 0xfc) << 3) | (c[2] >> 3);
+}
+
+static esp_err_t check_band(uint32_t y, uint32_t rows, const uint16_t *pixels, void *arg)
+{
+    band_check_t *check = (band_check_t *)arg;
+    TEST_ASSERT_EQUAL(check->next_y, y);
+    for (uint32_t i = 0; i < rows * check->width; i++) {
+        uint16_t expected = rgba_to_rgb565(check->rgba + ((size_t)y * check->width + i) * 4, 0x336699);
+        uint16_t swapped = (pixels[i] >> 8) | (pixels[i] << 8);
+        if (swapped != expected) {
+            check->mismatches++;
+        }
+    }
+    check->next_y = y + rows;
+    return ESP_OK;
+}
+
+static esp_err_t stop_band(uint32_t y, uint32_t rows, const uint16_t *pixels, void *arg)
+{
+    return y > 0 ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+TEST_CASE("decode a png image in rgb565 bands", "[libpng]")
+{
+    const uint8_t *buf = &in_png_start[0];
+    const size_t buf_len = in_png_end - in_png_start;
+
+    png_image image;
+    memset(&image, 0, (sizeof image));
+    image.version = PNG_IMAGE_VERSION;
+    TEST_ASSERT(png_image_begin_read_from_memory(&image, buf, buf_len));
+    image.format = PNG_FORMAT_RGBA;
+    png_bytep rgba = malloc(PNG_IMAGE_SIZE(image));
+    TEST_ASSERT_NOT_NULL(rgba);
+    TEST_ASSERT(png_image_finish_read(&image, NULL, rgba, 0, NULL));
+
+    band_check_t check = {
+        .rgba = rgba,
+        .width = image.width,
+    };
+    esp_png_stream_config_t config = {
+        .band_rows = 7,
+        .background = 0x336699,
+        .caps = MALLOC_CAP_INTERNAL,
+        .on_band = check_band,
+        .arg = &check,
+        .flags = {
+            .swap_color_bytes = 1,
+            .double_buffer = 1,
+        },
+    };
+    esp_png_stream_handle_t stream;
+    TEST_ESP_OK(esp_png_stream_new(&config, &stream));
+    // feed the image in pieces, as it would come from a file or a socket
+    for (size_t off = 0; off < buf_len; off += 100) {
+        size_t len = buf_len - off < 100 ? buf_len - off : 100;
+        TEST_ESP_OK(esp_png_stream_feed(stream, buf + off, len));
+    }
+    TEST_ESP_OK(esp_png_stream_finish(stream));
+    TEST_ESP_OK(esp_png_stream_del(stream));
+    TEST_ASSERT_EQUAL(image.height, check.next_y);
+    TEST_ASSERT_EQUAL(0, check.mismatches);
+
+    // a truncated image is reported
+    check.next_y = 0;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_png_stream_decode(&config, buf, buf_len / 2));
+
+    // so is an error of the band callback
+    config.on_band = stop_band;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_png_stream_decode(&config, buf, buf_len));
+
+    free(rgba);
+    png_image_free(&image);
+}
+
+#define SPEED_RUNS 10
+
+static esp_err_t drop_band(uint32_t y, uint32_t rows, const uint16_t *pixels, void *arg)
+{
+    return ESP_OK;
+}
+
+static void print_speed(const char *name, int64_t us, size_t png_len, size_t pixels)
+{
+    printf("%-28s %6lld us/image, %5u KB/s of PNG, %5u kpixel/s\n", name, us / SPEED_RUNS,
+           (unsigned)((uint64_t)png_len * SPEED_RUNS * 1000000 / 1024 / us),
+           (unsigned)((uint64_t)pixels * SPEED_RUNS * 1000 / us));
+}
+
+TEST_CASE("png decode speed", "[libpng]")
+{
+    const uint8_t *buf = &in_png_start[0];
+    const size_t buf_len = in_png_end - in_png_start;
+
+    png_image image;
+    memset(&image, 0, (sizeof image));
+    image.version = PNG_IMAGE_VERSION;
+    TEST_ASSERT(png_image_begin_read_from_memory(&image, buf, buf_len));
+    image.format = PNG_FORMAT_RGBA;
+    const size_t pixels = image.width * image.height;
+    png_bytep rgba = malloc(PNG_IMAGE_SIZE(image));
+    TEST_ASSERT_NOT_NULL(rgba);
+    png_image_free(&image);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < SPEED_RUNS; i++) {
+        memset(&image, 0, (sizeof image));
+        image.version = PNG_IMAGE_VERSION;
+        TEST_ASSERT(png_image_begin_read_from_memory(&image, buf, buf_len));
+        image.format = PNG_FORMAT_RGBA;
+        TEST_ASSERT(png_image_finish_read(&image, NULL, rgba, 0, NULL));
+    }
+    print_speed("simplified API, RGBA", esp_timer_get_time() - start, buf_len, pixels);
+    free(rgba);
+
+    esp_png_stream_config_t config = {
+        .band_rows = 16,
+        .on_band = drop_band,
+    };
+    start = esp_timer_get_time();
+    for (int i = 0; i < SPEED_RUNS; i++) {
+        TEST_ESP_OK(esp_png_stream_decode(&config, buf, buf_len));
+    }
+    print_speed("stream, RGB565", esp_timer_get_time() - start, buf_len, pixels);
+
+    config.flags.skip_checksums = 1;
+    start = esp_timer_get_time();
+    for (int i = 0; i < SPEED_RUNS; i++) {
+        TEST_ESP_OK(esp_png_stream_decode(&config, buf, buf_len));
+    }
+    print_speed("stream, RGB565, no checksum", esp_timer_get_time() - start, buf_len, pixels);
+}
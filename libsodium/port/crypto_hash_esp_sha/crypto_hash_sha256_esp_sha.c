@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "crypto_hash_sha256.h"
+#include "private/common.h"
+#include "utils.h"
+#include "esp_sha_process.h"
+
+/* SHA256 on the SHA peripheral, keeping libsodium's state structure.
+
+   'count' and 'buf' have their libsodium meaning: the number of bits hashed and the pending partial block. 'state'
+   holds the intermediate digest as read from the peripheral, which is only meaningful to it, and is loaded back into
+   it for the next blocks. As the peripheral is released between calls, any number of states can be used at once, and
+   with mbedTLS.
+
+   Every SHA256 consumer of libsodium, HMAC-SHA256, HKDF-SHA256 and the PBKDF2 of scrypt, goes through these
+   functions.
+*/
+
+#define SHA256_BLOCK_BYTES 64U
+
+_Static_assert(sizeof(((crypto_hash_sha256_state *)0)->state) == crypto_hash_sha256_BYTES, "state mismatch");
+
+int
+crypto_hash_sha256_init(crypto_hash_sha256_state *state)
+{
+    memset(state, 0, sizeof(*state));
+    return 0;
+}
+
+int
+crypto_hash_sha256_update(crypto_hash_sha256_state *state,
+                          const unsigned char *in, unsigned long long inlen)
+{
+    size_t r = (size_t) ((state->count >> 3) & (SHA256_BLOCK_BYTES - 1));
+    /* Nothing reached the peripheral yet if all the bytes counted are still buffered */
+    bool   first_block = (state->count >> 3) == r;
+    size_t head_len = 0;
+    size_t bulk_len;
+
+    if (inlen == 0) {
+        return 0;
+    }
+    state->count += (uint64_t) inlen << 3;
+    if (inlen < SHA256_BLOCK_BYTES - r) {
+        memcpy(&state->buf[r], in, (size_t) inlen);
+        return 0;
+    }
+    if (r != 0) {
+        memcpy(&state->buf[r], in, SHA256_BLOCK_BYTES - r);
+        in += SHA256_BLOCK_BYTES - r;
+        inlen -= SHA256_BLOCK_BYTES - r;
+        head_len = SHA256_BLOCK_BYTES;
+    }
+    bulk_len = (size_t) (inlen & ~(unsigned long long) (SHA256_BLOCK_BYTES - 1));
+    if (sodium_esp_sha_process(SHA2_256, state->state, first_block,
+                               state->buf, head_len, in, bulk_len) != 0) {
+        return -1;
+    }
+    memcpy(state->buf, in + bulk_len, (size_t) inlen - bulk_len);
+
+    return 0;
+}
+
+int
+crypto_hash_sha256_final(crypto_hash_sha256_state *state, unsigned char *out)
+{
+    size_t r = (size_t) ((state->count >> 3) & (SHA256_BLOCK_BYTES - 1));
+    bool   first_block = (state->count >> 3) == r;
+    int    ret;
+
+    state->buf[r++] = 0x80;
+    if (r > SHA256_BLOCK_BYTES - 8) {
+        memset(&state->buf[r], 0, SHA256_BLOCK_BYTES - r);
+        if (sodium_esp_sha_process(SHA2_256, state->state, first_block,
+                                   NULL, 0, state->buf, SHA256_BLOCK_BYTES) != 0) {
+            sodium_memzero((void *) state, sizeof *state);
+            return -1;
+        }
+        first_block = false;
+        r = 0;
+    }
+    memset(&state->buf[r], 0, SHA256_BLOCK_BYTES - 8 - r);
+    STORE64_BE(&state->buf[SHA256_BLOCK_BYTES - 8], state->count);
+    ret = sodium_esp_sha_process(SHA2_256, state->state, first_block,
+                                 NULL, 0, state->buf, SHA256_BLOCK_BYTES);
+    if (ret == 0) {
+        /* The peripheral's digest is already in output byte order */
+        memcpy(out, state->state, crypto_hash_sha256_BYTES);
+    }
+    sodium_memzero((void *) state, sizeof *state);
+
+    return ret;
+}
+
+int
+crypto_hash_sha256(unsigned char *out, const unsigned char *in,
+                   unsigned long long inlen)
+{
+    crypto_hash_sha256_state state;
+
+    crypto_hash_sha256_init(&state);
+    if (crypto_hash_sha256_update(&state, in, inlen) != 0) {
+        sodium_memzero(&state, sizeof state);
+        return -1;
+    }
+    return crypto_hash_sha256_final(&state, out);
+}
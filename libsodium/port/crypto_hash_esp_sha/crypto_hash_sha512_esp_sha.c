@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include "crypto_hash_sha512.h"
+#include "private/common.h"
+#include "utils.h"
+#include "esp_sha_process.h"
+
+/* SHA512 on the SHA peripheral, keeping libsodium's state structure.
+
+   'count' and 'buf' have their libsodium meaning: the number of bits hashed, count[0] being the high word, and the
+   pending partial block. 'state'
+   holds the intermediate digest as read from the peripheral, which is only meaningful to it, and is loaded back into
+   it for the next blocks. As the peripheral is released between calls, any number of states can be used at once, and
+   with mbedTLS.
+
+   Every SHA512 consumer of libsodium, HMAC-SHA512, HMAC-SHA512-256, HKDF-SHA512 and Ed25519, goes through these
+   functions.
+*/
+
+#define SHA512_BLOCK_BYTES 128U
+
+_Static_assert(sizeof(((crypto_hash_sha512_state *)0)->state) == crypto_hash_sha512_BYTES, "state mismatch");
+
+int
+crypto_hash_sha512_init(crypto_hash_sha512_state *state)
+{
+    memset(state, 0, sizeof(*state));
+    return 0;
+}
+
+/* Nothing reached the peripheral yet if all the bytes counted are still buffered */
+static bool
+sha512_first_block(const crypto_hash_sha512_state *state, size_t r)
+{
+    return state->count[0] == 0 && (state->count[1] >> 3) == r;
+}
+
+int
+crypto_hash_sha512_update(crypto_hash_sha512_state *state,
+                          const unsigned char *in, unsigned long long inlen)
+{
+    size_t   r = (size_t) ((state->count[1] >> 3) & (SHA512_BLOCK_BYTES - 1));
+    bool     first_block = sha512_first_block(state, r);
+    uint64_t bitlen = (uint64_t) inlen << 3;
+    size_t   head_len = 0;
+    size_t   bulk_len;
+
+    if (inlen == 0) {
+        return 0;
+    }
+    if ((state->count[1] += bitlen) < bitlen) {
+        state->count[0]++;
+    }
+    state->count[0] += (uint64_t) inlen >> 61;
+    if (inlen < SHA512_BLOCK_BYTES - r) {
+        memcpy(&state->buf[r], in, (size_t) inlen);
+        return 0;
+    }
+    if (r != 0) {
+        memcpy(&state->buf[r], in, SHA512_BLOCK_BYTES - r);
+        in += SHA512_BLOCK_BYTES - r;
+        inlen -= SHA512_BLOCK_BYTES - r;
+        head_len = SHA512_BLOCK_BYTES;
+    }
+    bulk_len = (size_t) (inlen & ~(unsigned long long) (SHA512_BLOCK_BYTES - 1));
+    if (sodium_esp_sha_process(SHA2_512, state->state, first_block,
+                               state->buf, head_len, in, bulk_len) != 0) {
+        return -1;
+    }
+    memcpy(state->buf, in + bulk_len, (size_t) inlen - bulk_len);
+
+    return 0;
+}
+
+int
+crypto_hash_sha512_final(crypto_hash_sha512_state *state, unsigned char *out)
+{
+    size_t r = (size_t) ((state->count[1] >> 3) & (SHA512_BLOCK_BYTES - 1));
+    bool   first_block = sha512_first_block(state, r);
+    int    ret;
+
+    state->buf[r++] = 0x80;
+    if (r > SHA512_BLOCK_BYTES - 16) {
+        memset(&state->buf[r], 0, SHA512_BLOCK_BYTES - r);
+        if (sodium_esp_sha_process(SHA2_512, state->state, first_block,
+                                   NULL, 0, state->buf, SHA512_BLOCK_BYTES) != 0) {
+            sodium_memzero((void *) state, sizeof *state);
+            return -1;
+        }
+        first_block = false;
+        r = 0;
+    }
+    memset(&state->buf[r], 0, SHA512_BLOCK_BYTES - 16 - r);
+    STORE64_BE(&state->buf[SHA512_BLOCK_BYTES - 16], state->count[0]);
+    STORE64_BE(&state->buf[SHA512_BLOCK_BYTES - 8], state->count[1]);
+    ret = sodium_esp_sha_process(SHA2_512, state->state, first_block,
+                                 NULL, 0, state->buf, SHA512_BLOCK_BYTES);
+    if (ret == 0) {
+        /* The peripheral's digest is already in output byte order */
+        memcpy(out, state->state, crypto_hash_sha512_BYTES);
+    }
+    sodium_memzero((void *) state, sizeof *state);
+
+    return ret;
+}
+
+int
+crypto_hash_sha512(unsigned char *out, const unsigned char *in,
+                   unsigned long long inlen)
+{
+    crypto_hash_sha512_state state;
+
+    crypto_hash_sha512_init(&state);
+    if (crypto_hash_sha512_update(&state, in, inlen) != 0) {
+        sodium_memzero(&state, sizeof state);
+        return -1;
+    }
+    return crypto_hash_sha512_final(&state, out);
+}
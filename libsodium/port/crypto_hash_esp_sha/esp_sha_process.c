@@ -0,0 +1,48 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "soc/soc_caps.h"
+#if SOC_SHA_SUPPORT_DMA
+#include "sha/sha_dma.h"
+#else
+#include "sha/sha_core.h"
+#endif
+#include "esp_sha_process.h"
+
+int
+sodium_esp_sha_process(esp_sha_type type, void *digest, bool first_block,
+                       const uint8_t *head, size_t head_len,
+                       const uint8_t *in, size_t in_len)
+{
+    int ret = 0;
+
+    esp_sha_acquire_hardware();
+    if (!first_block) {
+        esp_sha_write_digest_state(type, digest);
+    }
+#if SOC_SHA_SUPPORT_DMA
+    /* One DMA transfer for the buffered block and all the complete blocks of the input. Input the DMA can't read,
+       e.g. in flash, is fed block by block by esp_sha_dma() itself */
+    ret = esp_sha_dma(type, in, in_len, head, head_len, first_block);
+#else
+    const size_t block_len = (type == SHA2_256) ? 64 : 128;
+
+    if (head_len != 0) {
+        esp_sha_block(type, head, first_block);
+        first_block = false;
+    }
+    for (size_t i = 0; i < in_len; i += block_len) {
+        esp_sha_block(type, in + i, first_block);
+        first_block = false;
+    }
+#endif
+    if (ret == 0) {
+        esp_sha_read_digest_state(type, digest);
+    }
+    esp_sha_release_hardware();
+
+    return ret == 0 ? 0 : -1;
+}
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hal/sha_types.h"
+
+/* Hash complete blocks with the SHA peripheral.
+
+   'digest' holds the intermediate digest in the peripheral's own format: it is loaded before hashing, unless
+   'first_block' tells that nothing has been hashed yet and the peripheral starts from the initial hash value, and it
+   is read back after. The 'head' block, when 'head_len' isn't 0, is hashed before 'in'. 'head_len' is 0 or one block,
+   'in_len' a multiple of the block size.
+
+   Returns 0 on success, -1 if the peripheral failed.
+*/
+int sodium_esp_sha_process(esp_sha_type type, void *digest, bool first_block,
+                           const uint8_t *head, size_t head_len,
+                           const uint8_t *in, size_t in_len);
@@ -0,0 +1,232 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "crypto_stream_chacha20.h"
+#include "private/common.h"
+#include "utils.h"
+#include "crypto_stream/chacha20/stream_chacha20.h"
+
+/* Replacement of libsodium's chacha20_ref.c, defining the same implementation, for the 32-bit ESP cores.
+
+   libsodium's reference code loads and stores every word of the message with LOAD32_LE / STORE32_LE, which turn
+   into byte accesses as the buffers may be misaligned. Here a block of key stream is computed at once, and XORed
+   by words when both buffers are word-aligned, or through an aligned copy otherwise: crypto_secretstream, for
+   instance, writes the ciphertext one byte after the tag. The counter carries into the next word as in the
+   reference code.
+
+   Interleaving several blocks doesn't pay on these cores: the 16 words of one block already take all the registers.
+*/
+
+#ifndef NATIVE_LITTLE_ENDIAN
+#error "The key stream is XORed by words, which needs a little endian target"
+#endif
+
+#define CHACHA20_BLOCK_BYTES 64U
+
+#define QUARTERROUND(a, b, c, d)      \
+    a += b; d = ROTL32(d ^ a, 16);    \
+    c += d; b = ROTL32(b ^ c, 12);    \
+    a += b; d = ROTL32(d ^ a, 8);     \
+    c += d; b = ROTL32(b ^ c, 7)
+
+static void
+chacha20_esp_keysetup(uint32_t input[16], const unsigned char *k)
+{
+    input[0] = 0x61707865;
+    input[1] = 0x3320646e;
+    input[2] = 0x79622d32;
+    input[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        input[4 + i] = LOAD32_LE(k + 4 * i);
+    }
+}
+
+static void
+chacha20_esp_ivsetup(uint32_t input[16], const unsigned char *iv, const unsigned char *counter)
+{
+    input[12] = counter == NULL ? 0 : LOAD32_LE(counter + 0);
+    input[13] = counter == NULL ? 0 : LOAD32_LE(counter + 4);
+    input[14] = LOAD32_LE(iv + 0);
+    input[15] = LOAD32_LE(iv + 4);
+}
+
+static void
+chacha20_esp_ietf_ivsetup(uint32_t input[16], const unsigned char *iv, const unsigned char *counter)
+{
+    input[12] = counter == NULL ? 0 : LOAD32_LE(counter);
+    input[13] = LOAD32_LE(iv + 0);
+    input[14] = LOAD32_LE(iv + 4);
+    input[15] = LOAD32_LE(iv + 8);
+}
+
+/* One block of key stream, then the next counter */
+static void
+chacha20_esp_block(uint32_t input[16], uint32_t out[16])
+{
+    uint32_t x0 = input[0], x1 = input[1], x2 = input[2], x3 = input[3];
+    uint32_t x4 = input[4], x5 = input[5], x6 = input[6], x7 = input[7];
+    uint32_t x8 = input[8], x9 = input[9], x10 = input[10], x11 = input[11];
+    uint32_t x12 = input[12], x13 = input[13], x14 = input[14], x15 = input[15];
+
+    for (int i = 0; i < 10; i++) {
+        QUARTERROUND(x0, x4, x8, x12);
+        QUARTERROUND(x1, x5, x9, x13);
+        QUARTERROUND(x2, x6, x10, x14);
+        QUARTERROUND(x3, x7, x11, x15);
+        QUARTERROUND(x0, x5, x10, x15);
+        QUARTERROUND(x1, x6, x11, x12);
+        QUARTERROUND(x2, x7, x8, x13);
+        QUARTERROUND(x3, x4, x9, x14);
+    }
+    out[0] = x0 + input[0];
+    out[1] = x1 + input[1];
+    out[2] = x2 + input[2];
+    out[3] = x3 + input[3];
+    out[4] = x4 + input[4];
+    out[5] = x5 + input[5];
+    out[6] = x6 + input[6];
+    out[7] = x7 + input[7];
+    out[8] = x8 + input[8];
+    out[9] = x9 + input[9];
+    out[10] = x10 + input[10];
+    out[11] = x11 + input[11];
+    out[12] = x12 + input[12];
+    out[13] = x13 + input[13];
+    out[14] = x14 + input[14];
+    out[15] = x15 + input[15];
+
+    if (++input[12] == 0) {
+        input[13]++;
+    }
+}
+
+static void
+chacha20_esp_encrypt_bytes(uint32_t input[16], const unsigned char *m, unsigned char *c,
+                           unsigned long long bytes)
+{
+    uint32_t ks[16];
+    uint32_t tmp[16];
+
+    while (bytes >= CHACHA20_BLOCK_BYTES) {
+        chacha20_esp_block(input, ks);
+        if ((((uintptr_t) m | (uintptr_t) c) & 3U) == 0) {
+            const uint32_t *mw = (const uint32_t *) (const void *) m;
+            uint32_t       *cw = (uint32_t *) (void *) c;
+
+            for (int i = 0; i < 16; i++) {
+                cw[i] = mw[i] ^ ks[i];
+            }
+        } else {
+            memcpy(tmp, m, CHACHA20_BLOCK_BYTES);
+            for (int i = 0; i < 16; i++) {
+                tmp[i] ^= ks[i];
+            }
+            memcpy(c, tmp, CHACHA20_BLOCK_BYTES);
+        }
+        m += CHACHA20_BLOCK_BYTES;
+        c += CHACHA20_BLOCK_BYTES;
+        bytes -= CHACHA20_BLOCK_BYTES;
+    }
+    if (bytes > 0) {
+        const unsigned char *ks_bytes = (const unsigned char *) ks;
+
+        chacha20_esp_block(input, ks);
+        for (size_t i = 0; i < (size_t) bytes; i++) {
+            c[i] = m[i] ^ ks_bytes[i];
+        }
+    }
+    sodium_memzero(ks, sizeof ks);
+    sodium_memzero(tmp, sizeof tmp);
+}
+
+static int
+stream_esp(unsigned char *c, unsigned long long clen, const unsigned char *n,
+           const unsigned char *k)
+{
+    uint32_t input[16];
+
+    if (!clen) {
+        return 0;
+    }
+    COMPILER_ASSERT(crypto_stream_chacha20_KEYBYTES == 256 / 8);
+    chacha20_esp_keysetup(input, k);
+    chacha20_esp_ivsetup(input, n, NULL);
+    memset(c, 0, clen);
+    chacha20_esp_encrypt_bytes(input, c, c, clen);
+    sodium_memzero(input, sizeof input);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_esp(unsigned char *c, unsigned long long clen,
+                    const unsigned char *n, const unsigned char *k)
+{
+    uint32_t input[16];
+
+    if (!clen) {
+        return 0;
+    }
+    chacha20_esp_keysetup(input, k);
+    chacha20_esp_ietf_ivsetup(input, n, NULL);
+    memset(c, 0, clen);
+    chacha20_esp_encrypt_bytes(input, c, c, clen);
+    sodium_memzero(input, sizeof input);
+
+    return 0;
+}
+
+static int
+stream_esp_xor_ic(unsigned char *c, const unsigned char *m,
+                  unsigned long long mlen, const unsigned char *n, uint64_t ic,
+                  const unsigned char *k)
+{
+    uint32_t      input[16];
+    unsigned char ic_bytes[8];
+
+    if (!mlen) {
+        return 0;
+    }
+    STORE32_LE(&ic_bytes[0], (uint32_t) ic);
+    STORE32_LE(&ic_bytes[4], (uint32_t) (ic >> 32));
+    chacha20_esp_keysetup(input, k);
+    chacha20_esp_ivsetup(input, n, ic_bytes);
+    chacha20_esp_encrypt_bytes(input, m, c, mlen);
+    sodium_memzero(input, sizeof input);
+
+    return 0;
+}
+
+static int
+stream_ietf_ext_esp_xor_ic(unsigned char *c, const unsigned char *m,
+                           unsigned long long mlen, const unsigned char *n,
+                           uint32_t ic, const unsigned char *k)
+{
+    uint32_t      input[16];
+    unsigned char ic_bytes[4];
+
+    if (!mlen) {
+        return 0;
+    }
+    STORE32_LE(ic_bytes, ic);
+    chacha20_esp_keysetup(input, k);
+    chacha20_esp_ietf_ivsetup(input, n, ic_bytes);
+    chacha20_esp_encrypt_bytes(input, m, c, mlen);
+    sodium_memzero(input, sizeof input);
+
+    return 0;
+}
+
+struct crypto_stream_chacha20_implementation
+    crypto_stream_chacha20_ref_implementation = {
+    SODIUM_C99(.stream =) stream_esp,
+    SODIUM_C99(.stream_ietf_ext =) stream_ietf_ext_esp,
+    SODIUM_C99(.stream_xor_ic =) stream_esp_xor_ic,
+    SODIUM_C99(.stream_ietf_ext_xor_ic =) stream_ietf_ext_esp_xor_ic
+};
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include "unity.h"
-#include "sodium/crypto_hash_sha256.h"
-#include "sodium/crypto_hash_sha512.h"
+#include "sdkconfig.h"
+#include "esp_timer.h"
+#include "sodium.h"
+#include "mbedtls/gcm.h"
 
 
 #define LIBSODIUM_TEST(name_) \
@@ -38,6 +41,15 @@ LIBSODIUM_TEST(box2)
 LIBSODIUM_TEST(ed25519_convert)
 LIBSODIUM_TEST(hash)
 LIBSODIUM_TEST(sign)
+LIBSODIUM_TEST(auth)
+LIBSODIUM_TEST(auth2)
+LIBSODIUM_TEST(auth3)
+LIBSODIUM_TEST(auth5)
+LIBSODIUM_TEST(auth6)
+LIBSODIUM_TEST(auth7)
+LIBSODIUM_TEST(kdf_hkdf)
+LIBSODIUM_TEST(xchacha20)
+LIBSODIUM_TEST(aead_xchacha20poly1305)
 
 
 TEST_CASE("sha256 sanity check", "[libsodium]")
@@ -98,3 +110,191 @@ TEST_CASE("sha512 sanity check", "[libsodium]")
     crypto_hash_sha512_final(&state, calculated);
     TEST_ASSERT_EQUAL_MEMORY(expected, calculated, crypto_hash_sha512_bytes());
 }
+
+#define SPEED_RUNS 32
+
+static void print_speed(const char *name, size_t len, int64_t us)
+{
+    printf("%-22s %6u bytes: %7lld us/op, %6u KB/s\n", name, (unsigned)len, us / SPEED_RUNS,
+           (unsigned)((uint64_t)len * SPEED_RUNS * 1000000 / 1024 / us));
+}
+
+/* Run once with CONFIG_LIBSODIUM_USE_HARDWARE_SHA and once without (sdkconfig.ci.software_sha) to compare */
+TEST_CASE("sha2 primitives speed", "[libsodium]")
+{
+    const size_t sizes[] = { 64, 1024, 16384 };
+    unsigned char key[crypto_auth_hmacsha512_KEYBYTES] = { 0 };
+    unsigned char out[crypto_hash_sha512_BYTES];
+    unsigned char sig[crypto_sign_BYTES];
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    unsigned char prk[crypto_kdf_hkdf_sha256_KEYBYTES];
+    unsigned char *msg = malloc(sizes[2]);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_EQUAL(0, sodium_init() < 0);
+    randombytes_buf(msg, sizes[2]);
+    crypto_sign_keypair(pk, sk);
+
+#if CONFIG_LIBSODIUM_USE_HARDWARE_SHA
+    printf("SHA-2 on the SHA peripheral\n");
+#else
+    printf("SHA-2 in software\n");
+#endif
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        const size_t len = sizes[i];
+        int64_t start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_hash_sha256(out, msg, len);
+        }
+        print_speed("crypto_hash_sha256", len, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_hash_sha512(out, msg, len);
+        }
+        print_speed("crypto_hash_sha512", len, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_auth_hmacsha256(out, msg, len, key);
+        }
+        print_speed("crypto_auth_hmacsha256", len, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_auth_hmacsha512(out, msg, len, key);
+        }
+        print_speed("crypto_auth_hmacsha512", len, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_kdf_hkdf_sha256_extract(prk, key, sizeof(key), msg, len);
+        }
+        print_speed("crypto_kdf_hkdf_sha256", len, esp_timer_get_time() - start);
+
+        start = esp_timer_get_time();
+        for (int r = 0; r < SPEED_RUNS; r++) {
+            crypto_sign_detached(sig, NULL, msg, len, sk);
+        }
+        print_speed("crypto_sign_detached", len, esp_timer_get_time() - start);
+    }
+    free(msg);
+}
+
+#define CURVE_RUNS 8
+
+static void print_op_time(const char *name, int64_t us)
+{
+    printf("%-24s %7lld us/op\n", name, us / CURVE_RUNS);
+}
+
+/* Compare with and without CONFIG_LIBSODIUM_CURVE25519_OPTIMIZE_SPEED and CONFIG_LIBSODIUM_CURVE25519_IN_IRAM */
+TEST_CASE("curve25519 speed", "[libsodium]")
+{
+    unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+    unsigned char sk[crypto_sign_SECRETKEYBYTES];
+    unsigned char sig[crypto_sign_BYTES];
+    unsigned char msg[64];
+    unsigned char x_sk[crypto_scalarmult_SCALARBYTES];
+    unsigned char x_pk[crypto_scalarmult_BYTES];
+    unsigned char shared[crypto_scalarmult_BYTES];
+    TEST_ASSERT_EQUAL(0, sodium_init() < 0);
+    randombytes_buf(msg, sizeof(msg));
+    randombytes_buf(x_sk, sizeof(x_sk));
+
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < CURVE_RUNS; r++) {
+        crypto_sign_keypair(pk, sk);
+    }
+    print_op_time("crypto_sign_keypair", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < CURVE_RUNS; r++) {
+        crypto_sign_detached(sig, NULL, msg, sizeof(msg), sk);
+    }
+    print_op_time("crypto_sign_detached", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < CURVE_RUNS; r++) {
+        TEST_ASSERT_EQUAL(0, crypto_sign_verify_detached(sig, msg, sizeof(msg), pk));
+    }
+    print_op_time("crypto_sign_verify", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < CURVE_RUNS; r++) {
+        TEST_ASSERT_EQUAL(0, crypto_scalarmult_base(x_pk, x_sk));
+    }
+    print_op_time("crypto_scalarmult_base", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < CURVE_RUNS; r++) {
+        TEST_ASSERT_EQUAL(0, crypto_scalarmult(shared, x_sk, x_pk));
+    }
+    print_op_time("crypto_scalarmult", esp_timer_get_time() - start);
+}
+
+#define AEAD_CHUNK_BYTES (16 * 1024)
+#define AEAD_RUNS        16
+
+static void print_mb_per_s(const char *name, int64_t us)
+{
+    printf("%-36s %6lld us/16 KB, %.2f MB/s\n", name, us / AEAD_RUNS,
+           (double)AEAD_CHUNK_BYTES * AEAD_RUNS / us);
+}
+
+/* 16 KB chunks, as when shipping logs. Compare with and without CONFIG_LIBSODIUM_CHACHA20_POLY1305_OPTIMIZE_SPEED */
+TEST_CASE("chacha20poly1305 vs aes-gcm speed", "[libsodium]")
+{
+    unsigned char key[crypto_aead_chacha20poly1305_ietf_KEYBYTES];
+    unsigned char nonce[crypto_aead_xchacha20poly1305_ietf_NPUBBYTES] = { 0 };
+    unsigned char tag[16];
+    unsigned char header[crypto_secretstream_xchacha20poly1305_HEADERBYTES];
+    crypto_secretstream_xchacha20poly1305_state st;
+    unsigned char *msg = malloc(AEAD_CHUNK_BYTES);
+    unsigned char *out = malloc(AEAD_CHUNK_BYTES + crypto_secretstream_xchacha20poly1305_ABYTES);
+    TEST_ASSERT_NOT_NULL(msg);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL(0, sodium_init() < 0);
+    randombytes_buf(msg, AEAD_CHUNK_BYTES);
+    crypto_secretstream_xchacha20poly1305_keygen(key);
+
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < AEAD_RUNS; r++) {
+        crypto_stream_chacha20_ietf_xor(out, msg, AEAD_CHUNK_BYTES, nonce, key);
+    }
+    print_mb_per_s("crypto_stream_chacha20_ietf_xor", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < AEAD_RUNS; r++) {
+        crypto_onetimeauth_poly1305(tag, msg, AEAD_CHUNK_BYTES, key);
+    }
+    print_mb_per_s("crypto_onetimeauth_poly1305", esp_timer_get_time() - start);
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < AEAD_RUNS; r++) {
+        crypto_aead_chacha20poly1305_ietf_encrypt_detached(out, tag, NULL, msg, AEAD_CHUNK_BYTES, NULL, 0, NULL,
+                                                           nonce, key);
+    }
+    print_mb_per_s("crypto_aead_chacha20poly1305_ietf", esp_timer_get_time() - start);
+
+    crypto_secretstream_xchacha20poly1305_init_push(&st, header, key);
+    start = esp_timer_get_time();
+    for (int r = 0; r < AEAD_RUNS; r++) {
+        crypto_secretstream_xchacha20poly1305_push(&st, out, NULL, msg, AEAD_CHUNK_BYTES, NULL, 0, 0);
+    }
+    print_mb_per_s("crypto_secretstream_xchacha20poly1305", esp_timer_get_time() - start);
+
+    mbedtls_gcm_context gcm;
+    mbedtls_gcm_init(&gcm);
+    TEST_ASSERT_EQUAL(0, mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 256));
+    start = esp_timer_get_time();
+    for (int r = 0; r < AEAD_RUNS; r++) {
+        TEST_ASSERT_EQUAL(0, mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, AEAD_CHUNK_BYTES, nonce, 12, NULL, 0,
+                                                       msg, out, sizeof(tag), tag));
+    }
+    print_mb_per_s("mbedtls AES-256-GCM", esp_timer_get_time() - start);
+    mbedtls_gcm_free(&gcm);
+
+    free(msg);
+    free(out);
+}
@@ -260,6 +260,35 @@ typedef const char network_prov_security1_params_t;
  */
 typedef protocomm_security2_params_t network_prov_security2_params_t;
 
+/**
+ * @brief   Phases of provisioning recorded in the timeline
+ */
+typedef enum {
+    NETWORK_PROV_PHASE_START,               /*!< network_prov_mgr_start_provisioning() called */
+    NETWORK_PROV_PHASE_SERVICE_STARTED,     /*!< Transport and endpoints ready, waiting for a client */
+    NETWORK_PROV_PHASE_CLIENT_CONNECTED,    /*!< Client connected (BLE transport only) */
+    NETWORK_PROV_PHASE_SESSION_ESTABLISHED, /*!< Security handshake completed */
+    NETWORK_PROV_PHASE_SCAN_START,          /*!< Network scan started */
+    NETWORK_PROV_PHASE_SCAN_DONE,           /*!< Network scan finished */
+    NETWORK_PROV_PHASE_CRED_RECV,           /*!< Wi-Fi credentials or Thread dataset received and applied */
+    NETWORK_PROV_PHASE_CONNECTED,           /*!< Wi-Fi station associated with the AP (Wi-Fi only) */
+    NETWORK_PROV_PHASE_SUCCESS,             /*!< Wi-Fi station got IP or Thread attached */
+    NETWORK_PROV_PHASE_FAIL,                /*!< Wi-Fi connection or Thread attaching failed */
+    NETWORK_PROV_PHASE_END,                 /*!< Provisioning service stopped */
+    NETWORK_PROV_PHASE_MAX,
+} network_prov_phase_t;
+
+/**
+ * @brief   Timestamps of the provisioning phases
+ */
+typedef struct {
+    /**
+     * Time, as returned by esp_timer_get_time(), at which each phase was last
+     * entered since network_prov_mgr_start_provisioning(), 0 if never reached
+     */
+    int64_t time_us[NETWORK_PROV_PHASE_MAX];
+} network_prov_timeline_t;
+
 /**
  * @brief   Initialize provisioning manager instance
  *
@@ -569,6 +598,23 @@ esp_err_t network_prov_mgr_endpoint_register(const char *ep_name,
  */
 void network_prov_mgr_endpoint_unregister(const char *ep_name);
 
+/**
+ * @brief   Get the timestamps of the provisioning phases
+ *
+ * The timeline is reset by network_prov_mgr_start_provisioning() and stays
+ * available after provisioning ends, until the manager is de-initialized.
+ * It can also be logged when provisioning ends, see
+ * CONFIG_NETWORK_PROV_TIMELINE_LOG.
+ *
+ * @param[out] timeline  Pointer to network_prov_timeline_t to be filled
+ *
+ * @return
+ *  - ESP_OK                : Success
+ *  - ESP_ERR_INVALID_ARG   : Null argument
+ *  - ESP_ERR_INVALID_STATE : Manager not initialized
+ */
+esp_err_t network_prov_mgr_get_timeline(network_prov_timeline_t *timeline);
+
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
 /**
  * @brief   Get state of Wi-Fi Station during provisioning
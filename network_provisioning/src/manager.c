@@ -26,6 +26,12 @@
 #include <protocomm_security2.h>
 
 #include "network_provisioning_priv.h"
+#ifdef CONFIG_NETWORK_PROV_SESSION_RESUMPTION
+#include "network_prov_resume.h"
+#endif
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+#include "network_prov_batch.h"
+#endif
 
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
 #include <esp_openthread_lock.h>
@@ -33,6 +39,11 @@
 #include <openthread/thread.h>
 #endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
 
+#if defined(CONFIG_BT_ENABLED) && (defined(CONFIG_BT_BLUEDROID_ENABLED) || defined(CONFIG_BT_NIMBLE_ENABLED))
+#include <protocomm_ble.h>
+#define NETWORK_PROV_BLE_TRANSPORT 1
+#endif
+
 #define NETWORK_PROV_MGR_VERSION      "netprov-v1.2"
 #define WIFI_PROV_STORAGE_BIT       BIT0
 #define WIFI_PROV_SETTING_BIT       BIT1
@@ -137,6 +148,9 @@ struct network_prov_mgr_ctx {
     /* Application related information in JSON format */
     cJSON *app_info_json;
 
+    /* Timestamps of the provisioning phases */
+    network_prov_timeline_t timeline;
+
     /* Delay after which resources will be cleaned up asynchronously
      * upon execution of network_prov_mgr_stop_provisioning() */
     uint32_t cleanup_delay;
@@ -155,9 +169,9 @@ struct network_prov_mgr_ctx {
     /* Wi-Fi scan parameters and state variables */
     uint8_t channels_per_group;
     uint16_t curr_channel;
-    uint16_t ap_list_len[14];   // 14 entries corresponding to each channel
-    wifi_ap_record_t *ap_list[14];
-    wifi_ap_record_t *ap_list_sorted[MAX_SCAN_RESULTS];
+    uint16_t ap_list_len;
+    wifi_ap_record_t ap_list[MAX_SCAN_RESULTS];  // Strongest APs of all channels, sorted by RSSI
+    int64_t ap_list_time;                        // Completion time of the scan, 0 if incomplete
     wifi_scan_config_t scan_cfg;
 #endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
 
@@ -185,6 +199,41 @@ static SemaphoreHandle_t prov_ctx_lock = NULL;
 /* Pointer to provisioning context data */
 static struct network_prov_mgr_ctx *prov_ctx;
 
+/* NOTE: This function should be called only after ensuring that the
+ * context is valid and the control mutex is locked. */
+static void timeline_mark(network_prov_phase_t phase)
+{
+    prov_ctx->timeline.time_us[phase] = esp_timer_get_time();
+}
+
+#ifdef CONFIG_NETWORK_PROV_TIMELINE_LOG
+static void timeline_log(void)
+{
+    static const char *phase_names[NETWORK_PROV_PHASE_MAX] = {
+        [NETWORK_PROV_PHASE_START]               = "start",
+        [NETWORK_PROV_PHASE_SERVICE_STARTED]     = "service started",
+        [NETWORK_PROV_PHASE_CLIENT_CONNECTED]    = "client connected",
+        [NETWORK_PROV_PHASE_SESSION_ESTABLISHED] = "session established",
+        [NETWORK_PROV_PHASE_SCAN_START]          = "scan start",
+        [NETWORK_PROV_PHASE_SCAN_DONE]           = "scan done",
+        [NETWORK_PROV_PHASE_CRED_RECV]           = "credentials received",
+        [NETWORK_PROV_PHASE_CONNECTED]           = "connected",
+        [NETWORK_PROV_PHASE_SUCCESS]             = "success",
+        [NETWORK_PROV_PHASE_FAIL]                = "fail",
+        [NETWORK_PROV_PHASE_END]                 = "end",
+    };
+    const int64_t *time_us = prov_ctx->timeline.time_us;
+
+    ESP_LOGI(TAG, "Provisioning timeline (ms since start) :");
+    for (int phase = NETWORK_PROV_PHASE_SERVICE_STARTED; phase < NETWORK_PROV_PHASE_MAX; phase++) {
+        if (time_us[phase]) {
+            ESP_LOGI(TAG, "\t%-20s %8lld", phase_names[phase],
+                     (long long)(time_us[phase] - time_us[NETWORK_PROV_PHASE_START]) / 1000);
+        }
+    }
+}
+#endif // CONFIG_NETWORK_PROV_TIMELINE_LOG
+
 /* This executes registered app_event_callback for a particular event
  *
  * NOTE : By the time this function returns, it is possible that
@@ -202,6 +251,36 @@ static void execute_event_cb(network_prov_cb_event_t event_id, void *event_data,
     ESP_LOGD(TAG, "execute_event_cb : %d", event_id);
 
     if (prov_ctx) {
+        switch (event_id) {
+        case NETWORK_PROV_START:
+            timeline_mark(NETWORK_PROV_PHASE_SERVICE_STARTED);
+            break;
+#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
+        case NETWORK_PROV_WIFI_CRED_RECV:
+            timeline_mark(NETWORK_PROV_PHASE_CRED_RECV);
+            break;
+        case NETWORK_PROV_WIFI_CRED_FAIL:
+            timeline_mark(NETWORK_PROV_PHASE_FAIL);
+            break;
+        case NETWORK_PROV_WIFI_CRED_SUCCESS:
+            timeline_mark(NETWORK_PROV_PHASE_SUCCESS);
+            break;
+#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
+#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
+        case NETWORK_PROV_THREAD_DATASET_RECV:
+            timeline_mark(NETWORK_PROV_PHASE_CRED_RECV);
+            break;
+        case NETWORK_PROV_THREAD_DATASET_FAIL:
+            timeline_mark(NETWORK_PROV_PHASE_FAIL);
+            break;
+        case NETWORK_PROV_THREAD_DATASET_SUCCESS:
+            timeline_mark(NETWORK_PROV_PHASE_SUCCESS);
+            break;
+#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
+        default:
+            break;
+        }
+
         network_prov_cb_func_t app_cb = prov_ctx->mgr_config.app_event_handler.event_cb;
         void *app_data = prov_ctx->mgr_config.app_event_handler.user_data;
 
@@ -313,12 +392,26 @@ static cJSON *network_prov_get_info_json(void)
     cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("wifi_prov"));
     /* Indicate capability for performing Wi-Fi scan */
     cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("wifi_scan"));
+    /* Indicate that scan result requests return as many entries as fit in one response */
+    cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("wifi_scan_page"));
 #endif
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
     /* Indicate capability for performing Thread provision */
     cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("thread_prov"));
     /* Indicate capability for performing Thread scan */
     cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("thread_scan"));
+    /* Indicate that scan result requests return as many entries as fit in one response */
+    cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("thread_scan_page"));
+#endif
+#ifdef CONFIG_NETWORK_PROV_SESSION_RESUMPTION
+    /* Indicate that a session can be resumed with a ticket from the prov-resume endpoint */
+    if (prov_ctx->security == 2) {
+        cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("sec2_resume"));
+    }
+#endif
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+    /* Indicate that requests to several endpoints can be sent at once to prov-batch */
+    cJSON_AddItemToArray(prov_capabilities, cJSON_CreateString("batch"));
 #endif
     return full_info_json;
 }
@@ -327,6 +420,18 @@ static cJSON *network_prov_get_info_json(void)
 static void network_prov_mgr_event_handler_internal(void *arg, esp_event_base_t event_base,
         int32_t event_id, void *event_data);
 
+/* Add an endpoint to protocomm, and make it available in batches */
+static esp_err_t network_prov_add_endpoint(const char *ep_name, protocomm_req_handler_t handler, void *priv_data)
+{
+    esp_err_t ret = protocomm_add_endpoint(prov_ctx->pc, ep_name, handler, priv_data);
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+    if (ret == ESP_OK && network_prov_batch_add(ep_name, handler, priv_data) != ESP_OK) {
+        ESP_LOGW(TAG, "Endpoint %s is not available in batches", ep_name);
+    }
+#endif
+    return ret;
+}
+
 static esp_err_t network_prov_mgr_start_service(const char *service_name, const char *service_key)
 {
     const network_prov_scheme_t *scheme = &prov_ctx->mgr_config.scheme;
@@ -372,7 +477,10 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
         return ESP_ERR_NOT_SUPPORTED;
 #endif
     } else if (prov_ctx->security == 2) {
-#ifdef CONFIG_ESP_PROTOCOMM_SUPPORT_SECURITY_VERSION_2
+#if defined(CONFIG_NETWORK_PROV_SESSION_RESUMPTION)
+        ret = protocomm_set_security(prov_ctx->pc, "prov-session",
+                                     network_prov_resume_security(), prov_ctx->protocomm_sec_params);
+#elif defined(CONFIG_ESP_PROTOCOMM_SUPPORT_SECURITY_VERSION_2)
         ret = protocomm_set_security(prov_ctx->pc, "prov-session",
                                      &protocomm_security2, prov_ctx->protocomm_sec_params);
 #else
@@ -413,9 +521,9 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
     }
 
     /* Add protocomm endpoint for network configuration */
-    ret = protocomm_add_endpoint(prov_ctx->pc, "prov-config",
-                                 network_prov_config_data_handler,
-                                 prov_ctx->network_prov_handlers);
+    ret = network_prov_add_endpoint("prov-config",
+                                    network_prov_config_data_handler,
+                                    prov_ctx->network_prov_handlers);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set provisioning endpoint");
         free(prov_ctx->network_prov_handlers);
@@ -435,9 +543,9 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
     }
 
     /* Add endpoint for scanning networks and sending scan list */
-    ret = protocomm_add_endpoint(prov_ctx->pc, "prov-scan",
-                                 network_prov_scan_handler,
-                                 prov_ctx->network_scan_handlers);
+    ret = network_prov_add_endpoint("prov-scan",
+                                    network_prov_scan_handler,
+                                    prov_ctx->network_scan_handlers);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set network scan endpoint");
         free(prov_ctx->network_scan_handlers);
@@ -458,9 +566,9 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
     }
 
     /* Add endpoint for controlling state of network provisioning */
-    ret = protocomm_add_endpoint(prov_ctx->pc, "prov-ctrl",
-                                 network_ctrl_handler,
-                                 prov_ctx->network_ctrl_handlers);
+    ret = network_prov_add_endpoint("prov-ctrl",
+                                    network_ctrl_handler,
+                                    prov_ctx->network_ctrl_handlers);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set network ctrl endpoint");
         free(prov_ctx->network_ctrl_handlers);
@@ -470,6 +578,23 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
         return ret;
     }
 
+#ifdef CONFIG_NETWORK_PROV_SESSION_RESUMPTION
+    /* Session resumption is optional, clients fall back to the full handshake without it */
+    if (prov_ctx->security == 2) {
+        if (network_prov_resume_service_start() != ESP_OK ||
+                network_prov_add_endpoint("prov-resume", network_prov_resume_ticket_handler, NULL) != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to set session resumption endpoint");
+        }
+    }
+#endif
+
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+    /* Clients check the batch capability and send the requests one by one without it */
+    if (protocomm_add_endpoint(prov_ctx->pc, "prov-batch", network_prov_batch_handler, NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to set batch endpoint");
+    }
+#endif
+
     /* Register global event handler */
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
     ret = esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
@@ -536,6 +661,18 @@ static esp_err_t network_prov_mgr_start_service(const char *service_name, const
         return ret;
     }
 
+    /* Events of the protocomm session and transport only feed the timeline,
+     * failing to register them isn't fatal */
+    if (esp_event_handler_register(PROTOCOMM_SECURITY_SESSION_EVENT, PROTOCOMM_SECURITY_SESSION_SETUP_OK,
+                                   network_prov_mgr_event_handler_internal, NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register protocomm session event handler");
+    }
+#ifdef NETWORK_PROV_BLE_TRANSPORT
+    if (esp_event_handler_register(PROTOCOMM_TRANSPORT_BLE_EVENT, PROTOCOMM_TRANSPORT_BLE_CONNECTED,
+                                   network_prov_mgr_event_handler_internal, NULL) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to register protocomm BLE event handler");
+    }
+#endif
 
     ESP_LOGI(TAG, "Provisioning started with service name : %s ",
              service_name ? service_name : "<NULL>");
@@ -580,7 +717,7 @@ esp_err_t network_prov_mgr_endpoint_register(const char *ep_name, protocomm_req_
     if (prov_ctx &&
             prov_ctx->prov_state > NETWORK_PROV_STATE_STARTING &&
             prov_ctx->prov_state < NETWORK_PROV_STATE_STOPPING) {
-        err = protocomm_add_endpoint(prov_ctx->pc, ep_name, handler, user_ctx);
+        err = network_prov_add_endpoint(ep_name, handler, user_ctx);
     }
     RELEASE_LOCK(prov_ctx_lock);
 
@@ -602,14 +739,46 @@ void network_prov_mgr_endpoint_unregister(const char *ep_name)
             prov_ctx->prov_state > NETWORK_PROV_STATE_STARTING &&
             prov_ctx->prov_state < NETWORK_PROV_STATE_STOPPING) {
         protocomm_remove_endpoint(prov_ctx->pc, ep_name);
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+        network_prov_batch_remove(ep_name);
+#endif
+    }
+    RELEASE_LOCK(prov_ctx_lock);
+}
+
+esp_err_t network_prov_mgr_get_timeline(network_prov_timeline_t *timeline)
+{
+    if (!timeline) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!prov_ctx_lock) {
+        ESP_LOGE(TAG, "Provisioning manager not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ACQUIRE_LOCK(prov_ctx_lock);
+    if (!prov_ctx) {
+        ESP_LOGE(TAG, "Provisioning manager not initialized");
+        RELEASE_LOCK(prov_ctx_lock);
+        return ESP_ERR_INVALID_STATE;
     }
+
+    *timeline = prov_ctx->timeline;
     RELEASE_LOCK(prov_ctx_lock);
+    return ESP_OK;
 }
 
 static void prov_stop_and_notify(bool is_async)
 {
     esp_event_handler_unregister(NETWORK_PROV_MGR_PVT_EVENT, NETWORK_PROV_MGR_STOP,
                                  network_prov_mgr_event_handler_internal);
+    esp_event_handler_unregister(PROTOCOMM_SECURITY_SESSION_EVENT, PROTOCOMM_SECURITY_SESSION_SETUP_OK,
+                                 network_prov_mgr_event_handler_internal);
+#ifdef NETWORK_PROV_BLE_TRANSPORT
+    esp_event_handler_unregister(PROTOCOMM_TRANSPORT_BLE_EVENT, PROTOCOMM_TRANSPORT_BLE_CONNECTED,
+                                 network_prov_mgr_event_handler_internal);
+#endif
 
     if (prov_ctx->cleanup_delay_timer) {
         esp_timer_stop(prov_ctx->cleanup_delay_timer);
@@ -630,6 +799,15 @@ static void prov_stop_and_notify(bool is_async)
         vTaskDelay(cleanup_delay / portTICK_PERIOD_MS);
     }
 
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+    protocomm_remove_endpoint(prov_ctx->pc, "prov-batch");
+    network_prov_batch_clear();
+#endif
+
+#ifdef CONFIG_NETWORK_PROV_SESSION_RESUMPTION
+    protocomm_remove_endpoint(prov_ctx->pc, "prov-resume");
+#endif
+
     protocomm_remove_endpoint(prov_ctx->pc, "prov-ctrl");
 
     protocomm_remove_endpoint(prov_ctx->pc, "prov-scan");
@@ -666,6 +844,10 @@ static void prov_stop_and_notify(bool is_async)
 #endif
 
     ESP_LOGI(TAG, "Provisioning stopped");
+    timeline_mark(NETWORK_PROV_PHASE_END);
+#ifdef CONFIG_NETWORK_PROV_TIMELINE_LOG
+    timeline_log();
+#endif
 
     if (is_async) {
         /* NOTE: While calling this API in an async fashion,
@@ -769,14 +951,9 @@ static bool network_prov_mgr_stop_service(bool blocking)
 
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
     /* Delete all scan results */
-    for (uint16_t channel = 0; channel < 14; channel++) {
-        free(prov_ctx->ap_list[channel]);
-        prov_ctx->ap_list[channel] = NULL;
-    }
     prov_ctx->scanning = false;
-    for (uint8_t i = 0; i < MAX_SCAN_RESULTS; i++) {
-        prov_ctx->ap_list_sorted[i] = NULL;
-    }
+    prov_ctx->ap_list_len = 0;
+    prov_ctx->ap_list_time = 0;
 
     /* Remove event handler */
     esp_event_handler_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID,
@@ -881,6 +1058,28 @@ esp_err_t network_prov_mgr_done(void)
 }
 
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
+/* Insert an AP in the list of the strongest ones, which stays sorted by decreasing RSSI */
+static void insert_wifi_scan_result(const wifi_ap_record_t *ap)
+{
+    uint16_t len = prov_ctx->ap_list_len;
+    if (len == MAX_SCAN_RESULTS) {
+        if (ap->rssi <= prov_ctx->ap_list[len - 1].rssi) {
+            return;
+        }
+        /* Drop the weakest AP */
+        len--;
+    }
+
+    uint16_t pos = len;
+    while (pos > 0 && prov_ctx->ap_list[pos - 1].rssi < ap->rssi) {
+        pos--;
+    }
+    memmove(&prov_ctx->ap_list[pos + 1], &prov_ctx->ap_list[pos],
+            (len - pos) * sizeof(wifi_ap_record_t));
+    prov_ctx->ap_list[pos] = *ap;
+    prov_ctx->ap_list_len = len + 1;
+}
+
 static esp_err_t update_wifi_scan_results(void)
 {
     if (!prov_ctx->scanning) {
@@ -892,12 +1091,6 @@ static esp_err_t update_wifi_scan_results(void)
     uint16_t count = 0;
     uint16_t curr_channel = prov_ctx->curr_channel;
 
-    if (prov_ctx->ap_list[curr_channel]) {
-        free(prov_ctx->ap_list[curr_channel]);
-        prov_ctx->ap_list[curr_channel] = NULL;
-        prov_ctx->ap_list_len[curr_channel] = 0;
-    }
-
     if (esp_wifi_scan_get_ap_num(&count) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to get count of scanned APs");
         goto exit;
@@ -909,58 +1102,26 @@ static esp_err_t update_wifi_scan_results(void)
         goto exit;
     }
 
-    uint16_t get_count = MIN(count, MAX_SCAN_RESULTS);
-    prov_ctx->ap_list[curr_channel] = (wifi_ap_record_t *) calloc(get_count, sizeof(wifi_ap_record_t));
-    if (!prov_ctx->ap_list[curr_channel]) {
-        ESP_LOGE(TAG, "Failed to allocate memory for AP list");
-        esp_wifi_clear_ap_list();
-        goto exit;
-    }
-    if (esp_wifi_scan_get_ap_records(&get_count, prov_ctx->ap_list[curr_channel]) != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to get scanned AP records");
-        goto exit;
-    }
-    prov_ctx->ap_list_len[curr_channel] = get_count;
-
     if (prov_ctx->channels_per_group) {
         ESP_LOGD(TAG, "Scan results for channel %d :", curr_channel);
     } else {
         ESP_LOGD(TAG, "Scan results :");
     }
     ESP_LOGD(TAG, "\tS.N. %-32s %-12s %s %s", "SSID", "BSSID", "RSSI", "AUTH");
-    for (uint8_t i = 0; i < prov_ctx->ap_list_len[curr_channel]; i++) {
-        ESP_LOGD(TAG, "\t[%2d] %-32s %02x%02x%02x%02x%02x%02x %4d %4d", i,
-                 prov_ctx->ap_list[curr_channel][i].ssid,
-                 prov_ctx->ap_list[curr_channel][i].bssid[0],
-                 prov_ctx->ap_list[curr_channel][i].bssid[1],
-                 prov_ctx->ap_list[curr_channel][i].bssid[2],
-                 prov_ctx->ap_list[curr_channel][i].bssid[3],
-                 prov_ctx->ap_list[curr_channel][i].bssid[4],
-                 prov_ctx->ap_list[curr_channel][i].bssid[5],
-                 prov_ctx->ap_list[curr_channel][i].rssi,
-                 prov_ctx->ap_list[curr_channel][i].authmode);
-    }
-
-    /* Store results in sorted list */
-    {
-        int rc = get_count;
-        int is = MAX_SCAN_RESULTS - rc - 1;
-        while (rc > 0 && is >= 0) {
-            if (prov_ctx->ap_list_sorted[is]) {
-                if (prov_ctx->ap_list_sorted[is]->rssi > prov_ctx->ap_list[curr_channel][rc - 1].rssi) {
-                    prov_ctx->ap_list_sorted[is + rc] = &prov_ctx->ap_list[curr_channel][rc - 1];
-                    rc--;
-                    continue;
-                }
-                prov_ctx->ap_list_sorted[is + rc] = prov_ctx->ap_list_sorted[is];
-            }
-            is--;
-        }
-        while (rc > 0) {
-            prov_ctx->ap_list_sorted[rc - 1] = &prov_ctx->ap_list[curr_channel][rc - 1];
-            rc--;
+
+    /* Fetch the records one at a time, straight into the sorted list, so that
+     * dense environments don't need a buffer for all the APs of the channel */
+    wifi_ap_record_t ap;
+    for (uint16_t i = 0; i < count; i++) {
+        if (esp_wifi_scan_get_ap_record(&ap) != ESP_OK) {
+            break;
         }
+        ESP_LOGD(TAG, "\t[%2d] %-32s %02x%02x%02x%02x%02x%02x %4d %4d", i,
+                 ap.ssid, ap.bssid[0], ap.bssid[1], ap.bssid[2],
+                 ap.bssid[3], ap.bssid[4], ap.bssid[5], ap.rssi, ap.authmode);
+        insert_wifi_scan_result(&ap);
     }
+    esp_wifi_clear_ap_list();
 
     ret = ESP_OK;
 exit:
@@ -993,35 +1154,22 @@ exit:
     ESP_LOGD(TAG, "Scan started");
 
 final:
-
+    if (!prov_ctx->scanning) {
+        timeline_mark(NETWORK_PROV_PHASE_SCAN_DONE);
+        if (ret == ESP_OK) {
+            prov_ctx->ap_list_time = esp_timer_get_time();
+        }
+    }
     return ret;
 }
 
-esp_err_t network_prov_mgr_wifi_scan_start(bool blocking, bool passive,
-        uint8_t group_channels, uint32_t period_ms)
+/* NOTE: This function should be called only after ensuring that the
+ * context is valid and the control mutex is locked. */
+static esp_err_t wifi_scan_start_locked(bool passive, uint8_t group_channels, uint32_t period_ms)
 {
-    if (!prov_ctx_lock) {
-        ESP_LOGE(TAG, "Provisioning manager not initialized");
-        return ESP_ERR_INVALID_STATE;
-    }
-    ACQUIRE_LOCK(prov_ctx_lock);
-
-    if (!prov_ctx) {
-        ESP_LOGE(TAG, "Provisioning manager not initialized");
-        RELEASE_LOCK(prov_ctx_lock);
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    if (prov_ctx->scanning) {
-        ESP_LOGD(TAG, "Scan already running");
-        RELEASE_LOCK(prov_ctx_lock);
-        return ESP_OK;
-    }
-
     /* Clear sorted list for new entries */
-    for (uint8_t i = 0; i < MAX_SCAN_RESULTS; i++) {
-        prov_ctx->ap_list_sorted[i] = NULL;
-    }
+    prov_ctx->ap_list_len = 0;
+    prov_ctx->ap_list_time = 0;
 
     if (passive) {
         prov_ctx->scan_cfg.scan_type = WIFI_SCAN_TYPE_PASSIVE;
@@ -1049,13 +1197,42 @@ esp_err_t network_prov_mgr_wifi_scan_start(bool blocking, bool passive,
 
     if (esp_wifi_scan_start(&prov_ctx->scan_cfg, false) != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start scan");
-        RELEASE_LOCK(prov_ctx_lock);
         return ESP_FAIL;
     }
 
     ESP_LOGD(TAG, "Scan started");
     prov_ctx->scanning = true;
     prov_ctx->curr_channel = prov_ctx->scan_cfg.channel;
+    timeline_mark(NETWORK_PROV_PHASE_SCAN_START);
+    return ESP_OK;
+}
+
+esp_err_t network_prov_mgr_wifi_scan_start(bool blocking, bool passive,
+        uint8_t group_channels, uint32_t period_ms)
+{
+    if (!prov_ctx_lock) {
+        ESP_LOGE(TAG, "Provisioning manager not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    ACQUIRE_LOCK(prov_ctx_lock);
+
+    if (!prov_ctx) {
+        ESP_LOGE(TAG, "Provisioning manager not initialized");
+        RELEASE_LOCK(prov_ctx_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (prov_ctx->scanning) {
+        /* This may be the scan started along with provisioning,
+         * in which case blocking callers wait for its results */
+        ESP_LOGD(TAG, "Scan already running");
+    } else if (prov_ctx->ap_list_time &&
+               esp_timer_get_time() - prov_ctx->ap_list_time < CONFIG_NETWORK_PROV_WIFI_SCAN_CACHE_TIMEOUT * 1000LL) {
+        ESP_LOGD(TAG, "Reusing the results of the previous scan");
+    } else if (wifi_scan_start_locked(passive, group_channels, period_ms) != ESP_OK) {
+        RELEASE_LOCK(prov_ctx_lock);
+        return ESP_FAIL;
+    }
     RELEASE_LOCK(prov_ctx_lock);
 
     /* If scan is to be non-blocking, return immediately */
@@ -1111,12 +1288,7 @@ uint16_t network_prov_mgr_wifi_scan_result_count(void)
         return rval;
     }
 
-    while (rval < MAX_SCAN_RESULTS) {
-        if (!prov_ctx->ap_list_sorted[rval]) {
-            break;
-        }
-        rval++;
-    }
+    rval = prov_ctx->ap_list_len;
     RELEASE_LOCK(prov_ctx_lock);
     return rval;
 }
@@ -1136,8 +1308,8 @@ const wifi_ap_record_t *network_prov_mgr_wifi_scan_result(uint16_t index)
         return rval;
     }
 
-    if (index < MAX_SCAN_RESULTS) {
-        rval = prov_ctx->ap_list_sorted[index];
+    if (index < prov_ctx->ap_list_len) {
+        rval = &prov_ctx->ap_list[index];
     }
     RELEASE_LOCK(prov_ctx_lock);
     return rval;
@@ -1418,6 +1590,7 @@ static void update_thread_scan_result(otActiveScanResult *result, void *context)
 
     if (!result) {
         prov_ctx->scanning = false;
+        timeline_mark(NETWORK_PROV_PHASE_SCAN_DONE);
         ESP_LOGD(TAG, "Scan finished");
         RELEASE_LOCK(prov_ctx_lock);
         return;
@@ -1489,6 +1662,7 @@ esp_err_t network_prov_mgr_thread_scan_start(bool blocking, uint32_t channel_mas
 
     ESP_LOGI(TAG, "Scan started");
     prov_ctx->scanning = true;
+    timeline_mark(NETWORK_PROV_PHASE_SCAN_START);
     RELEASE_LOCK(prov_ctx_lock);
 
     /* If scan is to be non-blocking, return immediately */
@@ -1719,6 +1893,15 @@ static void network_prov_mgr_event_handler_internal(
         RELEASE_LOCK(prov_ctx_lock);
         return;
     }
+
+    if (event_base == PROTOCOMM_SECURITY_SESSION_EVENT && event_id == PROTOCOMM_SECURITY_SESSION_SETUP_OK) {
+        timeline_mark(NETWORK_PROV_PHASE_SESSION_ESTABLISHED);
+    }
+#ifdef NETWORK_PROV_BLE_TRANSPORT
+    if (event_base == PROTOCOMM_TRANSPORT_BLE_EVENT && event_id == PROTOCOMM_TRANSPORT_BLE_CONNECTED) {
+        timeline_mark(NETWORK_PROV_PHASE_CLIENT_CONNECTED);
+    }
+#endif
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
     /* If scan completed then update scan result */
     if (prov_ctx->prov_state == NETWORK_PROV_STATE_STARTED &&
@@ -1741,6 +1924,8 @@ static void network_prov_mgr_event_handler_internal(
          * wait for connection to establish with configured
          * host SSID and password */
         prov_ctx->wifi_state = NETWORK_PROV_WIFI_STA_CONNECTING;
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        timeline_mark(NETWORK_PROV_PHASE_CONNECTED);
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ESP_LOGI(TAG, "STA Got IP");
         /* Station got IP. That means configuration is successful. */
@@ -1889,6 +2074,24 @@ esp_err_t network_prov_mgr_init(network_prov_mgr_config_t config)
         goto exit;
     }
 
+#ifdef CONFIG_NETWORK_PROV_BATCH_ENDPOINT
+    /* Below the built-in endpoints, so that the custom endpoints keep their UUIDs */
+    ret = scheme->set_config_endpoint(prov_ctx->prov_scheme_config, "prov-batch", 0xFF4D);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to configure batch endpoint");
+        goto exit;
+    }
+#endif
+
+#ifdef CONFIG_NETWORK_PROV_SESSION_RESUMPTION
+    /* Below the built-in endpoints, so that the custom endpoints keep their UUIDs */
+    ret = scheme->set_config_endpoint(prov_ctx->prov_scheme_config, "prov-resume", 0xFF4E);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "failed to configure session resumption endpoint");
+        goto exit;
+    }
+#endif
+
     ret = scheme->set_config_endpoint(prov_ctx->prov_scheme_config, "prov-ctrl", 0xFF4F);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "failed to configure Network state control endpoint");
@@ -2065,6 +2268,8 @@ esp_err_t network_prov_mgr_start_provisioning(network_prov_security_t security,
      * or network_prov_mgr_stop_provisioning() or network_prov_mgr_deinit() from another
      * thread doesn't interfere with this process */
     prov_ctx->prov_state = NETWORK_PROV_STATE_STARTING;
+    memset(&prov_ctx->timeline, 0, sizeof(prov_ctx->timeline));
+    timeline_mark(NETWORK_PROV_PHASE_START);
 #ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
     uint8_t restore_wifi_flag = 0;
     /* Start Wi-Fi in Station Mode.
@@ -2237,6 +2442,16 @@ esp_err_t network_prov_mgr_start_provisioning(network_prov_security_t security,
     ACQUIRE_LOCK(prov_ctx_lock);
     if (ret == ESP_OK) {
         prov_ctx->prov_state = NETWORK_PROV_STATE_STARTED;
+#ifdef CONFIG_NETWORK_PROV_WIFI_SCAN_ON_START
+        /* Scan while the client connects and sets up the session, so that its
+         * scan request can be answered right away. With the softAP running,
+         * the channels are scanned by groups to keep sending beacons */
+        wifi_mode_t mode = WIFI_MODE_STA;
+        esp_wifi_get_mode(&mode);
+        if (wifi_scan_start_locked(false, mode == WIFI_MODE_APSTA ? 5 : 0, 120) != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to start scan on provisioning start");
+        }
+#endif
         /* Execute user registered callback handler */
         execute_event_cb(NETWORK_PROV_START, NULL, 0);
         goto exit;
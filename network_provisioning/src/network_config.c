@@ -11,6 +11,7 @@
 
 #include "network_constants.pb-c.h"
 #include "network_config.pb-c.h"
+#include "network_prov_arena.h"
 
 #include <network_provisioning/network_config.h>
 
@@ -18,18 +19,18 @@ static const char *TAG = "NetworkProvConfig";
 
 typedef struct network_prov_config_cmd {
     int cmd_num;
-    esp_err_t (*command_handler)(NetworkConfigPayload *req,
-                                 NetworkConfigPayload *resp, void *priv_data);
+    esp_err_t (*command_handler)(NetworkConfigPayload *req, NetworkConfigPayload *resp,
+                                 network_prov_arena_t *arena, void *priv_data);
 } network_prov_config_cmd_t;
 
 static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
-                                        NetworkConfigPayload *resp, void *priv_data);
+                                        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data);
 
 static esp_err_t cmd_set_config_handler(NetworkConfigPayload *req,
-                                        NetworkConfigPayload *resp, void *priv_data);
+                                        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data);
 
 static esp_err_t cmd_apply_config_handler(NetworkConfigPayload *req,
-        NetworkConfigPayload *resp, void *priv_data);
+        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data);
 
 static network_prov_config_cmd_t cmd_table[] = {
     {
@@ -59,7 +60,7 @@ static network_prov_config_cmd_t cmd_table[] = {
 };
 
 static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
-                                        NetworkConfigPayload *resp, void *priv_data)
+                                        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     ESP_LOGD(TAG, "Enter cmd_get_status_handler");
     network_prov_config_handlers_t *h = (network_prov_config_handlers_t *) priv_data;
@@ -69,7 +70,7 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
     }
 
     if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdGetWifiStatus) {
-        RespGetWifiStatus *resp_payload = (RespGetWifiStatus *) malloc(sizeof(RespGetWifiStatus));
+        RespGetWifiStatus *resp_payload = network_prov_arena_alloc(arena, sizeof(RespGetWifiStatus));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -85,40 +86,31 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
                 } else if (resp_data.wifi_state == NETWORK_PROV_WIFI_STA_CONNECTED) {
                     resp_payload->wifi_sta_state  = WIFI_STATION_STATE__Connected;
                     resp_payload->state_case = RESP_GET_WIFI_STATUS__STATE_WIFI_CONNECTED;
-                    WifiConnectedState *connected = (WifiConnectedState *)(
-                                                        malloc(sizeof(WifiConnectedState)));
+                    WifiConnectedState *connected = network_prov_arena_alloc(arena, sizeof(WifiConnectedState));
                     if (!connected) {
-                        free(resp_payload);
                         ESP_LOGE(TAG, "Error allocating memory");
                         return ESP_ERR_NO_MEM;
                     }
                     resp_payload->wifi_connected  = connected;
                     wifi_connected_state__init(connected);
 
-                    connected->ip4_addr = strdup(resp_data.conn_info.ip_addr);
+                    connected->ip4_addr = network_prov_arena_strndup(arena, resp_data.conn_info.ip_addr,
+                                          sizeof(resp_data.conn_info.ip_addr));
                     if (connected->ip4_addr == NULL) {
-                        free(connected);
-                        free(resp_payload);
                         return ESP_ERR_NO_MEM;
                     }
 
                     connected->bssid.len  = sizeof(resp_data.conn_info.bssid);
-                    connected->bssid.data = (uint8_t *) strndup(resp_data.conn_info.bssid,
+                    connected->bssid.data = network_prov_arena_memdup(arena, resp_data.conn_info.bssid,
                                             sizeof(resp_data.conn_info.bssid));
                     if (connected->bssid.data == NULL) {
-                        free(connected->ip4_addr);
-                        free(connected);
-                        free(resp_payload);
                         return ESP_ERR_NO_MEM;
                     }
 
-                    connected->ssid.len   = strlen(resp_data.conn_info.ssid);
-                    connected->ssid.data  = (uint8_t *) strdup(resp_data.conn_info.ssid);
+                    connected->ssid.len   = strnlen(resp_data.conn_info.ssid, sizeof(resp_data.conn_info.ssid));
+                    connected->ssid.data  = (uint8_t *) network_prov_arena_strndup(arena, resp_data.conn_info.ssid,
+                                            sizeof(resp_data.conn_info.ssid));
                     if (connected->ssid.data == NULL) {
-                        free(connected->bssid.data);
-                        free(connected->ip4_addr);
-                        free(connected);
-                        free(resp_payload);
                         return ESP_ERR_NO_MEM;
                     }
 
@@ -147,7 +139,7 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
         resp->payload_case = NETWORK_CONFIG_PAYLOAD__PAYLOAD_RESP_GET_WIFI_STATUS;
         resp->resp_get_wifi_status = resp_payload;
     } else if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdGetThreadStatus) {
-        RespGetThreadStatus *resp_payload = (RespGetThreadStatus *) malloc(sizeof(RespGetThreadStatus));
+        RespGetThreadStatus *resp_payload = network_prov_arena_alloc(arena, sizeof(RespGetThreadStatus));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -163,9 +155,8 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
                 } else if (resp_data.thread_state == NETWORK_PROV_THREAD_ATTACHED) {
                     resp_payload->thread_state  = THREAD_NETWORK_STATE__Attached;
                     resp_payload->state_case = RESP_GET_THREAD_STATUS__STATE_THREAD_ATTACHED;
-                    ThreadAttachState *attached = (ThreadAttachState *)malloc(sizeof(ThreadAttachState));
+                    ThreadAttachState *attached = network_prov_arena_alloc(arena, sizeof(ThreadAttachState));
                     if (!attached) {
-                        free(resp_payload);
                         ESP_LOGE(TAG, "Error allocating memory");
                         return ESP_ERR_NO_MEM;
                     }
@@ -173,23 +164,18 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
                     thread_attach_state__init(attached);
                     attached->channel = resp_data.conn_info.channel;
                     attached->ext_pan_id.len = sizeof(resp_data.conn_info.ext_pan_id);
-                    attached->ext_pan_id.data = (uint8_t *)malloc(attached->ext_pan_id.len);
+                    attached->ext_pan_id.data = network_prov_arena_memdup(arena, resp_data.conn_info.ext_pan_id,
+                                                sizeof(resp_data.conn_info.ext_pan_id));
                     if (!attached->ext_pan_id.data) {
-                        free(attached);
-                        free(resp_payload);
                         return ESP_ERR_NO_MEM;
                     }
-                    memcpy(attached->ext_pan_id.data, resp_data.conn_info.ext_pan_id, sizeof(resp_data.conn_info.ext_pan_id));
                     attached->pan_id = resp_data.conn_info.pan_id;
 
-                    attached->name = (char *)malloc(sizeof(resp_data.conn_info.name));
+                    attached->name = network_prov_arena_memdup(arena, resp_data.conn_info.name,
+                                                               sizeof(resp_data.conn_info.name));
                     if (!attached->name) {
-                        free(attached->ext_pan_id.data);
-                        free(attached);
-                        free(resp_payload);
                         return ESP_ERR_NO_MEM;
                     }
-                    memcpy(attached->name, resp_data.conn_info.name, sizeof(resp_data.conn_info.name));
                 } else if (resp_data.thread_state == NETWORK_PROV_THREAD_DETACHED) {
                     resp_payload->thread_state = THREAD_NETWORK_STATE__AttachingFailed;
                     resp_payload->state_case = RESP_GET_THREAD_STATUS__STATE_THREAD_FAIL_REASON;
@@ -217,7 +203,7 @@ static esp_err_t cmd_get_status_handler(NetworkConfigPayload *req,
 }
 
 static esp_err_t cmd_set_config_handler(NetworkConfigPayload *req,
-                                        NetworkConfigPayload *resp, void  *priv_data)
+                                        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     ESP_LOGD(TAG, "Enter cmd_set_config_handler");
     network_prov_config_handlers_t *h = (network_prov_config_handlers_t *) priv_data;
@@ -227,7 +213,7 @@ static esp_err_t cmd_set_config_handler(NetworkConfigPayload *req,
     }
 
     if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdSetWifiConfig) {
-        RespSetWifiConfig *resp_payload = (RespSetWifiConfig *) malloc(sizeof(RespSetWifiConfig));
+        RespSetWifiConfig *resp_payload = network_prov_arena_alloc(arena, sizeof(RespSetWifiConfig));
         if (resp_payload == NULL) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -273,7 +259,7 @@ static esp_err_t cmd_set_config_handler(NetworkConfigPayload *req,
         resp->payload_case = NETWORK_CONFIG_PAYLOAD__PAYLOAD_RESP_SET_WIFI_CONFIG;
         resp->resp_set_wifi_config = resp_payload;
     } else if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdSetThreadConfig) {
-        RespSetThreadConfig *resp_payload = (RespSetThreadConfig *) malloc(sizeof(RespSetThreadConfig));
+        RespSetThreadConfig *resp_payload = network_prov_arena_alloc(arena, sizeof(RespSetThreadConfig));
         if (resp_payload == NULL) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -304,7 +290,7 @@ static esp_err_t cmd_set_config_handler(NetworkConfigPayload *req,
 }
 
 static esp_err_t cmd_apply_config_handler(NetworkConfigPayload *req,
-        NetworkConfigPayload *resp, void  *priv_data)
+        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     ESP_LOGD(TAG, "Enter cmd_apply_config_handler");
     network_prov_config_handlers_t *h = (network_prov_config_handlers_t *) priv_data;
@@ -313,7 +299,7 @@ static esp_err_t cmd_apply_config_handler(NetworkConfigPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdApplyWifiConfig) {
-        RespApplyWifiConfig *resp_payload = (RespApplyWifiConfig *) malloc(sizeof(RespApplyWifiConfig));
+        RespApplyWifiConfig *resp_payload = network_prov_arena_alloc(arena, sizeof(RespApplyWifiConfig));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -331,7 +317,7 @@ static esp_err_t cmd_apply_config_handler(NetworkConfigPayload *req,
         resp->payload_case = NETWORK_CONFIG_PAYLOAD__PAYLOAD_RESP_APPLY_WIFI_CONFIG;
         resp->resp_apply_wifi_config = resp_payload;
     } else if (req->msg == NETWORK_CONFIG_MSG_TYPE__TypeCmdApplyThreadConfig) {
-        RespApplyThreadConfig *resp_payload = (RespApplyThreadConfig *) malloc(sizeof(RespApplyThreadConfig));
+        RespApplyThreadConfig *resp_payload = network_prov_arena_alloc(arena, sizeof(RespApplyThreadConfig));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -362,88 +348,8 @@ static int lookup_cmd_handler(int cmd_id)
 
     return -1;
 }
-static void network_prov_config_command_cleanup(NetworkConfigPayload *resp, void *priv_data)
-{
-    if (!resp) {
-        return;
-    }
-
-    switch (resp->msg) {
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespGetWifiStatus: {
-#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
-        switch (resp->resp_get_wifi_status->wifi_sta_state) {
-        case WIFI_STATION_STATE__Connecting:
-            break;
-        case WIFI_STATION_STATE__Connected:
-            if (resp->resp_get_wifi_status->wifi_connected) {
-                if (resp->resp_get_wifi_status->wifi_connected->ip4_addr) {
-                    free(resp->resp_get_wifi_status->wifi_connected->ip4_addr);
-                }
-                if (resp->resp_get_wifi_status->wifi_connected->bssid.data) {
-                    free(resp->resp_get_wifi_status->wifi_connected->bssid.data);
-                }
-                if (resp->resp_get_wifi_status->wifi_connected->ssid.data) {
-                    free(resp->resp_get_wifi_status->wifi_connected->ssid.data);
-                }
-                free(resp->resp_get_wifi_status->wifi_connected);
-            }
-            break;
-        case WIFI_STATION_STATE__ConnectionFailed:
-            break;
-        default:
-            break;
-        }
-#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
-        free(resp->resp_get_wifi_status);
-    }
-    break;
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespGetThreadStatus: {
-#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
-        switch (resp->resp_get_thread_status->thread_state) {
-        case THREAD_NETWORK_STATE__Attaching:
-            break;
-        case THREAD_NETWORK_STATE__Attached:
-            if (resp->resp_get_thread_status->thread_attached) {
-                if (resp->resp_get_thread_status->thread_attached->name) {
-                    free(resp->resp_get_thread_status->thread_attached->name);
-                }
-                free(resp->resp_get_thread_status->thread_attached);
-            }
-            break;
-        case THREAD_NETWORK_STATE__AttachingFailed:
-            break;
-        default:
-            break;
-        }
-#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
-        free(resp->resp_get_thread_status);
-    }
-    break;
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespSetWifiConfig: {
-        free(resp->resp_set_wifi_config);
-    }
-    break;
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespSetThreadConfig: {
-        free(resp->resp_set_thread_config);
-    }
-    break;
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespApplyWifiConfig: {
-        free(resp->resp_apply_wifi_config);
-    }
-    break;
-    case NETWORK_CONFIG_MSG_TYPE__TypeRespApplyThreadConfig: {
-        free(resp->resp_apply_thread_config);
-    }
-    break;
-    default:
-        ESP_LOGE(TAG, "Unsupported response type in cleanup_handler");
-        break;
-    }
-    return;
-}
-
 static esp_err_t network_prov_config_command_dispatcher(NetworkConfigPayload *req,
-        NetworkConfigPayload *resp, void *priv_data)
+        NetworkConfigPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     esp_err_t ret;
 
@@ -455,7 +361,7 @@ static esp_err_t network_prov_config_command_dispatcher(NetworkConfigPayload *re
         return ESP_FAIL;
     }
 
-    ret = cmd_table[cmd_index].command_handler(req, resp, priv_data);
+    ret = cmd_table[cmd_index].command_handler(req, resp, arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Error executing command handler");
         return ESP_FAIL;
@@ -469,37 +375,44 @@ esp_err_t network_prov_config_data_handler(uint32_t session_id, const uint8_t *i
 {
     NetworkConfigPayload *req;
     NetworkConfigPayload resp;
-    esp_err_t ret;
+    network_prov_arena_t arena;
+    esp_err_t ret = ESP_OK;
 
-    req = network_config_payload__unpack(NULL, inlen, inbuf);
+    /* The request and the response are allocated from the arena, and freed together */
+    network_prov_arena_init(&arena);
+    req = network_config_payload__unpack(&arena.allocator, inlen, inbuf);
     if (!req) {
         ESP_LOGE(TAG, "Unable to unpack config data");
+        network_prov_arena_free(&arena);
         return ESP_ERR_INVALID_ARG;
     }
 
     network_config_payload__init(&resp);
-    ret = network_prov_config_command_dispatcher(req, &resp, priv_data);
+    ret = network_prov_config_command_dispatcher(req, &resp, &arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Proto command dispatcher error %d", ret);
-        return ESP_FAIL;
+        ret = ESP_FAIL;
+        goto exit;
     }
 
     resp.msg = req->msg + 1; /* Response is request + 1 */
-    network_config_payload__free_unpacked(req, NULL);
 
     *outlen = network_config_payload__get_packed_size(&resp);
     if (*outlen <= 0) {
         ESP_LOGE(TAG, "Invalid encoding for response");
-        return ESP_FAIL;
+        ret = ESP_FAIL;
+        goto exit;
     }
 
     *outbuf = (uint8_t *) malloc(*outlen);
     if (!*outbuf) {
         ESP_LOGE(TAG, "System out of memory");
-        return ESP_ERR_NO_MEM;
+        ret = ESP_ERR_NO_MEM;
+        goto exit;
     }
     network_config_payload__pack(&resp, *outbuf);
-    network_prov_config_command_cleanup(&resp, priv_data);
 
-    return ESP_OK;
+exit:
+    network_prov_arena_free(&arena);
+    return ret;
 }
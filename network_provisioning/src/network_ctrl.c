@@ -10,6 +10,7 @@
 #include <esp_err.h>
 
 #include "network_ctrl.pb-c.h"
+#include "network_prov_arena.h"
 
 #include "network_ctrl.h"
 
@@ -17,16 +18,18 @@ static const char *TAG = "proto_network_ctrl";
 
 typedef struct network_ctrl_cmd {
     int cmd_id;
-    esp_err_t (*command_handler)(NetworkCtrlPayload *req,
-                                 NetworkCtrlPayload *resp, void *priv_data);
+    esp_err_t (*command_handler)(NetworkCtrlPayload *req, NetworkCtrlPayload *resp,
+                                 network_prov_arena_t *arena, void *priv_data);
 } network_ctrl_cmd_t;
 
 static esp_err_t cmd_ctrl_reset_handler(NetworkCtrlPayload *req,
                                         NetworkCtrlPayload *resp,
+                                        network_prov_arena_t *arena,
                                         void *priv_data);
 
 static esp_err_t cmd_ctrl_reprov_handler(NetworkCtrlPayload *req,
         NetworkCtrlPayload *resp,
+        network_prov_arena_t *arena,
         void *priv_data);
 
 static network_ctrl_cmd_t cmd_table[] = {
@@ -49,7 +52,7 @@ static network_ctrl_cmd_t cmd_table[] = {
 };
 
 static esp_err_t cmd_ctrl_reset_handler(NetworkCtrlPayload *req,
-                                        NetworkCtrlPayload *resp, void *priv_data)
+                                        NetworkCtrlPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     network_ctrl_handlers_t *h = (network_ctrl_handlers_t *) priv_data;
     if (!h) {
@@ -57,7 +60,7 @@ static esp_err_t cmd_ctrl_reset_handler(NetworkCtrlPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_CTRL_MSG_TYPE__TypeCmdCtrlWifiReset) {
-        RespCtrlWifiReset *resp_payload = (RespCtrlWifiReset *) malloc(sizeof(RespCtrlWifiReset));
+        RespCtrlWifiReset *resp_payload = network_prov_arena_alloc(arena, sizeof(RespCtrlWifiReset));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -75,7 +78,7 @@ static esp_err_t cmd_ctrl_reset_handler(NetworkCtrlPayload *req,
         resp->payload_case = NETWORK_CTRL_PAYLOAD__PAYLOAD_RESP_CTRL_WIFI_RESET;
         resp->resp_ctrl_wifi_reset = resp_payload;
     } else if (req->msg == NETWORK_CTRL_MSG_TYPE__TypeCmdCtrlThreadReset) {
-        RespCtrlThreadReset *resp_payload = (RespCtrlThreadReset *) malloc(sizeof(RespCtrlThreadReset));
+        RespCtrlThreadReset *resp_payload = network_prov_arena_alloc(arena, sizeof(RespCtrlThreadReset));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -97,7 +100,7 @@ static esp_err_t cmd_ctrl_reset_handler(NetworkCtrlPayload *req,
 }
 
 static esp_err_t cmd_ctrl_reprov_handler(NetworkCtrlPayload *req,
-        NetworkCtrlPayload *resp, void *priv_data)
+        NetworkCtrlPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     network_ctrl_handlers_t *h = (network_ctrl_handlers_t *) priv_data;
     if (!h) {
@@ -105,7 +108,7 @@ static esp_err_t cmd_ctrl_reprov_handler(NetworkCtrlPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_CTRL_MSG_TYPE__TypeCmdCtrlWifiReprov) {
-        RespCtrlWifiReprov *resp_payload = (RespCtrlWifiReprov *) malloc(sizeof(RespCtrlWifiReprov));
+        RespCtrlWifiReprov *resp_payload = network_prov_arena_alloc(arena, sizeof(RespCtrlWifiReprov));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -123,7 +126,7 @@ static esp_err_t cmd_ctrl_reprov_handler(NetworkCtrlPayload *req,
         resp->payload_case = NETWORK_CTRL_PAYLOAD__PAYLOAD_RESP_CTRL_WIFI_REPROV;
         resp->resp_ctrl_wifi_reprov = resp_payload;
     } else if (req->msg == NETWORK_CTRL_MSG_TYPE__TypeCmdCtrlThreadReprov) {
-        RespCtrlThreadReprov *resp_payload = (RespCtrlThreadReprov *) malloc(sizeof(RespCtrlThreadReprov));
+        RespCtrlThreadReprov *resp_payload = network_prov_arena_alloc(arena, sizeof(RespCtrlThreadReprov));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -155,34 +158,8 @@ static int lookup_cmd_handler(int cmd_id)
     return -1;
 }
 
-static void network_ctrl_cmd_cleanup(NetworkCtrlPayload *resp, void *priv_data)
-{
-    switch (resp->msg) {
-    case NETWORK_CTRL_MSG_TYPE__TypeRespCtrlWifiReset: {
-        free(resp->resp_ctrl_wifi_reset);
-    }
-    break;
-    case NETWORK_CTRL_MSG_TYPE__TypeRespCtrlWifiReprov: {
-        free(resp->resp_ctrl_wifi_reprov);
-    }
-    break;
-    case NETWORK_CTRL_MSG_TYPE__TypeRespCtrlThreadReset: {
-        free(resp->resp_ctrl_thread_reset);
-    }
-    break;
-    case NETWORK_CTRL_MSG_TYPE__TypeRespCtrlThreadReprov: {
-        free(resp->resp_ctrl_thread_reprov);
-    }
-    break;
-    default:
-        ESP_LOGE(TAG, "Unsupported response type in cleanup_handler");
-        break;
-    }
-    return;
-}
-
 static esp_err_t network_ctrl_cmd_dispatcher(NetworkCtrlPayload *req,
-        NetworkCtrlPayload *resp, void *priv_data)
+        NetworkCtrlPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     esp_err_t ret;
 
@@ -194,7 +171,7 @@ static esp_err_t network_ctrl_cmd_dispatcher(NetworkCtrlPayload *req,
         return ESP_FAIL;
     }
 
-    ret = cmd_table[cmd_index].command_handler(req, resp, priv_data);
+    ret = cmd_table[cmd_index].command_handler(req, resp, arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Error executing command handler");
     }
@@ -207,16 +184,20 @@ esp_err_t network_ctrl_handler(uint32_t session_id, const uint8_t *inbuf, ssize_
 {
     NetworkCtrlPayload *req;
     NetworkCtrlPayload resp;
+    network_prov_arena_t arena;
     esp_err_t ret = ESP_OK;
 
-    req = network_ctrl_payload__unpack(NULL, inlen, inbuf);
+    /* The request and the response are allocated from the arena, and freed together */
+    network_prov_arena_init(&arena);
+    req = network_ctrl_payload__unpack(&arena.allocator, inlen, inbuf);
     if (!req) {
         ESP_LOGE(TAG, "Unable to unpack ctrl message");
+        network_prov_arena_free(&arena);
         return ESP_ERR_INVALID_ARG;
     }
 
     network_ctrl_payload__init(&resp);
-    ret = network_ctrl_cmd_dispatcher(req, &resp, priv_data);
+    ret = network_ctrl_cmd_dispatcher(req, &resp, &arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Command dispatcher error %02X", ret);
         ret = ESP_FAIL;
@@ -241,7 +222,6 @@ esp_err_t network_ctrl_handler(uint32_t session_id, const uint8_t *inbuf, ssize_
     ESP_LOGD(TAG, "Response packet size : %d", *outlen);
 exit:
 
-    network_ctrl_payload__free_unpacked(req, NULL);
-    network_ctrl_cmd_cleanup(&resp, priv_data);
+    network_prov_arena_free(&arena);
     return ret;
 }
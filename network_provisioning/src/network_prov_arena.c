@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sdkconfig.h>
+
+#include "network_prov_arena.h"
+
+#define ARENA_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+struct network_prov_arena_block {
+    network_prov_arena_block_t *next;
+    size_t size;
+    size_t used;
+    uint8_t data[] __attribute__((aligned(8)));
+};
+
+static void *arena_protobuf_alloc(void *allocator_data, size_t size)
+{
+    return network_prov_arena_alloc((network_prov_arena_t *) allocator_data, size);
+}
+
+static void arena_protobuf_free(void *allocator_data, void *pointer)
+{
+    /* Everything is freed by network_prov_arena_free() */
+}
+
+void network_prov_arena_init(network_prov_arena_t *arena)
+{
+    arena->allocator.alloc = arena_protobuf_alloc;
+    arena->allocator.free = arena_protobuf_free;
+    arena->allocator.allocator_data = arena;
+    arena->blocks = NULL;
+}
+
+void *network_prov_arena_alloc(network_prov_arena_t *arena, size_t size)
+{
+    network_prov_arena_block_t *block = arena->blocks;
+    size = ARENA_ALIGN(size);
+    if (!block || block->size - block->used < size) {
+        /* Larger allocations get a block of their own, behind the current one which stays in use */
+        bool own_block = size > CONFIG_NETWORK_PROV_ARENA_SIZE;
+        size_t block_size = own_block ? size : CONFIG_NETWORK_PROV_ARENA_SIZE;
+        block = malloc(sizeof(network_prov_arena_block_t) + block_size);
+        if (!block) {
+            return NULL;
+        }
+        block->size = block_size;
+        block->used = 0;
+        if (own_block && arena->blocks) {
+            block->next = arena->blocks->next;
+            arena->blocks->next = block;
+        } else {
+            block->next = arena->blocks;
+            arena->blocks = block;
+        }
+    }
+    void *ptr = block->data + block->used;
+    block->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+void *network_prov_arena_memdup(network_prov_arena_t *arena, const void *data, size_t size)
+{
+    void *ptr = network_prov_arena_alloc(arena, size);
+    if (ptr) {
+        memcpy(ptr, data, size);
+    }
+    return ptr;
+}
+
+char *network_prov_arena_strndup(network_prov_arena_t *arena, const char *str, size_t n)
+{
+    size_t len = strnlen(str, n);
+    char *ptr = network_prov_arena_alloc(arena, len + 1);
+    if (ptr) {
+        memcpy(ptr, str, len);
+    }
+    return ptr;
+}
+
+void network_prov_arena_free(network_prov_arena_t *arena)
+{
+    network_prov_arena_block_t *block = arena->blocks;
+    while (block) {
+        network_prov_arena_block_t *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->blocks = NULL;
+}
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <protobuf-c/protobuf-c.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct network_prov_arena_block network_prov_arena_block_t;
+
+/**
+ * @brief   Bump allocator for the messages of one protocomm request
+ *
+ * The unpacked request and the response messages of a handler are all
+ * allocated from blocks of CONFIG_NETWORK_PROV_ARENA_SIZE bytes, so that
+ * a request usually costs a single allocation, and are freed at once
+ * by network_prov_arena_free().
+ */
+typedef struct {
+    /** Allocator to pass to the protobuf-c unpack functions */
+    ProtobufCAllocator allocator;
+    network_prov_arena_block_t *blocks;
+} network_prov_arena_t;
+
+/**
+ * @brief   Initialize an arena, no memory is allocated until the first allocation
+ */
+void network_prov_arena_init(network_prov_arena_t *arena);
+
+/**
+ * @brief   Allocate size bytes from the arena, zeroed
+ *
+ * @return  Pointer to the memory, or NULL if out of memory
+ */
+void *network_prov_arena_alloc(network_prov_arena_t *arena, size_t size);
+
+/**
+ * @brief   Copy size bytes into the arena
+ *
+ * @return  Pointer to the copy, or NULL if out of memory
+ */
+void *network_prov_arena_memdup(network_prov_arena_t *arena, const void *data, size_t size);
+
+/**
+ * @brief   Copy at most n characters of str into the arena, NULL terminated
+ *
+ * @return  Pointer to the copy, or NULL if out of memory
+ */
+char *network_prov_arena_strndup(network_prov_arena_t *arena, const char *str, size_t n);
+
+/**
+ * @brief   Free all the memory allocated from the arena
+ */
+void network_prov_arena_free(network_prov_arena_t *arena);
+
+#ifdef __cplusplus
+}
+#endif
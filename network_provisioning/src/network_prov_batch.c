@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sdkconfig.h>
+
+#include <esp_log.h>
+#include <esp_err.h>
+
+#include "network_prov_batch.h"
+
+#define BATCH_STATUS_OK             0
+#define BATCH_STATUS_NO_ENDPOINT    1
+#define BATCH_STATUS_FAILED         2
+
+#define BATCH_ENTRY_HEADER_LEN      3
+
+static const char *TAG = "network_prov_batch";
+
+typedef struct {
+    char *name;
+    protocomm_req_handler_t handler;
+    void *priv_data;
+} batch_endpoint_t;
+
+typedef struct {
+    uint8_t status;
+    uint8_t *outbuf;
+    ssize_t outlen;
+} batch_result_t;
+
+/* As the endpoint list of protocomm, updated by the manager when the
+ * endpoints are registered, before clients use them */
+static batch_endpoint_t s_endpoints[CONFIG_NETWORK_PROV_BATCH_MAX_ENDPOINTS];
+
+static batch_endpoint_t *batch_find(const char *name, size_t name_len)
+{
+    for (int i = 0; i < CONFIG_NETWORK_PROV_BATCH_MAX_ENDPOINTS; i++) {
+        if (s_endpoints[i].name && strlen(s_endpoints[i].name) == name_len &&
+                memcmp(s_endpoints[i].name, name, name_len) == 0) {
+            return &s_endpoints[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t network_prov_batch_add(const char *ep_name, protocomm_req_handler_t handler, void *priv_data)
+{
+    if (!ep_name || !handler) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    batch_endpoint_t *ep = batch_find(ep_name, strlen(ep_name));
+    for (int i = 0; !ep && i < CONFIG_NETWORK_PROV_BATCH_MAX_ENDPOINTS; i++) {
+        if (!s_endpoints[i].name) {
+            s_endpoints[i].name = strdup(ep_name);
+            if (!s_endpoints[i].name) {
+                return ESP_ERR_NO_MEM;
+            }
+            ep = &s_endpoints[i];
+        }
+    }
+    if (!ep) {
+        ESP_LOGW(TAG, "No slot left for endpoint %s", ep_name);
+        return ESP_ERR_NO_MEM;
+    }
+    ep->handler = handler;
+    ep->priv_data = priv_data;
+    return ESP_OK;
+}
+
+void network_prov_batch_remove(const char *ep_name)
+{
+    batch_endpoint_t *ep = ep_name ? batch_find(ep_name, strlen(ep_name)) : NULL;
+    if (ep) {
+        free(ep->name);
+        memset(ep, 0, sizeof(*ep));
+    }
+}
+
+void network_prov_batch_clear(void)
+{
+    for (int i = 0; i < CONFIG_NETWORK_PROV_BATCH_MAX_ENDPOINTS; i++) {
+        free(s_endpoints[i].name);
+    }
+    memset(s_endpoints, 0, sizeof(s_endpoints));
+}
+
+/* Checks the framing of the whole batch before any handler is called */
+static esp_err_t batch_validate(const uint8_t *inbuf, ssize_t inlen, uint8_t *count)
+{
+    if (inlen < 1 || inbuf[0] == 0 || inbuf[0] > CONFIG_NETWORK_PROV_BATCH_MAX_REQUESTS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ssize_t pos = 1;
+    for (int i = 0; i < inbuf[0]; i++) {
+        if (pos >= inlen) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        pos += 1 + inbuf[pos];
+        if (pos + 2 > inlen) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        pos += 2 + (inbuf[pos] | (inbuf[pos + 1] << 8));
+        if (pos > inlen) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    if (pos != inlen) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *count = inbuf[0];
+    return ESP_OK;
+}
+
+esp_err_t network_prov_batch_handler(uint32_t session_id, const uint8_t *inbuf, ssize_t inlen,
+                                     uint8_t **outbuf, ssize_t *outlen, void *priv_data)
+{
+    uint8_t count;
+    if (!inbuf || batch_validate(inbuf, inlen, &count) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid batch request");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    batch_result_t results[CONFIG_NETWORK_PROV_BATCH_MAX_REQUESTS] = { 0 };
+    size_t total = 1;
+    const uint8_t *pos = inbuf + 1;
+    for (int i = 0; i < count; i++) {
+        const char *name = (const char *) pos + 1;
+        size_t name_len = pos[0];
+        pos += 1 + name_len;
+        ssize_t req_len = pos[0] | (pos[1] << 8);
+        const uint8_t *req = pos + 2;
+        pos += 2 + req_len;
+
+        batch_endpoint_t *ep = batch_find(name, name_len);
+        if (!ep) {
+            ESP_LOGW(TAG, "Endpoint %.*s can't be batched", (int) name_len, name);
+            results[i].status = BATCH_STATUS_NO_ENDPOINT;
+        } else if (ep->handler(session_id, req, req_len, &results[i].outbuf, &results[i].outlen,
+                               ep->priv_data) != ESP_OK || results[i].outlen > UINT16_MAX) {
+            ESP_LOGW(TAG, "Request to endpoint %s failed", ep->name);
+            free(results[i].outbuf);
+            results[i].outbuf = NULL;
+            results[i].outlen = 0;
+            results[i].status = BATCH_STATUS_FAILED;
+        }
+        total += BATCH_ENTRY_HEADER_LEN + results[i].outlen;
+    }
+
+    esp_err_t ret = ESP_OK;
+    uint8_t *rsp = malloc(total);
+    if (!rsp) {
+        ESP_LOGE(TAG, "Failed to allocate memory for response");
+        ret = ESP_ERR_NO_MEM;
+    } else {
+        uint8_t *out = rsp;
+        *out++ = count;
+        for (int i = 0; i < count; i++) {
+            *out++ = results[i].status;
+            *out++ = results[i].outlen & 0xFF;
+            *out++ = results[i].outlen >> 8;
+            if (results[i].outlen) {
+                memcpy(out, results[i].outbuf, results[i].outlen);
+                out += results[i].outlen;
+            }
+        }
+        *outbuf = rsp;
+        *outlen = total;
+    }
+
+    for (int i = 0; i < count; i++) {
+        free(results[i].outbuf);
+    }
+    return ret;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <esp_err.h>
+#include <protocomm.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Make an endpoint reachable through the "prov-batch" endpoint
+ *
+ * @param[in] ep_name   Endpoint name, copied
+ * @param[in] handler   Handler of the endpoint, as passed to protocomm_add_endpoint()
+ * @param[in] priv_data Private data of the handler
+ *
+ * @return
+ *  - ESP_OK            : Added, or replaced the handler of an endpoint with the same name
+ *  - ESP_ERR_NO_MEM    : All the CONFIG_NETWORK_PROV_BATCH_MAX_ENDPOINTS slots are used
+ */
+esp_err_t network_prov_batch_add(const char *ep_name, protocomm_req_handler_t handler, void *priv_data);
+
+/**
+ * @brief   Remove an endpoint added with network_prov_batch_add()
+ *
+ * @param[in] ep_name   Endpoint name
+ */
+void network_prov_batch_remove(const char *ep_name);
+
+/**
+ * @brief   Remove all the endpoints
+ */
+void network_prov_batch_clear(void);
+
+/**
+ * @brief   Handler of the "prov-batch" endpoint
+ *
+ * Calls the handlers of several endpoints, in order, for one protocomm
+ * exchange. The batch is encrypted as a whole by the session, the requests
+ * and responses it carries are not encrypted again:
+ *
+ *      request:  count (1) | count x { name length (1) | name | length (2, LE) | request }
+ *      response: count (1) | count x { status (1) | length (2, LE) | response }
+ *
+ * with status 0 when the handler succeeded, 1 when the endpoint isn't
+ * available in a batch and 2 when the handler failed, the response being
+ * empty in the last two cases. The session endpoint can't be batched.
+ */
+esp_err_t network_prov_batch_handler(uint32_t session_id, const uint8_t *inbuf, ssize_t inlen,
+                                     uint8_t **outbuf, ssize_t *outlen, void *priv_data);
+
+#ifdef __cplusplus
+}
+#endif
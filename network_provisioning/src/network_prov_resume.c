@@ -0,0 +1,503 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sdkconfig.h>
+
+#include <esp_log.h>
+#include <esp_err.h>
+#include <esp_event.h>
+#include <esp_random.h>
+#include <nvs.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/md.h>
+#include <mbedtls/platform_util.h>
+
+#include <protocomm_security2.h>
+
+#include "network_prov_resume.h"
+
+#define RESUME_NVS_NAMESPACE        "netprov_resume"
+#define RESUME_NVS_TICKET           "ticket"
+#define RESUME_NVS_STARTS           "starts"
+
+#define RESUME_MARKER               0x00
+#define RESUME_MSG_REQUEST          0x01
+#define RESUME_MSG_RESPONSE         0x02
+#define RESUME_TICKET_VERSION       1
+
+#define RESUME_ID_LEN               16
+#define RESUME_SECRET_LEN           32
+#define RESUME_CLIENT_NONCE_LEN     16
+#define RESUME_NONCE_LEN            12
+#define RESUME_MAC_LEN              32
+#define RESUME_TAG_LEN              16
+
+#define RESUME_REQUEST_LEN          (2 + RESUME_ID_LEN + RESUME_CLIENT_NONCE_LEN + RESUME_MAC_LEN)
+#define RESUME_RESPONSE_LEN         (3 + RESUME_NONCE_LEN + RESUME_MAC_LEN)
+#define RESUME_TICKET_RESPONSE_LEN  (1 + RESUME_ID_LEN + RESUME_SECRET_LEN + 4)
+
+/* Earlier times mean that the system time isn't set */
+#define RESUME_CLOCK_SET            ((time_t) 1577836800)
+
+static const char *TAG = "network_prov_resume";
+
+typedef enum {
+    RESUME_STATUS_OK = 0,
+    RESUME_STATUS_INVALID_TICKET,
+    RESUME_STATUS_INVALID_MAC,
+} resume_status_t;
+
+typedef struct {
+    uint8_t id[RESUME_ID_LEN];
+    uint8_t secret[RESUME_SECRET_LEN];
+    /* time() at issue, 0 if the system time wasn't set */
+    int64_t issued;
+    /* Provisioning service starts counted at issue */
+    uint32_t starts;
+} resume_ticket_t;
+
+typedef struct {
+    /* Security 2 instance, handling the sessions which are not resumed */
+    protocomm_security_handle_t sec2;
+    /* session_id was resumed, its data is encrypted here */
+    bool resumed;
+    uint32_t session_id;
+    uint8_t nonce[RESUME_NONCE_LEN];
+    mbedtls_gcm_context gcm;
+} resume_ctx_t;
+
+static protocomm_security_t s_resume_security;
+static uint32_t s_service_starts;
+static bool s_service_counted;
+
+static int resume_hmac(const uint8_t *key, size_t key_len, const char *label,
+                       const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len, uint8_t *mac)
+{
+    mbedtls_md_context_t md;
+    mbedtls_md_init(&md);
+    int ret = mbedtls_md_setup(&md, mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), 1);
+    if (ret == 0) {
+        ret = mbedtls_md_hmac_starts(&md, key, key_len);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_hmac_update(&md, (const uint8_t *) label, strlen(label));
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_hmac_update(&md, a, a_len);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_hmac_update(&md, b, b_len);
+    }
+    if (ret == 0) {
+        ret = mbedtls_md_hmac_finish(&md, mac);
+    }
+    mbedtls_md_free(&md);
+    return ret;
+}
+
+static bool resume_mac_equal(const uint8_t *a, const uint8_t *b)
+{
+    uint8_t diff = 0;
+    for (int i = 0; i < RESUME_MAC_LEN; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+static esp_err_t resume_ticket_load(resume_ticket_t *ticket)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(RESUME_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    size_t len = sizeof(*ticket);
+    err = nvs_get_blob(handle, RESUME_NVS_TICKET, ticket, &len);
+    nvs_close(handle);
+    if (err == ESP_OK && len != sizeof(*ticket)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    return err;
+}
+
+/* Store the ticket, or erase the stored one if ticket is NULL */
+static esp_err_t resume_ticket_store(const resume_ticket_t *ticket)
+{
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(RESUME_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (ticket) {
+        err = nvs_set_blob(handle, RESUME_NVS_TICKET, ticket, sizeof(*ticket));
+    } else {
+        err = nvs_erase_key(handle, RESUME_NVS_TICKET);
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+static bool resume_ticket_is_valid(const resume_ticket_t *ticket)
+{
+    /* Expiry in provisioning service starts, which works without system time */
+    if (!s_service_counted ||
+            s_service_starts - ticket->starts >= CONFIG_NETWORK_PROV_SESSION_RESUMPTION_MAX_STARTS) {
+        return false;
+    }
+    /* Expiry in seconds, if the system time was set both at issue and now */
+    time_t now = time(NULL);
+    if (ticket->issued >= RESUME_CLOCK_SET && now >= RESUME_CLOCK_SET) {
+        if (now < ticket->issued || now - ticket->issued > CONFIG_NETWORK_PROV_SESSION_RESUMPTION_VALIDITY) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void resume_end_session(resume_ctx_t *ctx)
+{
+    if (ctx->resumed) {
+        mbedtls_gcm_free(&ctx->gcm);
+        mbedtls_gcm_init(&ctx->gcm);
+        mbedtls_platform_zeroize(ctx->nonce, sizeof(ctx->nonce));
+        ctx->resumed = false;
+    }
+}
+
+/* Increment the last 4 bytes of the nonce (big-endian counter), as security 2 does */
+static void resume_increment_nonce(resume_ctx_t *ctx)
+{
+    for (int i = RESUME_NONCE_LEN - 1; i >= RESUME_NONCE_LEN - 4; i--) {
+        if (++ctx->nonce[i] != 0) {
+            break;
+        }
+    }
+}
+
+static esp_err_t resume_handle_request(resume_ctx_t *ctx, uint32_t session_id, const uint8_t *inbuf, ssize_t inlen,
+                                       uint8_t **outbuf, ssize_t *outlen)
+{
+    if (inlen != RESUME_REQUEST_LEN || inbuf[1] != RESUME_MSG_REQUEST) {
+        ESP_LOGE(TAG, "Invalid resumption request");
+        return ESP_ERR_INVALID_ARG;
+    }
+    const uint8_t *id = inbuf + 2;
+    const uint8_t *client_nonce = id + RESUME_ID_LEN;
+    const uint8_t *client_mac = client_nonce + RESUME_CLIENT_NONCE_LEN;
+
+    uint8_t *rsp = calloc(1, RESUME_RESPONSE_LEN);
+    if (!rsp) {
+        ESP_LOGE(TAG, "Failed to allocate memory for response");
+        return ESP_ERR_NO_MEM;
+    }
+    rsp[0] = RESUME_MARKER;
+    rsp[1] = RESUME_MSG_RESPONSE;
+    *outbuf = rsp;
+    *outlen = 3;
+
+    resume_end_session(ctx);
+
+    resume_ticket_t ticket;
+    uint8_t mac[RESUME_MAC_LEN];
+    uint8_t session_key[RESUME_SECRET_LEN];
+    esp_err_t ret = ESP_OK;
+    if (resume_ticket_load(&ticket) != ESP_OK || memcmp(ticket.id, id, RESUME_ID_LEN) != 0 ||
+            !resume_ticket_is_valid(&ticket)) {
+        ESP_LOGW(TAG, "Unknown or expired resumption ticket");
+        rsp[2] = RESUME_STATUS_INVALID_TICKET;
+        goto exit;
+    }
+
+    ret = ESP_FAIL;
+    if (resume_hmac(ticket.secret, RESUME_SECRET_LEN, "netprov-resume-req",
+                    id, RESUME_ID_LEN, client_nonce, RESUME_CLIENT_NONCE_LEN, mac) != 0) {
+        ESP_LOGE(TAG, "Failed to compute the request MAC");
+        goto exit;
+    }
+    if (!resume_mac_equal(mac, client_mac)) {
+        ESP_LOGW(TAG, "Invalid resumption request MAC");
+        rsp[2] = RESUME_STATUS_INVALID_MAC;
+        esp_event_post(PROTOCOMM_SECURITY_SESSION_EVENT, PROTOCOMM_SECURITY_SESSION_CREDENTIALS_MISMATCH,
+                       NULL, 0, portMAX_DELAY);
+        ret = ESP_OK;
+        goto exit;
+    }
+
+    /* A ticket is accepted only once */
+    if (resume_ticket_store(NULL) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to erase the resumption ticket");
+        goto exit;
+    }
+
+    esp_fill_random(ctx->nonce, RESUME_NONCE_LEN);
+    if (resume_hmac(ticket.secret, RESUME_SECRET_LEN, "netprov-resume-key",
+                    client_nonce, RESUME_CLIENT_NONCE_LEN, ctx->nonce, RESUME_NONCE_LEN, session_key) != 0 ||
+            resume_hmac(session_key, RESUME_SECRET_LEN, "netprov-resume-rsp",
+                        client_nonce, RESUME_CLIENT_NONCE_LEN, ctx->nonce, RESUME_NONCE_LEN,
+                        rsp + 3 + RESUME_NONCE_LEN) != 0 ||
+            mbedtls_gcm_setkey(&ctx->gcm, MBEDTLS_CIPHER_ID_AES, session_key, RESUME_SECRET_LEN * 8) != 0) {
+        ESP_LOGE(TAG, "Failed to derive the session key");
+        mbedtls_gcm_free(&ctx->gcm);
+        mbedtls_gcm_init(&ctx->gcm);
+        goto exit;
+    }
+    memcpy(rsp + 3, ctx->nonce, RESUME_NONCE_LEN);
+    rsp[2] = RESUME_STATUS_OK;
+    *outlen = RESUME_RESPONSE_LEN;
+    ctx->resumed = true;
+    ctx->session_id = session_id;
+    ret = ESP_OK;
+
+    ESP_LOGI(TAG, "Session resumed");
+    esp_event_post(PROTOCOMM_SECURITY_SESSION_EVENT, PROTOCOMM_SECURITY_SESSION_SETUP_OK,
+                   &session_id, sizeof(session_id), portMAX_DELAY);
+
+exit:
+    mbedtls_platform_zeroize(&ticket, sizeof(ticket));
+    mbedtls_platform_zeroize(session_key, sizeof(session_key));
+    if (ret != ESP_OK) {
+        free(rsp);
+        *outbuf = NULL;
+        *outlen = 0;
+    }
+    return ret;
+}
+
+static esp_err_t resume_init(protocomm_security_handle_t *handle)
+{
+    resume_ctx_t *ctx = calloc(1, sizeof(resume_ctx_t));
+    if (!ctx) {
+        ESP_LOGE(TAG, "Failed to allocate memory for security context");
+        return ESP_ERR_NO_MEM;
+    }
+    esp_err_t ret = protocomm_security2.init(&ctx->sec2);
+    if (ret != ESP_OK) {
+        free(ctx);
+        return ret;
+    }
+    mbedtls_gcm_init(&ctx->gcm);
+    *handle = ctx;
+    return ESP_OK;
+}
+
+static esp_err_t resume_cleanup(protocomm_security_handle_t handle)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t ret = protocomm_security2.cleanup(ctx->sec2);
+    mbedtls_gcm_free(&ctx->gcm);
+    mbedtls_platform_zeroize(ctx, sizeof(*ctx));
+    free(ctx);
+    return ret;
+}
+
+static esp_err_t resume_new_transport_session(protocomm_security_handle_t handle, uint32_t session_id)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* Only one session at a time, as with security 2 */
+    resume_end_session(ctx);
+    return protocomm_security2.new_transport_session(ctx->sec2, session_id);
+}
+
+static esp_err_t resume_close_transport_session(protocomm_security_handle_t handle, uint32_t session_id)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    bool was_resumed = ctx->resumed && ctx->session_id == session_id;
+    if (was_resumed) {
+        resume_end_session(ctx);
+    }
+    esp_err_t ret = protocomm_security2.close_transport_session(ctx->sec2, session_id);
+    return was_resumed ? ESP_OK : ret;
+}
+
+static esp_err_t resume_req_handler(protocomm_security_handle_t handle, const void *sec_params, uint32_t session_id,
+                                    const uint8_t *inbuf, ssize_t inlen, uint8_t **outbuf, ssize_t *outlen,
+                                    void *priv_data)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (inlen >= 2 && inbuf[0] == RESUME_MARKER) {
+        return resume_handle_request(ctx, session_id, inbuf, inlen, outbuf, outlen);
+    }
+    /* The client starts a full security 2 handshake instead */
+    if (ctx->resumed && ctx->session_id == session_id) {
+        resume_end_session(ctx);
+    }
+    return protocomm_security2.security_req_handler(ctx->sec2, sec_params, session_id,
+            inbuf, inlen, outbuf, outlen, priv_data);
+}
+
+static esp_err_t resume_encrypt(protocomm_security_handle_t handle, uint32_t session_id,
+                                const uint8_t *inbuf, ssize_t inlen, uint8_t **outbuf, ssize_t *outlen)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!ctx->resumed || ctx->session_id != session_id) {
+        return protocomm_security2.encrypt(ctx->sec2, session_id, inbuf, inlen, outbuf, outlen);
+    }
+
+    uint8_t *out = malloc(inlen + RESUME_TAG_LEN);
+    if (!out) {
+        ESP_LOGE(TAG, "Failed to allocate encrypt buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    if (mbedtls_gcm_crypt_and_tag(&ctx->gcm, MBEDTLS_GCM_ENCRYPT, inlen, ctx->nonce, RESUME_NONCE_LEN,
+                                  NULL, 0, inbuf, out, RESUME_TAG_LEN, out + inlen) != 0) {
+        ESP_LOGE(TAG, "Failed at mbedtls_gcm_crypt_and_tag");
+        free(out);
+        return ESP_FAIL;
+    }
+    resume_increment_nonce(ctx);
+    *outbuf = out;
+    *outlen = inlen + RESUME_TAG_LEN;
+    return ESP_OK;
+}
+
+static esp_err_t resume_decrypt(protocomm_security_handle_t handle, uint32_t session_id,
+                                const uint8_t *inbuf, ssize_t inlen, uint8_t **outbuf, ssize_t *outlen)
+{
+    resume_ctx_t *ctx = (resume_ctx_t *) handle;
+    if (!ctx) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!ctx->resumed || ctx->session_id != session_id) {
+        return protocomm_security2.decrypt(ctx->sec2, session_id, inbuf, inlen, outbuf, outlen);
+    }
+
+    if (inlen < RESUME_TAG_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ssize_t len = inlen - RESUME_TAG_LEN;
+    uint8_t *out = malloc(len > 0 ? len : 1);
+    if (!out) {
+        ESP_LOGE(TAG, "Failed to allocate decrypt buffer");
+        return ESP_ERR_NO_MEM;
+    }
+    if (mbedtls_gcm_auth_decrypt(&ctx->gcm, len, ctx->nonce, RESUME_NONCE_LEN, NULL, 0,
+                                 inbuf + len, RESUME_TAG_LEN, inbuf, out) != 0) {
+        ESP_LOGE(TAG, "Failed at mbedtls_gcm_auth_decrypt");
+        free(out);
+        return ESP_FAIL;
+    }
+    resume_increment_nonce(ctx);
+    *outbuf = out;
+    *outlen = len;
+    return ESP_OK;
+}
+
+const protocomm_security_t *network_prov_resume_security(void)
+{
+    /* Keep the version fields of security 2, reported by the version endpoint */
+    s_resume_security = protocomm_security2;
+    s_resume_security.init = resume_init;
+    s_resume_security.cleanup = resume_cleanup;
+    s_resume_security.new_transport_session = resume_new_transport_session;
+    s_resume_security.close_transport_session = resume_close_transport_session;
+    s_resume_security.security_req_handler = resume_req_handler;
+    s_resume_security.encrypt = resume_encrypt;
+    s_resume_security.decrypt = resume_decrypt;
+    return &s_resume_security;
+}
+
+esp_err_t network_prov_resume_service_start(void)
+{
+#if !CONFIG_NVS_ENCRYPTION
+    ESP_LOGW(TAG, "NVS encryption is disabled, the session resumption secret is stored in plain text");
+#endif
+    s_service_counted = false;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(RESUME_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace (%s)", esp_err_to_name(err));
+        return err;
+    }
+    uint32_t starts = 0;
+    err = nvs_get_u32(handle, RESUME_NVS_STARTS, &starts);
+    if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+        err = nvs_set_u32(handle, RESUME_NVS_STARTS, starts + 1);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to count the service start (%s)", esp_err_to_name(err));
+        return err;
+    }
+    s_service_starts = starts + 1;
+    s_service_counted = true;
+    return ESP_OK;
+}
+
+esp_err_t network_prov_resume_ticket_handler(uint32_t session_id, const uint8_t *inbuf, ssize_t inlen,
+        uint8_t **outbuf, ssize_t *outlen, void *priv_data)
+{
+    if (!s_service_counted) {
+        ESP_LOGE(TAG, "Session resumption is unavailable");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    resume_ticket_t ticket;
+    memset(&ticket, 0, sizeof(ticket));
+    esp_fill_random(ticket.id, sizeof(ticket.id));
+    esp_fill_random(ticket.secret, sizeof(ticket.secret));
+    time_t now = time(NULL);
+    ticket.issued = now >= RESUME_CLOCK_SET ? now : 0;
+    ticket.starts = s_service_starts;
+
+    esp_err_t ret = ESP_ERR_NO_MEM;
+    uint8_t *rsp = malloc(RESUME_TICKET_RESPONSE_LEN);
+    if (!rsp) {
+        ESP_LOGE(TAG, "Failed to allocate memory for response");
+        goto exit;
+    }
+    ret = resume_ticket_store(&ticket);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to store the resumption ticket (%s)", esp_err_to_name(ret));
+        free(rsp);
+        goto exit;
+    }
+
+    uint32_t validity = CONFIG_NETWORK_PROV_SESSION_RESUMPTION_VALIDITY;
+    rsp[0] = RESUME_TICKET_VERSION;
+    memcpy(rsp + 1, ticket.id, RESUME_ID_LEN);
+    memcpy(rsp + 1 + RESUME_ID_LEN, ticket.secret, RESUME_SECRET_LEN);
+    for (int i = 0; i < 4; i++) {
+        rsp[1 + RESUME_ID_LEN + RESUME_SECRET_LEN + i] = (uint8_t) (validity >> (8 * i));
+    }
+    *outbuf = rsp;
+    *outlen = RESUME_TICKET_RESPONSE_LEN;
+    ESP_LOGD(TAG, "Issued a resumption ticket");
+
+exit:
+    mbedtls_platform_zeroize(&ticket, sizeof(ticket));
+    return ret;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <esp_err.h>
+#include <protocomm_security.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Security 2 with session resumption
+ *
+ * Behaves as protocomm_security2, and additionally lets a client holding
+ * a resumption ticket, issued by the "prov-resume" endpoint during a
+ * previous session, establish a session without the SRP6a handshake.
+ *
+ * A resumption request is sent on the "prov-session" endpoint and starts
+ * with a 0x00 byte, which never starts a SessionData protobuf message:
+ *
+ *      request:  0x00 0x01 | ticket id (16) | client nonce (16) |
+ *                HMAC-SHA256(secret, "netprov-resume-req" | ticket id | client nonce)
+ *      response: 0x00 0x02 | status (1) | device nonce (12) |
+ *                HMAC-SHA256(session key, "netprov-resume-rsp" | client nonce | device nonce)
+ *
+ * with session key = HMAC-SHA256(secret, "netprov-resume-key" | client nonce | device nonce).
+ * The nonce and the session key are then used with AES-256-GCM as in
+ * security 2. A ticket is accepted once, the client fetches a new one in
+ * every session.
+ *
+ * @return  The security implementation to pass to protocomm_set_security()
+ */
+const protocomm_security_t *network_prov_resume_security(void);
+
+/**
+ * @brief   Count a start of the provisioning service, for the ticket expiry
+ *
+ * @return
+ *  - ESP_OK    : Counted
+ *  - Others    : NVS error, resumption is unavailable until the next start
+ */
+esp_err_t network_prov_resume_service_start(void);
+
+/**
+ * @brief   Handler of the "prov-resume" endpoint
+ *
+ * Issues a new resumption ticket, replacing the stored one:
+ *
+ *      response: version (1) = 1 | ticket id (16) | secret (32) | validity in seconds (4, little endian)
+ *
+ * The endpoint is encrypted by the session, so tickets are only given to
+ * authenticated clients.
+ */
+esp_err_t network_prov_resume_ticket_handler(uint32_t session_id, const uint8_t *inbuf, ssize_t inlen,
+        uint8_t **outbuf, ssize_t *outlen, void *priv_data);
+
+#ifdef __cplusplus
+}
+#endif
@@ -11,27 +11,34 @@
 #include <esp_wifi.h>
 
 #include "network_scan.pb-c.h"
+#include "network_prov_arena.h"
 
 #include <network_provisioning/network_scan.h>
 
 static const char *TAG = "proto_network_scan";
 
+/* Tag and length of each entry in the repeated field of the response */
+#define SCAN_RESULT_ENTRY_OVERHEAD 2
+
 typedef struct network_prov_scan_cmd {
     int cmd_num;
-    esp_err_t (*command_handler)(NetworkScanPayload *req,
-                                 NetworkScanPayload *resp, void *priv_data);
+    esp_err_t (*command_handler)(NetworkScanPayload *req, NetworkScanPayload *resp,
+                                 network_prov_arena_t *arena, void *priv_data);
 } network_prov_scan_cmd_t;
 
 static esp_err_t cmd_scan_start_handler(NetworkScanPayload *req,
                                         NetworkScanPayload *resp,
+                                        network_prov_arena_t *arena,
                                         void *priv_data);
 
 static esp_err_t cmd_scan_status_handler(NetworkScanPayload *req,
         NetworkScanPayload *resp,
+        network_prov_arena_t *arena,
         void *priv_data);
 
 static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
         NetworkScanPayload *resp,
+        network_prov_arena_t *arena,
         void *priv_data);
 
 static network_prov_scan_cmd_t cmd_table[] = {
@@ -62,7 +69,7 @@ static network_prov_scan_cmd_t cmd_table[] = {
 };
 
 static esp_err_t cmd_scan_start_handler(NetworkScanPayload *req,
-                                        NetworkScanPayload *resp, void *priv_data)
+                                        NetworkScanPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     network_prov_scan_handlers_t *h = (network_prov_scan_handlers_t *) priv_data;
     if (!h) {
@@ -70,7 +77,7 @@ static esp_err_t cmd_scan_start_handler(NetworkScanPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanWifiStart) {
-        RespScanWifiStart *resp_payload = (RespScanWifiStart *) malloc(sizeof(RespScanWifiStart));
+        RespScanWifiStart *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanWifiStart));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -92,7 +99,7 @@ static esp_err_t cmd_scan_start_handler(NetworkScanPayload *req,
         resp->payload_case = NETWORK_SCAN_PAYLOAD__PAYLOAD_RESP_SCAN_WIFI_START;
         resp->resp_scan_wifi_start = resp_payload;
     } else if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanThreadStart) {
-        RespScanThreadStart *resp_payload = (RespScanThreadStart *) malloc(sizeof(RespScanThreadStart));
+        RespScanThreadStart *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanThreadStart));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -116,7 +123,7 @@ static esp_err_t cmd_scan_start_handler(NetworkScanPayload *req,
 }
 
 static esp_err_t cmd_scan_status_handler(NetworkScanPayload *req,
-        NetworkScanPayload *resp, void *priv_data)
+        NetworkScanPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     bool scan_finished = false;
     uint16_t result_count = 0;
@@ -127,7 +134,7 @@ static esp_err_t cmd_scan_status_handler(NetworkScanPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanWifiStatus) {
-        RespScanWifiStatus *resp_payload = (RespScanWifiStatus *) malloc(sizeof(RespScanWifiStatus));
+        RespScanWifiStatus *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanWifiStatus));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -148,7 +155,7 @@ static esp_err_t cmd_scan_status_handler(NetworkScanPayload *req,
         resp->payload_case = NETWORK_SCAN_PAYLOAD__PAYLOAD_RESP_SCAN_WIFI_STATUS;
         resp->resp_scan_wifi_status = resp_payload;
     } else if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanThreadStatus) {
-        RespScanThreadStatus *resp_payload = (RespScanThreadStatus *) malloc(sizeof(RespScanThreadStatus));
+        RespScanThreadStatus *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanThreadStatus));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -173,7 +180,7 @@ static esp_err_t cmd_scan_status_handler(NetworkScanPayload *req,
 }
 
 static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
-        NetworkScanPayload *resp, void *priv_data)
+        NetworkScanPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     esp_err_t err = ESP_OK;
     network_prov_scan_handlers_t *h = (network_prov_scan_handlers_t *) priv_data;
@@ -182,7 +189,7 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
         return ESP_ERR_INVALID_STATE;
     }
     if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanWifiResult) {
-        RespScanWifiResult *resp_payload = (RespScanWifiResult *) malloc(sizeof(RespScanWifiResult));
+        RespScanWifiResult *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanWifiResult));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -197,15 +204,17 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
 
         /* Allocate memory only if there are non-zero scan results */
         if (req->cmd_scan_wifi_result->count) {
-            results = (WiFiScanResult **) calloc(req->cmd_scan_wifi_result->count,
-                                                 sizeof(WiFiScanResult *));
+            results = network_prov_arena_alloc(arena, req->cmd_scan_wifi_result->count *
+                                               sizeof(WiFiScanResult *));
             if (!results) {
                 ESP_LOGE(TAG, "Failed to allocate memory for results array");
                 return ESP_ERR_NO_MEM;
             }
         }
         resp_payload->entries = results;
-        resp_payload->n_entries = req->cmd_scan_wifi_result->count;
+        /* Only the entries that fit in the page are counted, the client
+         * requests the other ones from start_index + n_entries */
+        size_t page_size = 0;
 
         /* If req->cmd_scan_wifi_result->count is 0, the below loop will
         * be skipped.
@@ -222,7 +231,7 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
                 break;
             }
 
-            results[i] = (WiFiScanResult *) malloc(sizeof(WiFiScanResult));
+            results[i] = network_prov_arena_alloc(arena, sizeof(WiFiScanResult));
             if (!results[i]) {
                 ESP_LOGE(TAG, "Failed to allocate memory for result entry");
                 return ESP_ERR_NO_MEM;
@@ -230,7 +239,7 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
             wi_fi_scan_result__init(results[i]);
 
             results[i]->ssid.len = strnlen(scan_result.ssid, 32);
-            results[i]->ssid.data = (uint8_t *) strndup(scan_result.ssid, 32);
+            results[i]->ssid.data = (uint8_t *) network_prov_arena_strndup(arena, scan_result.ssid, 32);
             if (!results[i]->ssid.data) {
                 ESP_LOGE(TAG, "Failed to allocate memory for scan result entry SSID");
                 return ESP_ERR_NO_MEM;
@@ -241,18 +250,23 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
             results[i]->auth = scan_result.auth;
 
             results[i]->bssid.len = sizeof(scan_result.bssid);
-            results[i]->bssid.data = malloc(results[i]->bssid.len);
+            results[i]->bssid.data = network_prov_arena_memdup(arena, scan_result.bssid, results[i]->bssid.len);
             if (!results[i]->bssid.data) {
                 ESP_LOGE(TAG, "Failed to allocate memory for scan result entry BSSID");
                 return ESP_ERR_NO_MEM;
             }
-            memcpy(results[i]->bssid.data, scan_result.bssid, results[i]->bssid.len);
+
+            page_size += wi_fi_scan_result__get_packed_size(results[i]) + SCAN_RESULT_ENTRY_OVERHEAD;
+            if (i > 0 && page_size > CONFIG_NETWORK_PROV_SCAN_RESULT_PAGE_SIZE) {
+                break;
+            }
+            resp_payload->n_entries = i + 1;
         }
 #else // CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
         resp->status = STATUS__InvalidArgument;
 #endif // !CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
     } else if (req->msg == NETWORK_SCAN_MSG_TYPE__TypeCmdScanThreadResult) {
-        RespScanThreadResult *resp_payload = (RespScanThreadResult *) malloc(sizeof(RespScanThreadResult));
+        RespScanThreadResult *resp_payload = network_prov_arena_alloc(arena, sizeof(RespScanThreadResult));
         if (!resp_payload) {
             ESP_LOGE(TAG, "Error allocating memory");
             return ESP_ERR_NO_MEM;
@@ -268,15 +282,17 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
 
         /* Allocate memory only if there are non-zero scan results */
         if (req->cmd_scan_thread_result->count) {
-            results = (ThreadScanResult **) calloc(req->cmd_scan_thread_result->count,
-                                                   sizeof(ThreadScanResult *));
+            results = network_prov_arena_alloc(arena, req->cmd_scan_thread_result->count *
+                                               sizeof(ThreadScanResult *));
             if (!results) {
                 ESP_LOGE(TAG, "Failed to allocate memory for results array");
                 return ESP_ERR_NO_MEM;
             }
         }
         resp_payload->entries = results;
-        resp_payload->n_entries = req->cmd_scan_thread_result->count;
+        /* Only the entries that fit in the page are counted, the client
+         * requests the other ones from start_index + n_entries */
+        size_t page_size = 0;
 
         /* If req->cmd_scan_result->count is 0, the below loop will
         * be skipped.
@@ -293,7 +309,7 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
                 break;
             }
 
-            results[i] = (ThreadScanResult *) malloc(sizeof(ThreadScanResult));
+            results[i] = network_prov_arena_alloc(arena, sizeof(ThreadScanResult));
             if (!results[i]) {
                 ESP_LOGE(TAG, "Failed to allocate memory for result entry");
                 return ESP_ERR_NO_MEM;
@@ -305,26 +321,32 @@ static esp_err_t cmd_scan_result_handler(NetworkScanPayload *req,
             results[i]->lqi = scan_result.lqi;
 
             results[i]->ext_addr.len = sizeof(scan_result.ext_addr);
-            results[i]->ext_addr.data = (uint8_t *)malloc(results[i]->ext_addr.len);
+            results[i]->ext_addr.data = network_prov_arena_memdup(arena, scan_result.ext_addr, results[i]->ext_addr.len);
             if (!results[i]->ext_addr.data) {
                 ESP_LOGE(TAG, "Failed to allocate memory for scan result entry extended address");
                 return ESP_ERR_NO_MEM;
             }
-            memcpy(results[i]->ext_addr.data, scan_result.ext_addr, results[i]->ext_addr.len);
 
             results[i]->ext_pan_id.len = sizeof(scan_result.ext_pan_id);
-            results[i]->ext_pan_id.data = (uint8_t *)malloc(results[i]->ext_pan_id.len);
+            results[i]->ext_pan_id.data = network_prov_arena_memdup(arena, scan_result.ext_pan_id,
+                                          results[i]->ext_pan_id.len);
             if (!results[i]->ext_pan_id.data) {
                 ESP_LOGE(TAG, "Failed to allocate memory for scan result entry extended PAN ID");
                 return ESP_ERR_NO_MEM;
             }
-            memcpy(results[i]->ext_pan_id.data, scan_result.ext_pan_id, results[i]->ext_pan_id.len);
 
-            results[i]->network_name = (char *)malloc(sizeof(scan_result.network_name));
+            results[i]->network_name = network_prov_arena_memdup(arena, scan_result.network_name,
+                                       sizeof(scan_result.network_name));
             if (!results[i]->network_name) {
                 ESP_LOGE(TAG, "Failed to allocate memory for scan result entry networkname");
+                return ESP_ERR_NO_MEM;
+            }
+
+            page_size += thread_scan_result__get_packed_size(results[i]) + SCAN_RESULT_ENTRY_OVERHEAD;
+            if (i > 0 && page_size > CONFIG_NETWORK_PROV_SCAN_RESULT_PAGE_SIZE) {
+                break;
             }
-            memcpy(results[i]->network_name, scan_result.network_name, sizeof(scan_result.network_name));
+            resp_payload->n_entries = i + 1;
         }
 #else // CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
         resp->status = STATUS__InvalidArgument;
@@ -346,75 +368,8 @@ static int lookup_cmd_handler(int cmd_id)
     return -1;
 }
 
-static void network_prov_scan_cmd_cleanup(NetworkScanPayload *resp, void *priv_data)
-{
-    switch (resp->msg) {
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanWifiStart: {
-        free(resp->resp_scan_wifi_start);
-    }
-    break;
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanThreadStart: {
-        free(resp->resp_scan_thread_start);
-    }
-    break;
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanWifiStatus: {
-        free(resp->resp_scan_wifi_status);
-    }
-    break;
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanThreadStatus: {
-        free(resp->resp_scan_thread_status);
-    }
-    break;
-
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanWifiResult: {
-        if (!resp->resp_scan_wifi_result) {
-            return;
-        }
-#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
-        if (resp->resp_scan_wifi_result->entries) {
-            for (uint16_t i = 0; i < resp->resp_scan_wifi_result->n_entries; i++) {
-                if (!resp->resp_scan_wifi_result->entries[i]) {
-                    continue;
-                }
-                free(resp->resp_scan_wifi_result->entries[i]->ssid.data);
-                free(resp->resp_scan_wifi_result->entries[i]->bssid.data);
-            }
-            free(resp->resp_scan_wifi_result->entries);
-        }
-#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_WIFI
-        free(resp->resp_scan_wifi_result);
-    }
-    break;
-    case NETWORK_SCAN_MSG_TYPE__TypeRespScanThreadResult: {
-        if (!resp->resp_scan_thread_result) {
-            return;
-        }
-#ifdef CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
-        if (resp->resp_scan_thread_result->entries) {
-            for (uint16_t i = 0; i < resp->resp_scan_thread_result->n_entries; i++) {
-                if (!resp->resp_scan_thread_result->entries[i]) {
-                    continue;
-                }
-                free(resp->resp_scan_thread_result->entries[i]->ext_addr.data);
-                free(resp->resp_scan_thread_result->entries[i]->ext_pan_id.data);
-                free(resp->resp_scan_thread_result->entries[i]->network_name);
-                free(resp->resp_scan_thread_result->entries[i]);
-            }
-            free(resp->resp_scan_thread_result->entries);
-        }
-#endif // CONFIG_NETWORK_PROV_NETWORK_TYPE_THREAD
-        free(resp->resp_scan_thread_result);
-    }
-    break;
-    default:
-        ESP_LOGE(TAG, "Unsupported response type in cleanup_handler");
-        break;
-    }
-    return;
-}
-
 static esp_err_t network_prov_scan_cmd_dispatcher(NetworkScanPayload *req,
-        NetworkScanPayload *resp, void *priv_data)
+        NetworkScanPayload *resp, network_prov_arena_t *arena, void *priv_data)
 {
     esp_err_t ret;
 
@@ -426,7 +381,7 @@ static esp_err_t network_prov_scan_cmd_dispatcher(NetworkScanPayload *req,
         return ESP_FAIL;
     }
 
-    ret = cmd_table[cmd_index].command_handler(req, resp, priv_data);
+    ret = cmd_table[cmd_index].command_handler(req, resp, arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Error executing command handler");
         return ESP_FAIL;
@@ -440,16 +395,20 @@ esp_err_t network_prov_scan_handler(uint32_t session_id, const uint8_t *inbuf, s
 {
     NetworkScanPayload *req;
     NetworkScanPayload resp;
+    network_prov_arena_t arena;
     esp_err_t ret = ESP_OK;
 
-    req = network_scan_payload__unpack(NULL, inlen, inbuf);
+    /* The request and the response are allocated from the arena, and freed together */
+    network_prov_arena_init(&arena);
+    req = network_scan_payload__unpack(&arena.allocator, inlen, inbuf);
     if (!req) {
         ESP_LOGE(TAG, "Unable to unpack scan message");
+        network_prov_arena_free(&arena);
         return ESP_ERR_INVALID_ARG;
     }
 
     network_scan_payload__init(&resp);
-    ret = network_prov_scan_cmd_dispatcher(req, &resp, priv_data);
+    ret = network_prov_scan_cmd_dispatcher(req, &resp, &arena, priv_data);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Command dispatcher error %d", ret);
         ret = ESP_FAIL;
@@ -474,7 +433,6 @@ esp_err_t network_prov_scan_handler(uint32_t session_id, const uint8_t *inbuf, s
     ESP_LOGD(TAG, "Response packet size : %d", *outlen);
 exit:
 
-    network_scan_payload__free_unpacked(req, NULL);
-    network_prov_scan_cmd_cleanup(&resp, priv_data);
+    network_prov_arena_free(&arena);
     return ret;
 }
@@ -12,6 +12,7 @@
 
 #include <protocomm.h>
 #include <protocomm_httpd.h>
+#include <esp_http_server.h>
 
 #include "network_provisioning/scheme_softap.h"
 #include "network_provisioning_priv.h"
@@ -26,6 +27,46 @@ static const char *TAG = "network_prov_scheme_softap";
 
 extern const network_prov_scheme_t network_prov_scheme_softap;
 static void *scheme_softap_prov_httpd_handle;
+
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+/* Enough for the built-in endpoints and a few custom ones */
+#define SOFTAP_MAX_URI_HANDLERS 16
+
+/* Server started by the scheme, when the application doesn't provide one */
+static httpd_handle_t scheme_softap_keep_alive_httpd_handle;
+
+/* Start the server as protocomm_httpd would, with TCP keep-alive so that a
+ * client gone without closing its connection is detected, and the HTTP
+ * connection (and protocomm session) of the client is otherwise kept open */
+static esp_err_t start_keep_alive_httpd(const protocomm_http_server_config_t *server_config)
+{
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.server_port = server_config->port;
+    config.stack_size = server_config->stack_size;
+    config.task_priority = server_config->task_priority;
+    config.max_uri_handlers = SOFTAP_MAX_URI_HANDLERS;
+    config.lru_purge_enable = true;
+    config.keep_alive_enable = true;
+    config.keep_alive_idle = CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE_IDLE;
+    config.keep_alive_interval = CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE_INTERVAL;
+    config.keep_alive_count = CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE_COUNT;
+
+    esp_err_t err = httpd_start(&scheme_softap_keep_alive_httpd_handle, &config);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start HTTP server : %d", err);
+        scheme_softap_keep_alive_httpd_handle = NULL;
+    }
+    return err;
+}
+
+static void stop_keep_alive_httpd(void)
+{
+    if (scheme_softap_keep_alive_httpd_handle) {
+        httpd_stop(scheme_softap_keep_alive_httpd_handle);
+        scheme_softap_keep_alive_httpd_handle = NULL;
+    }
+}
+#endif
 static esp_err_t start_wifi_ap(const char *ssid, const char *pass)
 {
     /* Build Wi-Fi configuration for AP mode */
@@ -80,15 +121,34 @@ static esp_err_t prov_start(protocomm_t *pc, void *config)
 
     protocomm_httpd_config_t *httpd_config = &softap_config->httpd_config;
 
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+    protocomm_httpd_config_t keep_alive_config = { 0 };
+#endif
     if (scheme_softap_prov_httpd_handle) {
         httpd_config->ext_handle_provided = true;
         httpd_config->data.handle = scheme_softap_prov_httpd_handle;
     }
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+    else {
+        esp_err_t err = start_keep_alive_httpd(&httpd_config->data.config);
+        if (err != ESP_OK) {
+            return err;
+        }
+        /* The handle shares its storage with the server configuration,
+         * which is kept for the next start */
+        keep_alive_config.ext_handle_provided = true;
+        keep_alive_config.data.handle = scheme_softap_keep_alive_httpd_handle;
+        httpd_config = &keep_alive_config;
+    }
+#endif
 
     /* Start protocomm server on top of HTTP */
     esp_err_t err = protocomm_httpd_start(pc, httpd_config);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start protocomm HTTP server");
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+        stop_keep_alive_httpd();
+#endif
         return err;
     }
 
@@ -97,6 +157,9 @@ static esp_err_t prov_start(protocomm_t *pc, void *config)
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start Wi-Fi AP");
         protocomm_httpd_stop(pc);
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+        stop_keep_alive_httpd();
+#endif
         return err;
     }
 
@@ -109,6 +172,9 @@ static esp_err_t prov_stop(protocomm_t *pc)
     if (err != ESP_OK) {
         ESP_LOGW(TAG, "Error occurred while stopping protocomm_httpd");
     }
+#ifdef CONFIG_NETWORK_PROV_SOFTAP_KEEP_ALIVE
+    stop_keep_alive_httpd();
+#endif
 
     return err;
 }
@@ -196,6 +196,17 @@ async def establish_session(tp, sec):
         return None
 
 
+async def get_resume_ticket(tp, sec, ticket_file):
+    try:
+        message = security.resume_ticket_request(sec)
+        response = await tp.send_data('prov-resume', message)
+        security.save_resume_ticket(ticket_file, security.resume_ticket_response(sec, response))
+        return True
+    except RuntimeError as e:
+        on_except(e)
+        return None
+
+
 async def custom_config(tp, sec, custom_info, custom_ver):
     try:
         message = prov.custom_config_request(sec, custom_info, custom_ver)
@@ -249,13 +260,20 @@ async def scan_wifi_APs(sel_transport, tp, sec):
         result = prov.scan_status_response(sec, response)
         print('++++ Scan results : ' + str(result['count']))
         if result['count'] != 0:
+            # With paging, the device returns as many of the requested entries as fit in one response
+            paging = await has_capability(tp, 'wifi_scan_page')
             index = 0
             remaining = result['count']
             while remaining:
-                count = [remaining, readlen][remaining > readlen]
+                count = remaining if paging else min(remaining, readlen)
                 message = prov.scan_result_request('wifi', sec, index, count)
                 response = await tp.send_data('prov-scan', message)
-                APs += prov.scan_result_response(sec, response)
+                entries = prov.scan_result_response(sec, response)
+                if paging:
+                    if not entries:
+                        raise RuntimeError('Empty scan result page')
+                    count = len(entries)
+                APs += entries
                 remaining -= count
                 index += count
 
@@ -286,6 +304,23 @@ async def apply_wifi_config(tp, sec):
         return None
 
 
+async def send_and_apply_config(tp, sec, network_type, ssid_or_dataset_tlvs, passphrase=''):
+    # Set and apply the configuration in a single exchange with the prov-batch endpoint
+    try:
+        entry_ctx = prov.BatchEntryContext(sec.verbose)
+        set_request = prov.config_set_config_request(network_type, entry_ctx, ssid_or_dataset_tlvs, passphrase)
+        apply_request = prov.config_apply_config_request(network_type, entry_ctx)
+        requests = [('prov-config', set_request), ('prov-config', apply_request)]
+        message = prov.batch_request(sec, requests)
+        response = await tp.send_data('prov-batch', message)
+        set_response, apply_response = prov.batch_response(sec, response)
+        return (prov.config_set_config_response(entry_ctx, set_response) == 0 and
+                prov.config_apply_config_response(entry_ctx, apply_response) == 0)
+    except (RuntimeError, ValueError) as e:
+        on_except(e)
+        return None
+
+
 async def get_wifi_config(tp, sec):
     try:
         message = prov.config_get_status_request('wifi', sec)
@@ -364,13 +399,20 @@ async def scan_thread_networks(sel_transport, tp, sec):
         result = prov.scan_status_response(sec, response)
         print('++++ Scan results : ' + str(result['count']))
         if result['count'] != 0:
+            # With paging, the device returns as many of the requested entries as fit in one response
+            paging = await has_capability(tp, 'thread_scan_page')
             index = 0
             remaining = result['count']
             while remaining:
-                count = [remaining, readlen][remaining > readlen]
+                count = remaining if paging else min(remaining, readlen)
                 message = prov.scan_result_request('thread', sec, index, count)
                 response = await tp.send_data('prov-scan', message)
-                Networks += prov.scan_result_response(sec, response)
+                entries = prov.scan_result_response(sec, response)
+                if paging:
+                    if not entries:
+                        raise RuntimeError('Empty scan result page')
+                    count = len(entries)
+                Networks += entries
                 remaining -= count
                 index += count
 
@@ -522,6 +564,12 @@ async def main():
                         help=desc_format(
                             'Salt length for security scheme 2 (SRP6a)'))
 
+    parser.add_argument('--sec2_resume_ticket', dest='sec2_resume_ticket', type=str, default='',
+                        help=desc_format(
+                            'File storing the session resumption ticket of the device for security scheme 2. '
+                            'When the file holds a valid ticket, the session is resumed without the SRP6a '
+                            'handshake, and a new ticket is stored in the file after the session is established'))
+
     parser.add_argument('--ssid', dest='ssid', type=str, default='',
                         help=desc_format(
                             'This configures the device to use SSID of the Wi-Fi network to which '
@@ -590,17 +638,11 @@ async def main():
                 print('Proof of Possession will be ignored')
                 args.sec1_pop = ''
 
+        resume_ticket = None
         if (args.secver == 2):
             sec_patch_ver = await get_sec_patch_ver(obj_transport, args.verbose)
-            if len(args.sec2_usr) == 0:
-                args.sec2_usr = input('Security Scheme 2 - SRP6a Username required: ')
-            if len(args.sec2_pwd) == 0:
-                prompt_str = 'Security Scheme 2 - SRP6a Password required: '
-                args.sec2_pwd = getpass(prompt_str)
-
-        obj_security = get_security(args.secver, sec_patch_ver, args.sec2_usr, args.sec2_pwd, args.sec1_pop, args.verbose)
-        if obj_security is None:
-            raise ValueError('Invalid Security Version')
+            if args.sec2_resume_ticket and await has_capability(obj_transport, 'sec2_resume'):
+                resume_ticket = security.load_resume_ticket(args.sec2_resume_ticket)
 
         if args.version != '':
             print('\n==== Verifying protocol version ====')
@@ -608,11 +650,39 @@ async def main():
                 raise RuntimeError('Error in protocol version matching')
             print('==== Verified protocol version successfully ====')
 
-        print('\n==== Starting Session ====')
-        if not await establish_session(obj_transport, obj_security):
-            print('Failed to establish session. Ensure that security scheme and proof of possession are correct')
-            raise RuntimeError('Error in establishing session')
-        print('==== Session Established ====')
+        obj_security = None
+        if resume_ticket is not None:
+            print('\n==== Resuming Session ====')
+            # The ticket is used only once, whether resumption succeeds or not
+            security.save_resume_ticket(args.sec2_resume_ticket, None)
+            obj_security = security.Security2Resume(resume_ticket, args.verbose)
+            if await establish_session(obj_transport, obj_security):
+                print('==== Session Resumed ====')
+            else:
+                print('Failed to resume session, starting a new one')
+                obj_security = None
+
+        if obj_security is None:
+            if (args.secver == 2):
+                if len(args.sec2_usr) == 0:
+                    args.sec2_usr = input('Security Scheme 2 - SRP6a Username required: ')
+                if len(args.sec2_pwd) == 0:
+                    prompt_str = 'Security Scheme 2 - SRP6a Password required: '
+                    args.sec2_pwd = getpass(prompt_str)
+
+            obj_security = get_security(args.secver, sec_patch_ver, args.sec2_usr, args.sec2_pwd, args.sec1_pop, args.verbose)
+            if obj_security is None:
+                raise ValueError('Invalid Security Version')
+
+            print('\n==== Starting Session ====')
+            if not await establish_session(obj_transport, obj_security):
+                print('Failed to establish session. Ensure that security scheme and proof of possession are correct')
+                raise RuntimeError('Error in establishing session')
+            print('==== Session Established ====')
+
+        if args.secver == 2 and args.sec2_resume_ticket and await has_capability(obj_transport, 'sec2_resume'):
+            if not await get_resume_ticket(obj_transport, obj_security, args.sec2_resume_ticket):
+                print('Failed to get a session resumption ticket')
 
         if await has_capability(obj_transport, 'thread_prov'):
             if args.reset:
@@ -665,15 +735,21 @@ async def main():
                             args.dataset_tlvs = get_thread_dataset_tlvs(Networks[select], network_key)
                             break
 
-            print('\n==== Sending Thread Dataset to Target ====')
-            if not await send_thread_config(obj_transport, obj_security, args.dataset_tlvs):
-                raise RuntimeError('Error in send Thread config')
-            print('==== Thread Dataset sent successfully ====')
-
-            print('\n==== Applying Thread Config to Target ====')
-            if not await apply_thread_config(obj_transport, obj_security):
-                raise RuntimeError('Error in apply Thread config')
-            print('==== Apply config sent successfully ====')
+            if await has_capability(obj_transport, 'batch'):
+                print('\n==== Sending and Applying Thread Dataset to Target ====')
+                if not await send_and_apply_config(obj_transport, obj_security, 'thread', args.dataset_tlvs):
+                    raise RuntimeError('Error in send Thread config')
+                print('==== Thread Dataset sent and applied successfully ====')
+            else:
+                print('\n==== Sending Thread Dataset to Target ====')
+                if not await send_thread_config(obj_transport, obj_security, args.dataset_tlvs):
+                    raise RuntimeError('Error in send Thread config')
+                print('==== Thread Dataset sent successfully ====')
+
+                print('\n==== Applying Thread Config to Target ====')
+                if not await apply_thread_config(obj_transport, obj_security):
+                    raise RuntimeError('Error in apply Thread config')
+                print('==== Apply config sent successfully ====')
 
             await wait_thread_connected(obj_transport, obj_security)
         else:
@@ -739,15 +815,21 @@ async def main():
                 prompt_str = 'Enter passphrase for {0} : '.format(args.ssid)
                 args.passphrase = getpass(prompt_str)
 
-            print('\n==== Sending Wi-Fi Credentials to Target ====')
-            if not await send_wifi_config(obj_transport, obj_security, args.ssid, args.passphrase):
-                raise RuntimeError('Error in send Wi-Fi config')
-            print('==== Wi-Fi Credentials sent successfully ====')
-
-            print('\n==== Applying Wi-Fi Config to Target ====')
-            if not await apply_wifi_config(obj_transport, obj_security):
-                raise RuntimeError('Error in apply Wi-Fi config')
-            print('==== Apply config sent successfully ====')
+            if await has_capability(obj_transport, 'batch'):
+                print('\n==== Sending and Applying Wi-Fi Credentials to Target ====')
+                if not await send_and_apply_config(obj_transport, obj_security, 'wifi', args.ssid, args.passphrase):
+                    raise RuntimeError('Error in send Wi-Fi config')
+                print('==== Wi-Fi Credentials sent and applied successfully ====')
+            else:
+                print('\n==== Sending Wi-Fi Credentials to Target ====')
+                if not await send_wifi_config(obj_transport, obj_security, args.ssid, args.passphrase):
+                    raise RuntimeError('Error in send Wi-Fi config')
+                print('==== Wi-Fi Credentials sent successfully ====')
+
+                print('\n==== Applying Wi-Fi Config to Target ====')
+                if not await apply_wifi_config(obj_transport, obj_security):
+                    raise RuntimeError('Error in apply Wi-Fi config')
+                print('==== Apply config sent successfully ====')
 
             await wait_wifi_connected(obj_transport, obj_security)
 
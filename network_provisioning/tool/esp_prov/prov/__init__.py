@@ -6,3 +6,4 @@ from .custom_prov import *  # noqa F403
 from .network_ctrl import *  # noqa F403
 from .network_prov import *  # noqa F403
 from .network_scan import *  # noqa F403
+from .batch import *  # noqa F403
@@ -0,0 +1,54 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+#
+
+# APIs for sending requests to several endpoints in one exchange with the
+# prov-batch endpoint (network_provisioning CONFIG_NETWORK_PROV_BATCH_ENDPOINT)
+
+import struct
+
+from utils import str_to_bytes
+
+BATCH_STATUS = {0: 'ok', 1: 'endpoint not available in batches', 2: 'request failed'}
+
+
+class BatchEntryContext:
+    # Security context of the requests carried by a batch, which is encrypted as a whole
+    def __init__(self, verbose=False):
+        self.verbose = verbose
+
+    def encrypt_data(self, data):
+        return data
+
+    def decrypt_data(self, data):
+        return data
+
+
+def batch_request(security_ctx, requests):
+    # requests: list of (endpoint name, request built with a BatchEntryContext)
+    payload = bytes([len(requests)])
+    for ep_name, request in requests:
+        name = ep_name.encode()
+        data = str_to_bytes(request)
+        payload += bytes([len(name)]) + name + struct.pack('<H', len(data)) + data
+    return security_ctx.encrypt_data(payload).decode('latin-1')
+
+
+def batch_response(security_ctx, response_data):
+    # Returns the responses in the order of the requests, to be interpreted with a BatchEntryContext
+    data = security_ctx.decrypt_data(str_to_bytes(response_data))
+    if len(data) < 1:
+        raise RuntimeError('Invalid batch response')
+    responses = []
+    pos = 1
+    for _ in range(data[0]):
+        if pos + 3 > len(data):
+            raise RuntimeError('Invalid batch response')
+        status = data[pos]
+        length = struct.unpack('<H', data[pos + 1:pos + 3])[0]
+        pos += 3
+        if status != 0:
+            raise RuntimeError(f'Batched request failed: {BATCH_STATUS.get(status, status)}')
+        responses.append(data[pos:pos + length].decode('latin-1'))
+        pos += length
+    return responses
@@ -5,3 +5,4 @@
 from .security0 import *  # noqa: F403, F401
 from .security1 import *  # noqa: F403, F401
 from .security2 import *  # noqa: F403, F401
+from .security2_resume import *  # noqa: F403, F401
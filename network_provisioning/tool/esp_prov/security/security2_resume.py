@@ -0,0 +1,139 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+# APIs for resuming a security2 session with a ticket from the prov-resume
+# endpoint (network_provisioning CONFIG_NETWORK_PROV_SESSION_RESUMPTION)
+import hashlib
+import hmac
+import json
+import os
+import struct
+import time
+from typing import Any
+from typing import Optional
+
+from cryptography.hazmat.primitives.ciphers.aead import AESGCM
+from utils import str_to_bytes
+
+from .security import Security
+
+RESUME_MARKER = 0x00
+RESUME_MSG_REQUEST = 0x01
+RESUME_MSG_RESPONSE = 0x02
+RESUME_TICKET_VERSION = 1
+
+RESUME_ID_LEN = 16
+RESUME_SECRET_LEN = 32
+RESUME_CLIENT_NONCE_LEN = 16
+RESUME_NONCE_LEN = 12
+RESUME_MAC_LEN = 32
+
+RESUME_STATUS = {0: 'ok', 1: 'unknown or expired ticket', 2: 'invalid request MAC'}
+
+
+def _hmac(key: bytes, label: str, *parts: bytes) -> bytes:
+    return hmac.new(key, label.encode() + b''.join(parts), hashlib.sha256).digest()
+
+
+def load_resume_ticket(path: str) -> Optional[dict]:
+    # Return the ticket stored in path, or None if there is none or it has expired
+    try:
+        with open(path, 'r') as f:
+            ticket = json.load(f)
+        if ticket['expires'] <= time.time():
+            return None
+        return {'id': bytes.fromhex(ticket['id']), 'secret': bytes.fromhex(ticket['secret'])}
+    except (OSError, ValueError, KeyError):
+        return None
+
+
+def save_resume_ticket(path: str, ticket: Optional[dict]) -> None:
+    # Store the ticket in path, or remove the stored one if ticket is None
+    if ticket is None:
+        if os.path.exists(path):
+            os.remove(path)
+        return
+    with open(os.open(path, os.O_WRONLY | os.O_CREAT | os.O_TRUNC, 0o600), 'w') as f:
+        json.dump({'id': ticket['id'].hex(), 'secret': ticket['secret'].hex(), 'expires': ticket['expires']}, f)
+
+
+def resume_ticket_request(security_ctx: Any) -> str:
+    # The request content is not used, the endpoint only needs a session
+    return security_ctx.encrypt_data(b'\x01').decode('latin-1')
+
+
+def resume_ticket_response(security_ctx: Any, response_data: str) -> dict:
+    data = security_ctx.decrypt_data(str_to_bytes(response_data))
+    if len(data) != 1 + RESUME_ID_LEN + RESUME_SECRET_LEN + 4 or data[0] != RESUME_TICKET_VERSION:
+        raise RuntimeError('Invalid resumption ticket')
+    ticket_id = data[1:1 + RESUME_ID_LEN]
+    secret = data[1 + RESUME_ID_LEN:1 + RESUME_ID_LEN + RESUME_SECRET_LEN]
+    validity = struct.unpack('<I', data[1 + RESUME_ID_LEN + RESUME_SECRET_LEN:])[0]
+    return {'id': ticket_id, 'secret': secret, 'expires': int(time.time()) + validity}
+
+
+class Security2Resume(Security):
+    def __init__(self, ticket: dict, verbose: bool) -> None:
+        # Initialize state of the resumption FSM
+        self.session_state = 0
+        self.ticket = ticket
+        self.verbose = verbose
+        self.client_nonce = os.urandom(RESUME_CLIENT_NONCE_LEN)
+        self.cipher: Optional[AESGCM] = None
+        self.nonce = bytearray()
+        Security.__init__(self, self.security2_resume_session)
+
+    def security2_resume_session(self, response_data: bytes) -> Any:
+        if (self.session_state == 0):
+            self.session_state = 1
+            return self.resume_request()
+        if (self.session_state == 1):
+            self.session_state = 2
+            self.resume_response(response_data)
+            return None
+
+        print('---- Unexpected state! ----')
+        return None
+
+    def _print_verbose(self, data: str) -> None:
+        if (self.verbose):
+            print(f'\x1b[32;20m++++ {data} ++++\x1b[0m')  # noqa E702
+
+    def resume_request(self) -> Any:
+        ticket_id = self.ticket['id']
+        mac = _hmac(self.ticket['secret'], 'netprov-resume-req', ticket_id, self.client_nonce)
+        request = bytes([RESUME_MARKER, RESUME_MSG_REQUEST]) + ticket_id + self.client_nonce + mac
+        self._print_verbose(f'Resumption ticket id:\t0x{ticket_id.hex()}')
+        return request.decode('latin-1')
+
+    def resume_response(self, response_data: bytes) -> None:
+        data = str_to_bytes(response_data)
+        if len(data) < 3 or data[0] != RESUME_MARKER or data[1] != RESUME_MSG_RESPONSE:
+            raise RuntimeError('Session resumption is not supported by the device')
+        if data[2] != 0:
+            raise RuntimeError(f'Session resumption failed: {RESUME_STATUS.get(data[2], data[2])}')
+        if len(data) != 3 + RESUME_NONCE_LEN + RESUME_MAC_LEN:
+            raise RuntimeError('Invalid session resumption response')
+
+        nonce = data[3:3 + RESUME_NONCE_LEN]
+        session_key = _hmac(self.ticket['secret'], 'netprov-resume-key', self.client_nonce, nonce)
+        device_mac = _hmac(session_key, 'netprov-resume-rsp', self.client_nonce, nonce)
+        if not hmac.compare_digest(device_mac, data[3 + RESUME_NONCE_LEN:]):
+            raise RuntimeError('Failed to verify the device')
+        self._print_verbose(f'Nonce:\t0x{nonce.hex()}')
+        self.nonce = bytearray(nonce)
+        self.cipher = AESGCM(session_key)
+
+    def _increment_nonce(self) -> None:
+        """Increment the last 4 bytes of nonce (big-endian counter)."""
+        counter = (struct.unpack('>I', self.nonce[8:])[0] + 1) & 0xFFFFFFFF
+        self.nonce[8:] = struct.pack('>I', counter)
+
+    def encrypt_data(self, data: bytes) -> Any:
+        ciphertext = self.cipher.encrypt(bytes(self.nonce), data, None)
+        self._increment_nonce()
+        return ciphertext
+
+    def decrypt_data(self, data: bytes) -> Any:
+        plaintext = self.cipher.decrypt(bytes(self.nonce), data, None)
+        self._increment_nonce()
+        return plaintext
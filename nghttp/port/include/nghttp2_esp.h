@@ -0,0 +1,69 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <nghttp2/nghttp2.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Pool allocator of the memory of one session
+ */
+typedef struct nghttp2_esp_mem_pool nghttp2_esp_mem_pool;
+
+/**
+ * @brief Create the options of a session, with the limits of the nghttp2 menuconfig
+ *
+ * Sets the maximum HPACK encoder table size (CONFIG_NGHTTP2_DEFLATE_TABLE_SIZE) and the maximum length of a sent
+ * header block (CONFIG_NGHTTP2_MAX_SEND_HEADER_BLOCK_LENGTH). Further options can be set before passing them to
+ * nghttp2_session_client_new3() or nghttp2_session_server_new3(). Delete them with nghttp2_option_del().
+ *
+ * @param[out] option_ptr Created options
+ *
+ * @return
+ *      - 0 on success
+ *      - NGHTTP2_ERR_NOMEM if there is no memory for the options
+ */
+int nghttp2_esp_option_new(nghttp2_option **option_ptr);
+
+/**
+ * @brief Create a pool allocator for one session
+ *
+ * Pass nghttp2_esp_mem_pool_get_mem() to nghttp2_session_client_new3() or nghttp2_session_server_new3(), and delete
+ * the pool after the session. With CONFIG_NGHTTP2_MEM_POOL disabled, *pool_ptr is set to NULL, and the session uses
+ * the default allocator.
+ *
+ * @note A pool serves one session, and must not be used by several tasks at the same time, as the session itself.
+ *
+ * @param[out] pool_ptr Created pool
+ *
+ * @return
+ *      - 0 on success
+ *      - NGHTTP2_ERR_NOMEM if there is no memory for the pool
+ */
+int nghttp2_esp_mem_pool_new(nghttp2_esp_mem_pool **pool_ptr);
+
+/**
+ * @brief Get the allocator of a pool
+ *
+ * @param[in] pool Pool created by nghttp2_esp_mem_pool_new(), may be NULL
+ *
+ * @return Allocator to pass to nghttp2, NULL for the default allocator if pool is NULL
+ */
+nghttp2_mem *nghttp2_esp_mem_pool_get_mem(nghttp2_esp_mem_pool *pool);
+
+/**
+ * @brief Delete a pool, and return its memory to the heap
+ *
+ * @param[in] pool Pool created by nghttp2_esp_mem_pool_new(), may be NULL. The session using it must be deleted.
+ */
+void nghttp2_esp_mem_pool_del(nghttp2_esp_mem_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,229 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "nghttp2_esp.h"
+
+int nghttp2_esp_option_new(nghttp2_option **option_ptr)
+{
+    int rv = nghttp2_option_new(option_ptr);
+    if (rv != 0) {
+        return rv;
+    }
+    nghttp2_option_set_max_deflate_dynamic_table_size(*option_ptr, CONFIG_NGHTTP2_DEFLATE_TABLE_SIZE);
+    nghttp2_option_set_max_send_header_block_length(*option_ptr, CONFIG_NGHTTP2_MAX_SEND_HEADER_BLOCK_LENGTH);
+    return 0;
+}
+
+#if CONFIG_NGHTTP2_MEM_POOL
+
+static const char *TAG = "nghttp2_esp";
+
+/*
+ * Blocks of 32 to 512 bytes, a power of 2, each one starting with a header giving its size class, and the requested
+ * size for realloc(). Each chunk taken from the heap is divided into blocks of one class, which then go back and
+ * forth between the free list of the class and nghttp2. Larger allocations go to the heap, with the same header.
+ */
+#define POOL_MIN_BLOCK_SHIFT    5
+#define POOL_NUM_CLASSES        5
+#define POOL_MAX_BLOCK_SIZE     (1 << (POOL_MIN_BLOCK_SHIFT + POOL_NUM_CLASSES - 1))
+#define POOL_CLASS_HEAP         UINT32_MAX
+
+typedef struct {
+    uint32_t cls;       /* Size class, or POOL_CLASS_HEAP */
+    uint32_t size;      /* Requested size */
+} pool_block_hdr_t;
+
+typedef struct pool_free_block {
+    struct pool_free_block *next;
+} pool_free_block_t;
+
+typedef struct pool_chunk {
+    struct pool_chunk *next;
+} pool_chunk_t;
+
+/* The blocks of a chunk start after its header, 8-byte aligned */
+#define POOL_CHUNK_HDR_SIZE     8
+_Static_assert(sizeof(pool_chunk_t) <= POOL_CHUNK_HDR_SIZE, "chunk header too large");
+
+struct nghttp2_esp_mem_pool {
+    nghttp2_mem mem;
+    pool_free_block_t *free_blocks[POOL_NUM_CLASSES];
+    pool_chunk_t *chunks;
+    size_t num_chunks;
+};
+
+static inline size_t pool_block_size(uint32_t cls)
+{
+    return (size_t)1 << (POOL_MIN_BLOCK_SHIFT + cls);
+}
+
+/* Smallest class whose blocks hold size bytes after the header, size <= POOL_MAX_BLOCK_SIZE - header */
+static inline uint32_t pool_class(size_t size)
+{
+    size_t total = size + sizeof(pool_block_hdr_t);
+    if (total <= pool_block_size(0)) {
+        return 0;
+    }
+    return (32 - __builtin_clz((unsigned int)(total - 1))) - POOL_MIN_BLOCK_SHIFT;
+}
+
+static bool pool_add_chunk(nghttp2_esp_mem_pool *pool, uint32_t cls)
+{
+    pool_chunk_t *chunk = malloc(CONFIG_NGHTTP2_MEM_POOL_CHUNK_SIZE);
+    if (chunk == NULL) {
+        return false;
+    }
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    pool->num_chunks++;
+
+    const size_t block_size = pool_block_size(cls);
+    uint8_t *block = (uint8_t *)chunk + POOL_CHUNK_HDR_SIZE;
+    uint8_t *end = (uint8_t *)chunk + CONFIG_NGHTTP2_MEM_POOL_CHUNK_SIZE;
+    for (; block + block_size <= end; block += block_size) {
+        pool_free_block_t *free_block = (pool_free_block_t *)block;
+        free_block->next = pool->free_blocks[cls];
+        pool->free_blocks[cls] = free_block;
+    }
+    return true;
+}
+
+static void *pool_malloc(size_t size, void *mem_user_data)
+{
+    nghttp2_esp_mem_pool *pool = mem_user_data;
+    pool_block_hdr_t *hdr;
+
+    if (size > POOL_MAX_BLOCK_SIZE - sizeof(pool_block_hdr_t)) {
+        if (size > UINT32_MAX - sizeof(pool_block_hdr_t)) {
+            return NULL;
+        }
+        hdr = malloc(sizeof(pool_block_hdr_t) + size);
+        if (hdr == NULL) {
+            return NULL;
+        }
+        hdr->cls = POOL_CLASS_HEAP;
+    } else {
+        uint32_t cls = pool_class(size);
+        if (pool->free_blocks[cls] == NULL && !pool_add_chunk(pool, cls)) {
+            return NULL;
+        }
+        hdr = (pool_block_hdr_t *)pool->free_blocks[cls];
+        pool->free_blocks[cls] = pool->free_blocks[cls]->next;
+        hdr->cls = cls;
+    }
+    hdr->size = size;
+    return hdr + 1;
+}
+
+static void pool_free(void *ptr, void *mem_user_data)
+{
+    nghttp2_esp_mem_pool *pool = mem_user_data;
+
+    if (ptr == NULL) {
+        return;
+    }
+    pool_block_hdr_t *hdr = (pool_block_hdr_t *)ptr - 1;
+    if (hdr->cls == POOL_CLASS_HEAP) {
+        free(hdr);
+        return;
+    }
+    uint32_t cls = hdr->cls;
+    pool_free_block_t *free_block = (pool_free_block_t *)hdr;
+    free_block->next = pool->free_blocks[cls];
+    pool->free_blocks[cls] = free_block;
+}
+
+static void *pool_calloc(size_t nmemb, size_t size, void *mem_user_data)
+{
+    if (size && nmemb > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = pool_malloc(nmemb * size, mem_user_data);
+    if (ptr) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+static void *pool_realloc(void *ptr, size_t size, void *mem_user_data)
+{
+    if (ptr == NULL) {
+        return pool_malloc(size, mem_user_data);
+    }
+    pool_block_hdr_t *hdr = (pool_block_hdr_t *)ptr - 1;
+    if (hdr->cls != POOL_CLASS_HEAP && size + sizeof(pool_block_hdr_t) <= pool_block_size(hdr->cls)) {
+        hdr->size = size;
+        return ptr;
+    }
+    void *new_ptr = pool_malloc(size, mem_user_data);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, hdr->size < size ? hdr->size : size);
+    pool_free(ptr, mem_user_data);
+    return new_ptr;
+}
+
+int nghttp2_esp_mem_pool_new(nghttp2_esp_mem_pool **pool_ptr)
+{
+    nghttp2_esp_mem_pool *pool = calloc(1, sizeof(nghttp2_esp_mem_pool));
+    if (pool == NULL) {
+        return NGHTTP2_ERR_NOMEM;
+    }
+    pool->mem = (nghttp2_mem) {
+        .mem_user_data = pool,
+        .malloc = pool_malloc,
+        .free = pool_free,
+        .calloc = pool_calloc,
+        .realloc = pool_realloc,
+    };
+    *pool_ptr = pool;
+    return 0;
+}
+
+nghttp2_mem *nghttp2_esp_mem_pool_get_mem(nghttp2_esp_mem_pool *pool)
+{
+    return pool ? &pool->mem : NULL;
+}
+
+void nghttp2_esp_mem_pool_del(nghttp2_esp_mem_pool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    ESP_LOGD(TAG, "pool of %u chunks deleted", (unsigned int)pool->num_chunks);
+    while (pool->chunks) {
+        pool_chunk_t *chunk = pool->chunks;
+        pool->chunks = chunk->next;
+        free(chunk);
+    }
+    free(pool);
+}
+
+#else
+
+int nghttp2_esp_mem_pool_new(nghttp2_esp_mem_pool **pool_ptr)
+{
+    *pool_ptr = NULL;
+    return 0;
+}
+
+nghttp2_mem *nghttp2_esp_mem_pool_get_mem(nghttp2_esp_mem_pool *pool)
+{
+    return NULL;
+}
+
+void nghttp2_esp_mem_pool_del(nghttp2_esp_mem_pool *pool)
+{
+}
+
+#endif /* CONFIG_NGHTTP2_MEM_POOL */
@@ -74,6 +74,29 @@ esp_err_t onewire_bus_read_bit(onewire_bus_handle_t bus, uint8_t *rx_bit);
  */
 esp_err_t onewire_bus_reset(onewire_bus_handle_t bus);
 
+/**
+ * @brief Run a sequence of reset, write and read operations as one bus transaction
+ *
+ * E.g. reset, match ROM and read scratchpad of a device, or of several devices one after the other.
+ * The RMT backend encodes the whole sequence into a single RMT transmission and decodes the bits read once at the end,
+ * instead of waiting for each call of onewire_bus_reset(), onewire_bus_write_bytes() and onewire_bus_read_bytes().
+ *
+ * @note A missing device doesn't stop the transaction, the bytes read from it are then all 0xFF.
+ *       The RMT backend runs transactions of up to `max_rx_bytes` * 8 time slots at once, counting
+ *       one slot per bit written or read, three per ROM search step and two per reset. Longer transactions
+ *       run operation by operation.
+ *
+ * @param[in] bus 1-Wire bus handle
+ * @param[in] ops operations, in bus order
+ * @param[in] op_count number of operations
+ * @return
+ *      - ESP_OK: All the operations are done and devices answered all the reset pulses
+ *      - ESP_ERR_NOT_FOUND: All the operations are done but no device answered one of the reset pulses
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_FAIL: The transaction failed because of other errors
+ */
+esp_err_t onewire_bus_transaction(onewire_bus_handle_t bus, const onewire_bus_trans_op_t *ops, size_t op_count);
+
 /**
  * @brief Free 1-Wire bus resources
  *
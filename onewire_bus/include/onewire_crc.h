@@ -22,6 +22,18 @@ extern "C" {
  */
 uint8_t onewire_crc8(uint8_t init_crc, uint8_t *input, size_t input_size);
 
+/**
+ * @brief Calculate Dallas CRC16 value of a given buffer, e.g. of an iButton memory page
+ *
+ * @note Devices send the complement of the CRC16, LSB first. The CRC16 of data followed by these two bytes is 0xB001.
+ *
+ * @param[in] init_crc Initial CRC value
+ * @param[in] input Input buffer to calculate CRC value
+ * @param[in] input_size Size of input buffer, in bytes
+ * @return CRC16 result of the input buffer
+ */
+uint16_t onewire_crc16(uint16_t init_crc, const uint8_t *input, size_t input_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 #include "esp_err.h"
 #include "onewire_types.h"
 
@@ -58,6 +59,66 @@ esp_err_t onewire_del_device_iter(onewire_device_iter_handle_t iter);
  */
 esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewire_device_t *dev);
 
+/**
+ * @brief Check if a device is attached to the bus
+ *
+ * @note This runs the ROM search in the direction of the address, in a single bus transaction
+ *       if the RMT backend has `max_rx_bytes` of at least 26, which is much faster than a ROM search
+ *       that has to read and write the bits one by one.
+ *
+ * @param[in] bus 1-Wire bus handle
+ * @param[in] address Address of the device
+ * @return
+ *      - ESP_OK: The device is attached to the bus
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_NOT_FOUND: The device is not attached to the bus
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t onewire_device_verify(onewire_bus_handle_t bus, onewire_device_address_t address);
+
+/**
+ * @brief Get the addresses of all the devices on the bus, reusing a list of addresses enumerated before
+ *
+ * If `*count` is not 0, `addresses` holds the addresses found by a previous enumeration, e.g. saved in NVS.
+ * They are checked with onewire_device_verify(), and if all the devices are still attached this is the result.
+ * Otherwise, or if `*count` is 0, the devices are enumerated again with a ROM search.
+ *
+ * @note A device added to the bus since the previous enumeration is not found as long as all the listed devices
+ *       are attached. Pass `*count` 0 to force a ROM search.
+ *
+ * @param[in] bus 1-Wire bus handle
+ * @param[inout] addresses Addresses of the devices, at least `max_count`
+ * @param[in] max_count Largest number of devices expected on the bus
+ * @param[inout] count Number of addresses listed before, and number of devices found
+ * @return
+ *      - ESP_OK: Get the addresses successfully, possibly none
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_INVALID_SIZE: More than `max_count` devices on the bus, the first `max_count` are returned
+ *      - ESP_ERR_INVALID_CRC: Bad device address received during the ROM search
+ *      - ESP_FAIL: Other errors
+ */
+esp_err_t onewire_device_enumerate_cached(onewire_bus_handle_t bus, onewire_device_address_t *addresses, size_t max_count, size_t *count);
+
+/**
+ * @brief Enumerate the devices of several buses at the same time
+ *
+ * Runs onewire_device_enumerate_cached() for every bus in its own task, so that the time taken is the one of the
+ * busiest bus instead of the sum of all the buses.
+ *
+ * @param[in] buses 1-Wire bus handles
+ * @param[in] bus_count Number of buses
+ * @param[inout] addresses Addresses of the devices, `max_count` for each bus one after the other
+ * @param[in] max_count Largest number of devices expected on a bus
+ * @param[inout] counts Number of addresses listed before, and number of devices found, for each bus
+ * @return
+ *      - ESP_OK: Get the addresses of all the buses successfully
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_NO_MEM: No memory to create the tasks
+ *      - Error of onewire_device_enumerate_cached() for the first bus that failed, the other buses are still done
+ */
+esp_err_t onewire_device_enumerate_buses(const onewire_bus_handle_t *buses, size_t bus_count, onewire_device_address_t *addresses,
+                                         size_t max_count, size_t *counts);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,28 @@ typedef struct {
     } flags; /*!< Configuration flags for the bus */
 } onewire_bus_config_t;
 
+/**
+ * @brief Type of 1-Wire transaction operation
+ */
+typedef enum {
+    ONEWIRE_BUS_TRANS_OP_RESET, /*!< Send a reset pulse and check the presence pulse */
+    ONEWIRE_BUS_TRANS_OP_WRITE, /*!< Write bytes */
+    ONEWIRE_BUS_TRANS_OP_READ,  /*!< Read bytes */
+    ONEWIRE_BUS_TRANS_OP_SEARCH, /*!< ROM search steps in a known direction: for each bit of the data to write,
+                                      read a bit and its complement, then write the bit */
+} onewire_bus_trans_op_type_t;
+
+/**
+ * @brief 1-Wire transaction operation, see onewire_bus_transaction()
+ */
+typedef struct {
+    onewire_bus_trans_op_type_t type; /*!< Type of the operation */
+    const uint8_t *tx_data;           /*!< Data to write, for ONEWIRE_BUS_TRANS_OP_WRITE and ONEWIRE_BUS_TRANS_OP_SEARCH */
+    uint8_t *rx_buf;                  /*!< Buffer for the data read, for ONEWIRE_BUS_TRANS_OP_READ, or of `size` * 2 bytes
+                                           for the bits and complements read by ONEWIRE_BUS_TRANS_OP_SEARCH, LSB first */
+    size_t size;                      /*!< Number of bytes to write or read, not used for ONEWIRE_BUS_TRANS_OP_RESET */
+} onewire_bus_trans_op_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -68,6 +68,24 @@ struct onewire_bus_t {
      */
     esp_err_t (*read_bit)(onewire_bus_handle_t handle, uint8_t *rx_bit);
 
+    /**
+     * @brief Run a sequence of reset, write and read operations as one bus transaction
+     *
+     * @note Optional, onewire_bus_transaction() runs the operations one by one if not implemented,
+     *       or if this returns ESP_ERR_NOT_SUPPORTED
+     *
+     * @param[in] bus 1-Wire bus handle
+     * @param[in] ops operations, in bus order
+     * @param[in] op_count number of operations
+     * @return
+     *      - ESP_OK: All the operations are done and devices answered all the reset pulses
+     *      - ESP_ERR_NOT_FOUND: All the operations are done but no device answered one of the reset pulses
+     *      - ESP_ERR_INVALID_ARG: Invalid argument
+     *      - ESP_ERR_NOT_SUPPORTED: The backend can't run this transaction at once, e.g. it's too long
+     *      - ESP_FAIL: The transaction failed because of other errors
+     */
+    esp_err_t (*transaction)(onewire_bus_t *bus, const onewire_bus_trans_op_t *ops, size_t op_count);
+
     /**
      * @brief Send reset pulse to the bus, and check if there are devices attached to the bus
      *
@@ -3,6 +3,7 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <string.h>
 #include "esp_log.h"
 #include "esp_check.h"
 #include "onewire_types.h"
@@ -40,6 +41,69 @@ esp_err_t onewire_bus_read_bit(onewire_bus_handle_t bus, uint8_t *rx_bit)
     return bus->read_bit(bus, rx_bit);
 }
 
+esp_err_t onewire_bus_transaction(onewire_bus_handle_t bus, const onewire_bus_trans_op_t *ops, size_t op_count)
+{
+    ESP_RETURN_ON_FALSE(bus && ops && op_count, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < op_count; i++) {
+        const onewire_bus_trans_op_t *op = &ops[i];
+        ESP_RETURN_ON_FALSE((op->type == ONEWIRE_BUS_TRANS_OP_RESET) ||
+                            (op->type == ONEWIRE_BUS_TRANS_OP_WRITE && op->tx_data && op->size) ||
+                            (op->type == ONEWIRE_BUS_TRANS_OP_READ && op->rx_buf && op->size) ||
+                            (op->type == ONEWIRE_BUS_TRANS_OP_SEARCH && op->tx_data && op->rx_buf && op->size),
+                            ESP_ERR_INVALID_ARG, TAG, "invalid operation %u", (unsigned)i);
+    }
+    if (bus->transaction) {
+        esp_err_t ret = bus->transaction(bus, ops, op_count);
+        if (ret != ESP_ERR_NOT_SUPPORTED) {
+            return ret;
+        }
+    }
+
+    // the backend can't do it in one go, run the operations one by one
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < op_count; i++) {
+        const onewire_bus_trans_op_t *op = &ops[i];
+        esp_err_t err;
+        switch (op->type) {
+        case ONEWIRE_BUS_TRANS_OP_RESET:
+            err = bus->reset(bus);
+            if (err == ESP_ERR_NOT_FOUND) {
+                ret = err;
+                err = ESP_OK;
+            }
+            break;
+        case ONEWIRE_BUS_TRANS_OP_WRITE:
+            err = ESP_OK;
+            for (size_t done = 0; done < op->size && err == ESP_OK; done += UINT8_MAX) {
+                size_t chunk = op->size - done < UINT8_MAX ? op->size - done : UINT8_MAX;
+                err = bus->write_bytes(bus, op->tx_data + done, (uint8_t)chunk);
+            }
+            break;
+        case ONEWIRE_BUS_TRANS_OP_READ:
+            err = bus->read_bytes(bus, op->rx_buf, op->size);
+            break;
+        default:
+            err = ESP_OK;
+            memset(op->rx_buf, 0, op->size * 2);
+            for (size_t bit = 0; bit < op->size * 8 && err == ESP_OK; bit++) {
+                uint8_t rx_bit = 0;
+                uint8_t rx_bit_complement = 0;
+                err = bus->read_bit(bus, &rx_bit);
+                if (err == ESP_OK) {
+                    err = bus->read_bit(bus, &rx_bit_complement);
+                }
+                if (err == ESP_OK) {
+                    err = bus->write_bit(bus, op->tx_data[bit / 8] & (1 << (bit % 8)));
+                }
+                op->rx_buf[bit / 4] |= (rx_bit | rx_bit_complement << 1) << (bit % 4 * 2);
+            }
+            break;
+        }
+        ESP_RETURN_ON_ERROR(err, TAG, "operation %u failed", (unsigned)i);
+    }
+    return ret;
+}
+
 esp_err_t onewire_bus_del(onewire_bus_handle_t bus)
 {
     ESP_RETURN_ON_FALSE(bus, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
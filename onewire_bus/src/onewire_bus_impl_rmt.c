@@ -112,6 +112,10 @@ Read 0 bit:
 #define ONEWIRE_SLOT_RECOVERY_DURATION          5  // recovery time between each bit, should be longer in parasite power mode
 #define ONEWIRE_SLOT_BIT_SAMPLE_TIME            15 // how long after bit start pulse should the master sample from the bus
 
+// in a transaction the next time slot follows the reset pulse directly, so wait until the end of the presence pulse,
+// but less than signal_range_max_ns, which ends the receive
+#define ONEWIRE_TRANS_RESET_WAIT_DURATION       480
+
 typedef struct {
     onewire_bus_t base; /*!< base class */
     rmt_channel_handle_t tx_channel; /*!< rmt tx channel handler */
@@ -123,6 +127,7 @@ typedef struct {
     rmt_encoder_handle_t tx_copy_encoder; /*!< used to encode reset pulse and bits */
 
     rmt_symbol_word_t *rx_symbols_buf; /*!< hold rmt raw symbols */
+    rmt_symbol_word_t *tx_symbols_buf; /*!< hold the symbols of a transaction */
 
     size_t max_rx_bytes; /*!< buffer size in byte for single receive transaction */
 
@@ -137,6 +142,13 @@ static rmt_symbol_word_t onewire_reset_pulse_symbol = {
     .duration1 = ONEWIRE_RESET_WAIT_DURATION
 };
 
+static rmt_symbol_word_t onewire_trans_reset_pulse_symbol = {
+    .level0 = 0,
+    .duration0 = ONEWIRE_RESET_PULSE_DURATION,
+    .level1 = 1,
+    .duration1 = ONEWIRE_TRANS_RESET_WAIT_DURATION
+};
+
 static rmt_symbol_word_t onewire_bit0_symbol = {
     .level0 = 0,
     .duration0 = ONEWIRE_SLOT_START_DURATION + ONEWIRE_SLOT_BIT_DURATION,
@@ -166,6 +178,7 @@ static esp_err_t onewire_bus_rmt_write_bit(onewire_bus_handle_t bus, uint8_t tx_
 static esp_err_t onewire_bus_rmt_read_bytes(onewire_bus_handle_t bus, uint8_t *rx_buf, size_t rx_buf_size);
 static esp_err_t onewire_bus_rmt_write_bytes(onewire_bus_handle_t bus, const uint8_t *tx_data, uint8_t tx_data_size);
 static esp_err_t onewire_bus_rmt_reset(onewire_bus_handle_t bus);
+static esp_err_t onewire_bus_rmt_transaction(onewire_bus_handle_t bus, const onewire_bus_trans_op_t *ops, size_t op_count);
 static esp_err_t onewire_bus_rmt_del(onewire_bus_handle_t bus);
 static esp_err_t onewire_bus_rmt_destroy(onewire_bus_rmt_obj_t *bus_rmt);
 
@@ -250,6 +263,34 @@ static void onewire_rmt_decode_data(rmt_symbol_word_t *rmt_symbols, size_t symbo
     }
 }
 
+/*
+Finds the next low pulse in the received symbols, from the half symbol at *pos, and returns the duration of the
+high level before it and its duration. Returns false at the end of the received signal.
+*/
+static bool onewire_rmt_next_low_pulse(const rmt_symbol_word_t *rmt_symbols, size_t symbol_num, size_t *pos,
+                                       uint32_t *high_duration, uint32_t *low_duration)
+{
+    *high_duration = 0;
+    *low_duration = 0;
+    for (; *pos < symbol_num * 2; (*pos)++) {
+        const rmt_symbol_word_t *symbol = &rmt_symbols[*pos / 2];
+        uint32_t level = (*pos % 2) ? symbol->level1 : symbol->level0;
+        uint32_t duration = (*pos % 2) ? symbol->duration1 : symbol->duration0;
+        if (duration == 0) { // end marker
+            break;
+        }
+        if (level) {
+            if (*low_duration) {
+                return true;
+            }
+            *high_duration += duration;
+        } else {
+            *low_duration += duration;
+        }
+    }
+    return *low_duration > 0;
+}
+
 esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onewire_bus_rmt_config_t *rmt_config, onewire_bus_handle_t *ret_bus)
 {
     esp_err_t ret = ESP_OK;
@@ -315,6 +356,9 @@ esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onew
     // allocate rmt rx symbol buffer, one RMT symbol represents one bit, so x8
     bus_rmt->rx_symbols_buf = malloc(rmt_config->max_rx_bytes * sizeof(rmt_symbol_word_t) * 8);
     ESP_GOTO_ON_FALSE(bus_rmt->rx_symbols_buf, ESP_ERR_NO_MEM, err, TAG, "no mem to store received RMT symbols");
+    // a transaction transmits at most one symbol per received symbol
+    bus_rmt->tx_symbols_buf = malloc(rmt_config->max_rx_bytes * sizeof(rmt_symbol_word_t) * 8);
+    ESP_GOTO_ON_FALSE(bus_rmt->tx_symbols_buf, ESP_ERR_NO_MEM, err, TAG, "no mem to store transaction RMT symbols");
     bus_rmt->max_rx_bytes = rmt_config->max_rx_bytes;
 
     bus_rmt->receive_queue = xQueueCreate(1, sizeof(rmt_rx_done_event_data_t));
@@ -350,6 +394,7 @@ esp_err_t onewire_new_bus_rmt(const onewire_bus_config_t *bus_config, const onew
     bus_rmt->base.write_bytes = onewire_bus_rmt_write_bytes;
     bus_rmt->base.read_bit = onewire_bus_rmt_read_bit;
     bus_rmt->base.read_bytes = onewire_bus_rmt_read_bytes;
+    bus_rmt->base.transaction = onewire_bus_rmt_transaction;
     *ret_bus = &bus_rmt->base;
 
     return ret;
@@ -387,6 +432,9 @@ static esp_err_t onewire_bus_rmt_destroy(onewire_bus_rmt_obj_t *bus_rmt)
     if (bus_rmt->rx_symbols_buf) {
         free(bus_rmt->rx_symbols_buf);
     }
+    if (bus_rmt->tx_symbols_buf) {
+        free(bus_rmt->tx_symbols_buf);
+    }
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(6, 0, 0)
     if (bus_rmt->data_gpio_num != GPIO_NUM_NC) {
         gpio_od_disable(bus_rmt->data_gpio_num);
@@ -519,3 +567,110 @@ err:
     xSemaphoreGive(bus_rmt->bus_mutex);
     return ret;
 }
+
+// one time slot per bit, three per ROM search step, and two for the reset and presence pulses
+static size_t onewire_trans_op_slot_num(const onewire_bus_trans_op_t *op)
+{
+    switch (op->type) {
+    case ONEWIRE_BUS_TRANS_OP_RESET:
+        return 2;
+    case ONEWIRE_BUS_TRANS_OP_SEARCH:
+        return op->size * 8 * 3;
+    default:
+        return op->size * 8;
+    }
+}
+
+// The whole transaction is encoded into one RMT transmission, read bits being 1 bits,
+// while the receive channel records it, then the received low pulses are matched to the time slots.
+static esp_err_t onewire_bus_rmt_transaction(onewire_bus_handle_t bus, const onewire_bus_trans_op_t *ops, size_t op_count)
+{
+    onewire_bus_rmt_obj_t *bus_rmt = __containerof(bus, onewire_bus_rmt_obj_t, base);
+    esp_err_t ret = ESP_OK;
+
+    size_t slot_num = 0;
+    for (size_t i = 0; i < op_count; i++) {
+        slot_num += onewire_trans_op_slot_num(&ops[i]);
+    }
+    // onewire_bus_transaction() then runs the operations one by one
+    if (slot_num > bus_rmt->max_rx_bytes * 8) {
+        ESP_LOGD(TAG, "transaction of %u slots too long for max_rx_bytes", (unsigned)slot_num);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    xSemaphoreTake(bus_rmt->bus_mutex, portMAX_DELAY);
+
+    rmt_symbol_word_t *tx_symbols = bus_rmt->tx_symbols_buf;
+    size_t tx_symbol_num = 0;
+    for (size_t i = 0; i < op_count; i++) {
+        const onewire_bus_trans_op_t *op = &ops[i];
+        if (op->type == ONEWIRE_BUS_TRANS_OP_RESET) {
+            tx_symbols[tx_symbol_num++] = onewire_trans_reset_pulse_symbol;
+            continue;
+        }
+        for (size_t bit = 0; bit < op->size * 8; bit++) {
+            // LSB first, reading is writing 1 bits
+            if (op->type == ONEWIRE_BUS_TRANS_OP_SEARCH) {
+                tx_symbols[tx_symbol_num++] = onewire_bit1_symbol;
+                tx_symbols[tx_symbol_num++] = onewire_bit1_symbol;
+            }
+            bool bit1 = op->type == ONEWIRE_BUS_TRANS_OP_READ || (op->tx_data[bit / 8] & (1 << (bit % 8)));
+            tx_symbols[tx_symbol_num++] = bit1 ? onewire_bit1_symbol : onewire_bit0_symbol;
+        }
+    }
+
+    ESP_GOTO_ON_ERROR(rmt_receive(bus_rmt->rx_channel, bus_rmt->rx_symbols_buf, slot_num * sizeof(rmt_symbol_word_t), &onewire_rmt_rx_config),
+                      err, TAG, "1-wire transaction receive failed");
+    ESP_GOTO_ON_ERROR(rmt_transmit(bus_rmt->tx_channel, bus_rmt->tx_copy_encoder, tx_symbols, tx_symbol_num * sizeof(rmt_symbol_word_t), &onewire_rmt_tx_config),
+                      err, TAG, "1-wire transaction transmit failed");
+
+    // wait the transaction finishes, a time slot takes less than 70us and a reset 1ms
+    rmt_rx_done_event_data_t rmt_rx_evt_data;
+    ESP_GOTO_ON_FALSE(xQueueReceive(bus_rmt->receive_queue, &rmt_rx_evt_data, pdMS_TO_TICKS(1000 + slot_num / 2)) == pdPASS,
+                      ESP_ERR_TIMEOUT, err, TAG, "1-wire transaction receive timeout");
+
+    size_t pos = 0;
+    uint32_t high_duration, low_duration;
+    for (size_t i = 0; i < op_count; i++) {
+        const onewire_bus_trans_op_t *op = &ops[i];
+        if (op->type == ONEWIRE_BUS_TRANS_OP_RESET) {
+            ESP_GOTO_ON_FALSE(onewire_rmt_next_low_pulse(rmt_rx_evt_data.received_symbols, rmt_rx_evt_data.num_symbols, &pos,
+                              &high_duration, &low_duration) && low_duration > ONEWIRE_RESET_PULSE_DURATION / 2,
+                              ESP_FAIL, err, TAG, "1-wire reset pulse not received");
+            // the presence pulse starts shortly after the reset pulse, otherwise the low pulse is the next time slot
+            size_t slot_pos = pos;
+            if (!onewire_rmt_next_low_pulse(rmt_rx_evt_data.received_symbols, rmt_rx_evt_data.num_symbols, &pos,
+                                            &high_duration, &low_duration) ||
+                    high_duration <= ONEWIRE_RESET_PRESENCE_WAIT_DURATION_MIN || high_duration >= ONEWIRE_RESET_WAIT_DURATION ||
+                    low_duration <= ONEWIRE_RESET_PRESENCE_DURATION_MIN) {
+                pos = slot_pos;
+                ret = ESP_ERR_NOT_FOUND;
+            }
+            continue;
+        }
+        if (op->type == ONEWIRE_BUS_TRANS_OP_READ) {
+            memset(op->rx_buf, 0, op->size);
+        } else if (op->type == ONEWIRE_BUS_TRANS_OP_SEARCH) {
+            memset(op->rx_buf, 0, op->size * 2);
+        }
+        size_t op_slot_num = onewire_trans_op_slot_num(op);
+        for (size_t slot = 0; slot < op_slot_num; slot++) {
+            ESP_GOTO_ON_FALSE(onewire_rmt_next_low_pulse(rmt_rx_evt_data.received_symbols, rmt_rx_evt_data.num_symbols, &pos,
+                              &high_duration, &low_duration), ESP_FAIL, err, TAG, "1-wire time slot not received");
+            if (low_duration > ONEWIRE_SLOT_BIT_SAMPLE_TIME) {
+                continue;
+            }
+            if (op->type == ONEWIRE_BUS_TRANS_OP_READ) {
+                op->rx_buf[slot / 8] |= 1 << (slot % 8);
+            } else if (op->type == ONEWIRE_BUS_TRANS_OP_SEARCH && slot % 3 != 2) {
+                // the bit and its complement, the third slot writes the direction
+                size_t rx_bit = slot / 3 * 2 + slot % 3;
+                op->rx_buf[rx_bit / 8] |= 1 << (rx_bit % 8);
+            }
+        }
+    }
+
+err:
+    xSemaphoreGive(bus_rmt->bus_mutex);
+    return ret;
+}
@@ -5,6 +5,9 @@
  */
 #include <string.h>
 #include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "esp_check.h"
 #include "esp_log.h"
 #include "onewire_bus.h"
@@ -16,11 +19,22 @@ static const char *TAG = "1-wire.device";
 
 typedef struct onewire_device_iter_t {
     onewire_bus_handle_t bus;
-    uint16_t last_discrepancy;
+    uint16_t last_discrepancy; // 1-based bit position of the last discrepancy searched for 0, 0 if none
     bool is_last_device;
     uint8_t rom_number[sizeof(onewire_device_address_t)];
 } onewire_device_iter_t;
 
+typedef struct {
+    onewire_bus_handle_t bus;
+    onewire_device_address_t *addresses;
+    size_t max_count;
+    size_t *count;
+    esp_err_t err;
+    SemaphoreHandle_t done;
+} onewire_device_enumerate_task_arg_t;
+
+#define ONEWIRE_DEVICE_ENUMERATE_TASK_STACK_SIZE 3072
+
 esp_err_t onewire_new_device_iter(onewire_bus_handle_t bus, onewire_device_iter_handle_t *ret_iter)
 {
     ESP_RETURN_ON_FALSE(bus && ret_iter, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
@@ -85,14 +99,14 @@ esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewir
         if (rom_bit != rom_bit_complement) { // There are only 0s or 1s in the bit of the participating ROM numbers.
             search_direction = rom_bit;  // just go ahead
         } else { // There are both 0s and 1s in the current bit position of the participating ROM numbers. This is a discrepancy.
-            if (rom_bit_index < iter->last_discrepancy) { // current id bit is before the last discrepancy bit
+            if (rom_bit_index + 1 < iter->last_discrepancy) { // current id bit is before the last discrepancy bit
                 search_direction = (iter->rom_number[rom_byte_index] & rom_bit_mask) ? 0x01 : 0x00; // follow previous way
             } else {
-                search_direction = (rom_bit_index == iter->last_discrepancy) ? 0x01 : 0x00; // search for 0 bit first
+                search_direction = (rom_bit_index + 1 == iter->last_discrepancy) ? 0x01 : 0x00; // search for 0 bit first
             }
 
             if (search_direction == 0) { // record zero's position in last zero
-                last_zero = rom_bit_index;
+                last_zero = rom_bit_index + 1;
             }
         }
 
@@ -122,3 +136,123 @@ esp_err_t onewire_device_iter_get_next(onewire_device_iter_handle_t iter, onewir
 
     return ESP_OK;
 }
+
+esp_err_t onewire_device_verify(onewire_bus_handle_t bus, onewire_device_address_t address)
+{
+    ESP_RETURN_ON_FALSE(bus, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    uint8_t rom_number[sizeof(onewire_device_address_t)];
+    memcpy(rom_number, &address, sizeof(rom_number));
+    // the bit and its complement read for every bit of the ROM number
+    uint8_t rom_bits[sizeof(rom_number) * 2];
+    const onewire_bus_trans_op_t ops[] = {
+        { .type = ONEWIRE_BUS_TRANS_OP_RESET },
+        { .type = ONEWIRE_BUS_TRANS_OP_WRITE, .tx_data = (const uint8_t[]) { ONEWIRE_CMD_SEARCH_NORMAL }, .size = 1 },
+        { .type = ONEWIRE_BUS_TRANS_OP_SEARCH, .tx_data = rom_number, .rx_buf = rom_bits, .size = sizeof(rom_number) },
+    };
+    esp_err_t ret = onewire_bus_transaction(bus, ops, sizeof(ops) / sizeof(ops[0]));
+    if (ret == ESP_ERR_NOT_FOUND) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "rom search transaction failed");
+
+    // Following the address, the devices with another address leave the search. The device is there if some devices
+    // still participate in the search at every bit, and none of them has only the other bit value.
+    for (uint16_t rom_bit_index = 0; rom_bit_index < sizeof(rom_number) * 8; rom_bit_index ++) {
+        uint8_t bits = (rom_bits[rom_bit_index / 4] >> (rom_bit_index % 4 * 2)) & 0x03;
+        uint8_t rom_bit = (rom_number[rom_bit_index / 8] >> (rom_bit_index % 8)) & 0x01;
+        if (bits == 0x03 || (bits != 0x00 && (bits & 0x01) != rom_bit)) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t onewire_device_enumerate_cached(onewire_bus_handle_t bus, onewire_device_address_t *addresses, size_t max_count, size_t *count)
+{
+    ESP_RETURN_ON_FALSE(bus && addresses && max_count && count && *count <= max_count, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    size_t verified = 0;
+    while (verified < *count) {
+        esp_err_t ret = onewire_device_verify(bus, addresses[verified]);
+        if (ret == ESP_ERR_NOT_FOUND) {
+            ESP_LOGD(TAG, "1-Wire device %016llX gone, new rom search", addresses[verified]);
+            break;
+        }
+        ESP_RETURN_ON_ERROR(ret, TAG, "verify device failed");
+        verified++;
+    }
+    if (*count > 0 && verified == *count) {
+        return ESP_OK;
+    }
+
+    *count = 0;
+    onewire_device_iter_handle_t iter;
+    ESP_RETURN_ON_ERROR(onewire_new_device_iter(bus, &iter), TAG, "create device iterator failed");
+    esp_err_t ret = ESP_OK;
+    onewire_device_t dev;
+    while ((ret = onewire_device_iter_get_next(iter, &dev)) == ESP_OK) {
+        if (*count == max_count) {
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+        addresses[(*count)++] = dev.address;
+    }
+    onewire_del_device_iter(iter);
+    // the iterator ends with ESP_ERR_NOT_FOUND, also if there's no device at all
+    if (ret == ESP_ERR_NOT_FOUND) {
+        ret = ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(ret, TAG, "rom search failed");
+    return ESP_OK;
+}
+
+static void onewire_device_enumerate_task(void *arg)
+{
+    onewire_device_enumerate_task_arg_t *task_arg = (onewire_device_enumerate_task_arg_t *)arg;
+    task_arg->err = onewire_device_enumerate_cached(task_arg->bus, task_arg->addresses, task_arg->max_count, task_arg->count);
+    xSemaphoreGive(task_arg->done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t onewire_device_enumerate_buses(const onewire_bus_handle_t *buses, size_t bus_count, onewire_device_address_t *addresses,
+                                         size_t max_count, size_t *counts)
+{
+    ESP_RETURN_ON_FALSE(buses && bus_count && addresses && max_count && counts, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    esp_err_t ret = ESP_OK;
+    size_t tasks = 0;
+    onewire_device_enumerate_task_arg_t *task_args = calloc(bus_count, sizeof(onewire_device_enumerate_task_arg_t));
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(bus_count, 0);
+    ESP_GOTO_ON_FALSE(task_args && done, ESP_ERR_NO_MEM, err, TAG, "no mem for enumeration tasks");
+
+    for (size_t i = 0; i < bus_count; i++) {
+        onewire_device_enumerate_task_arg_t *task_arg = &task_args[i];
+        task_arg->bus = buses[i];
+        task_arg->addresses = addresses + i * max_count;
+        task_arg->max_count = max_count;
+        task_arg->count = &counts[i];
+        task_arg->done = done;
+        if (xTaskCreate(onewire_device_enumerate_task, "1-wire enum", ONEWIRE_DEVICE_ENUMERATE_TASK_STACK_SIZE, task_arg,
+                        uxTaskPriorityGet(NULL), NULL) == pdPASS) {
+            tasks++;
+        } else {
+            // enumerate the bus from here instead, while the other tasks run
+            ESP_LOGD(TAG, "no mem for enumeration task, enumerate bus %u in calling task", (unsigned)i);
+            task_arg->err = onewire_device_enumerate_cached(task_arg->bus, task_arg->addresses, max_count, task_arg->count);
+        }
+    }
+    for (size_t i = 0; i < tasks; i++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    for (size_t i = 0; i < bus_count && ret == ESP_OK; i++) {
+        ret = task_args[i].err;
+    }
+
+err:
+    if (done) {
+        vSemaphoreDelete(done);
+    }
+    free(task_args);
+    return ret;
+}
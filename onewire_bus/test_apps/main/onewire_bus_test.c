@@ -3,18 +3,73 @@
  *
  * SPDX-License-Identifier: Unlicense OR CC0-1.0
  */
+#include <inttypes.h>
 #include "esp_log.h"
 #include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_rom_crc.h"
 #include "onewire_bus.h"
 #include "onewire_device.h"
+#include "onewire_crc.h"
 
 static const char *TAG = "test-app";
 
 #define EXAMPLE_ONEWIRE_BUS_GPIO    0
 #define EXAMPLE_ONEWIRE_MAX_DEVICES 2
 
+#define CRC_BENCH_SCRATCHPADS       100 // e.g. a large bus of DS18B20
+#define CRC_BENCH_PAGES             32  // iButton memory pages of 32 bytes
+#define CRC_BENCH_ROUNDS            100
+
+// The ROM CRC functions use other polynomials, they are only a reference for the speed
+static void crc_benchmark(void)
+{
+    static uint8_t data[CRC_BENCH_PAGES * 32];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = i * 37 + 11;
+    }
+    volatile uint32_t sink = 0;
+
+    int64_t start = esp_timer_get_time();
+    for (int r = 0; r < CRC_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < CRC_BENCH_SCRATCHPADS; i++) {
+            sink += onewire_crc8(0, &data[i * 9], 8);
+        }
+    }
+    int64_t crc8_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int r = 0; r < CRC_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < CRC_BENCH_SCRATCHPADS; i++) {
+            sink += esp_rom_crc8_le(0, &data[i * 9], 8);
+        }
+    }
+    int64_t rom_crc8_us = esp_timer_get_time() - start;
+
+    start = esp_timer_get_time();
+    for (int r = 0; r < CRC_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < CRC_BENCH_PAGES; i++) {
+            sink += onewire_crc16(0, &data[i * 32], 32);
+        }
+    }
+    int64_t crc16_us = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int r = 0; r < CRC_BENCH_ROUNDS; r++) {
+        for (int i = 0; i < CRC_BENCH_PAGES; i++) {
+            sink += esp_rom_crc16_le(0, &data[i * 32], 32);
+        }
+    }
+    int64_t rom_crc16_us = esp_timer_get_time() - start;
+
+    ESP_LOGI(TAG, "CRC8 of %d scratchpads: %" PRIi64 " us, ROM CRC8: %" PRIi64 " us",
+             CRC_BENCH_SCRATCHPADS, crc8_us / CRC_BENCH_ROUNDS, rom_crc8_us / CRC_BENCH_ROUNDS);
+    ESP_LOGI(TAG, "CRC16 of %d pages: %" PRIi64 " us, ROM CRC16: %" PRIi64 " us",
+             CRC_BENCH_PAGES, crc16_us / CRC_BENCH_ROUNDS, rom_crc16_us / CRC_BENCH_ROUNDS);
+}
+
 void app_main(void)
 {
+    crc_benchmark();
+
     // install new 1-wire bus
     onewire_bus_handle_t bus;
     onewire_bus_config_t bus_config = {
@@ -5,6 +5,8 @@ from pytest_embedded import Dut
 
 @pytest.mark.generic
 def test_onewire_bus(dut: Dut) -> None:
+    dut.expect(r'test-app: CRC8 of \d+ scratchpads: \d+ us')
+    dut.expect(r'test-app: CRC16 of \d+ pages: \d+ us')
     dut.expect_exact('test-app: 1-Wire bus installed on GPIO')
     dut.expect_exact('test-app: Device iterator created, start searching')
     dut.expect_exact('test-app: Searching done')
@@ -6,7 +6,10 @@
 #pragma once
 
 #include <stdio.h>
+#include <stdint.h>
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "pcap_sink.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,6 +18,7 @@ extern "C" {
 #define PCAP_DEFAULT_VERSION_MAJOR 0x02 /*!< Major Version */
 #define PCAP_DEFAULT_VERSION_MINOR 0x04 /*!< Minor Version */
 #define PCAP_DEFAULT_TIME_ZONE_GMT 0x00 /*!< Time Zone */
+#define PCAP_DEFAULT_SNAPLEN 0x40000    /*!< Max Length to Capture */
 
 /**
  * @brief Type of pcap file handle
@@ -51,14 +55,92 @@ typedef enum {
 */
 typedef struct {
     FILE *fp;                   /*!< Pointer to a standard file handle */
+    pcap_sink_handle_t sink;    /*!< Sink of the capture when fp is NULL, e.g. created by `pcap_new_net_sink()` */
     unsigned int major_version; /*!< Pcap version: major */
     unsigned int minor_version; /*!< Pcap version: minor */
     unsigned int time_zone;     /*!< Pcap timezone code */
+    uint32_t snaplen;           /*!< Max length of the captured packets, longer packets are truncated and keep their
+                                     original length in the file. 0 for PCAP_DEFAULT_SNAPLEN */
     struct {
-        unsigned int little_endian: 1; /*!< Whether the pcap file is recorded in little endian format */
+        unsigned int little_endian: 1; /*!< Whether the pcap file is recorded in little endian format, pcapng files
+                                            are always in host order */
+        unsigned int pcapng: 1;        /*!< Write a pcapng file instead of a pcap file */
+        unsigned int nanosecond: 1;    /*!< Record timestamps with nanosecond instead of microsecond resolution */
     } flags;
 } pcap_config_t;
 
+/**
+* @brief Pcap writer task configuration Type Definition
+*
+*/
+typedef struct {
+    size_t ring_size;           /*!< Size of the ring buffer queuing the captured packets, in bytes */
+    size_t write_size;          /*!< Size of the writes to the file, e.g. a multiple of the sector size */
+    uint32_t flush_interval_ms; /*!< Interval of the flushes of the file when no write is due */
+    uint32_t task_stack_size;   /*!< Stack size of the writer task */
+    UBaseType_t task_priority;  /*!< Priority of the writer task */
+    BaseType_t task_core;       /*!< Core of the writer task, or tskNO_AFFINITY */
+} pcap_writer_config_t;
+
+#define PCAP_WRITER_CONFIG_DEFAULT() { \
+    .ring_size = 32 * 1024,            \
+    .write_size = 4096,                \
+    .flush_interval_ms = 1000,         \
+    .task_stack_size = 3072,           \
+    .task_priority = 5,                \
+    .task_core = tskNO_AFFINITY,       \
+}
+
+#define PCAP_FILTER_MAX_ADDRS 4         /*!< Max MAC addresses of a capture filter */
+#define PCAP_FILTER_MAX_ETHERTYPES 4    /*!< Max ethertypes of a capture filter */
+#define PCAP_FILTER_MAX_IP_PROTOCOLS 4  /*!< Max IP protocols of a capture filter */
+#define PCAP_FILTER_MAX_PORTS 8         /*!< Max TCP or UDP ports of a capture filter */
+
+#define PCAP_80211_TYPE_MGMT 0          /*!< 802.11 management frames */
+#define PCAP_80211_TYPE_CTRL 1          /*!< 802.11 control frames */
+#define PCAP_80211_TYPE_DATA 2          /*!< 802.11 data frames */
+
+/**
+ * @brief Bit of the 802.11 frames of a type and subtype, in frame_types of `pcap_filter_t`
+ */
+#define PCAP_FILTER_80211_FRAME(type, subtype) (1ULL << (((type) << 4) | (subtype)))
+
+/**
+ * @brief Bits of all the 802.11 frames of a type, in frame_types of `pcap_filter_t`
+ */
+#define PCAP_FILTER_80211_TYPE(type) (0xFFFFULL << ((type) << 4))
+
+/**
+* @brief Pcap capture filter Type Definition
+*
+* A packet is captured when it matches all the criteria of the filter, and matches a criterion when it matches any of
+* its values. Criteria without values match all the packets.
+*/
+typedef struct {
+    uint64_t frame_types;                                  /*!< 802.11 frames to capture, made of PCAP_FILTER_80211_FRAME()
+                                                                and PCAP_FILTER_80211_TYPE() bits, 0 for all */
+    uint8_t addrs[PCAP_FILTER_MAX_ADDRS][6];               /*!< Capture the packets from or to one of these MAC addresses */
+    uint8_t num_addrs;                                     /*!< Number of addresses, 0 for all */
+    uint16_t ethertypes[PCAP_FILTER_MAX_ETHERTYPES];       /*!< Capture the packets of one of these ethertypes */
+    uint8_t num_ethertypes;                                /*!< Number of ethertypes, 0 for all */
+    uint8_t ip_protocols[PCAP_FILTER_MAX_IP_PROTOCOLS];    /*!< Capture the IPv4 or IPv6 packets of one of these protocols */
+    uint8_t num_ip_protocols;                              /*!< Number of IP protocols, 0 for all */
+    uint16_t ports[PCAP_FILTER_MAX_PORTS];                 /*!< Capture the TCP and UDP packets from or to one of these ports */
+    uint8_t num_ports;                                     /*!< Number of ports, 0 for all */
+} pcap_filter_t;
+
+/**
+* @brief Pcap capture statistics Type Definition
+*
+*/
+typedef struct {
+    uint32_t captured_packets; /*!< Packets written, or queued to the writer task */
+    uint32_t dropped_packets;  /*!< Packets dropped because the ring buffer of the writer task was full */
+    uint32_t dropped_bytes;    /*!< Bytes of the dropped packets */
+    uint32_t write_errors;     /*!< Failed writes of the writer task, the data of which is lost */
+    uint32_t filtered_packets; /*!< Packets discarded by the capture filter */
+} pcap_stats_t;
+
 /**
  * @brief Create a new pcap session, and returns pcap file handle
  *
@@ -75,7 +157,7 @@ typedef struct {
 esp_err_t pcap_new_session(const pcap_config_t *config, pcap_file_handle_t *ret_pcap);
 
 /**
- * @brief Delete the pcap session, and close the File Stream
+ * @brief Delete the pcap session, and close the File Stream or delete the sink
  *
  * @param[in] pcap pcap file handle created by `pcap_new_session()`
  * @return
@@ -97,6 +179,25 @@ esp_err_t pcap_del_session(pcap_file_handle_t pcap);
  */
 esp_err_t pcap_write_header(pcap_file_handle_t pcap, pcap_link_type_t link_type);
 
+/**
+ * @brief Add an interface to a pcapng file
+ *
+ * `pcap_write_header()` writes the first interface of the file, with interface ID 0. Further interfaces, e.g. to
+ * capture Wi-Fi and Ethernet into the same file, are added with this function.
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @param[in] link_type Network link layer type of the interface
+ * @param[out] ret_interface_id Returned interface ID, to pass to `pcap_capture_packet_ns()`
+ * @return
+ *      - ESP_OK: Add the interface successfully
+ *      - ESP_ERR_INVALID_ARG: Add the interface failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Add the interface failed because the file header isn't written yet
+ *      - ESP_ERR_NOT_SUPPORTED: Add the interface failed because the file isn't a pcapng file
+ *      - ESP_ERR_NO_MEM: Add the interface failed because the ring buffer of the writer task is full
+ *      - ESP_FAIL: Add the interface failed
+ */
+esp_err_t pcap_add_interface(pcap_file_handle_t pcap, pcap_link_type_t link_type, uint32_t *ret_interface_id);
+
 /**
  * @brief Capture one packet into pcap file
  *
@@ -106,12 +207,103 @@ esp_err_t pcap_write_header(pcap_file_handle_t pcap, pcap_link_type_t link_type)
  * @param[in] seconds second of capture time
  * @param[in] microseconds microsecond of capture time
  * @return
- *      - ESP_OK: Write network packet into pcap file successfully
+ *      - ESP_OK: Write network packet into pcap file successfully, or discard it because of the capture filter
  *      - ESP_ERR_INVALID_ARG: Write network packet into pcap file failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Network packet dropped because the ring buffer of the writer task is full
  *      - ESP_FAIL: Write network packet into pcap file failed
  */
 esp_err_t pcap_capture_packet(pcap_file_handle_t pcap, void *payload, uint32_t length, uint32_t seconds, uint32_t microseconds);
 
+/**
+ * @brief Capture one packet of an interface into pcap file, with a nanosecond timestamp
+ *
+ * The packet is truncated to the snaplen of the session. The timestamp is rounded down to microseconds unless the
+ * nanosecond flag of the session is set.
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @param[in] interface_id 0, or ID returned by `pcap_add_interface()` for pcapng files
+ * @param[in] payload pointer of the captured data buffer
+ * @param[in] length length of captured data buffer
+ * @param[in] seconds second of capture time
+ * @param[in] nanoseconds nanosecond of capture time
+ * @return
+ *      - ESP_OK: Write network packet into pcap file successfully, or discard it because of the capture filter
+ *      - ESP_ERR_INVALID_ARG: Write network packet into pcap file failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Network packet dropped because the ring buffer of the writer task is full
+ *      - ESP_FAIL: Write network packet into pcap file failed
+ */
+esp_err_t pcap_capture_packet_ns(pcap_file_handle_t pcap, uint32_t interface_id, void *payload, uint32_t length,
+                                 uint32_t seconds, uint32_t nanoseconds);
+
+/**
+ * @brief Start a writer task, to which `pcap_capture_packet()` hands the packets over
+ *
+ * Once the writer is started, `pcap_capture_packet()` copies the packet to a ring
+ * buffer and returns without waiting, so it can be called from the Wi-Fi promiscuous
+ * or Ethernet receive callbacks, though not from an ISR. When the ring buffer is full,
+ * the packet is dropped and counted in `pcap_get_stats()`. The writer task writes the
+ * packets to the file in chunks of write_size bytes, and flushes it every
+ * flush_interval_ms, instead of a write and a flush per packet.
+ *
+ * @note The file header must be written with `pcap_write_header()` before the writer is started.
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @param[in] config writer configuration, NULL for PCAP_WRITER_CONFIG_DEFAULT()
+ * @return
+ *      - ESP_OK: Start the writer task successfully
+ *      - ESP_ERR_INVALID_ARG: Start the writer task failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Start the writer task failed because it's already started
+ *      - ESP_ERR_NO_MEM: Start the writer task failed because out of memory
+ */
+esp_err_t pcap_start_writer(pcap_file_handle_t pcap, const pcap_writer_config_t *config);
+
+/**
+ * @brief Stop the writer task, once it has written and flushed the queued packets
+ *
+ * `pcap_capture_packet()` then writes to the file directly again. `pcap_del_session()`
+ * also stops the writer task.
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @return
+ *      - ESP_OK: Stop the writer task successfully
+ *      - ESP_ERR_INVALID_ARG: Stop the writer task failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Stop the writer task failed because it's not started
+ *      - ESP_FAIL: The writer task failed to write some packets to the file
+ */
+esp_err_t pcap_stop_writer(pcap_file_handle_t pcap);
+
+/**
+ * @brief Set the capture filter of the pcap session
+ *
+ * The packets passed to `pcap_capture_packet()` which don't match the filter are discarded before they are copied to
+ * the ring buffer of the writer task or written, and counted in `pcap_get_stats()`. The filter looks at the headers
+ * of the Ethernet, 802.11 and raw IP packets, the packets of the other link types are always captured. The raw IP
+ * packets don't match MAC addresses, having none. The ethertype,
+ * IP protocol and port criteria only match the 802.11 data frames which aren't protected, and the ports only match
+ * the first fragment of the IPv4 packets, and the IPv6 packets without extension headers.
+ *
+ * @note The filter must not be changed while packets are being captured from another task.
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @param[in] filter capture filter, NULL to capture all the packets
+ * @return
+ *      - ESP_OK: Set the filter successfully
+ *      - ESP_ERR_INVALID_ARG: Set the filter failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Set the filter failed because out of memory
+ */
+esp_err_t pcap_set_filter(pcap_file_handle_t pcap, const pcap_filter_t *filter);
+
+/**
+ * @brief Get the capture statistics of the pcap session
+ *
+ * @param[in] pcap pcap file handle created by `pcap_new_session()`
+ * @param[out] stats returned statistics
+ * @return
+ *      - ESP_OK: Get the statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get the statistics failed because of invalid argument
+ */
+esp_err_t pcap_get_stats(pcap_file_handle_t pcap, pcap_stats_t *stats);
+
 /**
  * @brief Print the summary of pcap file into stream
  *
@@ -120,6 +312,7 @@ esp_err_t pcap_capture_packet(pcap_file_handle_t pcap, void *payload, uint32_t l
  * @return
  *      - ESP_OK: Print pcap file summary successfully
  *      - ESP_ERR_INVALID_ARG: Print pcap file summary failed because of invalid argument
+ *      - ESP_ERR_NOT_SUPPORTED: Print pcap file summary failed because the file is a pcapng file, or a sink
  *      - ESP_FAIL: Print pcap file summary failed
  */
 esp_err_t pcap_print_summary(pcap_file_handle_t pcap, FILE *print_file);
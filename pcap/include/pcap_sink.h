@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Type of pcap sink handle
+ *
+ */
+typedef struct pcap_sink_t *pcap_sink_handle_t;
+
+/**
+ * @brief Pcap sink interface, receiving the capture instead of a FILE
+ *
+ * A custom sink embeds this structure as its first member. The pcap session only passes whole records to write(), so
+ * that a datagram based sink can send each write on its own: the file header, or one or more packet records batched
+ * by the writer task, see `pcap_start_writer()`.
+ */
+struct pcap_sink_t {
+    /**
+     * @brief Write whole records
+     *
+     * @param[in] sink sink handle
+     * @param[in] data records to write
+     * @param[in] length length of the records
+     * @return
+     *      - ESP_OK: Write the records successfully
+     *      - ESP_FAIL: Write the records failed
+     */
+    esp_err_t (*write)(pcap_sink_handle_t sink, const void *data, size_t length);
+
+    /**
+     * @brief Push the written records to the device or the network, may be NULL
+     *
+     * @param[in] sink sink handle
+     * @return
+     *      - ESP_OK: Flush successfully
+     *      - ESP_FAIL: Flush failed
+     */
+    esp_err_t (*flush)(pcap_sink_handle_t sink);
+
+    /**
+     * @brief Delete the sink, called by `pcap_del_session()`
+     *
+     * @param[in] sink sink handle
+     * @return
+     *      - ESP_OK: Delete the sink successfully
+     */
+    esp_err_t (*del)(pcap_sink_handle_t sink);
+};
+
+/**
+* @brief Transport of the network sink
+*
+*/
+typedef enum {
+    PCAP_NET_SINK_TCP, /*!< Stream the capture to a TCP server */
+    PCAP_NET_SINK_UDP, /*!< Send each write of records in a UDP datagram */
+} pcap_net_sink_protocol_t;
+
+/**
+* @brief Pcap network sink configuration Type Definition
+*
+*/
+typedef struct {
+    pcap_net_sink_protocol_t protocol; /*!< TCP or UDP */
+    const char *host;                  /*!< Address or host name of the capture host */
+    uint16_t port;                     /*!< Port of the capture host */
+} pcap_net_sink_config_t;
+
+/**
+ * @brief Create a sink sending the capture to another host
+ *
+ * The data sent is a pcap or pcapng file, so that e.g. `nc -l 19000 | wireshark -k -i -` displays a TCP capture live.
+ * With UDP, each datagram holds whole records, so that a lost datagram only loses its packets, as long as the first
+ * one, holding the file header, is received. The size of the datagrams is set by the write_size of the writer task,
+ * and should fit in the MTU to avoid IP fragmentation.
+ *
+ * @note For TCP, this function connects to the host, which must be listening.
+ *
+ * @param[in] config network sink configuration
+ * @param[out] ret_sink Returned sink handle, to set in `pcap_config_t`
+ * @return
+ *      - ESP_OK: Create the sink successfully
+ *      - ESP_ERR_INVALID_ARG: Create the sink failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create the sink failed because out of memory
+ *      - ESP_FAIL: Create the sink failed because the host couldn't be resolved or connected to
+ */
+esp_err_t pcap_new_net_sink(const pcap_net_sink_config_t *config, pcap_sink_handle_t *ret_sink);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,14 +8,30 @@
 #include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
+#include <sys/param.h>
 #include "esp_log.h"
 #include "esp_check.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
 #include "pcap.h"
+#include "pcap_filter.h"
 
 static const char *TAG = "pcap";
 
 #define PCAP_MAGIC_BIG_ENDIAN 0xA1B2C3D4    /*!< Big-Endian */
 #define PCAP_MAGIC_LITTLE_ENDIAN 0xD4C3B2A1 /*!< Little-Endian */
+#define PCAP_MAGIC_NS_BIG_ENDIAN 0xA1B23C4D    /*!< Big-Endian, nanosecond timestamps */
+#define PCAP_MAGIC_NS_LITTLE_ENDIAN 0x4D3CB2A1 /*!< Little-Endian, nanosecond timestamps */
+
+#define PCAPNG_BLOCK_TYPE_SHB 0x0A0D0D0A       /*!< Section Header Block */
+#define PCAPNG_BLOCK_TYPE_IDB 0x00000001       /*!< Interface Description Block */
+#define PCAPNG_BLOCK_TYPE_EPB 0x00000006       /*!< Enhanced Packet Block */
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4D     /*!< Byte order of the section, written in host order */
+#define PCAPNG_OPTION_END 0                    /*!< opt_endofopt */
+#define PCAPNG_OPTION_IF_TSRESOL 9             /*!< if_tsresol, power of 10 of the timestamp unit */
+#define PCAPNG_TRAILER_MAX_SIZE 8              /*!< Padding of the packet data, and trailing block length */
 
 typedef struct pcap_file_t pcap_file_t;
 
@@ -44,17 +60,94 @@ typedef struct {
     uint32_t packet_length;  /*!< Actual length of current packet */
 } pcap_packet_header_t;
 
+/**
+ * @brief Pcapng Section Header Block, without options
+ *
+ */
+typedef struct {
+    uint32_t block_type;        /*!< PCAPNG_BLOCK_TYPE_SHB */
+    uint32_t block_length;      /*!< Total length of the block */
+    uint32_t byte_order_magic;  /*!< PCAPNG_BYTE_ORDER_MAGIC */
+    uint16_t major;             /*!< Major Version */
+    uint16_t minor;             /*!< Minor Version */
+    uint32_t section_length[2]; /*!< 64 bit length of the section, -1 when not specified */
+    uint32_t block_length_end;  /*!< Total length of the block */
+} pcapng_section_header_t;
+
+/**
+ * @brief Pcapng Interface Description Block, with the if_tsresol option
+ *
+ */
+typedef struct {
+    uint32_t block_type;        /*!< PCAPNG_BLOCK_TYPE_IDB */
+    uint32_t block_length;      /*!< Total length of the block */
+    uint16_t link_type;         /*!< Link Layer Type */
+    uint16_t reserved;          /*!< Reserved, 0 */
+    uint32_t snaplen;           /*!< Max Length to Capture */
+    uint16_t tsresol_code;      /*!< PCAPNG_OPTION_IF_TSRESOL */
+    uint16_t tsresol_length;    /*!< 1 */
+    uint8_t tsresol[4];         /*!< Timestamp resolution, and padding */
+    uint16_t end_code;          /*!< PCAPNG_OPTION_END */
+    uint16_t end_length;        /*!< 0 */
+    uint32_t block_length_end;  /*!< Total length of the block */
+} pcapng_interface_block_t;
+
+/**
+ * @brief Pcapng Enhanced Packet Block header, followed by the data padded to 32 bits and the block length
+ *
+ */
+typedef struct {
+    uint32_t block_type;        /*!< PCAPNG_BLOCK_TYPE_EPB */
+    uint32_t block_length;      /*!< Total length of the block */
+    uint32_t interface_id;      /*!< Index of the interface in the section */
+    uint32_t timestamp_high;    /*!< Upper 32 bits of the timestamp, in units of if_tsresol */
+    uint32_t timestamp_low;     /*!< Lower 32 bits of the timestamp */
+    uint32_t capture_length;    /*!< Number of bytes of captured data, no longer than packet_length */
+    uint32_t packet_length;     /*!< Actual length of current packet */
+} pcapng_packet_header_t;
+
+/**
+ * @brief Pcap Writer Task
+ *
+ * Each item of the ring buffer is a whole packet record, the packet header followed by the payload, so that the
+ * records of concurrent producers don't interleave. The task copies them back to back into buf, and writes buf
+ * whenever it's full, so that all the writes but the last one of a flush are write_size bytes. A sink only gets
+ * whole records, so for a sink buf is written when the next record doesn't fit in it instead.
+ */
+typedef struct {
+    RingbufHandle_t ring;       /*!< Queued packet records */
+    uint8_t *buf;               /*!< Write buffer */
+    size_t buf_size;            /*!< Size of the write buffer */
+    size_t buf_len;             /*!< Bytes in the write buffer */
+    TickType_t flush_ticks;     /*!< Flush interval */
+    SemaphoreHandle_t done;     /*!< Given by the task when it exits */
+    volatile bool stop;         /*!< Asks the task to exit once the ring buffer is empty */
+    bool failed;                /*!< Set when a write failed */
+} pcap_writer_t;
+
 /**
  * @brief Pcap Runtime Handle
  *
  */
 struct pcap_file_t {
     FILE *file;                 /*!< File handle */
+    pcap_sink_handle_t sink;    /*!< Sink handle, used instead of the file */
+    uint8_t *record_buf;        /*!< Record assembled for the sink, when written without the writer task */
+    size_t record_buf_size;     /*!< Size of the record buffer */
+    pcap_writer_t *writer;      /*!< Writer task, if started */
+    pcap_compiled_filter_t *filter; /*!< Capture filter, NULL to capture all the packets */
+    portMUX_TYPE stats_lock;    /*!< Protects stats, updated by the producers and the writer task */
+    pcap_stats_t stats;         /*!< Capture statistics */
     pcap_link_type_t link_type; /*!< Pcap Link Type */
     unsigned int major_version; /*!< Pcap version: major */
     unsigned int minor_version; /*!< Pcap version: minor */
     unsigned int time_zone;     /*!< Pcap timezone code */
     uint32_t endian_magic;      /*!< Magic value related to endian format */
+    uint32_t snaplen;           /*!< Max length of the captured packets */
+    uint32_t interface_count;   /*!< Interfaces of the pcapng section */
+    pcap_link_type_t *interface_link_types; /*!< Link type of each interface of the pcapng section */
+    bool pcapng;                /*!< Write the pcapng format */
+    bool nanosecond;            /*!< Timestamps in nanoseconds */
 };
 
 esp_err_t pcap_new_session(const pcap_config_t *config, pcap_file_handle_t *ret_pcap)
@@ -62,14 +155,23 @@ esp_err_t pcap_new_session(const pcap_config_t *config, pcap_file_handle_t *ret_
     esp_err_t ret = ESP_OK;
     pcap_file_t *pcap = NULL;
     ESP_GOTO_ON_FALSE(config && ret_pcap, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
-    ESP_GOTO_ON_FALSE(config->fp, ESP_ERR_INVALID_ARG, err, TAG, "pcap file handle can't be NULL");
+    ESP_GOTO_ON_FALSE(config->fp || config->sink, ESP_ERR_INVALID_ARG, err, TAG, "pcap file and sink handles can't be NULL");
     pcap = calloc(1, sizeof(pcap_file_t));
     ESP_GOTO_ON_FALSE(pcap, ESP_ERR_NO_MEM, err, TAG, "no mem for pcap file object");
     pcap->file = config->fp;
+    pcap->sink = config->fp ? NULL : config->sink;
     pcap->major_version = config->major_version;
     pcap->minor_version = config->minor_version;
-    pcap->endian_magic = config->flags.little_endian ? PCAP_MAGIC_LITTLE_ENDIAN : PCAP_MAGIC_BIG_ENDIAN;
+    if (config->flags.nanosecond) {
+        pcap->endian_magic = config->flags.little_endian ? PCAP_MAGIC_NS_LITTLE_ENDIAN : PCAP_MAGIC_NS_BIG_ENDIAN;
+    } else {
+        pcap->endian_magic = config->flags.little_endian ? PCAP_MAGIC_LITTLE_ENDIAN : PCAP_MAGIC_BIG_ENDIAN;
+    }
+    pcap->snaplen = config->snaplen ? config->snaplen : PCAP_DEFAULT_SNAPLEN;
+    pcap->pcapng = config->flags.pcapng;
+    pcap->nanosecond = config->flags.nanosecond;
     pcap->time_zone = config->time_zone;
+    portMUX_INITIALIZE(&pcap->stats_lock);
     *ret_pcap = pcap;
     return ret;
 err:
@@ -82,17 +184,143 @@ err:
 esp_err_t pcap_del_session(pcap_file_handle_t pcap)
 {
     ESP_RETURN_ON_FALSE(pcap, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (pcap->writer) {
+        pcap_stop_writer(pcap);
+    }
     if (pcap->file) {
         fclose(pcap->file);
         pcap->file = NULL;
     }
+    if (pcap->sink) {
+        pcap->sink->del(pcap->sink);
+        pcap->sink = NULL;
+    }
+    free(pcap->record_buf);
+    free(pcap->interface_link_types);
+    free(pcap->filter);
     free(pcap);
     return ESP_OK;
 }
 
+static esp_err_t pcap_output_write(pcap_file_handle_t pcap, const void *data, size_t length)
+{
+    if (pcap->sink) {
+        return pcap->sink->write(pcap->sink, data, length);
+    }
+    return fwrite(data, 1, length, pcap->file) == length ? ESP_OK : ESP_FAIL;
+}
+
+static void pcap_output_flush(pcap_file_handle_t pcap)
+{
+    if (pcap->sink) {
+        if (pcap->sink->flush) {
+            pcap->sink->flush(pcap->sink);
+        }
+    } else {
+        fflush(pcap->file);
+    }
+}
+
+/*
+ * Writes one record to the file, or queues it to the writer task. The record is made of a header, the packet data,
+ * and a trailer, so that the packet data isn't copied more than once.
+ */
+static esp_err_t pcap_write_record(pcap_file_handle_t pcap, const void *header, size_t header_length,
+                                   const void *payload, size_t payload_length, const void *trailer, size_t trailer_length)
+{
+    if (pcap->writer) {
+        /* Copy the record into the ring buffer without waiting */
+        uint8_t *item = NULL;
+        if (xRingbufferSendAcquire(pcap->writer->ring, (void **)&item, header_length + payload_length + trailer_length, 0) != pdTRUE) {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(item, header, header_length);
+        if (payload_length) {
+            memcpy(item + header_length, payload, payload_length);
+        }
+        if (trailer_length) {
+            memcpy(item + header_length + payload_length, trailer, trailer_length);
+        }
+        xRingbufferSendComplete(pcap->writer->ring, item);
+        return ESP_OK;
+    }
+    if (pcap->sink) {
+        /* The sink takes whole records */
+        size_t length = header_length + payload_length + trailer_length;
+        if (length > pcap->record_buf_size) {
+            uint8_t *buf = realloc(pcap->record_buf, length);
+            ESP_RETURN_ON_FALSE(buf, ESP_ERR_NO_MEM, TAG, "no mem for record");
+            pcap->record_buf = buf;
+            pcap->record_buf_size = length;
+        }
+        memcpy(pcap->record_buf, header, header_length);
+        if (payload_length) {
+            memcpy(pcap->record_buf + header_length, payload, payload_length);
+        }
+        if (trailer_length) {
+            memcpy(pcap->record_buf + header_length + payload_length, trailer, trailer_length);
+        }
+        ESP_RETURN_ON_ERROR(pcap_output_write(pcap, pcap->record_buf, length), TAG, "write record failed");
+        pcap_output_flush(pcap);
+        return ESP_OK;
+    }
+    size_t real_write = fwrite(header, 1, header_length, pcap->file);
+    ESP_RETURN_ON_FALSE(real_write == header_length, ESP_FAIL, TAG, "write record header failed");
+    if (payload_length) {
+        real_write = fwrite(payload, 1, payload_length, pcap->file);
+        ESP_RETURN_ON_FALSE(real_write == payload_length, ESP_FAIL, TAG, "write packet payload failed");
+    }
+    if (trailer_length) {
+        real_write = fwrite(trailer, 1, trailer_length, pcap->file);
+        ESP_RETURN_ON_FALSE(real_write == trailer_length, ESP_FAIL, TAG, "write record trailer failed");
+    }
+    /* Flush content in the buffer into device */
+    fflush(pcap->file);
+    return ESP_OK;
+}
+
+static esp_err_t pcapng_write_interface(pcap_file_handle_t pcap, pcap_link_type_t link_type)
+{
+    pcap_link_type_t *link_types = realloc(pcap->interface_link_types, (pcap->interface_count + 1) * sizeof(pcap_link_type_t));
+    ESP_RETURN_ON_FALSE(link_types, ESP_ERR_NO_MEM, TAG, "no mem for interface");
+    pcap->interface_link_types = link_types;
+    pcapng_interface_block_t block = {
+        .block_type = PCAPNG_BLOCK_TYPE_IDB,
+        .block_length = sizeof(block),
+        .link_type = link_type,
+        .snaplen = pcap->snaplen,
+        .tsresol_code = PCAPNG_OPTION_IF_TSRESOL,
+        .tsresol_length = 1,
+        .tsresol = {pcap->nanosecond ? 9 : 6},
+        .end_code = PCAPNG_OPTION_END,
+        .block_length_end = sizeof(block),
+    };
+    ESP_RETURN_ON_ERROR(pcap_write_record(pcap, &block, sizeof(block), NULL, 0, NULL, 0), TAG, "write interface block failed");
+    link_types[pcap->interface_count++] = link_type;
+    return ESP_OK;
+}
+
 esp_err_t pcap_write_header(pcap_file_handle_t pcap, pcap_link_type_t link_type)
 {
     ESP_RETURN_ON_FALSE(pcap, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (pcap->pcapng) {
+        /* Write the Section Header Block, and the Interface Description Block of the first interface */
+        pcapng_section_header_t header = {
+            .block_type = PCAPNG_BLOCK_TYPE_SHB,
+            .block_length = sizeof(header),
+            .byte_order_magic = PCAPNG_BYTE_ORDER_MAGIC,
+            .major = 1,
+            .minor = 0,
+            .section_length = {UINT32_MAX, UINT32_MAX},
+            .block_length_end = sizeof(header),
+        };
+        ESP_RETURN_ON_ERROR(pcap_write_record(pcap, &header, sizeof(header), NULL, 0, NULL, 0), TAG,
+                            "write pcapng section header failed");
+        pcap->interface_count = 0;
+        ESP_RETURN_ON_ERROR(pcapng_write_interface(pcap, link_type), TAG, "write pcapng interface failed");
+        pcap->link_type = link_type;
+        return ESP_OK;
+    }
     /* Write Pcap File header */
     pcap_file_header_t header = {
         .magic = pcap->endian_magic,
@@ -100,34 +328,237 @@ esp_err_t pcap_write_header(pcap_file_handle_t pcap, pcap_link_type_t link_type)
         .minor = pcap->minor_version,
         .zone = pcap->time_zone,
         .sigfigs = 0,
-        .snaplen = 0x40000,
+        .snaplen = pcap->snaplen,
         .link_type = link_type,
     };
-    size_t real_write = fwrite(&header, sizeof(header), 1, pcap->file);
-    ESP_RETURN_ON_FALSE(real_write == 1, ESP_FAIL, TAG, "write pcap file header failed");
+    ESP_RETURN_ON_ERROR(pcap_write_record(pcap, &header, sizeof(header), NULL, 0, NULL, 0), TAG,
+                        "write pcap file header failed");
     /* Save the link type to pcap file object */
     pcap->link_type = link_type;
-    /* Flush content in the buffer into device */
-    fflush(pcap->file);
     return ESP_OK;
 }
 
-esp_err_t pcap_capture_packet(pcap_file_handle_t pcap, void *payload, uint32_t length, uint32_t seconds, uint32_t microseconds)
+esp_err_t pcap_add_interface(pcap_file_handle_t pcap, pcap_link_type_t link_type, uint32_t *ret_interface_id)
+{
+    ESP_RETURN_ON_FALSE(pcap && ret_interface_id, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(pcap->pcapng, ESP_ERR_NOT_SUPPORTED, TAG, "only pcapng supports several interfaces");
+    ESP_RETURN_ON_FALSE(pcap->interface_count, ESP_ERR_INVALID_STATE, TAG, "pcapng header not written");
+    uint32_t interface_id = pcap->interface_count;
+    ESP_RETURN_ON_ERROR(pcapng_write_interface(pcap, link_type), TAG, "write pcapng interface failed");
+    *ret_interface_id = interface_id;
+    return ESP_OK;
+}
+
+esp_err_t pcap_capture_packet_ns(pcap_file_handle_t pcap, uint32_t interface_id, void *payload, uint32_t length,
+                                 uint32_t seconds, uint32_t nanoseconds)
 {
     ESP_RETURN_ON_FALSE(pcap && payload, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
-    size_t real_write = 0;
-    pcap_packet_header_t header = {
-        .seconds = seconds,
-        .microseconds = microseconds,
-        .capture_length = length,
-        .packet_length = length
-    };
-    real_write = fwrite(&header, sizeof(header), 1, pcap->file);
-    ESP_RETURN_ON_FALSE(real_write == 1, ESP_FAIL, TAG, "write packet header failed");
-    real_write = fwrite(payload, sizeof(uint8_t), length, pcap->file);
-    ESP_RETURN_ON_FALSE(real_write == length, ESP_FAIL, TAG, "write packet payload failed");
-    /* Flush content in the buffer into device */
-    fflush(pcap->file);
+    ESP_RETURN_ON_FALSE(interface_id < (pcap->pcapng ? pcap->interface_count : 1), ESP_ERR_INVALID_ARG, TAG,
+                        "invalid interface");
+    if (pcap->filter) {
+        /* Discard the packets not matching the filter before they take room in the ring buffer or the file */
+        pcap_link_type_t link_type = pcap->pcapng ? pcap->interface_link_types[interface_id] : pcap->link_type;
+        if (!pcap_filter_match(pcap->filter, link_type, payload, length)) {
+            portENTER_CRITICAL_SAFE(&pcap->stats_lock);
+            pcap->stats.filtered_packets++;
+            portEXIT_CRITICAL_SAFE(&pcap->stats_lock);
+            return ESP_OK;
+        }
+    }
+    /* Longer packets are truncated to snaplen, the headers keep their original length */
+    uint32_t capture_length = MIN(length, pcap->snaplen);
+    esp_err_t ret;
+    if (pcap->pcapng) {
+        uint64_t timestamp = pcap->nanosecond ? (uint64_t)seconds * 1000000000 + nanoseconds :
+                             (uint64_t)seconds * 1000000 + nanoseconds / 1000;
+        uint32_t padding = -capture_length & 3;
+        uint32_t block_length = sizeof(pcapng_packet_header_t) + capture_length + padding + sizeof(uint32_t);
+        pcapng_packet_header_t header = {
+            .block_type = PCAPNG_BLOCK_TYPE_EPB,
+            .block_length = block_length,
+            .interface_id = interface_id,
+            .timestamp_high = timestamp >> 32,
+            .timestamp_low = (uint32_t)timestamp,
+            .capture_length = capture_length,
+            .packet_length = length,
+        };
+        uint8_t trailer[PCAPNG_TRAILER_MAX_SIZE] = {0};
+        memcpy(trailer + padding, &block_length, sizeof(block_length));
+        ret = pcap_write_record(pcap, &header, sizeof(header), payload, capture_length, trailer, padding + sizeof(block_length));
+    } else {
+        pcap_packet_header_t header = {
+            .seconds = seconds,
+            .microseconds = pcap->nanosecond ? nanoseconds : nanoseconds / 1000,
+            .capture_length = capture_length,
+            .packet_length = length
+        };
+        ret = pcap_write_record(pcap, &header, sizeof(header), payload, capture_length, NULL, 0);
+    }
+    portENTER_CRITICAL_SAFE(&pcap->stats_lock);
+    if (ret == ESP_OK) {
+        pcap->stats.captured_packets++;
+    } else if (ret == ESP_ERR_NO_MEM) {
+        pcap->stats.dropped_packets++;
+        pcap->stats.dropped_bytes += capture_length;
+    }
+    portEXIT_CRITICAL_SAFE(&pcap->stats_lock);
+    return ret;
+}
+
+esp_err_t pcap_capture_packet(pcap_file_handle_t pcap, void *payload, uint32_t length, uint32_t seconds, uint32_t microseconds)
+{
+    return pcap_capture_packet_ns(pcap, 0, payload, length, seconds, microseconds * 1000);
+}
+
+static void pcap_writer_write(pcap_file_handle_t pcap, const uint8_t *data, size_t length)
+{
+    pcap_writer_t *writer = pcap->writer;
+    if (length == 0) {
+        return;
+    }
+    if (pcap_output_write(pcap, data, length) != ESP_OK) {
+        ESP_LOGE(TAG, "write packets failed");
+        writer->failed = true;
+        portENTER_CRITICAL(&pcap->stats_lock);
+        pcap->stats.write_errors++;
+        portEXIT_CRITICAL(&pcap->stats_lock);
+    }
+}
+
+static void pcap_writer_write_buf(pcap_file_handle_t pcap)
+{
+    pcap_writer_t *writer = pcap->writer;
+    pcap_writer_write(pcap, writer->buf, writer->buf_len);
+    writer->buf_len = 0;
+}
+
+static void pcap_writer_task(void *arg)
+{
+    pcap_file_handle_t pcap = (pcap_file_handle_t)arg;
+    pcap_writer_t *writer = pcap->writer;
+    TickType_t last_flush = xTaskGetTickCount();
+    while (true) {
+        size_t size = 0;
+        uint8_t *item = xRingbufferReceive(writer->ring, &size, writer->flush_ticks);
+        if (item && pcap->sink) {
+            if (writer->buf_len + size > writer->buf_size) {
+                pcap_writer_write_buf(pcap);
+            }
+            if (size > writer->buf_size) {
+                pcap_writer_write(pcap, item, size);
+            } else {
+                memcpy(writer->buf + writer->buf_len, item, size);
+                writer->buf_len += size;
+            }
+            vRingbufferReturnItem(writer->ring, item);
+        } else if (item) {
+            for (size_t offset = 0; offset < size;) {
+                size_t len = MIN(size - offset, writer->buf_size - writer->buf_len);
+                memcpy(writer->buf + writer->buf_len, item + offset, len);
+                writer->buf_len += len;
+                offset += len;
+                if (writer->buf_len == writer->buf_size) {
+                    pcap_writer_write_buf(pcap);
+                }
+            }
+            vRingbufferReturnItem(writer->ring, item);
+        } else if (writer->stop) {
+            break;
+        }
+        if (xTaskGetTickCount() - last_flush >= writer->flush_ticks) {
+            pcap_writer_write_buf(pcap);
+            pcap_output_flush(pcap);
+            last_flush = xTaskGetTickCount();
+        }
+    }
+    pcap_writer_write_buf(pcap);
+    pcap_output_flush(pcap);
+    xSemaphoreGive(writer->done);
+    vTaskDelete(NULL);
+}
+
+static void pcap_writer_free(pcap_writer_t *writer)
+{
+    if (writer->ring) {
+        vRingbufferDelete(writer->ring);
+    }
+    if (writer->done) {
+        vSemaphoreDelete(writer->done);
+    }
+    free(writer->buf);
+    free(writer);
+}
+
+esp_err_t pcap_start_writer(pcap_file_handle_t pcap, const pcap_writer_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    pcap_writer_t *writer = NULL;
+    const pcap_writer_config_t default_config = PCAP_WRITER_CONFIG_DEFAULT();
+    ESP_RETURN_ON_FALSE(pcap, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!pcap->writer, ESP_ERR_INVALID_STATE, TAG, "writer already started");
+    if (!config) {
+        config = &default_config;
+    }
+    ESP_RETURN_ON_FALSE(config->ring_size && config->write_size && config->flush_interval_ms, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid writer configuration");
+    writer = calloc(1, sizeof(pcap_writer_t));
+    ESP_GOTO_ON_FALSE(writer, ESP_ERR_NO_MEM, err, TAG, "no mem for writer object");
+    writer->buf = malloc(config->write_size);
+    writer->buf_size = config->write_size;
+    writer->ring = xRingbufferCreate(config->ring_size, RINGBUF_TYPE_NOSPLIT);
+    writer->done = xSemaphoreCreateBinary();
+    writer->flush_ticks = MAX(pdMS_TO_TICKS(config->flush_interval_ms), 1);
+    ESP_GOTO_ON_FALSE(writer->buf && writer->ring && writer->done, ESP_ERR_NO_MEM, err, TAG, "no mem for writer");
+    pcap->writer = writer;
+    ESP_GOTO_ON_FALSE(xTaskCreatePinnedToCore(pcap_writer_task, "pcap_writer", config->task_stack_size, pcap,
+                      config->task_priority, NULL, config->task_core) == pdPASS,
+                      ESP_ERR_NO_MEM, err, TAG, "create writer task failed");
+    return ESP_OK;
+err:
+    pcap->writer = NULL;
+    if (writer) {
+        pcap_writer_free(writer);
+    }
+    return ret;
+}
+
+esp_err_t pcap_stop_writer(pcap_file_handle_t pcap)
+{
+    ESP_RETURN_ON_FALSE(pcap, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    pcap_writer_t *writer = pcap->writer;
+    ESP_RETURN_ON_FALSE(writer, ESP_ERR_INVALID_STATE, TAG, "writer not started");
+    writer->stop = true;
+    xSemaphoreTake(writer->done, portMAX_DELAY);
+    pcap->writer = NULL;
+    bool failed = writer->failed;
+    pcap_writer_free(writer);
+    return failed ? ESP_FAIL : ESP_OK;
+}
+
+esp_err_t pcap_set_filter(pcap_file_handle_t pcap, const pcap_filter_t *filter)
+{
+    esp_err_t ret = ESP_OK;
+    pcap_compiled_filter_t *compiled = NULL;
+    ESP_RETURN_ON_FALSE(pcap, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (filter) {
+        compiled = malloc(sizeof(pcap_compiled_filter_t));
+        ESP_GOTO_ON_FALSE(compiled, ESP_ERR_NO_MEM, err, TAG, "no mem for filter");
+        ESP_GOTO_ON_ERROR(pcap_filter_compile(filter, compiled), err, TAG, "compile filter failed");
+    }
+    free(pcap->filter);
+    pcap->filter = compiled;
+    return ESP_OK;
+err:
+    free(compiled);
+    return ret;
+}
+
+esp_err_t pcap_get_stats(pcap_file_handle_t pcap, pcap_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(pcap && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&pcap->stats_lock);
+    *stats = pcap->stats;
+    portEXIT_CRITICAL(&pcap->stats_lock);
     return ESP_OK;
 }
 
@@ -137,6 +568,8 @@ esp_err_t pcap_print_summary(pcap_file_handle_t pcap, FILE *print_file)
     long size = 0;
     char *packet_payload = NULL;
     ESP_RETURN_ON_FALSE(pcap && print_file, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!pcap->pcapng, ESP_ERR_NOT_SUPPORTED, TAG, "summary of pcapng files not supported");
+    ESP_RETURN_ON_FALSE(pcap->file, ESP_ERR_NOT_SUPPORTED, TAG, "summary of sinks not supported");
     // get file size
     fseek(pcap->file, 0L, SEEK_END);
     size = ftell(pcap->file);
@@ -167,7 +600,11 @@ esp_err_t pcap_print_summary(pcap_file_handle_t pcap, FILE *print_file)
         // print packet header information
         fprintf(print_file, "Packet %"PRIu32":\n", packet_num);
         fprintf(print_file, "Timestamp (Seconds): %"PRIu32"\n", packet_header.seconds);
-        fprintf(print_file, "Timestamp (Microseconds): %"PRIu32"\n", packet_header.microseconds);
+        if (file_header.magic == PCAP_MAGIC_NS_BIG_ENDIAN || file_header.magic == PCAP_MAGIC_NS_LITTLE_ENDIAN) {
+            fprintf(print_file, "Timestamp (Nanoseconds): %"PRIu32"\n", packet_header.microseconds);
+        } else {
+            fprintf(print_file, "Timestamp (Microseconds): %"PRIu32"\n", packet_header.microseconds);
+        }
         fprintf(print_file, "Capture Length: %"PRIu32"\n", packet_header.capture_length);
         fprintf(print_file, "Packet Length: %"PRIu32"\n", packet_header.packet_length);
         size_t payload_length = packet_header.capture_length;
@@ -0,0 +1,236 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "esp_check.h"
+#include "pcap_filter.h"
+
+static const char *TAG = "pcap_filter";
+
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_IPV6 0x86DD
+#define ETHERTYPE_VLAN 0x8100
+#define ETHERTYPE_QINQ 0x88A8
+#define IP_PROTOCOL_TCP 6
+#define IP_PROTOCOL_UDP 17
+
+#define ETH_HEADER_LEN 14
+#define IEEE80211_HEADER_LEN 24
+#define IEEE80211_FC1_DS_MASK 0x03      /*!< ToDS and FromDS, both set when the frame has a fourth address */
+#define IEEE80211_FC1_PROTECTED 0x40
+#define IEEE80211_FC1_ORDER 0x80        /*!< HT Control field in QoS data frames */
+#define IEEE80211_SUBTYPE_QOS 0x08
+#define IEEE80211_SUBTYPE_NO_DATA 0x04  /*!< Null and CF-Ack/Poll data frames, without payload */
+#define LLC_SNAP_LEN 8
+
+#define PORT_HASH(port) (((port) ^ ((port) >> 8)) & 0xFF)
+
+static inline uint16_t read_be16(const uint8_t *data)
+{
+    return data[0] << 8 | data[1];
+}
+
+static inline bool bitmap_test(const uint32_t *bitmap, uint32_t bit)
+{
+    return bitmap[bit >> 5] & (1U << (bit & 31));
+}
+
+static inline void bitmap_set(uint32_t *bitmap, uint32_t bit)
+{
+    bitmap[bit >> 5] |= 1U << (bit & 31);
+}
+
+esp_err_t pcap_filter_compile(const pcap_filter_t *filter, pcap_compiled_filter_t *compiled)
+{
+    ESP_RETURN_ON_FALSE(filter->num_addrs <= PCAP_FILTER_MAX_ADDRS && filter->num_ethertypes <= PCAP_FILTER_MAX_ETHERTYPES &&
+                        filter->num_ip_protocols <= PCAP_FILTER_MAX_IP_PROTOCOLS && filter->num_ports <= PCAP_FILTER_MAX_PORTS,
+                        ESP_ERR_INVALID_ARG, TAG, "too many filter values");
+    memset(compiled, 0, sizeof(pcap_compiled_filter_t));
+    compiled->frame_types = filter->frame_types ? filter->frame_types : UINT64_MAX;
+    if (filter->num_ip_protocols) {
+        for (int i = 0; i < filter->num_ip_protocols; i++) {
+            bitmap_set(compiled->ip_protocols, filter->ip_protocols[i]);
+        }
+    } else {
+        memset(compiled->ip_protocols, 0xFF, sizeof(compiled->ip_protocols));
+    }
+    for (int i = 0; i < filter->num_ports; i++) {
+        bitmap_set(compiled->port_hash, PORT_HASH(filter->ports[i]));
+    }
+    memcpy(compiled->addrs, filter->addrs, sizeof(compiled->addrs));
+    memcpy(compiled->ethertypes, filter->ethertypes, sizeof(compiled->ethertypes));
+    memcpy(compiled->ports, filter->ports, sizeof(compiled->ports));
+    compiled->num_addrs = filter->num_addrs;
+    compiled->num_ethertypes = filter->num_ethertypes;
+    compiled->num_ports = filter->num_ports;
+    compiled->match_ip = filter->num_ip_protocols || filter->num_ports;
+    compiled->match_network = compiled->match_ip || filter->num_ethertypes;
+    return ESP_OK;
+}
+
+static bool pcap_filter_match_addr(const pcap_compiled_filter_t *filter, const uint8_t *addr)
+{
+    for (int i = 0; i < filter->num_addrs; i++) {
+        if (memcmp(filter->addrs[i], addr, 6) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool pcap_filter_match_port(const pcap_compiled_filter_t *filter, uint16_t port)
+{
+    if (!bitmap_test(filter->port_hash, PORT_HASH(port))) {
+        return false;
+    }
+    for (int i = 0; i < filter->num_ports; i++) {
+        if (filter->ports[i] == port) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Matches the ethertype, and the IP protocol and ports of the packet, data pointing to the network header */
+static bool pcap_filter_match_network(const pcap_compiled_filter_t *filter, uint16_t ethertype, const uint8_t *data,
+                                      uint32_t length)
+{
+    if (filter->num_ethertypes) {
+        int i = 0;
+        while (i < filter->num_ethertypes && filter->ethertypes[i] != ethertype) {
+            i++;
+        }
+        if (i == filter->num_ethertypes) {
+            return false;
+        }
+    }
+    if (!filter->match_ip) {
+        return true;
+    }
+    uint8_t protocol;
+    uint32_t header_length;
+    bool first_fragment;
+    if (ethertype == ETHERTYPE_IPV4) {
+        if (length < 20 || (data[0] >> 4) != 4) {
+            return false;
+        }
+        protocol = data[9];
+        header_length = (data[0] & 0x0F) * 4;
+        first_fragment = (read_be16(data + 6) & 0x1FFF) == 0;
+    } else if (ethertype == ETHERTYPE_IPV6) {
+        if (length < 40 || (data[0] >> 4) != 6) {
+            return false;
+        }
+        /* The extension headers aren't walked, their ports don't match */
+        protocol = data[6];
+        header_length = 40;
+        first_fragment = true;
+    } else {
+        return false;
+    }
+    if (!bitmap_test(filter->ip_protocols, protocol)) {
+        return false;
+    }
+    if (!filter->num_ports) {
+        return true;
+    }
+    if ((protocol != IP_PROTOCOL_TCP && protocol != IP_PROTOCOL_UDP) || !first_fragment || length < header_length + 4) {
+        return false;
+    }
+    return pcap_filter_match_port(filter, read_be16(data + header_length)) ||
+           pcap_filter_match_port(filter, read_be16(data + header_length + 2));
+}
+
+static bool pcap_filter_match_ethernet(const pcap_compiled_filter_t *filter, const uint8_t *data, uint32_t length)
+{
+    if (length < ETH_HEADER_LEN) {
+        return false;
+    }
+    if (filter->num_addrs && !pcap_filter_match_addr(filter, data) && !pcap_filter_match_addr(filter, data + 6)) {
+        return false;
+    }
+    if (!filter->match_network) {
+        return true;
+    }
+    /* Skip the VLAN tags */
+    uint32_t offset = ETH_HEADER_LEN - 2;
+    uint16_t ethertype = read_be16(data + offset);
+    while ((ethertype == ETHERTYPE_VLAN || ethertype == ETHERTYPE_QINQ) && length >= offset + 6) {
+        offset += 4;
+        ethertype = read_be16(data + offset);
+    }
+    offset += 2;
+    return pcap_filter_match_network(filter, ethertype, data + offset, length - offset);
+}
+
+static bool pcap_filter_match_80211(const pcap_compiled_filter_t *filter, const uint8_t *data, uint32_t length)
+{
+    /* The shortest frames, e.g. ACK, have a frame control, a duration and one address */
+    if (length < 10) {
+        return false;
+    }
+    uint8_t type = (data[0] >> 2) & 0x03;
+    uint8_t subtype = data[0] >> 4;
+    if (!(filter->frame_types & (1ULL << (type << 4 | subtype)))) {
+        return false;
+    }
+    if (filter->num_addrs) {
+        /* Receiver, transmitter, and BSSID or source or destination address */
+        bool match = pcap_filter_match_addr(filter, data + 4) ||
+                     (length >= 16 && pcap_filter_match_addr(filter, data + 10)) ||
+                     (type != PCAP_80211_TYPE_CTRL && length >= 22 && pcap_filter_match_addr(filter, data + 16));
+        if (!match) {
+            return false;
+        }
+    }
+    if (!filter->match_network) {
+        return true;
+    }
+    /* Only the unprotected data frames with a payload have a network header */
+    if (type != PCAP_80211_TYPE_DATA || (subtype & IEEE80211_SUBTYPE_NO_DATA) || (data[1] & IEEE80211_FC1_PROTECTED)) {
+        return false;
+    }
+    uint32_t offset = IEEE80211_HEADER_LEN;
+    if ((data[1] & IEEE80211_FC1_DS_MASK) == IEEE80211_FC1_DS_MASK) {
+        offset += 6;
+    }
+    if (subtype & IEEE80211_SUBTYPE_QOS) {
+        offset += 2;
+        if (data[1] & IEEE80211_FC1_ORDER) {
+            offset += 4;
+        }
+    }
+    /* LLC SNAP header, with the RFC 1042 or the bridge tunnel OUI */
+    if (length < offset + LLC_SNAP_LEN) {
+        return false;
+    }
+    const uint8_t *llc = data + offset;
+    if (llc[0] != 0xAA || llc[1] != 0xAA || llc[2] != 0x03 || llc[3] != 0x00 || llc[4] != 0x00 ||
+            (llc[5] != 0x00 && llc[5] != 0xF8)) {
+        return false;
+    }
+    offset += LLC_SNAP_LEN;
+    return pcap_filter_match_network(filter, read_be16(llc + 6), data + offset, length - offset);
+}
+
+bool pcap_filter_match(const pcap_compiled_filter_t *filter, pcap_link_type_t link_type, const uint8_t *data,
+                       uint32_t length)
+{
+    switch (link_type) {
+    case PCAP_LINK_TYPE_ETHERNET:
+        return pcap_filter_match_ethernet(filter, data, length);
+    case PCAP_LINK_TYPE_802_11:
+        return pcap_filter_match_80211(filter, data, length);
+    case PCAP_LINK_TYPE_RAW_IP:
+        /* No link header, so no addresses to match */
+        if (filter->num_addrs || length == 0) {
+            return false;
+        }
+        return pcap_filter_match_network(filter, (data[0] >> 4) == 6 ? ETHERTYPE_IPV6 : ETHERTYPE_IPV4, data, length);
+    default:
+        return true;
+    }
+}
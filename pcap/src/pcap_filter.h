@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pcap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Capture filter compiled into lookup tables
+ *
+ * The 802.11 frame types and the IP protocols are bitmaps indexed by the value of the header, which are all ones when
+ * the criterion isn't set. The ports are looked up in a bitmap indexed by a hash of the port first, so that most of
+ * the packets are rejected without comparing their ports to the list.
+ */
+typedef struct {
+    uint64_t frame_types;                               /*!< Bit (type << 4 | subtype) for the 802.11 frames */
+    uint32_t ip_protocols[8];                           /*!< Bit of each IP protocol */
+    uint32_t port_hash[8];                              /*!< Bit of the hash of each port */
+    uint8_t addrs[PCAP_FILTER_MAX_ADDRS][6];            /*!< MAC addresses */
+    uint16_t ethertypes[PCAP_FILTER_MAX_ETHERTYPES];    /*!< Ethertypes */
+    uint16_t ports[PCAP_FILTER_MAX_PORTS];              /*!< TCP and UDP ports */
+    uint8_t num_addrs;                                  /*!< Number of addresses, 0 for all */
+    uint8_t num_ethertypes;                             /*!< Number of ethertypes, 0 for all */
+    uint8_t num_ports;                                  /*!< Number of ports, 0 for all */
+    bool match_ip;                                      /*!< Filter on the IP protocol or the ports */
+    bool match_network;                                 /*!< Filter on the ethertype, the IP protocol or the ports */
+} pcap_compiled_filter_t;
+
+/**
+ * @brief Compile a capture filter
+ *
+ * @param[in] filter capture filter
+ * @param[out] compiled compiled filter
+ * @return
+ *      - ESP_OK: Compile the filter successfully
+ *      - ESP_ERR_INVALID_ARG: Compile the filter failed because of too many values of a criterion
+ */
+esp_err_t pcap_filter_compile(const pcap_filter_t *filter, pcap_compiled_filter_t *compiled);
+
+/**
+ * @brief Check whether a packet matches a compiled capture filter
+ *
+ * @param[in] filter compiled filter
+ * @param[in] link_type link type of the interface of the packet
+ * @param[in] data packet data
+ * @param[in] length length of the packet data
+ * @return Whether the packet should be captured
+ */
+bool pcap_filter_match(const pcap_compiled_filter_t *filter, pcap_link_type_t link_type, const uint8_t *data,
+                       uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
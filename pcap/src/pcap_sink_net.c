@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/cdefs.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "pcap_sink.h"
+
+static const char *TAG = "pcap_net_sink";
+
+/**
+ * @brief Pcap Network Sink
+ *
+ */
+typedef struct {
+    struct pcap_sink_t base; /*!< Sink interface */
+    int sock;                /*!< Connected socket */
+} pcap_net_sink_t;
+
+static esp_err_t pcap_net_sink_write(pcap_sink_handle_t sink, const void *data, size_t length)
+{
+    pcap_net_sink_t *net_sink = __containerof(sink, pcap_net_sink_t, base);
+    /* A UDP socket sends it all in one datagram, a TCP one may send part of it */
+    for (size_t sent = 0; sent < length;) {
+        ssize_t ret = send(net_sink->sock, (const uint8_t *)data + sent, length - sent, 0);
+        ESP_RETURN_ON_FALSE(ret >= 0, ESP_FAIL, TAG, "send failed, errno %d", errno);
+        sent += ret;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t pcap_net_sink_del(pcap_sink_handle_t sink)
+{
+    pcap_net_sink_t *net_sink = __containerof(sink, pcap_net_sink_t, base);
+    close(net_sink->sock);
+    free(net_sink);
+    return ESP_OK;
+}
+
+esp_err_t pcap_new_net_sink(const pcap_net_sink_config_t *config, pcap_sink_handle_t *ret_sink)
+{
+    esp_err_t ret = ESP_OK;
+    pcap_net_sink_t *net_sink = NULL;
+    struct addrinfo *res = NULL;
+    ESP_GOTO_ON_FALSE(config && config->host && ret_sink, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->protocol == PCAP_NET_SINK_TCP || config->protocol == PCAP_NET_SINK_UDP,
+                      ESP_ERR_INVALID_ARG, err, TAG, "invalid protocol");
+    net_sink = calloc(1, sizeof(pcap_net_sink_t));
+    ESP_GOTO_ON_FALSE(net_sink, ESP_ERR_NO_MEM, err, TAG, "no mem for network sink object");
+    net_sink->sock = -1;
+
+    struct addrinfo hints = {
+        .ai_family = AF_UNSPEC,
+        .ai_socktype = config->protocol == PCAP_NET_SINK_TCP ? SOCK_STREAM : SOCK_DGRAM,
+    };
+    char port[6];
+    snprintf(port, sizeof(port), "%u", config->port);
+    ESP_GOTO_ON_FALSE(getaddrinfo(config->host, port, &hints, &res) == 0 && res, ESP_FAIL, err, TAG,
+                      "resolve %s failed", config->host);
+    net_sink->sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    ESP_GOTO_ON_FALSE(net_sink->sock >= 0, ESP_FAIL, err, TAG, "create socket failed, errno %d", errno);
+    /* Connecting a UDP socket only sets the destination of send() */
+    ESP_GOTO_ON_FALSE(connect(net_sink->sock, res->ai_addr, res->ai_addrlen) == 0, ESP_FAIL, err, TAG,
+                      "connect to %s:%u failed, errno %d", config->host, config->port, errno);
+    freeaddrinfo(res);
+
+    net_sink->base.write = pcap_net_sink_write;
+    net_sink->base.del = pcap_net_sink_del;
+    *ret_sink = &net_sink->base;
+    return ESP_OK;
+err:
+    if (res) {
+        freeaddrinfo(res);
+    }
+    if (net_sink) {
+        if (net_sink->sock >= 0) {
+            close(net_sink->sock);
+        }
+        free(net_sink);
+    }
+    return ret;
+}
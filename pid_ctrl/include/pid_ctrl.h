@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <stddef.h>
 #include "esp_err.h"
+#include "IQmathLib.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -105,6 +107,100 @@ esp_err_t pid_compute(pid_ctrl_block_handle_t pid, float input_error, float *ret
  */
 esp_err_t pid_reset_ctrl_block(pid_ctrl_block_handle_t pid);
 
+/**
+ * @brief Type of PID control batch handle
+ *
+ */
+typedef struct pid_ctrl_batch_t *pid_ctrl_batch_handle_t;
+
+/**
+ * @brief PID control batch configuration
+ *
+ */
+typedef struct {
+    size_t loop_num;                 // Number of control loops in the batch
+    pid_ctrl_parameter_t init_param; // Initial parameters of every loop, the calculation type is the same for all the loops
+    struct {
+        unsigned int fixed_point: 1; // Compute the loops in the GLOBAL_IQ format with `pid_compute_many_iq()` instead of float
+    } flags;
+} pid_ctrl_batch_config_t;
+
+/**
+ * @brief Create a batch of PID control loops, computed together by `pid_compute_many()` or `pid_compute_many_iq()`
+ *
+ * @param[in] config PID control batch configuration
+ * @param[out] ret_batch Returned PID control batch handle
+ * @return
+ *      - ESP_OK: Created PID control batch successfully
+ *      - ESP_ERR_INVALID_ARG: Created PID control batch failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Created PID control batch failed because out of memory
+ */
+esp_err_t pid_new_control_batch(const pid_ctrl_batch_config_t *config, pid_ctrl_batch_handle_t *ret_batch);
+
+/**
+ * @brief Delete the PID control batch
+ *
+ * @param[in] batch PID control batch handle, created by `pid_new_control_batch()`
+ * @return
+ *      - ESP_OK: Delete PID control batch successfully
+ *      - ESP_ERR_INVALID_ARG: Delete PID control batch failed because of invalid argument
+ */
+esp_err_t pid_del_control_batch(pid_ctrl_batch_handle_t batch);
+
+/**
+ * @brief Update the PID parameters of one loop of the batch
+ *
+ * @note For a fixed-point batch, the parameters are converted to the GLOBAL_IQ format, saturating at its range
+ *
+ * @param[in] batch PID control batch handle, created by `pid_new_control_batch()`
+ * @param[in] index Index of the loop in the batch
+ * @param[in] params PID parameters, the calculation type must be the one of the batch
+ * @return
+ *      - ESP_OK: Update PID parameters successfully
+ *      - ESP_ERR_INVALID_ARG: Update PID parameters failed because of invalid argument
+ */
+esp_err_t pid_update_batch_parameters(pid_ctrl_batch_handle_t batch, size_t index, const pid_ctrl_parameter_t *params);
+
+/**
+ * @brief Input the errors of all the loops of the batch and get their PID control results
+ *
+ * @note Placed in IRAM with CONFIG_PID_CTRL_ISR_IRAM_SAFE. The FPU can't be used in ISRs on the targets which have
+ *       one, call `pid_compute_many_iq()` from ISRs there.
+ *
+ * @param[in] batch PID control batch handle, created by `pid_new_control_batch()` without `flags.fixed_point`
+ * @param[in] input_errors errors of the loops, `loop_num` entries
+ * @param[out] ret_results results after PID calculation, `loop_num` entries
+ * @return
+ *      - ESP_OK: Run the PID computes successfully
+ *      - ESP_ERR_INVALID_ARG: Run the PID computes failed because of invalid argument
+ */
+esp_err_t pid_compute_many(pid_ctrl_batch_handle_t batch, const float *input_errors, float *ret_results);
+
+/**
+ * @brief Input the errors of all the loops of the batch and get their PID control results, in the GLOBAL_IQ format
+ *
+ * @note Placed in IRAM with CONFIG_PID_CTRL_ISR_IRAM_SAFE, doesn't use floating-point math
+ * @note GLOBAL_IQ must have the same value for the application and this component
+ *
+ * @param[in] batch PID control batch handle, created by `pid_new_control_batch()` with `flags.fixed_point`
+ * @param[in] input_errors errors of the loops, `loop_num` entries
+ * @param[out] ret_results results after PID calculation, `loop_num` entries
+ * @return
+ *      - ESP_OK: Run the PID computes successfully
+ *      - ESP_ERR_INVALID_ARG: Run the PID computes failed because of invalid argument
+ */
+esp_err_t pid_compute_many_iq(pid_ctrl_batch_handle_t batch, const _iq *input_errors, _iq *ret_results);
+
+/**
+ * @brief Reset the accumulation of all the loops of the batch
+ *
+ * @param[in] batch PID control batch handle, created by `pid_new_control_batch()`
+ * @return
+ *      - ESP_OK: Reset successfully
+ *      - ESP_ERR_INVALID_ARG: Reset failed because of invalid argument
+ */
+esp_err_t pid_reset_ctrl_batch(pid_ctrl_batch_handle_t batch);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,11 +5,23 @@
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <sys/param.h>
+#include "sdkconfig.h"
 #include "esp_check.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "pid_ctrl.h"
 
+#if CONFIG_PID_CTRL_ISR_IRAM_SAFE
+#define PID_CTRL_MEM_ALLOC_CAPS (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#else
+#define PID_CTRL_MEM_ALLOC_CAPS MALLOC_CAP_DEFAULT
+#endif
+
+/* Largest magnitude of the GLOBAL_IQ format */
+#define PID_CTRL_IQ_RANGE ((float)((int64_t)1 << (31 - GLOBAL_IQ)))
+
 static const char *TAG = "pid_ctrl";
 
 typedef struct pid_ctrl_block_t pid_ctrl_block_t;
@@ -81,6 +93,35 @@ static float pid_calc_incremental(pid_ctrl_block_t *pid, float error)
     return output;
 }
 
+/* A value of a batch, depending on the batch type */
+typedef union {
+    float f;
+    _iq q;
+} pid_ctrl_value_t;
+
+typedef struct pid_ctrl_batch_t pid_ctrl_batch_t;
+
+/* The loops of a batch are stored as a structure of arrays, each one indexed by the loop */
+struct pid_ctrl_batch_t {
+    size_t loop_num;               // Number of loops
+    pid_calculate_type_t cal_type; // Calculation type of all the loops
+    bool fixed_point;              // The values are in the GLOBAL_IQ format
+    pid_ctrl_value_t *Kp;            // PID Kp values
+    pid_ctrl_value_t *Ki;            // PID Ki values
+    pid_ctrl_value_t *Kd;            // PID Kd values
+    pid_ctrl_value_t *previous_err1; // e(k-1)
+    pid_ctrl_value_t *previous_err2; // e(k-2)
+    pid_ctrl_value_t *integral_err;  // Sums of error
+    pid_ctrl_value_t *last_output;   // PID outputs in last control period
+    pid_ctrl_value_t *max_output;    // PID maximum output limitations
+    pid_ctrl_value_t *min_output;    // PID minimum output limitations
+    pid_ctrl_value_t *max_integral;  // PID maximum integral value limitations
+    pid_ctrl_value_t *min_integral;  // PID minimum integral value limitations
+    pid_ctrl_value_t values[];       // Storage of the arrays above
+};
+
+#define PID_CTRL_BATCH_ARRAY_NUM 11
+
 esp_err_t pid_new_control_block(const pid_ctrl_config_t *config, pid_ctrl_block_handle_t *ret_pid)
 {
     esp_err_t ret = ESP_OK;
@@ -148,3 +189,183 @@ esp_err_t pid_reset_ctrl_block(pid_ctrl_block_handle_t pid)
     pid->last_output = 0;
     return ESP_OK;
 }
+
+static _iq pid_float_to_iq(float value)
+{
+    /* Saturate instead of overflowing, e.g. for limitations set to FLT_MAX */
+    if (value >= PID_CTRL_IQ_RANGE) {
+        return INT32_MAX;
+    }
+    if (value <= -PID_CTRL_IQ_RANGE) {
+        return INT32_MIN;
+    }
+    return _IQ(value);
+}
+
+static void pid_batch_set_value(pid_ctrl_batch_handle_t batch, pid_ctrl_value_t *array, size_t index, float value)
+{
+    if (batch->fixed_point) {
+        array[index].q = pid_float_to_iq(value);
+    } else {
+        array[index].f = value;
+    }
+}
+
+esp_err_t pid_new_control_batch(const pid_ctrl_batch_config_t *config, pid_ctrl_batch_handle_t *ret_batch)
+{
+    esp_err_t ret = ESP_OK;
+    pid_ctrl_batch_t *batch = NULL;
+    /* Check the input pointer */
+    ESP_GOTO_ON_FALSE(config && ret_batch && config->loop_num, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+
+    batch = heap_caps_calloc(1, sizeof(pid_ctrl_batch_t) + PID_CTRL_BATCH_ARRAY_NUM * config->loop_num * sizeof(pid_ctrl_value_t),
+                             PID_CTRL_MEM_ALLOC_CAPS);
+    ESP_GOTO_ON_FALSE(batch, ESP_ERR_NO_MEM, err, TAG, "no mem for PID control batch");
+    batch->loop_num = config->loop_num;
+    batch->cal_type = config->init_param.cal_type;
+    batch->fixed_point = config->flags.fixed_point;
+    pid_ctrl_value_t **arrays[PID_CTRL_BATCH_ARRAY_NUM] = {
+        &batch->Kp, &batch->Ki, &batch->Kd, &batch->previous_err1, &batch->previous_err2, &batch->integral_err,
+        &batch->last_output, &batch->max_output, &batch->min_output, &batch->max_integral, &batch->min_integral,
+    };
+    for (size_t i = 0; i < PID_CTRL_BATCH_ARRAY_NUM; i++) {
+        *arrays[i] = batch->values + i * config->loop_num;
+    }
+    /* All zero bits are 0 in both float and IQ, the accumulations are already reset */
+    for (size_t i = 0; i < config->loop_num; i++) {
+        ESP_GOTO_ON_ERROR(pid_update_batch_parameters(batch, i, &config->init_param), err, TAG, "init PID parameters failed");
+    }
+    *ret_batch = batch;
+    return ret;
+
+err:
+    if (batch) {
+        free(batch);
+    }
+    return ret;
+}
+
+esp_err_t pid_del_control_batch(pid_ctrl_batch_handle_t batch)
+{
+    ESP_RETURN_ON_FALSE(batch, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    free(batch);
+    return ESP_OK;
+}
+
+esp_err_t pid_update_batch_parameters(pid_ctrl_batch_handle_t batch, size_t index, const pid_ctrl_parameter_t *params)
+{
+    ESP_RETURN_ON_FALSE(batch && params && index < batch->loop_num, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(params->cal_type == PID_CAL_TYPE_INCREMENTAL || params->cal_type == PID_CAL_TYPE_POSITIONAL,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid PID calculation type:%d", params->cal_type);
+    ESP_RETURN_ON_FALSE(params->cal_type == batch->cal_type, ESP_ERR_INVALID_ARG, TAG, "PID calculation type differs from the batch");
+    pid_batch_set_value(batch, batch->Kp, index, params->kp);
+    pid_batch_set_value(batch, batch->Ki, index, params->ki);
+    pid_batch_set_value(batch, batch->Kd, index, params->kd);
+    pid_batch_set_value(batch, batch->max_output, index, params->max_output);
+    pid_batch_set_value(batch, batch->min_output, index, params->min_output);
+    pid_batch_set_value(batch, batch->max_integral, index, params->max_integral);
+    pid_batch_set_value(batch, batch->min_integral, index, params->min_integral);
+    return ESP_OK;
+}
+
+/*
+ * The batch functions take no lock and don't log outside of the argument checks, so that they can run in an ISR.
+ * The loops are written out in each function rather than in helpers, which might not be inlined and then be left in
+ * flash. Same formulas as pid_calc_positional() and pid_calc_incremental().
+ */
+esp_err_t pid_compute_many(pid_ctrl_batch_handle_t batch, const float *input_errors, float *ret_results)
+{
+    ESP_RETURN_ON_FALSE_ISR(batch && input_errors && ret_results && !batch->fixed_point, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (batch->cal_type == PID_CAL_TYPE_POSITIONAL) {
+        for (size_t i = 0; i < batch->loop_num; i++) {
+            float error = input_errors[i];
+            float integral = batch->integral_err[i].f + error;
+            integral = MIN(integral, batch->max_integral[i].f);
+            integral = MAX(integral, batch->min_integral[i].f);
+            batch->integral_err[i].f = integral;
+
+            float output = error * batch->Kp[i].f +
+                           (error - batch->previous_err1[i].f) * batch->Kd[i].f +
+                           integral * batch->Ki[i].f;
+            output = MIN(output, batch->max_output[i].f);
+            output = MAX(output, batch->min_output[i].f);
+
+            batch->previous_err1[i].f = error;
+            ret_results[i] = output;
+        }
+    } else {
+        for (size_t i = 0; i < batch->loop_num; i++) {
+            float error = input_errors[i];
+            float error1 = batch->previous_err1[i].f;
+            float output = (error - error1) * batch->Kp[i].f +
+                           (error - 2 * error1 + batch->previous_err2[i].f) * batch->Kd[i].f +
+                           error * batch->Ki[i].f +
+                           batch->last_output[i].f;
+            output = MIN(output, batch->max_output[i].f);
+            output = MAX(output, batch->min_output[i].f);
+
+            batch->previous_err2[i].f = error1;
+            batch->previous_err1[i].f = error;
+            batch->last_output[i].f = output;
+            ret_results[i] = output;
+        }
+    }
+    return ESP_OK;
+}
+
+/*
+ * The products are accumulated in 64 bits and shifted back to GLOBAL_IQ once, like _IQmpy() does for each product
+ * but without calling it, and the sums saturate at the limitations instead of wrapping around.
+ */
+esp_err_t pid_compute_many_iq(pid_ctrl_batch_handle_t batch, const _iq *input_errors, _iq *ret_results)
+{
+    ESP_RETURN_ON_FALSE_ISR(batch && input_errors && ret_results && batch->fixed_point, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (batch->cal_type == PID_CAL_TYPE_POSITIONAL) {
+        for (size_t i = 0; i < batch->loop_num; i++) {
+            _iq error = input_errors[i];
+            int64_t integral = (int64_t)batch->integral_err[i].q + error;
+            integral = MIN(integral, batch->max_integral[i].q);
+            integral = MAX(integral, batch->min_integral[i].q);
+            batch->integral_err[i].q = (_iq)integral;
+
+            int64_t output = ((int64_t)error * batch->Kp[i].q +
+                              (int64_t)(error - batch->previous_err1[i].q) * batch->Kd[i].q +
+                              integral * batch->Ki[i].q) >> GLOBAL_IQ;
+            output = MIN(output, batch->max_output[i].q);
+            output = MAX(output, batch->min_output[i].q);
+
+            batch->previous_err1[i].q = error;
+            ret_results[i] = (_iq)output;
+        }
+    } else {
+        for (size_t i = 0; i < batch->loop_num; i++) {
+            _iq error = input_errors[i];
+            _iq error1 = batch->previous_err1[i].q;
+            int64_t output = (((int64_t)(error - error1) * batch->Kp[i].q +
+                               (int64_t)(error - 2 * error1 + batch->previous_err2[i].q) * batch->Kd[i].q +
+                               (int64_t)error * batch->Ki[i].q) >> GLOBAL_IQ) +
+                             batch->last_output[i].q;
+            output = MIN(output, batch->max_output[i].q);
+            output = MAX(output, batch->min_output[i].q);
+
+            batch->previous_err2[i].q = error1;
+            batch->previous_err1[i].q = error;
+            batch->last_output[i].q = (_iq)output;
+            ret_results[i] = (_iq)output;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t pid_reset_ctrl_batch(pid_ctrl_batch_handle_t batch)
+{
+    ESP_RETURN_ON_FALSE(batch, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    for (size_t i = 0; i < batch->loop_num; i++) {
+        /* All zero bits are 0 in both float and IQ */
+        batch->integral_err[i].q = 0;
+        batch->previous_err1[i].q = 0;
+        batch->previous_err2[i].q = 0;
+        batch->last_output[i].q = 0;
+    }
+    return ESP_OK;
+}
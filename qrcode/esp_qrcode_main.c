@@ -5,7 +5,11 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
 #include <esp_err.h>
+#include "sdkconfig.h"
 #include "esp_log.h"
 
 #include "qrcodegen.h"
@@ -60,9 +64,250 @@ void esp_qrcode_print_console(esp_qrcode_handle_t qrcode)
     printf("\n");
 }
 
+static enum qrcodegen_Ecc qrcode_ecc_level(int level)
+{
+    switch (level) {
+    case ESP_QRCODE_ECC_LOW:
+        return qrcodegen_Ecc_LOW;
+    case ESP_QRCODE_ECC_MED:
+        return qrcodegen_Ecc_MEDIUM;
+    case ESP_QRCODE_ECC_QUART:
+        return qrcodegen_Ecc_QUARTILE;
+    case ESP_QRCODE_ECC_HIGH:
+        return qrcodegen_Ecc_HIGH;
+    default:
+        return qrcodegen_Ecc_LOW;
+    }
+}
+
+#if CONFIG_QRCODE_OPTIMIZE_SEGMENTS
+/*
+ * Optimal segmentation of the text, see makeSegmentsOptimally() of QrSegmentAdvanced in QR-Code-generator.
+ *
+ * qrcodegen_encodeText() encodes the whole text in the mode fitting all its characters, bytes as soon as there is a
+ * lower case letter. Instead, each character gets the numeric, alphanumeric or byte mode giving the fewest bits for
+ * the whole text, accounting for the header of each new segment, by dynamic programming over the characters. The
+ * costs are counted in sixths of a bit, so that the digits (10 bits for 3) and the alphanumeric characters (11 bits
+ * for 2) have whole costs. The length of the character count of the headers depends on the version, so the text is
+ * segmented for each group of versions in turn.
+ */
+#define SEG_MODE_BYTE           0
+#define SEG_MODE_ALPHANUMERIC   1
+#define SEG_MODE_NUMERIC        2
+#define SEG_MODE_NUM            3
+
+static const enum qrcodegen_Mode s_seg_modes[SEG_MODE_NUM] = {
+    qrcodegen_Mode_BYTE, qrcodegen_Mode_ALPHANUMERIC, qrcodegen_Mode_NUMERIC,
+};
+// Character count bits of each mode, for versions 1-9, 10-26 and 27-40
+static const uint8_t s_seg_count_bits[SEG_MODE_NUM][3] = {{8, 16, 16}, {9, 11, 13}, {10, 12, 14}};
+static const uint8_t s_seg_char_costs[SEG_MODE_NUM] = {8 * 6, 33, 20};
+static const uint8_t s_seg_group_versions[3][2] = {{1, 9}, {10, 26}, {27, 40}};
+
+// Value of an alphanumeric character, -1 for other characters
+static int qrcode_alnum_value(char c)
+{
+    static const char symbols[] = " $%*+-./:";
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    const char *p = c ? strchr(symbols, c) : NULL;
+    return p ? 36 + (p - symbols) : -1;
+}
+
+static void qrcode_append_bits(uint32_t val, int num_bits, uint8_t *buf, int *bit_len)
+{
+    for (int i = num_bits - 1; i >= 0; i--, (*bit_len)++) {
+        buf[*bit_len >> 3] |= ((val >> i) & 1) << (7 - (*bit_len & 7));
+    }
+}
+
+/*
+ * Writes the mode of each character of the text to modes. While going forward, modes[i] holds, 2 bits per mode, 1 +
+ * the mode of character i on the cheapest path to the character after it being in that mode, 0 when there is no
+ * such path. Going backward from the cheapest mode of the last character then replaces it with the mode of
+ * character i.
+ */
+static void qrcode_choose_modes(const char *text, size_t len, int group, uint8_t *modes)
+{
+    uint32_t head_costs[SEG_MODE_NUM];
+    uint32_t costs[SEG_MODE_NUM];
+    for (int m = 0; m < SEG_MODE_NUM; m++) {
+        head_costs[m] = (4 + s_seg_count_bits[m][group]) * 6;
+        costs[m] = head_costs[m];
+    }
+    for (size_t i = 0; i < len; i++) {
+        int value = qrcode_alnum_value(text[i]);
+        bool fits[SEG_MODE_NUM] = {true, value >= 0, value >= 0 && value < 10};
+        uint32_t end_costs[SEG_MODE_NUM];
+        uint8_t choices = 0;
+        for (int m = 0; m < SEG_MODE_NUM; m++) {
+            if (fits[m]) {
+                end_costs[m] = costs[m] + s_seg_char_costs[m];
+                choices |= (m + 1) << (2 * m);
+            }
+        }
+        // Start a new segment after the character, the previous one ending on a whole bit
+        for (int to = 0; to < SEG_MODE_NUM; to++) {
+            costs[to] = fits[to] ? end_costs[to] : UINT32_MAX;
+            for (int from = 0; from < SEG_MODE_NUM; from++) {
+                if (fits[from] && from != to) {
+                    uint32_t cost = (end_costs[from] + 5) / 6 * 6 + head_costs[to];
+                    if (cost < costs[to]) {
+                        costs[to] = cost;
+                        choices = (choices & ~(3 << (2 * to))) | (from + 1) << (2 * to);
+                    }
+                }
+            }
+        }
+        modes[i] = choices;
+    }
+    int mode = SEG_MODE_BYTE;
+    for (int m = 0; m < SEG_MODE_NUM; m++) {
+        if (costs[m] < costs[mode]) {
+            mode = m;
+        }
+    }
+    for (size_t i = len; i-- > 0;) {
+        mode = ((modes[i] >> (2 * mode)) & 3) - 1;
+        modes[i] = mode;
+    }
+}
+
+/*
+ * Encodes the text in optimal segments into a QR Code of a version of the group. The modes of the characters are
+ * computed in qrcode, and the segments are then laid out in tempbuf, both being free until the encoding starts.
+ * Returns ESP_ERR_INVALID_SIZE if the text doesn't fit in the versions, ESP_ERR_NO_MEM if the segments don't fit in
+ * the buffers.
+ */
+static esp_err_t qrcode_encode_optimal_segments(const char *text, size_t len, int group, uint8_t tempbuf[],
+        uint8_t qrcode[], size_t buf_len, enum qrcodegen_Ecc ecl, int min_version, int max_version,
+        enum qrcodegen_Mask mask)
+{
+    if (len > buf_len) {
+        return ESP_ERR_NO_MEM;
+    }
+    qrcode_choose_modes(text, len, group, qrcode);
+    size_t num_segs = 1;
+    for (size_t i = 1; i < len; i++) {
+        num_segs += qrcode[i] != qrcode[i - 1];
+    }
+    size_t align = _Alignof(struct qrcodegen_Segment);
+    size_t segs_offset = (align - (uintptr_t)tempbuf % align) % align;
+    size_t data_offset = segs_offset + num_segs * sizeof(struct qrcodegen_Segment);
+    if (data_offset > buf_len) {
+        return ESP_ERR_NO_MEM;
+    }
+    struct qrcodegen_Segment *segs = (struct qrcodegen_Segment *)(tempbuf + segs_offset);
+    memset(tempbuf + data_offset, 0, buf_len - data_offset);
+    size_t start = 0;
+    for (size_t s = 0; s < num_segs; s++) {
+        int mode = qrcode[start];
+        size_t end = start + 1;
+        while (end < len && qrcode[end] == mode) {
+            end++;
+        }
+        size_t num_chars = end - start;
+        size_t data_len = (s_seg_char_costs[mode] * num_chars + 47) / 48;
+        if (data_offset + data_len > buf_len) {
+            return ESP_ERR_NO_MEM;
+        }
+        uint8_t *data = tempbuf + data_offset;
+        int bit_len = 0;
+        if (mode == SEG_MODE_NUMERIC) {
+            for (size_t i = start; i < end; i += 3) {
+                size_t n = end - i < 3 ? end - i : 3;
+                uint32_t val = 0;
+                for (size_t j = 0; j < n; j++) {
+                    val = val * 10 + (text[i + j] - '0');
+                }
+                qrcode_append_bits(val, n * 3 + 1, data, &bit_len);
+            }
+        } else if (mode == SEG_MODE_ALPHANUMERIC) {
+            for (size_t i = start; i < end; i += 2) {
+                if (end - i >= 2) {
+                    qrcode_append_bits(qrcode_alnum_value(text[i]) * 45 + qrcode_alnum_value(text[i + 1]), 11, data, &bit_len);
+                } else {
+                    qrcode_append_bits(qrcode_alnum_value(text[i]), 6, data, &bit_len);
+                }
+            }
+        } else {
+            memcpy(data, text + start, num_chars);
+            bit_len = num_chars * 8;
+        }
+        segs[s] = (struct qrcodegen_Segment) {
+            .mode = s_seg_modes[mode],
+            .numChars = num_chars,
+            .data = data,
+            .bitLength = bit_len,
+        };
+        data_offset += data_len;
+        start = end;
+    }
+    if (!qrcodegen_encodeSegmentsAdvanced(segs, num_segs, ecl, min_version, max_version, mask, true, tempbuf, qrcode)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ESP_OK;
+}
+#endif
+
+// Same as qrcodegen_encodeText(), with optimal segments when enabled
+static bool qrcode_encode_text(const char *text, uint8_t tempbuf[], uint8_t qrcode[], enum qrcodegen_Ecc ecl,
+                               int min_version, int max_version, enum qrcodegen_Mask mask)
+{
+#if CONFIG_QRCODE_OPTIMIZE_SEGMENTS
+    // A numeric text is a single numeric segment anyway
+    size_t len = strlen(text);
+    if (len > 0 && !qrcodegen_isNumeric(text)) {
+        size_t buf_len = qrcodegen_BUFFER_LEN_FOR_VERSION(max_version);
+        for (int group = 0; group < 3; group++) {
+            int min = MAX(min_version, s_seg_group_versions[group][0]);
+            int max = MIN(max_version, s_seg_group_versions[group][1]);
+            if (min > max) {
+                continue;
+            }
+            esp_err_t err = qrcode_encode_optimal_segments(text, len, group, tempbuf, qrcode, buf_len, ecl, min, max, mask);
+            if (err == ESP_OK) {
+                return true;
+            }
+            if (err == ESP_ERR_NO_MEM) {
+                break;
+            }
+        }
+    }
+#endif
+    return qrcodegen_encodeText(text, tempbuf, qrcode, ecl, min_version, max_version, mask, true);
+}
+
+esp_err_t esp_qrcode_generate_with_buffers(const esp_qrcode_config_t *cfg, const char *text, uint8_t *qrcode,
+        uint8_t *tempbuf)
+{
+    if (!cfg || !text || !qrcode || !tempbuf) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    enum qrcodegen_Ecc ecc_lvl = qrcode_ecc_level(cfg->qrcode_ecc_level);
+
+    ESP_LOGI(TAG, "Encoding below text with ECC LVL %d & QR Code Version %d",
+             ecc_lvl, cfg->max_qrcode_version);
+    ESP_LOGI(TAG, "%s", text);
+    // Make and print the QR Code symbol
+    bool ok = qrcode_encode_text(text, tempbuf, qrcode, ecc_lvl,
+                                 qrcodegen_VERSION_MIN, cfg->max_qrcode_version,
+                                 qrcodegen_Mask_AUTO);
+    if (!ok) {
+        return ESP_FAIL;
+    }
+    if (cfg->display_func) {
+        cfg->display_func((esp_qrcode_handle_t)qrcode);
+    }
+    return ESP_OK;
+}
+
 esp_err_t esp_qrcode_generate(esp_qrcode_config_t *cfg, const char *text)
 {
-    enum qrcodegen_Ecc ecc_lvl;
     uint8_t *qrcode, *tempbuf;
     esp_err_t err = ESP_FAIL;
 
@@ -77,37 +322,113 @@ esp_err_t esp_qrcode_generate(esp_qrcode_config_t *cfg, const char *text)
         return ESP_ERR_NO_MEM;
     }
 
-    switch (cfg->qrcode_ecc_level) {
-    case ESP_QRCODE_ECC_LOW:
-        ecc_lvl = qrcodegen_Ecc_LOW;
-        break;
-    case ESP_QRCODE_ECC_MED:
-        ecc_lvl = qrcodegen_Ecc_MEDIUM;
-        break;
-    case ESP_QRCODE_ECC_QUART:
-        ecc_lvl = qrcodegen_Ecc_QUARTILE;
-        break;
-    case ESP_QRCODE_ECC_HIGH:
-        ecc_lvl = qrcodegen_Ecc_HIGH;
-        break;
-    default:
-        ecc_lvl = qrcodegen_Ecc_LOW;
-        break;
-    }
-
-    ESP_LOGI(TAG, "Encoding below text with ECC LVL %d & QR Code Version %d",
-             ecc_lvl, cfg->max_qrcode_version);
-    ESP_LOGI(TAG, "%s", text);
-    // Make and print the QR Code symbol
-    bool ok = qrcodegen_encodeText(text, tempbuf, qrcode, ecc_lvl,
-                                   qrcodegen_VERSION_MIN, cfg->max_qrcode_version,
-                                   qrcodegen_Mask_AUTO, true);
-    if (ok && cfg->display_func) {
-        cfg->display_func((esp_qrcode_handle_t)qrcode);
-        err = ESP_OK;
+    err = esp_qrcode_generate_with_buffers(cfg, text, qrcode, tempbuf);
+    // Kept for compatibility, esp_qrcode_generate() has always failed without display function
+    if (err == ESP_OK && !cfg->display_func) {
+        err = ESP_FAIL;
     }
 
     free(qrcode);
     free(tempbuf);
     return err;
 }
+
+struct esp_qrcode_generator {
+    esp_qrcode_config_t cfg;
+    uint8_t *qrcode;
+    uint8_t *tempbuf;
+    char *text;             // Text of the QR Code in qrcode, NULL if there is none
+    size_t text_size;
+};
+
+// Mask of a QR Code, from its format bits, see drawFormatBits() in qrcodegen.c
+static enum qrcodegen_Mask qrcode_get_mask(const uint8_t *qrcode)
+{
+    int bits = 0;
+    for (int i = 0; i <= 5; i++) {
+        bits |= qrcodegen_getModule(qrcode, 8, i) << i;
+    }
+    bits |= qrcodegen_getModule(qrcode, 8, 7) << 6;
+    bits |= qrcodegen_getModule(qrcode, 8, 8) << 7;
+    bits |= qrcodegen_getModule(qrcode, 7, 8) << 8;
+    for (int i = 9; i < 15; i++) {
+        bits |= qrcodegen_getModule(qrcode, 14 - i, 8) << i;
+    }
+    return (enum qrcodegen_Mask)(((bits ^ 0x5412) >> 10) & 7);
+}
+
+esp_err_t esp_qrcode_generator_create(const esp_qrcode_config_t *cfg, esp_qrcode_generator_handle_t *ret_gen)
+{
+    if (!cfg || !ret_gen || cfg->max_qrcode_version < qrcodegen_VERSION_MIN ||
+            cfg->max_qrcode_version > qrcodegen_VERSION_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_qrcode_generator_handle_t gen = calloc(1, sizeof(struct esp_qrcode_generator));
+    if (!gen) {
+        return ESP_ERR_NO_MEM;
+    }
+    gen->cfg = *cfg;
+    gen->qrcode = calloc(1, qrcodegen_BUFFER_LEN_FOR_VERSION(cfg->max_qrcode_version));
+    gen->tempbuf = calloc(1, qrcodegen_BUFFER_LEN_FOR_VERSION(cfg->max_qrcode_version));
+    if (!gen->qrcode || !gen->tempbuf) {
+        esp_qrcode_generator_delete(gen);
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_gen = gen;
+    return ESP_OK;
+}
+
+esp_err_t esp_qrcode_generator_generate(esp_qrcode_generator_handle_t gen, const char *text)
+{
+    if (!gen || !text) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!gen->text || strcmp(gen->text, text) != 0) {
+        size_t text_size = strlen(text) + 1;
+        if (text_size > gen->text_size) {
+            char *buf = realloc(gen->text, text_size);
+            if (!buf) {
+                return ESP_ERR_NO_MEM;
+            }
+            gen->text = buf;
+            gen->text_size = text_size;
+        }
+
+        enum qrcodegen_Ecc ecc_lvl = qrcode_ecc_level(gen->cfg.qrcode_ecc_level);
+        bool ok = false;
+        ESP_LOGD(TAG, "Encoding %s", text);
+        // The size of the previous QR Code is 0 if there is none
+        if (gen->cfg.reuse_mask && gen->qrcode[0]) {
+            int version = (qrcodegen_getSize(gen->qrcode) - 17) / 4;
+            enum qrcodegen_Mask mask = qrcode_get_mask(gen->qrcode);
+            ok = qrcode_encode_text(text, gen->tempbuf, gen->qrcode, ecc_lvl, version, version, mask);
+        }
+        if (!ok) {
+            ok = qrcode_encode_text(text, gen->tempbuf, gen->qrcode, ecc_lvl, qrcodegen_VERSION_MIN,
+                                    gen->cfg.max_qrcode_version, qrcodegen_Mask_AUTO);
+        }
+        if (!ok) {
+            // qrcode isn't a valid QR Code anymore
+            gen->qrcode[0] = 0;
+            free(gen->text);
+            gen->text = NULL;
+            gen->text_size = 0;
+            return ESP_FAIL;
+        }
+        memcpy(gen->text, text, text_size);
+    }
+    if (gen->cfg.display_func) {
+        gen->cfg.display_func((esp_qrcode_handle_t)gen->qrcode);
+    }
+    return ESP_OK;
+}
+
+void esp_qrcode_generator_delete(esp_qrcode_generator_handle_t gen)
+{
+    if (gen) {
+        free(gen->qrcode);
+        free(gen->tempbuf);
+        free(gen->text);
+        free(gen);
+    }
+}
@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <esp_err.h>
+
+#include "qrcodegen.h"
+#include "qrcode.h"
+
+static bool render_config_valid(const esp_qrcode_render_config_t *cfg)
+{
+    return cfg && cfg->scale >= 1 && cfg->border >= 0 &&
+           (cfg->format == ESP_QRCODE_PIXEL_FORMAT_RGB565 || cfg->format == ESP_QRCODE_PIXEL_FORMAT_MONO);
+}
+
+int esp_qrcode_get_render_size(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg)
+{
+    return (qrcodegen_getSize(qrcode) + 2 * cfg->border) * cfg->scale;
+}
+
+size_t esp_qrcode_get_render_stride(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg)
+{
+    int width = esp_qrcode_get_render_size(qrcode, cfg);
+    return cfg->format == ESP_QRCODE_PIXEL_FORMAT_MONO ? (width + 7) / 8 : width * sizeof(uint16_t);
+}
+
+/*
+ * Renders one row of modules into one row of pixels. The modules are packed row by row, LSB first, after the size
+ * byte, so the modules of a row are read one after the other instead of computing the position of each of them.
+ */
+static void render_module_row(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, int y, uint8_t *line,
+                              size_t stride)
+{
+    int size = qrcodegen_getSize(qrcode);
+    bool in_qrcode = 0 <= y && y < size;
+    int index = y * size;
+    int px = 0;
+
+    if (cfg->format == ESP_QRCODE_PIXEL_FORMAT_MONO) {
+        memset(line, 0, stride);
+    }
+    for (int x = -cfg->border; x < size + cfg->border; x++) {
+        bool black = false;
+        if (in_qrcode && 0 <= x && x < size) {
+            black = (qrcode[(index >> 3) + 1] >> (index & 7)) & 1;
+            index++;
+        }
+        if (cfg->format == ESP_QRCODE_PIXEL_FORMAT_RGB565) {
+            uint16_t *pixels = (uint16_t *)line + px;
+            uint16_t color = black ? cfg->black_color : cfg->white_color;
+            for (int i = 0; i < cfg->scale; i++) {
+                pixels[i] = color;
+            }
+        } else if (black) {
+            for (int i = px; i < px + cfg->scale; i++) {
+                line[i >> 3] |= 0x80 >> (i & 7);
+            }
+        }
+        px += cfg->scale;
+    }
+}
+
+/* Renders the pixel rows [y_start, y_end), each row of modules being rendered once and copied to the next rows */
+static void render_rows(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, int y_start, int y_end,
+                        uint8_t *buf, size_t stride)
+{
+    uint8_t *prev_line = NULL;
+    int prev_y = 0;
+    for (int py = y_start; py < y_end; py++) {
+        uint8_t *line = buf + (size_t)(py - y_start) * stride;
+        int y = py / cfg->scale - cfg->border;
+        if (prev_line && y == prev_y) {
+            memcpy(line, prev_line, stride);
+        } else {
+            render_module_row(qrcode, cfg, y, line, stride);
+        }
+        prev_line = line;
+        prev_y = y;
+    }
+}
+
+esp_err_t esp_qrcode_render(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, void *buf, size_t buf_size)
+{
+    if (!qrcode || !buf || !render_config_valid(cfg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int height = esp_qrcode_get_render_size(qrcode, cfg);
+    size_t stride = esp_qrcode_get_render_stride(qrcode, cfg);
+    if (buf_size < stride * height) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    render_rows(qrcode, cfg, 0, height, buf, stride);
+    return ESP_OK;
+}
+
+esp_err_t esp_qrcode_render_bands(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, void *buf,
+                                  size_t buf_size, esp_qrcode_draw_cb_t draw_cb, void *user_ctx)
+{
+    if (!qrcode || !buf || !draw_cb || !render_config_valid(cfg)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int height = esp_qrcode_get_render_size(qrcode, cfg);
+    size_t stride = esp_qrcode_get_render_stride(qrcode, cfg);
+    int band_rows = buf_size / stride;
+    if (band_rows == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    for (int y = 0; y < height; y += band_rows) {
+        int y_end = y + band_rows < height ? y + band_rows : height;
+        render_rows(qrcode, cfg, y, y_end, buf, stride);
+        esp_err_t err = draw_cb(user_ctx, y, y_end, buf);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
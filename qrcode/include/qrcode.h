@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <esp_err.h>
 
 #ifdef __cplusplus
@@ -24,8 +25,21 @@ typedef struct {
     void (*display_func)(esp_qrcode_handle_t qrcode);   /**< Function called for displaying the QR Code after encoding is complete */
     int max_qrcode_version;                             /**< Max QR Code Version to be used. Range: 2 - 40 */
     int qrcode_ecc_level;                               /**< Error Correction Level for QR Code */
+    bool reuse_mask;                                    /**< Generator only: encode the next texts with the version and
+                                                             mask of the previous QR Code when they fit, which skips the
+                                                             mask selection and keeps the size of the QR Code */
 } esp_qrcode_config_t;
 
+/**
+  * @brief  Size of the buffers for a QR Code of up to the given version
+  */
+#define ESP_QRCODE_BUFFER_LEN_FOR_VERSION(n)  ((((n) * 4 + 17) * ((n) * 4 + 17) + 7) / 8 + 1)
+
+/**
+  * @brief  QR Code generator handle, keeping its buffers from one QR Code to the next
+  */
+typedef struct esp_qrcode_generator *esp_qrcode_generator_handle_t;
+
 /**
   * @brief  Error Correction Level in a QR Code Symbol
   */
@@ -52,6 +66,60 @@ enum {
   */
 esp_err_t esp_qrcode_generate(esp_qrcode_config_t *cfg, const char *text);
 
+/**
+  * @brief  Encodes the given string into a QR Code in the given buffers and calls the display function
+  *
+  * Same as esp_qrcode_generate(), without allocating the buffers.
+  *
+  * @param  cfg      Configuration used for QR Code encoding.
+  * @param  text     String to encode into a QR Code.
+  * @param  qrcode   Buffer of ESP_QRCODE_BUFFER_LEN_FOR_VERSION(max_qrcode_version) bytes for the QR Code.
+  * @param  tempbuf  Buffer of ESP_QRCODE_BUFFER_LEN_FOR_VERSION(max_qrcode_version) bytes for the encoding.
+  *
+  * @return
+  *    - ESP_OK: succeed
+  *    - ESP_ERR_INVALID_ARG: Invalid arguments
+  *    - ESP_FAIL: Failed to encode string into a QR Code
+  */
+esp_err_t esp_qrcode_generate_with_buffers(const esp_qrcode_config_t *cfg, const char *text, uint8_t *qrcode,
+        uint8_t *tempbuf);
+
+/**
+  * @brief  Creates a QR Code generator, allocating its buffers once for all the QR Codes it generates
+  *
+  * @param  cfg      Configuration used for QR Code encoding, copied by the generator.
+  * @param  ret_gen  Returned generator handle.
+  *
+  * @return
+  *    - ESP_OK: succeed
+  *    - ESP_ERR_INVALID_ARG: Invalid arguments
+  *    - ESP_ERR_NO_MEM: Failed to allocate buffer for given max_qrcode_version
+  */
+esp_err_t esp_qrcode_generator_create(const esp_qrcode_config_t *cfg, esp_qrcode_generator_handle_t *ret_gen);
+
+/**
+  * @brief  Encodes the given string into a QR Code and calls the display function
+  *
+  * When the text is the same as the previous one, the previous QR Code is displayed again without encoding it.
+  *
+  * @param  gen   Generator handle.
+  * @param  text  String to encode into a QR Code.
+  *
+  * @return
+  *    - ESP_OK: succeed
+  *    - ESP_ERR_INVALID_ARG: Invalid arguments
+  *    - ESP_ERR_NO_MEM: Failed to allocate the copy of the text
+  *    - ESP_FAIL: Failed to encode string into a QR Code
+  */
+esp_err_t esp_qrcode_generator_generate(esp_qrcode_generator_handle_t gen, const char *text);
+
+/**
+  * @brief  Deletes a QR Code generator
+  *
+  * @param  gen  Generator handle.
+  */
+void esp_qrcode_generator_delete(esp_qrcode_generator_handle_t gen);
+
 /**
   * @brief  Displays QR Code on the console
   *
@@ -86,6 +154,109 @@ int esp_qrcode_get_size(esp_qrcode_handle_t qrcode);
   */
 bool esp_qrcode_get_module(esp_qrcode_handle_t qrcode, int x, int y);
 
+/**
+  * @brief  Pixel format of the rendered QR Code
+  */
+typedef enum {
+    ESP_QRCODE_PIXEL_FORMAT_RGB565,     /**< 16 bits per pixel, with the colors of esp_qrcode_render_config_t */
+    ESP_QRCODE_PIXEL_FORMAT_MONO,       /**< 1 bit per pixel, MSB first, set for black. Rows are padded to a byte */
+} esp_qrcode_pixel_format_t;
+
+/**
+  * @brief  QR Code rendering options
+  */
+typedef struct {
+    esp_qrcode_pixel_format_t format;   /**< Pixel format of the buffer */
+    int scale;                          /**< Pixels per module, at least 1 */
+    int border;                         /**< Modules of white border around the QR Code, 4 for the standard margin */
+    uint16_t black_color;               /**< RGB565 value of the black modules, byte swapped if the panel requires it */
+    uint16_t white_color;               /**< RGB565 value of the white modules and of the border */
+} esp_qrcode_render_config_t;
+
+/**
+  * @brief  Function called by esp_qrcode_render_bands() for each band of rendered rows
+  *
+  * @param  user_ctx  user_ctx given to esp_qrcode_render_bands().
+  * @param  y_start   First pixel row of the band.
+  * @param  y_end     Pixel row after the last row of the band.
+  * @param  pixels    Rendered rows, the whole width of the image.
+  *
+  * @return
+  *    - ESP_OK: continue rendering
+  *    - Any other value stops the rendering and is returned by esp_qrcode_render_bands()
+  */
+typedef esp_err_t (*esp_qrcode_draw_cb_t)(void *user_ctx, int y_start, int y_end, const void *pixels);
+
+/**
+  * @brief  Returns the side length of the rendered QR Code in pixels, border included
+  *
+  * @param  qrcode  QR Code handle used by the display function.
+  * @param  cfg     Rendering options.
+  *
+  * @return Side length in pixels
+  */
+int esp_qrcode_get_render_size(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg);
+
+/**
+  * @brief  Returns the size of one rendered row of pixels in bytes
+  *
+  * @param  qrcode  QR Code handle used by the display function.
+  * @param  cfg     Rendering options.
+  *
+  * @return Row size in bytes
+  */
+size_t esp_qrcode_get_render_stride(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg);
+
+/**
+  * @brief  Renders the QR Code into an image buffer
+  *
+  * Each row of modules is expanded once into a row of pixels, which is then repeated scale times, so that the whole
+  * image can be drawn with a single call, e.g. to esp_lcd_panel_draw_bitmap(), instead of module by module with
+  * esp_qrcode_get_module().
+  *
+  * @param  qrcode    QR Code handle used by the display function.
+  * @param  cfg       Rendering options.
+  * @param  buf       Image buffer, of esp_qrcode_get_render_size() rows of esp_qrcode_get_render_stride() bytes,
+  *                   16 bit aligned for RGB565.
+  * @param  buf_size  Size of buf.
+  *
+  * @return
+  *    - ESP_OK: succeed
+  *    - ESP_ERR_INVALID_ARG: Invalid options
+  *    - ESP_ERR_INVALID_SIZE: buf is too small
+  */
+esp_err_t esp_qrcode_render(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, void *buf, size_t buf_size);
+
+/**
+  * @brief  Renders the QR Code band by band, for images larger than the memory available
+  *
+  * Renders as many rows of pixels into buf as it can hold, calls draw_cb with them, and so on until the bottom of
+  * the image.
+  *
+  * @param  qrcode    QR Code handle used by the display function.
+  * @param  cfg       Rendering options.
+  * @param  buf       Band buffer, at least esp_qrcode_get_render_stride() bytes.
+  * @param  buf_size  Size of buf.
+  * @param  draw_cb   Function called with each band.
+  * @param  user_ctx  Passed to draw_cb.
+  *
+  * @return
+  *    - ESP_OK: succeed
+  *    - ESP_ERR_INVALID_ARG: Invalid options
+  *    - ESP_ERR_INVALID_SIZE: buf is too small for a row
+  *    - Error returned by draw_cb
+  */
+esp_err_t esp_qrcode_render_bands(esp_qrcode_handle_t qrcode, const esp_qrcode_render_config_t *cfg, void *buf,
+                                  size_t buf_size, esp_qrcode_draw_cb_t draw_cb, void *user_ctx);
+
+#define ESP_QRCODE_RENDER_CONFIG_DEFAULT() (esp_qrcode_render_config_t) { \
+    .format = ESP_QRCODE_PIXEL_FORMAT_RGB565, \
+    .scale = 4, \
+    .border = 4, \
+    .black_color = 0x0000, \
+    .white_color = 0xFFFF, \
+}
+
 #define ESP_QRCODE_CONFIG_DEFAULT() (esp_qrcode_config_t) { \
     .display_func = esp_qrcode_print_console, \
     .max_qrcode_version = 10, \
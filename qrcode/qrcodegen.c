@@ -25,6 +25,7 @@
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
+#include "sdkconfig.h"
 #include "qrcodegen.h"
 
 #ifndef QRCODEGEN_TEST
@@ -72,6 +73,11 @@ static void fillRectangle(int left, int top, int width, int height, uint8_t qrco
 static void drawCodewords(const uint8_t data[], int dataLen, uint8_t qrcode[]);
 static void applyMask(const uint8_t functionModules[], uint8_t qrcode[], enum qrcodegen_Mask mask);
 static long getPenaltyScore(const uint8_t qrcode[]);
+#if CONFIG_QRCODE_FAST_ENCODING
+static void getLineBits(const uint8_t qrcode[], int index, int step, int len, uint32_t line[]);
+static int getRunEnd(const uint32_t line[], int start, int len, bool isBlack);
+static int getLinePenaltyScore(const uint32_t line[], int qrsize);
+#endif
 static int finderPenaltyCountPatterns(const int runHistory[7], int qrsize);
 static int finderPenaltyTerminateAndCount(bool currentRunColor, int currentRunLength, int runHistory[7], int qrsize);
 static void finderPenaltyAddHistory(int currentRunLength, int runHistory[7]);
@@ -121,6 +127,67 @@ static const int PENALTY_N2 =  3;
 static const int PENALTY_N3 = 40;
 static const int PENALTY_N4 = 10;
 
+#if CONFIG_QRCODE_FAST_ENCODING
+// Powers of the generator element 0x02 of GF(2^8/0x11D), twice over so that the sum of two logarithms needs no modulo
+static const uint8_t GF_EXP[512] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+    0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+    0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+    0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+    0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+    0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+    0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+    0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+    0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+    0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+    0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+    0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+    0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+    0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+    0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+    0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+    0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+    0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+    0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+    0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+    0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+    0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+    0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+    0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+    0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+    0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+    0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+    0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01, 0x02,
+};
+
+// Logarithms of the field elements in base 0x02, the logarithm of 0 is unused
+static const uint8_t GF_LOG[256] = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+    0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+    0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+    0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+    0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+    0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+    0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+    0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+    0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+    0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+    0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+    0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+    0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+    0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+    0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF,
+};
+
+// Number of 32-bit words holding a line (row or column) of modules of the largest QR Code
+#define LINE_WORDS ((qrcodegen_VERSION_MAX * 4 + 17 + 31) / 32)
+#endif
+
 
 
 /*---- High-level QR Code encoding functions ----*/
@@ -410,6 +477,27 @@ testable void reedSolomonComputeRemainder(const uint8_t data[], int dataLen,
 {
     assert(1 <= degree && degree <= qrcodegen_REED_SOLOMON_DEGREE_MAX);
     memset(result, 0, (size_t)degree * sizeof(result[0]));
+#if CONFIG_QRCODE_FAST_ENCODING
+    // The generator is the same for every data byte, so take its logarithms once. Its coefficients are never 0,
+    // being the elementary symmetric polynomials of distinct powers of r.
+    uint8_t generatorLog[qrcodegen_REED_SOLOMON_DEGREE_MAX];
+    for (int j = 0; j < degree; j++) {
+        assert(generator[j] != 0);
+        generatorLog[j] = GF_LOG[generator[j]];
+    }
+    for (int i = 0; i < dataLen; i++) {  // Polynomial division
+        uint8_t factor = data[i] ^ result[0];
+        memmove(&result[0], &result[1], (size_t)(degree - 1) * sizeof(result[0]));
+        result[degree - 1] = 0;
+        if (factor == 0) {
+            continue;
+        }
+        const uint8_t *factorExp = &GF_EXP[GF_LOG[factor]];
+        for (int j = 0; j < degree; j++) {
+            result[j] ^= factorExp[generatorLog[j]];
+        }
+    }
+#else
     for (int i = 0; i < dataLen; i++) {  // Polynomial division
         uint8_t factor = data[i] ^ result[0];
         memmove(&result[0], &result[1], (size_t)(degree - 1) * sizeof(result[0]));
@@ -418,6 +506,7 @@ testable void reedSolomonComputeRemainder(const uint8_t data[], int dataLen,
             result[j] ^= reedSolomonMultiply(generator[j], factor);
         }
     }
+#endif
 }
 
 #undef qrcodegen_REED_SOLOMON_DEGREE_MAX
@@ -427,6 +516,12 @@ testable void reedSolomonComputeRemainder(const uint8_t data[], int dataLen,
 // All inputs are valid. This could be implemented as a 256*256 lookup table.
 testable uint8_t reedSolomonMultiply(uint8_t x, uint8_t y)
 {
+#if CONFIG_QRCODE_FAST_ENCODING
+    if (x == 0 || y == 0) {
+        return 0;
+    }
+    return GF_EXP[GF_LOG[x] + GF_LOG[y]];
+#else
     // Russian peasant multiplication
     uint8_t z = 0;
     for (int i = 7; i >= 0; i--) {
@@ -434,6 +529,7 @@ testable uint8_t reedSolomonMultiply(uint8_t x, uint8_t y)
         z ^= ((y >> i) & 1) * x;
     }
     return z;
+#endif
 }
 
 
@@ -682,6 +778,143 @@ static void applyMask(const uint8_t functionModules[], uint8_t qrcode[], enum qr
 
 // Calculates and returns the penalty score based on state of the given QR Code's current modules.
 // This is used by the automatic mask choice algorithm to find the mask pattern that yields the lowest score.
+#if CONFIG_QRCODE_FAST_ENCODING
+// Same score as below, computed on lines of modules packed in words: the runs of a line are found a word at a time,
+// and the 2*2 blocks and black modules of a row are counted with bitwise operations.
+static long getPenaltyScore(const uint8_t qrcode[])
+{
+    int qrsize = qrcodegen_getSize(qrcode);
+    int words = (qrsize + 31) / 32;
+    long result = 0;
+    int black = 0;
+    uint32_t line[LINE_WORDS];
+    uint32_t prevRow[LINE_WORDS];
+    uint32_t same[LINE_WORDS];
+
+    for (int y = 0; y < qrsize; y++) {
+        getLineBits(qrcode, y * qrsize, 1, qrsize, line);
+        // Adjacent modules in row having same color, and finder-like patterns
+        result += getLinePenaltyScore(line, qrsize);
+
+        // 2*2 blocks of modules having same color, with their top left module at x in the previous row
+        if (y > 0) {
+            for (int i = 0; i < words; i++) {
+                same[i] = ~(prevRow[i] ^ line[i]);
+            }
+            for (int i = 0; i < words; i++) {
+                uint32_t sameNext = i + 1 < words ? same[i + 1] : 0;
+                uint32_t lineNext = i + 1 < words ? line[i + 1] : 0;
+                uint32_t blocks = same[i] & (same[i] >> 1 | sameNext << 31) & ~(line[i] ^ (line[i] >> 1 | lineNext << 31));
+                int valid = qrsize - 1 - i * 32;  // Blocks can't start in the last column
+                if (valid < 32) {
+                    blocks &= (1u << valid) - 1;
+                }
+                result += __builtin_popcount(blocks) * PENALTY_N2;
+            }
+        }
+        memcpy(prevRow, line, (size_t)words * sizeof(line[0]));
+
+        for (int i = 0; i < words; i++) {
+            black += __builtin_popcount(line[i]);
+        }
+    }
+    // Adjacent modules in column having same color, and finder-like patterns
+    for (int x = 0; x < qrsize; x++) {
+        getLineBits(qrcode, x, qrsize, qrsize, line);
+        result += getLinePenaltyScore(line, qrsize);
+    }
+
+    // Balance of black and white modules
+    int total = qrsize * qrsize;  // Note that size is odd, so black/total != 1/2
+    // Compute the smallest integer k >= 0 such that (45-5k)% <= black/total <= (55+5k)%
+    int k = (int)((labs(black * 20L - total * 10L) + total - 1) / total) - 1;
+    result += k * PENALTY_N4;
+    return result;
+}
+
+
+// Reads the modules index, index + step, ... index + (len - 1) * step of the QR Code, module (x, y) being at
+// y * size + x, into bits 0 to len - 1 of line[] and clears the following bits.
+// A helper function for getPenaltyScore().
+static void getLineBits(const uint8_t qrcode[], int index, int step, int len, uint32_t line[])
+{
+    const uint8_t *modules = &qrcode[1];
+    int words = (len + 31) / 32;
+    if (step == 1) {
+        // Assemble each word from the 5 bytes it spans, without reading past the last module of the line
+        int end = (index + len + 7) / 8;
+        for (int i = 0; i < words; i++) {
+            int bit = index + i * 32;
+            uint64_t bits = 0;
+            for (int j = 0, byte = bit >> 3; j < 5 && byte + j < end; j++) {
+                bits |= (uint64_t)modules[byte + j] << (j * 8);
+            }
+            line[i] = (uint32_t)(bits >> (bit & 7));
+        }
+        if (len % 32 != 0) {
+            line[words - 1] &= (1u << (len % 32)) - 1;
+        }
+    } else {
+        memset(line, 0, (size_t)words * sizeof(line[0]));
+        for (int i = 0; i < len; i++, index += step) {
+            if ((modules[index >> 3] >> (index & 7)) & 1) {
+                line[i >> 5] |= 1u << (i & 31);
+            }
+        }
+    }
+}
+
+
+// Returns the end of the run of modules of the given color starting at start in line[0 : len], i.e. the first
+// following module of the other color or len. A helper function for getPenaltyScore().
+static int getRunEnd(const uint32_t line[], int start, int len, bool isBlack)
+{
+    int i = start >> 5;
+    // Look for the first bit set after start, in the line inverted for a black run
+    uint32_t word = (isBlack ? ~line[i] : line[i]) & (~0u << (start & 31));
+    while (word == 0) {
+        i++;
+        if (i * 32 >= len) {
+            return len;
+        }
+        word = isBlack ? ~line[i] : line[i];
+    }
+    int end = i * 32 + __builtin_ctz(word);
+    return end < len ? end : len;
+}
+
+
+// Returns the penalty of adjacent modules having same color and of finder-like patterns in the given line (row or
+// column) of modules, going from run to run instead of module to module. A helper function for getPenaltyScore().
+static int getLinePenaltyScore(const uint32_t line[], int qrsize)
+{
+    int result = 0;
+    bool runColor = false;
+    int runLength = 0;
+    int runHistory[7] = {0};
+    int padRun = qrsize;  // Add white border to initial run
+    for (int start = 0; start < qrsize;) {
+        bool color = (line[start >> 5] >> (start & 31)) & 1;
+        int end = getRunEnd(line, start, qrsize, color);
+        // Only the first run, if white, continues the initial run
+        if (color != runColor) {
+            finderPenaltyAddHistory(runLength + padRun, runHistory);
+            padRun = 0;
+            if (!runColor) {
+                result += finderPenaltyCountPatterns(runHistory, qrsize) * PENALTY_N3;
+            }
+            runColor = color;
+        }
+        runLength = end - start;
+        if (runLength >= 5) {
+            result += PENALTY_N1 + runLength - 5;
+        }
+        start = end;
+    }
+    result += finderPenaltyTerminateAndCount(runColor, runLength + padRun, runHistory, qrsize) * PENALTY_N3;
+    return result;
+}
+#else
 static long getPenaltyScore(const uint8_t qrcode[])
 {
     int qrsize = qrcodegen_getSize(qrcode);
@@ -767,6 +1000,7 @@ static long getPenaltyScore(const uint8_t qrcode[])
     result += k * PENALTY_N4;
     return result;
 }
+#endif
 
 
 // Can only be called immediately after a white run is added, and
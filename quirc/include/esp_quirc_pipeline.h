@@ -0,0 +1,199 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "jpeg_decoder.h"
+#include "quirc.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief  Format of the frames given to esp_quirc_pipeline_feed()
+ */
+typedef enum {
+    ESP_QUIRC_FRAME_GRAY = 0,   /*!< 8 bits of luminance per pixel */
+    ESP_QUIRC_FRAME_YUV422,     /*!< Packed YUV422 as Y0 U Y1 V (YUYV), e.g. PIXFORMAT_YUV422 of esp32-camera */
+    ESP_QUIRC_FRAME_YUV420,     /*!< Planar or semi-planar YUV420 (I420, NV12), starting with the Y plane */
+    ESP_QUIRC_FRAME_JPEG,       /*!< Baseline JPEG image, e.g. PIXFORMAT_JPEG of esp32-camera */
+} esp_quirc_frame_format_t;
+
+/**
+ * @brief  Frame captured by the application
+ */
+typedef struct {
+    esp_quirc_frame_format_t format;    /*!< Format of the frame */
+    const uint8_t *data;                /*!< Frame data */
+    size_t len;                         /*!< Length of data */
+    uint16_t width;                     /*!< Width in pixels, not used for JPEG frames */
+    uint16_t height;                    /*!< Height in pixels, not used for JPEG frames */
+} esp_quirc_frame_t;
+
+/**
+ * @brief  Region of the frames searched for QR codes, in pixels of the frames (of the scaled image for JPEG frames)
+ */
+typedef struct {
+    uint16_t left;      /*!< Left edge of the region */
+    uint16_t top;       /*!< Top edge of the region */
+    uint16_t width;     /*!< Width of the region, 0 for the whole frame */
+    uint16_t height;    /*!< Height of the region, 0 for the whole frame */
+} esp_quirc_roi_t;
+
+/**
+ * @brief  Called for each QR code decoded in a frame.
+ *
+ * @param[in]   code        extracted code, with the positions of its corners in the frame
+ * @param[in]   data        decoded data
+ * @param[in]   user_ctx    user_ctx of esp_quirc_pipeline_config_t
+ */
+typedef void (*esp_quirc_result_cb_t)(const struct quirc_code *code, const struct quirc_data *data, void *user_ctx);
+
+typedef struct {
+    esp_quirc_result_cb_t result_cb;    /*!< Called for each decoded QR code */
+    void *user_ctx;                     /*!< Passed to result_cb */
+    esp_jpeg_image_scale_t jpeg_scale;  /*!< Scale of the JPEG frames, 1:2 is often enough for QR codes and decodes
+                                             four times fewer pixels */
+    uint16_t roi_margin;                /*!< With flags.track_roi, margin around the decoded codes kept in the region
+                                             searched in the next frames, in pixels */
+    uint8_t max_codes;                  /*!< Maximum number of codes decoded per frame with flags.parallel_decode,
+                                             each taking 4 kB in the queue between the scan and decode tasks */
+    uint32_t task_stack_size;           /*!< Stack size of the scan and decode tasks. Quirc takes around 10 kB of stack */
+    UBaseType_t task_priority;          /*!< Priority of the scan and decode tasks */
+    BaseType_t task_core;               /*!< Core of the scan task, or tskNO_AFFINITY */
+    BaseType_t decode_task_core;        /*!< Core of the decode task, or tskNO_AFFINITY */
+    struct {
+        uint32_t track_roi: 1;          /*!< Once codes have been decoded, search the next frames only in the region
+                                             around them, and search the whole frame again when they are lost */
+        uint32_t parallel_decode: 1;    /*!< Decode the codes found in a frame on a separate task, while the scan
+                                             task thresholds the next frame and searches it for capstones */
+    } flags;
+} esp_quirc_pipeline_config_t;
+
+#if CONFIG_FREERTOS_UNICORE || portNUM_PROCESSORS < 2
+#define ESP_QUIRC_PIPELINE_SCAN_CORE tskNO_AFFINITY
+#define ESP_QUIRC_PIPELINE_DECODE_CORE tskNO_AFFINITY
+#define ESP_QUIRC_PIPELINE_PARALLEL_DECODE 0
+#else
+#define ESP_QUIRC_PIPELINE_SCAN_CORE 1
+#define ESP_QUIRC_PIPELINE_DECODE_CORE 0
+#define ESP_QUIRC_PIPELINE_PARALLEL_DECODE 1
+#endif
+
+#define ESP_QUIRC_PIPELINE_CONFIG_DEFAULT() {                           \
+    .jpeg_scale = JPEG_IMAGE_SCALE_0,                                   \
+    .roi_margin = 32,                                                   \
+    .max_codes = 2,                                                     \
+    .task_stack_size = 12 * 1024,                                       \
+    .task_priority = 5,                                                 \
+    .task_core = ESP_QUIRC_PIPELINE_SCAN_CORE,                          \
+    .decode_task_core = ESP_QUIRC_PIPELINE_DECODE_CORE,                 \
+    .flags = {                                                          \
+        .track_roi = 1,                                                 \
+        .parallel_decode = ESP_QUIRC_PIPELINE_PARALLEL_DECODE,          \
+    },                                                                  \
+}
+
+typedef struct {
+    uint32_t frames_scanned;    /*!< Frames searched for QR codes */
+    uint32_t frames_roi;        /*!< Frames among frames_scanned searched in a region only */
+    uint32_t frames_dropped;    /*!< Frames dropped because the scan task was still busy with the previous ones */
+    uint32_t codes_decoded;     /*!< QR codes passed to result_cb */
+} esp_quirc_pipeline_stats_t;
+
+typedef struct esp_quirc_pipeline *esp_quirc_pipeline_handle_t;
+
+/**
+ * @brief  Create a pipeline scanning camera frames for QR codes.
+ *
+ * The pipeline holds two quirc images. esp_quirc_pipeline_feed() loads a frame into the free one, on the task
+ * capturing the frames, while a scan task runs the grid search and decoding on the other one, so that capturing the
+ * next frame overlaps with scanning the current one. The scan task runs on the other core on dual core targets.
+ * With flags.parallel_decode, the codes found by the scan task are decoded by a decode task, on the capturing core
+ * by default, while the scan task goes on with the next frame.
+ *
+ * Only a region of the frames can be loaded into the quirc images and searched, which is faster in proportion to
+ * its area: either tracked from the previous results with flags.track_roi, or set by esp_quirc_pipeline_set_roi().
+ *
+ * @param[in]   config      pointer to esp_quirc_pipeline_config_t
+ * @param[out]  ret_pipeline created pipeline
+ *
+ * @return
+ *    - ESP_OK                  Success
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments
+ *    - ESP_ERR_NO_MEM          Out of memory
+ */
+esp_err_t esp_quirc_pipeline_new(const esp_quirc_pipeline_config_t *config, esp_quirc_pipeline_handle_t *ret_pipeline);
+
+/**
+ * @brief  Load a frame into a free quirc image and pass it to the scan task.
+ *
+ * JPEG frames are decoded to grayscale straight into the quirc image, with the scale of the configuration, and the
+ * Y plane of YUV frames is read into it without an intermediate buffer. The quirc images are resized to follow the
+ * size of the frames, or of the region searched. The frame data isn't used anymore once this function returns, so the camera frame buffer can
+ * be returned right away.
+ *
+ * @note  This function must always be called from the same task.
+ *
+ * @param[in]   pipeline    pipeline created by esp_quirc_pipeline_new()
+ * @param[in]   frame       frame to scan
+ * @param[in]   timeout     time to wait for a free quirc image. With 0, frames arriving while both images are busy
+ *                          are dropped, which keeps the latency low
+ *
+ * @return
+ *    - ESP_OK                  The frame has been passed to the scan task
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments, or the frame is too short for its size
+ *    - ESP_ERR_TIMEOUT         No free quirc image within timeout, the frame is dropped
+ *    - ESP_ERR_NO_MEM          Out of memory for resizing the quirc image
+ *    - ESP_FAIL                The JPEG frame can't be decoded
+ */
+esp_err_t esp_quirc_pipeline_feed(esp_quirc_pipeline_handle_t pipeline, const esp_quirc_frame_t *frame, TickType_t timeout);
+
+/**
+ * @brief  Set the region searched in the next frames.
+ *
+ * With flags.track_roi, the region is then updated from the results of these frames.
+ *
+ * @param[in]   pipeline    pipeline created by esp_quirc_pipeline_new()
+ * @param[in]   roi         region of the frames, NULL for the whole frames. Clipped to the frames
+ *
+ * @return
+ *    - ESP_OK                  Success
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments
+ */
+esp_err_t esp_quirc_pipeline_set_roi(esp_quirc_pipeline_handle_t pipeline, const esp_quirc_roi_t *roi);
+
+/**
+ * @brief  Get the statistics of a pipeline.
+ *
+ * @param[in]   pipeline    pipeline created by esp_quirc_pipeline_new()
+ * @param[out]  stats       statistics since the creation of the pipeline
+ *
+ * @return
+ *    - ESP_OK                  Success
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments
+ */
+esp_err_t esp_quirc_pipeline_get_stats(esp_quirc_pipeline_handle_t pipeline, esp_quirc_pipeline_stats_t *stats);
+
+/**
+ * @brief  Delete a pipeline, after the scan of the frames already fed.
+ *
+ * @param[in]   pipeline    pipeline created by esp_quirc_pipeline_new()
+ *
+ * @return
+ *    - ESP_OK                  Success
+ *    - ESP_ERR_INVALID_ARG     Invalid arguments
+ */
+esp_err_t esp_quirc_pipeline_delete(esp_quirc_pipeline_handle_t pipeline);
+
+#ifdef __cplusplus
+}
+#endif
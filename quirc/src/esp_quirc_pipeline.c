@@ -0,0 +1,448 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_quirc_pipeline.h"
+
+static const char *TAG = "esp_quirc_pipeline";
+
+#define PIPELINE_IMAGE_COUNT 2
+#define PIPELINE_BATCH_COUNT 2
+
+/* Part of a frame loaded into a quirc image */
+typedef struct {
+    esp_quirc_roi_t roi;
+    uint16_t frame_width;
+    uint16_t frame_height;
+} pipeline_region_t;
+
+typedef struct {
+    struct quirc *q;
+    pipeline_region_t region;
+} pipeline_image_t;
+
+/* Codes extracted from a frame by the scan task, waiting for the decode task */
+typedef struct {
+    pipeline_region_t region;
+    int count;
+    struct quirc_code *codes;
+} pipeline_batch_t;
+
+typedef struct {
+    int left;
+    int top;
+    int right;
+    int bottom;
+} pipeline_bbox_t;
+
+/*
+ * The images go round from free_queue to scan_queue and back to free_queue. With parallel_decode, the batches go
+ * round from batch_free_queue to decode_queue and back to batch_free_queue. A NULL image in scan_queue stops the
+ * scan task, which forwards a NULL batch to stop the decode task.
+ */
+struct esp_quirc_pipeline {
+    esp_quirc_pipeline_config_t config;
+    pipeline_image_t images[PIPELINE_IMAGE_COUNT];
+    pipeline_batch_t batches[PIPELINE_BATCH_COUNT];
+    struct quirc_code *batch_codes;
+    esp_jpeg_decoder_handle_t jpeg_decoder;
+    QueueHandle_t free_queue;
+    QueueHandle_t scan_queue;
+    QueueHandle_t batch_free_queue;
+    QueueHandle_t decode_queue;
+    SemaphoreHandle_t task_done;
+    int tasks;
+    portMUX_TYPE lock;
+    esp_quirc_roi_t roi;    // Region searched in the next frames
+    esp_quirc_pipeline_stats_t stats;
+    // Used by the task decoding the codes, too large for its stack
+    struct quirc_code code;
+    struct quirc_data data;
+};
+
+static bool pipeline_region_is_partial(const pipeline_region_t *region)
+{
+    return region->roi.width != region->frame_width || region->roi.height != region->frame_height;
+}
+
+/* Decodes a code found in region and reports it, in frame coordinates. Returns false if it can't be decoded */
+static bool pipeline_decode_code(esp_quirc_pipeline_handle_t pipeline, struct quirc_code *code,
+                                 const pipeline_region_t *region, pipeline_bbox_t *bbox)
+{
+    struct quirc_data *data = &pipeline->data;
+    quirc_decode_error_t err = quirc_decode(code, data);
+    if (err == QUIRC_ERROR_DATA_ECC) {
+        // The code may be seen in a mirror
+        quirc_flip(code);
+        err = quirc_decode(code, data);
+    }
+    if (err != QUIRC_SUCCESS) {
+        ESP_LOGD(TAG, "Decoding failed: %s", quirc_strerror(err));
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        struct quirc_point *corner = &code->corners[i];
+        corner->x += region->roi.left;
+        corner->y += region->roi.top;
+        bbox->left = MIN(bbox->left, corner->x);
+        bbox->top = MIN(bbox->top, corner->y);
+        bbox->right = MAX(bbox->right, corner->x);
+        bbox->bottom = MAX(bbox->bottom, corner->y);
+    }
+    if (pipeline->config.result_cb) {
+        pipeline->config.result_cb(code, data, pipeline->config.user_ctx);
+    }
+    return true;
+}
+
+/* Accounts for a scanned frame, and moves the region searched to the codes decoded in it */
+static void pipeline_frame_done(esp_quirc_pipeline_handle_t pipeline, const pipeline_region_t *region,
+                                uint32_t decoded, const pipeline_bbox_t *bbox)
+{
+    bool partial = pipeline_region_is_partial(region);
+    esp_quirc_roi_t roi = {0};
+    if (decoded > 0) {
+        int margin = pipeline->config.roi_margin;
+        int left = MAX(bbox->left - margin, 0);
+        int top = MAX(bbox->top - margin, 0);
+        int right = MIN(bbox->right + margin, region->frame_width - 1);
+        int bottom = MIN(bbox->bottom + margin, region->frame_height - 1);
+        if (left <= right && top <= bottom) {
+            roi = (esp_quirc_roi_t) {
+                left, top, right - left + 1, bottom - top + 1
+            };
+        }
+    }
+
+    portENTER_CRITICAL(&pipeline->lock);
+    pipeline->stats.frames_scanned++;
+    pipeline->stats.frames_roi += partial;
+    pipeline->stats.codes_decoded += decoded;
+    // The codes lost in a region may have moved out of it, search the whole frame for them
+    if (pipeline->config.flags.track_roi && (decoded > 0 || partial)) {
+        pipeline->roi = roi;
+    }
+    portEXIT_CRITICAL(&pipeline->lock);
+}
+
+static void pipeline_scan_task(void *arg)
+{
+    esp_quirc_pipeline_handle_t pipeline = (esp_quirc_pipeline_handle_t)arg;
+    pipeline_image_t *image;
+
+    while (xQueueReceive(pipeline->scan_queue, &image, portMAX_DELAY) == pdTRUE && image != NULL) {
+        // Thresholding, capstone search and grid fitting
+        quirc_end(image->q);
+        int count = quirc_count(image->q);
+        pipeline_region_t region = image->region;
+
+        if (pipeline->config.flags.parallel_decode) {
+            pipeline_batch_t *batch;
+            xQueueReceive(pipeline->batch_free_queue, &batch, portMAX_DELAY);
+            batch->region = region;
+            batch->count = MIN(count, pipeline->config.max_codes);
+            for (int i = 0; i < batch->count; i++) {
+                quirc_extract(image->q, i, &batch->codes[i]);
+            }
+            xQueueSend(pipeline->free_queue, &image, portMAX_DELAY);
+            xQueueSend(pipeline->decode_queue, &batch, portMAX_DELAY);
+            continue;
+        }
+
+        pipeline_bbox_t bbox = {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+        uint32_t decoded = 0;
+        for (int i = 0; i < count; i++) {
+            quirc_extract(image->q, i, &pipeline->code);
+            decoded += pipeline_decode_code(pipeline, &pipeline->code, &region, &bbox);
+        }
+        xQueueSend(pipeline->free_queue, &image, portMAX_DELAY);
+        pipeline_frame_done(pipeline, &region, decoded, &bbox);
+    }
+    if (pipeline->config.flags.parallel_decode) {
+        pipeline_batch_t *stop = NULL;
+        xQueueSend(pipeline->decode_queue, &stop, portMAX_DELAY);
+    }
+    xSemaphoreGive(pipeline->task_done);
+    vTaskDelete(NULL);
+}
+
+static void pipeline_decode_task(void *arg)
+{
+    esp_quirc_pipeline_handle_t pipeline = (esp_quirc_pipeline_handle_t)arg;
+    pipeline_batch_t *batch;
+
+    while (xQueueReceive(pipeline->decode_queue, &batch, portMAX_DELAY) == pdTRUE && batch != NULL) {
+        pipeline_bbox_t bbox = {INT_MAX, INT_MAX, INT_MIN, INT_MIN};
+        uint32_t decoded = 0;
+        for (int i = 0; i < batch->count; i++) {
+            decoded += pipeline_decode_code(pipeline, &batch->codes[i], &batch->region, &bbox);
+        }
+        pipeline_region_t region = batch->region;
+        xQueueSend(pipeline->batch_free_queue, &batch, portMAX_DELAY);
+        pipeline_frame_done(pipeline, &region, decoded, &bbox);
+    }
+    xSemaphoreGive(pipeline->task_done);
+    vTaskDelete(NULL);
+}
+
+/* Clips the region searched to a frame, an empty or outside region is the whole frame */
+static void pipeline_clip_roi(esp_quirc_roi_t *roi, uint16_t width, uint16_t height)
+{
+    if (roi->width == 0 || roi->height == 0 || roi->left >= width || roi->top >= height) {
+        *roi = (esp_quirc_roi_t) {
+            0, 0, width, height
+        };
+        return;
+    }
+    roi->width = MIN(roi->width, width - roi->left);
+    roi->height = MIN(roi->height, height - roi->top);
+}
+
+/* Returns the image buffer of q after resizing it to width x height if needed */
+static uint8_t *pipeline_begin_image(struct quirc *q, int width, int height)
+{
+    int w, h;
+    uint8_t *image = quirc_begin(q, &w, &h);
+    if (w == width && h == height) {
+        return image;
+    }
+    if (quirc_resize(q, width, height) < 0) {
+        ESP_LOGE(TAG, "Couldn't resize the quirc image to %dx%d", width, height);
+        return NULL;
+    }
+    return quirc_begin(q, NULL, NULL);
+}
+
+static esp_err_t pipeline_load_jpeg(esp_quirc_pipeline_handle_t pipeline, pipeline_image_t *image,
+                                    const esp_quirc_frame_t *frame)
+{
+    esp_jpeg_image_cfg_t cfg = {
+        .indata = (uint8_t *)frame->data,
+        .indata_size = frame->len,
+        .out_format = JPEG_IMAGE_FORMAT_GRAY,
+        .out_scale = pipeline->config.jpeg_scale,
+    };
+    esp_jpeg_image_output_t img;
+    ESP_RETURN_ON_ERROR(esp_jpeg_get_image_info(&cfg, &img), TAG, "Invalid JPEG frame");
+
+    // Same geometry as esp_jpeg_decode() without downscaling, the region is in pixels of the scaled image
+    int scale_div = 1 << pipeline->config.jpeg_scale;
+    pipeline_region_t *region = &image->region;
+    region->frame_width = img.width / scale_div;
+    region->frame_height = img.height / scale_div;
+    pipeline_clip_roi(&region->roi, region->frame_width, region->frame_height);
+    if (pipeline_region_is_partial(region)) {
+        // Only the MCUs in the region are converted
+        cfg.crop.left = region->roi.left * scale_div;
+        cfg.crop.top = region->roi.top * scale_div;
+        cfg.crop.width = region->roi.width * scale_div;
+        cfg.crop.height = region->roi.height * scale_div;
+    }
+    cfg.outbuf = pipeline_begin_image(image->q, region->roi.width, region->roi.height);
+    ESP_RETURN_ON_FALSE(cfg.outbuf, ESP_ERR_NO_MEM, TAG, "No memory for the quirc image");
+    cfg.outbuf_size = region->roi.width * region->roi.height;
+    return esp_jpeg_decoder_decode(pipeline->jpeg_decoder, &cfg, &img);
+}
+
+static esp_err_t pipeline_load_frame(esp_quirc_pipeline_handle_t pipeline, pipeline_image_t *image,
+                                     const esp_quirc_frame_t *frame)
+{
+    portENTER_CRITICAL(&pipeline->lock);
+    image->region.roi = pipeline->roi;
+    portEXIT_CRITICAL(&pipeline->lock);
+    if (frame->format == ESP_QUIRC_FRAME_JPEG) {
+        return pipeline_load_jpeg(pipeline, image, frame);
+    }
+
+    size_t pixels = (size_t)frame->width * frame->height;
+    size_t min_len = frame->format == ESP_QUIRC_FRAME_YUV422 ? pixels * 2 :
+                     frame->format == ESP_QUIRC_FRAME_YUV420 ? pixels + pixels / 2 : pixels;
+    ESP_RETURN_ON_FALSE(pixels > 0 && frame->len >= min_len, ESP_ERR_INVALID_ARG, TAG, "Frame too short for its size");
+    pipeline_region_t *region = &image->region;
+    region->frame_width = frame->width;
+    region->frame_height = frame->height;
+    pipeline_clip_roi(&region->roi, frame->width, frame->height);
+    const esp_quirc_roi_t *roi = &region->roi;
+    uint8_t *dst = pipeline_begin_image(image->q, roi->width, roi->height);
+    ESP_RETURN_ON_FALSE(dst, ESP_ERR_NO_MEM, TAG, "No memory for the quirc image");
+
+    for (int y = 0; y < roi->height; y++, dst += roi->width) {
+        size_t offset = (size_t)(roi->top + y) * frame->width + roi->left;
+        if (frame->format == ESP_QUIRC_FRAME_YUV422) {
+            const uint8_t *src = frame->data + offset * 2;
+            for (int x = 0; x < roi->width; x++) {
+                dst[x] = src[x * 2];
+            }
+        } else {
+            // The Y plane of YUV420 frames is a grayscale image
+            memcpy(dst, frame->data + offset, roi->width);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_quirc_pipeline_new(const esp_quirc_pipeline_config_t *config, esp_quirc_pipeline_handle_t *ret_pipeline)
+{
+    ESP_RETURN_ON_FALSE(config && ret_pipeline && config->result_cb, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->jpeg_scale <= JPEG_IMAGE_SCALE_1_8, ESP_ERR_INVALID_ARG, TAG, "invalid jpeg_scale");
+    ESP_RETURN_ON_FALSE(!config->flags.parallel_decode || config->max_codes > 0, ESP_ERR_INVALID_ARG, TAG,
+                        "max_codes must be set for parallel_decode");
+
+    esp_err_t ret = ESP_OK;
+    esp_quirc_pipeline_handle_t pipeline = calloc(1, sizeof(*pipeline));
+    ESP_RETURN_ON_FALSE(pipeline, ESP_ERR_NO_MEM, TAG, "no memory for the pipeline");
+    pipeline->config = *config;
+    pipeline->lock = (portMUX_TYPE)portMUX_INITIALIZER_UNLOCKED;
+
+    pipeline->free_queue = xQueueCreate(PIPELINE_IMAGE_COUNT, sizeof(pipeline_image_t *));
+    // One more item for stopping the task
+    pipeline->scan_queue = xQueueCreate(PIPELINE_IMAGE_COUNT + 1, sizeof(pipeline_image_t *));
+    pipeline->task_done = xSemaphoreCreateCounting(2, 0);
+    ESP_GOTO_ON_FALSE(pipeline->free_queue && pipeline->scan_queue && pipeline->task_done, ESP_ERR_NO_MEM, err, TAG,
+                      "no memory for the queues");
+    ESP_GOTO_ON_ERROR(esp_jpeg_decoder_new(NULL, &pipeline->jpeg_decoder), err, TAG, "no memory for the JPEG decoder");
+    for (int i = 0; i < PIPELINE_IMAGE_COUNT; i++) {
+        pipeline_image_t *image = &pipeline->images[i];
+        // The images are sized by the first frames
+        image->q = quirc_new();
+        ESP_GOTO_ON_FALSE(image->q, ESP_ERR_NO_MEM, err, TAG, "no memory for the quirc images");
+        xQueueSend(pipeline->free_queue, &image, 0);
+    }
+
+    if (config->flags.parallel_decode) {
+        pipeline->batch_codes = calloc(PIPELINE_BATCH_COUNT * config->max_codes, sizeof(struct quirc_code));
+        pipeline->batch_free_queue = xQueueCreate(PIPELINE_BATCH_COUNT, sizeof(pipeline_batch_t *));
+        pipeline->decode_queue = xQueueCreate(PIPELINE_BATCH_COUNT + 1, sizeof(pipeline_batch_t *));
+        ESP_GOTO_ON_FALSE(pipeline->batch_codes && pipeline->batch_free_queue && pipeline->decode_queue,
+                          ESP_ERR_NO_MEM, err, TAG, "no memory for the decode queue");
+        for (int i = 0; i < PIPELINE_BATCH_COUNT; i++) {
+            pipeline_batch_t *batch = &pipeline->batches[i];
+            batch->codes = pipeline->batch_codes + i * config->max_codes;
+            xQueueSend(pipeline->batch_free_queue, &batch, 0);
+        }
+        ESP_GOTO_ON_FALSE(xTaskCreatePinnedToCore(pipeline_decode_task, "quirc_decode", config->task_stack_size,
+                          pipeline, config->task_priority, NULL, config->decode_task_core) == pdPASS,
+                          ESP_ERR_NO_MEM, err, TAG, "couldn't create the decode task");
+        pipeline->tasks++;
+    }
+    if (xTaskCreatePinnedToCore(pipeline_scan_task, "quirc_scan", config->task_stack_size, pipeline,
+                                config->task_priority, NULL, config->task_core) != pdPASS) {
+        ESP_LOGE(TAG, "couldn't create the scan task");
+        ret = ESP_ERR_NO_MEM;
+        if (pipeline->tasks > 0) {
+            // Stop the decode task directly
+            pipeline_batch_t *stop = NULL;
+            xQueueSend(pipeline->decode_queue, &stop, portMAX_DELAY);
+            xSemaphoreTake(pipeline->task_done, portMAX_DELAY);
+        }
+        goto err;
+    }
+    pipeline->tasks++;
+    *ret_pipeline = pipeline;
+    return ESP_OK;
+
+err:
+    if (pipeline->decode_queue) {
+        vQueueDelete(pipeline->decode_queue);
+    }
+    if (pipeline->batch_free_queue) {
+        vQueueDelete(pipeline->batch_free_queue);
+    }
+    free(pipeline->batch_codes);
+    for (int i = 0; i < PIPELINE_IMAGE_COUNT; i++) {
+        if (pipeline->images[i].q) {
+            quirc_destroy(pipeline->images[i].q);
+        }
+    }
+    if (pipeline->jpeg_decoder) {
+        esp_jpeg_decoder_delete(pipeline->jpeg_decoder);
+    }
+    if (pipeline->task_done) {
+        vSemaphoreDelete(pipeline->task_done);
+    }
+    if (pipeline->scan_queue) {
+        vQueueDelete(pipeline->scan_queue);
+    }
+    if (pipeline->free_queue) {
+        vQueueDelete(pipeline->free_queue);
+    }
+    free(pipeline);
+    return ret;
+}
+
+esp_err_t esp_quirc_pipeline_feed(esp_quirc_pipeline_handle_t pipeline, const esp_quirc_frame_t *frame, TickType_t timeout)
+{
+    ESP_RETURN_ON_FALSE(pipeline && frame && frame->data && frame->format <= ESP_QUIRC_FRAME_JPEG, ESP_ERR_INVALID_ARG,
+                        TAG, "invalid argument");
+
+    pipeline_image_t *image;
+    if (xQueueReceive(pipeline->free_queue, &image, timeout) != pdTRUE) {
+        portENTER_CRITICAL(&pipeline->lock);
+        pipeline->stats.frames_dropped++;
+        portEXIT_CRITICAL(&pipeline->lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t err = pipeline_load_frame(pipeline, image, frame);
+    xQueueSend(err == ESP_OK ? pipeline->scan_queue : pipeline->free_queue, &image, portMAX_DELAY);
+    return err;
+}
+
+esp_err_t esp_quirc_pipeline_set_roi(esp_quirc_pipeline_handle_t pipeline, const esp_quirc_roi_t *roi)
+{
+    ESP_RETURN_ON_FALSE(pipeline, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&pipeline->lock);
+    if (roi) {
+        pipeline->roi = *roi;
+    } else {
+        memset(&pipeline->roi, 0, sizeof(pipeline->roi));
+    }
+    portEXIT_CRITICAL(&pipeline->lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_quirc_pipeline_get_stats(esp_quirc_pipeline_handle_t pipeline, esp_quirc_pipeline_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(pipeline && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    portENTER_CRITICAL(&pipeline->lock);
+    *stats = pipeline->stats;
+    portEXIT_CRITICAL(&pipeline->lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_quirc_pipeline_delete(esp_quirc_pipeline_handle_t pipeline)
+{
+    ESP_RETURN_ON_FALSE(pipeline, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    pipeline_image_t *stop = NULL;
+    xQueueSend(pipeline->scan_queue, &stop, portMAX_DELAY);
+    for (int i = 0; i < pipeline->tasks; i++) {
+        xSemaphoreTake(pipeline->task_done, portMAX_DELAY);
+    }
+
+    if (pipeline->decode_queue) {
+        vQueueDelete(pipeline->decode_queue);
+        vQueueDelete(pipeline->batch_free_queue);
+    }
+    free(pipeline->batch_codes);
+    for (int i = 0; i < PIPELINE_IMAGE_COUNT; i++) {
+        quirc_destroy(pipeline->images[i].q);
+    }
+    esp_jpeg_decoder_delete(pipeline->jpeg_decoder);
+    vSemaphoreDelete(pipeline->task_done);
+    vQueueDelete(pipeline->scan_queue);
+    vQueueDelete(pipeline->free_queue);
+    free(pipeline);
+    return ESP_OK;
+}
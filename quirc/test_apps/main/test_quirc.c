@@ -7,11 +7,14 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
 #include "quirc.h"
+#include "esp_quirc_pipeline.h"
 #include "unity.h"
 
 static const char *TAG = "test_quirc";
@@ -19,21 +22,26 @@ static const char *TAG = "test_quirc";
 extern const uint8_t test_qrcode_pgm_start[] asm("_binary_test_qrcode_pgm_start");
 extern const uint8_t test_qrcode_pgm_end[]   asm("_binary_test_qrcode_pgm_end");
 
-static void copy_test_image_into_quirc_buffer(struct quirc *q)
+static const uint8_t *get_test_image(int *width, int *height)
 {
     // get the size of the image from the PGM header
     const uint8_t *p = test_qrcode_pgm_start;
+    sscanf((const char *)p, "P5 %d %d 255", width, height);
+    TEST_ASSERT_EQUAL_INT(128, *width);
+    TEST_ASSERT_EQUAL_INT(113, *height);
+
+    // find the start of the image data
+    return memchr(p, '\n', test_qrcode_pgm_end - p) + 1;
+}
+
+static void copy_test_image_into_quirc_buffer(struct quirc *q)
+{
     int width, height;
-    sscanf((const char *)p, "P5 %d %d 255", &width, &height);
-    TEST_ASSERT_EQUAL_INT(128, width);
-    TEST_ASSERT_EQUAL_INT(113, height);
+    const uint8_t *p = get_test_image(&width, &height);
 
     // resize the quirc buffer to match the image
     TEST_ASSERT_EQUAL_INT(0, quirc_resize(q, width, height));
 
-    // find the start of the image data
-    p = memchr(p, '\n', test_qrcode_pgm_end - p) + 1;
-
     // copy the image into the quirc buffer
     memcpy(quirc_begin(q, NULL, NULL), p, width * height);
 }
@@ -89,3 +97,133 @@ TEST_CASE("quirc can load a QR code", "[quirc]")
     quirc_destroy(q);
     vTaskDelay(2);  // allow the task to clean up
 }
+
+typedef struct {
+    char payload[32];
+    SemaphoreHandle_t done;
+} pipeline_test_ctx_t;
+
+static void pipeline_result_cb(const struct quirc_code *code, const struct quirc_data *data, void *user_ctx)
+{
+    pipeline_test_ctx_t *ctx = (pipeline_test_ctx_t *)user_ctx;
+    snprintf(ctx->payload, sizeof(ctx->payload), "%.*s", data->payload_len, (const char *)data->payload);
+    xSemaphoreGive(ctx->done);
+}
+
+TEST_CASE("quirc pipeline decodes grayscale and YUV422 frames", "[quirc]")
+{
+    int width, height;
+    const uint8_t *image = get_test_image(&width, &height);
+    pipeline_test_ctx_t ctx = {
+        .done = xSemaphoreCreateBinary(),
+    };
+    TEST_ASSERT_NOT_NULL(ctx.done);
+
+    esp_quirc_pipeline_config_t config = ESP_QUIRC_PIPELINE_CONFIG_DEFAULT();
+    config.result_cb = pipeline_result_cb;
+    config.user_ctx = &ctx;
+    esp_quirc_pipeline_handle_t pipeline;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_new(&config, &pipeline));
+
+    esp_quirc_frame_t frame = {
+        .format = ESP_QUIRC_FRAME_GRAY,
+        .data = image,
+        .len = width * height,
+        .width = width,
+        .height = height,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_feed(pipeline, &frame, portMAX_DELAY));
+    TEST_ASSERT(xSemaphoreTake(ctx.done, pdMS_TO_TICKS(10000)));
+    TEST_ASSERT_EQUAL_STRING("test of quirc", ctx.payload);
+
+    // same image as YUYV, with neutral chroma
+    uint8_t *yuyv = malloc(width * height * 2);
+    TEST_ASSERT_NOT_NULL(yuyv);
+    for (int i = 0; i < width * height; i++) {
+        yuyv[i * 2] = image[i];
+        yuyv[i * 2 + 1] = 128;
+    }
+    memset(ctx.payload, 0, sizeof(ctx.payload));
+    frame.format = ESP_QUIRC_FRAME_YUV422;
+    frame.data = yuyv;
+    frame.len = width * height * 2;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_feed(pipeline, &frame, portMAX_DELAY));
+    free(yuyv);
+    TEST_ASSERT(xSemaphoreTake(ctx.done, pdMS_TO_TICKS(10000)));
+    TEST_ASSERT_EQUAL_STRING("test of quirc", ctx.payload);
+
+    frame.len = width * height;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_quirc_pipeline_feed(pipeline, &frame, portMAX_DELAY));
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_delete(pipeline));
+    vSemaphoreDelete(ctx.done);
+    vTaskDelay(2);  // allow the task to clean up
+}
+
+#define BENCH_FRAME_WIDTH   256
+#define BENCH_FRAME_HEIGHT  192
+#define BENCH_FRAME_COUNT   20
+
+static void bench_result_cb(const struct quirc_code *code, const struct quirc_data *data, void *user_ctx)
+{
+    // the test image pasted at (96, 64) in the frame
+    TEST_ASSERT(code->corners[0].x >= 96 && code->corners[0].x < 96 + 128);
+    TEST_ASSERT(code->corners[0].y >= 64 && code->corners[0].y < 64 + 113);
+}
+
+static void run_pipeline_benchmark(const char *name, const esp_quirc_frame_t *frame, bool track_roi, bool parallel_decode)
+{
+    esp_quirc_pipeline_config_t config = ESP_QUIRC_PIPELINE_CONFIG_DEFAULT();
+    config.result_cb = bench_result_cb;
+    config.flags.track_roi = track_roi;
+    config.flags.parallel_decode = parallel_decode;
+    esp_quirc_pipeline_handle_t pipeline;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_new(&config, &pipeline));
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_FRAME_COUNT; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_feed(pipeline, frame, portMAX_DELAY));
+    }
+    esp_quirc_pipeline_stats_t stats;
+    do {
+        vTaskDelay(1);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_get_stats(pipeline, &stats));
+    } while (stats.frames_scanned < BENCH_FRAME_COUNT);
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    printf("QUIRCBENCH,%s,%d,%lld,%" PRIu32 ",%" PRIu32 "\n", name, BENCH_FRAME_COUNT,
+           (long long)(elapsed / BENCH_FRAME_COUNT), stats.frames_roi, stats.codes_decoded);
+    TEST_ASSERT_EQUAL(BENCH_FRAME_COUNT, stats.codes_decoded);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_quirc_pipeline_delete(pipeline));
+    vTaskDelay(2);  // allow the tasks to clean up
+}
+
+TEST_CASE("quirc pipeline benchmark", "[quirc][benchmark]")
+{
+    int width, height;
+    const uint8_t *image = get_test_image(&width, &height);
+
+    // paste the test image into a larger white frame
+    uint8_t *buf = malloc(BENCH_FRAME_WIDTH * BENCH_FRAME_HEIGHT);
+    TEST_ASSERT_NOT_NULL(buf);
+    memset(buf, 255, BENCH_FRAME_WIDTH * BENCH_FRAME_HEIGHT);
+    for (int y = 0; y < height; y++) {
+        memcpy(buf + (64 + y) * BENCH_FRAME_WIDTH + 96, image + y * width, width);
+    }
+    esp_quirc_frame_t frame = {
+        .format = ESP_QUIRC_FRAME_GRAY,
+        .data = buf,
+        .len = BENCH_FRAME_WIDTH * BENCH_FRAME_HEIGHT,
+        .width = BENCH_FRAME_WIDTH,
+        .height = BENCH_FRAME_HEIGHT,
+    };
+
+    printf("QUIRCBENCH,config,frames,us_per_frame,frames_roi,codes_decoded\n");
+    run_pipeline_benchmark("full_frame", &frame, false, false);
+    run_pipeline_benchmark("roi", &frame, true, false);
+#if !CONFIG_FREERTOS_UNICORE
+    run_pipeline_benchmark("full_frame_parallel", &frame, false, true);
+    run_pipeline_benchmark("roi_parallel", &frame, true, true);
+#endif
+    free(buf);
+}
@@ -0,0 +1,299 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/time.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_event.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_netif.h"
+#include "esp_http_client.h"
+#include "esp_crt_bundle.h"
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION <= ESP_IDF_VERSION_VAL(5, 1, 0)
+#include "lwip/apps/sntp.h"
+#else
+#include "esp_netif_sntp.h"
+#endif
+#include "nvs_flash.h"
+#include "protocol_examples_common.h"
+#include "sh2lib.h"
+
+/*
+ * Fetches the same set of paths from one server over HTTP/2 and over HTTP/1.1. Each HTTP/2 run submits all its GET
+ * requests at once, as concurrent streams of one connection driven by the sh2lib event loop, with a given initial
+ * window size. The HTTP/1.1 run sends them one after the other with esp_http_client, on one persistent connection.
+ * The connection setup is not timed: sh2lib_connect() for HTTP/2, and a first request for HTTP/1.1.
+ */
+
+#define BENCH_MAX_PATHS     16
+#define BENCH_URL_SIZE      256
+#define BENCH_REQUESTS      CONFIG_EXAMPLE_HTTP2_BENCH_REQUESTS
+
+typedef struct {
+    const char *name;
+    uint32_t window_size;
+} bench_window_t;
+
+/* 0 keeps the default window of 65535 bytes */
+static const bench_window_t s_windows[] = {
+    {"64k", 0},
+    {"256k", 256 * 1024},
+    {"1m", 1024 * 1024},
+};
+
+typedef struct {
+    int64_t start_us;
+    int64_t latency_us[BENCH_REQUESTS];
+    uint32_t completed;
+    uint32_t failed;
+    uint64_t bytes;
+    SemaphoreHandle_t stream_closed;
+} bench_state_t;
+
+static const char *TAG = "http2_bench";
+
+static char s_paths_buf[] = CONFIG_EXAMPLE_HTTP2_BENCH_PATHS;
+static const char *s_paths[BENCH_MAX_PATHS];
+static int s_path_count;
+static bench_state_t s_state;
+
+static void set_time(void)
+{
+    struct timeval tv = {
+        .tv_sec = 1509449941,
+    };
+    struct timezone tz = {
+        0, 0
+    };
+    settimeofday(&tv, &tz);
+
+    /* Start SNTP service */
+#if ESP_IDF_VERSION <= ESP_IDF_VERSION_VAL(5, 1, 0)
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_init();
+#else
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG("time.windows.com");
+    esp_netif_sntp_init(&config);
+    if (esp_netif_sntp_sync_wait(pdMS_TO_TICKS(10000)) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to update system time, continuing");
+    }
+    esp_netif_sntp_deinit();
+#endif
+}
+
+static void parse_paths(void)
+{
+    char *saveptr;
+    for (char *path = strtok_r(s_paths_buf, " ", &saveptr); path && s_path_count < BENCH_MAX_PATHS;
+            path = strtok_r(NULL, " ", &saveptr)) {
+        s_paths[s_path_count++] = path;
+    }
+    if (s_path_count == 0) {
+        s_paths[s_path_count++] = "/";
+    }
+}
+
+static int compare_latency(const void *a, const void *b)
+{
+    int64_t la = *(const int64_t *)a, lb = *(const int64_t *)b;
+    return la < lb ? -1 : la > lb;
+}
+
+static void print_result(const char *protocol, const char *window, int64_t elapsed_us, int64_t setup_us)
+{
+    bench_state_t *state = &s_state;
+    qsort(state->latency_us, state->completed, sizeof(state->latency_us[0]), compare_latency);
+    double seconds = elapsed_us > 0 ? elapsed_us / 1e6 : 1e-6;
+    double lat_min = 0, lat_p50 = 0, lat_p90 = 0, lat_max = 0;
+    if (state->completed) {
+        lat_min = state->latency_us[0] / 1e3;
+        lat_p50 = state->latency_us[state->completed / 2] / 1e3;
+        lat_p90 = state->latency_us[state->completed * 9 / 10] / 1e3;
+        lat_max = state->latency_us[state->completed - 1] / 1e3;
+    }
+    printf("H2BENCH,%s,%s,%d,%" PRIu32 ",%" PRIu32 ",%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", protocol, window,
+           BENCH_REQUESTS, state->completed, state->failed, elapsed_us / 1e3, state->completed / seconds,
+           state->bytes / 1024.0 / seconds, lat_min, lat_p50, lat_p90, lat_max, setup_us / 1e3);
+}
+
+/* Called by the event loop task of sh2lib. All the streams are submitted together, so the latency of a stream is the
+ * time from the submission to its close */
+static int bench_h2_recv(struct sh2lib_handle *handle, const char *data, size_t len, int flags)
+{
+    bench_state_t *state = &s_state;
+    state->bytes += len;
+    if (flags == DATA_RECV_RST_STREAM && state->completed < BENCH_REQUESTS) {
+        state->latency_us[state->completed++] = esp_timer_get_time() - state->start_us;
+        xSemaphoreGive(state->stream_closed);
+    }
+    return 0;
+}
+
+static void bench_h2_run(const bench_window_t *window)
+{
+    bench_state_t *state = &s_state;
+    struct sh2lib_config_t cfg = {
+        .uri = CONFIG_EXAMPLE_HTTP2_BENCH_SERVER,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .initial_window_size = window->window_size,
+    };
+    struct sh2lib_handle hd;
+    int64_t setup_us, elapsed_us = 0;
+
+    memset(state, 0, sizeof(*state));
+    state->stream_closed = xSemaphoreCreateCounting(BENCH_REQUESTS, 0);
+    setup_us = esp_timer_get_time();
+    if (!state->stream_closed || sh2lib_connect(&cfg, &hd) != 0) {
+        ESP_LOGE(TAG, "Failed to connect to %s", cfg.uri);
+        state->failed = BENCH_REQUESTS;
+        print_result("h2", window->name, 0, 0);
+        goto out;
+    }
+    setup_us = esp_timer_get_time() - setup_us;
+    if (sh2lib_loop_start(&hd, NULL) != 0) {
+        ESP_LOGE(TAG, "Failed to start the event loop");
+        state->failed = BENCH_REQUESTS;
+        print_result("h2", window->name, 0, setup_us);
+        goto out_free;
+    }
+
+    /* The requests are sent together when the lock is released */
+    sh2lib_lock(&hd);
+    state->start_us = esp_timer_get_time();
+    for (int i = 0; i < BENCH_REQUESTS; i++) {
+        if (sh2lib_do_get(&hd, s_paths[i % s_path_count], bench_h2_recv) < 0) {
+            state->failed++;
+        }
+    }
+    sh2lib_unlock(&hd);
+
+    int64_t deadline = state->start_us + CONFIG_EXAMPLE_HTTP2_BENCH_TIMEOUT_MS * 1000LL;
+    for (uint32_t submitted = BENCH_REQUESTS - state->failed; submitted > 0; submitted--) {
+        int64_t remaining_us = deadline - esp_timer_get_time();
+        if (remaining_us <= 0 || xSemaphoreTake(state->stream_closed, pdMS_TO_TICKS(remaining_us / 1000) + 1) != pdTRUE) {
+            break;
+        }
+    }
+    /* Stop the loop before reading the results it writes */
+    sh2lib_loop_stop(&hd);
+    if (state->completed) {
+        elapsed_us = state->latency_us[state->completed - 1];
+    }
+    state->failed = BENCH_REQUESTS - state->completed;
+    print_result("h2", window->name, elapsed_us, setup_us);
+
+out_free:
+    sh2lib_free(&hd);
+out:
+    if (state->stream_closed) {
+        vSemaphoreDelete(state->stream_closed);
+    }
+}
+
+static esp_err_t bench_h1_event(esp_http_client_event_t *evt)
+{
+    bench_state_t *state = evt->user_data;
+    if (evt->event_id == HTTP_EVENT_ON_DATA) {
+        state->bytes += evt->data_len;
+    }
+    return ESP_OK;
+}
+
+static bool bench_h1_get(esp_http_client_handle_t client, const char *path)
+{
+    char url[BENCH_URL_SIZE];
+    snprintf(url, sizeof(url), "%s%s", CONFIG_EXAMPLE_HTTP2_BENCH_SERVER, path);
+    /* The connection is kept as long as the host doesn't change */
+    esp_http_client_set_url(client, url);
+    return esp_http_client_perform(client) == ESP_OK && esp_http_client_get_status_code(client) < 400;
+}
+
+static void bench_h1_run(void)
+{
+    bench_state_t *state = &s_state;
+    char url[BENCH_URL_SIZE];
+    snprintf(url, sizeof(url), "%s%s", CONFIG_EXAMPLE_HTTP2_BENCH_SERVER, s_paths[0]);
+    esp_http_client_config_t cfg = {
+        .url = url,
+        .crt_bundle_attach = esp_crt_bundle_attach,
+        .event_handler = bench_h1_event,
+        .user_data = state,
+        .buffer_size = 4096,
+        .timeout_ms = CONFIG_EXAMPLE_HTTP2_BENCH_TIMEOUT_MS,
+    };
+
+    memset(state, 0, sizeof(*state));
+    esp_http_client_handle_t client = esp_http_client_init(&cfg);
+    if (!client) {
+        ESP_LOGE(TAG, "Failed to create the HTTP client");
+        return;
+    }
+    int64_t setup_us = esp_timer_get_time();
+    if (!bench_h1_get(client, s_paths[0])) {
+        ESP_LOGE(TAG, "Failed to connect to %s", CONFIG_EXAMPLE_HTTP2_BENCH_SERVER);
+        state->failed = BENCH_REQUESTS;
+        print_result("h1", "-", 0, 0);
+        goto out;
+    }
+    setup_us = esp_timer_get_time() - setup_us;
+
+    state->bytes = 0;
+    state->start_us = esp_timer_get_time();
+    for (int i = 0; i < BENCH_REQUESTS; i++) {
+        int64_t request_start = esp_timer_get_time();
+        if (bench_h1_get(client, s_paths[i % s_path_count])) {
+            state->latency_us[state->completed++] = esp_timer_get_time() - request_start;
+        } else {
+            state->failed++;
+        }
+    }
+    print_result("h1", "-", esp_timer_get_time() - state->start_us, setup_us);
+
+out:
+    esp_http_client_cleanup(client);
+}
+
+static void bench_task(void *args)
+{
+    /* Proper system time is required for the certificate verification */
+    set_time();
+    parse_paths();
+    ESP_LOGI(TAG, "%d requests per run on %s, %d paths", BENCH_REQUESTS, CONFIG_EXAMPLE_HTTP2_BENCH_SERVER,
+             s_path_count);
+
+    printf("H2BENCH,protocol,window,requests,completed,failed,elapsed_ms,req_per_s,kb_per_s,"
+           "lat_min_ms,lat_p50_ms,lat_p90_ms,lat_max_ms,setup_ms\n");
+    for (size_t i = 0; i < sizeof(s_windows) / sizeof(s_windows[0]); i++) {
+        bench_h2_run(&s_windows[i]);
+    }
+    bench_h1_run();
+    printf("Benchmark done\n");
+    vTaskDelete(NULL);
+}
+
+void app_main(void)
+{
+    ESP_ERROR_CHECK(nvs_flash_init());
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    /* This helper function configures Wi-Fi or Ethernet, as selected in menuconfig.
+     * Read "Establishing Wi-Fi or Ethernet Connection" section in
+     * examples/protocols/README.md for more information about this function.
+     */
+    ESP_ERROR_CHECK(example_connect());
+
+    xTaskCreate(&bench_task, "bench_task", 16 * 1024, NULL, 5, NULL);
+}
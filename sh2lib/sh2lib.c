@@ -12,17 +12,57 @@
 #include <string.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
 #include <netdb.h>
+#include <sys/select.h>
 #include <esp_log.h>
+#include <esp_vfs_eventfd.h>
 #include <http_parser.h>
 #include <esp_idf_version.h>
+#include "sdkconfig.h"
 
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "sh2lib.h"
 
 static const char *TAG = "sh2lib";
 
 #define DBG_FRAME_SEND 1
 
+/* Size of the header of an HTTP/2 frame */
+#define FRAME_HEADER_LEN 9
+
+/*
+ * The loop task holds the lock while it runs nghttp2, and releases it while it
+ * waits in select(). Writing to wake_fd wakes it up, e.g. when another task has
+ * submitted a request and the session has something new to send.
+ */
+struct sh2lib_loop {
+    struct sh2lib_handle *hd;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t done;
+    int wake_fd;
+    volatile bool stop;
+    volatile bool running;
+    int err;
+};
+
+/*
+ * The connections of the pool, the handle first so that a handle given out by
+ * sh2lib_pool_acquire() is also its entry. An entry is unlinked from the pool
+ * when its connection is replaced or flushed, and freed once released.
+ */
+struct sh2lib_pool_entry {
+    struct sh2lib_handle hd;
+    char *key;
+    int refs;
+    bool pooled;
+    struct sh2lib_pool_entry *next;
+};
+
+static struct sh2lib_pool_entry *s_pool;
+static portMUX_TYPE s_pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
 /*
  * The implementation of nghttp2_send_callback type. Here we write
  * |data| with size |length| to the network and return the number of
@@ -78,6 +118,41 @@ static ssize_t callback_send(nghttp2_session *session, const uint8_t *data,
     return rv;
 }
 
+/*
+ * The implementation of nghttp2_send_data_callback type, called for the DATA
+ * frames of the streams set up with sh2lib_do_putpost_with_nv_no_copy(). The
+ * frame header and then the payload are written straight from |framehd| and
+ * the buffer of the application. The whole frame must be written, so after a
+ * partial write the callback returns NGHTTP2_ERR_WOULDBLOCK and is called
+ * again later with the same frame, and resumes where it stopped.
+ */
+static int callback_send_data(nghttp2_session *session, nghttp2_frame *frame,
+                              const uint8_t *framehd, size_t length,
+                              nghttp2_data_source *source, void *user_data)
+{
+    struct sh2lib_handle *hd = user_data;
+
+    while (hd->no_copy_sent < FRAME_HEADER_LEN + length) {
+        const uint8_t *data;
+        size_t len;
+        if (hd->no_copy_sent < FRAME_HEADER_LEN) {
+            data = framehd + hd->no_copy_sent;
+            len = FRAME_HEADER_LEN - hd->no_copy_sent;
+        } else {
+            data = (const uint8_t *)hd->no_copy_data + hd->no_copy_sent - FRAME_HEADER_LEN;
+            len = FRAME_HEADER_LEN + length - hd->no_copy_sent;
+        }
+        ssize_t rv = callback_send(session, data, len, 0, hd);
+        if (rv < 0) {
+            return rv == NGHTTP2_ERR_WOULDBLOCK ? NGHTTP2_ERR_WOULDBLOCK : NGHTTP2_ERR_CALLBACK_FAILURE;
+        }
+        hd->no_copy_sent += rv;
+    }
+    hd->no_copy_sent = 0;
+    hd->no_copy_data = NULL;
+    return 0;
+}
+
 /*
  * The implementation of nghttp2_recv_callback type. Here we read data
  * from the network and write them in |buf|. The capacity of |buf| is
@@ -224,7 +299,7 @@ static int callback_on_invalid_header(nghttp2_session *session, const nghttp2_fr
     return 0;
 }
 
-static int do_http2_connect(struct sh2lib_handle *hd)
+static int do_http2_connect(struct sh2lib_handle *hd, const struct sh2lib_config_t *cfg)
 {
     int ret;
     nghttp2_session_callbacks *callbacks;
@@ -232,6 +307,7 @@ static int do_http2_connect(struct sh2lib_handle *hd)
     nghttp2_session_callbacks_set_error_callback2(callbacks, callback_error);
     nghttp2_session_callbacks_set_send_callback(callbacks, callback_send);
     nghttp2_session_callbacks_set_recv_callback(callbacks, callback_recv);
+    nghttp2_session_callbacks_set_send_data_callback(callbacks, callback_send_data);
     nghttp2_session_callbacks_set_on_frame_send_callback(callbacks, callback_on_frame_send);
     nghttp2_session_callbacks_set_on_frame_not_send_callback(callbacks, callback_on_frame_not_send);
     nghttp2_session_callbacks_set_on_frame_recv_callback(callbacks, callback_on_frame_recv);
@@ -239,20 +315,61 @@ static int do_http2_connect(struct sh2lib_handle *hd)
     nghttp2_session_callbacks_set_on_stream_close_callback(callbacks, callback_on_stream_close);
     nghttp2_session_callbacks_set_on_data_chunk_recv_callback(callbacks, callback_on_data_chunk_recv);
     nghttp2_session_callbacks_set_on_header_callback(callbacks, callback_on_header);
-    ret = nghttp2_session_client_new(&hd->http2_sess, callbacks, hd);
+    /* The HPACK limits of menuconfig, and the small objects of the session in its own pool */
+    nghttp2_option *option = NULL;
+    ret = nghttp2_esp_option_new(&option);
+    if (ret == 0) {
+        ret = nghttp2_esp_mem_pool_new(&hd->mem_pool);
+    }
+    if (ret == 0) {
+        ret = nghttp2_session_client_new3(&hd->http2_sess, callbacks, hd, option,
+                                          nghttp2_esp_mem_pool_get_mem(hd->mem_pool));
+    }
+    nghttp2_option_del(option);
+    nghttp2_session_callbacks_del(callbacks);
     if (ret != 0) {
         ESP_LOGE(TAG, "[sh2-connect] New http2 session failed");
-        nghttp2_session_callbacks_del(callbacks);
         return -1;
     }
-    nghttp2_session_callbacks_del(callbacks);
 
-    /* Create the SETTINGS frame */
-    ret = nghttp2_submit_settings(hd->http2_sess, NGHTTP2_FLAG_NONE, NULL, 0);
+    /* Create the SETTINGS frame, with the non-default values only */
+    nghttp2_settings_entry settings[4];
+    size_t settings_len = 0;
+    if (cfg->initial_window_size) {
+        settings[settings_len++] = (nghttp2_settings_entry) {
+            NGHTTP2_SETTINGS_INITIAL_WINDOW_SIZE, cfg->initial_window_size
+        };
+    }
+    if (cfg->max_frame_size) {
+        settings[settings_len++] = (nghttp2_settings_entry) {
+            NGHTTP2_SETTINGS_MAX_FRAME_SIZE, cfg->max_frame_size
+        };
+    }
+    uint32_t header_table_size = cfg->header_table_size ? cfg->header_table_size : CONFIG_NGHTTP2_HEADER_TABLE_SIZE;
+    if (header_table_size != NGHTTP2_DEFAULT_HEADER_TABLE_SIZE) {
+        settings[settings_len++] = (nghttp2_settings_entry) {
+            NGHTTP2_SETTINGS_HEADER_TABLE_SIZE, header_table_size
+        };
+    }
+    if (cfg->max_concurrent_streams) {
+        settings[settings_len++] = (nghttp2_settings_entry) {
+            NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS, cfg->max_concurrent_streams
+        };
+    }
+    ret = nghttp2_submit_settings(hd->http2_sess, NGHTTP2_FLAG_NONE, settings, settings_len);
     if (ret != 0) {
         ESP_LOGE(TAG, "[sh2-connect] Submit settings failed");
         return -1;
     }
+
+    /* The connection window isn't part of SETTINGS, it would otherwise limit all the streams to 64 KB in flight */
+    if (cfg->initial_window_size > NGHTTP2_INITIAL_CONNECTION_WINDOW_SIZE) {
+        ret = nghttp2_session_set_local_window_size(hd->http2_sess, NGHTTP2_FLAG_NONE, 0, cfg->initial_window_size);
+        if (ret != 0) {
+            ESP_LOGE(TAG, "[sh2-connect] Set connection window size failed");
+            return -1;
+        }
+    }
     return 0;
 }
 
@@ -298,7 +415,7 @@ int sh2lib_connect(struct sh2lib_config_t *cfg, struct sh2lib_handle *hd)
     hd->hostname = strndup(&cfg->uri[u.field_data[UF_HOST].off], u.field_data[UF_HOST].len);
 
     /* HTTP/2 Connection */
-    if (do_http2_connect(hd) != 0) {
+    if (do_http2_connect(hd, cfg) != 0) {
         ESP_LOGE(TAG, "[sh2-connect] HTTP2 Connection failed with %s", cfg->uri);
         goto error;
     }
@@ -311,10 +428,13 @@ error:
 
 void sh2lib_free(struct sh2lib_handle *hd)
 {
+    sh2lib_loop_stop(hd);
     if (hd->http2_sess) {
         nghttp2_session_del(hd->http2_sess);
         hd->http2_sess = NULL;
     }
+    nghttp2_esp_mem_pool_del(hd->mem_pool);
+    hd->mem_pool = NULL;
     if (hd->http2_tls) {
         esp_tls_conn_destroy(hd->http2_tls);
         hd->http2_tls = NULL;
@@ -343,9 +463,302 @@ int sh2lib_execute(struct sh2lib_handle *hd)
     return 0;
 }
 
+static void sh2lib_loop_task(void *arg)
+{
+    struct sh2lib_loop *loop = arg;
+    struct sh2lib_handle *hd = loop->hd;
+    int sockfd = -1;
+
+    loop->running = true;
+    if (esp_tls_get_conn_sockfd(hd->http2_tls, &sockfd) != ESP_OK) {
+        ESP_LOGE(TAG, "[sh2-loop] Failed to get the connection socket");
+        loop->err = NGHTTP2_ERR_CALLBACK_FAILURE;
+        goto exit;
+    }
+
+    while (!loop->stop) {
+        xSemaphoreTakeRecursive(loop->lock, portMAX_DELAY);
+        /* Reads until the TLS layer would block, so nothing is left buffered above the socket */
+        int ret = nghttp2_session_send(hd->http2_sess);
+        if (ret == 0) {
+            ret = nghttp2_session_recv(hd->http2_sess);
+        }
+        bool want_read = nghttp2_session_want_read(hd->http2_sess);
+        bool want_write = nghttp2_session_want_write(hd->http2_sess);
+        xSemaphoreGiveRecursive(loop->lock);
+
+        if (ret != 0) {
+            ESP_LOGE(TAG, "[sh2-loop] HTTP2 session failed %d", ret);
+            loop->err = ret;
+            break;
+        }
+        if (!want_read && !want_write) {
+            ESP_LOGD(TAG, "[sh2-loop] HTTP2 session closed");
+            break;
+        }
+
+        fd_set read_fds, write_fds;
+        FD_ZERO(&read_fds);
+        FD_ZERO(&write_fds);
+        FD_SET(sockfd, &read_fds);
+        FD_SET(loop->wake_fd, &read_fds);
+        if (want_write) {
+            FD_SET(sockfd, &write_fds);
+        }
+        if (select((sockfd > loop->wake_fd ? sockfd : loop->wake_fd) + 1, &read_fds, &write_fds, NULL, NULL) < 0) {
+            ESP_LOGE(TAG, "[sh2-loop] select failed %d", errno);
+            loop->err = NGHTTP2_ERR_CALLBACK_FAILURE;
+            break;
+        }
+        if (FD_ISSET(loop->wake_fd, &read_fds)) {
+            uint64_t count;
+            read(loop->wake_fd, &count, sizeof(count));
+        }
+    }
+
+exit:
+    loop->running = false;
+    xSemaphoreGive(loop->done);
+    vTaskDelete(NULL);
+}
+
+static void sh2lib_loop_wake(struct sh2lib_loop *loop)
+{
+    uint64_t one = 1;
+    write(loop->wake_fd, &one, sizeof(one));
+}
+
+static void sh2lib_loop_free(struct sh2lib_loop *loop)
+{
+    if (loop->wake_fd >= 0) {
+        close(loop->wake_fd);
+    }
+    if (loop->done) {
+        vSemaphoreDelete(loop->done);
+    }
+    if (loop->lock) {
+        vSemaphoreDelete(loop->lock);
+    }
+    free(loop);
+}
+
+int sh2lib_loop_start(struct sh2lib_handle *hd, const sh2lib_loop_config_t *cfg)
+{
+    const sh2lib_loop_config_t default_cfg = SH2LIB_LOOP_CONFIG_DEFAULT();
+    if (hd == NULL || hd->http2_sess == NULL || hd->loop != NULL) {
+        ESP_LOGE(TAG, "[sh2-loop] Invalid handle or loop already started");
+        return -1;
+    }
+    if (cfg == NULL) {
+        cfg = &default_cfg;
+    }
+
+    /* The application may have registered the eventfd VFS already */
+    esp_vfs_eventfd_config_t eventfd_cfg = ESP_VFS_EVENTD_CONFIG_DEFAULT();
+    esp_err_t err = esp_vfs_eventfd_register(&eventfd_cfg);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "[sh2-loop] Failed to register the eventfd VFS: %s", esp_err_to_name(err));
+        return -1;
+    }
+
+    struct sh2lib_loop *loop = calloc(1, sizeof(struct sh2lib_loop));
+    if (loop == NULL) {
+        ESP_LOGE(TAG, "[sh2-loop] Failed to allocate the loop");
+        return -1;
+    }
+    loop->hd = hd;
+    loop->lock = xSemaphoreCreateRecursiveMutex();
+    loop->done = xSemaphoreCreateBinary();
+    loop->wake_fd = eventfd(0, 0);
+    if (loop->lock == NULL || loop->done == NULL || loop->wake_fd < 0) {
+        ESP_LOGE(TAG, "[sh2-loop] Failed to create the loop");
+        sh2lib_loop_free(loop);
+        return -1;
+    }
+
+    hd->loop = loop;
+    if (xTaskCreatePinnedToCore(sh2lib_loop_task, "sh2lib_loop", cfg->task_stack_size, loop,
+                                cfg->task_priority, NULL, cfg->task_core) != pdPASS) {
+        ESP_LOGE(TAG, "[sh2-loop] Failed to create the loop task");
+        hd->loop = NULL;
+        sh2lib_loop_free(loop);
+        return -1;
+    }
+    return 0;
+}
+
+int sh2lib_loop_stop(struct sh2lib_handle *hd)
+{
+    struct sh2lib_loop *loop = hd->loop;
+    if (loop == NULL) {
+        return 0;
+    }
+    loop->stop = true;
+    sh2lib_loop_wake(loop);
+    xSemaphoreTake(loop->done, portMAX_DELAY);
+
+    int err = loop->err;
+    hd->loop = NULL;
+    sh2lib_loop_free(loop);
+    return err;
+}
+
+/* host:port of the URI, which selects the pooled connection */
+static char *sh2lib_pool_key(const char *uri)
+{
+    struct http_parser_url u;
+    http_parser_url_init(&u);
+    if (http_parser_parse_url(uri, strlen(uri), 0, &u) != 0 || !(u.field_set & (1 << UF_HOST))) {
+        return NULL;
+    }
+    uint16_t port = (u.field_set & (1 << UF_PORT)) ? u.port : 443;
+    char *key = NULL;
+    if (asprintf(&key, "%.*s:%u", u.field_data[UF_HOST].len, &uri[u.field_data[UF_HOST].off], port) < 0) {
+        return NULL;
+    }
+    return key;
+}
+
+static void sh2lib_pool_entry_free(struct sh2lib_pool_entry *entry)
+{
+    sh2lib_free(&entry->hd);
+    free(entry->key);
+    free(entry);
+}
+
+/* Called with s_pool_lock held */
+static void sh2lib_pool_unlink(struct sh2lib_pool_entry *entry)
+{
+    for (struct sh2lib_pool_entry **p = &s_pool; *p; p = &(*p)->next) {
+        if (*p == entry) {
+            *p = entry->next;
+            break;
+        }
+    }
+    entry->next = NULL;
+    entry->pooled = false;
+}
+
+struct sh2lib_handle *sh2lib_pool_acquire(struct sh2lib_config_t *cfg, const sh2lib_loop_config_t *loop_cfg)
+{
+    if (cfg == NULL || cfg->uri == NULL) {
+        ESP_LOGE(TAG, "[sh2-pool] pointer to sh2lib configurations cannot be NULL");
+        return NULL;
+    }
+    char *key = sh2lib_pool_key(cfg->uri);
+    if (key == NULL) {
+        ESP_LOGE(TAG, "[sh2-pool] Invalid URI %s", cfg->uri);
+        return NULL;
+    }
+
+    struct sh2lib_pool_entry *found = NULL;
+    struct sh2lib_pool_entry *dead = NULL;
+    portENTER_CRITICAL(&s_pool_lock);
+    for (struct sh2lib_pool_entry *entry = s_pool; entry; entry = entry->next) {
+        if (strcmp(entry->key, key) == 0) {
+            if (entry->hd.loop->running) {
+                entry->refs++;
+                found = entry;
+            } else {
+                sh2lib_pool_unlink(entry);
+                if (entry->refs == 0) {
+                    dead = entry;
+                }
+            }
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_pool_lock);
+
+    if (dead) {
+        ESP_LOGD(TAG, "[sh2-pool] Replacing the closed connection to %s", key);
+        sh2lib_pool_entry_free(dead);
+    }
+    if (found) {
+        free(key);
+        return &found->hd;
+    }
+
+    /* Connect without holding the lock, the handshake takes a while */
+    struct sh2lib_pool_entry *entry = calloc(1, sizeof(struct sh2lib_pool_entry));
+    if (entry == NULL) {
+        ESP_LOGE(TAG, "[sh2-pool] Failed to allocate the connection");
+        free(key);
+        return NULL;
+    }
+    entry->key = key;
+    if (sh2lib_connect(cfg, &entry->hd) != 0) {
+        free(key);
+        free(entry);
+        return NULL;
+    }
+    if (sh2lib_loop_start(&entry->hd, loop_cfg) != 0) {
+        sh2lib_pool_entry_free(entry);
+        return NULL;
+    }
+    entry->refs = 1;
+    entry->pooled = true;
+    portENTER_CRITICAL(&s_pool_lock);
+    entry->next = s_pool;
+    s_pool = entry;
+    portEXIT_CRITICAL(&s_pool_lock);
+    return &entry->hd;
+}
+
+void sh2lib_pool_release(struct sh2lib_handle *hd)
+{
+    struct sh2lib_pool_entry *entry = (struct sh2lib_pool_entry *)hd;
+    portENTER_CRITICAL(&s_pool_lock);
+    bool unused = --entry->refs == 0 && !entry->pooled;
+    portEXIT_CRITICAL(&s_pool_lock);
+    if (unused) {
+        sh2lib_pool_entry_free(entry);
+    }
+}
+
+void sh2lib_pool_flush(void)
+{
+    struct sh2lib_pool_entry *unused = NULL;
+    portENTER_CRITICAL(&s_pool_lock);
+    while (s_pool) {
+        struct sh2lib_pool_entry *entry = s_pool;
+        sh2lib_pool_unlink(entry);
+        if (entry->refs == 0) {
+            entry->next = unused;
+            unused = entry;
+        }
+    }
+    portEXIT_CRITICAL(&s_pool_lock);
+
+    while (unused) {
+        struct sh2lib_pool_entry *entry = unused;
+        unused = entry->next;
+        sh2lib_pool_entry_free(entry);
+    }
+}
+
+void sh2lib_lock(struct sh2lib_handle *hd)
+{
+    if (hd->loop) {
+        xSemaphoreTakeRecursive(hd->loop->lock, portMAX_DELAY);
+    }
+}
+
+void sh2lib_unlock(struct sh2lib_handle *hd)
+{
+    struct sh2lib_loop *loop = hd->loop;
+    if (loop == NULL) {
+        return;
+    }
+    xSemaphoreGiveRecursive(loop->lock);
+    sh2lib_loop_wake(loop);
+}
+
 int sh2lib_do_get_with_nv(struct sh2lib_handle *hd, const nghttp2_nv *nva, size_t nvlen, sh2lib_frame_data_recv_cb_t recv_cb)
 {
+    sh2lib_lock(hd);
     int ret = nghttp2_submit_request(hd->http2_sess, NULL, nva, nvlen, NULL, recv_cb);
+    sh2lib_unlock(hd);
     if (ret < 0) {
         ESP_LOGE(TAG, "[sh2-do-get] HEADERS call failed %i", ret);
     }
@@ -379,7 +792,44 @@ int sh2lib_do_putpost_with_nv(struct sh2lib_handle *hd, const nghttp2_nv *nva, s
     nghttp2_data_provider sh2lib_data_provider;
     sh2lib_data_provider.read_callback = sh2lib_data_provider_cb;
     sh2lib_data_provider.source.ptr = send_cb;
+    sh2lib_lock(hd);
+    int ret = nghttp2_submit_request(hd->http2_sess, NULL, nva, nvlen, &sh2lib_data_provider, recv_cb);
+    sh2lib_unlock(hd);
+    if (ret < 0) {
+        ESP_LOGE(TAG, "[sh2-do-putpost] HEADERS call failed %i", ret);
+    }
+    return ret;
+}
+
+/*
+ * nghttp2 sends one DATA frame at a time, so the payload of the frame being
+ * sent is kept in the handle until callback_send_data() has written it.
+ */
+static ssize_t sh2lib_data_provider_no_copy_cb(nghttp2_session *session, int32_t stream_id, uint8_t *buf,
+        size_t length, uint32_t *data_flags,
+        nghttp2_data_source *source, void *user_data)
+{
+    struct sh2lib_handle *h2 = user_data;
+    sh2lib_putpost_data_no_copy_cb_t data_cb = source->ptr;
+    const char *data = NULL;
+    int rv = (*data_cb)(h2, &data, length, data_flags);
+    if (rv > 0) {
+        h2->no_copy_data = data;
+        *data_flags |= NGHTTP2_DATA_FLAG_NO_COPY;
+    }
+    return rv;
+}
+
+int sh2lib_do_putpost_with_nv_no_copy(struct sh2lib_handle *hd, const nghttp2_nv *nva, size_t nvlen,
+                                      sh2lib_putpost_data_no_copy_cb_t send_cb,
+                                      sh2lib_frame_data_recv_cb_t recv_cb)
+{
+    nghttp2_data_provider sh2lib_data_provider;
+    sh2lib_data_provider.read_callback = sh2lib_data_provider_no_copy_cb;
+    sh2lib_data_provider.source.ptr = send_cb;
+    sh2lib_lock(hd);
     int ret = nghttp2_submit_request(hd->http2_sess, NULL, nva, nvlen, &sh2lib_data_provider, recv_cb);
+    sh2lib_unlock(hd);
     if (ret < 0) {
         ESP_LOGE(TAG, "[sh2-do-putpost] HEADERS call failed %i", ret);
     }
@@ -7,7 +7,9 @@
 #pragma once
 
 #include "esp_tls.h"
+#include "freertos/FreeRTOS.h"
 #include <nghttp2/nghttp2.h>
+#include "nghttp2_esp.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,8 +35,27 @@ struct sh2lib_handle {
     char            *hostname;     /*!< The hostname we are connected to */
     struct esp_tls  *http2_tls;    /*!< Pointer to the TLS session handle */
     int             http2_tls_rc;  /*!< Error code from http2_tls */
+    struct sh2lib_loop *loop;     /*!< Event loop task, if started with sh2lib_loop_start() */
+    const char      *no_copy_data; /*!< Payload of the DATA frame being sent without copy */
+    size_t          no_copy_sent;  /*!< Bytes of that frame already written, including its header */
+    nghttp2_esp_mem_pool *mem_pool; /*!< Allocator of the HTTP2 session, see CONFIG_NGHTTP2_MEM_POOL */
 };
 
+/**
+ * @brief sh2lib event loop configuration structure
+ */
+typedef struct {
+    uint32_t task_stack_size;   /*!< Stack size of the event loop task, the receive callbacks run on it */
+    UBaseType_t task_priority;  /*!< Priority of the event loop task */
+    BaseType_t task_core;       /*!< Core of the event loop task, or tskNO_AFFINITY */
+} sh2lib_loop_config_t;
+
+#define SH2LIB_LOOP_CONFIG_DEFAULT() {  \
+    .task_stack_size = 8192,            \
+    .task_priority = 5,                 \
+    .task_core = tskNO_AFFINITY,        \
+}
+
 /**
  * @brief sh2lib configuration structure
  */
@@ -46,6 +67,12 @@ struct sh2lib_config_t {
     /*!< Function pointer to esp_crt_bundle_attach. Enables the use of certification
          bundle for server verification, must be enabled in menuconfig */
     tls_keep_alive_cfg_t *keep_alive_cfg;/*!< Enable TCP keep-alive timeout for SSL connection */
+    uint32_t initial_window_size;       /*!< SETTINGS_INITIAL_WINDOW_SIZE of the streams, the connection window is
+                                             enlarged to match it. 0 for the default of 65535 bytes, which limits
+                                             the download throughput to 64 KB per round trip */
+    uint32_t max_frame_size;            /*!< SETTINGS_MAX_FRAME_SIZE, 0 for the default of 16384 bytes */
+    uint32_t header_table_size;         /*!< SETTINGS_HEADER_TABLE_SIZE, 0 for CONFIG_NGHTTP2_HEADER_TABLE_SIZE */
+    uint32_t max_concurrent_streams;    /*!< SETTINGS_MAX_CONCURRENT_STREAMS, 0 for the default of 100 streams */
 };
 
 /** Flag indicating receive stream is reset */
@@ -90,6 +117,25 @@ typedef int (*sh2lib_frame_data_recv_cb_t)(struct sh2lib_handle *handle, const c
  */
 typedef int (*sh2lib_putpost_data_cb_t)(struct sh2lib_handle *handle, char *data, size_t len, uint32_t *data_flags);
 
+/**
+ * @brief Function Prototype for callback to send data in PUT/POST without copy
+ *
+ * Same as sh2lib_putpost_data_cb_t, except that the function points 'data' to
+ * the next bytes to send instead of copying them. They are then written to the
+ * TLS connection straight from there, after the DATA frame header.
+ *
+ * @param[in] handle       Pointer to the sh2lib handle.
+ * @param[out] data        Pointer to set to the data to send. The data must stay
+ *                         valid until the function is called again for the same
+ *                         stream, or until the stream is closed.
+ * @param[in] len          The maximum length of data that can be sent out by this function.
+ * @param[out] data_flags  Pointer to the data flags. The NGHTTP2_DATA_FLAG_EOF
+ *                         should be set in the data flags to indicate end of new data.
+ *
+ * @return The function should return the number of valid bytes at the data pointer
+ */
+typedef int (*sh2lib_putpost_data_no_copy_cb_t)(struct sh2lib_handle *handle, const char **data, size_t len, uint32_t *data_flags);
+
 /**
  * @brief Connect to a URI using HTTP/2
  *
@@ -117,6 +163,46 @@ int sh2lib_connect(struct sh2lib_config_t *cfg, struct sh2lib_handle *hd);
  */
 void sh2lib_free(struct sh2lib_handle *hd);
 
+/**
+ * @brief Get a connection to a host from the connection pool
+ *
+ * Returns the pooled connection to the host and port of cfg->uri if there is
+ * one, or connects with sh2lib_connect() and adds the connection to the pool.
+ * Pooled connections are driven by their event loop task, see
+ * sh2lib_loop_start(), so that several tasks can send requests on them at the
+ * same time, each request being a new stream of the same TLS connection.
+ *
+ * Only the host and port of cfg->uri select the connection, the rest of the
+ * configuration is only used when a new connection is made. A connection whose
+ * event loop ended, e.g. because the server closed it, is replaced.
+ *
+ * @param[in] cfg       Pointer to the sh2lib configurations of the type 'struct sh2lib_config_t'
+ * @param[in] loop_cfg  Configuration of the loop task of a new connection, NULL for SH2LIB_LOOP_CONFIG_DEFAULT()
+ *
+ * @return
+ *             - Pointer to the connection handle, to release with sh2lib_pool_release()
+ *             - NULL on failure
+ */
+struct sh2lib_handle *sh2lib_pool_acquire(struct sh2lib_config_t *cfg, const sh2lib_loop_config_t *loop_cfg);
+
+/**
+ * @brief Release a connection got from sh2lib_pool_acquire()
+ *
+ * The connection stays open in the pool, to be reused by the next
+ * sh2lib_pool_acquire() for the same host.
+ *
+ * @param[in] hd      Pointer returned by sh2lib_pool_acquire()
+ */
+void sh2lib_pool_release(struct sh2lib_handle *hd);
+
+/**
+ * @brief Close the connections of the pool
+ *
+ * The connections not acquired are closed right away, the others once they
+ * are released.
+ */
+void sh2lib_pool_flush(void);
+
 /**
  * @brief Setup an HTTP GET request stream
  *
@@ -201,6 +287,68 @@ int sh2lib_do_put(struct sh2lib_handle *hd, const char *path,
  */
 int sh2lib_execute(struct sh2lib_handle *hd);
 
+/**
+ * @brief Start an event loop task driving the HTTP/2 connection
+ *
+ * Instead of calling sh2lib_execute() in a loop, the connection can be handed
+ * to a task that waits with select() on the TLS socket and runs nghttp2 only
+ * when the socket is readable, or writable while there is data to send. The
+ * callbacks of all the streams are called from this task, and it doesn't use
+ * any CPU while the connection is idle.
+ *
+ * Once the loop is started, sh2lib_execute() must not be called anymore. The
+ * sh2lib_do_*() APIs can be called from any task, or from the callbacks. Direct
+ * calls to nghttp2 from other tasks, e.g. nghttp2_session_resume_data(), must
+ * be enclosed in sh2lib_lock() and sh2lib_unlock().
+ *
+ * The loop ends on a connection error or once the session is closed by either
+ * side, sh2lib_loop_stop() must then be called to release it.
+ *
+ * @note This uses an eventfd, the eventfd VFS is registered with its default
+ *       configuration if the application hasn't registered it.
+ *
+ * @param[in] hd      Pointer to a variable of the type 'struct sh2lib_handle'
+ * @param[in] cfg     Pointer to the loop configuration, NULL for SH2LIB_LOOP_CONFIG_DEFAULT()
+ *
+ * @return
+ *             - 0 if the loop was started
+ *             - -1 on failure
+ */
+int sh2lib_loop_start(struct sh2lib_handle *hd, const sh2lib_loop_config_t *cfg);
+
+/**
+ * @brief Stop the event loop task of an HTTP/2 connection
+ *
+ * Waits for the loop task to exit. The connection stays open, and can be freed
+ * with sh2lib_free(), which also stops the loop.
+ *
+ * @param[in] hd      Pointer to a variable of the type 'struct sh2lib_handle'
+ *
+ * @return
+ *             - 0 if the loop was stopped, or ended because the session was closed
+ *             - Negative error code from nghttp2 if the loop ended on failure
+ */
+int sh2lib_loop_stop(struct sh2lib_handle *hd);
+
+/**
+ * @brief Lock the HTTP/2 connection against its event loop task
+ *
+ * Does nothing if the event loop isn't started. The lock is recursive, and is
+ * held by the loop task while it runs the callbacks.
+ *
+ * @param[in] hd      Pointer to a variable of the type 'struct sh2lib_handle'
+ */
+void sh2lib_lock(struct sh2lib_handle *hd);
+
+/**
+ * @brief Unlock the HTTP/2 connection, waking its event loop task up
+ *
+ * The loop task then sends whatever was submitted while the lock was held.
+ *
+ * @param[in] hd      Pointer to a variable of the type 'struct sh2lib_handle'
+ */
+void sh2lib_unlock(struct sh2lib_handle *hd);
+
 #define SH2LIB_MAKE_NV(NAME, VALUE)                                    \
   {                                                                    \
     (uint8_t *)NAME, (uint8_t *)VALUE, strlen(NAME), strlen(VALUE),    \
@@ -268,6 +416,29 @@ int sh2lib_do_putpost_with_nv(struct sh2lib_handle *hd, const nghttp2_nv *nva, s
                               sh2lib_putpost_data_cb_t send_cb,
                               sh2lib_frame_data_recv_cb_t recv_cb);
 
+/**
+ * @brief Setup an HTTP PUT/POST request stream sending the body without copy
+ *
+ * Same as sh2lib_do_putpost_with_nv(), except that the body is provided by
+ * reference by send_cb. sh2lib_do_putpost_with_nv() copies the body into nghttp2,
+ * which this avoids for large uploads.
+ *
+ * @param[in] hd        Pointer to a variable of the type 'struct sh2lib_handle'.
+ * @param[in] nva       An array of name-value pairs that should be part of the request.
+ * @param[in] nvlen     The number of elements in the array pointed to by 'nva'.
+ * @param[in] send_cb   The callback function that should be called for
+ *                      sending data as part of this request.
+ * @param[in] recv_cb   The callback function that should be called for
+ *                      processing the request's response
+ *
+ * @return
+ *             - Stream ID (positive integer) if request setup is successful
+ *             - Negative error code if the request setup fails
+ */
+int sh2lib_do_putpost_with_nv_no_copy(struct sh2lib_handle *hd, const nghttp2_nv *nva, size_t nvlen,
+                                      sh2lib_putpost_data_no_copy_cb_t send_cb,
+                                      sh2lib_frame_data_recv_cb_t recv_cb);
+
 #ifdef __cplusplus
 }
 #endif
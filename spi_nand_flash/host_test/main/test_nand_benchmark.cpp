@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Replays sector level traces of typical FATFS workloads against the emulated flash and reports the figures of
+ * the emulator latency model. The numbers are projections for the chip delays configured in the emulator, they
+ * are meant to compare driver changes against each other, not to predict the throughput of a given part.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "spi_nand_flash.h"
+#include "nand_linux_mmap_emul.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#define BENCH_FLASH_SIZE    (16 * 1024 * 1024)
+#define BENCH_SEED          0x5eed
+
+// Sectors used as FAT and directory by the traces, the file data starts after them
+#define BENCH_FAT_SECTOR    0
+#define BENCH_DIR_SECTOR    4
+#define BENCH_DATA_SECTOR   64
+
+typedef struct {
+    spi_nand_flash_device_t *handle;
+    uint8_t *buf;
+    uint32_t sector_size;
+    uint32_t sector_num;
+    size_t host_sectors;        // sectors written by the workload
+} bench_ctx_t;
+
+typedef void (*bench_workload_t)(bench_ctx_t *ctx);
+
+static void bench_write(bench_ctx_t *ctx, uint32_t sector)
+{
+    memset(ctx->buf, (uint8_t)(sector + ctx->host_sectors), ctx->sector_size);
+    REQUIRE(spi_nand_flash_write_sector(ctx->handle, ctx->buf, sector) == ESP_OK);
+    ctx->host_sectors++;
+}
+
+// A log file growing by one sector at a time, with the FAT and the directory entry updated every few sectors
+static void workload_log_append(bench_ctx_t *ctx)
+{
+    uint32_t data_sectors = (ctx->sector_num - BENCH_DATA_SECTOR) / 2;
+
+    for (uint32_t i = 0; i < data_sectors; i++) {
+        bench_write(ctx, BENCH_DATA_SECTOR + i);
+        if (i % 8 == 7) {
+            bench_write(ctx, BENCH_FAT_SECTOR);
+            bench_write(ctx, BENCH_DIR_SECTOR);
+        }
+        if (i % 32 == 31) {
+            REQUIRE(spi_nand_flash_sync(ctx->handle) == ESP_OK);
+        }
+    }
+}
+
+// 4 KB records overwritten at random positions of a preallocated file covering half of the capacity
+static void workload_random_overwrite(bench_ctx_t *ctx)
+{
+    uint32_t file_sectors = (ctx->sector_num - BENCH_DATA_SECTOR) / 2;
+    uint32_t record_sectors = 4096 / ctx->sector_size ? 4096 / ctx->sector_size : 1;
+    uint32_t records = file_sectors / record_sectors;
+
+    for (uint32_t i = 0; i < file_sectors; i++) {
+        bench_write(ctx, BENCH_DATA_SECTOR + i);
+    }
+    REQUIRE(spi_nand_flash_sync(ctx->handle) == ESP_OK);
+
+    srand(BENCH_SEED);
+    for (uint32_t i = 0; i < records * 3; i++) {
+        uint32_t record = rand() % records;
+        for (uint32_t j = 0; j < record_sectors; j++) {
+            bench_write(ctx, BENCH_DATA_SECTOR + record * record_sectors + j);
+        }
+        if (i % 16 == 15) {
+            REQUIRE(spi_nand_flash_sync(ctx->handle) == ESP_OK);
+        }
+    }
+}
+
+// Many one-sector files: every file writes its data, its directory entry and the FAT, then syncs
+static void workload_small_files(bench_ctx_t *ctx)
+{
+    uint32_t files = (ctx->sector_num - BENCH_DATA_SECTOR) / 2;
+    uint32_t entries_per_dir_sector = ctx->sector_size / 32;
+
+    for (uint32_t i = 0; i < files; i++) {
+        bench_write(ctx, BENCH_DATA_SECTOR + i);
+        bench_write(ctx, BENCH_DIR_SECTOR + (i / entries_per_dir_sector) % (BENCH_DATA_SECTOR - BENCH_DIR_SECTOR));
+        bench_write(ctx, BENCH_FAT_SECTOR + (i * 4 / ctx->sector_size) % BENCH_DIR_SECTOR);
+        REQUIRE(spi_nand_flash_sync(ctx->handle) == ESP_OK);
+    }
+}
+
+// Log lines of a few sectors, each synced as soon as it is written
+static void workload_log_sync(bench_ctx_t *ctx)
+{
+    uint32_t data_sectors = (ctx->sector_num - BENCH_DATA_SECTOR) / 2;
+
+    for (uint32_t i = 0; i < data_sectors; i++) {
+        bench_write(ctx, BENCH_DATA_SECTOR + i);
+        if (i % 2 == 1) {
+            bench_write(ctx, BENCH_FAT_SECTOR);
+            REQUIRE(spi_nand_flash_sync(ctx->handle) == ESP_OK);
+        }
+    }
+}
+
+static void run_benchmark_config(const char *name, bench_workload_t workload, uint8_t gc_factor, uint8_t checkpoint_pages)
+{
+    nand_file_mmap_emul_config_t conf = {"", BENCH_FLASH_SIZE, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, gc_factor, SPI_NAND_IO_MODE_SIO, 0};
+    nand_flash_config.checkpoint_pages = checkpoint_pages;
+    bench_ctx_t ctx = {};
+
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &ctx.handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_get_capacity(ctx.handle, &ctx.sector_num) == ESP_OK);
+    REQUIRE(spi_nand_flash_get_sector_size(ctx.handle, &ctx.sector_size) == ESP_OK);
+    ctx.buf = (uint8_t *)malloc(ctx.sector_size);
+    REQUIRE(ctx.buf != NULL);
+
+    nand_emul_clear_stats(ctx.handle);
+    workload(&ctx);
+    REQUIRE(spi_nand_flash_sync(ctx.handle) == ESP_OK);
+
+    uint64_t time_us;
+    size_t page_reads, page_programs;
+    nand_emul_get_timing_stats(ctx.handle, &time_us, &page_reads, &page_programs);
+
+    size_t num_blocks;
+    const uint32_t *erase_counts = nand_emul_get_erase_counts(ctx.handle, &num_blocks);
+    uint32_t erase_min = UINT32_MAX, erase_max = 0;
+    uint64_t erase_total = 0;
+    for (size_t i = 0; erase_counts && i < num_blocks; i++) {
+        erase_min = erase_counts[i] < erase_min ? erase_counts[i] : erase_min;
+        erase_max = erase_counts[i] > erase_max ? erase_counts[i] : erase_max;
+        erase_total += erase_counts[i];
+    }
+    if (erase_counts == NULL) {
+        erase_min = 0;
+    }
+
+    // bytes per microsecond is MB/s
+    double mbps = time_us ? (double)ctx.host_sectors * ctx.sector_size / time_us : 0;
+    double write_amplification = (double)page_programs / ctx.host_sectors;
+    printf("[benchmark] %s: %zu sectors written, projected %.2f MB/s, write amplification %.2f, "
+           "%zu page reads, erases per block min/avg/max %" PRIu32 "/%.2f/%" PRIu32 "\n",
+           name, ctx.host_sectors, mbps, write_amplification, page_reads,
+           erase_min, num_blocks ? (double)erase_total / num_blocks : 0.0, erase_max);
+
+    // Rewrites may be merged by the write-back buffer, but the data must have reached the flash
+    REQUIRE(page_programs > 0);
+
+    free(ctx.buf);
+    spi_nand_flash_deinit_device(ctx.handle);
+}
+
+static void run_benchmark(const char *name, bench_workload_t workload)
+{
+    run_benchmark_config(name, workload, 0, 0);
+}
+
+TEST_CASE("benchmark sequential log append", "[spi_nand_flash][benchmark]")
+{
+    run_benchmark("log append", workload_log_append);
+}
+
+TEST_CASE("benchmark random 4K overwrite", "[spi_nand_flash][benchmark]")
+{
+    run_benchmark("random 4K overwrite", workload_random_overwrite);
+}
+
+TEST_CASE("benchmark metadata heavy small files", "[spi_nand_flash][benchmark]")
+{
+    run_benchmark("small files", workload_small_files);
+}
+
+TEST_CASE("benchmark synced log with the journal and GC settings", "[spi_nand_flash][benchmark]")
+{
+    run_benchmark_config("synced log, default", workload_log_sync, 0, 0);
+    run_benchmark_config("synced log, 4 pages per checkpoint", workload_log_sync, 0, 4);
+    run_benchmark_config("synced log, 4 pages per checkpoint, gc factor 8", workload_log_sync, 8, 4);
+}
@@ -10,6 +10,10 @@
 #include "spi_nand_flash.h"
 #include "nand_linux_mmap_emul.h"
 #include "nand_private/nand_impl_wrap.h"
+#include "nand_diag_api.h"
+#include "nand_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -92,3 +96,616 @@ TEST_CASE("verify nand_prog, nand_read, nand_copy, nand_is_free works", "[spi_na
     free(temp_buf);
     spi_nand_flash_deinit_device(device_handle);
 }
+
+TEST_CASE("verify spi_nand_flash_write_sectors and spi_nand_flash_read_sectors work", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_num, sector_size;
+    REQUIRE(spi_nand_flash_get_capacity(device_handle, &sector_num) == 0);
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+
+    const uint32_t test_sector = 10;
+    const uint32_t test_count = 32;
+    REQUIRE(test_sector + test_count < sector_num);
+
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size * test_count);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size * test_count);
+    REQUIRE(temp_buf != NULL);
+
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size * test_count / sizeof(uint32_t));
+
+    REQUIRE(spi_nand_flash_write_sectors(device_handle, pattern_buf, test_sector, test_count) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sectors(device_handle, temp_buf, test_sector, test_count) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size * test_count) == 0);
+
+    // A single sector read must see the data written by the multi-sector call
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector + test_count - 1) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf + (test_count - 1) * sector_size, temp_buf, sector_size) == 0);
+
+    free(pattern_buf);
+    free(temp_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+TEST_CASE("verify a striped device interleaves the sectors of both chips", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf[2] = {{"", 50 * 1024 * 1024, false}, {"", 50 * 1024 * 1024, false}};
+    spi_nand_flash_config_t nand_flash_config[2] = {{&conf[0], 0, SPI_NAND_IO_MODE_SIO, 0},
+        {&conf[1], 0, SPI_NAND_IO_MODE_SIO, 0}
+    };
+    spi_nand_flash_device_t *members[2];
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config[0], &members[0]) == ESP_OK);
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config[1], &members[1]) == ESP_OK);
+    REQUIRE(spi_nand_flash_init_striped_device(members[0], members[0], &device_handle) == ESP_ERR_INVALID_ARG);
+    REQUIRE(spi_nand_flash_init_striped_device(members[0], members[1], &device_handle) == ESP_OK);
+
+    uint32_t sector_num, member_sector_num, sector_size;
+    REQUIRE(spi_nand_flash_get_capacity(device_handle, &sector_num) == 0);
+    REQUIRE(spi_nand_flash_get_capacity(members[0], &member_sector_num) == 0);
+    REQUIRE(sector_num == 2 * member_sector_num);
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+
+    // Odd start and count, so that both chips get a partial share
+    const uint32_t test_sector = 11;
+    const uint32_t test_count = 31;
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size * test_count);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size * test_count);
+    REQUIRE(temp_buf != NULL);
+
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size * test_count / sizeof(uint32_t));
+
+    REQUIRE(spi_nand_flash_write_sectors(device_handle, pattern_buf, test_sector, test_count) == ESP_OK);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sectors(device_handle, temp_buf, test_sector, test_count) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size * test_count) == 0);
+
+    // Sector n of the striped device is sector n / 2 of the chip n % 2
+    for (uint32_t i = 0; i < test_count; i++) {
+        uint32_t sector = test_sector + i;
+        REQUIRE(spi_nand_flash_read_sector(members[sector % 2], temp_buf, sector / 2) == ESP_OK);
+        REQUIRE(memcmp(pattern_buf + i * sector_size, temp_buf, sector_size) == 0);
+    }
+
+    // Copy across the chips
+    REQUIRE(spi_nand_flash_copy_sector(device_handle, test_sector, test_sector + test_count) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector + test_count) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    REQUIRE(spi_nand_flash_trim_range(device_handle, test_sector, test_count) == ESP_OK);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sectors(device_handle, temp_buf, test_sector, test_count) == ESP_OK);
+    for (uint32_t j = 0; j < sector_size * test_count; j++) {
+        REQUIRE(temp_buf[j] == 0xFF);
+    }
+    REQUIRE(spi_nand_flash_read_sectors(device_handle, temp_buf, sector_num - 1, 2) == ESP_ERR_INVALID_ARG);
+
+    free(pattern_buf);
+    free(temp_buf);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    spi_nand_flash_deinit_device(members[1]);
+    spi_nand_flash_deinit_device(members[0]);
+}
+
+TEST_CASE("verify nand_wrap_prog_async and nand_wrap_read_async work", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_size, block_size;
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+    REQUIRE(spi_nand_flash_get_block_size(device_handle, &block_size) == 0);
+
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(temp_buf != NULL);
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size / sizeof(uint32_t));
+
+    uint32_t test_block = 26;
+    uint32_t test_page = test_block * (block_size / sector_size);
+    REQUIRE(nand_wrap_erase_block(device_handle, test_block) == 0);
+
+    // Completing an operation which was never started is an error
+    REQUIRE(nand_wrap_async_wait(device_handle, portMAX_DELAY) == ESP_ERR_INVALID_STATE);
+
+    REQUIRE(nand_wrap_prog_async(device_handle, test_page, pattern_buf) == 0);
+    REQUIRE(nand_wrap_async_wait(device_handle, portMAX_DELAY) == 0);
+
+    REQUIRE(nand_wrap_read_async(device_handle, test_page, temp_buf) == 0);
+    REQUIRE(nand_wrap_async_wait(device_handle, portMAX_DELAY) == 0);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    // A cancelled operation unlocks the device, and there is nothing left to wait for
+    REQUIRE(nand_wrap_read_async(device_handle, test_page, temp_buf) == 0);
+    REQUIRE(nand_wrap_async_cancel(device_handle) == 0);
+    REQUIRE(nand_wrap_async_wait(device_handle, portMAX_DELAY) == ESP_ERR_INVALID_STATE);
+    REQUIRE(nand_wrap_async_cancel(device_handle) == ESP_ERR_INVALID_STATE);
+    bool is_page_free = true;
+    REQUIRE(nand_wrap_is_free(device_handle, test_page, &is_page_free) == 0);
+    REQUIRE(is_page_free == false);
+
+    free(pattern_buf);
+    free(temp_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+TEST_CASE("verify page cache serves repeated reads and drops rewritten sectors", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_size;
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+
+    const uint32_t test_sector = 5;
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(temp_buf != NULL);
+
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size / sizeof(uint32_t));
+    REQUIRE(spi_nand_flash_write_sector(device_handle, pattern_buf, test_sector) == ESP_OK);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector) == ESP_OK);
+
+    nand_page_cache_stats_t before, after;
+    REQUIRE(nand_get_page_cache_stats(device_handle, &before) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+    REQUIRE(nand_get_page_cache_stats(device_handle, &after) == ESP_OK);
+    REQUIRE(after.hits > before.hits);
+
+    // The new copy goes to another page, the read must not return the cached old data
+    fill_buffer(PATTERN_SEED + 1, pattern_buf, sector_size / sizeof(uint32_t));
+    REQUIRE(spi_nand_flash_write_sector(device_handle, pattern_buf, test_sector) == ESP_OK);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    free(pattern_buf);
+    free(temp_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+TEST_CASE("verify write-back buffer coalesces rewrites until spi_nand_flash_sync", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_size;
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+
+    const uint32_t test_sector = 7;
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(temp_buf != NULL);
+
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    nand_emul_clear_stats(device_handle);
+    for (uint32_t i = 0; i < 8; i++) {
+        fill_buffer(PATTERN_SEED + i, pattern_buf, sector_size / sizeof(uint32_t));
+        REQUIRE(spi_nand_flash_write_sector(device_handle, pattern_buf, test_sector) == ESP_OK);
+    }
+    size_t read_ops, write_ops, erase_ops, read_bytes, write_bytes;
+    nand_emul_get_stats(device_handle, &read_ops, &write_ops, &erase_ops, &read_bytes, &write_bytes);
+    REQUIRE(write_ops == 0);
+
+    // Reads must see the buffered data before it reaches the flash
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    nand_emul_get_stats(device_handle, &read_ops, &write_ops, &erase_ops, &read_bytes, &write_bytes);
+    REQUIRE(write_ops > 0);
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, test_sector) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    free(pattern_buf);
+    free(temp_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+TEST_CASE("verify spi_nand_flash_trim_range releases the whole range", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_size, sector_num;
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+    REQUIRE(spi_nand_flash_get_capacity(device_handle, &sector_num) == 0);
+
+    const uint32_t start_sector = 10, sector_count = 16;
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(temp_buf != NULL);
+
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size / sizeof(uint32_t));
+    for (uint32_t i = 0; i < sector_count + 1; i++) {
+        REQUIRE(spi_nand_flash_write_sector(device_handle, pattern_buf, start_sector + i) == ESP_OK);
+    }
+    REQUIRE(spi_nand_flash_trim_range(device_handle, start_sector, sector_count) == ESP_OK);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+
+    // Trimmed sectors read back erased, the sector after the range keeps its data
+    for (uint32_t i = 0; i < sector_count; i++) {
+        REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, start_sector + i) == ESP_OK);
+        for (uint32_t j = 0; j < sector_size; j++) {
+            REQUIRE(temp_buf[j] == 0xFF);
+        }
+    }
+    REQUIRE(spi_nand_flash_read_sector(device_handle, temp_buf, start_sector + sector_count) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+
+    REQUIRE(spi_nand_flash_trim_range(device_handle, sector_num - 1, 2) == ESP_ERR_INVALID_ARG);
+
+    free(pattern_buf);
+    free(temp_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+TEST_CASE("verify spi_nand_flash_read_partial returns the requested bytes", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    uint32_t sector_size;
+    REQUIRE(spi_nand_flash_get_sector_size(device_handle, &sector_size) == 0);
+
+    const uint32_t test_sector = 3, offset = 100, length = 64;
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t temp_buf[length];
+
+    fill_buffer(PATTERN_SEED, pattern_buf, sector_size / sizeof(uint32_t));
+    REQUIRE(spi_nand_flash_write_sector(device_handle, pattern_buf, test_sector) == ESP_OK);
+
+    // Served from the write-back buffer before the sync, from the flash after it
+    REQUIRE(spi_nand_flash_read_partial(device_handle, temp_buf, test_sector, offset, length) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf + offset, temp_buf, length) == 0);
+    REQUIRE(spi_nand_flash_sync(device_handle) == ESP_OK);
+    REQUIRE(spi_nand_flash_read_partial(device_handle, temp_buf, test_sector, offset, length) == ESP_OK);
+    REQUIRE(memcmp(pattern_buf + offset, temp_buf, length) == 0);
+
+    // A sector that was never written reads back erased
+    REQUIRE(spi_nand_flash_read_partial(device_handle, temp_buf, test_sector + 1, 0, length) == ESP_OK);
+    for (uint32_t i = 0; i < length; i++) {
+        REQUIRE(temp_buf[i] == 0xFF);
+    }
+
+    REQUIRE(spi_nand_flash_read_partial(device_handle, temp_buf, test_sector, sector_size - 1, 2) == ESP_ERR_INVALID_ARG);
+
+    free(pattern_buf);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+static void append_counter(nand_log_t *log, uint32_t *counter, size_t words)
+{
+    uint32_t chunk[250];
+    while (words > 0) {
+        size_t n = words < 250 ? words : 250;
+        for (size_t i = 0; i < n; i++) {
+            chunk[i] = (*counter)++;
+        }
+        REQUIRE(nand_log_append(log, chunk, n * sizeof(uint32_t)) == ESP_OK);
+        words -= n;
+    }
+}
+
+// Reads the whole log, which must hold consecutive values ending at end - 1, and returns the first one
+static uint32_t check_counter(nand_log_t *log, uint32_t end)
+{
+    nand_log_cursor_t cursor;
+    uint32_t chunk[250];
+    uint32_t first = 0, expected = 0, total = 0;
+    size_t read_len;
+
+    nand_log_rewind(log, &cursor);
+    do {
+        REQUIRE(nand_log_read(log, &cursor, chunk, sizeof(chunk), &read_len) == ESP_OK);
+        REQUIRE(read_len % sizeof(uint32_t) == 0);
+        for (size_t i = 0; i < read_len / sizeof(uint32_t); i++, total++) {
+            if (total == 0) {
+                first = expected = chunk[i];
+            }
+            REQUIRE(chunk[i] == expected++);
+        }
+    } while (read_len == sizeof(chunk));
+    REQUIRE(expected == end);
+    return first;
+}
+
+TEST_CASE("verify nand_log appends, rebuilds its index and wraps around", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    nand_log_t *log;
+    nand_log_info_t info;
+    uint32_t counter = 0;
+    REQUIRE(nand_log_open(device_handle, &log) == ESP_OK);
+    REQUIRE(nand_log_erase(log) == ESP_OK);
+
+    // Three and a half pages, then a small record flushed on its own
+    append_counter(log, &counter, 7 * 2036 / 8);
+    REQUIRE(nand_log_flush(log) == ESP_OK);
+    append_counter(log, &counter, 10);
+    REQUIRE(nand_log_flush(log) == ESP_OK);
+    REQUIRE(nand_log_get_info(log, &info) == ESP_OK);
+    REQUIRE(info.page_data_size == 2036);
+    REQUIRE(info.used_pages == 5);
+
+    // The index is rebuilt from the flash, and appending continues after the last page
+    nand_log_close(log);
+    REQUIRE(nand_log_open(device_handle, &log) == ESP_OK);
+    REQUIRE(check_counter(log, counter) == 0);
+    append_counter(log, &counter, 100);
+    REQUIRE(nand_log_flush(log) == ESP_OK);
+    REQUIRE(check_counter(log, counter) == 0);
+
+    // Writing more than the partition holds erases the oldest blocks
+    uint32_t capacity_words = info.num_blocks * 64 * info.page_data_size / sizeof(uint32_t);
+    append_counter(log, &counter, capacity_words);
+    REQUIRE(nand_log_flush(log) == ESP_OK);
+    REQUIRE(check_counter(log, counter) > 0);
+    REQUIRE(nand_log_get_info(log, &info) == ESP_OK);
+    REQUIRE(info.used_pages <= info.num_blocks * 64);
+
+    nand_log_close(log);
+    spi_nand_flash_deinit_device(device_handle);
+}
+
+// Sector i holds the pattern of seed + i
+static void write_sector_patterns(spi_nand_flash_device_t *handle, uint32_t seed, uint32_t count)
+{
+    uint32_t sector_size;
+    REQUIRE(spi_nand_flash_get_sector_size(handle, &sector_size) == ESP_OK);
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        fill_buffer(seed + i, pattern_buf, sector_size / sizeof(uint32_t));
+        REQUIRE(spi_nand_flash_write_sector(handle, pattern_buf, i) == ESP_OK);
+    }
+    REQUIRE(spi_nand_flash_sync(handle) == ESP_OK);
+    free(pattern_buf);
+}
+
+static void check_sector_patterns(spi_nand_flash_device_t *handle, uint32_t seed, uint32_t count)
+{
+    uint32_t sector_size;
+    REQUIRE(spi_nand_flash_get_sector_size(handle, &sector_size) == ESP_OK);
+    uint8_t *pattern_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(pattern_buf != NULL);
+    uint8_t *temp_buf = (uint8_t *)malloc(sector_size);
+    REQUIRE(temp_buf != NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        fill_buffer(seed + i, pattern_buf, sector_size / sizeof(uint32_t));
+        REQUIRE(spi_nand_flash_read_sector(handle, temp_buf, i) == ESP_OK);
+        REQUIRE(memcmp(pattern_buf, temp_buf, sector_size) == 0);
+    }
+    free(pattern_buf);
+    free(temp_buf);
+}
+
+TEST_CASE("verify background scrub relocates corrected blocks and the data survives a remount", "[spi_nand_flash]")
+{
+    // A named dump is mounted again by the second init
+    nand_file_mmap_emul_config_t conf = {"/tmp/idf-nand-scrub-test.bin", 50 * 1024 * 1024, true};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    remove(conf.flash_file_name);
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+
+    const uint32_t test_count = 16;
+    write_sector_patterns(device_handle, PATTERN_SEED, test_count);
+
+    // Every page now reads back at the refresh threshold, until the scrubber has moved a block
+    nand_emul_set_ecc_corrected_bits(device_handle, 4);
+    nand_scrub_stats_t stats = {};
+    for (int i = 0; i < 200 && stats.blocks_relocated == 0; i++) {
+        vTaskDelay(pdMS_TO_TICKS(50));
+        REQUIRE(nand_get_scrub_stats(device_handle, &stats) == ESP_OK);
+    }
+    nand_emul_set_ecc_corrected_bits(device_handle, 0);
+    REQUIRE(stats.blocks_relocated > 0);
+    REQUIRE(stats.sectors_relocated >= test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+    conf.keep_dump = false;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    check_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+}
+
+#define FAST_MOUNT_MAGIC        0x544E4D46
+#define FAST_MOUNT_ROOT_OFFSET  44
+
+// The fast mount record is at the start of the last block of the dump
+static long fast_mount_record_offset(spi_nand_flash_device_t *handle)
+{
+    uint32_t num_blocks, block_size;
+    REQUIRE(spi_nand_flash_get_block_num(handle, &num_blocks) == ESP_OK);
+    REQUIRE(spi_nand_flash_get_block_size(handle, &block_size) == ESP_OK);
+    return (long)(num_blocks - 1) * block_size;
+}
+
+static void dump_access(const char *path, long offset, void *buf, size_t len, bool write)
+{
+    FILE *f = fopen(path, "r+b");
+    REQUIRE(f != NULL);
+    REQUIRE(fseek(f, offset, SEEK_SET) == 0);
+    REQUIRE((write ? fwrite(buf, 1, len, f) : fread(buf, 1, len, f)) == len);
+    fclose(f);
+}
+
+static uint32_t dump_read_u32(const char *path, long offset)
+{
+    uint32_t value;
+    dump_access(path, offset, &value, sizeof(value), false);
+    return value;
+}
+
+static void copy_dump(const char *src_path, const char *dst_path)
+{
+    static uint8_t buf[64 * 1024];
+    FILE *src = fopen(src_path, "rb");
+    REQUIRE(src != NULL);
+    FILE *dst = fopen(dst_path, "wb");
+    REQUIRE(dst != NULL);
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), src)) > 0) {
+        REQUIRE(fwrite(buf, 1, len, dst) == len);
+    }
+    fclose(src);
+    fclose(dst);
+}
+
+// Number of page reads done by the init, the journal scan reads many more than the fast mount record
+static size_t init_device_read_ops(spi_nand_flash_config_t *config, spi_nand_flash_device_t **handle)
+{
+    size_t read_ops, write_ops, erase_ops, read_bytes, write_bytes;
+    REQUIRE(spi_nand_flash_init_device(config, handle) == ESP_OK);
+    nand_emul_get_stats(*handle, &read_ops, &write_ops, &erase_ops, &read_bytes, &write_bytes);
+    return read_ops;
+}
+
+TEST_CASE("verify fast mount restores the journal saved by a clean deinit", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"/tmp/idf-nand-fast-mount.bin", 50 * 1024 * 1024, true};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    const uint32_t test_count = 32;
+    remove(conf.flash_file_name);
+
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    long record = fast_mount_record_offset(device_handle);
+    write_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    REQUIRE(dump_read_u32(conf.flash_file_name, record) == FAST_MOUNT_MAGIC);
+
+    size_t fast_reads = init_device_read_ops(&nand_flash_config, &device_handle);
+    check_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    // Nothing was written, the record is still valid
+    REQUIRE(dump_read_u32(conf.flash_file_name, record) == FAST_MOUNT_MAGIC);
+
+    // Without the record, the same journal is found by the scan
+    uint32_t erased = 0xFFFFFFFF;
+    dump_access(conf.flash_file_name, record, &erased, sizeof(erased), true);
+    conf.keep_dump = false;
+    size_t scan_reads = init_device_read_ops(&nand_flash_config, &device_handle);
+    check_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    REQUIRE(fast_reads < scan_reads);
+}
+
+TEST_CASE("verify fast mount falls back to the journal scan after an unclean shutdown", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"/tmp/idf-nand-fast-mount.bin", 50 * 1024 * 1024, true};
+    nand_file_mmap_emul_config_t lost_conf = {"/tmp/idf-nand-fast-mount-lost.bin", 50 * 1024 * 1024, false};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    const uint32_t test_count = 32;
+    remove(conf.flash_file_name);
+
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    long record = fast_mount_record_offset(device_handle);
+    write_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+    // The first write to the flash after a fast mount erases the record
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    REQUIRE(dump_read_u32(conf.flash_file_name, record) == FAST_MOUNT_MAGIC);
+    write_sector_patterns(device_handle, PATTERN_SEED + 1, test_count);
+    REQUIRE(dump_read_u32(conf.flash_file_name, record) == 0xFFFFFFFF);
+
+    // Power loss: the flash as it is before the deinit
+    copy_dump(conf.flash_file_name, lost_conf.flash_file_name);
+    conf.keep_dump = false;
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+    // No record, the synchronized data is found by the scan
+    nand_flash_config.emul_conf = &lost_conf;
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    check_sector_patterns(device_handle, PATTERN_SEED + 1, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+}
+
+TEST_CASE("verify fast mount ignores a record with a CRC mismatch", "[spi_nand_flash]")
+{
+    nand_file_mmap_emul_config_t conf = {"/tmp/idf-nand-fast-mount.bin", 50 * 1024 * 1024, true};
+    spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0};
+    spi_nand_flash_device_t *device_handle;
+    const uint32_t test_count = 32;
+    remove(conf.flash_file_name);
+
+    REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+    long record = fast_mount_record_offset(device_handle);
+    write_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    size_t fast_reads = init_device_read_ops(&nand_flash_config, &device_handle);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+    // A restored root pointing to the wrong page would return the wrong data
+    uint32_t root = dump_read_u32(conf.flash_file_name, record + FAST_MOUNT_ROOT_OFFSET) ^ 1;
+    dump_access(conf.flash_file_name, record + FAST_MOUNT_ROOT_OFFSET, &root, sizeof(root), true);
+    size_t scan_reads = init_device_read_ops(&nand_flash_config, &device_handle);
+    REQUIRE(fast_reads < scan_reads);
+    check_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+    // The deinit replaced the damaged record with a valid one
+    conf.keep_dump = false;
+    REQUIRE(init_device_read_ops(&nand_flash_config, &device_handle) < scan_reads);
+    check_sector_patterns(device_handle, PATTERN_SEED, test_count);
+    REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+}
+
+TEST_CASE("verify the journal resumes with the configured checkpoint interval", "[spi_nand_flash]")
+{
+    // 0 is the default, the most pages the page size allows
+    const uint8_t checkpoint_pages[] = {4, 0};
+    const uint32_t test_count = 37;
+
+    for (uint8_t pages : checkpoint_pages) {
+        nand_file_mmap_emul_config_t conf = {"/tmp/idf-nand-checkpoint.bin", 50 * 1024 * 1024, true};
+        spi_nand_flash_config_t nand_flash_config = {&conf, 0, SPI_NAND_IO_MODE_SIO, 0, pages};
+        spi_nand_flash_device_t *device_handle;
+        remove(conf.flash_file_name);
+
+        // Two syncs in the middle of a checkpoint group
+        REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+        long record = fast_mount_record_offset(device_handle);
+        write_sector_patterns(device_handle, PATTERN_SEED, test_count);
+        write_sector_patterns(device_handle, PATTERN_SEED + 1, test_count);
+        REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+
+        // Without the fast mount record, the journal is resumed from its last checkpoint
+        uint32_t erased = 0xFFFFFFFF;
+        dump_access(conf.flash_file_name, record, &erased, sizeof(erased), true);
+        conf.keep_dump = false;
+        REQUIRE(spi_nand_flash_init_device(&nand_flash_config, &device_handle) == ESP_OK);
+        check_sector_patterns(device_handle, PATTERN_SEED + 1, test_count);
+        REQUIRE(spi_nand_flash_deinit_device(device_handle) == ESP_OK);
+    }
+}
@@ -16,6 +16,76 @@ extern "C" {
 
 // These API used for diagnostic purpose of SPI NAND Flash
 
+/** @brief Chip operations whose busy time is tracked by the wait statistics */
+typedef enum {
+    NAND_WAIT_OP_READ = 0,      ///< PAGE READ (array to cache)
+    NAND_WAIT_OP_PROGRAM,       ///< PROGRAM EXECUTE
+    NAND_WAIT_OP_ERASE,         ///< BLOCK ERASE
+    NAND_WAIT_OP_MAX,
+} nand_wait_op_t;
+
+/** @brief Time spent waiting for the chip to become ready, for one type of operation */
+typedef struct {
+    uint32_t count;             ///< Number of completed waits
+    uint64_t total_us;          ///< Total time spent waiting, in microseconds
+    uint32_t max_us;            ///< Longest single wait, in microseconds
+    uint32_t polls;             ///< Total number of status register reads
+} nand_wait_stats_t;
+
+#define NAND_LATENCY_HIST_BUCKETS 16
+
+/** @brief Histogram of sector write latencies, as seen by the caller of spi_nand_flash_write_sector(s) */
+typedef struct {
+    uint32_t buckets[NAND_LATENCY_HIST_BUCKETS];    ///< buckets[i] counts writes which took [2^i, 2^(i+1)) us, the last bucket also counts longer ones
+    uint32_t count;                                 ///< Total number of writes
+    uint32_t max_us;                                ///< Longest single write, in microseconds
+} nand_latency_hist_t;
+
+/** @brief Chip operation counters, for one type of operation */
+typedef struct {
+    nand_latency_hist_t latency;    ///< Busy time of each operation, from the command to the chip being ready again, its count is the number of operations
+    uint64_t total_us;              ///< Total busy time, in microseconds
+    uint32_t failures;              ///< Operations the chip reported as failed (program and erase only)
+} nand_op_stats_t;
+
+/** @brief Operation and throughput counters (CONFIG_NAND_FLASH_IO_STATS)
+ *
+ * The write amplification is `ops[NAND_WAIT_OP_PROGRAM].latency.count / sectors_written`, the pages programmed
+ * including garbage collection and metadata, per sector written by the file system.
+ */
+typedef struct {
+    nand_op_stats_t ops[NAND_WAIT_OP_MAX];  ///< Page reads, programs and block erases
+    uint64_t bytes_read;                    ///< Bytes transferred from the chip to the host, data and metadata
+    uint64_t bytes_written;                 ///< Bytes transferred from the host to the chip, data and metadata
+    uint32_t sectors_read;                  ///< Sectors read through spi_nand_flash_read_sector(s)() and spi_nand_flash_read_partial()
+    uint32_t sectors_written;               ///< Sectors written through spi_nand_flash_write_sector(s)()
+    uint32_t background_gc_steps;           ///< Pages moved by background garbage collection (CONFIG_NAND_FLASH_BACKGROUND_GC)
+} nand_io_stats_t;
+
+/** @brief Page copy counters, copies are mostly issued by garbage collection */
+typedef struct {
+    uint32_t internal_copies;   ///< Copies done by the chip's internal data move, without transferring the page over SPI
+    uint32_t host_copies;       ///< Copies between planes, which have to go through RAM
+    uint32_t ecc_failures;      ///< Copies whose destination page failed the ECC check (CONFIG_NAND_FLASH_COPY_CHECK_ECC)
+} nand_copy_stats_t;
+
+/** @brief Page cache lookup counters */
+typedef struct {
+    uint32_t hits;              ///< Page reads served from the cache
+    uint32_t misses;            ///< Page reads which had to access the chip
+} nand_page_cache_stats_t;
+
+/** @brief Background scrubber counters (CONFIG_NAND_FLASH_BACKGROUND_SCRUB) */
+typedef struct {
+    uint32_t passes;                    ///< Complete passes over the flash since init
+    uint32_t pages_checked;             ///< Pages whose ECC status was read in the last complete pass, bad blocks excluded
+    uint32_t ecc_corrected;             ///< Pages of the last complete pass with corrected bit errors
+    uint32_t ecc_exceeding_threshold;   ///< Pages of the last complete pass above the refresh threshold
+    uint32_t ecc_not_corrected;         ///< Pages of the last complete pass with uncorrectable errors
+    uint32_t blocks_relocated;          ///< Blocks whose live sectors were rewritten since init
+    uint32_t sectors_relocated;         ///< Sectors rewritten by the relocations since init
+} nand_scrub_stats_t;
+
 /** @brief Get bad block statistics for the NAND Flash.
  *
  * This function scans all the blocks in the NAND Flash and returns the total count of bad blocks.
@@ -29,12 +99,126 @@ esp_err_t nand_get_bad_block_stats(spi_nand_flash_device_t *flash, uint32_t *bad
 /** @brief Get ECC error statistics for the NAND Flash.
  *
  * This function displays the total ECC errors reported, ECC not corrected error count and ECC error count exceeding threshold.
+ * With CONFIG_NAND_FLASH_BACKGROUND_SCRUB, once the scrubber has completed a pass, the counts of that pass are displayed
+ * instead of reading the ECC status of every page.
  *
  * @param flash The handle to the SPI nand flash chip.
  * @return ESP_OK on success, or a flash error code if it failed to read the page.
  */
 esp_err_t nand_get_ecc_stats(spi_nand_flash_device_t *flash);
 
+/** @brief Get the counters of the background scrubber.
+ *
+ * The scrubber reads the ECC status of one page at a time while the flash is idle, and rewrites the live sectors of
+ * the blocks with a page at or above the refresh threshold.
+ *
+ * @note Requires CONFIG_NAND_FLASH_BACKGROUND_SCRUB to be enabled.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] stats A pointer of where to put the counters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL, ESP_ERR_INVALID_STATE if the scrubber could not be
+ *         started, ESP_ERR_NOT_SUPPORTED if the scrubber is disabled.
+ */
+esp_err_t nand_get_scrub_stats(spi_nand_flash_device_t *flash, nand_scrub_stats_t *stats);
+
+/** @brief Get the ECC level of a block, from the last scan of the background scrubber.
+ *
+ * @note Requires CONFIG_NAND_FLASH_BACKGROUND_SCRUB to be enabled.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param block The block number.
+ * @param[out] min_bits_corrected Lower bound of the bits corrected in the worst page of the block as reported by the
+ *             chip (0, 1, 4 or 7), 0xFF if a page had uncorrectable errors, 0 if the block was not scanned yet
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the block is out of range or min_bits_corrected is NULL,
+ *         ESP_ERR_INVALID_STATE if the scrubber could not be started, ESP_ERR_NOT_SUPPORTED if the scrubber is disabled.
+ */
+esp_err_t nand_get_block_ecc_level(spi_nand_flash_device_t *flash, uint32_t block, uint8_t *min_bits_corrected);
+
+/** @brief Get the wait statistics of one type of operation.
+ *
+ * Compare `total_us / count` with the typical operation time of the chip to tune the wait parameters,
+ * and `polls / count` to see how much bus time is spent reading the status register.
+ *
+ * @note Requires CONFIG_NAND_FLASH_WAIT_STATS to be enabled.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param op The operation to get the statistics for.
+ * @param[out] stats A pointer of where to put the statistics
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if op is not valid, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_get_wait_stats(spi_nand_flash_device_t *flash, nand_wait_op_t op, nand_wait_stats_t *stats);
+
+/** @brief Reset the wait statistics of all operations.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_reset_wait_stats(spi_nand_flash_device_t *flash);
+
+/** @brief Get the operation and throughput counters.
+ *
+ * Sample them periodically and compare the deltas to follow the throughput, and the histograms with
+ * nand_latency_hist_percentile() to follow the tail latency of each operation.
+ *
+ * @note Requires CONFIG_NAND_FLASH_IO_STATS to be enabled.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] stats A pointer of where to put the counters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_get_io_stats(spi_nand_flash_device_t *flash, nand_io_stats_t *stats);
+
+/** @brief Reset the operation and throughput counters.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_reset_io_stats(spi_nand_flash_device_t *flash);
+
+/** @brief Get the write latency histogram.
+ *
+ * @note Requires CONFIG_NAND_FLASH_LATENCY_STATS to be enabled.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] hist A pointer of where to put the histogram
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if hist is NULL, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_get_write_latency_hist(spi_nand_flash_device_t *flash, nand_latency_hist_t *hist);
+
+/** @brief Reset the write latency histogram.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if statistics are disabled.
+ */
+esp_err_t nand_reset_write_latency_hist(spi_nand_flash_device_t *flash);
+
+/** @brief Get an upper bound of a latency percentile from a histogram.
+ *
+ * @param hist The histogram, as returned by nand_get_write_latency_hist().
+ * @param percentile The percentile, from 1 to 100 (e.g. 99 for p99).
+ * @return The upper bound of the bucket containing the percentile in microseconds, max_us for the last bucket,
+ *         or 0 if the histogram is empty.
+ */
+uint32_t nand_latency_hist_percentile(const nand_latency_hist_t *hist, uint8_t percentile);
+
+/** @brief Get the page copy counters.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] stats A pointer of where to put the counters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if stats is NULL.
+ */
+esp_err_t nand_get_copy_stats(spi_nand_flash_device_t *flash, nand_copy_stats_t *stats);
+
+/** @brief Get the hit and miss counters of the page cache.
+ *
+ * @note Requires CONFIG_NAND_FLASH_PAGE_CACHE_SIZE to be greater than 0.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] stats A pointer of where to put the counters
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if an argument is NULL, ESP_ERR_NOT_SUPPORTED if the cache is disabled.
+ */
+esp_err_t nand_get_page_cache_stats(spi_nand_flash_device_t *flash, nand_page_cache_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@ typedef struct {
     void *mem_file_buf;
     int mem_file_fd;
     nand_file_mmap_emul_config_t file_mmap_ctrl;
+    uint8_t ecc_corrected_bits;         // reported by every page read, see nand_emul_set_ecc_corrected_bits()
 #ifdef CONFIG_NAND_ENABLE_STATS
     struct {
         size_t read_ops;
@@ -34,6 +35,11 @@ typedef struct {
         size_t erase_ops;
         size_t read_bytes;
         size_t write_bytes;
+        size_t page_reads;              // array to cache transfers, for the latency model
+        size_t page_programs;
+        uint64_t projected_time_us;     // time the operations would take on the emulated chip
+        uint32_t *block_erase_count;    // per block, allocated on the first erase
+        size_t num_blocks;
     } stats;
 #endif
 } nand_mmap_emul_handle_t;
@@ -46,6 +52,9 @@ typedef struct {
 /**
  * @brief Initialize NAND flash emulation
  *
+ * A named file which already exists with the configured size keeps its contents, so that a device can be
+ * mounted again after spi_nand_flash_deinit_device() with keep_dump set. Other files start erased.
+ *
  * @param handle spi_nand_flash_device_t handle for nand device
  * @param cfg mmap emulation configuration setting
  * @return ESP_OK on success
@@ -103,6 +112,17 @@ esp_err_t nand_emul_write(spi_nand_flash_device_t *handle, size_t addr, const vo
  */
 esp_err_t nand_emul_erase_block(spi_nand_flash_device_t *handle, size_t offset);
 
+/**
+ * @brief Make the page reads report corrected bit errors
+ *
+ * Every following page read, and nand_get_ecc_status(), reports the ECC status a real chip gives for this number
+ * of corrected bits, to exercise the data refresh paths. More than 8 bits makes the reads fail as uncorrectable.
+ *
+ * @param handle spi_nand_flash_device_t handle for nand device
+ * @param bits Number of bits corrected in every page, 0 for error free reads
+ */
+void nand_emul_set_ecc_corrected_bits(spi_nand_flash_device_t *handle, uint8_t bits);
+
 #ifdef CONFIG_NAND_ENABLE_STATS
 /**
  * @brief Get NAND operation statistics
@@ -122,6 +142,50 @@ void nand_emul_get_stats(spi_nand_flash_device_t *handle, size_t *read_ops, size
  * @param handle spi_nand_flash_device_t handle for nand device
  */
 void nand_emul_clear_stats(spi_nand_flash_device_t *handle);
+
+/**
+ * @brief Emulated chip operations accounted by the latency model
+ */
+typedef enum {
+    NAND_EMUL_OP_PAGE_READ,         ///< PAGE READ followed by a read from the cache
+    NAND_EMUL_OP_PAGE_PROGRAM,      ///< PROGRAM LOAD followed by PROGRAM EXECUTE
+    NAND_EMUL_OP_INTERNAL_COPY,     ///< PAGE READ followed by PROGRAM EXECUTE, no data transfer
+} nand_emul_op_t;
+
+/**
+ * @brief Add an operation to the latency model
+ *
+ * The projected time is the array time of the operation, taken from the read, program and erase delays of the
+ * emulated chip, plus the time to transfer `transfer_bytes` at CONFIG_NAND_EMUL_SPI_FREQ_MHZ on a single data line.
+ * Block erases are accounted by nand_emul_erase_block().
+ *
+ * @param handle spi_nand_flash_device_t handle for nand device
+ * @param op Operation issued to the chip
+ * @param transfer_bytes Number of bytes transferred over SPI
+ */
+void nand_emul_account_op(spi_nand_flash_device_t *handle, nand_emul_op_t op, size_t transfer_bytes);
+
+/**
+ * @brief Get the latency model results
+ *
+ * @param handle spi_nand_flash_device_t handle for nand device
+ * @param[out] projected_time_us Time the operations since the last clear would take on the emulated chip
+ * @param[out] page_reads Number of page reads
+ * @param[out] page_programs Number of page programs, including internal copies
+ */
+void nand_emul_get_timing_stats(spi_nand_flash_device_t *handle, uint64_t *projected_time_us, size_t *page_reads,
+                                size_t *page_programs);
+
+/**
+ * @brief Get the number of erases of every block since the last clear
+ *
+ * @param handle spi_nand_flash_device_t handle for nand device
+ * @param[out] num_blocks Number of entries in the returned array
+ * @return Array of erase counts, NULL if no block was erased yet
+ */
+const uint32_t *nand_emul_get_erase_counts(spi_nand_flash_device_t *handle, size_t *num_blocks);
+#else
+#define nand_emul_account_op(handle, op, transfer_bytes) ((void)0)
 #endif /* CONFIG_NAND_ENABLE_STATS */
 
 #ifdef __cplusplus
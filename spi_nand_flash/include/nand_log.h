@@ -0,0 +1,122 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "spi_nand_flash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Raw append-only log partition (CONFIG_NAND_FLASH_LOG_PARTITION).
+ *
+ * The last CONFIG_NAND_FLASH_LOG_PARTITION_BLOCKS blocks of the chip (before the fast mount block, if any) are not
+ * managed by dhara. Data appended to the log is programmed page after page, block after block, skipping bad blocks.
+ * Once all blocks are used, the oldest block is erased, so the log keeps the most recent data as a ring buffer.
+ * Each page starts with a small header, from which nand_log_open() rebuilds the index by reading the first page of
+ * every block.
+ */
+
+/** @brief Handle of an open log partition */
+typedef struct nand_log_t nand_log_t;
+
+/** @brief Read position in the log, see nand_log_rewind() */
+typedef struct {
+    uint32_t seq;                   ///< Sequence number of the block
+    uint32_t page;                  ///< Page in the block
+    uint32_t offset;                ///< Offset in the data of the page
+} nand_log_cursor_t;
+
+/** @brief Occupation of the log partition */
+typedef struct {
+    uint32_t num_blocks;            ///< Blocks of the partition, bad blocks included
+    uint32_t bad_blocks;            ///< Bad blocks of the partition
+    uint32_t used_pages;            ///< Programmed pages holding log data
+    uint32_t page_data_size;        ///< Log data held by one page, the page size minus the page header
+} nand_log_info_t;
+
+/** @brief Open the log partition and rebuild its index.
+ *
+ * @param flash The handle to the SPI nand flash chip.
+ * @param[out] log The handle of the log partition.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if CONFIG_NAND_FLASH_LOG_PARTITION is disabled,
+ *         ESP_ERR_NO_MEM if out of memory, or a flash error code if the scan failed.
+ */
+esp_err_t nand_log_open(spi_nand_flash_device_t *flash, nand_log_t **log);
+
+/** @brief Close the log partition, data not flushed yet is lost.
+ *
+ * Must be called before spi_nand_flash_deinit_device().
+ *
+ * @param log The handle of the log partition.
+ */
+void nand_log_close(nand_log_t *log);
+
+/** @brief Append data to the log.
+ *
+ * Data is buffered until a page is full, then programmed. Once the partition is full, the oldest block is erased.
+ *
+ * @param log The handle of the log partition.
+ * @param data The data to append.
+ * @param length The length of the data.
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if no good block is left, or a flash error code.
+ */
+esp_err_t nand_log_append(nand_log_t *log, const void *data, size_t length);
+
+/** @brief Program the data buffered by nand_log_append().
+ *
+ * The rest of the page is left unused, so flushing small amounts of data often wastes space.
+ *
+ * @param log The handle of the log partition.
+ * @return ESP_OK on success, or a flash error code.
+ */
+esp_err_t nand_log_flush(nand_log_t *log);
+
+/** @brief Set a cursor to the oldest data of the log.
+ *
+ * @param log The handle of the log partition.
+ * @param[out] cursor The cursor to set.
+ */
+void nand_log_rewind(nand_log_t *log, nand_log_cursor_t *cursor);
+
+/** @brief Read the log from a cursor, and advance the cursor.
+ *
+ * Only data programmed to flash is read, see nand_log_flush(). If the data at the cursor has been erased since,
+ * reading resumes at the oldest data.
+ *
+ * @param log The handle of the log partition.
+ * @param cursor The position to read from, set by nand_log_rewind() or a previous read.
+ * @param[out] buffer The buffer to read into.
+ * @param size The size of the buffer.
+ * @param[out] read_len The length read, less than size once the end of the log is reached.
+ * @return ESP_OK on success, or a flash error code. The cursor is moved past a page that can not be read, so
+ *         reading can continue with the next one.
+ */
+esp_err_t nand_log_read(nand_log_t *log, nand_log_cursor_t *cursor, void *buffer, size_t size, size_t *read_len);
+
+/** @brief Get the occupation of the log partition.
+ *
+ * @param log The handle of the log partition.
+ * @param[out] info The occupation of the partition.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if info is NULL.
+ */
+esp_err_t nand_log_get_info(nand_log_t *log, nand_log_info_t *info);
+
+/** @brief Erase all the data of the log partition.
+ *
+ * @param log The handle of the log partition.
+ * @return ESP_OK on success, or a flash error code.
+ */
+esp_err_t nand_log_erase(nand_log_t *log);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include "esp_err.h"
 #include "spi_nand_flash.h"
+#include "freertos/FreeRTOS.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +25,17 @@ esp_err_t nand_wrap_erase_block(spi_nand_flash_device_t *handle, uint32_t b);
 esp_err_t nand_wrap_prog(spi_nand_flash_device_t *handle, uint32_t p, const uint8_t *data);
 esp_err_t nand_wrap_is_free(spi_nand_flash_device_t *handle, uint32_t p, bool *is_free_status);
 esp_err_t nand_wrap_read(spi_nand_flash_device_t *handle, uint32_t p, size_t offset, size_t length, uint8_t *data);
+// Asynchronous page access. nand_wrap_read_async()/nand_wrap_prog_async() return as soon as the page data transfer is
+// queued to the SPI driver, so the CPU can do other work (e.g. prepare the next page) while DMA moves the data.
+// Every successfully started operation must be completed by calling nand_wrap_async_wait() from the same task, which
+// returns the result of the operation. The device is locked in between, and `data` must stay valid and DMA capable.
+// nand_wrap_async_wait() returns ESP_ERR_TIMEOUT if the transfer did not finish within `timeout`; it can then be called again,
+// or the operation can be dropped with nand_wrap_async_cancel(), which waits for the transfer and skips the page program.
+// Both return ESP_ERR_INVALID_STATE when called from another task than the one which started the operation.
+esp_err_t nand_wrap_read_async(spi_nand_flash_device_t *handle, uint32_t p, uint8_t *data);
+esp_err_t nand_wrap_prog_async(spi_nand_flash_device_t *handle, uint32_t p, const uint8_t *data);
+esp_err_t nand_wrap_async_wait(spi_nand_flash_device_t *handle, TickType_t timeout);
+esp_err_t nand_wrap_async_cancel(spi_nand_flash_device_t *handle);
 esp_err_t nand_wrap_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst);
 esp_err_t nand_wrap_get_ecc_status(spi_nand_flash_device_t *handle, uint32_t page);
 
@@ -47,9 +47,14 @@ struct spi_nand_flash_config_t {
 #endif
     uint8_t gc_factor;                       ///< The gc factor controls the number of blocks to spare block ratio.
     ///< Lower values will reduce the available space but increase performance
+    ///< and lower the write amplification of rewrites. 0 for the default of 45
     spi_nand_flash_io_mode_t io_mode;        ///< set io mode for SPI NAND communication
     uint8_t flags;                           ///< set flag with SPI_DEVICE_HALFDUPLEX for half duplex communication, 0 for full-duplex.
     ///< This flag value must match the flag value in the spi_device_interface_config_t structure.
+    uint8_t checkpoint_pages;                ///< Pages written between two checkpoints of the Dhara journal, a power of 2.
+    ///< 0 for the most that the page size allows, 16 for 2 KB pages. A sync pads the current checkpoint
+    ///< group, so fewer pages waste less flash when syncing often, at the cost of one metadata page per group.
+    ///< Must stay the same as long as the flash holds data written with it
 };
 
 typedef struct spi_nand_flash_config_t spi_nand_flash_config_t;
@@ -65,6 +70,9 @@ typedef struct spi_nand_flash_config_t spi_nand_flash_config_t;
 esp_err_t spi_nand_flash_init_device(spi_nand_flash_config_t *config, spi_nand_flash_device_t **handle);
 
 /** @brief Read a sector from the nand flash.
+ *
+ * If buffer is word aligned and in DMA capable memory, the sector is received directly into it.
+ * Other buffers cost one extra copy of the sector.
  *
  * @param handle The handle to the SPI nand flash chip.
  * @param[out] buffer The output buffer to put the read data into.
@@ -73,6 +81,36 @@ esp_err_t spi_nand_flash_init_device(spi_nand_flash_config_t *config, spi_nand_f
  */
 esp_err_t spi_nand_flash_read_sector(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id);
 
+/** @brief Read a part of a sector from the nand flash.
+ *
+ * Only the requested bytes are transferred from the chip, which makes small lookups such as
+ * FAT entries cheaper than a full sector read. Unlike spi_nand_flash_read_sector(), a sector
+ * with corrected bit errors is not rewritten; the next full read of the sector takes care of it.
+ *
+ * @param handle The handle to the SPI nand flash chip.
+ * @param[out] buffer The output buffer, at least length bytes.
+ * @param sector_id The id of the sector to read.
+ * @param offset Offset of the first byte to read within the sector.
+ * @param length Number of bytes to read, offset + length must not exceed the sector size.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the range is not within the sector,
+ *         or a flash error code if the read failed.
+ */
+esp_err_t spi_nand_flash_read_partial(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id,
+                                      uint32_t offset, uint32_t length);
+
+/** @brief Read consecutive sectors from the nand flash.
+ *
+ * Equivalent to calling spi_nand_flash_read_sector() for each sector in the range, but the device
+ * is locked only once for the whole transfer.
+ *
+ * @param handle The handle to the SPI nand flash chip.
+ * @param[out] buffer The output buffer to put the read data into. Must be at least sector_count * sector size bytes.
+ * @param start_sector The id of the first sector to read.
+ * @param sector_count The number of sectors to read.
+ * @return ESP_OK on success, or a flash error code if the read failed.
+ */
+esp_err_t spi_nand_flash_read_sectors(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t start_sector, uint32_t sector_count);
+
 /** @brief Copy a sector to another sector from the nand flash.
  *
  * @param handle The handle to the SPI nand flash chip.
@@ -91,6 +129,19 @@ esp_err_t spi_nand_flash_copy_sector(spi_nand_flash_device_t *handle, uint32_t s
  */
 esp_err_t spi_nand_flash_write_sector(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t sector_id);
 
+/** @brief Write consecutive sectors to the nand flash.
+ *
+ * Equivalent to calling spi_nand_flash_write_sector() for each sector in the range, but the device
+ * is locked only once for the whole transfer.
+ *
+ * @param handle The handle to the SPI nand flash chip.
+ * @param buffer The input buffer containing the data to write. Must be at least sector_count * sector size bytes.
+ * @param start_sector The id of the first sector to write.
+ * @param sector_count The number of sectors to write.
+ * @return ESP_OK on success, or a flash error code if the write failed.
+ */
+esp_err_t spi_nand_flash_write_sectors(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t start_sector, uint32_t sector_count);
+
 /** @brief Trim sector from the nand flash.
  *
  * This function marks specified sector as free to optimize memory usage
@@ -103,6 +154,19 @@ esp_err_t spi_nand_flash_write_sector(spi_nand_flash_device_t *handle, const uin
  */
 esp_err_t spi_nand_flash_trim(spi_nand_flash_device_t *handle, uint32_t sector_id);
 
+/** @brief Trim consecutive sectors from the nand flash.
+ *
+ * Equivalent to calling spi_nand_flash_trim() for each sector in the range, but the device
+ * is locked only once. Sectors which hold no data are skipped without touching the flash.
+ *
+ * @param handle The handle to the SPI nand flash chip.
+ * @param start_sector The id of the first sector to be trimmed.
+ * @param sector_count The number of sectors to be trimmed.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the range exceeds the capacity,
+ *         or a flash error code if the trim failed.
+ */
+esp_err_t spi_nand_flash_trim_range(spi_nand_flash_device_t *handle, uint32_t start_sector, uint32_t sector_count);
+
 /** @brief Synchronizes any cache to the device.
  *
  * After this method is called, the nand flash chip should be synchronized with the results of any previous read/writes.
@@ -151,7 +215,28 @@ esp_err_t spi_nand_erase_chip(spi_nand_flash_device_t *handle);
  */
 esp_err_t spi_nand_flash_get_block_num(spi_nand_flash_device_t *handle, uint32_t *number_of_blocks);
 
+/** @brief Initialise a striped device over two SPI nand flash chips.
+ *
+ * The sectors of the striped device alternate between the two chips: sector n is sector n / 2 of member0 if n is
+ * even, of member1 if n is odd. Multi-sector reads and writes, and syncs, run on both chips at once, the share of
+ * member1 in a task of priority CONFIG_NAND_FLASH_STRIPE_TASK_PRIORITY, so that chips on different SPI hosts roughly
+ * double the sequential throughput. The striped handle works with all the spi_nand_flash_* functions and with the
+ * FATFS diskio, the diagnostic functions of nand_diag_api.h need the member handles.
+ *
+ * @note The members must not be accessed directly while the striped device is in use, and must stay initialized
+ *       until the striped device is de-initialized. Always stripe them in the same order.
+ *
+ * @param member0 Handle of the chip holding the even sectors.
+ * @param member1 Handle of the chip holding the odd sectors, with the same sector size.
+ * @param[out] handle The handle to the striped device is returned in this variable.
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if the devices cannot be striped, ESP_ERR_NO_MEM if out of memory.
+ */
+esp_err_t spi_nand_flash_init_striped_device(spi_nand_flash_device_t *member0, spi_nand_flash_device_t *member1,
+                                             spi_nand_flash_device_t **handle);
+
 /** @brief De-initialize the handle, releasing any resources reserved.
+ *
+ * For a striped device, the member devices are left initialized, de-initialize them afterwards.
  *
  * @param handle The handle to the SPI nand flash chip.
  * @return ESP_OK on success, or a flash error code if the de-initialization failed.
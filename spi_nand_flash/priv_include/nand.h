@@ -9,7 +9,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "spi_nand_flash.h"
+#include "nand_diag_api.h"
 #ifdef CONFIG_IDF_TARGET_LINUX
 #include "freertos/FreeRTOS.h"
 #include "nand_linux_mmap_emul.h"
@@ -24,6 +26,7 @@ extern "C" {
 
 #define NAND_FLAG_HAS_PROG_PLANE_SELECT       BIT(0)
 #define NAND_FLAG_HAS_READ_PLANE_SELECT       BIT(1)
+#define NAND_FLAG_HAS_CACHE_READ              BIT(2)  // supports READ PAGE CACHE SEQUENTIAL (0x31) / LAST (0x3F)
 
 typedef enum {
     STAT_ECC_OK = 0,
@@ -66,15 +69,44 @@ typedef struct {
     esp_err_t (*init)(spi_nand_flash_device_t *handle);
     esp_err_t (*deinit)(spi_nand_flash_device_t *handle);
     esp_err_t (*read)(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id);
+    esp_err_t (*read_partial)(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id, uint32_t offset, uint32_t length);
     esp_err_t (*write)(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t sector_id);
+    esp_err_t (*read_sectors)(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t start_sector, uint32_t sector_count);
+    esp_err_t (*write_sectors)(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t start_sector, uint32_t sector_count);
     esp_err_t (*erase_chip)(spi_nand_flash_device_t *handle);
     esp_err_t (*erase_block)(spi_nand_flash_device_t *handle, uint32_t block);
     esp_err_t (*trim)(spi_nand_flash_device_t *handle, uint32_t sector_id);
+    esp_err_t (*trim_range)(spi_nand_flash_device_t *handle, uint32_t start_sector, uint32_t sector_count);
     esp_err_t (*sync)(spi_nand_flash_device_t *handle);
     esp_err_t (*copy_sector)(spi_nand_flash_device_t *handle, uint32_t src_sec, uint32_t dst_sec);
     esp_err_t (*get_capacity)(spi_nand_flash_device_t *handle, uint32_t *number_of_sectors);
 } spi_nand_ops;
 
+typedef enum {
+    NAND_ASYNC_OP_NONE = 0,
+    NAND_ASYNC_OP_READ,
+    NAND_ASYNC_OP_PROG,
+} nand_async_op_t;
+
+typedef struct {
+    nand_async_op_t op;             // operation started by nand_read_async()/nand_prog_async(), completed by nand_async_wait()
+    uint32_t page;
+    TaskHandle_t owner;             // task which started the operation through nand_impl_wrap.h and holds the mutex
+#ifndef CONFIG_IDF_TARGET_LINUX
+    bool trans_pending;             // a transaction was queued with spi_nand_queue_transaction()
+    spi_transaction_ext_t trans;    // must stay valid until the queued transaction is done
+    uint8_t *rx_copy_dst;
+    uint32_t rx_copy_len;
+#else
+    esp_err_t result;
+#endif
+} nand_async_ctx_t;
+
+typedef struct {
+    uint8_t *known;                 // bit set once the bad block marker of the block has been read
+    uint8_t *bad;                   // bit set if the block is bad, valid only if the bit in known is set
+} nand_bbt_t;
+
 struct spi_nand_flash_device_t {
     spi_nand_flash_config_t config;
     spi_nand_chip_t chip;
@@ -84,6 +116,18 @@ struct spi_nand_flash_device_t {
     uint8_t *read_buffer;
     uint8_t *temp_buffer;
     SemaphoreHandle_t mutex;
+    nand_bbt_t bbt;
+    nand_copy_stats_t copy_stats;
+    nand_async_ctx_t async;
+#if CONFIG_NAND_FLASH_WAIT_STATS
+    nand_wait_stats_t wait_stats[NAND_WAIT_OP_MAX];
+#endif
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    nand_latency_hist_t write_latency;
+#endif
+#if CONFIG_NAND_FLASH_IO_STATS
+    nand_io_stats_t io_stats;
+#endif
 #ifdef CONFIG_IDF_TARGET_LINUX
     nand_mmap_emul_handle_t *emul_handle;
 #endif
@@ -92,6 +136,52 @@ struct spi_nand_flash_device_t {
 esp_err_t nand_register_dev(spi_nand_flash_device_t *handle);
 esp_err_t nand_unregister_dev(spi_nand_flash_device_t *handle);
 
+/* Stops the tasks which write to the flash on their own (GC, scrub, timed write-back flush), so that nothing
+ * changes the flash after the final sync of deinit. Also done by nand_unregister_dev(). */
+void nand_stop_background_tasks(spi_nand_flash_device_t *handle);
+
+/* Striped device of spi_nand_flash_init_striped_device(), the sectors go round NAND_STRIPE_WIDTH member devices */
+#define NAND_STRIPE_WIDTH 2
+
+extern const spi_nand_ops nand_stripe_ops;
+
+/* Releases the striped device, the member devices are left initialized */
+esp_err_t nand_stripe_deinit_device(spi_nand_flash_device_t *handle);
+
+/* Persists the mount state of the synchronized FTL, so that the next init can skip the journal scan */
+esp_err_t nand_save_mount_state(spi_nand_flash_device_t *handle);
+
+/* Invalidates the saved mount state, called before changing the flash outside of the FTL (e.g. a bad block marker) */
+esp_err_t nand_disarm_mount_state(spi_nand_flash_device_t *handle);
+
+/* In-RAM bad block table, filled by nand_is_bad() and nand_mark_bad(). nand_bbt_get() returns false if the
+ * block has not been checked yet. */
+bool nand_bbt_get(spi_nand_flash_device_t *handle, uint32_t block, bool *is_bad);
+void nand_bbt_set(spi_nand_flash_device_t *handle, uint32_t block, bool is_bad);
+
+/* Adds a sample to a latency histogram */
+static inline void nand_latency_hist_add(nand_latency_hist_t *hist, uint32_t elapsed_us)
+{
+    int bucket = 31 - __builtin_clz(elapsed_us | 1);
+
+    if (bucket >= NAND_LATENCY_HIST_BUCKETS) {
+        bucket = NAND_LATENCY_HIST_BUCKETS - 1;
+    }
+    hist->buckets[bucket]++;
+    hist->count++;
+    if (elapsed_us > hist->max_us) {
+        hist->max_us = elapsed_us;
+    }
+}
+
+/* Returns true if the ECC status of the last page read requires the sector to be rewritten */
+bool nand_need_data_refresh(spi_nand_flash_device_t *handle);
+
+/* State of the background scrubber, called with the mutex held. Return ESP_ERR_NOT_SUPPORTED if
+ * CONFIG_NAND_FLASH_BACKGROUND_SCRUB is disabled, ESP_ERR_INVALID_STATE if its task could not be started. */
+esp_err_t nand_scrub_get_stats(spi_nand_flash_device_t *handle, nand_scrub_stats_t *stats);
+esp_err_t nand_scrub_get_block_level(spi_nand_flash_device_t *handle, uint32_t block, uint8_t *min_bits_corrected);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,11 @@ esp_err_t nand_erase_block(spi_nand_flash_device_t *handle, uint32_t b);
 esp_err_t nand_prog(spi_nand_flash_device_t *handle, uint32_t p, const uint8_t *data);
 esp_err_t nand_is_free(spi_nand_flash_device_t *handle, uint32_t p, bool *is_free_status);
 esp_err_t nand_read(spi_nand_flash_device_t *handle, uint32_t p, size_t offset, size_t length, uint8_t *data);
+esp_err_t nand_read_pages(spi_nand_flash_device_t *handle, uint32_t p, uint32_t count, uint8_t *data);
+esp_err_t nand_read_async(spi_nand_flash_device_t *handle, uint32_t p, uint8_t *data);
+esp_err_t nand_prog_async(spi_nand_flash_device_t *handle, uint32_t p, const uint8_t *data);
+esp_err_t nand_async_wait(spi_nand_flash_device_t *handle, TickType_t timeout);
+esp_err_t nand_async_cancel(spi_nand_flash_device_t *handle);
 esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst);
 esp_err_t nand_get_ecc_status(spi_nand_flash_device_t *handle, uint32_t page);
 
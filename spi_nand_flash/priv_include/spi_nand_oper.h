@@ -36,6 +36,8 @@ typedef struct spi_nand_transaction_t spi_nand_transaction_t;
 #define CMD_WRITE_ENABLE    0x06
 #define CMD_READ_ID         0x9F
 #define CMD_PAGE_READ       0x13
+#define CMD_READ_CACHE_SEQ  0x31
+#define CMD_READ_CACHE_LAST 0x3F
 #define CMD_PROGRAM_EXECUTE 0x10
 #define CMD_PROGRAM_LOAD    0x84
 #define CMD_PROGRAM_LOAD_X4 0x34
@@ -59,14 +61,22 @@ typedef struct spi_nand_transaction_t spi_nand_transaction_t;
 #define STAT_ECC2           1 << 6
 
 esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction);
+// Queues a DMA transaction without waiting for it. Only one transaction can be pending at a time and no other
+// transaction may be executed on the device until spi_nand_finish_transaction() has returned.
+esp_err_t spi_nand_queue_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction);
+esp_err_t spi_nand_finish_transaction(spi_nand_flash_device_t *handle, TickType_t timeout);
 
 esp_err_t spi_nand_read_register(spi_nand_flash_device_t *handle, uint8_t reg, uint8_t *val);
 esp_err_t spi_nand_write_register(spi_nand_flash_device_t *handle, uint8_t reg, uint8_t val);
 esp_err_t spi_nand_write_enable(spi_nand_flash_device_t *handle);
 esp_err_t spi_nand_read_page(spi_nand_flash_device_t *handle, uint32_t page);
+esp_err_t spi_nand_read_cache_sequential(spi_nand_flash_device_t *handle);
+esp_err_t spi_nand_read_cache_last(spi_nand_flash_device_t *handle);
 esp_err_t spi_nand_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length);
+esp_err_t spi_nand_read_start(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length);
 esp_err_t spi_nand_program_execute(spi_nand_flash_device_t *handle, uint32_t page);
 esp_err_t spi_nand_program_load(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length);
+esp_err_t spi_nand_program_load_start(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length);
 esp_err_t spi_nand_erase_block(spi_nand_flash_device_t *handle, uint32_t page);
 
 #ifdef __cplusplus
@@ -7,26 +7,888 @@
  */
 
 #include <string.h>
+#include <inttypes.h>
 #include <sys/lock.h>
 #include "dhara/nand.h"
 #include "dhara/map.h"
 #include "dhara/error.h"
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+#include "dhara/bytes.h"
+#include "esp_rom_crc.h"
+#endif
 #include "esp_check.h"
 #include "esp_err.h"
+#include "esp_heap_caps.h"
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0 && CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+#include "freertos/timers.h"
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_GC || CONFIG_NAND_FLASH_BACKGROUND_SCRUB || \
+    (CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0 && CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0)
+#include "freertos/task.h"
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+#include "dhara/bytes.h"
+#endif
 #ifndef CONFIG_IDF_TARGET_LINUX
+#include "esp_memory_utils.h"
 #include "spi_nand_oper.h"
 #endif
 #include "nand_impl.h"
 #include "nand.h"
 
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0 || CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0 || CONFIG_NAND_FLASH_FAST_MOUNT || \
+    CONFIG_NAND_FLASH_BACKGROUND_GC || CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+static const char *TAG = "dhara_glue";
+#endif
+
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+typedef struct {
+    uint32_t page;              // physical page held by the entry, INVALID_CACHE_PAGE if unused
+    uint32_t last_use;          // value of use_counter at the last access, the lowest one is evicted first
+} page_cache_entry_t;
+
+#define INVALID_CACHE_PAGE UINT32_MAX
+
+typedef struct {
+    page_cache_entry_t entries[CONFIG_NAND_FLASH_PAGE_CACHE_SIZE];
+    uint8_t *data;              // CONFIG_NAND_FLASH_PAGE_CACHE_SIZE pages, one after another
+    uint32_t use_counter;
+    uint32_t hits;
+    uint32_t misses;
+} page_cache_t;
+#endif //CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+#define INVALID_BUFFERED_SECTOR UINT32_MAX
+#define WRITE_BUFFER_FLUSH_STACK_SIZE 3072
+#define WRITE_BUFFER_FLUSH_TASK_PRIORITY 1     // same as the default priority of the timer service task
+
+typedef struct {
+    uint32_t sectors[CONFIG_NAND_FLASH_WRITE_BACK_SECTORS];    // logical sector held by each slot, INVALID_BUFFERED_SECTOR if unused
+    uint8_t *data;              // CONFIG_NAND_FLASH_WRITE_BACK_SECTORS sectors, one after another
+    uint32_t count;             // number of used slots
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+    TimerHandle_t flush_timer;
+    TaskHandle_t flush_task;    // flushes the buffer when notified by flush_timer
+#endif
+} write_buffer_t;
+#endif //CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+#define FAST_MOUNT_MAGIC 0x544E4D46     // "FMNT"
+#define FAST_MOUNT_VERSION 2
+
+// Stored at the start of page 0 of the last block of the chip, followed by the bad block bitmap
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t crc;                   // CRC32 of the record with this field set to 0, and of the bitmap
+    uint32_t num_blocks;            // geometry the record was written with
+    uint32_t log2_ppb;
+    uint32_t log2_page_size;
+    uint32_t gc_factor;
+    uint32_t log2_ppc;              // checkpoint interval the journal was written with
+    // dhara journal state after dhara_map_sync()
+    uint32_t head;
+    uint32_t tail;
+    uint32_t tail_sync;
+    uint32_t root;
+    uint32_t bb_current;
+    uint32_t bb_last;
+    uint32_t epoch;
+    uint32_t flags;
+    uint32_t count;                 // number of mapped sectors
+} fast_mount_record_t;
+
+typedef struct {
+    uint32_t block;                 // reserved block holding the record, not managed by dhara
+    bool usable;                    // the reserved block is good and the record fits into a page
+    bool armed;                     // the stored record matches the flash, it must be erased before the flash is modified
+} fast_mount_t;
+#endif //CONFIG_NAND_FLASH_FAST_MOUNT
+
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+#define BACKGROUND_GC_STACK_SIZE 3072
+
+typedef struct {
+    TaskHandle_t task;
+    TickType_t last_io;             // tick count of the last foreground read or write
+    bool pending;                   // sectors were modified since the last GC pass which could not reach the reserve
+} background_gc_t;
+#endif //CONFIG_NAND_FLASH_BACKGROUND_GC
+
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+#define BACKGROUND_SCRUB_STACK_SIZE 3072
+#define SCRUB_LEVEL_NOT_CORRECTED 0xFF
+
+typedef struct {
+    TaskHandle_t task;
+    TickType_t last_io;             // tick count of the last foreground read or write
+    TickType_t pass_end;            // tick count at the end of the last complete pass
+    uint32_t next_page;             // next page to check, the pass is complete when it wraps to 0
+    uint8_t *block_levels;          // per block, the minimum number of corrected bits of its worst page in the last scan
+    uint8_t *buffer;                // page buffer for the relocations, DMA capable
+    nand_scrub_stats_t stats;       // pass counters are those of the current pass until it completes
+    nand_scrub_stats_t last_pass;   // copy of the counters at the end of the last complete pass
+} background_scrub_t;
+#endif //CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+
 typedef struct {
     struct dhara_nand dhara_nand;
     struct dhara_map dhara_map;
     spi_nand_flash_device_t *parent_handle;
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+    background_gc_t background_gc;
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    background_scrub_t background_scrub;
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    fast_mount_t fast_mount;
+#endif
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_t page_cache;
+#endif
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_t write_buffer;
+#endif
 } spi_nand_flash_dhara_priv_data_t;
 
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+static esp_err_t page_cache_init(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    page_cache_t *cache = &priv->page_cache;
+    size_t size = CONFIG_NAND_FLASH_PAGE_CACHE_SIZE * priv->parent_handle->chip.page_size;
+
+    // Pages are copied in and out of the cache by the CPU, so it does not need to be DMA capable
+#if CONFIG_SPIRAM
+    cache->data = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#endif
+    if (cache->data == NULL) {
+        cache->data = heap_caps_malloc(size, MALLOC_CAP_8BIT);
+    }
+    if (cache->data == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < CONFIG_NAND_FLASH_PAGE_CACHE_SIZE; i++) {
+        cache->entries[i].page = INVALID_CACHE_PAGE;
+    }
+    return ESP_OK;
+}
+
+static void page_cache_deinit(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    free(priv->page_cache.data);
+    priv->page_cache.data = NULL;
+}
+
+// Returns the cached copy of the page, or NULL on a miss
+static uint8_t *page_cache_lookup(spi_nand_flash_dhara_priv_data_t *priv, uint32_t page)
+{
+    page_cache_t *cache = &priv->page_cache;
+    if (cache->data == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < CONFIG_NAND_FLASH_PAGE_CACHE_SIZE; i++) {
+        if (cache->entries[i].page == page) {
+            cache->entries[i].last_use = ++cache->use_counter;
+            cache->hits++;
+            return cache->data + i * priv->parent_handle->chip.page_size;
+        }
+    }
+    cache->misses++;
+    return NULL;
+}
+
+static void page_cache_insert(spi_nand_flash_dhara_priv_data_t *priv, uint32_t page, const uint8_t *data)
+{
+    page_cache_t *cache = &priv->page_cache;
+    int victim = 0;
+    if (cache->data == NULL) {
+        return;
+    }
+    for (int i = 0; i < CONFIG_NAND_FLASH_PAGE_CACHE_SIZE; i++) {
+        if (cache->entries[i].page == INVALID_CACHE_PAGE) {
+            victim = i;
+            break;
+        }
+        if (cache->entries[i].last_use < cache->entries[victim].last_use) {
+            victim = i;
+        }
+    }
+    cache->entries[victim].page = page;
+    cache->entries[victim].last_use = ++cache->use_counter;
+    memcpy(cache->data + victim * priv->parent_handle->chip.page_size, data, priv->parent_handle->chip.page_size);
+}
+
+static void page_cache_invalidate(spi_nand_flash_dhara_priv_data_t *priv, uint32_t first_page, uint32_t count)
+{
+    page_cache_t *cache = &priv->page_cache;
+    for (int i = 0; i < CONFIG_NAND_FLASH_PAGE_CACHE_SIZE; i++) {
+        if (cache->entries[i].page != INVALID_CACHE_PAGE &&
+                cache->entries[i].page >= first_page && cache->entries[i].page - first_page < count) {
+            cache->entries[i].page = INVALID_CACHE_PAGE;
+        }
+    }
+}
+
+static void page_cache_invalidate_block(spi_nand_flash_dhara_priv_data_t *priv, uint32_t block)
+{
+    uint8_t log2_ppb = priv->parent_handle->chip.log2_ppb;
+    page_cache_invalidate(priv, block << log2_ppb, 1 << log2_ppb);
+}
+#endif //CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+static uint8_t *write_buffer_find(spi_nand_flash_dhara_priv_data_t *priv, uint32_t sector)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS && wb->count; i++) {
+        if (wb->sectors[i] == sector) {
+            return wb->data + i * priv->parent_handle->chip.page_size;
+        }
+    }
+    return NULL;
+}
+
+static void write_buffer_drop(spi_nand_flash_dhara_priv_data_t *priv, uint32_t sector)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS && wb->count; i++) {
+        if (wb->sectors[i] == sector) {
+            wb->sectors[i] = INVALID_BUFFERED_SECTOR;
+            wb->count--;
+            return;
+        }
+    }
+}
+
+static void write_buffer_clear(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS; i++) {
+        wb->sectors[i] = INVALID_BUFFERED_SECTOR;
+    }
+    wb->count = 0;
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+    if (wb->flush_timer) {
+        xTimerStop(wb->flush_timer, 0);
+    }
+#endif
+}
+
+// Writes the buffered sectors to dhara in ascending order, so adjacent sectors end up on consecutive pages
+static esp_err_t write_buffer_flush(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    dhara_error_t err;
+
+    while (wb->count) {
+        int next = -1;
+        for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS; i++) {
+            if (wb->sectors[i] != INVALID_BUFFERED_SECTOR && (next < 0 || wb->sectors[i] < wb->sectors[next])) {
+                next = i;
+            }
+        }
+        // Keep the sector buffered on failure, so a later flush can retry it
+        if (dhara_map_write(&priv->dhara_map, wb->sectors[next], wb->data + next * priv->parent_handle->chip.page_size, &err)) {
+            return ESP_ERR_FLASH_BASE + err;
+        }
+        wb->sectors[next] = INVALID_BUFFERED_SECTOR;
+        wb->count--;
+    }
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+    if (wb->flush_timer) {
+        xTimerStop(wb->flush_timer, 0);
+    }
+#endif
+    return ESP_OK;
+}
+
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+// The flush takes page programs and possibly garbage collection, which must not run on the timer service task
+static void write_buffer_timer_cb(TimerHandle_t timer)
+{
+    spi_nand_flash_dhara_priv_data_t *priv = (spi_nand_flash_dhara_priv_data_t *)pvTimerGetTimerID(timer);
+    xTaskNotifyGive(priv->write_buffer.flush_task);
+}
+
+static void write_buffer_flush_task(void *arg)
+{
+    spi_nand_flash_dhara_priv_data_t *priv = (spi_nand_flash_dhara_priv_data_t *)arg;
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    dhara_error_t err;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        // A sync or a full buffer may have flushed it since the timer expired
+        if (priv->write_buffer.count && (write_buffer_flush(priv) != ESP_OK || dhara_map_sync(&priv->dhara_map, &err))) {
+            ESP_LOGW(TAG, "Failed to flush the write-back buffer");
+        }
+        xSemaphoreGive(handle->mutex);
+    }
+}
+#endif
+
+static esp_err_t write_buffer_init(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+
+    wb->data = heap_caps_malloc(CONFIG_NAND_FLASH_WRITE_BACK_SECTORS * priv->parent_handle->chip.page_size,
+                                MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (wb->data == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+    if (xTaskCreate(write_buffer_flush_task, "nand_wb", WRITE_BUFFER_FLUSH_STACK_SIZE, priv,
+                    WRITE_BUFFER_FLUSH_TASK_PRIORITY, &wb->flush_task) != pdPASS) {
+        free(wb->data);
+        wb->data = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    wb->flush_timer = xTimerCreate("nand_wb", pdMS_TO_TICKS(CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS), pdFALSE,
+                                   priv, write_buffer_timer_cb);
+    if (wb->flush_timer == NULL) {
+        vTaskDelete(wb->flush_task);
+        wb->flush_task = NULL;
+        free(wb->data);
+        wb->data = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+    write_buffer_clear(priv);
+    return ESP_OK;
+}
+
+// Stops the timed flush, the buffer is then only written when it is full or on sync
+static void write_buffer_stop_flush(spi_nand_flash_dhara_priv_data_t *priv)
+{
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+    if (priv->write_buffer.flush_timer) {
+        xTimerDelete(priv->write_buffer.flush_timer, portMAX_DELAY);
+        priv->write_buffer.flush_timer = NULL;
+    }
+    if (priv->write_buffer.flush_task) {
+        // Same as the GC task, the flush task only touches the flash with the mutex held
+        xSemaphoreTake(priv->parent_handle->mutex, portMAX_DELAY);
+        vTaskDelete(priv->write_buffer.flush_task);
+        priv->write_buffer.flush_task = NULL;
+        xSemaphoreGive(priv->parent_handle->mutex);
+    }
+#endif
+}
+
+static void write_buffer_deinit(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    write_buffer_stop_flush(priv);
+    free(priv->write_buffer.data);
+    priv->write_buffer.data = NULL;
+}
+
+static esp_err_t write_buffer_put(spi_nand_flash_dhara_priv_data_t *priv, const uint8_t *buffer, uint32_t sector)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    uint32_t page_size = priv->parent_handle->chip.page_size;
+
+    // A rewrite of a buffered sector only replaces the data, it costs no page program
+    uint8_t *slot = write_buffer_find(priv, sector);
+    if (slot == NULL) {
+        if (wb->count == CONFIG_NAND_FLASH_WRITE_BACK_SECTORS) {
+            ESP_RETURN_ON_ERROR(write_buffer_flush(priv), TAG, "Failed to flush the write-back buffer");
+        }
+        for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS; i++) {
+            if (wb->sectors[i] == INVALID_BUFFERED_SECTOR) {
+                wb->sectors[i] = sector;
+                slot = wb->data + i * page_size;
+                break;
+            }
+        }
+#if CONFIG_NAND_FLASH_WRITE_BACK_TIMEOUT_MS > 0
+        if (wb->count == 0 && wb->flush_timer) {
+            xTimerReset(wb->flush_timer, 0);
+        }
+#endif
+        wb->count++;
+    }
+    memcpy(slot, buffer, page_size);
+    return ESP_OK;
+}
+
+// Replaces the data read from flash by the newer buffered data
+static void write_buffer_overlay(spi_nand_flash_dhara_priv_data_t *priv, uint8_t *buffer, uint32_t start_sector, uint32_t sector_count)
+{
+    write_buffer_t *wb = &priv->write_buffer;
+    uint32_t page_size = priv->parent_handle->chip.page_size;
+
+    for (int i = 0; i < CONFIG_NAND_FLASH_WRITE_BACK_SECTORS && wb->count; i++) {
+        if (wb->sectors[i] != INVALID_BUFFERED_SECTOR && wb->sectors[i] >= start_sector &&
+                wb->sectors[i] - start_sector < sector_count) {
+            memcpy(buffer + (wb->sectors[i] - start_sector) * page_size, wb->data + i * page_size, page_size);
+        }
+    }
+}
+#endif //CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+static uint32_t fast_mount_record_crc(const fast_mount_record_t *record, const uint8_t *bitmap, size_t bitmap_size)
+{
+    fast_mount_record_t tmp = *record;
+    tmp.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&tmp, sizeof(tmp));
+    return esp_rom_crc32_le(crc, bitmap, bitmap_size);
+}
+
+// Must be called before anything which modifies the flash, so a stale record is never used after a power loss
+static esp_err_t fast_mount_disarm(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    if (!priv->fast_mount.armed) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_ERROR(nand_erase_block(priv->parent_handle, priv->fast_mount.block), TAG,
+                        "Failed to erase the fast mount record");
+    priv->fast_mount.armed = false;
+    return ESP_OK;
+}
+
+// Restores the dhara journal from the record written by the last clean deinit. Returns false if there is no valid
+// record, in which case the caller falls back to dhara_map_resume().
+static bool fast_mount_load(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    fast_mount_t *fm = &priv->fast_mount;
+    size_t bitmap_size = (handle->chip.num_blocks + 7) / 8;
+    uint32_t page = fm->block << handle->chip.log2_ppb;
+    bool is_bad = true;
+    bool is_free = true;
+
+    fm->usable = sizeof(fast_mount_record_t) + bitmap_size <= handle->chip.page_size &&
+                 nand_is_bad(handle, fm->block, &is_bad) == ESP_OK && !is_bad;
+    if (!fm->usable) {
+        ESP_LOGW(TAG, "Fast mount block %"PRIu32" can not be used", fm->block);
+        return false;
+    }
+    if (nand_is_free(handle, page, &is_free) != ESP_OK || is_free) {
+        return false;
+    }
+    // The read buffer is not in use yet at this point
+    if (nand_read(handle, page, 0, handle->chip.page_size, handle->read_buffer) != ESP_OK) {
+        return false;
+    }
+
+    fast_mount_record_t record;
+    const uint8_t *bitmap = handle->read_buffer + sizeof(record);
+    memcpy(&record, handle->read_buffer, sizeof(record));
+    if (record.magic != FAST_MOUNT_MAGIC || record.version != FAST_MOUNT_VERSION ||
+            record.crc != fast_mount_record_crc(&record, bitmap, bitmap_size) ||
+            record.num_blocks != handle->chip.num_blocks || record.log2_ppb != handle->chip.log2_ppb ||
+            record.log2_page_size != handle->chip.log2_page_size || record.gc_factor != handle->config.gc_factor ||
+            record.log2_ppc != priv->dhara_map.journal.log2_ppc) {
+        ESP_LOGD(TAG, "Fast mount record is not valid");
+        return false;
+    }
+
+    // Seed the bad block table, so no block has to be checked on flash
+    for (uint32_t b = 0; b < handle->chip.num_blocks; b++) {
+        nand_bbt_set(handle, b, bitmap[b / 8] & BIT(b % 8));
+    }
+
+    struct dhara_journal *j = &priv->dhara_map.journal;
+    j->head = record.head;
+    j->tail = record.tail;
+    j->tail_sync = record.tail_sync;
+    j->root = record.root;
+    j->bb_current = record.bb_current;
+    j->bb_last = record.bb_last;
+    j->epoch = record.epoch;
+    j->flags = record.flags;
+    // dhara_map_resume() takes the sector count from the cookie of the last checkpoint
+    dhara_w32(dhara_journal_cookie(j), record.count);
+    priv->dhara_map.count = record.count;
+
+    fm->armed = true;
+    return true;
+}
+
+static esp_err_t fast_mount_save(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    fast_mount_t *fm = &priv->fast_mount;
+    struct dhara_journal *j = &priv->dhara_map.journal;
+    size_t bitmap_size = (handle->chip.num_blocks + 7) / 8;
+    uint32_t page = fm->block << handle->chip.log2_ppb;
+    bool is_free = false;
+
+    if (!fm->usable || fm->armed) {
+        // Nothing was modified since the record was loaded, it is still valid
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(dhara_journal_is_clean(j), ESP_ERR_INVALID_STATE, TAG, "Journal is not synchronized");
+
+    uint8_t *bitmap = handle->read_buffer + sizeof(fast_mount_record_t);
+    memset(handle->read_buffer, 0xFF, handle->chip.page_size);
+    memset(bitmap, 0, bitmap_size);
+    for (uint32_t b = 0; b < handle->chip.num_blocks; b++) {
+        bool is_bad = false;
+        // Answered from the bad block table for the blocks checked since init
+        ESP_RETURN_ON_ERROR(nand_is_bad(handle, b, &is_bad), TAG, "");
+        if (is_bad) {
+            bitmap[b / 8] |= BIT(b % 8);
+        }
+    }
+
+    fast_mount_record_t record = {
+        .magic = FAST_MOUNT_MAGIC,
+        .version = FAST_MOUNT_VERSION,
+        .num_blocks = handle->chip.num_blocks,
+        .log2_ppb = handle->chip.log2_ppb,
+        .log2_page_size = handle->chip.log2_page_size,
+        .gc_factor = handle->config.gc_factor,
+        .log2_ppc = j->log2_ppc,
+        .head = j->head,
+        .tail = j->tail,
+        .tail_sync = j->tail_sync,
+        .root = j->root,
+        .bb_current = j->bb_current,
+        .bb_last = j->bb_last,
+        .epoch = j->epoch,
+        .flags = j->flags,
+        .count = priv->dhara_map.count,
+    };
+    record.crc = fast_mount_record_crc(&record, bitmap, bitmap_size);
+    memcpy(handle->read_buffer, &record, sizeof(record));
+
+    // The block was erased when the previous record was disarmed, unless that record was never valid
+    ESP_RETURN_ON_ERROR(nand_is_free(handle, page, &is_free), TAG, "");
+    if (!is_free) {
+        ESP_RETURN_ON_ERROR(nand_erase_block(handle, fm->block), TAG, "");
+    }
+    ESP_RETURN_ON_ERROR(nand_prog(handle, page, handle->read_buffer), TAG, "Failed to write the fast mount record");
+    fm->armed = true;
+    return ESP_OK;
+}
+#endif //CONFIG_NAND_FLASH_FAST_MOUNT
+
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+static inline void background_gc_touch(spi_nand_flash_dhara_priv_data_t *priv, bool modified)
+{
+    priv->background_gc.last_io = xTaskGetTickCount();
+    if (modified) {
+        priv->background_gc.pending = true;
+    }
+}
+
+// dhara collects garbage inline once the journal reaches the map capacity, background GC keeps the journal the
+// reserve below that point. It is pointless once the live sectors alone use up the reserve.
+static bool background_gc_needed(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    struct dhara_map *map = &priv->dhara_map;
+    dhara_page_t reserve = CONFIG_NAND_FLASH_BACKGROUND_GC_RESERVE_BLOCKS << priv->parent_handle->chip.log2_ppb;
+    dhara_sector_t capacity = dhara_map_capacity(map);
+
+    return dhara_map_size(map) + reserve < capacity && dhara_journal_size(&map->journal) + reserve >= capacity;
+}
+
+static void background_gc_task(void *arg)
+{
+    spi_nand_flash_dhara_priv_data_t *priv = (spi_nand_flash_dhara_priv_data_t *)arg;
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_gc_t *gc = &priv->background_gc;
+    const TickType_t idle_ticks = pdMS_TO_TICKS(CONFIG_NAND_FLASH_BACKGROUND_GC_IDLE_MS);
+    dhara_error_t err;
+
+    while (1) {
+        vTaskDelay(idle_ticks ? idle_ticks : 1);
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        if (!gc->pending || xTaskGetTickCount() - gc->last_io < idle_ticks) {
+            xSemaphoreGive(handle->mutex);
+            continue;
+        }
+
+        // Reclaim at most one block per pass, giving the mutex back after every page, so foreground I/O waits
+        // for a single GC step at most
+        dhara_page_t size_before = dhara_journal_size(&priv->dhara_map.journal);
+        uint32_t steps = 0;
+        bool interrupted = false;
+        while (background_gc_needed(priv) && steps < (1U << handle->chip.log2_ppb)) {
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+            // Relocations write to the flash, the record of the last deinit must not survive them
+            if (fast_mount_disarm(priv) != ESP_OK) {
+                break;
+            }
+#endif
+            if (dhara_map_gc(&priv->dhara_map, &err)) {
+                ESP_LOGW(TAG, "Background GC failed: %d", err);
+                break;
+            }
+            steps++;
+#if CONFIG_NAND_FLASH_IO_STATS
+            handle->io_stats.background_gc_steps++;
+#endif
+            xSemaphoreGive(handle->mutex);
+            taskYIELD();
+            xSemaphoreTake(handle->mutex, portMAX_DELAY);
+            if (xTaskGetTickCount() - gc->last_io < idle_ticks) {
+                interrupted = true;
+                break;
+            }
+        }
+        // Stop until the next write if the reserve was reached or a full pass found no garbage, so an idle device
+        // is never worn by GC
+        if (!interrupted && (!background_gc_needed(priv) || dhara_journal_size(&priv->dhara_map.journal) >= size_before)) {
+            gc->pending = false;
+        }
+        xSemaphoreGive(handle->mutex);
+    }
+}
+#endif //CONFIG_NAND_FLASH_BACKGROUND_GC
+
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+// Minimum number of bits corrected in the page whose ECC status was just read, as nand_need_data_refresh() ranks it
+static uint8_t scrub_page_level(spi_nand_flash_device_t *handle)
+{
+    switch (handle->chip.ecc_data.ecc_corrected_bits_status) {
+    case STAT_ECC_1_TO_3_BITS_CORRECTED:
+        return 1;
+    case STAT_ECC_4_TO_6_BITS_CORRECTED:
+        return 4;
+    case STAT_ECC_7_8_BITS_CORRECTED:
+        return 7;
+    case STAT_ECC_NOT_CORRECTED:
+        return SCRUB_LEVEL_NOT_CORRECTED;
+    default:
+        return 0;
+    }
+}
+
+// Rewrite the live sectors of the block to the head of the journal, as the read path does for a single sector. The
+// block itself is reclaimed by garbage collection once the journal tail reaches it.
+static esp_err_t scrub_relocate_block(spi_nand_flash_dhara_priv_data_t *priv, uint32_t block)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_scrub_t *scrub = &priv->background_scrub;
+    struct dhara_map *map = &priv->dhara_map;
+    uint8_t meta[DHARA_META_SIZE];
+    uint32_t relocated = 0;
+    dhara_error_t err;
+
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    // The relocation rewrites sectors, the record of the last deinit must not survive it
+    ESP_RETURN_ON_ERROR(fast_mount_disarm(priv), TAG, "");
+#endif
+    for (uint32_t i = 0; i < (1U << handle->chip.log2_ppb); i++) {
+        dhara_page_t page = (block << handle->chip.log2_ppb) + i;
+        dhara_page_t found;
+
+        // Only the pages which still hold the current copy of their sector are moved, this also skips the free
+        // pages, the checkpoint pages and the stale copies
+        if (dhara_journal_read_meta(&map->journal, page, meta, &err)) {
+            continue;
+        }
+        dhara_sector_t sector = dhara_r32(meta);
+        if (dhara_map_find(map, sector, &found, &err) || found != page) {
+            continue;
+        }
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+        // Newer data is waiting in the write-back buffer, the stale copy will be replaced anyway
+        if (write_buffer_find(priv, sector)) {
+            continue;
+        }
+#endif
+        if (dhara_map_read(map, sector, scrub->buffer, &err)) {
+            ESP_LOGW(TAG, "Scrub: failed to read sector %"PRIu32" in block %"PRIu32": %d", sector, block, err);
+            continue;
+        }
+        if (dhara_map_write(map, sector, scrub->buffer, &err)) {
+            return ESP_ERR_FLASH_BASE + err;
+        }
+        relocated++;
+    }
+    // A block found again before garbage collection erased it only holds stale copies
+    if (relocated) {
+        scrub->stats.blocks_relocated++;
+        scrub->stats.sectors_relocated += relocated;
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+        // The journal grew by the relocated sectors
+        priv->background_gc.pending = true;
+#endif
+    }
+    return ESP_OK;
+}
+
+// Check the ECC status of one page, and relocate its block after its last page if one of its pages needs a refresh
+static esp_err_t scrub_step(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_scrub_t *scrub = &priv->background_scrub;
+    const uint32_t ppb_mask = (1U << handle->chip.log2_ppb) - 1;
+    uint32_t page = scrub->next_page;
+    uint32_t block = page >> handle->chip.log2_ppb;
+    bool is_bad = false;
+    esp_err_t ret = ESP_OK;
+
+    if ((page & ppb_mask) == 0) {
+        scrub->block_levels[block] = 0;
+        ESP_RETURN_ON_ERROR(nand_is_bad(handle, block, &is_bad), TAG, "");
+    }
+    if (is_bad) {
+        // Skip the whole block
+        page |= ppb_mask;
+    } else {
+        ESP_RETURN_ON_ERROR(nand_get_ecc_status(handle, page), TAG, "");
+        scrub->stats.pages_checked++;
+        uint8_t level = scrub_page_level(handle);
+        if (level) {
+            scrub->stats.ecc_corrected++;
+            if (level == SCRUB_LEVEL_NOT_CORRECTED) {
+                scrub->stats.ecc_not_corrected++;
+            } else if (nand_need_data_refresh(handle)) {
+                scrub->stats.ecc_exceeding_threshold++;
+            }
+        }
+        if (level > scrub->block_levels[block]) {
+            scrub->block_levels[block] = level;
+        }
+        // Blocks are relocated as a whole, their other pages have seen the same wear and retention time
+        if ((page & ppb_mask) == ppb_mask && scrub->block_levels[block] != SCRUB_LEVEL_NOT_CORRECTED &&
+                scrub->block_levels[block] >= handle->chip.ecc_data.ecc_data_refresh_threshold) {
+            ESP_LOGD(TAG, "Scrub: relocating block %"PRIu32", %u bits corrected", block, scrub->block_levels[block]);
+            ret = scrub_relocate_block(priv, block);
+        }
+    }
+
+    if (++page >= (priv->dhara_nand.num_blocks << handle->chip.log2_ppb)) {
+        page = 0;
+        scrub->stats.passes++;
+        scrub->last_pass = scrub->stats;
+        scrub->stats.pages_checked = 0;
+        scrub->stats.ecc_corrected = 0;
+        scrub->stats.ecc_exceeding_threshold = 0;
+        scrub->stats.ecc_not_corrected = 0;
+        scrub->pass_end = xTaskGetTickCount();
+    }
+    scrub->next_page = page;
+    return ret;
+}
+
+static void background_scrub_task(void *arg)
+{
+    spi_nand_flash_dhara_priv_data_t *priv = (spi_nand_flash_dhara_priv_data_t *)arg;
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_scrub_t *scrub = &priv->background_scrub;
+    const TickType_t idle_ticks = pdMS_TO_TICKS(CONFIG_NAND_FLASH_BACKGROUND_SCRUB_IDLE_MS);
+    const TickType_t period_ticks = pdMS_TO_TICKS(CONFIG_NAND_FLASH_BACKGROUND_SCRUB_PERIOD_S * 1000ULL);
+
+    while (1) {
+        vTaskDelay(idle_ticks ? idle_ticks : 1);
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        // Passes start once per period, reading the pages more often only adds read disturb
+        bool waiting = scrub->next_page == 0 && scrub->stats.passes > 0 &&
+                       xTaskGetTickCount() - scrub->pass_end < period_ticks;
+        if (waiting || xTaskGetTickCount() - scrub->last_io < idle_ticks) {
+            xSemaphoreGive(handle->mutex);
+            continue;
+        }
+
+        // Check at most one block per wake up, giving the mutex back after every page, so foreground I/O waits
+        // for a single page read, or a block relocation, at most
+        for (uint32_t steps = 0; steps < (1U << handle->chip.log2_ppb); steps++) {
+            if (scrub_step(priv) != ESP_OK) {
+                ESP_LOGW(TAG, "Background scrub failed at page %"PRIu32, scrub->next_page);
+                scrub->next_page = (scrub->next_page + 1) % (priv->dhara_nand.num_blocks << handle->chip.log2_ppb);
+                break;
+            }
+            if (scrub->next_page == 0) {
+                break;
+            }
+            xSemaphoreGive(handle->mutex);
+            taskYIELD();
+            xSemaphoreTake(handle->mutex, portMAX_DELAY);
+            if (xTaskGetTickCount() - scrub->last_io < idle_ticks) {
+                break;
+            }
+        }
+        xSemaphoreGive(handle->mutex);
+    }
+}
+
+static void background_scrub_init(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_scrub_t *scrub = &priv->background_scrub;
+
+    scrub->block_levels = calloc(handle->chip.num_blocks, 1);
+    scrub->buffer = heap_caps_malloc(handle->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (scrub->block_levels == NULL || scrub->buffer == NULL ||
+            xTaskCreate(background_scrub_task, "nand_scrub", BACKGROUND_SCRUB_STACK_SIZE, priv,
+                        CONFIG_NAND_FLASH_BACKGROUND_SCRUB_TASK_PRIORITY, &scrub->task) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to start the background scrub task, data is refreshed on read only");
+        free(scrub->block_levels);
+        free(scrub->buffer);
+        scrub->block_levels = NULL;
+        scrub->buffer = NULL;
+        scrub->task = NULL;
+    }
+}
+
+static void background_scrub_stop(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+    background_scrub_t *scrub = &priv->background_scrub;
+
+    if (scrub->task) {
+        // Same as the GC task, the scrub task only touches the flash with the mutex held
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        vTaskDelete(scrub->task);
+        scrub->task = NULL;
+        xSemaphoreGive(handle->mutex);
+    }
+}
+
+static void background_scrub_deinit(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    background_scrub_t *scrub = &priv->background_scrub;
+
+    background_scrub_stop(priv);
+    free(scrub->block_levels);
+    free(scrub->buffer);
+    scrub->block_levels = NULL;
+    scrub->buffer = NULL;
+}
+#endif //CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+
+// Called by every foreground operation, the background tasks only run once the flash has been idle for a while
+static inline void foreground_io(spi_nand_flash_dhara_priv_data_t *priv, bool modified)
+{
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+    background_gc_touch(priv, modified);
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    priv->background_scrub.last_io = xTaskGetTickCount();
+#endif
+}
+
+// dhara_map_init(), with the checkpoint interval of the configuration instead of the largest one dhara allows
+static void dhara_map_setup(spi_nand_flash_dhara_priv_data_t *priv)
+{
+    spi_nand_flash_device_t *handle = priv->parent_handle;
+
+    dhara_map_init(&priv->dhara_map, &priv->dhara_nand, handle->work_buffer, handle->config.gc_factor);
+    // dhara picks the most pages whose metadata still fits into the checkpoint page, fewer are always possible
+    if (handle->config.checkpoint_pages) {
+        uint8_t log2_ppc = __builtin_ctz(handle->config.checkpoint_pages);
+        if (log2_ppc < priv->dhara_map.journal.log2_ppc) {
+            priv->dhara_map.journal.log2_ppc = log2_ppc;
+        }
+    }
+}
+
 static esp_err_t dhara_init(spi_nand_flash_device_t *handle)
 {
+#if CONFIG_NAND_FLASH_LOG_PARTITION
+    ESP_RETURN_ON_FALSE(handle->chip.num_blocks > CONFIG_NAND_FLASH_LOG_PARTITION_BLOCKS + 2, ESP_ERR_INVALID_SIZE, TAG,
+                        "log partition larger than the chip");
+#endif
     // create a holder structure for dhara context
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = calloc(1, sizeof(spi_nand_flash_dhara_priv_data_t));
     // save the holder inside the device structure
@@ -34,30 +896,106 @@ static esp_err_t dhara_init(spi_nand_flash_device_t *handle)
     // store the pointer back to device structure in the holder structure
     dhara_priv_data->parent_handle = handle;
 
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    if (page_cache_init(dhara_priv_data) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to allocate page cache, continuing without it");
+    }
+#endif
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    // Without the buffer, writes go directly to dhara
+    if (write_buffer_init(dhara_priv_data) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to allocate write-back buffer, continuing without it");
+    }
+#endif
+
     dhara_priv_data->dhara_nand.log2_page_size = handle->chip.log2_page_size;
     dhara_priv_data->dhara_nand.log2_ppb = handle->chip.log2_ppb;
     dhara_priv_data->dhara_nand.num_blocks = handle->chip.num_blocks;
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    // The last block holds the fast mount record
+    dhara_priv_data->dhara_nand.num_blocks--;
+    dhara_priv_data->fast_mount.block = handle->chip.num_blocks - 1;
+#endif
+#if CONFIG_NAND_FLASH_LOG_PARTITION
+    // The blocks just before hold the raw log partition, see nand_log_open()
+    dhara_priv_data->dhara_nand.num_blocks -= CONFIG_NAND_FLASH_LOG_PARTITION_BLOCKS;
+#endif
 
-    dhara_map_init(&dhara_priv_data->dhara_map, &dhara_priv_data->dhara_nand, handle->work_buffer, handle->config.gc_factor);
-    dhara_error_t ignored;
-    dhara_map_resume(&dhara_priv_data->dhara_map, &ignored);
+    dhara_map_setup(dhara_priv_data);
+    if (handle->config.checkpoint_pages > 1U << dhara_priv_data->dhara_map.journal.log2_ppc) {
+        ESP_LOGW(TAG, "%u pages per checkpoint don't fit the page size, using %u", handle->config.checkpoint_pages,
+                 1U << dhara_priv_data->dhara_map.journal.log2_ppc);
+    }
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    if (fast_mount_load(dhara_priv_data)) {
+        ESP_LOGD(TAG, "Restored the journal from the fast mount record");
+    } else
+#endif
+    {
+        dhara_error_t ignored;
+        dhara_map_resume(&dhara_priv_data->dhara_map, &ignored);
+    }
 
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+    // Check the journal once in case the previous session ended with little free space
+    dhara_priv_data->background_gc.pending = true;
+    if (xTaskCreate(background_gc_task, "nand_gc", BACKGROUND_GC_STACK_SIZE, dhara_priv_data,
+                    CONFIG_NAND_FLASH_BACKGROUND_GC_TASK_PRIORITY, &dhara_priv_data->background_gc.task) != pdPASS) {
+        ESP_LOGW(TAG, "Failed to create the background GC task, GC is done on write only");
+        dhara_priv_data->background_gc.task = NULL;
+    }
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    background_scrub_init(dhara_priv_data);
+#endif
     return ESP_OK;
 }
 
 static esp_err_t dhara_deinit(spi_nand_flash_device_t *handle)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_clear(dhara_priv_data);
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    ESP_RETURN_ON_ERROR(fast_mount_disarm(dhara_priv_data), TAG, "");
+#endif
     // clear dhara map
-    dhara_map_init(&dhara_priv_data->dhara_map, &dhara_priv_data->dhara_nand, handle->work_buffer, handle->config.gc_factor);
+    dhara_map_setup(dhara_priv_data);
     dhara_map_clear(&dhara_priv_data->dhara_map);
     return ESP_OK;
 }
 
+// The SPI master driver receives straight into word aligned buffers in DMA capable memory, other buffers are
+// bounced through the driver. Such buffers are read into read_buffer instead, which is allocated once.
+static inline bool can_read_directly(const uint8_t *buffer)
+{
+#ifdef CONFIG_IDF_TARGET_LINUX
+    return true;
+#else
+    return esp_ptr_dma_capable(buffer) && ((uintptr_t)buffer & 3) == 0;
+#endif
+}
+
 static esp_err_t dhara_read(spi_nand_flash_device_t *handle, uint8_t *buffer, dhara_sector_t sector_id)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
     dhara_error_t err;
+    foreground_io(dhara_priv_data, false);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    const uint8_t *buffered = write_buffer_find(dhara_priv_data, sector_id);
+    if (buffered) {
+        memcpy(buffer, buffered, handle->chip.page_size);
+        handle->chip.ecc_data.ecc_corrected_bits_status = STAT_ECC_OK;
+        return ESP_OK;
+    }
+#endif
+    if (can_read_directly(buffer)) {
+        if (dhara_map_read(&dhara_priv_data->dhara_map, sector_id, buffer, &err)) {
+            return ESP_ERR_FLASH_BASE + err;
+        }
+        return ESP_OK;
+    }
     if (dhara_map_read(&dhara_priv_data->dhara_map, sector_id, handle->read_buffer, &err)) {
         return ESP_ERR_FLASH_BASE + err;
     }
@@ -65,20 +1003,153 @@ static esp_err_t dhara_read(spi_nand_flash_device_t *handle, uint8_t *buffer, dh
     return ESP_OK;
 }
 
+static esp_err_t dhara_read_partial(spi_nand_flash_device_t *handle, uint8_t *buffer, dhara_sector_t sector_id,
+                                    uint32_t offset, uint32_t length)
+{
+    spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
+    dhara_error_t err = DHARA_E_NONE;
+    dhara_page_t page;
+    foreground_io(dhara_priv_data, false);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    const uint8_t *buffered = write_buffer_find(dhara_priv_data, sector_id);
+    if (buffered) {
+        memcpy(buffer, buffered + offset, length);
+        handle->chip.ecc_data.ecc_corrected_bits_status = STAT_ECC_OK;
+        return ESP_OK;
+    }
+#endif
+    if (dhara_map_find(&dhara_priv_data->dhara_map, sector_id, &page, &err)) {
+        if (err == DHARA_E_NOT_FOUND) {
+            // Same as dhara_map_read(), sectors which were never written read back erased
+            memset(buffer, 0xFF, length);
+            return ESP_OK;
+        }
+        return ESP_ERR_FLASH_BASE + err;
+    }
+    // Only the requested bytes are clocked out of the chip cache
+    if (dhara_nand_read(&dhara_priv_data->dhara_nand, page, offset, length, buffer, &err)) {
+        return ESP_ERR_FLASH_BASE + err;
+    }
+    return ESP_OK;
+}
+
 static esp_err_t dhara_write(spi_nand_flash_device_t *handle, const uint8_t *buffer, dhara_sector_t sector_id)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
     dhara_error_t err;
+    foreground_io(dhara_priv_data, true);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    if (dhara_priv_data->write_buffer.data) {
+        return write_buffer_put(dhara_priv_data, buffer, sector_id);
+    }
+#endif
     if (dhara_map_write(&dhara_priv_data->dhara_map, sector_id, buffer, &err)) {
         return ESP_ERR_FLASH_BASE + err;
     }
     return ESP_OK;
 }
 
+static esp_err_t dhara_read_sectors(spi_nand_flash_device_t *handle, uint8_t *buffer, dhara_sector_t start_sector, uint32_t sector_count)
+{
+    spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
+    uint32_t page_size = handle->chip.page_size;
+    uint32_t i = 0;
+    dhara_error_t err;
+    foreground_io(dhara_priv_data, false);
+
+    while (i < sector_count) {
+        dhara_page_t first_page;
+        if (dhara_map_find(&dhara_priv_data->dhara_map, start_sector + i, &first_page, &err)) {
+            if (err != DHARA_E_NOT_FOUND) {
+                return ESP_ERR_FLASH_BASE + err;
+            }
+            // Unmapped sectors read as erased, same as dhara_map_read()
+            memset(buffer + i * page_size, 0xFF, page_size);
+            i++;
+            continue;
+        }
+
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+        const uint8_t *cached = page_cache_lookup(dhara_priv_data, first_page);
+        if (cached) {
+            memcpy(buffer + i * page_size, cached, page_size);
+            i++;
+            continue;
+        }
+#endif
+
+        // Group sectors which are stored on consecutive pages of the same block, so they can be streamed in one go
+        uint32_t run = 1;
+        while (i + run < sector_count) {
+            dhara_page_t page;
+            if (dhara_map_find(&dhara_priv_data->dhara_map, start_sector + i + run, &page, &err) ||
+                    page != first_page + run || (page >> handle->chip.log2_ppb) != (first_page >> handle->chip.log2_ppb)) {
+                break;
+            }
+            run++;
+        }
+
+        if (nand_read_pages(handle, first_page, run, buffer + i * page_size)) {
+            if (handle->chip.ecc_data.ecc_corrected_bits_status == STAT_ECC_NOT_CORRECTED) {
+                return ESP_ERR_FLASH_BASE + DHARA_E_ECC;
+            }
+            return ESP_FAIL;
+        }
+
+        // Same soft ECC error handling as spi_nand_flash_read_sector(), done while the mutex is held
+        if (handle->chip.ecc_data.ecc_corrected_bits_status && nand_need_data_refresh(handle)) {
+            for (uint32_t j = 0; j < run; j++) {
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+                // Newer data is waiting in the write-back buffer, the stale copy will be replaced anyway
+                if (write_buffer_find(dhara_priv_data, start_sector + i + j)) {
+                    continue;
+                }
+#endif
+                esp_err_t ret = dhara_write(handle, buffer + (i + j) * page_size, start_sector + i + j);
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+            }
+        }
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+        // Keep long sequential reads from flushing the cache, they are unlikely to be read again soon
+        if (run == 1 && handle->chip.ecc_data.ecc_corrected_bits_status == STAT_ECC_OK) {
+            page_cache_insert(dhara_priv_data, first_page, buffer + i * page_size);
+        }
+#endif
+        i += run;
+    }
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_overlay(dhara_priv_data, buffer, start_sector, sector_count);
+#endif
+    return ESP_OK;
+}
+
+static esp_err_t dhara_write_sectors(spi_nand_flash_device_t *handle, const uint8_t *buffer, dhara_sector_t start_sector, uint32_t sector_count)
+{
+    esp_err_t ret = ESP_OK;
+
+    for (uint32_t i = 0; i < sector_count; i++) {
+        ret = dhara_write(handle, buffer + i * handle->chip.page_size, start_sector + i);
+        if (ret != ESP_OK) {
+            break;
+        }
+    }
+    return ret;
+}
+
 static esp_err_t dhara_copy_sector(spi_nand_flash_device_t *handle, dhara_sector_t src_sec, dhara_sector_t dst_sec)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
     dhara_error_t err;
+    foreground_io(dhara_priv_data, true);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    // dhara copies the data stored in flash, so the buffered source must be written first
+    if (write_buffer_find(dhara_priv_data, src_sec)) {
+        ESP_RETURN_ON_ERROR(write_buffer_flush(dhara_priv_data), TAG, "Failed to flush the write-back buffer");
+    }
+    write_buffer_drop(dhara_priv_data, dst_sec);
+#endif
     if (dhara_map_copy_sector(&dhara_priv_data->dhara_map, src_sec, dst_sec, &err)) {
         return ESP_ERR_FLASH_BASE + err;
     }
@@ -89,16 +1160,41 @@ static esp_err_t dhara_trim(spi_nand_flash_device_t *handle, dhara_sector_t sect
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
     dhara_error_t err;
+    foreground_io(dhara_priv_data, true);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_drop(dhara_priv_data, sector_id);
+#endif
     if (dhara_map_trim(&dhara_priv_data->dhara_map, sector_id, &err)) {
         return ESP_ERR_FLASH_BASE + err;
     }
     return ESP_OK;
 }
 
+static esp_err_t dhara_trim_range(spi_nand_flash_device_t *handle, dhara_sector_t start_sector, uint32_t sector_count)
+{
+    spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
+    dhara_error_t err;
+    foreground_io(dhara_priv_data, true);
+
+    for (uint32_t i = 0; i < sector_count; i++) {
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+        write_buffer_drop(dhara_priv_data, start_sector + i);
+#endif
+        // dhara_map_trim() returns without writing to the journal if the sector is not mapped
+        if (dhara_map_trim(&dhara_priv_data->dhara_map, start_sector + i, &err)) {
+            return ESP_ERR_FLASH_BASE + err;
+        }
+    }
+    return ESP_OK;
+}
+
 static esp_err_t dhara_sync(spi_nand_flash_device_t *handle)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
     dhara_error_t err;
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    ESP_RETURN_ON_ERROR(write_buffer_flush(dhara_priv_data), TAG, "Failed to flush the write-back buffer");
+#endif
     if (dhara_map_sync(&dhara_priv_data->dhara_map, &err)) {
         return ESP_ERR_FLASH_BASE + err;
     }
@@ -114,11 +1210,27 @@ static esp_err_t dhara_get_capacity(spi_nand_flash_device_t *handle, dhara_secto
 
 static esp_err_t dhara_erase_chip(spi_nand_flash_device_t *handle)
 {
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    // The record block is erased together with the rest of the chip
+    ((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data)->fast_mount.armed = false;
+#endif
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_clear((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+#endif
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data, 0, UINT32_MAX);
+#endif
     return nand_erase_chip(handle);
 }
 
 static esp_err_t dhara_erase_block(spi_nand_flash_device_t *handle, uint32_t block)
 {
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    ESP_RETURN_ON_ERROR(fast_mount_disarm((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data), TAG, "");
+#endif
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate_block((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data, block);
+#endif
     return nand_erase_block(handle, block);
 }
 
@@ -127,10 +1239,14 @@ const spi_nand_ops dhara_nand_ops = {
     .init = &dhara_init,
     .deinit = &dhara_deinit,
     .read = &dhara_read,
+    .read_partial = &dhara_read_partial,
     .write = &dhara_write,
+    .read_sectors = &dhara_read_sectors,
+    .write_sectors = &dhara_write_sectors,
     .erase_chip = &dhara_erase_chip,
     .erase_block = &dhara_erase_block,
     .trim = &dhara_trim,
+    .trim_range = &dhara_trim_range,
     .sync = &dhara_sync,
     .copy_sector = &dhara_copy_sector,
     .get_capacity = &dhara_get_capacity,
@@ -145,13 +1261,97 @@ esp_err_t nand_register_dev(spi_nand_flash_device_t *handle)
     return ESP_OK;
 }
 
+void nand_stop_background_tasks(spi_nand_flash_device_t *handle)
+{
+    spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data;
+    if (dhara_priv_data == NULL) {
+        return;
+    }
+#if CONFIG_NAND_FLASH_BACKGROUND_GC
+    if (dhara_priv_data->background_gc.task) {
+        // The task only touches the flash with the mutex held, so it is safe to delete while the mutex is taken
+        xSemaphoreTake(handle->mutex, portMAX_DELAY);
+        vTaskDelete(dhara_priv_data->background_gc.task);
+        dhara_priv_data->background_gc.task = NULL;
+        xSemaphoreGive(handle->mutex);
+    }
+#endif
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    background_scrub_stop(dhara_priv_data);
+#endif
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    write_buffer_stop_flush(dhara_priv_data);
+#endif
+}
+
 esp_err_t nand_unregister_dev(spi_nand_flash_device_t *handle)
 {
+    nand_stop_background_tasks(handle);
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    if (handle->ops_priv_data) {
+        background_scrub_deinit((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+    }
+#endif
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    if (handle->ops_priv_data) {
+        page_cache_deinit((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+    }
+#endif
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0
+    if (handle->ops_priv_data) {
+        write_buffer_deinit((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+    }
+#endif
     free(handle->ops_priv_data);
     handle->ops = NULL;
     return ESP_OK;
 }
 
+esp_err_t nand_save_mount_state(spi_nand_flash_device_t *handle)
+{
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    return fast_mount_save((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+#else
+    return ESP_OK;
+#endif
+}
+
+esp_err_t nand_disarm_mount_state(spi_nand_flash_device_t *handle)
+{
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    return fast_mount_disarm((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data);
+#else
+    return ESP_OK;
+#endif
+}
+
+esp_err_t nand_scrub_get_stats(spi_nand_flash_device_t *handle, nand_scrub_stats_t *stats)
+{
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    background_scrub_t *scrub = &((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data)->background_scrub;
+    ESP_RETURN_ON_FALSE(scrub->task != NULL, ESP_ERR_INVALID_STATE, TAG, "Background scrub is not running");
+    *stats = scrub->last_pass;
+    stats->passes = scrub->stats.passes;
+    stats->blocks_relocated = scrub->stats.blocks_relocated;
+    stats->sectors_relocated = scrub->stats.sectors_relocated;
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_scrub_get_block_level(spi_nand_flash_device_t *handle, uint32_t block, uint8_t *min_bits_corrected)
+{
+#if CONFIG_NAND_FLASH_BACKGROUND_SCRUB
+    background_scrub_t *scrub = &((spi_nand_flash_dhara_priv_data_t *)handle->ops_priv_data)->background_scrub;
+    ESP_RETURN_ON_FALSE(scrub->task != NULL, ESP_ERR_INVALID_STATE, TAG, "Background scrub is not running");
+    *min_bits_corrected = scrub->block_levels[block];
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
 /*------------------------------------------------------------------------------------------------------*/
 
 
@@ -176,6 +1376,12 @@ void dhara_nand_mark_bad(const struct dhara_nand *n, dhara_block_t b)
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = __containerof(n, spi_nand_flash_dhara_priv_data_t, dhara_nand);
     spi_nand_flash_device_t *dev_handle = dhara_priv_data->parent_handle;
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate_block(dhara_priv_data, b);
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    fast_mount_disarm(dhara_priv_data);
+#endif
     nand_mark_bad(dev_handle, b);
     return;
 }
@@ -184,6 +1390,14 @@ int dhara_nand_erase(const struct dhara_nand *n, dhara_block_t b, dhara_error_t
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = __containerof(n, spi_nand_flash_dhara_priv_data_t, dhara_nand);
     spi_nand_flash_device_t *dev_handle = dhara_priv_data->parent_handle;
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate_block(dhara_priv_data, b);
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    if (fast_mount_disarm(dhara_priv_data) != ESP_OK) {
+        return -1;
+    }
+#endif
     esp_err_t ret = nand_erase_block(dev_handle, b);
     if (ret) {
         if (ret == ESP_ERR_NOT_FINISHED) {
@@ -198,6 +1412,14 @@ int dhara_nand_prog(const struct dhara_nand *n, dhara_page_t p, const uint8_t *d
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = __containerof(n, spi_nand_flash_dhara_priv_data_t, dhara_nand);
     spi_nand_flash_device_t *dev_handle = dhara_priv_data->parent_handle;
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate(dhara_priv_data, p, 1);
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    if (fast_mount_disarm(dhara_priv_data) != ESP_OK) {
+        return -1;
+    }
+#endif
     esp_err_t ret = nand_prog(dev_handle, p, data);
     if (ret) {
         if (ret == ESP_ERR_NOT_FINISHED) {
@@ -227,12 +1449,26 @@ int dhara_nand_read(const struct dhara_nand *n, dhara_page_t p, size_t offset, s
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = __containerof(n, spi_nand_flash_dhara_priv_data_t, dhara_nand);
     spi_nand_flash_device_t *dev_handle = dhara_priv_data->parent_handle;
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    const uint8_t *cached = page_cache_lookup(dhara_priv_data, p);
+    if (cached) {
+        memcpy(data, cached + offset, length);
+        dev_handle->chip.ecc_data.ecc_corrected_bits_status = STAT_ECC_OK;
+        return 0;
+    }
+#endif
     if (nand_read(dev_handle, p, offset, length, data)) {
         if (dev_handle->chip.ecc_data.ecc_corrected_bits_status == STAT_ECC_NOT_CORRECTED) {
             dhara_set_error(err, DHARA_E_ECC);
         }
         return -1;
     }
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    // Only complete pages are cached; dhara reads metadata with partial reads, keep those out of the cache
+    if (offset == 0 && length == dev_handle->chip.page_size) {
+        page_cache_insert(dhara_priv_data, p, data);
+    }
+#endif
     return 0;
 }
 
@@ -240,6 +1476,14 @@ int dhara_nand_copy(const struct dhara_nand *n, dhara_page_t src, dhara_page_t d
 {
     spi_nand_flash_dhara_priv_data_t *dhara_priv_data = __containerof(n, spi_nand_flash_dhara_priv_data_t, dhara_nand);
     spi_nand_flash_device_t *dev_handle = dhara_priv_data->parent_handle;
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    page_cache_invalidate(dhara_priv_data, dst, 1);
+#endif
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    if (fast_mount_disarm(dhara_priv_data) != ESP_OK) {
+        return -1;
+    }
+#endif
     esp_err_t ret = nand_copy(dev_handle, src, dst);
     if (ret) {
         if (dev_handle->chip.ecc_data.ecc_corrected_bits_status == STAT_ECC_NOT_CORRECTED) {
@@ -253,3 +1497,20 @@ int dhara_nand_copy(const struct dhara_nand *n, dhara_page_t src, dhara_page_t d
     return 0;
 }
 /*------------------------------------------------------------------------------------------------------*/
+
+esp_err_t nand_get_page_cache_stats(spi_nand_flash_device_t *flash, nand_page_cache_stats_t *stats)
+{
+#if CONFIG_NAND_FLASH_PAGE_CACHE_SIZE > 0
+    if (flash == NULL || stats == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    spi_nand_flash_dhara_priv_data_t *dhara_priv_data = (spi_nand_flash_dhara_priv_data_t *)flash->ops_priv_data;
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    stats->hits = dhara_priv_data->page_cache.hits;
+    stats->misses = dhara_priv_data->page_cache.misses;
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -18,6 +18,9 @@
 #include "nand_flash_chip.h"
 #include "esp_vfs_fat_nand.h"
 #endif //CONFIG_IDF_TARGET_LINUX
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+#include "esp_timer.h"
+#endif
 
 static const char *TAG = "nand_flash";
 
@@ -135,6 +138,9 @@ esp_err_t spi_nand_flash_init_device(spi_nand_flash_config_t *config, spi_nand_f
     ESP_RETURN_ON_FALSE(config->device_handle != NULL, ESP_ERR_INVALID_ARG, TAG, "Spi device pointer can not be NULL");
 #endif //CONFIG_IDF_TARGET_LINUX
 
+    ESP_RETURN_ON_FALSE((config->checkpoint_pages & (config->checkpoint_pages - 1)) == 0, ESP_ERR_INVALID_ARG, TAG,
+                        "checkpoint_pages must be a power of 2");
+
     if (!config->gc_factor) {
         config->gc_factor = 45;
     }
@@ -179,6 +185,12 @@ esp_err_t spi_nand_flash_init_device(spi_nand_flash_config_t *config, spi_nand_f
     (*handle)->temp_buffer = heap_caps_malloc((*handle)->chip.page_size + 1, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
     ESP_GOTO_ON_FALSE((*handle)->temp_buffer != NULL, ESP_ERR_NO_MEM, fail, TAG, "nomem");
 
+    // Both bitmaps of the bad block table share one allocation
+    size_t bbt_size = ((*handle)->chip.num_blocks + 7) / 8;
+    (*handle)->bbt.known = calloc(2, bbt_size);
+    ESP_GOTO_ON_FALSE((*handle)->bbt.known != NULL, ESP_ERR_NO_MEM, fail, TAG, "nomem");
+    (*handle)->bbt.bad = (*handle)->bbt.known + bbt_size;
+
     (*handle)->mutex = xSemaphoreCreateMutex();
     if (!(*handle)->mutex) {
         ret = ESP_ERR_NO_MEM;
@@ -192,7 +204,7 @@ esp_err_t spi_nand_flash_init_device(spi_nand_flash_config_t *config, spi_nand_f
         ret = ESP_FAIL;
         goto fail;
     }
-    (*handle)->ops->init(*handle);
+    ESP_GOTO_ON_ERROR((*handle)->ops->init(*handle), fail, TAG, "Failed to initialize the flash translation layer");
 
     return ret;
 
@@ -200,6 +212,7 @@ fail:
     free((*handle)->work_buffer);
     free((*handle)->read_buffer);
     free((*handle)->temp_buffer);
+    free((*handle)->bbt.known);
     if ((*handle)->mutex) {
         vSemaphoreDelete((*handle)->mutex);
     }
@@ -224,7 +237,26 @@ end:
     return ret;
 }
 
-static bool s_need_data_refresh(spi_nand_flash_device_t *handle)
+bool nand_bbt_get(spi_nand_flash_device_t *handle, uint32_t block, bool *is_bad)
+{
+    if (!(handle->bbt.known[block / 8] & BIT(block % 8))) {
+        return false;
+    }
+    *is_bad = handle->bbt.bad[block / 8] & BIT(block % 8);
+    return true;
+}
+
+void nand_bbt_set(spi_nand_flash_device_t *handle, uint32_t block, bool is_bad)
+{
+    handle->bbt.known[block / 8] |= BIT(block % 8);
+    if (is_bad) {
+        handle->bbt.bad[block / 8] |= BIT(block % 8);
+    } else {
+        handle->bbt.bad[block / 8] &= ~BIT(block % 8);
+    }
+}
+
+bool nand_need_data_refresh(spi_nand_flash_device_t *handle)
 {
     uint8_t min_bits_corrected = 0;
     bool ret = false;
@@ -248,11 +280,14 @@ esp_err_t spi_nand_flash_read_sector(spi_nand_flash_device_t *handle, uint8_t *b
     esp_err_t ret = ESP_OK;
 
     xSemaphoreTake(handle->mutex, portMAX_DELAY);
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.sectors_read++;
+#endif
     ret = handle->ops->read(handle, buffer, sector_id);
     // After a successful read operation, check the ECC corrected bit status; if the read fails, return an error
     if (ret == ESP_OK && handle->chip.ecc_data.ecc_corrected_bits_status) {
         // This indicates a soft ECC error, we rewrite the sector to recover if corrected bits are greater than refresh threshold
-        if (s_need_data_refresh(handle)) {
+        if (nand_need_data_refresh(handle)) {
             ret = handle->ops->write(handle, buffer, sector_id);
         }
     }
@@ -261,6 +296,39 @@ esp_err_t spi_nand_flash_read_sector(spi_nand_flash_device_t *handle, uint8_t *b
     return ret;
 }
 
+esp_err_t spi_nand_flash_read_partial(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id,
+                                      uint32_t offset, uint32_t length)
+{
+    esp_err_t ret = ESP_OK;
+
+    if (length == 0 || offset >= handle->chip.page_size || length > handle->chip.page_size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.sectors_read++;
+#endif
+    ret = handle->ops->read_partial(handle, buffer, sector_id, offset, length);
+    xSemaphoreGive(handle->mutex);
+
+    return ret;
+}
+
+esp_err_t spi_nand_flash_read_sectors(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t start_sector, uint32_t sector_count)
+{
+    esp_err_t ret = ESP_OK;
+
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.sectors_read += sector_count;
+#endif
+    ret = handle->ops->read_sectors(handle, buffer, start_sector, sector_count);
+    xSemaphoreGive(handle->mutex);
+
+    return ret;
+}
+
 esp_err_t spi_nand_flash_copy_sector(spi_nand_flash_device_t *handle, uint32_t src_sec, uint32_t dst_sec)
 {
     esp_err_t ret = ESP_OK;
@@ -272,12 +340,49 @@ esp_err_t spi_nand_flash_copy_sector(spi_nand_flash_device_t *handle, uint32_t s
     return ret;
 }
 
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+// Called with the mutex held, start_us is taken before the mutex so waiting for other operations is included
+static void update_write_latency(spi_nand_flash_device_t *handle, int64_t start_us)
+{
+    nand_latency_hist_add(&handle->write_latency, (uint32_t)(esp_timer_get_time() - start_us));
+}
+#endif //CONFIG_NAND_FLASH_LATENCY_STATS
+
 esp_err_t spi_nand_flash_write_sector(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t sector_id)
 {
     esp_err_t ret = ESP_OK;
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    int64_t start_us = esp_timer_get_time();
+#endif
 
     xSemaphoreTake(handle->mutex, portMAX_DELAY);
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.sectors_written++;
+#endif
     ret = handle->ops->write(handle, buffer, sector_id);
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    update_write_latency(handle, start_us);
+#endif
+    xSemaphoreGive(handle->mutex);
+
+    return ret;
+}
+
+esp_err_t spi_nand_flash_write_sectors(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t start_sector, uint32_t sector_count)
+{
+    esp_err_t ret = ESP_OK;
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    int64_t start_us = esp_timer_get_time();
+#endif
+
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.sectors_written += sector_count;
+#endif
+    ret = handle->ops->write_sectors(handle, buffer, start_sector, sector_count);
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    update_write_latency(handle, start_us);
+#endif
     xSemaphoreGive(handle->mutex);
 
     return ret;
@@ -294,6 +399,23 @@ esp_err_t spi_nand_flash_trim(spi_nand_flash_device_t *handle, uint32_t sector_i
     return ret;
 }
 
+esp_err_t spi_nand_flash_trim_range(spi_nand_flash_device_t *handle, uint32_t start_sector, uint32_t sector_count)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t capacity;
+
+    ESP_RETURN_ON_ERROR(handle->ops->get_capacity(handle, &capacity), TAG, "");
+    if (start_sector >= capacity || sector_count > capacity - start_sector) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    ret = handle->ops->trim_range(handle, start_sector, sector_count);
+    xSemaphoreGive(handle->mutex);
+
+    return ret;
+}
+
 esp_err_t spi_nand_flash_sync(spi_nand_flash_device_t *handle)
 {
     esp_err_t ret = ESP_OK;
@@ -331,6 +453,19 @@ esp_err_t spi_nand_flash_get_block_num(spi_nand_flash_device_t *handle, uint32_t
 esp_err_t spi_nand_flash_deinit_device(spi_nand_flash_device_t *handle)
 {
     esp_err_t ret = ESP_OK;
+    if (handle->ops == &nand_stripe_ops) {
+        return nand_stripe_deinit_device(handle);
+    }
+    // A GC or scrub step after the sync would make the saved mount state stale, or touch an unmapped emulator
+    nand_stop_background_tasks(handle);
+#if CONFIG_NAND_FLASH_WRITE_BACK_SECTORS > 0 || CONFIG_NAND_FLASH_FAST_MOUNT
+    // Flush the write-back buffer and leave the journal clean, so that the mount state can be persisted
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    if (handle->ops->sync(handle) != ESP_OK || nand_save_mount_state(handle) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to synchronize the device before deinit");
+    }
+    xSemaphoreGive(handle->mutex);
+#endif
 #ifdef CONFIG_IDF_TARGET_LINUX
     ret = nand_emul_deinit(handle);
 #endif
@@ -338,6 +473,7 @@ esp_err_t spi_nand_flash_deinit_device(spi_nand_flash_device_t *handle)
     free(handle->work_buffer);
     free(handle->read_buffer);
     free(handle->temp_buffer);
+    free(handle->bbt.known);
     vSemaphoreDelete(handle->mutex);
     free(handle);
     return ret;
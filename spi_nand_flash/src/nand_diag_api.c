@@ -70,6 +70,18 @@ esp_err_t nand_get_ecc_stats(spi_nand_flash_device_t *flash)
     uint32_t pages_per_block = block_size / sector_size;
     uint32_t num_pages = num_blocks * pages_per_block;
 
+    // The background scrubber already checked every page, incrementally
+    nand_scrub_stats_t scrub_stats;
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    esp_err_t scrub_ret = nand_scrub_get_stats(flash, &scrub_stats);
+    xSemaphoreGive(flash->mutex);
+    if (scrub_ret == ESP_OK && scrub_stats.passes > 0) {
+        ESP_LOGI(TAG, "\nTotal number of ECC errors: %"PRIu32"\nECC not corrected count: %"PRIu32"\nECC errors exceeding threshold (%d): %"PRIu32"\n(last background scrub pass)\n",
+                 scrub_stats.ecc_corrected, scrub_stats.ecc_not_corrected, flash->chip.ecc_data.ecc_data_refresh_threshold,
+                 scrub_stats.ecc_exceeding_threshold);
+        return ESP_OK;
+    }
+
     bool is_free = true;
     for (uint32_t page = 0; page < num_pages; page++) {
         ret = nand_wrap_is_free(flash, page, &is_free);
@@ -95,3 +107,124 @@ esp_err_t nand_get_ecc_stats(spi_nand_flash_device_t *flash)
              ecc_err_total_count, ecc_err_not_corrected_count, flash->chip.ecc_data.ecc_data_refresh_threshold, ecc_err_exceeding_threshold_count);
     return ret;
 }
+
+esp_err_t nand_get_scrub_stats(spi_nand_flash_device_t *flash, nand_scrub_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    esp_err_t ret = nand_scrub_get_stats(flash, stats);
+    xSemaphoreGive(flash->mutex);
+    return ret;
+}
+
+esp_err_t nand_get_block_ecc_level(spi_nand_flash_device_t *flash, uint32_t block, uint8_t *min_bits_corrected)
+{
+    ESP_RETURN_ON_FALSE(min_bits_corrected != NULL && block < flash->chip.num_blocks, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    esp_err_t ret = nand_scrub_get_block_level(flash, block, min_bits_corrected);
+    xSemaphoreGive(flash->mutex);
+    return ret;
+}
+
+esp_err_t nand_get_wait_stats(spi_nand_flash_device_t *flash, nand_wait_op_t op, nand_wait_stats_t *stats)
+{
+#if CONFIG_NAND_FLASH_WAIT_STATS
+    ESP_RETURN_ON_FALSE(op < NAND_WAIT_OP_MAX && stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    *stats = flash->wait_stats[op];
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_reset_wait_stats(spi_nand_flash_device_t *flash)
+{
+#if CONFIG_NAND_FLASH_WAIT_STATS
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    memset(flash->wait_stats, 0, sizeof(flash->wait_stats));
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_get_copy_stats(spi_nand_flash_device_t *flash, nand_copy_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    *stats = flash->copy_stats;
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+}
+
+esp_err_t nand_get_io_stats(spi_nand_flash_device_t *flash, nand_io_stats_t *stats)
+{
+#if CONFIG_NAND_FLASH_IO_STATS
+    ESP_RETURN_ON_FALSE(stats != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    *stats = flash->io_stats;
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_reset_io_stats(spi_nand_flash_device_t *flash)
+{
+#if CONFIG_NAND_FLASH_IO_STATS
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    memset(&flash->io_stats, 0, sizeof(flash->io_stats));
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_get_write_latency_hist(spi_nand_flash_device_t *flash, nand_latency_hist_t *hist)
+{
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    ESP_RETURN_ON_FALSE(hist != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    *hist = flash->write_latency;
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t nand_reset_write_latency_hist(spi_nand_flash_device_t *flash)
+{
+#if CONFIG_NAND_FLASH_LATENCY_STATS
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    memset(&flash->write_latency, 0, sizeof(flash->write_latency));
+    xSemaphoreGive(flash->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+uint32_t nand_latency_hist_percentile(const nand_latency_hist_t *hist, uint8_t percentile)
+{
+    // Number of samples at or below the percentile, rounded up
+    uint64_t target = ((uint64_t)hist->count * percentile + 99) / 100;
+    uint64_t seen = 0;
+
+    if (hist->count == 0) {
+        return 0;
+    }
+    for (int i = 0; i < NAND_LATENCY_HIST_BUCKETS - 1; i++) {
+        seen += hist->buckets[i];
+        if (seen >= target) {
+            return (2U << i) - 1;
+        }
+    }
+    return hist->max_us;
+}
@@ -31,6 +31,8 @@ esp_err_t spi_nand_gigadevice_init(spi_nand_flash_device_t *dev)
     dev->chip.read_page_delay_us = 25;
     dev->chip.erase_block_delay_us = 3200;
     dev->chip.program_page_delay_us = 380;
+    // No NAND_FLAG_HAS_CACHE_READ: the device IDs below are shared by several GigaDevice families, and the driver
+    // cannot tell which of them implement READ PAGE CACHE SEQUENTIAL (0x31) / LAST (0x3F). Pages are read one by one.
     ESP_LOGD(TAG, "%s: device_id: %x\n", __func__, device_id);
     switch (device_id) {
     case GIGADEVICE_DI_51:
@@ -12,6 +12,9 @@
 #include "spi_nand_oper.h"
 #include "spi_nand_flash.h"
 #include "nand.h"
+#if CONFIG_NAND_FLASH_WAIT_STATS || CONFIG_NAND_FLASH_IO_STATS
+#include "esp_timer.h"
+#endif
 
 #define ROM_WAIT_THRESHOLD_US 1000
 
@@ -39,15 +42,83 @@ static esp_err_t s_verify_write(spi_nand_flash_device_t *handle, const uint8_t *
 }
 #endif //CONFIG_NAND_FLASH_VERIFY_WRITE
 
-static esp_err_t wait_for_ready(spi_nand_flash_device_t *dev, uint32_t expected_operation_time_us, uint8_t *status_out)
+#if CONFIG_NAND_FLASH_WAIT_STATS
+static void update_wait_stats(spi_nand_flash_device_t *dev, nand_wait_op_t op, int64_t start_us, uint32_t polls)
 {
+    nand_wait_stats_t *stats = &dev->wait_stats[op];
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    stats->count++;
+    stats->total_us += elapsed_us;
+    stats->polls += polls;
+    if (elapsed_us > stats->max_us) {
+        stats->max_us = elapsed_us;
+    }
+}
+#endif //CONFIG_NAND_FLASH_WAIT_STATS
+
+#if CONFIG_NAND_FLASH_IO_STATS
+static void update_io_stats(spi_nand_flash_device_t *dev, nand_wait_op_t op, int64_t start_us, uint8_t status)
+{
+    nand_op_stats_t *stats = &dev->io_stats.ops[op];
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+
+    nand_latency_hist_add(&stats->latency, elapsed_us);
+    stats->total_us += elapsed_us;
+    if ((op == NAND_WAIT_OP_PROGRAM && (status & STAT_PROGRAM_FAILED)) ||
+            (op == NAND_WAIT_OP_ERASE && (status & STAT_ERASE_FAILED))) {
+        stats->failures++;
+    }
+}
+#endif //CONFIG_NAND_FLASH_IO_STATS
+
+#if CONFIG_NAND_FLASH_WAIT_BACKOFF
+#define WAIT_BACKOFF_MIN_US 8
+#define WAIT_BACKOFF_TICK_US (portTICK_PERIOD_MS * 1000)
+
+// Waits before the next status register read. The blocking waits last at least one tick, even when the delay is
+// shorter, the other ones are busy-waited.
+static void wait_backoff(uint32_t delay_us, bool block)
+{
+    if (block) {
+        vTaskDelay(delay_us > WAIT_BACKOFF_TICK_US ? delay_us / WAIT_BACKOFF_TICK_US : 1);
+    } else if (delay_us > 0) {
+        esp_rom_delay_us(delay_us);
+    }
+}
+#endif //CONFIG_NAND_FLASH_WAIT_BACKOFF
+
+static esp_err_t wait_for_ready(spi_nand_flash_device_t *dev, nand_wait_op_t op, uint32_t expected_operation_time_us, uint8_t *status_out)
+{
+#if CONFIG_NAND_FLASH_WAIT_STATS || CONFIG_NAND_FLASH_IO_STATS
+    int64_t start_us = esp_timer_get_time();
+#endif
+#if CONFIG_NAND_FLASH_WAIT_STATS
+    uint32_t polls = 0;
+#endif
+#if CONFIG_NAND_FLASH_WAIT_BACKOFF
+    // Waits for the typical duration of the operation, then polls the status register with an exponentially growing
+    // interval. As without backoff, operations expected to take ROM_WAIT_THRESHOLD_US or more block the task, the
+    // busy-waits of the shorter ones are bounded by ROM_WAIT_THRESHOLD_US.
+    const bool block = expected_operation_time_us >= ROM_WAIT_THRESHOLD_US;
+    const uint32_t max_backoff_us = block ? WAIT_BACKOFF_TICK_US : ROM_WAIT_THRESHOLD_US;
+    uint32_t backoff_us = expected_operation_time_us / 8;
+    if (backoff_us < WAIT_BACKOFF_MIN_US) {
+        backoff_us = WAIT_BACKOFF_MIN_US;
+    }
+    wait_backoff(expected_operation_time_us, block);
+#else
     if (expected_operation_time_us < ROM_WAIT_THRESHOLD_US) {
         esp_rom_delay_us(expected_operation_time_us);
     }
+#endif //CONFIG_NAND_FLASH_WAIT_BACKOFF
 
+    uint8_t status;
     while (true) {
-        uint8_t status;
         ESP_RETURN_ON_ERROR(spi_nand_read_register(dev, REG_STATUS, &status), TAG, "");
+#if CONFIG_NAND_FLASH_WAIT_STATS
+        polls++;
+#endif
 
         if ((status & STAT_BUSY) == 0) {
             if (status_out) {
@@ -56,11 +127,24 @@ static esp_err_t wait_for_ready(spi_nand_flash_device_t *dev, uint32_t expected_
             break;
         }
 
+#if CONFIG_NAND_FLASH_WAIT_BACKOFF
+        wait_backoff(backoff_us, block);
+        if (backoff_us < max_backoff_us) {
+            backoff_us = backoff_us * 2 < max_backoff_us ? backoff_us * 2 : max_backoff_us;
+        }
+#else
         if (expected_operation_time_us >= ROM_WAIT_THRESHOLD_US) {
             vTaskDelay(1);
         }
+#endif //CONFIG_NAND_FLASH_WAIT_BACKOFF
     }
 
+#if CONFIG_NAND_FLASH_WAIT_STATS
+    update_wait_stats(dev, op, start_us, polls);
+#endif
+#if CONFIG_NAND_FLASH_IO_STATS
+    update_io_stats(dev, op, start_us, status);
+#endif
     return ESP_OK;
 }
 
@@ -68,14 +152,14 @@ static esp_err_t read_page_and_wait(spi_nand_flash_device_t *dev, uint32_t page,
 {
     ESP_RETURN_ON_ERROR(spi_nand_read_page(dev, page), TAG, "");
 
-    return wait_for_ready(dev, dev->chip.read_page_delay_us, status_out);
+    return wait_for_ready(dev, NAND_WAIT_OP_READ, dev->chip.read_page_delay_us, status_out);
 }
 
 static esp_err_t program_execute_and_wait(spi_nand_flash_device_t *dev, uint32_t page, uint8_t *status_out)
 {
     ESP_RETURN_ON_ERROR(spi_nand_program_execute(dev, page), TAG, "");
 
-    return wait_for_ready(dev, dev->chip.program_page_delay_us, status_out);
+    return wait_for_ready(dev, NAND_WAIT_OP_PROGRAM, dev->chip.program_page_delay_us, status_out);
 }
 
 static uint16_t get_column_address(spi_nand_flash_device_t *handle, uint32_t block, uint32_t offset)
@@ -98,6 +182,10 @@ esp_err_t nand_is_bad(spi_nand_flash_device_t *handle, uint32_t block, bool *is_
     uint16_t bad_block_indicator;
     esp_err_t ret = ESP_OK;
 
+    if (nand_bbt_get(handle, block, is_bad_status)) {
+        return ret;
+    }
+
     ESP_GOTO_ON_ERROR(read_page_and_wait(handle, first_block_page, NULL), fail, TAG, "");
 
     uint16_t column_addr = get_column_address(handle, block, handle->chip.page_size);
@@ -109,6 +197,7 @@ esp_err_t nand_is_bad(spi_nand_flash_device_t *handle, uint32_t block, bool *is_
     memcpy(&bad_block_indicator, handle->read_buffer, sizeof(bad_block_indicator));
     ESP_LOGD(TAG, "is_bad, block=%"PRIu32", page=%"PRIu32",indicator = %04x", block, first_block_page, bad_block_indicator);
     *is_bad_status = (bad_block_indicator != 0xFFFF);
+    nand_bbt_set(handle, block, *is_bad_status);
     return ret;
 
 fail:
@@ -125,11 +214,14 @@ esp_err_t nand_mark_bad(spi_nand_flash_device_t *handle, uint32_t block)
     uint8_t status;
     ESP_LOGD(TAG, "mark_bad, block=%"PRIu32", page=%"PRIu32",indicator = %04x", block, first_block_page, bad_block_indicator);
 
+    // Even if writing the marker fails, the block must not be used anymore
+    nand_bbt_set(handle, block, true);
+
     ESP_GOTO_ON_ERROR(read_page_and_wait(handle, first_block_page, NULL), fail, TAG, "");
     ESP_GOTO_ON_ERROR(spi_nand_write_enable(handle), fail, TAG, "");
     ESP_GOTO_ON_ERROR(spi_nand_erase_block(handle, first_block_page),
                       fail, TAG, "");
-    ESP_GOTO_ON_ERROR(wait_for_ready(handle, handle->chip.erase_block_delay_us, &status),
+    ESP_GOTO_ON_ERROR(wait_for_ready(handle, NAND_WAIT_OP_ERASE, handle->chip.erase_block_delay_us, &status),
                       fail, TAG, "");
     if ((status & STAT_ERASE_FAILED) != 0) {
         ret = ESP_ERR_NOT_FINISHED;
@@ -165,7 +257,7 @@ esp_err_t nand_erase_chip(spi_nand_flash_device_t *handle)
         ESP_GOTO_ON_ERROR(spi_nand_write_enable(handle), end, TAG, "");
         ESP_GOTO_ON_ERROR(spi_nand_erase_block(handle, i * (1 << handle->chip.log2_ppb)),
                           end, TAG, "");
-        ESP_GOTO_ON_ERROR(wait_for_ready(handle, handle->chip.erase_block_delay_us, &status),
+        ESP_GOTO_ON_ERROR(wait_for_ready(handle, NAND_WAIT_OP_ERASE, handle->chip.erase_block_delay_us, &status),
                           end, TAG, "");
         if ((status & STAT_ERASE_FAILED) != 0) {
             ret = ESP_ERR_NOT_FINISHED;
@@ -189,7 +281,7 @@ esp_err_t nand_erase_block(spi_nand_flash_device_t *handle, uint32_t block)
     ESP_GOTO_ON_ERROR(spi_nand_write_enable(handle), fail, TAG, "");
     ESP_GOTO_ON_ERROR(spi_nand_erase_block(handle, first_block_page),
                       fail, TAG, "");
-    ESP_GOTO_ON_ERROR(wait_for_ready(handle,
+    ESP_GOTO_ON_ERROR(wait_for_ready(handle, NAND_WAIT_OP_ERASE,
                                      handle->chip.erase_block_delay_us, &status),
                       fail, TAG, "");
 
@@ -317,10 +409,199 @@ fail:
     return ret;
 }
 
+static esp_err_t read_cache_and_wait(spi_nand_flash_device_t *dev, bool last, uint8_t *status_out)
+{
+    if (last) {
+        ESP_RETURN_ON_ERROR(spi_nand_read_cache_last(dev), TAG, "");
+    } else {
+        ESP_RETURN_ON_ERROR(spi_nand_read_cache_sequential(dev), TAG, "");
+    }
+
+    return wait_for_ready(dev, NAND_WAIT_OP_READ, dev->chip.read_page_delay_us, status_out);
+}
+
+// Reads `count` consecutive pages of the same block using the cache read commands.
+// While the host transfers page N out of the cache, the chip is already loading page N+1 into its data register.
+static esp_err_t nand_read_pages_cached(spi_nand_flash_device_t *handle, uint32_t page, uint32_t count, uint8_t *data,
+                                        ecc_status_t *refresh_status)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t status;
+    uint32_t block = page >> handle->chip.log2_ppb;
+    uint16_t column_addr = get_column_address(handle, block, 0);
+
+    ESP_GOTO_ON_ERROR(read_page_and_wait(handle, page, &status), fail, TAG, "");
+    if (is_ecc_error(handle, status)) {
+        ESP_LOGD(TAG, "read ecc error, page=%"PRIu32"", page);
+        return ESP_FAIL;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        bool last = (i == count - 1);
+        // Moves page (page + i) into the cache and, unless this is the last page, starts loading (page + i + 1)
+        ESP_GOTO_ON_ERROR(read_cache_and_wait(handle, last, &status), fail, TAG, "");
+        if (is_ecc_error(handle, status)) {
+            ESP_LOGD(TAG, "read ecc error, page=%"PRIu32"", page + i);
+            if (!last) {
+                // Leave the cache read mode before reporting the error
+                read_cache_and_wait(handle, true, NULL);
+            }
+            return ESP_FAIL;
+        }
+        if (handle->chip.ecc_data.ecc_corrected_bits_status && nand_need_data_refresh(handle)) {
+            *refresh_status = handle->chip.ecc_data.ecc_corrected_bits_status;
+        }
+
+        ESP_GOTO_ON_ERROR(spi_nand_read(handle, handle->read_buffer, column_addr, handle->chip.page_size), fail, TAG, "");
+        memcpy(data + i * handle->chip.page_size, handle->read_buffer, handle->chip.page_size);
+    }
+    return ret;
+
+fail:
+    ESP_LOGE(TAG, "Error in nand_read_pages %d", ret);
+    return ret;
+}
+
+esp_err_t nand_read_pages(spi_nand_flash_device_t *handle, uint32_t page, uint32_t count, uint8_t *data)
+{
+    ESP_LOGV(TAG, "read_pages, page=%"PRIu32", count=%"PRIu32"", page, count);
+    assert(page + count <= handle->chip.num_blocks * (1 << handle->chip.log2_ppb));
+    esp_err_t ret = ESP_OK;
+    // Soft ECC status of the worst page in the range which needs a refresh, reported back to the caller once all pages are read
+    ecc_status_t refresh_status = STAT_ECC_OK;
+
+    while (count > 0) {
+        uint32_t pages_left_in_block = (1 << handle->chip.log2_ppb) - (page & ((1 << handle->chip.log2_ppb) - 1));
+        uint32_t chunk = count < pages_left_in_block ? count : pages_left_in_block;
+
+        if ((handle->chip.flags & NAND_FLAG_HAS_CACHE_READ) && chunk > 1) {
+            ret = nand_read_pages_cached(handle, page, chunk, data, &refresh_status);
+            if (ret != ESP_OK) {
+                return ret;
+            }
+        } else {
+            for (uint32_t i = 0; i < chunk; i++) {
+                ret = nand_read(handle, page + i, 0, handle->chip.page_size, handle->read_buffer);
+                if (ret != ESP_OK) {
+                    return ret;
+                }
+                if (handle->chip.ecc_data.ecc_corrected_bits_status && nand_need_data_refresh(handle)) {
+                    refresh_status = handle->chip.ecc_data.ecc_corrected_bits_status;
+                }
+                memcpy(data + i * handle->chip.page_size, handle->read_buffer, handle->chip.page_size);
+            }
+        }
+        page += chunk;
+        count -= chunk;
+        data += chunk * handle->chip.page_size;
+    }
+
+    if (refresh_status != STAT_ECC_OK) {
+        handle->chip.ecc_data.ecc_corrected_bits_status = refresh_status;
+    }
+    return ret;
+}
+
+esp_err_t nand_read_async(spi_nand_flash_device_t *handle, uint32_t page, uint8_t *data)
+{
+    ESP_LOGV(TAG, "read_async, page=%"PRIu32"", page);
+    assert(page < handle->chip.num_blocks * (1 << handle->chip.log2_ppb));
+    ESP_RETURN_ON_FALSE(handle->async.op == NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "async operation already in progress");
+    esp_err_t ret = ESP_OK;
+    uint8_t status;
+
+    ESP_GOTO_ON_ERROR(read_page_and_wait(handle, page, &status), fail, TAG, "");
+
+    if (is_ecc_error(handle, status)) {
+        ESP_LOGD(TAG, "read ecc error, page=%"PRIu32"", page);
+        return ESP_FAIL;
+    }
+
+    uint16_t column_addr = get_column_address(handle, page >> handle->chip.log2_ppb, 0);
+    ESP_GOTO_ON_ERROR(spi_nand_read_start(handle, data, column_addr, handle->chip.page_size), fail, TAG, "");
+
+    handle->async.op = NAND_ASYNC_OP_READ;
+    handle->async.page = page;
+    return ret;
+fail:
+    ESP_LOGE(TAG, "Error in nand_read_async %d", ret);
+    return ret;
+}
+
+esp_err_t nand_prog_async(spi_nand_flash_device_t *handle, uint32_t page, const uint8_t *data)
+{
+    ESP_LOGV(TAG, "prog_async, page=%"PRIu32"", page);
+    ESP_RETURN_ON_FALSE(handle->async.op == NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "async operation already in progress");
+    esp_err_t ret = ESP_OK;
+
+    uint16_t column_addr = get_column_address(handle, page >> handle->chip.log2_ppb, 0);
+
+    ESP_GOTO_ON_ERROR(read_page_and_wait(handle, page, NULL), fail, TAG, "");
+    ESP_GOTO_ON_ERROR(spi_nand_write_enable(handle), fail, TAG, "");
+    // The used marker and PROGRAM EXECUTE are issued by nand_async_wait() once the data transfer is done
+    ESP_GOTO_ON_ERROR(spi_nand_program_load_start(handle, data, column_addr, handle->chip.page_size), fail, TAG, "");
+
+    handle->async.op = NAND_ASYNC_OP_PROG;
+    handle->async.page = page;
+    return ret;
+fail:
+    ESP_LOGE(TAG, "Error in nand_prog_async %d", ret);
+    return ret;
+}
+
+esp_err_t nand_async_wait(spi_nand_flash_device_t *handle, TickType_t timeout)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op != NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "no async operation in progress");
+    esp_err_t ret = ESP_OK;
+    uint32_t page = handle->async.page;
+
+    ret = spi_nand_finish_transaction(handle, timeout);
+    if (ret == ESP_ERR_TIMEOUT) {
+        // Still in flight, the caller may wait again
+        return ret;
+    }
+    nand_async_op_t op = handle->async.op;
+    handle->async.op = NAND_ASYNC_OP_NONE;
+    ESP_GOTO_ON_FALSE(ret == ESP_OK, ret, fail, TAG, "");
+
+    if (op == NAND_ASYNC_OP_PROG) {
+        uint16_t used_marker = 0;
+        uint8_t status;
+        uint16_t column_addr = get_column_address(handle, page >> handle->chip.log2_ppb, 0);
+
+        ESP_GOTO_ON_ERROR(spi_nand_program_load(handle, (uint8_t *)&used_marker,
+                                                column_addr + handle->chip.page_size + 2, 2), fail, TAG, "");
+        ESP_GOTO_ON_ERROR(program_execute_and_wait(handle, page, &status), fail, TAG, "");
+
+        if ((status & STAT_PROGRAM_FAILED) != 0) {
+            ESP_LOGD(TAG, "prog failed, page=%"PRIu32",", page);
+            return ESP_ERR_NOT_FINISHED;
+        }
+    }
+    return ret;
+fail:
+    ESP_LOGE(TAG, "Error in nand_async_wait %d", ret);
+    return ret;
+}
+
+esp_err_t nand_async_cancel(spi_nand_flash_device_t *handle)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op != NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "no async operation in progress");
+
+    // A queued SPI transaction cannot be aborted, wait for the transfer but do not program the loaded page
+    esp_err_t ret = spi_nand_finish_transaction(handle, portMAX_DELAY);
+    handle->async.op = NAND_ASYNC_OP_NONE;
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error in nand_async_cancel %d", ret);
+    }
+    return ret;
+}
+
 esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
 {
     ESP_LOGD(TAG, "copy, src=%"PRIu32", dst=%"PRIu32"", src, dst);
     esp_err_t ret = ESP_OK;
+    uint8_t *copy_buf = NULL;
 #if CONFIG_NAND_FLASH_VERIFY_WRITE
     uint8_t *temp_buf = NULL;
 #endif //CONFIG_NAND_FLASH_VERIFY_WRITE
@@ -341,7 +622,9 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
 
     if (src_column_addr != dst_column_addr) {
         // In a 2 plane structure of the flash, if the pages are not on the same plane, the data must be copied through RAM.
-        uint8_t *copy_buf = heap_caps_malloc(handle->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+        // It is loaded into the cache of the destination plane and programmed by the PROGRAM EXECUTE below, same as
+        // an internal data move, so the page is programmed only once.
+        copy_buf = heap_caps_malloc(handle->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
         ESP_GOTO_ON_FALSE(copy_buf, ESP_ERR_NO_MEM, fail, TAG, "Failed to allocate copy buffer");
 
         ESP_GOTO_ON_ERROR(spi_nand_read(handle, copy_buf, src_column_addr, handle->chip.page_size), fail, TAG, "");
@@ -354,13 +637,8 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
         uint16_t used_marker = 0;
         ESP_GOTO_ON_ERROR(spi_nand_program_load(handle, (uint8_t *)&used_marker,
                                                 dst_column_addr + handle->chip.page_size + 2, 2), fail, TAG, "");
-        ESP_GOTO_ON_ERROR(program_execute_and_wait(handle, dst, &status), fail, TAG, "");
-
-        if ((status & STAT_PROGRAM_FAILED) != 0) {
-            ESP_LOGD(TAG, "copy, prog failed");
-            return ESP_ERR_NOT_FINISHED;
-        }
         free(copy_buf);
+        copy_buf = NULL;
     }
 
     ESP_GOTO_ON_ERROR(program_execute_and_wait(handle, dst, &status), fail, TAG, "");
@@ -368,6 +646,22 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
         ESP_LOGD(TAG, "copy, prog failed");
         return ESP_ERR_NOT_FINISHED;
     }
+    if (src_column_addr == dst_column_addr) {
+        handle->copy_stats.internal_copies++;
+    } else {
+        handle->copy_stats.host_copies++;
+    }
+
+#if CONFIG_NAND_FLASH_COPY_CHECK_ECC && !CONFIG_NAND_FLASH_VERIFY_WRITE
+    // Load the new page into the cache, the chip reports its ECC status without any data being transferred
+    ESP_GOTO_ON_ERROR(read_page_and_wait(handle, dst, &status), fail, TAG, "");
+    if (is_ecc_error(handle, status)) {
+        // Let dhara retire the destination block and copy the page elsewhere
+        ESP_LOGD(TAG, "copy, dst_page=%"PRIu32" ecc error", dst);
+        handle->copy_stats.ecc_failures++;
+        return ESP_ERR_NOT_FINISHED;
+    }
+#endif //CONFIG_NAND_FLASH_COPY_CHECK_ECC && !CONFIG_NAND_FLASH_VERIFY_WRITE
 
 #if CONFIG_NAND_FLASH_VERIFY_WRITE
     // First read src page data from cache to temp_buf
@@ -403,6 +697,7 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
     return ret;
 
 fail:
+    free(copy_buf);
 #if CONFIG_NAND_FLASH_VERIFY_WRITE
     free(temp_buf);
 #endif //CONFIG_NAND_FLASH_VERIFY_WRITE
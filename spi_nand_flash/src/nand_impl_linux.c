@@ -19,12 +19,18 @@ esp_err_t nand_is_bad(spi_nand_flash_device_t *handle, uint32_t block, bool *is_
     esp_err_t ret = ESP_OK;
     uint32_t block_offset = block * handle->chip.block_size;
 
+    if (nand_bbt_get(handle, block, is_bad_status)) {
+        return ret;
+    }
+
     // Read the first 2 bytes on the OOB of the first page in the block. This should be 0xFFFF for a good block
     ESP_RETURN_ON_ERROR(nand_emul_read(handle, block_offset + handle->chip.page_size, (uint8_t *) &bad_block_indicator, 2),
                         TAG, "Error in nand_is_bad %d", ret);
+    nand_emul_account_op(handle, NAND_EMUL_OP_PAGE_READ, 2);
 
     ESP_LOGD(TAG, "is_bad, block=%"PRIu32", page=%"PRIu32",indicator = %04x", block, block_offset, bad_block_indicator);
     *is_bad_status = bad_block_indicator != 0xFFFF;
+    nand_bbt_set(handle, block, *is_bad_status);
     return ret;
 }
 
@@ -36,10 +42,14 @@ esp_err_t nand_mark_bad(spi_nand_flash_device_t *handle, uint32_t block)
     uint16_t bad_block_indicator = 0;
     ESP_LOGD(TAG, "mark_bad, block=%"PRIu32", page=%"PRIu32",indicator = %04x", block, first_block_page, bad_block_indicator);
 
+    // Even if writing the marker fails, the block must not be used anymore
+    nand_bbt_set(handle, block, true);
+
     ESP_RETURN_ON_ERROR(nand_emul_erase_block(handle, block * handle->chip.block_size), TAG, "Error in nand_mark_bad %d", ret);
 
     ESP_RETURN_ON_ERROR(nand_emul_write(handle, block * handle->chip.block_size + handle->chip.page_size,
                                         (const uint8_t *) &bad_block_indicator, 2), TAG, "Error in nand_mark_bad %d", ret);
+    nand_emul_account_op(handle, NAND_EMUL_OP_PAGE_PROGRAM, 2);
 
     return ret;
 }
@@ -75,6 +85,7 @@ esp_err_t nand_prog(spi_nand_flash_device_t *handle, uint32_t page, const uint8_
     ESP_RETURN_ON_ERROR(nand_emul_write(handle, data_offset, data, handle->chip.page_size), TAG, "Error in nand_prog %d", ret);
     ESP_RETURN_ON_ERROR(nand_emul_write(handle, data_offset + handle->chip.page_size + 2,
                                         (uint8_t *)&used_marker, 2), TAG, "Error in nand_prog %d", ret);
+    nand_emul_account_op(handle, NAND_EMUL_OP_PAGE_PROGRAM, handle->chip.page_size + 2);
 
     return ret;
 }
@@ -86,24 +97,96 @@ esp_err_t nand_is_free(spi_nand_flash_device_t *handle, uint32_t page, bool *is_
 
     ESP_RETURN_ON_ERROR(nand_emul_read(handle, page * handle->chip.emulated_page_size + handle->chip.page_size + 2, (uint8_t *)&used_marker, 2),
                         TAG, "Error in nand_is_free %d", ret);
+    nand_emul_account_op(handle, NAND_EMUL_OP_PAGE_READ, 2);
 
     ESP_LOGD(TAG, "is free, page=%"PRIu32", used_marker=%04x,", page, used_marker);
     *is_free_status = (used_marker == 0xFFFF);
     return ret;
 }
 
+// Sets the ECC status of the page just read from the corrected bits injected by nand_emul_set_ecc_corrected_bits(),
+// returns true if the page is uncorrectable
+static bool emul_ecc_status(spi_nand_flash_device_t *handle)
+{
+    uint8_t bits = handle->emul_handle->ecc_corrected_bits;
+    ecc_status_t status = STAT_ECC_OK;
+
+    if (bits > 8) {
+        status = STAT_ECC_NOT_CORRECTED;
+    } else if (bits >= 7) {
+        status = STAT_ECC_7_8_BITS_CORRECTED;
+    } else if (bits >= 4) {
+        status = STAT_ECC_4_TO_6_BITS_CORRECTED;
+    } else if (bits) {
+        status = STAT_ECC_1_TO_3_BITS_CORRECTED;
+    }
+    handle->chip.ecc_data.ecc_corrected_bits_status = status;
+    return status == STAT_ECC_NOT_CORRECTED;
+}
+
 esp_err_t nand_read(spi_nand_flash_device_t *handle, uint32_t page, size_t offset, size_t length, uint8_t *data)
 {
     ESP_LOGV(TAG, "read, page=%"PRIu32", offset=%ld, length=%ld", page, offset, length);
     assert(page < handle->chip.num_blocks * (1 << handle->chip.log2_ppb));
     esp_err_t ret = ESP_OK;
 
+    if (emul_ecc_status(handle)) {
+        ESP_LOGD(TAG, "read ecc error, page=%"PRIu32"", page);
+        return ESP_FAIL;
+    }
     ESP_RETURN_ON_ERROR(nand_emul_read(handle, page * handle->chip.emulated_page_size + offset, data, length),
                         TAG, "Error in nand_read %d", ret);
+    nand_emul_account_op(handle, NAND_EMUL_OP_PAGE_READ, length);
+
+    return ret;
+}
+
+esp_err_t nand_read_pages(spi_nand_flash_device_t *handle, uint32_t page, uint32_t count, uint8_t *data)
+{
+    ESP_LOGV(TAG, "read_pages, page=%"PRIu32", count=%"PRIu32"", page, count);
+    esp_err_t ret = ESP_OK;
 
+    for (uint32_t i = 0; i < count; i++) {
+        ESP_RETURN_ON_ERROR(nand_read(handle, page + i, 0, handle->chip.page_size, data + i * handle->chip.page_size),
+                            TAG, "Error in nand_read_pages %d", ret);
+    }
     return ret;
 }
 
+// The emulated flash completes every operation synchronously, the result is only held until nand_async_wait()
+esp_err_t nand_read_async(spi_nand_flash_device_t *handle, uint32_t page, uint8_t *data)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op == NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "async operation already in progress");
+    handle->async.result = nand_read(handle, page, 0, handle->chip.page_size, data);
+    handle->async.op = NAND_ASYNC_OP_READ;
+    handle->async.page = page;
+    return ESP_OK;
+}
+
+esp_err_t nand_prog_async(spi_nand_flash_device_t *handle, uint32_t page, const uint8_t *data)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op == NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "async operation already in progress");
+    handle->async.result = nand_prog(handle, page, data);
+    handle->async.op = NAND_ASYNC_OP_PROG;
+    handle->async.page = page;
+    return ESP_OK;
+}
+
+esp_err_t nand_async_wait(spi_nand_flash_device_t *handle, TickType_t timeout)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op != NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "no async operation in progress");
+    handle->async.op = NAND_ASYNC_OP_NONE;
+    return handle->async.result;
+}
+
+// The emulated page program already happened in nand_prog_async(), only its result is dropped
+esp_err_t nand_async_cancel(spi_nand_flash_device_t *handle)
+{
+    ESP_RETURN_ON_FALSE(handle->async.op != NAND_ASYNC_OP_NONE, ESP_ERR_INVALID_STATE, TAG, "no async operation in progress");
+    handle->async.op = NAND_ASYNC_OP_NONE;
+    return ESP_OK;
+}
+
 esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
 {
     ESP_LOGD(TAG, "copy, src=%"PRIu32", dst=%"PRIu32"", src, dst);
@@ -114,6 +197,8 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
                         TAG, "Error in nand_copy %d", ret);
     ESP_RETURN_ON_ERROR(nand_emul_write(handle, (size_t)dst_offset, (void *)handle->read_buffer, handle->chip.page_size),
                         TAG, "Error in nand_copy %d", ret);
+    // Modelled as the internal data move of a real chip
+    nand_emul_account_op(handle, NAND_EMUL_OP_INTERNAL_COPY, 0);
 
     return ret;
 }
@@ -121,5 +206,8 @@ esp_err_t nand_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
 esp_err_t nand_get_ecc_status(spi_nand_flash_device_t *handle, uint32_t page)
 {
     esp_err_t ret = ESP_OK;
+    if (emul_ecc_status(handle)) {
+        ESP_LOGD(TAG, "read ecc error, page=%"PRIu32"", page);
+    }
     return ret;
 }
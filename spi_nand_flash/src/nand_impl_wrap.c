@@ -7,6 +7,7 @@
 #include <string.h>
 #include "esp_check.h"
 #include "esp_err.h"
+#include "freertos/task.h"
 #include "spi_nand_flash.h"
 #include "nand.h"
 #include "nand_impl.h"
@@ -74,6 +75,63 @@ esp_err_t nand_wrap_read(spi_nand_flash_device_t *handle, uint32_t page, size_t
     return ret;
 }
 
+esp_err_t nand_wrap_read_async(spi_nand_flash_device_t *handle, uint32_t page, uint8_t *data)
+{
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    ret = nand_read_async(handle, page, data);
+    if (ret != ESP_OK) {
+        xSemaphoreGive(handle->mutex);
+        return ret;
+    }
+    // The mutex stays taken until nand_wrap_async_wait() or nand_wrap_async_cancel() ends the operation
+    handle->async.owner = xTaskGetCurrentTaskHandle();
+    return ret;
+}
+
+esp_err_t nand_wrap_prog_async(spi_nand_flash_device_t *handle, uint32_t page, const uint8_t *data)
+{
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    ret = nand_prog_async(handle, page, data);
+    if (ret != ESP_OK) {
+        xSemaphoreGive(handle->mutex);
+        return ret;
+    }
+    handle->async.owner = xTaskGetCurrentTaskHandle();
+    return ret;
+}
+
+// Only the task holding the mutex may end the operation, any other task gets ESP_ERR_INVALID_STATE
+static bool nand_wrap_async_owned(spi_nand_flash_device_t *handle)
+{
+    return handle->async.owner != NULL && handle->async.owner == xTaskGetCurrentTaskHandle();
+}
+
+esp_err_t nand_wrap_async_wait(spi_nand_flash_device_t *handle, TickType_t timeout)
+{
+    if (!nand_wrap_async_owned(handle)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = nand_async_wait(handle, timeout);
+    if (ret != ESP_ERR_TIMEOUT) {
+        handle->async.owner = NULL;
+        xSemaphoreGive(handle->mutex);
+    }
+    return ret;
+}
+
+esp_err_t nand_wrap_async_cancel(spi_nand_flash_device_t *handle)
+{
+    if (!nand_wrap_async_owned(handle)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t ret = nand_async_cancel(handle);
+    handle->async.owner = NULL;
+    xSemaphoreGive(handle->mutex);
+    return ret;
+}
+
 esp_err_t nand_wrap_copy(spi_nand_flash_device_t *handle, uint32_t src, uint32_t dst)
 {
     esp_err_t ret = ESP_OK;
@@ -41,6 +41,11 @@ static esp_err_t nand_emul_mmap_init(nand_mmap_emul_handle_t *emul_handle)
         return ESP_ERR_NOT_FOUND;
     }
 
+    // A dump of the same size is mounted again, anything else starts erased
+    struct stat st;
+    bool keep_contents = fstat(emul_handle->mem_file_fd, &st) == 0 &&
+                         st.st_size == (off_t)emul_handle->file_mmap_ctrl.flash_file_size;
+
     // Set file size
     if (ftruncate(emul_handle->mem_file_fd, emul_handle->file_mmap_ctrl.flash_file_size) != 0) {
         ESP_LOGE(TAG, "Failed to set NAND file size: %s", strerror(errno));
@@ -59,7 +64,9 @@ static esp_err_t nand_emul_mmap_init(nand_mmap_emul_handle_t *emul_handle)
     }
 
     // Initialize with 0xFF (erased state)
-    memset(emul_handle->mem_file_buf, 0xFF, emul_handle->file_mmap_ctrl.flash_file_size);
+    if (!keep_contents) {
+        memset(emul_handle->mem_file_buf, 0xFF, emul_handle->file_mmap_ctrl.flash_file_size);
+    }
 
     ESP_LOGI(TAG, "NAND flash emulation initialized: %s (size: %zu bytes)",
              emul_handle->file_mmap_ctrl.flash_file_name,
@@ -136,10 +143,18 @@ esp_err_t nand_emul_init(spi_nand_flash_device_t *handle, nand_file_mmap_emul_co
 esp_err_t nand_emul_deinit(spi_nand_flash_device_t *handle)
 {
     esp_err_t ret = nand_emul_mmap_deinit(handle->emul_handle);
+#ifdef CONFIG_NAND_ENABLE_STATS
+    free(handle->emul_handle->stats.block_erase_count);
+#endif
     free(handle->emul_handle);
     return ret;
 }
 
+void nand_emul_set_ecc_corrected_bits(spi_nand_flash_device_t *handle, uint8_t bits)
+{
+    handle->emul_handle->ecc_corrected_bits = bits;
+}
+
 // Read from NAND
 esp_err_t nand_emul_read(spi_nand_flash_device_t *handle, size_t addr, void *dst, size_t size)
 {
@@ -205,6 +220,14 @@ esp_err_t nand_emul_erase_block(spi_nand_flash_device_t *handle, size_t offset)
 
 #ifdef CONFIG_NAND_ENABLE_STATS
     emul_handle->stats.erase_ops++;
+    emul_handle->stats.projected_time_us += handle->chip.erase_block_delay_us;
+    if (emul_handle->stats.block_erase_count == NULL) {
+        emul_handle->stats.num_blocks = handle->chip.num_blocks;
+        emul_handle->stats.block_erase_count = calloc(handle->chip.num_blocks, sizeof(uint32_t));
+    }
+    if (emul_handle->stats.block_erase_count) {
+        emul_handle->stats.block_erase_count[offset / handle->chip.block_size]++;
+    }
 #endif
 
     return ESP_OK;
@@ -220,5 +243,50 @@ void nand_emul_clear_stats(spi_nand_flash_device_t *handle)
     emul_handle->stats.erase_ops = 0;
     emul_handle->stats.read_bytes = 0;
     emul_handle->stats.write_bytes = 0;
+    emul_handle->stats.page_reads = 0;
+    emul_handle->stats.page_programs = 0;
+    emul_handle->stats.projected_time_us = 0;
+    if (emul_handle->stats.block_erase_count) {
+        memset(emul_handle->stats.block_erase_count, 0, emul_handle->stats.num_blocks * sizeof(uint32_t));
+    }
+}
+
+void nand_emul_account_op(spi_nand_flash_device_t *handle, nand_emul_op_t op, size_t transfer_bytes)
+{
+    nand_mmap_emul_handle_t *emul_handle = handle->emul_handle;
+    uint64_t time_us = (uint64_t)transfer_bytes * 8 / CONFIG_NAND_EMUL_SPI_FREQ_MHZ;
+
+    switch (op) {
+    case NAND_EMUL_OP_PAGE_READ:
+        emul_handle->stats.page_reads++;
+        time_us += handle->chip.read_page_delay_us;
+        break;
+    case NAND_EMUL_OP_PAGE_PROGRAM:
+        emul_handle->stats.page_programs++;
+        time_us += handle->chip.program_page_delay_us;
+        break;
+    case NAND_EMUL_OP_INTERNAL_COPY:
+        emul_handle->stats.page_reads++;
+        emul_handle->stats.page_programs++;
+        time_us += handle->chip.read_page_delay_us + handle->chip.program_page_delay_us;
+        break;
+    }
+    emul_handle->stats.projected_time_us += time_us;
+}
+
+void nand_emul_get_timing_stats(spi_nand_flash_device_t *handle, uint64_t *projected_time_us, size_t *page_reads,
+                                size_t *page_programs)
+{
+    nand_mmap_emul_handle_t *emul_handle = handle->emul_handle;
+    *projected_time_us = emul_handle->stats.projected_time_us;
+    *page_reads = emul_handle->stats.page_reads;
+    *page_programs = emul_handle->stats.page_programs;
+}
+
+const uint32_t *nand_emul_get_erase_counts(spi_nand_flash_device_t *handle, size_t *num_blocks)
+{
+    nand_mmap_emul_handle_t *emul_handle = handle->emul_handle;
+    *num_blocks = emul_handle->stats.num_blocks;
+    return emul_handle->stats.block_erase_count;
 }
 #endif
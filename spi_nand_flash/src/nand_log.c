@@ -0,0 +1,376 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "nand.h"
+#include "nand_impl.h"
+#include "nand_log.h"
+
+static const char *TAG = "nand_log";
+
+#define LOG_PAGE_MAGIC      0x474F4C4E      // "NLOG"
+#define LOG_SEQ_FREE        0               // erased, or holding no log data
+#define LOG_SEQ_BAD         UINT32_MAX
+#define LOG_NO_BLOCK        UINT32_MAX
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;                   // sequence number of the block, one more for each block opened
+    uint32_t length;                // log data in the page, after the header
+} log_page_header_t;
+
+struct nand_log_t {
+    spi_nand_flash_device_t *handle;
+    uint32_t first_block;
+    uint32_t num_blocks;
+    uint32_t *block_seq;            // sequence number of each block, LOG_SEQ_FREE or LOG_SEQ_BAD
+    uint32_t head;                  // block being written, LOG_NO_BLOCK before the first append
+    uint32_t head_page;             // next page to program in the head block
+    uint32_t next_seq;
+    uint8_t *page_buffer;           // page being filled, header included
+    uint32_t page_fill;             // log data in page_buffer
+    uint8_t *read_buffer;
+};
+
+#if CONFIG_NAND_FLASH_LOG_PARTITION
+#define LOG_PARTITION_BLOCKS CONFIG_NAND_FLASH_LOG_PARTITION_BLOCKS
+#else
+#define LOG_PARTITION_BLOCKS 0
+#endif
+
+static inline uint32_t page_data_size(const nand_log_t *log)
+{
+    return log->handle->chip.page_size - sizeof(log_page_header_t);
+}
+
+static inline uint32_t block_page(const nand_log_t *log, uint32_t block, uint32_t page)
+{
+    return ((log->first_block + block) << log->handle->chip.log2_ppb) + page;
+}
+
+// Block holding the smallest sequence number >= min_seq, LOG_NO_BLOCK if there is none
+static uint32_t find_block(const nand_log_t *log, uint32_t min_seq)
+{
+    uint32_t found = LOG_NO_BLOCK;
+    for (uint32_t b = 0; b < log->num_blocks; b++) {
+        uint32_t seq = log->block_seq[b];
+        if (seq != LOG_SEQ_FREE && seq != LOG_SEQ_BAD && seq >= min_seq &&
+                (found == LOG_NO_BLOCK || seq < log->block_seq[found])) {
+            found = b;
+        }
+    }
+    return found;
+}
+
+static void retire_block(nand_log_t *log, uint32_t block)
+{
+    ESP_LOGW(TAG, "block %"PRIu32" failed, marking it bad", log->first_block + block);
+    // The bad block table is part of the fast mount record, which must not be used once the marker is written.
+    // Without the marker, the block fails again and is retired by the next open.
+    if (nand_disarm_mount_state(log->handle) == ESP_OK) {
+        nand_mark_bad(log->handle, log->first_block + block);
+    }
+    log->block_seq[block] = LOG_SEQ_BAD;
+}
+
+// Moves the head to the next good block after it, erasing the oldest data once the partition is full
+static esp_err_t open_next_block(nand_log_t *log)
+{
+    uint32_t block = (log->head == LOG_NO_BLOCK) ? log->num_blocks - 1 : log->head;
+
+    for (uint32_t i = 0; i < log->num_blocks; i++) {
+        block = (block + 1) % log->num_blocks;
+        if (log->block_seq[block] == LOG_SEQ_BAD) {
+            continue;
+        }
+        // Also erases blocks left by an interrupted erase or by another user of the blocks
+        if (nand_erase_block(log->handle, log->first_block + block) != ESP_OK) {
+            retire_block(log, block);
+            continue;
+        }
+        log->block_seq[block] = log->next_seq++;
+        log->head = block;
+        log->head_page = 0;
+        return ESP_OK;
+    }
+    log->head = LOG_NO_BLOCK;
+    ESP_LOGE(TAG, "no good block left");
+    return ESP_ERR_NO_MEM;
+}
+
+static esp_err_t program_page(nand_log_t *log)
+{
+    const uint32_t pages_per_block = 1 << log->handle->chip.log2_ppb;
+    log_page_header_t *header = (log_page_header_t *)log->page_buffer;
+
+    header->magic = LOG_PAGE_MAGIC;
+    header->length = log->page_fill;
+    memset(log->page_buffer + sizeof(log_page_header_t) + log->page_fill, 0xFF, page_data_size(log) - log->page_fill);
+
+    while (true) {
+        if (log->head == LOG_NO_BLOCK || log->head_page == pages_per_block) {
+            ESP_RETURN_ON_ERROR(open_next_block(log), TAG, "");
+        }
+        header->seq = log->block_seq[log->head];
+        if (nand_prog(log->handle, block_page(log, log->head, log->head_page), log->page_buffer) == ESP_OK) {
+            break;
+        }
+        // The pages already programmed in the block are lost with it, the page goes to the next block
+        retire_block(log, log->head);
+        log->head_page = pages_per_block;
+    }
+    log->head_page++;
+    log->page_fill = 0;
+    return ESP_OK;
+}
+
+// First free page of the head block, pages being programmed in order
+static esp_err_t find_head_page(nand_log_t *log)
+{
+    uint32_t low = 1;
+    uint32_t high = 1 << log->handle->chip.log2_ppb;
+
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        bool is_free;
+        ESP_RETURN_ON_ERROR(nand_is_free(log->handle, block_page(log, log->head, mid), &is_free), TAG, "");
+        if (is_free) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    log->head_page = low;
+    return ESP_OK;
+}
+
+static esp_err_t scan(nand_log_t *log)
+{
+    log_page_header_t header;
+    uint32_t max_seq = LOG_SEQ_FREE;
+
+    log->head = LOG_NO_BLOCK;
+    for (uint32_t b = 0; b < log->num_blocks; b++) {
+        bool is_bad;
+        ESP_RETURN_ON_ERROR(nand_is_bad(log->handle, log->first_block + b, &is_bad), TAG, "");
+        if (is_bad) {
+            log->block_seq[b] = LOG_SEQ_BAD;
+            continue;
+        }
+        log->block_seq[b] = LOG_SEQ_FREE;
+        // An unreadable first page leaves the block free, it is erased before being written again
+        if (nand_read(log->handle, block_page(log, b, 0), 0, sizeof(header), (uint8_t *)&header) == ESP_OK &&
+                header.magic == LOG_PAGE_MAGIC && header.seq != LOG_SEQ_FREE && header.seq != LOG_SEQ_BAD) {
+            log->block_seq[b] = header.seq;
+            if (header.seq > max_seq) {
+                max_seq = header.seq;
+                log->head = b;
+            }
+        }
+    }
+    log->next_seq = max_seq + 1;
+    if (log->head != LOG_NO_BLOCK) {
+        ESP_RETURN_ON_ERROR(find_head_page(log), TAG, "");
+    }
+    ESP_LOGD(TAG, "scanned %"PRIu32" blocks, head block %"PRIu32" page %"PRIu32, log->num_blocks, log->head,
+             log->head_page);
+    return ESP_OK;
+}
+
+esp_err_t nand_log_open(spi_nand_flash_device_t *flash, nand_log_t **log_out)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(LOG_PARTITION_BLOCKS > 0, ESP_ERR_NOT_SUPPORTED, TAG, "log partition disabled");
+    ESP_RETURN_ON_FALSE(flash != NULL && log_out != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    nand_log_t *log = calloc(1, sizeof(nand_log_t));
+    ESP_RETURN_ON_FALSE(log != NULL, ESP_ERR_NO_MEM, TAG, "nomem");
+    log->handle = flash;
+    log->num_blocks = LOG_PARTITION_BLOCKS;
+    // Between the blocks of dhara and the fast mount block, see dhara_init()
+    log->first_block = flash->chip.num_blocks - LOG_PARTITION_BLOCKS;
+#if CONFIG_NAND_FLASH_FAST_MOUNT
+    log->first_block--;
+#endif
+    log->block_seq = calloc(log->num_blocks, sizeof(uint32_t));
+    log->page_buffer = heap_caps_malloc(flash->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    log->read_buffer = heap_caps_malloc(flash->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    ESP_GOTO_ON_FALSE(log->block_seq != NULL && log->page_buffer != NULL && log->read_buffer != NULL, ESP_ERR_NO_MEM,
+                      fail, TAG, "nomem");
+
+    xSemaphoreTake(flash->mutex, portMAX_DELAY);
+    ret = scan(log);
+    xSemaphoreGive(flash->mutex);
+    ESP_GOTO_ON_ERROR(ret, fail, TAG, "failed to scan the log partition");
+
+    *log_out = log;
+    return ESP_OK;
+
+fail:
+    nand_log_close(log);
+    return ret;
+}
+
+void nand_log_close(nand_log_t *log)
+{
+    if (log == NULL) {
+        return;
+    }
+    free(log->block_seq);
+    free(log->page_buffer);
+    free(log->read_buffer);
+    free(log);
+}
+
+esp_err_t nand_log_append(nand_log_t *log, const void *data, size_t length)
+{
+    esp_err_t ret = ESP_OK;
+    const uint8_t *src = data;
+    const uint32_t data_size = page_data_size(log);
+
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    while (length > 0) {
+        size_t chunk = data_size - log->page_fill;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(log->page_buffer + sizeof(log_page_header_t) + log->page_fill, src, chunk);
+        log->page_fill += chunk;
+        src += chunk;
+        length -= chunk;
+        if (log->page_fill == data_size) {
+            ESP_GOTO_ON_ERROR(program_page(log), end, TAG, "");
+        }
+    }
+end:
+    xSemaphoreGive(log->handle->mutex);
+    return ret;
+}
+
+esp_err_t nand_log_flush(nand_log_t *log)
+{
+    esp_err_t ret = ESP_OK;
+
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    if (log->page_fill > 0) {
+        ret = program_page(log);
+    }
+    xSemaphoreGive(log->handle->mutex);
+    return ret;
+}
+
+void nand_log_rewind(nand_log_t *log, nand_log_cursor_t *cursor)
+{
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    uint32_t oldest = find_block(log, 0);
+    cursor->seq = (oldest == LOG_NO_BLOCK) ? log->next_seq : log->block_seq[oldest];
+    cursor->page = 0;
+    cursor->offset = 0;
+    xSemaphoreGive(log->handle->mutex);
+}
+
+esp_err_t nand_log_read(nand_log_t *log, nand_log_cursor_t *cursor, void *buffer, size_t size, size_t *read_len)
+{
+    esp_err_t ret = ESP_OK;
+    const uint32_t pages_per_block = 1 << log->handle->chip.log2_ppb;
+    const log_page_header_t *header = (const log_page_header_t *)log->read_buffer;
+    uint8_t *dst = buffer;
+    size_t done = 0;
+
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    while (done < size) {
+        uint32_t block = find_block(log, cursor->seq);
+        if (block == LOG_NO_BLOCK) {
+            break;
+        }
+        if (log->block_seq[block] != cursor->seq) {
+            // Erased since, or the cursor reached the end of its block
+            cursor->seq = log->block_seq[block];
+            cursor->page = 0;
+            cursor->offset = 0;
+        }
+        if (cursor->page == pages_per_block) {
+            cursor->seq++;
+            cursor->page = 0;
+            cursor->offset = 0;
+            continue;
+        }
+        if (block == log->head && cursor->page >= log->head_page) {
+            break;
+        }
+        ret = nand_read(log->handle, block_page(log, block, cursor->page), 0, log->handle->chip.page_size,
+                        log->read_buffer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "failed to read block %"PRIu32" page %"PRIu32, log->first_block + block, cursor->page);
+            cursor->page++;
+            cursor->offset = 0;
+            break;
+        }
+        if (header->magic != LOG_PAGE_MAGIC || header->seq != cursor->seq) {
+            // Rest of a block the writer left early
+            cursor->page = pages_per_block;
+            continue;
+        }
+        size_t chunk = (header->length > cursor->offset) ? header->length - cursor->offset : 0;
+        if (chunk > size - done) {
+            chunk = size - done;
+        }
+        memcpy(dst + done, log->read_buffer + sizeof(log_page_header_t) + cursor->offset, chunk);
+        done += chunk;
+        cursor->offset += chunk;
+        if (cursor->offset >= header->length) {
+            cursor->page++;
+            cursor->offset = 0;
+        }
+    }
+    xSemaphoreGive(log->handle->mutex);
+    *read_len = done;
+    return ret;
+}
+
+esp_err_t nand_log_get_info(nand_log_t *log, nand_log_info_t *info)
+{
+    ESP_RETURN_ON_FALSE(info != NULL, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const uint32_t pages_per_block = 1 << log->handle->chip.log2_ppb;
+
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    memset(info, 0, sizeof(nand_log_info_t));
+    info->num_blocks = log->num_blocks;
+    info->page_data_size = page_data_size(log);
+    for (uint32_t b = 0; b < log->num_blocks; b++) {
+        if (log->block_seq[b] == LOG_SEQ_BAD) {
+            info->bad_blocks++;
+        } else if (log->block_seq[b] != LOG_SEQ_FREE) {
+            info->used_pages += (b == log->head) ? log->head_page : pages_per_block;
+        }
+    }
+    xSemaphoreGive(log->handle->mutex);
+    return ESP_OK;
+}
+
+esp_err_t nand_log_erase(nand_log_t *log)
+{
+    xSemaphoreTake(log->handle->mutex, portMAX_DELAY);
+    for (uint32_t b = 0; b < log->num_blocks; b++) {
+        if (log->block_seq[b] == LOG_SEQ_BAD) {
+            continue;
+        }
+        if (nand_erase_block(log->handle, log->first_block + b) != ESP_OK) {
+            retire_block(log, b);
+            continue;
+        }
+        log->block_seq[b] = LOG_SEQ_FREE;
+    }
+    log->head = LOG_NO_BLOCK;
+    log->page_fill = 0;
+    xSemaphoreGive(log->handle->mutex);
+    return ESP_OK;
+}
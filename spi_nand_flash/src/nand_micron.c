@@ -30,6 +30,7 @@ esp_err_t spi_nand_micron_init(spi_nand_flash_device_t *dev)
     dev->chip.quad_enable_bit_pos = 0;
     dev->chip.ecc_data.ecc_status_reg_len_in_bits = 3;
     dev->chip.erase_block_delay_us = 2000;
+    dev->chip.flags = NAND_FLAG_HAS_CACHE_READ;
     ESP_LOGD(TAG, "%s: device_id: %x\n", __func__, device_id);
     switch (device_id) {
     case MICRON_DI_34:
@@ -53,7 +54,7 @@ esp_err_t spi_nand_micron_init(spi_nand_flash_device_t *dev)
         dev->chip.num_blocks = 2048;
         dev->chip.log2_ppb = 6;        // 64 pages per block
         dev->chip.log2_page_size = 11; // 2048 bytes per page
-        dev->chip.flags = NAND_FLAG_HAS_PROG_PLANE_SELECT | NAND_FLAG_HAS_READ_PLANE_SELECT;
+        dev->chip.flags |= NAND_FLAG_HAS_PROG_PLANE_SELECT | NAND_FLAG_HAS_READ_PLANE_SELECT;
         dev->chip.num_planes = 2;
         break;
     default:
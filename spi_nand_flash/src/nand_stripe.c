@@ -0,0 +1,308 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <sys/param.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "spi_nand_flash.h"
+#include "nand.h"
+
+static const char *TAG = "nand_stripe";
+
+#define STRIPE_TASK_STACK_SIZE  3072
+
+typedef enum {
+    STRIPE_OP_READ,
+    STRIPE_OP_WRITE,
+    STRIPE_OP_SYNC,
+} stripe_op_t;
+
+/* Multi-sector request on the striped device, each member runs its share of it */
+typedef struct {
+    stripe_op_t op;
+    uint8_t *buffer;
+    uint32_t start_sector;
+    uint32_t sector_count;
+} stripe_request_t;
+
+/* Sector n of the striped device is sector n / NAND_STRIPE_WIDTH of member n % NAND_STRIPE_WIDTH */
+typedef struct {
+    spi_nand_flash_device_t *members[NAND_STRIPE_WIDTH];
+    uint32_t member_capacity;           // smallest capacity of the members, in sectors
+    uint8_t *copy_buffer;               // copy_sector() between two members
+    TaskHandle_t task;                  // runs the share of member 1 while the caller runs the share of member 0
+    SemaphoreHandle_t task_done;
+    stripe_request_t request;
+    esp_err_t task_result;
+} nand_stripe_t;
+
+static inline nand_stripe_t *stripe_of(spi_nand_flash_device_t *handle)
+{
+    return (nand_stripe_t *)handle->ops_priv_data;
+}
+
+/* Runs the sectors of the request which belong to the member */
+static esp_err_t stripe_run_member(nand_stripe_t *stripe, uint32_t member, const stripe_request_t *request,
+                                   uint32_t sector_size)
+{
+    spi_nand_flash_device_t *dev = stripe->members[member];
+    if (request->op == STRIPE_OP_SYNC) {
+        return spi_nand_flash_sync(dev);
+    }
+
+    uint32_t end = request->start_sector + request->sector_count;
+    uint32_t sector = request->start_sector + (member + NAND_STRIPE_WIDTH - request->start_sector % NAND_STRIPE_WIDTH) %
+                      NAND_STRIPE_WIDTH;
+    for (; sector < end; sector += NAND_STRIPE_WIDTH) {
+        uint8_t *buffer = request->buffer + (sector - request->start_sector) * sector_size;
+        if (request->op == STRIPE_OP_READ) {
+            ESP_RETURN_ON_ERROR(spi_nand_flash_read_sector(dev, buffer, sector / NAND_STRIPE_WIDTH), TAG, "");
+        } else {
+            ESP_RETURN_ON_ERROR(spi_nand_flash_write_sector(dev, buffer, sector / NAND_STRIPE_WIDTH), TAG, "");
+        }
+    }
+    return ESP_OK;
+}
+
+static void stripe_task(void *arg)
+{
+    spi_nand_flash_device_t *handle = (spi_nand_flash_device_t *)arg;
+    nand_stripe_t *stripe = stripe_of(handle);
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stripe->task_result = stripe_run_member(stripe, 1, &stripe->request, handle->chip.page_size);
+        xSemaphoreGive(stripe->task_done);
+    }
+}
+
+/* Runs the request on both members at once, called with the mutex of the striped device held */
+static esp_err_t stripe_run(spi_nand_flash_device_t *handle, const stripe_request_t *request)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+
+    if (request->op != STRIPE_OP_SYNC) {
+        ESP_RETURN_ON_FALSE(request->start_sector < NAND_STRIPE_WIDTH * stripe->member_capacity &&
+                            request->sector_count <= NAND_STRIPE_WIDTH * stripe->member_capacity - request->start_sector,
+                            ESP_ERR_INVALID_ARG, TAG, "sectors out of range");
+        if (request->sector_count == 1) {
+            // Not worth waking up the task
+            return stripe_run_member(stripe, request->start_sector % NAND_STRIPE_WIDTH, request, handle->chip.page_size);
+        }
+    }
+
+    stripe->request = *request;
+    xTaskNotifyGive(stripe->task);
+    esp_err_t ret = stripe_run_member(stripe, 0, request, handle->chip.page_size);
+    xSemaphoreTake(stripe->task_done, portMAX_DELAY);
+    return ret != ESP_OK ? ret : stripe->task_result;
+}
+
+static esp_err_t stripe_init(spi_nand_flash_device_t *handle)
+{
+    return ESP_OK;
+}
+
+// spi_nand_erase_chip() on the members already resets their flash translation layer
+static esp_err_t stripe_deinit(spi_nand_flash_device_t *handle)
+{
+    return ESP_OK;
+}
+
+static esp_err_t stripe_read(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id)
+{
+    return stripe_run(handle, &(stripe_request_t) {
+        .op = STRIPE_OP_READ, .buffer = buffer, .start_sector = sector_id, .sector_count = 1
+    });
+}
+
+static esp_err_t stripe_read_partial(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t sector_id,
+                                     uint32_t offset, uint32_t length)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+    ESP_RETURN_ON_FALSE(sector_id < NAND_STRIPE_WIDTH * stripe->member_capacity, ESP_ERR_INVALID_ARG, TAG,
+                        "sector out of range");
+    return spi_nand_flash_read_partial(stripe->members[sector_id % NAND_STRIPE_WIDTH], buffer,
+                                       sector_id / NAND_STRIPE_WIDTH, offset, length);
+}
+
+static esp_err_t stripe_write(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t sector_id)
+{
+    return stripe_run(handle, &(stripe_request_t) {
+        .op = STRIPE_OP_WRITE, .buffer = (uint8_t *)buffer, .start_sector = sector_id, .sector_count = 1
+    });
+}
+
+static esp_err_t stripe_read_sectors(spi_nand_flash_device_t *handle, uint8_t *buffer, uint32_t start_sector,
+                                     uint32_t sector_count)
+{
+    return stripe_run(handle, &(stripe_request_t) {
+        .op = STRIPE_OP_READ, .buffer = buffer, .start_sector = start_sector, .sector_count = sector_count
+    });
+}
+
+static esp_err_t stripe_write_sectors(spi_nand_flash_device_t *handle, const uint8_t *buffer, uint32_t start_sector,
+                                      uint32_t sector_count)
+{
+    return stripe_run(handle, &(stripe_request_t) {
+        .op = STRIPE_OP_WRITE, .buffer = (uint8_t *)buffer, .start_sector = start_sector, .sector_count = sector_count
+    });
+}
+
+static esp_err_t stripe_erase_chip(spi_nand_flash_device_t *handle)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+    for (uint32_t i = 0; i < NAND_STRIPE_WIDTH; i++) {
+        ESP_RETURN_ON_ERROR(spi_nand_erase_chip(stripe->members[i]), TAG, "");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stripe_erase_block(spi_nand_flash_device_t *handle, uint32_t block)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t stripe_trim(spi_nand_flash_device_t *handle, uint32_t sector_id)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+    ESP_RETURN_ON_FALSE(sector_id < NAND_STRIPE_WIDTH * stripe->member_capacity, ESP_ERR_INVALID_ARG, TAG,
+                        "sector out of range");
+    return spi_nand_flash_trim(stripe->members[sector_id % NAND_STRIPE_WIDTH], sector_id / NAND_STRIPE_WIDTH);
+}
+
+static esp_err_t stripe_trim_range(spi_nand_flash_device_t *handle, uint32_t start_sector, uint32_t sector_count)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+    uint32_t end = start_sector + sector_count;
+    for (uint32_t i = 0; i < NAND_STRIPE_WIDTH; i++) {
+        // First sector of the range on the member, then every NAND_STRIPE_WIDTH sectors
+        uint32_t first = start_sector + (i + NAND_STRIPE_WIDTH - start_sector % NAND_STRIPE_WIDTH) % NAND_STRIPE_WIDTH;
+        if (first < end) {
+            ESP_RETURN_ON_ERROR(spi_nand_flash_trim_range(stripe->members[i], first / NAND_STRIPE_WIDTH,
+                                                          (end - 1 - first) / NAND_STRIPE_WIDTH + 1), TAG, "");
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stripe_sync(spi_nand_flash_device_t *handle)
+{
+    return stripe_run(handle, &(stripe_request_t) {
+        .op = STRIPE_OP_SYNC
+    });
+}
+
+static esp_err_t stripe_copy_sector(spi_nand_flash_device_t *handle, uint32_t src_sec, uint32_t dst_sec)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+    ESP_RETURN_ON_FALSE(src_sec < NAND_STRIPE_WIDTH * stripe->member_capacity &&
+                        dst_sec < NAND_STRIPE_WIDTH * stripe->member_capacity, ESP_ERR_INVALID_ARG, TAG,
+                        "sector out of range");
+    if (src_sec % NAND_STRIPE_WIDTH == dst_sec % NAND_STRIPE_WIDTH) {
+        return spi_nand_flash_copy_sector(stripe->members[src_sec % NAND_STRIPE_WIDTH], src_sec / NAND_STRIPE_WIDTH,
+                                          dst_sec / NAND_STRIPE_WIDTH);
+    }
+    ESP_RETURN_ON_ERROR(spi_nand_flash_read_sector(stripe->members[src_sec % NAND_STRIPE_WIDTH], stripe->copy_buffer,
+                                                   src_sec / NAND_STRIPE_WIDTH), TAG, "");
+    return spi_nand_flash_write_sector(stripe->members[dst_sec % NAND_STRIPE_WIDTH], stripe->copy_buffer,
+                                       dst_sec / NAND_STRIPE_WIDTH);
+}
+
+static esp_err_t stripe_get_capacity(spi_nand_flash_device_t *handle, uint32_t *number_of_sectors)
+{
+    *number_of_sectors = NAND_STRIPE_WIDTH * stripe_of(handle)->member_capacity;
+    return ESP_OK;
+}
+
+const spi_nand_ops nand_stripe_ops = {
+    .init = &stripe_init,
+    .deinit = &stripe_deinit,
+    .read = &stripe_read,
+    .read_partial = &stripe_read_partial,
+    .write = &stripe_write,
+    .read_sectors = &stripe_read_sectors,
+    .write_sectors = &stripe_write_sectors,
+    .erase_chip = &stripe_erase_chip,
+    .erase_block = &stripe_erase_block,
+    .trim = &stripe_trim,
+    .trim_range = &stripe_trim_range,
+    .sync = &stripe_sync,
+    .copy_sector = &stripe_copy_sector,
+    .get_capacity = &stripe_get_capacity,
+};
+
+esp_err_t spi_nand_flash_init_striped_device(spi_nand_flash_device_t *member0, spi_nand_flash_device_t *member1,
+                                             spi_nand_flash_device_t **handle)
+{
+    ESP_RETURN_ON_FALSE(member0 != NULL && member1 != NULL && member0 != member1 && handle != NULL,
+                        ESP_ERR_INVALID_ARG, TAG, "two different devices are needed");
+    ESP_RETURN_ON_FALSE(member0->chip.page_size == member1->chip.page_size, ESP_ERR_INVALID_ARG, TAG,
+                        "the devices must have the same sector size");
+
+    esp_err_t ret = ESP_OK;
+    spi_nand_flash_device_t *dev = calloc(1, sizeof(spi_nand_flash_device_t));
+    nand_stripe_t *stripe = calloc(1, sizeof(nand_stripe_t));
+    ESP_GOTO_ON_FALSE(dev != NULL && stripe != NULL, ESP_ERR_NO_MEM, fail, TAG, "nomem");
+
+    stripe->members[0] = member0;
+    stripe->members[1] = member1;
+    uint32_t capacity0, capacity1;
+    ESP_GOTO_ON_ERROR(spi_nand_flash_get_capacity(member0, &capacity0), fail, TAG, "");
+    ESP_GOTO_ON_ERROR(spi_nand_flash_get_capacity(member1, &capacity1), fail, TAG, "");
+    stripe->member_capacity = MIN(capacity0, capacity1);
+
+    stripe->copy_buffer = heap_caps_malloc(member0->chip.page_size, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    stripe->task_done = xSemaphoreCreateBinary();
+    dev->mutex = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(stripe->copy_buffer != NULL && stripe->task_done != NULL && dev->mutex != NULL,
+                      ESP_ERR_NO_MEM, fail, TAG, "nomem");
+
+    // The geometry reported by spi_nand_flash_get_*() is the one of both chips together
+    dev->chip = member0->chip;
+    dev->chip.num_blocks = member0->chip.num_blocks + member1->chip.num_blocks;
+    dev->ops = &nand_stripe_ops;
+    dev->ops_priv_data = stripe;
+
+    ESP_GOTO_ON_FALSE(xTaskCreate(stripe_task, "nand_stripe", STRIPE_TASK_STACK_SIZE, dev,
+                                  CONFIG_NAND_FLASH_STRIPE_TASK_PRIORITY, &stripe->task) == pdPASS,
+                      ESP_ERR_NO_MEM, fail, TAG, "Failed to create the stripe task");
+    *handle = dev;
+    return ESP_OK;
+
+fail:
+    if (stripe) {
+        free(stripe->copy_buffer);
+        if (stripe->task_done) {
+            vSemaphoreDelete(stripe->task_done);
+        }
+    }
+    if (dev && dev->mutex) {
+        vSemaphoreDelete(dev->mutex);
+    }
+    free(stripe);
+    free(dev);
+    return ret;
+}
+
+esp_err_t nand_stripe_deinit_device(spi_nand_flash_device_t *handle)
+{
+    nand_stripe_t *stripe = stripe_of(handle);
+
+    // The task only runs while the caller holds the mutex, so it is waiting for a request once the mutex is taken
+    xSemaphoreTake(handle->mutex, portMAX_DELAY);
+    vTaskDelete(stripe->task);
+    xSemaphoreGive(handle->mutex);
+    vSemaphoreDelete(stripe->task_done);
+    free(stripe->copy_buffer);
+    free(stripe);
+    vSemaphoreDelete(handle->mutex);
+    free(handle);
+    return ESP_OK;
+}
@@ -10,7 +10,7 @@
 #include "spi_nand_oper.h"
 #include "driver/spi_master.h"
 
-esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction)
+static void s_build_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction, spi_transaction_ext_t *e)
 {
     uint8_t half_duplex = handle->config.flags & SPI_DEVICE_HALFDUPLEX;
     if (!half_duplex) {
@@ -19,7 +19,7 @@ esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand
         transaction->mosi_len = len;
     }
 
-    spi_transaction_ext_t e = {
+    *e = (spi_transaction_ext_t) {
         .base = {
             .flags = SPI_TRANS_VARIABLE_ADDR |  SPI_TRANS_VARIABLE_CMD |  SPI_TRANS_VARIABLE_DUMMY | transaction->flags,
             .rxlength = transaction->miso_len * 8,
@@ -36,11 +36,17 @@ esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand
 
     if (transaction->flags == SPI_TRANS_USE_TXDATA) {
         assert(transaction->mosi_len <= 4 && "SPI_TRANS_USE_TXDATA used for a long transaction");
-        memcpy(e.base.tx_data, transaction->mosi_data, transaction->mosi_len);
+        memcpy(e->base.tx_data, transaction->mosi_data, transaction->mosi_len);
     }
     if (transaction->flags == SPI_TRANS_USE_RXDATA) {
         assert(transaction->miso_len <= 4 && "SPI_TRANS_USE_RXDATA used for a long transaction");
     }
+}
+
+esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction)
+{
+    spi_transaction_ext_t e;
+    s_build_transaction(handle, transaction, &e);
 
     esp_err_t ret = spi_device_transmit(handle->config.device_handle, (spi_transaction_t *) &e);
     if (ret == ESP_OK) {
@@ -51,6 +57,44 @@ esp_err_t spi_nand_execute_transaction(spi_nand_flash_device_t *handle, spi_nand
     return ret;
 }
 
+esp_err_t spi_nand_queue_transaction(spi_nand_flash_device_t *handle, spi_nand_transaction_t *transaction)
+{
+    // Only DMA transfers are worth queueing, the result of the short register accesses is always needed immediately
+    assert(!(transaction->flags & (SPI_TRANS_USE_RXDATA | SPI_TRANS_USE_TXDATA)));
+    if (handle->async.trans_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_build_transaction(handle, transaction, &handle->async.trans);
+    esp_err_t ret = spi_device_queue_trans(handle->config.device_handle, (spi_transaction_t *) &handle->async.trans, portMAX_DELAY);
+    if (ret == ESP_OK) {
+        handle->async.trans_pending = true;
+    }
+    return ret;
+}
+
+esp_err_t spi_nand_finish_transaction(spi_nand_flash_device_t *handle, TickType_t timeout)
+{
+    if (!handle->async.trans_pending) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    spi_transaction_t *done;
+    esp_err_t ret = spi_device_get_trans_result(handle->config.device_handle, &done, timeout);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    assert(done == (spi_transaction_t *) &handle->async.trans);
+    handle->async.trans_pending = false;
+
+    if (handle->async.rx_copy_dst) {
+        // Full-duplex reads go through temp_buffer, skip the dummy byte clocked in while the address was sent
+        memcpy(handle->async.rx_copy_dst, handle->temp_buffer + 1, handle->async.rx_copy_len);
+        handle->async.rx_copy_dst = NULL;
+    }
+    return ESP_OK;
+}
+
 esp_err_t spi_nand_read_register(spi_nand_flash_device_t *handle, uint8_t reg, uint8_t *val)
 {
     spi_nand_transaction_t t = {
@@ -99,7 +143,25 @@ esp_err_t spi_nand_read_page(spi_nand_flash_device_t *handle, uint32_t page)
     return spi_nand_execute_transaction(handle, &t);
 }
 
-static esp_err_t spi_nand_quad_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
+esp_err_t spi_nand_read_cache_sequential(spi_nand_flash_device_t *handle)
+{
+    spi_nand_transaction_t  t = {
+        .command = CMD_READ_CACHE_SEQ
+    };
+
+    return spi_nand_execute_transaction(handle, &t);
+}
+
+esp_err_t spi_nand_read_cache_last(spi_nand_flash_device_t *handle)
+{
+    spi_nand_transaction_t  t = {
+        .command = CMD_READ_CACHE_LAST
+    };
+
+    return spi_nand_execute_transaction(handle, &t);
+}
+
+static void spi_nand_quad_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length, spi_nand_transaction_t *t)
 {
     uint32_t spi_flags = SPI_TRANS_MODE_QIO;
     uint8_t cmd = CMD_READ_X4;
@@ -111,7 +173,7 @@ static esp_err_t spi_nand_quad_read(spi_nand_flash_device_t *handle, uint8_t *da
         dummy_bits = 4;
     }
 
-    spi_nand_transaction_t  t = {
+    *t = (spi_nand_transaction_t) {
         .command = cmd,
         .address_bytes = 2,
         .address = column,
@@ -122,12 +184,11 @@ static esp_err_t spi_nand_quad_read(spi_nand_flash_device_t *handle, uint8_t *da
     };
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
-    t.flags |= SPI_TRANS_DMA_BUFFER_ALIGN_MANUAL;
+    t->flags |= SPI_TRANS_DMA_BUFFER_ALIGN_MANUAL;
 #endif
-    return spi_nand_execute_transaction(handle, &t);
 }
 
-static esp_err_t spi_nand_dual_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
+static void spi_nand_dual_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length, spi_nand_transaction_t *t)
 {
     uint32_t spi_flags = SPI_TRANS_MODE_DIO;
     uint8_t cmd = CMD_READ_X2;
@@ -139,7 +200,7 @@ static esp_err_t spi_nand_dual_read(spi_nand_flash_device_t *handle, uint8_t *da
         dummy_bits = 4;
     }
 
-    spi_nand_transaction_t  t = {
+    *t = (spi_nand_transaction_t) {
         .command = cmd,
         .address_bytes = 2,
         .address = column,
@@ -150,12 +211,12 @@ static esp_err_t spi_nand_dual_read(spi_nand_flash_device_t *handle, uint8_t *da
     };
 
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
-    t.flags |= SPI_TRANS_DMA_BUFFER_ALIGN_MANUAL;
+    t->flags |= SPI_TRANS_DMA_BUFFER_ALIGN_MANUAL;
 #endif
-    return spi_nand_execute_transaction(handle, &t);
 }
 
-static esp_err_t spi_nand_fast_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
+// Returns true if the data is received into temp_buffer and must be copied to `data` once the transaction is done
+static bool spi_nand_fast_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length, spi_nand_transaction_t *t)
 {
     uint8_t *data_read = NULL;
     uint16_t data_read_len;
@@ -167,7 +228,7 @@ static esp_err_t spi_nand_fast_read(spi_nand_flash_device_t *handle, uint8_t *da
         data_read_len = length + 1;
         data_read = handle->temp_buffer;
     }
-    spi_nand_transaction_t  t = {
+    *t = (spi_nand_transaction_t) {
         .command = CMD_READ_FAST,
         .address_bytes = 2,
         .address = column,
@@ -179,27 +240,52 @@ static esp_err_t spi_nand_fast_read(spi_nand_flash_device_t *handle, uint8_t *da
     };
 
     if (half_duplex) {
-        t.dummy_bits = 8;
+        t->dummy_bits = 8;
     }
-    esp_err_t ret = spi_nand_execute_transaction(handle, &t);
-    if (ret != ESP_OK) {
-        goto fail;
+    return !half_duplex;
+}
+
+static bool spi_nand_prepare_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length, spi_nand_transaction_t *t)
+{
+    if (handle->config.io_mode == SPI_NAND_IO_MODE_DOUT || handle->config.io_mode == SPI_NAND_IO_MODE_DIO) {
+        spi_nand_dual_read(handle, data, column, length, t);
+        return false;
+    } else if (handle->config.io_mode == SPI_NAND_IO_MODE_QOUT || handle->config.io_mode == SPI_NAND_IO_MODE_QIO) {
+        spi_nand_quad_read(handle, data, column, length, t);
+        return false;
     }
-    if (!half_duplex) {
-        memcpy(data, data_read + 1, length);
+    return spi_nand_fast_read(handle, data, column, length, t);
+}
+
+esp_err_t spi_nand_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
+{
+    spi_nand_transaction_t t;
+    bool copy_from_temp = spi_nand_prepare_read(handle, data, column, length, &t);
+
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.bytes_read += length;
+#endif
+    esp_err_t ret = spi_nand_execute_transaction(handle, &t);
+    if (ret == ESP_OK && copy_from_temp) {
+        memcpy(data, handle->temp_buffer + 1, length);
     }
-fail:
     return ret;
 }
 
-esp_err_t spi_nand_read(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
+esp_err_t spi_nand_read_start(spi_nand_flash_device_t *handle, uint8_t *data, uint16_t column, uint16_t length)
 {
-    if (handle->config.io_mode == SPI_NAND_IO_MODE_DOUT || handle->config.io_mode == SPI_NAND_IO_MODE_DIO) {
-        return spi_nand_dual_read(handle, data, column, length);
-    } else if (handle->config.io_mode == SPI_NAND_IO_MODE_QOUT || handle->config.io_mode == SPI_NAND_IO_MODE_QIO) {
-        return spi_nand_quad_read(handle, data, column, length);
+    spi_nand_transaction_t t;
+    bool copy_from_temp = spi_nand_prepare_read(handle, data, column, length, &t);
+
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.bytes_read += length;
+#endif
+    esp_err_t ret = spi_nand_queue_transaction(handle, &t);
+    if (ret == ESP_OK && copy_from_temp) {
+        handle->async.rx_copy_dst = data;
+        handle->async.rx_copy_len = length;
     }
-    return spi_nand_fast_read(handle, data, column, length);
+    return ret;
 }
 
 esp_err_t spi_nand_program_execute(spi_nand_flash_device_t *handle, uint32_t page)
@@ -213,7 +299,8 @@ esp_err_t spi_nand_program_execute(spi_nand_flash_device_t *handle, uint32_t pag
     return spi_nand_execute_transaction(handle, &t);
 }
 
-esp_err_t spi_nand_program_load(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length)
+static void s_program_load(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length,
+                           spi_nand_transaction_t *t)
 {
     uint8_t cmd = CMD_PROGRAM_LOAD;
     uint32_t spi_flags = 0;
@@ -222,7 +309,7 @@ esp_err_t spi_nand_program_load(spi_nand_flash_device_t *handle, const uint8_t *
         spi_flags = SPI_TRANS_MODE_QIO;
     }
 
-    spi_nand_transaction_t  t = {
+    *t = (spi_nand_transaction_t) {
         .command = cmd,
         .address_bytes = 2,
         .address = column,
@@ -230,10 +317,27 @@ esp_err_t spi_nand_program_load(spi_nand_flash_device_t *handle, const uint8_t *
         .mosi_data = data,
         .flags = spi_flags,
     };
+#if CONFIG_NAND_FLASH_IO_STATS
+    handle->io_stats.bytes_written += length;
+#endif
+}
+
+esp_err_t spi_nand_program_load(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length)
+{
+    spi_nand_transaction_t t;
+    s_program_load(handle, data, column, length, &t);
 
     return spi_nand_execute_transaction(handle, &t);
 }
 
+esp_err_t spi_nand_program_load_start(spi_nand_flash_device_t *handle, const uint8_t *data, uint16_t column, uint16_t length)
+{
+    spi_nand_transaction_t t;
+    s_program_load(handle, data, column, length, &t);
+
+    return spi_nand_queue_transaction(handle, &t);
+}
+
 esp_err_t spi_nand_erase_block(spi_nand_flash_device_t *handle, uint32_t page)
 {
     spi_nand_transaction_t  t = {
@@ -26,8 +26,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include "ccronexpr.h"
+#include "cron_fast.h"
+#include "esp_timer.h"
 #include "sdkconfig.h"
 
 #define MAX_SECONDS 62
@@ -39,6 +42,9 @@
 
 #define DATE_FORMAT "%Y-%m-%d_%H:%M:%S"
 
+/* Times each next time is computed, for the comparison of cron_next() with cron_fast_next() */
+#define BENCH_REPEAT 16
+
 #ifndef ARRAY_LEN
 #define ARRAY_LEN(x) sizeof(x)/sizeof(x[0])
 #endif
@@ -162,6 +168,46 @@ void poors_mans_strptime(const char *str, struct tm *cal)
 
 typedef time_t (*cron_find_fn)(cron_expr *, time_t);
 
+static int64_t bench_next_us;
+static int64_t bench_fast_us;
+static int bench_lines;
+static int bench_fast_lines;
+
+/**
+ * Compare cron_fast_next() with cron_next() on the lines of the tests of cron_next(): both must find the same time,
+ * and the time they take is summed up, to be reported at the end
+ */
+static void check_fast_next(const char *pattern, time_t dateinit, time_t expected)
+{
+    const char *err = NULL;
+    cron_fast_expr_t fast;
+    cron_expr parsed;
+    cron_fast_parse_expr(pattern, &fast, &err);
+    assert(!err);
+    cron_parse_expr(pattern, &parsed, &err);
+
+    time_t datenext = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        datenext = cron_next(&parsed, dateinit);
+    }
+    bench_next_us += esp_timer_get_time() - start;
+    assert(datenext == expected);
+
+    start = esp_timer_get_time();
+    for (int i = 0; i < BENCH_REPEAT; i++) {
+        datenext = cron_fast_next(&fast, dateinit);
+    }
+    bench_fast_us += esp_timer_get_time() - start;
+    if (datenext != expected) {
+        printf("Pattern: %s\n", pattern);
+        printf("cron_fast_next: %lld, cron_next: %lld\n", (long long)datenext, (long long)expected);
+        assert(0);
+    }
+    bench_lines++;
+    bench_fast_lines += fast.simple;
+}
+
 int count_fields(const char *str, char del)
 {
     size_t count = 0;
@@ -191,6 +237,9 @@ void check_fn_line(cron_find_fn fn, const char *pattern, const char *initial, co
     time_t dateinit = cron_mktime(&calinit);
     assert(-1 != dateinit);
     time_t datenext = fn(&parsed1, dateinit);
+    if (fn == cron_next) {
+        check_fast_next(pattern, dateinit, datenext);
+    }
 #ifdef CRON_USE_LOCAL_TIME
     struct tm *calnext = localtime(&datenext);
 #else
@@ -899,5 +948,7 @@ void app_main(void)
     test_expr();
     test_parse();
     check_calc_invalid();
+    printf("\ncron_next() on %d lines: %" PRId64 " us, cron_fast_next(): %" PRId64 " us, %d lines with bit scans\n",
+           bench_lines, bench_next_us / BENCH_REPEAT, bench_fast_us / BENCH_REPEAT, bench_fast_lines);
     printf("\nAll OK!\n");
 }
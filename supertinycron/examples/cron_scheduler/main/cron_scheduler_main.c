@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "ccronexpr.h"
+#include "cron_scheduler.h"
+
+#define JOB_COUNT 1000
+#define RUN_TIME_S 30
+#define REPORT_PERIOD_S 10
+
+static const char *TAG = "cron_scheduler";
+
+static atomic_uint s_fired;
+
+static void on_job(cron_job_handle_t job, time_t fire_time, void *arg)
+{
+    atomic_fetch_add(&s_fired, 1);
+}
+
+static void job_expression(int i, char *buf, size_t size)
+{
+    // Every 1 to 59 seconds, one job every minute out of 10
+    if (i % 10 == 0) {
+        snprintf(buf, size, "%d * * * * *", i % 60);
+    } else {
+        snprintf(buf, size, "*/%d * * * * *", 1 + i % 59);
+    }
+}
+
+/* What an application without scheduler does on every tick: compute the next fire time of every job */
+static void measure_polling(void)
+{
+    cron_expr *exprs = calloc(JOB_COUNT, sizeof(cron_expr));
+    ESP_ERROR_CHECK(exprs ? ESP_OK : ESP_ERR_NO_MEM);
+    char expression[32];
+    for (int i = 0; i < JOB_COUNT; i++) {
+        const char *error = NULL;
+        job_expression(i, expression, sizeof(expression));
+        cron_parse_expr(expression, &exprs[i], &error);
+    }
+
+    time_t now = time(NULL);
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < JOB_COUNT; i++) {
+        cron_next(&exprs[i], now);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    ESP_LOGI(TAG, "Polling: cron_next() of %d jobs takes %" PRId64 " us per tick", JOB_COUNT, elapsed);
+    free(exprs);
+}
+
+void app_main(void)
+{
+    // The example has no network, start from a fixed date
+    struct timeval tv = { .tv_sec = 1735689600 }; // 2025-01-01 00:00:00 UTC
+    settimeofday(&tv, NULL);
+
+    measure_polling();
+
+    cron_scheduler_config_t config = { .initial_capacity = JOB_COUNT };
+    cron_scheduler_handle_t scheduler;
+    ESP_ERROR_CHECK(cron_scheduler_new(&config, &scheduler));
+
+    char expression[32];
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < JOB_COUNT; i++) {
+        job_expression(i, expression, sizeof(expression));
+        ESP_ERROR_CHECK(cron_scheduler_add_job(scheduler, expression, on_job, NULL, NULL));
+    }
+    ESP_LOGI(TAG, "Added %d jobs in %" PRId64 " us", JOB_COUNT, esp_timer_get_time() - start);
+
+    for (int t = REPORT_PERIOD_S; t <= RUN_TIME_S; t += REPORT_PERIOD_S) {
+        vTaskDelay(pdMS_TO_TICKS(REPORT_PERIOD_S * 1000));
+        cron_scheduler_stats_t stats;
+        ESP_ERROR_CHECK(cron_scheduler_get_stats(scheduler, &stats));
+        ESP_LOGI(TAG, "%d s: %u jobs fired, %" PRIu32 " wake-ups, %" PRIu32 " cron_next() calls, %zu jobs",
+                 t, atomic_load(&s_fired), stats.wakeups, stats.next_computed, stats.job_count);
+    }
+
+    ESP_ERROR_CHECK(cron_scheduler_del(scheduler));
+    ESP_LOGI(TAG, "Done");
+}
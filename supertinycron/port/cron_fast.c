@@ -0,0 +1,247 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stddef.h>
+#include <string.h>
+#include "cron_fast.h"
+
+/* Last year of the expressions, the later ones are left to cron_next() */
+#define CRON_FAST_MAX_YEAR 2199
+/* A day of the month exists at least every 8 years, e.g. February 29th from 2096 to 2104 */
+#define CRON_FAST_MAX_SEARCH_YEARS 8
+
+#define SECONDS_MASK ((UINT64_C(1) << 60) - 1)
+
+/* defined in ccronexpr.c, mktime() or timegm() */
+time_t cron_mktime(struct tm *tm);
+
+static uint64_t load_bits(const uint8_t *bytes, size_t len)
+{
+    uint64_t bits = 0;
+    for (size_t i = 0; i < len; i++) {
+        bits |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return bits;
+}
+
+/* Lowest bit set from `from` on, below `limit`, or -1 */
+static int next_bit(uint64_t bits, int from, int limit)
+{
+    if (from >= limit) {
+        return -1;
+    }
+    bits &= ~UINT64_C(0) << from;
+    if (limit < 64) {
+        bits &= (UINT64_C(1) << limit) - 1;
+    }
+    return bits ? __builtin_ctzll(bits) : -1;
+}
+
+static bool is_leap_year(int year)
+{
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+static int days_in_month(int year, int mon)
+{
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    return mon == 1 && is_leap_year(year) ? 29 : days[mon];
+}
+
+/* 0 for Sunday, Sakamoto's method */
+static int day_of_week(int year, int mon, int day)
+{
+    static const uint8_t offsets[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+    if (mon < 2) {
+        year--;
+    }
+    return (year + year / 4 - year / 100 + year / 400 + offsets[mon] + day) % 7;
+}
+
+/* Whether a field only has values, ranges, steps and names: no L, W, # nor H, which have their own bitmaps */
+static bool field_is_plain(const char *field, size_t len)
+{
+    size_t letters = 0;
+    for (size_t i = 0; i <= len; i++) {
+        char c = i < len ? field[i] : ' ';
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+            letters++;
+            continue;
+        }
+        if ((letters != 0 && letters != 3) || c == '#') {
+            return false;
+        }
+        letters = 0;
+    }
+    return true;
+}
+
+static bool field_is_any(const char *field, size_t len)
+{
+    return len == 1 && (field[0] == '*' || field[0] == '?');
+}
+
+static bool expression_is_plain(const char *expression)
+{
+    const char *fields[7];
+    size_t lens[7];
+    int count = 0;
+
+    for (const char *p = expression; *p;) {
+        if (*p == ' ' || *p == '\t') {
+            p++;
+            continue;
+        }
+        if (count == 7) {
+            return false;
+        }
+        fields[count] = p;
+        while (*p && *p != ' ' && *p != '\t') {
+            p++;
+        }
+        lens[count] = p - fields[count];
+        if (fields[count][0] == '@' || !field_is_plain(fields[count], lens[count])) {
+            return false;
+        }
+        count++;
+    }
+    if (count < 5) {
+        return false;
+    }
+    // The layout of the years is left to ccronexpr
+    return count < 7 || field_is_any(fields[6], lens[6]);
+}
+
+void cron_fast_parse_expr(const char *expression, cron_fast_expr_t *target, const char **error)
+{
+    const char *err = NULL;
+    memset(target, 0, sizeof(*target));
+    cron_parse_expr(expression, &target->expr, &err);
+    if (error) {
+        *error = err;
+    }
+    if (err || !expression_is_plain(expression)) {
+        return;
+    }
+
+    const cron_expr *expr = &target->expr;
+    uint64_t seconds = load_bits(expr->seconds, sizeof(expr->seconds));
+    uint8_t days_of_week = expr->days_of_week[0];
+    target->seconds = seconds & SECONDS_MASK;
+    target->minutes = load_bits(expr->minutes, sizeof(expr->minutes)) & SECONDS_MASK;
+    target->hours = load_bits(expr->hours, sizeof(expr->hours)) & 0xffffff;
+    target->days_of_month = load_bits(expr->days_of_month, sizeof(expr->days_of_month)) & 0xfffffffe;
+    target->months = load_bits(expr->months, sizeof(expr->months)) & 0xfff;
+    target->days_of_week = (days_of_week & 0x7f) | ((days_of_week >> 7) & 1); // 7 is Sunday too
+
+    // Leap seconds only happen in the "right/" time zones, which cron_next() handles
+    bool leap_seconds = (seconds & ~SECONDS_MASK) && target->seconds != SECONDS_MASK;
+    // Whether both days must match, or either, is left to cron_next()
+    bool any_day = target->days_of_month == 0xfffffffe || target->days_of_week == 0x7f;
+    target->simple = !leap_seconds && any_day && target->seconds && target->minutes && target->hours &&
+                     target->days_of_month && target->months && target->days_of_week;
+}
+
+/* First day from `day` on matching the days of the month and of the week, or -1 */
+static int next_day(const cron_fast_expr_t *expr, int year, int mon, int day)
+{
+    int last = days_in_month(year, mon);
+    if (day > last) {
+        return -1;
+    }
+    if (expr->days_of_week != 0x7f) {
+        // The week twice, so the scan wraps from Saturday to Sunday
+        uint32_t week = expr->days_of_week | ((uint32_t)expr->days_of_week << 7);
+        int next = day + __builtin_ctz(week >> day_of_week(year, mon, day));
+        return next <= last ? next : -1;
+    }
+    return next_bit(expr->days_of_month, day, last + 1);
+}
+
+static bool time_to_tm(time_t date, struct tm *tm)
+{
+#ifdef CRON_USE_LOCAL_TIME
+    return localtime_r(&date, tm) != NULL;
+#else
+    return gmtime_r(&date, tm) != NULL;
+#endif
+}
+
+time_t cron_fast_next(cron_fast_expr_t *expr, time_t date)
+{
+    struct tm tm;
+    if (!expr->simple || !time_to_tm(date + 1, &tm) || tm.tm_sec > 59) {
+        return cron_next(&expr->expr, date);
+    }
+
+    int year = tm.tm_year + 1900, mon = tm.tm_mon, day = tm.tm_mday;
+    int hour = tm.tm_hour, min = tm.tm_min, sec = tm.tm_sec;
+    const int isdst = tm.tm_isdst;
+    const int last_year = year + CRON_FAST_MAX_SEARCH_YEARS;
+    // From the largest field to the smallest, resetting the smaller ones when a field moves forward
+    for (;;) {
+        if (year > last_year || year > CRON_FAST_MAX_YEAR) {
+            return cron_next(&expr->expr, date);
+        }
+        int next = next_bit(expr->months, mon, 12);
+        if (next < 0) {
+            year++;
+            mon = 0, day = 1, hour = 0, min = 0, sec = 0;
+            continue;
+        }
+        if (next != mon) {
+            mon = next, day = 1, hour = 0, min = 0, sec = 0;
+        }
+        next = next_day(expr, year, mon, day);
+        if (next < 0) {
+            mon++;
+            day = 1, hour = 0, min = 0, sec = 0;
+            continue;
+        }
+        if (next != day) {
+            day = next, hour = 0, min = 0, sec = 0;
+        }
+        next = next_bit(expr->hours, hour, 24);
+        if (next < 0) {
+            day++;
+            hour = 0, min = 0, sec = 0;
+            continue;
+        }
+        if (next != hour) {
+            hour = next, min = 0, sec = 0;
+        }
+        next = next_bit(expr->minutes, min, 60);
+        if (next < 0) {
+            hour++;
+            min = 0, sec = 0;
+            continue;
+        }
+        if (next != min) {
+            min = next, sec = 0;
+        }
+        next = next_bit(expr->seconds, sec, 60);
+        if (next < 0) {
+            min++;
+            sec = 0;
+            continue;
+        }
+        sec = next;
+        break;
+    }
+
+    struct tm found = {
+        .tm_year = year - 1900, .tm_mon = mon, .tm_mday = day,
+        .tm_hour = hour, .tm_min = min, .tm_sec = sec,
+        .tm_isdst = -1,
+    };
+    time_t ret = cron_mktime(&found);
+    // A time skipped by daylight saving, or a change of daylight saving on the way, left to cron_next()
+    if (ret == CRON_INVALID_INSTANT || ret <= date || !time_to_tm(ret, &tm) || tm.tm_isdst != isdst ||
+            tm.tm_year != year - 1900 || tm.tm_mon != mon || tm.tm_mday != day || tm.tm_hour != hour ||
+            tm.tm_min != min || tm.tm_sec != sec) {
+        return cron_next(&expr->expr, date);
+    }
+    return ret;
+}
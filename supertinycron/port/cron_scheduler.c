@@ -0,0 +1,309 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "ccronexpr.h"
+#include "cron_fast.h"
+#include "cron_scheduler.h"
+
+static const char *TAG = "cron_scheduler";
+
+#define CRON_SCHEDULER_MIN_CAPACITY 8
+
+struct cron_job_t {
+    cron_fast_expr_t expr;
+    time_t next;        /* CRON_INVALID_INSTANT when the expression has no more fire time */
+    cron_job_cb_t callback;
+    void *arg;
+    size_t index;       /* Position in the heap */
+    bool running;       /* Callback being called, the job is freed after it if removed meanwhile */
+    bool removed;
+};
+
+struct cron_scheduler_t {
+    SemaphoreHandle_t lock;
+    esp_timer_handle_t timer;
+    struct cron_job_t **heap; /* Min-heap of the jobs by next fire time, the ones without fire time last */
+    size_t count;
+    size_t capacity;
+    cron_scheduler_stats_t stats;
+};
+
+static bool job_before(const struct cron_job_t *a, const struct cron_job_t *b)
+{
+    if (a->next == CRON_INVALID_INSTANT) {
+        return false;
+    }
+    return b->next == CRON_INVALID_INSTANT || a->next < b->next;
+}
+
+static void heap_set(cron_scheduler_handle_t scheduler, size_t i, struct cron_job_t *job)
+{
+    scheduler->heap[i] = job;
+    job->index = i;
+}
+
+static void heap_sift_up(cron_scheduler_handle_t scheduler, size_t i)
+{
+    struct cron_job_t *job = scheduler->heap[i];
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (!job_before(job, scheduler->heap[parent])) {
+            break;
+        }
+        heap_set(scheduler, i, scheduler->heap[parent]);
+        i = parent;
+    }
+    heap_set(scheduler, i, job);
+}
+
+static void heap_sift_down(cron_scheduler_handle_t scheduler, size_t i)
+{
+    struct cron_job_t *job = scheduler->heap[i];
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= scheduler->count) {
+            break;
+        }
+        if (child + 1 < scheduler->count && job_before(scheduler->heap[child + 1], scheduler->heap[child])) {
+            child++;
+        }
+        if (!job_before(scheduler->heap[child], job)) {
+            break;
+        }
+        heap_set(scheduler, i, scheduler->heap[child]);
+        i = child;
+    }
+    heap_set(scheduler, i, job);
+}
+
+static void heap_remove(cron_scheduler_handle_t scheduler, size_t i)
+{
+    scheduler->count--;
+    if (i == scheduler->count) {
+        return;
+    }
+    heap_set(scheduler, i, scheduler->heap[scheduler->count]);
+    if (i > 0 && job_before(scheduler->heap[i], scheduler->heap[(i - 1) / 2])) {
+        heap_sift_up(scheduler, i);
+    } else {
+        heap_sift_down(scheduler, i);
+    }
+}
+
+/* Next fire time strictly after the given time */
+static void job_compute_next(cron_scheduler_handle_t scheduler, struct cron_job_t *job, time_t after)
+{
+    job->next = cron_fast_next(&job->expr, after);
+    scheduler->stats.next_computed++;
+}
+
+/* Sleep until the earliest job, or CONFIG_CRON_SCHEDULER_MAX_SLEEP_S, called with the lock held */
+static void scheduler_arm(cron_scheduler_handle_t scheduler)
+{
+    esp_timer_stop(scheduler->timer); // fails if not running, which is fine
+    if (scheduler->count == 0 || scheduler->heap[0]->next == CRON_INVALID_INSTANT) {
+        return;
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    int64_t delay_us = ((int64_t)scheduler->heap[0]->next - now.tv_sec) * 1000000 - now.tv_usec;
+    if (delay_us > (int64_t)CONFIG_CRON_SCHEDULER_MAX_SLEEP_S * 1000000) {
+        delay_us = (int64_t)CONFIG_CRON_SCHEDULER_MAX_SLEEP_S * 1000000;
+    } else if (delay_us < 1) {
+        delay_us = 1;
+    }
+    esp_timer_start_once(scheduler->timer, delay_us);
+}
+
+static void scheduler_timer_cb(void *arg)
+{
+    cron_scheduler_handle_t scheduler = arg;
+
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    scheduler->stats.wakeups++;
+    // The jobs due so far, a job taking long doesn't make the others fire more than once
+    time_t now = time(NULL);
+    while (scheduler->count > 0) {
+        struct cron_job_t *job = scheduler->heap[0];
+        if (job->next == CRON_INVALID_INSTANT || job->next > now) {
+            break;
+        }
+        time_t fire_time = job->next;
+        job_compute_next(scheduler, job, now);
+        heap_sift_down(scheduler, 0);
+
+        job->running = true;
+        xSemaphoreGive(scheduler->lock);
+        job->callback(job, fire_time, job->arg);
+        xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+        job->running = false;
+        scheduler->stats.fired++;
+        if (job->removed) {
+            free(job);
+        }
+    }
+    scheduler_arm(scheduler);
+    xSemaphoreGive(scheduler->lock);
+}
+
+esp_err_t cron_scheduler_new(const cron_scheduler_config_t *config, cron_scheduler_handle_t *ret_scheduler)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config && ret_scheduler, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    cron_scheduler_handle_t scheduler = calloc(1, sizeof(struct cron_scheduler_t));
+    ESP_RETURN_ON_FALSE(scheduler, ESP_ERR_NO_MEM, TAG, "no mem for scheduler");
+    scheduler->capacity = config->initial_capacity > CRON_SCHEDULER_MIN_CAPACITY ? config->initial_capacity :
+                          CRON_SCHEDULER_MIN_CAPACITY;
+    scheduler->heap = calloc(scheduler->capacity, sizeof(struct cron_job_t *));
+    ESP_GOTO_ON_FALSE(scheduler->heap, ESP_ERR_NO_MEM, err, TAG, "no mem for jobs");
+    scheduler->lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(scheduler->lock, ESP_ERR_NO_MEM, err, TAG, "no mem for lock");
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = scheduler_timer_cb,
+        .arg = scheduler,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "cron_scheduler",
+    };
+    ESP_GOTO_ON_ERROR(esp_timer_create(&timer_args, &scheduler->timer), err, TAG, "create timer failed");
+
+    *ret_scheduler = scheduler;
+    return ESP_OK;
+
+err:
+    if (scheduler->lock) {
+        vSemaphoreDelete(scheduler->lock);
+    }
+    free(scheduler->heap);
+    free(scheduler);
+    return ret;
+}
+
+esp_err_t cron_scheduler_add_job(cron_scheduler_handle_t scheduler, const char *expression, cron_job_cb_t callback,
+                                 void *arg, cron_job_handle_t *ret_job)
+{
+    ESP_RETURN_ON_FALSE(scheduler && expression && callback, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    struct cron_job_t *job = calloc(1, sizeof(struct cron_job_t));
+    ESP_RETURN_ON_FALSE(job, ESP_ERR_NO_MEM, TAG, "no mem for job");
+    const char *error = NULL;
+    cron_fast_parse_expr(expression, &job->expr, &error);
+    if (error) {
+        free(job);
+        ESP_RETURN_ON_FALSE(false, ESP_ERR_INVALID_ARG, TAG, "invalid expression \"%s\": %s", expression, error);
+    }
+    job->callback = callback;
+    job->arg = arg;
+
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    if (scheduler->count == scheduler->capacity) {
+        struct cron_job_t **heap = realloc(scheduler->heap, 2 * scheduler->capacity * sizeof(struct cron_job_t *));
+        if (!heap) {
+            xSemaphoreGive(scheduler->lock);
+            free(job);
+            ESP_RETURN_ON_FALSE(false, ESP_ERR_NO_MEM, TAG, "no mem for jobs");
+        }
+        scheduler->heap = heap;
+        scheduler->capacity *= 2;
+    }
+    job_compute_next(scheduler, job, time(NULL));
+    heap_set(scheduler, scheduler->count++, job);
+    heap_sift_up(scheduler, job->index);
+    scheduler->stats.job_count++;
+    if (job->index == 0) {
+        scheduler_arm(scheduler);
+    }
+    xSemaphoreGive(scheduler->lock);
+
+    if (ret_job) {
+        *ret_job = job;
+    }
+    return ESP_OK;
+}
+
+esp_err_t cron_scheduler_remove_job(cron_scheduler_handle_t scheduler, cron_job_handle_t job)
+{
+    ESP_RETURN_ON_FALSE(scheduler && job, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    if (job->removed || job->index >= scheduler->count || scheduler->heap[job->index] != job) {
+        xSemaphoreGive(scheduler->lock);
+        ESP_RETURN_ON_FALSE(false, ESP_ERR_INVALID_ARG, TAG, "job not in scheduler");
+    }
+    bool was_first = job->index == 0;
+    heap_remove(scheduler, job->index);
+    scheduler->stats.job_count--;
+    if (job->running) {
+        job->removed = true; // freed once its callback returns
+    } else {
+        free(job);
+    }
+    if (was_first) {
+        scheduler_arm(scheduler);
+    }
+    xSemaphoreGive(scheduler->lock);
+    return ESP_OK;
+}
+
+esp_err_t cron_scheduler_get_next(cron_scheduler_handle_t scheduler, cron_job_handle_t job, time_t *ret_time)
+{
+    ESP_RETURN_ON_FALSE(scheduler && job && ret_time, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    *ret_time = job->next;
+    xSemaphoreGive(scheduler->lock);
+    return ESP_OK;
+}
+
+esp_err_t cron_scheduler_time_changed(cron_scheduler_handle_t scheduler)
+{
+    ESP_RETURN_ON_FALSE(scheduler, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    time_t now = time(NULL);
+    for (size_t i = 0; i < scheduler->count; i++) {
+        job_compute_next(scheduler, scheduler->heap[i], now);
+    }
+    // Bottom-up heap construction, O(n)
+    for (size_t i = scheduler->count / 2; i-- > 0;) {
+        heap_sift_down(scheduler, i);
+    }
+    scheduler_arm(scheduler);
+    xSemaphoreGive(scheduler->lock);
+    return ESP_OK;
+}
+
+esp_err_t cron_scheduler_get_stats(cron_scheduler_handle_t scheduler, cron_scheduler_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(scheduler && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    xSemaphoreTake(scheduler->lock, portMAX_DELAY);
+    *ret_stats = scheduler->stats;
+    xSemaphoreGive(scheduler->lock);
+    return ESP_OK;
+}
+
+esp_err_t cron_scheduler_del(cron_scheduler_handle_t scheduler)
+{
+    ESP_RETURN_ON_FALSE(scheduler, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    esp_timer_stop(scheduler->timer);
+    esp_timer_delete(scheduler->timer);
+    for (size_t i = 0; i < scheduler->count; i++) {
+        free(scheduler->heap[i]);
+    }
+    free(scheduler->heap);
+    vSemaphoreDelete(scheduler->lock);
+    free(scheduler);
+    return ESP_OK;
+}
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccronexpr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Cron expression with the bitmaps of its fields as words, for `cron_fast_next()`
+ */
+typedef struct {
+    cron_expr expr;         /*!< Parsed expression, as for `cron_next()` */
+    bool simple;            /*!< Whether `cron_fast_next()` can compute the next time from the words below */
+    uint64_t seconds;       /*!< Bit n for second n, 0 to 59 */
+    uint64_t minutes;       /*!< Bit n for minute n, 0 to 59 */
+    uint32_t hours;         /*!< Bit n for hour n, 0 to 23 */
+    uint32_t days_of_month; /*!< Bit n for day n, 1 to 31 */
+    uint16_t months;        /*!< Bit n for month n, 0 (January) to 11 */
+    uint8_t days_of_week;   /*!< Bit n for day n, 0 (Sunday) to 6 */
+} cron_fast_expr_t;
+
+/**
+ * @brief Parse a cron expression, as `cron_parse_expr()`, for `cron_fast_next()`
+ *
+ * @param expression Cron expression
+ * @param target Parsed expression
+ * @param error Returned error message, NULL on success, can be NULL
+ */
+void cron_fast_parse_expr(const char *expression, cron_fast_expr_t *target, const char **error);
+
+/**
+ * @brief Next time matching a cron expression after a given time, as `cron_next()`
+ *
+ * The fields of the expressions made only of values, ranges, steps and names, with the day of the month or of the
+ * week left to `*` or `?`, and without year, are searched from the largest to the smallest, each with a bit scan
+ * over the word of the field which jumps to the next value set, and the result is converted with a single
+ * `mktime()`. The other expressions, e.g. with `L`, `W` or `#`, and the searches across a change of daylight saving,
+ * are left to `cron_next()`.
+ *
+ * @param expr Expression parsed with `cron_fast_parse_expr()`
+ * @param date Time to start from, excluded
+ * @return Next matching time, or CRON_INVALID_INSTANT if there is none
+ */
+time_t cron_fast_next(cron_fast_expr_t *expr, time_t date);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Cron scheduler handle
+ */
+typedef struct cron_scheduler_t *cron_scheduler_handle_t;
+
+/**
+ * @brief Cron job handle
+ */
+typedef struct cron_job_t *cron_job_handle_t;
+
+/**
+ * @brief Function called when a job is due
+ *
+ * @note Called from the esp_timer task, as the callbacks of `esp_timer`: it must not block, a long work should be
+ *       handed to another task
+ *
+ * @param job Job handle, which the function may remove
+ * @param fire_time Time the job was due at
+ * @param arg User argument of the job
+ */
+typedef void (*cron_job_cb_t)(cron_job_handle_t job, time_t fire_time, void *arg);
+
+/**
+ * @brief Cron scheduler configuration
+ */
+typedef struct {
+    size_t initial_capacity; /*!< Number of jobs the scheduler has room for at creation, it grows beyond as needed */
+} cron_scheduler_config_t;
+
+/**
+ * @brief Statistics of a scheduler, since its creation
+ */
+typedef struct {
+    size_t job_count;       /*!< Number of jobs added and not removed */
+    uint32_t wakeups;       /*!< Number of times the timer of the scheduler expired */
+    uint32_t fired;         /*!< Number of job callbacks called */
+    uint32_t next_computed; /*!< Number of next fire times computed, with `cron_fast_next()` */
+} cron_scheduler_stats_t;
+
+/**
+ * @brief Create a cron scheduler
+ *
+ * The scheduler keeps its jobs in a min-heap ordered by their next fire time, and a single `esp_timer` sleeps until
+ * the earliest one. When the timer expires, only the jobs due are fired, and the next fire time of each of them
+ * computed again with `cron_fast_next()`, so the cost of a wake-up is O(log n) per job fired, whatever the number
+ * of jobs.
+ *
+ * The fire times follow the wall clock, `time()`. The timer wakes up at least every
+ * CONFIG_CRON_SCHEDULER_MAX_SLEEP_S seconds to follow the small adjustments of the clock, but after the clock has
+ * been set, e.g. by SNTP, `cron_scheduler_time_changed()` must be called.
+ *
+ * @param config Scheduler configuration
+ * @param ret_scheduler Returned scheduler handle
+ * @return
+ *      - ESP_OK: Create scheduler successfully
+ *      - ESP_ERR_INVALID_ARG: Create scheduler failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create scheduler failed because of out of memory
+ *      - Others: Create scheduler failed because the timer could not be created
+ */
+esp_err_t cron_scheduler_new(const cron_scheduler_config_t *config, cron_scheduler_handle_t *ret_scheduler);
+
+/**
+ * @brief Add a job to a scheduler
+ *
+ * @param scheduler Scheduler handle
+ * @param expression Cron expression of the job, as for `cron_parse_expr()`
+ * @param callback Function called when the job is due
+ * @param arg User argument passed to the function
+ * @param ret_job Returned job handle, can be NULL
+ * @return
+ *      - ESP_OK: Add job successfully
+ *      - ESP_ERR_INVALID_ARG: Add job failed because of invalid argument, e.g. an invalid expression
+ *      - ESP_ERR_NO_MEM: Add job failed because of out of memory
+ */
+esp_err_t cron_scheduler_add_job(cron_scheduler_handle_t scheduler, const char *expression, cron_job_cb_t callback,
+                                 void *arg, cron_job_handle_t *ret_job);
+
+/**
+ * @brief Remove a job from its scheduler and free it
+ *
+ * @note Can be called from the callback of the job itself
+ *
+ * @param scheduler Scheduler handle
+ * @param job Job handle
+ * @return
+ *      - ESP_OK: Remove job successfully
+ *      - ESP_ERR_INVALID_ARG: Remove job failed because of invalid argument
+ */
+esp_err_t cron_scheduler_remove_job(cron_scheduler_handle_t scheduler, cron_job_handle_t job);
+
+/**
+ * @brief Get the next fire time of a job
+ *
+ * @param scheduler Scheduler handle
+ * @param job Job handle
+ * @param ret_time Returned fire time, CRON_INVALID_INSTANT if the expression has no more fire time
+ * @return
+ *      - ESP_OK: Get fire time successfully
+ *      - ESP_ERR_INVALID_ARG: Get fire time failed because of invalid argument
+ */
+esp_err_t cron_scheduler_get_next(cron_scheduler_handle_t scheduler, cron_job_handle_t job, time_t *ret_time);
+
+/**
+ * @brief Compute the next fire time of every job again, after the wall clock has been set
+ *
+ * The jobs are not fired for the times skipped by a clock set forward, nor twice for the times repeated by a clock
+ * set backward.
+ *
+ * @param scheduler Scheduler handle
+ * @return
+ *      - ESP_OK: Update jobs successfully
+ *      - ESP_ERR_INVALID_ARG: Update jobs failed because of invalid argument
+ */
+esp_err_t cron_scheduler_time_changed(cron_scheduler_handle_t scheduler);
+
+/**
+ * @brief Get the statistics of a scheduler
+ *
+ * @param scheduler Scheduler handle
+ * @param ret_stats Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ */
+esp_err_t cron_scheduler_get_stats(cron_scheduler_handle_t scheduler, cron_scheduler_stats_t *ret_stats);
+
+/**
+ * @brief Delete a scheduler and its jobs
+ *
+ * @note Must not be called from a job callback
+ *
+ * @param scheduler Scheduler handle
+ * @return
+ *      - ESP_OK: Delete scheduler successfully
+ *      - ESP_ERR_INVALID_ARG: Delete scheduler failed because of invalid argument
+ */
+esp_err_t cron_scheduler_del(cron_scheduler_handle_t scheduler);
+
+#ifdef __cplusplus
+}
+#endif
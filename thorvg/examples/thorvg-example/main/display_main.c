@@ -16,6 +16,8 @@
 #include "bsp/esp-bsp.h"
 #include "driver/ppa.h"
 #include "thorvg_capi.h"
+#include "esp_tvg_engine.h"
+#include "esp_tvg_band.h"
 
 static const char *TAG = "example";
 
@@ -26,7 +28,7 @@ static uint32_t play_tick_elaps(uint32_t prev_tick);
 
 static void capi_loop_task(void *arg);
 static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_handles_t *lcd_panel);
-static esp_err_t argb888_to_rgb565_ppa(ppa_client_handle_t ppa_handle, const uint32_t *in, uint16_t *out);
+static esp_err_t argb888_to_rgb565_ppa(ppa_client_handle_t ppa_handle, const uint32_t *in, uint16_t *out, int w, int h, size_t out_size);
 
 /* SPIFFS mount root */
 #define FS_MNT_PATH             BSP_SPIFFS_MOUNT_POINT
@@ -35,6 +37,14 @@ static esp_err_t argb888_to_rgb565_ppa(ppa_client_handle_t ppa_handle, const uin
 #define LOTTIE_SIZE_VER         (320)
 
 #define EXPECTED_FPS            (20)
+
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+#define LOTTIE_BAND_HEIGHT      (CONFIG_EXAMPLE_BAND_HEIGHT)
+#else
+#define LOTTIE_BAND_HEIGHT      (LOTTIE_SIZE_VER)
+#endif
+/* PPA output buffers are a whole number of cache lines */
+#define LOTTIE_BUF_565_SIZE     ((LOTTIE_SIZE_HOR * LOTTIE_BAND_HEIGHT * sizeof(uint16_t) + 63) & ~63)
 #define LOTTIE_FILENAME         FS_MNT_PATH"/emoji-animation.json"
 
 static uint32_t sys_time = 0;
@@ -83,6 +93,29 @@ void capi_loop_task(void *arg)
     vTaskDelete(NULL);
 }
 
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+typedef struct {
+    ppa_client_handle_t ppa_handle;
+    esp_lcd_panel_handle_t panel;
+    uint16_t *buf_565;
+    int64_t flush_us;
+} band_flush_ctx_t;
+
+/* Converts a rendered band to RGB565 and copies it to its rows of the display */
+static esp_err_t band_flush(int x_start, int y_start, int x_end, int y_end, const uint32_t *pixels, void *arg)
+{
+    band_flush_ctx_t *ctx = (band_flush_ctx_t *)arg;
+    int64_t start = esp_timer_get_time();
+    ESP_RETURN_ON_ERROR(argb888_to_rgb565_ppa(ctx->ppa_handle, pixels, ctx->buf_565, x_end - x_start, y_end - y_start,
+                                              LOTTIE_BUF_565_SIZE),
+                        TAG, "PPA conversion failed");
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_draw_bitmap(ctx->panel, x_start, y_start, x_end, y_end, ctx->buf_565),
+                        TAG, "draw bitmap failed");
+    ctx->flush_us += esp_timer_get_time() - start;
+    return ESP_OK;
+}
+#endif
+
 static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_handles_t *lcd_panel)
 {
     esp_err_t ret = ESP_OK;
@@ -97,24 +130,51 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
 
     Tvg_Animation *animation = NULL;
     Tvg_Canvas *canvas = NULL;
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    esp_tvg_band_handle_t band = NULL;
+    band_flush_ctx_t flush_ctx = {
+        .ppa_handle = ppa_handle,
+        .panel = lcd_panel->panel,
+    };
+#endif
     esp_timer_handle_t play_timer = NULL;
 
     play_tick_new(&play_timer);
 
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    /* One band of RGB565 in internal RAM, the renderer has its own band of ARGB8888 */
+    canvas_buf_565 = heap_caps_aligned_calloc(64, LOTTIE_BUF_565_SIZE, sizeof(uint8_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+    ESP_GOTO_ON_FALSE(canvas_buf_565, ESP_ERR_NO_MEM, err, TAG, "Error malloc band buffer");
+    flush_ctx.buf_565 = canvas_buf_565;
+#else
     canvas_buf_888 = heap_caps_aligned_calloc(64, LOTTIE_SIZE_HOR * LOTTIE_SIZE_VER * sizeof(uint32_t), sizeof(uint8_t), MALLOC_CAP_SPIRAM);
     ESP_GOTO_ON_FALSE(canvas_buf_888, ESP_ERR_NO_MEM, err, TAG, "Error malloc canvas buffer");
 
-    canvas_buf_565 = heap_caps_aligned_calloc(64, LOTTIE_SIZE_HOR * LOTTIE_SIZE_VER * sizeof(uint16_t), sizeof(uint8_t), MALLOC_CAP_SPIRAM);
+    canvas_buf_565 = heap_caps_aligned_calloc(64, LOTTIE_BUF_565_SIZE, sizeof(uint8_t), MALLOC_CAP_SPIRAM);
     ESP_GOTO_ON_FALSE(canvas_buf_565, ESP_ERR_NO_MEM, err, TAG, "Error malloc canvas buffer");
-
-    tvg_engine = tvg_engine_init(TVG_ENGINE_SW, 0);
-    ESP_GOTO_ON_FALSE(tvg_engine == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
-
+#endif
+
+    /* Worker threads, core affinity and priority from the ThorVG component configuration */
+    ESP_GOTO_ON_ERROR(esp_tvg_engine_init(), err, TAG, "esp_tvg_engine_init failed");
+    tvg_engine = TVG_RESULT_SUCCESS;
+
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    esp_tvg_band_config_t band_config = {
+        .width = LOTTIE_SIZE_HOR,
+        .height = LOTTIE_SIZE_VER,
+        .band_height = LOTTIE_BAND_HEIGHT,
+        .skip_unchanged = CONFIG_EXAMPLE_BAND_SKIP_UNCHANGED,
+        .flush = band_flush,
+        .arg = &flush_ctx,
+    };
+    ESP_GOTO_ON_ERROR(esp_tvg_band_new(&band_config, &band), err, TAG, "esp_tvg_band_new failed");
+#else
     canvas = tvg_swcanvas_create();
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
 
     tvg_res = tvg_swcanvas_set_target(canvas, canvas_buf_888, LOTTIE_SIZE_HOR, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER, TVG_COLORSPACE_ARGB8888);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
+#endif
 
     /* shape rect */
     Tvg_Paint *paint = tvg_shape_new();
@@ -131,6 +191,10 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
     }
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_shape_set_fill_color failed");
 
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    ESP_GOTO_ON_ERROR(esp_tvg_band_push(band, paint), err, TAG, "esp_tvg_band_push failed");
+    ESP_GOTO_ON_ERROR(esp_tvg_band_render(band), err, TAG, "esp_tvg_band_render failed");
+#else
     tvg_res = tvg_canvas_push(canvas, paint);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_push failed");
 
@@ -140,8 +204,9 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
     tvg_res = tvg_canvas_sync(canvas);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_sync failed");
 
-    argb888_to_rgb565_ppa(ppa_handle, canvas_buf_888, canvas_buf_565);
+    argb888_to_rgb565_ppa(ppa_handle, canvas_buf_888, canvas_buf_565, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER, LOTTIE_BUF_565_SIZE);
     esp_lcd_panel_draw_bitmap(lcd_panel->panel, 0, 0, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER, canvas_buf_565);
+#endif
 
     /* tvg Lottie */
     animation = tvg_animation_new();
@@ -150,14 +215,20 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
     Tvg_Paint *picture = tvg_animation_get_picture(animation);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
 
+    int64_t load_start = esp_timer_get_time();
     tvg_res = tvg_picture_load(picture, LOTTIE_FILENAME);
     ESP_GOTO_ON_FALSE(picture, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
 
     tvg_res = tvg_picture_set_size(picture, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
 
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    ESP_GOTO_ON_ERROR(esp_tvg_band_push(band, picture), err, TAG, "esp_tvg_band_push failed");
+#else
     tvg_res = tvg_canvas_push(canvas, picture);
     ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_engine_init failed");
+#endif
+    ESP_LOGI(TAG, "Lottie loaded in %" PRIi64 " us", esp_timer_get_time() - load_start);
 
     float f_total;
     float f = 0;
@@ -167,29 +238,64 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
 
     uint32_t time_busy = 0;
     uint32_t anim_start = play_tick_get();
+    uint32_t frames_drawn = 0;
+    uint32_t frames_skipped = 0;
+    int64_t total_update_us = 0;
+    int64_t total_render_us = 0;
+    int64_t total_flush_us = 0;
 
     while (f < f_total) {
         uint32_t frame_start = play_tick_get();
 
         tvg_res = tvg_animation_get_frame(animation, &f);
         f++;
-        ESP_LOGI(TAG, "set %f / %f", f, f_total);
+#if CONFIG_EXAMPLE_FRAME_SKIP
+        /* Show the frame due at this time, skipping those there was no time to draw */
+        uint32_t f_due = play_tick_elaps(anim_start) * EXPECTED_FPS / 1000 + 1;
+        if (f_due > (uint32_t)f) {
+            f_due = f_due < (uint32_t)f_total ? f_due : (uint32_t)f_total;
+            frames_skipped += f_due - (uint32_t)f;
+            f = f_due;
+        }
+#endif
+        int64_t t0 = esp_timer_get_time();
         tvg_res = tvg_animation_set_frame(animation, f);
         ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_animation_set_frame failed");
 
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+        /* Each band is updated, rasterized and flushed in turn, the flush time is taken out of the rest */
+        int64_t t1 = esp_timer_get_time();
+        flush_ctx.flush_us = 0;
+        ESP_GOTO_ON_ERROR(esp_tvg_band_render(band), err, TAG, "esp_tvg_band_render failed");
+        int64_t t3 = esp_timer_get_time();
+        int64_t t2 = t3 - flush_ctx.flush_us;
+
+        time_busy += play_tick_elaps(frame_start);
+#else
         tvg_res = tvg_canvas_update(canvas);
         ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_update failed");
+        int64_t t1 = esp_timer_get_time();
 
         tvg_res = tvg_canvas_draw(canvas);
         ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_draw failed");
 
         tvg_res = tvg_canvas_sync(canvas);
         ESP_GOTO_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_sync failed");
+        int64_t t2 = esp_timer_get_time();
 
         time_busy += play_tick_elaps(frame_start);
 
-        argb888_to_rgb565_ppa(ppa_handle, canvas_buf_888, canvas_buf_565);
+        argb888_to_rgb565_ppa(ppa_handle, canvas_buf_888, canvas_buf_565, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER, LOTTIE_BUF_565_SIZE);
         esp_lcd_panel_draw_bitmap(lcd_panel->panel, 0, 0, LOTTIE_SIZE_HOR, LOTTIE_SIZE_VER, canvas_buf_565);
+        int64_t t3 = esp_timer_get_time();
+#endif
+
+        ESP_LOGI(TAG, "frame %d / %d: update %" PRIi64 " us, rasterize %" PRIi64 " us, flush %" PRIi64 " us",
+                 (int)f, (int)f_total, t1 - t0, t2 - t1, t3 - t2);
+        frames_drawn++;
+        total_update_us += t1 - t0;
+        total_render_us += t2 - t1;
+        total_flush_us += t3 - t2;
 
         uint32_t elaps_frame = play_tick_elaps(frame_start);
         if (elaps_frame < (1000 / EXPECTED_FPS)) {
@@ -197,7 +303,16 @@ static esp_err_t capi_create_lottie(ppa_client_handle_t ppa_handle, bsp_lcd_hand
         }
     }
     uint32_t elaps_anim = play_tick_elaps(anim_start);
-    ESP_LOGI(TAG, "CPU:%" PRIu32 "%%, FPS:%d/%d", (time_busy * 100 / elaps_anim), (int)(1000 * f_total / elaps_anim), EXPECTED_FPS);
+    ESP_LOGI(TAG, "CPU:%" PRIu32 "%%, FPS:%d/%d, %" PRIu32 " frames skipped", (time_busy * 100 / elaps_anim),
+             (int)(1000 * frames_drawn / elaps_anim), EXPECTED_FPS, frames_skipped);
+    ESP_LOGI(TAG, "Average: update %" PRIi64 " us, rasterize %" PRIi64 " us, flush %" PRIi64 " us",
+             total_update_us / frames_drawn, total_render_us / frames_drawn, total_flush_us / frames_drawn);
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    esp_tvg_band_stats_t band_stats;
+    esp_tvg_band_get_stats(band, &band_stats);
+    ESP_LOGI(TAG, "Bands: %" PRIu32 " rendered, %" PRIu32 " flushed, %" PRIu32 " unchanged, %" PRIu32 " empty",
+             band_stats.bands_rendered, band_stats.bands_flushed, band_stats.bands_unchanged, band_stats.bands_empty);
+#endif
 
 err:
     if (animation) {
@@ -206,6 +321,11 @@ err:
     if (canvas) {
         tvg_canvas_destroy(canvas);
     }
+#if CONFIG_EXAMPLE_BANDED_RENDERING
+    if (band) {
+        esp_tvg_band_del(band);
+    }
+#endif
     if (TVG_RESULT_SUCCESS == tvg_engine) {
         tvg_engine_term(TVG_ENGINE_SW);
     }
@@ -223,22 +343,22 @@ err:
     return ret;
 }
 
-static esp_err_t argb888_to_rgb565_ppa(ppa_client_handle_t ppa_handle, const uint32_t *in, uint16_t *out)
+static esp_err_t argb888_to_rgb565_ppa(ppa_client_handle_t ppa_handle, const uint32_t *in, uint16_t *out, int w, int h, size_t out_size)
 {
     ppa_srm_oper_config_t oper_config = {
         .in.buffer = in,
-        .in.pic_w = LOTTIE_SIZE_HOR,
-        .in.pic_h = LOTTIE_SIZE_VER,
-        .in.block_w = LOTTIE_SIZE_HOR,
-        .in.block_h = LOTTIE_SIZE_VER,
+        .in.pic_w = w,
+        .in.pic_h = h,
+        .in.block_w = w,
+        .in.block_h = h,
         .in.block_offset_x = 0,
         .in.block_offset_y = 0,
         .in.srm_cm = PPA_SRM_COLOR_MODE_ARGB8888,
 
         .out.buffer = out,
-        .out.buffer_size = LOTTIE_SIZE_HOR * LOTTIE_SIZE_VER * sizeof(uint16_t),
-        .out.pic_w = LOTTIE_SIZE_HOR,
-        .out.pic_h = LOTTIE_SIZE_VER,
+        .out.buffer_size = out_size,
+        .out.pic_w = w,
+        .out.pic_h = h,
         .out.block_offset_x = 0,
         .out.block_offset_y = 0,
         .out.srm_cm = PPA_SRM_COLOR_MODE_RGB565,
@@ -0,0 +1,194 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_tvg_band.h"
+
+static const char *TAG = "esp_tvg_band";
+
+/* What the display shows in a band */
+typedef enum {
+    BAND_UNKNOWN = 0, /* Not flushed yet, or invalidated */
+    BAND_CLEARED,     /* Flushed empty, outside the bounds of the scene */
+    BAND_DRAWN,       /* Flushed with the pixels of the checksum */
+} band_state_t;
+
+struct esp_tvg_band_t {
+    esp_tvg_band_config_t config;
+    uint32_t band_count;
+    uint32_t *buf;
+    Tvg_Canvas *canvas;
+    Tvg_Paint *scene;
+    uint8_t *states;
+    uint32_t *checksums;
+    esp_tvg_band_stats_t stats;
+};
+
+/* FNV-1a over the pixels, only to tell whether a band changed since the last frame */
+static uint32_t band_checksum(const uint32_t *pixels, size_t count)
+{
+    uint32_t h = 0x811c9dc5;
+    for (size_t i = 0; i < count; i++) {
+        h = (h ^ pixels[i]) * 0x01000193;
+    }
+    return h;
+}
+
+esp_err_t esp_tvg_band_new(const esp_tvg_band_config_t *config, esp_tvg_band_handle_t *ret_band)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config && ret_band && config->flush, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->width && config->height && config->band_height, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid size");
+
+    esp_tvg_band_handle_t band = calloc(1, sizeof(struct esp_tvg_band_t));
+    ESP_RETURN_ON_FALSE(band, ESP_ERR_NO_MEM, TAG, "no mem for renderer");
+    band->config = *config;
+    if (band->config.band_height > band->config.height) {
+        band->config.band_height = band->config.height;
+    }
+    band->band_count = (band->config.height + band->config.band_height - 1) / band->config.band_height;
+
+    uint32_t caps = config->caps ? config->caps : MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA;
+    band->buf = heap_caps_aligned_calloc(64, band->config.width * band->config.band_height, sizeof(uint32_t), caps);
+    ESP_GOTO_ON_FALSE(band->buf, ESP_ERR_NO_MEM, err, TAG, "no mem for band buffer");
+    band->states = calloc(band->band_count, sizeof(uint8_t));
+    band->checksums = calloc(band->band_count, sizeof(uint32_t));
+    ESP_GOTO_ON_FALSE(band->states && band->checksums, ESP_ERR_NO_MEM, err, TAG, "no mem for band states");
+
+    band->canvas = tvg_swcanvas_create();
+    ESP_GOTO_ON_FALSE(band->canvas, ESP_ERR_INVALID_STATE, err, TAG, "tvg_swcanvas_create failed");
+    ESP_GOTO_ON_FALSE(tvg_swcanvas_set_target(band->canvas, band->buf, band->config.width, band->config.width,
+                                              band->config.band_height, TVG_COLORSPACE_ARGB8888) == TVG_RESULT_SUCCESS,
+                      ESP_ERR_INVALID_STATE, err, TAG, "tvg_swcanvas_set_target failed");
+
+    // The paints go in a scene, which moves them up to each band without touching their own transforms
+    band->scene = tvg_scene_new();
+    ESP_GOTO_ON_FALSE(band->scene, ESP_ERR_NO_MEM, err, TAG, "tvg_scene_new failed");
+    if (tvg_canvas_push(band->canvas, band->scene) != TVG_RESULT_SUCCESS) {
+        tvg_paint_del(band->scene);
+        band->scene = NULL;
+        ESP_GOTO_ON_FALSE(false, ESP_ERR_INVALID_STATE, err, TAG, "tvg_canvas_push failed");
+    }
+
+    *ret_band = band;
+    return ESP_OK;
+
+err:
+    esp_tvg_band_del(band);
+    return ret;
+}
+
+esp_err_t esp_tvg_band_push(esp_tvg_band_handle_t band, Tvg_Paint *paint)
+{
+    ESP_RETURN_ON_FALSE(band && paint, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(tvg_scene_push(band->scene, paint) == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, TAG,
+                        "tvg_scene_push failed");
+    return ESP_OK;
+}
+
+/* Rows [*ret_y_start, *ret_y_end) the scene may draw in, antialiasing included */
+static void band_scene_rows(esp_tvg_band_handle_t band, uint32_t *ret_y_start, uint32_t *ret_y_end)
+{
+    float x, y, w, h;
+    *ret_y_start = 0;
+    *ret_y_end = band->config.height;
+    if (tvg_paint_get_bounds(band->scene, &x, &y, &w, &h, false) != TVG_RESULT_SUCCESS) {
+        return; // can't tell, draw everything
+    }
+    if (w <= 0 || h <= 0 || x >= band->config.width || x + w <= 0) {
+        *ret_y_end = 0; // nothing visible
+        return;
+    }
+    float y_start = floorf(y) - 1;
+    float y_end = ceilf(y + h) + 1;
+    *ret_y_start = y_start > 0 ? (uint32_t)y_start : 0;
+    *ret_y_end = y_end < band->config.height ? (y_end > 0 ? (uint32_t)y_end : 0) : band->config.height;
+}
+
+esp_err_t esp_tvg_band_render(esp_tvg_band_handle_t band)
+{
+    ESP_RETURN_ON_FALSE(band, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    const esp_tvg_band_config_t *config = &band->config;
+
+    uint32_t scene_y_start, scene_y_end;
+    band_scene_rows(band, &scene_y_start, &scene_y_end);
+
+    for (uint32_t i = 0; i < band->band_count; i++) {
+        uint32_t y = i * config->band_height;
+        uint32_t rows = config->height - y < config->band_height ? config->height - y : config->band_height;
+        size_t pixel_count = config->width * rows;
+
+        if (y >= scene_y_end || y + rows <= scene_y_start) {
+            // Outside the scene, only cleared once
+            if (band->states[i] == BAND_CLEARED) {
+                band->stats.bands_empty++;
+                continue;
+            }
+            memset(band->buf, 0, pixel_count * sizeof(uint32_t));
+        } else {
+            ESP_RETURN_ON_FALSE(tvg_paint_translate(band->scene, 0, -(float)y) == TVG_RESULT_SUCCESS,
+                                ESP_ERR_INVALID_STATE, TAG, "tvg_paint_translate failed");
+            ESP_RETURN_ON_FALSE(tvg_canvas_update(band->canvas) == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, TAG,
+                                "tvg_canvas_update failed");
+            ESP_RETURN_ON_FALSE(tvg_canvas_draw(band->canvas) == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, TAG,
+                                "tvg_canvas_draw failed");
+            ESP_RETURN_ON_FALSE(tvg_canvas_sync(band->canvas) == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, TAG,
+                                "tvg_canvas_sync failed");
+            band->stats.bands_rendered++;
+
+            if (config->skip_unchanged) {
+                uint32_t checksum = band_checksum(band->buf, pixel_count);
+                if (band->states[i] == BAND_DRAWN && band->checksums[i] == checksum) {
+                    band->stats.bands_unchanged++;
+                    continue;
+                }
+                band->checksums[i] = checksum;
+            }
+        }
+
+        band->states[i] = BAND_UNKNOWN;
+        esp_err_t ret = config->flush(0, y, config->width, y + rows, band->buf, config->arg);
+        ESP_RETURN_ON_ERROR(ret, TAG, "flush band %" PRIu32 " failed", i);
+        band->states[i] = y >= scene_y_end || y + rows <= scene_y_start ? BAND_CLEARED : BAND_DRAWN;
+        band->stats.bands_flushed++;
+    }
+    band->stats.frames++;
+    return ESP_OK;
+}
+
+esp_err_t esp_tvg_band_invalidate(esp_tvg_band_handle_t band)
+{
+    ESP_RETURN_ON_FALSE(band, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    memset(band->states, BAND_UNKNOWN, band->band_count);
+    return ESP_OK;
+}
+
+esp_err_t esp_tvg_band_get_stats(esp_tvg_band_handle_t band, esp_tvg_band_stats_t *ret_stats)
+{
+    ESP_RETURN_ON_FALSE(band && ret_stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    *ret_stats = band->stats;
+    return ESP_OK;
+}
+
+esp_err_t esp_tvg_band_del(esp_tvg_band_handle_t band)
+{
+    ESP_RETURN_ON_FALSE(band, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (band->canvas) {
+        // frees the scene and its paints
+        tvg_canvas_destroy(band->canvas);
+    }
+    free(band->checksums);
+    free(band->states);
+    heap_caps_free(band->buf);
+    free(band);
+    return ESP_OK;
+}
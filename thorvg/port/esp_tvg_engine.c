@@ -0,0 +1,42 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "sdkconfig.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "thorvg_capi.h"
+#include "esp_tvg_engine.h"
+#if CONFIG_THORVG_THREAD_ENABLED
+#include "esp_pthread.h"
+#endif
+
+static const char *TAG = "esp_tvg_engine";
+
+esp_err_t esp_tvg_engine_init(void)
+{
+    Tvg_Result tvg_res;
+#if CONFIG_THORVG_THREAD_ENABLED
+    // ThorVG starts its workers with std::thread, which takes the pthread configuration of the calling task
+    esp_pthread_cfg_t prev_cfg;
+    if (esp_pthread_get_cfg(&prev_cfg) != ESP_OK) {
+        prev_cfg = esp_pthread_get_default_config();
+    }
+    esp_pthread_cfg_t cfg = esp_pthread_get_default_config();
+    cfg.stack_size = CONFIG_THORVG_THREAD_STACK_SIZE;
+    cfg.prio = CONFIG_THORVG_THREAD_PRIORITY;
+#if CONFIG_THORVG_THREAD_CORE_ID >= 0
+    cfg.pin_to_core = CONFIG_THORVG_THREAD_CORE_ID;
+#endif
+    cfg.thread_name = "thorvg";
+    ESP_RETURN_ON_ERROR(esp_pthread_set_cfg(&cfg), TAG, "set pthread config failed");
+
+    tvg_res = tvg_engine_init(TVG_ENGINE_SW, CONFIG_THORVG_THREAD_COUNT);
+    esp_pthread_set_cfg(&prev_cfg);
+#else
+    tvg_res = tvg_engine_init(TVG_ENGINE_SW, 0);
+#endif
+    ESP_RETURN_ON_FALSE(tvg_res == TVG_RESULT_SUCCESS, ESP_ERR_INVALID_STATE, TAG, "tvg_engine_init failed: %d", tvg_res);
+    return ESP_OK;
+}
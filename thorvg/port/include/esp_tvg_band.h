@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "thorvg_capi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Band renderer handle
+ */
+typedef struct esp_tvg_band_t *esp_tvg_band_handle_t;
+
+/**
+ * @brief Function receiving a rendered band
+ *
+ * @note The pixels are overwritten by the next band, they must have been used, e.g. copied to the display, when the
+ *       function returns
+ *
+ * @param x_start Start column of the band, included
+ * @param y_start Start row of the band, included
+ * @param x_end End column of the band, excluded, as for `esp_lcd_panel_draw_bitmap()`
+ * @param y_end End row of the band, excluded
+ * @param pixels ARGB8888 pixels of the band, `x_end - x_start` pixels per row
+ * @param arg User argument of the renderer
+ * @return ESP_OK on success, any other error to stop the rendering of the frame, which then returns it
+ */
+typedef esp_err_t (*esp_tvg_band_flush_cb_t)(int x_start, int y_start, int x_end, int y_end, const uint32_t *pixels,
+                                             void *arg);
+
+/**
+ * @brief Band renderer configuration
+ */
+typedef struct {
+    uint32_t width;                /*!< Width of the scene, in pixels */
+    uint32_t height;               /*!< Height of the scene, in pixels */
+    uint32_t band_height;          /*!< Height of the bands, in rows, the band buffer takes `width * band_height * 4`
+                                        bytes */
+    uint32_t caps;                 /*!< Heap capabilities of the band buffer, 0 for MALLOC_CAP_INTERNAL |
+                                        MALLOC_CAP_DMA */
+    bool skip_unchanged;           /*!< Don't flush the bands whose pixels are the same as in the previous frame,
+                                        at the cost of a checksum of each band */
+    esp_tvg_band_flush_cb_t flush; /*!< Function receiving the rendered bands */
+    void *arg;                     /*!< User argument passed to the function */
+} esp_tvg_band_config_t;
+
+/**
+ * @brief Statistics of a band renderer, since its creation
+ */
+typedef struct {
+    uint32_t frames;           /*!< Number of frames rendered */
+    uint32_t bands_rendered;   /*!< Number of bands rasterized */
+    uint32_t bands_empty;      /*!< Number of bands skipped because they are outside the bounds of the scene */
+    uint32_t bands_flushed;    /*!< Number of bands given to the flush function */
+    uint32_t bands_unchanged;  /*!< Number of bands rasterized but not flushed, because they hadn't changed */
+} esp_tvg_band_stats_t;
+
+/**
+ * @brief Create a band renderer
+ *
+ * The renderer draws its scene in horizontal bands of `band_height` rows, one after the other, into a buffer of one
+ * band, and gives each band to the flush function, instead of drawing the whole frame into a full-size buffer. Each
+ * band is a full `tvg_canvas_update()`, draw and sync of the scene moved up by the start row of the band, which the
+ * software engine clips to the band, so that the paints outside the band are not rasterized.
+ *
+ * To only redraw what changed, the bands outside the bounds of the scene are neither rasterized nor flushed, once
+ * they have been cleared, and, with `skip_unchanged`, the bands whose pixels are the same as in the previous frame are
+ * not flushed.
+ *
+ * @note The ThorVG engine must have been initialized, e.g. with `esp_tvg_engine_init()`
+ *
+ * @param config Renderer configuration
+ * @param ret_band Returned renderer handle
+ * @return
+ *      - ESP_OK: Create renderer successfully
+ *      - ESP_ERR_INVALID_ARG: Create renderer failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create renderer failed because of out of memory
+ *      - ESP_ERR_INVALID_STATE: Create renderer failed because of a ThorVG error, e.g. engine not initialized
+ */
+esp_err_t esp_tvg_band_new(const esp_tvg_band_config_t *config, esp_tvg_band_handle_t *ret_band);
+
+/**
+ * @brief Add a paint on top of the scene of the renderer, as `tvg_canvas_push()`
+ *
+ * @note The renderer takes the ownership of the paint, which is freed by `esp_tvg_band_del()`
+ *
+ * @param band Renderer handle
+ * @param paint Paint, e.g. the picture of an animation
+ * @return
+ *      - ESP_OK: Push paint successfully
+ *      - ESP_ERR_INVALID_ARG: Push paint failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Push paint failed because of a ThorVG error
+ */
+esp_err_t esp_tvg_band_push(esp_tvg_band_handle_t band, Tvg_Paint *paint);
+
+/**
+ * @brief Render the current state of the scene, e.g. after `tvg_animation_set_frame()`, band by band
+ *
+ * @param band Renderer handle
+ * @return
+ *      - ESP_OK: Render frame successfully
+ *      - ESP_ERR_INVALID_ARG: Render frame failed because of invalid argument
+ *      - ESP_ERR_INVALID_STATE: Render frame failed because of a ThorVG error
+ *      - Others: Render frame failed because the flush function returned this error
+ */
+esp_err_t esp_tvg_band_render(esp_tvg_band_handle_t band);
+
+/**
+ * @brief Redraw every band at the next frame, e.g. after something else has been drawn on the display
+ *
+ * @param band Renderer handle
+ * @return
+ *      - ESP_OK: Invalidate renderer successfully
+ *      - ESP_ERR_INVALID_ARG: Invalidate renderer failed because of invalid argument
+ */
+esp_err_t esp_tvg_band_invalidate(esp_tvg_band_handle_t band);
+
+/**
+ * @brief Get the statistics of a band renderer
+ *
+ * @param band Renderer handle
+ * @param ret_stats Returned statistics
+ * @return
+ *      - ESP_OK: Get statistics successfully
+ *      - ESP_ERR_INVALID_ARG: Get statistics failed because of invalid argument
+ */
+esp_err_t esp_tvg_band_get_stats(esp_tvg_band_handle_t band, esp_tvg_band_stats_t *ret_stats);
+
+/**
+ * @brief Delete a band renderer, with its canvas and the paints pushed to it
+ *
+ * @param band Renderer handle
+ * @return
+ *      - ESP_OK: Delete renderer successfully
+ *      - ESP_ERR_INVALID_ARG: Delete renderer failed because of invalid argument
+ */
+esp_err_t esp_tvg_band_del(esp_tvg_band_handle_t band);
+
+#ifdef __cplusplus
+}
+#endif
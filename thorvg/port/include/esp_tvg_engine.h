@@ -0,0 +1,34 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initialize the ThorVG software engine with the task pool of the configuration
+ *
+ * Calls `tvg_engine_init(TVG_ENGINE_SW, CONFIG_THORVG_THREAD_COUNT)`, with the worker threads ThorVG creates pinned to
+ * CONFIG_THORVG_THREAD_CORE_ID, at CONFIG_THORVG_THREAD_PRIORITY and with CONFIG_THORVG_THREAD_STACK_SIZE bytes of
+ * stack. Without CONFIG_THORVG_THREAD_ENABLED, ThorVG only renders in the calling task.
+ *
+ * The pthread configuration of the calling task is restored afterwards.
+ *
+ * @note Call `tvg_engine_term(TVG_ENGINE_SW)` to terminate the engine
+ *
+ * @return
+ *      - ESP_OK: Initialize engine successfully
+ *      - ESP_ERR_INVALID_STATE: Initialize engine failed because ThorVG failed to initialize
+ *      - Others: Initialize engine failed because the pthread configuration couldn't be set
+ */
+esp_err_t esp_tvg_engine_init(void);
+
+#ifdef __cplusplus
+}
+#endif
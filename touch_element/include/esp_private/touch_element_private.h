@@ -131,6 +131,9 @@ struct te_slider_s {
     touch_slider_event_t event;                 //Slider outside state(for application layer)
     float position_scale;                       //Slider position scale(step size)
     float *quantify_signal_array;               //Slider re-quantization array
+    uint32_t position_scale_fixed;              //Slider position scale, Q16 (fixed-point position)
+    uint32_t *channel_inv_sens_fixed;           //Channel 1 / sensitivity, Q16 (fixed-point position)
+    uint64_t *channel_coef_fixed;               //Channel sensitivity sum / sensitivity^2, Q16 (fixed-point position)
     uint32_t *channel_bcm;                      //Channel benchmark array
     uint32_t channel_bcm_update_cnt;            //Channel benchmark update counter
     uint32_t filter_reset_cnt;                  //Slider reset counter
@@ -154,6 +157,11 @@ typedef struct {
 
 typedef te_state_t te_matrix_state_t;           //TODO: add Long Press state
 
+typedef struct {
+    touch_matrix_position_t position;           //Matrix key position
+    uint32_t trigger_cnt;                       //Matrix key long time trigger counter
+} te_matrix_key_t;
+
 struct te_matrix_s {
     te_matrix_handle_config_t *config;          //Matrix button configuration
     te_dev_t **device;                          //Base device information
@@ -165,6 +173,15 @@ struct te_matrix_s {
     touch_matrix_position_t position;           //Matrix button position
     uint8_t x_channel_num;                      //The number of touch sensor channel in x axis
     uint8_t y_channel_num;                      //The number of touch sensor channel in y axis
+    uint8_t channel_index[TOUCH_PAD_MAX];       //Device index of each touch sensor channel, 0xff if not in the matrix
+    uint16_t x_mask;                            //Pressed x axis channels, bit n is device[n]
+    uint16_t y_mask;                            //Pressed y axis channels, bit n is device[x_channel_num + n]
+    uint16_t x_pending;                         //x axis channels not resolved into a key yet (multi-touch)
+    uint16_t y_pending;                         //y axis channels not resolved into a key yet (multi-touch)
+    uint8_t pending_cnt;                        //Processing periods the pending channels have been stable for
+    uint8_t key_max;                            //Most keys reported at the same time, 1 for single touch
+    uint8_t key_num;                            //The number of pressed keys (multi-touch)
+    te_matrix_key_t key[TOUCH_MATRIX_MAX_KEY_NUM];  //Pressed keys (multi-touch)
 };
 
 typedef struct te_matrix_s *te_matrix_handle_t;
@@ -193,6 +210,8 @@ bool is_matrix_object_handle(touch_elem_handle_t element_handle);
 void button_enable_wakeup_calibration(te_button_handle_t button_handle, bool en);
 void slider_enable_wakeup_calibration(te_slider_handle_t slider_handle, bool en);
 void matrix_enable_wakeup_calibration(te_matrix_handle_t matrix_handle, bool en);
+/* Slider position before filtering for the given smooth signals, by the float or the fixed-point calculation (for test) */
+uint32_t slider_calculate_raw_position(te_slider_handle_t slider_handle, const uint32_t *smooth_signal, bool fixed_point);
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 #ifdef __cplusplus
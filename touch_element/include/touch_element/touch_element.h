@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include "touch_sensor_legacy_types.h"
 
 #ifdef __cplusplus
@@ -36,9 +37,23 @@ extern "C" {
         .waterproof_threshold_divider = 0.8,                                  \
         .processing_period = 10,                                              \
         .intr_message_size = 14,                                              \
-        .event_message_size = 20                                              \
+        .event_message_size = 20,                                             \
+        .processing_mode = TOUCH_ELEM_PROC_TIMER,                             \
+        .processing_task_priority = 5,                                        \
+        .processing_task_stack_size = 4096,                                   \
+        .processing_task_core = TOUCH_ELEM_PROC_TASK_NO_AFFINITY,             \
+        .idle_processing_period = 0,                                          \
+        .event_delivery = TOUCH_ELEM_EVENT_DELIVERY_QUEUE,                    \
+        .coalesce_slider_position = false                                     \
     }                                                                         \
 }
+
+#define TOUCH_ELEM_AUTOTUNE_DEFAULT_CONFIG()                                  \
+{                                                                             \
+    .target_snr = 5.0,                                                        \
+    .min_sample_count = 50,                                                   \
+    .scan_count = 32,                                                         \
+}
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 /* ---------------------------------------------- Event subscription  ----------------------------------------------- */
@@ -49,7 +64,29 @@ extern "C" {
 #define TOUCH_ELEM_EVENT_ON_CALCULATION             BIT(4)      //!< On Calculation event
 /* ------------------------------------------------------------------------------------------------------------------ */
 #define TOUCH_WATERPROOF_GUARD_NOUSE       (0)         //!< Waterproof no use guard sensor
+#define TOUCH_ELEM_PROC_IDLE_STOP          (UINT16_MAX) //!< Idle processing period which stops the processing timer
+#define TOUCH_ELEM_PROC_TASK_NO_AFFINITY   (-1)         //!< Processing task core which lets the task run on any core
 /* -------------------------------- Global hardware & software configuration struct --------------------------------- */
+/**
+ * @brief   Touch element interrupt message processing mode
+ */
+typedef enum {
+    TOUCH_ELEM_PROC_TIMER,          //!< The esp_timer routine processes one interrupt message every processing period
+    TOUCH_ELEM_PROC_TASK,           //!< A task processes all the interrupt messages as soon as the interrupt sends them,
+                                    //!< the esp_timer routine only runs the periodic processing (long press, calculation)
+    TOUCH_ELEM_PROC_DEDICATED_TASK, //!< The task of TOUCH_ELEM_PROC_TASK also runs the periodic processing (the element
+                                    //!< state machines), the esp_timer routine only wakes it up
+} touch_elem_proc_mode_t;
+
+/**
+ * @brief   Touch element event message delivery
+ */
+typedef enum {
+    TOUCH_ELEM_EVENT_DELIVERY_QUEUE,    //!< Every event message is sent to a FreeRTOS queue
+    TOUCH_ELEM_EVENT_DELIVERY_RING,     //!< Event messages are written to a lock-free ring buffer, the receiving task
+                                        //!< is woken up once per processing pass (single receiving task only)
+} touch_elem_event_delivery_t;
+
 /**
  * @brief   Touch element software configuration
  */
@@ -58,6 +95,16 @@ typedef struct {
     uint8_t processing_period;                 //!< Processing period(ms)
     uint8_t intr_message_size;                 //!< Interrupt message queue size
     uint8_t event_message_size;                //!< Event message queue size
+    touch_elem_proc_mode_t processing_mode;    //!< Interrupt message processing mode
+    uint8_t processing_task_priority;          //!< Processing task priority (task processing modes only)
+    uint32_t processing_task_stack_size;       //!< Processing task stack size in bytes (task processing modes only)
+    int processing_task_core;                  //!< Core the processing task is pinned to, TOUCH_ELEM_PROC_TASK_NO_AFFINITY
+                                               //!< for any core (task processing modes only)
+    uint16_t idle_processing_period;           //!< Processing period(ms) while no channel is touched, 0 to keep processing_period,
+                                               //!< TOUCH_ELEM_PROC_IDLE_STOP to stop the timer (task processing modes only)
+    touch_elem_event_delivery_t event_delivery; //!< Event message delivery, event_message_size is the ring size too
+    bool coalesce_slider_position;             //!< touch_element_message_receive_many() only returns the last one of
+                                               //!< consecutive slider calculation messages of the same slider
 } touch_elem_sw_config_t;
 
 /**
@@ -133,6 +180,60 @@ typedef struct {
     void *arg;                              //!< User input argument
     uint8_t child_msg[8];                   //!< Encoded message
 } touch_elem_message_t;
+
+/**
+ * @brief   Touch element processing statistics from touch_element_get_proc_stats()
+ */
+typedef struct {
+    uint32_t timer_wakeups;                 //!< Number of runs of the processing timer routine since touch_element_start()
+    uint32_t task_wakeups;                  //!< Number of wake-ups of the processing task since touch_element_start(),
+                                            //!< the ones by the processing timer count as timer_wakeups
+    float wakeups_per_sec;                  //!< Timer and task wake-ups per second since the previous call, or since start
+    bool is_idle;                           //!< The processing timer runs at the idle processing period or is stopped
+} touch_elem_proc_stats_t;
+
+#define TOUCH_ELEM_PROC_TIME_HIST_BINS  (16)    //!< Number of bins of the processing time histogram
+
+/**
+ * @brief   Touch element processing time histogram from touch_element_get_proc_time_hist()
+ */
+typedef struct {
+    uint32_t bins[TOUCH_ELEM_PROC_TIME_HIST_BINS];  //!< bins[0]: passes under 1 us, bins[n]: passes of [2^(n-1), 2^n) us, the last bin also counts the longer passes
+    uint32_t count;                         //!< Number of processing passes measured
+    uint32_t max_time;                      //!< Longest processing pass (us)
+} touch_elem_proc_time_hist_t;
+
+/**
+ * @brief   Touch element trace sample from touch_element_trace_read()
+ */
+typedef struct {
+    int64_t timestamp;                      //!< Time of the processing pass (us, from esp_timer_get_time())
+    touch_pad_t channel;                    //!< Touch sensor channel
+    uint32_t raw;                           //!< Raw signal
+    uint32_t smooth;                        //!< Smooth signal, the one compared with the threshold
+    uint32_t benchmark;                     //!< Benchmark (baseline) signal
+} touch_elem_trace_sample_t;
+
+/**
+ * @brief   Touch element auto-tuning configuration passed to touch_element_autotune()
+ */
+typedef struct {
+    float target_snr;                       //!< Signal to noise ratio each channel must reach, the signal is the touch threshold
+                                            //!< (sensitivity * smooth signal), the noise is the peak to peak of the smooth signal
+    uint16_t min_sample_count;              //!< Smallest sample count tried, doubled up to the configured sample_count
+    uint16_t scan_count;                    //!< Scans measured for each candidate setting
+} touch_elem_autotune_config_t;
+
+/**
+ * @brief   Touch element auto-tuning result from touch_element_autotune()
+ */
+typedef struct {
+    uint16_t sample_count;                  //!< Chosen sample count in each measurement
+    touch_smooth_mode_t smooth_filter_mode; //!< Chosen smooth value filter mode
+    float snr;                              //!< Worst signal to noise ratio of the channels with the chosen settings
+    touch_pad_t worst_channel;              //!< Channel with the worst signal to noise ratio
+    uint32_t scan_period;                   //!< Measured period (us) of one scan of all the channels with the chosen settings
+} touch_elem_autotune_result_t;
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 /**
@@ -199,6 +300,152 @@ void touch_element_uninstall(void);
  */
 esp_err_t touch_element_message_receive(touch_elem_message_t *element_message, uint32_t ticks_to_wait);
 
+/**
+ * @brief   Get all the pending event messages of touch element instance
+ *
+ * This function will receive up to max_messages touch element messages at once. It will block until at least one
+ * touch element event or a timeout occurs, then return all the messages available without blocking again.
+ *
+ * @param[out]  element_messages    Array of at least max_messages touch element event message structures
+ * @param[in]   max_messages        Maximum number of messages to receive
+ * @param[out]  received            Number of messages written to element_messages
+ * @param[in]   ticks_to_wait       Number of FreeRTOS ticks to block for waiting the first event
+ *
+ * @note    With TOUCH_ELEM_EVENT_DELIVERY_RING, only one task may receive the event messages, by this function
+ *          or by touch_element_message_receive().
+ *
+ * @note    If coalesce_slider_position is set, consecutive slider calculation messages of the same slider are
+ *          merged into the last one of them, the returned messages keep their order.
+ *
+ * @return
+ *      - ESP_OK: Successfully received at least one touch element event
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ *      - ESP_ERR_INVALID_ARG: element_messages or received is null, or max_messages is 0
+ *      - ESP_ERR_TIMEOUT: Timed out waiting for event
+ */
+esp_err_t touch_element_message_receive_many(touch_elem_message_t *element_messages, size_t max_messages,
+                                             size_t *received, uint32_t ticks_to_wait);
+
+/**
+ * @brief   Get the processing statistics of the touch element library
+ *
+ * This function reports how often the library wakes up the CPU, e.g. to check the effect of the
+ * idle processing period on the light sleep residency.
+ *
+ * @param[out]  stats   Processing statistics
+ * @return
+ *      - ESP_OK: Successfully got the statistics
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ *      - ESP_ERR_INVALID_ARG: stats is null
+ */
+esp_err_t touch_element_get_proc_stats(touch_elem_proc_stats_t *stats);
+
+/**
+ * @brief   Start recording the signals of touch sensor channels
+ *
+ * Every processing pass records a sample of the raw, smooth and benchmark signals of each channel
+ * in channel_mask into the trace buffer of CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE samples, the
+ * oldest samples are overwritten once it is full. This is meant for tuning the channel sensitivity
+ * and the processing period at run time.
+ *
+ * @param[in]   channel_mask    Channels to record, bit n is touch channel n, 0 only clears the trace buffer
+ *
+ * @note    Needs CONFIG_TOUCH_ELEMENT_TRACE. Starting again clears the trace buffer and the processing time histogram.
+ *
+ * @return
+ *      - ESP_OK: Successfully started recording
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_TOUCH_ELEMENT_TRACE is disabled
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ *      - ESP_ERR_INVALID_ARG: channel_mask contains an invalid channel
+ *      - ESP_ERR_NO_MEM: Insufficient memory for the trace buffer
+ */
+esp_err_t touch_element_trace_start(uint32_t channel_mask);
+
+/**
+ * @brief   Stop recording the signals of touch sensor channels
+ *
+ * The recorded samples stay in the trace buffer until read or until the next touch_element_trace_start().
+ *
+ * @return
+ *      - ESP_OK: Successfully stopped recording
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_TOUCH_ELEMENT_TRACE is disabled
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ */
+esp_err_t touch_element_trace_stop(void);
+
+/**
+ * @brief   Read and remove the oldest samples of the trace buffer
+ *
+ * @param[out]  samples         Array receiving the samples, oldest first
+ * @param[in]   max_samples     Capacity of samples
+ * @param[out]  read            Number of samples written to samples, 0 if the trace buffer is empty
+ *
+ * @return
+ *      - ESP_OK: Successfully read the trace buffer
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_TOUCH_ELEMENT_TRACE is disabled
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ *      - ESP_ERR_INVALID_ARG: samples or read is null
+ */
+esp_err_t touch_element_trace_read(touch_elem_trace_sample_t *samples, size_t max_samples, size_t *read);
+
+/**
+ * @brief   Print the processing time histogram and the trace buffer
+ *
+ * Prints the histogram, then reads out the trace buffer as CSV lines `TETRACE,<timestamp>,<channel>,<raw>,<smooth>,<benchmark>`
+ * on stdout. Call it from a console command, or periodically from a task to stream the samples.
+ *
+ * @return
+ *      - ESP_OK: Successfully printed the trace
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_TOUCH_ELEMENT_TRACE is disabled
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ */
+esp_err_t touch_element_trace_print(void);
+
+/**
+ * @brief   Get the histogram of the processing pass durations
+ *
+ * A processing pass is one run of the processing timer routine, or one wake-up of the processing
+ * task in the task processing modes. Its duration must stay well below the processing period.
+ *
+ * @param[out]  hist    Processing time histogram since touch_element_install() or touch_element_trace_start()
+ *
+ * @note    Needs CONFIG_TOUCH_ELEMENT_TRACE
+ *
+ * @return
+ *      - ESP_OK: Successfully got the histogram
+ *      - ESP_ERR_NOT_SUPPORTED: CONFIG_TOUCH_ELEMENT_TRACE is disabled
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized
+ *      - ESP_ERR_INVALID_ARG: hist is null
+ */
+esp_err_t touch_element_get_proc_time_hist(touch_elem_proc_time_hist_t *hist);
+
+/**
+ * @brief   Choose the sample count and the smooth filter mode from the measured noise floor
+ *
+ * This function scans the initialized channels with increasing settings, starting from min_sample_count
+ * without smooth filter, and applies the first one with which every channel reaches target_snr: for each
+ * sample count (doubled up to the sample_count of touch_element_install()), the smooth filter modes are
+ * tried from TOUCH_PAD_SMOOTH_OFF to TOUCH_PAD_SMOOTH_IIR_8. A shorter measurement lowers the response
+ * latency and the power consumption, the sleep cycle is not changed.
+ *
+ * @param[in]   config  Auto-tuning configuration
+ * @param[out]  result  Chosen settings, or the configured ones if no setting reaches target_snr
+ *
+ * @note    This function must be called after all the touch element instances finished creating and before
+ *          touch_element_start(), while no channel is touched. It takes scan_count scans per tried setting.
+ *
+ * @note    The sample count of the light/deep sleep configuration is not changed, see touch_elem_sleep_config_t
+ *
+ * @return
+ *      - ESP_OK: Successfully applied a setting reaching target_snr
+ *      - ESP_ERR_NOT_FOUND: No setting reaches target_snr, the configured settings are kept
+ *      - ESP_ERR_INVALID_STATE: Touch element library is not initialized, started, or has no channel
+ *      - ESP_ERR_INVALID_ARG: Invalid argument
+ *      - ESP_ERR_NO_MEM: Insufficient memory
+ *      - ESP_ERR_TIMEOUT: The touch sensor did not finish a scan
+ */
+esp_err_t touch_element_autotune(const touch_elem_autotune_config_t *config, touch_elem_autotune_result_t *result);
+
 /**
  * @brief   Touch element waterproof initialization
  *
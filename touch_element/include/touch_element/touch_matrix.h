@@ -19,6 +19,8 @@ extern "C" {
     .default_lp_time = 1000                                                   \
 }
 /* ------------------------------------------------------------------------------------------------------------------ */
+#define TOUCH_MATRIX_MAX_KEY_NUM    (2)     //!< Most keys of a matrix button pressed at the same time (2-key rollover)
+
 /**
  * @brief   Matrix button initialization configuration passed to touch_matrix_install
  */
@@ -37,6 +39,7 @@ typedef struct {
     const float *y_sensitivity_array;        //!< Matrix button y-axis channels sensitivity array
     uint8_t x_channel_num;                   //!< The number of channels in x-axis
     uint8_t y_channel_num;                   //!< The number of channels in y-axis
+    uint8_t max_key_num;                     //!< Most keys reported at the same time, 0 or 1 for single touch, up to TOUCH_MATRIX_MAX_KEY_NUM
 } touch_matrix_config_t;
 
 /**
@@ -99,7 +102,9 @@ void touch_matrix_uninstall(void);
  *
  * @note    Channel array and sensitivity array must be one-one correspondence in those array
  *
- * @note    Touch matrix button does not support Multi-Touch now
+ * @note    Touch matrix button supports Multi-Touch of up to TOUCH_MATRIX_MAX_KEY_NUM keys, set with max_key_num.
+ *          Two keys pressed at the same time on different rows and columns are not reported before one of
+ *          them is pressed alone, since the sensor can not tell them from the other diagonal of the rectangle.
  *
  * @return
  *      - ESP_OK: Successfully create touch matrix button
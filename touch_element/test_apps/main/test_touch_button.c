@@ -65,6 +65,8 @@ void test_button_handler(touch_button_handle_t handle, touch_button_message_t *m
 static void test_button_event_change_lp(void);
 static void test_button_callback_change_lp(void);
 static void test_button_change_lp_handler(touch_button_handle_t handle, touch_button_message_t *message, void *arg);
+/* ------------------------------------------------ Idle processing test -------------------------------------------- */
+static void test_button_idle_processing(void);
 /* ------------------------------------------------ Concurrent test ------------------------------------------------- */
 static void test_button_event_concurrent(void);
 static void test_button_random_trigger_concurrent(void);
@@ -81,6 +83,37 @@ TEST_CASE("Touch button dispatch methods test", "[button][touch_element]")
     touch_element_uninstall();
 }
 
+TEST_CASE("Touch button dispatch methods test with task processing", "[button][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    global_config.software.processing_mode = TOUCH_ELEM_PROC_TASK;
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_button_disp_event();
+    test_button_disp_callback();
+    touch_element_uninstall();
+}
+
+TEST_CASE("Touch button dispatch methods test with dedicated task processing", "[button][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    global_config.software.processing_mode = TOUCH_ELEM_PROC_DEDICATED_TASK;
+    global_config.software.processing_task_core = portNUM_PROCESSORS - 1;
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_button_disp_event();
+    test_button_disp_callback();
+    touch_element_uninstall();
+}
+
+TEST_CASE("Touch button idle processing test", "[button][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    global_config.software.processing_mode = TOUCH_ELEM_PROC_TASK;
+    global_config.software.idle_processing_period = TOUCH_ELEM_PROC_IDLE_STOP;
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_button_idle_processing();
+    touch_element_uninstall();
+}
+
 TEST_CASE("Touch button run-time test", "[button][touch_element]")
 {
     touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
@@ -221,6 +254,49 @@ static void test_button_disp_event(void)
     touch_button_uninstall();
 }
 
+static void test_button_idle_processing(void)
+{
+    touch_button_handle_t button_handle;
+    touch_elem_proc_stats_t stats;
+    touch_button_global_config_t global_config = TOUCH_BUTTON_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_button_install(&global_config));
+    touch_button_config_t button_config = {
+        .channel_num = button_channel_array[0],
+        .channel_sens = 0.1F
+    };
+    TEST_ESP_OK(touch_button_create(&button_config, &button_handle));
+    TEST_ESP_OK(touch_button_subscribe_event(button_handle, TOUCH_ELEM_EVENT_ON_PRESS | TOUCH_ELEM_EVENT_ON_RELEASE,
+                (void *) button_channel_array[0]));
+    TEST_ESP_OK(touch_button_set_dispatch_method(button_handle, TOUCH_ELEM_DISP_EVENT));
+    TEST_ESP_OK(touch_element_start());
+
+    vTaskDelay(pdMS_TO_TICKS(500));  //Mention in README, code-block-1
+    TEST_ESP_OK(touch_element_get_proc_stats(&stats));
+    TEST_ASSERT_TRUE(stats.is_idle);
+
+    //The processing timer is stopped, nothing wakes up the library until the next touch
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    TEST_ESP_OK(touch_element_get_proc_stats(&stats));
+    printf("Idle wake-ups per second: %.1f\n", stats.wakeups_per_sec);
+    TEST_ASSERT_TRUE(stats.is_idle);
+    TEST_ASSERT_LESS_THAN_FLOAT(1.0F, stats.wakeups_per_sec);
+
+    //The first press switches back to the processing period
+    for (int i = 0; i < 3; i++) {
+        test_button_event_trigger_and_check(button_handle, TOUCH_BUTTON_EVT_ON_PRESS);
+        TEST_ESP_OK(touch_element_get_proc_stats(&stats));
+        TEST_ASSERT_FALSE(stats.is_idle);
+        test_button_event_trigger_and_check(button_handle, TOUCH_BUTTON_EVT_ON_RELEASE);
+        vTaskDelay(pdMS_TO_TICKS(500));
+        TEST_ESP_OK(touch_element_get_proc_stats(&stats));
+        TEST_ASSERT_TRUE(stats.is_idle);
+    }
+
+    TEST_ESP_OK(touch_element_stop());
+    TEST_ESP_OK(touch_button_delete(button_handle));
+    touch_button_uninstall();
+}
+
 static void test_button_disp_callback(void)
 {
     test_monitor_t monitor;
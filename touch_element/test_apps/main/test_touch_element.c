@@ -24,12 +24,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "unity.h"
+#include "sdkconfig.h"
 
 #include "touch_element/touch_button.h"
 #include "touch_element/touch_slider.h"
@@ -56,6 +58,10 @@ static void test_waterproof_event_simulator(touch_pad_t guard_channel, touch_but
 static void test_system_waterproof_guard(void);
 static void test_integrat_btn_sld_mat(void);
 static void test_integration_monitor_task(void *arg);
+static void test_system_autotune(void);
+#if CONFIG_TOUCH_ELEMENT_TRACE
+static void test_system_trace(void);
+#endif
 /* ------------------------------------------------------------------------------------------------------------------ */
 TEST_CASE("Touch element integration test", "[touch_element]")
 {
@@ -73,6 +79,24 @@ TEST_CASE("Touch element waterproof test", "[touch_element]")
     touch_element_uninstall();
 }
 
+TEST_CASE("Touch element auto-tuning test", "[touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_system_autotune();
+    touch_element_uninstall();
+}
+
+#if CONFIG_TOUCH_ELEMENT_TRACE
+TEST_CASE("Touch element trace test", "[touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_system_trace();
+    touch_element_uninstall();
+}
+#endif
+
 static void test_system_waterproof_guard(void)
 {
     static const touch_pad_t button_channel_array[12] = {
@@ -418,3 +442,102 @@ static void test_integration_monitor_task(void *arg)
         xSemaphoreGive(monitor->response_sig_handle);
     }
 }
+
+#if CONFIG_TOUCH_ELEMENT_TRACE
+static void test_system_trace(void)
+{
+    touch_button_handle_t button_handle;
+    touch_elem_proc_time_hist_t hist;
+    static touch_elem_trace_sample_t samples[CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE];
+    size_t read;
+    touch_button_global_config_t button_global_config = TOUCH_BUTTON_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_button_install(&button_global_config));
+    touch_button_config_t button_config = {
+        .channel_num = TOUCH_PAD_NUM5,
+        .channel_sens = 0.1F
+    };
+    TEST_ESP_OK(touch_button_create(&button_config, &button_handle));
+    TEST_ASSERT(touch_element_trace_start(BIT(TOUCH_PAD_NUM0)) == ESP_ERR_INVALID_ARG);  //De-noise channel
+    TEST_ASSERT(touch_element_trace_start(BIT(TOUCH_PAD_MAX)) == ESP_ERR_INVALID_ARG);
+    TEST_ESP_OK(touch_element_trace_start(BIT(TOUCH_PAD_NUM5)));
+    TEST_ESP_OK(touch_element_start());
+
+    vTaskDelay(pdMS_TO_TICKS(500));  //Mention in README, code-block-1
+    TEST_ESP_OK(touch_element_trace_stop());
+    TEST_ESP_OK(touch_element_stop());
+
+    TEST_ESP_OK(touch_element_get_proc_time_hist(&hist));
+    uint32_t hist_sum = 0;
+    for (int bin = 0; bin < TOUCH_ELEM_PROC_TIME_HIST_BINS; bin++) {
+        hist_sum += hist.bins[bin];
+    }
+    printf("Touch element processing passes: %"PRIu32", longest: %"PRIu32" us\n", hist.count, hist.max_time);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, hist.count);
+    TEST_ASSERT_EQUAL_UINT32(hist.count, hist_sum);
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ASSERT_LESS_THAN_UINT32(global_config.software.processing_period * 1000, hist.max_time);
+
+    TEST_ESP_OK(touch_element_trace_read(samples, CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE, &read));
+    TEST_ASSERT_GREATER_THAN(0, read);
+    for (size_t idx = 0; idx < read; idx++) {
+        TEST_ASSERT_EQUAL(TOUCH_PAD_NUM5, samples[idx].channel);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, samples[idx].smooth);
+        TEST_ASSERT_GREATER_THAN_UINT32(0, samples[idx].benchmark);
+        if (idx > 0) {
+            TEST_ASSERT_TRUE(samples[idx].timestamp > samples[idx - 1].timestamp);
+        }
+    }
+    TEST_ESP_OK(touch_element_trace_read(samples, CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE, &read));
+    TEST_ASSERT_EQUAL(0, read);  //Read out
+
+    TEST_ESP_OK(touch_button_delete(button_handle));
+    touch_button_uninstall();
+}
+#endif
+
+static void test_system_autotune(void)
+{
+    touch_button_handle_t button_handle;
+    touch_elem_autotune_result_t result;
+    uint16_t sample_count;
+    touch_elem_autotune_config_t autotune_config = TOUCH_ELEM_AUTOTUNE_DEFAULT_CONFIG();
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ASSERT(touch_element_autotune(&autotune_config, &result) == ESP_ERR_INVALID_STATE);  //No channel yet
+    touch_button_global_config_t button_global_config = TOUCH_BUTTON_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_button_install(&button_global_config));
+    touch_button_config_t button_config = {
+        .channel_num = TOUCH_PAD_NUM5,
+        .channel_sens = 0.1F
+    };
+    TEST_ESP_OK(touch_button_create(&button_config, &button_handle));
+    TEST_ESP_OK(touch_button_subscribe_event(button_handle, TOUCH_ELEM_EVENT_ON_PRESS | TOUCH_ELEM_EVENT_ON_RELEASE, NULL));
+    TEST_ESP_OK(touch_button_set_dispatch_method(button_handle, TOUCH_ELEM_DISP_EVENT));
+
+    autotune_config.target_snr = 1e9;  //Unreachable, the configured settings are kept
+    TEST_ASSERT(touch_element_autotune(&autotune_config, &result) == ESP_ERR_NOT_FOUND);
+    TEST_ASSERT_EQUAL_UINT16(global_config.hardware.sample_count, result.sample_count);
+    TEST_ASSERT_EQUAL(global_config.hardware.smooth_filter_mode, result.smooth_filter_mode);
+    touch_ll_get_measure_times(&sample_count);
+    TEST_ASSERT_EQUAL_UINT16(global_config.hardware.sample_count, sample_count);
+
+    autotune_config.target_snr = 5.0;
+    TEST_ESP_OK(touch_element_autotune(&autotune_config, &result));
+    printf("Touch element auto-tuning: sample count %"PRIu16", smooth filter %d, snr %.1f, scan period %"PRIu32" us\n",
+           result.sample_count, result.smooth_filter_mode, result.snr, result.scan_period);
+    TEST_ASSERT_EQUAL(TOUCH_PAD_NUM5, result.worst_channel);
+    TEST_ASSERT_TRUE(result.snr >= autotune_config.target_snr);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT16(global_config.hardware.sample_count, result.sample_count);
+    touch_ll_get_measure_times(&sample_count);
+    TEST_ASSERT_EQUAL_UINT16(result.sample_count, sample_count);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, result.scan_period);
+
+    TEST_ESP_OK(touch_element_start());  //The tuned settings work as usual
+    vTaskDelay(pdMS_TO_TICKS(100));  //Mention in README, code-block-1
+    test_button_event_trigger_and_check(button_handle, TOUCH_BUTTON_EVT_ON_PRESS);
+    test_button_event_trigger_and_check(button_handle, TOUCH_BUTTON_EVT_ON_RELEASE);
+    TEST_ASSERT(touch_element_autotune(&autotune_config, &result) == ESP_ERR_INVALID_STATE);  //Started
+    TEST_ESP_OK(touch_element_stop());
+
+    TEST_ESP_OK(touch_button_delete(button_handle));
+    touch_button_uninstall();
+}
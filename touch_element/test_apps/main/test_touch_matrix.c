@@ -62,6 +62,9 @@ static void test_matrix_callback_change_lp(void);
 static void test_matrix_change_lp_handler(touch_matrix_handle_t out_handle, touch_matrix_message_t *out_message, void *arg);
 /* ----------------------------------------------- Random channel trigger test -------------------------------------- */
 static void test_matrix_random_channel_trigger(void);
+/* ----------------------------------------------- Multi-touch test ------------------------------------------------- */
+static void test_matrix_multi_touch(void);
+static void test_matrix_message_check(touch_matrix_handle_t handle, touch_matrix_event_t matrix_event, uint32_t pos_index);
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 TEST_CASE("Touch matrix dispatch methods test", "[matrix][touch_element]")
@@ -90,6 +93,14 @@ TEST_CASE("Touch matrix random channel trigger test", "[matrix][touch_element]")
     touch_element_uninstall();
 }
 
+TEST_CASE("Touch matrix multi-touch test", "[matrix][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_matrix_multi_touch();
+    touch_element_uninstall();
+}
+
 void test_matrix_event_simulator(touch_matrix_handle_t matrix_handle, touch_matrix_event_t matrix_event, uint32_t pos_index)
 {
     te_matrix_handle_t te_matrix = (te_matrix_handle_t) matrix_handle;
@@ -454,3 +465,88 @@ static void test_matrix_change_lp_handler(touch_matrix_handle_t out_handle, touc
     xSemaphoreGive(monitor->response_sig_handle);
     TEST_ESP_OK(touch_matrix_set_longpress(valid_message.handle, 300)); // Always 300ms
 }
+
+static void test_matrix_message_check(touch_matrix_handle_t handle, touch_matrix_event_t matrix_event, uint32_t pos_index)
+{
+    touch_elem_message_t valid_message = {
+        .handle = handle,
+        .element_type = TOUCH_ELEM_TYPE_MATRIX,
+        .arg = NULL
+    };
+    touch_matrix_message_t matrix_message = {
+        .event = matrix_event,
+        .position.index = pos_index,
+        .position.x_axis = pos_index / MATRIX_CHANNEL_NUM_Y,
+        .position.y_axis = pos_index % MATRIX_CHANNEL_NUM_Y
+    };
+    memcpy(valid_message.child_msg, &matrix_message, sizeof(touch_matrix_message_t));  //Construct valid_message
+
+    touch_elem_message_t current_message;
+    esp_err_t ret = touch_element_message_receive(&current_message, pdMS_TO_TICKS(500));
+    TEST_ASSERT_MESSAGE(ret == ESP_OK, "matrix event receive timeout");
+    test_matrix_event_check(&valid_message, &current_message);  //Verification
+}
+
+static void test_matrix_multi_touch(void)
+{
+    touch_matrix_handle_t matrix_handle = NULL;
+    touch_elem_message_t current_message;
+    touch_matrix_global_config_t global_config = TOUCH_MATRIX_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_matrix_install(&global_config));
+    touch_matrix_config_t matrix_config = {
+        .x_channel_array = x_axis_channel,
+        .y_channel_array = y_axis_channel,
+        .x_sensitivity_array = x_axis_channel_sens,
+        .y_sensitivity_array = y_axis_channel_sens,
+        .x_channel_num = MATRIX_CHANNEL_NUM_X,
+        .y_channel_num = MATRIX_CHANNEL_NUM_Y,
+        .max_key_num = TOUCH_MATRIX_MAX_KEY_NUM + 1
+    };
+    TEST_ASSERT(touch_matrix_create(&matrix_config, &matrix_handle) == ESP_ERR_INVALID_ARG);
+    matrix_config.max_key_num = TOUCH_MATRIX_MAX_KEY_NUM;
+    TEST_ESP_OK(touch_matrix_create(&matrix_config, &matrix_handle));
+    TEST_ESP_OK(touch_matrix_subscribe_event(matrix_handle, TOUCH_ELEM_EVENT_ON_PRESS | TOUCH_ELEM_EVENT_ON_RELEASE, NULL));
+    TEST_ESP_OK(touch_matrix_set_dispatch_method(matrix_handle, TOUCH_ELEM_DISP_EVENT));
+    TEST_ESP_OK(touch_element_start());
+
+    vTaskDelay(pdMS_TO_TICKS(500));  //Mention in README, code-block-1
+
+    printf("Touch matrix multi-touch test start\n");
+    /*< Two keys on different rows and columns, pressed one after the other (0 = (x0, y0), 4 = (x1, y1)) */
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 0);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 0);
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 4);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 4);
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 0);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 0);
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 4);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 4);
+
+    /*< Two keys sharing the y0 channel (0 = (x0, y0), 3 = (x1, y0)) */
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 0);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 0);
+    test_matrix_channel_simulator(x_axis_channel[1], TOUCH_MATRIX_EVT_ON_PRESS);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 3);
+    test_matrix_channel_simulator(x_axis_channel[0], TOUCH_MATRIX_EVT_ON_RELEASE);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 0);
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 3);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 3);
+
+    /*< Two diagonal keys pressed at the same time are ambiguous, no ghost key must be reported */
+    test_matrix_channel_simulator(x_axis_channel[0], TOUCH_MATRIX_EVT_ON_PRESS);
+    test_matrix_channel_simulator(x_axis_channel[1], TOUCH_MATRIX_EVT_ON_PRESS);
+    test_matrix_channel_simulator(y_axis_channel[0], TOUCH_MATRIX_EVT_ON_PRESS);
+    test_matrix_channel_simulator(y_axis_channel[1], TOUCH_MATRIX_EVT_ON_PRESS);
+    TEST_ASSERT_MESSAGE(touch_element_message_receive(&current_message, pdMS_TO_TICKS(500)) == ESP_ERR_TIMEOUT,
+                        "Matrix ghost key invalid trigger");
+    /*< Once one of them is released, the other one is resolved */
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 4);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_PRESS, 0);
+    test_matrix_event_simulator(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 0);
+    test_matrix_message_check(matrix_handle, TOUCH_MATRIX_EVT_ON_RELEASE, 0);
+    printf("Touch matrix multi-touch test finish\n");
+
+    TEST_ESP_OK(touch_element_stop());
+    TEST_ESP_OK(touch_matrix_delete(matrix_handle));
+    touch_matrix_uninstall();
+}
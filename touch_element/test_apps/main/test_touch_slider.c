@@ -48,6 +48,10 @@ void test_slider_callback_trigger_and_check(touch_slider_handle_t handle, touch_
 static void test_slider_disp_event(void);
 static void test_slider_disp_callback(void);
 static void test_slider_handler(touch_slider_handle_t handle, touch_slider_message_t *message, void *arg);
+/* ------------------------------------------------ Bulk receive test ----------------------------------------------- */
+static void test_slider_receive_many_coalesce(void);
+/* ------------------------------------------------ Fixed-point position test --------------------------------------- */
+static void test_slider_fixed_point_position(void);
 /* ------------------------------------------------------------------------------------------------------------------ */
 
 TEST_CASE("Touch slider dispatch methods test", "[slider][touch_element]")
@@ -59,6 +63,34 @@ TEST_CASE("Touch slider dispatch methods test", "[slider][touch_element]")
     touch_element_uninstall();
 }
 
+TEST_CASE("Touch slider dispatch methods test with ring event delivery", "[slider][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    global_config.software.event_delivery = TOUCH_ELEM_EVENT_DELIVERY_RING;
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_slider_disp_event();
+    test_slider_disp_callback();
+    touch_element_uninstall();
+}
+
+TEST_CASE("Touch slider fixed-point position test", "[slider][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_slider_fixed_point_position();
+    touch_element_uninstall();
+}
+
+TEST_CASE("Touch slider bulk receive coalescing test", "[slider][touch_element]")
+{
+    touch_elem_global_config_t global_config = TOUCH_ELEM_GLOBAL_DEFAULT_CONFIG();
+    global_config.software.event_delivery = TOUCH_ELEM_EVENT_DELIVERY_RING;
+    global_config.software.coalesce_slider_position = true;
+    TEST_ESP_OK(touch_element_install(&global_config));
+    test_slider_receive_many_coalesce();
+    touch_element_uninstall();
+}
+
 void test_slider_event_simulator(touch_slider_handle_t slider_handle, touch_slider_event_t slider_event, uint32_t random)
 {
     te_slider_handle_t te_slider = (te_slider_handle_t) slider_handle;
@@ -217,3 +249,108 @@ static void test_slider_handler(touch_slider_handle_t handle, touch_slider_messa
 
     xSemaphoreGive(monitor->response_sig_handle);
 }
+
+/* Receives messages until the given slider event, no two calculation messages may be consecutive */
+static void test_slider_receive_many_until(touch_slider_event_t slider_event)
+{
+    touch_elem_message_t messages[20];
+    bool is_prev_calculation = false;
+    while (1) {
+        size_t received = 0;
+        esp_err_t ret = touch_element_message_receive_many(messages, 20, &received, 300);
+        TEST_ASSERT_MESSAGE(ret == ESP_OK, "slider event receive timeout");
+        TEST_ASSERT(received > 0 && received <= 20);
+        for (size_t i = 0; i < received; i++) {
+            const touch_slider_message_t *slider_message = touch_slider_get_message(&messages[i]);
+            bool is_calculation = slider_message->event == TOUCH_SLIDER_EVT_ON_CALCULATION;
+            TEST_ASSERT_MESSAGE(!(is_calculation && is_prev_calculation), "slider positions not coalesced");
+            if (slider_message->event == slider_event) {
+                return;
+            }
+            is_prev_calculation = is_calculation;
+        }
+        is_prev_calculation = false;  //The next batch may start with a new position
+    }
+}
+
+static void test_slider_receive_many_coalesce(void)
+{
+    touch_slider_handle_t slider_handle;
+    touch_slider_global_config_t global_config = TOUCH_SLIDER_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_slider_install(&global_config));
+    touch_slider_config_t slider_config = {
+        .channel_array = slider_channel_array,
+        .sensitivity_array = slider_sens_array,
+        .channel_num = SLIDER_CHANNEL_NUM,
+        .position_range = 101
+    };
+    TEST_ESP_OK(touch_slider_create(&slider_config, &slider_handle));
+    TEST_ESP_OK(touch_slider_subscribe_event(slider_handle, TOUCH_ELEM_EVENT_ON_PRESS | TOUCH_ELEM_EVENT_ON_RELEASE |
+                                             TOUCH_ELEM_EVENT_ON_CALCULATION, (void *) slider_handle));
+    TEST_ESP_OK(touch_slider_set_dispatch_method(slider_handle, TOUCH_ELEM_DISP_EVENT));
+    TEST_ESP_OK(touch_element_start());
+
+    vTaskDelay(pdMS_TO_TICKS(500));  //Mention in README, code-block-1
+
+    srandom((unsigned int)time(NULL));
+    printf("Touch slider bulk receive test start\n");
+    for (int i = 0; i < 10; i++) {
+        printf("Touch slider bulk receive test... (%d/10)\n", i + 1);
+        uint32_t random_channel = random() % SLIDER_CHANNEL_NUM;
+        test_slider_event_simulator(slider_handle, TOUCH_SLIDER_EVT_ON_PRESS, random_channel);
+        test_slider_receive_many_until(TOUCH_SLIDER_EVT_ON_PRESS);
+        vTaskDelay(pdMS_TO_TICKS(100));  //Let the calculation messages pile up
+        test_slider_event_simulator(slider_handle, TOUCH_SLIDER_EVT_ON_RELEASE, random_channel);
+        test_slider_receive_many_until(TOUCH_SLIDER_EVT_ON_RELEASE);
+    }
+    printf("Touch slider bulk receive test finish\n");
+    TEST_ESP_OK(touch_element_stop());
+    TEST_ESP_OK(touch_slider_delete(slider_handle));
+    touch_slider_uninstall();
+}
+
+static uint32_t test_slider_pseudo_random(uint32_t *state)
+{
+    *state = *state * 1103515245 + 12345;  //Deterministic, so that every run checks the same signals
+    return *state >> 8;
+}
+
+static void test_slider_fixed_point_position(void)
+{
+    touch_slider_handle_t slider_handle;
+    touch_slider_global_config_t global_config = TOUCH_SLIDER_GLOBAL_DEFAULT_CONFIG();
+    TEST_ESP_OK(touch_slider_install(&global_config));
+    touch_slider_config_t slider_config = {
+        .channel_array = slider_channel_array,
+        .sensitivity_array = slider_sens_array,
+        .channel_num = SLIDER_CHANNEL_NUM,
+        .position_range = 101
+    };
+    TEST_ESP_OK(touch_slider_create(&slider_config, &slider_handle));
+    te_slider_handle_t te_slider = (te_slider_handle_t) slider_handle;
+
+    uint32_t state = 1;
+    for (int i = 0; i < SLIDER_CHANNEL_NUM; i++) {
+        te_slider->channel_bcm[i] = 20000 + test_slider_pseudo_random(&state) % 10000;
+    }
+    /* A finger moving along the slider, changing the signal of up to 3 channels, with random pressure and noise */
+    const int points = 2000;
+    printf("Touch slider fixed-point position test start\n");
+    for (int p = 0; p < points; p++) {
+        uint32_t smooth_signal[SLIDER_CHANNEL_NUM];
+        const int center = p * (SLIDER_CHANNEL_NUM - 1) * 256 / (points - 1);
+        const uint32_t amplitude = 2000 + test_slider_pseudo_random(&state) % 6000;
+        for (int i = 0; i < SLIDER_CHANNEL_NUM; i++) {
+            const int distance = abs(i * 256 - center);
+            smooth_signal[i] = te_slider->channel_bcm[i] + (distance < 384 ? amplitude * (384 - distance) / 384 : 0) +
+                               test_slider_pseudo_random(&state) % 40;
+        }
+        uint32_t float_position = slider_calculate_raw_position(te_slider, smooth_signal, false);
+        uint32_t fixed_position = slider_calculate_raw_position(te_slider, smooth_signal, true);
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(float_position, fixed_position, "fixed-point position differs");
+        te_slider->position = float_position;  //Kept by both calculations if no channel is touched
+    }
+    printf("Touch slider fixed-point position test finish\n");
+    TEST_ESP_OK(touch_slider_delete(slider_handle));
+    touch_slider_uninstall();
+}
@@ -4,11 +4,16 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <stdio.h>
 #include <string.h>
 #include <inttypes.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/queue.h"
+#include "freertos/task.h"
 #include "esp_sleep.h"
 #include "esp_timer.h"
 #include "esp_check.h"
@@ -77,6 +82,16 @@
 
 #define TE_PROCESSING_PERIOD(obj)                 ((obj)->global_config->software.processing_period)
 #define TE_WATERPROOF_DIVIDER(obj)                ((obj)->global_config->software.waterproof_threshold_divider)
+#define TE_PROCESSING_MODE(obj)                   ((obj)->global_config->software.processing_mode)
+#define TE_PROC_NOTIFY_TIMER                      BIT(0)  //Processing task notification bit, processing period elapsed
+#define TE_PROC_NOTIFY_INTR                       BIT(1)  //Processing task notification bit, interrupt message sent
+#define TE_IDLE_PROCESSING_PERIOD(obj)            ((obj)->global_config->software.idle_processing_period)
+#define TE_EVENT_DELIVERY(obj)                    ((obj)->global_config->software.event_delivery)
+#define TE_COALESCE_SLIDER_POSITION(obj)          ((obj)->global_config->software.coalesce_slider_position)
+
+#define TE_IDLE_PROCESSING_DELAY                  (20)  //Processing periods without touched channel before switching to the idle period
+#define TE_AUTOTUNE_SCAN_TIMEOUT_MS               (1000)  //Longest wait for one scan while auto-tuning
+#define TE_AUTOTUNE_SETTLE_SCANS(smooth_mode)     (4 + (4 << (smooth_mode)))  //Scans discarded while the smooth filter settles
 
 #define TOUCH_GET_IO_NUM(channel) (touch_sensor_channel_io_map[channel])
 
@@ -94,17 +109,60 @@ typedef struct {
     touch_pad_t channel_num;            //channel index
 } te_intr_msg_t;
 
+/**
+ * Single producer (processing pass, under the global mutex), single consumer (event receiving task) ring,
+ * one slot is always left empty so that head == tail means empty and head + 1 == tail means full.
+ */
+typedef struct {
+    touch_elem_message_t *buffer;       //Ring storage, event_message_size + 1 slots
+    uint32_t size;                      //Number of slots
+    _Atomic uint32_t head;              //Next message to write, written by the producer only
+    _Atomic uint32_t tail;              //Next message to read, written by the consumer only
+    SemaphoreHandle_t ready;            //Given once per processing pass which wrote messages
+    bool is_pending;                    //Messages were written since the last notification (producer only)
+} te_event_ring_t;
+
+#if CONFIG_TOUCH_ELEMENT_TRACE
+#define TE_TRACE_CHANNEL_MASK     ((BIT(TOUCH_PAD_MAX) - 1) & ~BIT(TOUCH_PAD_NUM0))  //Channels which can be traced, channel 0 is the de-noise channel
+
+/**
+ * Signal trace and processing time histogram, written by the processing pass and read by the application, both under
+ * the global mutex. The trace buffer overwrites its oldest samples once it is full.
+ */
+typedef struct {
+    touch_elem_trace_sample_t *buffer;      //Trace buffer, CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE samples
+    uint32_t head;                          //Next sample to write
+    uint32_t count;                         //Number of samples in the trace buffer
+    uint32_t channel_mask;                  //Traced channels, 0 while not recording
+    touch_elem_proc_time_hist_t hist;       //Processing time histogram
+} te_trace_t;
+#endif
+
 typedef struct {
     te_object_methods_t object_methods[TE_CLS_TYPE_MAX];    //Class(object) methods
     touch_elem_global_config_t *global_config;              //Global initialization
     te_waterproof_handle_t waterproof_handle;               //Waterproof configuration
     te_sleep_handle_t sleep_handle;
     esp_timer_handle_t proc_timer;                          //Processing timer handle
-    QueueHandle_t event_msg_queue;                          //Application event message queue (for user)
+    TaskHandle_t proc_task;                                 //Processing task handle (TOUCH_ELEM_PROC_TASK, TOUCH_ELEM_PROC_DEDICATED_TASK)
+    QueueHandle_t event_msg_queue;                          //Application event message queue (for user, TOUCH_ELEM_EVENT_DELIVERY_QUEUE)
+    te_event_ring_t event_ring;                             //Application event message ring (for user, TOUCH_ELEM_EVENT_DELIVERY_RING)
     QueueHandle_t intr_msg_queue;                           //Interrupt message (for internal)
     SemaphoreHandle_t mutex;                                //Global resource mutex
     bool is_set_threshold;                                  //Threshold configuration state bit
     uint32_t denoise_channel_raw;                           //De-noise channel(TO) raw signal
+    uint32_t touched_channel_mask;                          //Channels between a press and a release interrupt
+    uint32_t idle_cnt;                                      //Processing periods since the last touched channel was released
+    bool is_proc_idle;                                      //The processing timer runs at the idle period (or is stopped)
+    uint32_t timer_wakeups;                                 //Processing timer routine runs, for the statistics
+    uint32_t task_wakeups;                                  //Processing task wake-ups, for the statistics
+    uint32_t stats_last_wakeups;                            //Wake-ups at the previous statistics read
+    int64_t stats_last_time;                                //Time(us) of the previous statistics read
+    SemaphoreHandle_t autotune_scan_done;                   //Given by every scan done interrupt while auto-tuning, NULL otherwise
+    float channel_sens[TOUCH_PAD_MAX];                      //Threshold ratio of the initialized channels, for the auto-tuning
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    te_trace_t trace;                                       //Signal trace and processing time histogram
+#endif
 } te_obj_t;
 
 static te_obj_t *s_te_obj = NULL;
@@ -134,6 +192,17 @@ static float te_channel_get_equ_cap(touch_pad_t channel_num);
 static uint32_t te_read_raw_signal(touch_pad_t channel_num);
 static void te_intr_cb(void *arg);
 static void te_proc_timer_cb(void *arg);
+static void te_proc_task(void *arg);
+static void te_proc_dedicated_task(void *arg);
+static void te_intr_msg_process(const te_intr_msg_t *te_intr_msg);
+static void te_proc_schedule_idle(void);
+static void te_proc_schedule_active(void);
+static void te_event_ring_notify(void);
+static void te_trace_pass(int64_t start_time);
+static esp_err_t te_autotune_measure(uint16_t channel_mask, uint16_t sample_count, touch_smooth_mode_t smooth_mode,
+                                     uint16_t scan_count, touch_elem_autotune_result_t *measure);
+static size_t te_event_ring_pop(touch_elem_message_t *element_messages, size_t max_messages);
+static size_t te_event_coalesce_slider(touch_elem_message_t *element_messages, size_t count);
 static inline esp_err_t te_object_set_threshold(void);
 static inline void te_object_process_state(void);
 static inline void te_object_update_state(te_intr_msg_t te_intr_msg);
@@ -196,13 +265,28 @@ esp_err_t touch_element_start(void)
             break;
         }
         s_te_obj->is_set_threshold = false;  //Threshold configuration will be set on touch sense start
+        s_te_obj->touched_channel_mask = 0;
+        s_te_obj->idle_cnt = 0;
+        s_te_obj->is_proc_idle = false;
+        s_te_obj->timer_wakeups = 0;
+        s_te_obj->task_wakeups = 0;
+        s_te_obj->stats_last_wakeups = 0;
+        s_te_obj->stats_last_time = esp_timer_get_time();
         ret = esp_timer_start_periodic(s_te_obj->proc_timer, TE_PROCESSING_PERIOD(s_te_obj) * 1000);
         if (ret != ESP_OK) {
             break;
         }
         touch_ll_intr_enable(TOUCH_PAD_INTR_MASK_SCAN_DONE); //Use scan done interrupt to set threshold
         touch_ll_start_fsm();
-        xQueueReset(s_te_obj->event_msg_queue);
+        if (s_te_obj->event_msg_queue != NULL) {
+            xQueueReset(s_te_obj->event_msg_queue);
+        } else {
+            //Drop the stale messages, the receiving task must not be reading the ring while the library starts
+            atomic_store_explicit(&s_te_obj->event_ring.tail,
+                                  atomic_load_explicit(&s_te_obj->event_ring.head, memory_order_relaxed),
+                                  memory_order_release);
+            xSemaphoreTake(s_te_obj->event_ring.ready, 0);
+        }
         xQueueReset(s_te_obj->intr_msg_queue);
         xSemaphoreGive(s_te_obj->mutex);
         return ESP_OK;
@@ -220,9 +304,12 @@ esp_err_t touch_element_stop(void)
     xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
     touch_ll_stop_fsm();
     touch_ll_intr_disable(TOUCH_PAD_INTR_MASK_SCAN_DONE);
-    ret = esp_timer_stop(s_te_obj->proc_timer);
-    if (ret != ESP_OK) {
-        return ret;
+    if (esp_timer_is_active(s_te_obj->proc_timer)) {  //The timer is already stopped while idle with TOUCH_ELEM_PROC_IDLE_STOP
+        ret = esp_timer_stop(s_te_obj->proc_timer);
+        if (ret != ESP_OK) {
+            xSemaphoreGive(s_te_obj->mutex);
+            return ret;
+        }
     }
     xSemaphoreGive(s_te_obj->mutex);
     return ESP_OK;
@@ -248,7 +335,19 @@ void touch_element_uninstall(void)
     if (ret != ESP_OK) {
         abort();
     }
-    vQueueDelete(s_te_obj->event_msg_queue);
+    if (s_te_obj->proc_task != NULL) {
+        vTaskDelete(s_te_obj->proc_task);  //The task is blocked on the queue, its notification or the mutex held here
+    }
+    if (s_te_obj->event_msg_queue != NULL) {
+        vQueueDelete(s_te_obj->event_msg_queue);
+    }
+    if (s_te_obj->event_ring.ready != NULL) {
+        vSemaphoreDelete(s_te_obj->event_ring.ready);
+    }
+    free(s_te_obj->event_ring.buffer);
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    free(s_te_obj->trace.buffer);
+#endif
     vQueueDelete(s_te_obj->intr_msg_queue);
     xSemaphoreGive(s_te_obj->mutex);
     vSemaphoreDelete(s_te_obj->mutex);
@@ -263,11 +362,315 @@ esp_err_t touch_element_message_receive(touch_elem_message_t *element_message, u
     //TODO: Use the generic data struct to refactor this api
     TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
     TE_CHECK(element_message != NULL, ESP_ERR_INVALID_ARG);
+    if (TE_EVENT_DELIVERY(s_te_obj) == TOUCH_ELEM_EVENT_DELIVERY_RING) {
+        size_t received;
+        return touch_element_message_receive_many(element_message, 1, &received, ticks_to_wait);
+    }
     TE_CHECK(s_te_obj->event_msg_queue != NULL, ESP_ERR_INVALID_STATE);
     int ret = xQueueReceive(s_te_obj->event_msg_queue, element_message, ticks_to_wait);
     return (ret == pdTRUE) ? ESP_OK : ESP_ERR_TIMEOUT;
 }
 
+esp_err_t touch_element_message_receive_many(touch_elem_message_t *element_messages, size_t max_messages,
+                                             size_t *received, uint32_t ticks_to_wait)
+{
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK(element_messages != NULL && received != NULL && max_messages > 0, ESP_ERR_INVALID_ARG);
+    size_t count = 0;
+    *received = 0;
+    if (TE_EVENT_DELIVERY(s_te_obj) == TOUCH_ELEM_EVENT_DELIVERY_RING) {
+        TE_CHECK(s_te_obj->event_ring.buffer != NULL, ESP_ERR_INVALID_STATE);
+        TickType_t ticks_left = ticks_to_wait;
+        TimeOut_t timeout;
+        vTaskSetTimeOutState(&timeout);
+        //The notification may be left over from messages already read, check the ring again after every wake-up
+        while ((count = te_event_ring_pop(element_messages, max_messages)) == 0) {
+            if (xTaskCheckForTimeOut(&timeout, &ticks_left) == pdTRUE ||
+                    xSemaphoreTake(s_te_obj->event_ring.ready, ticks_left) != pdTRUE) {
+                return ESP_ERR_TIMEOUT;
+            }
+        }
+    } else {
+        TE_CHECK(s_te_obj->event_msg_queue != NULL, ESP_ERR_INVALID_STATE);
+        if (xQueueReceive(s_te_obj->event_msg_queue, &element_messages[0], ticks_to_wait) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        count = 1;
+        while (count < max_messages && xQueueReceive(s_te_obj->event_msg_queue, &element_messages[count], 0) == pdTRUE) {
+            count++;
+        }
+    }
+    if (TE_COALESCE_SLIDER_POSITION(s_te_obj)) {
+        count = te_event_coalesce_slider(element_messages, count);
+    }
+    *received = count;
+    return ESP_OK;
+}
+
+esp_err_t touch_element_get_proc_stats(touch_elem_proc_stats_t *stats)
+{
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK(stats != NULL, ESP_ERR_INVALID_ARG);
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    int64_t now = esp_timer_get_time();
+    uint32_t wakeups = s_te_obj->timer_wakeups + s_te_obj->task_wakeups;
+    stats->timer_wakeups = s_te_obj->timer_wakeups;
+    stats->task_wakeups = s_te_obj->task_wakeups;
+    stats->is_idle = s_te_obj->is_proc_idle;
+    stats->wakeups_per_sec = 0;
+    if (now > s_te_obj->stats_last_time) {
+        stats->wakeups_per_sec = (wakeups - s_te_obj->stats_last_wakeups) * 1000000.0f / (now - s_te_obj->stats_last_time);
+    }
+    s_te_obj->stats_last_wakeups = wakeups;
+    s_te_obj->stats_last_time = now;
+    xSemaphoreGive(s_te_obj->mutex);
+    return ESP_OK;
+}
+
+esp_err_t touch_element_trace_start(uint32_t channel_mask)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK((channel_mask & ~TE_TRACE_CHANNEL_MASK) == 0, ESP_ERR_INVALID_ARG);
+    te_trace_t *trace = &s_te_obj->trace;
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    if (trace->buffer == NULL) {
+        trace->buffer = calloc(CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE, sizeof(touch_elem_trace_sample_t));
+        if (trace->buffer == NULL) {
+            xSemaphoreGive(s_te_obj->mutex);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    trace->head = 0;
+    trace->count = 0;
+    trace->channel_mask = channel_mask;
+    memset(&trace->hist, 0, sizeof(trace->hist));
+    xSemaphoreGive(s_te_obj->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t touch_element_trace_stop(void)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    s_te_obj->trace.channel_mask = 0;
+    xSemaphoreGive(s_te_obj->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t touch_element_trace_read(touch_elem_trace_sample_t *samples, size_t max_samples, size_t *read)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK(samples != NULL && read != NULL, ESP_ERR_INVALID_ARG);
+    te_trace_t *trace = &s_te_obj->trace;
+    size_t count = 0;
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    if (trace->buffer != NULL) {
+        uint32_t tail = (trace->head + CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE - trace->count) % CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE;
+        while (count < max_samples && count < trace->count) {
+            samples[count++] = trace->buffer[tail];
+            tail = (tail + 1 == CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE) ? 0 : tail + 1;
+        }
+        trace->count -= count;
+    }
+    xSemaphoreGive(s_te_obj->mutex);
+    *read = count;
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t touch_element_get_proc_time_hist(touch_elem_proc_time_hist_t *hist)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK(hist != NULL, ESP_ERR_INVALID_ARG);
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    *hist = s_te_obj->trace.hist;
+    xSemaphoreGive(s_te_obj->mutex);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t touch_element_trace_print(void)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    touch_elem_proc_time_hist_t hist;
+    esp_err_t ret = touch_element_get_proc_time_hist(&hist);
+    TE_CHECK(ret == ESP_OK, ret);
+    printf("Processing passes: %"PRIu32", longest: %"PRIu32" us\n", hist.count, hist.max_time);
+    for (int bin = 0; bin < TOUCH_ELEM_PROC_TIME_HIST_BINS; bin++) {
+        if (hist.bins[bin] != 0) {
+            printf("  < %"PRIu32" us: %"PRIu32"\n", (uint32_t)BIT(bin), hist.bins[bin]);
+        }
+    }
+    /*< Read in small chunks, so that the processing pass is not blocked for long */
+    touch_elem_trace_sample_t samples[16];
+    size_t read;
+    do {
+        ret = touch_element_trace_read(samples, sizeof(samples) / sizeof(samples[0]), &read);
+        TE_CHECK(ret == ESP_OK, ret);
+        for (size_t idx = 0; idx < read; idx++) {
+            printf("TETRACE,%"PRId64",%d,%"PRIu32",%"PRIu32",%"PRIu32"\n", samples[idx].timestamp, samples[idx].channel,
+                   samples[idx].raw, samples[idx].smooth, samples[idx].benchmark);
+        }
+    } while (read > 0);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t touch_element_autotune(const touch_elem_autotune_config_t *config, touch_elem_autotune_result_t *result)
+{
+    TE_CHECK(s_te_obj != NULL, ESP_ERR_INVALID_STATE);
+    TE_CHECK(config != NULL && result != NULL, ESP_ERR_INVALID_ARG);
+    TE_CHECK(config->target_snr > 0 && config->min_sample_count > 0 && config->scan_count > 0, ESP_ERR_INVALID_ARG);
+    esp_err_t ret = ESP_OK;
+    touch_elem_hw_config_t *hardware = &s_te_obj->global_config->hardware;
+    uint16_t channel_mask;
+    xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+    touch_ll_get_channel_mask(&channel_mask);
+    if (touch_ll_get_fsm_state() || channel_mask == 0x0) {
+        xSemaphoreGive(s_te_obj->mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_te_obj->autotune_scan_done = xSemaphoreCreateBinary();
+    if (s_te_obj->autotune_scan_done == NULL) {
+        xSemaphoreGive(s_te_obj->mutex);
+        return ESP_ERR_NO_MEM;
+    }
+    touch_ll_intr_disable(TOUCH_PAD_INTR_MASK_ACTIVE | TOUCH_PAD_INTR_MASK_INACTIVE | TOUCH_PAD_INTR_MASK_TIMEOUT);
+    touch_ll_intr_enable(TOUCH_PAD_INTR_MASK_SCAN_DONE);
+
+    /*< Cheapest settings first: the sample count sets the measurement time, the smooth filter only adds latency */
+    touch_elem_autotune_result_t measure = {};
+    bool is_found = false;
+    result->snr = 0;
+    uint32_t sample_count = MIN(config->min_sample_count, hardware->sample_count);
+    while (ret == ESP_OK && !is_found) {
+        for (int smooth_mode = TOUCH_PAD_SMOOTH_OFF; smooth_mode < TOUCH_PAD_SMOOTH_MAX; smooth_mode++) {
+            ret = te_autotune_measure(channel_mask, sample_count, smooth_mode, config->scan_count, &measure);
+            if (ret != ESP_OK) {
+                break;
+            }
+            ESP_LOGD(TE_DEBUG_TAG, "autotune: sample_count: %"PRIu16", smooth: %d, snr: %.1f (channel %d)",
+                     measure.sample_count, measure.smooth_filter_mode, measure.snr, measure.worst_channel);
+            if (measure.snr >= config->target_snr) {
+                *result = measure;
+                is_found = true;
+                break;
+            }
+            if (measure.snr > result->snr) {
+                result->snr = measure.snr;  //Best ratio reached, reported if no setting reaches the target
+                result->worst_channel = measure.worst_channel;
+            }
+        }
+        if (sample_count >= hardware->sample_count) {
+            break;
+        }
+        sample_count = MIN(sample_count * 2, hardware->sample_count);
+    }
+
+    touch_ll_stop_fsm();
+    touch_ll_intr_clear(TOUCH_PAD_INTR_MASK_SCAN_DONE);
+    vSemaphoreDelete(s_te_obj->autotune_scan_done);
+    s_te_obj->autotune_scan_done = NULL;
+    touch_ll_intr_enable(TOUCH_PAD_INTR_MASK_ACTIVE | TOUCH_PAD_INTR_MASK_SCAN_DONE |
+                         TOUCH_PAD_INTR_MASK_INACTIVE | TOUCH_PAD_INTR_MASK_TIMEOUT);
+    if (is_found) {
+        ESP_LOGI(TE_TAG, "Auto-tuning: sample count %"PRIu16" -> %"PRIu16", smooth filter %d -> %d, "
+                 "snr %.1f (channel %d), scan period %"PRIu32" us", hardware->sample_count, result->sample_count,
+                 hardware->smooth_filter_mode, result->smooth_filter_mode, result->snr, result->worst_channel,
+                 result->scan_period);
+        hardware->sample_count = result->sample_count;
+        hardware->smooth_filter_mode = result->smooth_filter_mode;
+    } else if (ret == ESP_OK) {
+        ESP_LOGW(TE_TAG, "Auto-tuning: no setting reaches snr %.1f, best %.1f (channel %d)",
+                 config->target_snr, result->snr, result->worst_channel);
+        result->sample_count = hardware->sample_count;
+        result->smooth_filter_mode = hardware->smooth_filter_mode;
+        result->scan_period = measure.scan_period;
+        ret = ESP_ERR_NOT_FOUND;
+    }
+    touch_ll_set_meas_times(hardware->sample_count);
+    touch_ll_filter_set_smooth_mode(hardware->smooth_filter_mode);
+    xSemaphoreGive(s_te_obj->mutex);
+    return ret;
+}
+
+/**
+ * Scans the channels of channel_mask with one setting, and measures the worst signal to noise ratio of them. The
+ * signal is the threshold of the channel (sensitivity * smooth signal), the noise is the peak to peak of the smooth
+ * signal, at least 1.
+ */
+static esp_err_t te_autotune_measure(uint16_t channel_mask, uint16_t sample_count, touch_smooth_mode_t smooth_mode,
+                                     uint16_t scan_count, touch_elem_autotune_result_t *measure)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t min_signal[TOUCH_PAD_MAX];
+    uint32_t max_signal[TOUCH_PAD_MAX];
+    uint64_t sum_signal[TOUCH_PAD_MAX] = {};
+    int64_t first_time = 0;
+    int64_t last_time = 0;
+    memset(min_signal, 0xff, sizeof(min_signal));
+    memset(max_signal, 0, sizeof(max_signal));
+
+    touch_ll_stop_fsm();
+    touch_ll_set_meas_times(sample_count);
+    touch_ll_filter_set_smooth_mode(smooth_mode);
+    xSemaphoreTake(s_te_obj->autotune_scan_done, 0);
+    touch_ll_start_fsm();
+    for (int scan = 0; scan < TE_AUTOTUNE_SETTLE_SCANS(smooth_mode) + scan_count; scan++) {
+        if (xSemaphoreTake(s_te_obj->autotune_scan_done, pdMS_TO_TICKS(TE_AUTOTUNE_SCAN_TIMEOUT_MS)) != pdTRUE) {
+            ret = ESP_ERR_TIMEOUT;
+            break;
+        }
+        last_time = esp_timer_get_time();
+        if (scan < TE_AUTOTUNE_SETTLE_SCANS(smooth_mode)) {
+            first_time = last_time;
+            continue;
+        }
+        for (int channel = 0; channel < TOUCH_PAD_MAX; channel++) {
+            if (channel_mask & BIT(channel)) {
+                uint32_t signal = te_read_smooth_signal(channel);
+                min_signal[channel] = MIN(min_signal[channel], signal);
+                max_signal[channel] = MAX(max_signal[channel], signal);
+                sum_signal[channel] += signal;
+            }
+        }
+    }
+    touch_ll_stop_fsm();
+    TE_CHECK(ret == ESP_OK, ret);
+
+    measure->sample_count = sample_count;
+    measure->smooth_filter_mode = smooth_mode;
+    measure->snr = INFINITY;
+    measure->scan_period = (uint32_t)((last_time - first_time) / scan_count);
+    for (int channel = 0; channel < TOUCH_PAD_MAX; channel++) {
+        if ((channel_mask & BIT(channel)) && s_te_obj->channel_sens[channel] > 0) {
+            float signal = s_te_obj->channel_sens[channel] * sum_signal[channel] / scan_count;
+            float snr = signal / MAX(max_signal[channel] - min_signal[channel], 1);
+            if (snr < measure->snr) {
+                measure->snr = snr;
+                measure->worst_channel = channel;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
 static uint32_t te_read_raw_signal(touch_pad_t channel_num)
 {
     uint32_t raw_signal = 0;
@@ -294,8 +697,37 @@ uint32_t te_read_smooth_signal(touch_pad_t channel_num)
     return smooth_signal;
 }
 
+#if CONFIG_TOUCH_ELEMENT_TRACE
+static uint32_t te_read_benchmark_signal(touch_pad_t channel_num)
+{
+    uint32_t benchmark = 0;
+    touch_pad_sleep_channel_t sleep_channel_info;
+    touch_hal_sleep_channel_get_config(&sleep_channel_info);
+    if (channel_num != sleep_channel_info.touch_num) {
+        touch_ll_read_benchmark(channel_num, &benchmark);
+    } else {
+        touch_ll_sleep_read_benchmark(&benchmark);
+    }
+    return benchmark;
+}
+#endif
+
 esp_err_t te_event_give(touch_elem_message_t te_message)
 {
+    if (TE_EVENT_DELIVERY(s_te_obj) == TOUCH_ELEM_EVENT_DELIVERY_RING) {
+        te_event_ring_t *ring = &s_te_obj->event_ring;
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);  //The consumer is done with the slot
+        uint32_t next = (head + 1 == ring->size) ? 0 : head + 1;
+        if (next == tail) {
+            ESP_LOGE(TE_TAG, "event ring write failed, event message ring is full");
+            return ESP_ERR_TIMEOUT;
+        }
+        ring->buffer[head] = te_message;
+        atomic_store_explicit(&ring->head, next, memory_order_release);  //Publish the message
+        ring->is_pending = true;
+        return ESP_OK;
+    }
     //TODO: add queue overwrite here when the queue is full
     int ret = xQueueSend(s_te_obj->event_msg_queue, &te_message, 0);
     if (ret != pdTRUE) {
@@ -406,7 +838,9 @@ static void te_intr_cb(void *arg)
         need_send_queue = false;
         /*< Due to a hardware issue, all of the data read operation(read raw, read smooth, read benchmark) */
         /*< must be after the second times of measure_done interrupt. */
-        if (++scan_done_cnt >= 5) {
+        if (s_te_obj->autotune_scan_done != NULL) {  //touch_element_autotune() waits for every scan
+            xSemaphoreGiveFromISR(s_te_obj->autotune_scan_done, &task_awoken);
+        } else if (++scan_done_cnt >= 5) {
             touch_ll_intr_disable(TOUCH_PAD_INTR_MASK_SCAN_DONE);  //TODO: remove hal
             scan_done_cnt = 0;
             need_send_queue = true;
@@ -416,69 +850,307 @@ static void te_intr_cb(void *arg)
     }
     if (need_send_queue) {
         xQueueSendFromISR(s_te_obj->intr_msg_queue, &te_intr_msg, &task_awoken);
+        if (TE_PROCESSING_MODE(s_te_obj) == TOUCH_ELEM_PROC_DEDICATED_TASK) {
+            xTaskNotifyFromISR(s_te_obj->proc_task, TE_PROC_NOTIFY_INTR, eSetBits, &task_awoken);
+        }
     }
     if (task_awoken == pdTRUE) {
         portYIELD_FROM_ISR();
     }
 }
 
+/**
+ * @brief Interrupt message processing
+ *
+ * This function applies one interrupt message from the touch sensor ISR, it
+ * must be called with the global mutex held.
+ */
+static void te_intr_msg_process(const te_intr_msg_t *te_intr_msg)
+{
+    if (te_intr_msg->intr_type == TE_INTR_PRESS || te_intr_msg->intr_type == TE_INTR_RELEASE) {
+        if (te_intr_msg->intr_type == TE_INTR_PRESS) {
+            s_te_obj->touched_channel_mask |= BIT(te_intr_msg->channel_num);
+            te_proc_schedule_active();
+        } else {
+            s_te_obj->touched_channel_mask &= ~BIT(te_intr_msg->channel_num);
+        }
+        te_object_update_state(*te_intr_msg);
+        if ((s_te_obj->sleep_handle != NULL) && (te_intr_msg->intr_type == TE_INTR_RELEASE)) {
+#ifdef CONFIG_PM_ENABLE
+            esp_pm_lock_release(s_te_obj->sleep_handle->pm_lock);
+#endif
+        }
+    } else if (te_intr_msg->intr_type == TE_INTR_SCAN_DONE) {
+        if (s_te_obj->is_set_threshold != true) {
+            s_te_obj->is_set_threshold = true;
+            te_object_set_threshold();  //TODO: add set threshold error processing
+            ESP_LOGD(TE_DEBUG_TAG, "Set threshold");
+            if (s_te_obj->sleep_handle != NULL) {
+#ifdef CONFIG_PM_ENABLE
+                esp_pm_lock_release(s_te_obj->sleep_handle->pm_lock);
+#endif
+            }
+        }
+        if (waterproof_check_state()) {
+            te_waterproof_handle_t waterproof_handle = s_te_obj->waterproof_handle;
+            if (waterproof_handle->is_shield_level_set != true) {
+                waterproof_handle->is_shield_level_set = true;
+                touch_pad_waterproof_t wp_conf;
+                wp_conf.shield_driver = waterproof_get_shield_level(waterproof_handle->shield_channel);
+                wp_conf.guard_ring_pad = (waterproof_guard_check_state() ? waterproof_handle->guard_device->channel : TOUCH_WATERPROOF_GUARD_NOUSE);
+                touch_hal_waterproof_set_config(&wp_conf);
+                touch_hal_waterproof_enable();
+                ESP_LOGD(TE_DEBUG_TAG, "Set waterproof shield level");
+            }
+        }
+        ESP_LOGD(TE_DEBUG_TAG, "read denoise channel %"PRIu32, s_te_obj->denoise_channel_raw);
+    } else if (te_intr_msg->intr_type == TE_INTR_TIMEOUT) { //Timeout processing
+        touch_ll_timer_force_done();
+    }
+}
+
 /**
  * @brief esp-timer callback routine
  *
  * This function is an esp-timer daemon routine, all the touch sensor
  * application(button, slider, etc...) will be processed in here.
- *
+ * In TOUCH_ELEM_PROC_TASK mode, the interrupt messages are processed
+ * by te_proc_task() and this routine only runs the periodic processing.
+ * In TOUCH_ELEM_PROC_DEDICATED_TASK mode, this routine only wakes up
+ * te_proc_dedicated_task(), keeping the esp_timer task free.
  */
 static void te_proc_timer_cb(void *arg)
 {
     TE_UNUSED(arg);
     te_intr_msg_t te_intr_msg;
-    te_intr_msg.intr_type = TE_INTR_MAX;
+    s_te_obj->timer_wakeups++;
+    if (TE_PROCESSING_MODE(s_te_obj) == TOUCH_ELEM_PROC_DEDICATED_TASK) {
+        xTaskNotify(s_te_obj->proc_task, TE_PROC_NOTIFY_TIMER, eSetBits);
+        return;
+    }
     BaseType_t ret = xSemaphoreTake(s_te_obj->mutex, 0);
     if (ret != pdPASS) {
         return;
     }
-    ret = xQueueReceive(s_te_obj->intr_msg_queue, &te_intr_msg, 0);
-    if (ret == pdPASS) {
-        if (te_intr_msg.intr_type == TE_INTR_PRESS || te_intr_msg.intr_type == TE_INTR_RELEASE) {
-            te_object_update_state(te_intr_msg);
-            if ((s_te_obj->sleep_handle != NULL) && (te_intr_msg.intr_type == TE_INTR_RELEASE)) {
-#ifdef CONFIG_PM_ENABLE
-                esp_pm_lock_release(s_te_obj->sleep_handle->pm_lock);
-#endif
-            }
-        } else if (te_intr_msg.intr_type == TE_INTR_SCAN_DONE) {
-            if (s_te_obj->is_set_threshold != true) {
-                s_te_obj->is_set_threshold = true;
-                te_object_set_threshold();  //TODO: add set threshold error processing
-                ESP_LOGD(TE_DEBUG_TAG, "Set threshold");
-                if (s_te_obj->sleep_handle != NULL) {
-#ifdef CONFIG_PM_ENABLE
-                    esp_pm_lock_release(s_te_obj->sleep_handle->pm_lock);
-#endif
-                }
-            }
-            if (waterproof_check_state()) {
-                te_waterproof_handle_t waterproof_handle = s_te_obj->waterproof_handle;
-                if (waterproof_handle->is_shield_level_set != true) {
-                    waterproof_handle->is_shield_level_set = true;
-                    touch_pad_waterproof_t wp_conf;
-                    wp_conf.shield_driver = waterproof_get_shield_level(waterproof_handle->shield_channel);
-                    wp_conf.guard_ring_pad = (waterproof_guard_check_state() ? waterproof_handle->guard_device->channel : TOUCH_WATERPROOF_GUARD_NOUSE);
-                    touch_hal_waterproof_set_config(&wp_conf);
-                    touch_hal_waterproof_enable();
-                    ESP_LOGD(TE_DEBUG_TAG, "Set waterproof shield level");
-                }
-            }
-            ESP_LOGD(TE_DEBUG_TAG, "read denoise channel %"PRIu32, s_te_obj->denoise_channel_raw);
-        } else if (te_intr_msg.intr_type == TE_INTR_TIMEOUT) { //Timeout processing
-            touch_ll_timer_force_done();
+    int64_t start_time = esp_timer_get_time();
+    if (TE_PROCESSING_MODE(s_te_obj) == TOUCH_ELEM_PROC_TIMER) {
+        ret = xQueueReceive(s_te_obj->intr_msg_queue, &te_intr_msg, 0);
+        if (ret == pdPASS) {
+            te_intr_msg_process(&te_intr_msg);
         }
     }
     te_object_process_state();
+    te_event_ring_notify();
+    te_proc_schedule_idle();
+    te_trace_pass(start_time);
     xSemaphoreGive(s_te_obj->mutex);
 }
 
+/**
+ * @brief Interrupt message processing task
+ *
+ * This task is woken up by the touch sensor ISR sending a message and drains
+ * all the pending messages at once. Every message is followed by a processing
+ * pass, so that a press and a release arriving together still give both events.
+ */
+static void te_proc_task(void *arg)
+{
+    TE_UNUSED(arg);
+    te_intr_msg_t te_intr_msg;
+    while (1) {
+        xQueueReceive(s_te_obj->intr_msg_queue, &te_intr_msg, portMAX_DELAY);
+        xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+        int64_t start_time = esp_timer_get_time();
+        s_te_obj->task_wakeups++;
+        do {
+            te_intr_msg_process(&te_intr_msg);
+            te_object_process_state();
+        } while (xQueueReceive(s_te_obj->intr_msg_queue, &te_intr_msg, 0) == pdPASS);
+        te_event_ring_notify();
+        te_trace_pass(start_time);
+        xSemaphoreGive(s_te_obj->mutex);
+    }
+}
+
+/**
+ * @brief Dedicated processing task
+ *
+ * This task runs all the processing in TOUCH_ELEM_PROC_DEDICATED_TASK mode, on the
+ * configured core and priority. It is woken up by the touch sensor ISR, then drains
+ * the interrupt messages like te_proc_task(), and by the processing timer, then runs
+ * the periodic processing of te_proc_timer_cb(). Timer notifications arriving while
+ * a pass is running are merged, like the skipped esp_timer events.
+ */
+static void te_proc_dedicated_task(void *arg)
+{
+    TE_UNUSED(arg);
+    te_intr_msg_t te_intr_msg;
+    uint32_t notify_bits;
+    while (1) {
+        xTaskNotifyWait(0, UINT32_MAX, &notify_bits, portMAX_DELAY);
+        xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
+        int64_t start_time = esp_timer_get_time();
+        if (!(notify_bits & TE_PROC_NOTIFY_TIMER)) {
+            s_te_obj->task_wakeups++;  //The timer wake-ups are counted by te_proc_timer_cb()
+        }
+        while (xQueueReceive(s_te_obj->intr_msg_queue, &te_intr_msg, 0) == pdPASS) {
+            te_intr_msg_process(&te_intr_msg);
+            te_object_process_state();
+        }
+        if (notify_bits & TE_PROC_NOTIFY_TIMER) {
+            te_object_process_state();
+            te_proc_schedule_idle();
+        }
+        te_event_ring_notify();
+        te_trace_pass(start_time);
+        xSemaphoreGive(s_te_obj->mutex);
+    }
+}
+
+/**
+ * @brief Wake up the event receiving task
+ *
+ * Called at the end of a processing pass, so that the receiving task
+ * is woken up once for all the event messages of the pass.
+ */
+static void te_event_ring_notify(void)
+{
+    if (s_te_obj->event_ring.is_pending) {
+        s_te_obj->event_ring.is_pending = false;
+        xSemaphoreGive(s_te_obj->event_ring.ready);
+    }
+}
+
+/**
+ * @brief Trace a processing pass
+ *
+ * Called at the end of a processing pass with the global mutex held, adds the
+ * pass duration to the histogram, then records a sample of every traced channel.
+ * Sampling is not counted in the pass duration.
+ */
+static void te_trace_pass(int64_t start_time)
+{
+#if CONFIG_TOUCH_ELEMENT_TRACE
+    te_trace_t *trace = &s_te_obj->trace;
+    uint32_t elapsed = (uint32_t)(esp_timer_get_time() - start_time);
+    uint32_t bin = (elapsed == 0) ? 0 : 32 - __builtin_clz(elapsed);
+    trace->hist.bins[(bin < TOUCH_ELEM_PROC_TIME_HIST_BINS) ? bin : TOUCH_ELEM_PROC_TIME_HIST_BINS - 1]++;
+    trace->hist.count++;
+    trace->hist.max_time = (elapsed > trace->hist.max_time) ? elapsed : trace->hist.max_time;
+    /*< The signals can only be read once the thresholds are set, see te_intr_cb() */
+    if (!s_te_obj->is_set_threshold) {
+        return;
+    }
+    for (uint32_t mask = trace->channel_mask; mask != 0; mask &= mask - 1) {
+        touch_pad_t channel = (touch_pad_t)__builtin_ctz(mask);
+        touch_elem_trace_sample_t *sample = &trace->buffer[trace->head];
+        sample->timestamp = start_time;
+        sample->channel = channel;
+        sample->raw = te_read_raw_signal(channel);
+        sample->smooth = te_read_smooth_signal(channel);
+        sample->benchmark = te_read_benchmark_signal(channel);
+        trace->head = (trace->head + 1 == CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE) ? 0 : trace->head + 1;
+        if (trace->count < CONFIG_TOUCH_ELEMENT_TRACE_BUFFER_SIZE) {
+            trace->count++;
+        }
+    }
+#else
+    TE_UNUSED(start_time);
+#endif
+}
+
+static size_t te_event_ring_pop(touch_elem_message_t *element_messages, size_t max_messages)
+{
+    te_event_ring_t *ring = &s_te_obj->event_ring;
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);  //The messages up to head are written
+    size_t count = 0;
+    while (tail != head && count < max_messages) {
+        element_messages[count++] = ring->buffer[tail];
+        tail = (tail + 1 == ring->size) ? 0 : tail + 1;
+    }
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);  //Give the slots back to the producer
+    return count;
+}
+
+static inline bool te_event_is_slider_calculation(const touch_elem_message_t *element_message)
+{
+    return element_message->element_type == TOUCH_ELEM_TYPE_SLIDER &&
+           ((const touch_slider_message_t *)element_message->child_msg)->event == TOUCH_SLIDER_EVT_ON_CALCULATION;
+}
+
+/**
+ * @brief Merge consecutive slider calculation messages of the same slider into the last one
+ *
+ * @return The number of messages left
+ */
+static size_t te_event_coalesce_slider(touch_elem_message_t *element_messages, size_t count)
+{
+    size_t kept = 0;
+    for (size_t idx = 0; idx < count; idx++) {
+        if (idx + 1 < count && te_event_is_slider_calculation(&element_messages[idx]) &&
+                te_event_is_slider_calculation(&element_messages[idx + 1]) &&
+                element_messages[idx].handle == element_messages[idx + 1].handle) {
+            continue;  //Superseded by the next position
+        }
+        if (kept != idx) {
+            element_messages[kept] = element_messages[idx];
+        }
+        kept++;
+    }
+    return kept;
+}
+
+/**
+ * @brief Switch the processing timer to the idle period
+ *
+ * Called at the end of every processing period. Once no channel has been touched
+ * for TE_IDLE_PROCESSING_DELAY periods, i.e. all the elements went back to idle,
+ * the processing timer slows down to the idle processing period or stops. The
+ * interrupt still wakes up the processing task, which calls te_proc_schedule_active()
+ * on the next press. Must be called with the global mutex held.
+ */
+static void te_proc_schedule_idle(void)
+{
+    if (TE_IDLE_PROCESSING_PERIOD(s_te_obj) == 0 || s_te_obj->is_proc_idle) {
+        return;
+    }
+    if (s_te_obj->touched_channel_mask != 0 || s_te_obj->is_set_threshold != true) {
+        s_te_obj->idle_cnt = 0;
+        return;
+    }
+    if (++s_te_obj->idle_cnt < TE_IDLE_PROCESSING_DELAY) {
+        return;
+    }
+    s_te_obj->is_proc_idle = true;
+    if (TE_IDLE_PROCESSING_PERIOD(s_te_obj) == TOUCH_ELEM_PROC_IDLE_STOP) {
+        esp_timer_stop(s_te_obj->proc_timer);
+    } else {
+        esp_timer_restart(s_te_obj->proc_timer, TE_IDLE_PROCESSING_PERIOD(s_te_obj) * 1000);
+    }
+    ESP_LOGD(TE_DEBUG_TAG, "Processing idle");
+}
+
+/**
+ * @brief Switch the processing timer back to the processing period
+ *
+ * Must be called with the global mutex held.
+ */
+static void te_proc_schedule_active(void)
+{
+    s_te_obj->idle_cnt = 0;
+    if (s_te_obj->is_proc_idle != true) {
+        return;
+    }
+    s_te_obj->is_proc_idle = false;
+    if (esp_timer_is_active(s_te_obj->proc_timer)) {
+        esp_timer_restart(s_te_obj->proc_timer, TE_PROCESSING_PERIOD(s_te_obj) * 1000);
+    } else {
+        esp_timer_start_periodic(s_te_obj->proc_timer, TE_PROCESSING_PERIOD(s_te_obj) * 1000);
+    }
+    ESP_LOGD(TE_DEBUG_TAG, "Processing active");
+}
+
 void te_object_method_register(te_object_methods_t *object_methods, te_class_type_t object_type)
 {
     xSemaphoreTake(s_te_obj->mutex, portMAX_DELAY);
@@ -568,6 +1240,7 @@ esp_err_t te_dev_init(te_dev_t **device, uint8_t device_num, te_dev_type_t type,
         device[idx]->type = type;
         device[idx]->state = TE_STATE_IDLE;
         device[idx]->is_use_last_threshold = false;
+        s_te_obj->channel_sens[device[idx]->channel] = device[idx]->sens;
         int touch_num = TOUCH_GET_IO_NUM(device[idx]->channel);
         esp_err_t ret = ESP_OK;
 #if (ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0))
@@ -589,6 +1262,7 @@ void te_dev_deinit(te_dev_t **device, uint8_t device_num)
 {
     for (int idx = 0; idx < device_num; idx++) {
         touch_ll_clear_channel_mask((1UL << device[idx]->channel));
+        s_te_obj->channel_sens[device[idx]->channel] = 0;
     }
 }
 
@@ -736,11 +1410,34 @@ static esp_err_t te_sw_init(const touch_elem_sw_config_t *software_init)
     TE_CHECK(software_init->waterproof_threshold_divider > 0, ESP_ERR_INVALID_ARG);
     TE_CHECK(software_init->intr_message_size >= (TOUCH_PAD_MAX - 1), ESP_ERR_INVALID_ARG);
     TE_CHECK(software_init->event_message_size > 0, ESP_ERR_INVALID_ARG);
+    TE_CHECK(software_init->processing_mode == TOUCH_ELEM_PROC_TIMER ||
+             software_init->processing_mode == TOUCH_ELEM_PROC_TASK ||
+             software_init->processing_mode == TOUCH_ELEM_PROC_DEDICATED_TASK, ESP_ERR_INVALID_ARG);
+    //Only the processing task is woken up by the interrupt while the timer is slowed down or stopped
+    TE_CHECK(software_init->idle_processing_period == 0 ||
+             software_init->processing_mode != TOUCH_ELEM_PROC_TIMER, ESP_ERR_INVALID_ARG);
+    TE_CHECK(software_init->processing_mode == TOUCH_ELEM_PROC_TIMER ||
+             software_init->processing_task_core == TOUCH_ELEM_PROC_TASK_NO_AFFINITY ||
+             (software_init->processing_task_core >= 0 && software_init->processing_task_core < portNUM_PROCESSORS),
+             ESP_ERR_INVALID_ARG);
+    TE_CHECK(software_init->event_delivery == TOUCH_ELEM_EVENT_DELIVERY_QUEUE ||
+             software_init->event_delivery == TOUCH_ELEM_EVENT_DELIVERY_RING, ESP_ERR_INVALID_ARG);
 
     esp_err_t ret = ESP_ERR_NO_MEM;
     s_te_obj->intr_msg_queue = xQueueCreate(software_init->intr_message_size, sizeof(te_intr_msg_t));
-    s_te_obj->event_msg_queue = xQueueCreate(software_init->event_message_size, sizeof(touch_elem_message_t));
-    TE_CHECK_GOTO(s_te_obj->event_msg_queue != NULL && s_te_obj->intr_msg_queue != NULL, cleanup);
+    TE_CHECK_GOTO(s_te_obj->intr_msg_queue != NULL, cleanup);
+    if (software_init->event_delivery == TOUCH_ELEM_EVENT_DELIVERY_RING) {
+        s_te_obj->event_ring.size = software_init->event_message_size + 1;
+        s_te_obj->event_ring.buffer = (touch_elem_message_t *)calloc(s_te_obj->event_ring.size,
+                                                                      sizeof(touch_elem_message_t));
+        s_te_obj->event_ring.ready = xSemaphoreCreateBinary();
+        atomic_init(&s_te_obj->event_ring.head, 0);
+        atomic_init(&s_te_obj->event_ring.tail, 0);
+        TE_CHECK_GOTO(s_te_obj->event_ring.buffer != NULL && s_te_obj->event_ring.ready != NULL, cleanup);
+    } else {
+        s_te_obj->event_msg_queue = xQueueCreate(software_init->event_message_size, sizeof(touch_elem_message_t));
+        TE_CHECK_GOTO(s_te_obj->event_msg_queue != NULL, cleanup);
+    }
 
     const esp_timer_create_args_t te_proc_timer_args = {
         .name = "te_proc_timer_cb",
@@ -750,7 +1447,21 @@ static esp_err_t te_sw_init(const touch_elem_sw_config_t *software_init)
     };
     ret = esp_timer_create(&te_proc_timer_args, &s_te_obj->proc_timer);
     TE_CHECK_GOTO(ret == ESP_OK, cleanup);
+    /* Copy the configuration first, the processing task and the timer routine read it */
     memcpy(&s_te_obj->global_config->software, software_init, sizeof(touch_elem_sw_config_t));
+    if (software_init->processing_mode != TOUCH_ELEM_PROC_TIMER) {
+        BaseType_t task_core = (software_init->processing_task_core == TOUCH_ELEM_PROC_TASK_NO_AFFINITY) ?
+                               tskNO_AFFINITY : software_init->processing_task_core;
+        BaseType_t task_ret = xTaskCreatePinnedToCore(
+                                  (software_init->processing_mode == TOUCH_ELEM_PROC_TASK) ? te_proc_task : te_proc_dedicated_task,
+                                  "te_proc_task", software_init->processing_task_stack_size, NULL,
+                                  software_init->processing_task_priority, &s_te_obj->proc_task, task_core);
+        if (task_ret != pdPASS) {
+            ret = ESP_ERR_NO_MEM;
+            esp_timer_delete(s_te_obj->proc_timer);
+            goto cleanup;
+        }
+    }
     return ret;
 
 cleanup:
@@ -760,6 +1471,10 @@ cleanup:
     if (s_te_obj->intr_msg_queue != NULL) {
         vQueueDelete(s_te_obj->intr_msg_queue);
     }
+    if (s_te_obj->event_ring.ready != NULL) {
+        vSemaphoreDelete(s_te_obj->event_ring.ready);
+    }
+    TE_FREE_AND_NULL(s_te_obj->event_ring.buffer);
     return ret;
 }
 
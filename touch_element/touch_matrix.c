@@ -13,6 +13,7 @@
 #include "esp_private/touch_element_private.h"
 
 #define TE_MAT_POS_MAX  (0xff)      //!< Matrix button startup position
+#define TE_MAT_KEY_SETTLE_CNT   (2) //!< Processing periods the new channels must be stable for before they're resolved into keys
 
 typedef struct te_matrix_handle_list {
     te_matrix_handle_t matrix_handle;               //Matrix handle
@@ -34,6 +35,7 @@ static void matrix_reset_state(te_matrix_handle_t matrix_handle);
 static void matrix_update_state(te_matrix_handle_t matrix_handle, touch_pad_t channel_num, te_state_t channel_state);
 static void matrix_update_position(te_matrix_handle_t matrix_handle, touch_matrix_position_t new_pos);
 static void matrix_proc_state(te_matrix_handle_t matrix_handle);
+static void matrix_proc_keys(te_matrix_handle_t matrix_handle);
 static void matrix_event_give(te_matrix_handle_t matrix_handle);
 static inline void matrix_dispatch(te_matrix_handle_t matrix_handle, touch_elem_dispatch_t dispatch_method);
 /* ------------------------------------------ Matrix object(class) methods ------------------------------------------ */
@@ -109,7 +111,8 @@ esp_err_t touch_matrix_create(const touch_matrix_config_t *matrix_config, touch_
              matrix_config->x_channel_num > 1 &&
              matrix_config->x_channel_num < TOUCH_PAD_MAX &&
              matrix_config->y_channel_num > 1 &&
-             matrix_config->y_channel_num < TOUCH_PAD_MAX,
+             matrix_config->y_channel_num < TOUCH_PAD_MAX &&
+             matrix_config->max_key_num <= TOUCH_MATRIX_MAX_KEY_NUM,
              ESP_ERR_INVALID_ARG);
     TE_CHECK(te_object_check_channel(matrix_config->x_channel_array, matrix_config->x_channel_num) == false &&
              te_object_check_channel(matrix_config->y_channel_array, matrix_config->y_channel_num) == false,
@@ -138,6 +141,10 @@ esp_err_t touch_matrix_create(const touch_matrix_config_t *matrix_config, touch_
                       TOUCH_ELEM_TYPE_MATRIX, matrix_config->y_channel_array, matrix_config->y_sensitivity_array,
                       TE_DEFAULT_THRESHOLD_DIVIDER(s_te_mat_obj));
     TE_CHECK_GOTO(ret == ESP_OK, cleanup);
+    memset(te_matrix->channel_index, TE_MAT_POS_MAX, sizeof(te_matrix->channel_index));
+    for (int idx = 0; idx < matrix_config->x_channel_num + matrix_config->y_channel_num; idx++) {
+        te_matrix->channel_index[te_matrix->device[idx]->channel] = idx;
+    }
 
     te_matrix->config->event_mask = TOUCH_ELEM_EVENT_NONE;
     te_matrix->config->dispatch_method = TOUCH_ELEM_DISP_MAX;
@@ -153,6 +160,7 @@ esp_err_t touch_matrix_create(const touch_matrix_config_t *matrix_config, touch_
     te_matrix->position.x_axis = TE_MAT_POS_MAX;
     te_matrix->position.y_axis = TE_MAT_POS_MAX;
     te_matrix->position.index = TE_MAT_POS_MAX;
+    te_matrix->key_max = (matrix_config->max_key_num > 1) ? matrix_config->max_key_num : 1;
     ret = matrix_object_add_instance(te_matrix);
     TE_CHECK_GOTO(ret == ESP_OK, cleanup);
     *matrix_handle = (touch_elem_handle_t) te_matrix;
@@ -291,7 +299,11 @@ static void matrix_object_process_state(void)
             matrix_reset_state(item->matrix_handle);
             continue;
         }
-        matrix_proc_state(item->matrix_handle);
+        if (item->matrix_handle->key_max > 1) {
+            matrix_proc_keys(item->matrix_handle);
+        } else {
+            matrix_proc_state(item->matrix_handle);
+        }
     }
 }
 
@@ -350,14 +362,7 @@ bool is_matrix_object_handle(touch_elem_handle_t element_handle)
 
 static bool matrix_channel_check(te_matrix_handle_t matrix_handle, touch_pad_t channel_num)
 {
-    te_dev_t *device;
-    for (int idx = 0; idx < matrix_handle->x_channel_num + matrix_handle->y_channel_num; idx++) {
-        device = matrix_handle->device[idx];
-        if (device->channel == channel_num) {
-            return true;
-        }
-    }
-    return false;
+    return channel_num < TOUCH_PAD_MAX && matrix_handle->channel_index[channel_num] != TE_MAT_POS_MAX;
 }
 
 static esp_err_t matrix_set_threshold(te_matrix_handle_t matrix_handle)
@@ -371,12 +376,18 @@ static esp_err_t matrix_set_threshold(te_matrix_handle_t matrix_handle)
 
 static void matrix_update_state(te_matrix_handle_t matrix_handle, touch_pad_t channel_num, te_state_t channel_state)
 {
-    te_dev_t *device;
-    for (int idx = 0; idx < matrix_handle->x_channel_num + matrix_handle->y_channel_num; idx++) {
-        device = matrix_handle->device[idx];
-        if (channel_num == device->channel) {
-            device->state = channel_state;
-        }
+    if (!matrix_channel_check(matrix_handle, channel_num)) {
+        return;
+    }
+    uint8_t idx = matrix_handle->channel_index[channel_num];
+    matrix_handle->device[idx]->state = channel_state;
+    /*< Keep the axis masks up to date for the multi-touch decoder */
+    uint16_t *axis_mask = (idx < matrix_handle->x_channel_num) ? &matrix_handle->x_mask : &matrix_handle->y_mask;
+    uint16_t axis_bit = BIT((idx < matrix_handle->x_channel_num) ? idx : idx - matrix_handle->x_channel_num);
+    if (channel_state == TE_STATE_PRESS) {
+        *axis_mask |= axis_bit;
+    } else {
+        *axis_mask &= ~axis_bit;
     }
 }
 
@@ -387,6 +398,12 @@ static void matrix_reset_state(te_matrix_handle_t matrix_handle)
     }
     matrix_handle->trigger_cnt = 0;
     matrix_handle->current_state = TE_STATE_IDLE;
+    matrix_handle->x_mask = 0;
+    matrix_handle->y_mask = 0;
+    matrix_handle->x_pending = 0;
+    matrix_handle->y_pending = 0;
+    matrix_handle->pending_cnt = 0;
+    matrix_handle->key_num = 0;
 }
 
 static void matrix_event_give(te_matrix_handle_t matrix_handle)
@@ -645,3 +662,121 @@ static void matrix_update_position(te_matrix_handle_t matrix_handle, touch_matri
     matrix_handle->position.y_axis = new_pos.y_axis;
     matrix_handle->position.index = matrix_handle->position.x_axis * matrix_handle->y_channel_num + matrix_handle->position.y_axis;
 }
+
+static inline void matrix_key_dispatch(te_matrix_handle_t matrix_handle, const te_matrix_key_t *key,
+                                       touch_matrix_event_t event, touch_elem_dispatch_t dispatch_method)
+{
+    matrix_handle->position = key->position;
+    matrix_handle->event = event;
+    matrix_dispatch(matrix_handle, dispatch_method);
+}
+
+/**
+ * @brief   Resolve the new channels into keys
+ *
+ * The new channels are the pressed channels which do not belong to a pressed key. They
+ * are resolved into keys only if there is a single way to do it within key_max keys:
+ *      - n new x channels and m new y channels, n * m keys (one key, or two keys sharing
+ *        a row or a column)
+ *      - one new x (y) channel only, with one key pressed: a key sharing the y (x) channel
+ *        of the pressed key
+ * Two new x channels and two new y channels could be either diagonal of the rectangle,
+ * they are left pending until one of the keys is released so that no ghost key is reported.
+ */
+static void matrix_resolve_keys(te_matrix_handle_t matrix_handle, uint16_t x_new, uint16_t y_new,
+                                uint32_t event_mask, touch_elem_dispatch_t dispatch_method)
+{
+    uint8_t x_cnt = __builtin_popcount(x_new);
+    uint8_t y_cnt = __builtin_popcount(y_new);
+    uint8_t key_free = matrix_handle->key_max - matrix_handle->key_num;
+    if (x_cnt + y_cnt == 1 && matrix_handle->key_num == 1 && key_free > 0) {
+        /*< Share the other axis channel of the pressed key */
+        if (x_cnt == 0) {
+            x_new = BIT(matrix_handle->key[0].position.x_axis);
+        } else {
+            y_new = BIT(matrix_handle->key[0].position.y_axis);
+        }
+    } else if (x_cnt == 0 || y_cnt == 0 || x_cnt * y_cnt > key_free) {
+        return;  //Not a key yet, ambiguous, or more keys than supported
+    }
+    for (uint16_t x_bits = x_new; x_bits != 0; x_bits &= x_bits - 1) {
+        for (uint16_t y_bits = y_new; y_bits != 0; y_bits &= y_bits - 1) {
+            te_matrix_key_t *key = &matrix_handle->key[matrix_handle->key_num++];
+            key->position.x_axis = __builtin_ctz(x_bits);
+            key->position.y_axis = __builtin_ctz(y_bits);
+            key->position.index = key->position.x_axis * matrix_handle->y_channel_num + key->position.y_axis;
+            key->trigger_cnt = 0;
+            ESP_LOGD(TE_DEBUG_TAG, "matrix key press  (%"PRIu8", %"PRIu8")", key->position.x_axis, key->position.y_axis);
+            if (event_mask & TOUCH_ELEM_EVENT_ON_PRESS) {
+                matrix_key_dispatch(matrix_handle, key, TOUCH_MATRIX_EVT_ON_PRESS, dispatch_method);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Matrix button multi-touch process
+ *
+ * This function replaces matrix_proc_state() if the matrix button reports more than one
+ * key. It works on the x, y axis masks kept up to date by matrix_update_state(), so that
+ * a processing period takes a few bit operations per pressed key instead of a pass over
+ * all the channels:
+ *      - A key is pressed as long as both its x and y channel are pressed, otherwise it is
+ *        released. A pressed key counts towards its LongPress event.
+ *      - The pressed channels which do not belong to a pressed key are resolved into new
+ *        keys by matrix_resolve_keys(), once they have been stable for TE_MAT_KEY_SETTLE_CNT
+ *        processing periods, since the x and y channel of a key are reported by different
+ *        interrupts.
+ */
+static void matrix_proc_keys(te_matrix_handle_t matrix_handle)
+{
+    uint32_t event_mask = matrix_handle->config->event_mask;
+    touch_elem_dispatch_t dispatch_method = matrix_handle->config->dispatch_method;
+
+    BaseType_t mux_ret = xSemaphoreTake(s_te_mat_obj->mutex, 0);
+    if (mux_ret != pdPASS) {
+        return;
+    }
+
+    uint16_t x_claimed = 0;
+    uint16_t y_claimed = 0;
+    for (int idx = 0; idx < matrix_handle->key_num;) {
+        te_matrix_key_t *key = &matrix_handle->key[idx];
+        uint16_t x_bit = BIT(key->position.x_axis);
+        uint16_t y_bit = BIT(key->position.y_axis);
+        if (!(matrix_handle->x_mask & x_bit) || !(matrix_handle->y_mask & y_bit)) {  //Press ---> Release = On_Release
+            ESP_LOGD(TE_DEBUG_TAG, "matrix key release (%"PRIu8", %"PRIu8")", key->position.x_axis, key->position.y_axis);
+            if (event_mask & TOUCH_ELEM_EVENT_ON_RELEASE) {
+                matrix_key_dispatch(matrix_handle, key, TOUCH_MATRIX_EVT_ON_RELEASE, dispatch_method);
+            }
+            *key = matrix_handle->key[--matrix_handle->key_num];
+            continue;
+        }
+        if (event_mask & TOUCH_ELEM_EVENT_ON_LONGPRESS) {  //Press ---> Press = On_LongPress
+            if (++key->trigger_cnt >= matrix_handle->trigger_thr) {
+                ESP_LOGD(TE_DEBUG_TAG, "matrix key longpress (%"PRIu8", %"PRIu8")", key->position.x_axis, key->position.y_axis);
+                matrix_key_dispatch(matrix_handle, key, TOUCH_MATRIX_EVT_ON_LONGPRESS, dispatch_method);
+                key->trigger_cnt = 0;
+            }
+        }
+        x_claimed |= x_bit;
+        y_claimed |= y_bit;
+        idx++;
+    }
+
+    uint16_t x_new = matrix_handle->x_mask & ~x_claimed;
+    uint16_t y_new = matrix_handle->y_mask & ~y_claimed;
+    if (x_new != matrix_handle->x_pending || y_new != matrix_handle->y_pending) {
+        matrix_handle->x_pending = x_new;
+        matrix_handle->y_pending = y_new;
+        matrix_handle->pending_cnt = 0;
+    } else if (x_new != 0 || y_new != 0) {
+        if (matrix_handle->pending_cnt < TE_MAT_KEY_SETTLE_CNT) {
+            matrix_handle->pending_cnt++;
+        }
+        if (matrix_handle->pending_cnt >= TE_MAT_KEY_SETTLE_CNT) {
+            matrix_resolve_keys(matrix_handle, x_new, y_new, event_mask, dispatch_method);
+        }
+    }
+    xSemaphoreGive(s_te_mat_obj->mutex);
+}
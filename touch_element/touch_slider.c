@@ -6,6 +6,7 @@
 
 #include <string.h>
 #include <sys/queue.h>
+#include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "esp_log.h"
@@ -18,6 +19,9 @@
 #define TE_SLD_DEFAULT_FILTER_RESET_TIME(obj)             ((obj)->global_config->filter_reset_time)
 #define TE_SLD_DEFAULT_POS_FILTER_SIZE(obj)               ((obj)->global_config->position_filter_size)
 
+#define TE_SLD_FIXED_SHIFT                                (16)  //Fractional bits of the fixed-point position calculation
+#define TE_SLD_TO_FIXED(x)                                ((uint32_t)((x) * (1 << TE_SLD_FIXED_SHIFT) + 0.5F))
+
 typedef struct te_slider_handle_list {
     te_slider_handle_t slider_handle;           //Slider handle
     SLIST_ENTRY(te_slider_handle_list) next;    //Slider handle list entry
@@ -27,6 +31,7 @@ typedef struct {
     SLIST_HEAD(te_slider_handle_list_head, te_slider_handle_list) handle_list;    //Slider handle (instance) list
     touch_slider_global_config_t *global_config;                                  //Slider global configuration
     SemaphoreHandle_t mutex;                                                      //Slider object mutex
+    int32_t quantify_threshold_fixed;                                             //Quantification threshold, Q16
 } te_slider_obj_t;
 
 te_slider_obj_t *s_te_sld_obj = NULL;
@@ -36,6 +41,8 @@ static esp_err_t slider_set_threshold(te_slider_handle_t slider_handle);
 static inline te_state_t slider_get_state(te_dev_t **device, int device_num);
 static void slider_reset_state(te_slider_handle_t slider_handle);
 static void slider_update_position(te_slider_handle_t slider_handle);
+static uint32_t slider_calculate_position_float(te_slider_handle_t slider_handle, const uint32_t *smooth_signal);
+static uint32_t slider_calculate_position_fixed(te_slider_handle_t slider_handle, const uint32_t *smooth_signal);
 static void slider_reset_position(te_slider_handle_t slider_handle);
 static void slider_update_benchmark(te_slider_handle_t slider_handle);
 static void slider_update_state(te_slider_handle_t slider_handle, touch_pad_t channel_num, te_state_t channel_state);
@@ -64,6 +71,7 @@ esp_err_t touch_slider_install(const touch_slider_global_config_t *global_config
     xSemaphoreTake(s_te_sld_obj->mutex, portMAX_DELAY);
     SLIST_INIT(&s_te_sld_obj->handle_list);
     memcpy(s_te_sld_obj->global_config, global_config, sizeof(touch_slider_global_config_t));
+    s_te_sld_obj->quantify_threshold_fixed = TE_SLD_TO_FIXED(global_config->quantify_lower_threshold);
     te_object_methods_t slider_methods = {
         .handle = s_te_sld_obj,
         .check_channel = slider_object_check_channel,
@@ -124,11 +132,15 @@ esp_err_t touch_slider_create(const touch_slider_config_t *slider_config, touch_
     te_slider->device = (te_dev_t **)calloc(slider_config->channel_num, sizeof(te_dev_t *));
     te_slider->channel_bcm = (uint32_t *)calloc(slider_config->channel_num, sizeof(uint32_t));
     te_slider->quantify_signal_array = (float *)calloc(slider_config->channel_num, sizeof(float));
+    te_slider->channel_inv_sens_fixed = (uint32_t *)calloc(slider_config->channel_num, sizeof(uint32_t));
+    te_slider->channel_coef_fixed = (uint64_t *)calloc(slider_config->channel_num, sizeof(uint64_t));
     TE_CHECK_GOTO(te_slider->config != NULL &&
                   te_slider->pos_filter_window != NULL &&
                   te_slider->device != NULL &&
                   te_slider->channel_bcm &&
-                  te_slider->quantify_signal_array,
+                  te_slider->quantify_signal_array &&
+                  te_slider->channel_inv_sens_fixed &&
+                  te_slider->channel_coef_fixed,
                   cleanup);
     for (int idx = 0; idx < slider_config->channel_num; idx++) {
         te_slider->device[idx] = (te_dev_t *)calloc(1, sizeof(te_dev_t));
@@ -151,6 +163,18 @@ esp_err_t touch_slider_create(const touch_slider_config_t *slider_config, touch_
     te_slider->channel_sum = slider_config->channel_num;
     te_slider->position_range = slider_config->position_range;
     te_slider->position_scale = (float)(slider_config->position_range) / (slider_config->channel_num - 1);
+    /* Rounded up, so that the integer multiples of the scale are not truncated to the integer below */
+    te_slider->position_scale_fixed = (((uint32_t)slider_config->position_range << TE_SLD_FIXED_SHIFT) +
+                                       slider_config->channel_num - 2) / (slider_config->channel_num - 1);
+    float weight_sum = 0;
+    for (int idx = 0; idx < slider_config->channel_num; idx++) {
+        weight_sum += te_slider->device[idx]->sens;
+    }
+    for (int idx = 0; idx < slider_config->channel_num; idx++) {
+        te_slider->channel_inv_sens_fixed[idx] = TE_SLD_TO_FIXED(1.0F / te_slider->device[idx]->sens);
+        float sens = te_slider->device[idx]->sens;
+        te_slider->channel_coef_fixed[idx] = (uint64_t)((double)weight_sum / sens / sens * (1 << TE_SLD_FIXED_SHIFT) + 0.5);
+    }
     te_slider->current_state = TE_STATE_IDLE;
     te_slider->last_state = TE_STATE_IDLE;
     te_slider->event = TOUCH_SLIDER_EVT_MAX;
@@ -168,6 +192,8 @@ cleanup:
     TE_FREE_AND_NULL(te_slider->pos_filter_window);
     TE_FREE_AND_NULL(te_slider->channel_bcm);
     TE_FREE_AND_NULL(te_slider->quantify_signal_array);
+    TE_FREE_AND_NULL(te_slider->channel_inv_sens_fixed);
+    TE_FREE_AND_NULL(te_slider->channel_coef_fixed);
     if (te_slider->device != NULL) {
         for (int idx = 0; idx < slider_config->channel_num; idx++) {
             TE_FREE_AND_NULL(te_slider->device[idx]);
@@ -194,6 +220,8 @@ esp_err_t touch_slider_delete(touch_slider_handle_t slider_handle)
     }
     free(te_slider->config);
     free(te_slider->quantify_signal_array);
+    free(te_slider->channel_inv_sens_fixed);
+    free(te_slider->channel_coef_fixed);
     free(te_slider->pos_filter_window);
     free(te_slider->channel_bcm);
     free(te_slider->device);
@@ -520,13 +548,13 @@ static inline te_state_t slider_get_state(te_dev_t **device, int device_num)
  * so as to make the different size of touch pad in PCB has the same difference value
  *
  */
-static inline void slider_quantify_signal(te_slider_handle_t slider_handle)
+static inline void slider_quantify_signal(te_slider_handle_t slider_handle, const uint32_t *smooth_signal)
 {
     float weight_sum = 0;
     for (int idx = 0; idx < slider_handle->channel_sum; idx++) {
         te_dev_t *device = slider_handle->device[idx];
         weight_sum += device->sens;
-        uint32_t current_signal = te_read_smooth_signal(device->channel);
+        uint32_t current_signal = smooth_signal[idx];
         int ans = current_signal - slider_handle->channel_bcm[idx];
         float diff_rate = (float)ans / slider_handle->channel_bcm[idx];
         slider_handle->quantify_signal_array[idx] = diff_rate / device->sens;
@@ -540,6 +568,28 @@ static inline void slider_quantify_signal(te_slider_handle_t slider_handle)
     }
 }
 
+/**
+ * @brief Slider channel difference-rate re-quantization, fixed-point
+ *
+ * Same as slider_quantify_signal(), in Q16 with the sensitivity terms computed on slider creation. The signal is
+ * scaled in one step, so that the results which are exact in float are exact here too.
+ *
+ */
+static inline void slider_quantify_signal_fixed(te_slider_handle_t slider_handle, const uint32_t *smooth_signal, int32_t *quantify_signal)
+{
+    for (int idx = 0; idx < slider_handle->channel_sum; idx++) {
+        uint32_t benchmark = slider_handle->channel_bcm[idx];
+        int32_t ans = (int32_t)(smooth_signal[idx] - benchmark);
+        //diff_rate / sens < threshold, with diff_rate = ans / benchmark
+        if (benchmark == 0 || (int64_t)ans * slider_handle->channel_inv_sens_fixed[idx] <
+                (int64_t)s_te_sld_obj->quantify_threshold_fixed * benchmark) {
+            quantify_signal[idx] = 0;
+        } else {
+            quantify_signal[idx] = (int32_t)((uint64_t)ans * slider_handle->channel_coef_fixed[idx] / benchmark);
+        }
+    }
+}
+
 /**
  * @brief Calculate max sum subarray
  *
@@ -580,6 +630,32 @@ static inline uint8_t slider_get_non_zero_num(const float *array, uint8_t array_
     return zero_cnt;
 }
 
+static inline int32_t slider_search_max_subarray_fixed(const int32_t *array, int array_size, int *max_array_idx)
+{
+    *max_array_idx = 0;
+    int32_t max_array_sum = 0;
+    for (int idx = 0; idx <= (array_size - TE_SLD_DEFAULT_CALCULATE_CHANNEL(s_te_sld_obj)); idx++) {
+        int32_t current_array_sum = 0;
+        for (int x = idx; x < idx + TE_SLD_DEFAULT_CALCULATE_CHANNEL(s_te_sld_obj); x++) {
+            current_array_sum += array[x];
+        }
+        if (max_array_sum < current_array_sum) {
+            max_array_sum = current_array_sum;
+            *max_array_idx = idx;
+        }
+    }
+    return max_array_sum;
+}
+
+static inline uint8_t slider_get_non_zero_num_fixed(const int32_t *array, uint8_t array_idx)
+{
+    uint8_t zero_cnt = 0;
+    for (int idx = array_idx; idx < array_idx + TE_SLD_DEFAULT_CALCULATE_CHANNEL(s_te_sld_obj); idx++) {
+        zero_cnt += (array[idx] > 0) ? 1 : 0;
+    }
+    return zero_cnt;
+}
+
 static inline uint32_t slider_calculate_position(te_slider_handle_t slider_handle, int subarray_index, float subarray_sum, int non_zero_num)
 {
     int range = slider_handle->position_range;
@@ -609,6 +685,56 @@ static inline uint32_t slider_calculate_position(te_slider_handle_t slider_handl
     return position;
 }
 
+static inline uint32_t slider_calculate_position_from_fixed(te_slider_handle_t slider_handle, const int32_t *array, int subarray_index, int32_t subarray_sum, int non_zero_num)
+{
+    uint32_t position = 0;
+    if (non_zero_num == 0) {
+        position = slider_handle->position;
+    } else if (non_zero_num == 1) {
+        for (int index = subarray_index; index < subarray_index + TE_SLD_DEFAULT_CALCULATE_CHANNEL(s_te_sld_obj); index++) {
+            if (0 != array[index]) {
+                if (index == slider_handle->channel_sum - 1) {
+                    position = slider_handle->position_range;
+                } else {
+                    position = ((uint32_t)index * slider_handle->position_scale_fixed) >> TE_SLD_FIXED_SHIFT;
+                }
+                break;
+            }
+        }
+    } else {
+        for (int idx = subarray_index; idx < subarray_index + TE_SLD_DEFAULT_CALCULATE_CHANNEL(s_te_sld_obj); idx++) {
+            position += ((uint64_t)idx * array[idx]) >> TE_SLD_FIXED_SHIFT;  //Truncated at every step like the float calculation
+        }
+        position = ((uint64_t)position * slider_handle->position_scale_fixed) / (uint32_t)subarray_sum;
+    }
+    return position;
+}
+
+static uint32_t slider_calculate_position_float(te_slider_handle_t slider_handle, const uint32_t *smooth_signal)
+{
+    int max_array_idx = 0;
+    slider_quantify_signal(slider_handle, smooth_signal);
+    float max_array_sum = slider_search_max_subarray(slider_handle->quantify_signal_array, slider_handle->channel_sum, &max_array_idx);
+    uint8_t non_zero_num = slider_get_non_zero_num(slider_handle->quantify_signal_array, max_array_idx);
+    return slider_calculate_position(slider_handle, max_array_idx, max_array_sum, non_zero_num);
+}
+
+static uint32_t slider_calculate_position_fixed(te_slider_handle_t slider_handle, const uint32_t *smooth_signal)
+{
+    int max_array_idx = 0;
+    int32_t quantify_signal[TOUCH_PAD_MAX];
+    slider_quantify_signal_fixed(slider_handle, smooth_signal, quantify_signal);
+    int32_t max_array_sum = slider_search_max_subarray_fixed(quantify_signal, slider_handle->channel_sum, &max_array_idx);
+    uint8_t non_zero_num = slider_get_non_zero_num_fixed(quantify_signal, max_array_idx);
+    return slider_calculate_position_from_fixed(slider_handle, quantify_signal, max_array_idx, max_array_sum, non_zero_num);
+}
+
+uint32_t slider_calculate_raw_position(te_slider_handle_t slider_handle, const uint32_t *smooth_signal, bool fixed_point)
+{
+    return fixed_point ? slider_calculate_position_fixed(slider_handle, smooth_signal) :
+           slider_calculate_position_float(slider_handle, smooth_signal);
+}
+
 static uint32_t slider_filter_average(te_slider_handle_t slider_handle, uint32_t current_position)
 {
     uint32_t position_average = 0;
@@ -627,7 +753,13 @@ static uint32_t slider_filter_average(te_slider_handle_t slider_handle, uint32_t
     for (int win_idx = 0; win_idx < TE_SLD_DEFAULT_POS_FILTER_SIZE(s_te_sld_obj); win_idx++) { //Moving average filter
         position_average += slider_handle->pos_filter_window[win_idx];
     }
+#if CONFIG_TOUCH_ELEMENT_SLIDER_FIXED_POINT
+    /* Rounded to the nearest integer, same as the float division below */
+    position_average = (2 * position_average + TE_SLD_DEFAULT_POS_FILTER_SIZE(s_te_sld_obj)) /
+                       (2 * TE_SLD_DEFAULT_POS_FILTER_SIZE(s_te_sld_obj));
+#else
     position_average = (uint32_t)((float)position_average / TE_SLD_DEFAULT_POS_FILTER_SIZE(s_te_sld_obj) + 0.5F);
+#endif
     return position_average;
 }
 
@@ -651,18 +783,22 @@ static inline uint32_t slider_filter_iir(uint32_t in_now, uint32_t out_last, uin
  *      3. Calculate position
  *      4. Filter
  *
+ * The steps 1 to 4 run in fixed-point if CONFIG_TOUCH_ELEMENT_SLIDER_FIXED_POINT is set.
+ *
  */
 static void slider_update_position(te_slider_handle_t slider_handle)
 {
-    int max_array_idx = 0;
-    float max_array_sum;
-    uint8_t non_zero_num;
+    uint32_t smooth_signal[TOUCH_PAD_MAX];
     uint32_t current_position;
 
-    slider_quantify_signal(slider_handle);
-    max_array_sum = slider_search_max_subarray(slider_handle->quantify_signal_array, slider_handle->channel_sum, &max_array_idx);
-    non_zero_num = slider_get_non_zero_num(slider_handle->quantify_signal_array, max_array_idx);
-    current_position = slider_calculate_position(slider_handle, max_array_idx, max_array_sum, non_zero_num);
+    for (int idx = 0; idx < slider_handle->channel_sum; idx++) {
+        smooth_signal[idx] = te_read_smooth_signal(slider_handle->device[idx]->channel);
+    }
+#if CONFIG_TOUCH_ELEMENT_SLIDER_FIXED_POINT
+    current_position = slider_calculate_position_fixed(slider_handle, smooth_signal);
+#else
+    current_position = slider_calculate_position_float(slider_handle, smooth_signal);
+#endif
     uint32_t position_average = slider_filter_average(slider_handle, current_position);
     slider_handle->last_position = slider_handle->last_position == 0 ? (position_average << 4) : slider_handle->last_position;
     slider_handle->last_position = slider_filter_iir((position_average << 4), slider_handle->last_position, TE_SLD_DEFAULT_POS_FILTER_FACTOR(s_te_sld_obj));
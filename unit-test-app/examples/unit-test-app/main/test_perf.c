@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Duration and heap delta of each test, printed as a JSON object on a "UT_PERF:" line which ElfUnitTestParser.py
+ * collects from the test log. setUp() and tearDown() of test_utils are wrapped at link time, see CMakeLists.txt.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+#if CONFIG_UT_PERF_TIMER_CCOMP_TIMER
+#include "ccomp_timer.h"
+#endif
+
+#define PERF_LOG_PREFIX         "UT_PERF: "
+#define PERF_TAG_TIME_US        "[perf_time_us="
+#define PERF_TAG_HEAP           "[perf_heap="
+
+void __real_setUp(void);
+void __real_tearDown(void);
+
+static size_t s_free_before;
+static int64_t s_start_us;
+#if CONFIG_UT_PERF_TIMER_CCOMP_TIMER
+static bool s_ccomp_timer_started;
+#endif
+
+/* Threshold of a "[tag=N]" in the test description, -1 if there is no such tag */
+static int64_t perf_get_threshold(const char *tag)
+{
+    const char *desc = Unity.CurrentDetail1;
+    const char *found = desc ? strstr(desc, tag) : NULL;
+    if (found == NULL) {
+        return -1;
+    }
+    return strtoll(found + strlen(tag), NULL, 10);
+}
+
+/* Test name as a JSON string, escaping the quotes and backslashes */
+static void perf_print_name(const char *name)
+{
+    putchar('"');
+    for (; name && *name; name++) {
+        if (*name == '"' || *name == '\\') {
+            putchar('\\');
+        }
+        putchar(*name);
+    }
+    putchar('"');
+}
+
+void __wrap_setUp(void)
+{
+    __real_setUp();
+
+    s_free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#if CONFIG_UT_PERF_TIMER_CCOMP_TIMER
+    s_ccomp_timer_started = (ccomp_timer_start() == ESP_OK);
+#endif
+    s_start_us = esp_timer_get_time();
+}
+
+void __wrap_tearDown(void)
+{
+    int64_t time_us = esp_timer_get_time() - s_start_us;
+    const char *timer = "esp_timer";
+#if CONFIG_UT_PERF_TIMER_CCOMP_TIMER
+    if (s_ccomp_timer_started) {
+        int64_t ccomp_time_us = ccomp_timer_stop();
+        if (ccomp_time_us >= 0) {
+            time_us = ccomp_time_us;
+            timer = "ccomp_timer";
+        }
+        s_ccomp_timer_started = false;
+    }
+#endif
+    /* Before test_utils' tearDown(), which frees the memory of its own checks */
+    int heap_delta = (int)s_free_before - (int)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    printf(PERF_LOG_PREFIX "{\"name\": ");
+    perf_print_name(Unity.CurrentTestName);
+    printf(", \"time_us\": %" PRId64 ", \"heap_delta\": %d, \"timer\": \"%s\"}\n", time_us, heap_delta, timer);
+
+    __real_tearDown();
+
+    /* A failed test may stop at any point, its duration and heap delta mean nothing */
+    if (Unity.CurrentTestFailed) {
+        return;
+    }
+    int64_t max_time_us = perf_get_threshold(PERF_TAG_TIME_US);
+    if (max_time_us >= 0 && time_us > max_time_us) {
+        printf("Test took %" PRId64 " us, more than the threshold of %" PRId64 " us\n", time_us, max_time_us);
+        TEST_FAIL_MESSAGE("Performance regression, duration above the threshold");
+    }
+    int64_t max_heap_delta = perf_get_threshold(PERF_TAG_HEAP);
+    if (max_heap_delta >= 0 && heap_delta > max_heap_delta) {
+        printf("Test kept %d bytes of heap, more than the threshold of %" PRId64 " bytes\n", heap_delta,
+               max_heap_delta);
+        TEST_FAIL_MESSAGE("Performance regression, heap delta above the threshold");
+    }
+}
@@ -1,7 +1,9 @@
 # SPDX-FileCopyrightText: 2022 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Apache-2.0
 import argparse
+import json
 import os
+import re
 import subprocess
 import sys
 from typing import Dict, List
@@ -15,6 +17,13 @@ except ImportError:
     import CreateSectionTable
 
 
+PERF_LOG_PREFIX = 'UT_PERF: '
+PERF_TAGS = {
+    'time_us': re.compile(r'\[perf_time_us=(\d+)\]'),
+    'heap_delta': re.compile(r'\[perf_heap=(\d+)\]'),
+}
+
+
 def get_target_objdump(idf_target: str) -> str:
     toolchain_for_target = {
         'esp32': 'xtensa-esp32-elf-',
@@ -56,6 +65,9 @@ def parse_elf_test_cases(elf_file: str, idf_target: str) -> List[Dict]:
                     'desc': table.get_string('any', desc_addr),
                     'function_count': table.get_unsigned_int(section, test_addr + 20, 4),
                 }
+                thresholds = parse_perf_thresholds(tc['desc'])
+                if thresholds:
+                    tc['perf_thresholds'] = thresholds
                 bin_test_cases.append(tc)
     except subprocess.CalledProcessError:
         raise Exception('Test cases not found')
@@ -65,6 +77,46 @@ def parse_elf_test_cases(elf_file: str, idf_target: str) -> List[Dict]:
     return bin_test_cases
 
 
+def parse_perf_thresholds(desc: str) -> Dict[str, int]:
+    """ Thresholds of the [perf_time_us=N] and [perf_heap=N] tags of a test description """
+    thresholds = {}
+    for key, regex in PERF_TAGS.items():
+        match = regex.search(desc)
+        if match:
+            thresholds[key] = int(match.group(1))
+    return thresholds
+
+
+def parse_perf_log(log_file: str) -> Dict[str, Dict]:
+    """ Results of the "UT_PERF:" lines printed with CONFIG_UT_PERF_CAPTURE, by test name, the last run of a test """
+    results = {}
+    with open(log_file, 'r', errors='replace') as input_f:
+        for line in input_f:
+            pos = line.find(PERF_LOG_PREFIX)
+            if pos < 0:
+                continue
+            try:
+                result = json.loads(line[pos + len(PERF_LOG_PREFIX):])
+            except ValueError:
+                continue
+            results[result.pop('name')] = result
+    return results
+
+
+def add_perf_results(test_cases: List[Dict], results: Dict[str, Dict]) -> List[str]:
+    """ Add the results of the log to the test cases, and return the names of the tests above their thresholds """
+    regressions = []
+    for tc in test_cases:
+        result = results.get(tc['name'])
+        if result is None:
+            continue
+        tc['perf'] = result
+        thresholds = tc.get('perf_thresholds', {})
+        if any(result.get(key, 0) > limit for key, limit in thresholds.items()):
+            regressions.append(tc['name'])
+    return regressions
+
+
 if __name__ == '__main__':
     parser = argparse.ArgumentParser()
     parser.add_argument('elf_file', help='Elf file to parse')
@@ -74,10 +126,22 @@ if __name__ == '__main__':
     parser.add_argument('-o', '--output_file',
                         type=str, default='elf_test_cases.yml',
                         help='Target of the elf, e.g. esp32s2')
+    parser.add_argument('-l', '--perf_log',
+                        type=str, default=None,
+                        help='Log of a run built with CONFIG_UT_PERF_CAPTURE, whose results are added to the test cases')
     args = parser.parse_args()
 
     assert args.idf_target
 
     test_cases = parse_elf_test_cases(args.elf_file, args.idf_target)
+    regressions = []
+    if args.perf_log:
+        regressions = add_perf_results(test_cases, parse_perf_log(args.perf_log))
     with open(args.output_file, 'w') as out_file:
         yaml.dump(test_cases, out_file, default_flow_style=False)
+
+    if regressions:
+        print('Tests above their performance thresholds:')
+        for name in regressions:
+            print('  {}'.format(name))
+        sys.exit(1)
@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Unlicense OR CC0-1.0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "zlib_stream.h"
+
+/*
+ * Compresses a synthetic log, resembling the output of an application logging its Wi-Fi, HTTP, sensor and MQTT
+ * activity and some JSON telemetry, with every compression level and a few RAM budgets, in gzip as for an upload
+ * with `Content-Encoding: gzip`. The log is written line by line, as a logger would, and only the compression is
+ * timed: the output is counted and dropped.
+ */
+
+#define BENCH_LOG_SIZE     (64 * 1024)
+#define BENCH_OUT_BUF_SIZE 1024
+
+static const char *TAG = "log_compress_bench";
+
+static const size_t s_budgets[] = {12 * 1024, 24 * 1024, 48 * 1024, 96 * 1024};
+
+static char *s_log;
+static size_t s_log_len;
+
+/* Small deterministic generator, so every run compresses the same log */
+static uint32_t s_seed = 1;
+
+static uint32_t bench_rand(uint32_t n)
+{
+    s_seed = s_seed * 1103515245 + 12345;
+    return (s_seed >> 8) % n;
+}
+
+static size_t bench_log_line(char *buf, size_t size, uint32_t ms)
+{
+    static const char *const tags[] = {"wifi", "httpd", "sensor", "mqtt_client", "app_main", "ota"};
+    switch (bench_rand(10)) {
+    case 0:
+    case 1:
+        return snprintf(buf, size, "I (%" PRIu32 ") sensor: temp=%" PRIu32 ".%02" PRIu32 " hum=%" PRIu32 ".%" PRIu32
+                        " pressure=%" PRIu32 "\n", ms, 18 + bench_rand(10), bench_rand(100), 30 + bench_rand(40),
+                        bench_rand(10), 98000 + bench_rand(4000));
+    case 2:
+    case 3:
+        return snprintf(buf, size, "D (%" PRIu32 ") mqtt_client: sent publish successfully, msg_id=%" PRIu32 "\n", ms,
+                        bench_rand(65536));
+    case 4:
+        return snprintf(buf, size, "I (%" PRIu32 ") wifi: rssi %d dBm, channel %" PRIu32 ", bssid %02" PRIx32
+                        ":%02" PRIx32 ":%02" PRIx32 "\n", ms, -30 - (int)bench_rand(60), 1 + bench_rand(13),
+                        bench_rand(256), bench_rand(256), bench_rand(256));
+    case 5:
+        return snprintf(buf, size, "W (%" PRIu32 ") httpd: httpd_sock_err: error in recv : %" PRIu32 "\n", ms,
+                        bench_rand(2) ? 104 : 11);
+    case 6:
+        return snprintf(buf, size, "E (%" PRIu32 ") %s: operation failed at 0x%08" PRIx32 ", retrying in %" PRIu32
+                        " ms\n", ms, tags[bench_rand(6)], 0x3f400000 + bench_rand(0x100000), 100 * bench_rand(50));
+    default:
+        return snprintf(buf, size, "{\"ts\":%" PRIu32 ",\"id\":\"dev-%04" PRIx32 "\",\"heap\":%" PRIu32
+                        ",\"v\":[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "]}\n", ms, bench_rand(16), 150000 + bench_rand(50000),
+                        bench_rand(4096), bench_rand(4096), bench_rand(4096));
+    }
+}
+
+static void bench_generate_log(void)
+{
+    char line[160];
+    uint32_t ms = 1000;
+    s_log = malloc(BENCH_LOG_SIZE);
+    ESP_ERROR_CHECK(s_log ? ESP_OK : ESP_ERR_NO_MEM);
+    for (;;) {
+        ms += bench_rand(500);
+        size_t len = bench_log_line(line, sizeof(line), ms);
+        if (s_log_len + len > BENCH_LOG_SIZE) {
+            break;
+        }
+        memcpy(s_log + s_log_len, line, len);
+        s_log_len += len;
+    }
+}
+
+static esp_err_t bench_drop_output(const void *data, size_t len, void *arg)
+{
+    return ESP_OK;
+}
+
+/* Writes the log line by line, returns the time spent in the calls to the stream */
+static int64_t bench_write_log(zlib_stream_handle_t stream)
+{
+    int64_t start = esp_timer_get_time();
+    const char *line = s_log;
+    const char *end = s_log + s_log_len;
+    while (line < end) {
+        const char *eol = memchr(line, '\n', end - line);
+        size_t len = eol ? eol + 1 - line : end - line;
+        ESP_ERROR_CHECK(zlib_stream_write(stream, line, len));
+        line += len;
+    }
+    ESP_ERROR_CHECK(zlib_stream_finish(stream));
+    return esp_timer_get_time() - start;
+}
+
+static void bench_run(size_t budget, int level)
+{
+    int window_bits = 0;
+    int mem_level = 0;
+    ESP_ERROR_CHECK(zlib_stream_fit_budget(budget, &window_bits, &mem_level));
+    zlib_stream_config_t config = ZLIB_STREAM_DEFAULT_CONFIG();
+    config.level = level;
+    config.ram_budget = budget;
+    config.out_buf_size = BENCH_OUT_BUF_SIZE;
+    config.output = bench_drop_output;
+
+    size_t free_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    zlib_stream_handle_t stream = NULL;
+    esp_err_t err = zlib_stream_new(&config, &stream);
+    if (err != ESP_OK) {
+        printf("ZLIBBENCH,%u,%d,%d,%d,create failed: %s\n", (unsigned)budget, window_bits, mem_level, level,
+               esp_err_to_name(err));
+        return;
+    }
+    int64_t us = bench_write_log(stream);
+    size_t heap_used = free_before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    size_t in = 0;
+    size_t out = 0;
+    ESP_ERROR_CHECK(zlib_stream_get_totals(stream, &in, &out));
+    ESP_ERROR_CHECK(zlib_stream_del(stream));
+    printf("ZLIBBENCH,%u,%d,%d,%d,%u,%u,%.1f,%" PRIi64 ",%.1f,%u\n", (unsigned)budget, window_bits, mem_level, level,
+           (unsigned)in, (unsigned)out, 100.0 * out / in, us, in * 1000000.0 / 1024 / us, (unsigned)heap_used);
+}
+
+/* Same log through the compression task, timing what the writer waits for */
+static void bench_run_task(void)
+{
+    zlib_stream_config_t config = ZLIB_STREAM_DEFAULT_CONFIG();
+    config.out_buf_size = BENCH_OUT_BUF_SIZE;
+    config.output = bench_drop_output;
+    config.ring_size = 8 * 1024;
+    config.task_priority = uxTaskPriorityGet(NULL);
+    config.write_timeout_ms = 1000;
+    zlib_stream_handle_t stream = NULL;
+    ESP_ERROR_CHECK(zlib_stream_new(&config, &stream));
+
+    int64_t start = esp_timer_get_time();
+    const char *line = s_log;
+    const char *end = s_log + s_log_len;
+    int64_t write_us = 0;
+    while (line < end) {
+        const char *eol = memchr(line, '\n', end - line);
+        size_t len = eol ? eol + 1 - line : end - line;
+        int64_t t = esp_timer_get_time();
+        ESP_ERROR_CHECK(zlib_stream_write(stream, line, len));
+        write_us += esp_timer_get_time() - t;
+        line += len;
+        // leave the CPU to the compression task now and then, as a real logger would
+        if (bench_rand(16) == 0) {
+            vTaskDelay(1);
+        }
+    }
+    ESP_ERROR_CHECK(zlib_stream_finish(stream));
+    int64_t total_us = esp_timer_get_time() - start;
+    size_t out = 0;
+    ESP_ERROR_CHECK(zlib_stream_get_totals(stream, NULL, &out));
+    ESP_ERROR_CHECK(zlib_stream_del(stream));
+    printf("Task mode: %u bytes in %" PRIi64 " us, %" PRIi64 " us spent in zlib_stream_write(), %u bytes out\n",
+           (unsigned)s_log_len, total_us, write_us, (unsigned)out);
+}
+
+void app_main(void)
+{
+    bench_generate_log();
+    ESP_LOGI(TAG, "Compressing %u bytes of log", (unsigned)s_log_len);
+    printf("ZLIBBENCH,budget,window_bits,mem_level,level,in,out,ratio_pct,us,kb_per_s,heap_used\n");
+    for (size_t i = 0; i < sizeof(s_budgets) / sizeof(s_budgets[0]); i++) {
+        for (int level = 1; level <= 9; level++) {
+            bench_run(s_budgets[i], level);
+        }
+    }
+    bench_run_task();
+    free(s_log);
+    printf("Benchmark done\n");
+}
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief RAM taken by a deflate state besides its window and hash buffers, in bytes
+ */
+#define ZLIB_STREAM_STATE_OVERHEAD (6 * 1024)
+
+/**
+ * @brief Framing of the compressed data
+ */
+typedef enum {
+    ZLIB_STREAM_FORMAT_ZLIB = 0, /*!< zlib header and Adler-32 trailer, for `Content-Encoding: deflate` */
+    ZLIB_STREAM_FORMAT_GZIP,     /*!< gzip header and CRC32 trailer, for `Content-Encoding: gzip` and .gz files */
+    ZLIB_STREAM_FORMAT_RAW,      /*!< Raw deflate data, without header nor trailer */
+} zlib_stream_format_t;
+
+/**
+ * @brief Compression stream handle
+ */
+typedef struct zlib_stream_t *zlib_stream_handle_t;
+
+/**
+ * @brief Function receiving the compressed data
+ *
+ * @param data Compressed data
+ * @param len Length of the data, in bytes
+ * @param arg User argument of the stream
+ * @return ESP_OK on success, any other error to fail the stream, which then returns it
+ */
+typedef esp_err_t (*zlib_stream_output_cb_t)(const void *data, size_t len, void *arg);
+
+/**
+ * @brief Compression stream configuration
+ */
+typedef struct {
+    int level;                      /*!< Compression level, 1 (fastest) to 9 (smallest) */
+    size_t ram_budget;              /*!< RAM the deflate state may take, in bytes, see `zlib_stream_fit_budget()`.
+                                         0 for the zlib defaults, about 262 KB */
+    zlib_stream_format_t format;    /*!< Framing of the compressed data */
+    size_t out_buf_size;            /*!< Size of the output buffer, the size of the pieces given to `output` */
+    zlib_stream_output_cb_t output; /*!< Function receiving the compressed data */
+    void *arg;                      /*!< User argument passed to the function */
+    uint32_t caps;                  /*!< Heap capabilities of the memory of the stream, 0 for MALLOC_CAP_DEFAULT */
+    size_t ring_size;               /*!< Size of the ring buffer of the compression task, 0 to compress in the calls
+                                         to `zlib_stream_write()`, without task */
+    uint32_t task_priority;         /*!< Priority of the compression task */
+    uint32_t task_stack_size;       /*!< Stack size of the compression task, in bytes */
+    uint32_t write_timeout_ms;      /*!< How long `zlib_stream_write()` waits for room in the ring buffer, 0 to drop
+                                         the data at once when it is full, e.g. for logs */
+} zlib_stream_config_t;
+
+/**
+ * @brief Default configuration of a compression stream, gzip in a 32 KB budget, compressing in the calls to
+ *        `zlib_stream_write()`
+ */
+#define ZLIB_STREAM_DEFAULT_CONFIG()           \
+    {                                          \
+        .level = 6,                            \
+        .ram_budget = 32 * 1024,               \
+        .format = ZLIB_STREAM_FORMAT_GZIP,     \
+        .out_buf_size = 1024,                  \
+        .task_priority = 2,                    \
+        .task_stack_size = 4096,               \
+    }
+
+/**
+ * @brief Pick the deflate parameters taking at most a RAM budget
+ *
+ * A deflate state takes `2^(window_bits + 2) + 2^(mem_level + 9)` bytes of buffers and about
+ * ZLIB_STREAM_STATE_OVERHEAD bytes of state. Starting from the zlib defaults, window bits MAX_WBITS and memory level 8,
+ * the larger of the two buffers is halved until they fit, the hash buffers first when they are the same size, as the
+ * matches of logs are often far apart: a smaller window finds fewer matches, a lower memory level makes shorter hash
+ * chains and smaller blocks.
+ *
+ * @param ram_budget RAM budget, in bytes
+ * @param ret_window_bits Returned window bits, 9 to MAX_WBITS
+ * @param ret_mem_level Returned memory level, 1 to 8
+ * @return
+ *      - ESP_OK: Fit budget successfully
+ *      - ESP_ERR_INVALID_ARG: Fit budget failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Fit budget failed because the budget is below the smallest state, about 9 KB
+ */
+esp_err_t zlib_stream_fit_budget(size_t ram_budget, int *ret_window_bits, int *ret_mem_level);
+
+/**
+ * @brief Create a compression stream
+ *
+ * The data written to the stream is compressed as it comes, and the compressed data is given to the output function
+ * in pieces of `out_buf_size` bytes. With `ring_size`, `zlib_stream_write()` only copies the data into a ring buffer,
+ * and a task compresses it and calls the output function, so the writers, e.g. a logger, don't wait for the
+ * compression.
+ *
+ * @param config Stream configuration
+ * @param ret_stream Returned stream handle
+ * @return
+ *      - ESP_OK: Create stream successfully
+ *      - ESP_ERR_INVALID_ARG: Create stream failed because of invalid argument
+ *      - ESP_ERR_NO_MEM: Create stream failed because of out of memory, or a RAM budget too small
+ *      - ESP_FAIL: Create stream failed because of a zlib error
+ */
+esp_err_t zlib_stream_new(const zlib_stream_config_t *config, zlib_stream_handle_t *ret_stream);
+
+/**
+ * @brief Write data to compress
+ *
+ * @note With the ring buffer, it can be called from several tasks, without it from one task at a time
+ *
+ * @param stream Stream handle
+ * @param data Data
+ * @param len Length of the data, in bytes
+ * @return
+ *      - ESP_OK: Write data successfully
+ *      - ESP_ERR_INVALID_ARG: Write data failed because of invalid argument
+ *      - ESP_ERR_TIMEOUT: Write data failed because the ring buffer stayed full, the data is dropped
+ *      - Others: Write data failed because the stream has failed with this error, e.g. from the output function
+ */
+esp_err_t zlib_stream_write(zlib_stream_handle_t stream, const void *data, size_t len);
+
+/**
+ * @brief Output all the data written so far, e.g. before sending a chunk, at the cost of some compression
+ *
+ * The compressed data is ended on a byte boundary with an empty stored block (Z_SYNC_FLUSH), so what has been output
+ * can be decompressed up to the data written before this call. With the ring buffer, the call waits for the task to
+ * compress the data written before it.
+ *
+ * @note Must not be called along with `zlib_stream_finish()` or itself from another task
+ *
+ * @param stream Stream handle
+ * @return
+ *      - ESP_OK: Flush stream successfully
+ *      - ESP_ERR_INVALID_ARG: Flush stream failed because of invalid argument
+ *      - Others: Flush stream failed because the stream has failed with this error
+ */
+esp_err_t zlib_stream_flush(zlib_stream_handle_t stream);
+
+/**
+ * @brief End the compressed data with its trailer, the next write then starts a new one, e.g. for the next upload
+ *
+ * @note Must not be called along with `zlib_stream_flush()` or itself from another task
+ *
+ * @param stream Stream handle
+ * @return
+ *      - ESP_OK: Finish stream successfully
+ *      - ESP_ERR_INVALID_ARG: Finish stream failed because of invalid argument
+ *      - Others: Finish stream failed because the stream has failed with this error
+ */
+esp_err_t zlib_stream_finish(zlib_stream_handle_t stream);
+
+/**
+ * @brief Get the number of bytes written and output since the start of the current compressed data
+ *
+ * @param stream Stream handle
+ * @param ret_in Returned number of bytes compressed, can be NULL
+ * @param ret_out Returned number of bytes output, can be NULL
+ * @return
+ *      - ESP_OK: Get totals successfully
+ *      - ESP_ERR_INVALID_ARG: Get totals failed because of invalid argument
+ */
+esp_err_t zlib_stream_get_totals(zlib_stream_handle_t stream, size_t *ret_in, size_t *ret_out);
+
+/**
+ * @brief Delete a compression stream, dropping the data not finished yet
+ *
+ * @param stream Stream handle
+ * @return
+ *      - ESP_OK: Delete stream successfully
+ *      - ESP_ERR_INVALID_ARG: Delete stream failed because of invalid argument
+ */
+esp_err_t zlib_stream_del(zlib_stream_handle_t stream);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,22 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "esp_rom_crc.h"
+#include "zlib.h"
+
+/* The software versions of crc32.c are renamed at build time, the rest of the file is used as is */
+
+uLong ZEXPORT crc32_z(uLong crc, const Bytef *buf, z_size_t len)
+{
+    if (buf == Z_NULL) {
+        return 0;
+    }
+    return esp_rom_crc32_le((uint32_t)crc, buf, (uint32_t)len);
+}
+
+uLong ZEXPORT crc32(uLong crc, const Bytef *buf, uInt len)
+{
+    return crc32_z(crc, buf, len);
+}
@@ -0,0 +1,309 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdbool.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/ringbuf.h"
+#include "zlib.h"
+#include "zlib_stream.h"
+
+static const char *TAG = "zlib_stream";
+
+#define STREAM_MIN_WINDOW_BITS 9
+#define STREAM_MAX_MEM_LEVEL   (MAX_MEM_LEVEL < 8 ? MAX_MEM_LEVEL : 8)
+
+/* Kinds of the items of the ring buffer, a data item is followed by the data */
+typedef enum {
+    STREAM_ITEM_DATA,
+    STREAM_ITEM_FLUSH,
+    STREAM_ITEM_FINISH,
+    STREAM_ITEM_STOP,
+} stream_item_kind_t;
+
+typedef struct {
+    uint32_t kind;
+} stream_item_t;
+
+typedef struct zlib_stream_t {
+    z_stream zs;
+    bool zs_ready;              // deflateInit2() succeeded, deflateEnd() is needed
+    bool finished;              // the compressed data is ended, the next write resets the state
+    zlib_stream_config_t config;
+    uint32_t caps;
+    uint8_t *out_buf;
+    esp_err_t err;              // error the stream failed with, ESP_OK while it works
+    RingbufHandle_t ring;
+    TaskHandle_t task;
+    SemaphoreHandle_t done;     // given by the task once a flush, finish or stop item is handled
+    esp_err_t result;           // result of the last flush or finish item
+} zlib_stream_t;
+
+static voidpf stream_zalloc(voidpf opaque, uInt items, uInt size)
+{
+    zlib_stream_t *stream = (zlib_stream_t *)opaque;
+    return heap_caps_calloc(items, size, stream->caps);
+}
+
+static void stream_zfree(voidpf opaque, voidpf ptr)
+{
+    heap_caps_free(ptr);
+}
+
+static size_t stream_budget_cost(int window_bits, int mem_level)
+{
+    return ((size_t)1 << (window_bits + 2)) + ((size_t)1 << (mem_level + 9)) + ZLIB_STREAM_STATE_OVERHEAD;
+}
+
+esp_err_t zlib_stream_fit_budget(size_t ram_budget, int *ret_window_bits, int *ret_mem_level)
+{
+    ESP_RETURN_ON_FALSE(ret_window_bits && ret_mem_level, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    int window_bits = MAX_WBITS;
+    int mem_level = STREAM_MAX_MEM_LEVEL;
+    while (stream_budget_cost(window_bits, mem_level) > ram_budget) {
+        // halve the larger buffer, the hash buffers on a tie, the window taking 2^(bits + 2) and the hash 2^(level + 9)
+        if (window_bits > STREAM_MIN_WINDOW_BITS && (window_bits + 2 > mem_level + 9 || mem_level == 1)) {
+            window_bits--;
+        } else if (mem_level > 1) {
+            mem_level--;
+        } else {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    *ret_window_bits = window_bits;
+    *ret_mem_level = mem_level;
+    return ESP_OK;
+}
+
+static esp_err_t stream_output(zlib_stream_t *stream)
+{
+    size_t len = stream->config.out_buf_size - stream->zs.avail_out;
+    stream->zs.next_out = stream->out_buf;
+    stream->zs.avail_out = stream->config.out_buf_size;
+    if (len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = stream->config.output(stream->out_buf, len, stream->config.arg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "output failed: %s", esp_err_to_name(err));
+        stream->err = err;
+    }
+    return err;
+}
+
+/* Compresses the data, and with Z_SYNC_FLUSH or Z_FINISH outputs everything, the output buffer is kept otherwise */
+static esp_err_t stream_deflate(zlib_stream_t *stream, const void *data, size_t len, int flush)
+{
+    if (stream->err != ESP_OK) {
+        return stream->err;
+    }
+    if (stream->finished) {
+        deflateReset(&stream->zs);
+        stream->finished = false;
+    }
+    stream->zs.next_in = (Bytef *)data;
+    stream->zs.avail_in = len;
+    for (;;) {
+        int ret = deflate(&stream->zs, flush);
+        if (ret == Z_STREAM_ERROR) {
+            ESP_LOGE(TAG, "deflate failed");
+            stream->err = ESP_FAIL;
+            return ESP_FAIL;
+        }
+        if (stream->zs.avail_out == 0) {
+            if (stream_output(stream) != ESP_OK) {
+                return stream->err;
+            }
+            continue;
+        }
+        // with room left in the output buffer, the input is all consumed and the flush complete
+        if (flush != Z_NO_FLUSH) {
+            if (stream_output(stream) != ESP_OK) {
+                return stream->err;
+            }
+            stream->finished = flush == Z_FINISH;
+        }
+        return ESP_OK;
+    }
+}
+
+static void stream_task(void *arg)
+{
+    zlib_stream_t *stream = (zlib_stream_t *)arg;
+    for (;;) {
+        size_t size;
+        stream_item_t *item = (stream_item_t *)xRingbufferReceive(stream->ring, &size, portMAX_DELAY);
+        if (!item) {
+            continue;
+        }
+        const stream_item_kind_t kind = item->kind;
+        if (kind == STREAM_ITEM_DATA) {
+            // the errors are kept in the stream and returned to the writers
+            stream_deflate(stream, item + 1, size - sizeof(stream_item_t), Z_NO_FLUSH);
+        }
+        vRingbufferReturnItem(stream->ring, item);
+        if (kind == STREAM_ITEM_FLUSH || kind == STREAM_ITEM_FINISH) {
+            stream->result = stream_deflate(stream, NULL, 0, kind == STREAM_ITEM_FLUSH ? Z_SYNC_FLUSH : Z_FINISH);
+            xSemaphoreGive(stream->done);
+        } else if (kind == STREAM_ITEM_STOP) {
+            xSemaphoreGive(stream->done);
+            vTaskSuspend(NULL);
+        }
+    }
+}
+
+/* Sends a control item to the task and waits for it to be handled */
+static esp_err_t stream_request(zlib_stream_t *stream, stream_item_kind_t kind)
+{
+    const stream_item_t item = {
+        .kind = kind,
+    };
+    ESP_RETURN_ON_FALSE(xRingbufferSend(stream->ring, &item, sizeof(item), portMAX_DELAY) == pdTRUE, ESP_FAIL, TAG,
+                        "send request failed");
+    xSemaphoreTake(stream->done, portMAX_DELAY);
+    return stream->result;
+}
+
+esp_err_t zlib_stream_new(const zlib_stream_config_t *config, zlib_stream_handle_t *ret_stream)
+{
+    esp_err_t ret = ESP_OK;
+    zlib_stream_t *stream = NULL;
+    ESP_RETURN_ON_FALSE(config && ret_stream && config->output && config->out_buf_size > 0, ESP_ERR_INVALID_ARG,
+                        TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(config->level >= 1 && config->level <= 9, ESP_ERR_INVALID_ARG, TAG, "invalid level");
+    ESP_RETURN_ON_FALSE(config->format <= ZLIB_STREAM_FORMAT_RAW, ESP_ERR_INVALID_ARG, TAG, "invalid format");
+    int window_bits = MAX_WBITS;
+    int mem_level = STREAM_MAX_MEM_LEVEL;
+    if (config->ram_budget) {
+        ESP_RETURN_ON_ERROR(zlib_stream_fit_budget(config->ram_budget, &window_bits, &mem_level), TAG,
+                            "budget of %u bytes too small", (unsigned)config->ram_budget);
+    }
+
+    const uint32_t caps = config->caps ? config->caps : MALLOC_CAP_DEFAULT;
+    stream = heap_caps_calloc(1, sizeof(zlib_stream_t), caps);
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_NO_MEM, TAG, "no memory for stream");
+    stream->config = *config;
+    stream->caps = caps;
+    stream->out_buf = heap_caps_malloc(config->out_buf_size, caps);
+    ESP_GOTO_ON_FALSE(stream->out_buf, ESP_ERR_NO_MEM, err, TAG, "no memory for output buffer");
+    stream->zs.zalloc = stream_zalloc;
+    stream->zs.zfree = stream_zfree;
+    stream->zs.opaque = stream;
+    stream->zs.next_out = stream->out_buf;
+    stream->zs.avail_out = config->out_buf_size;
+    ESP_LOGD(TAG, "window bits %d, memory level %d", window_bits, mem_level);
+    if (config->format == ZLIB_STREAM_FORMAT_GZIP) {
+        window_bits += 16;
+    } else if (config->format == ZLIB_STREAM_FORMAT_RAW) {
+        window_bits = -window_bits;
+    }
+    int zret = deflateInit2(&stream->zs, config->level, Z_DEFLATED, window_bits, mem_level, Z_DEFAULT_STRATEGY);
+    ESP_GOTO_ON_FALSE(zret != Z_MEM_ERROR, ESP_ERR_NO_MEM, err, TAG, "no memory for deflate state");
+    ESP_GOTO_ON_FALSE(zret == Z_OK, ESP_FAIL, err, TAG, "deflateInit2 failed: %d", zret);
+    stream->zs_ready = true;
+
+    if (config->ring_size) {
+        stream->done = xSemaphoreCreateBinary();
+        ESP_GOTO_ON_FALSE(stream->done, ESP_ERR_NO_MEM, err, TAG, "no memory for semaphore");
+        stream->ring = xRingbufferCreate(config->ring_size, RINGBUF_TYPE_NOSPLIT);
+        ESP_GOTO_ON_FALSE(stream->ring, ESP_ERR_NO_MEM, err, TAG, "no memory for ring buffer");
+        ESP_GOTO_ON_FALSE(xRingbufferGetMaxItemSize(stream->ring) > sizeof(stream_item_t), ESP_ERR_INVALID_ARG, err,
+                          TAG, "ring buffer too small");
+        BaseType_t res = xTaskCreate(stream_task, "zlib_stream", config->task_stack_size, stream,
+                                     config->task_priority, &stream->task);
+        ESP_GOTO_ON_FALSE(res == pdPASS, ESP_ERR_NO_MEM, err, TAG, "create task failed");
+    }
+    *ret_stream = stream;
+    return ESP_OK;
+
+err:
+    zlib_stream_del(stream);
+    return ret;
+}
+
+esp_err_t zlib_stream_write(zlib_stream_handle_t stream, const void *data, size_t len)
+{
+    ESP_RETURN_ON_FALSE(stream && (data || len == 0), ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!stream->ring) {
+        return stream_deflate(stream, data, len, Z_NO_FLUSH);
+    }
+    if (stream->err != ESP_OK) {
+        return stream->err;
+    }
+    const size_t max_len = xRingbufferGetMaxItemSize(stream->ring) - sizeof(stream_item_t);
+    const TickType_t timeout = pdMS_TO_TICKS(stream->config.write_timeout_ms);
+    const uint8_t *p = (const uint8_t *)data;
+    while (len > 0) {
+        size_t n = len < max_len ? len : max_len;
+        stream_item_t *item = NULL;
+        // the data is copied straight into the ring buffer, behind its item header
+        if (xRingbufferSendAcquire(stream->ring, (void **)&item, sizeof(stream_item_t) + n, timeout) != pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        item->kind = STREAM_ITEM_DATA;
+        memcpy(item + 1, p, n);
+        xRingbufferSendComplete(stream->ring, item);
+        p += n;
+        len -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t zlib_stream_flush(zlib_stream_handle_t stream)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!stream->ring) {
+        return stream_deflate(stream, NULL, 0, Z_SYNC_FLUSH);
+    }
+    return stream_request(stream, STREAM_ITEM_FLUSH);
+}
+
+esp_err_t zlib_stream_finish(zlib_stream_handle_t stream)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (!stream->ring) {
+        return stream_deflate(stream, NULL, 0, Z_FINISH);
+    }
+    return stream_request(stream, STREAM_ITEM_FINISH);
+}
+
+esp_err_t zlib_stream_get_totals(zlib_stream_handle_t stream, size_t *ret_in, size_t *ret_out)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (ret_in) {
+        *ret_in = stream->zs.total_in;
+    }
+    if (ret_out) {
+        *ret_out = stream->zs.total_out;
+    }
+    return ESP_OK;
+}
+
+esp_err_t zlib_stream_del(zlib_stream_handle_t stream)
+{
+    ESP_RETURN_ON_FALSE(stream, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (stream->task) {
+        // the task is stopped past the data still in the ring buffer, which is dropped
+        stream->err = ESP_ERR_INVALID_STATE;
+        stream_request(stream, STREAM_ITEM_STOP);
+        vTaskDelete(stream->task);
+    }
+    if (stream->ring) {
+        vRingbufferDelete(stream->ring);
+    }
+    if (stream->done) {
+        vSemaphoreDelete(stream->done);
+    }
+    if (stream->zs_ready) {
+        deflateEnd(&stream->zs);
+    }
+    heap_caps_free(stream->out_buf);
+    heap_caps_free(stream);
+    return ESP_OK;
+}
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "zlib.h"
+#include "zlib_stream.h"
+
+#define TEST_DATA_SIZE      (16 * 1024)
+#define TEST_OUT_BUF_SIZE   64      // smaller than most writes, the output function is called several times per write
+#define TEST_RING_SIZE      2048    // writes larger than an item are split
+
+/* Everything the output function got, in order */
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t size;
+} test_output_t;
+
+/* Called by the compression task with the ring buffer, the errors fail the stream instead of the test */
+static esp_err_t test_output_cb(const void *data, size_t len, void *arg)
+{
+    test_output_t *out = (test_output_t *)arg;
+    if (len == 0 || len > TEST_OUT_BUF_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (out->len + len > out->size) {
+        uint8_t *grown = realloc(out->data, (out->len + len) * 2);
+        if (!grown) {
+            return ESP_ERR_NO_MEM;
+        }
+        out->data = grown;
+        out->size = (out->len + len) * 2;
+    }
+    memcpy(out->data + out->len, data, len);
+    out->len += len;
+    return ESP_OK;
+}
+
+/* Log lines, with a block of random bytes in the middle which deflate has to store */
+static uint8_t *test_data_new(void)
+{
+    uint8_t *data = malloc(TEST_DATA_SIZE);
+    TEST_ASSERT_NOT_NULL(data);
+    size_t len = 0;
+    for (int i = 0; len < TEST_DATA_SIZE; i++) {
+        char line[96];
+        size_t n = snprintf(line, sizeof(line), "I (%d) wifi: sta rssi %d, channel %d, retries %d\n", i * 37,
+                            -40 - i % 50, 1 + i % 13, i % 7);
+        n = n < TEST_DATA_SIZE - len ? n : TEST_DATA_SIZE - len;
+        memcpy(data + len, line, n);
+        len += n;
+    }
+    uint32_t seed = 12345;
+    for (size_t i = TEST_DATA_SIZE / 2; i < TEST_DATA_SIZE / 2 + 1024; i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = seed >> 16;
+    }
+    return data;
+}
+
+/*
+ * Decompresses the output of the stream, from a finish, or up to a flush when `finished` is false, and compares it to
+ * the data written to the stream
+ */
+static void test_inflate(zlib_stream_format_t format, const uint8_t *in, size_t in_len, const uint8_t *expected,
+                         size_t expected_len, bool finished)
+{
+    z_stream zs = {0};
+    int window_bits = MAX_WBITS;
+    if (format == ZLIB_STREAM_FORMAT_GZIP) {
+        window_bits += 16;
+    } else if (format == ZLIB_STREAM_FORMAT_RAW) {
+        window_bits = -window_bits;
+    }
+    TEST_ASSERT_EQUAL(Z_OK, inflateInit2(&zs, window_bits));
+    // one more byte, so that data past the expected end is detected
+    uint8_t *out = malloc(expected_len + 1);
+    TEST_ASSERT_NOT_NULL(out);
+    zs.next_in = (Bytef *)in;
+    zs.avail_in = in_len;
+    zs.next_out = out;
+    zs.avail_out = expected_len + 1;
+    int ret = inflate(&zs, finished ? Z_FINISH : Z_SYNC_FLUSH);
+    TEST_ASSERT_EQUAL(finished ? Z_STREAM_END : Z_OK, ret);
+    TEST_ASSERT_EQUAL(0, zs.avail_in);
+    TEST_ASSERT_EQUAL(expected_len, zs.total_out);
+    if (expected_len) {
+        TEST_ASSERT_EQUAL_MEMORY(expected, out, expected_len);
+    }
+    inflateEnd(&zs);
+    free(out);
+}
+
+static void test_round_trip(zlib_stream_format_t format, size_t ring_size)
+{
+    test_output_t out = {0};
+    zlib_stream_config_t config = ZLIB_STREAM_DEFAULT_CONFIG();
+    config.format = format;
+    config.out_buf_size = TEST_OUT_BUF_SIZE;
+    config.output = test_output_cb;
+    config.arg = &out;
+    config.ring_size = ring_size;
+    config.write_timeout_ms = 1000;
+    zlib_stream_handle_t stream;
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_new(&config, &stream));
+    uint8_t *data = test_data_new();
+    size_t in_len, out_len;
+
+    // Writes of various sizes, empty and larger than a ring buffer item included
+    const size_t chunks[] = {0, 1, 100, 3000, 7, TEST_DATA_SIZE / 2 - 3108};
+    size_t written = 0;
+    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_write(stream, data + written, chunks[i]));
+        written += chunks[i];
+    }
+
+    // A flush outputs everything written before it, a second one adds nothing to decompress
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_flush(stream));
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_flush(stream));
+    test_inflate(format, out.data, out.len, data, written, false);
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_get_totals(stream, &in_len, &out_len));
+    TEST_ASSERT_EQUAL(written, in_len);
+    TEST_ASSERT_EQUAL(out.len, out_len);
+
+    // Finish right after a flush
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_write(stream, data + written, TEST_DATA_SIZE - written));
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_flush(stream));
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_finish(stream));
+    test_inflate(format, out.data, out.len, data, TEST_DATA_SIZE, true);
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_get_totals(stream, &in_len, &out_len));
+    TEST_ASSERT_EQUAL(TEST_DATA_SIZE, in_len);
+    TEST_ASSERT_EQUAL(out.len, out_len);
+
+    // A finish without data makes empty compressed data
+    size_t start = out.len;
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_finish(stream));
+    TEST_ASSERT_GREATER_THAN(start, out.len);
+    test_inflate(format, out.data + start, out.len - start, NULL, 0, true);
+
+    // The next write starts new compressed data, with its own totals
+    start = out.len;
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_write(stream, data, 1000));
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_finish(stream));
+    test_inflate(format, out.data + start, out.len - start, data, 1000, true);
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_get_totals(stream, &in_len, &out_len));
+    TEST_ASSERT_EQUAL(1000, in_len);
+    TEST_ASSERT_EQUAL(out.len - start, out_len);
+
+    TEST_ASSERT_EQUAL(ESP_OK, zlib_stream_del(stream));
+    free(data);
+    free(out.data);
+}
+
+TEST_CASE("zlib_stream round trip, zlib format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_ZLIB, 0);
+}
+
+TEST_CASE("zlib_stream round trip, raw format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_RAW, 0);
+}
+
+TEST_CASE("zlib_stream round trip, gzip format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_GZIP, 0);
+}
+
+TEST_CASE("zlib_stream round trip through the ring buffer, zlib format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_ZLIB, TEST_RING_SIZE);
+}
+
+TEST_CASE("zlib_stream round trip through the ring buffer, raw format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_RAW, TEST_RING_SIZE);
+}
+
+TEST_CASE("zlib_stream round trip through the ring buffer, gzip format", "[zlib_stream]")
+{
+    test_round_trip(ZLIB_STREAM_FORMAT_GZIP, TEST_RING_SIZE);
+}
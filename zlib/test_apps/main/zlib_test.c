@@ -1,6 +0,0 @@
-#include <stdio.h>
-
-void app_main(void)
-{
-
-}
@@ -0,0 +1,9 @@
+# SPDX-FileCopyrightText: 2025 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+
+import pytest
+
+
+@pytest.mark.generic
+def test_zlib(dut) -> None:
+    dut.run_all_single_board_cases()